@@ -88,6 +88,7 @@ class Struct(common.SourceLocation):
         self.immutable = False  # type: bool
         self.inline_chained_structs = False  # type: bool
         self.generate_comparison_operators = False  # type: bool
+        self.view_strings = False  # type: bool
         self.fields = []  # type: List[Field]
         super(Struct, self).__init__(file_name, line, column)
 
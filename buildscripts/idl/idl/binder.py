@@ -245,6 +245,7 @@ def _bind_struct_common(ctxt, parsed_spec, struct, ast_struct):
     ast_struct.immutable = struct.immutable
     ast_struct.inline_chained_structs = struct.inline_chained_structs
     ast_struct.generate_comparison_operators = struct.generate_comparison_operators
+    ast_struct.view_strings = struct.view_strings
     ast_struct.cpp_name = struct.name
     if struct.cpp_name:
         ast_struct.cpp_name = struct.cpp_name
@@ -272,6 +273,9 @@ def _bind_struct_common(ctxt, parsed_spec, struct, ast_struct):
     for field in struct.fields or []:
         ast_field = _bind_field(ctxt, parsed_spec, field)
         if ast_field:
+            if ast_struct.view_strings:
+                _bind_string_view(ast_field)
+
             if ast_field.supports_doc_sequence and not isinstance(ast_struct, ast.Command):
                 # Doc sequences are only supported in commands at the moment
                 ctxt.add_bad_struct_field_as_doc_sequence_error(ast_struct, ast_struct.name,
@@ -319,6 +323,23 @@ def _bind_struct(ctxt, parsed_spec, struct):
     return ast_struct
 
 
+def _bind_string_view(ast_field):
+    # type: (ast.Field) -> None
+    """
+    Store a string field as a StringData view of the BSON it is parsed from.
+
+    Object fields are already unowned views of the parsed BSON, so a struct which views its
+    strings too parses without allocating per field. The injected "$db" field stays owned because
+    the command constructors derive it from a NamespaceString.
+    """
+    if ast_field.serialize_op_msg_request_only:
+        return
+
+    if ast_field.cpp_type == 'std::string' and ast_field.deserializer == 'mongo::BSONElement::str':
+        ast_field.cpp_type = 'mongo::StringData'
+        ast_field.deserializer = 'mongo::BSONElement::valueStringData'
+
+
 def _inject_hidden_command_fields(command):
     # type: (syntax.Command) -> None
     """Inject hidden fields to aid deserialization/serialization for OpMsg parsing of commands."""
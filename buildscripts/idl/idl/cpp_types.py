@@ -60,7 +60,9 @@ def _is_primitive_type(cpp_type):
     # type: (unicode) -> bool
     """Return True if a cpp_type is a primitive type and should not be returned as reference."""
     cpp_type = cpp_type.replace(' ', '')
-    return is_primitive_scalar_type(cpp_type) or cpp_type == _STD_ARRAY_UINT8_16
+    return is_primitive_scalar_type(cpp_type) or cpp_type in [
+        _STD_ARRAY_UINT8_16, 'mongo::StringData'
+    ]
 
 
 def _qualify_optional_type(cpp_type):
@@ -366,6 +366,7 @@ def _parse_struct(ctxt, spec, name, node):
             "inline_chained_structs": _RuleDesc("bool_scalar"),
             "immutable": _RuleDesc('bool_scalar'),
             "generate_comparison_operators": _RuleDesc("bool_scalar"),
+            "view_strings": _RuleDesc("bool_scalar"),
         })
 
     # TODO: SHOULD WE ALLOW STRUCTS ONLY WITH CHAINED STUFF and no fields???
@@ -448,6 +449,7 @@ def _parse_command(ctxt, spec, name, node):
             "inline_chained_structs": _RuleDesc("bool_scalar"),
             "immutable": _RuleDesc('bool_scalar'),
             "generate_comparison_operators": _RuleDesc("bool_scalar"),
+            "view_strings": _RuleDesc("bool_scalar"),
         })
 
     # TODO: support the first argument as UUID depending on outcome of Catalog Versioning changes.
@@ -535,6 +535,54 @@ class TestBinder(testcase.IDLTestcase):
                         foo: string
             """))
 
+    def test_struct_view_strings(self):
+        # type: () -> None
+        """Test a struct which views its strings stores only the basic string type as a view."""
+
+        test_preamble = textwrap.dedent("""
+        types:
+            string:
+                description: foo
+                cpp_type: std::string
+                bson_serialization_type: string
+                deserializer: mongo::BSONElement::str
+            customstring:
+                description: foo
+                cpp_type: std::string
+                bson_serialization_type: string
+                deserializer: foo
+        """)
+
+        spec = self.assert_bind(test_preamble + textwrap.dedent("""
+            structs:
+                foo:
+                    description: foo
+                    view_strings: true
+                    fields:
+                        foo: string
+                        bar: customstring
+            """))
+        fields = spec.structs[0].fields
+        self.assertEqual(fields[0].cpp_type, 'mongo::StringData')
+        self.assertEqual(fields[0].deserializer, 'mongo::BSONElement::valueStringData')
+        self.assertEqual(fields[1].cpp_type, 'std::string')
+        self.assertEqual(fields[1].deserializer, 'foo')
+
+        # The injected $db field of a command stays owned
+        spec = self.assert_bind(test_preamble + textwrap.dedent("""
+            commands:
+                foo:
+                    description: foo
+                    namespace: ignored
+                    view_strings: true
+                    fields:
+                        bar: string
+            """))
+        fields = spec.commands[0].fields
+        self.assertEqual(fields[0].cpp_type, 'mongo::StringData')
+        self.assertEqual(fields[1].name, '$db')
+        self.assertEqual(fields[1].cpp_type, 'std::string')
+
     def test_struct_negative(self):
         # type: () -> None
         """Negative struct tests."""
@@ -274,6 +274,7 @@ class TestParser(testcase.IDLTestcase):
                 immutable: true
                 inline_chained_structs: true
                 generate_comparison_operators: true
+                view_strings: true
                 fields:
                     foo: bar
             """))
@@ -288,6 +289,7 @@ class TestParser(testcase.IDLTestcase):
                 immutable: false
                 inline_chained_structs: false
                 generate_comparison_operators: false
+                view_strings: false
                 fields:
                     foo: bar
             """))
@@ -829,6 +831,7 @@ class TestParser(testcase.IDLTestcase):
                 immutable: true
                 inline_chained_structs: true
                 generate_comparison_operators: true
+                view_strings: true
                 cpp_name: foo
                 fields:
                     foo: bar
@@ -845,6 +848,7 @@ class TestParser(testcase.IDLTestcase):
                 immutable: false
                 inline_chained_structs: false
                 generate_comparison_operators: false
+                view_strings: false
                 fields:
                     foo: bar
             """))
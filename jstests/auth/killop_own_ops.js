@@ -34,6 +34,8 @@
         if (!FixtureHelpers.isMongos(db)) {
             assert.commandWorked(
                 db.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 1}));
+            assert.commandWorked(db.adminCommand(
+                {setParameter: 1, internalQueryExecUncontendedYieldPeriodMS: 0}));
         }
 
         admin.logout();
@@ -123,6 +123,8 @@ var $config = (function() {
                 db.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 5}));
             assertAlways.commandWorked(
                 db.adminCommand({setParameter: 1, internalQueryExecYieldPeriodMS: 1}));
+            assertAlways.commandWorked(
+                db.adminCommand({setParameter: 1, internalQueryExecUncontendedYieldPeriodMS: 0}));
         });
         // Set up some data to query.
         var N = this.nDocs;
@@ -145,6 +147,8 @@ var $config = (function() {
                 db.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 128}));
             assertAlways.commandWorked(
                 db.adminCommand({setParameter: 1, internalQueryExecYieldPeriodMS: 10}));
+            assertAlways.commandWorked(db.adminCommand(
+                {setParameter: 1, internalQueryExecUncontendedYieldPeriodMS: 100}));
         });
     }
 
@@ -0,0 +1,90 @@
+// Tests that a collection created with the 'clusteredOnId' option stores its documents by _id, so
+// that lookups and range scans on _id read the collection directly rather than an _id index.
+// @tags: [assumes_unsharded_collection, assumes_no_implicit_collection_creation_after_drop]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage, getPlanStages, isIdhack.
+
+    const coll = db.clustered_collection_id;
+    coll.drop();
+
+    assert.commandFailedWithCode(
+        db.createCollection(coll.getName(), {clusteredOnId: true, capped: true, size: 4096}),
+        ErrorCodes.BadValue);
+
+    const res = db.createCollection(coll.getName(), {clusteredOnId: true});
+    if (!res.ok) {
+        // Not every storage engine can key records by _id.
+        assert.commandFailedWithCode(res, ErrorCodes.InvalidOptions);
+        return;
+    }
+
+    // There is no separate _id index.
+    assert.eq(coll.getIndexes().length, 0, tojson(coll.getIndexes()));
+
+    const docs = [];
+    for (let i = 100; i >= 1; i--) {
+        docs.push({_id: i, a: i % 10});
+    }
+    assert.commandWorked(coll.insert(docs));
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    // Only positive integral numbers can be the _id, and numerically equal values are duplicates.
+    assert.commandFailedWithCode(coll.insert({_id: 2.5}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(coll.insert({_id: "a"}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(coll.insert({_id: 0}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(coll.insert({a: 1}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(coll.insert({_id: 7}), ErrorCodes.DuplicateKey);
+    assert.commandFailedWithCode(coll.insert({_id: NumberLong(7)}), ErrorCodes.DuplicateKey);
+    assert.commandFailedWithCode(coll.insert({_id: 7.0}), ErrorCodes.DuplicateKey);
+    assert.eq(coll.find().itcount(), 100);
+
+    // A natural order scan returns the documents in _id order.
+    assert.eq(coll.find().toArray().map((doc) => doc._id), docs.map((doc) => doc._id).reverse());
+
+    // Point lookups on _id use the IDHACK stage.
+    assert.eq(coll.findOne({_id: 42}), {_id: 42, a: 2});
+    assert.eq(coll.findOne({_id: NumberDecimal("42")}), {_id: 42, a: 2});
+    assert.eq(coll.findOne({_id: 42.5}), null);
+    assert.eq(coll.findOne({_id: "42"}), null);
+    let explain = coll.find({_id: 42}).explain("executionStats");
+    assert(isIdhack(db, explain.queryPlanner.winningPlan), tojson(explain));
+    assert.eq(explain.executionStats.totalDocsExamined, 1, tojson(explain));
+    assert.eq(explain.executionStats.totalKeysExamined, 0, tojson(explain));
+
+    // Updates and deletes by _id find their document without an _id index.
+    assert.commandWorked(coll.update({_id: 42}, {$set: {b: 1}}));
+    assert.eq(coll.findOne({_id: 42}), {_id: 42, a: 2, b: 1});
+    assert.commandWorked(coll.remove({_id: 43}));
+    assert.eq(coll.findOne({_id: 43}), null);
+    assert.commandWorked(coll.insert({_id: 43, a: 3}));
+
+    // Range predicates on _id only read the records in the range.
+    function assertRangeScan(query, sort, expectedIds) {
+        const cursor = coll.find(query).sort(sort);
+        assert.eq(cursor.toArray().map((doc) => doc._id), expectedIds, tojson(query));
+
+        explain = coll.find(query).sort(sort).hint({$natural: 1}).explain("executionStats");
+        assert.eq(getPlanStages(explain.queryPlanner.winningPlan, "SORT").length,
+                  0,
+                  tojson(explain));
+        assert.eq(explain.executionStats.totalDocsExamined, expectedIds.length, tojson(explain));
+    }
+
+    assertRangeScan({_id: {$gte: 10, $lt: 20}}, {_id: 1}, [10, 11, 12, 13, 14, 15, 16, 17, 18, 19]);
+    assertRangeScan({_id: {$gt: 95.5}}, {_id: 1}, [96, 97, 98, 99, 100]);
+    assertRangeScan({_id: {$lte: 3}}, {_id: -1}, [3, 2, 1]);
+    assertRangeScan({_id: {$gt: 40, $lte: 44}}, {_id: -1}, [44, 43, 42, 41]);
+    assertRangeScan({_id: {$gt: 10, $lt: 11}}, {_id: 1}, []);
+    assertRangeScan({_id: {$gt: 100}}, {_id: -1}, []);
+
+    // Other predicates are still applied as a filter.
+    const ids = coll.find({_id: {$gte: 10, $lt: 40}, a: 5}).toArray().map((doc) => doc._id);
+    assert.eq(ids.sort((x, y) => x - y), [15, 25, 35]);
+
+    // A sort on _id is provided by the collection scan, without a blocking sort.
+    explain = coll.find().sort({_id: -1}).explain();
+    assert.eq(getPlanStages(explain.queryPlanner.winningPlan, "SORT").length, 0, tojson(explain));
+    assert.eq(coll.find().sort({_id: -1}).limit(2).toArray().map((doc) => doc._id), [100, 99]);
+})();
@@ -0,0 +1,48 @@
+// Tests that a rooted regex over an index with a case-insensitive collation scans only the index
+// keys which can match, and still returns every matching document.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    'use strict';
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.collation_regex_bounds;
+    coll.drop();
+
+    assert.commandWorked(
+        coll.createIndex({name: 1}, {collation: {locale: "en", strength: 2}, name: "name_ci"}));
+    const names = ["apple", "Apple pie", "APPLESAUCE", "applé", "appl", "banana", "Banana",
+                   "cherry", "apricot", "Äpple", "snapple", "apṕle", "APP-LE", "apple\n",
+                   "xapple", "ap ple", "BAT", "zebra"];
+    assert.commandWorked(coll.insert(names.map((name) => ({name: name}))));
+
+    function runQuery(filter) {
+        const sorted = (docs) => docs.map((doc) => doc.name).sort();
+        const expected = sorted(coll.find(filter).hint({$natural: 1}).toArray());
+        assert.eq(sorted(coll.find(filter).hint("name_ci").toArray()), expected, tojson(filter));
+
+        const explain = coll.find(filter).hint("name_ci").explain("executionStats");
+        assert(isIxscan(db, explain.queryPlanner.winningPlan), tojson(explain));
+        return {expected: expected, keysExamined: explain.executionStats.totalKeysExamined};
+    }
+
+    // The keys of strings which do not start with 'app', up to case and accents, are skipped.
+    let res = runQuery({name: /^APP/i});
+    assert.eq(res.expected,
+              ["APP-LE", "APPLESAUCE", "Apple pie", "appl", "apple", "apple\n", "applé"]);
+    assert.lt(res.keysExamined, names.length, tojson(res));
+
+    res = runQuery({name: /^appl/});
+    assert.eq(res.expected, ["appl", "apple", "apple\n", "applé"]);
+    assert.lt(res.keysExamined, names.length, tojson(res));
+
+    // Only the letters of a prefix narrow the bounds.
+    res = runQuery({name: /^app-/i});
+    assert.eq(res.expected, ["APP-LE"]);
+    assert.lt(res.keysExamined, names.length, tojson(res));
+
+    // Regexes which are not rooted still scan every string.
+    res = runQuery({name: /apple/i});
+    assert.eq(res.expected, ["APPLESAUCE", "Apple pie", "apple", "apple\n", "snapple", "xapple"]);
+    assert.gte(res.keysExamined, names.length, tojson(res));
+})();
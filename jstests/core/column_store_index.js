@@ -0,0 +1,89 @@
+// Tests that a columnstore index can answer queries which read only the indexed fields, and that
+// the documents it reassembles give the same results as a collection scan.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStages.
+
+    const coll = db.column_store_index;
+    coll.drop();
+
+    // Each field is a single top-level column, other than _id, and the index may not be sparse,
+    // unique or partial.
+    assert.commandFailedWithCode(coll.createIndex({"a.b": "columnstore"}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({_id: "columnstore"}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({a: "columnstore", b: 1}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({a: "columnstore"}, {sparse: true}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({a: "columnstore"}, {unique: true}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(
+        coll.createIndex({a: "columnstore"}, {partialFilterExpression: {a: {$gt: 0}}}),
+        ErrorCodes.CannotCreateIndex);
+
+    const docs = [];
+    for (let i = 0; i < 200; i++) {
+        const doc = {_id: i, a: i % 7, c: "other" + i};
+        if (i % 5 !== 0) {
+            doc.b = {x: i, y: [i % 3, "s"]};
+        }
+        docs.push(doc);
+    }
+    assert.commandWorked(coll.insert(docs));
+    assert.commandWorked(coll.createIndex({a: "columnstore", b: "columnstore"}, {name: "cs"}));
+
+    // Verifies that 'query' and 'proj' return the same documents with the columnstore index hinted
+    // as with a collection scan, and that the hinted plan reads the columns.
+    function assertMatchesCollscan(query, proj) {
+        const expected = coll.find(query, proj).sort({_id: 1}).hint({$natural: 1}).toArray();
+        assert.eq(coll.find(query, proj).sort({_id: 1}).hint("cs").toArray(), expected);
+        assert.sameMembers(coll.find(query, proj).toArray(), expected);
+
+        const explain = coll.find(query, proj).hint("cs").explain();
+        assert.eq(getPlanStages(explain.queryPlanner.winningPlan, "COLUMN_SCAN").length,
+                  1,
+                  tojson(explain));
+    }
+
+    assertMatchesCollscan({a: 3}, {a: 1});
+    assertMatchesCollscan({a: {$gte: 5}}, {_id: 0, a: 1, b: 1});
+    assertMatchesCollscan({"b.x": {$lt: 20}}, {b: 1});
+    assertMatchesCollscan({"b.y": 2}, {"b.x": 1});
+    assertMatchesCollscan({b: {$exists: false}}, {a: 1});
+    assertMatchesCollscan({}, {_id: 0, b: 1});
+
+    // A hinted columnstore index must hold every field the query reads.
+    assert.throws(() => coll.find({a: 1}).hint("cs").itcount());
+    assert.throws(() => coll.find({c: "other1"}, {a: 1}).hint("cs").itcount());
+    assert.throws(() => coll.find({a: 1}, {c: 1}).hint("cs").itcount());
+
+    // Aggregations which only read indexed fields can use the columns too.
+    function sumByA(hint) {
+        return coll
+            .aggregate([{$match: {a: {$gt: 1}}}, {$group: {_id: "$a", n: {$sum: "$b.x"}}}],
+                       {hint: hint})
+            .toArray()
+            .sort((l, r) => l._id - r._id);
+    }
+    assert.eq(sumByA("cs"), sumByA({$natural: 1}));
+
+    // Writes keep the columns up to date.
+    assert.commandWorked(coll.update({_id: 3}, {$set: {a: 100}, $unset: {b: 1}}));
+    assert.commandWorked(coll.update({_id: 5}, {$set: {b: "now a string"}}));
+    assert.commandWorked(coll.remove({a: 4}));
+    assert.commandWorked(coll.insert({_id: 1000, a: 3, b: {x: -1}, c: "new"}));
+    assertMatchesCollscan({a: {$in: [3, 100]}}, {a: 1, b: 1});
+    assertMatchesCollscan({}, {a: 1, b: 1});
+
+    // Columns are ordered by _id, whatever its type.
+    assert.commandWorked(coll.insert({_id: {nested: 1}, a: 1}));
+    assertMatchesCollscan({a: 1}, {a: 1, b: 1});
+
+    // Validation does not treat the column keys as extra keys.
+    const res = assert.commandWorked(coll.validate(true));
+    assert(res.valid, tojson(res));
+})();
@@ -0,0 +1,70 @@
+// Tests that a $text query sorted by text score with a limit returns the same highest scoring
+// documents as a sort without a limit, while reading fewer index keys when it can stop early.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStages.
+
+    const coll = db.fts_score_sort_limit;
+    coll.drop();
+
+    // Each document repeats the word "common" a varying number of times, so the documents have
+    // many distinct scores. Only a few documents contain the word "rare".
+    const docs = [];
+    for (let i = 0; i < 200; i++) {
+        const words = [];
+        for (let j = 0; j < (i % 17) + 1; j++) {
+            words.push("common");
+        }
+        words.push("filler" + i);
+        if (i % 40 === 0) {
+            words.push("rare");
+        }
+        if (i % 3 === 0) {
+            words.push("excluded");
+        }
+        docs.push({_id: i, a: words.join(" ")});
+    }
+    assert.commandWorked(coll.insert(docs));
+    assert.commandWorked(coll.createIndex({a: "text"}));
+
+    const proj = {score: {$meta: "textScore"}};
+    const sort = {score: {$meta: "textScore"}};
+
+    // Verifies that sorting by score with 'limit' returns the scores of the first 'limit'
+    // documents of the unlimited sort.
+    function assertTopKMatchesFullSort(search, limit) {
+        const query = {$text: {$search: search}};
+        const expected = coll.find(query, proj).sort(sort).toArray().map((doc) => doc.score);
+        const actual =
+            coll.find(query, proj).sort(sort).limit(limit).toArray().map((doc) => doc.score);
+        assert.eq(actual, expected.slice(0, limit), tojson(query));
+    }
+
+    assertTopKMatchesFullSort("common", 1);
+    assertTopKMatchesFullSort("common", 10);
+    assertTopKMatchesFullSort("common rare", 3);
+    assertTopKMatchesFullSort("common rare", 300);
+    assertTopKMatchesFullSort("rare filler40", 2);
+
+    // Negated terms and phrases are applied before choosing the highest scoring documents.
+    assertTopKMatchesFullSort("common -excluded", 5);
+    assertTopKMatchesFullSort("\"common common common\" rare", 4);
+
+    // The limit pushed into the TEXT stage accounts for a skip.
+    const skipped = coll.find({$text: {$search: "common"}}, proj).sort(sort).skip(5).limit(5);
+    const all = coll.find({$text: {$search: "common"}}, proj).sort(sort).toArray();
+    assert.eq(skipped.toArray().map((doc) => doc.score),
+              all.slice(5, 10).map((doc) => doc.score));
+
+    // Only a prefix of the postings for "common" needs to be read to find the highest scores.
+    const explain = coll.find({$text: {$search: "common"}}, proj)
+                        .sort(sort)
+                        .limit(3)
+                        .explain("executionStats");
+    const ixscans = getPlanStages(explain.executionStats.executionStages, "IXSCAN");
+    assert.eq(ixscans.length, 1, tojson(explain));
+    assert.lt(ixscans[0].keysExamined, 200, tojson(explain));
+    assert.eq(explain.executionStats.nReturned, 3, tojson(explain));
+})();
@@ -9,8 +9,8 @@ t.drop();
 // Include helpers for analyzing explain output.
 load("jstests/libs/analyze_plan.js");
 
-// test non-single field hashed indexes don't get created (maybe change later)
-var badspec = {a: "hashed", b: 1};
+// test hashed indexes with more than one hashed field don't get created
+var badspec = {a: "hashed", b: "hashed"};
 t.ensureIndex(badspec);
 assert.eq(t.getIndexes().length, 1, "only _id index should be created");
 
@@ -36,8 +36,10 @@ assert.commandWorked(coll.ensureIndex({a: "geoHaystack", b: 1}, {bucketSize: 1})
 coll.dropIndexes();
 assert.commandFailed(coll.ensureIndex({a: 1, b: "geoHaystack"}, {bucketSize: 1}));  // unsupported
 
-assert.commandFailed(coll.ensureIndex({a: "hashed", b: 1}));  // unsupported
-assert.commandFailed(coll.ensureIndex({a: 1, b: "hashed"}));  // unsupported
+assert.commandWorked(coll.ensureIndex({a: "hashed", b: 1}));
+coll.dropIndexes();
+assert.commandWorked(coll.ensureIndex({a: 1, b: "hashed"}));
+coll.dropIndexes();
 
 // Test compound index where multiple fields have same special index type.
 
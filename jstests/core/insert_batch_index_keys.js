@@ -0,0 +1,39 @@
+// Tests that the index keys of a batch insert, which are merged into each index in key order, are
+// complete and consistent with the documents, including for multikey and partial indexes.
+// @tags: [assumes_unsharded_collection, requires_fastcount]
+(function() {
+    "use strict";
+
+    const coll = db.insert_batch_index_keys;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: -1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+    assert.commandWorked(coll.createIndex({c: 1}, {partialFilterExpression: {c: {$gt: 50}}}));
+
+    // Documents arrive in an order unrelated to the order of their keys.
+    const docs = [];
+    for (let i = 0; i < 200; i++) {
+        const key = (i * 37) % 200;
+        docs.push({_id: i, a: key, b: [key, key + 1000], c: key});
+    }
+    assert.commandWorked(coll.insert(docs));
+
+    assert.eq(coll.find().hint({a: -1}).itcount(), 200);
+    assert.eq(coll.find({a: {$gte: 100}}).hint({a: -1}).itcount(), 100);
+    assert.eq(coll.find({b: {$gte: 1000}}).hint({b: 1}).itcount(), 200);
+    assert.eq(coll.find({c: {$gt: 150}}).hint({c: 1}).itcount(), 49);
+
+    const explain = coll.find({b: 5}).hint({b: 1}).explain();
+    assert(explain.queryPlanner.winningPlan.inputStage.isMultiKey, tojson(explain));
+
+    const res = assert.commandWorked(coll.validate({full: true}));
+    assert(res.valid, tojson(res));
+
+    // A duplicate key within an ordered batch fails at that document.
+    assert(coll.drop());
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true}));
+    const result = coll.insert([{_id: 0, u: 5}, {_id: 1, u: 3}, {_id: 2, u: 5}, {_id: 3, u: 4}]);
+    assert.writeErrorWithCode(result, ErrorCodes.DuplicateKey);
+    assert.eq(coll.find().sort({_id: 1}).toArray().map((doc) => doc._id), [0, 1]);
+})();
@@ -0,0 +1,35 @@
+// Tests that a batch insert containing failing documents reports an error for exactly those
+// documents, in order, and inserts every other document that it should.
+// @tags: [assumes_unsharded_collection, requires_fastcount]
+(function() {
+    "use strict";
+
+    const coll = db.insert_batch_partial_failure;
+    coll.drop();
+
+    const failingIds = [3, 40, 41, 99];
+    assert.commandWorked(coll.insert(failingIds.map((id) => ({_id: id}))));
+
+    const docs = [];
+    for (let i = 0; i < 100; i++) {
+        docs.push({_id: i, x: i});
+    }
+
+    // An unordered insert inserts all documents but the duplicates.
+    let res = db.runCommand({insert: coll.getName(), documents: docs, ordered: false});
+    assert.commandWorked(res);
+    assert.eq(res.n, docs.length - failingIds.length, tojson(res));
+    assert.eq(res.writeErrors.map((err) => err.index), failingIds, tojson(res));
+    res.writeErrors.forEach((err) => assert.eq(err.code, ErrorCodes.DuplicateKey, tojson(err)));
+    assert.eq(coll.count(), docs.length);
+    assert.eq(coll.count({x: {$exists: true}}), docs.length - failingIds.length);
+
+    // An ordered insert stops at the first failing document.
+    assert(coll.drop());
+    assert.commandWorked(coll.insert(failingIds.map((id) => ({_id: id}))));
+    res = db.runCommand({insert: coll.getName(), documents: docs, ordered: true});
+    assert.eq(res.n, 3, tojson(res));
+    assert.eq(res.writeErrors.length, 1, tojson(res));
+    assert.eq(res.writeErrors[0].index, 3, tojson(res));
+    assert.eq(coll.count({x: {$exists: true}}), 3);
+})();
@@ -41,6 +41,7 @@
         assert(stats.latencyStats.hasOwnProperty(key));
         assert(stats.latencyStats[key].hasOwnProperty("ops"));
         assert(stats.latencyStats[key].hasOwnProperty("latency"));
+        assert(stats.latencyStats[key].hasOwnProperty("percentiles"));
     });
 
     var lastHistogram = getHistogramStats(testColl);
@@ -40,6 +40,9 @@
     assert.eq(profileObj.planSummary, "IXSCAN { a: 1 }", tojson(profileObj));
     assert(profileObj.execStats.hasOwnProperty("stage"), tojson(profileObj));
     assert.eq(profileObj.command.filter, {a: 1}, tojson(profileObj));
+    assert(profileObj.planStageTimesNanos.hasOwnProperty("IXSCAN"), tojson(profileObj));
+    assert(profileObj.planStageTimesNanos.hasOwnProperty("FETCH"), tojson(profileObj));
+    assert(profileObj.execStats.hasOwnProperty("executionTimeNanosEstimate"), tojson(profileObj));
     if (isLegacyReadMode) {
         assert.eq(profileObj.command.ntoreturn, -1, tojson(profileObj));
     } else {
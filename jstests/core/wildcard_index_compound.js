@@ -0,0 +1,64 @@
+/**
+ * Tests that compound $** indexes return correct results, and are only used when the query has a
+ * predicate on a path indexed by the wildcard component.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStages, isCollscan.
+
+    const coll = db.wildcard_index_compound;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({tenantId: 1, "attrs.$**": 1, ts: 1}));
+
+    assert.commandWorked(coll.insert([
+        {_id: 0, tenantId: 1, attrs: {color: "red", size: 3}, ts: 10},
+        {_id: 1, tenantId: 1, attrs: {color: "blue", tags: ["x", "y"]}, ts: 20},
+        {_id: 2, tenantId: 2, attrs: {color: "red"}, ts: 30},
+        {_id: 3, tenantId: 2, ts: 40},
+        {_id: 4, attrs: {color: "red"}},
+    ]));
+
+    // Runs 'query' and verifies that it returns the documents with 'expectedIds', and that it uses
+    // the compound $** index if and only if 'expectIndexScan' is true.
+    function assertQueryResults(query, expectedIds, expectIndexScan) {
+        const ids = coll.find(query).sort({_id: 1}).toArray().map((doc) => doc._id);
+        assert.eq(ids, expectedIds, tojson(query));
+
+        const explain = coll.find(query).explain();
+        const ixscans = getPlanStages(explain.queryPlanner.winningPlan, "IXSCAN");
+        assert.eq(ixscans.length > 0, expectIndexScan, tojson(explain));
+        if (expectIndexScan) {
+            assert.eq(ixscans[0].indexName, "tenantId_1_attrs.$**_1_ts_1", tojson(explain));
+        } else {
+            assert(isCollscan(db, explain.queryPlanner.winningPlan), tojson(explain));
+        }
+    }
+
+    // Predicates on the regular prefix and the wildcard path use bounds on both.
+    assertQueryResults({tenantId: 1, "attrs.color": "red"}, [0], true);
+    assertQueryResults({tenantId: {$gte: 1}, "attrs.color": "red"}, [0, 2], true);
+    assertQueryResults({tenantId: 1, "attrs.tags": "y"}, [1], true);
+
+    // A predicate on the regular suffix is applied alongside the wildcard path.
+    assertQueryResults({tenantId: 2, "attrs.color": "red", ts: {$gt: 25}}, [2], true);
+    assertQueryResults({tenantId: 1, "attrs.size": {$exists: true}, ts: {$lt: 15}}, [0], true);
+
+    // Like a single-field $** index, the compound index is treated as sparse, and so it is not used
+    // to answer equality to null.
+    assertQueryResults({tenantId: null, "attrs.color": "red"}, [4], false);
+
+    // Without a predicate on the wildcard path, documents lacking any 'attrs' fields would be
+    // missed, so the index is not used.
+    assertQueryResults({tenantId: 2}, [2, 3], false);
+    assertQueryResults({tenantId: 2, ts: {$gte: 0}}, [2, 3], false);
+
+    // Updating a regular field maintains the index keys.
+    assert.commandWorked(coll.update({_id: 3}, {$set: {tenantId: 1, attrs: {color: "red"}}}));
+    assertQueryResults({tenantId: 1, "attrs.color": "red"}, [0, 3], true);
+
+    // Arrays are not permitted in the regular fields.
+    assert.commandFailedWithCode(coll.insert({tenantId: [1, 2], attrs: {color: "red"}}), 51011);
+    assert.commandFailedWithCode(coll.update({_id: 0}, {$set: {ts: [1]}}), 51011);
+})();
@@ -99,11 +99,34 @@
     assert.commandFailedWithCode(coll.createIndex({"$**": "wildcard"}),
                                  ErrorCodes.CannotCreateIndex);
 
-    // Cannot create a compound wildcard index.
+    // Can create a compound wildcard index whose regular fields lie outside of the wildcard paths.
+    createIndexAndVerifyWithDrop({"a": 1, "b.$**": 1, "c": 1}, {name: kIndexName});
+    createIndexAndVerifyWithDrop({"a": 1, "$**": 1}, {name: kIndexName, wildcardProjection: {a: 0}});
+    createIndexAndVerifyWithDrop({"$**": 1, "a": 1},
+                                 {name: kIndexName, wildcardProjection: {b: 1, c: 1}});
+
+    // Cannot create a compound wildcard index on all paths without a projection excluding its
+    // regular fields.
     assert.commandFailedWithCode(coll.createIndex({"$**": 1, "a": 1}),
                                  ErrorCodes.CannotCreateIndex);
     assert.commandFailedWithCode(coll.createIndex({"a": 1, "$**": 1}),
                                  ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(
+        createIndexHelper({"a.b": 1, "$**": 1}, {name: kIndexName, wildcardProjection: {a: 1}}),
+        ErrorCodes.CannotCreateIndex);
+
+    // Cannot create a compound wildcard index whose regular fields overlap the wildcard subtree.
+    assert.commandFailedWithCode(coll.createIndex({"a": 1, "a.b.$**": 1}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({"a.b.c": 1, "a.b.$**": 1}),
+                                 ErrorCodes.CannotCreateIndex);
+
+    // Cannot create a wildcard index with more than one wildcard component, or with a descending
+    // regular field.
+    assert.commandFailedWithCode(coll.createIndex({"a.$**": 1, "b.$**": 1}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({"a": -1, "b.$**": 1}),
+                                 ErrorCodes.CannotCreateIndex);
 
     // Cannot create an wildcard index with an invalid spec.
     assert.commandFailedWithCode(coll.createIndex({"a.$**.$**": 1}), ErrorCodes.CannotCreateIndex);
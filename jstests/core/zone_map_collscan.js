@@ -0,0 +1,77 @@
+// Tests that collection scans over a collection created with a 'zoneMap' option return the same
+// results as without it, and skip blocks of records which cannot match when the storage engine
+// supports zone maps.
+// @tags: [assumes_unsharded_collection, assumes_no_implicit_collection_creation_after_drop]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStages.
+
+    const coll = db.zone_map_collscan;
+    coll.drop();
+
+    assert.commandFailedWithCode(db.createCollection(coll.getName(), {zoneMap: {fields: []}}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        db.createCollection(coll.getName(), {zoneMap: {fields: ["ts"], unknown: 1}}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        db.createCollection(coll.getName(),
+                            {capped: true, size: 4096, zoneMap: {fields: ["ts"]}}),
+        ErrorCodes.BadValue);
+
+    assert.commandWorked(
+        db.createCollection(coll.getName(), {zoneMap: {fields: ["ts", "m.v"], blockSize: 16}}));
+    const collInfo = db.getCollectionInfos({name: coll.getName()})[0];
+    assert.eq(collInfo.options.zoneMap, {fields: ["ts", "m.v"], blockSize: 16}, tojson(collInfo));
+
+    // Append-only, increasing 'ts' values.
+    const docs = [];
+    for (let i = 0; i < 1000; i++) {
+        docs.push({_id: i, ts: new Date(i * 1000), m: {v: i % 100}});
+    }
+    assert.commandWorked(coll.insert(docs));
+
+    // Verifies that 'query' returns the documents with ids in ['minId', 'maxId'], and returns the
+    // COLLSCAN stage of its execution stats.
+    function assertResults(query, minId, maxId) {
+        const ids = coll.find(query).hint({$natural: 1}).toArray().map((doc) => doc._id);
+        const expected = [];
+        for (let i = minId; i <= maxId; i++) {
+            expected.push(i);
+        }
+        assert.eq(ids, expected, tojson(query));
+
+        const explain = coll.find(query).hint({$natural: 1}).explain("executionStats");
+        const collScans = getPlanStages(explain.executionStats.executionStages, "COLLSCAN");
+        assert.eq(collScans.length, 1, tojson(explain));
+        return collScans[0];
+    }
+
+    const rangeQuery = {ts: {$gte: new Date(900 * 1000), $lt: new Date(910 * 1000)}};
+    let collScan = assertResults(rangeQuery, 900, 909);
+    if (collScan.hasOwnProperty("zoneMapSkips")) {
+        assert.gt(collScan.zoneMapSkips, 0, tojson(collScan));
+        assert.lt(collScan.docsExamined, 200, tojson(collScan));
+    }
+
+    // Nothing after the matching range needs to be read either.
+    collScan = assertResults({ts: {$lt: new Date(20 * 1000)}}, 0, 19);
+    if (collScan.hasOwnProperty("zoneMapSkips")) {
+        assert.lt(collScan.docsExamined, 100, tojson(collScan));
+    }
+
+    // Predicates which the zone map cannot use are still applied.
+    assertResults({ts: {$gte: new Date(990 * 1000)}, "m.v": {$gte: 90}}, 990, 999);
+    assertResults({ts: {$gte: new Date(995 * 1000)}, _id: {$ne: -1}}, 995, 999);
+    assertResults({$or: [{ts: new Date(5 * 1000)}, {ts: new Date(6 * 1000)}]}, 5, 6);
+
+    // Updates widen the bounds, so updated documents are still found.
+    assert.commandWorked(coll.update({_id: 500}, {$set: {ts: new Date(905500)}}));
+    const ids = coll.find(rangeQuery).hint({$natural: 1}).toArray().map((doc) => doc._id);
+    assert.eq(ids, [500, 900, 901, 902, 903, 904, 905, 906, 907, 908, 909]);
+
+    // Arrays along a tracked path are matched element-wise.
+    assert.commandWorked(coll.insert({_id: 1000, ts: [new Date(0), new Date(2000000)]}));
+    assert.eq(coll.find({ts: {$gt: new Date(1500000)}}).hint({$natural: 1}).itcount(), 1);
+})();
@@ -57,6 +57,7 @@ function verifyCommonFTDCParameters(adminDb, isEnabled) {
     // Verify the defaults are as we documented them
     assert.eq(getparam("diagnosticDataCollectionEnabled"), isEnabled);
     assert.eq(getparam("diagnosticDataCollectionPeriodMillis"), 1000);
+    assert.eq(getparam("diagnosticDataCollectionHighFrequencyPeriodMillis"), 0);
     assert.eq(getparam("diagnosticDataCollectionDirectorySizeMB"), 200);
     assert.eq(getparam("diagnosticDataCollectionFileSizeMB"), 10);
     assert.eq(getparam("diagnosticDataCollectionSamplesPerChunk"), 300);
@@ -73,6 +74,7 @@ function verifyCommonFTDCParameters(adminDb, isEnabled) {
         assert.commandWorked(setparam({"diagnosticDataCollectionEnabled": 1}));
     }
     assert.commandWorked(setparam({"diagnosticDataCollectionPeriodMillis": 100}));
+    assert.commandWorked(setparam({"diagnosticDataCollectionHighFrequencyPeriodMillis": 10}));
     assert.commandWorked(setparam({"diagnosticDataCollectionDirectorySizeMB": 10}));
     assert.commandWorked(setparam({"diagnosticDataCollectionFileSizeMB": 1}));
     assert.commandWorked(setparam({"diagnosticDataCollectionSamplesPerChunk": 2}));
@@ -80,6 +82,8 @@ function verifyCommonFTDCParameters(adminDb, isEnabled) {
 
     // Negative tests - set values below minimums
     assert.commandFailed(setparam({"diagnosticDataCollectionPeriodMillis": 1}));
+    assert.commandFailed(setparam({"diagnosticDataCollectionHighFrequencyPeriodMillis": 1}));
+    assert.commandFailed(setparam({"diagnosticDataCollectionHighFrequencyPeriodMillis": 1001}));
     assert.commandFailed(setparam({"diagnosticDataCollectionDirectorySizeMB": 1}));
     assert.commandFailed(setparam({"diagnosticDataCollectionSamplesPerChunk": 1}));
     assert.commandFailed(setparam({"diagnosticDataCollectionSamplesPerInterimUpdate": 1}));
@@ -97,6 +101,7 @@ function verifyCommonFTDCParameters(adminDb, isEnabled) {
     assert.commandWorked(setparam({"diagnosticDataCollectionFileSizeMB": 10}));
     assert.commandWorked(setparam({"diagnosticDataCollectionDirectorySizeMB": 200}));
     assert.commandWorked(setparam({"diagnosticDataCollectionPeriodMillis": 1000}));
+    assert.commandWorked(setparam({"diagnosticDataCollectionHighFrequencyPeriodMillis": 0}));
     assert.commandWorked(setparam({"diagnosticDataCollectionSamplesPerChunk": 300}));
     assert.commandWorked(setparam({"diagnosticDataCollectionSamplesPerInterimUpdate": 10}));
 }
\ No newline at end of file
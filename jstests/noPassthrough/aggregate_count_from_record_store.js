@@ -0,0 +1,70 @@
+/**
+ * Tests that an aggregation which only counts every document of a collection takes the count from
+ * the record store instead of scanning the collection, but only when that count is exact: not while
+ * a transaction has uncommitted writes to the collection, and not inside a transaction.
+ *
+ * @tags: [requires_wiredtiger, uses_transactions]
+ */
+(function() {
+    'use strict';
+
+    const replTest = new ReplSetTest({nodes: 1});
+    replTest.startSet();
+    replTest.initiate();
+
+    const primary = replTest.getPrimary();
+    const testDB = primary.getDB('test');
+    const coll = testDB.aggregate_count_from_record_store;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; i++) {
+        bulk.insert({_id: i, x: i % 10});
+    }
+    assert.writeOK(bulk.execute({w: 'majority'}));
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    // Runs 'pipeline', and returns its result with the number of documents it examined.
+    let numRuns = 0;
+    function runCount(pipeline) {
+        const comment = 'count ' + numRuns++;
+        const result = coll.aggregate(pipeline, {comment: comment}).toArray();
+        const entry = testDB.system.profile.findOne({'command.comment': comment});
+        assert.neq(entry, null, comment);
+        return {result: result, docsExamined: entry.docsExamined || 0};
+    }
+
+    // $count, and the pipeline of countDocuments({}), read no document.
+    assert.eq(runCount([{$count: 'n'}]), {result: [{n: 100}], docsExamined: 0});
+    assert.eq(runCount([{$match: {}}, {$group: {_id: 1, n: {$sum: 1}}}]),
+              {result: [{_id: 1, n: 100}], docsExamined: 0});
+    assert.eq(runCount([{$group: {_id: null, n: {$sum: 1}, twice: {$sum: 2}}}]),
+              {result: [{_id: null, n: 100, twice: 200}], docsExamined: 0});
+
+    // Filtered counts, and sums of fields, still read the documents.
+    assert.eq(runCount([{$match: {x: 3}}, {$count: 'n'}]), {result: [{n: 10}], docsExamined: 100});
+    assert.eq(runCount([{$group: {_id: null, total: {$sum: '$x'}}}]),
+              {result: [{_id: null, total: 450}], docsExamined: 100});
+
+    // An empty collection has no groups.
+    assert.commandWorked(testDB.createCollection('empty'));
+    assert.eq(testDB.empty.aggregate([{$count: 'n'}]).toArray(), []);
+
+    // While a transaction has uncommitted inserts, the count is taken by scanning, and does not
+    // include them.
+    const session = primary.startSession();
+    const sessionColl = session.getDatabase('test').getCollection(coll.getName());
+    session.startTransaction();
+    for (let i = 100; i < 105; i++) {
+        assert.writeOK(sessionColl.insert({_id: i}));
+    }
+    assert.eq(runCount([{$count: 'n'}]), {result: [{n: 100}], docsExamined: 100});
+    assert.eq(sessionColl.aggregate([{$count: 'n'}]).toArray(), [{n: 105}]);
+    session.abortTransaction();
+
+    assert.eq(runCount([{$count: 'n'}]), {result: [{n: 100}], docsExamined: 0});
+    assert.writeOK(coll.remove({x: 0}));
+    assert.eq(runCount([{$count: 'n'}]), {result: [{n: 90}], docsExamined: 0});
+
+    session.endSession();
+    replTest.stopSet();
+})();
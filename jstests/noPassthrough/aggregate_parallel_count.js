@@ -0,0 +1,63 @@
+// Tests that an aggregation on a replica set primary which only counts the documents of a
+// collection scan returns the same counts when the scan is split between several threads.
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+    load("jstests/noPassthrough/libs/server_parameter_helpers.js");
+
+    testNumericServerParameter("internalQueryParallelCountThreads",
+                               true,  // is Startup Param
+                               true,  // is runtime param
+                               0,     // default value
+                               4,     // valid, non-default value
+                               true,  // has lower bound
+                               -1,    // out of bound value (below lower bound)
+                               true,  // has upper bound
+                               65     // out of bounds value (above upper bound)
+                               );
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    const coll = testDB.parallel_count;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; i++) {
+        bulk.insert({_id: i, x: i % 10, s: "s" + i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipelines = [
+        [{$match: {x: 3}}, {$count: "n"}],
+        [{$match: {x: {$lt: 4}, s: /1$/}}, {$group: {_id: null, n: {$sum: 1}}}],
+        [{$match: {x: 42}}, {$count: "n"}],
+    ];
+    const serial = pipelines.map(pipeline => coll.aggregate(pipeline).toArray());
+    assert.eq(serial[0], [{n: 500}]);
+    assert.eq(serial[2], []);
+
+    assert.commandWorked(
+        primary.adminCommand({setParameter: 1, internalQueryParallelCountThreads: 4}));
+    assert.commandWorked(
+        primary.adminCommand({setParameter: 1, internalQueryParallelCountMinRecords: 1000}));
+    assert.commandWorked(
+        primary.adminCommand({setParameter: 1, logComponentVerbosity: {query: {verbosity: 1}}}));
+
+    for (let i = 0; i < pipelines.length; i++) {
+        assert.eq(coll.aggregate(pipelines[i]).toArray(), serial[i], tojson(pipelines[i]));
+    }
+    assert.eq(coll.countDocuments({x: {$gte: 5}}), 2500);
+    checkLog.contains(primary, "documents of test.parallel_count in");
+
+    // The count includes the writes this client just made.
+    assert.writeOK(coll.insert({_id: "new", x: 3}));
+    assert.eq(coll.aggregate(pipelines[0]).toArray(), [{n: 501}]);
+    assert.writeOK(coll.remove({x: 3}));
+    assert.eq(coll.countDocuments({x: 3}), 0);
+
+    rst.stopSet();
+})();
@@ -0,0 +1,93 @@
+// Tests that the results of deterministic aggregations are served from the aggregation result cache
+// until a collection they read is written.
+(function() {
+    "use strict";
+
+    load("jstests/noPassthrough/libs/server_parameter_helpers.js");
+
+    testNumericServerParameter("aggregationResultCacheSizeBytes",
+                               true,     // is Startup Param
+                               true,     // is runtime param
+                               0,        // default value
+                               1024,     // valid, non-default value
+                               true,     // has lower bound
+                               -1,       // out of bound value (below lower bound)
+                               false,    // has upper bound
+                               "unused"  // out of bounds value (above upper bound)
+                               );
+
+    const conn =
+        MongoRunner.runMongod({setParameter: {aggregationResultCacheSizeBytes: 1024 * 1024}});
+    const testDB = conn.getDB("test");
+    const coll = testDB.aggregation_result_cache;
+    const other = testDB.aggregation_result_cache_other;
+    coll.drop();
+    other.drop();
+
+    function cacheMetrics() {
+        return testDB.serverStatus().metrics.aggregationResultCache;
+    }
+
+    function checkMetricsChange(before, hits, misses) {
+        const after = cacheMetrics();
+        assert.eq(after.hits - before.hits, hits, tojson(after));
+        assert.eq(after.misses - before.misses, misses, tojson(after));
+    }
+
+    for (let i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i, g: i % 3}));
+        assert.writeOK(other.insert({_id: i, g: i % 3}));
+    }
+
+    const pipeline = [{$group: {_id: "$g", n: {$sum: 1}}}, {$sort: {_id: 1}}];
+    const expected = [{_id: 0, n: 4}, {_id: 1, n: 3}, {_id: 2, n: 3}];
+
+    // The first run is a miss, and the second is answered from the cache.
+    let before = cacheMetrics();
+    assert.eq(coll.aggregate(pipeline).toArray(), expected);
+    checkMetricsChange(before, 0, 1);
+
+    before = cacheMetrics();
+    assert.eq(coll.aggregate(pipeline).toArray(), expected);
+    checkMetricsChange(before, 1, 0);
+
+    // A write to another collection leaves the entry valid.
+    assert.writeOK(other.insert({_id: 10, g: 0}));
+    before = cacheMetrics();
+    assert.eq(coll.aggregate(pipeline).toArray(), expected);
+    checkMetricsChange(before, 1, 0);
+
+    // A write to the source collection invalidates it.
+    assert.writeOK(coll.insert({_id: 10, g: 0}));
+    before = cacheMetrics();
+    assert.eq(coll.aggregate(pipeline).toArray(), [{_id: 0, n: 5}, {_id: 1, n: 3}, {_id: 2, n: 3}]);
+    checkMetricsChange(before, 0, 1);
+
+    // An entry which read a foreign collection is invalidated by writes to it.
+    const lookupPipeline = [
+        {$match: {_id: 0}},
+        {$lookup: {from: other.getName(), localField: "g", foreignField: "g", as: "same"}},
+        {$project: {n: {$size: "$same"}}}
+    ];
+    assert.eq(coll.aggregate(lookupPipeline).toArray(), [{_id: 0, n: 5}]);
+    assert.eq(coll.aggregate(lookupPipeline).toArray(), [{_id: 0, n: 5}]);
+    assert.writeOK(other.remove({_id: 10}));
+    assert.eq(coll.aggregate(lookupPipeline).toArray(), [{_id: 0, n: 4}]);
+
+    // Non-deterministic pipelines, explains and results larger than the first batch are not cached.
+    before = cacheMetrics();
+    assert.eq(coll.aggregate([{$sample: {size: 1}}]).itcount(), 1);
+    assert.commandWorked(coll.explain().aggregate(pipeline));
+    assert.eq(coll.aggregate([{$sort: {_id: 1}}], {cursor: {batchSize: 2}}).itcount(), 11);
+    assert.eq(coll.aggregate([{$sort: {_id: 1}}], {cursor: {batchSize: 2}}).itcount(), 11);
+    checkMetricsChange(before, 0, 2);
+
+    // Setting the budget to zero disables the cache.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, aggregationResultCacheSizeBytes: 0}));
+    before = cacheMetrics();
+    assert.eq(coll.aggregate(pipeline).toArray(), [{_id: 0, n: 5}, {_id: 1, n: 3}, {_id: 2, n: 3}]);
+    checkMetricsChange(before, 0, 0);
+
+    MongoRunner.stopMongod(conn);
+})();
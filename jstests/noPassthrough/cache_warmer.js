@@ -0,0 +1,48 @@
+// Tests that mongod saves the collections and indexes in use, and pre-loads them after a restart.
+(function() {
+    'use strict';
+
+    let conn = MongoRunner.runMongod({setParameter: {cacheWarmerPersistIntervalSecs: 1}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    let testDB = conn.getDB('test');
+    const coll = testDB.cache_warmer;
+    assert.commandWorked(coll.createIndex({a: 1}));
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i, s: 'x'.repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+    for (let i = 0; i < 10; i++) {
+        assert.eq(1, coll.find({a: i}).itcount());
+    }
+
+    function metrics(db) {
+        return assert.commandWorked(db.adminCommand({serverStatus: 1})).metrics.cacheWarmer;
+    }
+
+    // Wait for a hot list saved after the queries above. Usage scores halve every time the list is
+    // saved, so restart soon after.
+    const persists = metrics(testDB).persists;
+    assert.soon(() => metrics(testDB).persists > persists + 1);
+    assert.eq(0, metrics(testDB).preloadedBytes);
+
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({restart: conn, cleanData: false});
+    assert.neq(null, conn, 'mongod was unable to restart');
+
+    // The index and the documents are read back, about 1000 keys and 1000 documents of 100 bytes.
+    testDB = conn.getDB('test');
+    assert.soon(() => metrics(testDB).preloadedBytes >= 1000 * 100, () => tojson(metrics(testDB)));
+
+    // Nothing is pre-loaded when the warmer is disabled.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(
+        {restart: conn, cleanData: false, setParameter: {cacheWarmerEnabled: false}});
+    assert.neq(null, conn, 'mongod was unable to restart');
+    testDB = conn.getDB('test');
+    sleep(1000);
+    assert.eq(0, metrics(testDB).preloadedBytes);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -32,6 +32,8 @@
         // when we need to test.
         assert.commandWorked(
             testDB.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 1}));
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalQueryExecUncontendedYieldPeriodMS: 0}));
         assert.commandWorked(testDB.adminCommand(
             {configureFailPoint: "hangBeforeChildRemoveOpFinishes", mode: "alwaysOn"}));
         assert.commandWorked(testDB.adminCommand(
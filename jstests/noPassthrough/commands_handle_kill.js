@@ -12,6 +12,8 @@
     const yieldIterations = 2;
     assert.commandWorked(
         db.adminCommand({setParameter: 1, internalQueryExecYieldIterations: yieldIterations}));
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryExecUncontendedYieldPeriodMS: 0}));
     const nDocs = yieldIterations + 2;
 
     /**
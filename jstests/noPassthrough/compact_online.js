@@ -0,0 +1,51 @@
+/**
+ * Tests that an online compact runs on a replica set primary without blocking writes to the
+ * collection, and leaves the collection and its indexes intact.
+ *
+ * @tags: [requires_replication, requires_wiredtiger]
+ */
+(function() {
+    'use strict';
+
+    const replTest = new ReplSetTest({
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        nodeOptions: {setParameter: {onlineCompactionStepSecs: 1}}
+    });
+    replTest.startSet();
+    replTest.initiate();
+
+    const primary = replTest.getPrimary();
+    const testDB = primary.getDB('test');
+    const coll = testDB.compact_online;
+
+    assert.commandWorked(coll.createIndex({x: 1}));
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, x: i, padding: 'x'.repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.remove({_id: {$mod: [2, 0]}}));
+
+    // An offline compact still refuses to run on a primary without force.
+    assert.commandFailed(testDB.runCommand({compact: coll.getName()}));
+
+    assert.commandFailedWithCode(
+        primary.adminCommand({setParameter: 1, onlineCompactionStepSecs: 0}), ErrorCodes.BadValue);
+
+    // Writes to the collection proceed while the online compact runs.
+    const awaitWrites = startParallelShell(function() {
+        const coll = db.getSiblingDB('test').compact_online;
+        for (let i = 0; i < 100; i++) {
+            assert.writeOK(coll.insert({_id: 'concurrent' + i, x: -1}));
+        }
+    }, primary.port);
+    assert.commandWorked(testDB.runCommand({compact: coll.getName(), online: true}));
+    awaitWrites();
+
+    assert.eq(coll.getIndexes().length, 2);
+    assert.eq(coll.find().itcount(), 5100);
+    assert.eq(coll.find({x: 1}).itcount(), 1);
+    assert.eq(coll.find({x: -1}).hint({x: 1}).itcount(), 100);
+
+    replTest.stopSet();
+})();
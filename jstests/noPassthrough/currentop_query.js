@@ -12,12 +12,19 @@
 
     load("jstests/libs/fixture_helpers.js");  // For FixtureHelpers.
 
-    // Set up a 2-shard cluster. Configure 'internalQueryExecYieldIterations' on both shards such
-    // that operations will yield on each PlanExecuter iteration.
+    // Set up a 2-shard cluster. Configure 'internalQueryExecYieldIterations' and
+    // 'internalQueryExecUncontendedYieldPeriodMS' on both shards such that operations will yield on
+    // each PlanExecuter iteration.
     const st = new ShardingTest({
         name: jsTestName(),
         shards: 2,
-        rs: {nodes: 1, setParameter: {internalQueryExecYieldIterations: 1}}
+        rs: {
+            nodes: 1,
+            setParameter: {
+                internalQueryExecYieldIterations: 1,
+                internalQueryExecUncontendedYieldPeriodMS: 0
+            }
+        }
     });
 
     // Obtain one mongoS connection and a second direct to the shard.
@@ -0,0 +1,38 @@
+// Tests that serverStatus reports the number of attempts to pin a cursor and the time they took.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    const testDB = conn.getDB("test");
+    const coll = testDB.cursor_pin_metrics;
+    assert.commandWorked(coll.insert([{_id: 0}, {_id: 1}, {_id: 2}, {_id: 3}]));
+
+    function pinMetrics() {
+        return testDB.serverStatus().metrics.cursor.pin;
+    }
+
+    const before = pinMetrics();
+    const res = assert.commandWorked(testDB.runCommand({find: coll.getName(), batchSize: 1}));
+    const cursorId = res.cursor.id;
+    for (let i = 0; i < 2; i++) {
+        assert.commandWorked(
+            testDB.runCommand({getMore: cursorId, collection: coll.getName(), batchSize: 1}));
+    }
+
+    const after = pinMetrics();
+    assert.gte(after.total - before.total, 2, tojson({before: before, after: after}));
+    assert.gte(after.totalMicros, before.totalMicros, tojson({before: before, after: after}));
+
+    // An unknown cursor still counts as a pin attempt.
+    assert.commandFailedWithCode(
+        testDB.runCommand({getMore: NumberLong(123456), collection: coll.getName()}),
+        ErrorCodes.CursorNotFound);
+    assert.gt(pinMetrics().total, after.total);
+
+    // The cursor is unpinned after each getMore, so it can be exhausted.
+    const last =
+        assert.commandWorked(testDB.runCommand({getMore: cursorId, collection: coll.getName()}));
+    assert.eq(last.cursor.nextBatch, [{_id: 3}]);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,57 @@
+// Tests that the dbHash command returns the same hashes when the collections of a replica set
+// member are hashed by several threads at a common timestamp.
+(function() {
+    "use strict";
+
+    load("jstests/noPassthrough/libs/server_parameter_helpers.js");
+
+    testNumericServerParameter("dbHashThreads",
+                               true,  // is Startup Param
+                               true,  // is runtime param
+                               1,     // default value
+                               4,     // valid, non-default value
+                               true,  // has lower bound
+                               0,     // out of bound value (below lower bound)
+                               true,  // has upper bound
+                               65     // out of bounds value (above upper bound)
+                               );
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+
+    for (let i = 0; i < 10; i++) {
+        const bulk = testDB["coll" + i].initializeUnorderedBulkOp();
+        for (let j = 0; j < 100 * i; j++) {
+            bulk.insert({_id: j, x: i * j});
+        }
+        assert.writeOK(bulk.execute());
+    }
+    assert.commandWorked(testDB.createCollection("capped", {capped: true, size: 4096}));
+    assert.writeOK(testDB.capped.insert({x: 1}));
+
+    const serial = assert.commandWorked(testDB.runCommand({dbHash: 1}));
+
+    assert.commandWorked(primary.adminCommand({setParameter: 1, dbHashThreads: 4}));
+    let parallel = assert.commandWorked(testDB.runCommand({dbHash: 1}));
+    assert.eq(parallel.md5, serial.md5, tojson(parallel));
+    assert.eq(parallel.collections, serial.collections, tojson(parallel));
+    assert.eq(parallel.capped, ["capped"], tojson(parallel));
+    assert.eq(parallel.uuids, serial.uuids, tojson(parallel));
+
+    parallel =
+        assert.commandWorked(testDB.runCommand({dbHash: 1, collections: ["coll3", "coll7"]}));
+    assert.eq(Object.keys(parallel.collections).sort(), ["coll3", "coll7"], tojson(parallel));
+    assert.eq(parallel.collections.coll3, serial.collections.coll3, tojson(parallel));
+
+    // A change to the data changes the hash of the collection.
+    assert.writeOK(testDB.coll5.insert({_id: "new"}));
+    parallel = assert.commandWorked(testDB.runCommand({dbHash: 1}));
+    assert.neq(parallel.collections.coll5, serial.collections.coll5, tojson(parallel));
+    assert.eq(parallel.collections.coll6, serial.collections.coll6, tojson(parallel));
+
+    rst.stopSet();
+})();
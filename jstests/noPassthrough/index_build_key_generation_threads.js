@@ -0,0 +1,52 @@
+// Tests foreground index builds which generate and sort their keys on several threads.
+(function() {
+    'use strict';
+
+    load("jstests/libs/analyze_plan.js");
+
+    const conn = MongoRunner.runMongod({setParameter: "maxIndexBuildKeyGenerationThreads=4"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const coll = conn.getDB("test").index_build_key_generation_threads;
+
+    // Use enough documents for several batches, and a count which does not divide into them.
+    const numDocs = 10 * 1000 + 17;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        const doc = {_id: i, a: (i * 7919) % numDocs, u: i};
+        if (i === numDocs - 1) {
+            // Only one document, handled by a single thread, makes the index on 'b' multikey.
+            doc.b = [1, 2];
+        } else {
+            doc.b = i % 10;
+        }
+        // The only duplicate values of 'd' are far enough apart to be handled by different
+        // threads.
+        doc.d = (i === numDocs - 42) ? 42 : i;
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: -1}));
+
+    // The keys from all threads are merged into a single sorted index.
+    const aValues = coll.find({}, {_id: 0, a: 1}).hint({a: 1}).toArray().map(doc => doc.a);
+    assert.eq(numDocs, aValues.length);
+    for (let i = 0; i < aValues.length; i++) {
+        assert.eq(i, aValues[i]);
+    }
+    assert.eq(numDocs, coll.find({b: {$gte: 0}}).hint({b: -1}).itcount());
+
+    // The multikey state of every thread is taken into account.
+    let explain = coll.find({a: 5}).hint({a: 1}).explain();
+    assert(!getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN").isMultiKey);
+    explain = coll.find({b: 1}).hint({b: -1}).explain();
+    assert(getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN").isMultiKey);
+
+    // Duplicate keys generated by different threads are detected.
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true}));
+    assert.commandFailedWithCode(coll.createIndex({d: 1}, {unique: true}),
+                                 ErrorCodes.DuplicateKey);
+
+    assert.eq(0, MongoRunner.stopMongod(conn));
+})();
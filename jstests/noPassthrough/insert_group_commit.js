@@ -0,0 +1,56 @@
+// Tests that concurrent single-document inserts which are merged into groups by
+// insertGroupCommitWindowMicros each insert their document once, and that a document which fails
+// to insert only fails its own insert.
+(function() {
+    "use strict";
+
+    load("jstests/noPassthrough/libs/server_parameter_helpers.js");
+
+    testNumericServerParameter("insertGroupCommitWindowMicros",
+                               true,    // is Startup Param
+                               true,    // is runtime param
+                               0,       // default value
+                               500,     // valid, non-default value
+                               true,    // has lower bound
+                               -1,      // out of bound value (below lower bound)
+                               true,    // has upper bound
+                               100001   // out of bounds value (above upper bound)
+                               );
+
+    const rst = new ReplSetTest(
+        {nodes: 1, nodeOptions: {setParameter: {insertGroupCommitWindowMicros: 2000}}});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB("test").insert_group_commit;
+    assert.writeOK(coll.insert({_id: "existing"}));
+
+    const numShells = 8;
+    const docsPerShell = 200;
+    const shells = [];
+    for (let shell = 0; shell < numShells; shell++) {
+        shells.push(startParallelShell(funWithArgs(function(shell, docsPerShell) {
+            const coll = db.getSiblingDB("test").insert_group_commit;
+            for (let i = 0; i < docsPerShell; i++) {
+                assert.writeOK(coll.insert({_id: shell * docsPerShell + i}));
+
+                // A duplicate fails on its own, without failing the inserts grouped with it.
+                if (i % 50 === 0) {
+                    const res = coll.insert({_id: "existing"});
+                    assert.writeErrorWithCode(res, ErrorCodes.DuplicateKey);
+                }
+            }
+        }, shell, docsPerShell), primary.port));
+    }
+    shells.forEach((join) => join());
+
+    assert.eq(coll.find().itcount(), numShells * docsPerShell + 1);
+
+    // Each document has its own oplog entry.
+    const oplog = primary.getDB("local").oplog.rs;
+    assert.eq(oplog.find({ns: coll.getFullName(), op: "i"}).itcount(),
+              numShells * docsPerShell + 1);
+
+    rst.stopSet();
+})();
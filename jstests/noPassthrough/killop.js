@@ -16,6 +16,8 @@
 
         assert.commandWorked(
             shardConn.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 1}));
+        assert.commandWorked(shardConn.adminCommand(
+            {setParameter: 1, internalQueryExecUncontendedYieldPeriodMS: 0}));
         assert.commandWorked(shardConn.adminCommand(
             {"configureFailPoint": "setYieldAllLocksHang", "mode": "alwaysOn"}));
 
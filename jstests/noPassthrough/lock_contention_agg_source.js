@@ -0,0 +1,68 @@
+/**
+ * Tests for the $lockContention aggregation metadata source and the lock contention profiler.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {lockContentionSampleRate: 1}});
+    assert.neq(null, conn, "mongod failed to start up");
+
+    const adminDb = conn.getDB("admin");
+    const testDb = conn.getDB("test");
+    const coll = testDb.lock_contention_agg_source;
+
+    function getSamples() {
+        return adminDb.aggregate([{$lockContention: {}}, {$match: {"resource.ns": "test"}}])
+            .toArray();
+    }
+
+    // Must be run as a collectionless aggregate on the admin database.
+    assert.commandFailedWithCode(
+        testDb.runCommand({aggregate: 1, pipeline: [{$lockContention: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+    assert.commandFailedWithCode(
+        adminDb.runCommand({aggregate: 1, pipeline: [{$lockContention: {a: 1}}], cursor: {}}),
+        ErrorCodes.FailedToParse);
+
+    assert.writeOK(coll.insert({_id: 0}));
+    assert.eq(0, getSamples().length);
+
+    // Hold the database lock exclusively from another connection, and make an insert wait on it.
+    const awaitSleep = startParallelShell(() => {
+        assert.commandWorked(
+            db.adminCommand({sleep: 1, lock: "w", lockTarget: "test", secs: 2}));
+    }, conn.port);
+    assert.soon(() => adminDb.aggregate([
+                             {$currentOp: {}},
+                             {$match: {"command.sleep": 1, "locks.Database": "W"}}
+                         ])
+                          .itcount() === 1);
+    assert.writeOK(coll.insert({_id: 1}));
+    awaitSleep();
+
+    const samples = getSamples();
+    assert.gte(samples.length, 1, tojson(samples));
+    const sample = samples[0];
+    assert.eq("Database", sample.resource.type, tojson(sample));
+    assert.eq("insert", sample.opType, tojson(sample));
+    assert.eq("granted", sample.result, tojson(sample));
+    assert.gt(sample.waitMicros, 0, tojson(sample));
+    assert.eq([{mode: "X", opType: "sleep"}], sample.holders, tojson(sample));
+
+    // Turning the profiler off stops sampling.
+    assert.commandWorked(adminDb.runCommand({setParameter: 1, lockContentionSampleRate: 0}));
+    const awaitSleepAgain = startParallelShell(() => {
+        assert.commandWorked(
+            db.adminCommand({sleep: 1, lock: "w", lockTarget: "test", secs: 1}));
+    }, conn.port);
+    assert.soon(() => adminDb.aggregate([
+                             {$currentOp: {}},
+                             {$match: {"command.sleep": 1, "locks.Database": "W"}}
+                         ])
+                          .itcount() === 1);
+    assert.writeOK(coll.insert({_id: 2}));
+    awaitSleepAgain();
+    assert.eq(samples.length, getSamples().length);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,83 @@
+// Tests that a mapReduce whose map function runs on several threads returns the same results as one
+// which maps on the thread running the command.
+(function() {
+    "use strict";
+
+    load("jstests/noPassthrough/libs/server_parameter_helpers.js");
+
+    testNumericServerParameter("mapReduceMapThreads",
+                               true,  // is Startup Param
+                               true,  // is runtime param
+                               1,     // default value
+                               4,     // valid, non-default value
+                               true,  // has lower bound
+                               0,     // out of bound value (below lower bound)
+                               true,  // has upper bound
+                               65     // out of bounds value (above upper bound)
+                               );
+
+    const conn = MongoRunner.runMongod({setParameter: {mapReduceMapThreads: 4}});
+    const testDB = conn.getDB("test");
+    const coll = testDB.mr_parallel_map;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; i++) {
+        bulk.insert({_id: i, key: i % 37, value: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const map = function() {
+        emit(this.key, {count: 1, sum: this.value * factor});
+    };
+    const reduce = function(key, values) {
+        const result = {count: 0, sum: 0};
+        values.forEach(function(value) {
+            result.count += value.count;
+            result.sum += value.sum;
+        });
+        return result;
+    };
+
+    function runMapReduce(out) {
+        const res = assert.commandWorked(testDB.runCommand({
+            mapReduce: coll.getName(),
+            map: map,
+            reduce: reduce,
+            scope: {factor: 2},
+            out: out,
+            jsMode: false
+        }));
+        assert.eq(res.counts.input, 5000, tojson(res));
+        assert.eq(res.counts.emit, 5000, tojson(res));
+        return out.inline ? res.results : testDB[out].find().sort({_id: 1}).toArray();
+    }
+
+    const parallelInline = runMapReduce({inline: 1});
+    const parallelOut = runMapReduce("mr_parallel_map_out");
+
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, mapReduceMapThreads: 1}));
+    const serialInline = runMapReduce({inline: 1});
+
+    assert.eq(serialInline.length, 37);
+    assert.sameMembers(parallelInline, serialInline);
+    assert.eq(parallelOut, serialInline);
+
+    // An error in the map function fails the command.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, mapReduceMapThreads: 4}));
+    assert.commandFailed(testDB.runCommand({
+        mapReduce: coll.getName(),
+        map: function() {
+            if (this._id === 4321) {
+                throw new Error("map failure");
+            }
+            emit(this.key, 1);
+        },
+        reduce: function(key, values) {
+            return Array.sum(values);
+        },
+        out: {inline: 1},
+        jsMode: false
+    }));
+
+    MongoRunner.stopMongod(conn);
+})();
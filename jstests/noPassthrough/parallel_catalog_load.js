@@ -0,0 +1,56 @@
+// Tests that a node loading its catalog with several threads at startup finds every collection,
+// with its documents, indexes and options.
+// @tags: [requires_persistence]
+(function() {
+    "use strict";
+
+    load("jstests/noPassthrough/libs/server_parameter_helpers.js");
+
+    testNumericServerParameter("catalogLoadThreadCount",
+                               true,   // is Startup Param
+                               false,  // is runtime param
+                               1,      // default value
+                               4,      // valid, non-default value
+                               true,   // has lower bound
+                               0,      // out of bound value (below lower bound)
+                               true,   // has upper bound
+                               257     // out of bounds value (above upper bound)
+                               );
+
+    const numDbs = 3;
+    const numCollsPerDb = 20;
+
+    let conn = MongoRunner.runMongod({});
+    for (let d = 0; d < numDbs; d++) {
+        const testDB = conn.getDB("parallel_catalog_load_" + d);
+        for (let c = 0; c < numCollsPerDb; c++) {
+            const coll = testDB.getCollection("coll_" + c);
+            assert.commandWorked(coll.insert([{_id: 0, x: c}, {_id: 1, x: c + 1}]));
+            assert.commandWorked(coll.createIndex({x: 1}));
+        }
+        assert.commandWorked(testDB.createCollection("capped", {capped: true, size: 4096}));
+        assert.commandWorked(testDB.capped.insert({_id: d}));
+    }
+    MongoRunner.stopMongod(conn);
+
+    conn = MongoRunner.runMongod(
+        {restart: conn, cleanData: false, setParameter: {catalogLoadThreadCount: 4}});
+    assert.neq(null, conn, "mongod failed to restart with a multithreaded catalog load");
+
+    for (let d = 0; d < numDbs; d++) {
+        const testDB = conn.getDB("parallel_catalog_load_" + d);
+        for (let c = 0; c < numCollsPerDb; c++) {
+            const coll = testDB.getCollection("coll_" + c);
+            assert.eq(coll.find().sort({_id: 1}).toArray(), [{_id: 0, x: c}, {_id: 1, x: c + 1}]);
+            assert.eq(coll.find({x: c + 1}).hint({x: 1}).itcount(), 1);
+
+            // New documents get record ids past those of the existing ones.
+            assert.commandWorked(coll.insert({_id: 2}));
+            assert.eq(coll.find().itcount(), 3);
+        }
+        assert(testDB.capped.isCapped());
+        assert.eq(testDB.capped.find().toArray(), [{_id: d}]);
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
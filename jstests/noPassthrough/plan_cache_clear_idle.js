@@ -0,0 +1,43 @@
+// Tests that the plan cache entries of a collection which is no longer queried are removed once
+// internalQueryCacheClearIdleAfterSecs have passed, while those of a collection in use are kept.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    const testDB = conn.getDB("test");
+
+    assert.commandFailedWithCode(
+        testDB.adminCommand({setParameter: 1, internalQueryCacheClearIdleAfterSecs: -1}),
+        ErrorCodes.BadValue);
+
+    const idleColl = testDB.plan_cache_clear_idle;
+    const usedColl = testDB.plan_cache_clear_used;
+    for (let coll of [idleColl, usedColl]) {
+        coll.drop();
+        assert.commandWorked(coll.insert([{a: 1, b: 1}, {a: 1, b: 2}, {a: 2, b: 2}]));
+        assert.commandWorked(coll.createIndexes([{a: 1}, {b: 1}]));
+        assert.eq(coll.find({a: 1, b: 2}).itcount(), 1);
+        assert.eq(coll.getPlanCache().listQueryShapes().length, 1);
+    }
+
+    const clearedBefore =
+        testDB.serverStatus().metrics.query.planCacheIdleEntriesCleared.valueOf();
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryCacheClearIdleAfterSecs: 3}));
+
+    assert.soon(function() {
+        // Keep the second collection's cache in use.
+        assert.eq(usedColl.find({a: 1, b: 2}).itcount(), 1);
+        return idleColl.getPlanCache().listQueryShapes().length === 0;
+    }, "the plan cache of the idle collection was never cleared");
+
+    assert.eq(usedColl.getPlanCache().listQueryShapes().length, 1);
+    assert.gte(testDB.serverStatus().metrics.query.planCacheIdleEntriesCleared.valueOf(),
+               clearedBefore + 1);
+
+    // The idle collection's cache fills again when it is next queried.
+    assert.eq(idleColl.find({a: 1, b: 2}).itcount(), 1);
+    assert.eq(idleColl.getPlanCache().listQueryShapes().length, 1);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,45 @@
+// Tests that with deferProfilerWrites set, profiler entries are written to system.profile by a
+// background thread, and that a dropped database is not recreated by queued entries.
+// @tags: [requires_profiling]
+
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {deferProfilerWrites: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.getCollection("coll");
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+
+    // Every insert is profiled once its entry has been flushed.
+    const insertEntries = {op: "insert", ns: coll.getFullName()};
+    assert.soon(() => testDB.system.profile.find(insertEntries).itcount() === 100,
+                () => tojson(testDB.system.profile.find().toArray()));
+    assert(testDB.system.profile.stats().capped);
+
+    const serverStatus = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    assert.eq(
+        serverStatus.metrics.profiler.deferredWrites.dropped, 0, tojson(serverStatus.metrics));
+
+    // The parameter can be turned off at runtime, after which entries are written synchronously.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, deferProfilerWrites: false}));
+    assert.eq(1, coll.find({_id: 7}).comment("sync").itcount());
+    assert.eq(1, testDB.system.profile.find({"command.comment": "sync"}).itcount());
+
+    // Entries queued for a database which is then dropped do not recreate it.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, deferProfilerWrites: true}));
+    const otherDB = conn.getDB("profile_deferred_writes_other");
+    assert.commandWorked(otherDB.setProfilingLevel(2));
+    assert.writeOK(otherDB.coll.insert({}));
+    assert.commandWorked(otherDB.dropDatabase());
+    assert.eq(1, coll.find({_id: 8}).comment("flushed").itcount());
+    assert.soon(() => testDB.system.profile.find({"command.comment": "flushed"}).itcount() === 1);
+    assert(!conn.getDBNames().includes(otherDB.getName()), tojson(conn.getDBNames()));
+
+    MongoRunner.stopMongod(conn);
+})();
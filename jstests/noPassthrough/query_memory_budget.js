@@ -0,0 +1,48 @@
+// Tests that the memory buffered by blocking query stages is reported, and that new $group stages
+// wait for memory while all queries together use more than internalQueryExecMaxGlobalMemoryBytes.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            internalQueryExecMaxGlobalMemoryBytes: 1024,
+            internalQueryExecMemoryAdmissionMaxWaitMS: 200
+        }
+    });
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.query_memory_budget;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, g: i % 10, s: 'x'.repeat(200)});
+    }
+    assert.writeOK(bulk.execute());
+
+    function memoryMetrics() {
+        return assert.commandWorked(testDB.adminCommand({serverStatus: 1})).metrics.query.memory;
+    }
+
+    // Nothing is buffered between queries, so a $group starts right away.
+    assert.eq(0, memoryMetrics().currentBytes);
+    assert.eq(10, coll.aggregate([{$group: {_id: '$g', n: {$sum: 1}}}]).itcount());
+    assert.eq(0, memoryMetrics().admissionWaits);
+
+    // A blocking sort keeps its buffer while its cursor is open.
+    const cursor = coll.find().sort({s: 1, _id: -1}).batchSize(2);
+    assert(cursor.hasNext());
+    assert.gt(memoryMetrics().currentBytes, 0);
+
+    // Another $group waits for it, then runs anyway when it is not released in time.
+    const metricsBefore = memoryMetrics();
+    assert.eq(10, coll.aggregate([{$group: {_id: '$g', n: {$sum: 1}}}]).itcount());
+    const metricsAfter = memoryMetrics();
+    assert.eq(metricsBefore.admissionWaits + 1, metricsAfter.admissionWaits, tojson(metricsAfter));
+    assert.eq(
+        metricsBefore.admissionTimeouts + 1, metricsAfter.admissionTimeouts, tojson(metricsAfter));
+
+    cursor.close();
+    assert.eq(0, memoryMetrics().currentBytes);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,64 @@
+/**
+ * Tests for the $queryStats aggregation metadata source.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod failed to start up");
+
+    const adminDb = conn.getDB("admin");
+    const testDb = conn.getDB("test");
+    const coll = testDb.query_stats_agg_source;
+
+    function getShapeStats() {
+        return adminDb.aggregate([{$queryStats: {}}, {$match: {ns: coll.getFullName()}}])
+            .toArray();
+    }
+
+    // Must be run as a collectionless aggregate on the admin database.
+    assert.commandFailedWithCode(
+        testDb.runCommand({aggregate: coll.getName(), pipeline: [{$queryStats: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+    assert.commandFailedWithCode(
+        testDb.runCommand({aggregate: 1, pipeline: [{$queryStats: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+    assert.commandFailedWithCode(
+        adminDb.runCommand({aggregate: 1, pipeline: [{$queryStats: {a: 1}}], cursor: {}}),
+        ErrorCodes.FailedToParse);
+
+    // Two candidate indexes, so that the {a: ...} shape gets a plan cache entry.
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({a: i, b: i}));
+    }
+    assert.eq(0, getShapeStats().length);
+
+    // Two executions of one shape, and one of another.
+    assert.eq(1, coll.find({a: 1}).itcount());
+    assert.eq(1, coll.find({a: 2}).itcount());
+    assert.eq(1, coll.find({b: 3}).itcount());
+
+    const stats = getShapeStats();
+    assert.eq(2, stats.length, tojson(stats));
+
+    const indexedShape = stats.find((shape) => shape.execCount === 2);
+    assert(indexedShape, tojson(stats));
+    assert.gte(indexedShape.keysExamined, 2, tojson(indexedShape));
+    assert.gte(indexedShape.docsExamined, 2, tojson(indexedShape));
+    assert.eq(2, indexedShape.nreturned, tojson(indexedShape));
+    assert.gt(indexedShape.bytesReturned, 0, tojson(indexedShape));
+    assert.lte(indexedShape.latencyMicros.max, indexedShape.latencyMicros.total);
+
+    const collScanShape = stats.find((shape) => shape.execCount === 1);
+    assert(collScanShape, tojson(stats));
+    assert.eq(10, collScanShape.docsExamined, tojson(collScanShape));
+
+    // The shapes can be joined with the plan cache on queryHash.
+    const planCacheHashes =
+        coll.aggregate([{$planCacheStats: {}}]).toArray().map((entry) => entry.queryHash);
+    assert.contains(indexedShape.queryHash, planCacheHashes);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,51 @@
+// Tests that queries only yield early when another operation waits for a lock they hold.
+// @tags: [requires_profiling]
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            internalQueryExecYieldIterations: 1,
+            internalQueryExecUncontendedYieldPeriodMS: 60 * 60 * 1000
+        }
+    });
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.query_yield_on_demand;
+    const nDocs = 20;
+    for (let i = 0; i < nDocs; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    function lastNumYield(comment) {
+        const entry = testDB.system.profile.findOne({"command.comment": comment});
+        assert.neq(null, entry, tojson(testDB.system.profile.find().toArray()));
+        return entry.numYield;
+    }
+
+    // Nobody waits, so a scan doesn't yield even though it considers yielding at every document.
+    assert.eq(nDocs, coll.find().comment('uncontended').itcount());
+    assert.eq(0, lastNumYield('uncontended'));
+
+    // A scan yields for a writer which needs an exclusive lock on the database, so that the writer
+    // finishes long before the scan does.
+    const awaitScan = startParallelShell(() => {
+        const coll = db.getSiblingDB('test').query_yield_on_demand;
+        assert.eq(20, coll.find({$where: 'sleep(250) || true'}).comment('contended').itcount());
+    }, conn.port);
+    assert.soon(() => testDB.currentOp({"command.comment": 'contended'}).inprog.length === 1);
+    assert.commandWorked(coll.createIndex({a: 1}, {background: false}));
+    assert.eq(1, testDB.currentOp({"command.comment": 'contended'}).inprog.length);
+    awaitScan();
+    assert.gte(lastNumYield('contended'), 1);
+
+    // A period of 0 restores yielding at every check.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryExecUncontendedYieldPeriodMS: 0}));
+    assert.eq(nDocs, coll.find().comment('periodic').itcount());
+    assert.gte(lastNumYield('periodic'), nDocs - 1);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -13,6 +13,8 @@
         coll.getDB().adminCommand({setParameter: 1, internalQueryExecYieldIterations: 10}));
     assert.commandWorked(
         coll.getDB().adminCommand({setParameter: 1, internalQueryExecYieldPeriodMS: 500}));
+    assert.commandWorked(coll.getDB().adminCommand(
+        {setParameter: 1, internalQueryExecUncontendedYieldPeriodMS: 0}));
     assert.commandWorked(coll.getDB().adminCommand({
         configureFailPoint: "setYieldAllLocksWait",
         namespace: coll.getFullName(),
@@ -0,0 +1,68 @@
+// Tests that the sampling CPU profiler attributes samples to the command running on the sampled
+// thread, and reports them through serverStatus and the getSamplingProfile command.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {samplingProfilerEnabled: true, samplingProfilerSamplesPerSecond: 1000}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.getCollection("coll");
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, x: i % 10, s: "a".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Run aggregations until enough of their samples have been aggregated.
+    const pipeline = [{$group: {_id: "$x", total: {$sum: {$strLenCP: "$s"}}}}, {$sort: {_id: 1}}];
+    assert.soon(() => {
+        for (let i = 0; i < 20; ++i) {
+            assert.eq(10, coll.aggregate(pipeline).itcount());
+        }
+        const status = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+        return (status.samplingProfile.commands.aggregate || 0) >= 10;
+    }, "no samples were attributed to aggregate");
+
+    const status = assert.commandWorked(testDB.adminCommand({serverStatus: 1}));
+    const summary = status.samplingProfile;
+    assert.eq(1000, summary.samplesPerSecond, tojson(summary));
+    assert.gt(summary.samples, 0, tojson(summary));
+    assert.gt(summary.callTreeNodes, 0, tojson(summary));
+
+    // The call tree of the aggregations has the namespace they ran against, and its frames add up.
+    const profile = assert.commandWorked(testDB.adminCommand({getSamplingProfile: 1}));
+    const tree = profile.callTrees.find(
+        (tree) => tree.command === "aggregate" && tree.ns === coll.getFullName());
+    assert(tree, tojson(profile.callTrees));
+    assert.gt(tree.calls.length, 0, tojson(tree));
+    const checkNode = (node) => {
+        assert.eq(typeof node.frame, "string", tojson(node));
+        const childSamples = (node.calls || []).reduce((sum, child) => sum + child.samples, 0);
+        assert.lte(childSamples + node.selfSamples, node.samples, tojson(node));
+        (node.calls || []).forEach(checkNode);
+    };
+    tree.calls.forEach(checkNode);
+
+    // Subtrees below minSamples are left out.
+    const pruned = assert.commandWorked(
+        testDB.adminCommand({getSamplingProfile: 1, minSamples: summary.samples + 1}));
+    assert.eq([], pruned.callTrees, tojson(pruned));
+
+    assert.commandFailedWithCode(testDB.adminCommand({getSamplingProfile: 1, minSamples: "x"}),
+                                 ErrorCodes.TypeMismatch);
+    assert.commandFailedWithCode(testDB.runCommand({getSamplingProfile: 1}),
+                                 ErrorCodes.Unauthorized);
+
+    MongoRunner.stopMongod(conn);
+
+    // The command fails if the profiler is not running.
+    const disabled = MongoRunner.runMongod({});
+    assert.neq(null, disabled, "mongod was unable to start up");
+    assert.commandFailedWithCode(disabled.adminCommand({getSamplingProfile: 1}),
+                                 ErrorCodes.IllegalOperation);
+    assert(!disabled.adminCommand({serverStatus: 1}).hasOwnProperty("samplingProfile"));
+    MongoRunner.stopMongod(disabled);
+})();
@@ -0,0 +1,51 @@
+// Tests that the TTL monitor deletes every expired document when it works in small, rate limited
+// batches, and leaves documents which have not expired.
+(function() {
+    "use strict";
+
+    load("jstests/noPassthrough/libs/server_parameter_helpers.js");
+
+    testNumericServerParameter("ttlMonitorBatchSize",
+                               true,     // is Startup Param
+                               true,     // is runtime param
+                               100,      // default value
+                               5,        // valid, non-default value
+                               true,     // has lower bound
+                               0,        // out of bound value (below lower bound)
+                               false,    // has upper bound
+                               "unused"  // out of bounds value (above upper bound)
+                               );
+
+    const runner = MongoRunner.runMongod({
+        setParameter:
+            {ttlMonitorSleepSecs: 1, ttlMonitorBatchSize: 7, ttlMonitorMaxDeletesPerSecond: 200}
+    });
+    const coll = runner.getDB("test").ttl_batched_deletes;
+    coll.drop();
+
+    assert.commandFailedWithCode(
+        coll.getDB().adminCommand({setParameter: 1, ttlMonitorMaxDeletesPerSecond: -1}),
+        ErrorCodes.BadValue);
+
+    const now = new Date();
+    const expired = new Date(now.getTime() - 3600 * 1000);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; i++) {
+        bulk.insert({_id: i, x: expired});
+    }
+    for (let i = 100; i < 110; i++) {
+        bulk.insert({_id: i, x: now});
+    }
+    // A document is expired if any of its dates is.
+    bulk.insert({_id: 110, x: [now, expired, expired]});
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({x: -1}, {expireAfterSeconds: 60}));
+
+    assert.soon(function() {
+        return coll.find({x: {$lte: expired}}).itcount() === 0;
+    }, "TTL monitor didn't delete the expired documents before timing out.");
+
+    assert.eq(coll.find().sort({_id: 1}).toArray().map((doc) => doc._id),
+              [100, 101, 102, 103, 104, 105, 106, 107, 108, 109]);
+    MongoRunner.stopMongod(runner);
+})();
@@ -0,0 +1,38 @@
+// Tests group commit of j:true writes, along with its parameters and serverStatus metrics.
+// @tags: [requires_journaling, requires_wiredtiger]
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: "wiredTigerGroupCommitWindowMicros=1000"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+
+    const getGroupCommitMetrics = () =>
+        assert.commandWorked(db.serverStatus()).metrics.storage.groupCommit;
+
+    const before = getGroupCommitMetrics();
+    const numThreads = 8;
+    const threads = [];
+    for (let i = 0; i < numThreads; i++) {
+        threads.push(startParallelShell(function() {
+            for (let j = 0; j < 50; j++) {
+                assert.writeOK(db.getSiblingDB("test").coll.insert({}, {writeConcern: {j: true}}));
+            }
+        }, conn.port));
+    }
+    threads.forEach(join => join());
+
+    const after = getGroupCommitMetrics();
+    const flushes = after.flushes - before.flushes;
+    const waiters = after.waiters - before.waiters;
+    assert.gt(flushes, 0, tojson(after));
+    assert.gte(waiters, flushes, tojson(after));
+    jsTestLog("Group commit averaged " + waiters / flushes + " waiters per flush");
+
+    // The window can be changed at runtime, and rejects invalid values.
+    assert.commandWorked(db.adminCommand({setParameter: 1, wiredTigerGroupCommitWindowMicros: 0}));
+    assert.commandFailed(db.adminCommand({setParameter: 1, wiredTigerGroupCommitWindowMicros: -1}));
+    assert.commandFailed(db.adminCommand({setParameter: 1, wiredTigerGroupCommitMaxWaiters: 0}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -16,9 +16,12 @@
     const nDocsToInsert = 300;
     const worksPerYield = 50;
 
-    // Start a mongod that will yield every 50 work cycles.
+    // Start a mongod that will yield every 50 work cycles, even when no other operation waits.
     const mongod = MongoRunner.runMongod({
-        setParameter: `internalQueryExecYieldIterations=${worksPerYield}`,
+        setParameter: {
+            internalQueryExecYieldIterations: worksPerYield,
+            internalQueryExecUncontendedYieldPeriodMS: 0
+        },
         profile: 2,
     });
     assert.neq(null, mongod, 'mongod was unable to start up');
@@ -0,0 +1,67 @@
+// Tests that the analyze command builds index histograms, and that the planner uses them to prune
+// a candidate plan which the trial period cannot tell apart from the best one.
+(function() {
+    "use strict";
+
+    const coll = db.analyze_index_histograms;
+    coll.drop();
+
+    // Nearly every document has the same status, and 'created' increases with insertion order.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, status: i % 1000 === 0 ? "new" : "done", created: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({status: 1}));
+    assert.commandWorked(coll.createIndex({created: 1}));
+    assert.commandWorked(coll.createIndex({notes: "text"}));
+
+    const query = {status: "done", created: {$gte: 9990}};
+    function numCandidates() {
+        const explain = coll.find(query).explain();
+        return explain.queryPlanner.rejectedPlans.length + 1;
+    }
+    assert.eq(numCandidates(), 2);
+
+    // Only btree indexes are analyzed.
+    let res = assert.commandWorked(db.runCommand({analyze: coll.getName()}));
+    assert.eq(res.numSampledRecords, 10000, tojson(res));
+    assert.eq(res.indexes.map(index => index.name).sort(), ["_id_", "created_1", "status_1"]);
+    for (let index of res.indexes) {
+        assert.eq(index.histogram.sampleSize, 10000, tojson(index));
+        assert.eq(index.histogram.keysPerRecord, 1, tojson(index));
+        assert.lte(index.histogram.buckets.length, 100, tojson(index));
+    }
+
+    // The scan of the status index is estimated to read most of the collection, so it is no
+    // longer evaluated.
+    assert.eq(numCandidates(), 1);
+    const winningPlan = coll.find(query).explain().queryPlanner.winningPlan;
+    assert.eq(winningPlan.inputStage.indexName, "created_1", tojson(winningPlan));
+    assert.eq(coll.find(query).itcount(), 10);
+
+    // With a limit, candidates are only ordered.
+    assert.eq(coll.find(query).limit(5).explain().queryPlanner.rejectedPlans.length, 1);
+
+    res = assert.commandWorked(
+        db.runCommand({analyze: coll.getName(), index: "status_1", sampleSize: 500, buckets: 5}));
+    assert.eq(res.indexes.length, 1, tojson(res));
+    assert.eq(res.indexes[0].histogram.sampleSize, 500, tojson(res));
+    assert.lte(res.indexes[0].histogram.buckets.length, 5, tojson(res));
+
+    // Dropping an index discards its histogram.
+    assert.commandWorked(coll.dropIndex({created: 1}));
+    assert.commandWorked(coll.createIndex({created: 1}));
+    assert.eq(numCandidates(), 2);
+
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), index: "missing"}),
+                                 ErrorCodes.IndexNotFound);
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), index: "notes_text"}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), sampleSize: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), buckets: "ten"}),
+                                 ErrorCodes.TypeMismatch);
+    assert.commandFailedWithCode(db.runCommand({analyze: "analyze_index_histograms_missing"}),
+                                 ErrorCodes.NamespaceNotFound);
+})();
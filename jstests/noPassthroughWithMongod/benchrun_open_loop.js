@@ -0,0 +1,53 @@
+// Tests benchRun's target rate, latency percentiles and phases.
+(function() {
+    "use strict";
+
+    const coll = db.benchrun_open_loop;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 0, x: 0}));
+
+    const ops = [
+        {op: "findOne", ns: coll.getFullName(), query: {_id: 0}, readCmd: true},
+        {
+          op: "update",
+          ns: coll.getFullName(),
+          query: {_id: 0},
+          update: {$inc: {x: 1}},
+          writeCmd: true
+        }
+    ];
+
+    function assertPercentiles(percentiles, opName) {
+        const latencies = percentiles[opName];
+        assert(latencies, tojson(percentiles));
+        assert.gt(latencies.count, 0, tojson(latencies));
+        assert.lte(latencies.p50, latencies.p99, tojson(latencies));
+        assert.lte(latencies.p99, latencies.p999, tojson(latencies));
+        assert.lte(latencies.p999, latencies.max, tojson(latencies));
+    }
+
+    // A target rate far below what the server can do is met, and not exceeded.
+    let res = benchRun(
+        {ops: ops, parallel: 2, seconds: 2, opsPerSecond: 100, host: db.getMongo().host});
+    assert.gt(res.totalOps, 100, tojson(res));
+    assert.lt(res.totalOps, 300, tojson(res));
+    assertPercentiles(res.latencyPercentilesMicros, "findOne");
+    assertPercentiles(res.latencyPercentilesMicros, "update");
+
+    // Phases run in order, for their durations, each at its own rate and with its own ops.
+    res = benchRun({
+        ops: ops,
+        parallel: 2,
+        phases: [{seconds: 1, opsPerSecond: 50}, {seconds: 1, ops: [ops[0]]}],
+        host: db.getMongo().host
+    });
+    assert.eq(2, res.phases.length, tojson(res));
+    assert.lt(res.phases[0].totalOps, 150, tojson(res));
+    assertPercentiles(res.phases[0].latencyPercentilesMicros, "update");
+    assert.gt(res.phases[1].totalOps, res.phases[0].totalOps, tojson(res));
+    assertPercentiles(res.phases[1].latencyPercentilesMicros, "findOne");
+    assert.eq(undefined, res.phases[1].latencyPercentilesMicros.update, tojson(res));
+
+    assert.throws(() => benchRun({ops: ops, phases: [{opsPerSecond: 10}]}));
+    assert.throws(() => benchRun({ops: ops, opsPerSecond: -1}));
+})();
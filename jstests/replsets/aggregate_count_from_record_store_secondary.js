@@ -0,0 +1,62 @@
+/**
+ * Tests that counting every document of a collection on a secondary only counts the documents of
+ * the snapshot it reads at lastApplied, and not those of a batch which is still being applied even
+ * though the record store already counts them.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    load('jstests/replsets/libs/secondary_reads_test.js');
+
+    const name = "aggregateCountFromRecordStoreSecondary";
+    const collName = "testColl";
+    let secondaryReadsTest = new SecondaryReadsTest(name);
+
+    let primaryDB = secondaryReadsTest.getPrimaryDB();
+    let secondaryDB = secondaryReadsTest.getSecondaryDB();
+
+    if (!primaryDB.serverStatus().storageEngine.supportsSnapshotReadConcern) {
+        secondaryReadsTest.stop();
+        return;
+    }
+    let primaryColl = primaryDB.getCollection(collName);
+    let secondaryColl = secondaryDB.getCollection(collName);
+
+    primaryDB.runCommand({drop: collName});
+    assert.commandWorked(primaryDB.runCommand({create: collName}));
+    for (let i = 0; i < 100; i++) {
+        assert.commandWorked(primaryColl.insert({_id: i}));
+    }
+    secondaryReadsTest.getReplset().awaitLastOpCommitted();
+
+    assert.eq(secondaryColl.aggregate([{$count: "n"}]).toArray(), [{n: 100}]);
+    assert.eq(secondaryColl.countDocuments({}), 100);
+
+    // Prevent a batch of inserts from completing on the secondary.
+    let pauseAwait = secondaryReadsTest.pauseSecondaryBatchApplication();
+    let docs = [];
+    for (let i = 100; i < 150; i++) {
+        docs.push({_id: i});
+    }
+    assert.commandWorked(primaryDB.runCommand({insert: collName, documents: docs}));
+    assert.eq(primaryColl.aggregate([{$count: "n"}]).toArray(), [{n: 150}]);
+    pauseAwait();
+
+    // The inserts of the paused batch are not visible at lastApplied, so they are not counted.
+    for (let level of["local", "available"]) {
+        assert.eq(secondaryColl.aggregate([{$count: "n"}], {readConcern: {level: level}}).toArray(),
+                  [{n: 100}],
+                  level);
+    }
+    assert.eq(secondaryColl.countDocuments({}), 100);
+
+    secondaryReadsTest.resumeSecondaryBatchApplication();
+    secondaryReadsTest.getReplset().awaitLastOpCommitted();
+
+    assert.eq(secondaryColl.aggregate([{$count: "n"}]).toArray(), [{n: 150}]);
+    assert.eq(secondaryColl.countDocuments({}), 150);
+
+    secondaryReadsTest.stop();
+})();
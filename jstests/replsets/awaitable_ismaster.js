@@ -0,0 +1,67 @@
+/**
+ * Tests that an awaitable isMaster, which names the topology version the client last saw, waits
+ * until the node's topology changes and then returns the new topology at once.
+ */
+(function() {
+    'use strict';
+
+    const replTest = new ReplSetTest({nodes: 2});
+    replTest.startSet();
+    replTest.initiate();
+    replTest.getPrimary();
+
+    const secondary = replTest.getSecondary();
+    const secondaryAdmin = secondary.getDB('admin');
+
+    // Every isMaster reports a topology version.
+    const initial = assert.commandWorked(secondaryAdmin.runCommand({isMaster: 1}));
+    assert.eq(initial.topologyVersion.processId.constructor, ObjectId, tojson(initial));
+    assert(!initial.ismaster, tojson(initial));
+
+    // The two fields go together, and must be well formed.
+    assert.commandFailedWithCode(
+        secondaryAdmin.runCommand({isMaster: 1, topologyVersion: initial.topologyVersion}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(secondaryAdmin.runCommand({isMaster: 1, maxAwaitTimeMS: 100}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        secondaryAdmin.runCommand({isMaster: 1, topologyVersion: 1, maxAwaitTimeMS: 100}),
+        ErrorCodes.TypeMismatch);
+    assert.commandFailedWithCode(
+        secondaryAdmin.runCommand(
+            {isMaster: 1, topologyVersion: initial.topologyVersion, maxAwaitTimeMS: -1}),
+        ErrorCodes.BadValue);
+
+    // Without a change, the awaitable isMaster waits for 'maxAwaitTimeMS' and reports the same
+    // version.
+    const start = Date.now();
+    let res = assert.commandWorked(secondaryAdmin.runCommand(
+        {isMaster: 1, topologyVersion: initial.topologyVersion, maxAwaitTimeMS: 500}));
+    assert.gte(Date.now() - start, 500);
+    assert.eq(res.topologyVersion, initial.topologyVersion, tojson(res));
+
+    // A version the node has moved on from is answered immediately.
+    const stale = {processId: initial.topologyVersion.processId, counter: NumberLong(-1)};
+    res = assert.commandWorked(
+        secondaryAdmin.runCommand({isMaster: 1, topologyVersion: stale, maxAwaitTimeMS: 600000}));
+    assert.eq(res.topologyVersion, initial.topologyVersion, tojson(res));
+
+    // An election wakes a client waiting on the secondary, which then sees itself as primary.
+    const awaitIsMaster = startParallelShell(
+        funWithArgs(function(topologyVersion) {
+            let res;
+            assert.soon(function() {
+                res = assert.commandWorked(db.adminCommand(
+                    {isMaster: 1, topologyVersion: topologyVersion, maxAwaitTimeMS: 600000}));
+                topologyVersion = res.topologyVersion;
+                return res.ismaster;
+            });
+        }, initial.topologyVersion), secondary.port);
+
+    assert.commandWorked(secondaryAdmin.runCommand({replSetStepUp: 1}));
+    replTest.waitForState(secondary, ReplSetTest.State.PRIMARY);
+    awaitIsMaster();
+
+    replTest.awaitSecondaryNodes();
+    replTest.stopSet();
+})();
@@ -0,0 +1,83 @@
+/**
+ * Tests that retryable findAndModify commands store the image of the document which their retries
+ * return in config.image_collection, rather than in a no-op oplog entry, when
+ * storeFindAndModifyImagesInSideCollection is set, and that retries return that image on the
+ * primary and after failover.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/retryable_writes_util.js");
+
+    if (!RetryableWritesUtil.storageEngineSupportsRetryableWrites(jsTest.options().storageEngine)) {
+        jsTestLog("Retryable writes are not supported, skipping test");
+        return;
+    }
+
+    const replTest = new ReplSetTest(
+        {nodes: 2, nodeOptions: {setParameter: {storeFindAndModifyImagesInSideCollection: true}}});
+    replTest.startSet();
+    replTest.initiate();
+
+    let primary = replTest.getPrimary();
+    let testDB = primary.getDB("test");
+    assert.writeOK(testDB.coll.insert([{_id: 0, x: 0}, {_id: 1, x: 0}, {_id: 2, x: 0}]));
+
+    const lsid = {id: UUID()};
+    const commands = [
+        {findAndModify: "coll", query: {_id: 0}, update: {$inc: {x: 1}}, txnNumber: NumberLong(0)},
+        {
+          findAndModify: "coll",
+          query: {_id: 1},
+          update: {$inc: {x: 1}},
+          new: true,
+          txnNumber: NumberLong(1)
+        },
+        {findAndModify: "coll", query: {_id: 2}, remove: true, txnNumber: NumberLong(2)},
+    ];
+    const imageKinds = ["preImage", "postImage", "preImage"];
+    const results = [];
+
+    // Returns the image collection entry of the session on 'node', if any.
+    function getImageEntry(node) {
+        return node.getDB("config").image_collection.findOne({"_id.id": lsid.id});
+    }
+
+    commands.forEach(function(cmd, i) {
+        cmd.lsid = lsid;
+        const result = assert.commandWorked(testDB.runCommand(cmd));
+
+        // The write is logged without a no-op entry holding its image.
+        const oplog = primary.getDB("local").oplog.rs;
+        const entries = oplog.find({"lsid.id": lsid.id, txnNumber: cmd.txnNumber}).toArray();
+        assert.eq(entries.length, 1, tojson(entries));
+        assert.eq(entries[0].needsRetryImage, imageKinds[i], tojson(entries));
+        assert(!entries[0].hasOwnProperty("preImageOpTime"), tojson(entries));
+        assert(!entries[0].hasOwnProperty("postImageOpTime"), tojson(entries));
+
+        // The primary and the secondary both hold the image of the latest write of the session.
+        replTest.awaitReplication();
+        replTest.nodes.forEach(function(node) {
+            const imageEntry = getImageEntry(node);
+            assert.eq(imageEntry.txnNumber, cmd.txnNumber, tojson(imageEntry));
+            assert.eq(imageEntry.ts, entries[0].ts, tojson(imageEntry));
+            assert.eq(imageEntry.imageKind, imageKinds[i], tojson(imageEntry));
+            assert.eq(imageEntry.image, result.value, tojson(imageEntry));
+        });
+
+        // A retry returns the same result without writing again.
+        assert.eq(assert.commandWorked(testDB.runCommand(cmd)).value, result.value);
+        results.push(result);
+    });
+    assert.eq(testDB.coll.find().sort({_id: 1}).toArray(), [{_id: 0, x: 1}, {_id: 1, x: 1}]);
+
+    // The image derived by the secondary serves retries once it becomes the primary.
+    const secondary = replTest.getSecondary();
+    assert.commandWorked(secondary.adminCommand({replSetStepUp: 1}));
+    replTest.waitForState(secondary, ReplSetTest.State.PRIMARY);
+    testDB = replTest.getPrimary().getDB("test");
+    assert.eq(assert.commandWorked(testDB.runCommand(commands[2])).value, results[2].value);
+    assert.eq(testDB.coll.find().itcount(), 2);
+
+    replTest.stopSet();
+})();
@@ -0,0 +1,46 @@
+/**
+ * Tests that when replBuildForegroundIndexesInBackground is enabled, secondaries keep applying the
+ * oplog while they build an index which the primary built in the foreground.
+ */
+(function() {
+    'use strict';
+
+    load('jstests/libs/check_log.js');
+
+    const rst = new ReplSetTest({
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        nodeOptions: {setParameter: {replBuildForegroundIndexesInBackground: true}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const testDB = primary.getDB('test');
+    const coll = testDB.getCollection('coll');
+
+    for (let i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i, x: i}));
+    }
+    rst.awaitReplication();
+
+    assert.commandWorked(secondary.adminCommand(
+        {configureFailPoint: 'hangAfterStartingIndexBuild', mode: 'alwaysOn'}));
+
+    assert.commandWorked(coll.createIndex({x: 1}, {background: false}));
+    checkLog.contains(secondary, 'Hanging index build due to failpoint');
+
+    // The index build on the secondary must not hold up the replication of later writes.
+    assert.writeOK(coll.insert({_id: 10, x: 10}, {writeConcern: {w: 2}}));
+
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: 'hangAfterStartingIndexBuild', mode: 'off'}));
+
+    const secondaryColl = secondary.getDB('test').getCollection('coll');
+    assert.soon(function() {
+        return secondaryColl.getIndexes().length === 2;
+    }, 'index was not built on the secondary');
+    assert.eq(11, secondaryColl.find().hint({x: 1}).itcount());
+
+    rst.stopSet();
+})();
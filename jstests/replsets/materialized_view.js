@@ -0,0 +1,84 @@
+/**
+ * Tests that a collection created with the 'materializedView' option is populated from its source
+ * collection and maintained as the source is written, and that secondaries hold the same view.
+ */
+(function() {
+    'use strict';
+
+    const replTest = new ReplSetTest({nodes: [{}, {rsConfig: {priority: 0}}]});
+    replTest.startSet();
+    replTest.initiate();
+
+    const primary = replTest.getPrimary();
+    const testDB = primary.getDB('test');
+    const source = testDB.source;
+
+    assert.writeOK(source.insert([
+        {_id: 1, k: 'a', x: 1, secret: 1},
+        {_id: 2, k: 'b', x: 2, secret: 2},
+        {_id: 3, k: 'a', x: 3, secret: 3},
+    ]));
+
+    // Only the supported stages are accepted.
+    assert.commandFailedWithCode(
+        testDB.createCollection('bad',
+                                {materializedView: {on: 'source', pipeline: [{$sort: {x: 1}}]}}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        testDB.createCollection(
+            'bad', {materializedView: {on: 'source', pipeline: [{$project: {_id: 0, x: 1}}]}}),
+        ErrorCodes.InvalidOptions);
+
+    const filteredPipeline =
+        [{$match: {x: {$gte: 2}}}, {$project: {k: 1, x2: {$multiply: ['$x', 2]}}}];
+    const groupedPipeline = [{$group: {_id: '$k', n: {$sum: 1}, total: {$sum: '$x'}}}];
+    assert.commandWorked(testDB.createCollection(
+        'filtered', {materializedView: {on: 'source', pipeline: filteredPipeline}}));
+    assert.commandWorked(testDB.createCollection(
+        'grouped', {materializedView: {on: 'source', pipeline: groupedPipeline}}));
+
+    // Returns the result of running 'pipeline' over the source, for comparison with a view.
+    function expected(pipeline) {
+        return source.aggregate(pipeline.concat([{$sort: {_id: 1}}])).toArray();
+    }
+
+    function checkViews(db) {
+        assert.eq(db.filtered.find().sort({_id: 1}).toArray(), expected(filteredPipeline));
+        assert.eq(db.grouped.find().sort({_id: 1}).toArray(), expected(groupedPipeline));
+    }
+
+    // The views are populated from the existing documents.
+    checkViews(testDB);
+
+    // Inserts, updates and deletes of the source are reflected in the views.
+    assert.writeOK(source.insert({_id: 4, k: 'c', x: 10}));
+    assert.writeOK(source.update({_id: 1}, {$set: {x: 5}}));
+    assert.writeOK(source.update({_id: 2}, {$set: {k: 'a'}}));
+    assert.writeOK(source.update({_id: 3}, {$set: {x: 0}}));
+    checkViews(testDB);
+
+    // A group which loses its last document is removed.
+    assert.writeOK(source.remove({_id: 4}));
+    checkViews(testDB);
+    assert.eq(testDB.grouped.find({_id: 'c'}).itcount(), 0);
+
+    assert.writeOK(source.update({}, {$inc: {x: 1}}, {multi: true}));
+    assert.writeOK(source.remove({k: 'b'}));
+    checkViews(testDB);
+
+    // A view cannot be maintained from another view.
+    assert.commandFailedWithCode(
+        testDB.createCollection('chained', {materializedView: {on: 'grouped', pipeline: []}}),
+        51015);
+
+    // Secondaries apply the writes to the views.
+    replTest.awaitReplication();
+    checkViews(replTest.getSecondary().getDB('test'));
+
+    // Dropping the source empties its views.
+    assert(source.drop());
+    assert.eq(testDB.filtered.find().itcount(), 0);
+    assert.eq(testDB.grouped.find().itcount(), 0);
+
+    replTest.stopSet();
+})();
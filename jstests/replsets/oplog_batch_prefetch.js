@@ -0,0 +1,62 @@
+/**
+ * Tests that a secondary with replPrefetchOplogBatches enabled prefetches the documents and index
+ * entries of the CRUD ops it applies, and still applies them correctly.
+ */
+(function() {
+    "use strict";
+
+    function getPrefetchedOps(node) {
+        return assert.commandWorked(node.adminCommand({serverStatus: 1}))
+            .metrics.repl.apply.prefetchedOps;
+    }
+
+    const name = "oplog_batch_prefetch";
+    const rst = new ReplSetTest({
+        name: name,
+        nodes: [{}, {rsConfig: {priority: 0}, setParameter: {replPrefetchOplogBatches: true}}]
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const coll = primary.getDB(name).foo;
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true}));
+    rst.awaitReplication();
+    assert.eq(0, getPrefetchedOps(secondary));
+
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; i++) {
+        bulk.insert({_id: i, u: i, x: 0});
+    }
+    assert.writeOK(bulk.execute());
+    bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; i++) {
+        if (i % 2 == 0) {
+            bulk.find({_id: i}).updateOne({$set: {u: i + 1000, x: 1}});
+        } else {
+            bulk.find({_id: i}).removeOne();
+        }
+    }
+    assert.writeOK(bulk.execute());
+    rst.awaitReplication();
+
+    // Updates and deletes prefetched before the inserts of their documents were applied are
+    // skipped, so not every op is counted.
+    const prefetchedOps = getPrefetchedOps(secondary);
+    assert.gte(prefetchedOps, 100);
+
+    const secondaryColl = secondary.getDB(name).foo;
+    assert.eq(50, secondaryColl.find({x: 1}).itcount());
+    assert.eq(0, secondaryColl.find({x: 0}).itcount());
+    rst.checkReplicatedDataHashes();
+
+    // Prefetching stops when disabled at runtime.
+    assert.commandWorked(
+        secondary.adminCommand({setParameter: 1, replPrefetchOplogBatches: false}));
+    assert.writeOK(coll.insert({_id: 1000, u: 2000}));
+    rst.awaitReplication();
+    assert.eq(prefetchedOps, getPrefetchedOps(secondary));
+
+    rst.stopSet();
+})();
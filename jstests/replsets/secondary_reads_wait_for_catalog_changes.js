@@ -0,0 +1,73 @@
+/**
+ * Tests that with secondaryReadsWaitForCatalogChangesMS set, a secondary read which finds catalog
+ * changes later than the last applied timestamp waits for the batch making them to complete, and
+ * then reads at the last applied timestamp instead of taking the PBWM lock.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    load('jstests/libs/check_log.js');
+    load('jstests/replsets/libs/secondary_reads_test.js');
+
+    const name = "secondaryReadsWaitForCatalogChanges";
+    const collName = "testColl";
+    let secondaryReadsTest = new SecondaryReadsTest(name);
+
+    let primaryDB = secondaryReadsTest.getPrimaryDB();
+    let secondaryDB = secondaryReadsTest.getSecondaryDB();
+
+    if (!primaryDB.serverStatus().storageEngine.supportsSnapshotReadConcern) {
+        secondaryReadsTest.stop();
+        return;
+    }
+    let primaryColl = primaryDB.getCollection(collName);
+
+    primaryDB.runCommand({drop: collName});
+    assert.commandWorked(primaryDB.runCommand({create: collName}));
+    for (let i = 0; i < 10; i++) {
+        assert.commandWorked(primaryColl.insert({_id: i, x: i}));
+    }
+    secondaryReadsTest.getReplset().awaitLastOpCommitted();
+
+    assert.commandWorked(
+        secondaryDB.adminCommand({setParameter: 1, secondaryReadsWaitForCatalogChangesMS: 60000}));
+    assert.commandWorked(secondaryDB.adminCommand(
+        {setParameter: 1, logComponentVerbosity: {storage: {verbosity: 2}}}));
+
+    // Build an index in a batch which is paused before completion, so that the collection has a
+    // catalog change later than the last applied timestamp.
+    let pauseAwait = secondaryReadsTest.pauseSecondaryBatchApplication();
+    assert.commandWorked(primaryDB.runCommand(
+        {createIndexes: collName, indexes: [{key: {x: 1}, name: "x_1"}]}));
+    pauseAwait();
+
+    const awaitRead = startParallelShell(function() {
+        db.getMongo().setSlaveOk();
+        const coll = db.getSiblingDB("secondaryReadsWaitForCatalogChanges").testColl;
+        assert.eq(coll.find().itcount(), 10);
+    }, secondaryDB.getMongo().port);
+
+    // The read waits for the last applied timestamp without holding or queueing for any lock.
+    assert.soon(function() {
+        const ops = secondaryDB.getSiblingDB("admin")
+                        .aggregate([
+                            {$currentOp: {}},
+                            {$match: {ns: secondaryDB.getName() + "." + collName, op: "query"}}
+                        ])
+                        .toArray();
+        return ops.length === 1 && !ops[0].waitingForLock;
+    });
+
+    secondaryReadsTest.resumeSecondaryBatchApplication();
+    awaitRead();
+
+    checkLog.contains(secondaryDB.getMongo(),
+                      "Waited for last-applied time to reach pending catalog changes");
+    assert(!checkLog.getGlobalLog(secondaryDB.getMongo()).some(function(line) {
+        return line.includes("Trying again without reading at last-applied time");
+    }));
+
+    secondaryReadsTest.stop();
+})();
@@ -0,0 +1,58 @@
+/**
+ * Tests that a transaction with more operations than fit in one oplog entry is written as a chain
+ * of 'applyOps' entries, and that secondaries apply the whole chain atomically when they reach its
+ * final entry.
+ *
+ * @tags: [uses_transactions]
+ */
+(function() {
+    'use strict';
+
+    const replTest = new ReplSetTest({
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        nodeOptions: {setParameter: {maxNumberOfTransactionOperationsInSingleOplogEntry: 2}}
+    });
+    replTest.startSet();
+    replTest.initiate();
+
+    const primary = replTest.getPrimary();
+    const secondary = replTest.getSecondary();
+    const session = primary.startSession();
+    const sessionDB = session.getDatabase('test');
+    const coll = sessionDB.getCollection('coll');
+
+    assert.commandWorked(
+        sessionDB.createCollection(coll.getName(), {writeConcern: {w: "majority"}}));
+
+    session.startTransaction();
+    for (let i = 0; i < 5; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+    session.commitTransaction();
+    const txnNum = NumberLong(session._txnNumber);
+
+    // The five inserts are held by three entries, linked from the final entry to the first.
+    const entries = primary.getDB('local')
+                        .oplog.rs.find({"lsid.id": session.getSessionId().id, txnNumber: txnNum})
+                        .sort({$natural: 1})
+                        .toArray();
+    assert.eq(entries.length, 3, tojson(entries));
+    assert.eq(entries.map((entry) => entry.o.applyOps.length), [2, 2, 1], tojson(entries));
+    assert.eq(entries.map((entry) => entry.o.partialTxn), [true, true, undefined], tojson(entries));
+    assert.eq(entries[1].prevOpTime.ts, entries[0].ts, tojson(entries));
+    assert.eq(entries[2].prevOpTime.ts, entries[1].ts, tojson(entries));
+
+    // The transactions table records the final entry.
+    const txnRecord = primary.getDB('config').transactions.findOne({txnNum: txnNum});
+    assert.eq(txnRecord.lastWriteOpTime.ts, entries[2].ts, tojson(txnRecord));
+
+    // The secondary applies every operation of the chain, and records the same final entry.
+    replTest.awaitReplication();
+    const secondaryColl = secondary.getDB('test').getCollection('coll');
+    assert.eq(secondaryColl.find().sort({_id: 1}).toArray(),
+              [{_id: 0}, {_id: 1}, {_id: 2}, {_id: 3}, {_id: 4}]);
+    assert.eq(secondary.getDB('config').transactions.findOne({txnNum: txnNum}), txnRecord);
+
+    session.endSession();
+    replTest.stopSet();
+})();
@@ -41,11 +41,18 @@ TestData.skipAwaitingReplicationOnShardsBeforeCheckingUUIDs = true;
         name: jsTestName(),
         keyFile: key,
         shards: 3,
-        rs: {nodes: 1, setParameter: {internalQueryExecYieldIterations: 1}}
+        rs: {
+            nodes: 1,
+            setParameter: {
+                internalQueryExecYieldIterations: 1,
+                internalQueryExecUncontendedYieldPeriodMS: 0
+            }
+        }
     };
 
-    // Create a new sharded cluster for testing. We set the internalQueryExecYieldIterations
-    // parameter so that plan execution yields on every iteration. For some tests, we will
+    // Create a new sharded cluster for testing. We set the internalQueryExecYieldIterations and
+    // internalQueryExecUncontendedYieldPeriodMS parameters so that plan execution yields on every
+    // iteration. For some tests, we will
     // temporarily set yields to hang the mongod so we can capture particular operations in the
     // currentOp output.
     const st = new ShardingTest(stParams);
@@ -0,0 +1,46 @@
+// Tests that a change stream on a sharded collection returns the events written to one shard
+// while the other shard stays idle, without the idle shard having to write periodic noops to
+// advance the stream.
+// @tags: [uses_change_streams]
+(function() {
+    "use strict";
+
+    // For supportsMajorityReadConcern().
+    load("jstests/multiVersion/libs/causal_consistency_helpers.js");
+
+    if (!supportsMajorityReadConcern()) {
+        jsTestLog("Skipping test since storage engine doesn't support majority read concern.");
+        return;
+    }
+
+    const st = new ShardingTest(
+        {shards: 2, rs: {nodes: 1, setParameter: {writePeriodicNoops: false}}});
+
+    const mongosDB = st.s0.getDB(jsTestName());
+    const mongosColl = mongosDB[jsTestName()];
+
+    assert.commandWorked(mongosDB.adminCommand({enableSharding: mongosDB.getName()}));
+    st.ensurePrimaryShard(mongosDB.getName(), st.rs0.getURL());
+
+    // Shard the collection so that negative _ids live on shard 0 and the rest on shard 1.
+    assert.commandWorked(
+        mongosDB.adminCommand({shardCollection: mongosColl.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(
+        mongosDB.adminCommand({split: mongosColl.getFullName(), middle: {_id: 0}}));
+    assert.commandWorked(mongosDB.adminCommand(
+        {moveChunk: mongosColl.getFullName(), find: {_id: 1}, to: st.rs1.getURL()}));
+
+    const changeStream = mongosColl.watch();
+
+    // Only shard 0 is written to. Each event must be returned without waiting for shard 1.
+    for (let i = 1; i <= 3; i++) {
+        assert.writeOK(mongosColl.insert({_id: -i}, {writeConcern: {w: "majority"}}));
+        assert.soon(() => changeStream.hasNext(), "event " + i + " was not returned", 30 * 1000);
+        const event = changeStream.next();
+        assert.eq(event.operationType, "insert", tojson(event));
+        assert.eq(event.documentKey, {_id: -i}, tojson(event));
+    }
+
+    changeStream.close();
+    st.stop();
+})();
@@ -0,0 +1,100 @@
+// Tests sharding by a compound shard key which contains one hashed field. Writes are distributed by
+// the hash of that field, while queries which constrain the ranged fields are targeted to the
+// chunks which can hold matching documents.
+(function() {
+    'use strict';
+
+    const st = new ShardingTest({shards: 2});
+    const mongos = st.s0;
+    const testDB = mongos.getDB('test');
+
+    assert.commandWorked(mongos.adminCommand({enableSharding: 'test'}));
+    st.ensurePrimaryShard('test', st.shard0.shardName);
+
+    // Returns the number of shards that 'query' is sent to.
+    function numShardsTargeted(coll, query) {
+        const explain = coll.find(query).explain();
+        return explain.queryPlanner.winningPlan.shards.length;
+    }
+
+    //
+    // Hashed prefix: the collection can be presplit by hash value, and an equality on the hashed
+    // field with a range on the other field is sent to a single shard.
+    //
+
+    const hashedPrefix = testDB.hashed_prefix;
+    assert.commandWorked(mongos.adminCommand({
+        shardCollection: hashedPrefix.getFullName(),
+        key: {x: 'hashed', y: 1},
+        numInitialChunks: 4
+    }));
+
+    const chunks = mongos.getDB('config').chunks.find({ns: hashedPrefix.getFullName()}).toArray();
+    assert.eq(chunks.length, 4, tojson(chunks));
+    chunks.forEach((chunk) => assert.eq(Object.keySet(chunk.min), ['x', 'y'], tojson(chunk)));
+    assert.eq(st.onNumShards('hashed_prefix'), 2);
+
+    const bulk = hashedPrefix.initializeUnorderedBulkOp();
+    for (let x = 0; x < 100; x++) {
+        for (let y = 0; y < 5; y++) {
+            bulk.insert({x: x, y: y});
+        }
+    }
+    assert.writeOK(bulk.execute());
+
+    // Documents are spread across both shards by the hash of 'x'.
+    assert.gt(st.shard0.getDB('test').hashed_prefix.count(), 0);
+    assert.gt(st.shard1.getDB('test').hashed_prefix.count(), 0);
+
+    assert.eq(hashedPrefix.find({x: 7, y: {$gte: 2}}).itcount(), 3);
+    assert.eq(numShardsTargeted(hashedPrefix, {x: 7, y: {$gte: 2}}), 1);
+    assert.eq(hashedPrefix.find({y: 3}).itcount(), 100);
+
+    // The shard key is required on insert, and the ranged field may not be an array.
+    assert.writeError(hashedPrefix.insert({x: 1}));
+    assert.writeError(hashedPrefix.insert({x: 1, y: [1, 2]}));
+
+    //
+    // Hashed suffix: a range on the prefix field is sent only to the shards owning that range.
+    //
+
+    const hashedSuffix = testDB.hashed_suffix;
+    assert.commandWorked(mongos.adminCommand(
+        {shardCollection: hashedSuffix.getFullName(), key: {t: 1, h: 'hashed'}}));
+
+    // Presplitting needs the hash values to be the first field of the shard key.
+    const presplitRes = mongos.adminCommand({
+        shardCollection: testDB.hashed_suffix_presplit.getFullName(),
+        key: {t: 1, h: 'hashed'},
+        numInitialChunks: 4
+    });
+    assert.commandFailedWithCode(presplitRes, ErrorCodes.InvalidOptions);
+
+    assert.commandWorked(
+        mongos.adminCommand({split: hashedSuffix.getFullName(), middle: {t: 10, h: MinKey}}));
+    assert.commandWorked(mongos.adminCommand({
+        moveChunk: hashedSuffix.getFullName(),
+        find: {t: 10, h: MinKey},
+        to: st.shard1.shardName,
+        _waitForDelete: true
+    }));
+
+    for (let t = 0; t < 20; t++) {
+        assert.writeOK(hashedSuffix.insert({t: t, h: 'value' + t}));
+    }
+
+    assert.eq(hashedSuffix.find({t: {$lt: 10}}).itcount(), 10);
+    assert.eq(numShardsTargeted(hashedSuffix, {t: {$lt: 10}}), 1);
+    assert.eq(hashedSuffix.find({t: {$gte: 12}}).itcount(), 8);
+    assert.eq(numShardsTargeted(hashedSuffix, {t: {$gte: 12}}), 1);
+    assert.eq(hashedSuffix.find({h: 'value3'}).itcount(), 1);
+    assert.eq(numShardsTargeted(hashedSuffix, {h: 'value3'}), 2);
+
+    // Updates and deletes by the full shard key are targeted like inserts.
+    assert.writeOK(hashedSuffix.update({t: 15, h: 'value15'}, {$set: {updated: true}}));
+    assert.eq(st.shard1.getDB('test').hashed_suffix.count({updated: true}), 1);
+    assert.writeOK(hashedSuffix.remove({t: 3, h: 'value3'}));
+    assert.eq(hashedSuffix.find().itcount(), 19);
+
+    st.stop();
+})();
@@ -0,0 +1,60 @@
+// Tests that a sorted query with a limit over several shards returns the right results when the
+// merger tells the shards, in its getMores, which results sort too late to be needed.
+(function() {
+    'use strict';
+
+    const st = new ShardingTest({shards: 2});
+    const mongos = st.s0;
+    const coll = mongos.getDB('test').merge_sort_limit_bound;
+
+    assert.commandWorked(mongos.adminCommand({enableSharding: 'test'}));
+    st.ensurePrimaryShard('test', st.shard0.shardName);
+    assert.commandWorked(
+        mongos.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(mongos.adminCommand({split: coll.getFullName(), middle: {_id: 0}}));
+    assert.commandWorked(mongos.adminCommand(
+        {moveChunk: coll.getFullName(), find: {_id: 0}, to: st.shard1.shardName}));
+
+    // The values of 'x' on the two shards interleave, and the first shard holds the smaller ones.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 200; i++) {
+        bulk.insert({_id: -1 - i, x: 2 * i});
+        bulk.insert({_id: i, x: 2 * i + 1 + (i < 100 ? 0 : 1000)});
+    }
+    assert.writeOK(bulk.execute());
+
+    function expectedX(limit, skip) {
+        return coll.find({}, {_id: 0, x: 1})
+            .toArray()
+            .map((doc) => doc.x)
+            .sort((a, b) => a - b)
+            .slice(skip, skip + limit);
+    }
+
+    // Small batches make the merger ask the shards for more results after it has received the
+    // limit, so the later getMores carry the bound.
+    [{limit: 150, skip: 0}, {limit: 120, skip: 30}, {limit: 400, skip: 0}].forEach(function(test) {
+        const results = coll.find({}, {_id: 0, x: 1})
+                            .sort({x: 1})
+                            .skip(test.skip)
+                            .limit(test.limit)
+                            .batchSize(10)
+                            .toArray()
+                            .map((doc) => doc.x);
+        assert.eq(results, expectedX(test.limit, test.skip), tojson(test));
+    });
+
+    const aggResults = coll.aggregate([{$sort: {x: -1}}, {$limit: 150}, {$project: {_id: 0, x: 1}}],
+                                      {cursor: {batchSize: 10}})
+                           .toArray()
+                           .map((doc) => doc.x);
+    assert.eq(aggResults, expectedX(400, 0).reverse().slice(0, 150));
+
+    // Turning the bound off still returns the same results.
+    assert.commandWorked(mongos.adminCommand(
+        {setParameter: 1, internalQueryAsyncResultsMergerSendSortKeyBound: false}));
+    assert.eq(coll.find().sort({x: 1}).limit(150).batchSize(10).toArray().map((doc) => doc.x),
+              expectedX(150, 0));
+
+    st.stop();
+})();
@@ -0,0 +1,65 @@
+// Tests that a $sample on a sharded collection asks each shard for a sample in proportion to the
+// shard's share of the collection, and still returns the requested number of distinct documents.
+(function() {
+    'use strict';
+
+    const st = new ShardingTest({shards: 2});
+    const mongos = st.s0;
+    const testDB = mongos.getDB('test');
+    const coll = testDB.sample_apportioned;
+
+    assert.commandWorked(mongos.adminCommand({enableSharding: 'test'}));
+    st.ensurePrimaryShard('test', st.shard0.shardName);
+    assert.commandWorked(mongos.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+
+    // Nine tenths of the documents live on shard0, and the rest on shard1.
+    assert.commandWorked(mongos.adminCommand({split: coll.getFullName(), middle: {_id: 9000}}));
+    assert.commandWorked(mongos.adminCommand({
+        moveChunk: coll.getFullName(),
+        find: {_id: 9000},
+        to: st.shard1.shardName,
+        _waitForDelete: true
+    }));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Returns the size of the $sample that each shard was sent by the aggregate with 'comment'.
+    function shardSampleSizes(comment) {
+        return [st.shard0, st.shard1].map(function(shard) {
+            const entry = shard.getDB('test').system.profile.findOne(
+                {"command.aggregate": coll.getName(), "command.comment": comment});
+            assert(entry, "shard " + shard.shardName + " did not profile the aggregate");
+            return entry.command.pipeline[0].$sample.size;
+        });
+    }
+
+    function runSample(comment) {
+        const results = coll.aggregate([{$sample: {size: 50}}], {comment: comment}).toArray();
+        assert.eq(results.length, 50, tojson(results));
+        const ids = new Set(results.map((doc) => doc._id));
+        assert.eq(ids.size, 50, tojson(results));
+    }
+
+    for (let shard of [st.shard0, st.shard1]) {
+        assert.commandWorked(shard.getDB('test').setProfilingLevel(2));
+    }
+
+    runSample("apportioned");
+    let sizes = shardSampleSizes("apportioned");
+    assert.eq(sizes[0], 50, tojson(sizes));
+    assert.lt(sizes[1], 50, tojson(sizes));
+    assert.gte(sizes[1], 5, tojson(sizes));
+
+    // Without apportioning, each shard samples the whole size.
+    assert.commandWorked(
+        mongos.adminCommand({setParameter: 1, internalQueryApportionSampleAcrossShards: false}));
+    runSample("not apportioned");
+    sizes = shardSampleSizes("not apportioned");
+    assert.eq(sizes, [50, 50], tojson(sizes));
+
+    st.stop();
+})();
@@ -28,9 +28,12 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 /**
@@ -64,4 +67,64 @@ public:
 private:
     AtomicInt64 _counter;
 };
+
+/**
+ * A 64bit (atomic) counter for values bumped by many threads at once, with the same interface as
+ * Counter64.
+ *
+ * A single atomic that every thread increments keeps bouncing its cache line between cores. This
+ * counter instead spreads its value over kNumShards cache-aligned shards: each thread always
+ * increments the same shard, chosen round-robin the first time the thread touches any sharded
+ * counter, and readers sum all of the shards. Updates are therefore cheap while reads cost
+ * kNumShards loads, which suits counters that are written on every operation and read only by
+ * serverStatus and FTDC.
+ *
+ * The sum is not a snapshot: increments that race with get() may or may not be included.
+ */
+class ShardedCounter64 {
+public:
+    static constexpr size_t kNumShards = 16;
+
+    /** Increment this thread's shard, returning the shard's new value. */
+    long long increment(uint64_t n = 1) {
+        return _shards[_myShard()].addAndFetch(n);
+    }
+
+    /** Decrement this thread's shard, returning the shard's new value. */
+    long long decrement(uint64_t n = 1) {
+        return _shards[_myShard()].subtractAndFetch(n);
+    }
+
+    /** Return the sum of all shards */
+    long long get() const {
+        long long sum = 0;
+        for (const auto& shard : _shards) {
+            sum += shard.loadRelaxed();
+        }
+        return sum;
+    }
+
+    operator long long() const {
+        return get();
+    }
+
+    /**
+     * Set the counter back to zero. Increments that race with reset() may survive it, which is
+     * fine for the overflow resets this exists for.
+     */
+    void reset() {
+        for (auto& shard : _shards) {
+            shard.store(0);
+        }
+    }
+
+private:
+    static size_t _myShard() {
+        static AtomicWord<unsigned> nextShard;
+        thread_local const size_t myShard = nextShard.fetchAndAdd(1) % kNumShards;
+        return myShard;
+    }
+
+    std::array<CacheAligned<AtomicInt64>, kNumShards> _shards{};
+};
 }  // namespace mongo
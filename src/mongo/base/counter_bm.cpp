@@ -0,0 +1,65 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/base/counter.h"
+
+namespace mongo {
+namespace {
+
+Counter64 counter;
+ShardedCounter64 shardedCounter;
+
+void BM_Counter64Increment(benchmark::State& state) {
+    for (auto _ : state) {
+        counter.increment();
+    }
+}
+
+void BM_ShardedCounter64Increment(benchmark::State& state) {
+    for (auto _ : state) {
+        shardedCounter.increment();
+    }
+}
+
+void BM_ShardedCounter64Get(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shardedCounter.get());
+    }
+}
+
+BENCHMARK(BM_Counter64Increment)->ThreadRange(1, 16);
+BENCHMARK(BM_ShardedCounter64Increment)->ThreadRange(1, 16);
+BENCHMARK(BM_ShardedCounter64Get);
+
+}  // namespace
+}  // namespace mongo
@@ -30,8 +30,10 @@
 
 #include <climits>
 #include <iostream>
+#include <vector>
 
 #include "mongo/base/counter.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -53,5 +55,51 @@ TEST(CounterTest, Test1) {
     ASSERT_EQUALS(static_cast<long long>(c), 0);
 }
 
+TEST(ShardedCounterTest, Test1) {
+    ShardedCounter64 c;
+    ASSERT_EQUALS(c.get(), 0);
+    c.increment();
+    ASSERT_EQUALS(c.get(), 1);
+    c.decrement();
+    ASSERT_EQUALS(c.get(), 0);
+    c.decrement(3);
+    ASSERT_EQUALS(c.get(), -3);
+    c.increment(5);
+    ASSERT_EQUALS(static_cast<long long>(c), 2);
+    c.reset();
+    ASSERT_EQUALS(c.get(), 0);
+}
+
+TEST(ShardedCounterTest, SumsIncrementsFromManyThreads) {
+    const int kThreads = 2 * ShardedCounter64::kNumShards + 1;
+    const int kIncrementsPerThread = 10000;
+
+    ShardedCounter64 c;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kIncrementsPerThread; ++j) {
+                c.increment();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQUALS(c.get(), static_cast<long long>(kThreads) * kIncrementsPerThread);
+}
+
+TEST(ShardedCounterTest, ResetClearsEveryThreadsIncrements) {
+    ShardedCounter64 c;
+    c.increment(10);
+    stdx::thread([&] { c.increment(100); }).join();
+    ASSERT_EQUALS(c.get(), 110);
+
+    c.reset();
+    ASSERT_EQUALS(c.get(), 0);
+    ASSERT_EQUALS(c.increment(), 1);
+}
+
 }  // namespace
 }  // namespace mongo
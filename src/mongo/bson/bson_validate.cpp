@@ -27,9 +27,14 @@
  *    then also delete it in the license file.
  */
 
+#include <boost/container/small_vector.hpp>
 #include <cstring>
 #include <limits>
-#include <vector>
+
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#define MONGO_BSON_VALIDATE_SSE2
+#endif
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
@@ -37,6 +42,7 @@
 #include "mongo/bson/oid.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/platform/bits.h"
 #include "mongo/platform/decimal128.h"
 
 namespace mongo {
@@ -67,6 +73,27 @@ Status NOINLINE_DECL makeError(StringData baseMsg, BSONElement idElem, StringDat
     return Status(ErrorCodes::InvalidBSON, msg);
 }
 
+/**
+ * Returns the first NUL byte in [start, start + len), or nullptr if there is none.
+ *
+ * Field names are almost always shorter than 16 bytes, so on x86-64 a single vector compare
+ * usually finds the terminator without the call into memchr.
+ */
+const char* findNul(const char* start, uint64_t len) {
+#ifdef MONGO_BSON_VALIDATE_SSE2
+    if (len >= sizeof(__m128i)) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(start));
+        const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_setzero_si128()));
+        if (mask) {
+            return start + countTrailingZeros64(mask);
+        }
+        start += sizeof(__m128i);
+        len -= sizeof(__m128i);
+    }
+#endif
+    return static_cast<const char*>(memchr(start, 0, len));
+}
+
 class Buffer {
 public:
     Buffer(const char* buffer, uint64_t maxLength, BSONVersion version)
@@ -89,10 +116,10 @@ public:
      * reading, if it exists. Otherwise, it should be empty.
      */
     Status readCString(StringData elemName, StringData* out) {
-        const void* x = memchr(_buffer + _position, 0, _maxLength - _position);
+        const char* x = findNul(_buffer + _position, _maxLength - _position);
         if (!x)
             return makeError("no end of c-string", _idElem, elemName);
-        uint64_t len = static_cast<uint64_t>(static_cast<const char*>(x) - (_buffer + _position));
+        uint64_t len = static_cast<uint64_t>(x - (_buffer + _position));
 
         StringData data(_buffer + _position, len);
         _position += len + 1;
@@ -308,8 +335,8 @@ Status validateElementInfo(Buffer* buffer,
 }
 
 Status validateBSONIterative(Buffer* buffer) {
-    std::vector<ValidationObjectFrame> frames;
-    frames.reserve(16);
+    // Nearly every document is shallow enough for its frames to live on the stack.
+    boost::container::small_vector<ValidationObjectFrame, 16> frames;
     ValidationObjectFrame* curr = NULL;
     ValidationState::State state = ValidationState::BeginObj;
 
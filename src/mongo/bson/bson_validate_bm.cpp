@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/oid.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A document of 'numFields' mixed scalar fields with short names, as typical inserts have.
+ */
+BSONObj makeFlat(int numFields) {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    for (int i = 0; i < numFields; ++i) {
+        const auto name = "field" + std::to_string(i);
+        switch (i % 4) {
+            case 0:
+                bob.append(name, i);
+                break;
+            case 1:
+                bob.append(name, i * 1.5);
+                break;
+            case 2:
+                bob.append(name, "value" + std::to_string(i));
+                break;
+            case 3:
+                bob.append(name, i % 2 == 0);
+                break;
+        }
+    }
+    return bob.obj();
+}
+
+/**
+ * A chain of 'depth' subdocuments, each holding a few scalars.
+ */
+BSONObj makeNested(int depth) {
+    BSONObj inner = BSON("a" << 1 << "b"
+                             << "leaf");
+    for (int i = 0; i < depth; ++i) {
+        inner = BSON("level" << i << "name"
+                             << "nested"
+                             << "child"
+                             << inner);
+    }
+    return BSON("_id" << OID::gen() << "root" << inner);
+}
+
+/**
+ * An array of 'numElements' small subdocuments, like an embedded list of line items.
+ */
+BSONObj makeArrays(int numElements) {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    {
+        BSONArrayBuilder items(bob.subarrayStart("items"));
+        for (int i = 0; i < numElements; ++i) {
+            items.append(BSON("sku" << i << "qty" << i % 7 << "tags" << BSON_ARRAY("a"
+                                                                                  << "b")));
+        }
+    }
+    return bob.obj();
+}
+
+void runValidate(benchmark::State& state, const BSONObj& obj) {
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+void BM_validateFlat(benchmark::State& state) {
+    runValidate(state, makeFlat(state.range(0)));
+}
+
+void BM_validateNested(benchmark::State& state) {
+    runValidate(state, makeNested(state.range(0)));
+}
+
+void BM_validateArrays(benchmark::State& state) {
+    runValidate(state, makeArrays(state.range(0)));
+}
+
+BENCHMARK(BM_validateFlat)->ArgName("fields")->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(BM_validateNested)->ArgName("depth")->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(BM_validateArrays)->ArgName("elements")->Arg(8)->Arg(128)->Arg(4096);
+
+}  // namespace
+}  // namespace mongo
@@ -249,6 +249,29 @@ TEST(BSONValidateFast, NestedObject) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2, BSONVersion::kLatest));
 }
 
+TEST(BSONValidateFast, FieldNamesAroundVectorWidth) {
+    // Field name terminators may be found by a 16 byte vector compare, so exercise names ending
+    // on either side of that width, and documents truncated within the name.
+    for (size_t nameLen = 1; nameLen <= 40; ++nameLen) {
+        const std::string name(nameLen, 'f');
+        BSONObj x = BSON(name << 1 << "deep" << BSON(name << "value"));
+        ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
+        for (int len = 5; len < x.objsize(); len += 3) {
+            ASSERT_NOT_OK(validateBSON(x.objdata(), len, BSONVersion::kLatest));
+        }
+    }
+}
+
+TEST(BSONValidateFast, DeeplyNestedObject) {
+    // Deeper than the frames kept on the stack.
+    BSONObj x = BSON("leaf" << 1);
+    for (int i = 0; i < 40; ++i) {
+        x = BSON("a" << i << "child" << x);
+    }
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
+    ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() - 1, BSONVersion::kLatest));
+}
+
 TEST(BSONValidateFast, ErrorWithId) {
     BufBuilder bb;
     BSONObjBuilder ob(bb);
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobj_field_index.h"
+
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr int BSONObjFieldIndex::kMinFieldsToIndex;
+
+namespace {
+
+thread_local BSONObjFieldIndex::Scope* currentScope = nullptr;
+
+// FNV-1a, which is cheap for the short names that fields usually have.
+uint32_t hashFieldName(StringData name) {
+    uint32_t hash = 2166136261U;
+    for (char c : name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619U;
+    }
+    return hash;
+}
+
+}  // namespace
+
+BSONObjFieldIndex::Scope::Scope() : _previous(currentScope) {
+    currentScope = this;
+}
+
+BSONObjFieldIndex::Scope::~Scope() {
+    invariant(currentScope == this);
+    currentScope = _previous;
+}
+
+void BSONObjFieldIndex::Scope::attach(const BSONObj& obj) {
+    auto& index = _indexes[obj.objdata()];
+    if (!index) {
+        index = stdx::make_unique<BSONObjFieldIndex>(obj);
+    }
+}
+
+BSONObjFieldIndex* BSONObjFieldIndex::Scope::_find(const char* objdata) const {
+    auto it = _indexes.find(objdata);
+    return it == _indexes.end() ? nullptr : it->second.get();
+}
+
+BSONObjFieldIndex::BSONObjFieldIndex(const BSONObj& obj) : _obj(obj) {}
+
+BSONElement BSONObjFieldIndex::getField(StringData name) {
+    if (!_built) {
+        // A single lookup is cheaper as a scan than as a scan that also fills the table.
+        if (++_lookups < 2) {
+            return _obj.getField(name);
+        }
+        _build();
+    }
+    if (_slots.empty()) {
+        return _obj.getField(name);
+    }
+
+    const uint32_t hash = hashFieldName(name);
+    for (uint32_t i = hash & _mask;; i = (i + 1) & _mask) {
+        const Slot& slot = _slots[i];
+        if (slot.offset == 0) {
+            return BSONElement();
+        }
+        if (slot.hash == hash) {
+            BSONElement elem(_obj.objdata() + slot.offset);
+            if (elem.fieldNameStringData() == name) {
+                return elem;
+            }
+        }
+    }
+}
+
+void BSONObjFieldIndex::_build() {
+    _built = true;
+
+    const int nFields = _obj.nFields();
+    if (nFields < kMinFieldsToIndex) {
+        return;
+    }
+
+    // Keep the table at most half full so that probe sequences stay short.
+    uint32_t capacity = 1;
+    while (capacity < 2U * nFields) {
+        capacity <<= 1;
+    }
+    _slots.resize(capacity, Slot{0, 0});
+    _mask = capacity - 1;
+
+    for (auto&& elem : _obj) {
+        const auto name = elem.fieldNameStringData();
+        const uint32_t hash = hashFieldName(name);
+        for (uint32_t i = hash & _mask;; i = (i + 1) & _mask) {
+            Slot& slot = _slots[i];
+            if (slot.offset == 0) {
+                slot.offset = static_cast<uint32_t>(elem.rawdata() - _obj.objdata());
+                slot.hash = hash;
+                break;
+            }
+            // Keep only the first of any duplicate names, since that is what getField() finds.
+            if (slot.hash == hash &&
+                BSONElement(_obj.objdata() + slot.offset).fieldNameStringData() == name) {
+                break;
+            }
+        }
+    }
+}
+
+BSONElement BSONObjFieldIndex::lookup(const BSONObj& obj, StringData name) {
+    for (auto scope = currentScope; scope; scope = scope->_previous) {
+        if (auto index = scope->_find(obj.objdata())) {
+            return index->getField(name);
+        }
+    }
+    return obj.getField(name);
+}
+
+}  // namespace mongo
@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * A hash table from the top-level field names of a BSONObj to the offsets of their elements, so
+ * that code which extracts many fields from the same wide document does not pay for a linear
+ * scan on each lookup the way BSONObj::getField() does.
+ *
+ * Indexes are opt-in: a Scope attaches them to documents for as long as it is alive on the current
+ * thread, and lookup() consults the attached index of a document if it has one. Paths such as
+ * index key generation, partial index filters and shard key extraction call lookup() in place of
+ * getField(), so a caller that processes one document across all of a collection's indexes can
+ * share the cost of building the table between them.
+ *
+ * The table is built lazily, on the second lookup against a document with at least
+ * kMinFieldsToIndex fields. A document that is only read once, or that is narrow enough to scan
+ * quickly, never pays for it.
+ */
+class BSONObjFieldIndex {
+    MONGO_DISALLOW_COPYING(BSONObjFieldIndex);
+
+public:
+    static constexpr int kMinFieldsToIndex = 16;
+
+    /**
+     * Attaches field indexes to documents on the current thread until destroyed. Scopes may be
+     * nested; lookups consult every live scope, innermost first. The documents must outlive the
+     * scope and must not be modified while attached.
+     */
+    class Scope {
+        MONGO_DISALLOW_COPYING(Scope);
+
+    public:
+        Scope();
+        ~Scope();
+
+        /**
+         * Makes lookups against 'obj' use an index. Attaching the same document twice is a no-op.
+         */
+        void attach(const BSONObj& obj);
+
+    private:
+        friend class BSONObjFieldIndex;
+
+        BSONObjFieldIndex* _find(const char* objdata) const;
+
+        Scope* const _previous;
+        std::unordered_map<const char*, std::unique_ptr<BSONObjFieldIndex>> _indexes;
+    };
+
+    explicit BSONObjFieldIndex(const BSONObj& obj);
+
+    /**
+     * Returns the first top-level element of the indexed document named 'name', or EOO if there
+     * is none, exactly as BSONObj::getField() would.
+     */
+    BSONElement getField(StringData name);
+
+    /**
+     * Returns obj.getField(name), using the index attached to 'obj' on this thread if there is one.
+     */
+    static BSONElement lookup(const BSONObj& obj, StringData name);
+
+private:
+    struct Slot {
+        // Offset of the element from the start of the document. No element starts at offset zero,
+        // so zero marks an empty slot.
+        uint32_t offset;
+        uint32_t hash;
+    };
+
+    void _build();
+
+    const BSONObj _obj;
+    int _lookups = 0;
+    bool _built = false;
+
+    // Open-addressed table of the document's fields. Stays empty if the document is too narrow to
+    // be worth indexing.
+    std::vector<Slot> _slots;
+    uint32_t _mask = 0;
+};
+
+}  // namespace mongo
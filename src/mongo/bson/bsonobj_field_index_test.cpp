@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobj_field_index.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeWide(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numFields; ++i) {
+        bob.append("field" + std::to_string(i), i);
+    }
+    return bob.obj();
+}
+
+void assertSameElement(const BSONElement& expected, const BSONElement& actual) {
+    ASSERT_TRUE(expected.rawdata() == actual.rawdata()) << expected << " vs " << actual;
+}
+
+TEST(BSONObjFieldIndex, FindsEveryFieldOfAWideDocument) {
+    const auto obj = makeWide(300);
+    BSONObjFieldIndex index(obj);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (auto&& elem : obj) {
+            assertSameElement(elem, index.getField(elem.fieldNameStringData()));
+        }
+    }
+    ASSERT_TRUE(index.getField("missing").eoo());
+    ASSERT_TRUE(index.getField("").eoo());
+    ASSERT_TRUE(index.getField("field3000").eoo());
+}
+
+TEST(BSONObjFieldIndex, FindsTheFirstOfDuplicateNames) {
+    BSONObjBuilder bob;
+    bob.appendElements(makeWide(32));
+    bob.append("field7", "duplicate");
+    const auto obj = bob.obj();
+
+    BSONObjFieldIndex index(obj);
+    for (int pass = 0; pass < 2; ++pass) {
+        assertSameElement(obj.getField("field7"), index.getField("field7"));
+    }
+}
+
+TEST(BSONObjFieldIndex, NarrowDocumentsAreScanned) {
+    const auto obj = BSON("a" << 1 << "b" << 2);
+    BSONObjFieldIndex index(obj);
+    for (int pass = 0; pass < 2; ++pass) {
+        assertSameElement(obj["a"], index.getField("a"));
+        assertSameElement(obj["b"], index.getField("b"));
+        ASSERT_TRUE(index.getField("c").eoo());
+    }
+}
+
+TEST(BSONObjFieldIndex, LookupWithoutScopeScans) {
+    const auto obj = makeWide(64);
+    assertSameElement(obj["field42"], BSONObjFieldIndex::lookup(obj, "field42"));
+    ASSERT_TRUE(BSONObjFieldIndex::lookup(obj, "missing").eoo());
+}
+
+TEST(BSONObjFieldIndex, LookupUsesTheAttachedIndex) {
+    const auto wide = makeWide(64);
+    const auto other = makeWide(64);
+    {
+        BSONObjFieldIndex::Scope scope;
+        scope.attach(wide);
+        scope.attach(wide);
+        for (int pass = 0; pass < 3; ++pass) {
+            assertSameElement(wide["field42"], BSONObjFieldIndex::lookup(wide, "field42"));
+            assertSameElement(other["field42"], BSONObjFieldIndex::lookup(other, "field42"));
+        }
+
+        BSONObjFieldIndex::Scope nested;
+        nested.attach(other);
+        for (int pass = 0; pass < 3; ++pass) {
+            assertSameElement(wide["field1"], BSONObjFieldIndex::lookup(wide, "field1"));
+            assertSameElement(other["field1"], BSONObjFieldIndex::lookup(other, "field1"));
+        }
+    }
+    assertSameElement(wide["field7"], BSONObjFieldIndex::lookup(wide, "field7"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -125,6 +125,21 @@ public:
         _b.reserveBytes(1);
     }
 
+    /**
+     * Creates a new BSONObjBuilder that builds into 'buf', which must not be shared. Useful with
+     * SharedBufferPool::acquire() to avoid allocating a fresh buffer for every object.
+     */
+    explicit BSONObjBuilder(SharedBuffer buf)
+        : _b(_buf), _buf(0), _offset(0), _s(this), _tracker(0), _doneCalled(false) {
+        _b.useSharedBuffer(std::move(buf));
+
+        // See the comments in the first constructor for details.
+        _b.skip(sizeof(int));
+
+        // Reserve space for the EOO byte. This means _done() can't fail.
+        _b.reserveBytes(1);
+    }
+
     /**
      * Creates a new BSONObjBuilder prefixed with the fields in 'prefix'.
      *
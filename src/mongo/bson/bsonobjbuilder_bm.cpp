@@ -31,6 +31,7 @@
 #include <benchmark/benchmark.h>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 
@@ -49,4 +50,29 @@ void BM_arrayBuilder(benchmark::State& state) {
 
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 
+void BM_smallObjectBuilder(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        BSONObjBuilder bob;
+        for (auto j = 0; j < state.range(0); j++)
+            bob.append("field", j);
+        benchmark::DoNotOptimize(bob.obj());
+    }
+}
+
+void BM_smallObjectBuilderPooled(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        BSONObjBuilder bob(SharedBufferPool::acquire(512));
+        for (auto j = 0; j < state.range(0); j++)
+            bob.append("field", j);
+        auto obj = bob.obj();
+        benchmark::DoNotOptimize(obj.objdata());
+        SharedBufferPool::recycle(obj.releaseSharedBuffer());
+    }
+}
+
+BENCHMARK(BM_smallObjectBuilder)->Arg(1)->Arg(10)->Arg(50);
+BENCHMARK(BM_smallObjectBuilderPooled)->Arg(1)->Arg(10)->Arg(50);
+
 }  // namespace mongo
@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/bson/json_stream_parser.h"
+#include "mongo/bson/oid.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A document of 'numFields' mixed scalar fields with short names, as typical inserts have.
+ */
+BSONObj makeFlat(int numFields) {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    for (int i = 0; i < numFields; ++i) {
+        const auto name = "field" + std::to_string(i);
+        switch (i % 4) {
+            case 0:
+                bob.append(name, i);
+                break;
+            case 1:
+                bob.append(name, i * 1.5);
+                break;
+            case 2:
+                bob.append(name, "value" + std::to_string(i));
+                break;
+            case 3:
+                bob.append(name, i % 2 == 0);
+                break;
+        }
+    }
+    return bob.obj();
+}
+
+/**
+ * A chain of 'depth' subdocuments, each holding a few scalars.
+ */
+BSONObj makeNested(int depth) {
+    BSONObj inner = BSON("a" << 1 << "b"
+                             << "leaf");
+    for (int i = 0; i < depth; ++i) {
+        inner = BSON("level" << i << "name"
+                             << "nested"
+                             << "child"
+                             << inner);
+    }
+    return BSON("root" << inner);
+}
+
+/**
+ * A single array of 'numElements' doubles, as time series or geo payloads have.
+ */
+BSONObj makeNumbers(int numElements) {
+    BSONObjBuilder bob;
+    {
+        BSONArrayBuilder values(bob.subarrayStart("values"));
+        for (int i = 0; i < numElements; ++i) {
+            values.append(i * 0.25 - 1000);
+        }
+    }
+    return bob.obj();
+}
+
+/**
+ * 'numFields' string fields full of characters that JSON must escape.
+ */
+BSONObj makeEscaped(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numFields; ++i) {
+        bob.append("text" + std::to_string(i),
+                   "line one\nline \"two\"\twith a C:\\path and \xc3\xa9 " + std::to_string(i));
+    }
+    return bob.obj();
+}
+
+/**
+ * 'numFields' fields cycling through the types that need Extended JSON wrappers.
+ */
+BSONObj makeExtended(int numFields) {
+    BSONObjBuilder bob;
+    const char bin[] = "binary payload";
+    for (int i = 0; i < numFields; ++i) {
+        const auto name = "field" + std::to_string(i);
+        switch (i % 5) {
+            case 0:
+                bob.append(name, OID::gen());
+                break;
+            case 1:
+                bob.append(name, static_cast<long long>(i) << 33);
+                break;
+            case 2:
+                bob.appendDate(name, Date_t::fromMillisSinceEpoch(1500000000000LL + i));
+                break;
+            case 3:
+                bob.append(name, Timestamp(i, 1));
+                break;
+            case 4:
+                bob.appendBinData(name, sizeof(bin), BinDataGeneral, bin);
+                break;
+        }
+    }
+    return bob.obj();
+}
+
+/**
+ * Maps the benchmark argument to one of the documents above, rendered as strict Extended JSON
+ * so that both parsers accept it.
+ */
+std::string makeJson(int corpus) {
+    switch (corpus) {
+        case 0:
+            return tojson(makeFlat(256), Strict);
+        case 1:
+            return tojson(makeNested(64), Strict);
+        case 2:
+            return tojson(makeNumbers(4096), Strict);
+        case 3:
+            return tojson(makeEscaped(64), Strict);
+        default:
+            return tojson(makeExtended(256), Strict);
+    }
+}
+
+void BM_fromjson(benchmark::State& state) {
+    const auto json = makeJson(state.range(0));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(fromjson(json));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+void BM_jsonStreamParser(benchmark::State& state) {
+    const auto json = makeJson(state.range(0));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(fromExtendedJson(json));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+/**
+ * Parses a stream of newline separated documents, as mongoimport reads them.
+ */
+void BM_jsonStreamParserConcatenated(benchmark::State& state) {
+    const auto doc = tojson(makeFlat(16), Strict);
+    std::string json;
+    for (int i = 0; i < state.range(0); ++i) {
+        json += doc;
+        json += '\n';
+    }
+    for (auto keepRunning : state) {
+        JsonStreamParser parser(json);
+        while (parser.more()) {
+            benchmark::DoNotOptimize(parser.next());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+// The corpora are: 0 flat, 1 nested, 2 numeric array, 3 escaped strings, 4 extended types.
+BENCHMARK(BM_fromjson)->ArgName("corpus")->DenseRange(0, 4);
+BENCHMARK(BM_jsonStreamParser)->ArgName("corpus")->DenseRange(0, 4);
+BENCHMARK(BM_jsonStreamParserConcatenated)->ArgName("documents")->Arg(16)->Arg(1024);
+
+}  // namespace
+}  // namespace mongo
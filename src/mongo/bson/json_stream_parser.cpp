@@ -0,0 +1,1364 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json_stream_parser.h"
+
+#include <algorithm>
+#include <array>
+#include <boost/optional.hpp>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#define MONGO_JSON_STREAM_SSE2
+#endif
+
+#include "mongo/base/data_view.h"
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bson_depth.h"
+#include "mongo/bson/bsontypes.h"
+#include "mongo/bson/oid.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/platform/bits.h"
+#include "mongo/platform/decimal128.h"
+#include "mongo/util/base64.h"
+#include "mongo/util/decimal_counter.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+//
+// Stage 1: find the structural characters.
+//
+
+constexpr size_t kBlockSize = 64;
+
+enum CharClass : uint8_t {
+    kQuote = 1 << 0,
+    kBackslash = 1 << 1,
+    kOperator = 1 << 2,  // One of {}[]:,
+    kWhitespace = 1 << 3,
+};
+
+const std::array<uint8_t, 256> kCharClasses = [] {
+    std::array<uint8_t, 256> classes{};
+    classes['"'] = kQuote;
+    classes['\\'] = kBackslash;
+    for (unsigned char c : {'{', '}', '[', ']', ':', ','}) {
+        classes[c] = kOperator;
+    }
+    for (unsigned char c : {' ', '\t', '\n', '\r'}) {
+        classes[c] = kWhitespace;
+    }
+    return classes;
+}();
+
+bool isSeparator(char c) {
+    return kCharClasses[static_cast<unsigned char>(c)] & (kQuote | kOperator | kWhitespace);
+}
+
+/**
+ * Bitmasks of the characters of interest in a 64-byte block; bit i is set if the i'th byte is in
+ * that class.
+ */
+struct BlockMasks {
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t op = 0;
+    uint64_t whitespace = 0;
+};
+
+#if defined(MONGO_JSON_STREAM_SSE2)
+uint64_t matchMask(const __m128i (&chunks)[4], char c) {
+    const auto needle = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        const uint32_t bits = _mm_movemask_epi8(_mm_cmpeq_epi8(chunks[i], needle));
+        mask |= static_cast<uint64_t>(bits) << (16 * i);
+    }
+    return mask;
+}
+
+BlockMasks classifyBlock(const char* block) {
+    __m128i chunks[4];
+    __m128i folded[4];
+    // Setting the 0x20 bit folds '[' and ']' onto '{' and '}', and leaves ':' and ',' alone.
+    const auto caseBit = _mm_set1_epi8(0x20);
+    for (int i = 0; i < 4; ++i) {
+        chunks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+        folded[i] = _mm_or_si128(chunks[i], caseBit);
+    }
+
+    BlockMasks masks;
+    masks.quote = matchMask(chunks, '"');
+    masks.backslash = matchMask(chunks, '\\');
+    masks.op = matchMask(folded, '{') | matchMask(folded, '}') | matchMask(chunks, ':') |
+        matchMask(chunks, ',');
+    masks.whitespace = matchMask(chunks, ' ') | matchMask(chunks, '\t') |
+        matchMask(chunks, '\n') | matchMask(chunks, '\r');
+    return masks;
+}
+#else
+BlockMasks classifyBlock(const char* block) {
+    BlockMasks masks;
+    for (size_t i = 0; i < kBlockSize; ++i) {
+        const auto charClass = kCharClasses[static_cast<unsigned char>(block[i])];
+        const uint64_t bit = 1ULL << i;
+        masks.quote |= (charClass & kQuote) ? bit : 0;
+        masks.backslash |= (charClass & kBackslash) ? bit : 0;
+        masks.op |= (charClass & kOperator) ? bit : 0;
+        masks.whitespace |= (charClass & kWhitespace) ? bit : 0;
+    }
+    return masks;
+}
+#endif
+
+/**
+ * Returns the mask of characters that follow an odd-length run of backslashes, i.e. that are
+ * escaped. '*carry' says whether the first character of this block is escaped by the end of the
+ * previous one, and is updated for the next block. Backslashes are rare, so this only does work
+ * per backslash.
+ */
+uint64_t findEscaped(uint64_t backslash, uint64_t* carry) {
+    uint64_t escaped = *carry;
+    *carry = 0;
+    while (backslash) {
+        const auto i = countTrailingZeros64(backslash);
+        backslash &= backslash - 1;
+        if (escaped & (1ULL << i)) {
+            continue;  // This backslash is itself escaped.
+        }
+        if (i == kBlockSize - 1) {
+            *carry = 1;
+        } else {
+            escaped |= 1ULL << (i + 1);
+        }
+    }
+    return escaped;
+}
+
+/**
+ * Sets each bit to the parity of the set bits at or below it, which turns a mask of quotes into a
+ * mask covering each opening quote up to, but not including, its closing quote.
+ */
+uint64_t prefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+Status indexStructurals(StringData json, std::vector<uint32_t>* structurals) {
+    if (json.size() > std::numeric_limits<uint32_t>::max()) {
+        return {ErrorCodes::BadValue, "JSON input must be smaller than 4GB"};
+    }
+    structurals->reserve(json.size() / 8 + 16);
+
+    uint64_t escapeCarry = 0;
+    uint64_t inStringCarry = 0;
+    uint64_t scalarCarry = 0;
+
+    auto indexBlock = [&](const char* block, uint32_t base) {
+        auto masks = classifyBlock(block);
+
+        const auto quote = masks.quote & ~findEscaped(masks.backslash, &escapeCarry);
+        const auto inString = prefixXor(quote) ^ inStringCarry;
+        inStringCarry = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+        // Numbers and literals are runs of characters outside of strings that aren't separators.
+        // Only the first character of each run is structural.
+        const auto scalar = ~(masks.op | masks.whitespace | quote) & ~inString;
+        const auto scalarStart = scalar & ~((scalar << 1) | scalarCarry);
+        scalarCarry = scalar >> 63;
+
+        auto bits = (masks.op & ~inString) | quote | scalarStart;
+        while (bits) {
+            structurals->push_back(base + countTrailingZeros64(bits));
+            bits &= bits - 1;
+        }
+    };
+
+    const char* const data = json.rawData();
+    const size_t fullBlocksEnd = json.size() - json.size() % kBlockSize;
+    for (size_t offset = 0; offset < fullBlocksEnd; offset += kBlockSize) {
+        indexBlock(data + offset, offset);
+    }
+    if (fullBlocksEnd < json.size()) {
+        // Pad the last partial block with whitespace, which is never structural.
+        char block[kBlockSize];
+        std::memset(block, ' ', kBlockSize);
+        std::memcpy(block, data + fullBlocksEnd, json.size() - fullBlocksEnd);
+        indexBlock(block, fullBlocksEnd);
+    }
+
+    if (inStringCarry) {
+        return {ErrorCodes::FailedToParse,
+                str::stream() << "Unterminated string: offset:" << structurals->back()};
+    }
+    return Status::OK();
+}
+
+//
+// Stage 2: walk the structural characters and build BSON.
+//
+
+class DocumentParser {
+public:
+    DocumentParser(StringData json, const std::vector<uint32_t>& structurals, size_t* next)
+        : _json(json), _structurals(structurals), _next(*next) {}
+
+    Status parseDocument(BufBuilder* buf) {
+        if (_peek() != '{') {
+            return _error("Expecting '{'");
+        }
+        _advance();
+
+        if (_peek() == '}') {
+            _advance();
+            buf->appendNum(static_cast<int>(BSONObj::kMinBSONLength));
+            buf->appendChar(EOO);
+            return Status::OK();
+        }
+
+        std::string scratch;
+        StringData firstField;
+        auto status = _readFieldName(&firstField, &scratch);
+        if (!status.isOK()) {
+            return status;
+        }
+        return _members(firstField, buf, 1);
+    }
+
+private:
+    Status _error(const std::string& msg) const {
+        return {ErrorCodes::FailedToParse, str::stream() << msg << ": offset:" << _offset()};
+    }
+
+    bool _atEnd() const {
+        return _next >= _structurals.size();
+    }
+
+    size_t _offset() const {
+        return _atEnd() ? _json.size() : _structurals[_next];
+    }
+
+    char _peek() const {
+        return _atEnd() ? '\0' : _json[_structurals[_next]];
+    }
+
+    char _peekAhead(size_t n) const {
+        return _next + n < _structurals.size() ? _json[_structurals[_next + n]] : '\0';
+    }
+
+    void _advance() {
+        ++_next;
+    }
+
+    Status _expect(char c, const char* msg) {
+        if (_peek() != c) {
+            return _error(msg);
+        }
+        _advance();
+        return Status::OK();
+    }
+
+    /**
+     * Returns the number or literal that starts at the current structural character.
+     */
+    StringData _scalar() {
+        const auto start = _offset();
+        auto end = start;
+        while (end < _json.size() && !isSeparator(_json[end])) {
+            ++end;
+        }
+        _advance();
+        return _json.substr(start, end - start);
+    }
+
+    /**
+     * Reads the string at the current structural character. Strings without escapes are returned
+     * in place; the rest are unescaped into 'scratch'.
+     */
+    Status _readString(StringData* out, std::string* scratch) {
+        if (_peek() != '"') {
+            return _error("Expecting '\"'");
+        }
+        const auto open = _offset();
+        _advance();
+
+        // Stage 1 guarantees that the next structural character is the closing quote.
+        const auto close = _offset();
+        _advance();
+
+        const auto contents = _json.substr(open + 1, close - open - 1);
+        if (!std::memchr(contents.rawData(), '\\', contents.size())) {
+            *out = contents;
+            return Status::OK();
+        }
+        auto status = _unescape(contents, open + 1, scratch);
+        if (!status.isOK()) {
+            return status;
+        }
+        *out = *scratch;
+        return Status::OK();
+    }
+
+    Status _unescape(StringData contents, size_t offset, std::string* out) const {
+        out->clear();
+        out->reserve(contents.size());
+
+        auto readHex4 = [&](size_t i, unsigned* codePoint) {
+            if (i + 4 > contents.size()) {
+                return false;
+            }
+            *codePoint = 0;
+            for (size_t j = i; j < i + 4; ++j) {
+                const char c = contents[j];
+                unsigned digit;
+                if (c >= '0' && c <= '9') {
+                    digit = c - '0';
+                } else if (c >= 'a' && c <= 'f') {
+                    digit = c - 'a' + 10;
+                } else if (c >= 'A' && c <= 'F') {
+                    digit = c - 'A' + 10;
+                } else {
+                    return false;
+                }
+                *codePoint = (*codePoint << 4) | digit;
+            }
+            return true;
+        };
+
+        auto badEscape = [&](size_t i) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Invalid escape sequence: offset:" << offset + i);
+        };
+
+        for (size_t i = 0; i < contents.size(); ++i) {
+            const char c = contents[i];
+            if (c != '\\') {
+                out->push_back(c);
+                continue;
+            }
+
+            const size_t escapeStart = i++;
+            switch (i < contents.size() ? contents[i] : '\0') {
+                case '"':
+                case '\\':
+                case '/':
+                    out->push_back(contents[i]);
+                    break;
+                case 'b':
+                    out->push_back('\b');
+                    break;
+                case 'f':
+                    out->push_back('\f');
+                    break;
+                case 'n':
+                    out->push_back('\n');
+                    break;
+                case 'r':
+                    out->push_back('\r');
+                    break;
+                case 't':
+                    out->push_back('\t');
+                    break;
+                case 'u': {
+                    unsigned codePoint;
+                    if (!readHex4(i + 1, &codePoint)) {
+                        return badEscape(escapeStart);
+                    }
+                    i += 4;
+                    if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                        return badEscape(escapeStart);
+                    }
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                        // A high surrogate must be followed by an escaped low surrogate.
+                        unsigned low;
+                        if (i + 2 >= contents.size() || contents[i + 1] != '\\' ||
+                            contents[i + 2] != 'u' || !readHex4(i + 3, &low) || low < 0xDC00 ||
+                            low > 0xDFFF) {
+                            return badEscape(escapeStart);
+                        }
+                        i += 6;
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+
+                    if (codePoint < 0x80) {
+                        out->push_back(static_cast<char>(codePoint));
+                    } else if (codePoint < 0x800) {
+                        out->push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+                        out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+                    } else if (codePoint < 0x10000) {
+                        out->push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+                        out->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                        out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+                    } else {
+                        out->push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+                        out->push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+                        out->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                        out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+                    }
+                    break;
+                }
+                default:
+                    return badEscape(escapeStart);
+            }
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Like _readString(), but also rejects embedded NUL bytes, which can't appear in C strings.
+     */
+    Status _readCString(StringData* out, std::string* scratch) {
+        const auto offset = _offset();
+        auto status = _readString(out, scratch);
+        if (status.isOK() && std::memchr(out->rawData(), '\0', out->size())) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Field names and regular expressions may not contain NUL "
+                                     "bytes: offset:"
+                                  << offset};
+        }
+        return status;
+    }
+
+    Status _readFieldName(StringData* out, std::string* scratch) {
+        if (_peek() != '"') {
+            return _error("Expecting a quoted field name");
+        }
+        return _readCString(out, scratch);
+    }
+
+    void _appendHeader(BSONType type, StringData fieldName, BufBuilder* buf) {
+        buf->appendChar(static_cast<char>(type));
+        buf->appendStr(fieldName);
+    }
+
+    void _appendString(BSONType type, StringData fieldName, StringData value, BufBuilder* buf) {
+        _appendHeader(type, fieldName, buf);
+        buf->appendNum(static_cast<int>(value.size() + 1));
+        buf->appendStr(value);
+    }
+
+    /**
+     * Finishes an object or array whose length is at 'start'.
+     */
+    void _finishObject(int start, BufBuilder* buf) {
+        buf->appendChar(EOO);
+        DataView(buf->buf() + start).write<LittleEndian<int>>(buf->len() - start);
+    }
+
+    Status _checkDepth(uint32_t depth) const {
+        if (depth > BSONDepth::getMaxAllowableDepth()) {
+            return _error(str::stream() << "Exceeded the maximum nesting depth of "
+                                        << BSONDepth::getMaxAllowableDepth());
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Parses the members of an object whose '{' and first field name have been consumed, writing
+     * its length, elements and EOO byte.
+     */
+    Status _members(StringData firstField, BufBuilder* buf, uint32_t depth) {
+        const int start = buf->len();
+        buf->skip(sizeof(int));
+
+        std::string scratch;
+        StringData fieldName = firstField;
+        while (true) {
+            auto status = _expect(':', "Expecting ':'");
+            if (!status.isOK()) {
+                return status;
+            }
+            status = _value(fieldName, buf, depth);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            const char c = _peek();
+            _advance();
+            if (c == '}') {
+                break;
+            }
+            if (c != ',') {
+                --_next;
+                return _error("Expecting ',' or '}'");
+            }
+            status = _readFieldName(&fieldName, &scratch);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+
+        _finishObject(start, buf);
+        return Status::OK();
+    }
+
+    Status _object(StringData fieldName, BufBuilder* buf, uint32_t depth) {
+        auto status = _checkDepth(depth);
+        if (!status.isOK()) {
+            return status;
+        }
+        _advance();  // '{'
+
+        if (_peek() == '}') {
+            _advance();
+            _appendHeader(Object, fieldName, buf);
+            buf->appendNum(static_cast<int>(BSONObj::kMinBSONLength));
+            buf->appendChar(EOO);
+            return Status::OK();
+        }
+
+        std::string scratch;
+        StringData firstField;
+        status = _readFieldName(&firstField, &scratch);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        if (firstField.startsWith("$")) {
+            bool isTypeWrapper = false;
+            status = _typeWrapper(fieldName, firstField, buf, depth, &isTypeWrapper);
+            if (isTypeWrapper || !status.isOK()) {
+                return status;
+            }
+        }
+
+        _appendHeader(Object, fieldName, buf);
+        return _members(firstField, buf, depth);
+    }
+
+    Status _array(StringData fieldName, BufBuilder* buf, uint32_t depth) {
+        auto status = _checkDepth(depth);
+        if (!status.isOK()) {
+            return status;
+        }
+        _advance();  // '['
+
+        _appendHeader(Array, fieldName, buf);
+        const int start = buf->len();
+        buf->skip(sizeof(int));
+
+        if (_peek() == ']') {
+            _advance();
+            _finishObject(start, buf);
+            return Status::OK();
+        }
+
+        DecimalCounter<uint32_t> index;
+        while (true) {
+            status = _value(index, buf, depth);
+            if (!status.isOK()) {
+                return status;
+            }
+            ++index;
+
+            const char c = _peek();
+            _advance();
+            if (c == ']') {
+                break;
+            }
+            if (c != ',') {
+                --_next;
+                return _error("Expecting ',' or ']'");
+            }
+        }
+
+        _finishObject(start, buf);
+        return Status::OK();
+    }
+
+    Status _value(StringData fieldName, BufBuilder* buf, uint32_t depth) {
+        switch (_peek()) {
+            case '{':
+                return _object(fieldName, buf, depth + 1);
+            case '[':
+                return _array(fieldName, buf, depth + 1);
+            case '"': {
+                std::string scratch;
+                StringData value;
+                auto status = _readString(&value, &scratch);
+                if (!status.isOK()) {
+                    return status;
+                }
+                _appendString(String, fieldName, value, buf);
+                return Status::OK();
+            }
+            case '}':
+            case ']':
+            case ':':
+            case ',':
+            case '\0':
+                return _error("Expecting a value");
+            default:
+                return _scalarValue(fieldName, buf);
+        }
+    }
+
+    Status _scalarValue(StringData fieldName, BufBuilder* buf) {
+        const auto offset = _offset();
+        const auto token = _scalar();
+        switch (token[0]) {
+            case 't':
+                if (token == "true") {
+                    _appendHeader(Bool, fieldName, buf);
+                    buf->appendChar(1);
+                    return Status::OK();
+                }
+                break;
+            case 'f':
+                if (token == "false") {
+                    _appendHeader(Bool, fieldName, buf);
+                    buf->appendChar(0);
+                    return Status::OK();
+                }
+                break;
+            case 'n':
+                if (token == "null") {
+                    _appendHeader(jstNULL, fieldName, buf);
+                    return Status::OK();
+                }
+                break;
+            default:
+                return _number(fieldName, token, offset, buf);
+        }
+        return {ErrorCodes::FailedToParse,
+                str::stream() << "Unexpected token '" << token << "': offset:" << offset};
+    }
+
+    Status _number(StringData fieldName, StringData token, size_t offset, BufBuilder* buf) {
+        auto isDigit = [&](size_t i) {
+            return i < token.size() && token[i] >= '0' && token[i] <= '9';
+        };
+        auto invalid = [&] {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Invalid number '" << token << "': offset:" << offset);
+        };
+
+        // Check the token against the JSON number grammar, accumulating the integer part on the
+        // way for the common case of a small integer.
+        const bool negative = token[0] == '-';
+        size_t i = negative ? 1 : 0;
+        if (!isDigit(i)) {
+            return invalid();
+        }
+
+        uint64_t magnitude = 0;
+        const size_t integerStart = i;
+        if (token[i] == '0') {
+            ++i;
+        } else {
+            while (isDigit(i)) {
+                magnitude = magnitude * 10 + (token[i++] - '0');
+            }
+        }
+        const size_t integerDigits = i - integerStart;
+
+        bool isInteger = true;
+        if (i < token.size() && token[i] == '.') {
+            isInteger = false;
+            if (!isDigit(++i)) {
+                return invalid();
+            }
+            while (isDigit(i)) {
+                ++i;
+            }
+        }
+        if (i < token.size() && (token[i] == 'e' || token[i] == 'E')) {
+            isInteger = false;
+            ++i;
+            if (i < token.size() && (token[i] == '+' || token[i] == '-')) {
+                ++i;
+            }
+            if (!isDigit(i)) {
+                return invalid();
+            }
+            while (isDigit(i)) {
+                ++i;
+            }
+        }
+        if (i != token.size()) {
+            return invalid();
+        }
+
+        if (isInteger) {
+            // Up to 18 digits can't overflow 'magnitude' or a long long.
+            long long value;
+            bool fits = true;
+            if (integerDigits <= 18) {
+                value = negative ? -static_cast<long long>(magnitude)
+                                 : static_cast<long long>(magnitude);
+            } else {
+                fits = parseNumberFromStringWithBase(token, 10, &value).isOK();
+            }
+
+            if (fits) {
+                if (value >= std::numeric_limits<int>::min() &&
+                    value <= std::numeric_limits<int>::max()) {
+                    _appendHeader(NumberInt, fieldName, buf);
+                    buf->appendNum(static_cast<int>(value));
+                } else {
+                    _appendHeader(NumberLong, fieldName, buf);
+                    buf->appendNum(value);
+                }
+                return Status::OK();
+            }
+        }
+
+        double value;
+        if (!parseNumberFromString(token, &value).isOK()) {
+            return invalid();
+        }
+        _appendHeader(NumberDouble, fieldName, buf);
+        buf->appendNum(value);
+        return Status::OK();
+    }
+
+    //
+    // Extended JSON type wrappers. Each is called with the current structural character being
+    // the ':' after the wrapper's field name, and consumes the rest of the wrapper including its
+    // closing '}'.
+    //
+
+    Status _endWrapper(StringData wrapper) {
+        if (_peek() != '}') {
+            return _error(str::stream() << "Unexpected field in " << wrapper);
+        }
+        _advance();
+        return Status::OK();
+    }
+
+    /**
+     * Reads a string valued wrapper such as {"$numberLong": "1"}.
+     */
+    Status _wrappedString(StringData wrapper, StringData* out, std::string* scratch) {
+        auto status = _expect(':', "Expecting ':'");
+        if (!status.isOK()) {
+            return status;
+        }
+        if (_peek() != '"') {
+            return _error(str::stream() << wrapper << " requires a string value");
+        }
+        status = _readString(out, scratch);
+        if (!status.isOK()) {
+            return status;
+        }
+        return _endWrapper(wrapper);
+    }
+
+    /**
+     * Reads a document nested in a wrapper, such as the {"t": 1, "i": 2} of $timestamp, calling
+     * 'onField' for each field with the value as the current structural character. 'onField' must
+     * consume the value and reject unknown or repeated fields.
+     */
+    template <typename OnField>
+    Status _wrapperFields(StringData wrapper, OnField&& onField) {
+        auto status = _expect(':', "Expecting ':'");
+        if (!status.isOK()) {
+            return status;
+        }
+        if (_peek() != '{') {
+            return _error(str::stream() << wrapper << " requires an object value");
+        }
+        _advance();
+
+        std::string scratch;
+        StringData fieldName;
+        while (_peek() != '}') {
+            status = _readFieldName(&fieldName, &scratch);
+            if (!status.isOK()) {
+                return status;
+            }
+            status = _expect(':', "Expecting ':'");
+            if (!status.isOK()) {
+                return status;
+            }
+            status = onField(fieldName);
+            if (!status.isOK()) {
+                return status;
+            }
+            if (_peek() != ',') {
+                break;
+            }
+            _advance();
+        }
+
+        status = _expect('}', "Expecting '}'");
+        if (!status.isOK()) {
+            return status;
+        }
+        return _endWrapper(wrapper);
+    }
+
+    Status _wrapperFieldError(StringData wrapper, StringData fieldName) const {
+        return _error(str::stream() << "Unexpected or repeated field '" << fieldName << "' in "
+                                    << wrapper);
+    }
+
+    Status _missingFieldError(StringData wrapper, StringData fieldName) const {
+        return _error(str::stream() << wrapper << " requires a '" << fieldName << "' field");
+    }
+
+    /**
+     * Reads an unsigned 32-bit integer, as used by $timestamp.
+     */
+    Status _readUInt32(uint32_t* out) {
+        const auto offset = _offset();
+        if (_peek() == '"' || _peek() == '{' || _peek() == '[') {
+            return _error("Expecting an unsigned integer");
+        }
+        const auto token = _scalar();
+        long long value;
+        if (!parseNumberFromStringWithBase(token, 10, &value).isOK() || value < 0 ||
+            value > std::numeric_limits<uint32_t>::max()) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Expecting an unsigned 32-bit integer: offset:" << offset};
+        }
+        *out = static_cast<uint32_t>(value);
+        return Status::OK();
+    }
+
+    Status _readOid(StringData wrapper, OID* out) {
+        std::string scratch;
+        StringData hex;
+        const auto offset = _offset();
+        auto status = _wrappedString(wrapper, &hex, &scratch);
+        if (!status.isOK()) {
+            return status;
+        }
+        if (hex.size() != 2 * OID::kOIDSize ||
+            std::find_if_not(hex.begin(), hex.end(), [](unsigned char c) {
+                return std::isxdigit(c);
+            }) != hex.end()) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << wrapper << " requires 24 hex digits: offset:" << offset};
+        }
+        *out = OID(hex.toString());
+        return Status::OK();
+    }
+
+    /**
+     * Parses the type wrapper introduced by 'key', if it is one. Sets '*isTypeWrapper' to false
+     * and consumes nothing if the object is an ordinary one that happens to start with a '$'
+     * field, such as a query operator.
+     */
+    Status _typeWrapper(StringData fieldName,
+                        StringData key,
+                        BufBuilder* buf,
+                        uint32_t depth,
+                        bool* isTypeWrapper) {
+        *isTypeWrapper = true;
+        std::string scratch;
+        StringData text;
+
+        if (key == "$oid") {
+            OID oid;
+            auto status = _readOid(key, &oid);
+            if (!status.isOK()) {
+                return status;
+            }
+            _appendHeader(jstOID, fieldName, buf);
+            buf->appendBuf(oid.view().view(), OID::kOIDSize);
+            return Status::OK();
+        }
+
+        if (key == "$symbol") {
+            auto status = _wrappedString(key, &text, &scratch);
+            if (status.isOK()) {
+                _appendString(Symbol, fieldName, text, buf);
+            }
+            return status;
+        }
+
+        if (key == "$numberInt" || key == "$numberLong") {
+            auto status = _wrappedString(key, &text, &scratch);
+            if (!status.isOK()) {
+                return status;
+            }
+            long long value;
+            if (!parseNumberFromStringWithBase(text, 10, &value).isOK() ||
+                (key == "$numberInt" && (value < std::numeric_limits<int>::min() ||
+                                         value > std::numeric_limits<int>::max()))) {
+                return _error(str::stream() << "Invalid " << key << " '" << text << "'");
+            }
+            if (key == "$numberInt") {
+                _appendHeader(NumberInt, fieldName, buf);
+                buf->appendNum(static_cast<int>(value));
+            } else {
+                _appendHeader(NumberLong, fieldName, buf);
+                buf->appendNum(value);
+            }
+            return Status::OK();
+        }
+
+        if (key == "$numberDouble") {
+            auto status = _wrappedString(key, &text, &scratch);
+            if (!status.isOK()) {
+                return status;
+            }
+            double value;
+            if (text == "Infinity") {
+                value = std::numeric_limits<double>::infinity();
+            } else if (text == "-Infinity") {
+                value = -std::numeric_limits<double>::infinity();
+            } else if (text == "NaN") {
+                value = std::numeric_limits<double>::quiet_NaN();
+            } else if (!parseNumberFromString(text, &value).isOK() || !std::isfinite(value)) {
+                return _error(str::stream() << "Invalid $numberDouble '" << text << "'");
+            }
+            _appendHeader(NumberDouble, fieldName, buf);
+            buf->appendNum(value);
+            return Status::OK();
+        }
+
+        if (key == "$numberDecimal") {
+            auto status = _wrappedString(key, &text, &scratch);
+            if (!status.isOK()) {
+                return status;
+            }
+            std::uint32_t signalingFlags = Decimal128::SignalingFlag::kNoFlag;
+            const Decimal128 value =
+                text.empty() ? Decimal128() : Decimal128(text.toString(), &signalingFlags);
+            if (text.empty() ||
+                Decimal128::hasFlag(signalingFlags, Decimal128::SignalingFlag::kInvalid)) {
+                return _error(str::stream() << "Invalid $numberDecimal '" << text << "'");
+            }
+            _appendHeader(NumberDecimal, fieldName, buf);
+            buf->appendNum(value);
+            return Status::OK();
+        }
+
+        if (key == "$binary") {
+            return _binary(fieldName, buf);
+        }
+
+        if (key == "$date") {
+            return _date(fieldName, buf);
+        }
+
+        if (key == "$timestamp") {
+            boost::optional<uint32_t> t, i;
+            auto status = _wrapperFields(key, [&](StringData field) {
+                auto* target = field == "t" ? &t : field == "i" ? &i : nullptr;
+                if (!target || *target) {
+                    return _wrapperFieldError("$timestamp", field);
+                }
+                uint32_t value;
+                auto readStatus = _readUInt32(&value);
+                *target = value;
+                return readStatus;
+            });
+            if (!status.isOK()) {
+                return status;
+            }
+            if (!t || !i) {
+                return _missingFieldError(key, t ? "i" : "t");
+            }
+            _appendHeader(bsonTimestamp, fieldName, buf);
+            buf->appendNum(static_cast<unsigned long long>(Timestamp(*t, *i).asULL()));
+            return Status::OK();
+        }
+
+        if (key == "$regularExpression") {
+            std::string patternScratch, optionsScratch;
+            boost::optional<StringData> pattern, options;
+            auto status = _wrapperFields(key, [&](StringData field) {
+                if (field == "pattern" && !pattern) {
+                    pattern.emplace();
+                    return _readCString(&*pattern, &patternScratch);
+                }
+                if (field == "options" && !options) {
+                    options.emplace();
+                    return _readCString(&*options, &optionsScratch);
+                }
+                return _wrapperFieldError("$regularExpression", field);
+            });
+            if (!status.isOK()) {
+                return status;
+            }
+            if (!pattern || !options) {
+                return _missingFieldError(key, pattern ? "options" : "pattern");
+            }
+            return _appendRegex(fieldName, *pattern, *options, buf);
+        }
+
+        if (key == "$regex") {
+            // {"$regex": "a", "$options": "i"} is the v1 form of a regular expression, but a
+            // $regex query operator looks the same apart from its options being optional or the
+            // pattern itself being a regular expression. Only take the exact v1 shape.
+            if (_peekAhead(1) != '"' || _peekAhead(3) != ',' || _peekAhead(4) != '"' ||
+                _json.substr(_structurals[_next + 4] + 1,
+                             _structurals[_next + 5] - _structurals[_next + 4] - 1) !=
+                    "$options") {
+                *isTypeWrapper = false;
+                return Status::OK();
+            }
+            std::string patternScratch, optionsScratch;
+            StringData pattern, options;
+            _advance();  // ':'
+            auto status = _readCString(&pattern, &patternScratch);
+            if (!status.isOK()) {
+                return status;
+            }
+            _advance();  // ','
+            _advance();  // '"'
+            _advance();  // '"'
+            status = _expect(':', "Expecting ':'");
+            if (!status.isOK()) {
+                return status;
+            }
+            status = _readCString(&options, &optionsScratch);
+            if (!status.isOK()) {
+                return status;
+            }
+            status = _endWrapper(key);
+            if (!status.isOK()) {
+                return status;
+            }
+            return _appendRegex(fieldName, pattern, options, buf);
+        }
+
+        if (key == "$dbPointer") {
+            std::string nsScratch;
+            boost::optional<StringData> ns;
+            boost::optional<OID> id;
+            auto status = _wrapperFields(key, [&](StringData field) {
+                if (field == "$ref" && !ns) {
+                    ns.emplace();
+                    return _readString(&*ns, &nsScratch);
+                }
+                if (field == "$id" && !id) {
+                    // The $id must itself be an {"$oid": ...} wrapper.
+                    std::string oidScratch;
+                    StringData oidKey;
+                    auto idStatus = _expect('{', "$dbPointer's $id must be an $oid");
+                    if (idStatus.isOK()) {
+                        idStatus = _readFieldName(&oidKey, &oidScratch);
+                    }
+                    if (idStatus.isOK() && oidKey != "$oid") {
+                        idStatus = _error("$dbPointer's $id must be an $oid");
+                    }
+                    if (idStatus.isOK()) {
+                        id.emplace();
+                        idStatus = _readOid("$oid", &*id);
+                    }
+                    return idStatus;
+                }
+                return _wrapperFieldError("$dbPointer", field);
+            });
+            if (!status.isOK()) {
+                return status;
+            }
+            if (!ns || !id) {
+                return _missingFieldError(key, ns ? "$id" : "$ref");
+            }
+            _appendString(DBRef, fieldName, *ns, buf);
+            buf->appendBuf(id->view().view(), OID::kOIDSize);
+            return Status::OK();
+        }
+
+        if (key == "$code") {
+            auto status = _expect(':', "Expecting ':'");
+            if (!status.isOK()) {
+                return status;
+            }
+            if (_peek() != '"') {
+                return _error("$code requires a string value");
+            }
+            StringData code;
+            status = _readString(&code, &scratch);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            if (_peek() == '}') {
+                _advance();
+                _appendString(Code, fieldName, code, buf);
+                return Status::OK();
+            }
+
+            std::string scopeFieldScratch;
+            StringData scopeField;
+            status = _expect(',', "Expecting ',' or '}'");
+            if (status.isOK()) {
+                status = _readFieldName(&scopeField, &scopeFieldScratch);
+            }
+            if (status.isOK() && scopeField != "$scope") {
+                status = _wrapperFieldError("$code", scopeField);
+            }
+            if (status.isOK()) {
+                status = _expect(':', "Expecting ':'");
+            }
+            if (!status.isOK()) {
+                return status;
+            }
+            if (_peek() != '{') {
+                return _error("$scope requires an object value");
+            }
+
+            // CodeWScope is the total length, the code as a string, and then the scope.
+            _appendHeader(CodeWScope, fieldName, buf);
+            const int start = buf->len();
+            buf->skip(sizeof(int));
+            buf->appendNum(static_cast<int>(code.size() + 1));
+            buf->appendStr(code);
+
+            // Reuse _object() for the scope, then drop the element header it writes.
+            const int scopeStart = buf->len();
+            status = _object(""_sd, buf, depth + 1);
+            if (!status.isOK()) {
+                return status;
+            }
+            if (buf->buf()[scopeStart] != Object) {
+                return _error("$scope must be an ordinary object");
+            }
+            const int scopeLen = buf->len() - scopeStart - 2;
+            std::memmove(buf->buf() + scopeStart, buf->buf() + scopeStart + 2, scopeLen);
+            buf->setlen(scopeStart + scopeLen);
+            DataView(buf->buf() + start).write<LittleEndian<int>>(buf->len() - start);
+            return _endWrapper(key);
+        }
+
+        if (key == "$minKey" || key == "$maxKey" || key == "$undefined") {
+            auto status = _expect(':', "Expecting ':'");
+            if (!status.isOK()) {
+                return status;
+            }
+            const auto offset = _offset();
+            const auto expected = key == "$undefined" ? "true"_sd : "1"_sd;
+            if (_peek() == '"' || _peek() == '{' || _peek() == '[' || _scalar() != expected) {
+                return {ErrorCodes::FailedToParse,
+                        str::stream() << key << " requires a value of " << expected
+                                      << ": offset:"
+                                      << offset};
+            }
+            status = _endWrapper(key);
+            if (status.isOK()) {
+                const auto type = key == "$minKey" ? MinKey : key == "$maxKey" ? MaxKey : Undefined;
+                _appendHeader(type, fieldName, buf);
+            }
+            return status;
+        }
+
+        *isTypeWrapper = false;
+        return Status::OK();
+    }
+
+    Status _appendRegex(StringData fieldName,
+                        StringData pattern,
+                        StringData options,
+                        BufBuilder* buf) {
+        for (char c : options) {
+            if (!std::strchr("ilmsux", c)) {
+                return _error(str::stream() << "Invalid regular expression option '" << c << "'");
+            }
+        }
+        _appendHeader(RegEx, fieldName, buf);
+        buf->appendStr(pattern);
+        buf->appendStr(options);
+        return Status::OK();
+    }
+
+    Status _binary(StringData fieldName, BufBuilder* buf) {
+        std::string dataScratch, typeScratch;
+        boost::optional<StringData> data, subType;
+
+        if (_peekAhead(1) == '"') {
+            // The v1 form: {"$binary": "<base64>", "$type": "<hex>"}.
+            _advance();  // ':'
+            data.emplace();
+            auto status = _readString(&*data, &dataScratch);
+            if (status.isOK()) {
+                status = _expect(',', "$binary requires a $type");
+            }
+            StringData typeField;
+            std::string typeFieldScratch;
+            if (status.isOK()) {
+                status = _readFieldName(&typeField, &typeFieldScratch);
+            }
+            if (status.isOK() && typeField != "$type") {
+                status = _wrapperFieldError("$binary", typeField);
+            }
+            if (status.isOK()) {
+                subType.emplace();
+                status = _wrappedString("$binary", &*subType, &typeScratch);
+            }
+            if (!status.isOK()) {
+                return status;
+            }
+        } else {
+            auto status = _wrapperFields("$binary", [&](StringData field) {
+                if (field == "base64" && !data) {
+                    data.emplace();
+                    return _readString(&*data, &dataScratch);
+                }
+                if (field == "subType" && !subType) {
+                    subType.emplace();
+                    return _readString(&*subType, &typeScratch);
+                }
+                return _wrapperFieldError("$binary", field);
+            });
+            if (!status.isOK()) {
+                return status;
+            }
+            if (!data || !subType) {
+                return _missingFieldError("$binary", data ? "subType" : "base64");
+            }
+        }
+
+        int type;
+        if (subType->empty() || subType->size() > 2 ||
+            !parseNumberFromStringWithBase(*subType, 16, &type).isOK() || type < 0) {
+            return _error(str::stream() << "Invalid $binary subType '" << *subType << "'");
+        }
+        if (!base64::validate(*data)) {
+            return _error("Invalid base64 data in $binary");
+        }
+
+        const auto bytes = base64::decode(data->toString());
+        _appendHeader(BinData, fieldName, buf);
+        buf->appendNum(static_cast<int>(bytes.size()));
+        buf->appendChar(static_cast<char>(type));
+        buf->appendBuf(bytes.data(), bytes.size());
+        return Status::OK();
+    }
+
+    Status _date(StringData fieldName, BufBuilder* buf) {
+        auto status = _expect(':', "Expecting ':'");
+        if (!status.isOK()) {
+            return status;
+        }
+
+        long long millis;
+        const auto offset = _offset();
+        if (_peek() == '"') {
+            // Relaxed form: an ISO-8601 string.
+            std::string scratch;
+            StringData iso;
+            status = _readString(&iso, &scratch);
+            if (!status.isOK()) {
+                return status;
+            }
+            auto date = dateFromISOString(iso);
+            if (!date.isOK()) {
+                return {ErrorCodes::FailedToParse,
+                        str::stream() << "Invalid $date '" << iso << "': offset:" << offset};
+            }
+            millis = date.getValue().toMillisSinceEpoch();
+        } else if (_peek() == '{') {
+            // Canonical form: {"$numberLong": "<millis>"}.
+            _advance();
+            std::string scratch, numberScratch;
+            StringData field, number;
+            status = _readFieldName(&field, &scratch);
+            if (status.isOK() && field != "$numberLong") {
+                status = _error("$date requires a $numberLong, an ISO-8601 string or a number");
+            }
+            if (status.isOK()) {
+                status = _wrappedString(field, &number, &numberScratch);
+            }
+            if (!status.isOK()) {
+                return status;
+            }
+            if (!parseNumberFromStringWithBase(number, 10, &millis).isOK()) {
+                return {ErrorCodes::FailedToParse,
+                        str::stream() << "Invalid $date '" << number << "': offset:" << offset};
+            }
+        } else {
+            // The v1 form: a number of milliseconds.
+            if (_peek() == '[' || _atEnd()) {
+                return _error("$date requires a $numberLong, an ISO-8601 string or a number");
+            }
+            const auto token = _scalar();
+            if (!parseNumberFromStringWithBase(token, 10, &millis).isOK()) {
+                return {ErrorCodes::FailedToParse,
+                        str::stream() << "Invalid $date '" << token << "': offset:" << offset};
+            }
+        }
+
+        status = _endWrapper("$date");
+        if (!status.isOK()) {
+            return status;
+        }
+        _appendHeader(Date, fieldName, buf);
+        buf->appendNum(millis);
+        return Status::OK();
+    }
+
+    const StringData _json;
+    const std::vector<uint32_t>& _structurals;
+    size_t& _next;
+};
+
+}  // namespace
+
+JsonStreamParser::JsonStreamParser(StringData json) : _json(json) {
+    _status = indexStructurals(_json, &_structurals);
+}
+
+bool JsonStreamParser::more() const {
+    return !_status.isOK() || _nextStructural < _structurals.size();
+}
+
+StatusWith<BSONObj> JsonStreamParser::next() {
+    if (!_status.isOK()) {
+        return _status;
+    }
+
+    BufBuilder buf;
+    _status = DocumentParser(_json, _structurals, &_nextStructural).parseDocument(&buf);
+    if (!_status.isOK()) {
+        return _status;
+    }
+    return BSONObj(buf.release());
+}
+
+StatusWith<BSONObj> fromExtendedJson(StringData json) {
+    JsonStreamParser parser(json);
+    auto swObj = parser.next();
+    if (swObj.isOK() && parser.more()) {
+        return Status(ErrorCodes::FailedToParse, "Unexpected data after the end of the document");
+    }
+    return swObj;
+}
+
+}  // namespace mongo
@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * Parses a stream of JSON documents into BSON, such as the newline-delimited or concatenated
+ * documents fed to an import tool.
+ *
+ * Only strict JSON <http://www.ietf.org/rfc/rfc8259.txt> is accepted, with the type wrappers of
+ * Extended JSON v2 in both its canonical and relaxed forms (e.g. {"$oid": "..."},
+ * {"$date": {"$numberLong": "..."}}, {"$binary": {"base64": "...", "subType": "00"}}), plus the
+ * v1 "strict mode" wrappers that tojson() produces. Unlike fromjson(), none of the shell's
+ * extensions such as unquoted field names, single quotes or ObjectId(...) are accepted. Plain
+ * integers become NumberInt or NumberLong when they fit and NumberDouble otherwise.
+ *
+ * The input is parsed in two stages. The constructor indexes every structural character of the
+ * whole input (brackets, colons, commas, unescaped quotes and the starts of numbers and literals)
+ * 64 bytes at a time, using SSE2 on x86-64, so that quotes and escapes are only ever examined as
+ * bitmasks. next() then walks that index and writes BSON directly into a buffer, copying string
+ * contents in one go rather than character by character.
+ *
+ * The input must outlive the parser and be smaller than 4GB.
+ */
+class JsonStreamParser {
+    MONGO_DISALLOW_COPYING(JsonStreamParser);
+
+public:
+    explicit JsonStreamParser(StringData json);
+
+    /**
+     * Returns true if there is another document to parse, or an error to report.
+     */
+    bool more() const;
+
+    /**
+     * Parses the next document in the stream. Once this has returned an error, the rest of the
+     * stream cannot be parsed and every later call returns the same error.
+     */
+    StatusWith<BSONObj> next();
+
+private:
+    StringData _json;
+
+    // Offsets of the structural characters in '_json', in order.
+    std::vector<uint32_t> _structurals;
+    size_t _nextStructural = 0;
+
+    Status _status = Status::OK();
+};
+
+/**
+ * Parses 'json', which must hold exactly one document, with a JsonStreamParser.
+ */
+StatusWith<BSONObj> fromExtendedJson(StringData json);
+
+}  // namespace mongo
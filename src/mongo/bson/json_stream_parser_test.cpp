@@ -0,0 +1,257 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json_stream_parser.h"
+
+#include "mongo/bson/bson_depth.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj parse(StringData json) {
+    auto swObj = fromExtendedJson(json);
+    ASSERT_OK(swObj.getStatus());
+    return swObj.getValue();
+}
+
+// Compares the encoding too, so that e.g. NumberInt and NumberLong aren't considered equal.
+void assertParsesTo(StringData json, const BSONObj& expected) {
+    const auto obj = parse(json);
+    ASSERT_TRUE(obj.binaryEqual(expected)) << json << " parsed to " << obj << ", not "
+                                           << expected;
+}
+
+void assertFailsToParse(StringData json) {
+    ASSERT_EQ(fromExtendedJson(json).getStatus(), ErrorCodes::FailedToParse) << json;
+}
+
+TEST(JsonStreamParser, ParsesPlainJson) {
+    assertParsesTo("{}", BSONObj());
+    assertParsesTo(" {\n\t\"a\" : 1 , \"b\":\"x\" } ", BSON("a" << 1 << "b"
+                                                               << "x"));
+    assertParsesTo(R"({"a": [true, false, null, [], {}], "b": {"c": {"d": -2.5e-3}}})",
+                   BSON("a" << BSON_ARRAY(true << false << BSONNULL << BSONArray() << BSONObj())
+                            << "b"
+                            << BSON("c" << BSON("d" << -2.5e-3))));
+}
+
+TEST(JsonStreamParser, IntegersUseTheNarrowestTypeThatFits) {
+    assertParsesTo(R"({"a": 2147483647, "b": -2147483648, "c": 2147483648})",
+                   BSON("a" << 2147483647 << "b" << std::numeric_limits<int>::min() << "c"
+                            << 2147483648LL));
+    assertParsesTo(R"({"a": 9223372036854775807, "b": 9223372036854775808})",
+                   BSON("a" << std::numeric_limits<long long>::max() << "b"
+                            << 9223372036854775808.0));
+    assertParsesTo(R"({"a": 1.0, "b": 1e2})", BSON("a" << 1.0 << "b" << 100.0));
+}
+
+TEST(JsonStreamParser, UnescapesStrings) {
+    assertParsesTo(R"({"a\tb": "\"\\\/\b\f\n\r\t", "c": "\u00e9\u20ac\ud83d\ude00"})",
+                   BSON("a\tb"
+                        << "\"\\/\b\f\n\r\t"
+                        << "c"
+                        << "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"));
+}
+
+TEST(JsonStreamParser, EscapesAcrossBlockBoundaries) {
+    // Move runs of backslashes across the 64-byte boundaries of the structural index.
+    for (size_t padding = 0; padding < 70; ++padding) {
+        for (size_t backslashes = 1; backslashes <= 4; ++backslashes) {
+            const std::string prefix(padding, 'x');
+            std::string json = R"({"a": ")" + prefix + std::string(2 * backslashes, '\\') +
+                R"(\"", "b": 1})";
+            assertParsesTo(json,
+                           BSON("a" << prefix + std::string(backslashes, '\\') + "\""
+                                    << "b"
+                                    << 1));
+        }
+    }
+}
+
+TEST(JsonStreamParser, StructuralCharactersInStringsAreIgnored) {
+    assertParsesTo(R"({"{[:,]}": "}, \"x\": [1, 2]"})", BSON("{[:,]}"
+                                                             << "}, \"x\": [1, 2]"));
+}
+
+TEST(JsonStreamParser, CanonicalTypeWrappers) {
+    BSONObjBuilder expected;
+    expected.append("oid", OID("0102030405060708090a0b0c"));
+    expected.append("int", 1);
+    expected.append("long", 1LL);
+    expected.append("double", 1.5);
+    expected.append("inf", -std::numeric_limits<double>::infinity());
+    expected.append("decimal", Decimal128("1.5"));
+    expected.appendDate("date", Date_t::fromMillisSinceEpoch(-1));
+    expected.append("ts", Timestamp(1, 2));
+    const char bin[] = {1, 2, 3};
+    expected.appendBinData("bin", sizeof(bin), BinDataType(0x80), bin);
+    expected.appendRegex("regex", "a.*b", "im");
+    expected.appendCode("code", "f()");
+    expected.appendCodeWScope("codeWScope", "g()", BSON("x" << 1));
+    expected.appendSymbol("symbol", "s");
+    expected.appendDBRef("dbPointer", "db.coll", OID("0102030405060708090a0b0c"));
+    expected.appendMinKey("minKey");
+    expected.appendMaxKey("maxKey");
+    expected.appendUndefined("undefined");
+
+    assertParsesTo(R"json({"oid": {"$oid": "0102030405060708090a0b0c"},
+                       "int": {"$numberInt": "1"},
+                       "long": {"$numberLong": "1"},
+                       "double": {"$numberDouble": "1.5"},
+                       "inf": {"$numberDouble": "-Infinity"},
+                       "decimal": {"$numberDecimal": "1.5"},
+                       "date": {"$date": {"$numberLong": "-1"}},
+                       "ts": {"$timestamp": {"t": 1, "i": 2}},
+                       "bin": {"$binary": {"base64": "AQID", "subType": "80"}},
+                       "regex": {"$regularExpression": {"pattern": "a.*b", "options": "im"}},
+                       "code": {"$code": "f()"},
+                       "codeWScope": {"$code": "g()", "$scope": {"x": 1}},
+                       "symbol": {"$symbol": "s"},
+                       "dbPointer": {"$dbPointer": {"$ref": "db.coll",
+                                                    "$id": {"$oid": "0102030405060708090a0b0c"}}},
+                       "minKey": {"$minKey": 1},
+                       "maxKey": {"$maxKey": 1},
+                       "undefined": {"$undefined": true}})json",
+                   expected.obj());
+}
+
+TEST(JsonStreamParser, NestedWrapperFieldsMayComeInAnyOrder) {
+    assertParsesTo(R"({"ts": {"$timestamp": {"i": 2, "t": 1}},
+                       "regex": {"$regularExpression": {"options": "", "pattern": "a"}}})",
+                   BSON("ts" << Timestamp(1, 2) << "regex" << BSONRegEx("a", "")));
+}
+
+TEST(JsonStreamParser, RelaxedDate) {
+    assertParsesTo(R"({"date": {"$date": "1970-01-01T00:00:01.500Z"}})",
+                   BSON("date" << Date_t::fromMillisSinceEpoch(1500)));
+}
+
+TEST(JsonStreamParser, ParsesStrictModeOutputOfTojson) {
+    BSONObjBuilder builder;
+    builder.append("oid", OID("0102030405060708090a0b0c"));
+    builder.append("long", 1LL << 40);
+    builder.appendDate("date", Date_t::fromMillisSinceEpoch(1500));
+    builder.append("ts", Timestamp(1, 2));
+    const char bin[] = {1, 2, 3};
+    builder.appendBinData("bin", sizeof(bin), BinDataGeneral, bin);
+    builder.appendRegex("regex", "a.*b", "i");
+    builder.append("decimal", Decimal128("1.5"));
+    builder.appendMinKey("minKey");
+    builder.appendMaxKey("maxKey");
+    builder.appendUndefined("undefined");
+    const auto obj = builder.obj();
+
+    assertParsesTo(tojson(obj, Strict), obj);
+}
+
+TEST(JsonStreamParser, QueryOperatorsAreOrdinaryObjects) {
+    assertParsesTo(R"({"a": {"$gt": 1}, "b": {"$regex": "^x"}})",
+                   BSON("a" << BSON("$gt" << 1) << "b" << BSON("$regex"
+                                                                << "^x")));
+    assertParsesTo(R"({"b": {"$regex": {"$regularExpression": {"pattern": "x", "options": ""}}}})",
+                   BSON("b" << BSON("$regex" << BSONRegEx("x", ""))));
+}
+
+TEST(JsonStreamParser, StreamsConcatenatedDocuments) {
+    JsonStreamParser parser("{\"a\": 1}\n{\"a\": 2}{\"a\": 3}  \n");
+    for (int i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(parser.more());
+        auto swObj = parser.next();
+        ASSERT_OK(swObj.getStatus());
+        ASSERT_BSONOBJ_EQ(swObj.getValue(), BSON("a" << i));
+    }
+    ASSERT_FALSE(parser.more());
+}
+
+TEST(JsonStreamParser, ErrorsStopTheStream) {
+    JsonStreamParser parser("{\"a\": 1} {\"a\": } {\"a\": 3}");
+    ASSERT_OK(parser.next().getStatus());
+    ASSERT_EQ(parser.next().getStatus(), ErrorCodes::FailedToParse);
+    ASSERT_TRUE(parser.more());
+    ASSERT_EQ(parser.next().getStatus(), ErrorCodes::FailedToParse);
+}
+
+TEST(JsonStreamParser, RejectsInvalidJson) {
+    for (auto json : {"",
+                      "[1]",
+                      "{",
+                      "{\"a\"}",
+                      "{\"a\": 1,}",
+                      "{\"a\": [1,]}",
+                      "{\"a\" 1}",
+                      "{a: 1}",
+                      "{'a': 1}",
+                      "{\"a\": 01}",
+                      "{\"a\": 1.}",
+                      "{\"a\": -}",
+                      "{\"a\": tru}",
+                      "{\"a\": \"unterminated}",
+                      "{\"a\": \"\\x\"}",
+                      "{\"a\": \"\\ud800\"}",
+                      "{\"a\\u0000b\": 1}",
+                      "{\"a\": 1} trailing"}) {
+        assertFailsToParse(json);
+    }
+}
+
+TEST(JsonStreamParser, RejectsInvalidTypeWrappers) {
+    for (auto json : {R"({"a": {"$oid": "0102"}})",
+                      R"({"a": {"$oid": "0102030405060708090a0b0c", "b": 1}})",
+                      R"({"a": {"$numberInt": "2147483648"}})",
+                      R"({"a": {"$numberLong": 1}})",
+                      R"({"a": {"$numberDecimal": "abc"}})",
+                      R"({"a": {"$date": "yesterday"}})",
+                      R"({"a": {"$timestamp": {"t": 1}}})",
+                      R"({"a": {"$timestamp": {"t": -1, "i": 1}}})",
+                      R"({"a": {"$binary": {"base64": "!!", "subType": "00"}}})",
+                      R"({"a": {"$binary": {"base64": "AQID", "subType": "100"}}})",
+                      R"({"a": {"$regularExpression": {"pattern": "a", "options": "q"}}})",
+                      R"({"a": {"$minKey": 0}})"}) {
+        assertFailsToParse(json);
+    }
+}
+
+TEST(JsonStreamParser, RejectsExcessiveNesting) {
+    const auto depth = BSONDepth::getMaxAllowableDepth() + 1;
+    std::string json;
+    for (size_t i = 0; i < depth; ++i) {
+        json += "{\"a\": ";
+    }
+    json += "1";
+    json += std::string(depth, '}');
+    assertFailsToParse(json);
+}
+
+}  // namespace
+}  // namespace mongo
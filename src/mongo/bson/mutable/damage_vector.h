@@ -30,6 +30,8 @@
 #include <cstdint>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 namespace mongo {
 namespace mutablebson {
 
@@ -37,6 +39,10 @@ namespace mutablebson {
 // 'target_offset' in some target buffer, with the replacement data being 'size' bytes of
 // data from the 'source' offset. The base addresses against which these offsets are to be
 // applied are not captured here.
+//
+// A damage event may also grow or shrink the target, by replacing 'targetSize' bytes of it with
+// the 'size' bytes of source data. The events of a vector are applied in order, and the target
+// offset of each is relative to the target as changed by the events before it.
 struct DamageEvent {
     typedef uint32_t OffsetSizeType;
 
@@ -48,6 +54,13 @@ struct DamageEvent {
 
     // Size of the damage region.
     size_t size;
+
+    // Size of the target region replaced by the damage, if it differs from 'size'.
+    boost::optional<size_t> targetSize;
+
+    size_t getTargetSize() const {
+        return targetSize.value_or(size);
+    }
 };
 
 typedef std::vector<DamageEvent> DamageVector;
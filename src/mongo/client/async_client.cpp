@@ -215,24 +215,142 @@ Future<Message> AsyncDBClient::_call(Message request, const transport::BatonHand
         });
 }
 
+Future<Message> AsyncDBClient::_pipelinedCall(Message request) {
+    if (!_pipelineStatus.isOK()) {
+        return _pipelineStatus;
+    }
+
+    auto swm = _compressorManager.compressMessage(request);
+    if (!swm.isOK()) {
+        return swm.getStatus();
+    }
+
+    request = std::move(swm.getValue());
+    auto msgId = nextMessageId();
+    request.header().setId(msgId);
+    request.header().setResponseToMsgId(0);
+
+    auto pf = makePromiseFuture<Message>();
+    _pipelineReplies.emplace(msgId, std::move(pf.promise));
+    _pipelineSinkQueue.push_back(std::move(request));
+
+    if (!_pipelineSinking) {
+        _sinkNextPipelined();
+    }
+    if (!_pipelineSourcing) {
+        _sourceNextPipelined();
+    }
+
+    return std::move(pf.future);
+}
+
+void AsyncDBClient::_sinkNextPipelined() {
+    // Writes on the session must not overlap, so queued requests go out one at a time.
+    _pipelineSinking = true;
+    _session->asyncSinkMessage(_pipelineSinkQueue.front())
+        .getAsync([self = shared_from_this()](Status status) {
+            if (!self->_pipelineStatus.isOK()) {
+                return;
+            }
+            if (!status.isOK()) {
+                return self->_failPipeline(std::move(status));
+            }
+
+            self->_pipelineSinkQueue.pop_front();
+            if (self->_pipelineSinkQueue.empty()) {
+                self->_pipelineSinking = false;
+                return;
+            }
+            self->_sinkNextPipelined();
+        });
+}
+
+void AsyncDBClient::_sourceNextPipelined() {
+    _pipelineSourcing = true;
+    _session->asyncSourceMessage().getAsync([self = shared_from_this()](
+        StatusWith<Message> swResponse) {
+        if (!self->_pipelineStatus.isOK()) {
+            return;
+        }
+        if (!swResponse.isOK()) {
+            return self->_failPipeline(swResponse.getStatus());
+        }
+
+        auto response = std::move(swResponse.getValue());
+        auto it = self->_pipelineReplies.find(response.header().getResponseToMsgId());
+        if (it == self->_pipelineReplies.end()) {
+            return self->_failPipeline({ErrorCodes::ProtocolError,
+                                        "ResponseId did not match any pipelined message ID."});
+        }
+
+        auto promise = std::move(it->second);
+        self->_pipelineReplies.erase(it);
+        if (response.operation() == dbCompressed) {
+            promise.setFromStatusWith(self->_compressorManager.decompressMessage(response));
+        } else {
+            promise.emplaceValue(std::move(response));
+        }
+
+        // Fulfilling the promise may have pipelined more requests, so only stop reading once
+        // nothing is outstanding.
+        if (self->_pipelineReplies.empty()) {
+            self->_pipelineSourcing = false;
+            return;
+        }
+        self->_sourceNextPipelined();
+    });
+}
+
+void AsyncDBClient::_failPipeline(Status status) {
+    // Once a read or write has failed the stream is out of sync, so fail everything outstanding
+    // and refuse further pipelined calls.
+    _pipelineStatus = status;
+    _pipelineSinking = false;
+    _pipelineSourcing = false;
+    _pipelineSinkQueue.clear();
+
+    auto replies = std::move(_pipelineReplies);
+    _pipelineReplies.clear();
+    for (auto& reply : replies) {
+        reply.second.setError(status);
+    }
+}
+
 Future<rpc::UniqueReply> AsyncDBClient::runCommand(OpMsgRequest request,
                                                    const transport::BatonHandle& baton) {
+    return _runCommand(std::move(request), baton, false);
+}
+
+Future<rpc::UniqueReply> AsyncDBClient::_runCommand(OpMsgRequest request,
+                                                    const transport::BatonHandle& baton,
+                                                    bool pipelined) {
     invariant(_negotiatedProtocol);
     auto requestMsg = rpc::messageFromOpMsgRequest(*_negotiatedProtocol, std::move(request));
-    return _call(std::move(requestMsg), baton)
-        .then([this](Message response) -> Future<rpc::UniqueReply> {
-            return rpc::UniqueReply(response, rpc::makeReply(&response));
-        });
+    auto responseFuture =
+        pipelined ? _pipelinedCall(std::move(requestMsg)) : _call(std::move(requestMsg), baton);
+    return std::move(responseFuture).then([](Message response) -> Future<rpc::UniqueReply> {
+        return rpc::UniqueReply(response, rpc::makeReply(&response));
+    });
 }
 
 Future<executor::RemoteCommandResponse> AsyncDBClient::runCommandRequest(
     executor::RemoteCommandRequest request, const transport::BatonHandle& baton) {
+    return _runCommandRequest(std::move(request), baton, false);
+}
+
+Future<executor::RemoteCommandResponse> AsyncDBClient::runPipelinedCommandRequest(
+    executor::RemoteCommandRequest request) {
+    return _runCommandRequest(std::move(request), nullptr, true);
+}
+
+Future<executor::RemoteCommandResponse> AsyncDBClient::_runCommandRequest(
+    executor::RemoteCommandRequest request, const transport::BatonHandle& baton, bool pipelined) {
     auto clkSource = _svcCtx->getPreciseClockSource();
     auto start = clkSource->now();
     auto opMsgRequest = OpMsgRequest::fromDBAndBody(
         std::move(request.dbname), std::move(request.cmdObj), std::move(request.metadata));
-    return runCommand(std::move(opMsgRequest), baton)
-        .then([start, clkSource, this](rpc::UniqueReply response) {
+    return _runCommand(std::move(opMsgRequest), baton, pipelined)
+        .then([start, clkSource](rpc::UniqueReply response) {
             auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
             return executor::RemoteCommandResponse(*response, duration);
         })
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/service_context.h"
@@ -36,6 +37,7 @@
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/unique_message.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/transport_layer.h"
@@ -63,6 +65,16 @@ public:
     Future<rpc::UniqueReply> runCommand(OpMsgRequest request,
                                         const transport::BatonHandle& baton = nullptr);
 
+    /**
+     * Like runCommandRequest(), but does not wait for earlier pipelined requests to complete
+     * before sending. Replies are matched to their requests by responseTo, so any number of
+     * pipelined requests may be outstanding on the connection at once. Must only be called from
+     * the reactor thread of the connection and never mixed with the non-pipelined calls while
+     * pipelined requests are outstanding.
+     */
+    Future<executor::RemoteCommandResponse> runPipelinedCommandRequest(
+        executor::RemoteCommandRequest request);
+
     Future<void> authenticate(const BSONObj& params);
 
     Future<void> initWireVersion(const std::string& appName,
@@ -78,7 +90,18 @@ public:
     const HostAndPort& local() const;
 
 private:
+    Future<rpc::UniqueReply> _runCommand(OpMsgRequest request,
+                                         const transport::BatonHandle& baton,
+                                         bool pipelined);
+    Future<executor::RemoteCommandResponse> _runCommandRequest(
+        executor::RemoteCommandRequest request,
+        const transport::BatonHandle& baton,
+        bool pipelined);
     Future<Message> _call(Message request, const transport::BatonHandle& baton = nullptr);
+    Future<Message> _pipelinedCall(Message request);
+    void _sinkNextPipelined();
+    void _sourceNextPipelined();
+    void _failPipeline(Status status);
     BSONObj _buildIsMasterRequest(const std::string& appName);
     void _parseIsMasterResponse(BSONObj request,
                                 const std::unique_ptr<rpc::ReplyInterface>& response);
@@ -88,6 +111,13 @@ private:
     ServiceContext* const _svcCtx;
     MessageCompressorManager _compressorManager;
     boost::optional<rpc::Protocol> _negotiatedProtocol;
+
+    // State of pipelined calls. Only touched from the reactor thread, so it needs no locking.
+    Status _pipelineStatus = Status::OK();
+    std::deque<Message> _pipelineSinkQueue;
+    stdx::unordered_map<int32_t, Promise<Message>> _pipelineReplies;
+    bool _pipelineSinking = false;
+    bool _pipelineSourcing = false;
 };
 
 }  // namespace mongo
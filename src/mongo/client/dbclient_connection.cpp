@@ -591,6 +591,9 @@ bool DBClientConnection::call(Message& toSend,
                               Message& response,
                               bool assertOk,
                               string* actualServer) {
+    uassert(51019,
+            "Cannot run a command while pipelined requests are awaiting their replies",
+            _pipelinedRequestsInFlight.empty());
     checkConnection();
     auto killSessionOnError = MakeGuard([this] { _markFailed(kEndSession); });
     auto maybeThrow = [&](const auto& errStatus) {
@@ -628,6 +631,90 @@ bool DBClientConnection::call(Message& toSend,
     return true;
 }
 
+int DBClientConnection::sendPipelinedRequest(OpMsgRequest request) {
+    checkConnection();
+    uassert(51020,
+            str::stream() << "Pipelined requests need OP_MSG, which " << getServerAddress()
+                          << " does not support",
+            uassertStatusOK(rpc::negotiate(getClientRPCProtocols(), getServerRPCProtocols())) ==
+                rpc::Protocol::kOpMsg);
+
+    while (_pipelinedRequestsInFlight.size() >= _maxPipelinedRequests) {
+        _receivePipelinedReply();
+    }
+
+    if (const auto& metadataWriter = getRequestMetadataWriter()) {
+        BSONObjBuilder metadataBob(std::move(request.body));
+        uassertStatusOK(
+            metadataWriter((haveClient() ? cc().getOperationContext() : nullptr), &metadataBob));
+        request.body = metadataBob.obj();
+    }
+
+    auto requestMsg = request.serialize();
+    try {
+        say(requestMsg);
+    } catch (const DBException&) {
+        _pipelinedRequestsInFlight.clear();
+        _pipelinedReplies.clear();
+        throw;
+    }
+
+    const auto requestId = requestMsg.header().getId();
+    _pipelinedRequestsInFlight.insert(requestId);
+    return requestId;
+}
+
+rpc::UniqueReply DBClientConnection::awaitPipelinedReply(int requestId) {
+    uassert(51021,
+            str::stream() << "No pipelined request with id " << requestId << " is pending",
+            _pipelinedReplies.count(requestId) || _pipelinedRequestsInFlight.count(requestId));
+
+    auto it = _pipelinedReplies.find(requestId);
+    while (it == _pipelinedReplies.end()) {
+        _receivePipelinedReply();
+        it = _pipelinedReplies.find(requestId);
+    }
+
+    auto replyMsg = std::move(it->second);
+    _pipelinedReplies.erase(it);
+
+    auto commandReply = parseCommandReplyMessage(getServerAddress(), replyMsg);
+    if (!_parentReplSetName.empty()) {
+        const auto replyBody = commandReply->getCommandReply();
+        if (!isOk(replyBody)) {
+            handleNotMasterResponse(replyBody, "errmsg");
+        }
+    }
+    return commandReply;
+}
+
+void DBClientConnection::_receivePipelinedReply() {
+    invariant(!_pipelinedRequestsInFlight.empty());
+    auto killSessionOnError = MakeGuard([this] {
+        _markFailed(kEndSession);
+        _pipelinedRequestsInFlight.clear();
+        _pipelinedReplies.clear();
+    });
+
+    auto swm = _session->sourceMessage();
+    uassertStatusOKWithContext(swm.getStatus(),
+                               str::stream() << "network error while waiting for pipelined "
+                                             << "replies from "
+                                             << getServerAddress());
+    auto replyMsg = std::move(swm.getValue());
+    if (replyMsg.operation() == dbCompressed) {
+        replyMsg = uassertStatusOK(_compressorManager.decompressMessage(replyMsg));
+    }
+
+    const auto requestId = replyMsg.header().getResponseToMsgId();
+    uassert(51022,
+            str::stream() << "Received a reply to unknown request " << requestId << " from "
+                          << getServerAddress(),
+            _pipelinedRequestsInFlight.erase(requestId));
+    _pipelinedReplies.emplace(requestId, std::move(replyMsg));
+    killSessionOnError.Dismiss();
+}
+
 void DBClientConnection::checkResponse(const std::vector<BSONObj>& batch,
                                        bool networkError,
                                        bool* retry,
@@ -49,6 +49,8 @@
 #include "mongo/rpc/unique_message.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer.h"
@@ -239,6 +241,40 @@ public:
     ConnectionString::ConnectionType type() const override {
         return ConnectionString::MASTER;
     }
+
+    /**
+     * Sends "request" as an OP_MSG without waiting for its reply, and returns the id with which
+     * awaitPipelinedReply() retrieves the reply. Any number of requests may be sent back to back
+     * this way; their replies are matched to them by the responseTo field of each reply. At most
+     * getMaxPipelinedRequests() replies are left unread on the socket: sending another request
+     * first reads and buffers the oldest pending reply.
+     *
+     * call() and the commands built on it may not be used while pipelined replies are pending.
+     */
+    int sendPipelinedRequest(OpMsgRequest request);
+
+    /**
+     * Returns the reply to the pipelined request with id "requestId", buffering the replies of
+     * other pipelined requests which arrive before it.
+     */
+    rpc::UniqueReply awaitPipelinedReply(int requestId);
+
+    /**
+     * Returns the number of pipelined requests whose replies have not been returned yet.
+     */
+    size_t numPendingPipelinedRequests() const {
+        return _pipelinedRequestsInFlight.size() + _pipelinedReplies.size();
+    }
+
+    void setMaxPipelinedRequests(size_t maxPipelinedRequests) {
+        invariant(maxPipelinedRequests > 0);
+        _maxPipelinedRequests = maxPipelinedRequests;
+    }
+
+    size_t getMaxPipelinedRequests() const {
+        return _maxPipelinedRequests;
+    }
+
     void setSoTimeout(double timeout);
     double getSoTimeout() const override {
         return _socketTimeout.value_or(Milliseconds{0}).count() / 1000.0;
@@ -322,6 +358,12 @@ private:
     enum FailAction { kSetFlag, kEndSession, kReleaseSession };
     void _markFailed(FailAction action);
 
+    /**
+     * Reads the next reply from the socket into _pipelinedReplies. If the connection fails, every
+     * pending pipelined request is forgotten, since its reply can no longer arrive.
+     */
+    void _receivePipelinedReply();
+
     // Contains the string for the replica set name of the host this is connected to.
     // Should be empty if this connection is not pointing to a replica set member.
     std::string _parentReplSetName;
@@ -332,6 +374,15 @@ private:
     MessageCompressorManager _compressorManager;
 
     MongoURI _uri;
+
+    // Ids of the pipelined requests whose replies have not been read from the socket yet.
+    stdx::unordered_set<int> _pipelinedRequestsInFlight;
+
+    // Replies to pipelined requests which have been read from the socket, keyed by request id, but
+    // not yet returned by awaitPipelinedReply().
+    stdx::unordered_map<int, Message> _pipelinedReplies;
+
+    size_t _maxPipelinedRequests = 16;
 };
 
 BSONElement getErrField(const BSONObj& result);
@@ -100,5 +100,33 @@ TEST_F(DBClientConnectionFixture, shutdownWorksIfRunCommandInProgress) {
                   ExceptionForCat<ErrorCategory::NetworkError>);  // Currently HostUnreachable.
 }
 
+TEST_F(DBClientConnectionFixture, pipelinedRequestsGetTheirOwnReplies) {
+    auto conn = makeConn();
+    conn->setMaxPipelinedRequests(4);
+
+    // Send more requests than may be pending at once, so that some replies are buffered.
+    std::vector<int> requestIds;
+    for (int i = 0; i < 10; ++i) {
+        requestIds.push_back(conn->sendPipelinedRequest(
+            OpMsgRequest::fromDBAndBody("admin", BSON("echo" << 1 << "i" << i))));
+    }
+    ASSERT_EQ(10U, conn->numPendingPipelinedRequests());
+
+    // Commands may not be run on the connection until the pipelined replies have been read.
+    BSONObj reply;
+    ASSERT_THROWS_CODE(conn->runCommand("admin", BSON("ping" << 1), reply), DBException, 51019);
+
+    // Await the replies in the reverse order to the requests.
+    for (int i = 9; i >= 0; --i) {
+        auto pipelinedReply = conn->awaitPipelinedReply(requestIds[i]);
+        ASSERT_OK(getStatusFromCommandResult(pipelinedReply->getCommandReply()));
+        ASSERT_EQ(i, pipelinedReply->getCommandReply()["echo"]["i"].numberInt());
+    }
+    ASSERT_EQ(0U, conn->numPendingPipelinedRequests());
+    ASSERT_THROWS_CODE(conn->awaitPipelinedReply(requestIds[0]), DBException, 51021);
+
+    ASSERT(conn->runCommand("admin", BSON("ping" << 1), reply));
+}
+
 }  // namespace
 }  // namespace mongo
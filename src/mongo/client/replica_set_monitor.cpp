@@ -42,6 +42,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/bson_extract_optime.h"
 #include "mongo/db/server_options.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -91,11 +92,15 @@ const int64_t unknownLatency = numeric_limits<int64_t>::max();
 
 const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly, TagSet());
 const Milliseconds kFindHostMaxBackOffTime(500);
+
+// How much longer than its 'maxAwaitTimeMS' an awaitable isMaster may take over the network.
+const Milliseconds kAwaitableIsMasterNetworkTimeout(5000);
 AtomicBool areRefreshRetriesDisabledForTest{false};  // Only true in tests.
 
 // TODO: Move to ReplicaSetMonitorManager
 ReplicaSetMonitor::ConfigChangeHook asyncConfigChangeHook;
 ReplicaSetMonitor::ConfigChangeHook syncConfigChangeHook;
+ReplicaSetMonitor::PrimaryChangeHook primaryChangeHook;
 
 //
 // Helpers for stl algorithms
@@ -304,8 +309,12 @@ Future<HostAndPort> ReplicaSetMonitor::getHostOrRefresh(const ReadPreferenceSett
                     break;
                 }
 
-                // Back-off so we don't spam the replica set hosts too much
-                sleepFor(kFindHostMaxBackOffTime);
+                // Rather than polling the hosts again after a back-off, wait for one of them to
+                // report a change of topology, such as the election of a new primary. Back-off so
+                // we don't spam the replica set hosts too much if none of them can report one.
+                if (!self->_awaitTopologyChange(deadline - kFindHostMaxBackOffTime)) {
+                    sleepFor(kFindHostMaxBackOffTime);
+                }
             }
             return Status(ErrorCodes::FailedToSatisfyReadPreference,
                           str::stream() << "Could not find host matching read preference "
@@ -318,6 +327,79 @@ Future<HostAndPort> ReplicaSetMonitor::getHostOrRefresh(const ReadPreferenceSett
     return std::move(pf.future);
 }
 
+bool ReplicaSetMonitor::_awaitTopologyChange(Date_t deadline) {
+    std::vector<std::pair<HostAndPort, BSONObj>> awaitableNodes;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        for (auto&& node : _state->nodes) {
+            if (!node.topologyVersion.isEmpty()) {
+                awaitableNodes.emplace_back(node.host, node.topologyVersion);
+            }
+        }
+    }
+
+    const auto maxAwaitTime = duration_cast<Milliseconds>(deadline - Date_t::now());
+    if (awaitableNodes.empty() || maxAwaitTime <= Milliseconds(0)) {
+        return false;
+    }
+
+    struct AwaitState {
+        stdx::mutex mutex;
+        stdx::condition_variable cv;
+        size_t outstanding = 0;
+        bool changed = false;
+    };
+    auto state = std::make_shared<AwaitState>();
+    state->outstanding = awaitableNodes.size();
+
+    std::vector<CallbackHandle> handles;
+    for (auto&& hostAndVersion : awaitableNodes) {
+        executor::RemoteCommandRequest request(
+            hostAndVersion.first,
+            "admin",
+            BSON("isMaster" << 1 << "topologyVersion" << hostAndVersion.second << "maxAwaitTimeMS"
+                            << durationCount<Milliseconds>(maxAwaitTime)),
+            nullptr,
+            maxAwaitTime + kAwaitableIsMasterNetworkTimeout);
+        auto swHandle = _executor->scheduleRemoteCommand(
+            request,
+            [ state, version = hostAndVersion.second ](
+                const TaskExecutor::RemoteCommandCallbackArgs& cbArgs) {
+                const auto& response = cbArgs.response;
+                const bool changed = response.isOK() &&
+                    getStatusFromCommandResult(response.data).isOK() &&
+                    !response.data.getObjectField("topologyVersion").isEmpty() &&
+                    !response.data.getObjectField("topologyVersion").binaryEqual(version);
+
+                stdx::lock_guard<stdx::mutex> lk(state->mutex);
+                --state->outstanding;
+                state->changed = state->changed || changed;
+                state->cv.notify_all();
+            });
+        if (swHandle.isOK()) {
+            handles.push_back(std::move(swHandle.getValue()));
+        } else {
+            stdx::lock_guard<stdx::mutex> lk(state->mutex);
+            --state->outstanding;
+        }
+    }
+
+    bool changed;
+    {
+        stdx::unique_lock<stdx::mutex> lk(state->mutex);
+        state->cv.wait_until(lk, deadline.toSystemTimePoint(), [&] {
+            return state->changed || state->outstanding == 0;
+        });
+        changed = state->changed;
+    }
+
+    // The remaining requests are no longer needed once a node has reported a change.
+    for (auto&& handle : handles) {
+        _executor->cancel(handle);
+    }
+    return changed;
+}
+
 HostAndPort ReplicaSetMonitor::getMasterOrUassert() {
     return getHostOrRefresh(kPrimaryOnlyReadPreference).get();
 }
@@ -344,6 +426,27 @@ bool ReplicaSetMonitor::isPrimary(const HostAndPort& host) const {
     return node ? node->isMaster : false;
 }
 
+HostAndPort ReplicaSetMonitor::getMatchingHostNoRefresh(
+    const ReadPreferenceSetting& readPref, const std::set<HostAndPort>& excludedHosts) const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    return _state->getMatchingHost(readPref, excludedHosts);
+}
+
+void ReplicaSetMonitor::noteOperationLatency(const HostAndPort& host, Milliseconds latency) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (node) {
+        node->noteOpLatency(latency);
+    }
+}
+
+boost::optional<Milliseconds> ReplicaSetMonitor::getOperationLatencyPercentile(
+    const HostAndPort& host, double percentile) const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    return node ? node->getOpLatencyPercentile(percentile) : boost::none;
+}
+
 bool ReplicaSetMonitor::isHostUp(const HostAndPort& host) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
@@ -421,6 +524,11 @@ void ReplicaSetMonitor::setSynchronousConfigChangeHook(ConfigChangeHook hook) {
     syncConfigChangeHook = hook;
 }
 
+void ReplicaSetMonitor::setPrimaryChangeHook(PrimaryChangeHook hook) {
+    invariant(!primaryChangeHook);
+    primaryChangeHook = hook;
+}
+
 // TODO move to correct order with non-statics before pushing
 void ReplicaSetMonitor::appendInfo(BSONObjBuilder& bsonObjBuilder) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
@@ -463,6 +571,7 @@ void ReplicaSetMonitor::cleanup() {
     globalRSMonitorManager.removeAllMonitors();
     asyncConfigChangeHook = ReplicaSetMonitor::ConfigChangeHook();
     syncConfigChangeHook = ReplicaSetMonitor::ConfigChangeHook();
+    primaryChangeHook = ReplicaSetMonitor::PrimaryChangeHook();
 }
 
 void ReplicaSetMonitor::disableRefreshRetries_forTest() {
@@ -797,6 +906,12 @@ Status Refresher::receivedIsMasterFromMaster(const HostAndPort& from, const IsMa
     _scan->unconfirmedReplies.clear();
 
     _scan->foundUpMaster = true;
+
+    if (_set->lastSeenMaster != reply.host && primaryChangeHook) {
+        // call from a separate thread, as the hook may go over the network
+        stdx::thread bg(primaryChangeHook, _set->name, reply.host, _set->lastSeenMaster);
+        bg.detach();
+    }
     _set->lastSeenMaster = reply.host;
 
     return Status::OK();
@@ -930,6 +1045,8 @@ void IsMasterReply::parse(const BSONObj& obj) {
 
             uassertStatusOK(bsonExtractOpTimeField(lastWriteField, "opTime", &opTime));
         }
+
+        topologyVersion = raw.getObjectField("topologyVersion");
     } catch (const std::exception& e) {
         ok = false;
         log() << "exception while parsing isMaster reply: " << e.what() << " " << obj;
@@ -946,6 +1063,7 @@ void Node::markFailed(const Status& status) {
     }
 
     isMaster = false;
+    topologyVersion = BSONObj();
 }
 
 bool Node::matches(const ReadPreference pref) const {
@@ -1008,6 +1126,29 @@ void Node::update(const IsMasterReply& reply) {
     LOG(3) << "Updating " << host << " opTime to " << reply.opTime;
     opTime = reply.opTime;
     lastWriteDateUpdateTime = Date_t::now();
+
+    topologyVersion = reply.topologyVersion.getOwned();
+}
+
+void Node::noteOpLatency(Milliseconds latency) {
+    if (opLatencies.size() < kMaxOpLatencySamples) {
+        opLatencies.push_back(latency);
+    } else {
+        opLatencies[nextOpLatency] = latency;
+    }
+    nextOpLatency = (nextOpLatency + 1) % kMaxOpLatencySamples;
+}
+
+boost::optional<Milliseconds> Node::getOpLatencyPercentile(double percentile) const {
+    if (opLatencies.size() < kMinOpLatencySamples) {
+        return boost::none;
+    }
+
+    auto sorted = opLatencies;
+    const size_t rank = std::min(sorted.size() - 1,
+                                 static_cast<size_t>(percentile / 100 * sorted.size()));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
 }
 
 SetState::SetState(StringData name, const std::set<HostAndPort>& seedNodes)
@@ -1042,33 +1183,38 @@ SetState::SetState(const MongoURI& uri)
     setUri = uri;
 }
 
-HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) const {
+HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria,
+                                      const std::set<HostAndPort>& excludedHosts) const {
     switch (criteria.pref) {
         // "Prefered" read preferences are defined in terms of other preferences
         case ReadPreference::PrimaryPreferred: {
-            HostAndPort out =
-                getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+            HostAndPort out = getMatchingHost(
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excludedHosts);
             // NOTE: the spec says we should use the primary even if tags don't match
             if (!out.empty())
                 return out;
-            return getMatchingHost(ReadPreferenceSetting(
-                ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
+            return getMatchingHost(ReadPreferenceSetting(ReadPreference::SecondaryOnly,
+                                                         criteria.tags,
+                                                         criteria.maxStalenessSeconds),
+                                   excludedHosts);
         }
 
         case ReadPreference::SecondaryPreferred: {
-            HostAndPort out = getMatchingHost(ReadPreferenceSetting(
-                ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
+            HostAndPort out = getMatchingHost(ReadPreferenceSetting(ReadPreference::SecondaryOnly,
+                                                                    criteria.tags,
+                                                                    criteria.maxStalenessSeconds),
+                                              excludedHosts);
             if (!out.empty())
                 return out;
             // NOTE: the spec says we should use the primary even if tags don't match
             return getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excludedHosts);
         }
 
         case ReadPreference::PrimaryOnly: {
             // NOTE: isMaster implies isUp
             Nodes::const_iterator it = std::find_if(nodes.begin(), nodes.end(), isMaster);
-            if (it == nodes.end())
+            if (it == nodes.end() || excludedHosts.count(it->host))
                 return HostAndPort();
             return it->host;
         }
@@ -1124,7 +1270,7 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                 std::vector<const Node*> matchingNodes;
                 for (size_t i = 0; i < nodes.size(); i++) {
                     if (nodes[i].matches(criteria.pref) && nodes[i].matches(tag) &&
-                        matchNode(nodes[i])) {
+                        matchNode(nodes[i]) && !excludedHosts.count(nodes[i].host)) {
                         matchingNodes.push_back(&nodes[i]);
                     }
                 }
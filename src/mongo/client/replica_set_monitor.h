@@ -28,6 +28,7 @@
 #pragma once
 
 #include <atomic>
+#include <boost/optional.hpp>
 #include <memory>
 #include <memory>
 #include <set>
@@ -62,6 +63,11 @@ public:
     typedef stdx::function<void(const std::string& setName, const std::string& newConnectionString)>
         ConfigChangeHook;
 
+    typedef stdx::function<void(const std::string& setName,
+                                const HostAndPort& newPrimary,
+                                const HostAndPort& oldPrimary)>
+        PrimaryChangeHook;
+
     /**
      * Initializes local state.
      *
@@ -93,6 +99,26 @@ public:
     Future<HostAndPort> getHostOrRefresh(const ReadPreferenceSetting& readPref,
                                          Milliseconds maxWait = kDefaultFindHostTimeout);
 
+    /**
+     * Returns a host matching 'readPref' which is not one of 'excludedHosts', based ONLY on local
+     * data, or an empty HostAndPort if there is none. Does not refresh the view of the set.
+     */
+    HostAndPort getMatchingHostNoRefresh(const ReadPreferenceSetting& readPref,
+                                         const std::set<HostAndPort>& excludedHosts) const;
+
+    /**
+     * Records the round trip time of an operation which ran on 'host', so that callers can predict
+     * how long operations on that host are expected to take.
+     */
+    void noteOperationLatency(const HostAndPort& host, Milliseconds latency);
+
+    /**
+     * Returns the given percentile (between 0 and 100) of the latencies recently recorded for
+     * 'host' through noteOperationLatency, or boost::none if too few have been recorded.
+     */
+    boost::optional<Milliseconds> getOperationLatencyPercentile(const HostAndPort& host,
+                                                                double percentile) const;
+
     /**
      * Returns the host we think is the current master or uasserts.
      *
@@ -217,6 +243,18 @@ public:
      */
     static void setSynchronousConfigChangeHook(ConfigChangeHook hook);
 
+    /**
+     * Sets the hook to be called whenever a different node is found to be the primary of any
+     * replica set, including the first time a primary is found, in which case 'oldPrimary' is
+     * empty. Currently only 1 globally, so this asserts if one already exists.
+     *
+     * The hook will be called from a fresh thread. It is responsible for initializing any
+     * thread-local state and ensuring that no exceptions escape.
+     *
+     * The hook must not be changed while the program has multiple threads.
+     */
+    static void setPrimaryChangeHook(PrimaryChangeHook hook);
+
     /**
      * Permanently stops all monitoring on replica sets and clears all cached information
      * as well. As a consequence, NEVER call this if you have other threads that have a
@@ -282,6 +320,13 @@ private:
      */
     void _doScheduledRefresh(const executor::TaskExecutor::CallbackHandle& currentHandle);
 
+    /**
+     * Sends an awaitable isMaster to every node which reported a topology version, and waits until
+     * one of them reports a newer version or until 'deadline'. Returns true if a node reported a
+     * change, and false if no node supports awaitable isMaster or none reported a change in time.
+     */
+    bool _awaitTopologyChange(Date_t deadline);
+
     // Serializes refresh and protects _refresherHandle
     stdx::mutex _mutex;
     executor::TaskExecutor::CallbackHandle _refresherHandle;
@@ -75,6 +75,7 @@ struct ReplicaSetMonitor::IsMasterReply {
     BSONObj tags;
     int minWireVersion{};
     int maxWireVersion{};
+    BSONObj topologyVersion;  // empty if the host does not support awaitable isMaster
 
     // remaining fields aren't in isMaster reply, but are known to caller.
     HostAndPort host;
@@ -122,6 +123,21 @@ public:
          */
         void update(const IsMasterReply& reply);
 
+        /**
+         * Records the round trip time of an operation which ran on this node. Only the most recent
+         * kMaxOpLatencySamples are kept.
+         */
+        void noteOpLatency(Milliseconds latency);
+
+        /**
+         * Returns the given percentile of the recently recorded operation latencies, or
+         * boost::none if fewer than kMinOpLatencySamples have been recorded.
+         */
+        boost::optional<Milliseconds> getOpLatencyPercentile(double percentile) const;
+
+        static constexpr size_t kMaxOpLatencySamples = 64;
+        static constexpr size_t kMinOpLatencySamples = 8;
+
         HostAndPort host;
         bool isUp{false};
         bool isMaster{false};
@@ -133,6 +149,9 @@ public:
         Date_t lastWriteDateUpdateTime{};  // set to the local system's time at the time of updating
                                            // lastWriteDate
         repl::OpTime opTime{};             // from isMasterReply
+        BSONObj topologyVersion;           // owned, from isMasterReply
+        std::vector<Milliseconds> opLatencies;  // ring buffer of recent operation round trips
+        size_t nextOpLatency{0};                // position of the next sample in opLatencies
     };
 
     typedef std::vector<Node> Nodes;
@@ -147,11 +166,14 @@ public:
     bool isUsable() const;
 
     /**
-     * Returns a host matching criteria or an empty host if no known host matches.
+     * Returns a host matching criteria or an empty host if no known host matches. Hosts in
+     * 'excludedHosts' are never returned.
      *
      * Note: Uses only local data and does not go over the network.
      */
-    HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
+    HostAndPort getMatchingHost(
+        const ReadPreferenceSetting& criteria,
+        const std::set<HostAndPort>& excludedHosts = std::set<HostAndPort>()) const;
 
     /**
      * Returns the Node with the given host, or NULL if no Node has that host.
@@ -41,6 +41,7 @@ using std::set;
 typedef ReplicaSetMonitor::SetState SetState;
 typedef SetState::Node Node;
 typedef SetState::Nodes Nodes;
+typedef ReplicaSetMonitor::IsMasterReply IsMasterReply;
 
 bool isCompatible(const Node& node, ReadPreference pref, const TagSet& tagSet) {
     set<HostAndPort> seeds;
@@ -337,4 +338,45 @@ TEST(ReplSetMonitorNode, SecNodeNotCompatibleMultiTag) {
     ASSERT(!isCompatible(node, mongo::ReadPreference::Nearest, tags));
 }
 
+
+TEST(ReplSetMonitorNode, OpLatencyPercentile) {
+    Node node(HostAndPort("dummy", 3));
+
+    // Too few samples to predict the latency of the node
+    for (int i = 1; i < static_cast<int>(Node::kMinOpLatencySamples); i++) {
+        node.noteOpLatency(Milliseconds(i));
+    }
+    ASSERT_FALSE(node.getOpLatencyPercentile(50));
+
+    for (int i = Node::kMinOpLatencySamples; i <= 20; i++) {
+        node.noteOpLatency(Milliseconds(i));
+    }
+    ASSERT_EQUALS(Milliseconds(11), *node.getOpLatencyPercentile(50));
+    ASSERT_EQUALS(Milliseconds(20), *node.getOpLatencyPercentile(100));
+
+    // Older samples are dropped once the window is full
+    for (size_t i = 0; i < Node::kMaxOpLatencySamples; i++) {
+        node.noteOpLatency(Milliseconds(100));
+    }
+    ASSERT_EQUALS(Milliseconds(100), *node.getOpLatencyPercentile(1));
+}
+
+TEST(ReplSetMonitorNode, TopologyVersion) {
+    const HostAndPort host("dummy", 3);
+    Node node(host);
+
+    // Hosts which don't support awaitable isMaster don't report a topology version.
+    node.update(IsMasterReply(host, 10, BSON("ok" << 1 << "ismaster" << true)));
+    ASSERT(node.topologyVersion.isEmpty());
+
+    const BSONObj topologyVersion = BSON("processId" << OID::gen() << "counter" << 3LL);
+    node.update(IsMasterReply(
+        host, 10, BSON("ok" << 1 << "ismaster" << true << "topologyVersion" << topologyVersion)));
+    ASSERT_BSONOBJ_EQ(node.topologyVersion, topologyVersion);
+
+    // The version may be stale once the host has failed.
+    node.markFailed({ErrorCodes::HostUnreachable, "host unreachable"});
+    ASSERT(node.topologyVersion.isEmpty());
+}
+
 }  // namespace
@@ -298,6 +298,31 @@ TEST(ReplSetMonitorReadPref, NearestOneLocal) {
     ASSERT(!isPrimarySelected);
 }
 
+TEST(ReplSetMonitorReadPref, ExcludedHostsAreNotSelected) {
+    vector<Node> nodes = getThreeMemberWithTags();
+
+    nodes[0].latencyMicros = 10 * 1000;
+    nodes[1].latencyMicros = 20 * 1000;
+    nodes[2].latencyMicros = 30 * 1000;
+
+    SetState set("name", {nodes.front().host});
+    set.nodes = nodes;
+    set.latencyThresholdMicros = 3 * 1000;
+
+    const ReadPreferenceSetting nearest(mongo::ReadPreference::Nearest, TagSet());
+    ASSERT_EQUALS("a", set.getMatchingHost(nearest).host());
+
+    // The next closest host is selected instead of the excluded one
+    ASSERT_EQUALS("b", set.getMatchingHost(nearest, {HostAndPort("a")}).host());
+    ASSERT_EQUALS("c", set.getMatchingHost(nearest, {HostAndPort("a"), HostAndPort("b")}).host());
+    ASSERT(set.getMatchingHost(nearest, {HostAndPort("a"), HostAndPort("b"), HostAndPort("c")})
+               .empty());
+
+    // Excluding the primary leaves nothing to select for primary only reads
+    const ReadPreferenceSetting primaryOnly(mongo::ReadPreference::PrimaryOnly, TagSet());
+    ASSERT(set.getMatchingHost(primaryOnly, {HostAndPort("b")}).empty());
+}
+
 TEST(ReplSetMonitorReadPref, PriOnlyWithTagsNoMatch) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getP2TagSet());
@@ -647,6 +647,7 @@ bool AuthorizationSessionImpl::isAuthorizedForActionsOnNamespace(const Namespace
 }
 
 static const int resourceSearchListCapacity = 5;
+static const size_t maxCachedAuthorizationDecisions = 1000;
 /**
  * Builds from "target" an exhaustive list of all ResourcePatterns that match "target".
  *
@@ -752,10 +753,13 @@ bool AuthorizationSessionImpl::isAuthenticated() {
 void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx) {
     AuthorizationManager& authMan = getAuthorizationManager();
     UserSet::iterator it = _authenticatedUsers.begin();
+    bool usersChanged = false;
 
     while (it != _authenticatedUsers.end()) {
         auto& user = *it;
         if (!user->isValid()) {
+            usersChanged = true;
+
             // The user is invalid, so make sure that we erase it from _authenticateUsers at the
             // end of this block.
             auto removeGuard = MakeGuard([&] { _authenticatedUsers.removeAt(it++); });
@@ -822,10 +826,16 @@ void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx)
         }
         ++it;
     }
-    _buildAuthenticatedRolesVector();
+
+    // Only rebuild the state derived from the users when one of them was found to be invalid, so
+    // that the authorization decisions cached for this session survive from request to request.
+    if (usersChanged) {
+        _buildAuthenticatedRolesVector();
+    }
 }
 
 void AuthorizationSessionImpl::_buildAuthenticatedRolesVector() {
+    _authorizationDecisions.clear();
     _authenticatedRoleNames.clear();
     for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
          ++it) {
@@ -906,38 +916,64 @@ bool AuthorizationSessionImpl::isAuthorizedForAnyActionOnResource(const Resource
 bool AuthorizationSessionImpl::_isAuthorizedForPrivilege(const Privilege& privilege) {
     const ResourcePattern& target(privilege.getResourcePattern());
 
-    ResourcePattern resourceSearchList[resourceSearchListCapacity];
-    const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
-
     ActionSet unmetRequirements = privilege.getActions();
 
     PrivilegeVector defaultPrivileges = getDefaultPrivileges();
-    for (PrivilegeVector::iterator it = defaultPrivileges.begin(); it != defaultPrivileges.end();
-         ++it) {
-        for (int i = 0; i < resourceSearchListLength; ++i) {
-            if (!(it->getResourcePattern() == resourceSearchList[i]))
-                continue;
+    if (!defaultPrivileges.empty()) {
+        ResourcePattern resourceSearchList[resourceSearchListCapacity];
+        const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
+
+        for (PrivilegeVector::iterator it = defaultPrivileges.begin();
+             it != defaultPrivileges.end();
+             ++it) {
+            for (int i = 0; i < resourceSearchListLength; ++i) {
+                if (!(it->getResourcePattern() == resourceSearchList[i]))
+                    continue;
+
+                ActionSet userActions = it->getActions();
+                unmetRequirements.removeAllActionsFromSet(userActions);
+
+                if (unmetRequirements.empty())
+                    return true;
+            }
+        }
+    }
 
-            ActionSet userActions = it->getActions();
-            unmetRequirements.removeAllActionsFromSet(userActions);
+    return _usersAreAuthorizedForActions(target, unmetRequirements);
+}
 
-            if (unmetRequirements.empty())
-                return true;
-        }
+bool AuthorizationSessionImpl::_usersAreAuthorizedForActions(const ResourcePattern& target,
+                                                             const ActionSet& actions) {
+    // The answer depends only on the authenticated users, so it is computed once per resource and
+    // set of actions, until the users change.
+    AuthorizationDecisionKey key{target, actions};
+    auto it = _authorizationDecisions.find(key);
+    if (it != _authorizationDecisions.end()) {
+        return it->second;
     }
 
+    ResourcePattern resourceSearchList[resourceSearchListCapacity];
+    const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
+
+    ActionSet unmetRequirements = actions;
+    bool authorized = false;
     for (const auto& user : _authenticatedUsers) {
-        for (int i = 0; i < resourceSearchListLength; ++i) {
+        if (authorized) {
+            break;
+        }
+        for (int i = 0; i < resourceSearchListLength && !authorized; ++i) {
             ActionSet userActions = user->getActionsForResource(resourceSearchList[i]);
             unmetRequirements.removeAllActionsFromSet(userActions);
-
-            if (unmetRequirements.empty()) {
-                return true;
-            }
+            authorized = unmetRequirements.empty();
         }
     }
 
-    return false;
+    // Bound the memory used by a session which touches many distinct namespaces.
+    if (_authorizationDecisions.size() >= maxCachedAuthorizationDecisions) {
+        _authorizationDecisions.clear();
+    }
+    _authorizationDecisions.emplace(std::move(key), authorized);
+    return authorized;
 }
 
 void AuthorizationSessionImpl::setImpersonatedUserData(std::vector<UserName> usernames,
@@ -42,6 +42,7 @@
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -197,6 +198,7 @@ protected:
     // Builds a vector of all roles held by users who are authenticated on this connection. The
     // vector is stored in _authenticatedRoleNames. This function is called when users are
     // logged in or logged out, as well as when the user cache is determined to be out of date.
+    // Since the authenticated users have changed, it also discards _authorizationDecisions.
     void _buildAuthenticatedRolesVector();
 
     // All Users who have been authenticated on this connection.
@@ -207,10 +209,29 @@ protected:
     std::vector<RoleName> _authenticatedRoleNames;
 
 private:
+    // A resource and a set of actions which an authorization check requires on it.
+    struct AuthorizationDecisionKey {
+        struct Hasher {
+            size_t operator()(const AuthorizationDecisionKey& key) const {
+                return key.resource.hash() ^ key.actions.hash();
+            }
+        };
+
+        bool operator==(const AuthorizationDecisionKey& other) const {
+            return resource == other.resource && actions == other.actions;
+        }
+
+        ResourcePattern resource;
+        ActionSet actions;
+    };
+
     // If any users authenticated on this session are marked as invalid this updates them with
     // up-to-date information. May require a read lock on the "admin" db to read the user data.
     void _refreshUserInfoAsNeeded(OperationContext* opCtx);
 
+    // Checks whether the privileges of _authenticatedUsers grant 'actions' on 'target', consulting
+    // and filling _authorizationDecisions.
+    bool _usersAreAuthorizedForActions(const ResourcePattern& target, const ActionSet& actions);
 
     // Checks if this connection is authorized for the given Privilege, ignoring whether or not
     // we should even be doing authorization checks in general.  Note: this may acquire a read
@@ -228,5 +249,12 @@ private:
     std::vector<UserName> _impersonatedUserNames;
     std::vector<RoleName> _impersonatedRoleNames;
     bool _impersonationFlag;
+
+    // Whether the privileges of _authenticatedUsers grant a set of actions on a resource, for each
+    // such check made since the authenticated users last changed. A change to the user cache
+    // generation invalidates the User objects, and replacing them at the start of the next request
+    // clears this map.
+    stdx::unordered_map<AuthorizationDecisionKey, bool, AuthorizationDecisionKey::Hasher>
+        _authorizationDecisions;
 };
 }  // namespace mongo
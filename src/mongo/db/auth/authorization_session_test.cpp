@@ -480,6 +480,40 @@ TEST_F(AuthorizationSessionTest, InvalidateUser) {
     ASSERT_FALSE(authzSession->lookupUser(UserName("spencer", "test")));
 }
 
+TEST_F(AuthorizationSessionTest, RepeatedChecksDistinguishResourcesAndActions) {
+    ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
+                                                    BSON("user"
+                                                         << "spencer"
+                                                         << "db"
+                                                         << "test"
+                                                         << "credentials"
+                                                         << credentials
+                                                         << "roles"
+                                                         << BSON_ARRAY(BSON("role"
+                                                                            << "read"
+                                                                            << "db"
+                                                                            << "test"))),
+                                                    BSONObj()));
+    ASSERT_OK(authzSession->addAndAuthorizeUser(_opCtx.get(), UserName("spencer", "test")));
+
+    ActionSet findAndInsert{ActionType::find, ActionType::insert};
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(
+            authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+        ASSERT_FALSE(authzSession->isAuthorizedForActionsOnResource(testFooCollResource,
+                                                                    ActionType::insert));
+        ASSERT_FALSE(
+            authzSession->isAuthorizedForActionsOnResource(testFooCollResource, findAndInsert));
+        ASSERT_FALSE(
+            authzSession->isAuthorizedForActionsOnResource(otherFooCollResource, ActionType::find));
+    }
+
+    // Logging out discards the decisions made for the user.
+    authzSession->logoutDatabase("test");
+    ASSERT_FALSE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+}
+
 TEST_F(AuthorizationSessionTest, UseOldUserInfoInFaceOfConnectivityProblems) {
     // Add a readWrite user
     ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
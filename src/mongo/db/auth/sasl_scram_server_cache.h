@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/crypto/mechanism_scram.h"
+#include "mongo/db/auth/user.h"
+#include "mongo/db/auth/user_name.h"
+#include "mongo/db/auth/user_name_hash.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * A cache of the SCRAM secrets which the server decodes from a user's stored credentials.
+ *
+ * The server side of a SCRAM conversation only needs the StoredKey and ServerKey of the user,
+ * which are kept base64 encoded in the user document. Decoding them and copying them into secure
+ * memory happens on every conversation, which adds up when many connections authenticate as the
+ * same users at once, as happens after a failover. This cache is the server counterpart of
+ * SCRAMClientCache.
+ *
+ * Entries are keyed by user name and hold the credentials they were decoded from, so secrets are
+ * only returned while the user's credentials are unchanged.
+ */
+template <typename HashBlock>
+class SCRAMServerCache {
+private:
+    using Credentials = User::SCRAMCredentials<HashBlock>;
+    using CredentialsAndSecrets = std::pair<Credentials, scram::Secrets<HashBlock>>;
+    using UserToSecretsMap = stdx::unordered_map<UserName, CredentialsAndSecrets>;
+
+public:
+    // Once this many users have entries, the cache is emptied before another is added, so that
+    // entries for dropped users do not accumulate.
+    static constexpr size_t kMaxCachedUsers = 10000;
+
+    /**
+     * Returns the secrets stored for 'user', if they were decoded from credentials equal to
+     * 'credentials'. Otherwise, no secrets are returned.
+     */
+    scram::Secrets<HashBlock> getCachedSecrets(const UserName& user,
+                                               const Credentials& credentials) const {
+        const stdx::lock_guard<stdx::mutex> lock(_userToSecretsMutex);
+
+        auto foundSecrets = _userToSecrets.find(user);
+        if (foundSecrets == _userToSecrets.end()) {
+            return {};
+        }
+
+        // The user's credentials may have been changed since the secrets were cached, in which
+        // case the secrets must be decoded again.
+        const auto& foundCredentials = foundSecrets->second.first;
+        if (foundCredentials.iterationCount != credentials.iterationCount ||
+            foundCredentials.salt != credentials.salt ||
+            foundCredentials.storedKey != credentials.storedKey ||
+            foundCredentials.serverKey != credentials.serverKey) {
+            return {};
+        }
+        return foundSecrets->second.second;
+    }
+
+    /**
+     * Records the secrets decoded from the credentials of 'user', replacing any secrets previously
+     * recorded for it.
+     */
+    void setCachedSecrets(UserName user,
+                          Credentials credentials,
+                          scram::Secrets<HashBlock> secrets) {
+        const stdx::lock_guard<stdx::mutex> lock(_userToSecretsMutex);
+
+        if (_userToSecrets.size() >= kMaxCachedUsers) {
+            _userToSecrets.clear();
+        }
+        _userToSecrets[std::move(user)] =
+            std::make_pair(std::move(credentials), std::move(secrets));
+    }
+
+private:
+    mutable stdx::mutex _userToSecretsMutex;
+    UserToSecretsMap _userToSecrets;
+};
+
+template <typename HashBlock>
+constexpr size_t SCRAMServerCache<HashBlock>::kMaxCachedUsers;
+
+}  // namespace mongo
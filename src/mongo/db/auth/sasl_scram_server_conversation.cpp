@@ -44,7 +44,9 @@
 #include "mongo/db/auth/sasl_mechanism_policies.h"
 #include "mongo/db/auth/sasl_mechanism_registry.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/auth/sasl_scram_server_cache.h"
 #include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -53,6 +55,30 @@
 
 namespace mongo {
 
+namespace {
+
+template <typename HashBlock>
+SCRAMServerCache<HashBlock>& getSCRAMServerCache() {
+    static auto* const cache = new SCRAMServerCache<HashBlock>();
+    return *cache;
+}
+
+// Source of the server nonces. Creating a SecureRandom may open a file, so conversations share
+// one rather than each creating their own.
+stdx::mutex nonceRandomMutex;
+std::unique_ptr<SecureRandom> nonceRandom;
+
+void generateBinaryNonce(uint64_t* binaryNonce, int nonceLenQWords) {
+    stdx::lock_guard<stdx::mutex> lk(nonceRandomMutex);
+    if (!nonceRandom) {
+        nonceRandom = SecureRandom::create();
+    }
+    for (int i = 0; i < nonceLenQWords; ++i) {
+        binaryNonce[i] = nonceRandom->nextInt64();
+    }
+}
+
+}  // namespace
 
 template <typename Policy>
 StatusWith<std::tuple<bool, std::string>> SaslSCRAMServerMechanism<Policy>::stepImpl(
@@ -199,8 +225,8 @@ StatusWith<std::tuple<bool, std::string>> SaslSCRAMServerMechanism<Policy>::_fir
     }
     auto userObj = std::move(swUser.getValue());
 
-    User::CredentialData credentials = userObj->getCredentials();
-    UserName userName = userObj->getName();
+    const User::CredentialData& credentials = userObj->getCredentials();
+    const UserName& userName = userObj->getName();
 
     _scramCredentials = credentials.scram<HashBlock>();
 
@@ -218,20 +244,20 @@ StatusWith<std::tuple<bool, std::string>> SaslSCRAMServerMechanism<Policy>::_fir
         }
     }
 
-    _secrets = scram::Secrets<HashBlock>("",
-                                         base64::decode(_scramCredentials.storedKey),
-                                         base64::decode(_scramCredentials.serverKey));
+    auto& serverCache = getSCRAMServerCache<HashBlock>();
+    _secrets = serverCache.getCachedSecrets(userName, _scramCredentials);
+    if (!_secrets) {
+        _secrets = scram::Secrets<HashBlock>("",
+                                             base64::decode(_scramCredentials.storedKey),
+                                             base64::decode(_scramCredentials.serverKey));
+        serverCache.setCachedSecrets(userName, _scramCredentials, _secrets);
+    }
 
     // Generate server-first-message
     // Create text-based nonce as base64 encoding of a binary blob of length multiple of 3
     const int nonceLenQWords = 3;
     uint64_t binaryNonce[nonceLenQWords];
-
-    std::unique_ptr<SecureRandom> sr(SecureRandom::create());
-
-    binaryNonce[0] = sr->nextInt64();
-    binaryNonce[1] = sr->nextInt64();
-    binaryNonce[2] = sr->nextInt64();
+    generateBinaryNonce(binaryNonce, nonceLenQWords);
 
     _nonce =
         clientNonce + base64::encode(reinterpret_cast<char*>(binaryNonce), sizeof(binaryNonce));
@@ -42,6 +42,7 @@
 #include "mongo/db/auth/authz_manager_external_state_mock.h"
 #include "mongo/db/auth/authz_session_external_state_mock.h"
 #include "mongo/db/auth/sasl_mechanism_registry.h"
+#include "mongo/db/auth/sasl_scram_server_cache.h"
 #include "mongo/db/auth/sasl_scram_server_conversation.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -655,5 +656,49 @@ TEST(SCRAMCache, testSetAndReset) {
     testSetAndReset<SHA256Block>();
 }
 
+template <typename HashBlock>
+User::SCRAMCredentials<HashBlock> makeServerCredentials(const scram::Secrets<HashBlock>& secrets,
+                                                        const std::string& salt) {
+    User::SCRAMCredentials<HashBlock> credentials;
+    credentials.iterationCount = 10000;
+    credentials.salt = salt;
+    credentials.storedKey = secrets.storedKey().toString();
+    credentials.serverKey = secrets.serverKey().toString();
+    return credentials;
+}
+
+template <typename HashBlock>
+void testServerCacheSetAndGet() {
+    SCRAMServerCache<HashBlock> cache;
+    const UserName user("sajack", "test");
+    const auto salt = scram::Presecrets<HashBlock>::generateSecureRandomSalt();
+    const auto saltString = base64::encode(reinterpret_cast<const char*>(salt.data()), salt.size());
+
+    const auto secrets =
+        scram::Secrets<HashBlock>(scram::Presecrets<HashBlock>("aaa", salt, 10000));
+    const auto credentials = makeServerCredentials(secrets, saltString);
+    ASSERT_FALSE(cache.getCachedSecrets(user, credentials));
+
+    cache.setCachedSecrets(user, credentials, secrets);
+    const auto cachedSecrets = cache.getCachedSecrets(user, credentials);
+    ASSERT_TRUE(cachedSecrets);
+    ASSERT_TRUE(secrets.serverKey() == cachedSecrets.serverKey());
+    ASSERT_TRUE(secrets.storedKey() == cachedSecrets.storedKey());
+
+    // Another user, or changed credentials for the same user, must not be served the secrets.
+    ASSERT_FALSE(cache.getCachedSecrets(UserName("sajack", "admin"), credentials));
+    const auto otherSecrets =
+        scram::Secrets<HashBlock>(scram::Presecrets<HashBlock>("aab", salt, 10000));
+    ASSERT_FALSE(cache.getCachedSecrets(user, makeServerCredentials(otherSecrets, saltString)));
+    auto otherIterationCount = credentials;
+    otherIterationCount.iterationCount = 10001;
+    ASSERT_FALSE(cache.getCachedSecrets(user, otherIterationCount));
+}
+
+TEST(SCRAMServerCache, testSetAndGet) {
+    testServerCacheSetAndGet<SHA1Block>();
+    testServerCacheSetAndGet<SHA256Block>();
+}
+
 }  // namespace
 }  // namespace mongo
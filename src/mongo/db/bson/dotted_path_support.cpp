@@ -36,6 +36,7 @@
 #include "mongo/bson/bsonelement.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobj_field_index.h"
 #include "mongo/bson/bsonobjbuilder.h"
 
 namespace mongo {
@@ -123,13 +124,16 @@ void _extractAllElementsAlongPath(const BSONObj& obj,
 }  // namespace
 
 BSONElement extractElementAtPath(const BSONObj& obj, StringData path) {
-    BSONElement e = obj.getField(path);
+    BSONElement e = BSONObjFieldIndex::lookup(obj, path);
     if (e.eoo()) {
         size_t dot_offset = path.find('.');
         if (dot_offset != std::string::npos) {
             StringData left = path.substr(0, dot_offset);
             StringData right = path.substr(dot_offset + 1);
-            BSONObj sub = obj.getObjectField(left);
+            BSONElement leftElt = BSONObjFieldIndex::lookup(obj, left);
+            BSONObj sub = leftElt.type() == Object || leftElt.type() == Array
+                ? leftElt.embeddedObject()
+                : BSONObj();
             return sub.isEmpty() ? BSONElement() : extractElementAtPath(sub, right);
         }
     }
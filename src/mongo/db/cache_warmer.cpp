@@ -0,0 +1,489 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/cache_warmer.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mongo/base/counter.h"
+#include "mongo/base/data_type_validated.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_info_cache.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/keypattern.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/rpc/object_check.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(cacheWarmerEnabled, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(cacheWarmerPersistIntervalSecs, int, 300)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0)
+            return Status(ErrorCodes::BadValue,
+                          "cacheWarmerPersistIntervalSecs must be strictly positive");
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(cacheWarmerMaxPreloadBytes, long long, 1024 * 1024 * 1024)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0)
+            return Status(ErrorCodes::BadValue, "cacheWarmerMaxPreloadBytes must not be negative");
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(cacheWarmerMaxPreloadBytesPerSecond, long long, 64 * 1024 * 1024)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0)
+            return Status(ErrorCodes::BadValue,
+                          "cacheWarmerMaxPreloadBytesPerSecond must not be negative");
+        return Status::OK();
+    });
+
+namespace {
+
+const std::string kHotListBasename = "cacheWarmer.bson";
+
+// The most collections saved in the hot list.
+const size_t kMaxHotCollections = 100;
+
+// The bytes read under one acquisition of the collection lock while pre-loading.
+const long long kPreloadBatchBytes = 1024 * 1024;
+
+Counter64 cacheWarmerPersists;
+Counter64 cacheWarmerPreloadedBytes;
+
+ServerStatusMetricField<Counter64> displayCacheWarmerPersists("cacheWarmer.persists",
+                                                              &cacheWarmerPersists);
+ServerStatusMetricField<Counter64> displayCacheWarmerPreloadedBytes("cacheWarmer.preloadedBytes",
+                                                                    &cacheWarmerPreloadedBytes);
+
+struct HotCollection {
+    std::string ns;
+    double score = 0;
+    // Names of the indexes used since startup, most used first.
+    std::vector<std::string> indexes;
+};
+
+class CacheWarmer : public BackgroundJob {
+public:
+    std::string name() const override {
+        return "CacheWarmer";
+    }
+
+    void run() override {
+        Client::initThread(name().c_str());
+        ON_BLOCK_EXIT([] { Client::destroy(); });
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        const std::vector<HotCollection> hotList = _readHotList();
+        for (const auto& hot : hotList) {
+            _scores[hot.ns] = hot.score;
+        }
+
+        if (cacheWarmerEnabled.load() && !hotList.empty()) {
+            try {
+                _preload(hotList);
+            } catch (const DBException& ex) {
+                log() << "stopped pre-loading the cache: " << redact(ex.toStatus());
+            }
+        }
+
+        while (!globalInShutdownDeprecated()) {
+            {
+                MONGO_IDLE_THREAD_BLOCK;
+                sleepsecs(cacheWarmerPersistIntervalSecs.load());
+            }
+
+            if (!cacheWarmerEnabled.load() || globalInShutdownDeprecated()) {
+                continue;
+            }
+
+            try {
+                _persistHotList();
+            } catch (const DBException& ex) {
+                warning() << "failed to save the cache warmer hot list: " << redact(ex.toStatus());
+            }
+        }
+    }
+
+private:
+    static boost::filesystem::path _hotListPath() {
+        return boost::filesystem::path(storageGlobalParams.dbpath) / kHotListBasename;
+    }
+
+    /**
+     * Returns the hot list saved by the previous run, or an empty list if there is none or it
+     * can't be read. The list is only a hint, so a bad file is logged and ignored.
+     */
+    std::vector<HotCollection> _readHotList() {
+        std::vector<HotCollection> hotList;
+        const auto path = _hotListPath();
+        if (!boost::filesystem::exists(path)) {
+            return hotList;
+        }
+
+        try {
+            std::vector<char> buffer(boost::filesystem::file_size(path));
+            std::ifstream ifs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+            ifs.read(buffer.data(), buffer.size());
+            uassert(ErrorCodes::FileStreamFailed, "unable to read the file", ifs);
+
+            ConstDataRange cdr(buffer.data(), buffer.size());
+            const BSONObj obj = uassertStatusOK(cdr.read<Validated<BSONObj>>());
+            for (const auto& collElem : obj["collections"].Array()) {
+                const BSONObj coll = collElem.Obj();
+                HotCollection hot;
+                hot.ns = coll["ns"].String();
+                hot.score = coll["score"].Number();
+                for (const auto& indexElem : coll["indexes"].Array()) {
+                    hot.indexes.push_back(indexElem.String());
+                }
+                hotList.push_back(std::move(hot));
+            }
+        } catch (const std::exception& ex) {
+            warning() << "ignoring unreadable cache warmer hot list " << path.string() << ": "
+                      << ex.what();
+            hotList.clear();
+        }
+        return hotList;
+    }
+
+    /**
+     * Ages the usage scores of the namespaces, adds the operations Top recorded since the last
+     * call, and saves the hottest collections with their used indexes to the hot list file.
+     */
+    void _persistHotList() {
+        for (auto& entry : _scores) {
+            entry.second /= 2;
+        }
+
+        Top::UsageMap usage;
+        Top::get(getGlobalServiceContext()).cloneMap(usage);
+        std::map<std::string, long long> counts;
+        for (const auto& entry : usage) {
+            const NamespaceString nss(entry.first);
+            if (!nss.isValid() || !nss.isNormal() || nss.isOplog()) {
+                continue;
+            }
+            const long long count = entry.second.total.count;
+            counts[entry.first] = count;
+            const auto last = _lastCounts.find(entry.first);
+            const long long newOps = count - (last == _lastCounts.end() ? 0 : last->second);
+            if (newOps > 0) {
+                _scores[entry.first] += newOps;
+            }
+        }
+        _lastCounts = std::move(counts);
+
+        std::vector<HotCollection> hotList;
+        for (auto it = _scores.begin(); it != _scores.end();) {
+            if (it->second < 1) {
+                it = _scores.erase(it);
+                continue;
+            }
+            HotCollection hot;
+            hot.ns = it->first;
+            hot.score = it->second;
+            hotList.push_back(std::move(hot));
+            ++it;
+        }
+        std::sort(hotList.begin(), hotList.end(), [](const auto& a, const auto& b) {
+            return a.score > b.score;
+        });
+        if (hotList.size() > kMaxHotCollections) {
+            hotList.resize(kMaxHotCollections);
+        }
+
+        const auto opCtx = cc().makeOperationContext();
+        BSONObjBuilder builder;
+        BSONArrayBuilder collsBuilder(builder.subarrayStart("collections"));
+        for (auto& hot : hotList) {
+            _addUsedIndexes(opCtx.get(), &hot);
+            BSONObjBuilder collBuilder(collsBuilder.subobjStart());
+            collBuilder.append("ns", hot.ns);
+            collBuilder.append("score", hot.score);
+            collBuilder.append("indexes", hot.indexes);
+        }
+        collsBuilder.done();
+        uassertStatusOK(_writeHotList(builder.obj()));
+        cacheWarmerPersists.increment();
+    }
+
+    static void _addUsedIndexes(OperationContext* opCtx, HotCollection* hot) {
+        std::vector<std::pair<long long, std::string>> used;
+        {
+            AutoGetCollection autoColl(opCtx, NamespaceString(hot->ns), MODE_IS);
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                return;
+            }
+            for (const auto& entry : collection->infoCache()->getIndexUsageStats()) {
+                const long long accesses = entry.second.accesses.load();
+                if (accesses > 0) {
+                    used.emplace_back(accesses, entry.first);
+                }
+            }
+        }
+        std::sort(used.begin(), used.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+        for (const auto& index : used) {
+            hot->indexes.push_back(index.second);
+        }
+    }
+
+    /**
+     * Writes the hot list to a temporary file and renames it over the previous one. The file is
+     * not fsynced: after a crash the previous list, or none, is an acceptable hint.
+     */
+    static Status _writeHotList(const BSONObj& obj) {
+        const auto path = _hotListPath();
+        const auto tempPath = boost::filesystem::path(path.string() + ".tmp");
+        {
+            std::ofstream ofs(tempPath.c_str(), std::ios_base::out | std::ios_base::binary);
+            ofs.write(obj.objdata(), obj.objsize());
+            if (!ofs) {
+                return Status(ErrorCodes::FileStreamFailed,
+                              str::stream() << "Failed to write " << tempPath.string() << ": "
+                                            << errnoWithDescription());
+            }
+        }
+
+        boost::system::error_code ec;
+        boost::filesystem::rename(tempPath, path, ec);
+        if (ec) {
+            return Status(ErrorCodes::FileRenameFailed,
+                          str::stream() << "Failed to rename " << tempPath.string() << " to "
+                                        << path.string()
+                                        << ": "
+                                        << ec.message());
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Reads the indexes and then the records of the hot collections, hottest first, until
+     * cacheWarmerMaxPreloadBytes have been read.
+     */
+    void _preload(const std::vector<HotCollection>& hotList) {
+        const auto opCtx = cc().makeOperationContext();
+        const long long maxBytes = cacheWarmerMaxPreloadBytes.load();
+        long long bytes = 0;
+        Timer timer;
+
+        log() << "pre-loading up to " << maxBytes << " bytes of " << hotList.size()
+              << " hot collections into the cache";
+        for (const auto& hot : hotList) {
+            const NamespaceString nss(hot.ns);
+            for (const auto& indexName : hot.indexes) {
+                if (bytes >= maxBytes) {
+                    break;
+                }
+                bytes += _preloadIndex(opCtx.get(), nss, indexName, maxBytes - bytes);
+            }
+            if (bytes >= maxBytes) {
+                break;
+            }
+            bytes += _preloadRecords(opCtx.get(), nss, maxBytes - bytes);
+        }
+        log() << "pre-loaded " << bytes << " bytes into the cache in " << timer.millis() << "ms";
+    }
+
+    /**
+     * Reads up to 'maxBytes' of keys of the index 'indexName' in key order, releasing the
+     * collection lock between batches. Returns the bytes read.
+     */
+    static long long _preloadIndex(OperationContext* opCtx,
+                                   const NamespaceString& nss,
+                                   const std::string& indexName,
+                                   long long maxBytes) {
+        long long bytes = 0;
+        BSONObj resumeKey;
+        bool more = true;
+        while (more && bytes < maxBytes) {
+            Timer batchTimer;
+            long long batchBytes = 0;
+            {
+                AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+                Collection* collection = autoColl.getCollection();
+                if (!collection) {
+                    return bytes;
+                }
+                IndexDescriptor* desc =
+                    collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
+                if (!desc) {
+                    return bytes;
+                }
+
+                KeyPattern keyPattern(desc->keyPattern());
+                const BSONObj startKey = resumeKey.isEmpty()
+                    ? Helpers::toKeyFormat(keyPattern.extendRangeBound({}, false))
+                    : resumeKey;
+                const BSONObj endKey = Helpers::toKeyFormat(keyPattern.extendRangeBound({}, true));
+                // Keys equal to the last key of a batch are skipped by the next one, which only
+                // leaves a little of the index unread.
+                const BoundInclusion boundInclusion = resumeKey.isEmpty()
+                    ? BoundInclusion::kIncludeBothStartAndEndKeys
+                    : BoundInclusion::kIncludeEndKeyOnly;
+                auto exec = InternalPlanner::indexScan(opCtx,
+                                                       collection,
+                                                       desc,
+                                                       startKey,
+                                                       endKey,
+                                                       boundInclusion,
+                                                       PlanExecutor::NO_YIELD);
+                BSONObj keyObj;
+                PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+                while (batchBytes < kPreloadBatchBytes &&
+                       PlanExecutor::ADVANCED == (state = exec->getNext(&keyObj, nullptr))) {
+                    batchBytes += keyObj.objsize();
+                    resumeKey = keyObj.getOwned();
+                }
+                more = PlanExecutor::ADVANCED == state;
+            }
+            bytes += batchBytes;
+            cacheWarmerPreloadedBytes.increment(batchBytes);
+            _pace(opCtx, batchBytes, batchTimer);
+        }
+        return bytes;
+    }
+
+    /**
+     * Reads up to 'maxBytes' of the records of the collection 'nss' in storage order, releasing
+     * the collection lock between batches. Returns the bytes read.
+     */
+    static long long _preloadRecords(OperationContext* opCtx,
+                                     const NamespaceString& nss,
+                                     long long maxBytes) {
+        long long bytes = 0;
+        RecordId resumeFrom;
+        bool more = true;
+        while (more && bytes < maxBytes) {
+            Timer batchTimer;
+            long long batchBytes = 0;
+            {
+                AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+                Collection* collection = autoColl.getCollection();
+                if (!collection) {
+                    return bytes;
+                }
+
+                // Each batch starts at the last record of the previous one. If that record was
+                // deleted in between, the scan ends early.
+                auto exec = InternalPlanner::collectionScan(opCtx,
+                                                            nss.ns(),
+                                                            collection,
+                                                            PlanExecutor::NO_YIELD,
+                                                            InternalPlanner::FORWARD,
+                                                            resumeFrom);
+                BSONObj obj;
+                RecordId loc;
+                PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+                while (batchBytes < kPreloadBatchBytes &&
+                       PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &loc))) {
+                    batchBytes += obj.objsize();
+                    resumeFrom = loc;
+                }
+                more = PlanExecutor::ADVANCED == state;
+            }
+            bytes += batchBytes;
+            cacheWarmerPreloadedBytes.increment(batchBytes);
+            _pace(opCtx, batchBytes, batchTimer);
+        }
+        return bytes;
+    }
+
+    /**
+     * Sleeps for as long as needed to keep reading under cacheWarmerMaxPreloadBytesPerSecond,
+     * given that a batch of 'batchBytes' took the time measured by 'batchTimer'.
+     */
+    static void _pace(OperationContext* opCtx, long long batchBytes, const Timer& batchTimer) {
+        const long long maxBytesPerSecond = cacheWarmerMaxPreloadBytesPerSecond.load();
+        if (maxBytesPerSecond <= 0) {
+            return;
+        }
+        const Milliseconds batchBudget(batchBytes * 1000 / maxBytesPerSecond);
+        const Milliseconds batchTime(batchTimer.millis());
+        if (batchBudget > batchTime) {
+            MONGO_IDLE_THREAD_BLOCK;
+            opCtx->sleepFor(batchBudget - batchTime);
+        }
+    }
+
+    // Decaying count of operations on each namespace, halved every time the hot list is saved.
+    std::map<std::string, double> _scores;
+
+    // Top's total operation count for each namespace when the hot list was last saved.
+    std::map<std::string, long long> _lastCounts;
+};
+
+// The global CacheWarmer object is intentionally leaked, like the TTLMonitor.
+CacheWarmer* cacheWarmer = nullptr;
+
+}  // namespace
+
+void startCacheWarmerBackgroundJob() {
+    if (getGlobalServiceContext()->getStorageEngine()->isEphemeral()) {
+        return;
+    }
+    cacheWarmer = new CacheWarmer();
+    cacheWarmer->go();
+}
+
+}  // namespace mongo
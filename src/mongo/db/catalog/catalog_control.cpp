@@ -169,37 +169,42 @@ void openCatalog(OperationContext* opCtx, const MinVisibleTimestampMap& minVisib
     auto& uuidCatalog = UUIDCatalog::get(opCtx);
     std::vector<std::string> databasesToOpen;
     storageEngine->listDatabases(&databasesToOpen);
-    for (auto&& dbName : databasesToOpen) {
-        LOG(1) << "openCatalog: dbholder reopening database " << dbName;
-        auto db = DatabaseHolder::getDatabaseHolder().openDb(opCtx, dbName);
-        invariant(db, str::stream() << "failed to reopen database " << dbName);
-
-        std::list<std::string> collections;
-        db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collections);
-        for (auto&& collName : collections) {
-            // Note that the collection name already includes the database component.
-            NamespaceString collNss(collName);
-            auto collection = db->getCollection(opCtx, collName);
-            invariant(collection,
-                      str::stream() << "failed to get valid collection pointer for namespace "
-                                    << collName);
-
-            auto uuid = collection->uuid();
-            invariant(uuid);
-
-            LOG(1) << "openCatalog: registering uuid " << uuid->toString() << " for collection "
-                   << collName;
-            uuidCatalog.registerUUIDCatalogEntry(*uuid, collection);
-
-            if (minVisibleTimestampMap.count(*uuid) > 0) {
-                collection->setMinimumVisibleSnapshot(minVisibleTimestampMap.find(*uuid)->second);
-            }
-
-            // If this is the oplog collection, re-establish the replication system's cached pointer
-            // to the oplog.
-            if (collNss.isOplog()) {
-                log() << "openCatalog: updating cached oplog pointer";
-                repl::establishOplogCollectionForLogging(opCtx, collection);
+    {
+        // Registering collections one at a time would copy the UUID catalog once per collection.
+        UUIDCatalog::BatchedRegistration batchedRegistration(uuidCatalog);
+        for (auto&& dbName : databasesToOpen) {
+            LOG(1) << "openCatalog: dbholder reopening database " << dbName;
+            auto db = DatabaseHolder::getDatabaseHolder().openDb(opCtx, dbName);
+            invariant(db, str::stream() << "failed to reopen database " << dbName);
+
+            std::list<std::string> collections;
+            db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collections);
+            for (auto&& collName : collections) {
+                // Note that the collection name already includes the database component.
+                NamespaceString collNss(collName);
+                auto collection = db->getCollection(opCtx, collName);
+                invariant(collection,
+                          str::stream() << "failed to get valid collection pointer for namespace "
+                                        << collName);
+
+                auto uuid = collection->uuid();
+                invariant(uuid);
+
+                LOG(1) << "openCatalog: registering uuid " << uuid->toString() << " for collection "
+                       << collName;
+                uuidCatalog.registerUUIDCatalogEntry(*uuid, collection);
+
+                if (minVisibleTimestampMap.count(*uuid) > 0) {
+                    collection->setMinimumVisibleSnapshot(
+                        minVisibleTimestampMap.find(*uuid)->second);
+                }
+
+                // If this is the oplog collection, re-establish the replication system's cached
+                // pointer to the oplog.
+                if (collNss.isOplog()) {
+                    log() << "openCatalog: updating cached oplog pointer";
+                    repl::establishOplogCollectionForLogging(opCtx, collection);
+                }
             }
         }
     }
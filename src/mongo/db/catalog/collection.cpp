@@ -90,6 +90,7 @@ std::string CompactOptions::toString() const {
     }
 
     ss << " validateDocuments: " << validateDocuments;
+    ss << " online: " << online;
 
     return ss.str();
 }
@@ -30,6 +30,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <string>
 
 #include "mongo/base/shim.h"
@@ -60,6 +61,7 @@
 
 namespace mongo {
 class CollectionCatalogEntry;
+class CollectionZoneMap;
 class DatabaseCatalogEntry;
 class ExtentManager;
 class IndexCatalog;
@@ -83,6 +85,11 @@ struct CompactOptions {
     // other
     bool validateDocuments = true;
 
+    // online compaction only holds intent locks, and compacts in steps of at most 'stepTimeout'
+    // (0 means unbounded) which the storage engine reports as ExceededTimeLimit when cut short
+    bool online = false;
+    Seconds stepTimeout{0};
+
     std::string toString() const;
 
     unsigned computeRecordSize(unsigned recordSize) const {
@@ -119,6 +126,10 @@ struct CollectionUpdateArgs {
     // True if this update comes from a chunk migration.
     bool fromMigrate = false;
 
+    // If set, the paths modified by the update which might be indexed. Only the indexes whose keys
+    // depend on one of these paths are updated. If null, every index is updated.
+    const std::set<FieldRef>* modifiedIndexedPaths = nullptr;
+
     StoreDocOption storeDocOption = StoreDocOption::None;
 };
 
@@ -223,6 +234,8 @@ public:
 
         virtual CursorManager* getCursorManager() const = 0;
 
+        virtual const CollectionZoneMap* getZoneMap() const = 0;
+
         virtual bool requiresIdIndex() const = 0;
 
         virtual Snapshotted<BSONObj> docFor(OperationContext* opCtx, const RecordId& loc) const = 0;
@@ -242,6 +255,13 @@ public:
                                     bool noWarn,
                                     StoreDeletedDoc storeDeletedDoc) = 0;
 
+        virtual void deleteDocuments(OperationContext* opCtx,
+                                     StmtId stmtId,
+                                     const std::vector<RecordId>& locs,
+                                     OpDebug* opDebug,
+                                     bool fromMigrate,
+                                     bool noWarn) = 0;
+
         virtual Status insertDocuments(OperationContext* opCtx,
                                        std::vector<InsertStatement>::const_iterator begin,
                                        std::vector<InsertStatement>::const_iterator end,
@@ -417,6 +437,14 @@ public:
         return this->_impl().getCursorManager();
     }
 
+    /**
+     * Returns the per-block min/max summaries used to skip blocks during collection scans, or
+     * nullptr if the collection was not created with a 'zoneMap' option.
+     */
+    inline const CollectionZoneMap* getZoneMap() const {
+        return this->_impl().getZoneMap();
+    }
+
     inline bool requiresIdIndex() const {
         return this->_impl().requiresIdIndex();
     }
@@ -463,6 +491,23 @@ public:
             opCtx, stmtId, loc, opDebug, fromMigrate, noWarn, storeDeletedDoc);
     }
 
+    /**
+     * Deletes the documents with the given RecordIds from the collection, as if by calling
+     * deleteDocument() for each in turn within the caller's WriteUnitOfWork. The index keys of all
+     * the documents are removed together, in index order, before the records are deleted and the
+     * deletes are logged one document at a time.
+     *
+     * The parameters are as for deleteDocument(). The deleted documents are not stored.
+     */
+    inline void deleteDocuments(OperationContext* const opCtx,
+                                StmtId stmtId,
+                                const std::vector<RecordId>& locs,
+                                OpDebug* const opDebug,
+                                const bool fromMigrate = false,
+                                const bool noWarn = false) {
+        return this->_impl().deleteDocuments(opCtx, stmtId, locs, opDebug, fromMigrate, noWarn);
+    }
+
     /*
      * Inserts all documents inside one WUOW.
      * Caller should ensure vector is appropriately sized for this.
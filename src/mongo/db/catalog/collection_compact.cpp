@@ -42,11 +42,84 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/write_concern_options.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 
 namespace {
+
+// The longest an online compaction works on one table before yielding to the throttle checks.
+MONGO_EXPORT_SERVER_PARAMETER(onlineCompactionStepSecs, int, 10)
+    ->withValidator([](const int& newValue) {
+        if (newValue < 1) {
+            return Status(ErrorCodes::BadValue, "onlineCompactionStepSecs must be at least 1");
+        }
+        return Status::OK();
+    });
+
+// Between steps, an online compaction on a primary waits until a majority of the replica set is
+// within this many milliseconds of the primary's last applied write.
+MONGO_EXPORT_SERVER_PARAMETER(onlineCompactionMaxReplicationLagMillis, int, 10 * 1000)
+    ->withValidator([](const int& newValue) {
+        if (newValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "onlineCompactionMaxReplicationLagMillis must be at least 1");
+        }
+        return Status::OK();
+    });
+
+/**
+ * Blocks between two steps of an online compaction while the storage engine cache is under
+ * pressure, or while the secondaries of a primary lag too far behind, so that compaction only
+ * uses spare capacity. Throws if the operation is interrupted.
+ */
+void waitForOnlineCompactionCapacity(OperationContext* opCtx) {
+    StorageEngine* storageEngine = opCtx->getServiceContext()->getStorageEngine();
+    repl::ReplicationCoordinator* replCoord = repl::ReplicationCoordinator::get(opCtx);
+
+    while (true) {
+        opCtx->checkForInterrupt();
+
+        if (storageEngine->isCacheUnderPressure(opCtx)) {
+            LOG(1) << "online compaction waiting for cache pressure to drop";
+            opCtx->sleepFor(Seconds(1));
+            continue;
+        }
+
+        if (!replCoord->getMemberState().primary())
+            return;
+
+        const WriteConcernOptions majority(
+            WriteConcernOptions::kMajority,
+            WriteConcernOptions::SyncMode::UNSET,
+            Milliseconds(onlineCompactionMaxReplicationLagMillis.load()));
+        const Status status =
+            replCoord->awaitReplication(opCtx, replCoord->getMyLastAppliedOpTime(), majority)
+                .status;
+        if (status != ErrorCodes::WriteConcernFailed) {
+            uassertStatusOK(status);
+            return;
+        }
+        LOG(1) << "online compaction waiting for replication to catch up";
+    }
+}
+
+/**
+ * Runs 'compactStep' until it finishes, waiting for capacity between steps which ran out of time.
+ */
+Status runCompactionSteps(OperationContext* opCtx, const stdx::function<Status()>& compactStep) {
+    while (true) {
+        Status status = compactStep();
+        if (status != ErrorCodes::ExceededTimeLimit)
+            return status;
+        waitForOnlineCompactionCapacity(opCtx);
+    }
+}
+
 class MyCompactAdaptor : public RecordStoreCompactAdaptor {
 public:
     MyCompactAdaptor(Collection* collection, MultiIndexBlock* indexBlock)
@@ -77,7 +150,11 @@ private:
 
 StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
                                                  const CompactOptions* compactOptions) {
-    dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_X));
+    if (compactOptions->online) {
+        dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
+    } else {
+        dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_X));
+    }
 
     DisableDocumentValidation validationDisabler(opCtx);
 
@@ -87,6 +164,16 @@ StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
                                             << "cannot compact collection with record store: "
                                             << _recordStore->name());
 
+    if (compactOptions->online) {
+        if (!_recordStore->compactsInPlace()) {
+            return StatusWith<CompactStats>(
+                ErrorCodes::CommandNotSupported,
+                str::stream() << "cannot compact online with record store: "
+                              << _recordStore->name());
+        }
+        return _compactOnline(opCtx, *compactOptions);
+    }
+
     if (_recordStore->compactsInPlace()) {
         CompactStats stats;
         Status status = _recordStore->compact(opCtx, NULL, compactOptions, &stats);
@@ -100,7 +187,7 @@ StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
             IndexAccessMethod* index = _indexCatalog->getIndex(descriptor);
 
             LOG(1) << "compacting index: " << descriptor->toString();
-            Status status = index->compact(opCtx);
+            Status status = index->compact(opCtx, compactOptions);
             if (!status.isOK()) {
                 error() << "failed to compact index: " << descriptor->toString();
                 return status;
@@ -182,4 +269,33 @@ StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
     return StatusWith<CompactStats>(stats);
 }
 
+StatusWith<CompactStats> CollectionImpl::_compactOnline(OperationContext* opCtx,
+                                                        const CompactOptions& compactOptions) {
+    CompactOptions stepOptions = compactOptions;
+    stepOptions.stepTimeout = Seconds(onlineCompactionStepSecs.load());
+
+    CompactStats stats;
+    Status status = runCompactionSteps(
+        opCtx, [&] { return _recordStore->compact(opCtx, NULL, &stepOptions, &stats); });
+    if (!status.isOK())
+        return StatusWith<CompactStats>(status);
+
+    // Compact all indexes (not including unfinished indexes)
+    IndexCatalog::IndexIterator ii(_indexCatalog->getIndexIterator(opCtx, false));
+    while (ii.more()) {
+        IndexDescriptor* descriptor = ii.next();
+        IndexAccessMethod* index = _indexCatalog->getIndex(descriptor);
+
+        LOG(1) << "compacting index online: " << descriptor->toString();
+        Status status =
+            runCompactionSteps(opCtx, [&] { return index->compact(opCtx, &stepOptions); });
+        if (!status.isOK()) {
+            error() << "failed to compact index: " << descriptor->toString();
+            return status;
+        }
+    }
+
+    return StatusWith<CompactStats>(stats);
+}
+
 }  // namespace mongo
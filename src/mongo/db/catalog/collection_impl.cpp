@@ -34,9 +34,12 @@
 
 #include "mongo/db/catalog/collection_impl.h"
 
+#include <algorithm>
+
 #include "mongo/base/counter.h"
 #include "mongo/base/init.h"
 #include "mongo/base/owned_pointer_map.h"
+#include "mongo/bson/bsonobj_field_index.h"
 #include "mongo/bson/ordering.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
@@ -133,6 +136,27 @@ std::unique_ptr<CollatorInterface> parseCollation(OperationContext* opCtx,
 
     return std::move(collator.getValue());
 }
+
+// Builds the zone map described by the 'zoneMap' collection option. Returns null if there is no
+// such option, or if the record store cannot guarantee that newly inserted records sort after
+// existing ones, which the zone map relies on.
+std::unique_ptr<CollectionZoneMap> makeZoneMap(const CollectionOptions& options,
+                                               const RecordStore* recordStore) {
+    if (options.zoneMap.isEmpty() || recordStore->isCapped() ||
+        !recordStore->isInRecordIdOrder()) {
+        return {nullptr};
+    }
+    return std::make_unique<CollectionZoneMap>(options.zoneMap);
+}
+
+// Returns the form of 'validator' which documents are checked against, or null if there is no
+// validator.
+std::unique_ptr<CompiledMatchExpression> compileValidator(const MatchExpression* validator) {
+    if (!validator) {
+        return {nullptr};
+    }
+    return std::make_unique<CompiledMatchExpression>(validator);
+}
 }  // namespace
 
 using std::endl;
@@ -162,11 +186,13 @@ CollectionImpl::CollectionImpl(Collection* _this_init,
       _validatorDoc(_details->getCollectionOptions(opCtx).validator.getOwned()),
       _validator(uassertStatusOK(
           parseValidator(opCtx, _validatorDoc, MatchExpressionParser::kAllowAllSpecialFeatures))),
+      _compiledValidator(compileValidator(_validator.get())),
       _validationAction(uassertStatusOK(
           parseValidationAction(_details->getCollectionOptions(opCtx).validationAction))),
       _validationLevel(uassertStatusOK(
           parseValidationLevel(_details->getCollectionOptions(opCtx).validationLevel))),
       _cursorManager(_ns),
+      _zoneMap(makeZoneMap(_details->getCollectionOptions(opCtx), _recordStore)),
       _cappedNotifier(_recordStore->isCapped() ? stdx::make_unique<CappedInsertNotifier>()
                                                : nullptr),
       _this(_this_init) {}
@@ -206,6 +232,11 @@ bool CollectionImpl::requiresIdIndex() const {
         return false;
     }
 
+    if (_recordStore->isClusteredOnId()) {
+        // The records are keyed by _id, so the record store already serves as the _id index.
+        return false;
+    }
+
     if (_ns.isSystem()) {
         StringData shortName = _ns.coll().substr(_ns.coll().find('.') + 1);
         if (shortName == "indexes" || shortName == "namespaces" || shortName == "profile") {
@@ -247,7 +278,7 @@ Status CollectionImpl::checkValidation(OperationContext* opCtx, const BSONObj& d
     if (documentValidationDisabled(opCtx))
         return Status::OK();
 
-    if (_validator->matchesBSON(document))
+    if (_compiledValidator->matchesBSON(document))
         return Status::OK();
 
     if (_validationAction == ValidationAction::WARN) {
@@ -346,7 +377,13 @@ Status CollectionImpl::insertDocuments(OperationContext* opCtx,
     // Should really be done in the collection object at creation and updated on index create.
     const bool hasIdIndex = _indexCatalog->findIdIndex(opCtx);
 
+    // Validation, key generation for every index and the op observer all extract fields from the
+    // same documents, so let them share a field index per document.
+    BSONObjFieldIndex::Scope fieldIndexes;
+
     for (auto it = begin; it != end; it++) {
+        fieldIndexes.attach(it->doc);
+
         if (hasIdIndex && it->doc["_id"].eoo()) {
             return Status(ErrorCodes::InternalError,
                           str::stream()
@@ -431,6 +468,10 @@ Status CollectionImpl::insertDocument(OperationContext* opCtx,
     if (!loc.isOK())
         return loc.getStatus();
 
+    if (_zoneMap) {
+        _zoneMap->noteInsert(loc.getValue(), doc);
+    }
+
     for (auto&& indexBlock : indexBlocks) {
         Status status = indexBlock->insert(doc, loc.getValue());
         if (!status.isOK()) {
@@ -506,6 +547,10 @@ Status CollectionImpl::_insertDocuments(OperationContext* opCtx,
 
         BsonRecord bsonRecord = {loc, Timestamp(it->oplogSlot.opTime.getTimestamp()), &(it->doc)};
         bsonRecords.push_back(bsonRecord);
+
+        if (_zoneMap) {
+            _zoneMap->noteInsert(loc, it->doc);
+        }
     }
 
     int64_t keysInserted;
@@ -579,6 +624,42 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
         opCtx, ns(), uuid(), stmtId, fromMigrate, deletedDoc);
 }
 
+void CollectionImpl::deleteDocuments(OperationContext* opCtx,
+                                     StmtId stmtId,
+                                     const std::vector<RecordId>& locs,
+                                     OpDebug* opDebug,
+                                     bool fromMigrate,
+                                     bool noWarn) {
+    if (isCapped()) {
+        log() << "failing remove on a capped ns " << _ns;
+        uasserted(51023, "cannot remove from a capped collection");
+    }
+
+    std::vector<Snapshotted<BSONObj>> docs;
+    docs.reserve(locs.size());
+    std::vector<BsonRecord> bsonRecords;
+    bsonRecords.reserve(locs.size());
+    for (auto&& loc : locs) {
+        docs.push_back(docFor(opCtx, loc));
+        bsonRecords.push_back({loc, Timestamp(), &docs.back().value()});
+    }
+
+    int64_t keysDeleted;
+    _indexCatalog->unindexRecords(opCtx, bsonRecords, noWarn, &keysDeleted);
+    if (opDebug) {
+        opDebug->additiveMetrics.incrementKeysDeleted(keysDeleted);
+    }
+
+    // The op observer carries state from aboutToDelete() to onDelete(), so each document is
+    // observed, deleted and logged before the next.
+    auto opObserver = getGlobalServiceContext()->getOpObserver();
+    for (size_t i = 0; i < locs.size(); ++i) {
+        opObserver->aboutToDelete(opCtx, ns(), docs[i].value());
+        _recordStore->deleteRecord(opCtx, locs[i]);
+        opObserver->onDelete(opCtx, ns(), uuid(), stmtId, fromMigrate, boost::none);
+    }
+}
+
 Counter64 moveCounter;
 ServerStatusMetricField<Counter64> moveCounterDisplay("record.moves", &moveCounter);
 
@@ -649,6 +730,21 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            // Skip generating keys for an index which does not depend on any modified path, since
+            // its keys cannot have changed.
+            if (args->modifiedIndexedPaths) {
+                const UpdateIndexData* indexedPaths =
+                    _infoCache.getIndexKeysForIndex(opCtx, descriptor->indexName());
+                if (indexedPaths &&
+                    std::none_of(args->modifiedIndexedPaths->begin(),
+                                 args->modifiedIndexedPaths->end(),
+                                 [&](const FieldRef& path) {
+                                     return indexedPaths->mightBeIndexed(path);
+                                 })) {
+                    continue;
+                }
+            }
+
             InsertDeleteOptions options;
             _indexCatalog->prepareInsertDeleteOptions(opCtx, descriptor, &options);
             UpdateTicket* updateTicket = new UpdateTicket();
@@ -665,6 +761,10 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
 
     args->preImageDoc = oldDoc.value().getOwned();
 
+    if (_zoneMap) {
+        _zoneMap->noteUpdate(oldLocation, newDoc);
+    }
+
     Status updateStatus =
         _recordStore->updateRecord(opCtx, oldLocation, newDoc.objdata(), newDoc.objsize());
 
@@ -675,10 +775,14 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
             IndexDescriptor* descriptor = ii.next();
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            auto updateTicket = updateTickets.mutableMap().find(descriptor);
+            if (updateTicket == updateTickets.mutableMap().end()) {
+                continue;
+            }
+
             int64_t keysInserted;
             int64_t keysDeleted;
-            uassertStatusOK(iam->update(
-                opCtx, *updateTickets.mutableMap()[descriptor], &keysInserted, &keysDeleted));
+            uassertStatusOK(iam->update(opCtx, *updateTicket->second, &keysInserted, &keysDeleted));
             if (opDebug) {
                 opDebug->additiveMetrics.incrementKeysInserted(keysInserted);
                 opDebug->additiveMetrics.incrementKeysDeleted(keysDeleted);
@@ -720,6 +824,10 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
     if (newRecStatus.isOK()) {
         args->updatedDoc = newRecStatus.getValue().toBson();
 
+        if (_zoneMap) {
+            _zoneMap->noteUpdate(loc, args->updatedDoc);
+        }
+
         invariant(uuid());
         OplogUpdateEntryArgs entryArgs(*args, ns(), *uuid());
         getGlobalServiceContext()->getOpObserver()->onUpdate(opCtx, entryArgs);
@@ -836,12 +944,15 @@ Status CollectionImpl::setValidator(OperationContext* opCtx, BSONObj validatorDo
     opCtx->recoveryUnit()->onRollback([
         this,
         oldValidator = std::move(_validator),
+        oldCompiledValidator = std::move(_compiledValidator),
         oldValidatorDoc = std::move(_validatorDoc)
     ]() mutable {
         this->_validator = std::move(oldValidator);
+        this->_compiledValidator = std::move(oldCompiledValidator);
         this->_validatorDoc = std::move(oldValidatorDoc);
     });
     _validator = std::move(statusWithMatcher.getValue());
+    _compiledValidator = compileValidator(_validator.get());
     _validatorDoc = std::move(validatorDoc);
     return Status::OK();
 }
@@ -943,11 +1054,13 @@ Status CollectionImpl::updateValidator(OperationContext* opCtx,
     opCtx->recoveryUnit()->onRollback([
         this,
         oldValidator = std::move(_validator),
+        oldCompiledValidator = std::move(_compiledValidator),
         oldValidatorDoc = std::move(_validatorDoc),
         oldValidationLevel = _validationLevel,
         oldValidationAction = _validationAction
     ]() mutable {
         this->_validator = std::move(oldValidator);
+        this->_compiledValidator = std::move(oldCompiledValidator);
         this->_validatorDoc = std::move(oldValidatorDoc);
         this->_validationLevel = oldValidationLevel;
         this->_validationAction = oldValidationAction;
@@ -962,6 +1075,7 @@ Status CollectionImpl::updateValidator(OperationContext* opCtx,
         return validatorSW.getStatus();
     }
     _validator = std::move(validatorSW.getValue());
+    _compiledValidator = compileValidator(_validator.get());
 
     auto levelSW = parseValidationLevel(newLevel);
     if (!levelSW.isOK()) {
@@ -31,8 +31,10 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
+#include "mongo/db/catalog/collection_zone_map.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 
 namespace mongo {
 class IndexConsistency;
@@ -102,6 +104,10 @@ public:
         return &_cursorManager;
     }
 
+    const CollectionZoneMap* getZoneMap() const final {
+        return _zoneMap.get();
+    }
+
     bool requiresIdIndex() const final;
 
     Snapshotted<BSONObj> docFor(OperationContext* opCtx, const RecordId& loc) const final {
@@ -144,6 +150,17 @@ public:
         bool noWarn = false,
         Collection::StoreDeletedDoc storeDeletedDoc = Collection::StoreDeletedDoc::Off) final;
 
+    /**
+     * Deletes the documents at 'locs' within the caller's WriteUnitOfWork, removing their index
+     * keys one index at a time in key order.
+     */
+    void deleteDocuments(OperationContext* opCtx,
+                         StmtId stmtId,
+                         const std::vector<RecordId>& locs,
+                         OpDebug* opDebug,
+                         bool fromMigrate = false,
+                         bool noWarn = false) final;
+
     /*
      * Inserts all documents inside one WUOW.
      * Caller should ensure vector is appropriately sized for this.
@@ -386,6 +403,12 @@ private:
                             std::vector<InsertStatement>::const_iterator end,
                             OpDebug* opDebug);
 
+    /**
+     * Compacts the record store and then each index in bounded steps, only holding intent locks.
+     */
+    StatusWith<CompactStats> _compactOnline(OperationContext* opCtx,
+                                            const CompactOptions& compactOptions);
+
     int _magic;
 
     const NamespaceString _ns;
@@ -410,6 +433,9 @@ private:
     // Points into _validatorDoc. Null means no filter.
     std::unique_ptr<MatchExpression> _validator;
 
+    // Compiled from _validator, which it points into. Null exactly when _validator is.
+    std::unique_ptr<CompiledMatchExpression> _compiledValidator;
+
     ValidationAction _validationAction;
     ValidationLevel _validationLevel;
 
@@ -418,6 +444,10 @@ private:
     // should be about the data.
     mutable CursorManager _cursorManager;
 
+    // Per-block min/max summaries of the fields named by the 'zoneMap' collection option. Null if
+    // the option is absent or the record store does not return records in RecordId order.
+    const std::unique_ptr<CollectionZoneMap> _zoneMap;
+
     // Notifier object for awaitData. Threads polling a capped collection for new data can wait
     // on this object until notified of the arrival of new data.
     //
@@ -38,6 +38,7 @@
 namespace mongo {
 class Collection;
 class IndexDescriptor;
+class IndexHistogram;
 class OperationContext;
 
 /**
@@ -56,8 +57,17 @@ public:
 
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
+        virtual const UpdateIndexData* getIndexKeysForIndex(OperationContext* opCtx,
+                                                            StringData indexName) const = 0;
+
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
 
+        virtual std::shared_ptr<const IndexHistogram> getIndexHistogram(
+            StringData indexName) const = 0;
+
+        virtual void setIndexHistogram(StringData indexName,
+                                       std::shared_ptr<const IndexHistogram> histogram) = 0;
+
         virtual void init(OperationContext* opCtx) = 0;
 
         virtual void addedIndex(OperationContext* opCtx, const IndexDescriptor* desc) = 0;
@@ -110,6 +120,15 @@ public:
         return this->_impl().getIndexKeys(opCtx);
     }
 
+    /**
+     * Returns the paths which the keys of the index 'indexName' depend on, or nullptr if they are
+     * not known, in which case any update may change the index's keys.
+     */
+    inline const UpdateIndexData* getIndexKeysForIndex(OperationContext* const opCtx,
+                                                       const StringData indexName) const {
+        return this->_impl().getIndexKeysForIndex(opCtx, indexName);
+    }
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -121,6 +140,25 @@ public:
         return this->_impl().getIndexUsageStats();
     }
 
+    /**
+     * Returns the histogram the analyze command last gathered for the index 'indexName', or
+     * nullptr if the index has not been analyzed since the collection was loaded.
+     */
+    inline std::shared_ptr<const IndexHistogram> getIndexHistogram(
+        const StringData indexName) const {
+        return this->_impl().getIndexHistogram(indexName);
+    }
+
+    /**
+     * Sets the histogram the planner uses to estimate scans of the index 'indexName', and clears
+     * the plan cache, whose plans were chosen without it. Requires an intent lock on the
+     * collection.
+     */
+    inline void setIndexHistogram(const StringData indexName,
+                                  std::shared_ptr<const IndexHistogram> histogram) {
+        return this->_impl().setIndexHistogram(indexName, std::move(histogram));
+    }
+
     /**
      * Register a newly-created index with the cache.  Must be called whenever an index is
      * built on the associated collection.
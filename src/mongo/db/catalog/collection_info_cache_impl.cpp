@@ -73,6 +73,81 @@ CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
     }
 }
 
+namespace {
+
+/**
+ * Adds the paths which the keys of the index described by 'descriptor' and 'entry' depend on to
+ * 'indexedPaths'.
+ */
+void addIndexedPaths(const IndexDescriptor* descriptor,
+                     const IndexCatalogEntry* entry,
+                     UpdateIndexData* indexedPaths) {
+    if (descriptor->getAccessMethodName() == IndexNames::WILDCARD) {
+        // Obtain the projection used by the $** index's key generator.
+        auto pathProj = WildcardKeyGenerator::createProjectionExec(
+            descriptor->keyPattern(), descriptor->pathProjection());
+        // If the projection is an exclusion, then we must check the new document's keys on all
+        // updates, since we do not exhaustively know the set of paths to be indexed.
+        if (pathProj->getType() == ProjectionExecAgg::ProjectionType::kExclusionProjection) {
+            indexedPaths->allPathsIndexed();
+        } else {
+            // If a subtree was specified in the keyPattern, or if an inclusion projection is
+            // present, then we need only index the path(s) preserved by the projection.
+            for (const auto& path : pathProj->getExhaustivePaths()) {
+                indexedPaths->addPath(path);
+            }
+        }
+        // The regular fields of a compound $** index are indexed in addition to the paths
+        // preserved by the projection.
+        for (auto&& keyElem : descriptor->keyPattern()) {
+            const auto fieldName = keyElem.fieldNameStringData();
+            if (!WildcardKeyGenerator::isWildcardFieldName(fieldName)) {
+                indexedPaths->addPath(FieldRef(fieldName));
+            }
+        }
+    } else if (descriptor->getAccessMethodName() == IndexNames::TEXT) {
+        fts::FTSSpec ftsSpec(descriptor->infoObj());
+
+        if (ftsSpec.wildcard()) {
+            indexedPaths->allPathsIndexed();
+        } else {
+            for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
+                indexedPaths->addPath(FieldRef(ftsSpec.extraBefore(i)));
+            }
+            for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
+                 it != ftsSpec.weights().end();
+                 ++it) {
+                indexedPaths->addPath(FieldRef(it->first));
+            }
+            for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
+                indexedPaths->addPath(FieldRef(ftsSpec.extraAfter(i)));
+            }
+            // Any update to a path containing "language" as a component could change the
+            // language of a subdocument.  Add the override field as a path component.
+            indexedPaths->addPathComponent(ftsSpec.languageOverrideField());
+        }
+    } else {
+        BSONObj key = descriptor->keyPattern();
+        BSONObjIterator j(key);
+        while (j.more()) {
+            BSONElement e = j.next();
+            indexedPaths->addPath(FieldRef(e.fieldName()));
+        }
+    }
+
+    // handle partial indexes
+    const MatchExpression* filter = entry->getFilterExpression();
+    if (filter) {
+        stdx::unordered_set<std::string> paths;
+        QueryPlannerIXSelect::getFields(filter, &paths);
+        for (auto it = paths.begin(); it != paths.end(); ++it) {
+            indexedPaths->addPath(FieldRef(*it));
+        }
+    }
+}
+
+}  // namespace
+
 const UpdateIndexData& CollectionInfoCacheImpl::getIndexKeys(OperationContext* opCtx) const {
     // This requires "some" lock, and MODE_IS is an expression for that, for now.
     dassert(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
@@ -80,8 +155,17 @@ const UpdateIndexData& CollectionInfoCacheImpl::getIndexKeys(OperationContext* o
     return _indexedPaths;
 }
 
+const UpdateIndexData* CollectionInfoCacheImpl::getIndexKeysForIndex(OperationContext* opCtx,
+                                                                     StringData indexName) const {
+    dassert(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
+    invariant(_keysComputed);
+    auto it = _indexedPathsByIndex.find(indexName);
+    return it == _indexedPathsByIndex.end() ? nullptr : &it->second;
+}
+
 void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
     _indexedPaths.clear();
+    _indexedPathsByIndex.clear();
 
     bool hadTTLIndex = _hasTTLIndex;
     _hasTTLIndex = false;
@@ -89,66 +173,16 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
     IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(opCtx, true);
     while (i.more()) {
         IndexDescriptor* descriptor = i.next();
+        const IndexCatalogEntry* entry = i.catalogEntry(descriptor);
 
-        if (descriptor->getAccessMethodName() == IndexNames::WILDCARD) {
-            // Obtain the projection used by the $** index's key generator.
-            auto pathProj = WildcardKeyGenerator::createProjectionExec(
-                descriptor->keyPattern(), descriptor->pathProjection());
-            // If the projection is an exclusion, then we must check the new document's keys on all
-            // updates, since we do not exhaustively know the set of paths to be indexed.
-            if (pathProj->getType() == ProjectionExecAgg::ProjectionType::kExclusionProjection) {
-                _indexedPaths.allPathsIndexed();
-            } else {
-                // If a subtree was specified in the keyPattern, or if an inclusion projection is
-                // present, then we need only index the path(s) preserved by the projection.
-                for (const auto& path : pathProj->getExhaustivePaths()) {
-                    _indexedPaths.addPath(path);
-                }
-            }
-        } else if (descriptor->getAccessMethodName() == IndexNames::TEXT) {
-            fts::FTSSpec ftsSpec(descriptor->infoObj());
-
-            if (ftsSpec.wildcard()) {
-                _indexedPaths.allPathsIndexed();
-            } else {
-                for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                    _indexedPaths.addPath(FieldRef(ftsSpec.extraBefore(i)));
-                }
-                for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
-                     it != ftsSpec.weights().end();
-                     ++it) {
-                    _indexedPaths.addPath(FieldRef(it->first));
-                }
-                for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                    _indexedPaths.addPath(FieldRef(ftsSpec.extraAfter(i)));
-                }
-                // Any update to a path containing "language" as a component could change the
-                // language of a subdocument.  Add the override field as a path component.
-                _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
-            }
-        } else {
-            BSONObj key = descriptor->keyPattern();
-            const BSONObj& infoObj = descriptor->infoObj();
-            if (infoObj.hasField("expireAfterSeconds")) {
-                _hasTTLIndex = true;
-            }
-            BSONObjIterator j(key);
-            while (j.more()) {
-                BSONElement e = j.next();
-                _indexedPaths.addPath(FieldRef(e.fieldName()));
-            }
+        const std::string& accessMethod = descriptor->getAccessMethodName();
+        if (accessMethod != IndexNames::WILDCARD && accessMethod != IndexNames::TEXT &&
+            descriptor->infoObj().hasField("expireAfterSeconds")) {
+            _hasTTLIndex = true;
         }
 
-        // handle partial indexes
-        const IndexCatalogEntry* entry = i.catalogEntry(descriptor);
-        const MatchExpression* filter = entry->getFilterExpression();
-        if (filter) {
-            stdx::unordered_set<std::string> paths;
-            QueryPlannerIXSelect::getFields(filter, &paths);
-            for (auto it = paths.begin(); it != paths.end(); ++it) {
-                _indexedPaths.addPath(FieldRef(*it));
-            }
-        }
+        addIndexedPaths(descriptor, entry, &_indexedPaths);
+        addIndexedPaths(descriptor, entry, &_indexedPathsByIndex[descriptor->indexName()]);
     }
 
     TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
@@ -239,6 +273,9 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
 
     rebuildIndexData(opCtx);
     _indexUsageTracker.unregisterIndex(indexName);
+
+    stdx::lock_guard<stdx::mutex> lk(_histogramsMutex);
+    _histograms.erase(indexName);
 }
 
 void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
@@ -252,4 +289,24 @@ void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
 CollectionIndexUsageMap CollectionInfoCacheImpl::getIndexUsageStats() const {
     return _indexUsageTracker.getUsageStats();
 }
+
+std::shared_ptr<const IndexHistogram> CollectionInfoCacheImpl::getIndexHistogram(
+    StringData indexName) const {
+    if (!_hasHistograms.load()) {
+        return nullptr;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_histogramsMutex);
+    auto it = _histograms.find(indexName);
+    return it == _histograms.end() ? nullptr : it->second;
+}
+
+void CollectionInfoCacheImpl::setIndexHistogram(StringData indexName,
+                                                std::shared_ptr<const IndexHistogram> histogram) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_histogramsMutex);
+        _histograms[indexName] = std::move(histogram);
+        _hasHistograms.store(true);
+    }
+    clearQueryCache();
+}
 }  // namespace mongo
@@ -35,6 +35,9 @@
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -67,6 +70,13 @@ public:
     */
     const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const;
 
+    /**
+     * Returns the paths which the keys of the index 'indexName' depend on, or nullptr if they are
+     * not known.
+     */
+    const UpdateIndexData* getIndexKeysForIndex(OperationContext* opCtx,
+                                                StringData indexName) const;
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -76,6 +86,10 @@ public:
      */
     CollectionIndexUsageMap getIndexUsageStats() const;
 
+    std::shared_ptr<const IndexHistogram> getIndexHistogram(StringData indexName) const;
+
+    void setIndexHistogram(StringData indexName, std::shared_ptr<const IndexHistogram> histogram);
+
     /**
      * Builds internal cache state based on the current state of the Collection's IndexCatalog
      */
@@ -124,6 +138,7 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    StringMap<UpdateIndexData> _indexedPathsByIndex;
 
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
@@ -136,6 +151,13 @@ private:
     CollectionIndexUsageTracker _indexUsageTracker;
 
     bool _hasTTLIndex = false;
+
+    // The histograms gathered by the analyze command, by index name. The command sets them under
+    // an intent lock, so they are guarded by '_histogramsMutex', which planning only takes once
+    // '_hasHistograms' is set.
+    mutable stdx::mutex _histogramsMutex;
+    StringMap<std::shared_ptr<const IndexHistogram>> _histograms;
+    AtomicWord<bool> _hasHistograms{false};
 };
 
 }  // namespace mongo
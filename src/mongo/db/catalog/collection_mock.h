@@ -98,6 +98,10 @@ public:
         std::abort();
     }
 
+    const CollectionZoneMap* getZoneMap() const {
+        return nullptr;
+    }
+
     bool requiresIdIndex() const {
         std::abort();
     }
@@ -124,6 +128,15 @@ public:
         std::abort();
     }
 
+    void deleteDocuments(OperationContext* opCtx,
+                         StmtId stmtId,
+                         const std::vector<RecordId>& locs,
+                         OpDebug* opDebug,
+                         bool fromMigrate,
+                         bool noWarn) {
+        std::abort();
+    }
+
     Status insertDocuments(OperationContext* opCtx,
                            std::vector<InsertStatement>::const_iterator begin,
                            std::vector<InsertStatement>::const_iterator end,
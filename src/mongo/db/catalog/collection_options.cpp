@@ -33,6 +33,7 @@
 #include <algorithm>
 
 #include "mongo/base/string_data.h"
+#include "mongo/db/catalog/collection_zone_map.h"
 #include "mongo/db/command_generic_argument.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
@@ -93,6 +94,39 @@ Status checkStorageEngineOptions(const BSONElement& elem) {
     return Status::OK();
 }
 
+// Checks the shape of a 'materializedView' option. The stages of its pipeline are checked when the
+// collection is created, by MaterializedView::parse().
+Status checkMaterializedViewSpec(const BSONObj& spec) {
+    bool hasOn = false;
+    bool hasPipeline = false;
+    for (auto&& elem : spec) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "on") {
+            if (elem.type() != mongo::String || elem.valueStringData().empty()) {
+                return {ErrorCodes::BadValue,
+                        "'materializedView.on' has to be a non-empty string."};
+            }
+            hasOn = true;
+        } else if (fieldName == "pipeline") {
+            if (elem.type() != mongo::Array) {
+                return {ErrorCodes::BadValue, "'materializedView.pipeline' has to be an array."};
+            }
+            hasPipeline = true;
+        } else {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "'materializedView." << fieldName
+                                  << "' is not a valid materialized view option."};
+        }
+    }
+
+    if (!hasOn || !hasPipeline) {
+        return {ErrorCodes::BadValue,
+                "'materializedView' requires both 'on' and 'pipeline' to be specified."};
+    }
+
+    return Status::OK();
+}
+
 }  // namespace
 
 bool CollectionOptions::isView() const {
@@ -228,6 +262,30 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             }
 
             collation = e.Obj().getOwned();
+        } else if (fieldName == "zoneMap") {
+            if (e.type() != mongo::Object) {
+                return Status(ErrorCodes::BadValue, "'zoneMap' has to be a document.");
+            }
+
+            auto status = CollectionZoneMap::validateSpec(e.Obj());
+            if (!status.isOK()) {
+                return status;
+            }
+
+            zoneMap = e.Obj().getOwned();
+        } else if (fieldName == "clusteredOnId") {
+            clusteredOnId = e.trueValue();
+        } else if (fieldName == "materializedView") {
+            if (e.type() != mongo::Object) {
+                return Status(ErrorCodes::BadValue, "'materializedView' has to be a document.");
+            }
+
+            auto status = checkMaterializedViewSpec(e.Obj());
+            if (!status.isOK()) {
+                return status;
+            }
+
+            materializedView = e.Obj().getOwned();
         } else if (fieldName == "viewOn") {
             if (e.type() != mongo::String) {
                 return Status(ErrorCodes::BadValue, "'viewOn' has to be a string.");
@@ -266,6 +324,33 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (!materializedView.isEmpty() && (capped || !viewOn.empty() || clusteredOnId)) {
+        return Status(ErrorCodes::BadValue,
+                      "'materializedView' cannot be specified for a capped or clustered collection "
+                      "or a view");
+    }
+
+    if (!zoneMap.isEmpty() && capped) {
+        return Status(ErrorCodes::BadValue,
+                      "'zoneMap' cannot be specified for a capped collection");
+    }
+
+    if (clusteredOnId) {
+        if (capped || !viewOn.empty()) {
+            return Status(ErrorCodes::BadValue,
+                          "'clusteredOnId' cannot be specified for a capped collection or a view");
+        }
+        if (!zoneMap.isEmpty()) {
+            // The zone map relies on records being inserted in increasing RecordId order.
+            return Status(ErrorCodes::BadValue,
+                          "'clusteredOnId' and 'zoneMap' cannot be specified together");
+        }
+        if (!idIndex.isEmpty()) {
+            return Status(ErrorCodes::BadValue,
+                          "'idIndex' cannot be specified for a collection clustered on _id");
+        }
+    }
+
     return Status::OK();
 }
 
@@ -326,6 +411,18 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
         builder->append("collation", collation);
     }
 
+    if (!zoneMap.isEmpty()) {
+        builder->append("zoneMap", zoneMap);
+    }
+
+    if (clusteredOnId) {
+        builder->appendBool("clusteredOnId", true);
+    }
+
+    if (!materializedView.isEmpty()) {
+        builder->append("materializedView", materializedView);
+    }
+
     if (!viewOn.empty()) {
         builder->append("viewOn", viewOn);
     }
@@ -415,6 +512,18 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (zoneMap.woCompare(other.zoneMap) != 0) {
+        return false;
+    }
+
+    if (clusteredOnId != other.clusteredOnId) {
+        return false;
+    }
+
+    if (materializedView.woCompare(other.materializedView) != 0) {
+        return false;
+    }
+
     if (viewOn != other.viewOn) {
         return false;
     }
@@ -143,6 +143,19 @@ struct CollectionOptions {
     // The namespace's default collation.
     BSONObj collation;
 
+    // The fields summarized per block of RecordIds by the collection's zone map, which collection
+    // scans use to skip blocks. See CollectionZoneMap. Always owned or empty.
+    BSONObj zoneMap;
+
+    // If true, the records of the collection are keyed by their integral _id instead of by a
+    // RecordId chosen by the storage engine, and the collection has no separate _id index.
+    bool clusteredOnId = false;
+
+    // If set, the collection is a materialized view: {on: <collection>, pipeline: [<stages>]}. Its
+    // contents are the results of the pipeline over the collection 'on', and are kept up to date
+    // as that collection is written. See MaterializedView. Always owned or empty.
+    BSONObj materializedView;
+
     // View-related options.
     // The namespace of the view or collection that "backs" this view, or the empty string if this
     // collection is not a view.
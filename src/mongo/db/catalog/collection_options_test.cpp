@@ -81,6 +81,58 @@ TEST(CollectionOptions, Validator) {
     ASSERT(!defaultOptions.toBSON()["validator"]);
 }
 
+TEST(CollectionOptions, ZoneMap) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{zoneMap: {fields: ['ts'], blockSize: 64}}")));
+    ASSERT_BSONOBJ_EQ(options.zoneMap, fromjson("{fields: ['ts'], blockSize: 64}"));
+    ASSERT_BSONOBJ_EQ(options.toBSON()["zoneMap"].Obj(), options.zoneMap);
+    ASSERT_FALSE(options.matchesStorageOptions(CollectionOptions(), nullptr));
+
+    ASSERT_NOT_OK(CollectionOptions().parse(fromjson("{zoneMap: 1}")));
+    ASSERT_NOT_OK(CollectionOptions().parse(fromjson("{zoneMap: {fields: []}}")));
+    ASSERT_NOT_OK(CollectionOptions().parse(
+        fromjson("{capped: true, size: 1024, zoneMap: {fields: ['a']}}")));
+
+    CollectionOptions defaultOptions;
+    ASSERT(!defaultOptions.toBSON()["zoneMap"]);
+}
+
+TEST(CollectionOptions, ClusteredOnId) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{clusteredOnId: true}")));
+    ASSERT(options.clusteredOnId);
+    ASSERT_BSONOBJ_EQ(options.toBSON(), fromjson("{clusteredOnId: true}"));
+    ASSERT_FALSE(options.matchesStorageOptions(CollectionOptions(), nullptr));
+
+    ASSERT_NOT_OK(
+        CollectionOptions().parse(fromjson("{clusteredOnId: true, capped: true, size: 1024}")));
+    ASSERT_NOT_OK(
+        CollectionOptions().parse(fromjson("{clusteredOnId: true, zoneMap: {fields: ['a']}}")));
+    ASSERT_NOT_OK(CollectionOptions().parse(
+        fromjson("{clusteredOnId: true, idIndex: {key: {_id: 1}, name: '_id_'}}"),
+        CollectionOptions::parseForCommand));
+
+    ASSERT(!CollectionOptions().toBSON()["clusteredOnId"]);
+}
+
+TEST(CollectionOptions, MaterializedView) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{materializedView: {on: 'src', pipeline: [{$match: {}}]}}")));
+    ASSERT_BSONOBJ_EQ(options.materializedView, fromjson("{on: 'src', pipeline: [{$match: {}}]}"));
+    ASSERT_BSONOBJ_EQ(options.toBSON()["materializedView"].Obj(), options.materializedView);
+    ASSERT_FALSE(options.matchesStorageOptions(CollectionOptions(), nullptr));
+
+    ASSERT_NOT_OK(CollectionOptions().parse(fromjson("{materializedView: 1}")));
+    ASSERT_NOT_OK(CollectionOptions().parse(fromjson("{materializedView: {on: 'src'}}")));
+    ASSERT_NOT_OK(CollectionOptions().parse(fromjson("{materializedView: {pipeline: []}}")));
+    ASSERT_NOT_OK(
+        CollectionOptions().parse(fromjson("{materializedView: {on: '', pipeline: []}}")));
+    ASSERT_NOT_OK(CollectionOptions().parse(
+        fromjson("{materializedView: {on: 'src', pipeline: [], other: 1}}")));
+    ASSERT_NOT_OK(CollectionOptions().parse(
+        fromjson("{capped: true, size: 1024, materializedView: {on: 'src', pipeline: []}}")));
+}
+
 TEST(CollectionOptions, ErrorBadSize) {
     ASSERT_NOT_OK(CollectionOptions().parse(fromjson("{capped: true, size: -1}")));
     ASSERT_NOT_OK(CollectionOptions().parse(fromjson("{capped: false, size: -1}")));
@@ -0,0 +1,344 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection_zone_map.h"
+
+#include <algorithm>
+
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/text.h"
+
+namespace mongo {
+
+const long long CollectionZoneMap::kDefaultBlockSize = 1024;
+
+namespace {
+
+const long long kMaxBlockSize = 1LL << 30;
+
+/**
+ * Returns true if comparing against 'operand' has the same outcome for every value of a type
+ * whether or not a collation is in effect, and does not involve the array or null special cases of
+ * the match language, so that the bounds of a block can be used to rule out matches.
+ */
+bool isPrunableOperand(const BSONElement& operand) {
+    switch (operand.type()) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case NumberDecimal:
+        case Date:
+        case bsonTimestamp:
+        case jstOID:
+        case Bool:
+        case BinData:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Compares the values of 'lhs' and 'rhs' in BSON order, ignoring their field names and any
+ * collation.
+ */
+int compareElements(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false, nullptr);
+}
+
+/**
+ * Stores 'elem' as the single element of an owned object with an empty field name.
+ */
+BSONObj makeBound(const BSONElement& elem) {
+    BSONObjBuilder bob;
+    bob.appendAs(elem, "");
+    return bob.obj();
+}
+
+}  // namespace
+
+Status CollectionZoneMap::validateSpec(const BSONObj& spec) {
+    bool hasFields = false;
+    for (auto&& elem : spec) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "fields") {
+            if (elem.type() != Array) {
+                return {ErrorCodes::TypeMismatch, "'zoneMap.fields' has to be an array."};
+            }
+
+            std::vector<std::string> paths;
+            for (auto&& pathElem : elem.Obj()) {
+                if (pathElem.type() != String || pathElem.valueStringData().empty()) {
+                    return {ErrorCodes::BadValue,
+                            "'zoneMap.fields' has to be an array of non-empty strings."};
+                }
+
+                const auto path = pathElem.str();
+                if (path[0] == '$' || path.find("..") != std::string::npos ||
+                    path.front() == '.' || path.back() == '.') {
+                    return {ErrorCodes::BadValue,
+                            str::stream() << "Invalid path in 'zoneMap.fields': " << path};
+                }
+                if (std::find(paths.begin(), paths.end(), path) != paths.end()) {
+                    return {ErrorCodes::BadValue,
+                            str::stream() << "Duplicate path in 'zoneMap.fields': " << path};
+                }
+                paths.push_back(path);
+            }
+
+            if (paths.empty()) {
+                return {ErrorCodes::BadValue, "'zoneMap.fields' cannot be empty."};
+            }
+            hasFields = true;
+        } else if (fieldName == "blockSize") {
+            if (!elem.isNumber() || elem.numberLong() <= 0 || elem.numberLong() > kMaxBlockSize ||
+                elem.numberDouble() != static_cast<double>(elem.numberLong())) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "'zoneMap.blockSize' has to be an integer between 1 and "
+                                      << kMaxBlockSize};
+            }
+        } else {
+            return {ErrorCodes::InvalidOptions,
+                    str::stream() << "The field '" << fieldName
+                                  << "' is not a valid zoneMap option."};
+        }
+    }
+
+    if (!hasFields) {
+        return {ErrorCodes::BadValue, "'zoneMap' requires 'fields'."};
+    }
+    return Status::OK();
+}
+
+CollectionZoneMap::CollectionZoneMap(const BSONObj& spec) {
+    invariant(validateSpec(spec));
+
+    for (auto&& pathElem : spec["fields"].Obj()) {
+        _fields.push_back(pathElem.str());
+        _fieldParts.push_back(StringSplitter::split(_fields.back(), "."));
+    }
+
+    if (auto blockSize = spec["blockSize"]) {
+        _blockSize = blockSize.numberLong();
+    }
+}
+
+void CollectionZoneMap::noteInsert(const RecordId& id, const BSONObj& doc) {
+    const long long block = blockFor(id);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_firstBlock) {
+        _firstBlock = block;
+    }
+
+    Zone& zone = _zones[block];
+    if (zone.ranges.empty()) {
+        zone.firstId = id;
+        zone.ranges.resize(_fields.size());
+    } else if (id < zone.firstId) {
+        zone.firstId = id;
+    }
+    widen(&zone, doc);
+}
+
+void CollectionZoneMap::noteUpdate(const RecordId& id, const BSONObj& doc) {
+    const long long block = blockFor(id);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_firstBlock || block <= *_firstBlock) {
+        return;
+    }
+
+    // Every document in a block after the first was inserted while the zone map was watching.
+    auto it = _zones.find(block);
+    invariant(it != _zones.end());
+    widen(&it->second, doc);
+}
+
+void CollectionZoneMap::widen(Zone* zone, const BSONObj& doc) const {
+    // A missing field is summarized as null, which no prunable operand is equal to.
+    static const BSONObj kNull = BSON("" << BSONNULL);
+    for (size_t i = 0; i < _fieldParts.size(); ++i) {
+        const auto& parts = _fieldParts[i];
+        BSONObj current = doc;
+        BSONElement value;
+        bool sawArray = false;
+        for (size_t j = 0; j < parts.size(); ++j) {
+            value = current[parts[j]];
+            if (value.type() == Array) {
+                sawArray = true;
+                break;
+            }
+            if (j + 1 < parts.size()) {
+                if (value.type() != Object) {
+                    value = BSONElement();
+                    break;
+                }
+                current = value.Obj();
+            }
+        }
+
+        FieldRange& range = zone->ranges[i];
+        if (sawArray) {
+            range.hasArray = true;
+            continue;
+        }
+        if (value.eoo()) {
+            value = kNull.firstElement();
+        }
+        if (range.min.isEmpty() || compareElements(value, range.min.firstElement()) < 0) {
+            range.min = makeBound(value);
+        }
+        if (range.max.isEmpty() || compareElements(value, range.max.firstElement()) > 0) {
+            range.max = makeBound(value);
+        }
+    }
+}
+
+bool CollectionZoneMap::canSkipBlock(const RecordId& id,
+                                     const MatchExpression* filter,
+                                     RecordId* nextStart) const {
+    invariant(filter);
+    const long long block = blockFor(id);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_firstBlock || block <= *_firstBlock) {
+        return false;
+    }
+
+    auto it = _zones.find(block);
+    if (it == _zones.end() || mayMatch(it->second, filter)) {
+        return false;
+    }
+
+    for (++it; it != _zones.end(); ++it) {
+        if (mayMatch(it->second, filter)) {
+            *nextStart = it->second.firstId;
+            return true;
+        }
+    }
+
+    *nextStart = RecordId();
+    return true;
+}
+
+size_t CollectionZoneMap::numBlocks() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _zones.size();
+}
+
+boost::optional<size_t> CollectionZoneMap::fieldIndex(StringData path) const {
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        if (path == _fields[i]) {
+            return i;
+        }
+    }
+    return boost::none;
+}
+
+bool CollectionZoneMap::mayMatch(const Zone& zone, const MatchExpression* expr) const {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!mayMatch(zone, expr->getChild(i))) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::OR:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (mayMatch(zone, expr->getChild(i))) {
+                    return true;
+                }
+            }
+            return expr->numChildren() == 0;
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::MATCH_IN:
+            break;
+        default:
+            return true;
+    }
+
+    const auto index = fieldIndex(expr->path());
+    if (!index) {
+        return true;
+    }
+    const FieldRange& range = zone.ranges[*index];
+    if (range.hasArray || range.min.isEmpty()) {
+        return true;
+    }
+    const BSONElement min = range.min.firstElement();
+    const BSONElement max = range.max.firstElement();
+
+    const auto inRange = [&](const BSONElement& operand) {
+        return compareElements(operand, min) >= 0 && compareElements(operand, max) <= 0;
+    };
+
+    if (expr->matchType() == MatchExpression::MATCH_IN) {
+        const auto* in = static_cast<const InMatchExpression*>(expr);
+        if (!in->getRegexes().empty()) {
+            return true;
+        }
+        for (auto&& equality : in->getEqualities()) {
+            if (!isPrunableOperand(equality) || inRange(equality)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const BSONElement& operand = static_cast<const ComparisonMatchExpression*>(expr)->getData();
+    if (!isPrunableOperand(operand)) {
+        return true;
+    }
+
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+            return inRange(operand);
+        case MatchExpression::LT:
+            return compareElements(min, operand) < 0;
+        case MatchExpression::LTE:
+            return compareElements(min, operand) <= 0;
+        case MatchExpression::GT:
+            return compareElements(max, operand) > 0;
+        case MatchExpression::GTE:
+            return compareElements(max, operand) >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class MatchExpression;
+
+/**
+ * An in-memory zone map for a collection: the minimum and maximum value of a few selected fields
+ * across each block of 'blockSize' consecutive RecordIds. A forward collection scan can consult it
+ * to skip over whole blocks which cannot contain a document matching its filter.
+ *
+ * The bounds of a block only ever widen. They are widened for every document which is inserted or
+ * updated, before the write commits, so they always include the values of every version of every
+ * document in the block which a reader can see. Deletes and aborted writes leave the bounds wider
+ * than necessary, which is safe.
+ *
+ * The zone map is not persisted. It only knows about the documents written since it was created,
+ * so it never reports that a block at or before the one holding the first inserted RecordId it was
+ * told about can be skipped. This relies on the record store handing out increasing RecordIds to
+ * inserts, so that every later block only holds documents the zone map has seen. That holds for
+ * the record stores which iterate in RecordId order.
+ *
+ * This class is thread-safe.
+ */
+class CollectionZoneMap {
+    MONGO_DISALLOW_COPYING(CollectionZoneMap);
+
+public:
+    static const long long kDefaultBlockSize;
+
+    /**
+     * Validates the 'zoneMap' collection option, which has the form
+     *
+     *   {fields: [<path>, ...], blockSize: <number of RecordIds per block>}
+     *
+     * where 'blockSize' is optional.
+     */
+    static Status validateSpec(const BSONObj& spec);
+
+    /**
+     * Constructs a zone map from a 'zoneMap' collection option which passed validateSpec().
+     */
+    explicit CollectionZoneMap(const BSONObj& spec);
+
+    /**
+     * Widens the bounds of the block containing 'id' to include the tracked fields of 'doc', which
+     * is being inserted.
+     */
+    void noteInsert(const RecordId& id, const BSONObj& doc);
+
+    /**
+     * Widens the bounds of the block containing 'id' to include the tracked fields of 'doc', the
+     * new version of a document which is being updated in place. Updates to blocks which can never
+     * be skipped are ignored.
+     */
+    void noteUpdate(const RecordId& id, const BSONObj& doc);
+
+    /**
+     * Returns true if no document in the block containing 'id' can match 'filter'. In that case
+     * 'nextStart' is set to the lowest RecordId ever written to the next block which may contain a
+     * match, or to a null RecordId if no later block may contain one.
+     */
+    bool canSkipBlock(const RecordId& id, const MatchExpression* filter, RecordId* nextStart) const;
+
+    /**
+     * Returns the number of the block which contains 'id'.
+     */
+    long long blockFor(const RecordId& id) const {
+        return id.repr() / _blockSize;
+    }
+
+    /**
+     * Returns the number of blocks which have been written to. For testing.
+     */
+    size_t numBlocks() const;
+
+private:
+    // The values of one tracked field across a block. 'min' and 'max' hold a single element with
+    // an empty field name, and are empty until a document is noted.
+    struct FieldRange {
+        BSONObj min;
+        BSONObj max;
+
+        // Documents with an array along the path match predicates element-wise, which the bounds
+        // do not capture, so such blocks are never skipped based on this field.
+        bool hasArray = false;
+    };
+
+    struct Zone {
+        RecordId firstId;
+        std::vector<FieldRange> ranges;
+    };
+
+    /**
+     * Returns false if no document summarized by 'zone' can match 'expr'.
+     */
+    bool mayMatch(const Zone& zone, const MatchExpression* expr) const;
+
+    /**
+     * Widens 'zone' to include the tracked fields of 'doc'. 'zone' must already be sized for the
+     * tracked fields.
+     */
+    void widen(Zone* zone, const BSONObj& doc) const;
+
+    /**
+     * Returns the index of 'path' in '_fields', or boost::none if it is not tracked.
+     */
+    boost::optional<size_t> fieldIndex(StringData path) const;
+
+    // The tracked paths, and the same paths split into their components.
+    std::vector<std::string> _fields;
+    std::vector<std::vector<std::string>> _fieldParts;
+
+    long long _blockSize = kDefaultBlockSize;
+
+    mutable stdx::mutex _mutex;
+
+    // The block holding the first inserted RecordId noted. Guarded by '_mutex'.
+    boost::optional<long long> _firstBlock;
+
+    // Guarded by '_mutex'.
+    std::map<long long, Zone> _zones;
+};
+
+}  // namespace mongo
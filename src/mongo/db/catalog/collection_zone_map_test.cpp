@@ -0,0 +1,186 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection_zone_map.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parseFilter(const char* filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto result = MatchExpressionParser::parse(fromjson(filter), expCtx);
+    ASSERT_OK(result.getStatus());
+    return std::move(result.getValue());
+}
+
+/**
+ * Returns whether 'zoneMap' allows skipping the block holding 'id' under 'filter', and sets
+ * '*nextStart' as CollectionZoneMap::canSkipBlock() does.
+ */
+bool canSkip(const CollectionZoneMap& zoneMap,
+             long long id,
+             const char* filter,
+             RecordId* nextStart = nullptr) {
+    RecordId unused;
+    auto expr = parseFilter(filter);
+    return zoneMap.canSkipBlock(RecordId(id), expr.get(), nextStart ? nextStart : &unused);
+}
+
+TEST(CollectionZoneMap, ValidateSpec) {
+    ASSERT_OK(CollectionZoneMap::validateSpec(fromjson("{fields: ['a']}")));
+    ASSERT_OK(CollectionZoneMap::validateSpec(fromjson("{fields: ['a', 'b.c'], blockSize: 16}")));
+    ASSERT_OK(CollectionZoneMap::validateSpec(fromjson("{fields: ['a'], blockSize: 16.0}")));
+
+    ASSERT_EQ(ErrorCodes::BadValue, CollectionZoneMap::validateSpec(BSONObj()));
+    ASSERT_EQ(ErrorCodes::BadValue, CollectionZoneMap::validateSpec(fromjson("{fields: []}")));
+    ASSERT_EQ(ErrorCodes::TypeMismatch, CollectionZoneMap::validateSpec(fromjson("{fields: 'a'}")));
+    ASSERT_EQ(ErrorCodes::BadValue, CollectionZoneMap::validateSpec(fromjson("{fields: [1]}")));
+    ASSERT_EQ(ErrorCodes::BadValue, CollectionZoneMap::validateSpec(fromjson("{fields: ['']}")));
+    ASSERT_EQ(ErrorCodes::BadValue, CollectionZoneMap::validateSpec(fromjson("{fields: ['$a']}")));
+    ASSERT_EQ(ErrorCodes::BadValue, CollectionZoneMap::validateSpec(fromjson("{fields: ['a.']}")));
+    ASSERT_EQ(ErrorCodes::BadValue,
+              CollectionZoneMap::validateSpec(fromjson("{fields: ['a..b']}")));
+    ASSERT_EQ(ErrorCodes::BadValue,
+              CollectionZoneMap::validateSpec(fromjson("{fields: ['a', 'a']}")));
+    ASSERT_EQ(ErrorCodes::BadValue,
+              CollectionZoneMap::validateSpec(fromjson("{fields: ['a'], blockSize: 0}")));
+    ASSERT_EQ(ErrorCodes::BadValue,
+              CollectionZoneMap::validateSpec(fromjson("{fields: ['a'], blockSize: 1.5}")));
+    ASSERT_EQ(ErrorCodes::BadValue,
+              CollectionZoneMap::validateSpec(fromjson("{fields: ['a'], blockSize: 'x'}")));
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              CollectionZoneMap::validateSpec(fromjson("{fields: ['a'], foo: 1}")));
+}
+
+TEST(CollectionZoneMap, SkipsBlocksOutsideRange) {
+    CollectionZoneMap zoneMap(fromjson("{fields: ['ts'], blockSize: 10}"));
+    for (long long id = 1; id < 40; ++id) {
+        zoneMap.noteInsert(RecordId(id), BSON("ts" << id));
+    }
+    ASSERT_EQ(4U, zoneMap.numBlocks());
+
+    // The first block is never skipped.
+    ASSERT_FALSE(canSkip(zoneMap, 5, "{ts: {$gte: 100}}"));
+
+    RecordId nextStart;
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{ts: {$gte: 32}}", &nextStart));
+    ASSERT_EQ(RecordId(30), nextStart);
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{ts: {$gt: 25, $lt: 28}}", &nextStart));
+    ASSERT_EQ(RecordId(20), nextStart);
+    ASSERT_FALSE(canSkip(zoneMap, 25, "{ts: {$gt: 25, $lt: 28}}"));
+
+    // A null 'nextStart' means that no later block can match.
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{ts: {$gte: 100}}", &nextStart));
+    ASSERT(nextStart.isNull());
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{ts: 5}", &nextStart));
+    ASSERT(nextStart.isNull());
+
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: {$in: [3, 15]}}"));
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{ts: {$in: [3, 35]}}", &nextStart));
+    ASSERT_EQ(RecordId(30), nextStart);
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{$or: [{ts: 3}, {ts: 25}]}", &nextStart));
+    ASSERT_EQ(RecordId(20), nextStart);
+}
+
+TEST(CollectionZoneMap, DoesNotSkipForUnsupportedPredicates) {
+    CollectionZoneMap zoneMap(fromjson("{fields: ['ts'], blockSize: 10}"));
+    for (long long id = 1; id < 30; ++id) {
+        zoneMap.noteInsert(RecordId(id), BSON("ts" << id << "other" << id));
+    }
+
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{other: {$gte: 100}}"));
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: {$ne: 15}}"));
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: {$exists: true}}"));
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: 'a string'}"));
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: null}"));
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: {$in: [100, /a/]}}"));
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{$or: [{ts: 100}, {other: 100}]}"));
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{ts: 100, other: {$ne: 1}}"));
+}
+
+TEST(CollectionZoneMap, ArraysAndMissingFields) {
+    CollectionZoneMap zoneMap(fromjson("{fields: ['a.b'], blockSize: 10}"));
+    for (long long id = 1; id < 40; ++id) {
+        zoneMap.noteInsert(RecordId(id), BSON("a" << BSON("b" << id)));
+    }
+    zoneMap.noteInsert(RecordId(21), fromjson("{a: [{b: 100}]}"));
+    zoneMap.noteInsert(RecordId(31), fromjson("{a: {c: 1}}"));
+
+    // The block with an array along the path cannot be skipped based on that path.
+    ASSERT_FALSE(canSkip(zoneMap, 25, "{'a.b': 1000}"));
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{'a.b': 1000}"));
+
+    // A missing field is summarized as null, which sorts before numbers and so does not prevent
+    // skipping for a predicate above the largest value.
+    RecordId nextStart;
+    ASSERT_TRUE(canSkip(zoneMap, 35, "{'a.b': 100}", &nextStart));
+    ASSERT(nextStart.isNull());
+    ASSERT_FALSE(canSkip(zoneMap, 35, "{'a.b': null}"));
+}
+
+TEST(CollectionZoneMap, UpdatesWidenBounds) {
+    CollectionZoneMap zoneMap(fromjson("{fields: ['ts'], blockSize: 10}"));
+    for (long long id = 1; id < 30; ++id) {
+        zoneMap.noteInsert(RecordId(id), BSON("ts" << id));
+    }
+    ASSERT_TRUE(canSkip(zoneMap, 15, "{ts: 500}"));
+
+    zoneMap.noteUpdate(RecordId(15), BSON("ts" << 500));
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: 500}"));
+
+    // The original values stay within the bounds.
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: 12}"));
+}
+
+TEST(CollectionZoneMap, IgnoresUpdatesBeforeFirstInsertedBlock) {
+    CollectionZoneMap zoneMap(fromjson("{fields: ['ts'], blockSize: 10}"));
+
+    // Records written before the zone map was created are unknown to it.
+    zoneMap.noteUpdate(RecordId(5), BSON("ts" << 5));
+    zoneMap.noteUpdate(RecordId(15), BSON("ts" << 15));
+    ASSERT_EQ(0U, zoneMap.numBlocks());
+
+    zoneMap.noteInsert(RecordId(25), BSON("ts" << 25));
+    zoneMap.noteInsert(RecordId(35), BSON("ts" << 35));
+    zoneMap.noteUpdate(RecordId(15), BSON("ts" << 15));
+    ASSERT_EQ(2U, zoneMap.numBlocks());
+
+    ASSERT_FALSE(canSkip(zoneMap, 15, "{ts: 1000}"));
+    ASSERT_FALSE(canSkip(zoneMap, 25, "{ts: 35}"));
+    ASSERT_TRUE(canSkip(zoneMap, 35, "{ts: 25}"));
+}
+
+}  // namespace
+}  // namespace mongo
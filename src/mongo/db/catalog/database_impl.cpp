@@ -266,10 +266,14 @@ void DatabaseImpl::init(OperationContext* const opCtx) {
     list<string> collections;
     _dbEntry->getCollectionNamespaces(&collections);
 
-    for (list<string>::const_iterator it = collections.begin(); it != collections.end(); ++it) {
-        const string ns = *it;
-        NamespaceString nss(ns);
-        _collections[ns] = _getOrCreateCollectionInstance(opCtx, nss);
+    {
+        UUIDCatalog::BatchedRegistration batchedRegistration(UUIDCatalog::get(opCtx));
+        for (list<string>::const_iterator it = collections.begin(); it != collections.end();
+             ++it) {
+            const string ns = *it;
+            NamespaceString nss(ns);
+            _collections[ns] = _getOrCreateCollectionInstance(opCtx, nss);
+        }
     }
 
     // At construction time of the viewCatalog, the _collections map wasn't initialized yet, so no
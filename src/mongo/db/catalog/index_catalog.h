@@ -364,6 +364,16 @@ public:
                                const bool noWarn,
                                int64_t* const keysDeletedOut) = 0;
 
+    /**
+     * Removes the keys of every record in 'bsonRecords' from each index, one index at a time and
+     * in index key order. When 'keysDeletedOut' is not null, it will be set to the number of index
+     * keys removed by this operation.
+     */
+    virtual void unindexRecords(OperationContext* const opCtx,
+                                const std::vector<BsonRecord>& bsonRecords,
+                                const bool noWarn,
+                                int64_t* const keysDeletedOut) = 0;
+
     virtual std::string getAccessMethodName(const BSONObj& keyPattern) = 0;
 
     /**
@@ -35,6 +35,7 @@
 #include <vector>
 
 #include "mongo/base/init.h"
+#include "mongo/bson/bsonobj_field_index.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/audit.h"
@@ -583,7 +584,7 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
 
     const bool isSparse = spec["sparse"].trueValue();
 
-    if (pluginName == IndexNames::WILDCARD) {
+    if (pluginName == IndexNames::WILDCARD || pluginName == IndexNames::COLUMNSTORE) {
         if (isSparse) {
             return Status(ErrorCodes::CannotCreateIndex,
                           str::stream() << "Index type '" << pluginName
@@ -603,6 +604,14 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
         }
     }
 
+    // A columnstore index has a row entry for every document, which its scans rely on to find all
+    // of the documents in the collection.
+    if (pluginName == IndexNames::COLUMNSTORE && spec.getField("partialFilterExpression")) {
+        return Status(ErrorCodes::CannotCreateIndex,
+                      str::stream() << "Index type '" << pluginName
+                                    << "' does not support the partialFilterExpression option");
+    }
+
     // Ensure if there is a filter, its valid.
     BSONElement filterElement = spec.getField("partialFilterExpression");
     if (filterElement) {
@@ -1221,6 +1230,21 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    // A batch of documents, such as the documents cloned by a chunk migration, is merged into the
+    // index in key order rather than document by document.
+    if (bsonRecords.size() > 1) {
+        int64_t inserted;
+        Status status =
+            index->accessMethod()->insertRecords(opCtx, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
@@ -1293,6 +1317,32 @@ Status IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexCatalogImpl::_unindexRecords(OperationContext* opCtx,
+                                         IndexCatalogEntry* index,
+                                         const std::vector<BsonRecord>& bsonRecords,
+                                         bool logIfError,
+                                         int64_t* keysDeletedOut) {
+    InsertDeleteOptions options;
+    prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
+    options.logIfError = logIfError;
+
+    // As in _unindexRecord(), blind deletes are disabled for in-progress indexes.
+    options.dupsAllowed = options.dupsAllowed || !index->isReady(opCtx);
+
+    int64_t removed;
+    Status status = index->accessMethod()->removeRecords(opCtx, bsonRecords, options, &removed);
+
+    if (!status.isOK()) {
+        log() << "Couldn't unindex " << bsonRecords.size() << " records from collection "
+              << _collection->ns() << ". Status: " << redact(status);
+    }
+
+    if (keysDeletedOut) {
+        *keysDeletedOut += removed;
+    }
+
+    return Status::OK();
+}
 
 Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
                                       const std::vector<BsonRecord>& bsonRecords,
@@ -1320,6 +1370,9 @@ void IndexCatalogImpl::unindexRecord(OperationContext* opCtx,
         *keysDeletedOut = 0;
     }
 
+    BSONObjFieldIndex::Scope fieldIndexes;
+    fieldIndexes.attach(obj);
+
     for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
          ++i) {
         IndexCatalogEntry* entry = i->get();
@@ -1330,6 +1383,25 @@ void IndexCatalogImpl::unindexRecord(OperationContext* opCtx,
     }
 }
 
+void IndexCatalogImpl::unindexRecords(OperationContext* opCtx,
+                                      const std::vector<BsonRecord>& bsonRecords,
+                                      bool noWarn,
+                                      int64_t* keysDeletedOut) {
+    if (keysDeletedOut) {
+        *keysDeletedOut = 0;
+    }
+
+    for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
+         ++i) {
+        IndexCatalogEntry* entry = i->get();
+
+        // If it's a background index, we DO NOT want to log anything.
+        bool logIfError = entry->isReady(opCtx) ? !noWarn : false;
+        _unindexRecords(opCtx, entry, bsonRecords, logIfError, keysDeletedOut)
+            .transitional_ignore();
+    }
+}
+
 std::unique_ptr<IndexCatalog::IndexBuildBlockInterface> IndexCatalogImpl::createIndexBuildBlock(
     OperationContext* opCtx, const BSONObj& spec) {
     return std::make_unique<IndexBuildBlock>(opCtx, _collection, this, spec);
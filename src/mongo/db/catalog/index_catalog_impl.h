@@ -319,6 +319,11 @@ public:
                        bool noWarn,
                        int64_t* keysDeletedOut) override;
 
+    void unindexRecords(OperationContext* opCtx,
+                        const std::vector<BsonRecord>& bsonRecords,
+                        bool noWarn,
+                        int64_t* keysDeletedOut) override;
+
     inline std::string getAccessMethodName(const BSONObj& keyPattern) override {
         return _getAccessMethodName(keyPattern);
     }
@@ -370,6 +375,12 @@ private:
                           bool logIfError,
                           int64_t* keysDeletedOut);
 
+    Status _unindexRecords(OperationContext* opCtx,
+                           IndexCatalogEntry* index,
+                           const std::vector<BsonRecord>& bsonRecords,
+                           bool logIfError,
+                           int64_t* keysDeletedOut);
+
     /**
      * this does no sanity checks
      */
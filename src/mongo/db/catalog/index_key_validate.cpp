@@ -37,6 +37,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/exec/projection_exec_agg.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/wildcard_key_generator.h"
@@ -103,6 +104,72 @@ static const std::set<StringData> allowedIdIndexFieldNames = {
     IndexDescriptor::kNamespaceFieldName,
     // Index creation under legacy writeMode can result in an index spec with an _id field.
     "_id"};
+
+/**
+ * Checks that the regular fields of a compound wildcard key pattern cannot overlap with any path
+ * indexed by its wildcard component, since a single document field must map to exactly one
+ * component of each index key.
+ */
+Status validateCompoundWildcardIndex(const BSONObj& keyPattern, const BSONObj& pathProjection) {
+    const auto wildcardFieldPos = WildcardKeyGenerator::getWildcardFieldPos(keyPattern);
+    const auto wildcardFieldName = keyPattern[wildcardFieldPos].fieldNameStringData();
+
+    std::unique_ptr<ProjectionExecAgg> projExec;
+    if (wildcardFieldName == "$**"_sd) {
+        if (pathProjection.isEmpty()) {
+            return {ErrorCodes::CannotCreateIndex,
+                    str::stream() << "A compound '" << IndexNames::WILDCARD
+                                  << "' index on all paths requires a '"
+                                  << IndexDescriptor::kPathProjectionFieldName
+                                  << "' which excludes its other fields"};
+        }
+        try {
+            projExec = WildcardKeyGenerator::createProjectionExec(keyPattern, pathProjection);
+        } catch (const DBException& ex) {
+            return ex.toStatus(str::stream() << "Failed to parse: "
+                                             << IndexDescriptor::kPathProjectionFieldName);
+        }
+    }
+
+    const FieldRef subtreePath(
+        projExec ? StringData()
+                 : wildcardFieldName.substr(0,
+                                            wildcardFieldName.size() -
+                                                WildcardKeyGenerator::kSubtreeSuffix.size()));
+
+    for (auto&& keyElem : keyPattern) {
+        const auto fieldName = keyElem.fieldNameStringData();
+        if (WildcardKeyGenerator::isWildcardFieldName(fieldName)) {
+            continue;
+        }
+
+        const FieldRef regularPath(fieldName);
+        bool overlaps = false;
+        if (!projExec) {
+            overlaps = subtreePath.isPrefixOfOrEqualTo(regularPath) ||
+                regularPath.isPrefixOf(subtreePath);
+        } else if (projExec->getType() ==
+                   ProjectionExecAgg::ProjectionType::kInclusionProjection) {
+            for (auto&& includedPath : projExec->getExhaustivePaths()) {
+                overlaps = overlaps || includedPath.isPrefixOfOrEqualTo(regularPath) ||
+                    regularPath.isPrefixOf(includedPath);
+            }
+        } else {
+            overlaps = projExec->applyProjectionToOneField(fieldName);
+        }
+
+        if (overlaps) {
+            return {ErrorCodes::CannotCreateIndex,
+                    str::stream() << "The field '" << fieldName
+                                  << "' of a compound wildcard index overlaps with the paths "
+                                     "indexed by its wildcard component '"
+                                  << wildcardFieldName
+                                  << "'"};
+        }
+    }
+
+    return Status::OK();
+}
 }
 
 Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion indexVersion) {
@@ -121,6 +188,8 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
                 code, mongoutils::str::stream() << "Unknown index plugin '" << pluginName << '\'');
     }
 
+    size_t numWildcardFields = 0;
+    size_t numHashedFields = 0;
     BSONObjIterator it(key);
     while (it.more()) {
         BSONElement keyElement = it.next();
@@ -135,7 +204,7 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
                                           << static_cast<int>(indexVersion)};
                 }
 
-                if (pluginName == IndexNames::WILDCARD) {
+                if (pluginName == IndexNames::WILDCARD || pluginName == IndexNames::COLUMNSTORE) {
                     return {code,
                             str::stream() << "'" << pluginName
                                           << "' index plugin is not allowed with index version v:"
@@ -176,10 +245,43 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
                                         << "' index must be a non-zero number, not a string.");
         }
 
-        // Check if the wildcard index is compounded. If it is the key is invalid because
-        // compounded wildcard indexes are disallowed.
-        if (pluginName == IndexNames::WILDCARD && key.nFields() != 1) {
-            return Status(code, "wildcard indexes do not allow compounding");
+        // Each field of a columnstore index is stored as a separate column, which holds the whole
+        // value of a top-level field. The _id of each document is always stored, so it cannot be
+        // listed as a column.
+        if (pluginName == IndexNames::COLUMNSTORE) {
+            if (keyElement.type() != String) {
+                return Status(code,
+                              str::stream() << "Every field of a '" << IndexNames::COLUMNSTORE
+                                            << "' index must have the value '"
+                                            << IndexNames::COLUMNSTORE
+                                            << "'");
+            }
+            if (keyElement.fieldNameStringData().find('.') != std::string::npos) {
+                return Status(code,
+                              str::stream() << "The fields of a '" << IndexNames::COLUMNSTORE
+                                            << "' index must be top-level fields");
+            }
+            if (keyElement.fieldNameStringData() == "_id") {
+                return Status(code,
+                              str::stream() << "A '" << IndexNames::COLUMNSTORE
+                                            << "' index always stores _id, so it cannot be a "
+                                               "column of the index");
+            }
+        }
+
+        // A wildcard index may be compounded with regular fields, but it may contain only one
+        // wildcard component.
+        if (pluginName == IndexNames::WILDCARD &&
+            WildcardKeyGenerator::isWildcardFieldName(keyElement.fieldNameStringData()) &&
+            ++numWildcardFields > 1) {
+            return Status(code, "wildcard indexes may contain only one wildcard component");
+        }
+
+        // A hashed index may be compounded with ascending or descending fields, but only one of its
+        // fields may be hashed.
+        if (keyElement.type() == String && keyElement.str() == IndexNames::HASHED &&
+            ++numHashedFields > 1) {
+            return Status(code, "A hashed index may contain only one hashed field");
         }
 
         // Ensure that the fields on which we are building the index are valid: a field must not
@@ -457,6 +559,16 @@ StatusWith<BSONObj> validateIndexSpec(
                               << "' field is a required property of an index specification"};
     }
 
+    const auto keyPattern = indexSpec.getObjectField(IndexDescriptor::kKeyPatternFieldName);
+    if (IndexNames::findPluginName(keyPattern) == IndexNames::WILDCARD &&
+        keyPattern.nFields() > 1) {
+        auto compoundWildcardStatus = validateCompoundWildcardIndex(
+            keyPattern, indexSpec.getObjectField(IndexDescriptor::kPathProjectionFieldName));
+        if (!compoundWildcardStatus.isOK()) {
+            return compoundWildcardStatus;
+        }
+    }
+
     if (hasCollationField && *resolvedIndexVersion < IndexVersion::kV2) {
         return {ErrorCodes::CannotCreateIndex,
                 str::stream() << "Invalid index specification " << indexSpec
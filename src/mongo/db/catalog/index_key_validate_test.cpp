@@ -281,9 +281,22 @@ TEST(IndexKeyValidateTest, KeyElementNameWildcardFailsOnSubPathRepeat) {
     ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
 }
 
-TEST(IndexKeyValidateTest, KeyElementNameWildcardFailsOnCompound) {
+TEST(IndexKeyValidateTest, KeyElementNameWildcardSucceedsOnCompound) {
     TestCommandQueryKnobGuard guard;
-    auto status = validateKeyPattern(BSON("$**" << 1 << "a" << 1), IndexVersion::kV2);
+    ASSERT_OK(validateKeyPattern(BSON("$**" << 1 << "a" << 1), IndexVersion::kV2));
+    ASSERT_OK(validateKeyPattern(BSON("a" << 1 << "b.$**" << 1 << "c" << 1), IndexVersion::kV2));
+}
+
+TEST(IndexKeyValidateTest, KeyElementNameWildcardFailsOnCompoundWithTwoWildcardComponents) {
+    TestCommandQueryKnobGuard guard;
+    auto status = validateKeyPattern(BSON("a.$**" << 1 << "b.$**" << 1), IndexVersion::kV2);
+    ASSERT_NOT_OK(status);
+    ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
+}
+
+TEST(IndexKeyValidateTest, CompoundWildcardIndexFailsIfRegularFieldIsNotPositive) {
+    TestCommandQueryKnobGuard guard;
+    auto status = validateKeyPattern(BSON("a" << -1 << "b.$**" << 1), IndexVersion::kV2);
     ASSERT_NOT_OK(status);
     ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
 }
@@ -315,6 +328,66 @@ TEST(IndexKeyValidateTest, KeyElementNameWildcardFailsWhenValueIsPluginNameWithV
     ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
 }
 
+TEST(IndexKeyValidateTest, HashedIndexSucceedsOnCompound) {
+    ASSERT_OK(validateKeyPattern(BSON("a"
+                                      << "hashed"
+                                      << "b"
+                                      << 1),
+                                 IndexVersion::kV2));
+    ASSERT_OK(validateKeyPattern(BSON("a" << -1 << "b"
+                                          << "hashed"
+                                          << "c"
+                                          << 1),
+                                 IndexVersion::kV2));
+}
+
+TEST(IndexKeyValidateTest, HashedIndexFailsWithTwoHashedFields) {
+    auto status = validateKeyPattern(BSON("a"
+                                          << "hashed"
+                                          << "b"
+                                          << "hashed"),
+                                     IndexVersion::kV2);
+    ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
+}
+
+TEST(IndexKeyValidateTest, ColumnStoreIndexSucceedsOnTopLevelFields) {
+    ASSERT_OK(validateKeyPattern(BSON("a"
+                                      << "columnstore"
+                                      << "b"
+                                      << "columnstore"),
+                                 IndexVersion::kV2));
+}
+
+TEST(IndexKeyValidateTest, ColumnStoreIndexFailsOnDottedField) {
+    auto status = validateKeyPattern(BSON("a.b"
+                                          << "columnstore"),
+                                     IndexVersion::kV2);
+    ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
+}
+
+TEST(IndexKeyValidateTest, ColumnStoreIndexFailsOnIdField) {
+    auto status = validateKeyPattern(BSON("_id"
+                                          << "columnstore"),
+                                     IndexVersion::kV2);
+    ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
+}
+
+TEST(IndexKeyValidateTest, ColumnStoreIndexFailsWhenCompoundedWithRegularField) {
+    auto status = validateKeyPattern(BSON("a"
+                                          << "columnstore"
+                                          << "b"
+                                          << 1),
+                                     IndexVersion::kV2);
+    ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
+}
+
+TEST(IndexKeyValidateTest, ColumnStoreIndexFailsForV1Indexes) {
+    auto status = validateKeyPattern(BSON("a"
+                                          << "columnstore"),
+                                     IndexVersion::kV1);
+    ASSERT_EQ(status, ErrorCodes::CannotCreateIndex);
+}
+
 }  // namespace
 
 }  // namespace mongo
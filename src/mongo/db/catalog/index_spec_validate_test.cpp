@@ -977,6 +977,83 @@ TEST(IndexSpecWildcard, FailsWithEmptyProjection) {
     ASSERT_EQ(result.getStatus().code(), ErrorCodes::FailedToParse);
 }
 
+TEST(IndexSpecWildcard, SucceedsOnCompoundSubpath) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("tenantId" << 1 << "attrs.$**" << 1 << "ts"
+                                                                  << 1)
+                                               << "name"
+                                               << "indexName"),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_OK(result.getStatus());
+}
+
+TEST(IndexSpecWildcard, FailsOnCompoundSubpathWhenRegularFieldOverlaps) {
+    TestCommandFcvGuard guard;
+    for (auto&& regularField : {"attrs", "attrs.x", "attrs.x.y"}) {
+        auto result = validateIndexSpec(
+            kDefaultOpCtx,
+            BSON("key" << BSON(regularField << 1 << "attrs.x.$**" << 1) << "name"
+                       << "indexName"),
+            kTestNamespace,
+            serverGlobalParams.featureCompatibility);
+        ASSERT_EQ(result.getStatus().code(), ErrorCodes::CannotCreateIndex);
+    }
+}
+
+TEST(IndexSpecWildcard, FailsOnCompoundAllPathsWithoutProjection) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a" << 1 << "$**" << 1) << "name"
+                                               << "indexName"),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_EQ(result.getStatus().code(), ErrorCodes::CannotCreateIndex);
+}
+
+TEST(IndexSpecWildcard, SucceedsOnCompoundAllPathsWhenProjectionExcludesRegularFields) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a" << 1 << "$**" << 1) << "name"
+                                               << "indexName"
+                                               << "wildcardProjection"
+                                               << BSON("a" << 0)),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_OK(result.getStatus());
+
+    result = validateIndexSpec(kDefaultOpCtx,
+                               BSON("key" << BSON("a" << 1 << "$**" << 1) << "name"
+                                          << "indexName"
+                                          << "wildcardProjection"
+                                          << BSON("b" << 1 << "c.d" << 1)),
+                               kTestNamespace,
+                               serverGlobalParams.featureCompatibility);
+    ASSERT_OK(result.getStatus());
+}
+
+TEST(IndexSpecWildcard, FailsOnCompoundAllPathsWhenProjectionIncludesRegularField) {
+    TestCommandFcvGuard guard;
+    auto result = validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("a.b" << 1 << "$**" << 1) << "name"
+                                               << "indexName"
+                                               << "wildcardProjection"
+                                               << BSON("c" << 0)),
+                                    kTestNamespace,
+                                    serverGlobalParams.featureCompatibility);
+    ASSERT_EQ(result.getStatus().code(), ErrorCodes::CannotCreateIndex);
+
+    result = validateIndexSpec(kDefaultOpCtx,
+                               BSON("key" << BSON("a.b" << 1 << "$**" << 1) << "name"
+                                          << "indexName"
+                                          << "wildcardProjection"
+                                          << BSON("a" << 1)),
+                               kTestNamespace,
+                               serverGlobalParams.featureCompatibility);
+    ASSERT_EQ(result.getStatus().code(), ErrorCodes::CannotCreateIndex);
+}
+
 TEST(IndexSpecWildcard, FailsWhenInclusionWithSubpath) {
     TestCommandFcvGuard guard;
     auto result = validateIndexSpec(kDefaultOpCtx,
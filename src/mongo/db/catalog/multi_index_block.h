@@ -72,6 +72,12 @@ public:
      */
     virtual void allowBackgroundBuilding() = 0;
 
+    /**
+     * Call this before init() to build the indexes in the background whatever the 'background'
+     * flag in their specs says.
+     */
+    virtual void forceBackgroundBuilding() = 0;
+
     /**
      * Call this before init() to allow the index build to be interrupted.
      * This only affects builds using the insertAllDocumentsInCollection helper.
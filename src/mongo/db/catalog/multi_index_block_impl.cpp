@@ -134,6 +134,7 @@ MultiIndexBlockImpl::MultiIndexBlockImpl(OperationContext* opCtx, Collection* co
     : _collection(collection),
       _opCtx(opCtx),
       _buildInBackground(false),
+      _ignoreBackgroundFlags(false),
       _allowInterruption(false),
       _ignoreUnique(false),
       _needToCleanup(true) {}
@@ -224,7 +225,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         BSONObj info = indexSpecs[i];
 
         // Any foreground indexes make all indexes be built in the foreground.
-        _buildInBackground = (_buildInBackground && info["background"].trueValue());
+        _buildInBackground =
+            (_buildInBackground && (_ignoreBackgroundFlags || info["background"].trueValue()));
     }
 
     std::vector<BSONObj> indexInfoObjs;
@@ -82,6 +82,15 @@ public:
         _buildInBackground = true;
     }
 
+    /**
+     * Call this before init() to build the indexes in the background whatever the 'background'
+     * flag in their specs says.
+     */
+    void forceBackgroundBuilding() override {
+        _buildInBackground = true;
+        _ignoreBackgroundFlags = true;
+    }
+
     /**
      * Call this before init() to allow the index build to be interrupted.
      * This only affects builds using the insertAllDocumentsInCollection helper.
@@ -209,6 +218,7 @@ private:
     OperationContext* _opCtx;
 
     bool _buildInBackground;
+    bool _ignoreBackgroundFlags;
     bool _allowInterruption;
     bool _ignoreUnique;
 
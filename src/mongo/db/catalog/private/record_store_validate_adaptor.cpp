@@ -278,10 +278,11 @@ void RecordStoreValidateAdaptor::validateIndexKeyCount(IndexDescriptor* idx,
 
     // Confirm that the number of index entries is not greater than the number of documents in the
     // collection. This check is only valid for indexes that are not multikey (indexed arrays
-    // produce an index key per array entry) and not $** indexes which can produce index keys for
-    // multiple paths within a single document.
+    // produce an index key per array entry) and not $** or columnstore indexes which can produce
+    // index keys for multiple paths or columns within a single document.
     if (results.valid && !idx->isMultikey(_opCtx) &&
-        idx->getIndexType() != IndexType::INDEX_WILDCARD && totalKeys > numRecs) {
+        idx->getIndexType() != IndexType::INDEX_WILDCARD &&
+        idx->getIndexType() != IndexType::INDEX_COLUMNSTORE && totalKeys > numRecs) {
         std::string err = str::stream()
             << "index " << idx->indexName() << " is not multi-key, but has more entries ("
             << numIndexedKeys << ") than documents in the index (" << numRecs - numLongKeys << ")";
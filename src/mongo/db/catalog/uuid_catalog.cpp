@@ -42,6 +42,9 @@ namespace mongo {
 namespace {
 const ServiceContext::Decoration<UUIDCatalog> getCatalog =
     ServiceContext::declareDecoration<UUIDCatalog>();
+
+// The number of UUIDCatalog::BatchedRegistration instances alive on this thread.
+thread_local int batchedRegistrationDepth = 0;
 }  // namespace
 
 void UUIDCatalogObserver::onCreateCollection(OperationContext* opCtx,
@@ -133,6 +136,7 @@ void UUIDCatalog::onCreateCollection(OperationContext* opCtx,
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     _removeUUIDCatalogEntry_inlock(uuid);  // Remove UUID if it exists
     _registerUUIDCatalogEntry_inlock(uuid, coll);
+    _publish_inlock();
     opCtx->recoveryUnit()->onRollback([this, uuid] { removeUUIDCatalogEntry(uuid); });
 }
 
@@ -152,22 +156,28 @@ void UUIDCatalog::onRenameCollection(OperationContext* opCtx,
 }
 
 void UUIDCatalog::onCloseDatabase(Database* db) {
+    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     for (auto&& coll : *db) {
         if (coll->uuid()) {
             // While the collection does not actually get dropped, we're going to destroy the
             // Collection object, so for purposes of the UUIDCatalog it looks the same.
-            removeUUIDCatalogEntry(coll->uuid().get());
+            _removeUUIDCatalogEntry_inlock(coll->uuid().get());
         }
     }
+    _publish_inlock();
 }
 
 void UUIDCatalog::onCloseCatalog(OperationContext* opCtx) {
     invariant(opCtx->lockState()->isW());
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     invariant(!_shadowCatalog);
-    _shadowCatalog.emplace();
-    for (auto entry : _catalog)
-        _shadowCatalog->insert({entry.first, entry.second->ns()});
+    auto shadowCatalog = std::make_shared<ShadowCatalog>();
+    for (const auto& bucket : _catalog) {
+        for (auto entry : bucket)
+            shadowCatalog->insert({entry.first, entry.second->ns()});
+    }
+    _shadowCatalog = std::move(shadowCatalog);
+    _publish_inlock();
 }
 
 void UUIDCatalog::onOpenCatalog(OperationContext* opCtx) {
@@ -175,27 +185,40 @@ void UUIDCatalog::onOpenCatalog(OperationContext* opCtx) {
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     invariant(_shadowCatalog);
     _shadowCatalog.reset();
+    _publish_inlock();
 }
 
 Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    return foundIt == _catalog.end() ? nullptr : foundIt->second;
+    const auto bucket = std::atomic_load(&_publishedCatalog[_bucketFor(uuid)]);
+    if (!bucket)
+        return nullptr;
+    auto foundIt = bucket->find(uuid);
+    return foundIt == bucket->end() ? nullptr : foundIt->second;
 }
 
 NamespaceString UUIDCatalog::lookupNSSByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    if (foundIt != _catalog.end())
-        return foundIt->second->ns();
+    // The shadow catalog is published separately from the buckets. It is set before the catalog
+    // is emptied on close, and reset after the catalog has been filled again on open, so whichever
+    // way this lookup overlaps with one of those, a UUID missing from the bucket is in the shadow
+    // catalog as loaded either before or after the bucket.
+    const auto shadowCatalogBefore = std::atomic_load(&_publishedShadowCatalog);
+    const auto bucket = std::atomic_load(&_publishedCatalog[_bucketFor(uuid)]);
+    if (bucket) {
+        auto foundIt = bucket->find(uuid);
+        if (foundIt != bucket->end())
+            return foundIt->second->ns();
+    }
 
     // Only in the case that the catalog is closed and a UUID is currently unknown, resolve it
     // using the pre-close state. This ensures that any tasks reloading the catalog can see their
     // own updates.
-    if (_shadowCatalog) {
-        auto shadowIt = _shadowCatalog->find(uuid);
-        if (shadowIt != _shadowCatalog->end())
-            return shadowIt->second;
+    for (const auto& shadowCatalog :
+         {std::atomic_load(&_publishedShadowCatalog), shadowCatalogBefore}) {
+        if (shadowCatalog) {
+            auto shadowIt = shadowCatalog->find(uuid);
+            if (shadowIt != shadowCatalog->end())
+                return shadowIt->second;
+        }
     }
     return NamespaceString();
 }
@@ -206,16 +229,20 @@ Collection* UUIDCatalog::replaceUUIDCatalogEntry(CollectionUUID uuid, Collection
     Collection* oldColl = _removeUUIDCatalogEntry_inlock(uuid);
     invariant(oldColl != nullptr);  // Need to replace an existing coll
     _registerUUIDCatalogEntry_inlock(uuid, coll);
+    _publish_inlock();
     return oldColl;
 }
 void UUIDCatalog::registerUUIDCatalogEntry(CollectionUUID uuid, Collection* coll) {
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     _registerUUIDCatalogEntry_inlock(uuid, coll);
+    _publish_inlock();
 }
 
 Collection* UUIDCatalog::removeUUIDCatalogEntry(CollectionUUID uuid) {
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    return _removeUUIDCatalogEntry_inlock(uuid);
+    Collection* foundColl = _removeUUIDCatalogEntry_inlock(uuid);
+    _publish_inlock();
+    return foundColl;
 }
 
 boost::optional<CollectionUUID> UUIDCatalog::prev(const StringData& db, CollectionUUID uuid) {
@@ -243,6 +270,37 @@ boost::optional<CollectionUUID> UUIDCatalog::next(const StringData& db, Collecti
     return *(current + 1);
 }
 
+UUIDCatalog::BatchedRegistration::BatchedRegistration(UUIDCatalog& catalog) : _catalog(catalog) {
+    ++batchedRegistrationDepth;
+}
+
+UUIDCatalog::BatchedRegistration::~BatchedRegistration() {
+    if (--batchedRegistrationDepth == 0) {
+        stdx::lock_guard<stdx::mutex> lock(_catalog._catalogLock);
+        _catalog._publish_inlock();
+    }
+}
+
+size_t UUIDCatalog::_bucketFor(CollectionUUID uuid) {
+    return CollectionUUID::Hash()(uuid) % kNumBuckets;
+}
+
+void UUIDCatalog::_publish_inlock() {
+    if (batchedRegistrationDepth > 0) {
+        return;
+    }
+
+    for (size_t i = 0; _unpublishedBuckets.any() && i < kNumBuckets; ++i) {
+        if (_unpublishedBuckets[i]) {
+            std::atomic_store(&_publishedCatalog[i],
+                              std::shared_ptr<const CollectionMap>(
+                                  std::make_shared<CollectionMap>(_catalog[i])));
+            _unpublishedBuckets.reset(i);
+        }
+    }
+    std::atomic_store(&_publishedShadowCatalog, _shadowCatalog);
+}
+
 const std::vector<CollectionUUID>& UUIDCatalog::_getOrdering_inlock(
     const StringData& db, const stdx::lock_guard<stdx::mutex>&) {
     // If an ordering is already cached,
@@ -254,9 +312,11 @@ const std::vector<CollectionUUID>& UUIDCatalog::_getOrdering_inlock(
 
     // Otherwise, get all of the UUIDs for this database,
     auto& newOrdering = _orderedCollections[db];
-    for (const auto& pair : _catalog) {
-        if (pair.second->ns().db() == db) {
-            newOrdering.push_back(pair.first);
+    for (const auto& bucket : _catalog) {
+        for (const auto& pair : bucket) {
+            if (pair.second->ns().db() == db) {
+                newOrdering.push_back(pair.first);
+            }
         }
     }
 
@@ -266,18 +326,23 @@ const std::vector<CollectionUUID>& UUIDCatalog::_getOrdering_inlock(
     return newOrdering;
 }
 void UUIDCatalog::_registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collection* coll) {
-    if (coll && !_catalog.count(uuid)) {
+    const size_t bucketIndex = _bucketFor(uuid);
+    auto& bucket = _catalog[bucketIndex];
+    if (coll && !bucket.count(uuid)) {
         // Invalidate this database's ordering, since we're adding a new UUID.
         _orderedCollections.erase(coll->ns().db());
 
         std::pair<CollectionUUID, Collection*> entry = std::make_pair(uuid, coll);
         LOG(2) << "registering collection " << coll->ns() << " with UUID " << uuid.toString();
-        invariant(_catalog.insert(entry).second == true);
+        invariant(bucket.insert(entry).second == true);
+        _unpublishedBuckets.set(bucketIndex);
     }
 }
 Collection* UUIDCatalog::_removeUUIDCatalogEntry_inlock(CollectionUUID uuid) {
-    auto foundIt = _catalog.find(uuid);
-    if (foundIt == _catalog.end())
+    const size_t bucketIndex = _bucketFor(uuid);
+    auto& bucket = _catalog[bucketIndex];
+    auto foundIt = bucket.find(uuid);
+    if (foundIt == bucket.end())
         return nullptr;
 
     // Invalidate this database's ordering, since we're deleting a UUID.
@@ -285,7 +350,8 @@ Collection* UUIDCatalog::_removeUUIDCatalogEntry_inlock(CollectionUUID uuid) {
 
     auto foundCol = foundIt->second;
     LOG(2) << "unregistering collection " << foundCol->ns() << " with UUID " << uuid.toString();
-    _catalog.erase(foundIt);
+    bucket.erase(foundIt);
+    _unpublishedBuckets.set(bucketIndex);
     return foundCol;
 }
 }  // namespace mongo
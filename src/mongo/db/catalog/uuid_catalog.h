@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include <array>
+#include <bitset>
+#include <memory>
 #include <unordered_map>
 
 #include "mongo/base/disallow_copying.h"
@@ -213,20 +216,55 @@ public:
      */
     boost::optional<CollectionUUID> next(const StringData& db, CollectionUUID uuid);
 
+    /**
+     * While alive, defers making the entries this thread registers or removes visible to lookups
+     * until destruction, so that registering all collections of a database copies each part of the
+     * catalog it changes only once. Changes made by other threads in the meantime may make them
+     * visible earlier.
+     */
+    class BatchedRegistration {
+        MONGO_DISALLOW_COPYING(BatchedRegistration);
+
+    public:
+        explicit BatchedRegistration(UUIDCatalog& catalog);
+        ~BatchedRegistration();
+
+    private:
+        UUIDCatalog& _catalog;
+    };
+
 private:
+    using CollectionMap = stdx::unordered_map<CollectionUUID, Collection*, CollectionUUID::Hash>;
+    using ShadowCatalog =
+        stdx::unordered_map<CollectionUUID, NamespaceString, CollectionUUID::Hash>;
+
+    /**
+     * The catalog is split into this many buckets by the hash of the UUID. Lookups read an
+     * immutable copy of a single bucket without taking _catalogLock, and a change to the catalog
+     * only replaces the copies of the buckets it changed, rather than copying the whole catalog.
+     */
+    static constexpr size_t kNumBuckets = 256;
+
+    static size_t _bucketFor(CollectionUUID uuid);
+
+    /**
+     * Makes the current contents of the changed buckets and the shadow catalog visible to lookups,
+     * unless this thread is within a BatchedRegistration.
+     */
+    void _publish_inlock();
+
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
                                                            const stdx::lock_guard<stdx::mutex>&);
     void _registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collection* coll);
     Collection* _removeUUIDCatalogEntry_inlock(CollectionUUID uuid);
 
+    // Serializes changes to the catalog. Lookups do not take it.
     mutable mongo::stdx::mutex _catalogLock;
     /**
      * When present, indicates that the catalog is in closed state, and contains a map from UUID
      * to pre-close NSS. See also onCloseCatalog.
      */
-    boost::optional<
-        mongo::stdx::unordered_map<CollectionUUID, NamespaceString, CollectionUUID::Hash>>
-        _shadowCatalog;
+    std::shared_ptr<const ShadowCatalog> _shadowCatalog;
 
     /**
      * Map from database names to ordered `vector`s of their UUIDs.
@@ -235,7 +273,16 @@ private:
      * not all databases are guaranteed to have an ordering in it.
      */
     StringMap<std::vector<CollectionUUID>> _orderedCollections;
-    mongo::stdx::unordered_map<CollectionUUID, Collection*, CollectionUUID::Hash> _catalog;
+
+    // The buckets of the catalog as changed by writers, and which of them have changed since they
+    // were last published.
+    std::array<CollectionMap, kNumBuckets> _catalog;
+    std::bitset<kNumBuckets> _unpublishedBuckets;
+
+    // The copies of the buckets and of the shadow catalog read by lookups. A null bucket is empty.
+    // Only accessed through std::atomic_load and std::atomic_store.
+    std::array<std::shared_ptr<const CollectionMap>, kNumBuckets> _publishedCatalog;
+    std::shared_ptr<const ShadowCatalog> _publishedShadowCatalog;
 };
 
 }  // namespace mongo
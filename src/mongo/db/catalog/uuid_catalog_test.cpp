@@ -33,6 +33,7 @@
 #include "mongo/db/catalog/collection_mock.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
 
 using namespace mongo;
 
@@ -104,6 +105,52 @@ TEST_F(UUIDCatalogTest, InsertAfterLookup) {
     ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), nss);
 }
 
+TEST_F(UUIDCatalogTest, BatchedRegistrationDefersVisibilityUntilDestroyed) {
+    auto newUUID = CollectionUUID::gen();
+    NamespaceString newNss(nss.db(), "newcol");
+    Collection newCol(stdx::make_unique<CollectionMock>(newNss));
+
+    {
+        UUIDCatalog::BatchedRegistration batchedRegistration(catalog);
+        catalog.registerUUIDCatalogEntry(newUUID, &newCol);
+        catalog.removeUUIDCatalogEntry(colUUID);
+
+        // Lookups still see the catalog as it was before the batch.
+        ASSERT(catalog.lookupCollectionByUUID(newUUID) == nullptr);
+        ASSERT_EQUALS(catalog.lookupCollectionByUUID(colUUID), &col);
+    }
+
+    ASSERT_EQUALS(catalog.lookupCollectionByUUID(newUUID), &newCol);
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(newUUID), newNss);
+    ASSERT(catalog.lookupCollectionByUUID(colUUID) == nullptr);
+}
+
+TEST_F(UUIDCatalogTest, ChangesToSomeEntriesLeaveOthersVisible) {
+    // Enough collections to spread over every part of the catalog which is published separately.
+    const int numCollections = 2000;
+    std::vector<CollectionUUID> uuids;
+    std::vector<std::unique_ptr<Collection>> collections;
+    for (int i = 0; i < numCollections; ++i) {
+        uuids.push_back(CollectionUUID::gen());
+        collections.push_back(stdx::make_unique<Collection>(
+            stdx::make_unique<CollectionMock>(NamespaceString(nss.db(), str::stream() << i))));
+        catalog.onCreateCollection(&opCtx, collections.back().get(), uuids.back());
+    }
+
+    for (int i = 0; i < numCollections; i += 2) {
+        catalog.onDropCollection(&opCtx, uuids[i]);
+    }
+
+    for (int i = 0; i < numCollections; ++i) {
+        if (i % 2 == 0) {
+            ASSERT(catalog.lookupCollectionByUUID(uuids[i]) == nullptr);
+        } else {
+            ASSERT_EQUALS(catalog.lookupCollectionByUUID(uuids[i]), collections[i].get());
+        }
+    }
+    ASSERT_EQUALS(catalog.lookupCollectionByUUID(colUUID), &col);
+}
+
 TEST_F(UUIDCatalogTest, OnDropCollection) {
     catalog.onDropCollection(&opCtx, colUUID);
     // Ensure the lookup returns a null pointer upon removing the colUUID entry.
@@ -0,0 +1,242 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/query/index_histogram.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/platform/random.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultSampleSize = 10000;
+const long long kMaxSampleSize = 100000;
+const long long kDefaultNumBuckets = 100;
+const long long kMaxNumBuckets = 10000;
+
+long long parseBoundedNumber(const BSONObj& cmdObj,
+                             StringData fieldName,
+                             long long defaultValue,
+                             long long maxValue) {
+    auto elem = cmdObj[fieldName];
+    if (!elem) {
+        return defaultValue;
+    }
+    uassert(ErrorCodes::TypeMismatch,
+            str::stream() << fieldName << " must be a number",
+            elem.isNumber());
+    const long long value = elem.safeNumberLong();
+    uassert(ErrorCodes::BadValue,
+            str::stream() << fieldName << " must be between 1 and " << maxValue,
+            value >= 1 && value <= maxValue);
+    return value;
+}
+
+/**
+ * Returns up to 'sampleSize' documents of 'collection', chosen at random if it holds more.
+ */
+std::vector<BSONObj> sampleDocuments(OperationContext* opCtx,
+                                     Collection* collection,
+                                     long long sampleSize) {
+    std::vector<BSONObj> sample;
+    const RecordStore* rs = collection->getRecordStore();
+    if (rs->numRecords(opCtx) > sampleSize) {
+        if (auto cursor = rs->getRandomCursor(opCtx)) {
+            while (static_cast<long long>(sample.size()) < sampleSize) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+                sample.push_back(record->data.releaseToBson().getOwned());
+                if (sample.size() % 1000 == 0) {
+                    opCtx->checkForInterrupt();
+                }
+            }
+            return sample;
+        }
+    }
+
+    // Without a random cursor, keep a uniform sample of a full scan.
+    PseudoRandom random(Date_t::now().asInt64());
+    auto cursor = collection->getCursor(opCtx);
+    long long numSeen = 0;
+    while (auto record = cursor->next()) {
+        if (++numSeen % 1000 == 0) {
+            opCtx->checkForInterrupt();
+        }
+        if (static_cast<long long>(sample.size()) < sampleSize) {
+            sample.push_back(record->data.releaseToBson().getOwned());
+        } else {
+            const long long ix = random.nextInt64(numSeen);
+            if (ix < sampleSize) {
+                sample[ix] = record->data.releaseToBson().getOwned();
+            }
+        }
+    }
+    return sample;
+}
+
+/**
+ * Builds the histogram of the leading field of the index 'entry' from the keys it holds for the
+ * documents of 'sample'. The keys are in index key form, including collation keys for strings.
+ */
+IndexHistogram buildHistogram(OperationContext* opCtx,
+                              const IndexCatalogEntry& entry,
+                              const std::vector<BSONObj>& sample,
+                              size_t numBuckets) {
+    std::vector<BSONObj> keys;
+    const MatchExpression* filter = entry.getFilterExpression();
+    for (auto&& doc : sample) {
+        if (filter && !filter->matchesBSON(doc)) {
+            continue;
+        }
+        BSONObjSet docKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        entry.accessMethod()->getKeys(
+            doc, IndexAccessMethod::GetKeysMode::kRelaxConstraints, &docKeys, nullptr, nullptr);
+        keys.insert(keys.end(), docKeys.begin(), docKeys.end());
+        if (keys.size() % 1000 == 0) {
+            opCtx->checkForInterrupt();
+        }
+    }
+    return IndexHistogram::make(std::move(keys), numBuckets, sample.size());
+}
+
+/**
+ * Gathers the histograms the query planner uses to order and prune candidate plans before their
+ * trial period, see QueryPlanner::plan().
+ *
+ *     { analyze: <collection>, index: <name>, sampleSize: <n>, buckets: <n> }
+ *
+ * Samples 'sampleSize' documents, 10000 by default, and builds a histogram with at most 'buckets'
+ * buckets, 100 by default, of the leading field of the index 'index', or of every btree index if
+ * it is omitted. The histograms are kept in memory until the index is dropped, the collection is
+ * unloaded or the server restarts, and are replaced by the next analyze of the index.
+ */
+class AnalyzeCommand final : public BasicCommand {
+public:
+    AnalyzeCommand() : BasicCommand("analyze") {}
+
+    std::string help() const override {
+        return "build the histograms the query planner uses to estimate index scans\n"
+               "{ analyze: <collection>, [index: <name>], [sampleSize: <n>], [buckets: <n>] }";
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kOptIn;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                parseResourcePattern(dbname, cmdObj), ActionType::planCacheWrite)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+        const long long sampleSize =
+            parseBoundedNumber(cmdObj, "sampleSize", kDefaultSampleSize, kMaxSampleSize);
+        const long long numBuckets =
+            parseBoundedNumber(cmdObj, "buckets", kDefaultNumBuckets, kMaxNumBuckets);
+        std::string indexName;
+        if (auto elem = cmdObj["index"]) {
+            uassert(ErrorCodes::TypeMismatch, "index must be a string", elem.type() == String);
+            indexName = elem.str();
+        }
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "collection " << nss.ns() << " does not exist",
+                collection);
+
+        IndexCatalog* indexCatalog = collection->getIndexCatalog();
+        std::vector<const IndexDescriptor*> indexes;
+        if (!indexName.empty()) {
+            const IndexDescriptor* desc = indexCatalog->findIndexByName(opCtx, indexName);
+            uassert(ErrorCodes::IndexNotFound,
+                    str::stream() << "index " << indexName << " does not exist",
+                    desc);
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "index " << indexName << " is not a btree index",
+                    desc->getIndexType() == INDEX_BTREE);
+            indexes.push_back(desc);
+        } else {
+            auto it = indexCatalog->getIndexIterator(opCtx, false);
+            while (it.more()) {
+                const IndexDescriptor* desc = it.next();
+                if (desc->getIndexType() == INDEX_BTREE) {
+                    indexes.push_back(desc);
+                }
+            }
+        }
+
+        const auto sample = sampleDocuments(opCtx, collection, sampleSize);
+        BSONArrayBuilder indexesBuilder(result.subarrayStart("indexes"));
+        for (auto desc : indexes) {
+            auto histogram = std::make_shared<IndexHistogram>(buildHistogram(
+                opCtx, *indexCatalog->getEntry(desc), sample, static_cast<size_t>(numBuckets)));
+            indexesBuilder.append(BSON("name" << desc->indexName() << "key" << desc->keyPattern()
+                                              << "histogram"
+                                              << histogram->toBSON()));
+            collection->infoCache()->setIndexHistogram(desc->indexName(), std::move(histogram));
+        }
+        indexesBuilder.doneFast();
+
+        LOG(1) << "Analyzed " << indexes.size() << " indexes of " << nss << " from a sample of "
+               << sample.size() << " documents";
+        result.appendNumber("numSampledRecords", static_cast<long long>(sample.size()));
+        return true;
+    }
+} analyzeCommand;
+
+}  // namespace
+}  // namespace mongo
@@ -79,8 +79,10 @@ public:
                "warning: this operation locks the database and is slow. you can cancel with "
                "killOp()\n"
                "{ compact : <collection_name>, [force:<bool>], [validate:<bool>],\n"
-               "  [paddingFactor:<num>], [paddingBytes:<num>] }\n"
+               "  [paddingFactor:<num>], [paddingBytes:<num>], [online:<bool>] }\n"
                "  force - allows to run on a replica set primary\n"
+               "  online - compact in steps under intent locks, throttled by cache pressure and "
+               "replication lag. allowed on a replica set primary\n"
                "  validate - check records are noncorrupt before adding to newly compacting "
                "extents. slower but safer (defaults to true in this version)\n";
     }
@@ -92,12 +94,13 @@ public:
                            string& errmsg,
                            BSONObjBuilder& result) {
         NamespaceString nss = CommandHelpers::parseNsCollectionRequired(db, cmdObj);
+        const bool online = cmdObj["online"].trueValue();
 
         repl::ReplicationCoordinator* replCoord = repl::ReplicationCoordinator::get(opCtx);
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (replCoord->getMemberState().primary() && !online && !cmdObj["force"].trueValue()) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
-                "operation. use force:true to force";
+                "operation. use online:true to compact without blocking, or force:true to force";
             return false;
         }
 
@@ -142,7 +145,14 @@ public:
         if (cmdObj.hasElement("validate"))
             compactOptions.validateDocuments = cmdObj["validate"].trueValue();
 
-        AutoGetDb autoDb(opCtx, db, MODE_X);
+        compactOptions.online = online;
+
+        // An online compaction only holds intent locks, so reads and writes to the collection
+        // proceed while it runs, and only operations needing an exclusive lock wait for it.
+        AutoGetDb autoDb(opCtx, db, online ? MODE_IX : MODE_X);
+        boost::optional<Lock::CollectionLock> collLock;
+        if (online)
+            collLock.emplace(opCtx->lockState(), nss.ns(), MODE_IX);
         Database* const collDB = autoDb.getDb();
 
         Collection* collection = collDB ? collDB->getCollection(opCtx, nss) : nullptr;
@@ -35,6 +35,7 @@
 #include <boost/optional.hpp>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
@@ -45,17 +46,217 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
 
 namespace {
 
+// The number of threads hashing the collections of a database. With more than one thread, the
+// collections of a replica set member are read at a common timestamp under intent locks.
+MONGO_EXPORT_SERVER_PARAMETER(dbHashThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue, "dbHashThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+/**
+ * Returns the md5 of the documents of 'collection' in _id order. Stops with an Interrupted error
+ * if 'interrupted' is set while the collection is being read.
+ */
+std::string hashCollectionDocuments(OperationContext* opCtx,
+                                    Collection* collection,
+                                    const NamespaceString& nss,
+                                    const AtomicWord<bool>* interrupted = nullptr) {
+    IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
+
+    std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
+    if (desc) {
+        exec = InternalPlanner::indexScan(opCtx,
+                                          collection,
+                                          desc,
+                                          BSONObj(),
+                                          BSONObj(),
+                                          BoundInclusion::kIncludeStartKeyOnly,
+                                          PlanExecutor::NO_YIELD,
+                                          InternalPlanner::FORWARD,
+                                          InternalPlanner::IXSCAN_FETCH);
+    } else if (collection->isCapped() || collection->getRecordStore()->isClusteredOnId()) {
+        // Collections clustered on _id are stored in _id order.
+        exec = InternalPlanner::collectionScan(
+            opCtx, nss.ns(), collection, PlanExecutor::NO_YIELD);
+    } else {
+        log() << "can't find _id index for: " << nss;
+        return "no _id _index";
+    }
+
+    md5_state_t st;
+    md5_init(&st);
+
+    long long n = 0;
+    PlanExecutor::ExecState state;
+    BSONObj c;
+    verify(NULL != exec.get());
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
+        md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+        n++;
+        if (interrupted && n % 1000 == 0 && interrupted->load()) {
+            uasserted(ErrorCodes::Interrupted, "dbHash was interrupted");
+        }
+    }
+    if (PlanExecutor::IS_EOF != state) {
+        warning() << "error while hashing, db dropped? ns=" << nss;
+        uasserted(34371,
+                  "Plan executor error while running dbHash command: " +
+                      WorkingSetCommon::toStatusString(c));
+    }
+    md5digest d;
+    md5_finish(&st, d);
+    return digestToString(d);
+}
+
+/**
+ * Returns the timestamp at which the collections of 'dbname' can be hashed by several threads, or
+ * boost::none if they have to be hashed by this operation under a database lock.
+ */
+boost::optional<Timestamp> getParallelHashTimestamp(OperationContext* opCtx,
+                                                    const std::string& dbname) {
+    if (dbHashThreads.load() <= 1 || dbname == NamespaceString::kLocalDb) {
+        return boost::none;
+    }
+
+    auto txnParticipant = TransactionParticipant::get(opCtx);
+    if (txnParticipant && txnParticipant->inMultiDocumentTransaction()) {
+        return boost::none;
+    }
+
+    // Writes are only timestamped on replica set members, and only some storage engines can read
+    // at a timestamp.
+    auto storageEngine = opCtx->getServiceContext()->getStorageEngine();
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (!storageEngine->supportsReadConcernSnapshot() ||
+        replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+        return boost::none;
+    }
+
+    // Secondaries apply the operations of a batch out of order, so only the end of a batch is a
+    // consistent state to read.
+    Timestamp readTimestamp = replCoord->getMemberState().secondary()
+        ? replCoord->getMyLastAppliedOpTime().getTimestamp()
+        : storageEngine->getAllCommittedTimestamp();
+    if (readTimestamp.isNull()) {
+        return boost::none;
+    }
+    return readTimestamp;
+}
+
+void uassertNoCatalogChangesAfter(Collection* collection, Timestamp readTimestamp) {
+    auto minSnapshot = collection->getMinimumVisibleSnapshot();
+    uassert(ErrorCodes::SnapshotUnavailable,
+            str::stream() << "Unable to read from a snapshot due to pending collection catalog "
+                             "changes; please retry the operation. Snapshot timestamp is "
+                          << readTimestamp.toString()
+                          << ". Collection minimum timestamp is "
+                          << minSnapshot->toString(),
+            !minSnapshot || readTimestamp >= *minSnapshot);
+}
+
+/**
+ * Hashes the collections 'namespaces' on several threads, each of which reads at 'readTimestamp'
+ * under intent locks. Must be called without holding any locks. Returns the hashes in the order of
+ * 'namespaces'.
+ */
+std::vector<std::string> hashCollectionsInParallel(OperationContext* opCtx,
+                                                   const std::vector<NamespaceString>& namespaces,
+                                                   Timestamp readTimestamp) {
+    invariant(!opCtx->lockState()->isLocked());
+
+    std::vector<std::string> hashes(namespaces.size());
+    const size_t numWorkers = std::min(static_cast<size_t>(dbHashThreads.load()), hashes.size());
+
+    stdx::mutex mutex;
+    stdx::condition_variable workerDone;
+    size_t nextCollection = 0;
+    size_t numRunning = numWorkers;
+    Status status = Status::OK();
+    AtomicWord<bool> interrupted{false};
+
+    auto hashCollections = [&] {
+        Client::initThread("dbHashWorker");
+        auto workerOpCtx = cc().makeOperationContext();
+        workerOpCtx->recoveryUnit()->setTimestampReadSource(
+            RecoveryUnit::ReadSource::kProvided, readTimestamp);
+
+        // Reading at the end of a batch does not need to wait for batch application to finish.
+        ShouldNotConflictWithSecondaryBatchApplicationBlock noPBWMBlock(
+            workerOpCtx->lockState());
+
+        Status workerStatus = Status::OK();
+        try {
+            while (true) {
+                size_t i;
+                {
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    if (nextCollection == namespaces.size() || !status.isOK()) {
+                        break;
+                    }
+                    i = nextCollection++;
+                }
+
+                AutoGetCollection autoColl(workerOpCtx.get(), namespaces[i], MODE_IS);
+                Collection* collection = autoColl.getCollection();
+                uassert(ErrorCodes::NamespaceNotFound,
+                        str::stream() << "Collection " << namespaces[i].ns()
+                                      << " was dropped while hashing; please retry the operation",
+                        collection);
+                uassertNoCatalogChangesAfter(collection, readTimestamp);
+
+                hashes[i] = hashCollectionDocuments(
+                    workerOpCtx.get(), collection, namespaces[i], &interrupted);
+            }
+        } catch (const DBException& ex) {
+            workerStatus = ex.toStatus();
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (!workerStatus.isOK() && status.isOK()) {
+                status = workerStatus;
+            }
+            --numRunning;
+        }
+        workerDone.notify_all();
+    };
+
+    std::vector<stdx::thread> workers;
+    ON_BLOCK_EXIT([&] {
+        interrupted.store(true);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+    for (size_t i = 0; i < numWorkers; ++i) {
+        workers.emplace_back(hashCollections);
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    opCtx->waitForConditionOrInterrupt(workerDone, lk, [&] { return numRunning == 0; });
+    uassertStatusOK(status);
+    return hashes;
+}
+
 class DBHashCmd : public ErrmsgCommandDeprecated {
 public:
     DBHashCmd() : ErrmsgCommandDeprecated("dbHash", "dbhash") {}
@@ -116,13 +317,19 @@ public:
         // change for the snapshot.
         auto lockMode = LockMode::MODE_S;
         auto txnParticipant = TransactionParticipant::get(opCtx);
+        const auto parallelHashTimestamp = getParallelHashTimestamp(opCtx, dbname);
         if (txnParticipant && txnParticipant->inMultiDocumentTransaction()) {
             // However, if we are inside a multi-statement transaction, then we only need to lock
             // the database in intent mode to ensure that none of the collections get dropped.
             lockMode = getLockModeForQuery(opCtx);
+        } else if (parallelHashTimestamp) {
+            // Likewise when the collections are read at a timestamp. The database lock is only held
+            // while listing the collections.
+            lockMode = LockMode::MODE_IS;
         }
-        AutoGetDb autoDb(opCtx, ns, lockMode);
-        Database* db = autoDb.getDb();
+        boost::optional<AutoGetDb> autoDb;
+        autoDb.emplace(opCtx, ns, lockMode);
+        Database* db = autoDb->getDb();
         std::list<std::string> colls;
         if (db) {
             db->getDatabaseCatalogEntry()->getCollectionNamespaces(&colls);
@@ -146,7 +353,7 @@ public:
         BSONArrayBuilder cappedCollections;
         BSONObjBuilder collectionsByUUID;
 
-        BSONObjBuilder bb(result.subobjStart("collections"));
+        std::vector<NamespaceString> collectionsToHash;
         for (const auto& collectionName : colls) {
 
             NamespaceString collNss(collectionName);
@@ -183,12 +390,30 @@ public:
                 if (OptionalCollectionUUID uuid = collection->uuid()) {
                     uuid->appendToBuilder(&collectionsByUUID, collNss.coll());
                 }
+
+                if (parallelHashTimestamp) {
+                    uassertNoCatalogChangesAfter(collection, *parallelHashTimestamp);
+                }
             }
 
-            // Compute the hash for this collection.
-            std::string hash = _hashCollection(opCtx, db, collNss.toString());
+            collectionsToHash.push_back(collNss);
+        }
+
+        // Compute the hash for each collection.
+        std::vector<std::string> hashes;
+        if (parallelHashTimestamp) {
+            autoDb.reset();
+            hashes = hashCollectionsInParallel(opCtx, collectionsToHash, *parallelHashTimestamp);
+        } else {
+            for (const auto& collNss : collectionsToHash) {
+                hashes.push_back(_hashCollection(opCtx, db, collNss.toString()));
+            }
+        }
 
-            bb.append(collNss.coll(), hash);
+        BSONObjBuilder bb(result.subobjStart("collections"));
+        for (size_t i = 0; i < collectionsToHash.size(); ++i) {
+            const std::string& hash = hashes[i];
+            bb.append(collectionsToHash[i].coll(), hash);
             md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
         }
         bb.done();
@@ -244,49 +469,7 @@ private:
             invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_S));
         }
 
-        IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
-
-        std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
-        if (desc) {
-            exec = InternalPlanner::indexScan(opCtx,
-                                              collection,
-                                              desc,
-                                              BSONObj(),
-                                              BSONObj(),
-                                              BoundInclusion::kIncludeStartKeyOnly,
-                                              PlanExecutor::NO_YIELD,
-                                              InternalPlanner::FORWARD,
-                                              InternalPlanner::IXSCAN_FETCH);
-        } else if (collection->isCapped()) {
-            exec = InternalPlanner::collectionScan(
-                opCtx, fullCollectionName, collection, PlanExecutor::NO_YIELD);
-        } else {
-            log() << "can't find _id index for: " << fullCollectionName;
-            return "no _id _index";
-        }
-
-        md5_state_t st;
-        md5_init(&st);
-
-        long long n = 0;
-        PlanExecutor::ExecState state;
-        BSONObj c;
-        verify(NULL != exec.get());
-        while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
-            md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
-            n++;
-        }
-        if (PlanExecutor::IS_EOF != state) {
-            warning() << "error while hashing, db dropped? ns=" << fullCollectionName;
-            uasserted(34371,
-                      "Plan executor error while running dbHash command: " +
-                          WorkingSetCommon::toStatusString(c));
-        }
-        md5digest d;
-        md5_finish(&st, d);
-        std::string hash = digestToString(d);
-
-        return hash;
+        return hashCollectionDocuments(opCtx, collection, ns);
     }
 
 } dbhashCmd;
@@ -186,7 +186,8 @@ public:
                              const GetMoreRequest& request,
                              CursorResponseBuilder* nextBatch,
                              PlanExecutor::ExecState* state,
-                             std::uint64_t* numResults) {
+                             std::uint64_t* numResults,
+                             bool* reachedSortKeyBound) {
             PlanExecutor* exec = cursor->getExecutor();
 
             // If an awaitData getMore is killed during this process due to our max time expiring at
@@ -196,6 +197,14 @@ public:
             try {
                 while (!FindCommon::enoughForGetMore(request.batchSize.value_or(0), *numResults) &&
                        PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
+                    // The mongos merging these sorted results has no use for those after its
+                    // bound, and the rest of them sort later still, so the cursor ends here.
+                    if (request.sortKeyBound && request.sortsAfterBound(obj)) {
+                        *reachedSortKeyBound = true;
+                        *state = PlanExecutor::IS_EOF;
+                        break;
+                    }
+
                     // If adding this object will cause us to exceed the message size limit, then we
                     // stash it for later.
                     if (!FindCommon::haveSpaceForNext(obj, *numResults, nextBatch->bytesUsed())) {
@@ -464,13 +473,17 @@ public:
                     dropAndReaquireReadLock);
             }
 
-            uassertStatusOK(
-                generateBatch(opCtx, cursor, _request, &nextBatch, &state, &numResults));
+            bool reachedSortKeyBound = false;
+            uassertStatusOK(generateBatch(
+                opCtx, cursor, _request, &nextBatch, &state, &numResults, &reachedSortKeyBound));
 
             PlanSummaryStats postExecutionStats;
             Explain::getSummaryStats(*exec, &postExecutionStats);
             postExecutionStats.totalKeysExamined -= preExecutionStats.totalKeysExamined;
             postExecutionStats.totalDocsExamined -= preExecutionStats.totalDocsExamined;
+            for (auto&& stageTime : preExecutionStats.stageExecutionTimeNanos) {
+                postExecutionStats.stageExecutionTimeNanos[stageTime.first] -= stageTime.second;
+            }
             curOp->debug().setPlanSummaryMetrics(postExecutionStats);
 
             // We do not report 'execStats' for aggregation or other globally managed cursors, both
@@ -487,7 +500,8 @@ public:
                 curOp->debug().execStats = execStatsBob.obj();
             }
 
-            if (shouldSaveCursorGetMore(state, exec, cursor->isTailable())) {
+            if (!reachedSortKeyBound &&
+                shouldSaveCursorGetMore(state, exec, cursor->isTailable())) {
                 respondWithId = _request.cursorid;
 
                 exec->saveState();
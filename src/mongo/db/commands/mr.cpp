@@ -32,6 +32,8 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <deque>
+
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connpool.h"
@@ -63,6 +65,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/parallel.h"
@@ -72,7 +75,9 @@
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/scripting/engine.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
@@ -93,6 +98,16 @@ namespace dps = ::mongo::dotted_path_support;
 namespace mr {
 namespace {
 
+// The number of threads which run the map function of a mapReduce which is not in jsMode. With the
+// default of 1 the map function runs on the thread running the command.
+MONGO_EXPORT_SERVER_PARAMETER(mapReduceMapThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue, "mapReduceMapThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
 /**
  * Runs a count against the namespace specified by 'ns'. If the caller holds the global write lock,
  * then this function does not acquire any additional locks.
@@ -120,25 +135,31 @@ unsigned long long collectionCount(OperationContext* opCtx,
 }
 
 /**
- * Emit that will be called by a js function.
+ * Validates the arguments of a call to emit() and returns the (key, value) tuple to record.
  */
-BSONObj fastEmit(const BSONObj& args, void* data) {
+BSONObj makeEmitTuple(const BSONObj& args) {
     uassert(10077, "emit takes 2 args", args.nFields() == 2);
     uassert(13069,
             "an emit can't be more than half max bson size",
             args.objsize() < (BSONObjMaxUserSize / 2));
 
-    State* state = (State*)data;
     if (args.firstElement().type() == Undefined) {
         BSONObjBuilder b(args.objsize());
         b.appendNull("");
         BSONObjIterator i(args);
         i.next();
         b.append(i.next());
-        state->emit(b.obj());
-    } else {
-        state->emit(args);
+        return b.obj();
     }
+    return args;
+}
+
+/**
+ * Emit that will be called by a js function.
+ */
+BSONObj fastEmit(const BSONObj& args, void* data) {
+    State* state = (State*)data;
+    state->emit(makeEmitTuple(args));
     return BSONObj();
 }
 
@@ -174,7 +195,11 @@ JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
 }
 
 void JSFunction::init(State* state) {
-    _scope = state->scope();
+    init(state->scope());
+}
+
+void JSFunction::init(Scope* scope) {
+    _scope = scope;
     verify(_scope);
     _scope->init(&_wantedScope);
 
@@ -186,8 +211,12 @@ void JSFunction::init(State* state) {
 }
 
 void JSMapper::init(State* state) {
-    _func.init(state);
-    _params = state->config().mapParams;
+    init(state->scope(), state->config().mapParams);
+}
+
+void JSMapper::init(Scope* scope, const BSONObj& params) {
+    _func.init(scope);
+    _params = params;
 }
 
 /**
@@ -207,14 +236,18 @@ void JSMapper::map(const BSONObj& o) {
 BSONObj JSFinalizer::finalize(const BSONObj& o) {
     Scope* s = _func.scope();
 
-    Scope::NoDBAccess no = s->disableDBAccess("can't access db inside finalize");
-    s->invokeSafe(_func.func(), &o, 0);
-
     // We don't want to use o.objsize() to size b since there are many cases where the point of
     // finalize is converting many fields to 1
     BSONObjBuilder b;
     b.append(o.firstElement());
-    s->append(b, "value", "__returnValue");
+
+    // Make the calls for this document in one batch, rather than one round trip each to the thread
+    // running the JavaScript.
+    s->runBatch([&](Scope& scope) {
+        Scope::NoDBAccess no = scope.disableDBAccess("can't access db inside finalize");
+        scope.invokeSafe(_func.func(), &o, 0);
+        scope.append(b, "value", "__returnValue");
+    });
     return b.obj();
 }
 
@@ -395,7 +428,8 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
         if (cmdObj["scope"].type() == Object)
             scopeSetup = cmdObj["scope"].embeddedObjectUserCheck().getOwned();
 
-        mapper.reset(new JSMapper(cmdObj["map"]));
+        mapFunction = BSON("map" << cmdObj["map"]);
+        mapper.reset(new JSMapper(mapFunction.firstElement()));
         reducer.reset(new JSReducer(cmdObj["reduce"]));
         if (cmdObj["finalize"].type() && cmdObj["finalize"].trueValue())
             finalizer.reset(new JSFinalizer(cmdObj["finalize"]));
@@ -1343,6 +1377,228 @@ void State::reduceAndSpillInMemoryStateIfNeeded() {
     }
 }
 
+namespace {
+
+/**
+ * Runs the map function of a mapReduce on several worker threads. Each worker has its own Client,
+ * JavaScript scope and in-memory table of emitted tuples. Documents are handed to the workers in
+ * batches, and drainInto() merges the workers' tables into the State of the mapReduce.
+ */
+class ParallelMapper {
+    MONGO_DISALLOW_COPYING(ParallelMapper);
+
+public:
+    static constexpr size_t kBatchSize = 100;
+
+    // The number of batches each worker may map between two merges of the emitted tuples.
+    static constexpr long long kBatchesPerDrain = 4;
+
+    ParallelMapper(const Config& config, int numWorkers) : _config(config) {
+        for (int i = 0; i < numWorkers; ++i) {
+            _workers.push_back(stdx::make_unique<Worker>());
+        }
+        _numLiveWorkers = _workers.size();
+        for (auto& worker : _workers) {
+            Worker* w = worker.get();
+            w->thread = stdx::thread([this, w] { _run(w); });
+        }
+    }
+
+    /**
+     * Stops the workers, interrupting any map function they are running.
+     */
+    ~ParallelMapper() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _shutdown = true;
+            for (auto& worker : _workers) {
+                if (worker->scope) {
+                    worker->scope->kill();
+                }
+            }
+        }
+        _workAvailable.notify_all();
+        for (auto& worker : _workers) {
+            worker->thread.join();
+        }
+    }
+
+    /**
+     * Queues an owned document to be mapped.
+     */
+    void add(BSONObj doc) {
+        _pendingBatch.push_back(std::move(doc));
+        if (_pendingBatch.size() < kBatchSize) {
+            return;
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _batches.push_back(std::move(_pendingBatch));
+        }
+        _pendingBatch.clear();
+        _workAvailable.notify_one();
+    }
+
+    /**
+     * Returns whether the tuples emitted so far should be merged, given the number of documents
+     * added.
+     */
+    bool shouldDrain(long long numInputs) const {
+        return numInputs % (kBatchSize * kBatchesPerDrain * _workers.size()) == 0;
+    }
+
+    /**
+     * Waits for every document added so far to be mapped, then moves the tuples emitted by the
+     * workers into 'state'. Throws the first error a worker ran into.
+     */
+    void drainInto(OperationContext* opCtx, State* state) {
+        if (!_pendingBatch.empty()) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _batches.push_back(std::move(_pendingBatch));
+            }
+            _pendingBatch.clear();
+            _workAvailable.notify_one();
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        opCtx->waitForConditionOrInterrupt(_workDone, lk, [this] {
+            return !_status.isOK() ||
+                (_numBusyWorkers == 0 && (_batches.empty() || _numLiveWorkers == 0));
+        });
+        uassertStatusOK(_status);
+        uassert(ErrorCodes::InternalError,
+                "no mapReduce map worker is running",
+                _batches.empty() && _numBusyWorkers == 0);
+
+        // Every worker is idle, so their tables can be read without further synchronization.
+        for (auto& worker : _workers) {
+            for (const auto& entry : worker->emits) {
+                for (const auto& tuple : entry.second) {
+                    state->emit(tuple);
+                }
+            }
+            worker->emits.clear();
+        }
+    }
+
+private:
+    struct Worker {
+        stdx::thread thread;
+
+        // The scope running the map function, set while the worker is able to run it. Guarded
+        // by the mutex of the ParallelMapper, so that it can be killed on shutdown.
+        Scope* scope = nullptr;
+
+        // The tuples emitted by this worker since the last drain.
+        InMemory emits;
+    };
+
+    static BSONObj _emit(const BSONObj& args, void* data) {
+        Worker* worker = static_cast<Worker*>(data);
+        BSONObj tuple = makeEmitTuple(args);
+        worker->emits[tuple].push_back(tuple);
+        return BSONObj();
+    }
+
+    void _run(Worker* worker) {
+        Client::initThread("mapReduceMapWorker");
+        auto opCtx = cc().makeOperationContext();
+
+        try {
+            std::unique_ptr<Scope> scope(getGlobalScriptEngine()->newScopeForCurrentThread());
+            scope->requireOwnedObjects();
+            scope->registerOperation(opCtx.get());
+            scope->setLocalDB(_config.dbname);
+            scope->loadStored(opCtx.get(), true);
+            if (!_config.scopeSetup.isEmpty()) {
+                scope->init(&_config.scopeSetup);
+            }
+
+            JSMapper mapper(_config.mapFunction.firstElement());
+            mapper.init(scope.get(), _config.mapParams);
+            scope->injectNative("emit", _emit, worker);
+
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                worker->scope = nullptr;
+            });
+            {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                if (_shutdown) {
+                    return;
+                }
+                worker->scope = scope.get();
+            }
+
+            while (true) {
+                std::vector<BSONObj> batch;
+                {
+                    stdx::unique_lock<stdx::mutex> lk(_mutex);
+                    _workAvailable.wait(lk, [this] { return _shutdown || !_batches.empty(); });
+                    if (_shutdown) {
+                        return;
+                    }
+                    batch = std::move(_batches.front());
+                    _batches.pop_front();
+                    ++_numBusyWorkers;
+                }
+
+                Status status = Status::OK();
+                try {
+                    for (const auto& doc : batch) {
+                        mapper.map(doc);
+                    }
+                } catch (const DBException& ex) {
+                    status = ex.toStatus();
+                }
+
+                {
+                    stdx::lock_guard<stdx::mutex> lk(_mutex);
+                    --_numBusyWorkers;
+                    if (!status.isOK() && _status.isOK()) {
+                        _status = status;
+                    }
+                }
+                _workDone.notify_all();
+            }
+        } catch (const DBException& ex) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                --_numLiveWorkers;
+                if (_status.isOK()) {
+                    _status = ex.toStatus();
+                }
+            }
+            _workDone.notify_all();
+        }
+    }
+
+    const Config& _config;
+
+    // Only used by the thread running the mapReduce.
+    std::vector<BSONObj> _pendingBatch;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _workDone;
+
+    // Everything below is guarded by _mutex.
+    std::deque<std::vector<BSONObj>> _batches;
+    size_t _numBusyWorkers = 0;
+    size_t _numLiveWorkers = 0;
+    bool _shutdown = false;
+    Status _status = Status::OK();
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+};
+
+constexpr size_t ParallelMapper::kBatchSize;
+constexpr long long ParallelMapper::kBatchesPerDrain;
+
+}  // namespace
+
 /**
  * This class represents a map/reduce command executed on a single server
  */
@@ -1454,6 +1710,14 @@ public:
             long long reduceTime = 0;
             long long numInputs = 0;
 
+            // In mixed mode the map function may run on worker threads, whose emitted tuples are
+            // merged into the state before it is reduced.
+            std::unique_ptr<ParallelMapper> parallelMapper;
+            const int mapThreads = mapReduceMapThreads.load();
+            if (mapThreads > 1 && !state.jsMode()) {
+                parallelMapper = stdx::make_unique<ParallelMapper>(config, mapThreads);
+            }
+
             {
                 // We've got a cursor preventing migrations off, now re-establish our useful cursor
 
@@ -1527,11 +1791,15 @@ public:
                     }
 
                     // do map
-                    if (config.verbose)
-                        mt.reset();
-                    config.mapper->map(o);
-                    if (config.verbose)
-                        mapTime += mt.micros();
+                    if (parallelMapper) {
+                        parallelMapper->add(o);
+                    } else {
+                        if (config.verbose)
+                            mt.reset();
+                        config.mapper->map(o);
+                        if (config.verbose)
+                            mapTime += mt.micros();
+                    }
 
                     // Check if the state accumulated so far needs to be written to a
                     // collection. This may yield the DB lock temporarily and then
@@ -1548,7 +1816,12 @@ public:
 
                         scopedAutoColl.reset();
 
-                        state.reduceAndSpillInMemoryStateIfNeeded();
+                        if (!parallelMapper) {
+                            state.reduceAndSpillInMemoryStateIfNeeded();
+                        } else if (parallelMapper->shouldDrain(numInputs)) {
+                            parallelMapper->drainInto(opCtx, &state);
+                            state.reduceAndSpillInMemoryStateIfNeeded();
+                        }
                         scopedAutoColl.emplace(opCtx, config.nss, MODE_S);
 
                         auto restoreStatus = exec->restoreState();
@@ -1587,6 +1860,13 @@ public:
                     curOp->debug().execStats = execStatsBob.obj();
                 }
             }
+            if (parallelMapper) {
+                // The map time is the time spent waiting for the workers to finish.
+                Timer dt;
+                parallelMapper->drainInto(opCtx, &state);
+                parallelMapper.reset();
+                mapTime += dt.micros();
+            }
             pm.finished();
 
             opCtx->checkForInterrupt();
@@ -113,6 +113,11 @@ public:
 
     virtual void init(State* state);
 
+    /**
+     * Compiles the function in 'scope', which need not be the scope of a State.
+     */
+    void init(Scope* scope);
+
     Scope* scope() const {
         return _scope;
     }
@@ -135,6 +140,11 @@ public:
     virtual void map(const BSONObj& o);
     virtual void init(State* state);
 
+    /**
+     * Prepares to map into 'scope', passing 'params' to every call of the map function.
+     */
+    void init(Scope* scope, const BSONObj& params);
+
 private:
     JSFunction _func;
     BSONObj _params;
@@ -208,6 +218,9 @@ public:
     // functions
 
     std::unique_ptr<Mapper> mapper;
+    // The 'map' element of the command, owned so that the map function can be compiled again
+    // in other scopes.
+    BSONObj mapFunction;
     std::unique_ptr<Reducer> reducer;
     std::unique_ptr<Finalizer> finalizer;
 
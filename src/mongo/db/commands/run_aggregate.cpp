@@ -43,6 +43,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/aggregation_result_cache.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
@@ -60,6 +61,7 @@
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_options.h"
@@ -87,12 +89,15 @@ namespace {
  * requests). Otherwise, returns false. The passed 'nsForCursor' is only used to determine the
  * namespace used in the returned cursor, which will be registered with the global cursor manager,
  * and thus will be different from that in 'request'.
+ *
+ * If 'batchCopy' is not null, every document returned in the first batch is also appended to it.
  */
 bool handleCursorCommand(OperationContext* opCtx,
                          const NamespaceString& nsForCursor,
                          std::vector<ClientCursor*> cursors,
                          const AggregationRequest& request,
-                         rpc::ReplyBuilderInterface* result) {
+                         rpc::ReplyBuilderInterface* result,
+                         std::vector<BSONObj>* batchCopy) {
     invariant(!cursors.empty());
     long long batchSize = request.getBatchSize();
 
@@ -175,6 +180,9 @@ bool handleCursorCommand(OperationContext* opCtx,
 
         responseBuilder.setLatestOplogTimestamp(cursor->getExecutor()->getLatestOplogTimestamp());
         responseBuilder.append(next);
+        if (batchCopy) {
+            batchCopy->push_back(next.getOwned());
+        }
     }
 
     if (cursor) {
@@ -319,6 +327,84 @@ std::unique_ptr<CollatorInterface> resolveCollator(OperationContext* opCtx,
                 : nullptr);
 }
 
+/**
+ * Returns true if this aggregation may be answered from, and its results stored in, the
+ * AggregationResultCache. Only reads of the latest local data on a node which accepts writes for
+ * the database qualify, since a cache entry stays valid only until a write to one of its namespaces
+ * is observed on this node. The caller must hold the global lock.
+ */
+bool canUseResultCache(OperationContext* opCtx,
+                       const NamespaceString& nss,
+                       const AggregationRequest& request,
+                       const LiteParsedPipeline& liteParsedPipeline) {
+    if (!AggregationResultCache::isEnabled()) {
+        return false;
+    }
+    if (request.getExplain() || request.getExchangeSpec() || request.isFromMongos() ||
+        request.needsMerge()) {
+        return false;
+    }
+    if (nss.isCollectionlessAggregateNS() || liteParsedPipeline.hasChangeStream()) {
+        return false;
+    }
+
+    auto txnParticipant = TransactionParticipant::get(opCtx);
+    if (txnParticipant && txnParticipant->inMultiDocumentTransaction()) {
+        return false;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern ||
+        readConcernArgs.getArgsAtClusterTime()) {
+        return false;
+    }
+
+    return repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesForDatabase(opCtx, nss.db());
+}
+
+/**
+ * Returns the namespaces whose contents the results of 'pipeline' depend on, or boost::none if they
+ * cannot be determined without resolving views.
+ */
+boost::optional<std::vector<NamespaceString>> getResultCacheNamespaces(
+    const NamespaceString& nss,
+    const LiteParsedPipeline& liteParsedPipeline,
+    const ExpressionContext& expCtx) {
+    std::vector<NamespaceString> namespaces{nss};
+    for (auto&& involvedNs : liteParsedPipeline.getInvolvedNamespaces()) {
+        // A view may itself read further namespaces, which are not tracked here.
+        const auto& resolvedNs = expCtx.getResolvedNamespace(involvedNs);
+        if (!resolvedNs.pipeline.empty() || resolvedNs.ns != involvedNs) {
+            return boost::none;
+        }
+        namespaces.push_back(involvedNs);
+    }
+    return namespaces;
+}
+
+/**
+ * Replies to the aggregation with the 'cachedResults', all of which fit in the first batch.
+ */
+void replyWithCachedResults(OperationContext* opCtx,
+                            const NamespaceString& nsForCursor,
+                            const BSONObj& cachedResults,
+                            rpc::ReplyBuilderInterface* result) {
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    CursorResponseBuilder responseBuilder(result, options);
+
+    long long nReturned = 0;
+    for (auto&& elem : cachedResults) {
+        responseBuilder.append(elem.Obj());
+        ++nReturned;
+    }
+    responseBuilder.done(0LL, nsForCursor.ns());
+
+    auto curOp = CurOp::get(opCtx);
+    curOp->debug().cursorExhausted = true;
+    curOp->debug().nreturned = nReturned;
+}
+
 boost::intrusive_ptr<ExpressionContext> makeExpressionContext(
     OperationContext* opCtx,
     const AggregationRequest& request,
@@ -359,6 +445,13 @@ Status runAggregate(OperationContext* opCtx,
     std::vector<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> execs;
     boost::intrusive_ptr<ExpressionContext> expCtx;
     auto curOp = CurOp::get(opCtx);
+
+    // If the results are to be cached, the key and the namespaces they are read from. The write
+    // counter of the cache is recorded before any snapshot is opened.
+    auto resultCache = AggregationResultCache::get(opCtx->getServiceContext());
+    const auto resultCacheReadStart = resultCache->beginRead();
+    boost::optional<std::string> resultCacheKey;
+    std::vector<NamespaceString> resultCacheNamespaces;
     {
         const LiteParsedPipeline liteParsedPipeline(request);
 
@@ -499,6 +592,33 @@ Status runAggregate(OperationContext* opCtx,
 
         pipeline->optimizePipeline();
 
+        if (canUseResultCache(opCtx, nss, request, liteParsedPipeline)) {
+            auto namespaces = getResultCacheNamespaces(nss, liteParsedPipeline, *expCtx);
+            if (namespaces) {
+                BSONArrayBuilder serializedPipeline;
+                for (auto&& stage : pipeline->serialize()) {
+                    stage.addToBsonArray(&serializedPipeline);
+                }
+                resultCacheKey = AggregationResultCache::makeKey(
+                    nss,
+                    serializedPipeline.arr(),
+                    expCtx->getCollator() ? expCtx->getCollator()->getSpec().toBSON() : BSONObj(),
+                    request.getHint());
+                resultCacheNamespaces = std::move(*namespaces);
+            }
+        }
+
+        if (resultCacheKey) {
+            auto cachedResults =
+                resultCache->lookup(*resultCacheKey,
+                                    request.getBatchSize(),
+                                    opCtx->getServiceContext()->getFastClockSource()->now());
+            if (cachedResults) {
+                replyWithCachedResults(opCtx, origNss, *cachedResults, result);
+                return Status::OK();
+            }
+        }
+
         // Prepare a PlanExecutor to provide input into the pipeline, if needed.
         if (liteParsedPipeline.hasChangeStream()) {
             // If we are using a change stream, the cursor stage should have a simple collation,
@@ -538,6 +658,8 @@ Status runAggregate(OperationContext* opCtx,
                 pipelines.emplace_back(uassertStatusOK(Pipeline::create({consumer}, expCtx)));
             }
         } else {
+            PipelineD::addParallelExchange(pipeline.get());
+            PipelineD::addParallelFacets(pipeline.get());
             pipelines.emplace_back(std::move(pipeline));
         }
 
@@ -610,10 +732,21 @@ Status runAggregate(OperationContext* opCtx,
             pins[0].getCursor()->getExecutor(), *(expCtx->explain), &bodyBuilder);
     } else {
         // Cursor must be specified, if explain is not.
-        const bool keepCursor =
-            handleCursorCommand(opCtx, origNss, std::move(cursors), request, result);
+        std::vector<BSONObj> batchCopy;
+        const bool keepCursor = handleCursorCommand(opCtx,
+                                                    origNss,
+                                                    std::move(cursors),
+                                                    request,
+                                                    result,
+                                                    resultCacheKey ? &batchCopy : nullptr);
         if (keepCursor) {
             cursorFreer.Dismiss();
+        } else if (resultCacheKey) {
+            resultCache->insert(*resultCacheKey,
+                                std::move(resultCacheNamespaces),
+                                resultCacheReadStart,
+                                batchCopy,
+                                opCtx->getServiceContext()->getFastClockSource()->now());
         }
     }
 
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/sampling_profiler.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns the call trees aggregated by the sampling CPU profiler.
+ *
+ *     { getSamplingProfile: 1, minSamples: <n> }
+ *
+ * Subtrees with fewer than 'minSamples' samples, 1 by default, are left out.
+ */
+class GetSamplingProfileCommand final : public BasicCommand {
+public:
+    GetSamplingProfileCommand() : BasicCommand("getSamplingProfile") {}
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    std::string help() const override {
+        return "get the call trees collected by the sampling CPU profiler";
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::cpuProfiler)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        uassert(ErrorCodes::IllegalOperation,
+                "the sampling profiler is not running; start the server with "
+                "--setParameter samplingProfilerEnabled=true",
+                SamplingProfiler::isRunning());
+
+        long long minSamples = 1;
+        if (auto elem = cmdObj["minSamples"]) {
+            uassert(ErrorCodes::TypeMismatch, "minSamples must be a number", elem.isNumber());
+            minSamples = elem.safeNumberLong();
+        }
+
+        SamplingProfiler::appendSummary(&result);
+        SamplingProfiler::appendCallTrees(&result, minSamples);
+        return true;
+    }
+} getSamplingProfileCommand;
+
+}  // namespace
+}  // namespace mongo
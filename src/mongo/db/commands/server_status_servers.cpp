@@ -37,6 +37,7 @@
 #include "mongo/util/net/hostname_canonicalization.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 
@@ -90,6 +91,21 @@ public:
 
 } network;
 
+class BufferPool : public ServerStatusSection {
+public:
+    BufferPool() : ServerStatusSection("bufferPool") {}
+    virtual bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
+        BSONObjBuilder b;
+        SharedBufferPool::appendStats(&b);
+        return b.obj();
+    }
+
+} bufferPool;
+
 #ifdef MONGO_CONFIG_SSL
 class Security : public ServerStatusSection {
 public:
@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mongo/db/concurrency/global_lock_acquisition_tracker.h"
+#include "mongo/db/concurrency/lock_contention_profiler.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
@@ -227,6 +228,7 @@ Lock::DBLock::DBLock(OperationContext* opCtx, StringData db, LockMode mode, Date
         _mode = MODE_X;
     }
 
+    LockContentionProfiler::ScopedResourceName resourceName(_id, db);
     _result = _opCtx->lockState()->lock(_opCtx, _id, _mode, deadline);
     invariant(_result == LOCK_OK || _result == LOCK_TIMEOUT);
 }
@@ -275,6 +277,7 @@ Lock::CollectionLock::CollectionLock(Locker* lockState,
         actualLockMode = isSharedLockMode(mode) ? MODE_S : MODE_X;
     }
 
+    LockContentionProfiler::ScopedResourceName resourceName(_id, ns);
     _result = _lockState->lock(_id, actualLockMode, deadline);
     invariant(_result == LOCK_OK || _result == LOCK_TIMEOUT);
 }
@@ -42,6 +42,10 @@ namespace mongo {
 
 namespace {
 auto kLogInterval = stdx::chrono::minutes(1);
+
+// The limits on the number of documents and bytes written in one storage transaction.
+const size_t kMaxBatchDocs = 500;
+const int64_t kMaxBatchBytes = 4 * 1024 * 1024;
 }
 
 void DeferredWriter::_logFailure(const Status& status) {
@@ -92,38 +96,61 @@ StatusWith<std::unique_ptr<AutoGetCollection>> DeferredWriter::_getCollection(
     return std::move(agc);
 }
 
-void DeferredWriter::_worker(InsertStatement stmt) {
-    auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
-    OperationContext* opCtx = uniqueOpCtx.get();
-    auto result = _getCollection(opCtx);
+void DeferredWriter::_worker() {
+    while (true) {
+        // Take the next batch off the buffer. The bytes stay accounted for until it is written, so
+        // that the buffer limit also bounds the batch in flight.
+        std::vector<InsertStatement> batch;
+        int64_t batchBytes = 0;
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            while (!_pending.empty() && batch.size() < kMaxBatchDocs &&
+                   batchBytes < kMaxBatchBytes) {
+                batchBytes += _pending.front().objsize();
+                batch.emplace_back(std::move(_pending.front()));
+                _pending.pop_front();
+            }
+
+            if (batch.empty()) {
+                _workerScheduled = false;
+                return;
+            }
+        }
 
-    if (!result.isOK()) {
-        _logFailure(result.getStatus());
-        return;
-    }
+        Status status = [&] {
+            auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
+            OperationContext* opCtx = uniqueOpCtx.get();
+            auto result = _getCollection(opCtx);
 
-    auto agc = std::move(result.getValue());
+            if (!result.isOK()) {
+                return result.getStatus();
+            }
 
-    Collection& collection = *agc->getCollection();
+            auto agc = std::move(result.getValue());
 
-    Status status = writeConflictRetry(opCtx, "deferred insert", _nss.ns(), [&] {
-        WriteUnitOfWork wuow(opCtx);
-        Status status = collection.insertDocument(opCtx, stmt, nullptr, false);
-        if (!status.isOK()) {
-            return status;
-        }
+            Collection& collection = *agc->getCollection();
 
-        wuow.commit();
-        return Status::OK();
-    });
+            return writeConflictRetry(opCtx, "deferred insert", _nss.ns(), [&] {
+                WriteUnitOfWork wuow(opCtx);
+                Status status =
+                    collection.insertDocuments(opCtx, batch.begin(), batch.end(), nullptr, false);
+                if (!status.isOK()) {
+                    return status;
+                }
 
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
+                wuow.commit();
+                return Status::OK();
+            });
+        }();
+
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
 
-    _numBytes -= stmt.doc.objsize();
+        _numBytes -= batchBytes;
 
-    // If a write to a deferred collection fails, periodically tell the log.
-    if (!status.isOK()) {
-        _logFailure(status);
+        // If a write to a deferred collection fails, periodically tell the log.
+        if (!status.isOK()) {
+            _logFailure(status);
+        }
     }
 }
 
@@ -175,9 +202,13 @@ bool DeferredWriter::insertDocument(BSONObj obj) {
         return false;
     }
 
-    // Add the object to the buffer.
+    // Add the object to the buffer, and make sure a worker will write it.
     _numBytes += obj.objsize();
-    fassert(40588, _pool->schedule([this, obj] { _worker(InsertStatement(obj.getOwned())); }));
+    _pending.push_back(obj.getOwned());
+    if (!_workerScheduled) {
+        fassert(40588, _pool->schedule([this] { _worker(); }));
+        _workerScheduled = true;
+    }
     return true;
 }
 
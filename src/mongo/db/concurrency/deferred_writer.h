@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
@@ -52,6 +54,10 @@ class ThreadPool;
  * caller, it cannot report most errors to the client; it instead periodically logs any errors to
  * the system log.
  *
+ * Buffered documents are written by a single background task in batches, so a burst of inserts
+ * costs one collection lock acquisition and one storage transaction per batch rather than per
+ * document.
+ *
  * Instances of this class are unconditionally thread-safe, and cannot cause deadlock barring
  * improper use of the ctor, `flush` and `shutdown` methods below.
  */
@@ -91,7 +97,7 @@ public:
      * Does not clean up the worker thread; call `shutdown` for that.  Instead, if the worker thread
      * is still running calls std::terminate, which crashes the server.
      */
-    ~DeferredWriter();
+    virtual ~DeferredWriter();
 
     /**
      * Deferred-insert the given object.
@@ -107,6 +113,23 @@ public:
      */
     int64_t getDroppedEntries();
 
+    /**
+     * The name of the backing collection.
+     */
+    const NamespaceString& getNamespace() const {
+        return _nss;
+    }
+
+protected:
+    /**
+     * Ensure that the backing collection exists, and pass back a lock and handle to it.
+     *
+     * Writers whose backing collection must not be created on demand, or must be created in a
+     * special way, override this.
+     */
+    virtual StatusWith<std::unique_ptr<AutoGetCollection>> _getCollection(
+        OperationContext* opCtx);
+
 private:
     /**
      * Log failure, but only if a certain interval has passed since the last log.
@@ -127,14 +150,10 @@ private:
     Status _makeCollection(OperationContext* opCtx);
 
     /**
-     * Ensure that the backing collection exists, and pass back a lock and handle to it.
+     * The method that the worker thread will run. Writes the buffered documents in batches until
+     * the buffer is empty.
      */
-    StatusWith<std::unique_ptr<AutoGetCollection>> _getCollection(OperationContext* opCtx);
-
-    /**
-     * The method that the worker thread will run.
-     */
-    void _worker(InsertStatement stmt);
+    void _worker();
 
     /**
      * The options for the collection, in case we need to create it.
@@ -158,6 +177,16 @@ private:
      */
     stdx::mutex _mutex;
 
+    /**
+     * The documents waiting to be written, oldest first.
+     */
+    std::deque<BSONObj> _pending;
+
+    /**
+     * Whether a worker task has been scheduled and has not yet emptied the buffer.
+     */
+    bool _workerScheduled = false;
+
     /**
      * The number of bytes currently in the in-memory buffer.
      */
@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(lockContentionSampleRate, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "lockContentionSampleRate must be non-negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(lockContentionMaxSamples, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0) {
+            return Status(ErrorCodes::BadValue, "lockContentionMaxSamples must be positive");
+        }
+        return Status::OK();
+    });
+
+LockContentionProfiler globalLockContentionProfiler;
+
+thread_local const LockContentionProfiler::ScopedResourceName* currentResourceName = nullptr;
+
+const char* lockResultName(LockResult result) {
+    switch (result) {
+        case LOCK_OK:
+            return "granted";
+        case LOCK_TIMEOUT:
+            return "timeout";
+        case LOCK_DEADLOCK:
+            return "deadlock";
+        default:
+            return "interrupted";
+    }
+}
+
+}  // namespace
+
+LockContentionProfiler::ScopedResourceName::ScopedResourceName(ResourceId resId, StringData name)
+    : _previous(currentResourceName), _resId(resId), _name(name) {
+    currentResourceName = this;
+}
+
+LockContentionProfiler::ScopedResourceName::~ScopedResourceName() {
+    currentResourceName = _previous;
+}
+
+LockContentionProfiler& LockContentionProfiler::get() {
+    return globalLockContentionProfiler;
+}
+
+bool LockContentionProfiler::shouldSample() {
+    const int sampleRate = lockContentionSampleRate.load();
+    if (sampleRate <= 0) {
+        return false;
+    }
+    return _waits.fetchAndAdd(1) % sampleRate == 0;
+}
+
+StringData LockContentionProfiler::getResourceName(ResourceId resId) {
+    for (auto name = currentResourceName; name; name = name->_previous) {
+        if (name->_resId == resId) {
+            return name->_name;
+        }
+    }
+    return StringData();
+}
+
+void LockContentionProfiler::record(Sample sample) {
+    const size_t maxSamples = lockContentionMaxSamples;
+    const auto type = sample.resId.getType();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _sampledWaits[type]++;
+    _sampledWaitMicros[type] += durationCount<Microseconds>(sample.waitTime);
+
+    if (_ring.size() < maxSamples) {
+        _ring.push_back(std::move(sample));
+    } else {
+        _ring[_next] = std::move(sample);
+    }
+    _next = (_next + 1) % maxSamples;
+}
+
+std::vector<BSONObj> LockContentionProfiler::getSamples() const {
+    std::vector<BSONObj> samples;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    samples.reserve(_ring.size());
+    // Until the ring wraps around '_next' is the end of it, so the oldest sample is at 0.
+    const size_t oldest = _ring.size() < static_cast<size_t>(lockContentionMaxSamples) ? 0 : _next;
+    for (size_t i = 0; i < _ring.size(); ++i) {
+        samples.push_back(_toBSON(_ring[(oldest + i) % _ring.size()]));
+    }
+    return samples;
+}
+
+void LockContentionProfiler::appendSummary(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (int i = RESOURCE_GLOBAL; i < ResourceTypesCount; ++i) {
+        BSONObjBuilder typeBuilder(
+            builder->subobjStart(resourceTypeName(static_cast<ResourceType>(i))));
+        typeBuilder.append("waits", _sampledWaits[i]);
+        typeBuilder.append("waitMicros", _sampledWaitMicros[i]);
+    }
+}
+
+void LockContentionProfiler::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _ring.clear();
+    _next = 0;
+    std::fill(std::begin(_sampledWaits), std::end(_sampledWaits), 0);
+    std::fill(std::begin(_sampledWaitMicros), std::end(_sampledWaitMicros), 0);
+}
+
+BSONObj LockContentionProfiler::_toBSON(const Sample& sample) {
+    BSONObjBuilder bob;
+    bob.append("ts", sample.time);
+    {
+        BSONObjBuilder resource(bob.subobjStart("resource"));
+        resource.append("type", resourceTypeName(sample.resId.getType()));
+        resource.append("id", sample.resId.toString());
+        if (!sample.resourceName.empty()) {
+            resource.append("ns", sample.resourceName);
+        }
+    }
+    bob.append("mode", modeName(sample.mode));
+    bob.append("opType", sample.opType ? sample.opType : "unknown");
+    {
+        BSONArrayBuilder holders(bob.subarrayStart("holders"));
+        for (auto&& holder : sample.holders) {
+            BSONObjBuilder holderBuilder(holders.subobjStart());
+            holderBuilder.append("mode", modeName(holder.mode));
+            holderBuilder.append("opType", holder.opType ? holder.opType : "unknown");
+        }
+    }
+    bob.append("waitMicros", durationCount<Microseconds>(sample.waitTime));
+    bob.append("result", lockResultName(sample.result));
+    return bob.obj();
+}
+
+}  // namespace mongo
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Opt-in profiler of lock waits. LockStats say how long operations waited per resource type and
+ * mode; this records, for a sample of individual waits, which resource was waited on, which
+ * operations were holding it and how long the wait lasted, so that contention can be traced to a
+ * specific collection and workload.
+ *
+ * The profiler is off unless the 'lockContentionSampleRate' server parameter is set to N > 0, in
+ * which case one in every N lock waits is recorded. Only waits are considered, so uncontended lock
+ * acquisitions never pay for it. The last 'lockContentionMaxSamples' samples are kept in a ring.
+ */
+class LockContentionProfiler {
+    MONGO_DISALLOW_COPYING(LockContentionProfiler);
+
+public:
+    /**
+     * A granted request that the sampled waiter had to wait behind.
+     */
+    struct Holder {
+        LockMode mode;
+        const char* opType;
+    };
+
+    struct Sample {
+        Date_t time;
+        ResourceId resId;
+        std::string resourceName;
+        LockMode mode = MODE_NONE;
+        const char* opType = nullptr;
+        std::vector<Holder> holders;
+        Microseconds waitTime;
+        LockResult result = LOCK_INVALID;
+    };
+
+    /**
+     * Lets the lock acquisition on the current thread attribute a wait on 'resId' to a namespace,
+     * since a ResourceId only holds a hash of it. 'name' must outlive this object.
+     */
+    class ScopedResourceName {
+        MONGO_DISALLOW_COPYING(ScopedResourceName);
+
+    public:
+        ScopedResourceName(ResourceId resId, StringData name);
+        ~ScopedResourceName();
+
+    private:
+        const ScopedResourceName* const _previous;
+        const ResourceId _resId;
+        const StringData _name;
+
+        friend class LockContentionProfiler;
+    };
+
+    LockContentionProfiler() = default;
+
+    static LockContentionProfiler& get();
+
+    /**
+     * Returns true if the lock wait which is about to start should be recorded. Cheap when the
+     * profiler is off.
+     */
+    bool shouldSample();
+
+    /**
+     * Returns the name the current thread gave to 'resId' through a ScopedResourceName, or an
+     * empty string.
+     */
+    static StringData getResourceName(ResourceId resId);
+
+    void record(Sample sample);
+
+    /**
+     * Returns the retained samples, oldest first, one document per sample.
+     */
+    std::vector<BSONObj> getSamples() const;
+
+    /**
+     * Appends the number of sampled waits and their total wait time per resource type, for FTDC.
+     */
+    void appendSummary(BSONObjBuilder* builder) const;
+
+    void clear();
+
+private:
+    static BSONObj _toBSON(const Sample& sample);
+
+    AtomicUInt64 _waits;
+
+    mutable stdx::mutex _mutex;
+    std::vector<Sample> _ring;
+    size_t _next = 0;
+
+    // Totals over every sample ever recorded, including those evicted from the ring.
+    long long _sampledWaits[ResourceTypesCount] = {};
+    long long _sampledWaitMicros[ResourceTypesCount] = {};
+};
+
+}  // namespace mongo
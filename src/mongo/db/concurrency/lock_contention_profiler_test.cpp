@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Turns the profiler on with the given sample rate for the lifetime of the fixture.
+ */
+class LockContentionProfilerTest : public unittest::Test {
+public:
+    void setUp() final {
+        setSampleRate(1);
+        LockContentionProfiler::get().clear();
+    }
+
+    void tearDown() final {
+        setSampleRate(0);
+        LockContentionProfiler::get().clear();
+    }
+
+    void setSampleRate(int rate) {
+        auto param = ServerParameterSet::getGlobal()->getMap().find("lockContentionSampleRate");
+        ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+        ASSERT_OK(param->second->setFromString(std::to_string(rate)));
+    }
+};
+
+TEST_F(LockContentionProfilerTest, RecordsWaitWithHolderAndName) {
+    const ResourceId resId(RESOURCE_COLLECTION, "TestDB.collection"_sd);
+
+    LockerImpl holder;
+    holder.setOpType("createIndexes");
+    ASSERT(LOCK_OK == holder.lockGlobal(MODE_IX));
+    ASSERT(LOCK_OK == holder.lock(resId, MODE_X));
+
+    LockerImpl waiter;
+    waiter.setOpType("insert");
+    ASSERT(LOCK_OK == waiter.lockGlobal(MODE_IX));
+    {
+        LockContentionProfiler::ScopedResourceName name(resId, "TestDB.collection");
+        ASSERT(LOCK_TIMEOUT == waiter.lock(resId, MODE_IX, Date_t::now()));
+    }
+
+    auto samples = LockContentionProfiler::get().getSamples();
+    ASSERT_EQ(1U, samples.size());
+    const BSONObj& sample = samples[0];
+    ASSERT_EQ("Collection", sample["resource"]["type"].String());
+    ASSERT_EQ("TestDB.collection", sample["resource"]["ns"].String());
+    ASSERT_EQ("IX", sample["mode"].String());
+    ASSERT_EQ("insert", sample["opType"].String());
+    ASSERT_EQ("timeout", sample["result"].String());
+
+    auto holders = sample["holders"].Array();
+    ASSERT_EQ(1U, holders.size());
+    ASSERT_EQ("X", holders[0]["mode"].String());
+    ASSERT_EQ("createIndexes", holders[0]["opType"].String());
+
+    ASSERT(holder.unlockGlobal());
+    ASSERT(waiter.unlockGlobal());
+}
+
+TEST_F(LockContentionProfilerTest, SamplesOneInEveryNWaits) {
+    const ResourceId resId(RESOURCE_COLLECTION, "TestDB.collection"_sd);
+    setSampleRate(3);
+
+    LockerImpl holder;
+    ASSERT(LOCK_OK == holder.lockGlobal(MODE_IX));
+    ASSERT(LOCK_OK == holder.lock(resId, MODE_X));
+
+    LockerImpl waiter;
+    ASSERT(LOCK_OK == waiter.lockGlobal(MODE_IX));
+    for (int i = 0; i < 6; ++i) {
+        ASSERT(LOCK_TIMEOUT == waiter.lock(resId, MODE_S, Date_t::now()));
+    }
+
+    ASSERT_EQ(2U, LockContentionProfiler::get().getSamples().size());
+
+    BSONObjBuilder summary;
+    LockContentionProfiler::get().appendSummary(&summary);
+    ASSERT_EQ(2, summary.obj()["Collection"]["waits"].numberLong());
+
+    ASSERT(holder.unlockGlobal());
+    ASSERT(waiter.unlockGlobal());
+}
+
+TEST_F(LockContentionProfilerTest, DisabledByDefault) {
+    const ResourceId resId(RESOURCE_COLLECTION, "TestDB.collection"_sd);
+    setSampleRate(0);
+
+    LockerImpl holder;
+    ASSERT(LOCK_OK == holder.lockGlobal(MODE_IX));
+    ASSERT(LOCK_OK == holder.lock(resId, MODE_X));
+
+    LockerImpl waiter;
+    ASSERT(LOCK_OK == waiter.lockGlobal(MODE_IX));
+    ASSERT(LOCK_TIMEOUT == waiter.lock(resId, MODE_S, Date_t::now()));
+
+    ASSERT_EQ(0U, LockContentionProfiler::get().getSamples().size());
+
+    ASSERT(holder.unlockGlobal());
+    ASSERT(waiter.unlockGlobal());
+}
+
+TEST_F(LockContentionProfilerTest, NameIsOnlyGivenToTheMatchingResource) {
+    const ResourceId resId(RESOURCE_COLLECTION, "TestDB.collection"_sd);
+    const ResourceId otherResId(RESOURCE_COLLECTION, "TestDB.other"_sd);
+
+    LockContentionProfiler::ScopedResourceName name(resId, "TestDB.collection");
+    ASSERT_EQ("TestDB.collection", LockContentionProfiler::getResourceName(resId));
+    ASSERT_EQ("", LockContentionProfiler::getResourceName(otherResId));
+}
+
+}  // namespace
+}  // namespace mongo
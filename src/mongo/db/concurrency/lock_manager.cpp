@@ -41,6 +41,7 @@
 #include "mongo/config.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -319,13 +320,31 @@ void LockHead::decConflictModeCount(LockMode mode) {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+namespace {
+
+/**
+ * Balance scalability of intent locks against potential added cost of conflicting locks, which
+ * have to visit every partition in which the resource has intent locks. A fixed count stops
+ * scaling once there are more cores than partitions, as lockers then start sharing partitions,
+ * so use at least two partitions per core, rounded up to a power of two.
+ */
+unsigned numPartitionsForCores(unsigned numCores) {
+    const unsigned kMinPartitions = 32;
+    const unsigned kMaxPartitions = 1024;
 
-LockManager::LockManager() {
+    unsigned numPartitions = kMinPartitions;
+    while (numPartitions < 2 * numCores && numPartitions < kMaxPartitions) {
+        numPartitions *= 2;
+    }
+    return numPartitions;
+}
+
+}  // namespace
+
+LockManager::LockManager()
+    : _numPartitions(numPartitionsForCores(stdx::thread::hardware_concurrency())),
+      _partitions(_numPartitions) {
     _lockBuckets = new LockBucket[_numLockBuckets];
-    _partitions = new Partition[_numPartitions];
 }
 
 LockManager::~LockManager() {
@@ -337,7 +356,6 @@ LockManager::~LockManager() {
     }
 
     delete[] _lockBuckets;
-    delete[] _partitions;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -719,7 +737,7 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
 }
 
 LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+    return &_partitions[request->locker->getId() & (_numPartitions - 1)];
 }
 
 void LockManager::dump() const {
@@ -799,6 +817,41 @@ void LockManager::getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClien
     result->append("lockInfo", lockInfo.arr());
 }
 
+std::vector<LockContentionProfiler::Holder> LockManager::getHolders(ResourceId resId,
+                                                                   size_t maxHolders) {
+    std::vector<LockContentionProfiler::Holder> holders;
+
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    LockBucket::Map::iterator it = bucket->data.find(resId);
+    if (it == bucket->data.end()) {
+        return holders;
+    }
+
+    // A conflicting request migrates the partitioned lock heads into the LockHead before it
+    // queues, so the granted list holds every request that a waiter can be queued behind.
+    for (const LockRequest* iter = it->second->grantedList._front;
+         iter != nullptr && holders.size() < maxHolders;
+         iter = iter->next) {
+        holders.push_back({iter->mode, iter->locker->getOpType()});
+    }
+    return holders;
+}
+
+bool LockManager::hasWaiters(ResourceId resId) {
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    LockBucket::Map::iterator it = bucket->data.find(resId);
+    if (it == bucket->data.end()) {
+        return false;
+    }
+
+    // A partitioned lock has only intent mode requests, all of which are granted.
+    return it->second->conflictModes || it->second->conversionsCount;
+}
+
 void LockManager::_dumpBucket(const LockBucket* bucket) const {
     for (LockBucket::Map::const_iterator it = bucket->data.begin(); it != bucket->data.end();
          it++) {
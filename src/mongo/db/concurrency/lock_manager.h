@@ -33,8 +33,11 @@
 #include <map>
 #include <vector>
 
+#include <boost/align/aligned_allocator.hpp>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/config.h"
+#include "mongo/db/concurrency/lock_contention_profiler.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_request_list.h"
 #include "mongo/platform/atomic_word.h"
@@ -43,6 +46,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -133,6 +137,17 @@ public:
     void getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClientMap,
                          BSONObjBuilder* result);
 
+    /**
+     * Returns the mode and the owner's operation type of the requests currently granted on
+     * 'resId', up to 'maxHolders' of them.
+     */
+    std::vector<LockContentionProfiler::Holder> getHolders(ResourceId resId, size_t maxHolders);
+
+    /**
+     * Returns whether any request on 'resId' is waiting to be granted or converted.
+     */
+    bool hasWaiters(ResourceId resId);
+
 private:
     // The deadlock detector needs to access the buckets and locks directly
     friend class DeadlockDetector;
@@ -155,7 +170,8 @@ private:
 
     // Each locker maps to a partition that is used for resources acquired in intent modes
     // modes and potentially other modes that don't conflict with themselves. This avoids
-    // contention on the regular LockHead in the lock manager.
+    // contention on the regular LockHead in the lock manager. Partitions are cache aligned, so
+    // that lockers using neighbouring partitions don't contend on the same cache line either.
     struct Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
@@ -220,8 +236,13 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
-    Partition* _partitions;
+    // A power of two, so that _getPartition() can mask rather than divide.
+    const unsigned _numPartitions;
+    using AlignedPartition = CacheAligned<Partition>;
+    // Mutable for the same reason the buckets are reachable from const methods: the partitions
+    // carry their own mutexes and are handed out by _getPartition() const.
+    mutable std::vector<AlignedPartition, boost::alignment::aligned_allocator<AlignedPartition>>
+        _partitions;
 };
 
 
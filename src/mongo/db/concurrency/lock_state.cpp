@@ -32,8 +32,10 @@
 
 #include "mongo/db/concurrency/lock_state.h"
 
+#include <boost/optional.hpp>
 #include <vector>
 
+#include "mongo/db/concurrency/lock_contention_profiler.h"
 #include "mongo/db/concurrency/replication_lock_manager_manipulator.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
@@ -115,6 +117,9 @@ const ResourceId resourceIdGlobal = ResourceId(RESOURCE_GLOBAL, ResourceId::SING
 // How often (in millis) to check for deadlock if a lock has not been granted for some time
 const Milliseconds DeadlockTimeout = Milliseconds(500);
 
+// How many of the holders of a resource to record for a sampled lock wait
+const size_t kMaxContentionHolders = 8;
+
 // Dispenses unique LockerId identifiers
 AtomicUInt64 idCounter(0);
 
@@ -238,6 +243,7 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 
 namespace {
 TicketHolder* ticketHolders[LockModesCount] = {};
+AtomicBool globalThrottlingAdaptive(false);
 }  // namespace
 
 
@@ -252,6 +258,21 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
     ticketHolders[MODE_IX] = writing;
 }
 
+/* static */
+TicketHolder* Locker::getGlobalThrottling(LockMode mode) {
+    return ticketHolders[mode];
+}
+
+/* static */
+void Locker::setGlobalThrottlingAdaptive(bool adaptive) {
+    globalThrottlingAdaptive.store(adaptive);
+}
+
+/* static */
+bool Locker::isGlobalThrottlingAdaptive() {
+    return globalThrottlingAdaptive.load();
+}
+
 LockerImpl::LockerImpl()
     : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {}
 
@@ -550,6 +571,24 @@ ResourceId LockerImpl::getWaitingResource() const {
     return ResourceId();
 }
 
+bool LockerImpl::hasConflictingWaiters() const {
+    if (_modeForTicket != MODE_NONE && _clientState.load() != kInactive) {
+        auto holder = shouldAcquireTicket() ? ticketHolders[_modeForTicket] : nullptr;
+        if (holder && holder->waiters() > 0) {
+            return true;
+        }
+    }
+
+    // Only this locker's thread adds or removes its requests, so there is no need to take _lock,
+    // which is meant for other threads reading them.
+    for (auto it = _requests.begin(); !it.finished(); it.next()) {
+        if (it->status == LockRequest::STATUS_GRANTED && globalLockManager.hasWaiters(it.key())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void LockerImpl::getLockerInfo(LockerInfo* lockerInfo,
                                const boost::optional<SingleThreadedLockStats> lockStatsBase) const {
     invariant(lockerInfo);
@@ -812,7 +851,7 @@ LockResult LockerImpl::lockBegin(OperationContext* opCtx, ResourceId resId, Lock
 LockResult LockerImpl::lockComplete(
     OperationContext* opCtx, ResourceId resId, LockMode mode, Date_t deadline, bool checkDeadlock) {
 
-    LockResult result;
+    LockResult result = LOCK_INVALID;
     Milliseconds timeout;
     if (deadline == Date_t::max()) {
         timeout = Milliseconds::max();
@@ -835,6 +874,28 @@ LockResult LockerImpl::lockComplete(
     const uint64_t startOfTotalWaitTime = curTimeMicros64();
     uint64_t startOfCurrentWaitTime = startOfTotalWaitTime;
 
+    // The holders are captured now, since by the time the wait ends they may be gone. A sampled
+    // wait is recorded however it ends, including by interruption.
+    auto& contentionProfiler = LockContentionProfiler::get();
+    boost::optional<LockContentionProfiler::Sample> contentionSample;
+    if (contentionProfiler.shouldSample()) {
+        contentionSample.emplace();
+        contentionSample->time = Date_t::now();
+        contentionSample->resId = resId;
+        contentionSample->resourceName = LockContentionProfiler::getResourceName(resId).toString();
+        contentionSample->mode = mode;
+        contentionSample->opType = getOpType();
+        contentionSample->holders = globalLockManager.getHolders(resId, kMaxContentionHolders);
+    }
+    ON_BLOCK_EXIT([&] {
+        if (contentionSample) {
+            contentionSample->waitTime =
+                Microseconds(static_cast<int64_t>(curTimeMicros64() - startOfTotalWaitTime));
+            contentionSample->result = result;
+            contentionProfiler.record(std::move(*contentionSample));
+        }
+    });
+
     // Clean up the state on any failed lock attempts.
     auto unlockOnErrorGuard = MakeGuard([&] {
         LockRequestsMap::Iterator it = _requests.find(resId);
@@ -181,6 +181,8 @@ public:
 
     virtual ResourceId getWaitingResource() const;
 
+    virtual bool hasConflictingWaiters() const;
+
     virtual void getLockerInfo(LockerInfo* lockerInfo,
                                const boost::optional<SingleThreadedLockStats> lockStatsBase) const;
     virtual boost::optional<LockerInfo> getLockerInfo(
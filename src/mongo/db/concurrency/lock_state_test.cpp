@@ -537,6 +537,52 @@ TEST(LockerImpl, GetLockerInfoShouldReportPendingLocks) {
     ASSERT(conflictingLocker.unlockGlobal());
 }
 
+TEST(LockerImpl, HasConflictingWaitersOnlyWhileALockHeldIsWaitedFor) {
+    const ResourceId dbId(RESOURCE_DATABASE, "TestDB"_sd);
+    const ResourceId collectionId(RESOURCE_COLLECTION, "TestDB.collection"_sd);
+    const ResourceId otherCollectionId(RESOURCE_COLLECTION, "TestDB.other"_sd);
+
+    LockerImpl reader;
+    ASSERT_EQ(LOCK_OK, reader.lockGlobal(MODE_IS));
+    ASSERT_EQ(LOCK_OK, reader.lock(dbId, MODE_IS));
+    ASSERT_EQ(LOCK_OK, reader.lock(collectionId, MODE_IS));
+    ASSERT_FALSE(reader.hasConflictingWaiters());
+
+    // Compatible lockers and waiters on other resources do not count.
+    LockerImpl otherReader;
+    ASSERT_EQ(LOCK_OK, otherReader.lockGlobal(MODE_IS));
+    ASSERT_EQ(LOCK_OK, otherReader.lock(dbId, MODE_IS));
+    ASSERT_EQ(LOCK_OK, otherReader.lock(collectionId, MODE_IS));
+    ASSERT_EQ(LOCK_OK, otherReader.lock(otherCollectionId, MODE_X));
+
+    LockerImpl otherWriter;
+    ASSERT_EQ(LOCK_OK, otherWriter.lockGlobal(MODE_IX));
+    ASSERT_EQ(LOCK_OK, otherWriter.lock(dbId, MODE_IX));
+    ASSERT_EQ(LOCK_WAITING, otherWriter.lockBegin(nullptr, otherCollectionId, MODE_IX));
+    ASSERT_FALSE(reader.hasConflictingWaiters());
+    otherWriter.unlock(otherCollectionId);
+
+    // A writer queued behind the collection lock does.
+    ASSERT_EQ(LOCK_WAITING, otherWriter.lockBegin(nullptr, collectionId, MODE_X));
+    ASSERT(reader.hasConflictingWaiters());
+    ASSERT(otherReader.hasConflictingWaiters());
+    ASSERT_FALSE(otherWriter.hasConflictingWaiters());
+
+    // Until it gives up.
+    otherWriter.unlock(collectionId);
+    ASSERT_FALSE(reader.hasConflictingWaiters());
+
+    ASSERT(otherWriter.unlock(dbId));
+    ASSERT(otherWriter.unlockGlobal());
+    ASSERT(otherReader.unlock(otherCollectionId));
+    ASSERT(otherReader.unlock(collectionId));
+    ASSERT(otherReader.unlock(dbId));
+    ASSERT(otherReader.unlockGlobal());
+    ASSERT(reader.unlock(collectionId));
+    ASSERT(reader.unlock(dbId));
+    ASSERT(reader.unlockGlobal());
+}
+
 TEST(LockerImpl, ReaquireLockPendingUnlock) {
     const ResourceId resId(RESOURCE_COLLECTION, "TestDB.collection"_sd);
 
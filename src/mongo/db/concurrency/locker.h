@@ -34,6 +34,7 @@
 #include "mongo/db/concurrency/lock_manager.h"
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/thread.h"
 
 namespace mongo {
@@ -73,6 +74,19 @@ public:
      */
     static void setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing);
 
+    /**
+     * Returns the ticket holder throttling global lock attempts in 'mode', or nullptr if that mode
+     * is not throttled.
+     */
+    static class TicketHolder* getGlobalThrottling(LockMode mode);
+
+    /**
+     * Records whether the storage engine is currently resizing the ticket holders passed to
+     * setGlobalThrottling() at runtime, which may leave very few tickets available under load.
+     */
+    static void setGlobalThrottlingAdaptive(bool adaptive);
+    static bool isGlobalThrottlingAdaptive();
+
     /**
      * State for reporting the number of active and queued reader and writer clients.
      */
@@ -97,6 +111,19 @@ public:
      */
     virtual void updateThreadIdToCurrentThread() = 0;
 
+    /**
+     * Names the type of operation which owns this locker, for attributing lock contention to it.
+     * 'opType' must have static storage duration, such as a command's name. Other threads may
+     * read it while they wait for a lock held by this locker.
+     */
+    void setOpType(const char* opType) {
+        _opType.store(opType);
+    }
+
+    const char* getOpType() const {
+        return _opType.load();
+    }
+
     /**
      * Clears any cached thread id values.
      */
@@ -277,6 +304,13 @@ public:
      */
     virtual ResourceId getWaitingResource() const = 0;
 
+    /**
+     * Returns whether another operation is queued behind a lock this locker holds, or behind the
+     * ticket it holds. Takes a lock manager mutex per lock held, so it is meant to be polled
+     * occasionally, for instance to decide whether to yield.
+     */
+    virtual bool hasConflictingWaiters() const = 0;
+
     /**
      * Describes a single lock acquisition for reporting/serialization purposes.
      */
@@ -478,6 +512,7 @@ protected:
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    AtomicWord<const char*> _opType{nullptr};
 };
 
 /**
@@ -157,6 +157,10 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    virtual bool hasConflictingWaiters() const {
+        return false;
+    }
+
     virtual void getLockerInfo(LockerInfo* lockerInfo,
                                boost::optional<SingleThreadedLockStats> lockStatsBase) const {
         MONGO_UNREACHABLE;
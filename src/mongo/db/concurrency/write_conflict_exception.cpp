@@ -31,6 +31,7 @@
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kWrite
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/concurrency/write_conflict_tracker.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stacktrace.h"
@@ -50,6 +51,11 @@ void WriteConflictException::logAndBackoff(int attempt, StringData operation, St
     LOG(1) << "Caught WriteConflictException doing " << operation << " on " << ns
            << ", attempt: " << attempt << " retrying";
 
+    if (auto backoff = WriteConflictTracker::get().onRetry(ns, attempt)) {
+        sleepmicros(durationCount<Microseconds>(*backoff));
+        return;
+    }
+
     // All numbers below chosen by guess and check against a few random benchmarks.
     if (attempt < 4) {
         // no-op
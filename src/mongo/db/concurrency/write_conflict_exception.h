@@ -49,7 +49,8 @@ public:
 
     /**
      * Will log a message if sensible and will do an exponential backoff to make sure
-     * we don't hammer the same doc over and over.
+     * we don't hammer the same doc over and over. If the current thread last conflicted on a hot
+     * document, the backoff is the WriteConflictTracker's adaptive one instead.
      * @param attempt - what attempt is this, 1 based
      * @param operation - e.g. "update"
      */
@@ -0,0 +1,244 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/write_conflict_tracker.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/clock_source.h"
+#include "mongo/util/system_clock_source.h"
+
+namespace mongo {
+namespace {
+
+// The number of recent conflicts after which a document is hot, so that writers conflicting on it
+// back off adaptively. Zero turns the adaptive backoff off.
+MONGO_EXPORT_SERVER_PARAMETER(writeConflictHotDocumentThreshold, int, 10)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "writeConflictHotDocumentThreshold must be non-negative");
+        }
+        return Status::OK();
+    });
+
+const Milliseconds kMaxHotDocumentBackoff(100);
+
+WriteConflictTracker globalWriteConflictTracker(SystemClockSource::get());
+
+// The document the current thread last conflicted on, for its next retry.
+struct LastDocumentConflict {
+    std::string ns;
+    long long recentConflicts = 0;
+};
+thread_local LastDocumentConflict lastDocumentConflict;
+
+}  // namespace
+
+const Seconds WriteConflictTracker::kDecayPeriod(10);
+
+WriteConflictTracker::WriteConflictTracker(ClockSource* clockSource)
+    : _clockSource(clockSource), _random(SecureRandom::create()->nextInt64()) {
+    _lastDecay = _clockSource->now();
+}
+
+WriteConflictTracker& WriteConflictTracker::get() {
+    return globalWriteConflictTracker;
+}
+
+void WriteConflictTracker::recordDocumentConflict(StringData ns,
+                                                  const RecordId& rid,
+                                                  const BSONObj& doc) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _decay(lk);
+
+    auto it = std::find_if(_documents.begin(), _documents.end(), [&](const DocumentEntry& entry) {
+        return entry.rid == rid && entry.ns == ns;
+    });
+    if (it == _documents.end()) {
+        DocumentEntry entry{ns.toString(), rid, doc["_id"].wrap(), 1};
+        if (_documents.size() < kMaxTrackedEntries) {
+            it = _documents.insert(_documents.end(), std::move(entry));
+        } else {
+            // Take over the coldest entry, and its count, so that a document which keeps
+            // conflicting is not repeatedly evicted by a stream of one-off conflicts.
+            it = std::min_element(_documents.begin(),
+                                  _documents.end(),
+                                  [](const DocumentEntry& lhs, const DocumentEntry& rhs) {
+                                      return lhs.recentConflicts < rhs.recentConflicts;
+                                  });
+            entry.recentConflicts = it->recentConflicts + 1;
+            *it = std::move(entry);
+        }
+    } else {
+        ++it->recentConflicts;
+    }
+
+    lastDocumentConflict.ns = it->ns;
+    lastDocumentConflict.recentConflicts = it->recentConflicts;
+}
+
+boost::optional<Microseconds> WriteConflictTracker::onRetry(StringData ns, int attempt) {
+    const long long documentConflicts =
+        lastDocumentConflict.ns == ns ? lastDocumentConflict.recentConflicts : 0;
+    lastDocumentConflict.recentConflicts = 0;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _decay(lk);
+    ++_totalRetries;
+
+    auto it = std::find_if(_namespaces.begin(),
+                           _namespaces.end(),
+                           [&](const NamespaceEntry& entry) { return entry.ns == ns; });
+    if (it != _namespaces.end()) {
+        ++it->recentConflicts;
+    } else if (_namespaces.size() < kMaxTrackedEntries) {
+        _namespaces.push_back({ns.toString(), 1});
+    } else {
+        it = std::min_element(_namespaces.begin(),
+                              _namespaces.end(),
+                              [](const NamespaceEntry& lhs, const NamespaceEntry& rhs) {
+                                  return lhs.recentConflicts < rhs.recentConflicts;
+                              });
+        *it = {ns.toString(), it->recentConflicts + 1};
+    }
+
+    const int threshold = writeConflictHotDocumentThreshold.load();
+    if (threshold == 0 || documentConflicts < threshold) {
+        return boost::none;
+    }
+    return _hotDocumentBackoff(lk, attempt);
+}
+
+void WriteConflictTracker::report(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _decay(lk);
+
+    builder->append("totalRetries", _totalRetries);
+
+    std::vector<const NamespaceEntry*> namespaces;
+    for (auto&& entry : _namespaces) {
+        namespaces.push_back(&entry);
+    }
+    const size_t numNamespaces = std::min(namespaces.size(), kReportedEntries);
+    std::partial_sort(namespaces.begin(),
+                      namespaces.begin() + numNamespaces,
+                      namespaces.end(),
+                      [](const NamespaceEntry* lhs, const NamespaceEntry* rhs) {
+                          return lhs->recentConflicts > rhs->recentConflicts;
+                      });
+    {
+        BSONArrayBuilder arr(builder->subarrayStart("namespaces"));
+        for (size_t i = 0; i < numNamespaces; ++i) {
+            BSONObjBuilder entry(arr.subobjStart());
+            entry.append("ns", namespaces[i]->ns);
+            entry.append("recentConflicts", namespaces[i]->recentConflicts);
+        }
+    }
+
+    std::vector<const DocumentEntry*> documents;
+    for (auto&& entry : _documents) {
+        documents.push_back(&entry);
+    }
+    const size_t numDocuments = std::min(documents.size(), kReportedEntries);
+    std::partial_sort(documents.begin(),
+                      documents.begin() + numDocuments,
+                      documents.end(),
+                      [](const DocumentEntry* lhs, const DocumentEntry* rhs) {
+                          return lhs->recentConflicts > rhs->recentConflicts;
+                      });
+    {
+        BSONArrayBuilder arr(builder->subarrayStart("documents"));
+        for (size_t i = 0; i < numDocuments; ++i) {
+            BSONObjBuilder entry(arr.subobjStart());
+            entry.append("ns", documents[i]->ns);
+            entry.appendElements(documents[i]->id);
+            entry.append("recentConflicts", documents[i]->recentConflicts);
+        }
+    }
+}
+
+void WriteConflictTracker::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _lastDecay = _clockSource->now();
+    _totalRetries = 0;
+    _namespaces.clear();
+    _documents.clear();
+}
+
+void WriteConflictTracker::_decay(WithLock) {
+    const Date_t now = _clockSource->now();
+    int halvings = 0;
+    while (now - _lastDecay >= kDecayPeriod && halvings < 63) {
+        _lastDecay += kDecayPeriod;
+        ++halvings;
+    }
+    if (halvings == 0) {
+        return;
+    }
+    if (now - _lastDecay >= kDecayPeriod) {
+        _lastDecay = now;
+    }
+
+    for (auto&& entry : _namespaces) {
+        entry.recentConflicts >>= halvings;
+    }
+    _namespaces.erase(std::remove_if(_namespaces.begin(),
+                                     _namespaces.end(),
+                                     [](const NamespaceEntry& entry) {
+                                         return entry.recentConflicts == 0;
+                                     }),
+                      _namespaces.end());
+
+    for (auto&& entry : _documents) {
+        entry.recentConflicts >>= halvings;
+    }
+    _documents.erase(std::remove_if(_documents.begin(),
+                                    _documents.end(),
+                                    [](const DocumentEntry& entry) {
+                                        return entry.recentConflicts == 0;
+                                    }),
+                     _documents.end());
+}
+
+Microseconds WriteConflictTracker::_hotDocumentBackoff(WithLock, int attempt) {
+    // Double the backoff with every attempt, from 1ms up to kMaxHotDocumentBackoff, and wait for
+    // a random time between half of it and all of it so that the retries of the writers on the
+    // document spread out rather than collide again.
+    const int doublings = std::min(std::max(attempt, 0), 7);
+    const Microseconds cap =
+        std::min<Microseconds>(Milliseconds(1) * (1 << doublings), kMaxHotDocumentBackoff);
+    const auto half = durationCount<Microseconds>(cap) / 2;
+    return Microseconds(half + _random.nextInt64(half + 1));
+}
+
+}  // namespace mongo
@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ClockSource;
+
+/**
+ * Tracks where write conflicts happen, so that writers which keep conflicting on the same hot
+ * document back off adaptively, and so that the documents and namespaces with the most recent
+ * conflicts can be reported in serverStatus.
+ *
+ * Every retry after a WriteConflictException is counted against its namespace. Write stages which
+ * know the document they conflicted on also count the conflict against that document, and the
+ * thread's next retry then backs off according to how hot the document is. Counts are halved every
+ * kDecayPeriod, so they reflect recent contention, and each table keeps at most kMaxTrackedEntries
+ * entries, replacing the coldest entry when a new one is needed.
+ */
+class WriteConflictTracker {
+    MONGO_DISALLOW_COPYING(WriteConflictTracker);
+
+public:
+    static const size_t kMaxTrackedEntries = 256;
+    static const size_t kReportedEntries = 10;
+    static const Seconds kDecayPeriod;
+
+    explicit WriteConflictTracker(ClockSource* clockSource);
+
+    static WriteConflictTracker& get();
+
+    /**
+     * Counts a write conflict on the document 'doc', at 'rid' in 'ns', and remembers its recent
+     * conflicts for the current thread's next retry. Only the _id of 'doc' is kept.
+     */
+    void recordDocumentConflict(StringData ns, const RecordId& rid, const BSONObj& doc);
+
+    /**
+     * Counts the retry of a write on 'ns' which conflicted, where 'attempt' is the number of
+     * conflicts in a row. If the current thread's last document conflict was on a hot document in
+     * 'ns', returns how long to back off before retrying; otherwise returns boost::none, and the
+     * caller uses its usual backoff.
+     */
+    boost::optional<Microseconds> onRetry(StringData ns, int attempt);
+
+    /**
+     * Appends the total number of retries and the namespaces and documents with the most recent
+     * conflicts.
+     */
+    void report(BSONObjBuilder* builder);
+
+    void clear();
+
+private:
+    struct NamespaceEntry {
+        std::string ns;
+        long long recentConflicts;
+    };
+
+    struct DocumentEntry {
+        std::string ns;
+        RecordId rid;
+        BSONObj id;
+        long long recentConflicts;
+    };
+
+    /**
+     * Halves every count once for each kDecayPeriod that has passed since the last decay.
+     */
+    void _decay(WithLock);
+
+    /**
+     * Returns a random backoff for a writer conflicting on a hot document, which grows with
+     * 'attempt' up to a cap.
+     */
+    Microseconds _hotDocumentBackoff(WithLock, int attempt);
+
+    ClockSource* const _clockSource;
+
+    stdx::mutex _mutex;
+    PseudoRandom _random;
+    Date_t _lastDecay;
+    long long _totalRetries = 0;
+    std::vector<NamespaceEntry> _namespaces;
+    std::vector<DocumentEntry> _documents;
+};
+
+}  // namespace mongo
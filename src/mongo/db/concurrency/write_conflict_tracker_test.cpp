@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/write_conflict_tracker.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+class WriteConflictTrackerTest : public unittest::Test {
+protected:
+    BSONObj report() {
+        BSONObjBuilder builder;
+        _tracker.report(&builder);
+        return builder.obj();
+    }
+
+    /**
+     * Records 'times' conflicts on the document with _id 'rid', each followed by a first retry.
+     */
+    void recordConflicts(StringData ns, long long rid, int times) {
+        for (int i = 0; i < times; ++i) {
+            _tracker.recordDocumentConflict(ns, RecordId(rid), BSON("_id" << rid << "x" << i));
+            _tracker.onRetry(ns, 0);
+        }
+    }
+
+    ClockSourceMock _clock;
+    WriteConflictTracker _tracker{&_clock};
+};
+
+TEST_F(WriteConflictTrackerTest, ReportsTheMostConflictedNamespacesAndDocuments) {
+    recordConflicts("test.a", 1, 3);
+    recordConflicts("test.b", 1, 5);
+    recordConflicts("test.b", 2, 1);
+    _tracker.onRetry("test.c", 1);
+
+    ASSERT_BSONOBJ_EQ(report(),
+                      fromjson("{totalRetries: 10,"
+                               " namespaces: [{ns: 'test.b', recentConflicts: 6},"
+                               "              {ns: 'test.a', recentConflicts: 3},"
+                               "              {ns: 'test.c', recentConflicts: 1}],"
+                               " documents: [{ns: 'test.b', _id: 1, recentConflicts: 5},"
+                               "             {ns: 'test.a', _id: 1, recentConflicts: 3},"
+                               "             {ns: 'test.b', _id: 2, recentConflicts: 1}]}"));
+}
+
+TEST_F(WriteConflictTrackerTest, ReportsAtMostTheTopEntries) {
+    for (size_t i = 0; i < 2 * WriteConflictTracker::kReportedEntries; ++i) {
+        recordConflicts("test.a", i, i + 1);
+    }
+
+    auto documents = report()["documents"].Array();
+    ASSERT_EQ(WriteConflictTracker::kReportedEntries, documents.size());
+    ASSERT_EQ(2 * WriteConflictTracker::kReportedEntries - 1, documents[0]["_id"].numberLong());
+}
+
+TEST_F(WriteConflictTrackerTest, CountsDecayOverTime) {
+    recordConflicts("test.a", 1, 4);
+    recordConflicts("test.a", 2, 1);
+
+    _clock.advance(WriteConflictTracker::kDecayPeriod);
+    ASSERT_BSONOBJ_EQ(report(),
+                      fromjson("{totalRetries: 5,"
+                               " namespaces: [{ns: 'test.a', recentConflicts: 2}],"
+                               " documents: [{ns: 'test.a', _id: 1, recentConflicts: 2}]}"));
+
+    _clock.advance(WriteConflictTracker::kDecayPeriod * 10);
+    ASSERT_BSONOBJ_EQ(report(), fromjson("{totalRetries: 5, namespaces: [], documents: []}"));
+}
+
+TEST_F(WriteConflictTrackerTest, HotDocumentKeepsItsEntryWhenTheTableIsFull) {
+    recordConflicts("test.a", -1, 5);
+    for (size_t i = 0; i < WriteConflictTracker::kMaxTrackedEntries; ++i) {
+        recordConflicts("test.a", i, 1);
+    }
+
+    auto documents = report()["documents"].Array();
+    ASSERT_EQ(-1, documents[0]["_id"].numberLong());
+    ASSERT_EQ(5, documents[0]["recentConflicts"].numberLong());
+    ASSERT_EQ(2, documents[1]["recentConflicts"].numberLong());
+}
+
+TEST_F(WriteConflictTrackerTest, BacksOffAdaptivelyOnlyOnHotDocuments) {
+    // Below the default threshold of 10 recent conflicts, the usual backoff applies.
+    for (int i = 0; i < 9; ++i) {
+        _tracker.recordDocumentConflict("test.a", RecordId(1), BSON("_id" << 1));
+        ASSERT_FALSE(_tracker.onRetry("test.a", i));
+    }
+
+    _tracker.recordDocumentConflict("test.a", RecordId(1), BSON("_id" << 1));
+    auto backoff = _tracker.onRetry("test.a", 0);
+    ASSERT(backoff);
+    ASSERT_GTE(*backoff, Microseconds(500));
+    ASSERT_LTE(*backoff, Milliseconds(1));
+
+    _tracker.recordDocumentConflict("test.a", RecordId(1), BSON("_id" << 1));
+    backoff = _tracker.onRetry("test.a", 20);
+    ASSERT(backoff);
+    ASSERT_GTE(*backoff, Milliseconds(50));
+    ASSERT_LTE(*backoff, Milliseconds(100));
+
+    // A retry that did not follow a conflict on the hot document, or that is on another
+    // namespace, backs off as usual.
+    ASSERT_FALSE(_tracker.onRetry("test.a", 1));
+    _tracker.recordDocumentConflict("test.a", RecordId(1), BSON("_id" << 1));
+    ASSERT_FALSE(_tracker.onRetry("test.b", 1));
+}
+
+}  // namespace
+}  // namespace mongo
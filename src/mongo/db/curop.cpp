@@ -46,6 +46,8 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_memory_tracker.h"
+#include "mongo/db/storage/recovery_unit.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/metadata/impersonated_user_metadata.h"
@@ -67,6 +69,19 @@ const std::vector<const char*> kDollarQueryModifiers = {
     "$hint", "$comment", "$max", "$min", "$returnKey", "$showDiskLoc", "$snapshot", "$maxTimeMS",
 };
 
+BSONObj stageTimesToBSON(const std::map<std::string, long long>& stageTimesNanos) {
+    BSONObjBuilder bob;
+    for (auto&& stageTime : stageTimesNanos) {
+        bob.appendNumber(stageTime.first, stageTime.second);
+    }
+    return bob.obj();
+}
+
+std::shared_ptr<StorageStats> getStorageStatsSnapshot(OperationContext* opCtx) {
+    auto recoveryUnit = opCtx->recoveryUnit();
+    return recoveryUnit ? recoveryUnit->getOperationStatistics() : nullptr;
+}
+
 }  // namespace
 
 BSONObj upconvertQueryEntry(const BSONObj& query,
@@ -291,18 +306,43 @@ void CurOp::reportCurrentOpForClient(OperationContext* opCtx,
         }
 
         CurOp::get(clientOpCtx)->reportState(infoBuilder, truncateOps);
+
+        // Only operations running blocking query stages use memory which is accounted for.
+        auto memoryTracker = QueryMemoryTracker::get(clientOpCtx);
+        if (auto peakBytes = memoryTracker->peakBytes()) {
+            infoBuilder->append("queryMemoryBytes", memoryTracker->currentBytes());
+            infoBuilder->append("queryMemoryPeakBytes", peakBytes);
+        }
     }
 }
 
+void CurOp::setPlanStageTimes_inlock(const std::map<std::string, long long>& stageTimesNanos) {
+    _planStageTimesNanos = stageTimesToBSON(stageTimesNanos);
+}
+
 void CurOp::setGenericCursor_inlock(GenericCursor gc) {
     _genericCursor = std::move(gc);
 }
 
+void CurOp::updateStorageStats(OperationContext* opCtx) {
+    if (!_storageStatsBase) {
+        return;
+    }
+
+    auto current = getStorageStatsSnapshot(opCtx);
+    auto storageStats = current ? current->since(*_storageStatsBase) : nullptr;
+
+    stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+    _debug.storageStats = std::move(storageStats);
+}
+
 CurOp::CurOp(OperationContext* opCtx) : CurOp(opCtx, &_curopStack(opCtx)) {
     // If this is a sub-operation, we store the snapshot of lock stats as the base lock stats of the
     // current operation.
-    if (_parent != nullptr)
+    if (_parent != nullptr) {
         _lockStatsBase = opCtx->lockState()->getLockerInfo(boost::none)->stats;
+        _storageStatsBase = getStorageStatsSnapshot(opCtx);
+    }
 }
 
 CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack) : _stack(stack) {
@@ -330,6 +370,16 @@ void CurOp::setGenericOpRequestDetails(OperationContext* opCtx,
     const bool isCommand = (op == dbMsg || (op == dbQuery && nss.isCommand()));
     auto logicalOp = (command ? command->getLogicalOp() : networkOpToLogicalOp(op));
 
+    if (auto locker = opCtx->lockState()) {
+        locker->setOpType(command ? command->getName().c_str() : logicalOpToString(logicalOp));
+    }
+
+    // The top-level CurOp is created along with the OperationContext, so this is the earliest point
+    // at which its storage statistics can be snapshotted.
+    if (!_storageStatsBase) {
+        _storageStatsBase = getStorageStatsSnapshot(opCtx);
+    }
+
     stdx::lock_guard<Client> clientLock(*opCtx->getClient());
     _isCommand = _debug.iscommand = isCommand;
     _logicalOp = _debug.logicalOp = logicalOp;
@@ -363,7 +413,7 @@ void CurOp::setNS_inlock(StringData ns) {
 
 void CurOp::ensureStarted() {
     if (_start == 0) {
-        _start = curTimeMicros64();
+        _start = _nowMicros();
     }
 }
 
@@ -396,19 +446,28 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     }
 
     // Obtain the total execution time of this operation.
-    _end = curTimeMicros64();
+    _end = _nowMicros();
     _debug.executionTimeMicros = durationCount<Microseconds>(elapsedTimeExcludingPauses());
 
     const bool shouldSample =
         client->getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
 
-    if (shouldLogOp || (shouldSample && _debug.executionTimeMicros > slowMs * 1000LL)) {
+    const bool shouldLogSlowOp =
+        shouldLogOp || (shouldSample && _debug.executionTimeMicros > slowMs * 1000LL);
+    const bool shouldProfile = shouldDBProfile(shouldSample);
+
+    // Only gather storage statistics for operations which will actually report them.
+    if (shouldLogSlowOp || shouldProfile) {
+        updateStorageStats(opCtx);
+    }
+
+    if (shouldLogSlowOp) {
         auto lockerInfo = opCtx->lockState()->getLockerInfo(_lockStatsBase);
         log(component) << _debug.report(client, *this, (lockerInfo ? &lockerInfo->stats : nullptr));
     }
 
     // Return 'true' if this operation should also be added to the profiler.
-    return shouldDBProfile(shouldSample);
+    return shouldProfile;
 }
 
 Command::ReadWriteType CurOp::getReadWriteType() const {
@@ -493,6 +552,14 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
         builder->append("planSummary", _planSummary);
     }
 
+    if (!_planStageTimesNanos.isEmpty()) {
+        builder->append("planStageTimesNanos", _planStageTimesNanos);
+    }
+
+    if (_debug.storageStats) {
+        builder->append("storage", _debug.storageStats->toBSON());
+    }
+
     if (_genericCursor) {
         // This creates a new builder to truncate the object that will go into the curOp output. In
         // order to make sure the object is not too large but not truncate the comment, we only
@@ -601,6 +668,10 @@ string OpDebug::report(Client* client,
         s << " planSummary: " << curop.getPlanSummary().toString();
     }
 
+    if (!planStageTimesNanos.isEmpty()) {
+        s << " planStageTimesNanos:" << planStageTimesNanos.toString();
+    }
+
     OPDEBUG_TOSTRING_HELP(nShards);
     OPDEBUG_TOSTRING_HELP(cursorid);
     OPDEBUG_TOSTRING_HELP(ntoreturn);
@@ -652,6 +723,10 @@ string OpDebug::report(Client* client,
         s << " locks:" << locks.obj().toString();
     }
 
+    if (storageStats) {
+        s << " storage:" << storageStats->toBSON().toString();
+    }
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
@@ -724,6 +799,10 @@ void OpDebug::append(const CurOp& curop,
         lockStats.report(&locks);
     }
 
+    if (storageStats) {
+        b.append("storage", storageStats->toBSON());
+    }
+
     if (!errInfo.isOK()) {
         b.appendNumber("ok", 0.0);
         if (!errInfo.reason().empty()) {
@@ -743,6 +822,10 @@ void OpDebug::append(const CurOp& curop,
         b.append("planSummary", curop.getPlanSummary());
     }
 
+    if (!planStageTimesNanos.isEmpty()) {
+        b.append("planStageTimesNanos", planStageTimesNanos);
+    }
+
     if (!execStats.isEmpty()) {
         b.append("execStats", execStats);
     }
@@ -755,6 +838,7 @@ void OpDebug::setPlanSummaryMetrics(const PlanSummaryStats& planSummaryStats) {
     usedDisk = planSummaryStats.usedDisk;
     fromMultiPlanner = planSummaryStats.fromMultiPlanner;
     replanned = planSummaryStats.replanned;
+    planStageTimesNanos = stageTimesToBSON(planSummaryStats.stageExecutionTimeNanos);
 }
 
 namespace {
@@ -31,14 +31,19 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/storage/storage_stats.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/progress_meter.h"
+#include "mongo/util/system_tick_source.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -183,6 +188,14 @@ public:
 
     BSONObj execStats;  // Owned here.
 
+    // Estimated nanoseconds spent in each type of plan stage, excluding time spent in its
+    // children. Owned here.
+    BSONObj planStageTimesNanos;
+
+    // Storage engine work performed on behalf of this operation, if the storage engine reports it.
+    // Written by the thread running the operation while holding the client lock.
+    std::shared_ptr<StorageStats> storageStats;
+
     boost::optional<uint32_t> queryHash;
 
     // Details of any error (whether from an exception or a command returning failure).
@@ -385,20 +398,20 @@ public:
     }
 
     //
-    // Methods for getting/setting elapsed time. Note that the observed elapsed time may be
-    // negative, if the system time has been reset during the course of this operation.
+    // Methods for getting/setting elapsed time. Times are read from the SystemTickSource, so they
+    // are monotonic and only meaningful relative to one another.
     //
 
     void ensureStarted();
     bool isStarted() const {
         return _start > 0;
     }
-    long long startTime() {  // micros
+    long long startTime() {  // micros on the SystemTickSource clock
         ensureStarted();
         return _start;
     }
     void done() {
-        _end = curTimeMicros64();
+        _end = _nowMicros();
     }
     bool isDone() const {
         return _end > 0;
@@ -414,7 +427,7 @@ public:
     void pauseTimer() {
         invariant(isStarted());
         invariant(_lastPauseTime == 0);
-        _lastPauseTime = curTimeMicros64();
+        _lastPauseTime = _nowMicros();
     }
 
     /**
@@ -424,8 +437,7 @@ public:
     void resumeTimer() {
         invariant(isStarted());
         invariant(_lastPauseTime > 0);
-        _totalPausedDuration +=
-            Microseconds{static_cast<long long>(curTimeMicros64()) - _lastPauseTime};
+        _totalPausedDuration += Microseconds{_nowMicros() - _lastPauseTime};
         _lastPauseTime = 0;
     }
 
@@ -443,9 +455,9 @@ public:
         }
 
         if (!_end) {
-            return Microseconds{static_cast<long long>(curTimeMicros64() - startTime())};
+            return Microseconds{_nowMicros() - startTime()};
         } else {
-            return Microseconds{static_cast<long long>(_end - startTime())};
+            return Microseconds{_end - startTime()};
         }
     }
 
@@ -563,8 +575,21 @@ public:
         _planSummary = std::move(summary);
     }
 
+    /**
+     * Publishes the per-stage execution times of a plan that is still running, so that currentOp
+     * can report where the operation is spending its time.
+     */
+    void setPlanStageTimes_inlock(const std::map<std::string, long long>& stageTimesNanos);
+
     void setGenericCursor_inlock(GenericCursor gc);
 
+    /**
+     * Computes the storage engine work this operation has performed since it started and stores it
+     * in OpDebug, where the slow query log, the profiler and currentOp report it. Must be called by
+     * the thread running the operation. Locks the client.
+     */
+    void updateStorageStats(OperationContext* opCtx);
+
     const boost::optional<SingleThreadedLockStats> getLockStatsBase() {
         return _lockStatsBase;
     }
@@ -576,6 +601,17 @@ private:
 
     CurOp(OperationContext*, CurOpStack*);
 
+    /**
+     * Current time in microseconds for the start, end and pause timestamps below. Uses the
+     * SystemTickSource, which reads the CPU's cycle counter where that is safe, so it is cheap
+     * enough to call several times per operation.
+     */
+    static long long _nowMicros() {
+        auto tickSource = SystemTickSource::get();
+        return durationCount<Microseconds>(
+            tickSource->ticksTo<Microseconds>(tickSource->getTicks()));
+    }
+
     CurOpStack* _stack;
     CurOp* _parent{nullptr};
     const Command* _command{nullptr};
@@ -613,8 +649,11 @@ private:
     boost::optional<GenericCursor> _genericCursor;
 
     std::string _planSummary;
+    BSONObj _planStageTimesNanos;
     boost::optional<SingleThreadedLockStats>
         _lockStatsBase;  // This is the snapshot of lock stats taken when curOp is constructed.
+    // Snapshot of the storage engine statistics taken when the operation started.
+    std::shared_ptr<StorageStats> _storageStatsBase;
 };
 
 /**
@@ -32,6 +32,7 @@
 
 #include "mongo/db/cursor_manager.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/base/data_cursor.h"
 #include "mongo/base/init.h"
 #include "mongo/db/audit.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/cursor_server_params.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/kill_sessions_common.h"
@@ -55,7 +57,9 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/startup_test.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -520,6 +524,14 @@ std::size_t CursorManager::timeoutCursors(OperationContext* opCtx, Date_t now) {
 
 namespace {
 static AtomicUInt32 registeredPlanExecutorId;
+
+// The number of attempts to pin a cursor, and the total time they took.
+Counter64 cursorPinAttempts;
+Counter64 cursorPinMicros;
+ServerStatusMetricField<Counter64> displayCursorPinAttempts("cursor.pin.total",
+                                                            &cursorPinAttempts);
+ServerStatusMetricField<Counter64> displayCursorPinMicros("cursor.pin.totalMicros",
+                                                          &cursorPinMicros);
 }  // namespace
 
 Partitioned<stdx::unordered_set<PlanExecutor*>>::PartitionId CursorManager::registerExecutor(
@@ -539,33 +551,49 @@ void CursorManager::deregisterExecutor(PlanExecutor* exec) {
 StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx,
                                                      CursorId id,
                                                      AuthCheck checkSessionAuth) {
-    auto lockedPartition = _cursorMap->lockOnePartition(id);
-    auto it = lockedPartition->find(id);
-    if (it == lockedPartition->end()) {
-        return {ErrorCodes::CursorNotFound, str::stream() << "cursor id " << id << " not found"};
-    }
+    Timer pinTimer;
+    ON_BLOCK_EXIT([&] {
+        cursorPinAttempts.increment();
+        cursorPinMicros.increment(pinTimer.micros());
+    });
 
-    ClientCursor* cursor = it->second;
-    uassert(ErrorCodes::CursorInUse,
-            str::stream() << "cursor id " << id << " is already in use",
-            !cursor->_operationUsingCursor);
-    if (cursor->getExecutor()->isMarkedAsKilled()) {
-        // This cursor was killed while it was idle.
-        Status error = cursor->getExecutor()->getKillStatus();
-        deregisterAndDestroyCursor(std::move(lockedPartition),
-                                   opCtx,
-                                   std::unique_ptr<ClientCursor, ClientCursor::Deleter>(cursor));
-        return error;
-    }
-
-    if (checkSessionAuth == kCheckSession) {
-        auto cursorPrivilegeStatus = checkCursorSessionPrivilege(opCtx, cursor->getSessionId());
-        if (!cursorPrivilegeStatus.isOK()) {
-            return cursorPrivilegeStatus;
+    ClientCursor* cursor;
+    {
+        auto lockedPartition = _cursorMap->lockOnePartition(id);
+        auto it = lockedPartition->find(id);
+        if (it == lockedPartition->end()) {
+            return {ErrorCodes::CursorNotFound,
+                    str::stream() << "cursor id " << id << " not found"};
+        }
+
+        cursor = it->second;
+        uassert(ErrorCodes::CursorInUse,
+                str::stream() << "cursor id " << id << " is already in use",
+                !cursor->_operationUsingCursor);
+        if (cursor->getExecutor()->isMarkedAsKilled()) {
+            // This cursor was killed while it was idle.
+            Status error = cursor->getExecutor()->getKillStatus();
+            deregisterAndDestroyCursor(
+                std::move(lockedPartition),
+                opCtx,
+                std::unique_ptr<ClientCursor, ClientCursor::Deleter>(cursor));
+            return error;
         }
+
+        if (checkSessionAuth == kCheckSession) {
+            auto cursorPrivilegeStatus = checkCursorSessionPrivilege(opCtx, cursor->getSessionId());
+            if (!cursorPrivilegeStatus.isOK()) {
+                return cursorPrivilegeStatus;
+            }
+        }
+
+        cursor->_operationUsingCursor = opCtx;
     }
 
-    cursor->_operationUsingCursor = opCtx;
+    // Once marked as in use, the cursor belongs to this operation, so the rest of the work happens
+    // outside of the partition lock. If it fails, the pin hands the cursor back as a completed
+    // getMore would.
+    ClientCursorPin pin(opCtx, cursor);
 
     // We use pinning of a cursor as a proxy for active, user-initiated use of a cursor.  Therefore,
     // we pass down to the logical session cache and vivify the record (updating last use).
@@ -577,7 +605,7 @@ StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx,
         }
     }
 
-    return ClientCursorPin(opCtx, cursor);
+    return std::move(pin);
 }
 
 void CursorManager::unpin(OperationContext* opCtx,
@@ -49,6 +49,7 @@
 #include "mongo/db/audit.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/cache_warmer.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/create_collection.h"
 #include "mongo/db/catalog/database.h"
@@ -93,7 +94,9 @@
 #include "mongo/db/op_observer_registry.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
+#include "mongo/db/periodic_runner_job_clear_idle_plan_caches.h"
 #include "mongo/db/periodic_runner_job_decrease_snapshot_cache_pressure.h"
+#include "mongo/db/pipeline/aggregation_result_cache_op_observer.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
@@ -129,6 +132,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/system_index.h"
 #include "mongo/db/ttl.h"
+#include "mongo/db/views/materialized_view_op_observer.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface_factory.h"
@@ -163,6 +167,7 @@
 #include "mongo/util/periodic_runner_factory.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/ramlog.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/sequence_util.h"
 #include "mongo/util/signal_handlers.h"
@@ -282,6 +287,8 @@ ExitCode _initAndListen(int listenPort) {
     auto opObserverRegistry = stdx::make_unique<OpObserverRegistry>();
     opObserverRegistry->addObserver(stdx::make_unique<OpObserverShardingImpl>());
     opObserverRegistry->addObserver(stdx::make_unique<UUIDCatalogObserver>());
+    opObserverRegistry->addObserver(stdx::make_unique<AggregationResultCacheOpObserver>());
+    opObserverRegistry->addObserver(stdx::make_unique<MaterializedViewOpObserver>());
 
     if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
         opObserverRegistry->addObserver(stdx::make_unique<ShardServerOpObserver>());
@@ -532,6 +539,8 @@ ExitCode _initAndListen(int listenPort) {
     invariant(storageEngine);
     BackupCursorHooks::initialize(serviceContext, storageEngine);
 
+    SamplingProfiler::startIfEnabled();
+
     if (!storageGlobalParams.readOnly) {
 
         if (storageEngine->supportsCappedCollections()) {
@@ -601,6 +610,8 @@ ExitCode _initAndListen(int listenPort) {
         if (replSettings.usingReplSets() || !internalValidateFeaturesAsMaster) {
             serverGlobalParams.validateFeaturesAsMaster.store(false);
         }
+
+        startCacheWarmerBackgroundJob();
     }
 
     startClientCursorMonitor();
@@ -621,6 +632,10 @@ ExitCode _initAndListen(int listenPort) {
         startPeriodicThreadToDecreaseSnapshotHistoryCachePressure(serviceContext);
     }
 
+    // Start up a background task to periodically free the memory held by the plan caches of
+    // collections which are no longer being queried.
+    startPeriodicThreadToClearIdlePlanCaches(serviceContext);
+
     // Set up the logical session cache
     LogicalSessionCacheServer kind = LogicalSessionCacheServer::kStandalone;
     if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
@@ -943,6 +958,8 @@ void shutdownTask() {
 
     HealthLog::get(serviceContext).shutdown();
 
+    shutdownProfiler(serviceContext);
+
     // We should always be able to acquire the global lock at shutdown.
     //
     // TODO: This call chain uses the locker directly, because we do not want to start an
@@ -35,6 +35,8 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/logical_time.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_parameters.h"
@@ -52,6 +54,20 @@ const boost::optional<int> kDoNotChangeProfilingLevel = boost::none;
 // application.
 MONGO_EXPORT_SERVER_PARAMETER(allowSecondaryReadsDuringBatchApplication, bool, true);
 
+// How long a secondary read at lastApplied waits for lastApplied to catch up with a pending
+// catalog change before it falls back to taking the PBWM lock. Zero, the default, falls back
+// immediately. Nothing advances lastApplied while no batch is being applied, such as after an
+// initial-sync index build, so every such read waits for the whole period in that case.
+MONGO_EXPORT_SERVER_PARAMETER(secondaryReadsWaitForCatalogChangesMS, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "secondaryReadsWaitForCatalogChangesMS must be greater than or equal "
+                          "to 0");
+        }
+        return Status::OK();
+    });
+
 AutoStatsTracker::AutoStatsTracker(OperationContext* opCtx,
                                    const NamespaceString& nss,
                                    Top::LockType lockType,
@@ -104,6 +120,9 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
     repl::ReplicationCoordinator* const replCoord = repl::ReplicationCoordinator::get(opCtx);
     const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
 
+    // Whether we have already waited once for lastApplied to reach a pending catalog change.
+    bool waitedForLastApplied = false;
+
     // If the collection doesn't exist or disappears after releasing locks and waiting, there is no
     // need to check for pending catalog changes.
     while (auto coll = _autoColl->getCollection()) {
@@ -150,6 +169,35 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
         // Yield locks in order to do the blocking call below.
         _autoColl = boost::none;
 
+        // Catalog changes later than lastApplied were made by the batch that is currently being
+        // applied, so lastApplied normally reaches them as soon as that batch completes. Wait for
+        // that once, without the PBWM lock, and then try reading at lastApplied again. Taking the
+        // PBWM lock instead would also hold up the next batch until this read is done.
+        const auto waitMS = secondaryReadsWaitForCatalogChangesMS.load();
+        if (lastAppliedTimestamp && !waitedForLastApplied && waitMS > 0) {
+            waitedForLastApplied = true;
+            const auto waitDeadline =
+                std::min(Date_t::now() + Milliseconds(waitMS), opCtx->getDeadline());
+            const auto readConcernArgs = repl::ReadConcernArgs(
+                LogicalTime(*minSnapshot), repl::ReadConcernLevel::kLocalReadConcern);
+            auto waitStatus =
+                replCoord->waitUntilOpTimeForReadUntil(opCtx, readConcernArgs, waitDeadline);
+            if (ErrorCodes::isInterruption(waitStatus.code())) {
+                uassertStatusOK(waitStatus);
+            }
+            LOG(2) << "Waited for last-applied time to reach pending catalog changes at time "
+                   << *minSnapshot << " on nss: " << nss.ns() << ", status: " << waitStatus
+                   << ". Trying again to read at last-applied time.";
+
+            {
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                CurOp::get(opCtx)->yielded();
+            }
+
+            _autoColl.emplace(opCtx, nsOrUUID, collectionLockMode, viewMode, deadline);
+            continue;
+        }
+
         // If there are pending catalog changes, we should conflict with any in-progress batches (by
         // taking the PBWM lock) and choose not to read from the last applied timestamp by unsetting
         // _shouldNotConflictWithSecondaryBatchApplicationBlock. Index builds on secondaries can
@@ -150,6 +150,7 @@ bool DBDirectClient::call(Message& toSend, Message& response, bool assertOk, str
     auto dbResponse = loopbackBuildResponse(_opCtx, &_lastError, toSend);
     invariant(!dbResponse.response.empty());
     response = std::move(dbResponse.response);
+    response.flatten();
 
     return true;
 }
@@ -54,6 +54,7 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/db/storage/data_protector.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
@@ -155,6 +156,18 @@ bool Helpers::findById(OperationContext* opCtx,
     if (nsFound)
         *nsFound = true;
 
+    if (collection->getRecordStore()->isClusteredOnId()) {
+        // The record store itself serves as the _id index.
+        if (indexFound)
+            *indexFound = 1;
+
+        RecordId loc = findById(opCtx, collection, query);
+        if (loc.isNull())
+            return false;
+        result = collection->docFor(opCtx, loc).value();
+        return true;
+    }
+
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
 
@@ -175,6 +188,17 @@ RecordId Helpers::findById(OperationContext* opCtx,
                            Collection* collection,
                            const BSONObj& idquery) {
     verify(collection);
+    if (collection->getRecordStore()->isClusteredOnId()) {
+        // The RecordId of a document in a collection clustered on _id is derived from its _id.
+        auto swRecordId = clusteredid::keyForId(idquery["_id"]);
+        RecordData unused;
+        if (!swRecordId.isOK() ||
+            !collection->getRecordStore()->findRecord(opCtx, swRecordId.getValue(), &unused)) {
+            return RecordId();
+        }
+        return swRecordId.getValue();
+    }
+
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
     uassert(13430, "no _id index", desc);
@@ -92,7 +92,7 @@ struct Helpers {
                          bool* indexFound = 0);
 
     /* TODO: should this move into Collection?
-     * uasserts if no _id index.
+     * uasserts if no _id index, unless the collection is clustered on _id.
      * @return null loc if not found */
     static RecordId findById(OperationContext* opCtx, Collection* collection, const BSONObj& query);
 
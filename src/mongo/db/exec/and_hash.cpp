@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/and_hash.h"
 
+#include <algorithm>
+
 #include "mongo/db/exec/and_common-inl.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
@@ -79,6 +81,11 @@ void AndHashStage::addChild(PlanStage* child) {
     _children.emplace_back(child);
 }
 
+void AndHashStage::enableSpilling(std::string tempDir) {
+    invariant(_lookAheadResults.empty());
+    _tempDir = std::move(tempDir);
+}
+
 size_t AndHashStage::getMemUsage() const {
     return _memUsage;
 }
@@ -89,6 +96,10 @@ bool AndHashStage::isEOF() {
         return false;
     }
 
+    if (_spilling) {
+        return _spilledEOF;
+    }
+
     // Either we're busy hashing children, in which case we're not done yet.
     if (_hashingChildren) {
         return false;
@@ -165,10 +176,21 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     // table with subsequent children, or checking the last child's results to see if they're
     // in the hash table.
 
+    if (_spilling) {
+        return workSpilled(out);
+    }
+
     // We read the first child into our hash table.
     if (_hashingChildren) {
         // Check memory usage of previously hashed results.
-        if (_memUsage > _maxMemUsage) {
+        if (_memUsage > _maxMemUsage && !_tempDir.empty()) {
+            Status status = spillHashTable();
+            if (!status.isOK()) {
+                *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                return PlanStage::FAILURE;
+            }
+            return PlanStage::NEED_TIME;
+        } else if (_memUsage > _maxMemUsage) {
             mongoutils::str::stream ss;
             ss << "hashed AND stage buffered data usage of " << _memUsage
                << " bytes exceeds internal limit of " << kDefaultMaxMemUsageBytes << " bytes";
@@ -383,6 +405,248 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
     }
 }
 
+int AndHashStage::SpillComparator::operator()(const SpillSorter::Data& lhs,
+                                              const SpillSorter::Data& rhs) const {
+    // False means ignore field names.
+    return lhs.first.woCompare(rhs.first, BSONObj(), false);
+}
+
+std::unique_ptr<AndHashStage::SpillSorter> AndHashStage::makeSpillSorter() const {
+    SortOptions opts;
+    opts.maxMemoryUsageBytes = _maxMemUsage;
+    opts.extSortAllowed = true;
+    opts.tempDir = _tempDir;
+    return std::unique_ptr<SpillSorter>(SpillSorter::make(opts, SpillComparator()));
+}
+
+Status AndHashStage::spillHashTable() {
+    invariant(!_spilling);
+    invariant(_hashingChildren);
+    _spilling = true;
+    _specificStats.usedDisk = true;
+
+    auto buffered = makeSpillSorter();
+    for (auto&& entry : _dataMap) {
+        const bool seen = _currentChild > 0 && _seenMap.count(entry.first);
+        Status status = addToSorter(buffered.get(), entry.second, seen);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    if (0 == _currentChild) {
+        // Everything in the table came from the first child, which we keep reading.
+        _spilledFirstChildCount = _dataMap.size();
+        _spilledChild = std::move(buffered);
+    } else {
+        _spilledIntersection.reset(buffered->done());
+        _spilledChild = makeSpillSorter();
+    }
+
+    _dataMap.clear();
+    _seenMap.clear();
+    _memUsage = 0;
+    return Status::OK();
+}
+
+Status AndHashStage::addToSorter(SpillSorter* sorter, WorkingSetID id, bool seen) {
+    WorkingSetMember* member = _ws->get(id);
+
+    // Only the RecordId, the document and the index keys are written out.
+    for (int type = 0; type < WSM_COMPUTED_NUM_TYPES; ++type) {
+        if (member->hasComputed(static_cast<WorkingSetComputedDataType>(type))) {
+            mongoutils::str::stream ss;
+            ss << "hashed AND stage buffered data usage exceeds internal limit of " << _maxMemUsage
+               << " bytes and results with $meta data cannot be intersected externally";
+            return Status(ErrorCodes::OperationFailed, ss);
+        }
+    }
+
+    BSONObjBuilder value;
+    if (member->hasObj()) {
+        value.append("obj", member->obj.value());
+    } else {
+        BSONArrayBuilder keys(value.subarrayStart("keys"));
+        for (auto&& datum : member->keyData) {
+            auto spilledIndex = std::find_if(
+                _spilledIndexes.begin(), _spilledIndexes.end(), [&](const IndexKeyDatum& index) {
+                    return index.index == datum.index &&
+                        index.indexKeyPattern.binaryEqual(datum.indexKeyPattern);
+                });
+            if (_spilledIndexes.end() == spilledIndex) {
+                _spilledIndexes.emplace_back(datum.indexKeyPattern, BSONObj(), datum.index);
+                spilledIndex = _spilledIndexes.end() - 1;
+            }
+
+            BSONObjBuilder keyBuilder(keys.subobjStart());
+            keyBuilder.append("index", static_cast<int>(spilledIndex - _spilledIndexes.begin()));
+            keyBuilder.append("key", datum.keyData);
+        }
+    }
+    if (seen) {
+        value.append("seen", true);
+    }
+
+    sorter->add(BSON("" << static_cast<long long>(member->recordId.repr())), value.obj());
+    _ws->free(id);
+    return Status::OK();
+}
+
+WorkingSetID AndHashStage::restoreSpilledMember(const SpillSorter::Data& data) {
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    member->recordId = RecordId(data.first.firstElement().numberLong());
+
+    BSONElement obj = data.second["obj"];
+    if (!obj.eoo()) {
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), obj.Obj().getOwned());
+        _ws->transitionToRecordIdAndObj(id);
+        return id;
+    }
+
+    for (auto&& keyElt : data.second["keys"].Obj()) {
+        BSONObj spilledKey = keyElt.Obj();
+        const IndexKeyDatum& index = _spilledIndexes[spilledKey["index"].numberInt()];
+        member->keyData.emplace_back(
+            index.indexKeyPattern, spilledKey["key"].Obj().getOwned(), index.index);
+    }
+
+    // We may have yielded since this member was spilled, so its index keys have to be checked
+    // against the document once it is fetched.
+    member->isSuspicious = true;
+    _ws->transitionToRecordIdAndIdx(id);
+    return id;
+}
+
+void AndHashStage::advanceSpilledChildResults() {
+    if (_spilledChildResults->more()) {
+        _nextSpilledChildResult = _spilledChildResults->next();
+    } else {
+        _nextSpilledChildResult = boost::none;
+    }
+}
+
+WorkingSetID AndHashStage::nextSpilledIntersection() {
+    const SpillComparator cmp;
+    while (_spilledIntersection->more()) {
+        SpillSorter::Data data = _spilledIntersection->next();
+
+        // Results of the child with a smaller RecordId cannot be in the intersection.
+        while (_nextSpilledChildResult && cmp(*_nextSpilledChildResult, data) < 0) {
+            advanceSpilledChildResults();
+        }
+
+        const bool matched = _nextSpilledChildResult && cmp(*_nextSpilledChildResult, data) == 0;
+        if (!matched && !data.second["seen"].trueValue()) {
+            continue;
+        }
+
+        WorkingSetID id = restoreSpilledMember(data);
+        while (_nextSpilledChildResult && cmp(*_nextSpilledChildResult, data) == 0) {
+            WorkingSetID childId = restoreSpilledMember(*_nextSpilledChildResult);
+            AndCommon::mergeFrom(_ws, id, *_ws->get(childId));
+            _ws->free(childId);
+            advanceSpilledChildResults();
+        }
+        return id;
+    }
+
+    return WorkingSet::INVALID_ID;
+}
+
+PlanStage::StageState AndHashStage::workSpilled(WorkingSetID* out) {
+    if (!_spilledChild) {
+        // Every child has been read. We merge the intersection with the last child as we go.
+        WorkingSetID id = nextSpilledIntersection();
+        if (WorkingSet::INVALID_ID == id) {
+            _spilledEOF = true;
+            return PlanStage::IS_EOF;
+        }
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState childStatus = workChild(_currentChild, &id);
+
+    if (PlanStage::ADVANCED == childStatus) {
+        // The planner ensures that the child stage can never produce an WSM with no record id.
+        invariant(_ws->get(id)->hasRecordId());
+
+        Status status = addToSorter(_spilledChild.get(), id, false);
+        if (!status.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
+        if (0 == _currentChild) {
+            ++_spilledFirstChildCount;
+        }
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::IS_EOF == childStatus) {
+        std::unique_ptr<SpillSorter::Iterator> childResults(_spilledChild->done());
+        _spilledChild.reset();
+
+        if (0 == _currentChild) {
+            _specificStats.mapAfterChild.push_back(_spilledFirstChildCount);
+            _spilledIntersection = std::move(childResults);
+            _spilledChild = makeSpillSorter();
+            _currentChild = 1;
+            return PlanStage::NEED_TIME;
+        }
+
+        _spilledChildResults = std::move(childResults);
+        advanceSpilledChildResults();
+
+        if (_currentChild == _children.size() - 1) {
+            // We don't buffer the intersection with the last child. Instead, we return results
+            // with subsequent calls to work().
+            _hashingChildren = false;
+            return PlanStage::NEED_TIME;
+        }
+
+        // Merge this child into the intersection.
+        auto intersection = makeSpillSorter();
+        size_t intersectionSize = 0;
+        for (WorkingSetID merged = nextSpilledIntersection(); WorkingSet::INVALID_ID != merged;
+             merged = nextSpilledIntersection()) {
+            Status status = addToSorter(intersection.get(), merged, false);
+            if (!status.isOK()) {
+                *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                return PlanStage::FAILURE;
+            }
+            ++intersectionSize;
+        }
+        _specificStats.mapAfterChild.push_back(intersectionSize);
+
+        _spilledIntersection.reset(intersection->done());
+        _spilledChildResults.reset();
+        _nextSpilledChildResult = boost::none;
+        ++_currentChild;
+
+        // If we have nothing to AND with after finishing any child, stop.
+        if (0 == intersectionSize) {
+            _hashingChildren = false;
+            _spilledEOF = true;
+            return PlanStage::IS_EOF;
+        }
+
+        _spilledChild = makeSpillSorter();
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
+        // The stage which produces a failure is responsible for allocating a working set member
+        // with error details.
+        invariant(WorkingSet::INVALID_ID != id);
+        *out = id;
+        return childStatus;
+    } else {
+        if (PlanStage::NEED_YIELD == childStatus) {
+            *out = id;
+        }
+
+        return childStatus;
+    }
+}
+
 unique_ptr<PlanStageStats> AndHashStage::getStats() {
     _commonStats.isEOF = isEOF();
 
@@ -403,3 +667,6 @@ const SpecificStats* AndHashStage::getSpecificStats() const {
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -28,12 +28,16 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <string>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/stdx/unordered_set.h"
 
@@ -59,6 +63,14 @@ public:
 
     void addChild(PlanStage* child);
 
+    /**
+     * Once the hash table exceeds the memory limit, intersect the children externally using files
+     * in 'tempDir' instead of failing. External intersection returns results in RecordId order
+     * rather than in the order of the last child, so this may only be enabled when nothing relies
+     * on the order of this stage's output. Must be called before the first call to work().
+     */
+    void enableSpilling(std::string tempDir);
+
     /**
      * Returns memory usage.
      * For testing only.
@@ -85,6 +97,54 @@ private:
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
 
+    //
+    // External intersection
+    //
+
+    // The sorter's key is the RecordId and its value is the serialized working set member. Every
+    // spilled stream is sorted by RecordId, so children are intersected by merging the stream of
+    // the intersection so far with the stream of the next child.
+    using SpillSorter = Sorter<BSONObj, BSONObj>;
+
+    struct SpillComparator {
+        int operator()(const SpillSorter::Data& lhs, const SpillSorter::Data& rhs) const;
+    };
+
+    std::unique_ptr<SpillSorter> makeSpillSorter() const;
+
+    /**
+     * Moves the hash table into sorted streams. Members of the current child which were already
+     * merged into the table are remembered as seen so that they survive the next merge.
+     */
+    Status spillHashTable();
+
+    /**
+     * Serializes the member 'id' into 'sorter' and frees it.
+     */
+    Status addToSorter(SpillSorter* sorter, WorkingSetID id, bool seen);
+
+    /**
+     * Allocates a working set member from a spilled one.
+     */
+    WorkingSetID restoreSpilledMember(const SpillSorter::Data& data);
+
+    /**
+     * Moves '_nextSpilledChildResult' on to the next entry of '_spilledChildResults'.
+     */
+    void advanceSpilledChildResults();
+
+    /**
+     * Returns the next member of '_spilledIntersection' which is either marked as seen or has a
+     * match in '_spilledChildResults', with the matching results merged in. Returns INVALID_ID
+     * once '_spilledIntersection' is exhausted.
+     */
+    WorkingSetID nextSpilledIntersection();
+
+    /**
+     * Performs a unit of work once we have moved to external intersection.
+     */
+    StageState workSpilled(WorkingSetID* out);
+
     // Not owned by us.
     const Collection* _collection;
 
@@ -123,6 +183,35 @@ private:
     // Upper limit for buffered data memory usage.
     // Defaults to 32 MB (See kMaxBytes in and_hash.cpp).
     size_t _maxMemUsage;
+
+    // Where we may spill once we exceed '_maxMemUsage'. Empty if spilling is not allowed.
+    std::string _tempDir;
+
+    // True once we have exceeded '_maxMemUsage' and moved to external intersection.
+    bool _spilling = false;
+
+    // True once the external intersection has returned all of its results.
+    bool _spilledEOF = false;
+
+    // The intersection of the children before '_currentChild', sorted by RecordId.
+    std::unique_ptr<SpillSorter::Iterator> _spilledIntersection;
+
+    // Buffers the results of '_currentChild' until it is EOF. Null once every child is read.
+    std::unique_ptr<SpillSorter> _spilledChild;
+
+    // How many results of the first child have been spilled, for stats.
+    size_t _spilledFirstChildCount = 0;
+
+    // The sorted results of the child being merged with '_spilledIntersection'. For the last
+    // child, the merge happens as we return results.
+    std::unique_ptr<SpillSorter::Iterator> _spilledChildResults;
+
+    // The next entry of '_spilledChildResults', which has to be looked at before it is consumed.
+    boost::optional<SpillSorter::Data> _nextSpilledChildResult;
+
+    // Spilled index key data refers to its key pattern and index by position in this list, since
+    // neither can be written to disk.
+    std::vector<IndexKeyDatum> _spilledIndexes;
 };
 
 }  // namespace mongo
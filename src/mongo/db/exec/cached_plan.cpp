@@ -76,6 +76,7 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedTickTimer tickTimer(getTickSource(), &_commonStats.executionTimeNanos);
 
     // If we work this many times during the trial period, then we will replan the
     // query from scratch.
@@ -30,7 +30,10 @@
 
 #include "mongo/db/exec/collection_scan.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_zone_map.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/collection_scan_common.h"
@@ -67,12 +70,26 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     _specificStats.direction = params.direction;
     _specificStats.maxTs = params.maxTs;
     invariant(!_params.shouldTrackLatestOplogTimestamp || _params.collection->ns().isOplog());
+    invariant(_params.stop.isNull() || !_params.tailable);
 
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte" << *(params.maxTs));
         _endCondition = stdx::make_unique<GTEMatchExpression>(repl::OpTime::kTimestampFieldName,
                                                               _endConditionBSON.firstElement());
     }
+
+    if (_filter) {
+        _compiledFilter = stdx::make_unique<CompiledMatchExpression>(_filter);
+    }
+
+    // The zone map only summarizes the documents inserted since the collection was loaded, in
+    // increasing RecordId order, so it is only consulted by plain forward scans with a filter.
+    if (_filter && params.collection && params.direction == CollectionScanParams::FORWARD &&
+        !params.tailable && !params.maxTs && !params.shouldTrackLatestOplogTimestamp &&
+        !params.stopApplyingFilterAfterFirstMatch) {
+        _zoneMap = params.collection->getZoneMap();
+    }
+    _specificStats.usesZoneMap = _zoneMap != nullptr;
 }
 
 PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
@@ -142,9 +159,15 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
         if (_lastSeenId.isNull() && !_params.start.isNull()) {
             record = _cursor->seekExact(_params.start);
+        } else if (_lastSeenId.isNull() && !_params.scanFrom.isNull()) {
+            record = seekScanFrom();
         } else {
             record = _cursor->next();
         }
+
+        if (record && _zoneMap) {
+            skipBlocksWithoutMatches(&record);
+        }
     } catch (const WriteConflictException&) {
         // Leave us in a state to try again next time.
         if (needToMakeCursor)
@@ -154,9 +177,17 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     }
 
     if (!record) {
-        // We just hit EOF. If we are tailable and have already returned data, leave us in a
-        // state to pick up where we left off on the next call to work(). Otherwise EOF is
-        // permanent.
+        // We just hit EOF, so every oplog entry visible to this snapshot has been scanned. Report
+        // the visibility bound as the latest timestamp, so that a reader merging several oplogs
+        // may advance past this one without waiting for another entry to be written to it.
+        if (_params.shouldTrackLatestOplogTimestamp) {
+            if (auto visibleTs = getOpCtx()->recoveryUnit()->getOplogVisibilityTs()) {
+                _latestOplogEntryTimestamp = std::max(_latestOplogEntryTimestamp, *visibleTs);
+            }
+        }
+
+        // If we are tailable and have already returned data, leave us in a state to pick up where
+        // we left off on the next call to work(). Otherwise EOF is permanent.
         if (_params.tailable && !_lastSeenId.isNull()) {
             _cursor.reset();
         } else {
@@ -166,6 +197,11 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (isPastStop(record->id)) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
         auto status = setLatestOplogEntryTimestamp(*record);
@@ -184,6 +220,203 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     return returnIfMatches(member, id, out);
 }
 
+PlanStage::StageState CollectionScan::doWorkBatch(size_t maxWorks,
+                                                  std::vector<WorkingSetID>* out,
+                                                  WorkingSetID* last) {
+    // Cursor creation, the initial seek, tailable restarts, oplog timestamp tracking and zone map
+    // skipping are all handled one unit at a time by doWork(). Only the steady state loop over the
+    // cursor is batched.
+    if (!_cursor || _isDead || _commonStats.isEOF || _params.shouldTrackLatestOplogTimestamp ||
+        _zoneMap ||
+        (_lastSeenId.isNull() && (!_params.start.isNull() || !_params.scanFrom.isNull()))) {
+        return PlanStage::doWorkBatch(maxWorks, out, last);
+    }
+
+    const size_t sizeBefore = out->size();
+    for (size_t works = 0; works < maxWorks; ++works) {
+        boost::optional<Record> record;
+        try {
+            record = _cursor->next();
+        } catch (const WriteConflictException&) {
+            if (out->size() > sizeBefore) {
+                // Hand back what we have. The conflict will be hit and reported on the next call.
+                return PlanStage::ADVANCED;
+            }
+            recordWork(PlanStage::NEED_YIELD);
+            *last = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+
+        if (!record) {
+            if (_params.tailable && !_lastSeenId.isNull()) {
+                _cursor.reset();
+            } else {
+                _commonStats.isEOF = true;
+            }
+
+            if (out->size() > sizeBefore) {
+                return PlanStage::ADVANCED;
+            }
+            recordWork(PlanStage::IS_EOF);
+            return PlanStage::IS_EOF;
+        }
+
+        if (isPastStop(record->id)) {
+            _commonStats.isEOF = true;
+            if (out->size() > sizeBefore) {
+                return PlanStage::ADVANCED;
+            }
+            recordWork(PlanStage::IS_EOF);
+            return PlanStage::IS_EOF;
+        }
+
+        _lastSeenId = record->id;
+
+        WorkingSetID id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->recordId = record->id;
+        member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
+        _workingSet->transitionToRecordIdAndObj(id);
+
+        StageState state = returnIfMatches(member, id, &id);
+        if (PlanStage::IS_EOF == state && out->size() > sizeBefore) {
+            // '_commonStats.isEOF' is set, so the next call reports EOF.
+            return PlanStage::ADVANCED;
+        }
+
+        recordWork(state);
+        if (PlanStage::IS_EOF == state) {
+            return state;
+        } else if (PlanStage::ADVANCED == state) {
+            out->push_back(id);
+
+            // The record is only valid until the cursor is advanced again. Copying it to keep
+            // going would cost more per document than work() does, so unless the record store
+            // handed out owned data, the batch ends with it.
+            if (!member->obj.value().isOwned()) {
+                return PlanStage::ADVANCED;
+            }
+        }
+    }
+
+    return out->size() > sizeBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
+boost::optional<Record> CollectionScan::seekScanFrom() {
+    // oplogStartHack() finds the last record at or before 'scanFrom' in RecordId order, using the
+    // same snapshot as '_cursor'.
+    const boost::optional<RecordId> atOrBefore =
+        _params.collection->getRecordStore()->oplogStartHack(getOpCtx(), _params.scanFrom);
+    if (!atOrBefore) {
+        // Unsupported by the record store, so scan from the start of the collection instead.
+        return _cursor->next();
+    }
+
+    if (_params.direction == CollectionScanParams::BACKWARD) {
+        if (atOrBefore->isNull()) {
+            return boost::none;
+        }
+        return _cursor->seekExact(*atOrBefore);
+    }
+
+    if (atOrBefore->isNull()) {
+        // Every record is past 'scanFrom'.
+        return _cursor->next();
+    }
+    auto record = _cursor->seekExact(*atOrBefore);
+    invariant(record);
+    if (record->id == _params.scanFrom) {
+        return record;
+    }
+    return _cursor->next();
+}
+
+bool CollectionScan::isPastStop(const RecordId& id) const {
+    if (_params.stop.isNull()) {
+        return false;
+    }
+    return _params.direction == CollectionScanParams::FORWARD ? id >= _params.stop
+                                                              : id <= _params.stop;
+}
+
+void CollectionScan::skipBlocksWithoutMatches(boost::optional<Record>* record) {
+    const long long block = _zoneMap->blockFor((*record)->id);
+    if (_lastZoneMapBlock && *_lastZoneMapBlock == block) {
+        return;
+    }
+    _lastZoneMapBlock = block;
+
+    RecordId nextStart;
+    if (!_zoneMap->canSkipBlock((*record)->id, _filter, &nextStart)) {
+        return;
+    }
+
+    if (nextStart.isNull()) {
+        // No later block can hold a match either.
+        ++_specificStats.zoneMapSkips;
+        *record = boost::none;
+        return;
+    }
+
+    // 'nextStart' is the first RecordId inserted into its block, but it may have been deleted
+    // since. A failed seek would leave the cursor at EOF, so in that case keep scanning from the
+    // current record instead. Every record in between belongs to a block which cannot match, so
+    // losing the cursor position to a write conflict below is harmless.
+    RecordData unused;
+    if (!_params.collection->getRecordStore()->findRecord(getOpCtx(), nextStart, &unused)) {
+        return;
+    }
+
+    auto nextRecord = _cursor->seekExact(nextStart);
+    invariant(nextRecord);
+    ++_specificStats.zoneMapSkips;
+    _lastZoneMapBlock = _zoneMap->blockFor(nextStart);
+    *record = std::move(nextRecord);
+}
+
+// static
+std::vector<RecordId> CollectionScan::sampleRangeBoundaries(OperationContext* opCtx,
+                                                            const Collection* collection,
+                                                            size_t numRanges) {
+    // Sampling several records per range keeps the ranges reasonably even despite the randomness
+    // of the samples.
+    const size_t kSamplesPerRange = 10;
+
+    std::vector<RecordId> boundaries;
+    const RecordStore* rs = collection->getRecordStore();
+    const long long numRecords = rs->numRecords(opCtx);
+    if (numRanges < 2 || numRecords < static_cast<long long>(numRanges * kSamplesPerRange)) {
+        return boundaries;
+    }
+
+    auto cursor = rs->getRandomCursor(opCtx);
+    if (!cursor) {
+        return boundaries;
+    }
+
+    std::vector<RecordId> samples;
+    samples.reserve(numRanges * kSamplesPerRange);
+    while (samples.size() < numRanges * kSamplesPerRange) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        samples.push_back(record->id);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
+    if (samples.size() < numRanges) {
+        return boundaries;
+    }
+
+    for (size_t i = 1; i < numRanges; ++i) {
+        boundaries.push_back(samples[i * samples.size() / numRanges]);
+    }
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+    return boundaries;
+}
+
 Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     if (tsElem.type() != BSONType::bsonTimestamp) {
@@ -202,9 +435,10 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (!_compiledFilter || _compiledFilter->matchesBSON(member->obj.value())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -30,13 +30,17 @@
 
 #include <memory>
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
 
 namespace mongo {
 
+class CollectionZoneMap;
 struct Record;
 class SeekableRecordCursor;
 class WorkingSet;
@@ -56,6 +60,9 @@ public:
                    const MatchExpression* filter);
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* last) final;
     bool isEOF() final;
 
     void doSaveState() final;
@@ -77,6 +84,22 @@ public:
 
     static const char* kStageType;
 
+    /**
+     * Returns up to 'numRanges' - 1 distinct RecordIds, in increasing order, which split the
+     * collection into approximately equal-sized ranges. The boundaries are chosen by sampling
+     * with the record store's random cursor, so an empty vector is returned if the storage engine
+     * does not provide one or the collection is too small to be worth splitting.
+     *
+     * Each boundary is the first RecordId of its range, so the ranges can be scanned independently
+     * by setting CollectionScanParams::start and CollectionScanParams::stop to consecutive
+     * boundaries. Since 'start' must name an existing record, the scans must read from the same
+     * snapshot, or read timestamp, that the boundaries were sampled from. Aggregations counting
+     * the documents of a collection scan do so when internalQueryParallelCountThreads is set.
+     */
+    static std::vector<RecordId> sampleRangeBoundaries(OperationContext* opCtx,
+                                                       const Collection* collection,
+                                                       size_t numRanges);
+
 private:
     /**
      * If the member (with id memberID) passes our filter, set *out to memberID and return that
@@ -91,12 +114,35 @@ private:
      */
     Status setLatestOplogEntryTimestamp(const Record& record);
 
+    /**
+     * Positions the cursor at the first record of the scan according to '_params.scanFrom', and
+     * returns that record. May throw WriteConflictException.
+     */
+    boost::optional<Record> seekScanFrom();
+
+    /**
+     * Returns true if 'id' is '_params.stop' or lies beyond it in the direction of the scan.
+     */
+    bool isPastStop(const RecordId& id) const;
+
+    /**
+     * Called with the record the cursor was just positioned on. If the zone map shows that no
+     * document in its block can pass the filter, moves the cursor to the first record of the next
+     * block which may hold a match and replaces '*record' with it, or sets '*record' to
+     * boost::none if there is no such block. May throw WriteConflictException.
+     */
+    void skipBlocksWithoutMatches(boost::optional<Record>* record);
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // '_filter' compiled for matching the documents returned by the cursor. Null if there is no
+    // filter.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
@@ -110,6 +156,13 @@ private:
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
 
+    // The collection's zone map, if this scan may use it to skip blocks of records. Null
+    // otherwise.
+    const CollectionZoneMap* _zoneMap = nullptr;
+
+    // The block of the last record which was checked against '_zoneMap'.
+    boost::optional<long long> _lastZoneMapBlock;
+
     // If _params.shouldTrackLatestOplogTimestamp is set and the collection is the oplog, the latest
     // timestamp seen in the collection.  Otherwise, this is a null timestamp.
     Timestamp _latestOplogEntryTimestamp;
@@ -48,6 +48,18 @@ struct CollectionScanParams {
     // The RecordId to which we should seek to as the first document of the scan.
     RecordId start;
 
+    // If not null and 'start' is null, the scan begins at the first record at or past this
+    // RecordId in the scan direction, which need not exist. Only supported by record stores which
+    // implement RecordStore::oplogStartHack(), such as those clustered on _id; otherwise the scan
+    // begins at the start of the collection.
+    RecordId scanFrom;
+
+    // If not null, the scan returns EOF once it reaches this RecordId, or any RecordId past it in
+    // the scan direction, without returning that record. Together with 'start', this restricts a
+    // forward scan to the range [start, stop), such as one partition of a scan that has been split
+    // using CollectionScan::sampleRangeBoundaries().
+    RecordId stop;
+
     // If present, the collection scan will stop and return EOF the first time it sees a document
     // that does not pass the filter and has 'ts' greater than 'maxTs'.
     boost::optional<Timestamp> maxTs;
@@ -0,0 +1,261 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/column_scan.h"
+
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+// static
+const char* ColumnScan::kStageType = "COLUMN_SCAN";
+
+ColumnScan::ColumnScan(OperationContext* opCtx,
+                       const IndexDescriptor* descriptor,
+                       std::vector<std::string> fields,
+                       WorkingSet* workingSet,
+                       const MatchExpression* filter)
+    : PlanStage(kStageType, opCtx),
+      _workingSet(workingSet),
+      _filter(filter),
+      _iam(static_cast<const ColumnStoreAccessMethod*>(
+          descriptor->getIndexCatalog()->getIndex(descriptor))),
+      _fields(std::move(fields)) {
+    _rowCursor.column = ColumnStoreKeyGenerator::kRowColumn;
+    for (auto&& field : _fields) {
+        ColumnCursor columnCursor;
+        columnCursor.column = _iam->getKeyGenerator().getColumn(field);
+        invariant(columnCursor.column != ColumnStoreKeyGenerator::kRowColumn);
+        _columnCursors.push_back(std::move(columnCursor));
+    }
+
+    _specificStats.indexName = descriptor->indexName();
+    _specificStats.keyPattern = descriptor->keyPattern();
+    _specificStats.fields = _fields;
+}
+
+void ColumnScan::openCursors() {
+    const bool inclusive = false;
+    _rowCursor.cursor = _iam->newCursor(getOpCtx());
+    _rowCursor.cursor->setEndPosition(
+        ColumnStoreKeyGenerator::makeColumnStartKey(_rowCursor.column + 1), inclusive);
+    for (auto&& columnCursor : _columnCursors) {
+        columnCursor.cursor = _iam->newCursor(getOpCtx());
+        columnCursor.cursor->setEndPosition(
+            ColumnStoreKeyGenerator::makeColumnStartKey(columnCursor.column + 1), inclusive);
+    }
+}
+
+boost::optional<IndexKeyEntry> ColumnScan::seekCursors() {
+    boost::optional<IndexKeyEntry> row;
+    if (_lastRowKey.isEmpty()) {
+        const bool inclusive = true;
+        row = _rowCursor.cursor->seek(
+            ColumnStoreKeyGenerator::makeColumnStartKey(_rowCursor.column), inclusive);
+    } else {
+        const bool inclusive = false;
+        row = _rowCursor.cursor->seek(_lastRowKey, inclusive);
+    }
+    if (!row) {
+        return row;
+    }
+    ++_specificStats.keysExamined;
+
+    // Every column is ordered by _id, so positioning each column on the _id of the document
+    // skips the entries of any document that precedes it.
+    const BSONElement id = ColumnStoreKeyGenerator::extractId(row->key);
+    for (auto&& columnCursor : _columnCursors) {
+        BSONObjBuilder startKey;
+        startKey.append("", columnCursor.column);
+        startKey.appendAs(id, "");
+
+        const bool inclusive = true;
+        columnCursor.entry = columnCursor.cursor->seek(startKey.obj(), inclusive);
+        if (columnCursor.entry) {
+            ++_specificStats.keysExamined;
+        }
+    }
+    return row;
+}
+
+boost::optional<IndexKeyEntry> ColumnScan::advanceCursors() {
+    // The column cursors were advanced past the entries of the previous document when its object
+    // was assembled.
+    auto row = _rowCursor.cursor->next();
+    if (row) {
+        ++_specificStats.keysExamined;
+    }
+    return row;
+}
+
+PlanStage::StageState ColumnScan::doWork(WorkingSetID* out) {
+    if (_commonStats.isEOF) {
+        return PlanStage::IS_EOF;
+    }
+
+    RecordId recordId;
+    BSONObj obj;
+    try {
+        if (!_rowCursor.cursor) {
+            openCursors();
+        }
+
+        auto row = _needsSeek ? seekCursors() : advanceCursors();
+        if (!row) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+
+        // A column has an entry for the document if the document has the field. As the entries
+        // of each column are in the same order as the entries of the row column, any entry for
+        // the document is the one that the column cursor is positioned on.
+        BSONObjBuilder bob;
+        bob.appendAs(ColumnStoreKeyGenerator::extractId(row->key), "_id");
+        for (size_t i = 0; i < _columnCursors.size(); ++i) {
+            auto& columnCursor = _columnCursors[i];
+            if (!columnCursor.entry || columnCursor.entry->loc != row->loc) {
+                continue;
+            }
+
+            bob.appendAs(ColumnStoreKeyGenerator::extractValue(columnCursor.entry->key),
+                         _fields[i]);
+            columnCursor.entry = columnCursor.cursor->next();
+            if (columnCursor.entry) {
+                ++_specificStats.keysExamined;
+            }
+        }
+
+        recordId = row->loc;
+        obj = bob.obj();
+        _lastRowKey = row->key.getOwned();
+        _needsSeek = false;
+    } catch (const WriteConflictException&) {
+        // The cursors may have moved past the document that was being assembled. Find it again
+        // from the last document that was examined.
+        _needsSeek = true;
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->recordId = recordId;
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), obj};
+    _workingSet->transitionToRecordIdAndObj(id);
+
+    if (Filter::passes(member, _filter)) {
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
+
+    _workingSet->free(id);
+    return PlanStage::NEED_TIME;
+}
+
+bool ColumnScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+void ColumnScan::doSaveState() {
+    // Documents may be inserted or deleted while we yield, so the cursors are positioned afresh
+    // after '_lastRowKey' when the scan resumes.
+    _needsSeek = true;
+    if (_rowCursor.cursor) {
+        _rowCursor.cursor->saveUnpositioned();
+    }
+    for (auto&& columnCursor : _columnCursors) {
+        columnCursor.entry = boost::none;
+        if (columnCursor.cursor) {
+            columnCursor.cursor->saveUnpositioned();
+        }
+    }
+}
+
+void ColumnScan::doRestoreState() {
+    if (_rowCursor.cursor) {
+        _rowCursor.cursor->restore();
+    }
+    for (auto&& columnCursor : _columnCursors) {
+        if (columnCursor.cursor) {
+            columnCursor.cursor->restore();
+        }
+    }
+}
+
+void ColumnScan::doDetachFromOperationContext() {
+    if (_rowCursor.cursor) {
+        _rowCursor.cursor->detachFromOperationContext();
+    }
+    for (auto&& columnCursor : _columnCursors) {
+        if (columnCursor.cursor) {
+            columnCursor.cursor->detachFromOperationContext();
+        }
+    }
+}
+
+void ColumnScan::doReattachToOperationContext() {
+    if (_rowCursor.cursor) {
+        _rowCursor.cursor->reattachToOperationContext(getOpCtx());
+    }
+    for (auto&& columnCursor : _columnCursors) {
+        if (columnCursor.cursor) {
+            columnCursor.cursor->reattachToOperationContext(getOpCtx());
+        }
+    }
+}
+
+unique_ptr<PlanStageStats> ColumnScan::getStats() {
+    _commonStats.isEOF = isEOF();
+
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (NULL != _filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
+    unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_COLUMN_SCAN);
+    ret->specific = make_unique<ColumnScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ColumnScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
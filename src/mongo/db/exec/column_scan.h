@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/index/column_store_access_method.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+
+namespace mongo {
+
+class IndexDescriptor;
+class WorkingSet;
+
+/**
+ * Scans a columnstore index in place of the collection. The stage walks the row column of the
+ * index, which has an entry for every document, alongside the column of each field in 'fields'.
+ * For each document it assembles an owned object holding _id followed by those of 'fields' which
+ * the document has, in the order of the columns of the index, and applies 'filter' to it.
+ *
+ * The objects hold only the requested fields, so the stage can only answer queries which read no
+ * other fields. The documents are returned in _id order.
+ */
+class ColumnScan final : public PlanStage {
+public:
+    ColumnScan(OperationContext* opCtx,
+               const IndexDescriptor* descriptor,
+               std::vector<std::string> fields,
+               WorkingSet* workingSet,
+               const MatchExpression* filter);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+    void doSaveState() final;
+    void doRestoreState() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+
+    StageType stageType() const final {
+        return STAGE_COLUMN_SCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    struct ColumnCursor {
+        int column;
+        std::unique_ptr<SortedDataInterface::Cursor> cursor;
+
+        // The entry the cursor is positioned on, which belongs to the current document or to one
+        // after it.
+        boost::optional<IndexKeyEntry> entry;
+    };
+
+    // Opens a cursor over the row column and over each of the requested columns.
+    void openCursors();
+
+    // Positions the cursors on the first document, or on the document after '_lastRowKey'.
+    boost::optional<IndexKeyEntry> seekCursors();
+
+    // Advances the cursors past the document that was returned last.
+    boost::optional<IndexKeyEntry> advanceCursors();
+
+    // The WorkingSet we annotate with results. Not owned by us.
+    WorkingSet* _workingSet;
+
+    // Not owned by us.
+    const MatchExpression* _filter;
+
+    const ColumnStoreAccessMethod* _iam;
+
+    const std::vector<std::string> _fields;
+
+    ColumnCursor _rowCursor;
+    std::vector<ColumnCursor> _columnCursors;
+
+    // The owned row key of the document that was examined last. Empty before the first document.
+    BSONObj _lastRowKey;
+
+    // Set until the cursors are first positioned, and again after they may have been moved by a
+    // yield or an interrupted attempt to advance them. The cursors are then positioned by seeking
+    // past '_lastRowKey'.
+    bool _needsSeek = true;
+
+    ColumnScanStats _specificStats;
+};
+
+}  // namespace mongo
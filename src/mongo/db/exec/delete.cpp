@@ -93,7 +93,7 @@ bool DeleteStage::isEOF() {
         return true;
     }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
-        child()->isEOF();
+        _batchedIds.empty() && child()->isEOF();
 }
 
 PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
@@ -102,6 +102,10 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     }
     invariant(_collection);  // If isEOF() returns false, we must have a collection.
 
+    if (isBatched()) {
+        return doBatchedWork(out);
+    }
+
     // It is possible that after a delete was executed, a WriteConflictException occurred
     // and prevented us from returning ADVANCED with the old version of the document.
     if (_idReturning != WorkingSet::INVALID_ID) {
@@ -192,9 +196,6 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         member->obj.setValue(deletedDoc.getOwned());
     }
 
-    // TODO: Do we want to buffer docs and delete them in a group rather than saving/restoring state
-    // repeatedly?
-
     WorkingSetCommon::prepareForSnapshotChange(_ws);
     try {
         child()->saveState();
@@ -261,6 +262,108 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     return PlanStage::NEED_TIME;
 }
 
+bool DeleteStage::isBatched() const {
+    return _params.maxBatchSize > 1 && _params.isMulti && !_params.returnDeleted &&
+        !_params.isExplain;
+}
+
+PlanStage::StageState DeleteStage::doBatchedWork(WorkingSetID* out) {
+    // A full batch, or the last one, may be left over from a write conflict.
+    if (!_batchedIds.empty() &&
+        (_batchedIds.size() >= _params.maxBatchSize || child()->isEOF())) {
+        return deleteBatch(out);
+    }
+
+    WorkingSetID id;
+    auto status = child()->work(&id);
+
+    switch (status) {
+        case PlanStage::ADVANCED:
+            break;
+
+        case PlanStage::FAILURE:
+        case PlanStage::DEAD:
+            // The stage which produces a failure is responsible for allocating a working set
+            // member with error details.
+            invariant(WorkingSet::INVALID_ID != id);
+            *out = id;
+            return status;
+
+        case PlanStage::NEED_TIME:
+            return status;
+
+        case PlanStage::NEED_YIELD:
+            *out = id;
+            return status;
+
+        case PlanStage::IS_EOF:
+            return _batchedIds.empty() ? status : deleteBatch(out);
+
+        default:
+            MONGO_UNREACHABLE;
+    }
+
+    WorkingSetMember* member = _ws->get(id);
+    invariant(member->hasRecordId());
+    // Deletes can't have projections, so we should always get fetched data.
+    invariant(member->hasObj());
+
+    _batchedIds.push_back(id);
+    if (_batchedIds.size() < _params.maxBatchSize) {
+        return PlanStage::NEED_TIME;
+    }
+    return deleteBatch(out);
+}
+
+PlanStage::StageState DeleteStage::deleteBatch(WorkingSetID* out) {
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    size_t numDeleted = 0;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        std::vector<RecordId> recordIds;
+        recordIds.reserve(_batchedIds.size());
+        for (auto id : _batchedIds) {
+            // Skip documents that have been deleted, or updated so that they no longer match the
+            // predicate, since they were buffered.
+            if (write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                recordIds.push_back(_ws->get(id)->recordId);
+            }
+        }
+        _collection->deleteDocuments(
+            getOpCtx(), _params.stmtId, recordIds, _params.opDebug, _params.fromMigrate);
+        wunit.commit();
+        numDeleted = recordIds.size();
+    } catch (const WriteConflictException&) {
+        // Keep the batch so that it is retried as a whole.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    for (auto id : _batchedIds) {
+        _ws->free(id);
+    }
+    _batchedIds.clear();
+    _specificStats.docsDeleted += numDeleted;
+
+    // As in doWork(), restore the child's state outside of the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // The batch has already been committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 void DeleteStage::doRestoreState() {
     invariant(_collection);
     const NamespaceString& ns(_collection->ns());
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/logical_session_id.h"
@@ -73,6 +75,10 @@ struct DeleteStageParams {
 
     // Optional. When not null, delete metrics are recorded here.
     OpDebug* opDebug;
+
+    // The maximum number of documents a multi delete removes in each WriteUnitOfWork. Values
+    // greater than one do not apply to deletes which return the deleted document or are explained.
+    size_t maxBatchSize = 1;
 };
 
 /**
@@ -82,6 +88,11 @@ struct DeleteStageParams {
  *
  * Callers of work() must be holding a write lock (and, for replicated deletes, callers must have
  * had the replication coordinator approve the write).
+ *
+ * A multi delete with a 'maxBatchSize' greater than one instead buffers the members returned from
+ * its child, and deletes them together once it has 'maxBatchSize' of them or its child is EOF. Each
+ * buffered document is checked against the predicate again in the WriteUnitOfWork which deletes the
+ * batch, and a write conflict retries the whole batch after yielding.
  */
 class DeleteStage final : public PlanStage {
     MONGO_DISALLOW_COPYING(DeleteStage);
@@ -122,6 +133,22 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Returns true if this stage deletes the documents returned from its child in batches.
+     */
+    bool isBatched() const;
+
+    /**
+     * Implements work() for a batched delete.
+     */
+    StageState doBatchedWork(WorkingSetID* out);
+
+    /**
+     * Deletes the documents in '_batchedIds' which still exist and match the predicate, in one
+     * WriteUnitOfWork. Returns NEED_YIELD, keeping the batch to be retried, on a write conflict.
+     */
+    StageState deleteBatch(WorkingSetID* out);
+
     DeleteStageParams _params;
 
     // Not owned by us.
@@ -138,6 +165,9 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // Members returned from the child which are yet to be deleted by a batched delete.
+    std::vector<WorkingSetID> _batchedIds;
+
     // Stats
     DeleteStats _specificStats;
 };
@@ -69,6 +69,10 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (hasBufferedChildResults()) {
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -80,12 +84,15 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (hasBufferedChildResults()) {
+        status = ADVANCED;
+        id = popBufferedChildResult();
+    } else {
+        status = child()->work(&id);
     }
 
     if (PlanStage::ADVANCED == status) {
@@ -131,7 +138,103 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatch(size_t maxWorks,
+                                              std::vector<WorkingSetID>* out,
+                                              WorkingSetID* last) {
+    if (isEOF()) {
+        recordWork(PlanStage::IS_EOF);
+        return PlanStage::IS_EOF;
+    }
+
+    // Our child is worked at most once per batch, so that any state other than ADVANCED it reports
+    // can be passed straight up without holding on to results of our own.
+    if (WorkingSet::INVALID_ID == _idRetrying && !hasBufferedChildResults()) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState status = child()->workBatch(maxWorks, &_childResults, &id);
+        if (PlanStage::ADVANCED != status) {
+            if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+                invariant(WorkingSet::INVALID_ID != id);
+            }
+            recordWork(status);
+            *last = id;
+            return status;
+        }
+    }
+
+    const size_t sizeBefore = out->size();
+    for (size_t works = 0; works < maxWorks; ++works) {
+        WorkingSetID id;
+        if (WorkingSet::INVALID_ID != _idRetrying) {
+            id = _idRetrying;
+            _idRetrying = WorkingSet::INVALID_ID;
+        } else if (hasBufferedChildResults()) {
+            id = popBufferedChildResult();
+        } else {
+            break;
+        }
+
+        WorkingSetMember* member = _ws->get(id);
+        if (member->hasObj()) {
+            ++_specificStats.alreadyHasObj;
+        } else {
+            verify(WorkingSetMember::RID_AND_IDX == member->getState());
+            verify(member->hasRecordId());
+
+            try {
+                if (!_cursor)
+                    _cursor = _collection->getCursor(getOpCtx());
+
+                if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
+                    _ws->free(id);
+                    recordWork(PlanStage::NEED_TIME);
+                    continue;
+                }
+            } catch (const WriteConflictException&) {
+                member->makeObjOwnedIfNeeded();
+                _idRetrying = id;
+                if (out->size() > sizeBefore) {
+                    // Hand back what we have. The fetch is retried on the next call.
+                    return PlanStage::ADVANCED;
+                }
+                recordWork(PlanStage::NEED_YIELD);
+                *last = WorkingSet::INVALID_ID;
+                return PlanStage::NEED_YIELD;
+            }
+        }
+
+        StageState state = returnIfMatches(member, id, &id);
+        recordWork(state);
+        if (PlanStage::ADVANCED == state) {
+            out->push_back(id);
+
+            // A document we fetched is only valid until '_cursor' is repositioned. Rather than
+            // copying it to keep going, end the batch with it.
+            if (!member->obj.value().isOwned()) {
+                return PlanStage::ADVANCED;
+            }
+        }
+    }
+
+    return out->size() > sizeBefore ? PlanStage::ADVANCED : PlanStage::NEED_TIME;
+}
+
+WorkingSetID FetchStage::popBufferedChildResult() {
+    invariant(hasBufferedChildResults());
+    WorkingSetID id = _childResults[_childResultsPos++];
+    if (!hasBufferedChildResults()) {
+        _childResults.clear();
+        _childResultsPos = 0;
+    }
+    return id;
+}
+
 void FetchStage::doSaveState() {
+    // Buffered child results may refer to BSON owned by our child's storage cursor, which is not
+    // allowed to survive a yield.
+    for (size_t i = _childResultsPos; i < _childResults.size(); ++i) {
+        _ws->get(_childResults[i])->makeObjOwnedIfNeeded();
+    }
+
     if (_cursor)
         _cursor->saveUnpositioned();
 }
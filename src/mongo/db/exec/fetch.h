@@ -59,6 +59,9 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* last) final;
 
     void doSaveState() final;
     void doRestoreState() final;
@@ -82,6 +85,19 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Returns true if a batch obtained from our child in doWorkBatch() has not been fully
+     * consumed yet.
+     */
+    bool hasBufferedChildResults() const {
+        return _childResultsPos < _childResults.size();
+    }
+
+    /**
+     * Returns the next buffered child result, clearing the buffer once it is exhausted.
+     */
+    WorkingSetID popBufferedChildResult();
+
     // Collection which is used by this stage. Used to resolve record ids retrieved by child
     // stages. The lifetime of the collection must supersede that of the stage.
     const Collection* _collection;
@@ -97,6 +113,11 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // Results obtained from our child by workBatch() which we have not fetched yet. They are
+    // consumed, starting at '_childResultsPos', before our child is worked again.
+    std::vector<WorkingSetID> _childResults;
+    size_t _childResultsPos = 0;
+
     // Stats
     FetchStats _specificStats;
 };
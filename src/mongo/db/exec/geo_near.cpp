@@ -1066,7 +1066,16 @@ StatusWith<NearStage::CoveredInterval*>  //
     scanParams.bounds.fields[s2FieldPosition].intervals.clear();
     std::unique_ptr<S2Region> region(buildS2Region(_currBounds));
 
-    std::vector<S2CellId> cover = ExpressionMapping::get2dsphereCovering(*region);
+    // Queries near the same point expand their annuli by the same increments, so the annulus'
+    // exact bounds identify its covering.
+    BSONObjBuilder regionKey;
+    regionKey.append("x", _currBounds.center().x);
+    regionKey.append("y", _currBounds.center().y);
+    regionKey.append("inner", _currBounds.getInner());
+    regionKey.append("outer", _currBounds.getOuter());
+    const BSONObj regionKeyObj = regionKey.obj();
+    std::vector<S2CellId> cover = ExpressionMapping::get2dsphereCoveringCached(
+        *region, StringData(regionKeyObj.objdata(), regionKeyObj.objsize()));
 
     // Generate a covering that does not intersect with any previous coverings
     S2CellUnion coverUnion;
@@ -38,6 +38,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/btree_access_method.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -59,9 +60,12 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
       _workingSet(ws),
       _key(query->getQueryObj()["_id"].wrap()),
       _done(false) {
-    const IndexCatalog* catalog = _collection->getIndexCatalog();
-    _specificStats.indexName = descriptor->indexName();
-    _accessMethod = catalog->getIndex(descriptor);
+    if (descriptor) {
+        _specificStats.indexName = descriptor->indexName();
+        _accessMethod = _collection->getIndexCatalog()->getIndex(descriptor);
+    } else {
+        invariant(_collection->getRecordStore()->isClusteredOnId());
+    }
 
     if (NULL != query->getProj()) {
         _addKeyMetadata = query->getProj()->wantIndexKey();
@@ -81,9 +85,12 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
       _key(key),
       _done(false),
       _addKeyMetadata(false) {
-    const IndexCatalog* catalog = _collection->getIndexCatalog();
-    _specificStats.indexName = descriptor->indexName();
-    _accessMethod = catalog->getIndex(descriptor);
+    if (descriptor) {
+        _specificStats.indexName = descriptor->indexName();
+        _accessMethod = _collection->getIndexCatalog()->getIndex(descriptor);
+    } else {
+        invariant(_collection->getRecordStore()->isClusteredOnId());
+    }
 }
 
 IDHackStage::~IDHackStage() {}
@@ -99,8 +106,18 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
 
     WorkingSetID id = WorkingSet::INVALID_ID;
     try {
-        // Look up the key by going directly to the index.
-        RecordId recordId = _accessMethod->findSingle(getOpCtx(), _key);
+        RecordId recordId;
+        if (_accessMethod) {
+            // Look up the key by going directly to the index.
+            recordId = _accessMethod->findSingle(getOpCtx(), _key);
+        } else {
+            // The RecordId is derived from the _id itself. Values that can't be a key can't be
+            // the _id of any document in the collection.
+            auto swRecordId = clusteredid::keyForId(_key.firstElement());
+            if (swRecordId.isOK()) {
+                recordId = swRecordId.getValue();
+            }
+        }
 
         // Key not found.
         if (recordId.isNull()) {
@@ -108,7 +125,9 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
             return PlanStage::IS_EOF;
         }
 
-        ++_specificStats.keysExamined;
+        if (_accessMethod) {
+            ++_specificStats.keysExamined;
+        }
         ++_specificStats.docsExamined;
 
         // Create a new WSM for the result document.
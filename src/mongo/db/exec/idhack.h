@@ -44,6 +44,9 @@ class RecordCursor;
  * A standalone stage implementing the fast path for key-value retrievals via the _id index. Since
  * the _id index always has the collection default collation, the IDHackStage can only be used when
  * the query's collation is equal to the collection default.
+ *
+ * For collections clustered on _id, 'descriptor' is null and the record is looked up in the record
+ * store directly.
  */
 class IDHackStage final : public PlanStage {
 public:
@@ -101,8 +104,8 @@ private:
     // The WorkingSet we annotate with results.  Not owned by us.
     WorkingSet* _workingSet;
 
-    // Not owned here.
-    const IndexAccessMethod* _accessMethod;
+    // Not owned here. Null if the collection is clustered on _id.
+    const IndexAccessMethod* _accessMethod = nullptr;
 
     // The value to match against the _id field.
     BSONObj _key;
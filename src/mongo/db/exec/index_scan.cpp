@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/index_scan.h"
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/filter.h"
@@ -103,6 +104,7 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
         _startKey = _params.bounds.startKey;
         _endKey = _params.bounds.endKey;
         _indexCursor->setEndPosition(_endKey, _endKeyInclusive);
+        requestProjectedKeysFromCursor();
         return _indexCursor->seek(_startKey, _startKeyInclusive);
     } else {
         // For single intervals, we can use an optimized scan which checks against the position
@@ -111,8 +113,10 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
         if (IndexBoundsBuilder::isSingleInterval(
                 _params.bounds, &_startKey, &_startKeyInclusive, &_endKey, &_endKeyInclusive)) {
             _indexCursor->setEndPosition(_endKey, _endKeyInclusive);
+            requestProjectedKeysFromCursor();
             return _indexCursor->seek(_startKey, _startKeyInclusive);
         } else {
+            // The IndexBoundsChecker needs each key with all of its fields.
             _checker.reset(new IndexBoundsChecker(&_params.bounds, _keyPattern, _params.direction));
 
             if (!_checker->getStartSeekPoint(&_seekPoint))
@@ -123,6 +127,46 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
     }
 }
 
+bool IndexScan::setProjectedKeyFieldNames(const BSONObj& keyPattern,
+                                          std::vector<std::string> fieldNames) {
+    if (_filter || _params.addKeyMetadata || _scanState != INITIALIZING ||
+        !SimpleBSONObjComparator::kInstance.evaluate(keyPattern == _keyPattern)) {
+        return false;
+    }
+
+    // Fields past the last one included don't need to be decoded at all.
+    while (!fieldNames.empty() && fieldNames.back().empty()) {
+        fieldNames.pop_back();
+    }
+    if (fieldNames.empty()) {
+        // Nothing to name: the projection of every key is the empty object.
+        fieldNames.push_back("");
+    }
+
+    _projectedKeyFieldNames = std::move(fieldNames);
+    return true;
+}
+
+void IndexScan::requestProjectedKeysFromCursor() {
+    if (!_projectedKeyFieldNames.empty()) {
+        _cursorProjectsKeys = _indexCursor->setKeyFieldNames(_projectedKeyFieldNames);
+    }
+}
+
+BSONObj IndexScan::projectKey(const BSONObj& key) const {
+    BSONObjBuilder bob;
+    size_t keyIndex = 0;
+    BSONObjIterator keyIterator(key);
+    while (keyIterator.more() && keyIndex < _projectedKeyFieldNames.size()) {
+        BSONElement elt = keyIterator.next();
+        if (!_projectedKeyFieldNames[keyIndex].empty()) {
+            bob.appendAs(elt, _projectedKeyFieldNames[keyIndex]);
+        }
+        ++keyIndex;
+    }
+    return bob.obj();
+}
+
 PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     // Get the next kv pair from the index, if any.
     boost::optional<IndexKeyEntry> kv;
@@ -147,8 +191,9 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     }
 
     if (kv) {
-        // In debug mode, check that the cursor isn't lying to us.
-        if (kDebugBuild && !_startKey.isEmpty()) {
+        // In debug mode, check that the cursor isn't lying to us. Projected keys can't be
+        // compared against the bounds.
+        if (kDebugBuild && !_cursorProjectsKeys && !_startKey.isEmpty()) {
             int cmp = kv->key.woCompare(_startKey,
                                         Ordering::make(_keyPattern),
                                         /*compareFieldNames*/ false);
@@ -157,7 +202,7 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
             dassert(_forward ? cmp >= 0 : cmp <= 0);
         }
 
-        if (kDebugBuild && !_endKey.isEmpty()) {
+        if (kDebugBuild && !_cursorProjectsKeys && !_endKey.isEmpty()) {
             int cmp = kv->key.woCompare(_endKey,
                                         Ordering::make(_keyPattern),
                                         /*compareFieldNames*/ false);
@@ -208,8 +253,11 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
         }
     }
 
-    if (!kv->key.isOwned())
+    if (!_projectedKeyFieldNames.empty() && !_cursorProjectsKeys) {
+        kv->key = projectKey(kv->key);
+    } else if (!kv->key.isOwned()) {
         kv->key = kv->key.getOwned();
+    }
 
     // We found something to return, so fill out the WSM.
     WorkingSetID id = _workingSet->allocate();
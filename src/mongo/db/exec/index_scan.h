@@ -141,6 +141,18 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    /**
+     * Asks this stage to return each key as the simple inclusion projection of the key whose
+     * i-th field is named 'fieldNames[i]', and which doesn't include the fields whose name is
+     * empty. Used by a covered projection over this stage, which can then take the keys as is.
+     * When the index cursor supports it the keys are decoded straight into that form.
+     *
+     * Returns false, leaving the keys unchanged, if 'keyPattern' isn't this stage's key pattern,
+     * if this stage needs the original keys for a filter or for key metadata, or if the scan has
+     * already started.
+     */
+    bool setProjectedKeyFieldNames(const BSONObj& keyPattern, std::vector<std::string> fieldNames);
+
     static const char* kStageType;
 
 private:
@@ -149,6 +161,16 @@ private:
      */
     boost::optional<IndexKeyEntry> initIndexScan();
 
+    /**
+     * Asks the index cursor to return projected keys. See setProjectedKeyFieldNames().
+     */
+    void requestProjectedKeysFromCursor();
+
+    /**
+     * Returns 'key' with its fields named according to _projectedKeyFieldNames.
+     */
+    BSONObj projectKey(const BSONObj& key) const;
+
     // The WorkingSet we fill with results.  Not owned by us.
     WorkingSet* const _workingSet;
 
@@ -204,6 +226,14 @@ private:
     bool _startKeyInclusive;
     // Is the end key included in the range?
     bool _endKeyInclusive;
+
+    // If non-empty, the keys returned by this stage are projected to these field names. See
+    // setProjectedKeyFieldNames().
+    std::vector<std::string> _projectedKeyFieldNames;
+
+    // Whether the index cursor already returns the keys projected to _projectedKeyFieldNames.
+    // Otherwise this stage renames each key before returning it.
+    bool _cursorProjectsKeys = false;
 };
 
 }  // namespace mongo
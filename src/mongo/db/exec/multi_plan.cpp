@@ -45,6 +45,7 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -201,14 +202,21 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedTickTimer tickTimer(getTickSource(), &_commonStats.executionTimeNanos);
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
+    // Each round gives every plan up to 'worksPerPlan' units of work, so the total number of works
+    // per plan stays bounded by 'numWorks' regardless of the batch size.
+    const size_t worksPerPlan =
+        static_cast<size_t>(std::max(1, internalQueryPlanEvaluationWorkBatchSize.load()));
+
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
-    for (size_t ix = 0; ix < numWorks; ++ix) {
-        bool moreToDo = workAllPlans(numResults, yieldPolicy);
+    for (size_t ix = 0; ix < numWorks; ix += worksPerPlan) {
+        bool moreToDo =
+            workAllPlans(numResults, std::min(worksPerPlan, numWorks - ix), yieldPolicy);
         if (!moreToDo) {
             break;
         }
@@ -332,8 +340,11 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     return Status::OK();
 }
 
-bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy) {
+bool MultiPlanStage::workAllPlans(size_t numResults,
+                                  size_t worksPerPlan,
+                                  PlanYieldPolicy* yieldPolicy) {
     bool doneWorking = false;
+    std::vector<WorkingSetID> produced;
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
@@ -347,15 +358,31 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
         }
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState state = candidate.root->work(&id);
+        PlanStage::StageState state;
+        produced.clear();
+        if (worksPerPlan > 1) {
+            // Never ask for more results than would end the trial, so that batching does not
+            // change which results the candidates have buffered when ranking happens.
+            const size_t remaining = candidate.results.size() < numResults
+                ? numResults - candidate.results.size()
+                : 1;
+            state = candidate.root->workBatch(std::min(worksPerPlan, remaining), &produced, &id);
+        } else {
+            state = candidate.root->work(&id);
+            if (PlanStage::ADVANCED == state) {
+                produced.push_back(id);
+            }
+        }
 
         if (PlanStage::ADVANCED == state) {
-            // Save result for later.
-            WorkingSetMember* member = candidate.ws->get(id);
-            // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we choose to
-            // return the results from the 'candidate' plan.
-            member->makeObjOwnedIfNeeded();
-            candidate.results.push(id);
+            for (auto resultId : produced) {
+                // Save result for later.
+                WorkingSetMember* member = candidate.ws->get(resultId);
+                // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we
+                // choose to return the results from the 'candidate' plan.
+                member->makeObjOwnedIfNeeded();
+                candidate.results.push(resultId);
+            }
 
             // Once a plan returns enough results, stop working.
             if (candidate.results.size() >= numResults) {
@@ -41,16 +41,51 @@ namespace mongo {
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
-    ++_commonStats.works;
+
+    // Time every call until the stage has done a few units of work, so that short-lived stages
+    // get exact figures, and then only a sample scaled up to stand for the calls in between.
+    const bool warmingUp = _commonStats.works < kExecutionTimeSampleInterval;
+    const bool sampled = warmingUp || _commonStats.works % kExecutionTimeSampleInterval == 0;
+    ScopedTickTimer tickTimer(sampled ? getTickSource() : nullptr,
+                              &_commonStats.executionTimeNanos,
+                              warmingUp ? 1 : kExecutionTimeSampleInterval);
 
     StageState workResult = doWork(out);
+    recordWork(workResult);
+
+    return workResult;
+}
+
+PlanStage::StageState PlanStage::workBatch(size_t maxWorks,
+                                           std::vector<WorkingSetID>* out,
+                                           WorkingSetID* last) {
+    invariant(_opCtx);
+    invariant(maxWorks > 0);
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    // A batch amortizes the cost of reading the tick source, so every batch is timed.
+    ScopedTickTimer tickTimer(getTickSource(), &_commonStats.executionTimeNanos);
 
-    if (StageState::ADVANCED == workResult) {
-        ++_commonStats.advanced;
-    } else if (StageState::NEED_TIME == workResult) {
-        ++_commonStats.needTime;
-    } else if (StageState::NEED_YIELD == workResult) {
-        ++_commonStats.needYield;
+    const size_t sizeBefore = out->size();
+    StageState batchResult = doWorkBatch(maxWorks, out, last);
+    invariant(out->size() == sizeBefore || StageState::ADVANCED == batchResult);
+
+    return batchResult;
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(size_t maxWorks,
+                                             std::vector<WorkingSetID>* out,
+                                             WorkingSetID* last) {
+    StageState workResult = StageState::NEED_TIME;
+    for (size_t works = 0; works < maxWorks && StageState::NEED_TIME == workResult; ++works) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        workResult = doWork(&id);
+        recordWork(workResult);
+
+        if (StageState::ADVANCED == workResult) {
+            out->push_back(id);
+        } else {
+            *last = id;
+        }
     }
 
     return workResult;
@@ -100,4 +135,10 @@ ClockSource* PlanStage::getClock() const {
     return _opCtx->getServiceContext()->getFastClockSource();
 }
 
+TickSource* PlanStage::getTickSource() const {
+    return _opCtx->getServiceContext()->getTickSource();
+}
+
+constexpr size_t PlanStage::kExecutionTimeSampleInterval;
+
 }  // namespace mongo
@@ -40,6 +40,7 @@ class ClockSource;
 class Collection;
 class OperationContext;
 class RecordId;
+class TickSource;
 
 /**
  * A PlanStage ("stage") is the basic building block of a "Query Execution Plan."  A stage is
@@ -187,6 +188,23 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Batched analogue of work(). Performs up to 'maxWorks' units of work, appending every result
+     * produced to 'out'. This lets tight loops over a storage cursor produce many results per
+     * virtual call instead of returning through the whole plan tree once per document.
+     *
+     * Returns ADVANCED if at least one result was appended to 'out'. Any other state is only
+     * returned when nothing was appended, in which case '*last' is populated exactly as work()
+     * would populate its out parameter for that state. Stages which hit a retryable condition
+     * (such as a write conflict) after producing some results return those results first and
+     * report the condition on the next call.
+     *
+     * Every result appended to 'out', except possibly the last one, has owned BSON and may be held
+     * while this stage continues to do work. The caller must call makeObjOwnedIfNeeded() on the
+     * last result before working this stage again or yielding.
+     */
+    StageState workBatch(size_t maxWorks, std::vector<WorkingSetID>* out, WorkingSetID* last);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -331,6 +349,32 @@ protected:
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxWorks' units of work. See comment at workBatch() above.
+     *
+     * The default implementation adapts doWork(): it keeps working through NEED_TIME results, but
+     * stops at the first result so that stages which know nothing about batching never have to
+     * keep a result alive while they advance. Stages with a cheap inner loop override this to
+     * produce many results at once. Overrides must call recordWork() once per unit of work.
+     */
+    virtual StageState doWorkBatch(size_t maxWorks,
+                                   std::vector<WorkingSetID>* out,
+                                   WorkingSetID* last);
+
+    /**
+     * Updates the common stats to account for one unit of work which resulted in 'state'.
+     */
+    void recordWork(StageState state) {
+        ++_commonStats.works;
+        if (StageState::ADVANCED == state) {
+            ++_commonStats.advanced;
+        } else if (StageState::NEED_TIME == state) {
+            ++_commonStats.needTime;
+        } else if (StageState::NEED_YIELD == state) {
+            ++_commonStats.needYield;
+        }
+    }
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -367,6 +411,8 @@ protected:
 
     ClockSource* getClock() const;
 
+    TickSource* getTickSource() const;
+
     OperationContext* getOpCtx() const {
         return _opCtx;
     }
@@ -375,6 +421,11 @@ protected:
     CommonStats _commonStats;
 
 private:
+    // Reading the tick source costs about as much as a cheap stage's doWork(), so after the first
+    // kExecutionTimeSampleInterval calls only every kExecutionTimeSampleInterval-th call to work()
+    // is timed at nanosecond resolution.
+    static constexpr size_t kExecutionTimeSampleInterval = 8;
+
     OperationContext* _opCtx;
 };
 
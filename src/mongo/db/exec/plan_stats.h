@@ -64,6 +64,7 @@ struct CommonStats {
           needTime(0),
           needYield(0),
           executionTimeMillis(0),
+          executionTimeNanos(0),
           isEOF(false) {}
     // String giving the type of the stage. Not owned.
     const char* stageTypeStr;
@@ -85,6 +86,10 @@ struct CommonStats {
     // Time elapsed while working inside this stage.
     long long executionTimeMillis;
 
+    // Estimate of the same time at nanosecond resolution, measured with the tick source on a
+    // sample of the calls into this stage.
+    long long executionTimeNanos;
+
     // TODO: have some way of tracking WSM sizes (or really any series of #s).  We can measure
     // the size of our inputs and the size of our outputs.  We can do a lot with the WS here.
 
@@ -156,6 +161,9 @@ struct AndHashStats : public SpecificStats {
 
     // What's our memory limit?
     size_t memLimit = 0u;
+
+    // Did we exceed the memory limit and intersect externally?
+    bool usedDisk = false;
 };
 
 struct AndSortedStats : public SpecificStats {
@@ -199,6 +207,28 @@ struct CollectionScanStats : public SpecificStats {
     // sees a document that does not pass the filter and has a "ts" Timestamp field greater than
     // 'maxTs'.
     boost::optional<Timestamp> maxTs;
+
+    // Whether the scan consults the collection's zone map, and how many times it skipped ahead
+    // because the zone map showed that no document in the current block could pass the filter.
+    bool usesZoneMap = false;
+    size_t zoneMapSkips = 0;
+};
+
+struct ColumnScanStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        ColumnScanStats* specific = new ColumnScanStats(*this);
+        return specific;
+    }
+
+    std::string indexName;
+
+    BSONObj keyPattern;
+
+    // The fields read from the columns of the index.
+    std::vector<std::string> fields;
+
+    // The number of keys read from all of the columns, including the row column.
+    size_t keysExamined = 0;
 };
 
 struct CountStats : public SpecificStats {
@@ -500,6 +530,9 @@ struct SortStats : public SpecificStats {
     // What's our memory limit?
     size_t memLimit = 0u;
 
+    // Did we exceed the memory limit and sort externally?
+    bool usedDisk = false;
+
     // The number of results to return from the sort.
     size_t limit = 0u;
 
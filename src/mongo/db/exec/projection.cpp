@@ -30,6 +30,7 @@
 
 #include "mongo/db/exec/projection.h"
 
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -96,6 +97,17 @@ ProjectionStage::ProjectionStage(OperationContext* opCtx,
                     _includeKey.push_back(true);
                 }
             }
+
+            // An index scan can hand us the keys already projected, sparing us from building
+            // each result twice.
+            if (STAGE_IXSCAN == child->stageType()) {
+                std::vector<std::string> fieldNames;
+                for (size_t i = 0; i < _keyFieldNames.size(); ++i) {
+                    fieldNames.push_back(_includeKey[i] ? _keyFieldNames[i].toString() : "");
+                }
+                _keysProjectedByChild = static_cast<IndexScan*>(child)->setProjectedKeyFieldNames(
+                    _coveredKeyObj, std::move(fieldNames));
+            }
         } else {
             invariant(ProjectionStageParams::SIMPLE_DOC == params.projImpl);
         }
@@ -161,6 +173,17 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
         invariant(ProjectionStageParams::COVERED_ONE_INDEX == _projImpl);
         // We're pulling data out of the key.
         invariant(1 == member->keyData.size());
+
+        if (_keysProjectedByChild) {
+            // The key is already the projected, owned document.
+            BSONObj projected = member->keyData[0].keyData;
+            member->keyData.clear();
+            member->recordId = RecordId();
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), std::move(projected));
+            member->transitionToOwnedObj();
+            return Status::OK();
+        }
+
         size_t keyIndex = 0;
 
         // Look at every key element...
@@ -216,6 +239,41 @@ PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::doWorkBatch(size_t maxWorks,
+                                                   std::vector<WorkingSetID>* out,
+                                                   WorkingSetID* last) {
+    const size_t sizeBefore = out->size();
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->workBatch(maxWorks, out, &id);
+
+    if (PlanStage::ADVANCED != status) {
+        if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+            invariant(WorkingSet::INVALID_ID != id);
+        }
+        recordWork(status);
+        *last = id;
+        return status;
+    }
+
+    // Projecting in place leaves every member of the batch with owned BSON.
+    for (size_t i = sizeBefore; i < out->size(); ++i) {
+        Status projStatus = transform(_ws->get((*out)[i]));
+        if (!projStatus.isOK()) {
+            warning() << "Couldn't execute projection, status = " << redact(projStatus);
+            for (size_t j = sizeBefore; j < out->size(); ++j) {
+                _ws->free((*out)[j]);
+            }
+            out->resize(sizeBefore);
+            recordWork(PlanStage::FAILURE);
+            *last = WorkingSetCommon::allocateStatusMember(_ws, projStatus);
+            return PlanStage::FAILURE;
+        }
+        recordWork(PlanStage::ADVANCED);
+    }
+
+    return PlanStage::ADVANCED;
+}
+
 unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_PROJECTION);
@@ -82,6 +82,9 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* last) final;
 
     StageType stageType() const final {
         return STAGE_PROJECTION;
@@ -144,6 +147,9 @@ private:
 
     // If the i-th entry of _includeKey is true this is the field name for the i-th key field.
     std::vector<StringData> _keyFieldNames;
+
+    // True if the child index scan already returns the projected keys, which we then use as is.
+    bool _keysProjectedByChild = false;
 };
 
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/projection_exec.h"
 
+#include <algorithm>
+
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/matcher/expression.h"
@@ -181,6 +183,8 @@ ProjectionExec::ProjectionExec(OperationContext* opCtx,
             _arrayOpType = ARRAY_OP_POSITIONAL;
         }
     }
+
+    compileFlatProjection();
 }
 
 ProjectionExec::~ProjectionExec() {
@@ -234,6 +238,27 @@ void ProjectionExec::add(const string& field, int skip, int limit) {
     }
 }
 
+void ProjectionExec::compileFlatProjection() {
+    if (_special || _hasReturnKey || ARRAY_OP_NORMAL != _arrayOpType || !_matchers.empty() ||
+        !_meta.empty()) {
+        return;
+    }
+
+    std::vector<StringData> flatFields;
+    for (auto&& field : _fields) {
+        const ProjectionExec& subfm = *field.second;
+        // Every field must be included or excluded as a whole, the opposite of the default.
+        if (!subfm._fields.empty() || subfm._special || subfm._include == _include) {
+            return;
+        }
+        flatFields.push_back(field.first);
+    }
+
+    std::sort(flatFields.begin(), flatFields.end());
+    _flatFields = std::move(flatFields);
+    _isFlat = true;
+}
+
 //
 // Execution
 //
@@ -379,6 +404,11 @@ Status ProjectionExec::transform(WorkingSetMember* member) const {
 Status ProjectionExec::transform(const BSONObj& in,
                                  BSONObjBuilder* bob,
                                  const MatchDetails* details) const {
+    if (_isFlat) {
+        transformFlat(in, bob);
+        return Status::OK();
+    }
+
     const ArrayOpType& arrayOpType = _arrayOpType;
 
     BSONObjIterator it(in);
@@ -444,6 +474,24 @@ Status ProjectionExec::transform(const BSONObj& in,
     return Status::OK();
 }
 
+void ProjectionExec::transformFlat(const BSONObj& in, BSONObjBuilder* bob) const {
+    for (auto&& elt : in) {
+        const StringData fieldName = elt.fieldNameStringData();
+        if (fieldName == "_id"_sd) {
+            if (_includeID) {
+                bob->append(elt);
+            }
+            continue;
+        }
+
+        // An inclusion projection lists the fields to keep, an exclusion one those to drop.
+        const bool listed = std::binary_search(_flatFields.begin(), _flatFields.end(), fieldName);
+        if (listed != _include) {
+            bob->append(elt);
+        }
+    }
+}
+
 void ProjectionExec::appendArray(BSONObjBuilder* bob, const BSONObj& array, bool nested) const {
     int skip = nested ? 0 : _skip;
     int limit = nested ? -1 : _limit;
@@ -95,6 +95,13 @@ private:
      */
     void add(const std::string& field, int skip, int limit);
 
+    /**
+     * Prepares the single pass of transformFlat() if the projection only includes or only excludes
+     * top-level fields, with no operators or $meta projections. Must be called once all the fields
+     * have been added.
+     */
+    void compileFlatProjection();
+
     //
     // Execution
     //
@@ -119,6 +126,12 @@ private:
         return ARRAY_OP_POSITIONAL == _arrayOpType;
     }
 
+    /**
+     * Applies a projection which compileFlatProjection() found to be flat to the object 'in', by
+     * looking up each of its fields in '_flatFields'.
+     */
+    void transformFlat(const BSONObj& in, BSONObjBuilder* bob) const;
+
     /**
      * Appends the element 'e' to the builder 'bob', possibly descending into sub-fields of 'e'
      * if needed.
@@ -151,6 +164,11 @@ private:
     // The raw projection spec. that is passed into init(...)
     BSONObj _source;
 
+    // Whether the projection only includes or only excludes top-level fields, in which case
+    // '_flatFields' holds the sorted names of those fields, which point into the keys of '_fields'.
+    bool _isFlat = false;
+    std::vector<StringData> _flatFields;
+
     // Should we include the _id field?
     bool _includeID;
 
@@ -192,6 +192,26 @@ BSONObj transformCovered(BSONObj projSpec, const IndexKeyDatum& ikd) {
     return wsm->obj.value();
 }
 
+//
+// Inclusion and exclusion of top-level fields
+//
+
+TEST(ProjectionExecTest, TransformInclusionOfTopLevelFields) {
+    const char* s = "{_id: 1, a: 1, b: {c: 2}, d: [3, 4], e: 5}";
+    testTransform("{e: 1, b: 1}", "{}", s, true, "{_id: 1, b: {c: 2}, e: 5}");
+    testTransform("{d: 1, _id: 0}", "{}", s, true, "{d: [3, 4]}");
+    testTransform("{_id: 1, a: 1}", "{}", s, true, "{_id: 1, a: 1}");
+    testTransform("{z: 1}", "{}", s, true, "{_id: 1}");
+}
+
+TEST(ProjectionExecTest, TransformExclusionOfTopLevelFields) {
+    const char* s = "{_id: 1, a: 1, b: {c: 2}, d: [3, 4], e: 5}";
+    testTransform("{e: 0, b: 0}", "{}", s, true, "{_id: 1, a: 1, d: [3, 4]}");
+    testTransform("{d: 0, _id: 0}", "{}", s, true, "{a: 1, b: {c: 2}, e: 5}");
+    testTransform("{_id: 0}", "{}", s, true, "{a: 1, b: {c: 2}, d: [3, 4], e: 5}");
+    testTransform("{z: 0}", "{}", s, true, s);
+}
+
 //
 // position $
 //
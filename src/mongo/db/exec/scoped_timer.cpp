@@ -41,4 +41,9 @@ ScopedTimer::~ScopedTimer() {
     *_counter += elapsed;
 }
 
+void ScopedTickTimer::_record() {
+    const auto elapsed = _tickSource->ticksTo<Nanoseconds>(_tickSource->getTicks() - _start);
+    *_counter += durationCount<Nanoseconds>(elapsed) * _scale;
+}
+
 }  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/base/disallow_copying.h"
 
+#include "mongo/util/tick_source.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -57,4 +58,35 @@ private:
     const Date_t _start;
 };
 
+/**
+ * Like ScopedTimer, but measures the elapsed time in nanoseconds with a TickSource. A null
+ * TickSource makes the timer a no-op, so callers on hot paths can time only a sample of their
+ * calls; each measurement is multiplied by 'scale' so that the counter estimates the time spent in
+ * all calls rather than only the sampled ones.
+ */
+class ScopedTickTimer {
+    MONGO_DISALLOW_COPYING(ScopedTickTimer);
+
+public:
+    ScopedTickTimer(TickSource* ts, long long* counterNanos, long long scale = 1)
+        : _tickSource(ts),
+          _counter(counterNanos),
+          _scale(scale),
+          _start(ts ? ts->getTicks() : 0) {}
+
+    ~ScopedTickTimer() {
+        if (_tickSource) {
+            _record();
+        }
+    }
+
+private:
+    void _record();
+
+    TickSource* const _tickSource;
+    long long* const _counter;
+    const long long _scale;
+    const TickSource::Tick _start;
+};
+
 }  // namespace mongo
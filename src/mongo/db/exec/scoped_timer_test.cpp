@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/scoped_timer.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/tick_source_mock.h"
+
+namespace mongo {
+namespace {
+
+TEST(ScopedTickTimerTest, AddsElapsedNanosOnDestruction) {
+    TickSourceMock<Nanoseconds> tickSource;
+    long long counter = 5;
+    {
+        ScopedTickTimer timer(&tickSource, &counter);
+        tickSource.advance(Nanoseconds(250));
+        ASSERT_EQ(5, counter);
+    }
+    ASSERT_EQ(255, counter);
+}
+
+TEST(ScopedTickTimerTest, ConvertsTicksToNanos) {
+    TickSourceMock<Microseconds> tickSource;
+    long long counter = 0;
+    {
+        ScopedTickTimer timer(&tickSource, &counter);
+        tickSource.advance(Microseconds(3));
+    }
+    ASSERT_EQ(3000, counter);
+}
+
+TEST(ScopedTickTimerTest, ScalesSampledMeasurements) {
+    TickSourceMock<Nanoseconds> tickSource;
+    long long counter = 0;
+    {
+        ScopedTickTimer timer(&tickSource, &counter, 8);
+        tickSource.advance(Nanoseconds(100));
+    }
+    ASSERT_EQ(800, counter);
+}
+
+TEST(ScopedTickTimerTest, NullTickSourceRecordsNothing) {
+    long long counter = 7;
+    { ScopedTickTimer timer(nullptr, &counter, 8); }
+    ASSERT_EQ(7, counter);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -55,6 +55,10 @@ ShardFilterStage::ShardFilterStage(OperationContext* opCtx,
                                    PlanStage* child)
     : PlanStage(kStageType, opCtx), _ws(ws), _metadata(std::move(metadata)) {
     _children.emplace_back(child);
+
+    if (_metadata->isSharded()) {
+        _shardKeyPattern.emplace(_metadata->getKeyPattern());
+    }
 }
 
 ShardFilterStage::~ShardFilterStage() {}
@@ -76,10 +80,8 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
         // including pending documents from in-progress migrations and orphaned documents from
         // aborted migrations
         if (_metadata->isSharded()) {
-            ShardKeyPattern shardKeyPattern(_metadata->getKeyPattern());
             WorkingSetMember* member = _ws->get(*out);
-            WorkingSetMatchableDocument matchable(member);
-            BSONObj shardKey = shardKeyPattern.extractShardKeyFromMatchable(matchable);
+            BSONObj shardKey = _extractShardKey(member);
 
             if (shardKey.isEmpty()) {
                 // We can't find a shard key for this document - this should never happen with
@@ -105,7 +107,7 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
                           << "document may have been inserted manually into shard";
             }
 
-            if (!_metadata->keyBelongsToMe(shardKey)) {
+            if (!_keyBelongsToMe(shardKey)) {
                 _ws->free(*out);
                 ++_specificStats.chunkSkips;
                 return PlanStage::NEED_TIME;
@@ -120,6 +122,81 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+BSONObj ShardFilterStage::_extractShardKey(WorkingSetMember* member) {
+    if (!member->hasObj() && member->keyData.size() == 1) {
+        const IndexKeyDatum& keyDatum = member->keyData.front();
+
+        if (keyDatum.indexKeyPattern.objdata() != _lastIndexKeyPattern.objdata()) {
+            _lastIndexKeyPattern = keyDatum.indexKeyPattern;
+            _shardKeyPositions = _computeShardKeyPositions(keyDatum.indexKeyPattern);
+        }
+
+        if (!_shardKeyPositions.empty()) {
+            std::vector<BSONElement> keyElts;
+            for (const auto& keyElt : keyDatum.keyData) {
+                keyElts.push_back(keyElt);
+            }
+
+            BSONObjBuilder keyBuilder;
+            size_t i = 0;
+            for (const auto& patternElt : _metadata->getKeyPattern()) {
+                const int pos = _shardKeyPositions[i++];
+                if (pos >= static_cast<int>(keyElts.size()) || keyElts[pos].type() == Array) {
+                    return BSONObj();
+                }
+                keyBuilder.appendAs(keyElts[pos], patternElt.fieldName());
+            }
+            return keyBuilder.obj();
+        }
+    }
+
+    WorkingSetMatchableDocument matchable(member);
+    return _shardKeyPattern->extractShardKeyFromMatchable(matchable);
+}
+
+bool ShardFilterStage::_keyBelongsToMe(const BSONObj& shardKey) {
+    if (shardKey.isEmpty()) {
+        return false;
+    }
+
+    if (_lastChunkRange && _lastChunkRange->containsKey(shardKey)) {
+        return _lastChunkOwned;
+    }
+
+    _lastChunkOwned = _metadata->keyBelongsToMe(shardKey, &_lastChunkRange);
+    return _lastChunkOwned;
+}
+
+std::vector<int> ShardFilterStage::_computeShardKeyPositions(
+    const BSONObj& indexKeyPattern) const {
+    std::vector<int> positions;
+
+    for (const auto& patternElt : _metadata->getKeyPattern()) {
+        // Hashed shard key values are computed from the document, so leave them to the general
+        // extraction path rather than interpreting the index key values.
+        if (ShardKeyPattern::isHashedPatternEl(patternElt)) {
+            return {};
+        }
+
+        int pos = 0;
+        bool found = false;
+        for (const auto& indexElt : indexKeyPattern) {
+            if (indexElt.fieldNameStringData() == patternElt.fieldNameStringData()) {
+                found = indexElt.isNumber();
+                break;
+            }
+            ++pos;
+        }
+
+        if (!found) {
+            return {};
+        }
+        positions.push_back(pos);
+    }
+
+    return positions;
+}
+
 unique_ptr<PlanStageStats> ShardFilterStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret =
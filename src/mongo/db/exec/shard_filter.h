@@ -28,8 +28,13 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <vector>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/s/scoped_collection_metadata.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 
@@ -90,6 +95,26 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Returns the shard key of 'member', or an empty object if it cannot be found. Covered results
+     * take the shard key values straight from the index key when the index includes every shard
+     * key field.
+     */
+    BSONObj _extractShardKey(WorkingSetMember* member);
+
+    /**
+     * Returns whether 'shardKey' belongs to this shard. Consecutive keys which fall within the same
+     * chunk, as happens when scanning in shard key order, reuse the answer for that chunk instead
+     * of looking up the chunk map for every document.
+     */
+    bool _keyBelongsToMe(const BSONObj& shardKey);
+
+    /**
+     * Returns the position in 'indexKeyPattern' of each shard key field, or an empty vector if some
+     * shard key field is not available from the index key.
+     */
+    std::vector<int> _computeShardKeyPositions(const BSONObj& indexKeyPattern) const;
+
     WorkingSet* _ws;
 
     // Stats
@@ -98,6 +123,19 @@ private:
     // Note: it is important that this is the metadata from the time this stage is constructed.
     // See class comment for details.
     ScopedCollectionMetadata _metadata;
+
+    // Only set if the collection is sharded.
+    boost::optional<ShardKeyPattern> _shardKeyPattern;
+
+    // Bounds of the chunk which contained the last shard key looked up and whether this shard owns
+    // it. Unset if the last key was not within any chunk.
+    boost::optional<ChunkRange> _lastChunkRange;
+    bool _lastChunkOwned = false;
+
+    // Index key pattern of the last covered result and the positions of the shard key fields in
+    // it, which are only recomputed when results start coming from a different index.
+    BSONObj _lastIndexKeyPattern;
+    std::vector<int> _shardKeyPositions;
 };
 
 }  // namespace mongo
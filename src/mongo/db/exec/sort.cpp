@@ -67,6 +67,20 @@ bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
     return lhs.recordId < rhs.recordId;
 }
 
+SortStage::SpillComparator::SpillComparator(BSONObj sortComparator) {
+    // The RecordId appended to each key breaks ties, just as it does for in-memory sorts.
+    BSONObjBuilder bob;
+    bob.appendElements(sortComparator);
+    bob.append("$recordId", 1);
+    pattern = bob.obj();
+}
+
+int SortStage::SpillComparator::operator()(const SpillSorter::Data& lhs,
+                                           const SpillSorter::Data& rhs) const {
+    // False means ignore field names.
+    return lhs.first.woCompare(rhs.first, pattern, false);
+}
+
 SortStage::SortStage(OperationContext* opCtx,
                      const SortStageParams& params,
                      WorkingSet* ws,
@@ -76,9 +90,12 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse && !params.tempDir.empty()),
+      _tempDir(params.tempDir),
       _sorted(false),
       _resultIterator(_data.end()),
-      _memUsage(0) {
+      _memUsage(0),
+      _memCharge(opCtx) {
     _children.emplace_back(child);
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
@@ -97,18 +114,34 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    return _sortedOutput ? !_sortedOutput->more() : (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
-    if (_memUsage > maxBytes) {
-        mongoutils::str::stream ss;
-        ss << "Sort operation used more than the maximum " << maxBytes
-           << " bytes of RAM. Add an index, or specify a smaller limit.";
-        Status status(ErrorCodes::OperationFailed, ss);
-        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
-        return PlanStage::FAILURE;
+
+    // While all queries together use more memory than they may, sort externally before reaching
+    // our own limit if we can.
+    const bool withinGlobalBudget = _memCharge.set(_memUsage);
+    const bool spillEarly = !withinGlobalBudget && _allowDiskUse && !_sorter && !_sorted &&
+        _memUsage >= QueryMemoryTracker::kMinEarlySpillBytes;
+    if (_memUsage > maxBytes || spillEarly) {
+        Status status = _allowDiskUse ? spillToSorter() : Status::OK();
+        if (!_allowDiskUse) {
+            mongoutils::str::stream ss;
+            ss << "Sort operation used more than the maximum " << maxBytes
+               << " bytes of RAM. Add an index, specify a smaller limit, or specify"
+               << " allowDiskUse:true to sort externally.";
+            status = Status(ErrorCodes::OperationFailed, ss);
+        }
+
+        if (!status.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
     }
 
     if (isEOF()) {
@@ -140,14 +173,28 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
-            addToBuffer(item);
+            if (_sorter) {
+                Status status = addToSorter(item);
+                if (!status.isOK()) {
+                    *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                    return PlanStage::FAILURE;
+                }
+            } else {
+                addToBuffer(item);
+            }
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
-            _resultIterator = _data.begin();
+            if (_sorter) {
+                _sortedOutput.reset(_sorter->done());
+                _specificStats.usedDisk = _sorter->usedDisk();
+                _sorter.reset();
+            } else {
+                sortBuffer();
+                _resultIterator = _data.begin();
+            }
             _sorted = true;
             return PlanStage::NEED_TIME;
         } else if (PlanStage::FAILURE == code || PlanStage::DEAD == code) {
@@ -164,6 +211,12 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
+    if (_sortedOutput) {
+        verify(_sorted);
+        *out = nextSpilledResult();
+        return PlanStage::ADVANCED;
+    }
+
     verify(_resultIterator != _data.end());
     verify(_sorted);
     *out = _resultIterator->wsid;
@@ -190,6 +243,14 @@ const SpecificStats* SortStage::getSpecificStats() const {
     return &_specificStats;
 }
 
+void SortStage::doDetachFromOperationContext() {
+    _memCharge.detachFromOperationContext();
+}
+
+void SortStage::doReattachToOperationContext() {
+    _memCharge.reattachToOperationContext(getOpCtx());
+}
+
 /**
  * addToBuffer() and sortBuffer() work differently based on the
  * configured limit. addToBuffer() is also responsible for
@@ -292,4 +353,90 @@ void SortStage::sortBuffer() {
     }
 }
 
+Status SortStage::spillToSorter() {
+    invariant(!_sorter);
+    invariant(!_sorted);
+
+    SortOptions opts;
+    opts.limit = _limit;
+    opts.maxMemoryUsageBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+    opts.extSortAllowed = true;
+    opts.tempDir = _tempDir;
+    _sorter.reset(SpillSorter::make(opts, SpillComparator(_sortKeyComparator->pattern)));
+
+    std::vector<SortableDataItem> buffered;
+    if (_dataSet) {
+        buffered.assign(_dataSet->begin(), _dataSet->end());
+        _dataSet.reset();
+    } else {
+        buffered.swap(_data);
+    }
+    _memUsage = 0;
+
+    for (auto&& item : buffered) {
+        Status status = addToSorter(item);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status SortStage::addToSorter(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+
+    // Only the document, its RecordId and its sort key are written out, so we cannot spill
+    // documents carrying any other computed data such as a text score or a geoNear distance.
+    for (int type = 0; type < WSM_COMPUTED_NUM_TYPES; ++type) {
+        if (WSM_SORT_KEY != type &&
+            member->hasComputed(static_cast<WorkingSetComputedDataType>(type))) {
+            mongoutils::str::stream ss;
+            ss << "Sort operation used more than the maximum "
+               << internalQueryExecMaxBlockingSortBytes.load()
+               << " bytes of RAM and cannot sort documents with $meta data externally. Add an"
+               << " index, or specify a smaller limit.";
+            return Status(ErrorCodes::OperationFailed, ss);
+        }
+    }
+
+    BSONObjBuilder key;
+    key.appendElements(item.sortKey);
+    key.append("", static_cast<long long>(item.recordId.repr()));
+    _sorter->add(key.obj(), member->obj.value());
+
+    _ws->free(item.wsid);
+    return Status::OK();
+}
+
+WorkingSetID SortStage::nextSpilledResult() {
+    SpillSorter::Data data = _sortedOutput->next();
+
+    // Split the RecordId we appended back off the sort key.
+    BSONObjBuilder sortKey;
+    BSONElement recordIdElt;
+    for (auto&& elt : data.first) {
+        if (!recordIdElt.eoo()) {
+            sortKey.append(recordIdElt);
+        }
+        recordIdElt = elt;
+    }
+    const RecordId recordId(recordIdElt.numberLong());
+
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), data.second.getOwned());
+    member->addComputed(new SortKeyComputedData(sortKey.obj()));
+    if (recordId.isNull()) {
+        _ws->transitionToOwnedObj(id);
+    } else {
+        member->recordId = recordId;
+        _ws->transitionToRecordIdAndObj(id);
+    }
+    return id;
+}
+
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
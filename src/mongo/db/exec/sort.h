@@ -37,6 +37,8 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/query/query_memory_tracker.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +48,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,6 +58,11 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // If true, once the buffered data exceeds internalQueryExecMaxBlockingSortBytes the sort
+    // continues externally using files in 'tempDir' rather than failing.
+    bool allowDiskUse;
+    std::string tempDir;
 };
 
 /**
@@ -85,6 +92,9 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+
     static const char* kStageType;
 
 private:
@@ -104,6 +114,10 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // Whether, and where, we may spill to disk once we exceed the memory limit.
+    bool _allowDiskUse;
+    std::string _tempDir;
+
     //
     // Data storage
     //
@@ -150,6 +164,38 @@ private:
      */
     void sortBuffer();
 
+    //
+    // External sort
+    //
+
+    // The sorter's key is the sort key with the RecordId appended as a tie-breaker, and its value
+    // is the document.
+    using SpillSorter = Sorter<BSONObj, BSONObj>;
+
+    struct SpillComparator {
+        explicit SpillComparator(BSONObj sortComparator);
+
+        int operator()(const SpillSorter::Data& lhs, const SpillSorter::Data& rhs) const;
+
+        BSONObj pattern;
+    };
+
+    /**
+     * Moves every item we have buffered so far into '_sorter', which sorts externally using files
+     * in '_tempDir'. All subsequent input goes straight to '_sorter'.
+     */
+    Status spillToSorter();
+
+    /**
+     * Adds 'item' to '_sorter' and frees its working set member.
+     */
+    Status addToSorter(const SortableDataItem& item);
+
+    /**
+     * Allocates a working set member for the next document produced by '_sortedOutput'.
+     */
+    WorkingSetID nextSpilledResult();
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
@@ -168,10 +214,19 @@ private:
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
 
+    // Only set once we have exceeded the memory limit and started to sort externally.
+    std::unique_ptr<SpillSorter> _sorter;
+
+    // Iterates through the externally sorted data, returning it.
+    std::unique_ptr<SpillSorter::Iterator> _sortedOutput;
+
     SortStats _specificStats;
 
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+
+    // Charges '_memUsage' against the memory of the operation and of all queries.
+    QueryMemoryTracker::Charge _memCharge;
 };
 
 }  // namespace mongo
@@ -35,12 +35,15 @@
 #include <boost/optional.hpp>
 
 #include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_mock.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 
@@ -68,12 +71,15 @@ public:
      *     {input: [doc1, doc2, doc3, ...]}
      * expectedStr represents the expected sorted data set.
      *     {output: [docA, docB, docC, ...]}
+     * If tempDir is non-empty, the sort stage is allowed to spill to disk in that directory, and
+     * is expected to have done so.
      */
     void testWork(const char* patternStr,
                   CollatorInterface* collator,
                   int limit,
                   const char* inputStr,
-                  const char* expectedStr) {
+                  const char* expectedStr,
+                  const std::string& tempDir = "") {
         // WorkingSet is not owned by stages
         // so it's fine to declare
         WorkingSet ws;
@@ -102,6 +108,8 @@ public:
         SortStageParams params;
         params.pattern = fromjson(patternStr);
         params.limit = limit;
+        params.allowDiskUse = !tempDir.empty();
+        params.tempDir = tempDir;
 
         auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
             getOpCtx(), queuedDataStage.release(), &ws, params.pattern, collator);
@@ -137,6 +145,9 @@ public:
         ASSERT_EQUALS(state, PlanStage::IS_EOF);
         ASSERT_TRUE(sort.isEOF());
 
+        auto stats = static_cast<const SortStats*>(sort.getSpecificStats());
+        ASSERT_EQUALS(!tempDir.empty(), stats->usedDisk);
+
         // Finally, we get to compare the sorted results against what we expect.
         BSONObj expectedObj = fromjson(expectedStr);
         if (SimpleBSONObjComparator::kInstance.evaluate(outputObj != expectedObj)) {
@@ -289,4 +300,86 @@ TEST_F(SortStageTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+//
+// Sorting past internalQueryExecMaxBlockingSortBytes
+// Implementation should fail unless allowed to spill to disk, in which case the results and their
+// RecordId tie-breaking must match an in-memory sort.
+//
+
+class SortStageSpillTest : public SortStageTest {
+public:
+    SortStageSpillTest()
+        : _tempDir("SortStageSpillTest"),
+          _originalMaxBytes(internalQueryExecMaxBlockingSortBytes.load()) {
+        internalQueryExecMaxBlockingSortBytes.store(1);
+    }
+
+    ~SortStageSpillTest() {
+        internalQueryExecMaxBlockingSortBytes.store(_originalMaxBytes);
+    }
+
+    std::string tempDir() {
+        return _tempDir.path();
+    }
+
+private:
+    unittest::TempDir _tempDir;
+    const int _originalMaxBytes;
+};
+
+TEST_F(SortStageSpillTest, SortAscendingExternally) {
+    testWork("{a: 1}",
+             nullptr,
+             0,
+             "{input: [{a: 2}, {a: 1}, {a: 3}, {a: 0}]}",
+             "{output: [{a: 0}, {a: 1}, {a: 2}, {a: 3}]}",
+             tempDir());
+}
+
+TEST_F(SortStageSpillTest, SortDescendingWithLimitExternally) {
+    testWork("{a: -1}",
+             nullptr,
+             2,
+             "{input: [{a: 2}, {a: 1}, {a: 3}, {a: 4}]}",
+             "{output: [{a: 4}, {a: 3}]}",
+             tempDir());
+}
+
+TEST_F(SortStageSpillTest, SortWithCollationExternally) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    testWork("{a: 1}",
+             &collator,
+             0,
+             "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
+             "{output: [{a: 'aa'}, {a: 'ba'}, {a: 'ab'}]}",
+             tempDir());
+}
+
+TEST_F(SortStageSpillTest, SortFailsWithoutAllowDiskUse) {
+    WorkingSet ws;
+    auto queuedDataStage = stdx::make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    for (int i = 0; i < 2; ++i) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        wsm->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << i));
+        wsm->transitionToOwnedObj();
+        queuedDataStage->pushBack(id);
+    }
+
+    SortStageParams params;
+    params.pattern = BSON("a" << 1);
+    auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
+        getOpCtx(), queuedDataStage.release(), &ws, params.pattern, nullptr);
+    SortStage sort(getOpCtx(), params, &ws, sortKeyGen.release());
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (state == PlanStage::NEED_TIME) {
+        state = sort.work(&id);
+    }
+    ASSERT_EQUALS(state, PlanStage::FAILURE);
+    ASSERT_EQUALS(ErrorCodes::OperationFailed,
+                  WorkingSetCommon::getMemberStatus(*ws.get(id)).code());
+}
 }  // namespace
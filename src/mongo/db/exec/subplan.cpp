@@ -114,6 +114,11 @@ Status SubplanStage::planSubqueries() {
         LOG(5) << "Subplanner: index " << i << " is " << ie;
     }
 
+    // The plan for each branch must be an indexed plan that can be combined with the others, which
+    // a scan of a columnstore index cannot be.
+    QueryPlannerParams branchParams = _plannerParams;
+    branchParams.columnStoreIndices.clear();
+
     for (size_t i = 0; i < _orExpression->numChildren(); ++i) {
         // We need a place to shove the results from planning this branch.
         _branchResults.push_back(stdx::make_unique<BranchPlanningResult>());
@@ -155,7 +160,7 @@ Status SubplanStage::planSubqueries() {
             // We don't set NO_TABLE_SCAN because peeking at the cache data will keep us from
             // considering any plan that's a collscan.
             invariant(branchResult->solutions.empty());
-            auto solutions = QueryPlanner::plan(*branchResult->canonicalQuery, _plannerParams);
+            auto solutions = QueryPlanner::plan(*branchResult->canonicalQuery, branchParams);
             if (!solutions.isOK()) {
                 mongoutils::str::stream ss;
                 ss << "Can't plan for subchild " << branchResult->canonicalQuery->toString() << " "
@@ -433,6 +438,7 @@ Status SubplanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // Adds the amount of time taken by pickBestPlan() to executionTimeMillis. There's lots of
     // work that happens here, so this is needed for the time accounting to make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedTickTimer tickTimer(getTickSource(), &_commonStats.executionTimeNanos);
 
     // Plan each branch of the $or.
     Status subplanningStatus = planSubqueries();
@@ -118,8 +118,10 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
     std::unique_ptr<PlanStage> textMatchStage;
     if (wantTextScore) {
         // We use a TEXT_OR stage to get the union of the results from the index scans and then
-        // compute their text scores. This is a blocking operation.
-        auto textScorer = make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, _params.index);
+        // compute their text scores. This is a blocking operation. If only the highest scoring
+        // documents are needed, the TEXT_OR stage can stop reading the index scans early.
+        auto textScorer = make_unique<TextOrStage>(
+            opCtx, _params.spec, ws, filter, _params.index, _params.query, _params.topK);
 
         textScorer->addChildren(std::move(indexScanList));
 
@@ -63,6 +63,10 @@ struct TextStageParams {
     // True if we need the text score in the output, because the projection includes the 'textScore'
     // metadata field.
     bool wantTextScore = true;
+
+    // If nonzero, the caller only needs the 'topK' documents with the highest text scores, in any
+    // order. Only meaningful when 'wantTextScore' is true.
+    size_t topK = 0;
 };
 
 /**
@@ -28,6 +28,7 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -57,25 +58,37 @@ TextOrStage::TextOrStage(OperationContext* opCtx,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         IndexDescriptor* index)
+                         IndexDescriptor* index,
+                         const FTSQueryImpl& query,
+                         size_t topK)
     : PlanStage(kStageType, opCtx),
       _ftsSpec(ftsSpec),
       _ws(ws),
       _scoreIterator(_scores.end()),
+      _topK(topK),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID),
-      _index(index) {}
+      _index(index) {
+    if (_topK > 0) {
+        _matcher = make_unique<FTSMatcher>(query, _ftsSpec);
+        _terms.assign(query.getTermsForBounds().begin(), query.getTermsForBounds().end());
+    }
+}
 
 TextOrStage::~TextOrStage() {}
 
 void TextOrStage::addChild(unique_ptr<PlanStage> child) {
     _children.push_back(std::move(child));
+    _childMaxScores.push_back(std::numeric_limits<double>::infinity());
+    _childIsEOF.push_back(false);
 }
 
 void TextOrStage::addChildren(Children childrenToAdd) {
     _children.insert(_children.end(),
                      std::make_move_iterator(childrenToAdd.begin()),
                      std::make_move_iterator(childrenToAdd.end()));
+    _childMaxScores.resize(_children.size(), std::numeric_limits<double>::infinity());
+    _childIsEOF.resize(_children.size(), false);
 }
 
 bool TextOrStage::isEOF() {
@@ -186,10 +199,30 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        StageState addTermState = addTerm(id, out);
+        if (_topK == 0 || PlanStage::NEED_YIELD == addTermState) {
+            return addTermState;
+        }
+
+        if (canStopReadingTerms()) {
+            _scoreIterator = _scores.begin();
+            _internalState = State::kReturningResults;
+        } else {
+            advanceToNextChild();
+        }
+        return addTermState;
     } else if (PlanStage::IS_EOF == childState) {
         // Done with this child.
-        ++_currentChild;
+        if (_topK == 0) {
+            ++_currentChild;
+        } else {
+            _childMaxScores[_currentChild] = 0;
+            _childIsEOF[_currentChild] = true;
+            advanceToNextChild();
+            if (canStopReadingTerms()) {
+                _currentChild = _children.size();
+            }
+        }
 
         if (_currentChild < _children.size()) {
             // We have another child to read from.
@@ -221,6 +254,35 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 }
 
+void TextOrStage::advanceToNextChild() {
+    for (size_t i = 1; i <= _children.size(); ++i) {
+        const size_t nextChild = (_currentChild + i) % _children.size();
+        if (!_childIsEOF[nextChild]) {
+            _currentChild = nextChild;
+            return;
+        }
+    }
+
+    // Every child has hit EOF.
+    _currentChild = _children.size();
+}
+
+bool TextOrStage::canStopReadingTerms() const {
+    if (_topK == 0 || _topKHeap.size() < _topK) {
+        return false;
+    }
+
+    // A document which no child has returned yet can score at most the sum of the scores which
+    // each child may still return. Since a document only replaces one of the best '_topK' if it
+    // scores strictly higher than the lowest of them, there is no point in reading further once
+    // that bound is no higher than the lowest score.
+    double maxUnseenScore = 0;
+    for (auto childMaxScore : _childMaxScores) {
+        maxUnseenScore += childMaxScore;
+    }
+    return maxUnseenScore <= _topKHeap.top().first;
+}
+
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     if (_scoreIterator == _scores.end()) {
         _internalState = State::kDone;
@@ -250,10 +312,30 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
     invariant(1 == wsm->keyData.size());
     const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
-    TextRecordData* textRecordData = &_scores[wsm->recordId];
+
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(newKeyData.keyData);
+    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    BSONElement scoreElement = keyIt.next();
+    double documentTermScore = scoreElement.number();
+
+    if (_topK > 0) {
+        // The child scans the postings for its term in descending score order, so none of its
+        // remaining keys can have a higher score than this one.
+        _childMaxScores[_currentChild] = documentTermScore;
+    }
+
+    const RecordId recordId = wsm->recordId;
+    TextRecordData* textRecordData = &_scores[recordId];
 
     if (textRecordData->score < 0) {
-        // We have already rejected this document for not matching the filter.
+        // We have already rejected this document for not matching the filter or, in top-k mode,
+        // for not being among the best documents.
         invariant(WorkingSet::INVALID_ID == textRecordData->wsid);
         _ws->free(wsid);
         return NEED_TIME;
@@ -289,6 +371,16 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
 
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         wsm->makeObjOwnedIfNeeded();
+
+        if (_topK > 0) {
+            addDocumentToTopK(recordId, textRecordData);
+            return NEED_TIME;
+        }
+    } else if (_topK > 0) {
+        // In top-k mode, the score of the document was computed in full when we first saw it.
+        invariant(wsid != textRecordData->wsid);
+        _ws->free(wsid);
+        return NEED_TIME;
     } else {
         // We already have a working set member for this RecordId. Free the new WSM and retrieve the
         // old one. Note that since we don't keep all index keys, we could get a score that doesn't
@@ -299,20 +391,51 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
-    // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
+    // Aggregate relevance score, term keys.
+    textRecordData->score += documentTermScore;
+    return NEED_TIME;
+}
+
+void TextOrStage::addDocumentToTopK(const RecordId& recordId, TextRecordData* textRecordData) {
+    const BSONObj& obj = _ws->get(textRecordData->wsid)->obj.value();
+
+    const auto rejectDocument = [this](TextRecordData* rejected) {
+        _ws->free(rejected->wsid);
+        rejected->wsid = WorkingSet::INVALID_ID;
+        rejected->score = -1;
+    };
+
+    // Documents which the TEXT_MATCH stage above us would filter out must not take the place of
+    // ones that it would return.
+    if (!_matcher->matches(obj)) {
+        rejectDocument(textRecordData);
+        return;
     }
 
-    keyIt.next();  // Skip past 'term'.
+    // Add up the scores of the query terms in the order of our children, so that the result is
+    // the same as if we had accumulated the scores from each child's index key.
+    fts::TermFrequencyMap termFrequencies;
+    _ftsSpec.scoreDocument(obj, &termFrequencies);
+    double score = 0;
+    for (auto&& term : _terms) {
+        auto termFrequency = termFrequencies.find(term);
+        if (termFrequency != termFrequencies.end()) {
+            score += termFrequency->second;
+        }
+    }
 
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
+    if (_topKHeap.size() == _topK) {
+        if (score <= _topKHeap.top().first) {
+            rejectDocument(textRecordData);
+            return;
+        }
 
-    // Aggregate relevance score, term keys.
-    textRecordData->score += documentTermScore;
-    return NEED_TIME;
+        rejectDocument(&_scores[_topKHeap.top().second]);
+        _topKHeap.pop();
+    }
+
+    textRecordData->score = score;
+    _topKHeap.emplace(score, recordId);
 }
 
 }  // namespace mongo
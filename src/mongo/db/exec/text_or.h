@@ -29,9 +29,14 @@
 #pragma once
 
 #include <memory>
+#include <queue>
+#include <string>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/fts/fts_matcher.h"
+#include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/expression.h"
@@ -39,6 +44,8 @@
 
 namespace mongo {
 
+using fts::FTSMatcher;
+using fts::FTSQueryImpl;
 using fts::FTSSpec;
 
 class OperationContext;
@@ -47,6 +54,14 @@ class OperationContext;
  * A blocking stage that returns the set of WSMs with RecordIDs of all of the documents that contain
  * the positive terms in the search query, as well as their scores.
  *
+ * When constructed with a nonzero 'topK', the stage only returns the 'topK' highest scoring
+ * documents which match the text query. Each child must then be the scan of a single term's
+ * postings in descending score order, with the children in the order of the query's
+ * getTermsForBounds(). The children are read round-robin, and the exact score of each newly seen
+ * document is computed from the document itself. Reading stops as soon as no unseen document can
+ * score higher than the lowest of the best 'topK' documents seen so far, which is bounded by the
+ * sum of the last scores read from each child.
+ *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
  */
 class TextOrStage final : public PlanStage {
@@ -72,7 +87,9 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                IndexDescriptor* index);
+                IndexDescriptor* index,
+                const FTSQueryImpl& query,
+                size_t topK);
     ~TextOrStage();
 
     void addChild(std::unique_ptr<PlanStage> child);
@@ -99,6 +116,17 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     *  Temporary score data filled out by children.
+     *  Maps from RecordID -> (aggregate score for doc, wsid).
+     *  Map each buffered record id to this data.
+     */
+    struct TextRecordData {
+        TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0) {}
+        WorkingSetID wsid;
+        double score;
+    };
+
     /**
      * Worker for kInit. Initializes the _recordCursor member and handles the potential for
      * getCursor() to throw WriteConflictException.
@@ -117,6 +145,24 @@ private:
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Helper called from addTerm in top-k mode once the document for a newly seen RecordId has
+     * been fetched. Scores the document, and either keeps it among the best '_topK' documents or
+     * frees it.
+     */
+    void addDocumentToTopK(const RecordId& recordId, TextRecordData* textRecordData);
+
+    /**
+     * Returns true if we are in top-k mode, and no document which has not been seen yet can
+     * displace any of the best '_topK' documents seen so far.
+     */
+    bool canStopReadingTerms() const;
+
+    /**
+     * Moves '_currentChild' to the next child which has not hit EOF, in round-robin order.
+     */
+    void advanceToNextChild();
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -134,21 +180,32 @@ private:
     // Which of _children are we calling work(...) on now?
     size_t _currentChild = 0;
 
-    /**
-     *  Temporary score data filled out by children.
-     *  Maps from RecordID -> (aggregate score for doc, wsid).
-     *  Map each buffered record id to this data.
-     */
-    struct TextRecordData {
-        TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0) {}
-        WorkingSetID wsid;
-        double score;
-    };
-
     typedef stdx::unordered_map<RecordId, TextRecordData, RecordId::Hasher> ScoreMap;
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // The number of highest scoring documents to return, or 0 if all documents are returned.
+    const size_t _topK = 0;
+
+    // In top-k mode, matches fetched documents against the text query, so that documents which
+    // TEXT_MATCH would reject never take up one of the '_topK' slots.
+    std::unique_ptr<FTSMatcher> _matcher;
+
+    // In top-k mode, the term scanned by each child.
+    std::vector<std::string> _terms;
+
+    // An upper bound on the score of the keys which each child has yet to return, which is zero
+    // for children which have hit EOF. Only maintained in top-k mode.
+    std::vector<double> _childMaxScores;
+
+    // Whether each child has hit EOF. Only maintained in top-k mode.
+    std::vector<bool> _childIsEOF;
+
+    // In top-k mode, the best documents seen so far, with the lowest score on top.
+    typedef std::pair<double, RecordId> ScoredRecordId;
+    std::priority_queue<ScoredRecordId, std::vector<ScoredRecordId>, std::greater<ScoredRecordId>>
+        _topKHeap;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
@@ -37,6 +37,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/bson/mutable/algorithm.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/concurrency/write_conflict_tracker.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/write_stage_common.h"
@@ -46,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/update/damage_diff.h"
 #include "mongo/db/update/storage_validation.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -297,9 +299,9 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                     !request->isMulti() || args.criteria.hasField("_id"_sd));
             args.fromMigrate = request->isFromMigration();
             args.storeDocOption = getStoreDocMode(*request);
-            if (args.storeDocOption == CollectionUpdateArgs::StoreDocOption::PreImage) {
-                args.preImageDoc = oldObj.value().getOwned();
-            }
+            // The pre-image is owned by the working set, so sharing it is free. Observers such as
+            // the materialized view maintenance need it even when the oplog does not.
+            args.preImageDoc = oldObj.value();
         }
 
         if (inPlace) {
@@ -325,7 +327,16 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                   << BSONObjMaxUserSize,
                     newObj.objsize() <= BSONObjMaxUserSize);
 
-            if (!request->isExplain()) {
+            if (!request->isExplain() && canWriteDiffAsDamages(driver, oldObj.value(), newObj)) {
+                // No index needs new keys, so only the changed parts of the document are
+                // written.
+                const RecordData oldRec(oldObj.value().objdata(), oldObj.value().objsize());
+                Snapshotted<RecordData> snap(oldObj.snapshotId(), oldRec);
+                uassertStatusOK(_collection->updateDocumentWithDamages(
+                    getOpCtx(), recordId, std::move(snap), newObj.objdata(), _damages, &args));
+                newRecordId = recordId;
+            } else if (!request->isExplain()) {
+                args.modifiedIndexedPaths = driver->getModifiedIndexedPaths();
                 newRecordId = _collection->updateDocument(getOpCtx(),
                                                           recordId,
                                                           oldObj,
@@ -361,6 +372,19 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
     return newObj;
 }
 
+bool UpdateStage::canWriteDiffAsDamages(const UpdateDriver* driver,
+                                        const BSONObj& oldObj,
+                                        const BSONObj& newObj) {
+    // Documents in capped collections cannot change size, which updateDocument() enforces.
+    if (driver->modsAffectIndices() || _collection->isCapped() ||
+        !_collection->updateWithDamagesSupported()) {
+        return false;
+    }
+
+    // Writing the damages is only worthwhile if they cover a small part of the document.
+    return damagediff::computeDamages(oldObj, newObj, newObj.objsize() / 2, &_damages);
+}
+
 BSONObj UpdateStage::applyUpdateOpsForInsert(OperationContext* opCtx,
                                              const CanonicalQuery* cq,
                                              const BSONObj& query,
@@ -626,6 +650,8 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             // Do the update, get us the new version of the doc.
             newObj = transformAndUpdate(member->obj, recordId);
         } catch (const WriteConflictException&) {
+            WriteConflictTracker::get().recordDocumentConflict(
+                _collection->ns().ns(), recordId, member->obj.value());
             memberFreer.Dismiss();  // Keep this member around so we can retry updating it.
             return prepareToRetryWSM(id, out);
         }
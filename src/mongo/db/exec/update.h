@@ -152,6 +152,16 @@ private:
      */
     BSONObj transformAndUpdate(const Snapshotted<BSONObj>& oldObj, RecordId& recordId);
 
+    /**
+     * Returns true if the update of 'oldObj' to 'newObj' which could not be done in place should
+     * still be written as damages, which are then held in '_damages' with 'newObj' as their
+     * source. This is the case when no index is affected and only a small part of the document
+     * changed.
+     */
+    bool canWriteDiffAsDamages(const UpdateDriver* driver,
+                               const BSONObj& oldObj,
+                               const BSONObj& newObj);
+
     /**
      * Computes the document to insert and inserts it into the collection. Used if the
      * user requested an upsert and no matching documents were found.
@@ -98,4 +98,34 @@ std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
     return std::tuple<BSONObj, Date_t>(builder.obj(), start);
 }
 
+void FTDCNumericCollectorCollection::add(std::unique_ptr<FTDCNumericCollectorInterface> collector) {
+    auto metricNames = collector->metricNames();
+    _sampleSize += metricNames.size();
+    _collectors.push_back({std::move(collector), std::move(metricNames)});
+}
+
+void FTDCNumericCollectorCollection::collect(Date_t date, std::uint64_t* sample) {
+    *sample++ = date.toMillisSinceEpoch();
+
+    for (auto& collector : _collectors) {
+        collector.collector->collect(sample);
+        sample += collector.metricNames.size();
+    }
+}
+
+BSONObj FTDCNumericCollectorCollection::toBSON(const std::uint64_t* sample) const {
+    BSONObjBuilder builder;
+
+    builder.appendDate(kFTDCCollectStartField, Date_t::fromMillisSinceEpoch(*sample++));
+
+    for (auto& collector : _collectors) {
+        BSONObjBuilder subObjBuilder(builder.subobjStart(collector.collector->name()));
+        for (auto& metricName : collector.metricNames) {
+            subObjBuilder.append(metricName, static_cast<long long>(*sample++));
+        }
+    }
+
+    return builder.obj();
+}
+
 }  // namespace mongo
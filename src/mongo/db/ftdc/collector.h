@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -112,4 +114,101 @@ private:
     std::vector<std::unique_ptr<FTDCCollectorInterface>> _collectors;
 };
 
+/**
+ * Numeric Collector interface
+ *
+ * Provides an interface to collect a fixed layout of numbers from system providers cheaply enough
+ * to be sampled many times a second, i.e. counters and gauges that can be read without building
+ * BSON.
+ */
+class FTDCNumericCollectorInterface {
+    MONGO_DISALLOW_COPYING(FTDCNumericCollectorInterface);
+
+public:
+    virtual ~FTDCNumericCollectorInterface() = default;
+
+    /**
+     * Name of the collector
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * Names of the metrics in the order in which collect() writes them. The layout is fixed for the
+     * lifetime of the collector.
+     */
+    virtual std::vector<std::string> metricNames() const = 0;
+
+    /**
+     * Collect a sample by writing one value per metric name to 'metrics'.
+     *
+     * Called on a dedicated thread without an OperationContext at up to 100 Hz, so it must not
+     * block, allocate, or run commands.
+     */
+    virtual void collect(std::uint64_t* metrics) = 0;
+
+protected:
+    FTDCNumericCollectorInterface() = default;
+};
+
+/**
+ * Manages the set of numeric collectors
+ *
+ * Not Thread-Safe. Locking is owner's responsibility.
+ */
+class FTDCNumericCollectorCollection {
+    MONGO_DISALLOW_COPYING(FTDCNumericCollectorCollection);
+
+public:
+    FTDCNumericCollectorCollection() = default;
+
+    /**
+     * Add a metric collector to the collection.
+     * Must be called before collect. Cannot be called after collect is called.
+     */
+    void add(std::unique_ptr<FTDCNumericCollectorInterface> collector);
+
+    bool empty() const {
+        return _collectors.empty();
+    }
+
+    /**
+     * Number of values in a sample, including the time at which it was collected.
+     */
+    std::size_t getSampleSize() const {
+        return _sampleSize;
+    }
+
+    /**
+     * Collect a sample from all collectors into 'sample', which must have room for
+     * getSampleSize() values. The first value is 'date' in milliseconds since the epoch, followed
+     * by the metrics of each collector in the order they were added.
+     */
+    void collect(Date_t date, std::uint64_t* sample);
+
+    /**
+     * Convert a sample into a document with the same metrics, in the same order:
+     * {
+     *    "start" : Date_t,    <- Time at which the sample was collected
+     *    "name" : {           <- name is from name() in FTDCNumericCollectorInterface
+     *       "metric" : long,  <- metric names come from metricNames()
+     *       ...
+     *    },
+     *    ...
+     * }
+     */
+    BSONObj toBSON(const std::uint64_t* sample) const;
+
+private:
+    struct Collector {
+        std::unique_ptr<FTDCNumericCollectorInterface> collector;
+        std::vector<std::string> metricNames;
+    };
+
+    // collection of collectors
+    std::vector<Collector> _collectors;
+
+    // Number of values in a sample, starting with the collection time
+    std::size_t _sampleSize{1};
+};
+
 }  // namespace mongo
@@ -68,21 +68,51 @@ FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
 
     // We need to flush the current set of samples since the BSON schema has changed.
     if (!swMatches.getValue()) {
-        auto swCompressedSamples = getCompressedSamples();
+        return _flushForSchemaChange(sample, date);
+    }
 
-        if (!swCompressedSamples.isOK()) {
-            return swCompressedSamples.getStatus();
-        }
+    return _addDeltas();
+}
 
-        // Set the new sample as the current reference document as we have to start all over
-        _reset(sample, date);
-        return {std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>(
-            std::get<0>(swCompressedSamples.getValue()),
-            CompressorState::kSchemaChanged,
-            std::get<1>(swCompressedSamples.getValue()))};
+StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
+FTDCCompressor::addSample(const std::uint64_t* metrics,
+                          std::size_t count,
+                          Date_t date,
+                          const stdx::function<BSONObj()>& makeReferenceDoc) {
+    dassert(count < std::numeric_limits<std::uint32_t>::max());
+
+    _metrics.assign(metrics, metrics + count);
+
+    if (_referenceDoc.isEmpty()) {
+        _reset(makeReferenceDoc(), date);
+        return {boost::none};
+    }
+
+    if (count != _metricsCount) {
+        return _flushForSchemaChange(makeReferenceDoc(), date);
+    }
+
+    return _addDeltas();
+}
+
+StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
+FTDCCompressor::_flushForSchemaChange(const BSONObj& referenceDoc, Date_t date) {
+    auto swCompressedSamples = getCompressedSamples();
+
+    if (!swCompressedSamples.isOK()) {
+        return swCompressedSamples.getStatus();
     }
 
+    // Set the new sample as the current reference document as we have to start all over
+    _reset(referenceDoc, date);
+    return {std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>(
+        std::get<0>(swCompressedSamples.getValue()),
+        CompressorState::kSchemaChanged,
+        std::get<1>(swCompressedSamples.getValue()))};
+}
 
+StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
+FTDCCompressor::_addDeltas() {
     // Add another sample
     for (std::size_t i = 0; i < _metrics.size(); ++i) {
         // NOTE: This touches a lot of cache lines so that compression code can be more effcient.
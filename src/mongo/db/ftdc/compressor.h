@@ -40,6 +40,7 @@
 #include "mongo/db/ftdc/block_compressor.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -95,6 +96,24 @@ public:
     StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>> addSample(
         const BSONObj& sample, Date_t date);
 
+    /**
+     * Add a sample whose metrics have already been extracted into a fixed layout of 'count'
+     * integers, skipping the BSON traversal of the document overload. This is intended for
+     * high-frequency samples which are collected as raw numbers.
+     *
+     * 'makeReferenceDoc' is only called when this sample becomes the reference document. It must
+     * return a document from which FTDCBSONUtil::extractMetricsFromDocument() extracts exactly
+     * 'metrics', so that the chunk decompresses like any other. A change in 'count' is treated as a
+     * schema change.
+     *
+     * Returns the same values as the document overload.
+     */
+    StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>> addSample(
+        const std::uint64_t* metrics,
+        std::size_t count,
+        Date_t date,
+        const stdx::function<BSONObj()>& makeReferenceDoc);
+
     /**
      * Returns the number of enqueued samples.
      *
@@ -149,6 +168,19 @@ private:
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Delta encode the metrics in _metrics, which match the reference document, against the
+     * previous sample. Flushes if the chunk is full.
+     */
+    StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>>
+    _addDeltas();
+
+    /**
+     * Flush the current chunk because the schema changed, and start a new one with 'referenceDoc'.
+     */
+    StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>>
+    _flushForSchemaChange(const BSONObj& referenceDoc, Date_t date);
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
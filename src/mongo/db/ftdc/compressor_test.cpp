@@ -34,11 +34,13 @@
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/compressor.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/decompressor.h"
 #include "mongo/db/ftdc/ftdc_test.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 
@@ -649,4 +651,64 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// A numeric collector with a counter that increments on every sample, and a constant.
+class FTDCTestNumericCollector final : public FTDCNumericCollectorInterface {
+public:
+    std::string name() const final {
+        return "test";
+    }
+
+    std::vector<std::string> metricNames() const final {
+        return {"counter", "constant"};
+    }
+
+    void collect(std::uint64_t* metrics) final {
+        metrics[0] = _counter++;
+        metrics[1] = 42;
+    }
+
+private:
+    std::uint64_t _counter{0};
+};
+
+// Test raw metrics decompress to the documents they were extracted from
+TEST_F(FTDCCompressorTest, TestRawMetrics) {
+    FTDCConfig config;
+    FTDCCompressor c(&config);
+    FTDCDecompressor d;
+
+    FTDCNumericCollectorCollection collectors;
+    collectors.add(stdx::make_unique<FTDCTestNumericCollector>());
+    ASSERT_EQUALS(3U, collectors.getSampleSize());
+
+    std::vector<std::uint64_t> sample(collectors.getSampleSize());
+    std::vector<BSONObj> docs;
+
+    for (int i = 0; i < 10; i++) {
+        Date_t date = Date_t::fromMillisSinceEpoch(1000 + i * 10);
+        collectors.collect(date, sample.data());
+        docs.emplace_back(collectors.toBSON(sample.data()));
+
+        auto st = c.addSample(sample.data(), sample.size(), date, [&] {
+            return collectors.toBSON(sample.data());
+        });
+        ASSERT_HAS_SPACE(st);
+    }
+
+    auto swBuf = c.getCompressedSamples();
+    ASSERT_TRUE(swBuf.isOK());
+    ASSERT_EQUALS(Date_t::fromMillisSinceEpoch(1000), std::get<1>(swBuf.getValue()));
+
+    auto sw = d.uncompress(std::get<0>(swBuf.getValue()));
+    ASSERT_TRUE(sw.isOK());
+    ValidateDocumentList(sw.getValue(), docs, FTDCValidationMode::kStrict);
+
+    // A different number of metrics is a schema change
+    std::vector<std::uint64_t> other{1, 2};
+    auto st = c.addSample(other.data(), other.size(), Date_t(), [] {
+        return BSON("a" << 1LL << "b" << 2LL);
+    });
+    ASSERT_SCHEMA_CHANGED(st);
+}
+
 }  // namespace mongo
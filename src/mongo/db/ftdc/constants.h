@@ -46,6 +46,8 @@ extern const char kFTDCDocsField[];
 extern const char kFTDCCollectStartField[];
 extern const char kFTDCCollectEndField[];
 
+extern const char kFTDCHighFrequencyField[];
+
 constexpr StringData kFTDCDefaultDirectory = "diagnostic.data"_sd;
 
 }  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/condition_variable.h"
@@ -47,6 +48,14 @@
 
 namespace mongo {
 
+namespace {
+
+// Number of high-frequency samples buffered between writes. This holds over 10 seconds of samples
+// at the highest supported frequency, so that samples survive a periodic collection that stalls.
+const std::size_t kHighFrequencyBufferSamples = 1024;
+
+}  // namespace
+
 Status FTDCController::setEnabled(bool enabled) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -58,6 +67,7 @@ Status FTDCController::setEnabled(bool enabled) {
 
     _configTemp.enabled = enabled;
     _condvar.notify_one();
+    _highFrequencyCondvar.notify_one();
 
     return Status::OK();
 }
@@ -68,6 +78,12 @@ void FTDCController::setPeriod(Milliseconds millis) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _highFrequencyCondvar.notify_one();
+}
+
 void FTDCController::setMaxDirectorySizeBytes(std::uint64_t size) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _configTemp.maxDirectorySizeBytes = size;
@@ -127,6 +143,16 @@ void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCollector(
+    std::unique_ptr<FTDCNumericCollectorInterface> collector) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyCollectors.add(std::move(collector));
+    }
+}
+
 BSONObj FTDCController::getMostRecentPeriodicDocument() {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -138,9 +164,18 @@ void FTDCController::start() {
     log() << "Initializing full-time diagnostic data capture with directory '"
           << _path.generic_string() << "'";
 
+    if (!_highFrequencyCollectors.empty()) {
+        _highFrequencyBuffer = stdx::make_unique<FTDCRingBuffer>(
+            _highFrequencyCollectors.getSampleSize(), kHighFrequencyBufferSamples);
+    }
+
     // Start the thread
     _thread = stdx::thread([this] { doLoop(); });
 
+    if (_highFrequencyBuffer) {
+        _highFrequencyThread = stdx::thread([this] { doHighFrequencyLoop(); });
+    }
+
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -167,12 +202,17 @@ void FTDCController::stop() {
         _configTemp.enabled = false;
         _state = State::kStopRequested;
 
-        // Wake up the thread if sleeping so that it will check if we are done
+        // Wake up the threads if sleeping so that they will check if we are done
         _condvar.notify_one();
+        _highFrequencyCondvar.notify_one();
     }
 
     _thread.join();
 
+    if (_highFrequencyThread.joinable()) {
+        _highFrequencyThread.join();
+    }
+
     _state = State::kDone;
 
     if (_mgr) {
@@ -253,6 +293,10 @@ void FTDCController::doLoop() {
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
                     _mostRecentPeriodicDocument = std::get<0>(collectSample);
                 }
+
+                if (_highFrequencyBuffer) {
+                    writeHighFrequencySamples(client);
+                }
             }
         }
     } catch (...) {
@@ -262,4 +306,67 @@ void FTDCController::doLoop() {
     }
 }
 
+void FTDCController::writeHighFrequencySamples(Client* client) {
+    _highFrequencySamples.clear();
+
+    auto count = _highFrequencyBuffer->drain(&_highFrequencySamples);
+    auto sampleSize = _highFrequencyBuffer->getSampleSize();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t* sample = &_highFrequencySamples[i * sampleSize];
+
+        // The first value of each sample is the time at which it was collected.
+        Status s = _mgr->writeHighFrequencySampleAndRotateIfNeeded(
+            client, sample, sampleSize, Date_t::fromMillisSinceEpoch(sample[0]), [&] {
+                return BSON(kFTDCHighFrequencyField << _highFrequencyCollectors.toBSON(sample));
+            });
+
+        uassertStatusOK(s);
+    }
+}
+
+void FTDCController::doHighFrequencyLoop() {
+    try {
+        std::vector<std::uint64_t> sample(_highFrequencyCollectors.getSampleSize());
+        auto clockSource = getGlobalServiceContext()->getPreciseClockSource();
+
+        while (true) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+
+                // Check before waiting since a stop request while we were collecting would not
+                // wake us up.
+                if (_state == State::kStopRequested) {
+                    break;
+                }
+
+                auto period = _configTemp.highFrequencyPeriod;
+
+                // Sleep until we are signalled if high-frequency collection is disabled.
+                if (!_configTemp.enabled || period == Milliseconds(0)) {
+                    _highFrequencyCondvar.wait(lock);
+                    continue;
+                }
+
+                auto next_time = FTDCUtil::roundTime(clockSource->now(), period);
+                auto status =
+                    _highFrequencyCondvar.wait_until(lock, next_time.toSystemTimePoint());
+
+                // if we were signalled, then we have a config update only or were asked to stop
+                if (status == stdx::cv_status::no_timeout) {
+                    continue;
+                }
+            }
+
+            _highFrequencyCollectors.collect(clockSource->now(), sample.data());
+            _highFrequencyBuffer->push(sample.data());
+        }
+    } catch (...) {
+        warning() << "Uncaught exception in '" << exceptionToStatus()
+                  << "' in full-time diagnostic data capture high-frequency collection. Shutting "
+                     "down high-frequency collection.";
+    }
+}
+
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/file_manager.h"
+#include "mongo/db/ftdc/ring_buffer.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -74,6 +75,11 @@ public:
      */
     void setPeriod(Milliseconds millis);
 
+    /**
+     * Set the period for high-frequency data collection, or zero to disable it.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
     /**
      * Set the maximum directory size in bytes.
      */
@@ -110,6 +116,14 @@ public:
      */
     void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a numeric collector to sample at the high-frequency period. i.e., opcounters
+     *
+     * High-frequency samples are collected on their own thread into a ring buffer, and written
+     * by the periodic collection thread, so a slow periodic collector does not delay them.
+     */
+    void addHighFrequencyCollector(std::unique_ptr<FTDCNumericCollectorInterface> collector);
+
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
      *
@@ -147,6 +161,17 @@ private:
      */
     void doLoop();
 
+    /**
+     * Do high-frequency statistics collection on the high-frequency background thread.
+     */
+    void doHighFrequencyLoop();
+
+    /**
+     * Write the high-frequency samples collected since the last call. Called on the background
+     * thread.
+     */
+    void writeHighFrequencySamples(Client* client);
+
 private:
     /**
     * Private enum to track state.
@@ -189,6 +214,9 @@ private:
     stdx::mutex _mutex;
     stdx::condition_variable _condvar;
 
+    // Condvar to wake the high-frequency thread, protected by _mutex.
+    stdx::condition_variable _highFrequencyCondvar;
+
     // Config settings that are used by controller, file manager, and all other classes.
     // Copied from _configTemp periodically to get a consistent snapshot.
     FTDCConfig _config;
@@ -206,11 +234,25 @@ private:
     // Set of file rotation collectors
     FTDCCollectorCollection _rotateCollectors;
 
+    // Set of high-frequency collectors. Only collected by the high-frequency thread, but the
+    // background thread reads their fixed names to build reference documents.
+    FTDCNumericCollectorCollection _highFrequencyCollectors;
+
+    // High-frequency samples waiting to be written, only created if there are high-frequency
+    // collectors.
+    std::unique_ptr<FTDCRingBuffer> _highFrequencyBuffer;
+
+    // Samples drained from _highFrequencyBuffer by the background thread, reused across periods.
+    std::vector<std::uint64_t> _highFrequencySamples;
+
     // File manager that manages file rotation, and logging
     std::unique_ptr<FTDCFileManager> _mgr;
 
     // Background collection and writing thread
     stdx::thread _thread;
+
+    // High-frequency collection thread
+    stdx::thread _highFrequencyThread;
 };
 
 }  // namespace mongo
@@ -306,6 +306,25 @@ Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
     return Status::OK();
 }
 
+Status FTDCFileManager::writeHighFrequencySampleAndRotateIfNeeded(
+    Client* client,
+    const std::uint64_t* sample,
+    std::size_t count,
+    Date_t date,
+    const stdx::function<BSONObj()>& makeReferenceDoc) {
+    Status s = _writer.writeHighFrequencySample(sample, count, date, makeReferenceDoc);
+
+    if (!s.isOK()) {
+        return s;
+    }
+
+    if (_writer.getSize() > _config->maxFileSizeBytes) {
+        return rotate(client);
+    }
+
+    return Status::OK();
+}
+
 Status FTDCFileManager::close() {
     return _writer.close();
 }
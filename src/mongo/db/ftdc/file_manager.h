@@ -84,6 +84,18 @@ public:
      */
     Status writeSampleAndRotateIfNeeded(Client* client, const BSONObj& sample, Date_t date);
 
+    /**
+     * Writes a high-frequency sample to disk via FTDCFileWriter.
+     *
+     * Rotates files as needed.
+     */
+    Status writeHighFrequencySampleAndRotateIfNeeded(
+        Client* client,
+        const std::uint64_t* sample,
+        std::size_t count,
+        Date_t date,
+        const stdx::function<BSONObj()>& makeReferenceDoc);
+
     /**
      * Closes the current file manager down.
      */
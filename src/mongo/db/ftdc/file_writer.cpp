@@ -76,6 +76,7 @@ Status FTDCFileWriter::open(const boost::filesystem::path& file) {
     _interimTempFile = FTDCUtil::getInterimTempFile(file);
 
     _compressor.reset();
+    _highFrequencyCompressor.reset();
 
     return Status::OK();
 }
@@ -178,6 +179,44 @@ Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
     return Status::OK();
 }
 
+Status FTDCFileWriter::writeHighFrequencySample(const std::uint64_t* sample,
+                                                std::size_t count,
+                                                Date_t date,
+                                                const stdx::function<BSONObj()>& makeReferenceDoc) {
+    auto ret = _highFrequencyCompressor.addSample(sample, count, date, makeReferenceDoc);
+
+    if (!ret.isOK()) {
+        return ret.getStatus();
+    }
+
+    // Unlike BSON samples, partial chunks of high-frequency samples are not written to the interim
+    // file since they would displace the BSON samples there. At most one chunk is lost if the
+    // process terminates.
+    if (ret.getValue().is_initialized()) {
+        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(ret.getValue().get()),
+                                                                std::get<2>(ret.getValue().get()));
+        return writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+    }
+
+    return Status::OK();
+}
+
+Status FTDCFileWriter::flushHighFrequency() {
+    if (!_highFrequencyCompressor.hasDataToFlush()) {
+        return Status::OK();
+    }
+
+    auto swBuf = _highFrequencyCompressor.getCompressedSamples();
+
+    if (!swBuf.isOK()) {
+        return swBuf.getStatus();
+    }
+
+    BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
+                                                            std::get<1>(swBuf.getValue()));
+    return writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+}
+
 Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_t date) {
     if (!range.is_initialized()) {
         if (_compressor.hasDataToFlush()) {
@@ -211,7 +250,11 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
 
 Status FTDCFileWriter::close() {
     if (_archiveStream.is_open()) {
-        Status s = flush(boost::none, Date_t());
+        Status s = flushHighFrequency();
+
+        if (s.isOK()) {
+            s = flush(boost::none, Date_t());
+        }
 
         _archiveStream.close();
 
@@ -61,7 +61,8 @@ class FTDCFileWriter {
     MONGO_DISALLOW_COPYING(FTDCFileWriter);
 
 public:
-    FTDCFileWriter(const FTDCConfig* config) : _config(config), _compressor(_config) {}
+    FTDCFileWriter(const FTDCConfig* config)
+        : _config(config), _compressor(_config), _highFrequencyCompressor(_config) {}
     ~FTDCFileWriter();
 
     /**
@@ -79,6 +80,17 @@ public:
      */
     Status writeSample(const BSONObj& sample, Date_t date);
 
+    /**
+     * Write a high-frequency sample of 'count' raw metrics to the archive log as needed.
+     *
+     * High-frequency samples are compressed separately from BSON samples, and their chunks are
+     * written to the archive log once full. See FTDCCompressor::addSample for 'makeReferenceDoc'.
+     */
+    Status writeHighFrequencySample(const std::uint64_t* sample,
+                                    std::size_t count,
+                                    Date_t date,
+                                    const stdx::function<BSONObj()>& makeReferenceDoc);
+
     /**
      * Close all the files and shutdown cleanly by zeroing the beginning of the interim file.
      */
@@ -105,6 +117,11 @@ private:
      */
     Status flush(const boost::optional<ConstDataRange>&, Date_t date);
 
+    /**
+     * Flush any pending high-frequency samples to the archive log.
+     */
+    Status flushHighFrequency();
+
     /**
      * Write a buffer to the beginning of the interim file.
      */
@@ -134,6 +151,9 @@ private:
     // FTDC compressor
     FTDCCompressor _compressor;
 
+    // FTDC compressor for high-frequency samples
+    FTDCCompressor _highFrequencyCompressor;
+
     // Size of archive file
     std::size_t _size{0};
 
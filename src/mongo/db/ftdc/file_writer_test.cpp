@@ -280,6 +280,47 @@ TEST_F(FTDCFileTest, TestSchemaChanges) {
                      << 47));
 }
 
+// Test high-frequency samples are written alongside documents
+TEST_F(FTDCFileTest, TestHighFrequencySamples) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path p(tempdir.path());
+    p /= kTestFile;
+
+    deleteFileIfNeeded(p);
+
+    FTDCConfig config;
+    FTDCFileWriter writer(&config);
+
+    ASSERT_OK(writer.open(p));
+
+    std::vector<BSONObj> highFrequencyDocs;
+    std::vector<BSONObj> docs;
+
+    for (long long i = 0; i < 20; i++) {
+        std::vector<std::uint64_t> sample{static_cast<std::uint64_t>(i), 7};
+        auto makeDoc = [&] {
+            return BSON("highFrequency" << BSON("a" << static_cast<long long>(sample[0]) << "b"
+                                                    << static_cast<long long>(sample[1])));
+        };
+        highFrequencyDocs.emplace_back(makeDoc());
+        ASSERT_OK(writer.writeHighFrequencySample(sample.data(), sample.size(), Date_t(), makeDoc));
+
+        if (i % 10 == 0) {
+            docs.emplace_back(BSON("name"
+                                   << "joe"
+                                   << "key1"
+                                   << i));
+            ASSERT_OK(writer.writeSample(docs.back(), Date_t()));
+        }
+    }
+
+    ASSERT_OK(writer.close());
+
+    // Closing flushes the high-frequency chunk before the chunk of documents.
+    docs.insert(docs.begin(), highFrequencyDocs.begin(), highFrequencyDocs.end());
+    ValidateDocumentList(p, docs, FTDCValidationMode::kStrict);
+}
+
 // Test a full buffer
 TEST_F(FTDCFileTest, TestFull) {
     // Test a large numbers of zeros, and incremental numbers in a full buffer
@@ -32,16 +32,86 @@
 
 #include <boost/filesystem.hpp>
 
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/ftdc/ftdc_server.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/stats/query_stats.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/util/concurrency/ticketholder.h"
 
 namespace mongo {
 
 namespace {
+
+/**
+ * Collects a summary of the QueryStatsStore: its counters, and the statistics of the query shapes
+ * with the highest total latency.
+ */
+class FTDCQueryStatsCollector final : public FTDCCollectorInterface {
+public:
+    std::string name() const final {
+        return "queryStats";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        QueryStatsStore::get(opCtx->getServiceContext()).appendSummary(kTopShapes, &builder);
+    }
+
+private:
+    static constexpr size_t kTopShapes = 10;
+};
+
+/**
+ * Collects the number and total duration of the lock waits sampled by the LockContentionProfiler,
+ * per resource type.
+ */
+class FTDCLockContentionCollector final : public FTDCCollectorInterface {
+public:
+    std::string name() const final {
+        return "lockContention";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        LockContentionProfiler::get().appendSummary(&builder);
+    }
+};
+
+/**
+ * Collects the read and write tickets in use by the global lock throttling, the numbers which
+ * serverStatus reports in "wiredTiger.concurrentTransactions".
+ */
+class FTDCTicketsCollector final : public FTDCNumericCollectorInterface {
+public:
+    std::string name() const final {
+        return "tickets";
+    }
+
+    std::vector<std::string> metricNames() const final {
+        return {"readOut", "readTotal", "writeOut", "writeTotal"};
+    }
+
+    void collect(std::uint64_t* metrics) final {
+        collectTickets(Locker::getGlobalThrottling(MODE_IS), &metrics[0]);
+        collectTickets(Locker::getGlobalThrottling(MODE_IX), &metrics[2]);
+    }
+
+private:
+    static void collectTickets(TicketHolder* holder, std::uint64_t* metrics) {
+        // Storage engines which do not throttle have no ticket holders.
+        metrics[0] = holder ? holder->used() : 0;
+        metrics[1] = holder ? holder->outof() : 0;
+    }
+};
+
 void registerMongoDCollectors(FTDCController* controller) {
+    controller->addPeriodicCollector(stdx::make_unique<FTDCQueryStatsCollector>());
+    controller->addPeriodicCollector(stdx::make_unique<FTDCLockContentionCollector>());
+
+    controller->addHighFrequencyCollector(stdx::make_unique<FTDCTicketsCollector>());
+
     // These metrics are only collected if replication is enabled
     if (repl::ReplicationCoordinator::get(getGlobalServiceContext())->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
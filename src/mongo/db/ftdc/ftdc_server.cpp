@@ -44,6 +44,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/counters.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -110,6 +111,57 @@ public:
 
 } exportedFTDCPeriodParameter;
 
+AtomicInt32 localHighFrequencyPeriodMillis(FTDCConfig::kHighFrequencyPeriodMillisDefault);
+
+class ExportedFTDCHighFrequencyPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyPeriodMillis",
+              &localHighFrequencyPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue != 0 && (potentialNewValue < 10 || potentialNewValue > 1000)) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyPeriodMillis must be 0 to disable "
+                          "high-frequency collection, or between 10ms and 1000ms");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyPeriodParameter;
+
+/**
+ * Collects the operation counters reported in the "opcounters" section of serverStatus.
+ */
+class FTDCOpCountersCollector final : public FTDCNumericCollectorInterface {
+public:
+    std::string name() const final {
+        return "opcounters";
+    }
+
+    std::vector<std::string> metricNames() const final {
+        return {"insert", "query", "update", "delete", "getmore", "command"};
+    }
+
+    void collect(std::uint64_t* metrics) final {
+        metrics[0] = globalOpCounters.getInsert();
+        metrics[1] = globalOpCounters.getQuery();
+        metrics[2] = globalOpCounters.getUpdate();
+        metrics[3] = globalOpCounters.getDelete();
+        metrics[4] = globalOpCounters.getGetMore();
+        metrics[5] = globalOpCounters.getCommand();
+    }
+};
+
 // Scale the values down since are defaults are in bytes, but the user interface is MB
 AtomicInt32 localMaxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024));
 
@@ -270,6 +322,7 @@ void startFTDC(boost::filesystem::path& path,
                RegisterCollectorsFunction registerCollectors) {
     FTDCConfig config;
     config.period = Milliseconds(localPeriodMillis.load());
+    config.highFrequencyPeriod = Milliseconds(localHighFrequencyPeriodMillis.load());
     // Only enable FTDC if our caller says to enable FTDC, MongoS may not have a valid path to write
     // files to so update the diagnosticDataCollectionEnabled set parameter to reflect that.
     localEnabledFlag.store(startupMode == FTDCStartMode::kStart && localEnabledFlag.load());
@@ -300,6 +353,10 @@ void startFTDC(boost::filesystem::path& path,
         BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false << "timing"
                             << false)));
 
+    // Install high-frequency collectors
+    // These are collected on the high-frequency interval in FTDCConfig, if it is enabled.
+    controller->addHighFrequencyCollector(stdx::make_unique<FTDCOpCountersCollector>());
+
     registerCollectors(controller.get());
 
     // Install System Metric Collector as a periodic collector
@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/ring_buffer.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+FTDCRingBuffer::FTDCRingBuffer(std::size_t sampleSize, std::size_t capacity)
+    : _sampleSize(sampleSize), _capacity(capacity), _samples(sampleSize * capacity) {
+    invariant(_capacity > 0);
+}
+
+void FTDCRingBuffer::push(const std::uint64_t* sample) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    std::size_t slot;
+    if (_count == _capacity) {
+        // Overwrite the oldest sample.
+        slot = _head;
+        _head = (_head + 1) % _capacity;
+        ++_dropped;
+    } else {
+        slot = (_head + _count) % _capacity;
+        ++_count;
+    }
+
+    std::copy(sample, sample + _sampleSize, _samples.begin() + slot * _sampleSize);
+}
+
+std::size_t FTDCRingBuffer::drain(std::vector<std::uint64_t>* samples) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    const auto count = _count;
+    samples->reserve(samples->size() + count * _sampleSize);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        auto begin = _samples.begin() + ((_head + i) % _capacity) * _sampleSize;
+        samples->insert(samples->end(), begin, begin + _sampleSize);
+    }
+
+    _head = 0;
+    _count = 0;
+
+    return count;
+}
+
+std::uint64_t FTDCRingBuffer::getDroppedCount() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _dropped;
+}
+
+}  // namespace mongo
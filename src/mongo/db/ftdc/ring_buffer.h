@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * A fixed capacity ring of fixed-size numeric samples, used to hand high-frequency samples from
+ * the thread that collects them to the thread that compresses and writes them.
+ *
+ * When the ring is full, the oldest sample is overwritten so that the producer never blocks on the
+ * consumer, i.e. while a slow BSON collection or a disk write is in progress.
+ *
+ * Thread-Safe.
+ */
+class FTDCRingBuffer {
+    MONGO_DISALLOW_COPYING(FTDCRingBuffer);
+
+public:
+    FTDCRingBuffer(std::size_t sampleSize, std::size_t capacity);
+
+    /**
+     * Copy a sample of getSampleSize() values into the ring.
+     */
+    void push(const std::uint64_t* sample);
+
+    /**
+     * Append all samples in the ring to 'samples', oldest first, and empty the ring. Returns the
+     * number of samples appended.
+     */
+    std::size_t drain(std::vector<std::uint64_t>* samples);
+
+    /**
+     * Number of samples overwritten before they were drained.
+     */
+    std::uint64_t getDroppedCount() const;
+
+    std::size_t getSampleSize() const {
+        return _sampleSize;
+    }
+
+private:
+    const std::size_t _sampleSize;
+    const std::size_t _capacity;
+
+    // Protects the members below.
+    mutable stdx::mutex _mutex;
+
+    // _capacity * _sampleSize values.
+    std::vector<std::uint64_t> _samples;
+
+    // Index of the oldest sample.
+    std::size_t _head{0};
+
+    // Number of samples in the ring.
+    std::size_t _count{0};
+
+    std::uint64_t _dropped{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/ftdc/ring_buffer.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+// Test samples are drained in the order they were pushed
+TEST(FTDCRingBufferTest, DrainReturnsSamplesOldestFirst) {
+    FTDCRingBuffer buffer(2, 4);
+
+    std::vector<std::uint64_t> samples;
+    ASSERT_EQUALS(0U, buffer.drain(&samples));
+    ASSERT_TRUE(samples.empty());
+
+    for (std::uint64_t i = 0; i < 3; i++) {
+        std::uint64_t sample[] = {i, i * 10};
+        buffer.push(sample);
+    }
+
+    ASSERT_EQUALS(3U, buffer.drain(&samples));
+    ASSERT_TRUE((samples == std::vector<std::uint64_t>{0, 0, 1, 10, 2, 20}));
+
+    // Draining empties the buffer
+    samples.clear();
+    ASSERT_EQUALS(0U, buffer.drain(&samples));
+    ASSERT_EQUALS(0U, buffer.getDroppedCount());
+}
+
+// Test a full buffer overwrites its oldest samples
+TEST(FTDCRingBufferTest, FullBufferOverwritesOldestSamples) {
+    FTDCRingBuffer buffer(1, 3);
+
+    for (std::uint64_t i = 0; i < 5; i++) {
+        buffer.push(&i);
+    }
+
+    std::vector<std::uint64_t> samples;
+    ASSERT_EQUALS(3U, buffer.drain(&samples));
+    ASSERT_TRUE((samples == std::vector<std::uint64_t>{2, 3, 4}));
+    ASSERT_EQUALS(2U, buffer.getDroppedCount());
+
+    // The buffer wraps around correctly after draining
+    for (std::uint64_t i = 5; i < 7; i++) {
+        buffer.push(&i);
+    }
+
+    samples.clear();
+    ASSERT_EQUALS(2U, buffer.drain(&samples));
+    ASSERT_TRUE((samples == std::vector<std::uint64_t>{5, 6}));
+}
+
+}  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/fts/fts_tokenizer.h"
 #include "mongo/db/fts/fts_util.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/stringutils.h"
 
@@ -54,6 +55,19 @@ const double MAX_WEIGHT = 1000000000;
 const double MAX_WORD_WEIGHT = MAX_WEIGHT / 10000;
 
 namespace {
+// Tokenizers are reused across the strings and documents scored on a thread, so that their
+// stemmers are only created once per language and keep the stems they have already computed.
+thread_local stdx::unordered_map<const FTSLanguage*, std::unique_ptr<FTSTokenizer>>
+    threadTokenizers;
+
+FTSTokenizer* getThreadTokenizer(const FTSLanguage* language) {
+    auto& tokenizer = threadTokenizers[language];
+    if (!tokenizer) {
+        tokenizer = language->createTokenizer();
+    }
+    return tokenizer.get();
+}
+
 // Default language.  Used for new indexes.
 const std::string moduleDefaultLanguage("english");
 
@@ -183,8 +197,7 @@ void FTSSpec::scoreDocument(const BSONObj& obj, TermFrequencyMap* term_freqs) co
 
     while (it.more()) {
         FTSIteratorValue val = it.next();
-        std::unique_ptr<FTSTokenizer> tokenizer(val._language->createTokenizer());
-        _scoreStringV2(tokenizer.get(), val._text, term_freqs, val._weight);
+        _scoreStringV2(getThreadTokenizer(val._language), val._text, term_freqs, val._weight);
     }
 }
 
@@ -50,10 +50,29 @@ Stemmer::~Stemmer() {
     }
 }
 
+constexpr size_t Stemmer::kMaxCachedWordSize;
+constexpr size_t Stemmer::kMaxCachedStems;
+
 StringData Stemmer::stem(StringData word) const {
     if (!_stemmer)
         return word;
 
+    if (word.size() > kMaxCachedWordSize)
+        return _stem(word);
+
+    auto it = _stems.find(word);
+    if (it != _stems.end())
+        return it->second;
+
+    if (_stems.size() >= kMaxCachedStems)
+        _stems.clear();
+
+    std::string& stemmed = _stems[word];
+    stemmed = _stem(word).toString();
+    return stemmed;
+}
+
+StringData Stemmer::_stem(StringData word) const {
     const sb_symbol* sb_sym =
         sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/util/string_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -61,7 +64,19 @@ public:
     StringData stem(StringData word) const;
 
 private:
+    // Words longer than this are rare enough in text that they are not worth remembering.
+    static constexpr size_t kMaxCachedWordSize = 32;
+
+    // The cache is emptied once it holds this many stems, which bounds its memory.
+    static constexpr size_t kMaxCachedStems = 4096;
+
+    StringData _stem(StringData word) const;
+
     struct sb_stemmer* _stemmer;
+
+    // Stems of recently seen words, since the same words come up over and over in a body of text
+    // and running the snowball stemmer is much more expensive than a lookup.
+    mutable StringMap<std::string> _stems;
 };
 }
 }
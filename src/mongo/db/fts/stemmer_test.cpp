@@ -48,5 +48,21 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+TEST(English, RepeatedWordsStemTheSame) {
+    Stemmer s(&languageEnglishV2);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQUALS("run", s.stem("running"));
+        ASSERT_EQUALS("jump", s.stem("jumping"));
+    }
+}
+
+TEST(English, StemsRemainCorrectWhenCacheFills) {
+    Stemmer s(&languageEnglishV2);
+    for (int i = 0; i < 10000; i++) {
+        s.stem("running" + std::to_string(i));
+        ASSERT_EQUALS("run", s.stem("running"));
+    }
+}
 }
 }
@@ -60,6 +60,30 @@ inline void appendUtf8Codepoint(char32_t codepoint, OutputIterator* outputIt) {
         *(*outputIt)++ = (((codepoint >> (6 * 0)) & 0x3f) | 0x80);
     }
 }
+
+/**
+ * Returns the number of leading bytes of 'utf8' that are ASCII, stopping early at a null byte
+ * since that is where decoding stops.
+ */
+size_t countLeadingAscii(const StringData utf8) {
+    size_t pos = 0;
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    while (utf8.size() - pos >= ByteVector::size) {
+        auto word = ByteVector::load(utf8.rawData() + pos);
+        ByteVector::Mask stopMask = word.maskHigh() | word.compareEQ(0).maskAny();
+        if (stopMask)
+            return pos + ByteVector::countInitialZeros(stopMask);
+        pos += ByteVector::size;
+    }
+#endif
+    while (pos < utf8.size()) {
+        const unsigned char c = utf8[pos];
+        if (c == 0 || c > 0x7f)
+            break;
+        ++pos;
+    }
+    return pos;
+}
 }
 
 using linenoise_utf8::copyString32to8;
@@ -82,22 +106,31 @@ void String::setData(const StringData utf8_src) {
     // plus a null character if there isn't one.
     _data.resize(utf8_src.size() + 1);
 
+    // Most text is ASCII, where each byte is its own codepoint, so widen the leading run of ASCII
+    // directly and only decode what follows it.
+    const size_t asciiSize = countLeadingAscii(utf8_src);
+    for (size_t i = 0; i < asciiSize; ++i) {
+        _data[i] = static_cast<unsigned char>(utf8_src[i]);
+    }
+
     int result = 0;
     size_t resultSize = 0;
 
     // Although utf8_src.rawData() is not guaranteed to be null-terminated, copyString8to32 won't
     // access bad memory because it is limited by the size of its output buffer, which is set to the
-    // size of utf8_src.
-    copyString8to32(&_data[0],
-                    reinterpret_cast<const unsigned char*>(&utf8_src.rawData()[0]),
-                    _data.size(),
-                    resultSize,
-                    result);
+    // size of the rest of utf8_src.
+    if (asciiSize < utf8_src.size() && utf8_src[asciiSize] != '\0') {
+        copyString8to32(&_data[asciiSize],
+                        reinterpret_cast<const unsigned char*>(&utf8_src.rawData()[asciiSize]),
+                        _data.size() - asciiSize,
+                        resultSize,
+                        result);
+    }
 
     uassert(28755, "text contains invalid UTF-8", result == 0);
 
     // Resize _data so it is only as big as what it contains.
-    _data.resize(resultSize);
+    _data.resize(asciiSize + resultSize);
     _needsOutputConversion = true;
 }
 
@@ -84,6 +84,25 @@ TEST(UnicodeString, SubstrTest) {
     ASSERT_EQ("", indexes.substrToBuf(&buf, 1, 0));   // len == 0.
 }
 
+TEST(UnicodeString, ConvertsAsciiFollowedByMultibyteCharacters) {
+    // Long enough for the ASCII prefix to span more than one vector of bytes.
+    const std::string ascii = "the quick brown fox jumps over";
+    String str(ascii + "\xc3\xa9t\xc3\xa9");
+    ASSERT_EQ(ascii.size() + 3, str.size());
+    ASSERT_EQ(U'\u00e9', str[ascii.size()]);
+    ASSERT_EQ(ascii + "\xc3\xa9t\xc3\xa9", str.toString());
+}
+
+TEST(UnicodeString, ConversionStopsAtNullByte) {
+    String str(StringData("abcdefghijklmnopqrstuvwxyz\0abc", 30));
+    ASSERT_EQ(26U, str.size());
+    ASSERT_EQ("abcdefghijklmnopqrstuvwxyz", str.toString());
+}
+
+TEST(UnicodeString, InvalidUtf8AfterAsciiThrows) {
+    ASSERT_THROWS_CODE(String("abcdefghijklmnopqrstuvwxyz\xff"), AssertionException, 28755);
+}
+
 TEST(UnicodeString, RemoveDiacritics) {
     // Test all ascii chars.
     for (unsigned char ch = 0; ch <= 0x7F; ch++) {
@@ -30,6 +30,7 @@
 
 #include <boost/optional.hpp>
 
+#include "mongo/bson/bsonobj_field_index.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
@@ -87,8 +88,10 @@ BSONElement BtreeKeyGenerator::_extractNextElement(const BSONObj& obj,
                                                    const PositionalPathInfo& positionalInfo,
                                                    const char** field,
                                                    bool* arrayNestedArray) const {
-    std::string firstField = mongoutils::str::before(*field, '.');
-    bool haveObjField = !obj.getField(firstField).eoo();
+    const char* dot = strchr(*field, '.');
+    const StringData firstField = dot ? StringData(*field, dot - *field) : StringData(*field);
+    const BSONElement objField = BSONObjFieldIndex::lookup(obj, firstField);
+    bool haveObjField = !objField.eoo();
     BSONElement arrField = positionalInfo.positionallyIndexedElt;
 
     // An index component field name cannot exist in both a document
@@ -104,7 +107,15 @@ BSONElement BtreeKeyGenerator::_extractNextElement(const BSONObj& obj,
 
     *arrayNestedArray = false;
     if (haveObjField) {
-        return dps::extractElementAtPathOrArrayAlongPath(obj, *field);
+        // Continue from the top-level element found above instead of scanning 'obj' for it again,
+        // as dps::extractElementAtPathOrArrayAlongPath() would.
+        *field = dot ? dot + 1 : *field + firstField.size();
+        if (objField.type() == Array || **field == '\0') {
+            return objField;
+        } else if (objField.type() == Object) {
+            return dps::extractElementAtPathOrArrayAlongPath(objField.embeddedObject(), *field);
+        }
+        return BSONElement();
     } else if (positionalInfo.hasPositionallyIndexedElt()) {
         if (arrField.type() == Array) {
             *arrayNestedArray = true;
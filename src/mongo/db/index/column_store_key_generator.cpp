@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/column_store_key_generator.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+constexpr int ColumnStoreKeyGenerator::kRowColumn;
+
+ColumnStoreKeyGenerator::ColumnStoreKeyGenerator(const BSONObj& keyPattern) {
+    for (auto&& elem : keyPattern) {
+        _columnFields.push_back(elem.fieldName());
+        _columnsByField[elem.fieldNameStringData()] = static_cast<int>(_columnFields.size());
+    }
+}
+
+void ColumnStoreKeyGenerator::generateKeys(const BSONObj& doc, BSONObjSet* keys) const {
+    BSONElement idElem;
+    std::vector<BSONElement> values(_columnFields.size());
+    for (auto&& elem : doc) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "_id") {
+            idElem = elem;
+            continue;
+        }
+        const int column = getColumn(fieldName);
+        if (column != kRowColumn && values[column - 1].eoo()) {
+            values[column - 1] = elem;
+        }
+    }
+
+    uassert(51012,
+            str::stream() << "A columnstore index can only index documents with an _id: " << doc,
+            !idElem.eoo());
+
+    {
+        BSONObjBuilder rowKey;
+        rowKey.append("", kRowColumn);
+        rowKey.appendAs(idElem, "");
+        keys->insert(rowKey.obj());
+    }
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i].eoo()) {
+            continue;
+        }
+        BSONObjBuilder columnKey;
+        columnKey.append("", static_cast<int>(i + 1));
+        columnKey.appendAs(idElem, "");
+        columnKey.appendAs(values[i], "");
+        keys->insert(columnKey.obj());
+    }
+}
+
+int ColumnStoreKeyGenerator::getColumn(StringData fieldName) const {
+    auto it = _columnsByField.find(fieldName);
+    return it == _columnsByField.end() ? kRowColumn : it->second;
+}
+
+BSONObj ColumnStoreKeyGenerator::makeColumnStartKey(int column) {
+    return BSON("" << column);
+}
+
+BSONElement ColumnStoreKeyGenerator::extractId(const BSONObj& key) {
+    BSONObjIterator it(key);
+    it.next();
+    return it.next();
+}
+
+BSONElement ColumnStoreKeyGenerator::extractValue(const BSONObj& key) {
+    BSONObjIterator it(key);
+    it.next();
+    it.next();
+    return it.next();
+}
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Generates the keys of a columnstore index, e.g. { a: "columnstore", b: "columnstore" }. Each
+ * field of the key pattern is a column, numbered from 1 in key pattern order. Every document has a
+ * key in the row column 0, and one key in each column whose field it contains:
+ *      { '': 0, '': <_id> }
+ *      { '': <column>, '': <_id>, '': <whole field value> }
+ *
+ * Since each column is ordered by _id, the entries of any column for a range of documents appear in
+ * the same relative order as their row entries, which lets a scan reassemble documents by walking
+ * the columns side by side. The values are stored without regard to any collation.
+ */
+class ColumnStoreKeyGenerator {
+public:
+    static constexpr int kRowColumn = 0;
+
+    explicit ColumnStoreKeyGenerator(const BSONObj& keyPattern);
+
+    /**
+     * Adds the row key and the key of each column present in 'doc' to 'keys'. Throws if 'doc' has
+     * no _id.
+     */
+    void generateKeys(const BSONObj& doc, BSONObjSet* keys) const;
+
+    /**
+     * Returns the column number of the top-level field 'fieldName', or 'kRowColumn' if the field is
+     * not a column of this index.
+     */
+    int getColumn(StringData fieldName) const;
+
+    /**
+     * Returns the fields of the columns in key pattern order. The field of column 'n' is at
+     * position 'n - 1'.
+     */
+    const std::vector<std::string>& getColumnFields() const {
+        return _columnFields;
+    }
+
+    /**
+     * Returns a key that sorts before every key of 'column'.
+     */
+    static BSONObj makeColumnStartKey(int column);
+
+    /**
+     * Returns the _id stored in 'key', which must be a key of this index.
+     */
+    static BSONElement extractId(const BSONObj& key);
+
+    /**
+     * Returns the field value stored in 'key', which must be a key of a column other than the row
+     * column.
+     */
+    static BSONElement extractValue(const BSONObj& key);
+
+private:
+    std::vector<std::string> _columnFields;
+    StringMap<int> _columnsByField;
+};
+
+}  // namespace mongo
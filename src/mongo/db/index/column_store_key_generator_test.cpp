@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/index/column_store_key_generator.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObjSet makeKeySet(std::initializer_list<BSONObj> init = {}) {
+    return SimpleBSONObjComparator::kInstance.makeBSONObjSet(std::move(init));
+}
+
+void assertKeysetsEqual(const BSONObjSet& expectedKeys, const BSONObjSet& actualKeys) {
+    ASSERT_EQ(expectedKeys.size(), actualKeys.size());
+    ASSERT_TRUE(std::equal(expectedKeys.begin(),
+                           expectedKeys.end(),
+                           actualKeys.begin(),
+                           SimpleBSONObjComparator::kInstance.makeEqualTo()));
+}
+
+TEST(ColumnStoreKeyGeneratorTest, GeneratesRowKeyAndOneKeyPerPresentColumn) {
+    ColumnStoreKeyGenerator keyGen{fromjson("{a: 'columnstore', b: 'columnstore'}")};
+    BSONObjSet keys = makeKeySet();
+    keyGen.generateKeys(fromjson("{_id: 7, b: 'x', c: 3, a: 1.5}"), &keys);
+
+    assertKeysetsEqual(makeKeySet({fromjson("{'': 0, '': 7}"),
+                                   fromjson("{'': 1, '': 7, '': 1.5}"),
+                                   fromjson("{'': 2, '': 7, '': 'x'}")}),
+                       keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, MissingColumnsHaveNoKeys) {
+    ColumnStoreKeyGenerator keyGen{fromjson("{a: 'columnstore', b: 'columnstore'}")};
+    BSONObjSet keys = makeKeySet();
+    keyGen.generateKeys(fromjson("{_id: 'k', c: 3}"), &keys);
+
+    assertKeysetsEqual(makeKeySet({fromjson("{'': 0, '': 'k'}")}), keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, StoresWholeValuesOfArraysAndObjects) {
+    ColumnStoreKeyGenerator keyGen{fromjson("{a: 'columnstore', b: 'columnstore'}")};
+    BSONObjSet keys = makeKeySet();
+    keyGen.generateKeys(fromjson("{_id: 1, a: [1, [2]], b: {c: null}}"), &keys);
+
+    assertKeysetsEqual(makeKeySet({fromjson("{'': 0, '': 1}"),
+                                   fromjson("{'': 1, '': 1, '': [1, [2]]}"),
+                                   fromjson("{'': 2, '': 1, '': {c: null}}")}),
+                       keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, FailsOnDocumentWithoutId) {
+    ColumnStoreKeyGenerator keyGen{fromjson("{a: 'columnstore'}")};
+    BSONObjSet keys = makeKeySet();
+    ASSERT_THROWS_CODE(keyGen.generateKeys(fromjson("{a: 1}"), &keys), AssertionException, 51012);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, ExtractsIdAndValueFromKeys) {
+    ColumnStoreKeyGenerator keyGen{fromjson("{a: 'columnstore', b: 'columnstore'}")};
+    ASSERT_EQ(keyGen.getColumn("a"), 1);
+    ASSERT_EQ(keyGen.getColumn("b"), 2);
+    ASSERT_EQ(keyGen.getColumn("c"), ColumnStoreKeyGenerator::kRowColumn);
+
+    BSONObj key = fromjson("{'': 2, '': 'id', '': {c: 1}}");
+    ASSERT_EQ(ColumnStoreKeyGenerator::extractId(key).str(), "id");
+    ASSERT_BSONOBJ_EQ(ColumnStoreKeyGenerator::extractValue(key).Obj(), fromjson("{c: 1}"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -90,9 +90,6 @@ Status S2GetKeysForElement(const BSONElement& element,
     if (!status.isOK())
         return status;
 
-    S2RegionCoverer coverer;
-    params.configureCoverer(geoContainer, &coverer);
-
     // Don't index big polygon
     if (geoContainer.getNativeCRS() == STRICT_SPHERE) {
         return Status(ErrorCodes::BadValue, "can't index geometry with strict winding order");
@@ -115,6 +112,16 @@ Status S2GetKeysForElement(const BSONElement& element,
 
     invariant(geoContainer.hasS2Region());
 
+    // Since version 3 points are indexed at the leaf level, where their covering is always the
+    // single leaf cell containing them, so there is no need to run the coverer.
+    if (params.indexVersion >= S2_INDEX_VERSION_3 && geoContainer.isPoint()) {
+        out->push_back(geoContainer.getPoint().cell.id());
+        return Status::OK();
+    }
+
+    // Setting up a coverer allocates its candidate queue, so each thread generating keys keeps one.
+    thread_local S2RegionCoverer coverer;
+    params.configureCoverer(geoContainer, &coverer);
     coverer.GetCovering(geoContainer.getS2Region(), out);
     return Status::OK();
 }
@@ -131,8 +138,9 @@ bool getS2GeoKeys(const BSONObj& document,
                   const S2IndexingParams& params,
                   BSONObjSet* out) {
     bool everGeneratedMultipleCells = false;
+    vector<S2CellId> cells;
     for (BSONElementSet::iterator i = elements.begin(); i != elements.end(); ++i) {
-        vector<S2CellId> cells;
+        cells.clear();
         Status status = S2GetKeysForElement(*i, params, &cells);
         uassert(16755,
                 str::stream() << "Can't extract geo keys: " << document << "  " << status.reason(),
@@ -338,34 +346,48 @@ void ExpressionKeysPrivate::getFTSKeys(const BSONObj& obj,
 
 // static
 void ExpressionKeysPrivate::getHashKeys(const BSONObj& obj,
-                                        const string& hashedField,
+                                        const BSONObj& keyPattern,
                                         HashSeed seed,
                                         int hashVersion,
                                         bool isSparse,
                                         const CollatorInterface* collator,
                                         BSONObjSet* keys) {
-    const char* cstr = hashedField.c_str();
-    BSONElement fieldVal = dps::extractElementAtPath(obj, cstr);
-
-    // Convert strings to comparison keys.
-    BSONObj fieldValObj;
-    if (!fieldVal.eoo()) {
-        BSONObjBuilder bob;
-        CollationIndexKey::collationAwareIndexKeyAppend(fieldVal, collator, &bob);
-        fieldValObj = bob.obj();
-        fieldVal = fieldValObj.firstElement();
-    }
+    static const BSONObj nullObj = BSON("" << BSONNULL);
+    bool hasAnyField = false;
+
+    BSONObjBuilder keyBuilder;
+    for (auto&& keyElem : keyPattern) {
+        BSONElement fieldVal = dps::extractElementAtPath(obj, keyElem.fieldName());
+
+        // Convert strings to comparison keys.
+        BSONObj fieldValObj;
+        if (!fieldVal.eoo()) {
+            BSONObjBuilder bob;
+            CollationIndexKey::collationAwareIndexKeyAppend(fieldVal, collator, &bob);
+            fieldValObj = bob.obj();
+            fieldVal = fieldValObj.firstElement();
+            hasAnyField = true;
+        }
 
-    uassert(16766,
-            "Error: hashed indexes do not currently support array values",
-            fieldVal.type() != Array);
+        uassert(16766,
+                "Error: hashed indexes do not currently support array values",
+                fieldVal.type() != Array);
+
+        // Explicit null values and missing fields are indexed identically.
+        if (fieldVal.eoo()) {
+            fieldVal = nullObj.firstElement();
+        }
+
+        if (keyElem.type() == String && keyElem.valueStringData() == IndexNames::HASHED) {
+            keyBuilder.append("", makeSingleHashKey(fieldVal, seed, hashVersion));
+        } else {
+            keyBuilder.appendAs(fieldVal, "");
+        }
+    }
 
-    if (!fieldVal.eoo()) {
-        BSONObj key = BSON("" << makeSingleHashKey(fieldVal, seed, hashVersion));
-        keys->insert(key);
-    } else if (!isSparse) {
-        BSONObj nullObj = BSON("" << BSONNULL);
-        keys->insert(BSON("" << makeSingleHashKey(nullObj.firstElement(), seed, hashVersion)));
+    // A sparse hashed index only omits documents which have none of its fields.
+    if (hasAnyField || !isSparse) {
+        keys->insert(keyBuilder.obj());
     }
 }
 
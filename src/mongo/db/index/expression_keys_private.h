@@ -71,10 +71,12 @@ public:
     //
 
     /**
-     * Generates keys for hash access method.
+     * Generates keys for hash access method. The key pattern holds exactly one hashed field, which
+     * may be compounded with ascending or descending fields. Each key holds the hash of the hashed
+     * field's value and the values of the other fields, in key pattern order.
      */
     static void getHashKeys(const BSONObj& obj,
-                            const std::string& hashedField,
+                            const BSONObj& keyPattern,
                             HashSeed seed,
                             int hashVersion,
                             bool isSparse,
@@ -28,6 +28,8 @@
 
 #include "mongo/db/index/expression_params.h"
 
+#include <algorithm>
+
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/hasher.h"
@@ -70,8 +72,7 @@ void ExpressionParams::parseTwoDParams(const BSONObj& infoObj, TwoDIndexingParam
 
 void ExpressionParams::parseHashParams(const BSONObj& infoObj,
                                        HashSeed* seedOut,
-                                       int* versionOut,
-                                       std::string* fieldOut) {
+                                       int* versionOut) {
     // Default _seed to DEFAULT_HASH_SEED if "seed" is not included in the index spec
     // or if the value of "seed" is not a number
 
@@ -90,10 +91,13 @@ void ExpressionParams::parseHashParams(const BSONObj& infoObj,
     // the value of "hashversion" is not a number
     *versionOut = infoObj["hashVersion"].numberInt();
 
-    // Get the hashfield name
-    BSONElement firstElt = infoObj.getObjectField("key").firstElement();
-    massert(16765, "error: no hashed index field", firstElt.str().compare(IndexNames::HASHED) == 0);
-    *fieldOut = firstElt.fieldName();
+    // The hashed field may be compounded with ascending or descending fields in any position.
+    const BSONObj keyPattern = infoObj.getObjectField("key");
+    massert(16765,
+            "error: no hashed index field",
+            std::any_of(keyPattern.begin(), keyPattern.end(), [](const BSONElement& elt) {
+                return elt.type() == String && elt.valueStringData() == IndexNames::HASHED;
+            }));
 }
 
 void ExpressionParams::parseHaystackParams(const BSONObj& infoObj,
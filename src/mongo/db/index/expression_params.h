@@ -44,10 +44,7 @@ namespace ExpressionParams {
 
 void parseTwoDParams(const BSONObj& infoObj, TwoDIndexingParams* out);
 
-void parseHashParams(const BSONObj& infoObj,
-                     HashSeed* seedOut,
-                     int* versionOut,
-                     std::string* fieldOut);
+void parseHashParams(const BSONObj& infoObj, HashSeed* seedOut, int* versionOut);
 
 void parseHaystackParams(const BSONObj& infoObj,
                          std::string* geoFieldOut,
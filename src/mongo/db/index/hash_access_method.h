@@ -41,7 +41,8 @@ namespace mongo {
 class CollatorInterface;
 
 /**
- * This is the access method for "hashed" indices.
+ * This is the access method for "hashed" indices. A hashed index has exactly one hashed field,
+ * which may be compounded with ascending or descending fields.
  */
 class HashAccessMethod : public AbstractIndexAccessMethod {
 public:
@@ -59,9 +60,6 @@ private:
                    BSONObjSet* multikeyMetadataKeys,
                    MultikeyPaths* multikeyPaths) const final;
 
-    // Only one of our fields is hashed.  This is the field name for it.
-    std::string _hashedField;
-
     // _seed defaults to zero.
     HashSeed _seed;
 
@@ -48,6 +48,8 @@ namespace {
 
 const HashSeed kHashSeed = 0;
 const int kHashVersion = 0;
+const BSONObj kKeyPattern = BSON("a"
+                                 << "hashed");
 
 std::string dumpKeyset(const BSONObjSet& objs) {
     std::stringstream ss;
@@ -88,7 +90,7 @@ TEST(HashKeyGeneratorTest, CollationAppliedBeforeHashing) {
     BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     ExpressionKeysPrivate::getHashKeys(
-        obj, "a", kHashSeed, kHashVersion, false, &collator, &actualKeys);
+        obj, kKeyPattern, kHashSeed, kHashVersion, false, &collator, &actualKeys);
 
     BSONObj backwardsObj = fromjson("{a: 'gnirts'}");
     BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
@@ -102,7 +104,7 @@ TEST(HashKeyGeneratorTest, CollationDoesNotAffectNonStringFields) {
     BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     ExpressionKeysPrivate::getHashKeys(
-        obj, "a", kHashSeed, kHashVersion, false, &collator, &actualKeys);
+        obj, kKeyPattern, kHashSeed, kHashVersion, false, &collator, &actualKeys);
 
     BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     expectedKeys.insert(makeHashKey(obj["a"]));
@@ -116,7 +118,7 @@ TEST(HashKeyGeneratorTest, CollatorAppliedBeforeHashingNestedObject) {
     BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     ExpressionKeysPrivate::getHashKeys(
-        obj, "a", kHashSeed, kHashVersion, false, &collator, &actualKeys);
+        obj, kKeyPattern, kHashSeed, kHashVersion, false, &collator, &actualKeys);
 
     BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     expectedKeys.insert(makeHashKey(backwardsObj["a"]));
@@ -128,7 +130,7 @@ TEST(HashKeyGeneratorTest, NoCollation) {
     BSONObj obj = fromjson("{a: 'string'}");
     BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     ExpressionKeysPrivate::getHashKeys(
-        obj, "a", kHashSeed, kHashVersion, false, nullptr, &actualKeys);
+        obj, kKeyPattern, kHashSeed, kHashVersion, false, nullptr, &actualKeys);
 
     BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     expectedKeys.insert(makeHashKey(obj["a"]));
@@ -136,4 +138,64 @@ TEST(HashKeyGeneratorTest, NoCollation) {
     ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
 }
 
+TEST(HashKeyGeneratorTest, CompoundKeyHoldsHashOfHashedFieldOnly) {
+    BSONObj keyPattern = fromjson("{a: 1, 'b.c': 'hashed', d: -1}");
+    BSONObj obj = fromjson("{a: 'x', b: {c: 5}, d: {e: 1}}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ExpressionKeysPrivate::getHashKeys(
+        obj, keyPattern, kHashSeed, kHashVersion, false, nullptr, &actualKeys);
+
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(BSON(""
+                             << "x"
+                             << ""
+                             << BSONElementHasher::hash64(obj["b"]["c"], kHashSeed)
+                             << ""
+                             << BSON("e" << 1)));
+
+    ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
+}
+
+TEST(HashKeyGeneratorTest, CompoundKeyIndexesMissingFieldsAsNull) {
+    BSONObj keyPattern = fromjson("{a: 'hashed', b: 1}");
+    BSONObj obj = fromjson("{c: 1}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ExpressionKeysPrivate::getHashKeys(
+        obj, keyPattern, kHashSeed, kHashVersion, false, nullptr, &actualKeys);
+
+    BSONObj nullObj = BSON("" << BSONNULL);
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(
+        BSON("" << BSONElementHasher::hash64(nullObj.firstElement(), kHashSeed) << ""
+                << BSONNULL));
+
+    ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
+}
+
+TEST(HashKeyGeneratorTest, SparseCompoundKeyOmitsDocumentsMissingEveryField) {
+    BSONObj keyPattern = fromjson("{a: 'hashed', b: 1}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ExpressionKeysPrivate::getHashKeys(
+        fromjson("{c: 1}"), keyPattern, kHashSeed, kHashVersion, true, nullptr, &actualKeys);
+    ASSERT(actualKeys.empty());
+
+    ExpressionKeysPrivate::getHashKeys(
+        fromjson("{b: 1}"), keyPattern, kHashSeed, kHashVersion, true, nullptr, &actualKeys);
+    ASSERT_EQ(actualKeys.size(), 1U);
+}
+
+TEST(HashKeyGeneratorTest, CompoundKeyFailsOnArrayInAnyField) {
+    BSONObj keyPattern = fromjson("{a: 'hashed', b: 1}");
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    ASSERT_THROWS_CODE(ExpressionKeysPrivate::getHashKeys(fromjson("{a: 1, b: [1, 2]}"),
+                                                          keyPattern,
+                                                          kHashSeed,
+                                                          kHashVersion,
+                                                          false,
+                                                          nullptr,
+                                                          &actualKeys),
+                       AssertionException,
+                       16766);
+}
+
 }  // namespace
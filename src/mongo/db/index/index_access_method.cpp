@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -51,6 +52,8 @@
 #include "mongo/db/repl/timestamp_block.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
@@ -103,6 +106,17 @@ Status checkKeySize(const BSONObj& key) {
 // TODO SERVER-36386: Remove the server parameter
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
 
+// The number of threads each bulk index build uses to generate and sort keys. With a single
+// thread, keys are generated by the thread scanning the collection.
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildKeyGenerationThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "maxIndexBuildKeyGenerationThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
 // TODO SERVER-36386: Remove the server parameter
 bool failIndexKeyTooLongParam() {
     // Always return true in FCV 4.2 although FCV 4.2 actually never needs to
@@ -220,6 +234,85 @@ Status AbstractIndexAccessMethod::insert(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status AbstractIndexAccessMethod::insertRecords(OperationContext* opCtx,
+                                                const std::vector<BsonRecord>& bsonRecords,
+                                                const InsertDeleteOptions& options,
+                                                int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+
+    struct KeyToInsert {
+        BSONObj key;
+        RecordId loc;
+        Timestamp ts;
+    };
+    std::vector<KeyToInsert> keys;
+    std::vector<std::pair<Timestamp, MultikeyPaths>> multikeyUpdates;
+    for (auto&& bsonRecord : bsonRecords) {
+        BSONObjSet docKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        getKeys(*bsonRecord.docPtr,
+                options.getKeysMode,
+                &docKeys,
+                &multikeyMetadataKeys,
+                &multikeyPaths);
+
+        // As in insert(), multikey metadata keys point to the reserved 'kMultikeyMetadataKeyId'.
+        for (auto&& key : docKeys) {
+            keys.push_back({key, bsonRecord.id, bsonRecord.ts});
+        }
+        for (auto&& key : multikeyMetadataKeys) {
+            keys.push_back({key, kMultikeyMetadataKeyId, bsonRecord.ts});
+        }
+        if (shouldMarkIndexAsMultikey(docKeys, multikeyMetadataKeys, multikeyPaths)) {
+            multikeyUpdates.emplace_back(bsonRecord.ts, std::move(multikeyPaths));
+        }
+    }
+
+    const Ordering& ordering = _btreeState->ordering();
+    std::stable_sort(
+        keys.begin(), keys.end(), [&ordering](const KeyToInsert& lhs, const KeyToInsert& rhs) {
+            const int cmp = lhs.key.woCompare(rhs.key, ordering, false);
+            return cmp < 0 || (cmp == 0 && lhs.loc < rhs.loc);
+        });
+
+    bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+    for (auto&& key : keys) {
+        if (!key.ts.isNull()) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(key.ts);
+            if (!status.isOK())
+                return status;
+        }
+
+        Status status = checkIndexKeySize ? checkKeySize(key.key) : Status::OK();
+        if (status.isOK()) {
+            StatusWith<SpecialFormatInserted> ret =
+                _newInterface->insert(opCtx, key.key, key.loc, options.dupsAllowed);
+            status = ret.getStatus();
+            if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
+                _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
+        }
+        if (isFatalError(opCtx, status, key.key)) {
+            return status;
+        }
+    }
+
+    *numInserted = keys.size();
+
+    // The index must be multikey as of the first document which made it so.
+    for (auto&& multikeyUpdate : multikeyUpdates) {
+        if (!multikeyUpdate.first.isNull()) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(multikeyUpdate.first);
+            if (!status.isOK())
+                return status;
+        }
+        _btreeState->setMultikey(opCtx, multikeyUpdate.second);
+    }
+
+    return Status::OK();
+}
+
 void AbstractIndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                              const BSONObj& key,
                                              const RecordId& loc,
@@ -274,6 +367,45 @@ Status AbstractIndexAccessMethod::remove(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status AbstractIndexAccessMethod::removeRecords(OperationContext* opCtx,
+                                                const std::vector<BsonRecord>& bsonRecords,
+                                                const InsertDeleteOptions& options,
+                                                int64_t* numDeleted) {
+    invariant(numDeleted);
+    *numDeleted = 0;
+
+    std::vector<std::pair<BSONObj, RecordId>> keys;
+    for (auto&& bsonRecord : bsonRecords) {
+        BSONObjSet docKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        // As in remove(), neither multikey metadata nor constraints matter when removing keys.
+        getKeys(*bsonRecord.docPtr,
+                GetKeysMode::kRelaxConstraintsUnfiltered,
+                &docKeys,
+                nullptr,
+                nullptr);
+        for (auto&& key : docKeys) {
+            keys.emplace_back(key, bsonRecord.id);
+        }
+    }
+
+    const Ordering& ordering = _btreeState->ordering();
+    std::sort(keys.begin(),
+              keys.end(),
+              [&ordering](const std::pair<BSONObj, RecordId>& lhs,
+                          const std::pair<BSONObj, RecordId>& rhs) {
+                  const int cmp = lhs.first.woCompare(rhs.first, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.second < rhs.second);
+              });
+
+    for (auto&& key : keys) {
+        removeOneKey(opCtx, key.first, key.second, options.dupsAllowed);
+    }
+
+    *numDeleted = keys.size();
+
+    return Status::OK();
+}
+
 Status AbstractIndexAccessMethod::initializeAsEmpty(OperationContext* opCtx) {
     return _newInterface->initAsEmpty(opCtx);
 }
@@ -476,8 +608,9 @@ Status AbstractIndexAccessMethod::update(OperationContext* opCtx,
     return Status::OK();
 }
 
-Status AbstractIndexAccessMethod::compact(OperationContext* opCtx) {
-    return this->_newInterface->compact(opCtx);
+Status AbstractIndexAccessMethod::compact(OperationContext* opCtx,
+                                          const CompactOptions* options) {
+    return this->_newInterface->compact(opCtx, options);
 }
 
 std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initiateBulk(
@@ -485,54 +618,194 @@ std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initi
     return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor, maxMemoryUsageBytes));
 }
 
+namespace {
+
+// The number of documents handed to the key generation threads at a time.
+const size_t kKeyGenerationBatchSize = 1024;
+
+void mergeMultikeyPaths(MultikeyPaths* dest, const MultikeyPaths& src) {
+    if (src.empty()) {
+        return;
+    }
+    if (dest->empty()) {
+        *dest = src;
+        return;
+    }
+    invariant(dest->size() == src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+        (*dest)[i].insert(src[i].begin(), src[i].end());
+    }
+}
+
+}  // namespace
+
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
                                             const IndexDescriptor* descriptor,
                                             size_t maxMemoryUsageBytes)
-    : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+    : _real(index),
+      _descriptor(descriptor),
+      _sortOptions(SortOptions()
+                       .TempDir(storageGlobalParams.dbpath + "/_tmp")
+                       .ExtSortAllowed()
+                       .PrefixCompressKeys()
+                       .BackgroundSpills()) {
+    const size_t numPartitions = maxIndexBuildKeyGenerationThreads.load();
+
+    // Each partition sorts its keys separately, so they split the memory budget between them.
+    _partitions.resize(numPartitions);
+    for (auto& partition : _partitions) {
+        partition.sorter.reset(Sorter::make(
+            SortOptions(_sortOptions).MaxMemoryUsageBytes(maxMemoryUsageBytes / numPartitions),
+            BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version())));
+    }
 
-Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
+    if (numPartitions > 1) {
+        ThreadPool::Options options;
+        options.poolName = "IndexBuildKeyGeneration";
+        options.minThreads = 0;
+        options.maxThreads = numPartitions;
+        _workers = stdx::make_unique<ThreadPool>(options);
+        _workers->startup();
+        _pendingDocuments.reserve(kKeyGenerationBatchSize);
+        _inFlightDocuments.reserve(kKeyGenerationBatchSize);
+    }
+}
+
+IndexAccessMethod::BulkBuilder::~BulkBuilder() {
+    // The workers refer to this BulkBuilder's members, so they must be gone before any of them.
+    if (_workers) {
+        _workers->shutdown();
+        _workers->join();
+    }
+}
+
+void IndexAccessMethod::BulkBuilder::_addKeys(Partition* partition,
                                               const BSONObj& obj,
                                               const RecordId& loc,
-                                              const InsertDeleteOptions& options) {
+                                              const InsertDeleteOptions& options) const {
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
 
-    _real->getKeys(obj, options.getKeysMode, &keys, &_multikeyMetadataKeys, &multikeyPaths);
+    _real->getKeys(
+        obj, options.getKeysMode, &keys, &partition->multikeyMetadataKeys, &multikeyPaths);
 
-    if (!multikeyPaths.empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = multikeyPaths;
-        } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
-            for (size_t i = 0; i < multikeyPaths.size(); ++i) {
-                _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
-            }
-        }
-    }
+    mergeMultikeyPaths(&partition->indexMultikeyPaths, multikeyPaths);
 
     for (const auto& key : keys) {
-        _sorter->add(key, loc);
-        ++_keysInserted;
+        partition->sorter->add(key, loc);
+        ++partition->keysInserted;
     }
 
-    _isMultiKey =
-        _isMultiKey || _real->shouldMarkIndexAsMultikey(keys, _multikeyMetadataKeys, multikeyPaths);
+    partition->isMultiKey = partition->isMultiKey ||
+        _real->shouldMarkIndexAsMultikey(keys, partition->multikeyMetadataKeys, multikeyPaths);
+}
+
+Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
+                                              const BSONObj& obj,
+                                              const RecordId& loc,
+                                              const InsertDeleteOptions& options) {
+    if (!_workers) {
+        _addKeys(&_partitions.front(), obj, loc, options);
+        return Status::OK();
+    }
+
+    // The options are the same for all documents of an index build.
+    if (!_options) {
+        _options = stdx::make_unique<InsertDeleteOptions>(options);
+    }
 
+    _pendingDocuments.emplace_back(obj.getOwned(), loc);
+    if (_pendingDocuments.size() < kKeyGenerationBatchSize) {
+        return Status::OK();
+    }
+    return _dispatchPendingDocuments();
+}
+
+Status IndexAccessMethod::BulkBuilder::_dispatchPendingDocuments() {
+    // Only one batch is processed at a time, which lets the caller scan the next one meanwhile.
+    Status status = _waitForWorkers();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    _inFlightDocuments.swap(_pendingDocuments);
+    _pendingDocuments.clear();
+
+    // Give each partition a contiguous slice of the batch.
+    const size_t numDocs = _inFlightDocuments.size();
+    const size_t numPartitions = _partitions.size();
+    for (size_t i = 0; i < numPartitions; i++) {
+        Partition* partition = &_partitions[i];
+        const size_t begin = numDocs * i / numPartitions;
+        const size_t end = numDocs * (i + 1) / numPartitions;
+        status = _workers->schedule([this, partition, begin, end] {
+            try {
+                for (size_t j = begin; j < end; j++) {
+                    _addKeys(partition,
+                             _inFlightDocuments[j].first,
+                             _inFlightDocuments[j].second,
+                             *_options);
+                }
+            } catch (...) {
+                partition->status = exceptionToStatus();
+            }
+        });
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
+Status IndexAccessMethod::BulkBuilder::_waitForWorkers() {
+    _workers->waitForIdle();
+    for (const auto& partition : _partitions) {
+        if (!partition.status.isOK()) {
+            return partition.status;
+        }
+    }
     return Status::OK();
 }
 
 IndexAccessMethod::BulkBuilder::Sorter::Iterator* IndexAccessMethod::BulkBuilder::done() {
-    for (const auto& key : _multikeyMetadataKeys) {
-        _sorter->add(key, kMultikeyMetadataKeyId);
+    if (_workers) {
+        if (!_pendingDocuments.empty()) {
+            uassertStatusOK(_dispatchPendingDocuments());
+        }
+        uassertStatusOK(_waitForWorkers());
+        _workers->shutdown();
+        _workers->join();
+        _workers.reset();
+    }
+
+    // Partitions may have generated the same multikey metadata keys, so only add each one once.
+    BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    for (auto& partition : _partitions) {
+        _keysInserted += partition.keysInserted;
+        _isMultiKey = _isMultiKey || partition.isMultiKey;
+        mergeMultikeyPaths(&_indexMultikeyPaths, partition.indexMultikeyPaths);
+        multikeyMetadataKeys.insert(partition.multikeyMetadataKeys.begin(),
+                                    partition.multikeyMetadataKeys.end());
+    }
+
+    Sorter* sorter = _partitions.front().sorter.get();
+    for (const auto& key : multikeyMetadataKeys) {
+        sorter->add(key, kMultikeyMetadataKeyId);
         ++_keysInserted;
     }
-    return _sorter->done();
+
+    if (_partitions.size() == 1) {
+        return sorter->done();
+    }
+
+    std::vector<std::shared_ptr<Sorter::Iterator>> iterators;
+    for (auto& partition : _partitions) {
+        iterators.emplace_back(partition.sorter->done());
+    }
+    return Sorter::Iterator::merge(
+        iterators,
+        _sortOptions,
+        BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version()));
 }
 
 Status AbstractIndexAccessMethod::commitBulk(OperationContext* opCtx,
@@ -654,7 +927,9 @@ void AbstractIndexAccessMethod::getKeys(const BSONObj& obj,
                                               13067,
                                               13068,
                                               13026,
-                                              13027};
+                                              13027,
+                                              // Columnstore
+                                              51012};
     try {
         doGetKeys(obj, keys, multikeyMetadataKeys, multikeyPaths);
     } catch (const AssertionException& ex) {
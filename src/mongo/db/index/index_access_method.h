@@ -31,6 +31,8 @@
 #include <atomic>
 #include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
@@ -45,7 +47,10 @@
 namespace mongo {
 
 class BSONObjBuilder;
+struct BsonRecord;
+struct CompactOptions;
 class MatchExpression;
+class ThreadPool;
 class UpdateTicket;
 struct InsertDeleteOptions;
 
@@ -86,6 +91,18 @@ public:
                           const InsertDeleteOptions& options,
                           int64_t* numInserted) = 0;
 
+    /**
+     * Analogous to insert(), but for every document in 'bsonRecords', which must already be in the
+     * record store. The keys of all the documents are generated first and then inserted in index
+     * order, so the batch is merged into the index in one pass rather than one document at a time.
+     * Each key is written at the timestamp of its document, when that is set.
+     * 'numInserted' will be set to the number of keys added to the index for all documents.
+     */
+    virtual Status insertRecords(OperationContext* opCtx,
+                                 const std::vector<BsonRecord>& bsonRecords,
+                                 const InsertDeleteOptions& options,
+                                 int64_t* numInserted) = 0;
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -96,6 +113,17 @@ public:
                           const InsertDeleteOptions& options,
                           int64_t* numDeleted) = 0;
 
+    /**
+     * Analogous to remove(), but for every document in 'bsonRecords'. The keys of all the
+     * documents are removed in index order, so each part of the index is visited once for the
+     * whole batch rather than once per document.
+     * 'numDeleted' will be set to the number of keys removed from the index for all documents.
+     */
+    virtual Status removeRecords(OperationContext* opCtx,
+                                 const std::vector<BsonRecord>& bsonRecords,
+                                 const InsertDeleteOptions& options,
+                                 int64_t* numDeleted) = 0;
+
     /**
      * Checks whether the index entries for the document 'from', which is placed at location
      * 'loc' on disk, can be changed to the index entries for the doc 'to'. Provides a ticket
@@ -192,7 +220,7 @@ public:
      * Attempt compaction to regain disk space if the indexed record store supports
      * compaction-in-place.
      */
-    virtual Status compact(OperationContext* opCtx) = 0;
+    virtual Status compact(OperationContext* opCtx, const CompactOptions* options) = 0;
 
     /**
      * Sets this index as multikey with the provided paths.
@@ -207,18 +235,29 @@ public:
     public:
         using Sorter = mongo::Sorter<BSONObj, RecordId>;
 
+        ~BulkBuilder();
+
         /**
          * Insert into the BulkBuilder as-if inserting into an IndexAccessMethod.
+         *
+         * If the BulkBuilder has key generation threads, the document is copied and its keys are
+         * generated later, so errors may be returned by a later call or thrown by done().
          */
         Status insert(OperationContext* opCtx,
                       const BSONObj& obj,
                       const RecordId& loc,
                       const InsertDeleteOptions& options);
 
+        /**
+         * Only valid once done() has been called.
+         */
         const MultikeyPaths& getMultikeyPaths() const {
             return _indexMultikeyPaths;
         }
 
+        /**
+         * Only valid once done() has been called.
+         */
         bool isMultikey() const {
             return _isMultiKey;
         }
@@ -232,25 +271,72 @@ public:
     private:
         friend class AbstractIndexAccessMethod;
 
+        /**
+         * The keys generated from a subset of the documents added to the BulkBuilder, along with
+         * the multikey information of those documents. There is one partition per key generation
+         * thread, each of which sorts and spills its keys independently of the others.
+         */
+        struct Partition {
+            std::unique_ptr<Sorter> sorter;
+            int64_t keysInserted = 0;
+
+            // Set to true if any document added to the partition causes the index to become
+            // multikey.
+            bool isMultiKey = false;
+
+            // Holds the path components that cause this index to be multikey. The
+            // 'indexMultikeyPaths' vector remains empty if this index doesn't support path-level
+            // multikey tracking.
+            MultikeyPaths indexMultikeyPaths;
+
+            // Caches the set of all multikey metadata keys generated during the bulk build process.
+            // These are inserted into the sorter after all normal data keys have been added, just
+            // before the bulk build is committed.
+            BSONObjSet multikeyMetadataKeys{SimpleBSONObjComparator::kInstance.makeBSONObjSet()};
+
+            // The first error hit while generating keys for this partition on a worker thread.
+            Status status = Status::OK();
+        };
+
         BulkBuilder(const IndexAccessMethod* index,
                     const IndexDescriptor* descriptor,
                     size_t maxMemoryUsageBytes);
 
-        std::unique_ptr<Sorter> _sorter;
+        /**
+         * Generates the keys for 'obj' and adds them to 'partition'.
+         */
+        void _addKeys(Partition* partition,
+                      const BSONObj& obj,
+                      const RecordId& loc,
+                      const InsertDeleteOptions& options) const;
+
+        /**
+         * Waits for the batch being processed by the key generation threads, if any, then hands
+         * them the pending batch. Returns the first error hit while processing a previous batch.
+         */
+        Status _dispatchPendingDocuments();
+
+        /**
+         * Waits for the key generation threads to become idle and returns the first error they hit.
+         */
+        Status _waitForWorkers();
+
         const IndexAccessMethod* _real;
-        int64_t _keysInserted = 0;
+        const IndexDescriptor* _descriptor;
+        const SortOptions _sortOptions;
+        std::vector<Partition> _partitions;
 
-        // Set to true if any document added to the BulkBuilder causes the index to become multikey.
+        // The totals across all partitions, only set by done().
+        int64_t _keysInserted = 0;
         bool _isMultiKey = false;
-
-        // Holds the path components that cause this index to be multikey. The '_indexMultikeyPaths'
-        // vector remains empty if this index doesn't support path-level multikey tracking.
         MultikeyPaths _indexMultikeyPaths;
 
-        // Caches the set of all multikey metadata keys generated during the bulk build process.
-        // These are inserted into the sorter after all normal data keys have been added, just
-        // before the bulk build is committed.
-        BSONObjSet _multikeyMetadataKeys{SimpleBSONObjComparator::kInstance.makeBSONObjSet()};
+        // Only used when generating keys on worker threads. Documents are accumulated in
+        // '_pendingDocuments' while the workers process '_inFlightDocuments'.
+        std::unique_ptr<ThreadPool> _workers;
+        std::vector<std::pair<BSONObj, RecordId>> _pendingDocuments;
+        std::vector<std::pair<BSONObj, RecordId>> _inFlightDocuments;
+        std::unique_ptr<InsertDeleteOptions> _options;
     };
 
     /**
@@ -419,12 +505,22 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted) final;
 
+    Status insertRecords(OperationContext* opCtx,
+                         const std::vector<BsonRecord>& bsonRecords,
+                         const InsertDeleteOptions& options,
+                         int64_t* numInserted) final;
+
     Status remove(OperationContext* opCtx,
                   const BSONObj& obj,
                   const RecordId& loc,
                   const InsertDeleteOptions& options,
                   int64_t* numDeleted) final;
 
+    Status removeRecords(OperationContext* opCtx,
+                         const std::vector<BsonRecord>& bsonRecords,
+                         const InsertDeleteOptions& options,
+                         int64_t* numDeleted) final;
+
     Status validateUpdate(OperationContext* opCtx,
                           const BSONObj& from,
                           const BSONObj& to,
@@ -458,7 +554,7 @@ public:
 
     RecordId findSingle(OperationContext* opCtx, const BSONObj& key) const final;
 
-    Status compact(OperationContext* opCtx) final;
+    Status compact(OperationContext* opCtx, const CompactOptions* options) final;
 
     void setIndexIsMultikey(OperationContext* opCtx, MultikeyPaths paths) final;
 
@@ -529,7 +625,7 @@ private:
     /**
      * Removes a single key from the index.
      *
-     * Used by remove() only.
+     * Used by remove() and removeRecords() only.
      */
     void removeOneKey(OperationContext* opCtx,
                       const BSONObj& key,
@@ -43,6 +43,9 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "third_party/s2/s2cell.h"
+#include "third_party/s2/s2latlng.h"
+#include "third_party/s2/s2regioncoverer.h"
 
 using namespace mongo;
 
@@ -183,6 +186,41 @@ TEST(S2KeyGeneratorTest, GetS2KeysFromArrayOfNonGeoSubobjectsWithArrayValues) {
     assertMultikeyPathsEqual(MultikeyPaths{{0U, 1U}, std::set<size_t>{}}, actualMultikeyPaths);
 }
 
+TEST(S2KeyGeneratorTest, PointKeyIsTheLeafCellCoveringThePoint) {
+    S2RegionCoverer coverer;
+    coverer.set_min_level(S2::kMaxCellLevel);
+    coverer.set_max_level(S2::kMaxCellLevel);
+
+    const std::vector<std::pair<int, int>> points{
+        {0, 0}, {1, 1}, {-73, 40}, {139, 35}, {-180, -90}, {180, 90}, {0, 90}, {45, -45}};
+    for (const auto& point : points) {
+        const S2Point s2Point = S2LatLng::FromDegrees(point.second, point.first).ToPoint();
+        std::vector<S2CellId> covering;
+        coverer.GetCovering(S2Cell(s2Point), &covering);
+        ASSERT_EQUALS(1U, covering.size());
+        ASSERT_EQUALS(static_cast<long long>(covering[0].id()),
+                      getCellID(point.first, point.second));
+    }
+}
+
+TEST(S2KeyGeneratorTest, LegacyPointHasSameKeyAsGeoJSONPoint) {
+    BSONObj keyPattern = fromjson("{a: '2dsphere'}");
+    BSONObj infoObj = fromjson("{key: {a: '2dsphere'}, '2dsphereIndexVersion': 3}");
+    S2IndexingParams params;
+    const CollatorInterface* collator = nullptr;
+    ExpressionParams::initialize2dsphereParams(infoObj, collator, &params);
+
+    BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths* multikeyPaths = nullptr;
+    ExpressionKeysPrivate::getS2Keys(
+        fromjson("{a: [-73, 40]}"), keyPattern, params, &actualKeys, multikeyPaths);
+
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(BSON("" << getCellID(-73, 40)));
+
+    ASSERT_TRUE(assertKeysetsEqual(expectedKeys, actualKeys));
+}
+
 TEST(S2KeyGeneratorTest, GetS2KeysFromMultiPointInGeoField) {
     BSONObj keyPattern = fromjson("{nongeo: 1, geo: '2dsphere'}");
     BSONObj genKeysFrom =
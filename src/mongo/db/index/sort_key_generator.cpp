@@ -35,7 +35,7 @@
 namespace mongo {
 
 SortKeyGenerator::SortKeyGenerator(const BSONObj& sortSpec, const CollatorInterface* collator)
-    : _collator(collator) {
+    : _collator(CachingCollator::make(collator)) {
     BSONObjBuilder btreeBob;
 
     for (auto&& elt : sortSpec) {
@@ -78,7 +78,8 @@ SortKeyGenerator::SortKeyGenerator(const BSONObj& sortSpec, const CollatorInterf
     }
 
     constexpr bool isSparse = false;
-    _indexKeyGen = stdx::make_unique<BtreeKeyGenerator>(fieldNames, fixed, isSparse, _collator);
+    _indexKeyGen =
+        stdx::make_unique<BtreeKeyGenerator>(fieldNames, fixed, isSparse, _collator.get());
 }
 
 StatusWith<BSONObj> SortKeyGenerator::getSortKey(const BSONObj& obj,
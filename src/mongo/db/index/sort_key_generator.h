@@ -31,6 +31,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/index/btree_key_generator.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/collation/caching_collator.h"
 #include "mongo/db/query/collation/collator_interface.h"
 
 namespace mongo {
@@ -82,7 +83,9 @@ private:
 
     StatusWith<BSONObj> getIndexKey(const BSONObj& obj) const;
 
-    const CollatorInterface* _collator = nullptr;
+    // A CachingCollator over the collation of the sort, or null for the simple collation. Sorts
+    // often see the same strings many times, and each string's comparison key is costly.
+    std::unique_ptr<CollatorInterface> _collator;
 
     // The sort pattern with any $meta sort components stripped out, since the underlying index key
     // generator does not understand $meta sort.
@@ -55,14 +55,14 @@ void WildcardAccessMethod::doGetKeys(const BSONObj& obj,
 
 std::set<FieldRef> WildcardAccessMethod::getMultikeyPathSet(OperationContext* opCtx) const {
     auto cursor = newCursor(opCtx);
-    // All of the keys storing multikeyness metadata are prefixed by a value of 1. Establish an
-    // index cursor which will scan this range.
-    const BSONObj metadataKeyRangeBegin = BSON("" << 1 << "" << MINKEY);
-    const BSONObj metadataKeyRangeEnd = BSON("" << 1 << "" << MAXKEY);
+    // All of the keys storing multikeyness metadata are prefixed by a value of 1, preceded by a
+    // MinKey for each regular field of a compound key pattern. Establish an index cursor which will
+    // scan this range.
+    const auto metadataKeyRange = _keyGen.getMultikeyMetadataKeyRange();
 
     constexpr bool inclusive = true;
-    cursor->setEndPosition(metadataKeyRangeEnd, inclusive);
-    auto entry = cursor->seek(metadataKeyRangeBegin, inclusive);
+    cursor->setEndPosition(metadataKeyRange.second, inclusive);
+    auto entry = cursor->seek(metadataKeyRange.first, inclusive);
 
     // Iterate the cursor, copying the multikey paths into an in-memory set.
     std::set<FieldRef> multikeyPaths{};
@@ -72,19 +72,8 @@ std::set<FieldRef> WildcardAccessMethod::getMultikeyPathSet(OperationContext* op
         invariant(entry->loc.repr() ==
                   static_cast<int64_t>(RecordId::ReservedId::kWildcardMultikeyMetadataId));
 
-        // Validate that the first piece of the key is the integer 1.
-        BSONObjIterator iter(entry->key);
-        invariant(iter.more());
-        const auto firstElem = iter.next();
-        invariant(firstElem.isNumber());
-        invariant(firstElem.numberInt() == 1);
-        invariant(iter.more());
-
-        // Extract the path from the second piece of the key.
-        const auto secondElem = iter.next();
-        invariant(!iter.more());
-        invariant(secondElem.type() == BSONType::String);
-        multikeyPaths.emplace(secondElem.valueStringData());
+        // Extract the path from the key, validating that it is preceded by the integer 1.
+        multikeyPaths.emplace(_keyGen.extractMultikeyPath(entry->key));
 
         entry = cursor->next();
     }
@@ -36,7 +36,8 @@ namespace mongo {
 
 /**
  * Class which is responsible for generating and providing access to Wildcard index keys. Any index
- * created with { "$**": ±1 } or { "path.$**": ±1 } uses this class.
+ * created with { "$**": ±1 } or { "path.$**": ±1 }, optionally compounded with regular fields,
+ * uses this class.
  *
  * $** indexes store a special metadata key for each path in the index that is multikey. This class
  * provides an interface to access the multikey metadata: see getMultikeyPathSet().
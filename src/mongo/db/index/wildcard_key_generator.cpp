@@ -30,8 +30,11 @@
 
 #include "mongo/db/index/wildcard_key_generator.h"
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 namespace {
@@ -63,12 +66,11 @@ constexpr StringData WildcardKeyGenerator::kSubtreeSuffix;
 
 std::unique_ptr<ProjectionExecAgg> WildcardKeyGenerator::createProjectionExec(
     BSONObj keyPattern, BSONObj pathProjection) {
-    // We should never have a key pattern that contains more than a single element.
-    invariant(keyPattern.nFields() == 1);
-
-    // The _keyPattern is either { "$**": ±1 } for all paths or { "path.$**": ±1 } for a single
-    // subtree. If we are indexing a single subtree, then we will project just that path.
-    auto indexRoot = keyPattern.firstElement().fieldNameStringData();
+    // The wildcard component of the _keyPattern is either { "$**": ±1 } for all paths or
+    // { "path.$**": ±1 } for a single subtree. If we are indexing a single subtree, then we will
+    // project just that path. Any regular fields of a compound key pattern are indexed separately.
+    auto wildcardElem = keyPattern[getWildcardFieldPos(keyPattern)];
+    auto indexRoot = wildcardElem.fieldNameStringData();
     auto suffixPos = indexRoot.find(kSubtreeSuffix);
 
     // If we're indexing a single subtree, we can't also specify a path projection.
@@ -95,13 +97,120 @@ WildcardKeyGenerator::WildcardKeyGenerator(BSONObj keyPattern,
                                            const CollatorInterface* collator)
     : _collator(collator), _keyPattern(keyPattern) {
     _projExec = createProjectionExec(keyPattern, pathProjection);
+    _wildcardFieldPos = getWildcardFieldPos(_keyPattern);
+
+    BSONObjBuilder metadataRegularValues;
+    for (auto&& elem : _keyPattern) {
+        if (!isWildcardFieldName(elem.fieldNameStringData())) {
+            _regularFields.push_back(elem.fieldName());
+            metadataRegularValues.appendMinKey("");
+        }
+    }
+    _metadataRegularValues = metadataRegularValues.obj();
+}
+
+bool WildcardKeyGenerator::isWildcardFieldName(StringData fieldName) {
+    return fieldName == "$**"_sd || fieldName.endsWith(kSubtreeSuffix);
+}
+
+size_t WildcardKeyGenerator::getWildcardFieldPos(const BSONObj& keyPattern) {
+    size_t pos = 0;
+    for (auto&& elem : keyPattern) {
+        if (isWildcardFieldName(elem.fieldNameStringData())) {
+            return pos;
+        }
+        ++pos;
+    }
+    MONGO_UNREACHABLE;
 }
 
 void WildcardKeyGenerator::generateKeys(BSONObj inputDoc,
                                         BSONObjSet* keys,
                                         BSONObjSet* multikeyPaths) const {
     FieldRef rootPath;
-    _traverseWildcard(_projExec->applyProjection(inputDoc), false, &rootPath, keys, multikeyPaths);
+    auto projectedDoc = _projExec->applyProjection(inputDoc);
+    if (_regularFields.empty()) {
+        _traverseWildcard(projectedDoc, false, &rootPath, keys, multikeyPaths);
+        return;
+    }
+
+    // For a compound key pattern, generate the single-field wildcard keys first and then surround
+    // each of them with the values of the regular fields.
+    auto wildcardKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    auto wildcardMultikeyPaths = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    _traverseWildcard(projectedDoc,
+                      false,
+                      &rootPath,
+                      &wildcardKeys,
+                      multikeyPaths ? &wildcardMultikeyPaths : nullptr);
+
+    if (!wildcardKeys.empty()) {
+        const auto regularValues = _extractRegularFieldValues(inputDoc);
+        for (auto&& wildcardKey : wildcardKeys) {
+            keys->insert(_makeCompoundKey(wildcardKey, regularValues));
+        }
+    }
+    for (auto&& metadataKey : wildcardMultikeyPaths) {
+        multikeyPaths->insert(_makeCompoundKey(metadataKey, _metadataRegularValues));
+    }
+}
+
+std::pair<BSONObj, BSONObj> WildcardKeyGenerator::getMultikeyMetadataKeyRange() const {
+    // Metadata keys carry the number 1 in place of a path, which sorts before every string path;
+    // their regular fields are always MinKey.
+    return {_makeCompoundKey(BSON("" << 1 << "" << MINKEY), _metadataRegularValues),
+            _makeCompoundKey(BSON("" << 1 << "" << MAXKEY), _metadataRegularValues)};
+}
+
+StringData WildcardKeyGenerator::extractMultikeyPath(const BSONObj& metadataKey) const {
+    BSONObjIterator it(metadataKey);
+    for (size_t i = 0; i < _wildcardFieldPos; ++i) {
+        invariant(it.next().type() == BSONType::MinKey);
+    }
+    invariant(it.next().numberInt() == 1);
+    auto pathElem = it.next();
+    invariant(pathElem.type() == BSONType::String);
+    while (it.more()) {
+        invariant(it.next().type() == BSONType::MinKey);
+    }
+    return pathElem.valueStringData();
+}
+
+BSONObj WildcardKeyGenerator::_extractRegularFieldValues(const BSONObj& inputDoc) const {
+    BSONObjBuilder bob;
+    for (auto&& field : _regularFields) {
+        BSONElementSet elems;
+        std::set<size_t> arrayComponents;
+        dotted_path_support::extractAllElementsAlongPath(
+            inputDoc, field, elems, true, &arrayComponents);
+        uassert(51011,
+                str::stream() << "Cannot index an array in the non-wildcard field '" << field
+                              << "' of a compound wildcard index",
+                arrayComponents.empty());
+        invariant(elems.size() <= 1);
+        if (elems.empty()) {
+            bob.appendNull("");
+        } else {
+            CollationIndexKey::collationAwareIndexKeyAppend(*elems.begin(), _collator, &bob);
+        }
+    }
+    return bob.obj();
+}
+
+BSONObj WildcardKeyGenerator::_makeCompoundKey(const BSONObj& wildcardKey,
+                                               const BSONObj& regularValues) const {
+    BSONObjBuilder bob;
+    BSONObjIterator regularIt(regularValues);
+    for (size_t i = 0; i <= _regularFields.size(); ++i) {
+        if (i == _wildcardFieldPos) {
+            for (auto&& elem : wildcardKey) {
+                bob.appendAs(elem, "");
+            }
+        } else {
+            bob.appendAs(regularIt.next(), "");
+        }
+    }
+    return bob.obj();
 }
 
 void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
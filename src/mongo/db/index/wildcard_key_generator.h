@@ -28,6 +28,10 @@
 
 #pragma once
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "mongo/db/exec/projection_exec_agg.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/query/collation/collator_interface.h"
@@ -38,6 +42,10 @@ namespace mongo {
  * This class is responsible for generating an aggregation projection based on the keyPattern and
  * pathProjection specs, and for subsequently extracting the set of all path-value pairs for each
  * document.
+ *
+ * A wildcard key pattern may be compound, e.g. { tenantId: 1, "attrs.$**": 1, ts: 1 }. It has
+ * exactly one wildcard component; the remaining fields are regular, non-multikey fields whose
+ * values are stored around the wildcard's path-value pair in every key.
  */
 class WildcardKeyGenerator {
 public:
@@ -51,6 +59,17 @@ public:
     static std::unique_ptr<ProjectionExecAgg> createProjectionExec(BSONObj keyPattern,
                                                                    BSONObj pathProjection);
 
+    /**
+     * Returns the position of the wildcard component within 'keyPattern', which must contain
+     * exactly one field of the form "$**" or "path.$**".
+     */
+    static size_t getWildcardFieldPos(const BSONObj& keyPattern);
+
+    /**
+     * Returns true if 'fieldName' names the wildcard component of a wildcard key pattern.
+     */
+    static bool isWildcardFieldName(StringData fieldName);
+
     WildcardKeyGenerator(BSONObj keyPattern,
                          BSONObj pathProjection,
                          const CollatorInterface* collator);
@@ -62,9 +81,24 @@ public:
      * Also adds one entry to 'multikeyPaths' for each array encountered in the post-projection
      * document, in the following format:
      *      { '': 1, '': 'path.to.array' }
+     * For a compound key pattern, the values of the regular fields are placed before and after
+     * these pairs according to their position in the key pattern. Metadata keys use MinKey for
+     * each regular field. Throws if a regular field of the document holds an array.
      */
     void generateKeys(BSONObj inputDoc, BSONObjSet* keys, BSONObjSet* multikeyPaths) const;
 
+    /**
+     * Returns the smallest and largest possible multikey metadata keys for this index. Every
+     * multikey metadata key generated by this index lies between the two.
+     */
+    std::pair<BSONObj, BSONObj> getMultikeyMetadataKeyRange() const;
+
+    /**
+     * Returns the array path recorded in the multikey metadata key 'metadataKey'. The returned
+     * StringData points into 'metadataKey'.
+     */
+    StringData extractMultikeyPath(const BSONObj& metadataKey) const;
+
 private:
     // Traverses every path of the post-projection document, adding keys to the set as it goes.
     void _traverseWildcard(BSONObj obj,
@@ -84,8 +118,24 @@ private:
                                BSONObjSet* keys) const;
     bool _addKeyForEmptyLeaf(BSONElement elem, const FieldRef& fullPath, BSONObjSet* keys) const;
 
+    // Returns the values of the regular fields of a compound key pattern for 'inputDoc', in key
+    // pattern order. A missing field is represented by null.
+    BSONObj _extractRegularFieldValues(const BSONObj& inputDoc) const;
+
+    // Surrounds the single-field wildcard key 'wildcardKey' with the 'regularValues' of a compound
+    // key pattern.
+    BSONObj _makeCompoundKey(const BSONObj& wildcardKey, const BSONObj& regularValues) const;
+
     std::unique_ptr<ProjectionExecAgg> _projExec;
     const CollatorInterface* _collator;
     const BSONObj _keyPattern;
+
+    // The non-wildcard fields of a compound key pattern, in key pattern order, and the position of
+    // the wildcard component. '_regularFields' is empty for a single-field wildcard index.
+    std::vector<std::string> _regularFields;
+    size_t _wildcardFieldPos = 0;
+
+    // One MinKey per regular field; used for the regular fields of multikey metadata keys.
+    BSONObj _metadataRegularValues;
 };
 }  // namespace mongo
@@ -967,5 +967,88 @@ TEST(WildcardKeyGeneratorDottedFieldsTest, DoNotIndexDottedFieldsWithSimilarSubp
     ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
 }
 
+// Compound wildcard index tests.
+
+TEST(WildcardKeyGeneratorCompoundTest, ExtractKeysSurroundedByRegularFields) {
+    WildcardKeyGenerator keyGen{fromjson("{tenantId: 1, 'attrs.$**': 1, ts: 1}"), {}, nullptr};
+    auto inputDoc = fromjson("{tenantId: 'x', attrs: {a: 1, b: [2, 3]}, ts: 5}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': 'x', '': 'attrs.a', '': 1, '': 5}"),
+                                    fromjson("{'': 'x', '': 'attrs.b', '': 2, '': 5}"),
+                                    fromjson("{'': 'x', '': 'attrs.b', '': 3, '': 5}")});
+
+    auto expectedMultikeyPaths =
+        makeKeySet({fromjson("{'': {$minKey: 1}, '': 1, '': 'attrs.b', '': {$minKey: 1}}")});
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+    ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
+}
+
+TEST(WildcardKeyGeneratorCompoundTest, MissingRegularFieldIsIndexedAsNull) {
+    WildcardKeyGenerator keyGen{fromjson("{'a.b': 1, 'c.$**': 1}"), {}, nullptr};
+    auto inputDoc = fromjson("{a: {d: 1}, c: {e: 2}}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': null, '': 'c.e', '': 2}")});
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+    ASSERT(assertKeysetsEqual(makeKeySet(), multikeyMetadataKeys));
+}
+
+TEST(WildcardKeyGeneratorCompoundTest, NoKeysWhenWildcardComponentIsEmpty) {
+    WildcardKeyGenerator keyGen{fromjson("{a: 1, '$**': 1}"), fromjson("{a: 0}"), nullptr};
+    auto inputDoc = fromjson("{a: 1}");
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(makeKeySet(), outputKeys));
+    ASSERT(assertKeysetsEqual(makeKeySet(), multikeyMetadataKeys));
+}
+
+TEST(WildcardKeyGeneratorCompoundTest, FailsWhenRegularFieldIsArray) {
+    WildcardKeyGenerator keyGen{fromjson("{a: 1, 'b.$**': 1}"), {}, nullptr};
+
+    for (auto&& inputDoc : {fromjson("{a: [1, 2], b: {c: 1}}"), fromjson("{a: [], b: {c: 1}}")}) {
+        auto outputKeys = makeKeySet();
+        auto multikeyMetadataKeys = makeKeySet();
+        ASSERT_THROWS_CODE(keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys),
+                           AssertionException,
+                           51011);
+    }
+}
+
+TEST(WildcardKeyGeneratorCompoundTest, RegularFieldsAreCollationAware) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    WildcardKeyGenerator keyGen{fromjson("{a: 1, 'b.$**': 1}"), {}, &collator};
+    auto inputDoc = fromjson("{a: 'abc', b: {c: 'def'}}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': 'cba', '': 'b.c', '': 'fed'}")});
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+}
+
+TEST(WildcardKeyGeneratorCompoundTest, MultikeyMetadataKeyRangeContainsMetadataKeys) {
+    WildcardKeyGenerator keyGen{fromjson("{a: 1, 'b.$**': 1, c: 1}"), {}, nullptr};
+    auto metadataKey = fromjson("{'': {$minKey: 1}, '': 1, '': 'b.d', '': {$minKey: 1}}");
+    auto range = keyGen.getMultikeyMetadataKeyRange();
+
+    ASSERT_BSONOBJ_LT(range.first, metadataKey);
+    ASSERT_BSONOBJ_GT(range.second, metadataKey);
+    ASSERT_EQ(keyGen.extractMultikeyPath(metadataKey), "b.d"_sd);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -199,7 +199,7 @@ Status IndexBuilder::_build(OperationContext* opCtx,
     MultiIndexBlock& indexer(*indexerPtr);
     indexer.allowInterruption();
     if (allowBackgroundBuilding)
-        indexer.allowBackgroundBuilding();
+        indexer.forceBackgroundBuilding();
 
     Status status = Status::OK();
     {
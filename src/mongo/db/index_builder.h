@@ -54,9 +54,11 @@ class OperationContext;
  * build an index in the foreground; the properties of BackgroundJob are not used for this use
  * case.
  * For background index builds, BackgroundJob::go() is called on the IndexBuilder instance,
- * which begins a new thread at this class's run() method.  After go() is called in the
- * parent thread, waitForBgIndexStarting() must be called by the same parent thread,
- * before any other thread calls go() on any other IndexBuilder instance.  This is
+ * which begins a new thread at this class's run() method. Indexes built by run() are always built
+ * in the background, even if their spec asks for a foreground build, as the replication applier
+ * may hand foreground builds to a thread so that they do not hold up oplog application.
+ * After go() is called in the parent thread, waitForBgIndexStarting() must be called by the same
+ * parent thread, before any other thread calls go() on any other IndexBuilder instance.  This is
  * ensured by the replication system, since commands are effectively run single-threaded
  * by the replication applier.
  * The argument "relaxConstraints" specifies whether we should honor or ignore index constraints,
@@ -52,6 +52,7 @@
 #include "mongo/db/auth/security_key.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -62,6 +63,7 @@
 #include "mongo/logger/rotatable_file_writer.h"
 #include "mongo/logger/syslog_appender.h"
 #include "mongo/platform/process_id.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/ssl_manager.h"
@@ -211,13 +213,27 @@ void forkServerOrDie() {
 }
 
 MONGO_EXPORT_SERVER_PARAMETER(maxLogSizeKB, int, logger::LogContext::kDefaultMaxLogSizeKB);
+
+// When non-zero and logging to a file, log messages are handed to a background thread through a
+// buffer of this many entries instead of being written by the logging thread.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogBufferSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 1024 * 1024) {
+            return Status(ErrorCodes::BadValue,
+                          "asyncLogBufferSize must be between 0 and 1048576, inclusive");
+        }
+        return Status::OK();
+    });
+
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))
 (InitializerContext*) {
+    using logger::AsyncAppender;
     using logger::LogManager;
     using logger::MessageEventEphemeral;
     using logger::MessageEventDetailsEncoder;
+    using logger::MessageEventUnadornedEncoder;
     using logger::MessageEventWithContextEncoder;
     using logger::MessageLogDomain;
     using logger::RotatableFileAppender;
@@ -298,9 +314,22 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        if (asyncLogBufferSize > 0) {
+            auto appender = std::make_unique<AsyncAppender<MessageEventEphemeral>>(
+                std::make_unique<MessageEventDetailsEncoder>(),
+                std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventUnadornedEncoder>(), writer.getValue()),
+                asyncLogBufferSize);
+            // The process exits without destroying the appender, so make sure the last messages
+            // before exit are written rather than left in the buffer.
+            auto rawAppender = appender.get();
+            registerShutdownTask([rawAppender] { rawAppender->setWriteThrough(true); });
+            manager->getGlobalDomain()->attachAppender(std::move(appender));
+        } else {
+            manager->getGlobalDomain()->attachAppender(
+                std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        }
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
                 std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
@@ -38,13 +38,18 @@
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/deferred_writer.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -52,8 +57,89 @@ using std::unique_ptr;
 using std::endl;
 using std::string;
 
+// When set, profile() queues its entries to be written by a background thread instead of writing
+// them from the profiled operation.
+MONGO_EXPORT_SERVER_PARAMETER(deferProfilerWrites, bool, false);
+
 namespace {
 
+// The size limit of the buffer of queued profile entries of each database.
+const int64_t kDeferredProfileBufferBytes = 16 * 1024 * 1024;
+
+Counter64 droppedProfileEntries;
+ServerStatusMetricField<Counter64> displayDroppedProfileEntries(
+    "profiler.deferredWrites.dropped", &droppedProfileEntries);
+
+/**
+ * Writes the queued profile entries of one database. Unlike other deferred writers it never
+ * creates the database, so that an entry queued before a dropDatabase does not bring the database
+ * back, and it creates a missing profile collection the same way profile() does.
+ */
+class ProfileWriter final : public DeferredWriter {
+public:
+    explicit ProfileWriter(NamespaceString nss)
+        : DeferredWriter(std::move(nss), CollectionOptions(), kDeferredProfileBufferBytes) {}
+
+protected:
+    StatusWith<std::unique_ptr<AutoGetCollection>> _getCollection(
+        OperationContext* opCtx) override {
+        const auto& nss = getNamespace();
+        auto agc = stdx::make_unique<AutoGetCollection>(opCtx, nss, MODE_IX);
+        if (agc->getCollection()) {
+            return std::move(agc);
+        }
+
+        agc.reset();
+        {
+            AutoGetDb autoDb(opCtx, nss.db(), MODE_X);
+            if (autoDb.getDb()) {
+                Status status = createProfileCollection(opCtx, autoDb.getDb());
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+        }
+
+        agc = stdx::make_unique<AutoGetCollection>(opCtx, nss, MODE_IX);
+        if (!agc->getCollection()) {
+            return Status(ErrorCodes::NamespaceNotFound,
+                          str::stream() << "not profiling because db went away for " << nss.ns());
+        }
+        return std::move(agc);
+    }
+};
+
+/**
+ * The profile writers of each database, started the first time an entry is queued for it.
+ */
+struct ProfileWriters {
+    stdx::mutex mutex;
+    StringMap<std::unique_ptr<ProfileWriter>> writers;
+    bool shutdown = false;
+};
+
+const auto getProfileWriters = ServiceContext::declareDecoration<ProfileWriters>();
+
+/**
+ * Queues a profile entry for 'dbName'. Returns false if it was dropped.
+ */
+bool deferProfileEntry(ServiceContext* service, const std::string& dbName, const BSONObj& entry) {
+    auto& profileWriters = getProfileWriters(service);
+
+    // The mutex is held while queueing, so that the writer cannot be shut down in the meantime.
+    stdx::lock_guard<stdx::mutex> lk(profileWriters.mutex);
+    if (profileWriters.shutdown) {
+        return false;
+    }
+
+    auto& writer = profileWriters.writers[dbName];
+    if (!writer) {
+        writer = stdx::make_unique<ProfileWriter>(NamespaceString(dbName, "system.profile"));
+        writer->startup("ProfileWriter-" + dbName);
+    }
+    return writer->insertDocument(entry);
+}
+
 void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSession* authSession) {
     UserNameIterator nameIter = authSession->getAuthenticatedUserNames();
 
@@ -115,6 +201,13 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 
     const string dbName(nsToDatabase(CurOp::get(opCtx)->getNS()));
 
+    if (deferProfilerWrites.load()) {
+        if (!deferProfileEntry(opCtx->getServiceContext(), dbName, p)) {
+            droppedProfileEntries.increment();
+        }
+        return;
+    }
+
     try {
         // Even if the operation we are profiling was interrupted, we still want to output the
         // profiler entry.  This lock guard will prevent lock acquisitions from throwing exceptions
@@ -174,6 +267,16 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 }
 
 
+void shutdownProfiler(ServiceContext* service) {
+    auto& profileWriters = getProfileWriters(service);
+    stdx::lock_guard<stdx::mutex> lk(profileWriters.mutex);
+    profileWriters.shutdown = true;
+    for (auto&& writer : profileWriters.writers) {
+        writer.second->shutdown();
+    }
+}
+
+
 Status createProfileCollection(OperationContext* opCtx, Database* db) {
     invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_X));
 
@@ -35,12 +35,19 @@ namespace mongo {
 
 class Database;
 class OperationContext;
+class ServiceContext;
 
 /**
  * Invoked when database profile is enabled.
  */
 void profile(OperationContext* opCtx, NetworkOp op);
 
+/**
+ * Writes out the profile entries still queued by profile() when the deferProfilerWrites parameter
+ * is set, and stops the threads writing them. Entries profiled afterwards are dropped.
+ */
+void shutdownProfiler(ServiceContext* service);
+
 /**
  * Pre-creates the profile collection for the specified database.
  */
@@ -90,22 +90,16 @@ void LogicalClock::set(ServiceContext* service, std::unique_ptr<LogicalClock> cl
 LogicalClock::LogicalClock(ServiceContext* service) : _service(service) {}
 
 LogicalTime LogicalClock::getClusterTime() {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-    return _clusterTime;
+    return LogicalTime(Timestamp(_clusterTime.load()));
 }
 
 Status LogicalClock::advanceClusterTime(const LogicalTime newTime) {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-
-    auto rateLimitStatus = _passesRateLimiter_inlock(newTime);
+    auto rateLimitStatus = _passesRateLimiter(newTime);
     if (!rateLimitStatus.isOK()) {
         return rateLimitStatus;
     }
 
-    if (newTime > _clusterTime) {
-        _clusterTime = newTime;
-    }
-
+    _advanceTo(newTime);
     return Status::OK();
 }
 
@@ -113,50 +107,55 @@ LogicalTime LogicalClock::reserveTicks(uint64_t nTicks) {
 
     invariant(nTicks > 0 && nTicks <= kMaxSignedInt);
 
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-
-    LogicalTime clusterTime = _clusterTime;
-
     const unsigned wallClockSecs =
         durationCount<Seconds>(_service->getFastClockSource()->now().toDurationSinceEpoch());
-    unsigned clusterTimeSecs = clusterTime.asTimestamp().getSecs();
 
-    // Synchronize clusterTime with wall clock time, if clusterTime was behind in seconds.
-    if (clusterTimeSecs < wallClockSecs) {
-        clusterTime = LogicalTime(Timestamp(wallClockSecs, 0));
-    }
-    // If reserving 'nTicks' would force the cluster timestamp's increment field to exceed (2^31-1),
-    // overflow by moving to the next second. We use the signed integer maximum as an overflow point
-    // in order to preserve compatibility with potentially signed or unsigned integral Timestamp
-    // increment types. It is also unlikely to apply more than 2^31 oplog entries in the span of one
-    // second.
-    else if (clusterTime.asTimestamp().getInc() > (kMaxSignedInt - nTicks)) {
-
-        log() << "Exceeded maximum allowable increment value within one second. Moving clusterTime "
-                 "forward to the next second.";
-
-        // Move time forward to the next second
-        clusterTime = LogicalTime(Timestamp(clusterTime.asTimestamp().getSecs() + 1, 0));
-    }
+    while (true) {
+        const Timestamp clusterTime(_clusterTime.load());
 
-    uassert(40482,
-            "cluster time cannot be advanced beyond its maximum value",
-            lessThanOrEqualToMaxPossibleTime(clusterTime, nTicks));
+        // Synchronize clusterTime with wall clock time, if clusterTime was behind in seconds. If
+        // another thread changes the clock first, retry with its value.
+        if (clusterTime.getSecs() < wallClockSecs) {
+            _clusterTime.compareAndSwap(clusterTime.asULL(),
+                                        Timestamp(wallClockSecs, 0).asULL());
+            continue;
+        }
 
-    // Save the next cluster time.
-    clusterTime.addTicks(1);
-    _clusterTime = clusterTime;
+        // If reserving 'nTicks' would force the cluster timestamp's increment field to exceed
+        // (2^31-1), overflow by moving to the next second. We use the signed integer maximum as an
+        // overflow point in order to preserve compatibility with potentially signed or unsigned
+        // integral Timestamp increment types. It is also unlikely to apply more than 2^31 oplog
+        // entries in the span of one second.
+        if (clusterTime.getInc() > (kMaxSignedInt - nTicks)) {
+            log() << "Exceeded maximum allowable increment value within one second. Moving "
+                     "clusterTime forward to the next second.";
+
+            // Move time forward to the next second
+            _clusterTime.compareAndSwap(clusterTime.asULL(),
+                                        Timestamp(clusterTime.getSecs() + 1, 0).asULL());
+            continue;
+        }
 
-    // Add the rest of the requested ticks if needed.
-    if (nTicks > 1) {
-        _clusterTime.addTicks(nTicks - 1);
-    }
+        uassert(40482,
+                "cluster time cannot be advanced beyond its maximum value",
+                lessThanOrEqualToMaxPossibleTime(LogicalTime(clusterTime), nTicks));
+
+        // Reserve the ticks, unless another thread moved the clock since it was checked above, in
+        // which case the checks are repeated on its value.
+        const Timestamp reserved(clusterTime.getSecs(), clusterTime.getInc() + nTicks);
+        if (_clusterTime.compareAndSwap(clusterTime.asULL(), reserved.asULL()) !=
+            clusterTime.asULL()) {
+            continue;
+        }
 
-    return clusterTime;
+        // Return the first of the reserved ticks.
+        LogicalTime firstTick(clusterTime);
+        firstTick.addTicks(1);
+        return firstTick;
+    }
 }
 
 void LogicalClock::setClusterTimeFromTrustedSource(LogicalTime newTime) {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
     // Rate limit checks are skipped here so a server with no activity for longer than
     // maxAcceptableLogicalClockDriftSecs seconds can still have its cluster time initialized.
 
@@ -164,12 +163,22 @@ void LogicalClock::setClusterTimeFromTrustedSource(LogicalTime newTime) {
             "cluster time cannot be advanced beyond its maximum value",
             lessThanOrEqualToMaxPossibleTime(newTime, 0));
 
-    if (newTime > _clusterTime) {
-        _clusterTime = newTime;
+    _advanceTo(newTime);
+}
+
+void LogicalClock::_advanceTo(LogicalTime newTime) {
+    const auto newTimeULL = newTime.asTimestamp().asULL();
+    auto current = _clusterTime.load();
+    while (newTimeULL > current) {
+        const auto previous = _clusterTime.compareAndSwap(current, newTimeULL);
+        if (previous == current) {
+            break;
+        }
+        current = previous;
     }
 }
 
-Status LogicalClock::_passesRateLimiter_inlock(LogicalTime newTime) {
+Status LogicalClock::_passesRateLimiter(LogicalTime newTime) {
     const unsigned wallClockSecs =
         durationCount<Seconds>(_service->getFastClockSource()->now().toDurationSinceEpoch());
     auto maxAcceptableDriftSecs = static_cast<const unsigned>(maxAcceptableLogicalClockDriftSecs);
@@ -192,13 +201,11 @@ Status LogicalClock::_passesRateLimiter_inlock(LogicalTime newTime) {
 }
 
 bool LogicalClock::isEnabled() const {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-    return _isEnabled;
+    return _isEnabled.load();
 }
 
 void LogicalClock::disable() {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-    _isEnabled = false;
+    _isEnabled.store(false);
 }
 
 }  // namespace mongo
@@ -29,7 +29,7 @@
 #pragma once
 
 #include "mongo/db/logical_time.h"
-#include "mongo/stdx/mutex.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 class ServiceContext;
@@ -79,6 +79,10 @@ public:
      * Returns the next clusterTime value and provides a guarantee that any future call to
      * reserveTicks() will return a value at least 'nTicks' ticks in the future from the current
      * clusterTime.
+     *
+     * The ticks are reserved with a compare-and-swap on the clusterTime, so concurrent writers do
+     * not serialize on a mutex here. A reservation retries, with the checks against the wall clock
+     * and the increment's overflow point repeated, whenever another writer moved the clock first.
      */
     LogicalTime reserveTicks(uint64_t nTicks);
 
@@ -104,14 +108,19 @@ private:
      * Rate limiter for advancing cluster time. Rejects newTime if its seconds value is more than
      * kMaxAcceptableLogicalClockDriftSecs seconds ahead of this node's wall clock.
      */
-    Status _passesRateLimiter_inlock(LogicalTime newTime);
+    Status _passesRateLimiter(LogicalTime newTime);
+
+    /**
+     * Sets the cluster time to 'newTime' if it is greater than the current cluster time.
+     */
+    void _advanceTo(LogicalTime newTime);
 
     ServiceContext* const _service;
 
-    // The mutex protects _clusterTime and _isEnabled.
-    mutable stdx::mutex _mutex;
-    LogicalTime _clusterTime;
-    bool _isEnabled{true};
+    // The cluster time, packed as Timestamp::asULL() so that it can be read and advanced without
+    // a lock: the seconds are in the high 32 bits and the increment in the low 32 bits.
+    AtomicUInt64 _clusterTime{0};
+    AtomicWord<bool> _isEnabled{true};
 };
 
 }  // namespace mongo
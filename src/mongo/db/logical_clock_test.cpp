@@ -38,6 +38,7 @@
 #include "mongo/db/logical_time.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/log.h"
@@ -95,6 +96,39 @@ TEST_F(LogicalClockTest, reserveTicks) {
     ASSERT_TRUE(newTimeSecs == initTimeSecs + 1);
 }
 
+// Verify that concurrent reservations never hand out the same tick twice.
+TEST_F(LogicalClockTest, ConcurrentReserveTicksAreDisjoint) {
+    setMockClockSourceTime(Date_t::fromMillisSinceEpoch(10 * 1000));
+
+    const int kThreads = 8;
+    const int kReservations = 1000;
+    std::vector<std::vector<Timestamp>> reserved(kThreads);
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < kReservations; j++) {
+                const auto nTicks = 1 + j % 3;
+                const auto first = getClock()->reserveTicks(nTicks).asTimestamp();
+                for (int k = 0; k < nTicks; k++) {
+                    reserved[i].push_back(Timestamp(first.asULL() + k));
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<Timestamp> allTicks;
+    for (auto&& ticks : reserved) {
+        allTicks.insert(allTicks.end(), ticks.begin(), ticks.end());
+    }
+    std::sort(allTicks.begin(), allTicks.end());
+    ASSERT(std::adjacent_find(allTicks.begin(), allTicks.end()) == allTicks.end());
+    ASSERT_EQ(allTicks.front(), Timestamp(10, 1));
+    ASSERT_EQ(allTicks.back(), getClock()->getClusterTime().asTimestamp());
+}
+
 // Verify the advanceClusterTime functionality.
 TEST_F(LogicalClockTest, advanceClusterTime) {
     auto t1 = getClock()->reserveTicks(1);
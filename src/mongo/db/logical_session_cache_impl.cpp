@@ -32,6 +32,9 @@
 
 #include "mongo/db/logical_session_cache_impl.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/operation_context.h"
@@ -55,6 +58,7 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(disableLogicalSessionCacheRefresh, bool, f
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(maxSessions, int, 1'000'000);
 
 constexpr Milliseconds LogicalSessionCacheImpl::kLogicalSessionDefaultRefresh;
+constexpr size_t LogicalSessionCacheImpl::kNumPartitions;
 
 LogicalSessionCacheImpl::LogicalSessionCacheImpl(
     std::unique_ptr<ServiceLiaison> service,
@@ -70,9 +74,12 @@ LogicalSessionCacheImpl::LogicalSessionCacheImpl(
     _stats.setLastTransactionReaperJobTimestamp(now());
 
     if (!disableLogicalSessionCacheRefresh) {
-        _service->scheduleJob({"LogicalSessionCacheRefresh",
-                               [this](Client* client) { _periodicRefresh(client); },
-                               _refreshInterval});
+        // Each run of the periodic refresh writes one partition, so that every partition is
+        // written once per refresh interval.
+        _service->scheduleJob(
+            {"LogicalSessionCacheRefresh",
+             [this](Client* client) { _periodicRefresh(client); },
+             std::max(Milliseconds(1), _refreshInterval / static_cast<int>(kNumPartitions))});
         if (_transactionReaper) {
             _service->scheduleJob({"LogicalSessionCacheReap",
                                    [this](Client* client) { _periodicReap(client); },
@@ -92,9 +99,10 @@ LogicalSessionCacheImpl::~LogicalSessionCacheImpl() {
 }
 
 Status LogicalSessionCacheImpl::promote(LogicalSessionId lsid) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    auto it = _activeSessions.find(lsid);
-    if (it == _activeSessions.end()) {
+    auto& partition = _getPartition(lsid);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.activeSessions.find(lsid);
+    if (it == partition.activeSessions.end()) {
         return {ErrorCodes::NoSuchSession, "no matching session record found in the cache"};
     }
 
@@ -150,8 +158,12 @@ Status LogicalSessionCacheImpl::vivify(OperationContext* opCtx, const LogicalSes
 }
 
 Status LogicalSessionCacheImpl::refreshNow(Client* client) {
+    std::vector<size_t> allPartitions(kNumPartitions);
+    std::iota(allPartitions.begin(), allPartitions.end(), 0);
+
     try {
-        _refresh(client);
+        stdx::lock_guard<stdx::mutex> lk(_refreshMutex);
+        _refresh(client, allPartitions);
     } catch (...) {
         return exceptionToStatus();
     }
@@ -167,13 +179,15 @@ Date_t LogicalSessionCacheImpl::now() {
 }
 
 size_t LogicalSessionCacheImpl::size() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheMutex);
-    return _activeSessions.size();
+    return _activeSessionsCount.load();
 }
 
 void LogicalSessionCacheImpl::_periodicRefresh(Client* client) {
     try {
-        _refresh(client);
+        stdx::lock_guard<stdx::mutex> lk(_refreshMutex);
+        const auto partitionIndex = _nextRefreshPartition;
+        _nextRefreshPartition = (_nextRefreshPartition + 1) % kNumPartitions;
+        _refresh(client, {partitionIndex});
     } catch (...) {
         log() << "Failed to refresh session cache: " << exceptionToStatus();
     }
@@ -256,7 +270,8 @@ Status LogicalSessionCacheImpl::_reap(Client* client) {
     return Status::OK();
 }
 
-void LogicalSessionCacheImpl::_refresh(Client* client) {
+void LogicalSessionCacheImpl::_refresh(Client* client,
+                                       const std::vector<size_t>& partitionIndexes) {
     // Stats for serverStatus:
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
@@ -298,37 +313,50 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         return;
     }
 
-    LogicalSessionIdSet staleSessions;
     LogicalSessionIdSet explicitlyEndingSessions;
-    LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
-
-    // backSwapper creates a guard that in the case of a exception
-    // replaces the ending or active sessions that swapped out of of LogicalSessionCache,
-    // and merges in any records that had been added since we swapped them
-    // out.
-    auto backSwapper = [this](auto& member, auto& temp) {
-        return MakeGuard([this, &member, &temp] {
-            stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-            using std::swap;
-            swap(member, temp);
-            for (const auto& it : temp) {
-                member.emplace(it);
-            }
-        });
-    };
 
-    {
+    // Swap the ending and active sessions of the partitions out of the cache. The guards below
+    // put back the sessions of a partition, merged with those added since they were swapped out,
+    // if writing them to the sessions collection fails.
+    std::vector<LogicalSessionIdMap<LogicalSessionRecord>> swappedActiveSessions(
+        partitionIndexes.size());
+    std::vector<LogicalSessionIdSet> swappedEndingSessions(partitionIndexes.size());
+    for (size_t i = 0; i < partitionIndexes.size(); ++i) {
+        auto& partition = _partitions[partitionIndexes[i]];
         using std::swap;
-        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-        swap(explicitlyEndingSessions, _endingSessions);
-        swap(activeSessions, _activeSessions);
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        swap(swappedEndingSessions[i], partition.endingSessions);
+        swap(swappedActiveSessions[i], partition.activeSessions);
+        _activeSessionsCount.subtractAndFetch(swappedActiveSessions[i].size());
     }
-    auto activeSessionsBackSwapper = backSwapper(_activeSessions, activeSessions);
-    auto explicitlyEndingBackSwaper = backSwapper(_endingSessions, explicitlyEndingSessions);
+
+    auto activeSessionsBackSwapper = MakeGuard([&] {
+        for (size_t i = 0; i < partitionIndexes.size(); ++i) {
+            auto& partition = _partitions[partitionIndexes[i]];
+            stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+            const auto sizeBefore = partition.activeSessions.size();
+            for (const auto& it : swappedActiveSessions[i]) {
+                partition.activeSessions.emplace(it);
+            }
+            _activeSessionsCount.addAndFetch(partition.activeSessions.size() - sizeBefore);
+        }
+    });
+    auto explicitlyEndingBackSwaper = MakeGuard([&] {
+        for (size_t i = 0; i < partitionIndexes.size(); ++i) {
+            auto& partition = _partitions[partitionIndexes[i]];
+            stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+            partition.endingSessions.insert(swappedEndingSessions[i].begin(),
+                                            swappedEndingSessions[i].end());
+        }
+    });
 
     // remove all explicitlyEndingSessions from activeSessions
-    for (const auto& lsid : explicitlyEndingSessions) {
-        activeSessions.erase(lsid);
+    for (size_t i = 0; i < partitionIndexes.size(); ++i) {
+        explicitlyEndingSessions.insert(swappedEndingSessions[i].begin(),
+                                        swappedEndingSessions[i].end());
+        for (const auto& lsid : swappedEndingSessions[i]) {
+            swappedActiveSessions[i].erase(lsid);
+        }
     }
 
     // refresh all recently active sessions as well as for sessions attached to running ops
@@ -338,14 +366,20 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     auto runningOpSessions = _service->getActiveOpSessions();
 
     for (const auto& it : runningOpSessions) {
+        // Sessions of the other partitions are refreshed with their partition.
+        if (!_isInPartitions(it, partitionIndexes)) {
+            continue;
+        }
         // if a running op is the cause of an upsert, we won't have a user name for the record
         if (explicitlyEndingSessions.count(it) > 0) {
             continue;
         }
         activeSessionRecords.insert(makeLogicalSessionRecord(it, now()));
     }
-    for (const auto& it : activeSessions) {
-        activeSessionRecords.insert(it.second);
+    for (const auto& partitionActiveSessions : swappedActiveSessions) {
+        for (const auto& it : partitionActiveSessions) {
+            activeSessionRecords.insert(it.second);
+        }
     }
 
     // Refresh the active sessions in the sessions collection.
@@ -370,12 +404,21 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     KillAllSessionsByPatternSet patterns;
 
     auto openCursorSessions = _service->getOpenCursorSessions();
-    // Exclude sessions added to _activeSessions from the openCursorSession to avoid race between
-    // killing cursors on the removed sessions and creating sessions.
-    {
-        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+    for (auto it = openCursorSessions.begin(); it != openCursorSessions.end();) {
+        if (_isInPartitions(*it, partitionIndexes)) {
+            ++it;
+        } else {
+            it = openCursorSessions.erase(it);
+        }
+    }
+
+    // Exclude sessions added to the active sessions from the openCursorSession to avoid race
+    // between killing cursors on the removed sessions and creating sessions.
+    for (auto partitionIndex : partitionIndexes) {
+        auto& partition = _partitions[partitionIndex];
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-        for (const auto& it : _activeSessions) {
+        for (const auto& it : partition.activeSessions) {
             auto newSessionIt = openCursorSessions.find(it.first);
             if (newSessionIt != openCursorSessions.end()) {
                 openCursorSessions.erase(newSessionIt);
@@ -409,43 +452,74 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
 }
 
 void LogicalSessionCacheImpl::endSessions(const LogicalSessionIdSet& sessions) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _endingSessions.insert(begin(sessions), end(sessions));
+    for (const auto& lsid : sessions) {
+        auto& partition = _getPartition(lsid);
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.endingSessions.insert(lsid);
+    }
 }
 
 LogicalSessionCacheStats LogicalSessionCacheImpl::getStats() {
     stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _stats.setActiveSessionsCount(_activeSessions.size());
+    _stats.setActiveSessionsCount(_activeSessionsCount.load());
     return _stats;
 }
 
 Status LogicalSessionCacheImpl::_addToCache(LogicalSessionRecord record) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    if (_activeSessions.size() >= static_cast<size_t>(maxSessions)) {
+    auto& partition = _getPartition(record.getId());
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    if (_activeSessionsCount.load() >= maxSessions) {
         return {ErrorCodes::TooManyLogicalSessions, "cannot add session into the cache"};
     }
-    _activeSessions.insert(std::make_pair(record.getId(), record));
+    if (partition.activeSessions.insert(std::make_pair(record.getId(), record)).second) {
+        _activeSessionsCount.addAndFetch(1);
+    }
     return Status::OK();
 }
 
+size_t LogicalSessionCacheImpl::_partitionIndex(const LogicalSessionId& lsid) {
+    // The low bits of the hash pick the bucket within a partition's map, so use the high ones.
+    return (LogicalSessionIdHash{}(lsid) >> 24) % kNumPartitions;
+}
+
+LogicalSessionCacheImpl::Partition& LogicalSessionCacheImpl::_getPartition(
+    const LogicalSessionId& lsid) {
+    return _partitions[_partitionIndex(lsid)];
+}
+
+const LogicalSessionCacheImpl::Partition& LogicalSessionCacheImpl::_getPartition(
+    const LogicalSessionId& lsid) const {
+    return _partitions[_partitionIndex(lsid)];
+}
+
+bool LogicalSessionCacheImpl::_isInPartitions(const LogicalSessionId& lsid,
+                                              const std::vector<size_t>& partitionIndexes) {
+    return std::find(partitionIndexes.begin(), partitionIndexes.end(), _partitionIndex(lsid)) !=
+        partitionIndexes.end();
+}
+
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds() const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    ret.reserve(_activeSessions.size());
-    for (const auto& id : _activeSessions) {
-        ret.push_back(id.first);
+    ret.reserve(_activeSessionsCount.load());
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& id : partition.activeSessions) {
+            ret.push_back(id.first);
+        }
     }
     return ret;
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
     const std::vector<SHA256Block>& userDigests) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    for (const auto& it : _activeSessions) {
-        if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
-            userDigests.cend()) {
-            ret.push_back(it.first);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& it : partition.activeSessions) {
+            if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
+                userDigests.cend()) {
+                ret.push_back(it.first);
+            }
         }
     }
     return ret;
@@ -453,9 +527,10 @@ std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
 
 boost::optional<LogicalSessionRecord> LogicalSessionCacheImpl::peekCached(
     const LogicalSessionId& id) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    const auto it = _activeSessions.find(id);
-    if (it == _activeSessions.end()) {
+    const auto& partition = _getPartition(id);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    const auto it = partition.activeSessions.find(id);
+    if (it == partition.activeSessions.end()) {
         return boost::none;
     }
     return it->second;
@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "mongo/db/logical_session_cache.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/refresh_sessions_gen.h"
@@ -133,7 +136,7 @@ private:
      * session records contained within the cache.
      */
     void _periodicRefresh(Client* client);
-    void _refresh(Client* client);
+    void _refresh(Client* client, const std::vector<size_t>& partitionIndexes);
 
     void _periodicReap(Client* client);
     Status _reap(Client* client);
@@ -144,10 +147,36 @@ private:
     bool _isDead(const LogicalSessionRecord& record, Date_t now) const;
 
     /**
-     * Takes the lock and inserts the given record into the cache.
+     * Takes the lock of the record's partition and inserts the given record into the cache.
      */
     Status _addToCache(LogicalSessionRecord record);
 
+    /**
+     * The cache is split into partitions by the hash of the session id. Operations on sessions
+     * only take the lock of their session's partition, and the periodic refresh writes the
+     * sessions of one partition at a time, so that the writes to the sessions collection are
+     * spread over the refresh interval and lookups do not wait for a refresh of the whole cache.
+     */
+    static constexpr size_t kNumPartitions = 16;
+
+    struct Partition {
+        mutable stdx::mutex mutex;
+
+        LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
+
+        LogicalSessionIdSet endingSessions;
+    };
+
+    static size_t _partitionIndex(const LogicalSessionId& lsid);
+    Partition& _getPartition(const LogicalSessionId& lsid);
+    const Partition& _getPartition(const LogicalSessionId& lsid) const;
+
+    /**
+     * Returns whether the given session belongs to one of the given partitions.
+     */
+    static bool _isInPartitions(const LogicalSessionId& lsid,
+                                const std::vector<size_t>& partitionIndexes);
+
     const Milliseconds _refreshInterval;
     const Minutes _sessionTimeout;
 
@@ -161,11 +190,18 @@ private:
     mutable stdx::mutex _reaperMutex;
     std::shared_ptr<TransactionReaper> _transactionReaper;
 
+    // Protects '_stats'.
     mutable stdx::mutex _cacheMutex;
 
-    LogicalSessionIdMap<LogicalSessionRecord> _activeSessions;
+    std::array<Partition, kNumPartitions> _partitions;
+
+    // The number of sessions in the active sessions of all partitions.
+    AtomicWord<long long> _activeSessionsCount{0};
 
-    LogicalSessionIdSet _endingSessions;
+    // Serializes refreshes, and protects '_nextRefreshPartition', the partition which the next
+    // periodic refresh writes.
+    stdx::mutex _refreshMutex;
+    size_t _nextRefreshPartition = 0;
 
     Date_t lastRefreshTime;
 };
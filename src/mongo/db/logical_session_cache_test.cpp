@@ -246,6 +246,41 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     ASSERT(cache()->refreshNow(getClient()).isOK());
 }
 
+// Test that sessions which fail to refresh are put back in the cache, along with those started
+// during the refresh
+TEST_F(LogicalSessionCacheTest, FailedRefreshKeepsSessionsInCache) {
+    const int count = 100;
+    for (int i = 0; i < count; i++) {
+        ASSERT_OK(cache()->startSession(opCtx(), makeLogicalSessionRecordForTest()));
+    }
+    auto endedLsid = makeLogicalSessionIdForTest();
+    ASSERT_OK(
+        cache()->startSession(opCtx(), makeLogicalSessionRecord(endedLsid, service()->now())));
+    cache()->endSessions({endedLsid});
+
+    auto startedDuringRefresh = makeLogicalSessionRecordForTest();
+    sessions()->setRefreshHook([&](const LogicalSessionRecordSet& sessions) {
+        ASSERT_EQ(sessions.size(), size_t(count));
+        ASSERT_OK(cache()->startSession(nullptr, startedDuringRefresh));
+        return Status(ErrorCodes::HostUnreachable, "network error");
+    });
+
+    clearOpCtx();
+    ASSERT_NOT_OK(cache()->refreshNow(getClient()));
+    ASSERT_EQ(cache()->size(), size_t(count + 1));
+    ASSERT(cache()->peekCached(startedDuringRefresh.getId()));
+    ASSERT_FALSE(cache()->peekCached(endedLsid));
+
+    // The next refresh writes all of them, and ends the ended session.
+    sessions()->setRefreshHook([&](const LogicalSessionRecordSet& sessions) {
+        ASSERT_EQ(sessions.size(), size_t(count + 1));
+        return Status::OK();
+    });
+    ASSERT_OK(cache()->refreshNow(getClient()));
+    ASSERT_EQ(cache()->size(), size_t(0));
+    ASSERT_EQ(cache()->getStats().getLastSessionsCollectionJobEntriesEnded(), 1);
+}
+
 //
 TEST_F(LogicalSessionCacheTest, RefreshMatrixSessionState) {
     const std::vector<std::vector<std::string>> stateNames = {
@@ -0,0 +1,333 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+bool comparisonResult(MatchExpression::MatchType matchType, int cmp) {
+    switch (matchType) {
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+CompiledMatchExpression::CompiledMatchExpression(const MatchExpression* root) : _root(root) {
+    invariant(_root);
+
+    if (MatchExpression::AND == _root->matchType()) {
+        addConjuncts(_root);
+    } else {
+        addLeaf(_root);
+    }
+
+    // If nothing could be compiled, evaluate the original tree as a whole.
+    if (_groups.empty()) {
+        _residual.clear();
+    }
+}
+
+void CompiledMatchExpression::addConjuncts(const MatchExpression* expr) {
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        const MatchExpression* child = expr->getChild(i);
+        if (MatchExpression::AND == child->matchType()) {
+            addConjuncts(child);
+        } else if (!addLeaf(child)) {
+            _residual.push_back(child);
+        }
+    }
+}
+
+bool CompiledMatchExpression::addLeaf(const MatchExpression* expr) {
+    boost::optional<StringData> fieldName;
+    if (!collectFieldName(expr, &fieldName) || !fieldName) {
+        return false;
+    }
+
+    for (auto&& group : _groups) {
+        if (group.fieldName == *fieldName) {
+            group.leaves.push_back(compileLeaf(expr));
+            return true;
+        }
+    }
+
+    if (_groups.size() == kMaxGroups) {
+        return false;
+    }
+
+    FieldGroup group;
+    group.fieldName = *fieldName;
+    group.leaves.push_back(compileLeaf(expr));
+    _groups.push_back(std::move(group));
+    return true;
+}
+
+// static
+bool CompiledMatchExpression::collectFieldName(const MatchExpression* expr,
+                                               boost::optional<StringData>* fieldName) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT:
+        case MatchExpression::INTERNAL_SCHEMA_COND:
+        case MatchExpression::INTERNAL_SCHEMA_XOR:
+            // These evaluate their children against the same document.
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!collectFieldName(expr->getChild(i), fieldName)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::ALWAYS_FALSE:
+        case MatchExpression::ALWAYS_TRUE:
+            return true;
+        default:
+            break;
+    }
+
+    auto pathExpr = dynamic_cast<const PathMatchExpression*>(expr);
+    if (!pathExpr || pathExpr->path().empty()) {
+        return false;
+    }
+
+    const StringData firstPart = pathExpr->elementPath().fieldRef().getPart(0);
+    if (!*fieldName) {
+        *fieldName = firstPart;
+    }
+    return **fieldName == firstPart;
+}
+
+// static
+CompiledMatchExpression::Leaf CompiledMatchExpression::compileLeaf(const MatchExpression* expr) {
+    Leaf leaf;
+    leaf.expr = expr;
+    leaf.kind = leafKind(expr);
+
+    switch (leaf.kind) {
+        case LeafKind::kLogical:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                leaf.children.push_back(compileLeaf(expr->getChild(i)));
+            }
+            break;
+        case LeafKind::kObjectMatch:
+            leaf.subobject = stdx::make_unique<CompiledMatchExpression>(expr->getChild(0));
+            break;
+        default:
+            break;
+    }
+
+    return leaf;
+}
+
+// static
+CompiledMatchExpression::LeafKind CompiledMatchExpression::leafKind(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT:
+            return LeafKind::kLogical;
+        default:
+            break;
+    }
+
+    auto pathExpr = dynamic_cast<const PathMatchExpression*>(expr);
+    if (!pathExpr || pathExpr->elementPath().fieldRef().numParts() != 1) {
+        return LeafKind::kPath;
+    }
+
+    if (MatchExpression::INTERNAL_SCHEMA_OBJECT_MATCH == expr->matchType()) {
+        return LeafKind::kObjectMatch;
+    }
+
+    if (ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+        const BSONElement& rhs = static_cast<const ComparisonMatchExpression*>(expr)->getData();
+        switch (rhs.type()) {
+            case NumberInt:
+            case NumberLong:
+                return LeafKind::kIntegralComparison;
+            case String:
+                return LeafKind::kStringComparison;
+            default:
+                break;
+        }
+    }
+
+    return LeafKind::kSingleElement;
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    if (_groups.empty()) {
+        return _root->matchesBSON(doc);
+    }
+
+    // Resolve the field of each group with a single pass over the document. Only the first
+    // occurrence of a field name counts, as it would for BSONObj::getField().
+    const uint64_t allSeen = _groups.size() == kMaxGroups ? ~uint64_t(0)
+                                                          : (uint64_t(1) << _groups.size()) - 1;
+    uint64_t seen = 0;
+    BSONObjIterator it(doc);
+    while (seen != allSeen && it.more()) {
+        const BSONElement elem = it.next();
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < _groups.size(); ++i) {
+            const uint64_t bit = uint64_t(1) << i;
+            if ((seen & bit) || _groups[i].fieldName != fieldName) {
+                continue;
+            }
+            if (!groupMatches(_groups[i], elem)) {
+                return false;
+            }
+            seen |= bit;
+            break;
+        }
+    }
+
+    // Groups whose field is missing are matched against an EOO element.
+    for (size_t i = 0; seen != allSeen && i < _groups.size(); ++i) {
+        if (!(seen & (uint64_t(1) << i)) && !groupMatches(_groups[i], BSONElement())) {
+            return false;
+        }
+    }
+
+    for (auto&& expr : _residual) {
+        if (!expr->matchesBSON(doc)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// static
+bool CompiledMatchExpression::groupMatches(const FieldGroup& group, BSONElement elem) {
+    for (auto&& leaf : group.leaves) {
+        if (!leafMatches(leaf, elem)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// static
+bool CompiledMatchExpression::leafMatches(const Leaf& leaf, BSONElement elem) {
+    switch (leaf.kind) {
+        case LeafKind::kLogical:
+            return logicalMatches(leaf, elem);
+        case LeafKind::kObjectMatch:
+            // The path does not traverse arrays, so only an embedded object can match.
+            return Object == elem.type() && leaf.subobject->matchesBSON(elem.embeddedObject());
+        default:
+            break;
+    }
+
+    // Arrays and missing fields are subject to the full path traversal rules.
+    if (LeafKind::kPath == leaf.kind || elem.eoo() || Array == elem.type()) {
+        return leaf.expr->matchesBSONElement(elem);
+    }
+
+    switch (leaf.kind) {
+        case LeafKind::kIntegralComparison:
+            if (NumberInt == elem.type() || NumberLong == elem.type()) {
+                auto cmp = static_cast<const ComparisonMatchExpression*>(leaf.expr);
+                const long long lhs = elem.numberLong();
+                const long long rhs = cmp->getData().numberLong();
+                return comparisonResult(cmp->matchType(), lhs < rhs ? -1 : (lhs > rhs ? 1 : 0));
+            }
+            break;
+        case LeafKind::kStringComparison:
+            if (String == elem.type()) {
+                auto cmp = static_cast<const ComparisonMatchExpression*>(leaf.expr);
+                if (!cmp->getCollator()) {
+                    return comparisonResult(
+                        cmp->matchType(),
+                        elem.valueStringData().compare(cmp->getData().valueStringData()));
+                }
+            }
+            break;
+        default:
+            break;
+    }
+
+    return leaf.expr->matchesSingleElement(elem);
+}
+
+// static
+bool CompiledMatchExpression::logicalMatches(const Leaf& leaf, BSONElement elem) {
+    switch (leaf.expr->matchType()) {
+        case MatchExpression::AND:
+            for (auto&& child : leaf.children) {
+                if (!leafMatches(child, elem)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::OR:
+            for (auto&& child : leaf.children) {
+                if (leafMatches(child, elem)) {
+                    return true;
+                }
+            }
+            return false;
+        case MatchExpression::NOR:
+            for (auto&& child : leaf.children) {
+                if (leafMatches(child, elem)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::NOT:
+            return !leafMatches(leaf.children[0], elem);
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace mongo
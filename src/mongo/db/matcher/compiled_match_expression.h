@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class MatchExpression;
+
+/**
+ * A form of a MatchExpression tree that is cheaper to evaluate against BSON documents.
+ *
+ * Evaluating a MatchExpression resolves the path of every leaf through a fresh ElementIterator
+ * for every document. When the tree is a conjunction of path expressions, compilation instead
+ * groups the path expressions by the first component of their paths so that one pass over the
+ * document's top-level fields locates the element every group needs. Simple comparisons over
+ * top-level fields are then dispatched against that element directly, with specialized code for
+ * integral and (non-collated) string operands. Anything that cannot be compiled is evaluated
+ * through the MatchExpression itself, so the result is always the same as
+ * MatchExpression::matchesBSON().
+ *
+ * Nested $and nodes under the root are flattened, and a logical subtree whose paths all start with
+ * the same field joins that field's group and is evaluated node by node against its element. This
+ * is the shape of a translated $jsonSchema, where each property is checked by a subtree such as
+ * {$or: [{$not: {p: {$exists: true}}}, ...]}. The subschema of a non-dotted
+ * $_internalSchemaObjectMatch is compiled in turn and run over the embedded object, so a validator
+ * with nested object schemas still reads every level of the document once.
+ *
+ * The compiled form holds pointers into the tree it was compiled from, which must outlive it and
+ * must not be restructured while it is in use.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    explicit CompiledMatchExpression(const MatchExpression* root);
+
+    /**
+     * Returns true if 'doc' satisfies the expression this was compiled from.
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+    /**
+     * Returns true if any part of the expression was compiled, i.e. if matchesBSON() does anything
+     * other than delegate to the original tree.
+     */
+    bool isCompiled() const {
+        return !_groups.empty();
+    }
+
+private:
+    // Compiling more groups than can be tracked with one bit each is not worthwhile.
+    static const size_t kMaxGroups = 64;
+
+    enum class LeafKind {
+        // Evaluated against the element at the group's field through matchesBSONElement().
+        kPath,
+        // A non-dotted path which traverses arrays. Non-array elements are passed to
+        // matchesSingleElement() directly.
+        kSingleElement,
+        // As kSingleElement, but a comparison against a NumberInt or NumberLong operand.
+        kIntegralComparison,
+        // As kSingleElement, but a comparison against a String operand.
+        kStringComparison,
+        // An $and, $or, $nor or $not whose children are compiled leaves of the same group.
+        kLogical,
+        // A non-dotted $_internalSchemaObjectMatch, whose subschema is compiled separately.
+        kObjectMatch,
+    };
+
+    struct Leaf {
+        const MatchExpression* expr;
+        LeafKind kind;
+
+        // The compiled children of a kLogical leaf.
+        std::vector<Leaf> children;
+
+        // The compiled subschema of a kObjectMatch leaf.
+        std::unique_ptr<CompiledMatchExpression> subobject;
+    };
+
+    struct FieldGroup {
+        StringData fieldName;
+        std::vector<Leaf> leaves;
+    };
+
+    /**
+     * Adds the children of the $and 'expr' to their groups, descending into nested $and nodes.
+     * Children which cannot be compiled are added to '_residual'.
+     */
+    void addConjuncts(const MatchExpression* expr);
+
+    /**
+     * Adds 'expr' to the group for the first component of its paths. Returns false if 'expr'
+     * cannot be compiled.
+     */
+    bool addLeaf(const MatchExpression* expr);
+
+    /**
+     * Returns true if every path read by 'expr' starts with the same field, in which case that
+     * field is stored in 'fieldName'. Leaves 'fieldName' unset if 'expr' reads no paths at all.
+     */
+    static bool collectFieldName(const MatchExpression* expr,
+                                 boost::optional<StringData>* fieldName);
+
+    static Leaf compileLeaf(const MatchExpression* expr);
+
+    static LeafKind leafKind(const MatchExpression* expr);
+
+    /**
+     * Returns true if 'elem', the top-level field of the document under test named by the group's
+     * field, satisfies every leaf in 'group'. 'elem' is EOO if the field is missing.
+     */
+    static bool groupMatches(const FieldGroup& group, BSONElement elem);
+
+    static bool leafMatches(const Leaf& leaf, BSONElement elem);
+
+    static bool logicalMatches(const Leaf& leaf, BSONElement elem);
+
+    const MatchExpression* _root;
+
+    std::vector<FieldGroup> _groups;
+
+    // Conjuncts of a rooted $and which were not compiled and are evaluated on their own.
+    std::vector<const MatchExpression*> _residual;
+};
+
+}  // namespace mongo
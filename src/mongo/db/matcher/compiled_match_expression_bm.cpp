@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+namespace {
+
+const char* const kFilters[] = {
+    // A single equality.
+    "{c: 7}",
+    // A range over one field.
+    "{c: {$gte: 5, $lt: 9}}",
+    // Conjunction over several top-level fields of different types.
+    "{a: {$gt: 10}, s: 'str7', c: {$lte: 8}, f: {$lt: 0.5}}",
+    // Conjunction over dotted paths sharing a prefix.
+    "{'sub.x': {$gt: 3}, 'sub.y': 'y', c: {$exists: true}}",
+    // A collection validator with a nested object schema and optional properties which are
+    // absent from every document, as is typical of real-world schemas.
+    "{$jsonSchema: {bsonType: 'object', required: ['_id', 'a', 'c', 'sub'], properties: {"
+    "    _id: {bsonType: 'int'},"
+    "    a: {bsonType: 'int', minimum: 0},"
+    "    b: {bsonType: 'string', maxLength: 64},"
+    "    c: {bsonType: 'int', minimum: 0, maximum: 9},"
+    "    d: {bsonType: 'array', maxItems: 10, items: {bsonType: 'int'}},"
+    "    f: {bsonType: 'double', minimum: 0, maximum: 1},"
+    "    s: {bsonType: 'string', pattern: '^str'},"
+    "    sub: {bsonType: 'object', required: ['x'], properties: {"
+    "        x: {bsonType: 'int'},"
+    "        y: {enum: ['x', 'y', 'z']},"
+    "        w: {bsonType: 'string'}}},"
+    "    z: {bsonType: 'bool'},"
+    "    created: {bsonType: 'date'},"
+    "    updated: {bsonType: 'date'},"
+    "    owner: {bsonType: 'string', minLength: 1},"
+    "    tags: {bsonType: 'array', uniqueItems: true},"
+    "    status: {enum: ['new', 'active', 'closed']},"
+    "    score: {bsonType: 'number', minimum: 0},"
+    "    notes: {bsonType: 'string'},"
+    "    meta: {bsonType: 'object'}}}}",
+};
+
+BSONObj makeDoc(int i) {
+    BSONObjBuilder bob;
+    bob.append("_id", i);
+    bob.append("a", i);
+    bob.append("b", "some string");
+    bob.append("c", i % 10);
+    bob.append("d", BSON_ARRAY(1 << 2 << 3));
+    bob.append("f", (i % 100) / 100.0);
+    bob.append("s", "str" + std::to_string(i % 10));
+    bob.append("sub", BSON("x" << i % 7 << "y" << "y"));
+    bob.append("z", true);
+    return bob.obj();
+}
+
+std::vector<BSONObj> makeDocs() {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 1000; ++i) {
+        docs.push_back(makeDoc(i));
+    }
+    return docs;
+}
+
+std::unique_ptr<MatchExpression> parseFilter(int filterIndex) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto result = MatchExpressionParser::parse(fromjson(kFilters[filterIndex]), expCtx);
+    invariant(result.isOK());
+    return std::move(result.getValue());
+}
+
+void BM_matchesBSON(benchmark::State& state) {
+    auto expr = parseFilter(state.range(0));
+    const auto docs = makeDocs();
+    size_t numMatched = 0;
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            numMatched += expr->matchesBSON(doc);
+        }
+    }
+    benchmark::DoNotOptimize(numMatched);
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_compiledMatchesBSON(benchmark::State& state) {
+    auto expr = parseFilter(state.range(0));
+    CompiledMatchExpression compiled(expr.get());
+    const auto docs = makeDocs();
+    size_t numMatched = 0;
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            numMatched += compiled.matchesBSON(doc);
+        }
+    }
+    benchmark::DoNotOptimize(numMatched);
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+BENCHMARK(BM_matchesBSON)->DenseRange(0, 4);
+BENCHMARK(BM_compiledMatchesBSON)->DenseRange(0, 4);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& query,
+                                       const CollatorInterface* collator = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(collator);
+    auto result = MatchExpressionParser::parse(query, expCtx);
+    ASSERT_OK(result.getStatus());
+    return std::move(result.getValue());
+}
+
+/**
+ * Asserts that compiling 'query' gives the same result as the original tree for every document in
+ * 'docs', and returns the number of documents that matched.
+ */
+size_t assertCompiledMatchesSame(const BSONObj& query,
+                                 const std::vector<BSONObj>& docs,
+                                 const CollatorInterface* collator = nullptr) {
+    auto expr = parse(query, collator);
+    CompiledMatchExpression compiled(expr.get());
+    size_t numMatched = 0;
+    for (auto&& doc : docs) {
+        const bool expected = expr->matchesBSON(doc);
+        ASSERT_EQ(expected, compiled.matchesBSON(doc)) << "query: " << query << ", doc: " << doc;
+        numMatched += expected;
+    }
+    return numMatched;
+}
+
+const std::vector<BSONObj> kDocs = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 5, b: 'x'}"),
+    fromjson("{a: 5.5, b: 'y'}"),
+    fromjson("{a: NumberLong(5), b: 'X'}"),
+    fromjson("{a: [1, 5, 9], b: ['x', 'y']}"),
+    fromjson("{a: [[5]], b: null}"),
+    fromjson("{a: null, b: 'abc'}"),
+    fromjson("{a: NaN}"),
+    fromjson("{a: '5'}"),
+    fromjson("{a: {b: 5, c: 1}}"),
+    fromjson("{a: [{b: 5}, {b: 6}], c: 1}"),
+    fromjson("{a: {b: [4, 5]}, c: 2}"),
+    fromjson("{b: 1, a: 2, a: 5}"),
+    fromjson("{c: {$minKey: 1}, a: {$maxKey: 1}}"),
+    fromjson("{a: {b: {c: 3}}, d: true}"),
+};
+
+TEST(CompiledMatchExpressionTest, ComparisonsOnTopLevelFields) {
+    ASSERT_EQ(3U, assertCompiledMatchesSame(fromjson("{a: 5}"), kDocs));
+    assertCompiledMatchesSame(fromjson("{a: {$gt: 1}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$lte: 5}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$gte: 5, $lt: 9}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$lt: 5.5}, b: {$gte: 'x'}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{b: 'x'}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{b: {$lt: 'y'}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: null}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: NaN}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$gt: {$minKey: 1}}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: [5]}"), kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, DottedPathsAndArrays) {
+    assertCompiledMatchesSame(fromjson("{'a.b': 5}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{'a.b': 5, 'a.c': 1}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{'a.b': {$gt: 4}, c: {$exists: true}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{'a.b.c': 3, d: true}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{'a.1': 5}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$size: 3}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$elemMatch: {b: 6}}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$in: [1, 9]}, b: {$type: 'string'}}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$exists: false}}"), kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, NonPathChildrenAreEvaluatedSeparately) {
+    assertCompiledMatchesSame(fromjson("{a: 5, $or: [{b: 'x'}, {b: 'X'}]}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{a: {$not: {$gt: 2}}, c: 1}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{$nor: [{a: 1}, {b: 'x'}]}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{$and: []}"), kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, StringComparisonsRespectCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    ASSERT_EQ(3U, assertCompiledMatchesSame(fromjson("{b: 'x'}"), kDocs, &collator));
+    assertCompiledMatchesSame(fromjson("{b: {$gte: 'X'}}"), kDocs, &collator);
+}
+
+TEST(CompiledMatchExpressionTest, OnlyCompilesPathExpressions) {
+    auto expr = parse(fromjson("{a: 1, b: {$gt: 2}}"));
+    ASSERT_TRUE(CompiledMatchExpression(expr.get()).isCompiled());
+
+    expr = parse(fromjson("{$or: [{a: 1}, {b: 2}]}"));
+    ASSERT_FALSE(CompiledMatchExpression(expr.get()).isCompiled());
+}
+
+TEST(CompiledMatchExpressionTest, LogicalSubtreesOverOneField) {
+    assertCompiledMatchesSame(fromjson("{$or: [{a: 1}, {a: {$gt: 5}}]}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{$or: [{a: {$exists: false}}, {a: {$type: 'array'}}]}"),
+                              kDocs);
+    assertCompiledMatchesSame(fromjson("{$and: [{$nor: [{a: 5}, {'a.b': 5}]}, {b: 'x'}]}"), kDocs);
+    assertCompiledMatchesSame(fromjson("{$and: [{$and: [{a: {$gte: 5}}, {b: {$ne: 'y'}}]}]}"),
+                              kDocs);
+    assertCompiledMatchesSame(fromjson("{$or: [{a: 1}, {$alwaysFalse: 1}], b: {$exists: true}}"),
+                              kDocs);
+
+    auto expr = parse(fromjson("{$or: [{a: 1}, {a: {$gt: 5}}]}"));
+    ASSERT_TRUE(CompiledMatchExpression(expr.get()).isCompiled());
+}
+
+TEST(CompiledMatchExpressionTest, JSONSchemaValidators) {
+    const std::vector<BSONObj> docs = {
+        fromjson("{}"),
+        fromjson("{a: 1, b: 'x'}"),
+        fromjson("{a: 1, b: 'x', c: {d: 5, e: 'abc'}}"),
+        fromjson("{a: 1, b: 'x', c: {d: 50, e: 'abc'}}"),
+        fromjson("{a: 1, b: 'x', c: {d: 5}}"),
+        fromjson("{a: 1, b: 'x', c: {e: 'abcdef'}}"),
+        fromjson("{a: 1, b: 'x', c: [{d: 5, e: 'abc'}]}"),
+        fromjson("{a: 1, b: 'x', c: 'not an object'}"),
+        fromjson("{a: 'str', b: 'x'}"),
+        fromjson("{a: [1, 2], b: 'x'}"),
+        fromjson("{a: 1, b: 2}"),
+        fromjson("{a: 1, b: 'x', a: 'str'}"),
+        fromjson("{a: 1, b: 'x', c: {d: 5, e: 'abc', d: 50}}"),
+        fromjson("{a: 1, b: 'x', c: {d: 5, e: 'abc', f: {g: 1}}}"),
+        fromjson("{a: 1, b: 'x', c: {d: 5, e: 'abc', f: {g: 'str'}}}"),
+        fromjson("{a: 1, b: 'x', c: {d: 5, e: 'abc', f: {g: 1}}, extra: true}"),
+        fromjson("{a: 1, b: 'x', 'c.d': 50}"),
+    };
+
+    const BSONObj schema = fromjson(
+        "{$jsonSchema: {required: ['a', 'b'], properties: {"
+        "    a: {bsonType: 'int', minimum: 0},"
+        "    b: {enum: ['x', 'y']},"
+        "    c: {bsonType: 'object', required: ['d'], properties: {"
+        "        d: {bsonType: 'number', maximum: 10},"
+        "        e: {type: 'string', maxLength: 4},"
+        "        f: {properties: {g: {bsonType: 'int'}}}}}}}}");
+    ASSERT_EQ(8U, assertCompiledMatchesSame(schema, docs));
+
+    auto expr = parse(schema);
+    ASSERT_TRUE(CompiledMatchExpression(expr.get()).isCompiled());
+
+    assertCompiledMatchesSame(
+        fromjson("{$jsonSchema: {properties: {a: {anyOf: [{type: 'string'}, {minimum: 1}]},"
+                 "                            c: {not: {required: ['d']}}}}}"),
+        docs);
+    assertCompiledMatchesSame(
+        fromjson("{$jsonSchema: {additionalProperties: false, properties: {"
+                 "    a: {}, b: {}, c: {additionalProperties: false, properties: {"
+                 "        d: {}, e: {}, f: {}}}}}}"),
+        docs);
+    assertCompiledMatchesSame(
+        fromjson("{$jsonSchema: {properties: {a: {bsonType: 'int'}}, minProperties: 3}}"), docs);
+    assertCompiledMatchesSame(
+        fromjson("{$jsonSchema: {properties: {c: {dependencies: {d: ['e']}}}}, b: 'x'}"), docs);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/db/matcher/expression_leaf.h"
 
+#include <algorithm>
 #include <cmath>
 #include <pcrecpp.h>
 
@@ -215,6 +216,31 @@ inline pcrecpp::RE_Options flags2options(const char* flags) {
     return options;
 }
 
+namespace {
+
+bool isASCII(StringData str) {
+    return std::all_of(
+        str.begin(), str.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+}
+
+char toLowerASCII(char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+bool containsIgnoringASCIICase(StringData haystack, StringData needle) {
+    if (needle.empty()) {
+        return true;
+    }
+    auto equalIgnoringCase = [](char left, char right) {
+        return toLowerASCII(left) == toLowerASCII(right);
+    };
+    const auto found = std::search(
+        haystack.begin(), haystack.end(), needle.begin(), needle.end(), equalIgnoringCase);
+    return found != haystack.end();
+}
+
+}  // namespace
+
 const std::set<char> RegexMatchExpression::kValidRegexFlags = {'i', 'm', 's', 'x'};
 constexpr size_t RegexMatchExpression::kMaxPatternSize;
 
@@ -246,6 +272,27 @@ void RegexMatchExpression::_init() {
     uassert(ErrorCodes::BadValue,
             "Regular expression options string cannot contain an embedded null byte",
             _flags.find('\0') == std::string::npos);
+
+    // A pattern of plain ASCII characters with none of the metacharacters from 'man pcrepattern'
+    // matches exactly the strings which contain it. The 'm' and 's' flags only change how '^', '$'
+    // and '.' behave, but with 'x' whitespace and '#' become syntax.
+    _isLiteral = isASCII(_regex) && _flags.find('x') == std::string::npos &&
+        _regex.find_first_of("\\^$.[]|()?*+{}") == std::string::npos;
+    _literalIgnoresCase = _flags.find('i') != std::string::npos;
+}
+
+bool RegexMatchExpression::_matchesLiteral(StringData str) const {
+    // PCRE matches non-ASCII letters such as the Kelvin sign caselessly against ASCII ones, and
+    // never matches a string which is not valid UTF-8. Those cases are left to the regex.
+    const pcrecpp::StringPiece data(str.rawData(), str.size());
+    if (_literalIgnoresCase) {
+        return isASCII(str) ? containsIgnoringASCIICase(str, _regex) : _re->PartialMatch(data);
+    }
+
+    if (str.find(_regex) == std::string::npos) {
+        return false;
+    }
+    return isASCII(str) || _re->PartialMatch(data);
 }
 
 RegexMatchExpression::~RegexMatchExpression() {}
@@ -266,6 +313,9 @@ bool RegexMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetai
             // String values stored in documents can contain embedded NUL bytes. We construct a
             // pcrecpp::StringPiece instance using the full length of the string to avoid truncating
             // 'data' early.
+            if (_isLiteral) {
+                return _matchesLiteral(StringData(e.valuestr(), e.valuestrsize() - 1));
+            }
             pcrecpp::StringPiece data(e.valuestr(), e.valuestrsize() - 1);
             return _re->PartialMatch(data);
         }
@@ -324,9 +324,20 @@ private:
 
     void _init();
 
+    /**
+     * Returns whether 'str' matches a pattern which is only a literal substring, without running
+     * the regex when the answer can be decided with a plain substring search.
+     */
+    bool _matchesLiteral(StringData str) const;
+
     std::string _regex;
     std::string _flags;
     std::unique_ptr<pcrecpp::RE> _re;
+
+    // Whether '_regex' is a substring to search for, possibly ignoring ASCII case, with no regex
+    // syntax in it.
+    bool _isLiteral = false;
+    bool _literalIgnoresCase = false;
 };
 
 class ModMatchExpression : public LeafMatchExpression {
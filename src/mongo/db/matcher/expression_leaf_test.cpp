@@ -753,6 +753,43 @@ TEST(RegexMatchExpression, MatchesElementCaseInsensitive) {
     ASSERT(!regex.matchesSingleElement(notMatch.firstElement()));
 }
 
+TEST(RegexMatchExpression, LiteralPatternMatchesSubstrings) {
+    RegexMatchExpression regex("", "b c", "");
+    ASSERT(regex.matchesSingleElement(BSON("x"
+                                           << "ab cd")
+                                          .firstElement()));
+    ASSERT(regex.matchesSingleElement(BSON("x"
+                                           << "\xc3\xa9b c")
+                                          .firstElement()));
+    ASSERT(!regex.matchesSingleElement(BSON("x"
+                                            << "ab  cd")
+                                           .firstElement()));
+    ASSERT(!regex.matchesSingleElement(BSON("x"
+                                            << "AB CD")
+                                           .firstElement()));
+}
+
+TEST(RegexMatchExpression, CaseInsensitiveLiteralPatternMatchesNonASCIIStrings) {
+    RegexMatchExpression regex("", "ok", "i");
+    ASSERT(regex.matchesSingleElement(BSON("x"
+                                           << "bOOKs")
+                                          .firstElement()));
+    // The Kelvin sign is caselessly equal to 'k'.
+    ASSERT(regex.matchesSingleElement(BSON("x"
+                                           << "bo\xe2\x84\xaa")
+                                          .firstElement()));
+    ASSERT(!regex.matchesSingleElement(BSON("x"
+                                            << "\xc3\xa9bo")
+                                           .firstElement()));
+}
+
+TEST(RegexMatchExpression, LiteralPatternDoesNotMatchInvalidUTF8) {
+    RegexMatchExpression regex("", "abc", "");
+    ASSERT(!regex.matchesSingleElement(BSON("x"
+                                            << "abc\xff")
+                                           .firstElement()));
+}
+
 TEST(RegexMatchExpression, MatchesElementMultilineOff) {
     BSONObj match = BSON("x"
                          << "az");
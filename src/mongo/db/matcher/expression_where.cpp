@@ -74,24 +74,37 @@ bool WhereMatchExpression::matches(const MatchableDocument* doc, MatchDetails* d
     uassert(28692, "$where compile error", _func);
     BSONObj obj = doc->toBSON();
 
-    if (!getScope().isEmpty()) {
-        _scope->init(&getScope());
-    }
-
-    _scope->advanceGeneration();
-    _scope->setObject("obj", const_cast<BSONObj&>(obj));
-    _scope->setBoolean("fullObject", true);  // this is a hack b/c fullObject used to be relevant
+    // Make all the calls for this document in one batch, as each call on its own would be a round
+    // trip to the thread running the JavaScript.
+    int err = 0;
+    std::string error;
+    bool returnValue = false;
+    _scope->runBatch([&](Scope& scope) {
+        if (!getScope().isEmpty()) {
+            scope.init(&getScope());
+        }
+
+        scope.advanceGeneration();
+        scope.setObject("obj", const_cast<BSONObj&>(obj));
+        scope.setBoolean("fullObject", true);  // this is a hack b/c fullObject used to be relevant
+
+        err = scope.invoke(_func, 0, &obj, 1000 * 60, false);
+        if (err == 0) {
+            returnValue = scope.getBoolean("__returnValue") != 0;
+        } else if (err == -3) {
+            error = scope.getError();
+        }
+    });
 
-    int err = _scope->invoke(_func, 0, &obj, 1000 * 60, false);
     if (err == -3) {  // INVOKE_ERROR
         stringstream ss;
-        ss << "error on invocation of $where function:\n" << _scope->getError();
+        ss << "error on invocation of $where function:\n" << error;
         uassert(16812, ss.str(), false);
     } else if (err != 0) {  // ! INVOKE_SUCCESS
         uassert(16813, "unknown error in invocation of $where function", false);
     }
 
-    return _scope->getBoolean("__returnValue") != 0;
+    return returnValue;
 }
 
 unique_ptr<MatchExpression> WhereMatchExpression::shallowClone() const {
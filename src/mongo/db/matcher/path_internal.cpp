@@ -30,6 +30,8 @@
 
 #include "mongo/db/matcher/path_internal.h"
 
+#include "mongo/bson/bsonobj_field_index.h"
+
 namespace mongo {
 
 bool isAllDigits(StringData str) {
@@ -53,7 +55,7 @@ BSONElement getFieldDottedOrArray(const BSONObj& doc,
     bool stop = false;
     size_t partNum = startIndex;
     while (partNum < path.numParts() && !stop) {
-        res = curr.getField(path.getPart(partNum));
+        res = BSONObjFieldIndex::lookup(curr, path.getPart(partNum));
 
         switch (res.type()) {
             case EOO:
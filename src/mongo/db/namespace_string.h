@@ -77,6 +77,9 @@ public:
     // Namespace for storing the transaction information for each session
     static const NamespaceString kSessionTransactionsTableNamespace;
 
+    // Namespace for storing the findAndModify images of retryable writes, one for each session
+    static const NamespaceString kConfigImagesNamespace;
+
     // Name for a shard's collections metadata collection, each document of which indicates the
     // state of a specific collection
     static const NamespaceString kShardConfigCollectionsNamespace;
@@ -30,6 +30,8 @@
 
 #include "mongo/db/op_observer_impl.h"
 
+#include <limits>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
@@ -51,15 +53,38 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/db/views/durable_view_catalog.h"
 #include "mongo/scripting/engine.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point_service.h"
 
 namespace mongo {
 using repl::OplogEntry;
+
+// Server parameter that limits the number of operations of a transaction which are written to a
+// single 'applyOps' oplog entry. Transactions which are not prepared and have more operations are
+// written as a chain of entries. Only meant to be lowered by tests.
+MONGO_EXPORT_SERVER_PARAMETER(maxNumberOfTransactionOperationsInSingleOplogEntry,
+                              int,
+                              std::numeric_limits<int>::max())
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "maxNumberOfTransactionOperationsInSingleOplogEntry must be greater than "
+                          "or equal to 1");
+        }
+
+        return Status::OK();
+    });
+
+// Server parameter which makes retryable findAndModify commands store the image of the document
+// which their retries return in the image collection, rather than in a no-op oplog entry.
+MONGO_EXPORT_SERVER_PARAMETER(storeFindAndModifyImagesInSideCollection, bool, false);
+
 namespace {
 
 MONGO_FAIL_POINT_DEFINE(failCollectionUpdates);
@@ -161,6 +186,35 @@ Date_t getWallClockTimeForOpLog(OperationContext* opCtx) {
     return clockSource->now();
 }
 
+/**
+ * Returns whether the image of a retryable findAndModify should be written to the image collection
+ * rather than to a no-op oplog entry.
+ */
+bool shouldStoreImageInSideCollection(OperationContext* opCtx, Session* session) {
+    return session && opCtx->writesAreReplicated() &&
+        storeFindAndModifyImagesInSideCollection.load();
+}
+
+/**
+ * Writes the image of the findAndModify logged at 'writeOpTime' to the image collection. Each
+ * session keeps only the image of its latest findAndModify, as only that one can be retried.
+ */
+void writeImageToSideCollection(OperationContext* opCtx,
+                                repl::RetryImageEnum imageKind,
+                                const BSONObj& image,
+                                const repl::OpTime& writeOpTime) {
+    if (writeOpTime.isNull()) {
+        return;
+    }
+
+    repl::ImageEntry imageEntry(*opCtx->getLogicalSessionId(),
+                                *opCtx->getTxnNumber(),
+                                writeOpTime.getTimestamp(),
+                                imageKind,
+                                image);
+    repl::writeRetryImageEntry(opCtx, imageEntry);
+}
+
 struct OpTimeBundle {
     repl::OpTime writeOpTime;
     repl::OpTime prePostImageOpTime;
@@ -195,7 +249,13 @@ OpTimeBundle replLogUpdate(OperationContext* opCtx,
     OpTimeBundle opTimes;
     opTimes.wallClockTime = getWallClockTimeForOpLog(opCtx);
 
-    if (!storeObj.isEmpty() && opCtx->getTxnNumber()) {
+    if (!storeObj.isEmpty() && opCtx->getTxnNumber() &&
+        shouldStoreImageInSideCollection(opCtx, session)) {
+        oplogLink.needsRetryImage =
+            args.updateArgs.storeDocOption == CollectionUpdateArgs::StoreDocOption::PreImage
+            ? repl::RetryImageEnum::kPreImage
+            : repl::RetryImageEnum::kPostImage;
+    } else if (!storeObj.isEmpty() && opCtx->getTxnNumber()) {
         auto noteUpdateOpTime = logOperation(opCtx,
                                              "n",
                                              args.nss,
@@ -234,6 +294,11 @@ OpTimeBundle replLogUpdate(OperationContext* opCtx,
                                        false /* prepare */,
                                        OplogSlot());
 
+    if (oplogLink.needsRetryImage) {
+        writeImageToSideCollection(
+            opCtx, *oplogLink.needsRetryImage, storeObj, opTimes.writeOpTime);
+    }
+
     return opTimes;
 }
 
@@ -261,7 +326,9 @@ OpTimeBundle replLogDelete(OperationContext* opCtx,
     OpTimeBundle opTimes;
     opTimes.wallClockTime = getWallClockTimeForOpLog(opCtx);
 
-    if (deletedDoc && opCtx->getTxnNumber()) {
+    if (deletedDoc && opCtx->getTxnNumber() && shouldStoreImageInSideCollection(opCtx, session)) {
+        oplogLink.needsRetryImage = repl::RetryImageEnum::kPreImage;
+    } else if (deletedDoc && opCtx->getTxnNumber()) {
         auto noteOplog = logOperation(opCtx,
                                       "n",
                                       nss,
@@ -293,6 +360,12 @@ OpTimeBundle replLogDelete(OperationContext* opCtx,
                                        oplogLink,
                                        false /* prepare */,
                                        OplogSlot());
+
+    if (oplogLink.needsRetryImage) {
+        writeImageToSideCollection(
+            opCtx, *oplogLink.needsRetryImage, *deletedDoc, opTimes.writeOpTime);
+    }
+
     return opTimes;
 }
 
@@ -922,17 +995,55 @@ void OpObserverImpl::onEmptyCapped(OperationContext* opCtx,
 
 namespace {
 
+/**
+ * Groups the operations of a transaction into the 'applyOps' arrays of the oplog entries which hold
+ * them. Each array holds at most 'maxNumberOfTransactionOperationsInSingleOplogEntry' operations
+ * and, unless a single operation is larger, at most BSONObjMaxUserSize bytes, which leaves room for
+ * the other fields of the oplog entry. A prepared transaction is always written as one entry.
+ */
+std::vector<BSONArray> packTransactionOperations(const std::vector<repl::ReplOperation>& stmts,
+                                                 bool prepare) {
+    const auto maxNumOps = maxNumberOfTransactionOperationsInSingleOplogEntry.load();
+
+    std::vector<BSONArray> applyOpsArrays;
+    std::unique_ptr<BSONArrayBuilder> opsArray;
+    int numOps = 0;
+    for (const auto& stmt : stmts) {
+        auto stmtBSON = stmt.toBSON();
+        if (opsArray && !prepare &&
+            (numOps >= maxNumOps || opsArray->len() + stmtBSON.objsize() > BSONObjMaxUserSize)) {
+            applyOpsArrays.push_back(opsArray->arr());
+            opsArray.reset();
+        }
+        if (!opsArray) {
+            opsArray = stdx::make_unique<BSONArrayBuilder>();
+            numOps = 0;
+        }
+        opsArray->append(stmtBSON);
+        ++numOps;
+    }
+    if (opsArray) {
+        applyOpsArrays.push_back(opsArray->arr());
+    }
+
+    // A prepared transaction without writes still writes an empty 'applyOps' entry.
+    if (applyOpsArrays.empty()) {
+        applyOpsArrays.push_back(BSONArray());
+    }
+    return applyOpsArrays;
+}
+
+/**
+ * Writes the operations of a transaction to the oplog. A transaction which does not fit in a
+ * single 'applyOps' entry is written as a chain of them, linked through 'prevOpTime', all within
+ * the storage transaction of the commit. Every entry but the last is marked as a partial
+ * transaction. Secondaries apply the operations of the whole chain when they reach its last
+ * entry, at its timestamp, and only the last entry updates the transactions table.
+ */
 OpTimeBundle logApplyOpsForTransaction(OperationContext* opCtx,
                                        Session* const session,
                                        std::vector<repl::ReplOperation> stmts,
                                        const OplogSlot& prepareOplogSlot) {
-    BSONObjBuilder applyOpsBuilder;
-    BSONArrayBuilder opsArray(applyOpsBuilder.subarrayStart("applyOps"_sd));
-    for (auto& stmt : stmts) {
-        opsArray.append(stmt.toBSON());
-    }
-    opsArray.done();
-
     const NamespaceString cmdNss{"admin", "$cmd"};
 
     OperationSessionInfo sessionInfo;
@@ -942,21 +1053,41 @@ OpTimeBundle logApplyOpsForTransaction(OperationContext* opCtx,
 
     const auto txnParticipant = TransactionParticipant::get(opCtx);
     oplogLink.prevOpTime = txnParticipant->getLastWriteOpTime(*opCtx->getTxnNumber());
-    // Until we support multiple oplog entries per transaction, prevOpTime should always be null.
+    // The chain of a transaction's entries starts at its first entry, so prevOpTime is null.
     invariant(oplogLink.prevOpTime.isNull());
 
     try {
         // We are only given an oplog slot for prepared transactions.
         auto prepare = !prepareOplogSlot.opTime.isNull();
-        if (prepare) {
-            // TODO: SERVER-36814 Remove "prepare" field on applyOps.
-            applyOpsBuilder.append("prepare", true);
-        }
-        auto applyOpCmd = applyOpsBuilder.done();
-        const StmtId stmtId(0);
+        const auto applyOpsArrays = packTransactionOperations(stmts, prepare);
+        invariant(!prepare || applyOpsArrays.size() == 1);
 
-        auto times = replLogApplyOps(
-            opCtx, cmdNss, applyOpCmd, sessionInfo, stmtId, oplogLink, prepare, prepareOplogSlot);
+        const StmtId stmtId(0);
+        OpTimeBundle times;
+        for (size_t i = 0; i < applyOpsArrays.size(); ++i) {
+            const bool isFinalEntry = i + 1 == applyOpsArrays.size();
+
+            BSONObjBuilder applyOpsBuilder;
+            applyOpsBuilder.append("applyOps"_sd, applyOpsArrays[i]);
+            if (prepare) {
+                // TODO: SERVER-36814 Remove "prepare" field on applyOps.
+                applyOpsBuilder.append("prepare", true);
+            }
+            if (!isFinalEntry) {
+                applyOpsBuilder.append(OplogEntry::kPartialTxnFieldName, true);
+            }
+            auto applyOpCmd = applyOpsBuilder.done();
+
+            times = replLogApplyOps(opCtx,
+                                    cmdNss,
+                                    applyOpCmd,
+                                    sessionInfo,
+                                    stmtId,
+                                    oplogLink,
+                                    prepare,
+                                    prepareOplogSlot);
+            oplogLink.prevOpTime = times.writeOpTime;
+        }
 
         auto txnState = prepare ? DurableTxnStateEnum::kPrepared : DurableTxnStateEnum::kCommitted;
         onWriteOpCompleted(
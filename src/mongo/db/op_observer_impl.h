@@ -29,9 +29,12 @@
 #pragma once
 
 #include "mongo/db/op_observer.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
+extern AtomicInt32 maxNumberOfTransactionOperationsInSingleOplogEntry;
+
 class OpObserverImpl : public OpObserver {
     MONGO_DISALLOW_COPYING(OpObserverImpl);
 
@@ -89,6 +89,18 @@ protected:
         return opEntry.first;
     }
 
+    // Assert that oplog has exactly 'n' entries and return them, oldest first.
+    std::vector<BSONObj> getNOplogEntries(OperationContext* opCtx, int n) {
+        repl::OplogInterfaceLocal oplogInterface(opCtx, NamespaceString::kRsOplogNamespace.ns());
+        auto oplogIter = oplogInterface.makeIterator();
+        std::vector<BSONObj> entries;
+        for (int i = 0; i < n; ++i) {
+            entries.insert(entries.begin(), unittest::assertGet(oplogIter->next()).first);
+        }
+        ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, oplogIter->next().getStatus());
+        return entries;
+    }
+
 private:
     // Creates a reasonable set of ReplSettings for most tests.  We need to be able to
     // override this to create a larger oplog.
@@ -400,16 +412,16 @@ class OpObserverLargeTransactionTest : public OpObserverSessionCatalogTest {
 private:
     repl::ReplSettings createReplSettings() override {
         repl::ReplSettings settings;
-        // We need an oplog comfortably large enough to hold an oplog entry that exceeds the BSON
-        // size limit.  Otherwise we will get the wrong error code when trying to write one.
-        settings.setOplogSizeBytes(BSONObjMaxInternalSize + 2 * 1024 * 1024);
+        // We need an oplog comfortably large enough to hold a transaction which is larger than
+        // the BSON size limit, written as more than one oplog entry.
+        settings.setOplogSizeBytes(2 * BSONObjMaxInternalSize + 2 * 1024 * 1024);
         settings.setReplSetString("mySet/node1:12345");
         return settings;
     }
 };
 
-// Tests that a transaction aborts if it becomes too large only during the commit.
-TEST_F(OpObserverLargeTransactionTest, TransactionTooLargeWhileCommitting) {
+// Tests that a transaction too large for a single oplog entry is written as a chain of entries.
+TEST_F(OpObserverLargeTransactionTest, TransactionLargerThanOplogEntryIsChained) {
     OpObserverImpl opObserver;
     auto opCtx = cc().makeOperationContext();
     const NamespaceString nss("testDB", "testColl");
@@ -442,9 +454,17 @@ TEST_F(OpObserverLargeTransactionTest, TransactionTooLargeWhileCommitting) {
                   << BSONBinData(halfTransactionData.get(), kHalfTransactionSize, BinDataGeneral)));
     txnParticipant->addTransactionOperation(opCtx.get(), operation);
     txnParticipant->addTransactionOperation(opCtx.get(), operation);
-    ASSERT_THROWS_CODE(opObserver.onTransactionCommit(opCtx.get(), boost::none, boost::none),
-                       AssertionException,
-                       ErrorCodes::TransactionTooLarge);
+    opObserver.onTransactionCommit(opCtx.get(), boost::none, boost::none);
+
+    auto oplogEntries = getNOplogEntries(opCtx.get(), 2);
+    auto firstEntry = assertGet(OplogEntry::parse(oplogEntries[0]));
+    auto finalEntry = assertGet(OplogEntry::parse(oplogEntries[1]));
+    ASSERT(firstEntry.isPartialTransaction());
+    ASSERT_EQ(repl::OpTime(), *firstEntry.getPrevWriteOpTimeInTransaction());
+    ASSERT_EQ(1, firstEntry.getObject()["applyOps"].Obj().nFields());
+    ASSERT_FALSE(finalEntry.isPartialTransaction());
+    ASSERT_EQ(firstEntry.getOpTime(), *finalEntry.getPrevWriteOpTimeInTransaction());
+    ASSERT_EQ(1, finalEntry.getObject()["applyOps"].Obj().nFields());
 }
 
 TEST_F(OpObserverTest, OnRollbackInvalidatesAuthCacheWhenAuthNamespaceRolledBack) {
@@ -1116,6 +1136,52 @@ TEST_F(OpObserverTransactionTest, TransactionalInsertTest) {
     ASSERT_FALSE(oplogEntryObj.hasField("prepare"));
 }
 
+TEST_F(OpObserverTransactionTest, TransactionWithMoreOperationsThanEntryLimitIsChained) {
+    const NamespaceString nss("testDB", "testColl");
+    auto uuid = CollectionUUID::gen();
+    const TxnNumber txnNum = 2;
+    opCtx()->setTxnNumber(txnNum);
+
+    const auto originalMaxNumOps = maxNumberOfTransactionOperationsInSingleOplogEntry.load();
+    maxNumberOfTransactionOperationsInSingleOplogEntry.store(2);
+    ON_BLOCK_EXIT(
+        [&] { maxNumberOfTransactionOperationsInSingleOplogEntry.store(originalMaxNumOps); });
+
+    OperationContextSessionMongod opSession(opCtx(), true, false, true);
+    auto txnParticipant = TransactionParticipant::get(opCtx());
+    txnParticipant->unstashTransactionResources(opCtx(), "insert");
+
+    std::vector<InsertStatement> inserts;
+    for (int i = 0; i < 5; ++i) {
+        inserts.emplace_back(i, BSON("_id" << i));
+    }
+    {
+        AutoGetCollection autoColl(opCtx(), nss, MODE_IX);
+        opObserver().onInserts(opCtx(), nss, uuid, inserts.begin(), inserts.end(), false);
+    }
+    opObserver().onTransactionCommit(opCtx(), boost::none, boost::none);
+
+    // The entries are linked from the last to the first, and each holds at most two operations.
+    auto oplogEntryObjs = getNOplogEntries(opCtx(), 3);
+    repl::OpTime prevOpTime;
+    int nextId = 0;
+    for (size_t i = 0; i < oplogEntryObjs.size(); ++i) {
+        checkCommonFields(oplogEntryObjs[i]);
+        auto oplogEntry = assertGet(OplogEntry::parse(oplogEntryObjs[i]));
+        ASSERT_EQ(i + 1 < oplogEntryObjs.size(), oplogEntry.isPartialTransaction());
+        ASSERT_EQ(prevOpTime, *oplogEntry.getPrevWriteOpTimeInTransaction());
+        prevOpTime = oplogEntry.getOpTime();
+
+        for (auto&& op : oplogEntry.getObject()["applyOps"].Obj()) {
+            ASSERT_BSONOBJ_EQ(BSON("_id" << nextId++), op.Obj()["o"].Obj());
+        }
+    }
+    ASSERT_EQ(5, nextId);
+
+    opCtx()->getWriteUnitOfWork()->commit();
+    assertTxnRecord(txnNum, prevOpTime, DurableTxnStateEnum::kCommitted);
+}
+
 TEST_F(OpObserverTransactionTest, TransactionalUpdateTest) {
     const NamespaceString nss1("testDB", "testColl");
     const NamespaceString nss2("testDB2", "testColl2");
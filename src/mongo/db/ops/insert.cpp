@@ -147,6 +147,25 @@ StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj&
     if (firstElementIsId && !hasTimestampToFix)
         return StatusWith<BSONObj>(BSONObj());
 
+    if (!hasTimestampToFix) {
+        // Only the _id needs to move to the front, or to be generated. The rest of the document is
+        // copied as whole runs of bytes rather than element by element.
+        BSONObjBuilder b(doc.objsize() + 16);
+        const char* const bodyStart = doc.objdata() + sizeof(int);
+        const char* const bodyEnd = doc.objdata() + doc.objsize() - 1;  // Excludes the EOO.
+
+        BSONElement id = doc["_id"];
+        if (id.type()) {
+            b.append(id);
+            b.bb().appendBuf(bodyStart, id.rawdata() - bodyStart);
+            b.bb().appendBuf(id.rawdata() + id.size(), bodyEnd - (id.rawdata() + id.size()));
+        } else {
+            b.appendOID("_id", NULL, true);
+            b.bb().appendBuf(bodyStart, bodyEnd - bodyStart);
+        }
+        return StatusWith<BSONObj>(b.obj());
+    }
+
     BSONObjIterator i(doc);
 
     BSONObjBuilder b(doc.objsize() + 16);
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ops/insert_group_commit.h"
+
+#include <algorithm>
+
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+
+namespace mongo {
+namespace {
+
+const auto getInsertGroupCommitter = ServiceContext::declareDecoration<InsertGroupCommitter>();
+
+// How long the leader of a group of inserts waits for other inserts to join it. Grouping is
+// disabled when 0.
+MONGO_EXPORT_SERVER_PARAMETER(insertGroupCommitWindowMicros, int, 0)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 0 || potentialNewValue > 100 * 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "insertGroupCommitWindowMicros must be between 0 and 100000");
+        }
+
+        return Status::OK();
+    });
+
+}  // namespace
+
+struct InsertGroupCommitter::Group {
+    std::vector<InsertStatement> stmts;
+
+    // Signalled when the group is full, and when it has been inserted.
+    stdx::condition_variable cv;
+
+    // Set once the leader has stopped waiting for inserts to join. From then on the statements
+    // belong to the leader, so an insert which joined can no longer withdraw.
+    bool inserting = false;
+    bool done = false;
+    Status status = Status::OK();
+};
+
+InsertGroupCommitter::InsertGroupCommitter() = default;
+
+InsertGroupCommitter::~InsertGroupCommitter() = default;
+
+InsertGroupCommitter* InsertGroupCommitter::get(ServiceContext* serviceContext) {
+    return &getInsertGroupCommitter(serviceContext);
+}
+
+InsertGroupCommitter* InsertGroupCommitter::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool InsertGroupCommitter::isEnabled() {
+    return insertGroupCommitWindowMicros.load() > 0;
+}
+
+Status InsertGroupCommitter::insert(OperationContext* opCtx,
+                                    const NamespaceString& nss,
+                                    InsertStatement stmt,
+                                    const InsertGroupFn& insertGroup) {
+    const size_t maxGroupSize = std::max(1, internalInsertMaxBatchSize.load());
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto& openGroup = _openGroups[nss.ns()];
+
+    if (openGroup && openGroup->stmts.size() < maxGroupSize) {
+        // Join the open group, and wait for its leader to insert it.
+        const auto group = openGroup;
+        const char* const joinedDoc = stmt.doc.objdata();
+        group->stmts.push_back(std::move(stmt));
+        if (group->stmts.size() == maxGroupSize) {
+            group->cv.notify_all();
+        }
+
+        try {
+            opCtx->waitForConditionOrInterrupt(group->cv, lk, [&] { return group->done; });
+        } catch (const DBException&) {
+            if (!group->inserting) {
+                // The leader hasn't taken the statements yet, so withdraw the document.
+                auto& stmts = group->stmts;
+                stmts.erase(std::find_if(stmts.begin(), stmts.end(), [&](const auto& s) {
+                    return s.doc.objdata() == joinedDoc;
+                }));
+                throw;
+            }
+
+            // The leader may already be inserting this document, so report its outcome.
+            group->cv.wait(lk, [&] { return group->done; });
+        }
+        return group->status;
+    }
+
+    // Lead a new group, which replaces any full group as the one that later inserts join.
+    const auto group = std::make_shared<Group>();
+    group->stmts.push_back(std::move(stmt));
+    openGroup = group;
+
+    group->cv.wait_for(lk,
+                       Microseconds(insertGroupCommitWindowMicros.load()).toSystemDuration(),
+                       [&] { return group->stmts.size() >= maxGroupSize; });
+
+    auto it = _openGroups.find(nss.ns());
+    if (it != _openGroups.end() && it->second == group) {
+        _openGroups.erase(it);
+    }
+    group->inserting = true;
+    lk.unlock();
+
+    Status status = Status::OK();
+    try {
+        status = insertGroup(opCtx, &group->stmts);
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    lk.lock();
+    group->status = status;
+    group->done = true;
+    group->cv.notify_all();
+    return status;
+}
+
+}  // namespace mongo
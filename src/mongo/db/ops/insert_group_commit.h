@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class NamespaceString;
+class OperationContext;
+class ServiceContext;
+struct InsertStatement;
+
+/**
+ * Merges single-document inserts which concurrent operations make into the same collection into
+ * one insert, so that they share one WriteUnitOfWork, one acquisition of the collection lock and
+ * one reservation of a contiguous range of oplog slots.
+ *
+ * The first operation to insert into a collection becomes the leader of a group. It waits for
+ * 'insertGroupCommitWindowMicros' for other operations to join the group, and then inserts the
+ * documents of the whole group on their behalf while they wait.
+ */
+class InsertGroupCommitter {
+    MONGO_DISALLOW_COPYING(InsertGroupCommitter);
+
+public:
+    /**
+     * Inserts the documents of a group, all in the same collection. Runs on the operation of the
+     * group's leader.
+     */
+    using InsertGroupFn =
+        stdx::function<Status(OperationContext* opCtx, std::vector<InsertStatement>* group)>;
+
+    InsertGroupCommitter();
+    ~InsertGroupCommitter();
+
+    static InsertGroupCommitter* get(ServiceContext* serviceContext);
+    static InsertGroupCommitter* get(OperationContext* opCtx);
+
+    /**
+     * Returns whether inserts are to be grouped, which is when 'insertGroupCommitWindowMicros' is
+     * set.
+     */
+    static bool isEnabled();
+
+    /**
+     * Inserts 'stmt' into 'nss' together with the inserts into 'nss' which other operations start
+     * meanwhile. Returns the status of inserting the whole group with 'insertGroup'. As that
+     * inserts either all or none of the documents, the caller must insert its document on its own
+     * if it fails.
+     *
+     * Throws if 'opCtx' is interrupted while waiting for the leader of its group, unless the
+     * leader has already started inserting the group.
+     */
+    Status insert(OperationContext* opCtx,
+                  const NamespaceString& nss,
+                  InsertStatement stmt,
+                  const InsertGroupFn& insertGroup);
+
+private:
+    struct Group;
+
+    stdx::mutex _mutex;
+
+    // The group which inserts into each collection are to join, by namespace.
+    StringMap<std::shared_ptr<Group>> _openGroups;
+};
+
+}  // namespace mongo
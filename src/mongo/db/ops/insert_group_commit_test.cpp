@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <numeric>
+
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/ops/insert_group_commit.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+
+class InsertGroupCommitTest : public ServiceContextTest {
+public:
+    void setUp() final {
+        setParameter("insertGroupCommitWindowMicros", 100 * 1000);
+        setParameter("internalInsertMaxBatchSize", 3);
+    }
+
+    void tearDown() final {
+        setParameter("insertGroupCommitWindowMicros", 0);
+        setParameter("internalInsertMaxBatchSize", 64);
+    }
+
+    void setParameter(StringData name, int value) {
+        auto param = ServerParameterSet::getGlobal()->getMap().find(name.toString());
+        ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+        ASSERT_OK(param->second->setFromString(std::to_string(value)));
+    }
+
+    /**
+     * Inserts the documents {_id: 0} to {_id: numInserts - 1} from concurrent threads, and returns
+     * the status each insert reported. Records the documents of each inserted group.
+     */
+    std::vector<Status> insertConcurrently(int numInserts, Status groupStatus) {
+        std::vector<Status> statuses(numInserts, Status::OK());
+        std::vector<stdx::thread> threads;
+        for (int i = 0; i < numInserts; ++i) {
+            threads.emplace_back([&, i] {
+                auto client = getServiceContext()->makeClient("insert" + std::to_string(i));
+                auto opCtx = client->makeOperationContext();
+                statuses[i] = insert(opCtx.get(), i, groupStatus);
+            });
+        }
+
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+        return statuses;
+    }
+
+    /**
+     * Inserts the document {_id: id} through the group committer, recording the documents of the
+     * group it is inserted in.
+     */
+    Status insert(OperationContext* opCtx, int id, Status groupStatus) {
+        return _committer.insert(
+            opCtx,
+            kNss,
+            InsertStatement(BSON("_id" << id)),
+            [&](OperationContext*, std::vector<InsertStatement>* group) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                std::vector<int> ids;
+                for (auto&& stmt : *group) {
+                    ids.push_back(stmt.doc["_id"].numberInt());
+                }
+                _groups.push_back(ids);
+                return groupStatus;
+            });
+    }
+
+protected:
+    InsertGroupCommitter _committer;
+
+    stdx::mutex _mutex;
+    std::vector<std::vector<int>> _groups;
+};
+
+TEST_F(InsertGroupCommitTest, EachDocumentIsInsertedInExactlyOneGroup) {
+    const auto statuses = insertConcurrently(9, Status::OK());
+    for (auto&& status : statuses) {
+        ASSERT_OK(status);
+    }
+
+    std::vector<int> insertedIds;
+    for (auto&& group : _groups) {
+        ASSERT_GTE(group.size(), 1U);
+        ASSERT_LTE(group.size(), 3U);
+        insertedIds.insert(insertedIds.end(), group.begin(), group.end());
+    }
+
+    std::sort(insertedIds.begin(), insertedIds.end());
+    std::vector<int> expectedIds(9);
+    std::iota(expectedIds.begin(), expectedIds.end(), 0);
+    ASSERT(insertedIds == expectedIds);
+}
+
+TEST_F(InsertGroupCommitTest, FailureOfGroupIsReportedToEachInsertOfIt) {
+    const Status failure(ErrorCodes::DuplicateKey, "duplicate key");
+    const auto statuses = insertConcurrently(4, failure);
+    for (auto&& status : statuses) {
+        ASSERT_EQ(ErrorCodes::DuplicateKey, status);
+    }
+}
+
+TEST_F(InsertGroupCommitTest, InterruptedInsertWithdrawsFromOpenGroup) {
+    stdx::thread leader([&] {
+        auto client = getServiceContext()->makeClient("leader");
+        auto opCtx = client->makeOperationContext();
+        ASSERT_OK(insert(opCtx.get(), 0, Status::OK()));
+    });
+
+    // Give the leader time to open its group, which stays open for 100ms.
+    sleepmillis(10);
+
+    auto opCtx = makeOperationContext();
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        opCtx->markKilled();
+    }
+    ASSERT_THROWS_CODE(insert(opCtx.get(), 1, Status::OK()), DBException, ErrorCodes::Interrupted);
+
+    leader.join();
+    ASSERT_EQ(1U, _groups.size());
+    ASSERT(_groups[0] == std::vector<int>{0});
+}
+
+TEST_F(InsertGroupCommitTest, InsertWithoutConcurrentInsertsIsItsOwnGroup) {
+    setParameter("insertGroupCommitWindowMicros", 1);
+    ASSERT(InsertGroupCommitter::isEnabled());
+    ASSERT_OK(insertConcurrently(1, Status::OK())[0]);
+    ASSERT_EQ(1U, _groups.size());
+    ASSERT(_groups[0] == std::vector<int>{0});
+
+    setParameter("insertGroupCommitWindowMicros", 0);
+    ASSERT_FALSE(InsertGroupCommitter::isEnabled());
+}
+
+}  // namespace
+}  // namespace mongo
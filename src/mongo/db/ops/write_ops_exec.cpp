@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <functional>
 #include <memory>
 
 #include "mongo/base/checked_cast.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/lasterror.h"
 #include "mongo/db/ops/delete_request.h"
 #include "mongo/db/ops/insert.h"
+#include "mongo/db/ops/insert_group_commit.h"
 #include "mongo/db/ops/parsed_delete.h"
 #include "mongo/db/ops/parsed_update.h"
 #include "mongo/db/ops/update_lifecycle_impl.h"
@@ -332,6 +334,11 @@ void insertDocuments(OperationContext* opCtx,
 
 /**
  * Returns true if caller should try to insert more documents. Does nothing else if batch is empty.
+ *
+ * The batch is first inserted in a single WriteUnitOfWork. If that fails, it is split in half and
+ * each half is retried the same way, down to single documents, which report their own errors. A
+ * failing document therefore costs a logarithmic number of extra batch inserts rather than
+ * re-inserting the whole batch one document at a time, and results are still reported in order.
  */
 bool insertBatchAndHandleErrors(OperationContext* opCtx,
                                 const write_ops::Insert& wholeOp,
@@ -369,71 +376,95 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
         assertCanWrite_inlock(opCtx, wholeOp.getNamespace());
     };
 
+    // See Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
+    bool canInsertAsBatch = false;
     try {
         acquireCollection();
-        if (!collection->getCollection()->isCapped() && batch.size() > 1) {
-            // First try doing it all together. If all goes well, this is all we need to do.
-            // See Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
+        canInsertAsBatch = !collection->getCollection()->isCapped();
+    } catch (const DBException&) {
+        // The errors are reported for each document by the one-at-a-time inserts below.
+        collection.reset();
+    }
+
+    using BatchIterator = std::vector<InsertStatement>::iterator;
+
+    // Inserts the documents in [begin, end) one at a time, reporting an error for each document
+    // which fails.
+    auto insertOneAtATime = [&](BatchIterator begin, BatchIterator end) {
+        for (auto it = begin; it != end; ++it) {
+            globalOpCounters.gotInsert();
+            try {
+                writeConflictRetry(opCtx, "insert", wholeOp.getNamespace().ns(), [&] {
+                    try {
+                        if (!collection)
+                            acquireCollection();
+                        lastOpFixer->startingOp();
+                        insertDocuments(
+                            opCtx, collection->getCollection(), it, it + 1, fromMigrate);
+                        lastOpFixer->finishedOpSuccessfully();
+                        SingleWriteResult result;
+                        result.setN(1);
+                        out->results.emplace_back(std::move(result));
+                        curOp.debug().additiveMetrics.incrementNinserted(1);
+                    } catch (...) {
+                        // Release the lock following any error if we are not in multi-statement
+                        // transaction. Among other things, this ensures that we don't sleep in the
+                        // WCE retry loop with the lock held.
+                        // If we are in multi-statement transaction and under a under a WUOW, we
+                        // will not actually release the lock.
+                        collection.reset();
+                        throw;
+                    }
+                });
+            } catch (const DBException& ex) {
+                bool canContinue = handleError(
+                    opCtx, ex, wholeOp.getNamespace(), wholeOp.getWriteCommandBase(), out);
+                if (!canContinue)
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    // Inserts the documents in [begin, end) all together, and splits the range in half to retry
+    // each part if that fails.
+    std::function<bool(BatchIterator, BatchIterator)> insertRange = [&](BatchIterator begin,
+                                                                        BatchIterator end) {
+        const auto rangeSize = std::distance(begin, end);
+        if (!canInsertAsBatch || rangeSize == 1) {
+            return insertOneAtATime(begin, end);
+        }
+
+        try {
+            if (!collection)
+                acquireCollection();
             lastOpFixer->startingOp();
-            insertDocuments(
-                opCtx, collection->getCollection(), batch.begin(), batch.end(), fromMigrate);
+            insertDocuments(opCtx, collection->getCollection(), begin, end, fromMigrate);
             lastOpFixer->finishedOpSuccessfully();
-            globalOpCounters.gotInserts(batch.size());
+            globalOpCounters.gotInserts(rangeSize);
             SingleWriteResult result;
             result.setN(1);
 
-            std::fill_n(std::back_inserter(out->results), batch.size(), std::move(result));
-            curOp.debug().additiveMetrics.incrementNinserted(batch.size());
+            std::fill_n(std::back_inserter(out->results), rangeSize, std::move(result));
+            curOp.debug().additiveMetrics.incrementNinserted(rangeSize);
             return true;
-        }
-    } catch (const DBException&) {
+        } catch (const DBException&) {
+            // If we cannot abandon the current snapshot, we give up and rethrow the exception.
+            // No WCE retrying is attempted.  This code path is intended for snapshot read concern.
+            if (opCtx->lockState()->inAWriteUnitOfWork()) {
+                throw;
+            }
 
-        // If we cannot abandon the current snapshot, we give up and rethrow the exception.
-        // No WCE retrying is attempted.  This code path is intended for snapshot read concern.
-        if (opCtx->lockState()->inAWriteUnitOfWork()) {
-            throw;
+            // Otherwise, ignore this failure and behave as-if we never tried to insert this range
+            // together. Retrying the halves will report any non-transient errors.
+            collection.reset();
         }
 
-        // Otherwise, ignore this failure and behave as-if we never tried to do the combined batch
-        // insert.  The loop below will handle reporting any non-transient errors.
-        collection.reset();
-    }
-
-    // Try to insert the batch one-at-a-time. This path is executed both for singular batches, and
-    // for batches that failed all-at-once inserting.
-    for (auto it = batch.begin(); it != batch.end(); ++it) {
-        globalOpCounters.gotInsert();
-        try {
-            writeConflictRetry(opCtx, "insert", wholeOp.getNamespace().ns(), [&] {
-                try {
-                    if (!collection)
-                        acquireCollection();
-                    lastOpFixer->startingOp();
-                    insertDocuments(opCtx, collection->getCollection(), it, it + 1, fromMigrate);
-                    lastOpFixer->finishedOpSuccessfully();
-                    SingleWriteResult result;
-                    result.setN(1);
-                    out->results.emplace_back(std::move(result));
-                    curOp.debug().additiveMetrics.incrementNinserted(1);
-                } catch (...) {
-                    // Release the lock following any error if we are not in multi-statement
-                    // transaction. Among other things, this ensures that we don't sleep in the WCE
-                    // retry loop with the lock held.
-                    // If we are in multi-statement transaction and under a under a WUOW, we will
-                    // not actually release the lock.
-                    collection.reset();
-                    throw;
-                }
-            });
-        } catch (const DBException& ex) {
-            bool canContinue =
-                handleError(opCtx, ex, wholeOp.getNamespace(), wholeOp.getWriteCommandBase(), out);
-            if (!canContinue)
-                return false;
-        }
-    }
+        const auto middle = begin + rangeSize / 2;
+        return insertRange(begin, middle) && insertRange(middle, end);
+    };
 
-    return true;
+    return insertRange(batch.begin(), batch.end());
 }
 
 template <typename T>
@@ -451,6 +482,49 @@ SingleWriteResult makeWriteResultForInsertOrDeleteRetry() {
 
 }  // namespace
 
+/**
+ * Returns whether the insert can be merged with concurrent inserts into the same collection which
+ * other operations make. Only single-document inserts outside of sessions are, and only when no
+ * per-operation state, such as a shard version or bypassing document validation, tells them apart.
+ */
+static bool canGroupCommitInsert(OperationContext* opCtx,
+                                 const write_ops::Insert& wholeOp,
+                                 bool fromMigrate) {
+    const auto& oss = OperationShardingState::get(opCtx);
+    return InsertGroupCommitter::isEnabled() && wholeOp.getDocuments().size() == 1 &&
+        !fromMigrate && !opCtx->getTxnNumber() && opCtx->writesAreReplicated() &&
+        !opCtx->lockState()->inAWriteUnitOfWork() &&
+        !wholeOp.getWriteCommandBase().getBypassDocumentValidation() &&
+        !oss.hasShardVersion() && !oss.hasDbVersion() && !wholeOp.getNamespace().isSystem();
+}
+
+/**
+ * Inserts the documents of a group of single-document inserts, all into 'nss', in one
+ * WriteUnitOfWork. Fails rather than creating the collection, or inserting into a capped one.
+ */
+static Status insertGroupCommit(OperationContext* opCtx,
+                                const NamespaceString& nss,
+                                std::vector<InsertStatement>* group) {
+    try {
+        writeConflictRetry(opCtx, "insertGroupCommit", nss.ns(), [&] {
+            AutoGetCollection collection(opCtx, nss, MODE_IX);
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Collection " << nss.ns() << " does not exist",
+                    collection.getCollection());
+            uassert(ErrorCodes::IllegalOperation,
+                    "Inserts into capped collections are not grouped",
+                    !collection.getCollection()->isCapped());
+            assertCanWrite_inlock(opCtx, nss);
+
+            insertDocuments(opCtx, collection.getCollection(), group->begin(), group->end(), false);
+        });
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    return Status::OK();
+}
+
 WriteResult performInserts(OperationContext* opCtx,
                            const write_ops::Insert& wholeOp,
                            bool fromMigrate) {
@@ -492,6 +566,33 @@ WriteResult performInserts(OperationContext* opCtx,
     WriteResult out;
     out.results.reserve(wholeOp.getDocuments().size());
 
+    if (canGroupCommitInsert(opCtx, wholeOp, fromMigrate)) {
+        const auto& doc = wholeOp.getDocuments().front();
+        auto fixedDoc = fixDocumentForInsert(opCtx->getServiceContext(), doc);
+        if (fixedDoc.isOK()) {
+            InsertStatement stmt(fixedDoc.getValue().isEmpty() ? doc : fixedDoc.getValue());
+            const auto& nss = wholeOp.getNamespace();
+
+            lastOpFixer.startingOp();
+            auto status = InsertGroupCommitter::get(opCtx)->insert(
+                opCtx, nss, std::move(stmt), [&](OperationContext* leaderOpCtx, auto* group) {
+                    return insertGroupCommit(leaderOpCtx, nss, group);
+                });
+
+            // If the group failed, the document is inserted on its own below, which reports the
+            // error for it if it is the one which made the group fail.
+            if (status.isOK()) {
+                lastOpFixer.finishedOpSuccessfully();
+                globalOpCounters.gotInsert();
+                curOp.debug().additiveMetrics.incrementNinserted(1);
+                SingleWriteResult result;
+                result.setN(1);
+                out.results.emplace_back(std::move(result));
+                return out;
+            }
+        }
+    }
+
     bool containsRetry = false;
     ON_BLOCK_EXIT([&] { updateRetryStats(opCtx, containsRetry); });
 
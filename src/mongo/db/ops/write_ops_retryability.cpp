@@ -34,11 +34,25 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/find_and_modify_result.h"
 #include "mongo/db/query/find_and_modify_request.h"
+#include "mongo/db/repl/image_collection_entry_gen.h"
 #include "mongo/logger/redaction.h"
 
 namespace mongo {
 namespace {
 
+/**
+ * Returns whether 'oplog' stores, either in another oplog entry or in the image collection, the
+ * image of the document of the given kind.
+ */
+bool hasRetryImage(const repl::OplogEntry& oplog, repl::RetryImageEnum imageKind) {
+    if (oplog.getNeedsRetryImage()) {
+        return *oplog.getNeedsRetryImage() == imageKind;
+    }
+
+    return imageKind == repl::RetryImageEnum::kPreImage ? !!oplog.getPreImageOpTime()
+                                                        : !!oplog.getPostImageOpTime();
+}
+
 /**
  * Validates that the request is retry-compatible with the operation that occurred.
  * In the case of nested oplog entry where the correct links are in the top level
@@ -64,7 +78,7 @@ void validateFindAndModifyRetryability(const FindAndModifyRequest& request,
         uassert(40607,
                 str::stream() << "No pre-image available for findAndModify retry request:"
                               << redact(request.toBSON()),
-                oplogWithCorrectLinks.getPreImageOpTime());
+                hasRetryImage(oplogWithCorrectLinks, repl::RetryImageEnum::kPreImage));
     } else if (opType == repl::OpTypeEnum::kInsert) {
         uassert(
             40608,
@@ -96,7 +110,7 @@ void validateFindAndModifyRetryability(const FindAndModifyRequest& request,
                                   << ts.toString()
                                   << ", oplog: "
                                   << redact(oplogEntry.toBSON()),
-                    oplogWithCorrectLinks.getPostImageOpTime());
+                    hasRetryImage(oplogWithCorrectLinks, repl::RetryImageEnum::kPostImage));
         } else {
             uassert(40612,
                     str::stream() << "findAndModify retry request: " << redact(request.toBSON())
@@ -105,16 +119,47 @@ void validateFindAndModifyRetryability(const FindAndModifyRequest& request,
                                   << ts.toString()
                                   << ", oplog: "
                                   << redact(oplogEntry.toBSON()),
-                    oplogWithCorrectLinks.getPreImageOpTime());
+                    hasRetryImage(oplogWithCorrectLinks, repl::RetryImageEnum::kPreImage));
         }
     }
 }
 
+/**
+ * Extracts the image of the findAndModify operation from the image collection. Only the image of
+ * the latest findAndModify of each session is kept there.
+ */
+BSONObj extractImageFromSideCollection(OperationContext* opCtx, const repl::OplogEntry& oplog) {
+    const auto& sessionId = *oplog.getSessionId();
+
+    DBDirectClient client(opCtx);
+    auto imageDoc = client.findOne(NamespaceString::kConfigImagesNamespace.ns(),
+                                   BSON("_id" << sessionId.toBSON()));
+
+    boost::optional<repl::ImageEntry> imageEntry;
+    if (!imageDoc.isEmpty()) {
+        imageEntry = repl::ImageEntry::parse(IDLParserErrorContext("image entry"), imageDoc);
+    }
+
+    uassert(51013,
+            str::stream() << "image collection no longer contains the image of the findAndModify "
+                             "with oplog ts "
+                          << oplog.getTimestamp().toString(),
+            imageEntry && imageEntry->getTxnNumber() == *oplog.getTxnNumber() &&
+                imageEntry->getTimestamp() == oplog.getTimestamp() &&
+                !imageEntry->getInvalidated());
+
+    return imageEntry->getImage().getOwned();
+}
+
 /**
  * Extracts either the pre or post image (cannot be both) of the findAndModify operation from the
- * oplog.
+ * oplog, or from the image collection if the oplog entry says it is stored there.
  */
 BSONObj extractPreOrPostImage(OperationContext* opCtx, const repl::OplogEntry& oplog) {
+    if (oplog.getNeedsRetryImage()) {
+        return extractImageFromSideCollection(opCtx, oplog);
+    }
+
     invariant(oplog.getPreImageOpTime() || oplog.getPostImageOpTime());
     auto opTime = oplog.getPreImageOpTime() ? oplog.getPreImageOpTime().value()
                                             : oplog.getPostImageOpTime().value();
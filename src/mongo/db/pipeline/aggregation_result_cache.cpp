@@ -0,0 +1,303 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+#include <algorithm>
+
+#include "mongo/base/counter.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(aggregationResultCacheSizeBytes, long long, 0)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "aggregationResultCacheSizeBytes must be >= 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(aggregationResultCacheMaxAgeSecs, int, 300)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0) {
+            return Status(ErrorCodes::BadValue, "aggregationResultCacheMaxAgeSecs must be > 0");
+        }
+        return Status::OK();
+    });
+
+namespace {
+
+const auto getAggregationResultCache =
+    ServiceContext::declareDecoration<AggregationResultCache>();
+
+Counter64 cacheHits;
+Counter64 cacheMisses;
+Counter64 cacheInserts;
+Counter64 cacheEvictions;
+Counter64 cacheBytes;
+
+ServerStatusMetricField<Counter64> displayCacheHits("aggregationResultCache.hits", &cacheHits);
+ServerStatusMetricField<Counter64> displayCacheMisses("aggregationResultCache.misses",
+                                                      &cacheMisses);
+ServerStatusMetricField<Counter64> displayCacheInserts("aggregationResultCache.inserts",
+                                                       &cacheInserts);
+ServerStatusMetricField<Counter64> displayCacheEvictions("aggregationResultCache.evictions",
+                                                         &cacheEvictions);
+ServerStatusMetricField<Counter64> displayCacheBytes("aggregationResultCache.bytes", &cacheBytes);
+
+// Stages whose output depends only on their input and their arguments.
+const StringData kDeterministicStages[] = {"$addFields"_sd,
+                                           "$bucket"_sd,
+                                           "$bucketAuto"_sd,
+                                           "$count"_sd,
+                                           "$facet"_sd,
+                                           "$graphLookup"_sd,
+                                           "$group"_sd,
+                                           "$limit"_sd,
+                                           "$lookup"_sd,
+                                           "$match"_sd,
+                                           "$project"_sd,
+                                           "$redact"_sd,
+                                           "$replaceRoot"_sd,
+                                           "$skip"_sd,
+                                           "$sort"_sd,
+                                           "$sortByCount"_sd,
+                                           "$unwind"_sd};
+
+bool containsWhere(const BSONObj& obj) {
+    for (auto&& elem : obj) {
+        if (elem.fieldNameStringData() == "$where"_sd) {
+            return true;
+        }
+        if (elem.isABSONObj() && containsWhere(elem.embeddedObject())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isDeterministicPipeline(const BSONObj& pipeline) {
+    for (auto&& stageElem : pipeline) {
+        if (stageElem.type() != BSONType::Object) {
+            return false;
+        }
+        const auto stage = stageElem.embeddedObject();
+        const auto stageName = stage.firstElement().fieldNameStringData();
+        const auto stagesEnd = std::end(kDeterministicStages);
+        if (std::find(std::begin(kDeterministicStages), stagesEnd, stageName) == stagesEnd) {
+            return false;
+        }
+
+        // $where runs JavaScript, which may call Math.random() or read the clock.
+        if (containsWhere(stage)) {
+            return false;
+        }
+
+        // Check the sub-pipelines of $lookup and $facet as well.
+        const auto spec = stage.firstElement();
+        if (stageName == "$lookup"_sd && spec.isABSONObj()) {
+            const auto subPipeline = spec.embeddedObject()["pipeline"];
+            if (subPipeline.isABSONObj() &&
+                !isDeterministicPipeline(subPipeline.embeddedObject())) {
+                return false;
+            }
+        } else if (stageName == "$facet"_sd && spec.isABSONObj()) {
+            for (auto&& facet : spec.embeddedObject()) {
+                if (!facet.isABSONObj() || !isDeterministicPipeline(facet.embeddedObject())) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+AggregationResultCache* AggregationResultCache::get(ServiceContext* service) {
+    return &getAggregationResultCache(service);
+}
+
+boost::optional<std::string> AggregationResultCache::makeKey(const NamespaceString& nss,
+                                                             const BSONObj& pipeline,
+                                                             const BSONObj& collation,
+                                                             const BSONObj& hint) {
+    if (!isDeterministicPipeline(pipeline)) {
+        return boost::none;
+    }
+
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("ns", nss.ns());
+    keyBuilder.appendArray("pipeline", pipeline);
+    keyBuilder.append("collation", collation);
+    keyBuilder.append("hint", hint);
+    const auto key = keyBuilder.done();
+    return std::string(key.objdata(), key.objsize());
+}
+
+boost::optional<BSONObj> AggregationResultCache::lookup(const std::string& key,
+                                                        long long maxResults,
+                                                        Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        cacheMisses.increment();
+        return boost::none;
+    }
+
+    auto entryIt = it->second;
+    if (!_isValid_inlock(entryIt->second, now)) {
+        _erase_inlock(entryIt);
+        cacheMisses.increment();
+        return boost::none;
+    }
+
+    if (entryIt->second.numResults > maxResults) {
+        cacheMisses.increment();
+        return boost::none;
+    }
+
+    _entries.splice(_entries.begin(), _entries, entryIt);
+    cacheHits.increment();
+    return entryIt->second.results;
+}
+
+void AggregationResultCache::insert(const std::string& key,
+                                    std::vector<NamespaceString> namespaces,
+                                    WriteCount readStart,
+                                    const std::vector<BSONObj>& results,
+                                    Date_t now) {
+    const auto maxSizeBytes = static_cast<size_t>(aggregationResultCacheSizeBytes.load());
+
+    size_t sizeBytes = key.size();
+    for (auto&& result : results) {
+        sizeBytes += result.objsize();
+    }
+    if (sizeBytes > maxSizeBytes / 4) {
+        return;
+    }
+
+    BSONArrayBuilder resultsBuilder;
+    for (auto&& result : results) {
+        resultsBuilder.append(result);
+    }
+
+    Entry entry{std::move(namespaces),
+                readStart,
+                resultsBuilder.arr(),
+                static_cast<long long>(results.size()),
+                now,
+                sizeBytes};
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_isValid_inlock(entry, now)) {
+        return;
+    }
+
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+        _erase_inlock(it->second);
+    }
+
+    _entries.emplace_front(key, std::move(entry));
+    _index.emplace(key, _entries.begin());
+    _sizeBytes += sizeBytes;
+    cacheBytes.increment(sizeBytes);
+    cacheInserts.increment();
+
+    _evictTo_inlock(maxSizeBytes);
+}
+
+void AggregationResultCache::invalidate(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _lastNamespaceWrite[nss.ns()] = _writeCount.addAndFetch(1);
+}
+
+void AggregationResultCache::invalidateDatabase(StringData dbName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _lastDatabaseWrite[dbName] = _writeCount.addAndFetch(1);
+}
+
+void AggregationResultCache::invalidateAll() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _lastInvalidateAll = _writeCount.addAndFetch(1);
+    _evictTo_inlock(0);
+}
+
+size_t AggregationResultCache::sizeBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sizeBytes;
+}
+
+size_t AggregationResultCache::numEntries() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+bool AggregationResultCache::_isValid_inlock(const Entry& entry, Date_t now) const {
+    if (now - entry.created > Seconds(aggregationResultCacheMaxAgeSecs.load())) {
+        return false;
+    }
+    if (_lastInvalidateAll > entry.readStart) {
+        return false;
+    }
+    for (auto&& nss : entry.namespaces) {
+        auto nsIt = _lastNamespaceWrite.find(nss.ns());
+        if (nsIt != _lastNamespaceWrite.end() && nsIt->second > entry.readStart) {
+            return false;
+        }
+        auto dbIt = _lastDatabaseWrite.find(nss.db());
+        if (dbIt != _lastDatabaseWrite.end() && dbIt->second > entry.readStart) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AggregationResultCache::_erase_inlock(EntryList::iterator it) {
+    _sizeBytes -= it->second.sizeBytes;
+    cacheBytes.decrement(it->second.sizeBytes);
+    _index.erase(it->first);
+    _entries.erase(it);
+}
+
+void AggregationResultCache::_evictTo_inlock(size_t maxSizeBytes) {
+    while (_sizeBytes > maxSizeBytes) {
+        invariant(!_entries.empty());
+        _erase_inlock(std::prev(_entries.end()));
+        cacheEvictions.increment();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+// The memory budget of the aggregation result cache, in bytes. Zero disables the cache.
+extern AtomicInt64 aggregationResultCacheSizeBytes;
+
+// Cached results older than this are discarded even if no write to their namespaces was seen.
+extern AtomicInt32 aggregationResultCacheMaxAgeSecs;
+
+/**
+ * A server-wide cache of the results of deterministic aggregations, so that a pipeline which is
+ * run again over unchanged collections can be answered without being executed. Entries are keyed
+ * by the namespace and the normalized pipeline, and each remembers the namespaces it read.
+ *
+ * Writes are reported by AggregationResultCacheOpObserver, and stamp the written namespace with
+ * the next value of a global write counter. A reader records the counter before it opens its
+ * storage snapshot, so its results stay valid for as long as none of the namespaces it read has
+ * been stamped with a later value.
+ *
+ * The cache holds at most 'aggregationResultCacheSizeBytes' of results, evicting the least
+ * recently used entries first. This class is thread safe.
+ */
+class AggregationResultCache {
+    MONGO_DISALLOW_COPYING(AggregationResultCache);
+
+public:
+    using WriteCount = unsigned long long;
+
+    static AggregationResultCache* get(ServiceContext* service);
+
+    /**
+     * Returns true if the cache has a non-zero memory budget.
+     */
+    static bool isEnabled() {
+        return aggregationResultCacheSizeBytes.load() > 0;
+    }
+
+    /**
+     * Returns the cache key for running the serialized, optimized 'pipeline' over 'nss' with the
+     * given collation and hint, or boost::none if the pipeline contains a stage or expression
+     * whose output may differ between two runs over the same data.
+     */
+    static boost::optional<std::string> makeKey(const NamespaceString& nss,
+                                                const BSONObj& pipeline,
+                                                const BSONObj& collation,
+                                                const BSONObj& hint);
+
+    AggregationResultCache() = default;
+
+    /**
+     * Returns the current value of the write counter. A reader must call this before it opens the
+     * snapshot whose results it will pass to insert().
+     */
+    WriteCount beginRead() const {
+        return _writeCount.load();
+    }
+
+    /**
+     * Returns the results cached under 'key', as a BSON array, if there is a valid entry for it
+     * holding no more than 'maxResults' documents. Counts a hit or a miss.
+     */
+    boost::optional<BSONObj> lookup(const std::string& key, long long maxResults, Date_t now);
+
+    /**
+     * Caches 'results' under 'key'. 'readStart' is the value beginRead() returned before the
+     * results were read from 'namespaces'. The results are dropped if a write to one of those
+     * namespaces has been seen since, or if they would use more than a quarter of the budget.
+     */
+    void insert(const std::string& key,
+                std::vector<NamespaceString> namespaces,
+                WriteCount readStart,
+                const std::vector<BSONObj>& results,
+                Date_t now);
+
+    /**
+     * Invalidates every entry which read 'nss', every entry which read a collection of the
+     * database 'dbName', or every entry respectively.
+     */
+    void invalidate(const NamespaceString& nss);
+    void invalidateDatabase(StringData dbName);
+    void invalidateAll();
+
+    size_t sizeBytes() const;
+    size_t numEntries() const;
+
+private:
+    struct Entry {
+        std::vector<NamespaceString> namespaces;
+        WriteCount readStart;
+        BSONObj results;
+        long long numResults;
+        Date_t created;
+        size_t sizeBytes;
+    };
+
+    using EntryList = std::list<std::pair<std::string, Entry>>;
+
+    bool _isValid_inlock(const Entry& entry, Date_t now) const;
+    void _erase_inlock(EntryList::iterator it);
+    void _evictTo_inlock(size_t maxSizeBytes);
+
+    AtomicUInt64 _writeCount{0};
+
+    mutable stdx::mutex _mutex;
+
+    // The value of the write counter when each namespace or database was last written, and when
+    // the whole cache was last invalidated.
+    StringMap<WriteCount> _lastNamespaceWrite;
+    StringMap<WriteCount> _lastDatabaseWrite;
+    WriteCount _lastInvalidateAll = 0;
+
+    // Entries in order of last use, most recent first.
+    EntryList _entries;
+    stdx::unordered_map<std::string, EntryList::iterator> _index;
+    size_t _sizeBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache_op_observer.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+namespace mongo {
+
+namespace {
+
+void invalidateNamespace(OperationContext* opCtx, const NamespaceString& nss) {
+    if (!AggregationResultCache::isEnabled()) {
+        return;
+    }
+
+    auto cache = AggregationResultCache::get(opCtx->getServiceContext());
+    cache->invalidate(nss);
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        opCtx->recoveryUnit()->onCommit(
+            [cache, nss](boost::optional<Timestamp>) { cache->invalidate(nss); });
+    }
+}
+
+void invalidateDatabase(OperationContext* opCtx, const std::string& dbName) {
+    if (!AggregationResultCache::isEnabled()) {
+        return;
+    }
+
+    auto cache = AggregationResultCache::get(opCtx->getServiceContext());
+    cache->invalidateDatabase(dbName);
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        opCtx->recoveryUnit()->onCommit(
+            [cache, dbName](boost::optional<Timestamp>) { cache->invalidateDatabase(dbName); });
+    }
+}
+
+}  // namespace
+
+void AggregationResultCacheOpObserver::onCreateIndex(OperationContext* opCtx,
+                                                     const NamespaceString& nss,
+                                                     CollectionUUID uuid,
+                                                     BSONObj indexDoc,
+                                                     bool fromMigrate) {
+    invalidateNamespace(opCtx, nss);
+}
+
+void AggregationResultCacheOpObserver::onInserts(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 OptionalCollectionUUID uuid,
+                                                 std::vector<InsertStatement>::const_iterator begin,
+                                                 std::vector<InsertStatement>::const_iterator end,
+                                                 bool fromMigrate) {
+    invalidateNamespace(opCtx, nss);
+}
+
+void AggregationResultCacheOpObserver::onUpdate(OperationContext* opCtx,
+                                                const OplogUpdateEntryArgs& args) {
+    invalidateNamespace(opCtx, args.nss);
+}
+
+void AggregationResultCacheOpObserver::onDelete(OperationContext* opCtx,
+                                                const NamespaceString& nss,
+                                                OptionalCollectionUUID uuid,
+                                                StmtId stmtId,
+                                                bool fromMigrate,
+                                                const boost::optional<BSONObj>& deletedDoc) {
+    invalidateNamespace(opCtx, nss);
+}
+
+void AggregationResultCacheOpObserver::onCollMod(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 OptionalCollectionUUID uuid,
+                                                 const BSONObj& collModCmd,
+                                                 const CollectionOptions& oldCollOptions,
+                                                 boost::optional<TTLCollModInfo> ttlInfo) {
+    invalidateNamespace(opCtx, nss);
+}
+
+void AggregationResultCacheOpObserver::onDropDatabase(OperationContext* opCtx,
+                                                      const std::string& dbName) {
+    invalidateDatabase(opCtx, dbName);
+}
+
+repl::OpTime AggregationResultCacheOpObserver::onDropCollection(
+    OperationContext* opCtx, const NamespaceString& collectionName, OptionalCollectionUUID uuid) {
+    invalidateNamespace(opCtx, collectionName);
+    return {};
+}
+
+void AggregationResultCacheOpObserver::onDropIndex(OperationContext* opCtx,
+                                                   const NamespaceString& nss,
+                                                   OptionalCollectionUUID uuid,
+                                                   const std::string& indexName,
+                                                   const BSONObj& idxDescriptor) {
+    invalidateNamespace(opCtx, nss);
+}
+
+void AggregationResultCacheOpObserver::onRenameCollection(OperationContext* opCtx,
+                                                          const NamespaceString& fromCollection,
+                                                          const NamespaceString& toCollection,
+                                                          OptionalCollectionUUID uuid,
+                                                          OptionalCollectionUUID dropTargetUUID,
+                                                          bool stayTemp) {
+    invalidateNamespace(opCtx, fromCollection);
+    invalidateNamespace(opCtx, toCollection);
+}
+
+void AggregationResultCacheOpObserver::postRenameCollection(OperationContext* opCtx,
+                                                            const NamespaceString& fromCollection,
+                                                            const NamespaceString& toCollection,
+                                                            OptionalCollectionUUID uuid,
+                                                            OptionalCollectionUUID dropTargetUUID,
+                                                            bool stayTemp) {
+    invalidateNamespace(opCtx, fromCollection);
+    invalidateNamespace(opCtx, toCollection);
+}
+
+void AggregationResultCacheOpObserver::onApplyOps(OperationContext* opCtx,
+                                                  const std::string& dbName,
+                                                  const BSONObj& applyOpCmd) {
+    // The operations of an applyOps command may target any database.
+    if (AggregationResultCache::isEnabled()) {
+        AggregationResultCache::get(opCtx->getServiceContext())->invalidateAll();
+    }
+}
+
+void AggregationResultCacheOpObserver::onEmptyCapped(OperationContext* opCtx,
+                                                     const NamespaceString& collectionName,
+                                                     OptionalCollectionUUID uuid) {
+    invalidateNamespace(opCtx, collectionName);
+}
+
+void AggregationResultCacheOpObserver::onReplicationRollback(OperationContext* opCtx,
+                                                             const RollbackObserverInfo& rbInfo) {
+    AggregationResultCache::get(opCtx->getServiceContext())->invalidateAll();
+}
+
+}  // namespace mongo
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kTestNss("test.coll");
+const NamespaceString kOtherNss("test.other");
+const Date_t kNow = Date_t::fromMillisSinceEpoch(1000 * 1000);
+
+class AggregationResultCacheTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _oldSizeBytes = aggregationResultCacheSizeBytes.swap(1024 * 1024);
+    }
+
+    void tearDown() override {
+        aggregationResultCacheSizeBytes.store(_oldSizeBytes);
+    }
+
+    std::string makeKey(const char* pipeline) {
+        auto key = AggregationResultCache::makeKey(
+            kTestNss, fromjson(pipeline)["p"].Obj(), BSONObj(), BSONObj());
+        ASSERT(key);
+        return *key;
+    }
+
+    AggregationResultCache cache;
+
+private:
+    long long _oldSizeBytes;
+};
+
+TEST_F(AggregationResultCacheTest, PipelinesWithNonDeterministicStagesHaveNoKey) {
+    const auto makeKey = [](const char* pipeline) {
+        return AggregationResultCache::makeKey(
+            kTestNss, fromjson(pipeline)["p"].Obj(), BSONObj(), BSONObj());
+    };
+    ASSERT(makeKey("{p: [{$match: {a: 1}}, {$group: {_id: '$b'}}]}"));
+    ASSERT_FALSE(makeKey("{p: [{$sample: {size: 1}}]}"));
+    ASSERT_FALSE(makeKey("{p: [{$out: 'target'}]}"));
+    ASSERT_FALSE(makeKey("{p: [{$match: {$where: 'return true;'}}]}"));
+    ASSERT_FALSE(makeKey("{p: [{$facet: {a: [{$sample: {size: 1}}]}}]}"));
+    ASSERT_FALSE(makeKey("{p: [{$lookup: {from: 'other', as: 'x', pipeline: [{$sample: "
+                         "{size: 1}}]}}]}"));
+}
+
+TEST_F(AggregationResultCacheTest, KeyDependsOnCollationAndHint) {
+    const auto pipeline = BSON_ARRAY(BSON("$match" << BSON("a" << 1)));
+    const auto simple = AggregationResultCache::makeKey(kTestNss, pipeline, BSONObj(), BSONObj());
+    const auto collated = AggregationResultCache::makeKey(
+        kTestNss, pipeline, BSON("locale"
+                                 << "fr"),
+        BSONObj());
+    const auto hinted =
+        AggregationResultCache::makeKey(kTestNss, pipeline, BSONObj(), BSON("a" << 1));
+    ASSERT_NE(*simple, *collated);
+    ASSERT_NE(*simple, *hinted);
+}
+
+TEST_F(AggregationResultCacheTest, ReturnsCachedResultsUntilNamespaceIsWritten) {
+    const auto key = makeKey("{p: [{$match: {a: 1}}]}");
+    ASSERT_FALSE(cache.lookup(key, 100, kNow));
+
+    cache.insert(key, {kTestNss}, cache.beginRead(), {BSON("a" << 1), BSON("a" << 1)}, kNow);
+    auto results = cache.lookup(key, 100, kNow);
+    ASSERT(results);
+    ASSERT_BSONOBJ_EQ(*results, BSON_ARRAY(BSON("a" << 1) << BSON("a" << 1)));
+
+    // A write to another namespace does not invalidate the entry.
+    cache.invalidate(kOtherNss);
+    ASSERT(cache.lookup(key, 100, kNow));
+
+    cache.invalidate(kTestNss);
+    ASSERT_FALSE(cache.lookup(key, 100, kNow));
+    ASSERT_EQ(cache.numEntries(), 0U);
+}
+
+TEST_F(AggregationResultCacheTest, DoesNotCacheResultsReadBeforeAWrite) {
+    const auto key = makeKey("{p: [{$match: {a: 1}}]}");
+    const auto readStart = cache.beginRead();
+    cache.invalidate(kTestNss);
+    cache.insert(key, {kTestNss}, readStart, {BSON("a" << 1)}, kNow);
+    ASSERT_FALSE(cache.lookup(key, 100, kNow));
+    ASSERT_EQ(cache.numEntries(), 0U);
+}
+
+TEST_F(AggregationResultCacheTest, DropDatabaseInvalidatesItsNamespaces) {
+    const auto key = makeKey("{p: [{$match: {a: 1}}]}");
+    cache.insert(key, {kTestNss}, cache.beginRead(), {BSON("a" << 1)}, kNow);
+    cache.invalidateDatabase("other");
+    ASSERT(cache.lookup(key, 100, kNow));
+    cache.invalidateDatabase("test");
+    ASSERT_FALSE(cache.lookup(key, 100, kNow));
+}
+
+TEST_F(AggregationResultCacheTest, EntriesExpire) {
+    const auto key = makeKey("{p: [{$match: {a: 1}}]}");
+    cache.insert(key, {kTestNss}, cache.beginRead(), {BSON("a" << 1)}, kNow);
+    ASSERT(cache.lookup(key, 100, kNow + Seconds(aggregationResultCacheMaxAgeSecs.load())));
+    ASSERT_FALSE(
+        cache.lookup(key, 100, kNow + Seconds(aggregationResultCacheMaxAgeSecs.load() + 1)));
+}
+
+TEST_F(AggregationResultCacheTest, DoesNotServeMoreResultsThanRequested) {
+    const auto key = makeKey("{p: [{$match: {a: 1}}]}");
+    cache.insert(key, {kTestNss}, cache.beginRead(), {BSON("a" << 1), BSON("a" << 1)}, kNow);
+    ASSERT_FALSE(cache.lookup(key, 1, kNow));
+    ASSERT(cache.lookup(key, 2, kNow));
+}
+
+TEST_F(AggregationResultCacheTest, EvictsLeastRecentlyUsedEntriesToStayWithinBudget) {
+    aggregationResultCacheSizeBytes.store(4 * 1024);
+    const auto bigDoc = BSON("s" << std::string(800, 'x'));
+    const auto first = makeKey("{p: [{$match: {a: 1}}]}");
+    const auto second = makeKey("{p: [{$match: {a: 2}}]}");
+    const auto third = makeKey("{p: [{$match: {a: 3}}]}");
+    const auto fourth = makeKey("{p: [{$match: {a: 4}}]}");
+    const auto fifth = makeKey("{p: [{$match: {a: 5}}]}");
+
+    for (auto&& key : {first, second, third, fourth}) {
+        cache.insert(key, {kTestNss}, cache.beginRead(), {bigDoc}, kNow);
+    }
+    ASSERT_EQ(cache.numEntries(), 4U);
+
+    // Using the first entry makes the second the least recently used.
+    ASSERT(cache.lookup(first, 100, kNow));
+    cache.insert(fifth, {kTestNss}, cache.beginRead(), {bigDoc}, kNow);
+    ASSERT_LTE(cache.sizeBytes(), 4U * 1024);
+    ASSERT(cache.lookup(first, 100, kNow));
+    ASSERT_FALSE(cache.lookup(second, 100, kNow));
+    ASSERT(cache.lookup(fifth, 100, kNow));
+}
+
+TEST_F(AggregationResultCacheTest, DoesNotCacheResultsLargerThanAQuarterOfTheBudget) {
+    aggregationResultCacheSizeBytes.store(4 * 1024);
+    const auto key = makeKey("{p: [{$match: {a: 1}}]}");
+    cache.insert(
+        key, {kTestNss}, cache.beginRead(), {BSON("s" << std::string(2 * 1024, 'x'))}, kNow);
+    ASSERT_EQ(cache.numEntries(), 0U);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_oplog_entry_cache.h"
+
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+const auto getCache = ServiceContext::declareDecoration<ChangeStreamOplogEntryCache>();
+}  // namespace
+
+ChangeStreamOplogEntryCache& ChangeStreamOplogEntryCache::get(ServiceContext* serviceContext) {
+    return getCache(serviceContext);
+}
+
+ChangeStreamOplogEntryCache::Key ChangeStreamOplogEntryCache::makeKey(const BSONObj& entry) {
+    return Key(entry[repl::OplogEntry::kTimestampFieldName].timestamp(),
+               entry[repl::OplogEntry::kTermFieldName].safeNumberLong(),
+               entry[repl::OplogEntry::kHashFieldName].safeNumberLong());
+}
+
+Document ChangeStreamOplogEntryCache::getOrConvert(const BSONObj& entry, size_t maxSizeBytes) {
+    const Key key = makeKey(entry);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            return it->second;
+        }
+    }
+
+    // Convert the entry without holding the mutex, so that change streams reading different
+    // entries do not wait for one another. If another change stream converts the same entry in
+    // the meantime, the first one to be added is kept.
+    Document converted = Document::fromBsonWithMetaData(entry);
+    const size_t convertedSize = converted.getApproximateSize();
+    if (convertedSize > maxSizeBytes) {
+        return converted;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto inserted = _entries.emplace(key, std::move(converted));
+    Document result = inserted.first->second;
+    if (inserted.second) {
+        _sizeBytes += convertedSize;
+        while (_sizeBytes > maxSizeBytes) {
+            auto oldest = _entries.begin();
+            _sizeBytes -= oldest->second.getApproximateSize();
+            _entries.erase(oldest);
+        }
+    }
+    return result;
+}
+
+size_t ChangeStreamOplogEntryCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+void ChangeStreamOplogEntryCache::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.clear();
+    _sizeBytes = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <tuple>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A cache of recently read oplog entries, converted to Documents, which is shared by every change
+ * stream on this node.
+ *
+ * Each change stream reads the oplog through its own cursor, so that it can resume from its own
+ * position and push its own filter down to the scan. Many change streams following the end of the
+ * oplog read the same entries, though, and would each convert them from BSON. With this cache the
+ * first change stream to read an entry converts it, and the others share the result.
+ *
+ * The cached Documents are fully converted, so they are never changed by reading them and are safe
+ * to share between threads. Pipeline stages that modify a shared Document copy it first, as they
+ * would any other Document with more than one reference.
+ *
+ * Entries are identified by their timestamp, term and hash, so that an entry rolled back and
+ * replaced by another with the same timestamp is not confused with the original. The cache is
+ * bounded in bytes and evicts the oldest entries first.
+ */
+class ChangeStreamOplogEntryCache {
+    MONGO_DISALLOW_COPYING(ChangeStreamOplogEntryCache);
+
+public:
+    ChangeStreamOplogEntryCache() = default;
+
+    static ChangeStreamOplogEntryCache& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns the Document for the oplog entry 'entry', converting it only if it is not already in
+     * the cache. 'maxSizeBytes' is the size the cache is kept within after adding the entry.
+     */
+    Document getOrConvert(const BSONObj& entry, size_t maxSizeBytes);
+
+    /**
+     * Returns the number of entries currently in the cache.
+     */
+    size_t size() const;
+
+    /**
+     * Removes every entry from the cache.
+     */
+    void clear();
+
+private:
+    // The timestamp, term and hash of an oplog entry. Ordered first by timestamp so that the
+    // oldest entries are at the beginning of '_entries'.
+    using Key = std::tuple<Timestamp, long long, long long>;
+
+    static Key makeKey(const BSONObj& entry);
+
+    mutable stdx::mutex _mutex;
+
+    std::map<Key, Document> _entries;
+    size_t _sizeBytes = 0;
+};
+
+}  // namespace mongo
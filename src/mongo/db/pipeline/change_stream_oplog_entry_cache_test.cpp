@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_oplog_entry_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kLargeCacheBytes = 1024 * 1024;
+
+BSONObj makeOplogEntry(unsigned inc, long long hash, long long term = 1) {
+    return BSON("ts" << Timestamp(100, inc) << "t" << term << "h" << hash << "v" << 2 << "op"
+                     << "i"
+                     << "ns"
+                     << "test.coll"
+                     << "o"
+                     << BSON("_id" << static_cast<int>(inc) << "x" << std::string(100, 'x')));
+}
+
+TEST(ChangeStreamOplogEntryCacheTest, ConvertsEachEntryOnce) {
+    ChangeStreamOplogEntryCache cache;
+    const auto entry = makeOplogEntry(1, 10);
+
+    auto first = cache.getOrConvert(entry, kLargeCacheBytes);
+    ASSERT_DOCUMENT_EQ(Document(entry), first);
+    ASSERT_EQ(1U, cache.size());
+
+    // A second read of the same entry, even from a different copy of its BSON, is a hit.
+    auto second = cache.getOrConvert(entry.getOwned(), kLargeCacheBytes);
+    ASSERT_DOCUMENT_EQ(first, second);
+    ASSERT_EQ(1U, cache.size());
+}
+
+TEST(ChangeStreamOplogEntryCacheTest, DistinguishesEntriesWithTheSameTimestamp) {
+    ChangeStreamOplogEntryCache cache;
+
+    // An entry which replaced a rolled back entry with the same timestamp has a different hash or
+    // term.
+    auto original = cache.getOrConvert(makeOplogEntry(1, 10), kLargeCacheBytes);
+    auto differentHash = cache.getOrConvert(makeOplogEntry(1, 11), kLargeCacheBytes);
+    auto differentTerm = cache.getOrConvert(makeOplogEntry(1, 10, 2), kLargeCacheBytes);
+    ASSERT_EQ(3U, cache.size());
+    ASSERT_VALUE_EQ(Value(10LL), original["h"]);
+    ASSERT_VALUE_EQ(Value(11LL), differentHash["h"]);
+    ASSERT_VALUE_EQ(Value(2LL), differentTerm["t"]);
+}
+
+TEST(ChangeStreamOplogEntryCacheTest, EvictsOldestEntriesFirst) {
+    ChangeStreamOplogEntryCache cache;
+    const size_t entrySize = Document(makeOplogEntry(1, 10)).getApproximateSize();
+    const size_t cacheSize = entrySize * 3;
+
+    for (unsigned i = 1; i <= 10; ++i) {
+        cache.getOrConvert(makeOplogEntry(i, 10), cacheSize);
+        ASSERT_LTE(cache.size(), 3U);
+    }
+    ASSERT_EQ(3U, cache.size());
+
+    // The newest entries are still cached.
+    cache.getOrConvert(makeOplogEntry(10, 10), cacheSize);
+    cache.getOrConvert(makeOplogEntry(9, 10), cacheSize);
+    ASSERT_EQ(3U, cache.size());
+}
+
+TEST(ChangeStreamOplogEntryCacheTest, DoesNotCacheEntriesLargerThanTheCache) {
+    ChangeStreamOplogEntryCache cache;
+    const auto entry = makeOplogEntry(1, 10);
+
+    ASSERT_DOCUMENT_EQ(Document(entry), cache.getOrConvert(entry, 10));
+    ASSERT_EQ(0U, cache.size());
+}
+
+TEST(ChangeStreamOplogEntryCacheTest, ClearRemovesEveryEntry) {
+    ChangeStreamOplogEntryCache cache;
+    cache.getOrConvert(makeOplogEntry(1, 10), kLargeCacheBytes);
+    cache.getOrConvert(makeOplogEntry(2, 10), kLargeCacheBytes);
+    ASSERT_EQ(2U, cache.size());
+
+    cache.clear();
+    ASSERT_EQ(0U, cache.size());
+}
+
+}  // namespace
+}  // namespace mongo
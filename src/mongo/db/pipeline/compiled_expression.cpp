@@ -0,0 +1,245 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/compiled_expression.h"
+
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+CompiledExpression::CompiledExpression(const Expression* root) : _root(root) {
+    compile(_root);
+    invariant(_stackDepth == 1);
+    _stack.resize(_maxStackDepth);
+}
+
+Value CompiledExpression::evaluate(const Document& root) const {
+    if (!isCompiled()) {
+        return _root->evaluate(root);
+    }
+
+    Value* stack = _stack.data();
+    size_t top = 0;  // The index one past the top of the stack.
+
+    // Releases the values at indexes ['begin', 'end') of the stack, so that the stack does not hold
+    // on to them between calls and force copies of documents or arrays shared with them.
+    auto release = [stack](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            stack[i] = Value();
+        }
+    };
+
+    size_t pc = 0;
+    while (pc < _program.size()) {
+        const Instruction& instr = _program[pc++];
+        switch (instr.op) {
+            case OpCode::kConstant:
+                stack[top++] = _constants[instr.arg];
+                break;
+            case OpCode::kFieldPath:
+                stack[top++] = evaluateFieldPath(_fieldPaths[instr.arg], root);
+                break;
+            case OpCode::kEvaluate:
+                stack[top++] = instr.expr->evaluate(root);
+                break;
+            case OpCode::kAdd:
+            case OpCode::kMultiply: {
+                const size_t first = top - instr.arg;
+                Value result = instr.op == OpCode::kAdd
+                    ? ExpressionAdd::apply(stack + first, instr.arg)
+                    : ExpressionMultiply::apply(stack + first, instr.arg);
+                release(first, top);
+                stack[first] = std::move(result);
+                top = first + 1;
+                break;
+            }
+            case OpCode::kSubtract: {
+                Value result = ExpressionSubtract::apply(stack[top - 2], stack[top - 1]);
+                release(top - 2, top);
+                stack[top - 2] = std::move(result);
+                --top;
+                break;
+            }
+            case OpCode::kCompare: {
+                Value result = static_cast<const ExpressionCompare*>(instr.expr)
+                                   ->apply(stack[top - 2], stack[top - 1]);
+                release(top - 2, top);
+                stack[top - 2] = std::move(result);
+                --top;
+                break;
+            }
+            case OpCode::kNot:
+                stack[top - 1] = Value(!stack[top - 1].coerceToBool());
+                break;
+            case OpCode::kJumpIfFalse:
+            case OpCode::kJumpIfTrue: {
+                --top;
+                const bool value = stack[top].coerceToBool();
+                stack[top] = Value();
+                if (value == (instr.op == OpCode::kJumpIfTrue)) {
+                    pc = instr.arg;
+                }
+                break;
+            }
+            case OpCode::kJump:
+                pc = instr.arg;
+                break;
+        }
+    }
+
+    dassert(top == 1);
+    return std::move(stack[0]);
+}
+
+void CompiledExpression::compile(const Expression* expr) {
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+        emitConstant(constant->getValue());
+    } else if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(expr)) {
+        compileFieldPath(fieldPath);
+    } else if (auto add = dynamic_cast<const ExpressionAdd*>(expr)) {
+        compileArithmetic(OpCode::kAdd, add);
+    } else if (auto multiply = dynamic_cast<const ExpressionMultiply*>(expr)) {
+        compileArithmetic(OpCode::kMultiply, multiply);
+    } else if (auto subtract = dynamic_cast<const ExpressionSubtract*>(expr)) {
+        compileArithmetic(OpCode::kSubtract, subtract);
+    } else if (auto compare = dynamic_cast<const ExpressionCompare*>(expr)) {
+        const auto& operands = compare->getOperandList();
+        compile(operands[0].get());
+        compile(operands[1].get());
+        emit(OpCode::kCompare, 0, compare, -1);
+    } else if (auto notExpr = dynamic_cast<const ExpressionNot*>(expr)) {
+        compile(notExpr->getOperandList()[0].get());
+        emit(OpCode::kNot, 0, nullptr, 0);
+    } else if (auto andExpr = dynamic_cast<const ExpressionAnd*>(expr)) {
+        compileLogical(andExpr, true);
+    } else if (auto orExpr = dynamic_cast<const ExpressionOr*>(expr)) {
+        compileLogical(orExpr, false);
+    } else if (auto cond = dynamic_cast<const ExpressionCond*>(expr)) {
+        compileCond(cond);
+    } else {
+        emit(OpCode::kEvaluate, 0, expr, 1);
+    }
+}
+
+void CompiledExpression::compileFieldPath(const ExpressionFieldPath* expr) {
+    const FieldPath& path = expr->getFieldPath();
+
+    // Paths over other variables, and the whole of $$CURRENT, are left to the expression.
+    if (!expr->isRootFieldPath() || path.getPathLength() == 1) {
+        emit(OpCode::kEvaluate, 0, expr, 1);
+        return;
+    }
+
+    CompiledFieldPath compiled;
+    compiled.expr = expr;
+    for (size_t i = 1; i < path.getPathLength(); ++i) {
+        compiled.fieldNames.push_back(path.getFieldName(i));
+        compiled.fieldNameHashes.push_back(Document::hashFieldName(path.getFieldName(i)));
+    }
+    _fieldPaths.push_back(std::move(compiled));
+    emit(OpCode::kFieldPath, _fieldPaths.size() - 1, nullptr, 1);
+}
+
+void CompiledExpression::compileArithmetic(OpCode op, const ExpressionNary* expr) {
+    const auto& operands = expr->getOperandList();
+    for (auto&& operand : operands) {
+        compile(operand.get());
+    }
+    emit(op, operands.size(), nullptr, 1 - static_cast<int>(operands.size()));
+}
+
+void CompiledExpression::compileLogical(const ExpressionNary* expr, bool isAnd) {
+    // Each operand is followed by a jump to the short-circuit result, as soon as an operand of an
+    // $and is false or an operand of an $or is true.
+    std::vector<size_t> shortCircuits;
+    for (auto&& operand : expr->getOperandList()) {
+        compile(operand.get());
+        shortCircuits.push_back(
+            emit(isAnd ? OpCode::kJumpIfFalse : OpCode::kJumpIfTrue, 0, nullptr, -1));
+    }
+    emitConstant(Value(isAnd));
+    const size_t jumpToEnd = emit(OpCode::kJump, 0, nullptr, 0);
+
+    // The short-circuit result starts with the stack as it was before the result of the operands.
+    --_stackDepth;
+    for (auto&& jump : shortCircuits) {
+        _program[jump].arg = _program.size();
+    }
+    emitConstant(Value(!isAnd));
+    _program[jumpToEnd].arg = _program.size();
+}
+
+void CompiledExpression::compileCond(const ExpressionNary* expr) {
+    const auto& operands = expr->getOperandList();
+    compile(operands[0].get());
+    const size_t jumpToElse = emit(OpCode::kJumpIfFalse, 0, nullptr, -1);
+    compile(operands[1].get());
+    const size_t jumpToEnd = emit(OpCode::kJump, 0, nullptr, 0);
+
+    // The 'else' branch starts with the stack as it was before the result of the 'then' branch.
+    --_stackDepth;
+    _program[jumpToElse].arg = _program.size();
+    compile(operands[2].get());
+    _program[jumpToEnd].arg = _program.size();
+}
+
+size_t CompiledExpression::emit(OpCode op, uint32_t arg, const Expression* expr, int stackChange) {
+    _program.push_back({op, arg, expr});
+    _stackDepth += stackChange;
+    invariant(_stackDepth >= 0);
+    _maxStackDepth = std::max(_maxStackDepth, _stackDepth);
+    return _program.size() - 1;
+}
+
+void CompiledExpression::emitConstant(Value value) {
+    _constants.push_back(std::move(value));
+    emit(OpCode::kConstant, _constants.size() - 1, nullptr, 1);
+}
+
+Value CompiledExpression::evaluateFieldPath(const CompiledFieldPath& path,
+                                            const Document& root) const {
+    Value value = root.getField(path.fieldNames[0], path.fieldNameHashes[0]);
+    for (size_t i = 1; i < path.fieldNames.size(); ++i) {
+        switch (value.getType()) {
+            case Object:
+                value = value.getDocument().getField(path.fieldNames[i], path.fieldNameHashes[i]);
+                break;
+            case Array:
+                // Traversing arrays of documents is left to the expression.
+                return path.expr->evaluate(root);
+            default:
+                return Value();
+        }
+    }
+    return value;
+}
+
+}  // namespace mongo
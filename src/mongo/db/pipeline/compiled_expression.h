@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+class Expression;
+class ExpressionFieldPath;
+class ExpressionNary;
+
+/**
+ * A form of an aggregation Expression tree that is cheaper to evaluate against many documents.
+ *
+ * Evaluating an Expression is a walk over the tree through a virtual evaluate() call per node,
+ * which hashes every component of every field path again for each document. Compilation flattens
+ * the supported nodes into one program run over a stack of Values: constants, field paths rooted
+ * at $$CURRENT, $add, $subtract, $multiply, the comparisons, $and, $or, $not and $cond. The field
+ * names of each path are hashed once, when compiling. Any other node is evaluated through the
+ * Expression itself, so the result is always the same as Expression::evaluate().
+ *
+ * The compiled form holds pointers into the tree it was compiled from, which must outlive it and
+ * must not be changed (e.g. by optimize()) while it is in use. evaluate() uses a stack owned by
+ * this object, so a CompiledExpression must not be used by several threads at once.
+ */
+class CompiledExpression {
+    MONGO_DISALLOW_COPYING(CompiledExpression);
+
+public:
+    explicit CompiledExpression(const Expression* root);
+
+    /**
+     * Returns the result of evaluating the expression this was compiled from against 'root'.
+     */
+    Value evaluate(const Document& root) const;
+
+    /**
+     * Returns true if any part of the expression was compiled, i.e. if evaluate() does anything
+     * other than delegate to the original tree.
+     */
+    bool isCompiled() const {
+        return _program.size() > 1 || _program.front().op != OpCode::kEvaluate;
+    }
+
+private:
+    enum class OpCode : uint8_t {
+        // Pushes _constants[arg].
+        kConstant,
+        // Pushes the value of the field path _fieldPaths[arg].
+        kFieldPath,
+        // Pushes the result of 'expr->evaluate()'.
+        kEvaluate,
+        // Replaces the top 'arg' values with their sum, product or difference.
+        kAdd,
+        kMultiply,
+        kSubtract,
+        // Replaces the top two values with the result of the ExpressionCompare 'expr'.
+        kCompare,
+        // Replaces the top value with its negation as a boolean.
+        kNot,
+        // Pops the top value, and continues at instruction 'arg' if it is false (or true).
+        kJumpIfFalse,
+        kJumpIfTrue,
+        // Continues at instruction 'arg'.
+        kJump,
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t arg;
+        const Expression* expr;
+    };
+
+    struct CompiledFieldPath {
+        const ExpressionFieldPath* expr;
+        // The components of the path after "CURRENT", and their hashes for Document::getField().
+        std::vector<StringData> fieldNames;
+        std::vector<unsigned> fieldNameHashes;
+    };
+
+    /**
+     * Appends the instructions which leave the value of 'expr' on top of the stack.
+     */
+    void compile(const Expression* expr);
+
+    void compileFieldPath(const ExpressionFieldPath* expr);
+
+    /**
+     * Compiles 'expr', an $add, $multiply or $subtract, as its operands followed by 'op'.
+     */
+    void compileArithmetic(OpCode op, const ExpressionNary* expr);
+
+    /**
+     * Compiles an $and (if 'isAnd' is true) or $or, short-circuiting as the expressions do.
+     */
+    void compileLogical(const ExpressionNary* expr, bool isAnd);
+
+    void compileCond(const ExpressionNary* expr);
+
+    /**
+     * Appends an instruction and returns its index, keeping track of how much stack the program
+     * needs given that the instruction changes the size of the stack by 'stackChange'.
+     */
+    size_t emit(OpCode op, uint32_t arg, const Expression* expr, int stackChange);
+
+    void emitConstant(Value value);
+
+    Value evaluateFieldPath(const CompiledFieldPath& path, const Document& root) const;
+
+    const Expression* _root;
+
+    std::vector<Instruction> _program;
+    std::vector<Value> _constants;
+    std::vector<CompiledFieldPath> _fieldPaths;
+
+    // The size of the stack at the current end of the program while compiling, and the largest
+    // size the stack reaches.
+    int _stackDepth = 0;
+    int _maxStackDepth = 0;
+
+    mutable std::vector<Value> _stack;
+};
+
+}  // namespace mongo
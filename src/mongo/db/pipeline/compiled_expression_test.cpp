@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/compiled_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const std::vector<Document> kDocs = {
+    Document(fromjson("{}")),
+    Document(fromjson("{a: 1, b: 2}")),
+    Document(fromjson("{a: 5, b: 'x'}")),
+    Document(fromjson("{a: 5.5, b: 2.25, c: true}")),
+    Document(fromjson("{a: NumberLong(5), b: NumberDecimal('1.5')}")),
+    Document(fromjson("{a: 2147483647, b: 2147483647}")),
+    Document(fromjson("{a: null, b: 3}")),
+    Document(fromjson("{a: [1, 2], b: 'y'}")),
+    Document(fromjson("{a: {b: 5, c: 1}, b: 0, c: false}")),
+    Document(fromjson("{a: [{b: 5}, {b: 6}, 1], c: 1}")),
+    Document(fromjson("{a: {b: {c: 3}}, b: 'a', c: 'b'}")),
+    Document(fromjson("{a: {$date: 1000}, b: 10}")),
+    Document(fromjson("{e: 1, f: 2, g: 3, h: 4, a: 7, b: 8, c: 9}")),
+};
+
+/**
+ * Asserts that compiling 'spec' gives the same result as evaluating the original tree for every
+ * document in 'docs', including the same error. Returns whether any of the expression was
+ * compiled.
+ */
+bool assertCompiledEvaluatesSame(const BSONObj& spec,
+                                 const std::vector<Document>& docs = kDocs,
+                                 const CollatorInterface* collator = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(collator);
+    auto expr = Expression::parseOperand(expCtx, spec.firstElement(), expCtx->variablesParseState);
+    CompiledExpression compiled(expr.get());
+
+    for (auto&& doc : docs) {
+        Value expected;
+        Status expectedStatus = Status::OK();
+        try {
+            expected = expr->evaluate(doc);
+        } catch (const DBException& ex) {
+            expectedStatus = ex.toStatus();
+        }
+
+        if (!expectedStatus.isOK()) {
+            ASSERT_THROWS_CODE(compiled.evaluate(doc), AssertionException, expectedStatus.code());
+            continue;
+        }
+
+        Value result = compiled.evaluate(doc);
+        ASSERT_VALUE_EQ(expected, result);
+        ASSERT_EQ(expected.getType(), result.getType())
+            << "expression: " << spec << ", doc: " << doc.toString();
+    }
+    return compiled.isCompiled();
+}
+
+TEST(CompiledExpressionTest, ConstantsAndFieldPaths) {
+    ASSERT(assertCompiledEvaluatesSame(BSON("" << 7)));
+    ASSERT(assertCompiledEvaluatesSame(BSON(""
+                                            << "$a")));
+    ASSERT(assertCompiledEvaluatesSame(BSON(""
+                                            << "$a.b")));
+    ASSERT(assertCompiledEvaluatesSame(BSON(""
+                                            << "$a.b.c")));
+    ASSERT(assertCompiledEvaluatesSame(BSON(""
+                                            << "$$ROOT.c")));
+    ASSERT(assertCompiledEvaluatesSame(BSON(""
+                                            << "$missing")));
+}
+
+TEST(CompiledExpressionTest, WholeDocumentIsLeftToTheExpression) {
+    ASSERT_FALSE(assertCompiledEvaluatesSame(BSON(""
+                                                  << "$$CURRENT")));
+    ASSERT_FALSE(assertCompiledEvaluatesSame(BSON(""
+                                                  << "$$ROOT")));
+}
+
+TEST(CompiledExpressionTest, Arithmetic) {
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$add: ['$a', '$b']}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$add: ['$a', 1, '$b', 0.5]}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$add: []}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$multiply: ['$a', '$b', 2]}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$subtract: ['$a', '$b']}}")));
+    ASSERT(assertCompiledEvaluatesSame(
+        fromjson("{'': {$subtract: [{$multiply: ['$a', 3]}, {$add: ['$b', '$a.b']}]}}")));
+}
+
+TEST(CompiledExpressionTest, Comparisons) {
+    for (auto&& op : {"$eq", "$ne", "$gt", "$gte", "$lt", "$lte", "$cmp"}) {
+        ASSERT(assertCompiledEvaluatesSame(BSON("" << BSON(op << BSON_ARRAY("$a"
+                                                                                << "$b")))));
+        ASSERT(assertCompiledEvaluatesSame(BSON("" << BSON(op << BSON_ARRAY("$a.b" << 5)))));
+    }
+}
+
+TEST(CompiledExpressionTest, ComparisonsRespectTheCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$eq: ['$b', '$c']}}"), kDocs, &collator));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$lt: ['$b', 'z']}}"), kDocs, &collator));
+}
+
+TEST(CompiledExpressionTest, LogicalOperatorsAndCond) {
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$and: ['$a', '$c']}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$or: ['$a', '$c']}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$not: ['$c']}}")));
+    ASSERT(assertCompiledEvaluatesSame(
+        fromjson("{'': {$and: [{$gt: ['$a', 1]}, {$or: [{$eq: ['$b', 'x']}, '$c']}]}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$cond: ['$c', '$a', '$b']}}")));
+    ASSERT(assertCompiledEvaluatesSame(
+        fromjson("{'': {$cond: [{$lt: ['$a', 5]}, {$add: ['$a', 1]}, {$cond: ['$b', 1, 2]}]}}")));
+}
+
+TEST(CompiledExpressionTest, ShortCircuitingSkipsErrors) {
+    // The $add would fail for documents where 'b' is a string, unless $and or $cond stop first.
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$and: ['$c', {$add: ['$a', '$b']}]}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$or: ['$c', {$add: ['$a', '$b']}]}}")));
+    ASSERT(assertCompiledEvaluatesSame(
+        fromjson("{'': {$cond: ['$c', {$add: ['$a', '$b']}, 0]}}")));
+}
+
+TEST(CompiledExpressionTest, UnsupportedExpressionsAreEvaluatedInPlace) {
+    ASSERT(assertCompiledEvaluatesSame(
+        fromjson("{'': {$add: [{$size: {$ifNull: ['$a', []]}}, '$b']}}")));
+    ASSERT(assertCompiledEvaluatesSame(fromjson("{'': {$eq: [{$concat: ['$b', '$c']}, 'ab']}}")));
+    ASSERT_FALSE(assertCompiledEvaluatesSame(fromjson("{'': {$concat: ['$b', '$c']}}")));
+}
+
+TEST(CompiledExpressionTest, CompiledExpressionCanBeEvaluatedRepeatedly) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = Expression::parseOperand(expCtx,
+                                         fromjson("{'': {$add: ['$a', '$b']}}").firstElement(),
+                                         expCtx->variablesParseState);
+    CompiledExpression compiled(expr.get());
+
+    // An error part way through evaluation must not affect the next evaluation.
+    ASSERT_THROWS_CODE(
+        compiled.evaluate(Document{{"a", 1}, {"b", "x"_sd}}), AssertionException, 16554);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_VALUE_EQ(Value(2 * i), compiled.evaluate(Document{{"a", i}, {"b", i}}));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
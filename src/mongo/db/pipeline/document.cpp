@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/document.h"
 
+#include <algorithm>
 #include <boost/functional/hash.hpp>
 
 #include "mongo/bson/bson_depth.h"
@@ -52,10 +53,26 @@ const std::vector<StringData> Document::allMetadataFieldNames = {Document::metaF
                                                                  Document::metaFieldGeoNearPoint};
 
 Position DocumentStorage::findField(StringData requested) const {
+    const Position pos = findLoadedField(requested);
+    if (pos.found() || MONGO_likely(!_bsonNext))
+        return pos;
+
+    return const_cast<DocumentStorage*>(this)->loadLazily(requested);
+}
+
+Position DocumentStorage::findField(StringData requested, unsigned requestedHash) const {
+    const Position pos = findLoadedField(requested, &requestedHash);
+    if (pos.found() || MONGO_likely(!_bsonNext))
+        return pos;
+
+    return const_cast<DocumentStorage*>(this)->loadLazily(requested);
+}
+
+Position DocumentStorage::findLoadedField(StringData requested, const unsigned* nameHash) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
-        const unsigned bucket = bucketForKey(requested);
+        const unsigned bucket = nameHash ? (*nameHash & _hashTabMask) : bucketForKey(requested);
 
         Position pos = _hashTab[bucket];
         while (pos.found()) {
@@ -172,6 +189,64 @@ void DocumentStorage::alloc(unsigned newSize) {
 }
 
 void DocumentStorage::reserveFields(size_t expectedFields) {
+    // Using expectedFields+1 to allow space for long field names
+    reserveBytes(expectedFields, (expectedFields + 1) * ValueElement::align(sizeof(ValueElement)));
+}
+
+void DocumentStorage::reserveFields(size_t expectedFields, size_t expectedFieldNameBytes) {
+    // Every element is padded to the alignment boundary, which costs at most 'align - 1' bytes
+    // on top of the element header and its name.
+    const size_t maxPerFieldBytes = sizeof(ValueElement) + 7;
+    reserveBytes(expectedFields, expectedFields * maxPerFieldBytes + expectedFieldNameBytes);
+}
+
+void DocumentStorage::initLazily(BSONObj bson) {
+    dassert(bson.isOwned());
+
+    size_t numFields = 0;
+    size_t fieldNameBytes = 0;
+    for (auto&& bsonElement : bson) {
+        ++numFields;
+        fieldNameBytes += bsonElement.fieldNameSize() - 1;
+    }
+    if (numFields == 0)
+        return;
+
+    // Reserving the whole document up front means loading a field never moves the buffer.
+    reserveFields(numFields, fieldNameBytes);
+    _bson = std::move(bson);
+    _bsonNext = _bson.firstElement().rawdata();
+}
+
+Position DocumentStorage::loadLazily(boost::optional<StringData> requested) {
+    while (_bsonNext) {
+        const BSONElement bsonElement(_bsonNext);
+        if (bsonElement.eoo()) {
+            _bsonNext = nullptr;
+            break;
+        }
+        _bsonNext += bsonElement.size();
+
+        // Sub-documents share the buffer of '_bson' and are loaded lazily in turn.
+        Value val;
+        if (bsonElement.type() == BSONType::Object) {
+            intrusive_ptr<DocumentStorage> subStorage(new DocumentStorage());
+            subStorage->initLazily(
+                bsonElement.embeddedObject().shareOwnershipWith(_bson.sharedBuffer()));
+            val = Value(Document(subStorage.get()));
+        } else {
+            val = Value(bsonElement);
+        }
+
+        const Position pos = getNextPosition();
+        appendField(bsonElement.fieldNameStringData()) = std::move(val);
+        if (requested && bsonElement.fieldNameStringData() == *requested)
+            return pos;
+    }
+    return Position();
+}
+
+void DocumentStorage::reserveBytes(size_t expectedFields, size_t elementBytes) {
     fassert(16487, !_buffer);
 
     unsigned buckets = HASH_TAB_INIT_SIZE;
@@ -179,16 +254,15 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
         buckets *= 2;
     _hashTabMask = buckets - 1;
 
-    // Using expectedFields+1 to allow space for long field names
-    const size_t newSize = (expectedFields + 1) * ValueElement::align(sizeof(ValueElement));
+    uassert(16491, "Tried to make oversized document", elementBytes <= size_t(BufferMaxSize));
 
-    uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
-
-    _buffer = new char[newSize + hashTabBytes()];
-    _bufferEnd = _buffer + newSize;
+    _buffer = new char[elementBytes + hashTabBytes()];
+    _bufferEnd = _buffer + elementBytes;
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
+    // The clone is about to be modified, so it is never backed by BSON.
+    loadAllLazily();
     intrusive_ptr<DocumentStorage> out(new DocumentStorage());
 
     // Make a copy of the buffer.
@@ -228,7 +302,15 @@ DocumentStorage::~DocumentStorage() {
 }
 
 Document::Document(const BSONObj& bson) {
-    MutableDocument md(bson.nFields());
+    // Reserve room for the actual field names so that building the document never has to grow
+    // and copy its buffer, no matter how long the names are.
+    size_t numFields = 0;
+    size_t fieldNameBytes = 0;
+    for (auto&& bsonElement : bson) {
+        ++numFields;
+        fieldNameBytes += bsonElement.fieldNameSize() - 1;
+    }
+    MutableDocument md(numFields, fieldNameBytes);
 
     BSONObjIterator it(bson);
     while (it.more()) {
@@ -263,6 +345,14 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // An unmodified top-level document that was created lazily already has its BSON form. Nested
+    // documents are still converted field by field so that the depth limit is enforced.
+    const BSONObj& backingBson = storage().getBackingBson();
+    if (recursionLevel == 1 && !backingBson.isEmpty()) {
+        builder->appendElements(backingBson);
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
@@ -337,6 +427,40 @@ Document Document::fromBsonWithMetaData(const BSONObj& bson) {
     return md.freeze();
 }
 
+Document Document::fromBsonLazily(const BSONObj& bson) {
+    for (auto&& bsonElement : bson) {
+        const auto fieldName = bsonElement.fieldNameStringData();
+        if (fieldName[0] == '$' &&
+            std::find(allMetadataFieldNames.begin(), allMetadataFieldNames.end(), fieldName) !=
+                allMetadataFieldNames.end()) {
+            // Metadata is rare enough that it is not worth teaching the lazy path about it.
+            return fromBsonWithMetaData(bson);
+        }
+    }
+
+    intrusive_ptr<DocumentStorage> storage(new DocumentStorage());
+    storage->initLazily(bson.getOwned());
+    return Document(storage.get());
+}
+
+namespace {
+void loadLazyFieldsRecursively(const Value& val) {
+    if (val.getType() == BSONType::Object) {
+        val.getDocument().loadLazyFieldsRecursively();
+    } else if (val.getType() == BSONType::Array) {
+        for (auto&& elem : val.getArray()) {
+            loadLazyFieldsRecursively(elem);
+        }
+    }
+}
+}  // namespace
+
+void Document::loadLazyFieldsRecursively() const {
+    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+        mongo::loadLazyFieldsRecursively(it->val);
+    }
+}
+
 MutableDocument::MutableDocument(size_t expectedFields)
     : _storageHolder(NULL), _storage(_storageHolder) {
     if (expectedFields) {
@@ -344,6 +468,13 @@ MutableDocument::MutableDocument(size_t expectedFields)
     }
 }
 
+MutableDocument::MutableDocument(size_t expectedFields, size_t expectedFieldNameBytes)
+    : _storageHolder(NULL), _storage(_storageHolder) {
+    if (expectedFields) {
+        storage().reserveFields(expectedFields, expectedFieldNameBytes);
+    }
+}
+
 MutableValue MutableDocument::getNestedFieldHelper(const FieldPath& dottedField, size_t level) {
     if (level == dottedField.getPathLength() - 1) {
         return getField(dottedField.getFieldName(level));
@@ -408,7 +539,13 @@ size_t Document::getApproximateSize() const {
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
 
-    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+    // Fields that have not been loaded lazily yet are accounted for by the size of the BSON. Lazy
+    // sub-documents share their parent's buffer, which is only counted for the parent.
+    const BSONObj& backingBson = storage().getBackingBson();
+    if (!backingBson.isEmpty() && backingBson.objdata() == backingBson.sharedBuffer().get())
+        size += backingBson.objsize();
+
+    for (DocumentStorageIterator it = storage().iteratorAll(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
     }
@@ -123,6 +123,17 @@ public:
         return storage().getField(key);
     }
 
+    /**
+     * Like getField(StringData), but with the hash of 'key' already computed by hashFieldName().
+     * This saves rehashing the name for callers that look up the same field in many documents.
+     */
+    const Value getField(StringData key, unsigned keyHash) const {
+        return storage().getField(key, keyHash);
+    }
+    static unsigned hashFieldName(StringData key) {
+        return DocumentStorage::hashKey(key);
+    }
+
     /// Look up a field by Position. See positionOf and getNestedField.
     const Value operator[](Position pos) const {
         return getField(pos);
@@ -219,6 +230,24 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like fromBsonWithMetaData, but keeps a copy of 'bson' (or shares it, if it is owned) and only
+     * converts the fields that are looked up, as they are looked up. Sub-documents are loaded
+     * lazily as well. Iterating over the fields, comparing or hashing the document loads all of
+     * its top-level fields, and modifying it through MutableDocument loads it completely.
+     *
+     * Looking up a field mutates the document's storage, so the result must not be shared between
+     * threads before loadLazyFieldsRecursively() has been called.
+     */
+    static Document fromBsonLazily(const BSONObj& bson);
+
+    /**
+     * Loads every field of a document created by fromBsonLazily(), including those of its
+     * sub-documents, after which it is safe to read from multiple threads. A no-op for other
+     * documents, other than the cost of walking them.
+     */
+    void loadLazyFieldsRecursively() const;
+
     /**
      * Given a BSON object that may have metadata fields added as part of toBsonWithMetadata(),
      * returns the same object without any of the metadata fields.
@@ -299,6 +328,7 @@ public:
     }
 
 private:
+    friend class DocumentStorage;
     friend class FieldIterator;
     friend class ValueStorage;
     friend class MutableDocument;
@@ -418,11 +448,12 @@ public:
      *  @param expectedFields a hint at what the number of fields will be, if known.
      *         this can be used to increase memory allocation efficiency. There is
      *         no impact on correctness if this field over or under estimates.
-     *
-     *  TODO: find some way to convey field-name sizes to make even more efficient
+     *  @param expectedFieldNameBytes the total length of the expected field names. When given,
+     *         the buffer is sized to hold all of the fields without growing.
      */
     MutableDocument() : _storageHolder(NULL), _storage(_storageHolder) {}
     explicit MutableDocument(size_t expectedFields);
+    MutableDocument(size_t expectedFields, size_t expectedFieldNameBytes);
 
     /// No copy of data yet. Copy-on-write. See storage()
     explicit MutableDocument(Document d) : _storageHolder(NULL), _storage(_storageHolder) {
@@ -593,7 +624,9 @@ private:
             return clonedStorage();
 
         // This function exists to ensure this is safe
-        return const_cast<DocumentStorage&>(*storagePtr());
+        auto& ds = const_cast<DocumentStorage&>(*storagePtr());
+        ds.prepareForMutation();
+        return ds;
     }
     DocumentStorage& newStorage() {
         reset(new DocumentStorage);
@@ -32,6 +32,7 @@
 
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/optional.hpp>
 
 #include "mongo/base/static_assert.h"
 #include "mongo/db/pipeline/value.h"
@@ -190,7 +191,8 @@ public:
           _metaFields(),
           _textScore(0),
           _randVal(0),
-          _geoNearDistance(0) {}
+          _geoNearDistance(0),
+          _bsonNext(nullptr) {}
 
     ~DocumentStorage();
 
@@ -209,6 +211,41 @@ public:
         return kEmptyDoc;
     }
 
+    /**
+     * Makes this storage read its fields from 'bson' the first time they are looked up, rather than
+     * converting them all up front. 'bson' must be owned or share ownership of its buffer. Only
+     * valid to call before anything is added to the document.
+     *
+     * A storage that is being loaded lazily mutates itself in const accessors, so it must not be
+     * read from more than one thread at a time until loadAllLazily() has been called.
+     */
+    void initLazily(BSONObj bson);
+
+    /// Loads all fields that have not been read from the backing BSON yet.
+    void loadAllLazily() const {
+        if (MONGO_unlikely(_bsonNext))
+            const_cast<DocumentStorage*>(this)->loadLazily(boost::none);
+    }
+
+    /**
+     * Returns the BSON this storage was lazily created from, or an empty BSONObj if it was not
+     * created by initLazily() or has been modified since.
+     */
+    const BSONObj& getBackingBson() const {
+        return _bson;
+    }
+
+    /**
+     * Loads any remaining fields and forgets the backing BSON. MutableDocument calls this before
+     * modifying the storage, so that 'getBackingBson()' never returns stale contents.
+     */
+    void prepareForMutation() {
+        if (MONGO_unlikely(!_bson.isEmpty())) {
+            loadAllLazily();
+            _bson = BSONObj();
+        }
+    }
+
     size_t size() const {
         // can't use _numFields because it includes removed Fields
         size_t count = 0;
@@ -225,6 +262,17 @@ public:
     /// Returns the position of the named field (may be missing) or Position()
     Position findField(StringData name) const;
 
+    /// Like findField(StringData), but with the hash of 'name' already computed by hashKey().
+    Position findField(StringData name, unsigned nameHash) const;
+
+    /// Returns the hash of a field name, for use with findField(StringData, unsigned).
+    static unsigned hashKey(StringData name) {
+        // TODO consider FNV-1a once we have a better benchmark corpus
+        unsigned out;
+        MurmurHash3_x86_32(name.rawData(), name.size(), 0, &out);
+        return out;
+    }
+
     // Document uses these
     const ValueElement& getField(Position pos) const {
         verify(pos.found());
@@ -236,6 +284,12 @@ public:
             return Value();
         return getField(pos).val;
     }
+    Value getField(StringData name, unsigned nameHash) const {
+        Position pos = findField(name, nameHash);
+        if (!pos.found())
+            return Value();
+        return getField(pos).val;
+    }
 
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
@@ -257,12 +311,18 @@ public:
      */
     void reserveFields(size_t expectedFields);
 
+    /** Like reserveFields(size_t), but also takes the total length of the field names (not
+     *  including NUL terminators) so that documents with long field names do not have to grow.
+     */
+    void reserveFields(size_t expectedFields, size_t expectedFieldNameBytes);
+
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadAllLazily();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
-    /// This includes missing values
+    /// This includes missing values, but not fields that have not been loaded lazily yet
     DocumentStorageIterator iteratorAll() const {
         return DocumentStorageIterator(_firstElement, end(), true);
     }
@@ -360,9 +420,23 @@ private:
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
+    /// Preallocates 'elementBytes' of element space plus a hash table sized for 'expectedFields'.
+    void reserveBytes(size_t expectedFields, size_t elementBytes);
+
     /// Call after adding field to _buffer and increasing _numFields
     void addFieldToHashTable(Position pos);
 
+    /// Looks up a field among the fields that have been loaded so far. If 'nameHash' is non-null,
+    /// it is used as the hash of 'name' rather than hashing 'name' again.
+    Position findLoadedField(StringData name, const unsigned* nameHash = nullptr) const;
+
+    /**
+     * Appends fields from the backing BSON until one named 'requested' has been loaded and returns
+     * its position. Loads all remaining fields and returns Position() if there is no such field or
+     * 'requested' is boost::none.
+     */
+    Position loadLazily(boost::optional<StringData> requested);
+
     // assumes _hashTabMask is (power of two) - 1
     unsigned hashTabBuckets() const {
         return _hashTabMask + 1;
@@ -381,13 +455,6 @@ private:
         memset(_hashTab, -1, hashTabBytes());
     }
 
-    static unsigned hashKey(StringData name) {
-        // TODO consider FNV-1a once we have a better benchmark corpus
-        unsigned out;
-        MurmurHash3_x86_32(name.rawData(), name.size(), 0, &out);
-        return out;
-    }
-
     unsigned bucketForKey(StringData name) const {
         return hashKey(name) & _hashTabMask;
     }
@@ -435,6 +502,12 @@ private:
     BSONObj _sortKey;
     double _geoNearDistance;
     Value _geoNearPoint;
+
+    // When non-empty, this document was created by initLazily() and has not been modified since.
+    // The fields that have not been loaded yet are the elements of '_bson' starting at
+    // '_bsonNext', which is null once every field has been loaded.
+    BSONObj _bson;
+    const char* _bsonNext;
     // When adding a field, make sure to update clone() method
 
     // Defined in document.cpp
@@ -125,9 +125,23 @@ private:
     Value extractKey(const Document& doc);
 
     /**
-     * Calculates the bucket boundaries for the input documents and places them into buckets.
+     * Evaluates the arguments of the accumulators for 'doc', as a document with the names of the
+     * output fields. Only these are sorted, rather than whole documents, so that the sorter holds
+     * and spills as little as possible.
      */
-    void populateBuckets();
+    Document extractAccumulatorArguments(const Document& doc);
+
+    /**
+     * Starts reading the sorted input and makes the first bucket.
+     */
+    void initializeBucketIteration();
+
+    /**
+     * Places the next documents of the sorted input into a bucket, or returns boost::none if there
+     * are no more documents or buckets. The bucket's maximum is only final once the bucket after
+     * it is linked to it.
+     */
+    boost::optional<Bucket> makeNextBucket();
 
     /**
      * Adds the document in 'entry' to 'bucket' by updating the accumulators in 'bucket'.
@@ -135,9 +149,9 @@ private:
     void addDocumentToBucket(const std::pair<Value, Document>& entry, Bucket& bucket);
 
     /**
-     * Adds 'newBucket' to _buckets and updates any boundaries if necessary.
+     * Updates the boundaries of 'previous' and 'newBucket', which follows it, if necessary.
      */
-    void addBucket(Bucket& newBucket);
+    void linkBuckets(Bucket& previous, Bucket& newBucket);
 
     /**
      * Makes a document using the information from bucket. This is what is returned when getNext()
@@ -153,8 +167,11 @@ private:
     int _nBuckets;
     uint64_t _maxMemoryUsageBytes;
     bool _populated = false;
-    std::vector<Bucket> _buckets;
-    std::vector<Bucket>::iterator _bucketsIterator;
+    long long _approxBucketSize = 0;
+    int _nBucketsMade = 0;
+    boost::optional<std::pair<Value, Document>> _firstEntryInNextBucket;
+    // The next bucket to return.
+    boost::optional<Bucket> _currentBucket;
     boost::intrusive_ptr<Expression> _groupByExpression;
     boost::intrusive_ptr<GranularityRounder> _granularityRounder;
     long long _nDocuments = 0;
@@ -34,9 +34,11 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/pipeline/change_stream_oplog_entry_cache.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -70,7 +72,22 @@ DocumentSource::GetNextResult DocumentSourceCursor::getNext() {
 }
 
 Document DocumentSourceCursor::transformBSONObjToDocument(const BSONObj& obj) const {
-    return _dependencies ? _dependencies->extractFields(obj) : Document::fromBsonWithMetaData(obj);
+    if (_dependencies) {
+        return _dependencies->extractFields(obj);
+    }
+
+    if (_sharesOplogEntries) {
+        const long long cacheSizeBytes = internalChangeStreamOplogEntryCacheSizeBytes.load();
+        if (cacheSizeBytes > 0) {
+            return ChangeStreamOplogEntryCache::get(pExpCtx->opCtx->getServiceContext())
+                .getOrConvert(obj, cacheSizeBytes);
+        }
+    }
+
+    // The pipeline needs the whole document, but it may still only read a few of its fields.
+    return internalDocumentSourceCursorLateMaterialization.load()
+        ? Document::fromBsonLazily(obj)
+        : Document::fromBsonWithMetaData(obj);
 }
 
 void DocumentSourceCursor::loadBatch() {
@@ -314,7 +331,8 @@ DocumentSourceCursor::DocumentSourceCursor(
     : DocumentSource(pCtx),
       _docsAddedToBatches(0),
       _exec(std::move(exec)),
-      _outputSorts(_exec->getOutputSorts()) {
+      _outputSorts(_exec->getOutputSorts()),
+      _sharesOplogEntries(pExpCtx->isTailableAwaitData() && _exec->nss().isOplog()) {
     // Later code in the DocumentSourceCursor lifecycle expects that '_exec' is in a saved state.
     _exec->saveState();
 
@@ -221,6 +221,10 @@ private:
     Status _execStatus = Status::OK();
 
     BSONObjSet _outputSorts;
+
+    // Whether this cursor tails the oplog, as a change stream does, and so shares the conversion of
+    // the entries it reads through the ChangeStreamOplogEntryCache.
+    const bool _sharesOplogEntries;
     std::string _planSummary;
     PlanSummaryStats _planSummaryStats;
 
@@ -303,7 +303,8 @@ size_t Exchange::loadNextBatch() {
         switch (_policy) {
             case ExchangePolicyEnum::kBroadcast: {
                 bool full = false;
-                // The document is sent to all consumers.
+                // The document is sent to all consumers, which read it concurrently.
+                input.getDocument().loadLazyFieldsRecursively();
                 for (auto& c : _consumers) {
                     full = c->appendDocument(input, _maxBufferSize);
                 }
@@ -388,7 +389,7 @@ void Exchange::dispose(OperationContext* opCtx, size_t consumerId) {
 
     // If _errorInLoadNextBatch status is not OK then an exception was thrown. In that case the
     // throwing thread will do the dispose.
-    if (!_errorInLoadNextBatch.isOK()) {
+    if (!_errorInLoadNextBatch.isOK() && !_aborted) {
         if (_loadingThreadId == consumerId) {
             _pipeline->dispose(opCtx);
         }
@@ -397,6 +398,20 @@ void Exchange::dispose(OperationContext* opCtx, size_t consumerId) {
     }
 }
 
+void Exchange::abort(Status status) {
+    invariant(!status.isOK());
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    if (!_errorInLoadNextBatch.isOK()) {
+        return;
+    }
+
+    // No thread can be loading the buffers since we hold the lock, so '_pipeline' is detached.
+    _errorInLoadNextBatch = std::move(status);
+    _aborted = true;
+    _haveBufferSpace.notify_all();
+}
+
 DocumentSource::GetNextResult Exchange::ExchangeBuffer::getNext() {
     invariant(!_buffer.empty());
 
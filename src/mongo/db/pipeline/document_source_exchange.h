@@ -83,6 +83,12 @@ public:
 
     void dispose(OperationContext* opCtx, size_t consumerId);
 
+    /**
+     * Fails the exchange with 'status' on behalf of a consumer which will not read its buffer any
+     * further, so that the other consumers fail too instead of waiting for it forever.
+     */
+    void abort(Status status);
+
 private:
     size_t loadNextBatch();
 
@@ -147,6 +153,10 @@ private:
     // state all other producing threads will fail too.
     Status _errorInLoadNextBatch{Status::OK()};
 
+    // Set if '_errorInLoadNextBatch' was set by abort() rather than by a failure in
+    // loadNextBatch(), in which case '_pipeline' is detached and the last consumer disposes of it.
+    bool _aborted{false};
+
     size_t _roundRobinCounter{0};
 
     // A rundown counter of consumers disposing of the pipelines. Only the last consumer will
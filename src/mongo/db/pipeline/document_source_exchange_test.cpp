@@ -31,7 +31,10 @@
 #include "mongo/db/hasher.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_parallel_exchange.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/executor/thread_pool_task_executor.h"
@@ -474,6 +477,72 @@ TEST_F(DocumentSourceExchangeTest, RangeRandomHashExchangeNConsumer) {
     ASSERT_EQ(nDocs, processedDocs.load());
 }
 
+TEST_F(DocumentSourceExchangeTest, AbortFailsOtherConsumers) {
+    auto source = getMockSource(500);
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+    spec.setConsumers(2);
+    spec.setBufferSize(1024);
+
+    boost::intrusive_ptr<Exchange> ex =
+        new Exchange(spec, unittest::assertGet(Pipeline::create({source}, getExpCtx())));
+
+    ASSERT_TRUE(ex->getNext(getExpCtx()->opCtx, 0).isAdvanced());
+    ex->abort(Status(ErrorCodes::InternalError, "consumer failed"));
+
+    ASSERT_THROWS_CODE(
+        ex->getNext(getExpCtx()->opCtx, 1), AssertionException, ErrorCodes::InternalError);
+}
+
+TEST_F(DocumentSourceExchangeTest, ParallelExchangeMergesPartialGroupsOfAllConsumers) {
+    const size_t nDocs = 500;
+    const size_t nConsumers = 4;
+    auto opCtx = getExpCtx()->opCtx;
+    auto source = getMockSource(nDocs);
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+    spec.setConsumers(nConsumers);
+    spec.setBufferSize(1024);
+
+    boost::intrusive_ptr<Exchange> ex =
+        new Exchange(spec, unittest::assertGet(Pipeline::create({source}, getExpCtx())));
+    getExpCtx()->opCtx = opCtx;
+
+    auto groupSpec = BSON("$group" << BSON("_id" << BSON("$mod" << BSON_ARRAY("$a" << 10))
+                                                 << "count"
+                                                 << BSON("$sum" << 1)
+                                                 << "max"
+                                                 << BSON("$max"
+                                                         << "$a")));
+
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> consumers;
+    for (size_t idx = 0; idx < nConsumers; ++idx) {
+        auto consumerExpCtx = getExpCtx()->copyWith(getExpCtx()->ns);
+        consumerExpCtx->needsMerge = true;
+        auto consumer = unittest::assertGet(Pipeline::parse({groupSpec}, consumerExpCtx));
+        consumer->addInitialSource(new DocumentSourceExchange(consumerExpCtx, ex, idx));
+        consumers.push_back(std::move(consumer));
+    }
+    auto parallel = DocumentSourceParallelExchange::create(getExpCtx(), ex, std::move(consumers));
+
+    auto group = DocumentSourceGroup::createFromBson(groupSpec.firstElement(), getExpCtx());
+    auto mergingGroup = static_cast<DocumentSourceGroup*>(group.get())->createMergingGroup();
+    mergingGroup->setSource(parallel.get());
+
+    size_t nGroups = 0;
+    for (auto next = mergingGroup->getNext(); next.isAdvanced(); next = mergingGroup->getNext()) {
+        auto doc = next.releaseDocument();
+        ASSERT_VALUE_EQ(doc["count"], Value(static_cast<int>(nDocs / 10)));
+        ASSERT_VALUE_EQ(doc["max"], Value(static_cast<int>(nDocs - 10) + doc["_id"].coerceToInt()));
+        ++nGroups;
+    }
+    ASSERT_EQ(nGroups, 10u);
+
+    mergingGroup->dispose();
+}
+
 TEST_F(DocumentSourceExchangeTest, RejectNoConsumers) {
     BSONObj spec = BSON("policy"
                         << "broadcast"
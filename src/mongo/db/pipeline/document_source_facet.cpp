@@ -37,6 +37,8 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -45,8 +47,10 @@
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -176,16 +180,20 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     }
 
     vector<vector<Value>> results(_facets.size());
-    bool allPipelinesEOF = false;
-    while (!allPipelinesEOF) {
-        allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
-        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-            const auto& pipeline = _facets[facetId].pipeline;
-            auto next = pipeline->getSources().back()->getNext();
-            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
-                results[facetId].emplace_back(next.releaseDocument());
+    if (_maxThreads > 1) {
+        runFacetsOnThreads(&results);
+    } else {
+        bool allPipelinesEOF = false;
+        while (!allPipelinesEOF) {
+            allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
+            for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+                const auto& pipeline = _facets[facetId].pipeline;
+                auto next = pipeline->getSources().back()->getNext();
+                for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+                    results[facetId].emplace_back(next.releaseDocument());
+                }
+                allPipelinesEOF = allPipelinesEOF && next.isEOF();
             }
-            allPipelinesEOF = allPipelinesEOF && next.isEOF();
         }
     }
 
@@ -198,6 +206,115 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     return resultDoc.freeze();
 }
 
+void DocumentSourceFacet::runFacetsInParallel(
+    std::vector<boost::intrusive_ptr<ExpressionContext>> facetExpCtxs, size_t maxThreads) {
+    invariant(facetExpCtxs.size() == _facets.size());
+    invariant(!_done);
+
+    for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+        auto& facet = _facets[facetId];
+
+        // The DocumentSourceTeeConsumer at the front of the pipeline serializes to nothing.
+        vector<BSONObj> rawStages;
+        for (auto&& stage : facet.pipeline->serialize()) {
+            rawStages.push_back(stage.getDocument().toBson());
+        }
+        auto pipeline =
+            uassertStatusOK(Pipeline::parseFacetPipeline(rawStages, facetExpCtxs[facetId]));
+        pipeline->optimizePipeline();
+        pipeline->addInitialSource(
+            DocumentSourceTeeConsumer::create(facetExpCtxs[facetId], facetId, _teeBuffer));
+
+        // Disposing of the replaced pipeline would remove its facet as a consumer of _teeBuffer.
+        facet.pipeline.get_deleter().dismissDisposal();
+        facet.pipeline = std::move(pipeline);
+    }
+
+    _maxThreads = std::min(maxThreads, _facets.size());
+}
+
+void DocumentSourceFacet::runFacetsOnThreads(vector<vector<Value>>* results) {
+    auto opCtx = pExpCtx->opCtx;
+    auto serviceContext = opCtx->getServiceContext();
+    const auto deadline = opCtx->getDeadline();
+
+    // Each thread detaches its facet pipelines from its own operation when it is done with them.
+    ON_BLOCK_EXIT([&] {
+        for (auto&& facet : _facets) {
+            facet.pipeline->reattachToOperationContext(opCtx);
+        }
+    });
+
+    // Not a vector<bool>, since the threads write to neighbouring elements concurrently.
+    vector<char> facetsEOF(_facets.size(), false);
+    while (std::find(facetsEOF.begin(), facetsEOF.end(), false) != facetsEOF.end()) {
+        // Only this thread reads from the input of the $facet, which is attached to its operation.
+        // Once the input is exhausted, the facets see EOF and produce their final results.
+        _teeBuffer->loadNextBatchForConcurrentConsumers();
+
+        vector<Status> statuses(_maxThreads, Status::OK());
+        vector<stdx::thread> threads;
+        size_t numStarted = 1;
+        for (; numStarted < _maxThreads; ++numStarted) {
+            const size_t threadId = numStarted;
+            try {
+                threads.emplace_back([&, threadId] {
+                    const std::string threadName = str::stream() << "facet-" << threadId;
+                    Client::initThread(threadName, serviceContext, nullptr);
+                    auto facetOpCtx = cc().makeOperationContext();
+                    if (deadline != Date_t::max()) {
+                        facetOpCtx->setDeadlineByDate(deadline, ErrorCodes::MaxTimeMSExpired);
+                    }
+                    statuses[threadId] = runFacetsForBatch(
+                        facetOpCtx.get(), threadId, _maxThreads, results, &facetsEOF);
+                });
+            } catch (const std::exception&) {
+                // The facets of the threads which could not be started run on this one instead.
+                break;
+            }
+        }
+
+        statuses[0] = runFacetsForBatch(opCtx, 0, _maxThreads, results, &facetsEOF);
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+        for (size_t threadId = numStarted; threadId < _maxThreads; ++threadId) {
+            statuses[threadId] =
+                runFacetsForBatch(opCtx, threadId, _maxThreads, results, &facetsEOF);
+        }
+
+        for (auto&& status : statuses) {
+            uassertStatusOK(status);
+        }
+    }
+}
+
+Status DocumentSourceFacet::runFacetsForBatch(OperationContext* opCtx,
+                                              size_t firstFacetId,
+                                              size_t stride,
+                                              vector<vector<Value>>* results,
+                                              vector<char>* facetsEOF) {
+    for (size_t facetId = firstFacetId; facetId < _facets.size(); facetId += stride) {
+        if ((*facetsEOF)[facetId]) {
+            continue;
+        }
+
+        const auto& pipeline = _facets[facetId].pipeline;
+        pipeline->reattachToOperationContext(opCtx);
+        ON_BLOCK_EXIT([&] { pipeline->detachFromOperationContext(); });
+        try {
+            auto next = pipeline->getSources().back()->getNext();
+            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+                (*results)[facetId].emplace_back(next.releaseDocument());
+            }
+            (*facetsEOF)[facetId] = next.isEOF();
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+    }
+    return Status::OK();
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
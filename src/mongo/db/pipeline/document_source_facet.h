@@ -135,6 +135,15 @@ public:
         return _facets;
     }
 
+    /**
+     * Makes getNext() run the facet pipelines on up to 'maxThreads' threads at once, each thread
+     * with an operation of its own. Since the facets then must not share an ExpressionContext,
+     * each facet pipeline is replaced by one parsed from the same stages with the corresponding
+     * entry of 'facetExpCtxs'. Must be called before this stage returns any results.
+     */
+    void runFacetsInParallel(std::vector<boost::intrusive_ptr<ExpressionContext>> facetExpCtxs,
+                             size_t maxThreads);
+
     // The following are overridden just to forward calls to sub-pipelines.
     void addInvolvedCollections(std::vector<NamespaceString>* collections) const final;
     void detachFromOperationContext() final;
@@ -151,9 +160,28 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Runs the facet pipelines over all of the input on '_maxThreads' threads, loading every batch
+     * of '_teeBuffer' on this thread and then letting the threads consume it concurrently.
+     */
+    void runFacetsOnThreads(std::vector<std::vector<Value>>* results);
+
+    /**
+     * Consumes the current batch of '_teeBuffer' with the pipelines of facets 'firstFacetId',
+     * 'firstFacetId' + 'stride' and so on which have not reached EOF yet, running them on 'opCtx'.
+     */
+    Status runFacetsForBatch(OperationContext* opCtx,
+                             size_t firstFacetId,
+                             size_t stride,
+                             std::vector<std::vector<Value>>* results,
+                             std::vector<char>* facetsEOF);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
+    // Greater than 1 once runFacetsInParallel() has been called.
+    size_t _maxThreads = 1;
+
     bool _done = false;
 };
 }  // namespace mongo
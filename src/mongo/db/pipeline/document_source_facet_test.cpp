@@ -43,8 +43,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -406,6 +408,46 @@ TEST_F(DocumentSourceFacetTest, ShouldBeAbleToEvaluateMultipleStagesWithinOneSub
     ASSERT_DOCUMENT_EQ(output.getDocument(), Document(fromjson("{subPipe: [{_id: 0}, {_id: 1}]}")));
 }
 
+TEST_F(DocumentSourceFacetTest, ParallelFacetsProduceSameResultsAsSequentialFacets) {
+    auto ctx = getExpCtx();
+
+    // Use a tiny buffer so that the facets run over many batches.
+    const int originalBufferSize = internalQueryFacetBufferSizeBytes.load();
+    internalQueryFacetBufferSizeBytes.store(1);
+    ON_BLOCK_EXIT([&] { internalQueryFacetBufferSizeBytes.store(originalBufferSize); });
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 50; ++i) {
+        inputs.emplace_back(Document{{"_id", i}});
+    }
+
+    auto spec = fromjson(
+        "{$facet: {all: [{$match: {_id: {$gte: 0}}}], first: [{$limit: 1}], odd: [{$match: {_id: "
+        "{$mod: [2, 1]}}}, {$count: 'n'}], total: [{$group: {_id: null, n: {$sum: 1}}}]}}");
+    auto sequential = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    auto sequentialMock = DocumentSourceMock::create(inputs);
+    sequential->setSource(sequentialMock.get());
+
+    auto parallel = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    auto parallelFacet = static_cast<DocumentSourceFacet*>(parallel.get());
+    std::vector<boost::intrusive_ptr<ExpressionContext>> facetExpCtxs;
+    for (size_t facetId = 0; facetId < parallelFacet->getFacetPipelines().size(); ++facetId) {
+        facetExpCtxs.push_back(ctx->copyWith(ctx->ns));
+    }
+    const size_t maxThreads = 3;  // Fewer threads than facets.
+    parallelFacet->runFacetsInParallel(std::move(facetExpCtxs), maxThreads);
+    auto parallelMock = DocumentSourceMock::create(inputs);
+    parallel->setSource(parallelMock.get());
+
+    auto expected = sequential->getNext();
+    auto output = parallel->getNext();
+    ASSERT_TRUE(expected.isAdvanced());
+    ASSERT_TRUE(output.isAdvanced());
+    ASSERT_DOCUMENT_EQ(output.getDocument(), expected.getDocument());
+    ASSERT_EQ(output.getDocument()["all"].getArrayLength(), inputs.size());
+    ASSERT_TRUE(parallel->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceFacetTest, ShouldPropagateDisposeThroughToSource) {
     auto ctx = getExpCtx();
 
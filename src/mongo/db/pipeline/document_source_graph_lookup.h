@@ -33,11 +33,16 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
 class DocumentSourceGraphLookUp final : public DocumentSource {
 public:
+    // The maximum size of the $in values of a single query against the 'from' collection. A
+    // frontier with more values than this is queried for in several batches.
+    static constexpr size_t kMaxFrontierQueryBytes = BSONObjMaxUserSize / 2;
+
     static std::unique_ptr<LiteParsedDocumentSourceForeignCollections> liteParse(
         const AggregationRequest& request, const BSONElement& spec);
 
@@ -57,7 +62,7 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed);
 
@@ -74,6 +79,10 @@ public:
         collections->push_back(_from);
     }
 
+    bool usedDisk() final {
+        return _usedDisk;
+    }
+
     void detachFromOperationContext() final;
 
     void reattachToOperationContext(OperationContext* opCtx) final;
@@ -121,15 +130,16 @@ private:
     }
 
     /**
-     * Prepares the query to execute on the 'from' collection wrapped in a $match by using the
-     * contents of '_frontier'.
+     * Prepares the queries to execute on the 'from' collection wrapped in a $match by using the
+     * contents of '_frontier', splitting the values among as many queries as needed to keep each
+     * within 'kMaxFrontierQueryBytes'.
      *
      * Fills 'cached' with any values that were retrieved from the cache.
      *
-     * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
-     * Otherwise, returns a query object.
+     * Returns an empty vector if no query is necessary, i.e., all values were retrieved from the
+     * cache.
      */
-    boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
+    std::vector<BSONObj> makeMatchStagesFromFrontier(DocumentUnorderedSet* cached);
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -157,10 +167,29 @@ private:
 
     /**
      * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'. If disk use
+     * is allowed, spills '_visited' instead of failing when over the limit.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the documents in '_visited' to a sorted file, keeping their '_id's in
+     * '_spilledVisitedIds' so that the rest of the search can still de-duplicate against them.
+     */
+    void spill();
+
+    /**
+     * Returns whether any documents found by the current search have yet to be returned, either
+     * from '_visited' or from the spilled files.
+     */
+    bool hasVisited() const;
+
+    /**
+     * Removes and returns the next document found by the current search. Must only be called if
+     * hasVisited() is true.
+     */
+    Document popVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -186,7 +215,7 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -200,6 +229,17 @@ private:
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // Iterators over the documents of the current search which were spilled out of '_visited',
+    // each with at least one document left to return.
+    std::vector<std::unique_ptr<Sorter<Value, Document>::Iterator>> _spilledVisited;
+
+    // The '_id's of the documents in '_spilledVisited', kept for de-duplication until the search
+    // completes. Compared using the simple collation, as the keys of '_visited' are.
+    ValueUnorderedSet _spilledVisitedIds;
+    size_t _spilledVisitedIdsUsageBytes = 0;
+
+    bool _usedDisk = false;  // Keeps track of whether this $graphLookup spilled to disk.
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
@@ -37,9 +37,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -615,5 +618,155 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+/**
+ * Returns a $graphLookup over a chain of 'numDocs' documents of the form {_id: i, to: i + 1, pad:
+ * <string of 'padBytes' bytes>}, starting from the document with _id 0.
+ */
+boost::intrusive_ptr<DocumentSourceGraphLookUp> makeChainGraphLookUp(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    int numDocs,
+    size_t padBytes,
+    boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc = boost::none) {
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (int i = 0; i < numDocs; ++i) {
+        fromContents.emplace_back(
+            Document{{"_id", i}, {"to", i + 1}, {"pad", std::string(padBytes, 'x')}});
+    }
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    return DocumentSourceGraphLookUp::create(expCtx,
+                                             fromNs,
+                                             "results",
+                                             "to",
+                                             "_id",
+                                             ExpressionFieldPath::create(expCtx, "startVal"),
+                                             boost::none,
+                                             boost::none,
+                                             boost::none,
+                                             unwindSrc);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldErrorWhenExceedingMemoryLimitWithoutAllowDiskUse) {
+    auto expCtx = getExpCtx();
+    expCtx->allowDiskUse = false;
+
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    auto graphLookupStage = makeChainGraphLookUp(expCtx, 20, 1024);
+    graphLookupStage->setSource(inputMock.get());
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsWhenExceedingMemoryLimit) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    const int numDocs = 20;
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    auto graphLookupStage = makeChainGraphLookUp(expCtx, numDocs, 1024);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_TRUE(graphLookupStage->usedDisk());
+
+    // Every document in the chain is returned exactly once, whether or not it was spilled.
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(static_cast<size_t>(numDocs), resultsArray.size());
+    std::vector<int> ids;
+    for (auto&& result : resultsArray) {
+        ids.push_back(result.getDocument().getField("_id").getInt());
+    }
+    std::sort(ids.begin(), ids.end());
+    for (int i = 0; i < numDocs; ++i) {
+        ASSERT_EQ(i, ids[i]);
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsWhileUnwinding) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const auto originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    const int numDocs = 20;
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    auto unwindStage = DocumentSourceUnwind::create(expCtx, "results", false, boost::none);
+    auto graphLookupStage = makeChainGraphLookUp(expCtx, numDocs, 1024, unwindStage);
+    graphLookupStage->setSource(inputMock.get());
+
+    std::vector<int> ids;
+    for (auto next = graphLookupStage->getNext(); next.isAdvanced();
+         next = graphLookupStage->getNext()) {
+        ids.push_back(next.getDocument().getNestedField("results._id").getInt());
+    }
+    ASSERT_TRUE(graphLookupStage->usedDisk());
+
+    std::sort(ids.begin(), ids.end());
+    ASSERT_EQ(static_cast<size_t>(numDocs), ids.size());
+    for (int i = 0; i < numDocs; ++i) {
+        ASSERT_EQ(i, ids[i]);
+    }
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldQueryForLargeFrontierInSeveralBatches) {
+    auto expCtx = getExpCtx();
+
+    // Build a frontier whose values are larger in total than a single query allows.
+    const size_t numValues = 20;
+    const size_t valueBytes = DocumentSourceGraphLookUp::kMaxFrontierQueryBytes / 10;
+    std::vector<Value> startValues;
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (size_t i = 0; i < numValues; ++i) {
+        std::string key(valueBytes, 'a' + i);
+        startValues.push_back(Value(key));
+        fromContents.emplace_back(Document{{"_id", static_cast<int>(i)}, {"key", key}});
+    }
+
+    auto inputMock =
+        DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", std::move(startValues)}});
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "from",
+                                          "key",
+                                          ExpressionFieldPath::create(expCtx, "startVal"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(numValues, next.getDocument().getField("results").getArray().size());
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -33,11 +33,13 @@
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -173,6 +175,16 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     if (_groups->empty())
         return GetNextResult::makeEOF();
 
+    if (_sortedByGroupKey) {
+        const auto& group = *_sortedGroups[_nextSortedGroup];
+        Document out = makeDocument(group.first, group.second, pExpCtx->needsMerge);
+
+        if (++_nextSortedGroup == _sortedGroups.size())
+            dispose();
+
+        return std::move(out);
+    }
+
     Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
 
     if (++groupsIterator == _groups->end())
@@ -189,6 +201,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
             return nextInput;
         }
         _firstDocOfNextGroup = nextInput.releaseDocument();
+        _currentId = computeId(*_firstDocOfNextGroup);
     }
 
     Value id;
@@ -196,11 +209,15 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
         // Add to the current accumulator(s).
         for (size_t i = 0; i < _currentAccumulators.size(); i++) {
             _currentAccumulators[i]->process(
-                _accumulatedFields[i].expression->evaluate(*_firstDocOfNextGroup), _doingMerge);
+                _compiledAccumulatedExpressions[i]->evaluate(*_firstDocOfNextGroup), _doingMerge);
         }
 
-        // Retrieve the next document.
+        // Retrieve the next document. Once the input is exhausted, the current group is the last.
         auto nextInput = pSource->getNext();
+        if (nextInput.isEOF()) {
+            _firstDocOfNextGroup = boost::none;
+            return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+        }
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
@@ -219,13 +236,25 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
     return std::move(out);
 }
 
+void DocumentSourceGroup::detachFromOperationContext() {
+    _memCharge.detachFromOperationContext();
+}
+
+void DocumentSourceGroup::reattachToOperationContext(OperationContext* opCtx) {
+    _memCharge.reattachToOperationContext(opCtx);
+}
+
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _memoryUsageBytes = 0;
+    _memCharge.set(0);
 
     // Make us look done.
     groupsIterator = _groups->end();
+    _sortedGroups.clear();
+    _nextSortedGroup = 0;
 
     _firstDocOfNextGroup = boost::none;
 }
@@ -242,6 +271,10 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::optimize() {
         accumulatedField.expression = accumulatedField.expression->optimize();
     }
 
+    // The compiled expressions point into the trees which were just replaced.
+    _compiledIdExpressions.clear();
+    _compiledAccumulatedExpressions.clear();
+
     return this;
 }
 
@@ -276,13 +309,33 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
+    if (_sortedByGroupKey) {
+        insides["$sortedByGroupKey"] = Value(true);
+    }
+
+    if (_mergingSortedInput) {
+        insides["$mergingSortedInput"] = Value(true);
+    }
+
     if (explain && findRelevantInputSort()) {
         return Value(DOC("$streamingGroup" << insides.freeze()));
     }
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
+void DocumentSourceGroup::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (_unwindSrc) {
+        _unwindSrc->serializeToArray(array, explain);
+    }
+    DocumentSource::serializeToArray(array, explain);
+}
+
 DepsTracker::State DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
+    if (_unwindSrc) {
+        _unwindSrc->getDependencies(deps);
+    }
+
     // add the _id
     for (size_t i = 0; i < _idExpressions.size(); i++) {
         _idExpressions[i]->addDependencies(deps);
@@ -338,6 +391,7 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _doingMerge(false),
       _maxMemoryUsageBytes(maxMemoryUsageBytes ? *maxMemoryUsageBytes
                                                : internalDocumentSourceGroupMaxMemoryBytes.load()),
+      _memCharge(pExpCtx->opCtx),
       _inputSort(BSONObj()),
       _streaming(false),
       _initialized(false),
@@ -421,6 +475,15 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
             massert(17030, "$doingMerge should be true if present", groupField.Bool());
 
             pGroup->setDoingMerge(true);
+        } else if (str::equals(pFieldName, "$sortedByGroupKey")) {
+            uassert(50968, "$sortedByGroupKey should be true if present", groupField.trueValue());
+
+            pGroup->setSortedByGroupKey(true);
+        } else if (str::equals(pFieldName, "$mergingSortedInput")) {
+            uassert(
+                50969, "$mergingSortedInput should be true if present", groupField.trueValue());
+
+            pGroup->_mergingSortedInput = true;
         } else {
             // Any other field will be treated as an accumulator specification.
             pGroup->addAccumulator(
@@ -527,9 +590,13 @@ void getFieldPathListForSpilled(ExpressionObject* expressionObj,
 
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     const size_t numAccumulators = _accumulatedFields.size();
+    compileExpressions();
 
-    boost::optional<BSONObj> inputSort = findRelevantInputSort();
-    if (inputSort) {
+    // A merging $group whose input is sorted by group key can combine each group as it arrives.
+    boost::optional<BSONObj> inputSort =
+        _mergingSortedInput ? BSON("_id" << 1) : findRelevantInputSort();
+    invariant(!inputSort || !_unwindSrc);
+    if (inputSort && !_sortedByGroupKey) {
         // We can convert to streaming.
         _streaming = true;
         _inputSort = *inputSort;
@@ -555,64 +622,25 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     }
 
 
+    // Before we start to build the groups, wait for other queries to release memory if all of
+    // them together use more than they may.
+    if (_groups->empty() && pExpCtx->opCtx) {
+        QueryMemoryTracker::get(pExpCtx->opCtx)->waitForAdmission(pExpCtx->opCtx);
+    }
+
+    if (_inputCount) {
+        processInputCount();
+    }
+
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
+    GetNextResult input = _inputCount ? GetNextResult::makeEOF() : pSource->getNext();
     for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
-        }
-
         // We release the result document here so that it does not outlive the end of this loop
         // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
+        if (_unwindSrc) {
+            processUnwoundDocuments(input.releaseDocument());
         } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
-            }
-        }
-
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
-
-            _memoryUsageBytes += group[i]->memUsageForSorter();
-        }
-
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
-
-                _sortedFiles.push_back(spill());
-            }
+            processDocument(input.releaseDocument());
         }
     }
 
@@ -633,6 +661,8 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 
                 // We won't be using groups again so free its memory.
                 _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+                _memoryUsageBytes = 0;
+                _memCharge.set(0);
 
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
@@ -645,6 +675,15 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 
                 verify(_sorterIterator->more());  // we put data in, we should get something out.
                 _firstPartOfNextGroup = _sorterIterator->next();
+            } else if (_sortedByGroupKey) {
+                _sortedGroups.reserve(_groups->size());
+                for (auto&& group : *_groups) {
+                    _sortedGroups.push_back(&group);
+                }
+                std::stable_sort(_sortedGroups.begin(),
+                                 _sortedGroups.end(),
+                                 SpillSTLComparator(pExpCtx->getValueComparator()));
+                _nextSortedGroup = 0;
             } else {
                 // start the group iterator
                 groupsIterator = _groups->begin();
@@ -659,6 +698,101 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     MONGO_UNREACHABLE;
 }
 
+void DocumentSourceGroup::processDocument(const Document& root) {
+    const size_t numAccumulators = _accumulatedFields.size();
+
+    // While all queries together use more memory than they may, spill before reaching our own
+    // limit if we can.
+    const bool withinGlobalBudget = _memCharge.set(_memoryUsageBytes);
+    const bool spillEarly = !withinGlobalBudget && _allowDiskUse &&
+        _memoryUsageBytes >= QueryMemoryTracker::kMinEarlySpillBytes;
+    if (_memoryUsageBytes > _maxMemoryUsageBytes || spillEarly) {
+        uassert(16945,
+                "Exceeded memory limit for $group, but didn't allow external sort."
+                " Pass allowDiskUse:true to opt in.",
+                _allowDiskUse);
+        _sortedFiles.push_back(spill());
+        _memoryUsageBytes = 0;
+        _memCharge.set(0);
+    }
+
+    Value id = computeId(root);
+
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in '_groups' multiple times.
+    const size_t oldSize = _groups->size();
+    vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
+    const bool inserted = _groups->size() != oldSize;
+
+    if (inserted) {
+        _memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        group.reserve(numAccumulators);
+        for (auto&& accumulatedField : _accumulatedFields) {
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
+    } else {
+        for (auto&& groupObj : group) {
+            // subtract old mem usage. New usage added back after processing.
+            _memoryUsageBytes -= groupObj->memUsageForSorter();
+        }
+    }
+
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        group[i]->process(_compiledAccumulatedExpressions[i]->evaluate(root), _doingMerge);
+
+        _memoryUsageBytes += group[i]->memUsageForSorter();
+    }
+
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&                 // is a dup
+            !pExpCtx->inMongos &&        // can't spill to disk in mongos
+            !_allowDiskUse &&            // don't change behavior when testing external sort
+            _sortedFiles.size() < 20) {  // don't open too many FDs
+
+            _sortedFiles.push_back(spill());
+        }
+    }
+}
+
+void DocumentSourceGroup::processUnwoundDocuments(Document root) {
+    // WARNING: Any functional changes to this method must also be implemented in the unwinding
+    // implementation of the $unwind stage.
+    _unwindPathFieldIndexes.clear();
+    const Value inputArray =
+        root.getNestedField(_unwindSrc->unwindPath(), &_unwindPathFieldIndexes);
+
+    if (inputArray.getType() == Array) {
+        const auto& elements = inputArray.getArray();
+        if (elements.empty()) {
+            // Preserve documents with empty arrays if asked to, otherwise skip them.
+            if (_unwindSrc->preserveNullAndEmptyArrays()) {
+                MutableDocument output(std::move(root));
+                output.removeNestedField(_unwindPathFieldIndexes);
+                processDocument(output.freeze());
+            }
+            return;
+        }
+
+        // Each element replaces the array in the same document. The document is only copied if
+        // an accumulator, such as a $push of $$ROOT, holds on to the previous one.
+        MutableDocument output(std::move(root));
+        for (const auto& element : elements) {
+            output.setNestedField(_unwindPathFieldIndexes, element);
+            processDocument(output.peek());
+        }
+    } else if (!inputArray.nullish() || _unwindSrc->preserveNullAndEmptyArrays()) {
+        // Any non-nullish, non-array value passes through, as do nullish values if asked to.
+        processDocument(root);
+    }
+}
+
 bool DocumentSourceGroup::usedDisk() {
     return _usedDisk;
 }
@@ -711,9 +845,9 @@ boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
         return boost::none;
     }
 
-    if (!pSource) {
+    if (!pSource || _unwindSrc) {
         // Sometimes when performing an explain, or using $group as the merge point, 'pSource' will
-        // not be set.
+        // not be set. An absorbed $unwind changes the documents coming from 'pSource'.
         return boost::none;
     }
 
@@ -851,18 +985,36 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
 }
 
 
+void DocumentSourceGroup::compileExpressions() {
+    if (_compiledIdExpressions.size() != _idExpressions.size()) {
+        _compiledIdExpressions.clear();
+        for (auto&& idExpression : _idExpressions) {
+            _compiledIdExpressions.push_back(
+                stdx::make_unique<CompiledExpression>(idExpression.get()));
+        }
+    }
+
+    if (_compiledAccumulatedExpressions.size() != _accumulatedFields.size()) {
+        _compiledAccumulatedExpressions.clear();
+        for (auto&& accumulatedField : _accumulatedFields) {
+            _compiledAccumulatedExpressions.push_back(
+                stdx::make_unique<CompiledExpression>(accumulatedField.expression.get()));
+        }
+    }
+}
+
 Value DocumentSourceGroup::computeId(const Document& root) {
     // If only one expression, return result directly
-    if (_idExpressions.size() == 1) {
-        Value retValue = _idExpressions[0]->evaluate(root);
+    if (_compiledIdExpressions.size() == 1) {
+        Value retValue = _compiledIdExpressions[0]->evaluate(root);
         return retValue.missing() ? Value(BSONNULL) : std::move(retValue);
     }
 
     // Multiple expressions get results wrapped in a vector
     vector<Value> vals;
-    vals.reserve(_idExpressions.size());
-    for (size_t i = 0; i < _idExpressions.size(); i++) {
-        vals.push_back(_idExpressions[i]->evaluate(root));
+    vals.reserve(_compiledIdExpressions.size());
+    for (size_t i = 0; i < _compiledIdExpressions.size(); i++) {
+        vals.push_back(_compiledIdExpressions[i]->evaluate(root));
     }
     return Value(std::move(vals));
 }
@@ -906,14 +1058,49 @@ Document DocumentSourceGroup::makeDocument(const Value& id,
         }
     }
 
+    if (_sortedByGroupKey && mergeableOutput) {
+        // The merger merges the streams of partial groups from each shard using this sort key, so
+        // it must order the group keys the same way as the comparator that sorted them here.
+        out.setSortKeyMetaField(
+            BSON("" << DocumentSourceSort::getCollationComparisonKey(pExpCtx->getCollator(), id)));
+    }
+
     return out.freeze();
 }
 
 intrusive_ptr<DocumentSource> DocumentSourceGroup::getShardSource() {
-    return this;  // No modifications necessary when on shard
+    if (!internalDocumentSourceGroupMergeSortedPartialGroups.load()) {
+        return this;  // No modifications necessary when on shard
+    }
+
+    // The shards must return their partial groups in order of group key, which is a change to
+    // this stage, so build a copy of it to run on the shards.
+    intrusive_ptr<DocumentSourceGroup> shardGroup(
+        new DocumentSourceGroup(pExpCtx, _maxMemoryUsageBytes));
+    shardGroup->_idFieldNames = _idFieldNames;
+    shardGroup->_idExpressions = _idExpressions;
+    shardGroup->_accumulatedFields = _accumulatedFields;
+    shardGroup->_unwindSrc = _unwindSrc;
+    shardGroup->setDoingMerge(_doingMerge);
+    shardGroup->setSortedByGroupKey(true);
+    return shardGroup;
 }
 
 NeedsMergerDocumentSource::MergingLogic DocumentSourceGroup::mergingLogic() {
+    auto mergingGroup = createMergingGroup();
+
+    if (internalDocumentSourceGroupMergeSortedPartialGroups.load()) {
+        // The shards return their partial groups sorted by group key, see getShardSource(). The
+        // sort key pattern only tells the merger to merge the shards' streams in ascending order of
+        // the sort keys attached to each group.
+        mergingGroup->_mergingSortedInput = true;
+        return {mergingGroup, BSON("_id" << 1)};
+    }
+
+    return {mergingGroup};
+}
+
+intrusive_ptr<DocumentSourceGroup> DocumentSourceGroup::createMergingGroup() const {
     intrusive_ptr<DocumentSourceGroup> mergingGroup(new DocumentSourceGroup(pExpCtx));
     mergingGroup->setDoingMerge(true);
 
@@ -932,7 +1119,15 @@ NeedsMergerDocumentSource::MergingLogic DocumentSourceGroup::mergingLogic() {
         mergingGroup->addAccumulator(copiedAccumuledField);
     }
 
-    return {mergingGroup};
+    return mergingGroup;
+}
+
+bool DocumentSourceGroup::canMergePartialGroupsInAnyOrder() const {
+    return std::all_of(
+        _accumulatedFields.begin(), _accumulatedFields.end(), [this](const auto& accumulatedField) {
+            auto accumulator = accumulatedField.makeAccumulator(pExpCtx);
+            return accumulator->isAssociative() && accumulator->isCommutative();
+        });
 }
 
 bool DocumentSourceGroup::pathIncludedInGroupKeys(const std::string& dottedPath) const {
@@ -953,6 +1148,10 @@ bool DocumentSourceGroup::canRunInParallelBeforeOut(
         return true;  // This is fine.
     }
 
+    if (_unwindSrc) {
+        return false;  // Like a separate $unwind stage, which cannot run before $out in parallel.
+    }
+
     // Certain $group stages are allowed to execute on each exchange consumer. In order to
     // guarantee each consumer will only group together data from its own shard, the $group must
     // group on a superset of the shard key.
@@ -973,6 +1172,11 @@ bool DocumentSourceGroup::canRunInParallelBeforeOut(
 
 std::unique_ptr<GroupFromFirstDocumentTransformation>
 DocumentSourceGroup::rewriteGroupAsTransformOnFirstDocument() const {
+    if (_unwindSrc) {
+        // The first document of each group is an element of an unwound array.
+        return nullptr;
+    }
+
     if (!_idFieldNames.empty()) {
         // This transformation is only intended for $group stages that group on a single field.
         return nullptr;
@@ -1013,6 +1217,56 @@ DocumentSourceGroup::rewriteGroupAsTransformOnFirstDocument() const {
 
     return GroupFromFirstDocumentTransformation::create(pExpCtx, groupId, std::move(fields));
 }
+
+bool DocumentSourceGroup::onlyCountsInput() const {
+    if (_unwindSrc || _doingMerge) {
+        return false;
+    }
+
+    for (auto&& idExpression : _idExpressions) {
+        if (!ExpressionConstant::isNullOrConstant(idExpression)) {
+            return false;
+        }
+    }
+
+    for (auto&& accumulator : _accumulatedFields) {
+        auto constant = dynamic_cast<ExpressionConstant*>(accumulator.expression.get());
+        if (!constant || accumulator.makeAccumulator(pExpCtx)->getOpName() != "$sum"_sd ||
+            (constant->getValue().getType() != NumberInt &&
+             constant->getValue().getType() != NumberLong)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DocumentSourceGroup::processInputCount() {
+    if (*_inputCount == 0) {
+        // No document, and so no group.
+        return;
+    }
+
+    auto& group = (*_groups)[computeId(Document())];
+    for (auto&& accumulatedField : _accumulatedFields) {
+        const Value addend =
+            static_cast<ExpressionConstant*>(accumulatedField.expression.get())->getValue();
+
+        // Sum the constant '_inputCount' times at once, with the result type that summing it
+        // one document at a time gives.
+        int64_t sum;
+        Value total;
+        if (mongoSignedMultiplyOverflow64(addend.coerceToLong(), *_inputCount, &sum)) {
+            total = Value(addend.coerceToDouble() * *_inputCount);
+        } else if (addend.getType() == NumberInt) {
+            total = Value::createIntOrLong(sum);
+        } else {
+            total = Value(static_cast<long long>(sum));
+        }
+
+        group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        group.back()->process(total, false);
+    }
+}
 }  // namespace mongo
 
 #include "mongo/db/sorter/sorter.cpp"
@@ -33,8 +33,11 @@
 
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/compiled_expression.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/transformer_interface.h"
+#include "mongo/db/query/query_memory_tracker.h"
 #include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
@@ -100,6 +103,13 @@ public:
     BSONObjSet getOutputSorts() final;
     GetModPathsReturn getModifiedPaths() const final;
 
+    /**
+     * Serializes the absorbed $unwind stage, if any, before this stage.
+     */
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
     /**
      * Convenience method for creating a new $group stage. If maxMemoryUsageBytes is boost::none,
      * then it will actually use the value of internalDocumentSourceGroupMaxMemoryBytes.
@@ -155,6 +165,47 @@ public:
         return _streaming;
     }
 
+    /**
+     * Returns true if this $group stage returns its groups in order of group key, with the
+     * collation comparison key of each group key as the sort key metadata when the output needs
+     * merging.
+     */
+    bool isSortedByGroupKey() const {
+        return _sortedByGroupKey;
+    }
+
+    /**
+     * Tell this source to return its groups in order of group key. Defaults to false.
+     */
+    void setSortedByGroupKey(bool sortedByGroupKey) {
+        _sortedByGroupKey = sortedByGroupKey;
+    }
+
+    /**
+     * Returns true if this $group stage is merging partial groups which arrive sorted by group key,
+     * so that it can combine each group as it streams past instead of hashing every group.
+     */
+    bool isMergingSortedInput() const {
+        return _mergingSortedInput;
+    }
+
+    /**
+     * Returns true if this $group can take over the work of 'unwind', which immediately precedes
+     * it. Only an $unwind without 'includeArrayIndex' can be absorbed.
+     */
+    bool canAbsorbUnwind(const DocumentSourceUnwind& unwind) const {
+        return !_unwindSrc && !_doingMerge && !unwind.indexPath();
+    }
+
+    /**
+     * Makes this $group unwind the array of each input document itself, grouping each element in
+     * place rather than receiving a document per element from a separate $unwind stage.
+     */
+    void setUnwindSource(const boost::intrusive_ptr<DocumentSourceUnwind>& unwind) {
+        invariant(canAbsorbUnwind(*unwind));
+        _unwindSrc = unwind;
+    }
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -166,6 +217,19 @@ public:
     bool canRunInParallelBeforeOut(
         const std::set<std::string>& nameOfShardKeyFieldsUponEntryToStage) const final;
 
+    /**
+     * Returns true if every accumulator of this $group is associative and commutative, so that its
+     * result does not depend on how its input is split into partial groups or in which order the
+     * partial groups are merged.
+     */
+    bool canMergePartialGroupsInAnyOrder() const;
+
+    /**
+     * Creates a $group which merges the partial groups output by this $group, arriving in any
+     * order.
+     */
+    boost::intrusive_ptr<DocumentSourceGroup> createMergingGroup() const;
+
     /**
      * When possible, creates a document transformer that transforms the first document in a group
      * into one of the output documents of the $group stage. This is possible when we are grouping
@@ -178,6 +242,24 @@ public:
     std::unique_ptr<GroupFromFirstDocumentTransformation> rewriteGroupAsTransformOnFirstDocument()
         const;
 
+    /**
+     * Returns true if this $group puts every document in one group and each of its accumulators
+     * sums a constant integer, so that its output depends only on how many documents it reads.
+     */
+    bool onlyCountsInput() const;
+
+    /**
+     * Makes this $group, for which onlyCountsInput() is true, output the group of 'count' input
+     * documents without reading its input.
+     */
+    void setInputCount(long long count) {
+        invariant(onlyCountsInput());
+        _inputCount = count;
+    }
+
+    void detachFromOperationContext() final;
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
 protected:
     void doDispose() final;
 
@@ -212,6 +294,22 @@ private:
      */
     GetNextResult initialize();
 
+    /**
+     * Adds 'root' to the group it belongs to, spilling the groups to disk first if they exceed the
+     * memory limit.
+     */
+    void processDocument(const Document& root);
+
+    /**
+     * Processes each document which the absorbed $unwind stage would output for 'root'.
+     */
+    void processUnwoundDocuments(Document root);
+
+    /**
+     * Adds the group of '_inputCount' documents, when this $group only counts its input.
+     */
+    void processInputCount();
+
     /**
      * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
      * does not exhaust the previous stage before returning, and thus does not maintain as large a
@@ -221,6 +319,12 @@ private:
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
+    /**
+     * Compiles '_idExpressions' and the expressions of '_accumulatedFields', if they have not been
+     * compiled already.
+     */
+    void compileExpressions();
+
     /**
      * Computes the internal representation of the group key.
      */
@@ -241,11 +345,21 @@ private:
 
     bool _usedDisk;  // Keeps track of whether this $group spilled to disk.
     bool _doingMerge;
+    bool _sortedByGroupKey = false;
+    bool _mergingSortedInput = false;
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
+
+    // Charges '_memoryUsageBytes' against the memory of the operation and of all queries.
+    QueryMemoryTracker::Charge _memCharge;
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
 
+    // The compiled forms of '_idExpressions' and of the expressions of '_accumulatedFields', used
+    // to evaluate them for each input document. Cleared whenever the expressions are re-optimized.
+    std::vector<std::unique_ptr<CompiledExpression>> _compiledIdExpressions;
+    std::vector<std::unique_ptr<CompiledExpression>> _compiledAccumulatedExpressions;
+
     BSONObj _inputSort;
     bool _streaming;
     bool _initialized;
@@ -264,6 +378,11 @@ private:
     // Only used when '_spilled' is false.
     GroupsMap::iterator groupsIterator;
 
+    // Only used when '_spilled' is false and '_sortedByGroupKey' is true. Points into '_groups' in
+    // order of group key.
+    std::vector<const GroupsMap::value_type*> _sortedGroups;
+    size_t _nextSortedGroup = 0;
+
     // Only used when '_spilled' is true.
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
     const bool _allowDiskUse;
@@ -271,6 +390,14 @@ private:
     std::pair<Value, Value> _firstPartOfNextGroup;
     // Only used when '_sorted' is true.
     boost::optional<Document> _firstDocOfNextGroup;
+
+    // The $unwind stage which preceded this stage, if it was absorbed. Each input document is then
+    // unwound in place, one element at a time, by processUnwoundDocuments().
+    boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
+    std::vector<Position> _unwindPathFieldIndexes;
+
+    // If set, the number of documents this $group counts in place of reading its input.
+    boost::optional<long long> _inputCount;
 };
 
 }  // namespace mongo
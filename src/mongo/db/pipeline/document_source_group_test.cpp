@@ -30,6 +30,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <deque>
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -46,11 +47,14 @@
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 
@@ -227,6 +231,198 @@ TEST_F(DocumentSourceGroupTest, ShouldNotReportDottedGroupKeyAsARename) {
     ASSERT_EQ(modifiedPathsRet.renames.size(), 0UL);
 }
 
+TEST_F(DocumentSourceGroupTest, PartialGroupsCanBeMergedInAnyOrderOnlyForCommutativeAccumulators) {
+    auto expCtx = getExpCtx();
+    auto commutative = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: '$x', total: {$sum: '$y'}, low: {$min: '$y'}, set: {$addToSet: "
+                 "'$y'}}}")
+            .firstElement(),
+        expCtx);
+    ASSERT_TRUE(
+        static_cast<DocumentSourceGroup*>(commutative.get())->canMergePartialGroupsInAnyOrder());
+
+    auto orderSensitive = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: '$x', total: {$sum: '$y'}, first: {$first: '$y'}}}")
+            .firstElement(),
+        expCtx);
+    ASSERT_FALSE(
+        static_cast<DocumentSourceGroup*>(orderSensitive.get())->canMergePartialGroupsInAnyOrder());
+}
+
+TEST_F(DocumentSourceGroupTest, SplitGroupMergesPartialGroupsSortedByKeyWhenEnabled) {
+    bool oldMergeSorted = internalDocumentSourceGroupMergeSortedPartialGroups.load();
+    ON_BLOCK_EXIT([oldMergeSorted] {
+        internalDocumentSourceGroupMergeSortedPartialGroups.store(oldMergeSorted);
+    });
+    internalDocumentSourceGroupMergeSortedPartialGroups.store(true);
+
+    auto expCtx = getExpCtx();
+    auto spec = fromjson("{$group: {_id: '$x', total: {$sum: '$y'}}}");
+    auto group = DocumentSourceGroup::createFromBson(spec.firstElement(), expCtx);
+    auto splittable = dynamic_cast<NeedsMergerDocumentSource*>(group.get());
+    ASSERT(splittable);
+
+    auto shardGroup = dynamic_cast<DocumentSourceGroup*>(splittable->getShardSource().get());
+    ASSERT(shardGroup);
+    ASSERT_NOT_EQUALS(group.get(), shardGroup);
+    ASSERT_TRUE(shardGroup->isSortedByGroupKey());
+    ASSERT_FALSE(static_cast<DocumentSourceGroup*>(group.get())->isSortedByGroupKey());
+
+    auto mergeLogic = splittable->mergingLogic();
+    auto mergingGroup = dynamic_cast<DocumentSourceGroup*>(mergeLogic.mergingStage.get());
+    ASSERT(mergingGroup);
+    ASSERT_TRUE(mergingGroup->isMergingSortedInput());
+    ASSERT(mergeLogic.inputSortPattern);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), *mergeLogic.inputSortPattern);
+
+    // Both flags must survive being sent to the shards or to a merging shard.
+    vector<Value> serialized;
+    shardGroup->serializeToArray(serialized);
+    ASSERT_EQ(1UL, serialized.size());
+    ASSERT_VALUE_EQ(Value(true), serialized[0]["$group"]["$sortedByGroupKey"]);
+    serialized.clear();
+    mergingGroup->serializeToArray(serialized);
+    ASSERT_EQ(1UL, serialized.size());
+    ASSERT_VALUE_EQ(Value(true), serialized[0]["$group"]["$mergingSortedInput"]);
+}
+
+TEST_F(DocumentSourceGroupTest, GroupSortedByGroupKeyReturnsGroupsInOrderWithSortKeys) {
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;  // Disallow the spills debug builds do to stress merging.
+    expCtx->needsMerge = true;
+    auto spec = fromjson("{$group: {_id: '$x', total: {$sum: '$y'}, $sortedByGroupKey: true}}");
+    auto group = DocumentSourceGroup::createFromBson(spec.firstElement(), expCtx);
+    auto mock = DocumentSourceMock::create({Document{{"x", 3}, {"y", 1}},
+                                            Document{{"x", 1}, {"y", 2}},
+                                            Document{{"x", 2}, {"y", 3}},
+                                            Document{{"x", 1}, {"y", 4}}});
+    group->setSource(mock.get());
+
+    for (auto&& expected : {std::make_pair(1, 6), std::make_pair(2, 3), std::make_pair(3, 1)}) {
+        auto next = group->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto doc = next.releaseDocument();
+        ASSERT_DOCUMENT_EQ(doc, (Document{{"_id", expected.first}, {"total", expected.second}}));
+        ASSERT_TRUE(doc.hasSortKeyMetaField());
+        ASSERT_BSONOBJ_EQ(BSON("" << expected.first), doc.getSortKeyMetaField());
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGroupTest, GroupMergingSortedInputCombinesEachGroupAsItStreams) {
+    auto expCtx = getExpCtx();
+    auto spec = fromjson(
+        "{$group: {_id: '$$ROOT._id', total: {$sum: '$$ROOT.total'}, $doingMerge: true, "
+        "$mergingSortedInput: true}}");
+    auto group = DocumentSourceGroup::createFromBson(spec.firstElement(), expCtx);
+    auto mock = DocumentSourceMock::create({Document{{"_id", 1}, {"total", 2}},
+                                            Document{{"_id", 1}, {"total", 3}},
+                                            Document{{"_id", 2}, {"total", 1}},
+                                            Document{{"_id", 3}, {"total", 4}},
+                                            Document{{"_id", 3}, {"total", 1}}});
+    group->setSource(mock.get());
+
+    auto next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_TRUE(static_cast<DocumentSourceGroup*>(group.get())->isStreaming());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 1}, {"total", 5}}));
+
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 2}, {"total", 1}}));
+
+    // The last group is returned once the input is exhausted.
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 3}, {"total", 5}}));
+
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGroupTest, GroupAbsorbsPrecedingUnwindAndGroupsEachArrayElement) {
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;  // Disallow the spills debug builds do to stress merging.
+    std::vector<BSONObj> rawPipeline = {
+        fromjson("{$unwind: '$items'}"),
+        fromjson("{$group: {_id: '$items.sku', qty: {$sum: '$items.qty'}, lines: {$sum: 1}}}")};
+    auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, expCtx));
+    pipeline->optimizePipeline();
+
+    // The $unwind runs inside the $group, but is still serialized as its own stage.
+    ASSERT_EQ(pipeline->getSources().size(), 1UL);
+    auto serialized = pipeline->serialize();
+    ASSERT_EQ(serialized.size(), 2UL);
+    ASSERT_VALUE_EQ(serialized[0], Value(fromjson("{$unwind: {path: '$items'}}")));
+
+    auto mock = DocumentSourceMock::create(
+        {Document(fromjson("{items: [{sku: 'a', qty: 1}, {sku: 'b', qty: 2}]}")),
+         Document(fromjson("{items: [{sku: 'a', qty: 3}]}")),
+         Document(fromjson("{items: []}")),
+         Document(fromjson("{other: 1}")),
+         Document(fromjson("{items: {sku: 'c', qty: 5}}"))});
+    pipeline->addInitialSource(mock);
+
+    std::map<std::string, Document> results;
+    while (auto next = pipeline->getNext()) {
+        results[next->getField("_id").getString()] = *next;
+    }
+    ASSERT_EQ(results.size(), 3UL);
+    ASSERT_DOCUMENT_EQ(results["a"], (Document{{"_id", "a"_sd}, {"qty", 4}, {"lines", 2}}));
+    ASSERT_DOCUMENT_EQ(results["b"], (Document{{"_id", "b"_sd}, {"qty", 2}, {"lines", 1}}));
+    ASSERT_DOCUMENT_EQ(results["c"], (Document{{"_id", "c"_sd}, {"qty", 5}, {"lines", 1}}));
+}
+
+TEST_F(DocumentSourceGroupTest, GroupDoesNotAbsorbUnwindWithArrayIndex) {
+    std::vector<BSONObj> rawPipeline = {
+        fromjson("{$unwind: {path: '$items', includeArrayIndex: 'i'}}"),
+        fromjson("{$group: {_id: '$i', lines: {$sum: 1}}}")};
+    auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, getExpCtx()));
+    pipeline->optimizePipeline();
+    ASSERT_EQ(pipeline->getSources().size(), 2UL);
+}
+
+TEST_F(DocumentSourceGroupTest, OnlyCountsInputWhenEveryAccumulatorSumsAConstantIntoOneGroup) {
+    auto parseGroup = [&](const char* spec) {
+        auto group =
+            DocumentSourceGroup::createFromBson(fromjson(spec).firstElement(), getExpCtx());
+        return boost::intrusive_ptr<DocumentSourceGroup>(
+            static_cast<DocumentSourceGroup*>(group.get()));
+    };
+    ASSERT_TRUE(parseGroup("{$group: {_id: null, n: {$sum: 1}}}")->onlyCountsInput());
+    ASSERT_TRUE(parseGroup("{$group: {_id: {a: 1}, n: {$sum: 1}, twice: {$sum: {$numberLong: "
+                           "'2'}}}}")
+                    ->onlyCountsInput());
+    ASSERT_FALSE(parseGroup("{$group: {_id: '$a', n: {$sum: 1}}}")->onlyCountsInput());
+    ASSERT_FALSE(parseGroup("{$group: {_id: null, n: {$sum: '$a'}}}")->onlyCountsInput());
+    ASSERT_FALSE(parseGroup("{$group: {_id: null, n: {$sum: 1.5}}}")->onlyCountsInput());
+    ASSERT_FALSE(parseGroup("{$group: {_id: null, n: {$max: 1}}}")->onlyCountsInput());
+}
+
+TEST_F(DocumentSourceGroupTest, GroupWithInputCountOutputsSumsWithoutReadingInput) {
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: null, n: {$sum: 1}, twice: {$sum: {$numberLong: '2'}}, big: "
+                 "{$sum: 2147483647}}}")
+            .firstElement(),
+        getExpCtx());
+    auto groupStage = static_cast<DocumentSourceGroup*>(group.get());
+    groupStage->setInputCount(3);
+
+    auto next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", BSONNULL},
+                                 {"n", 3},
+                                 {"twice", 6LL},
+                                 {"big", 3LL * std::numeric_limits<int>::max()}}));
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    // Without any document, there is no group.
+    auto emptyGroup = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: null, n: {$sum: 1}}}").firstElement(), getExpCtx());
+    static_cast<DocumentSourceGroup*>(emptyGroup.get())->setInputCount(0);
+    ASSERT_TRUE(emptyGroup->getNext().isEOF());
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
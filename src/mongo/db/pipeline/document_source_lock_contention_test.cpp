@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_lock_contention.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class DocumentSourceLockContentionTest : public AggregationContextFixture {
+public:
+    DocumentSourceLockContentionTest()
+        : AggregationContextFixture(NamespaceString::makeCollectionlessAggregateNSS("admin")) {}
+};
+
+TEST_F(DocumentSourceLockContentionTest, ShouldFailToParseIfSpecIsNotObject) {
+    const auto specObj = fromjson("{$lockContention: 1}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceLockContention::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::FailedToParse);
+}
+
+TEST_F(DocumentSourceLockContentionTest, ShouldFailToParseOnACollection) {
+    const auto specObj = fromjson("{$lockContention: {}}");
+    getExpCtx()->ns = NamespaceString("admin.coll");
+    ASSERT_THROWS_CODE(
+        DocumentSourceLockContention::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::InvalidNamespace);
+}
+
+TEST_F(DocumentSourceLockContentionTest, CannotCreateWhenInMongos) {
+    const auto specObj = fromjson("{$lockContention: {}}");
+    getExpCtx()->inMongos = true;
+    ASSERT_THROWS_CODE(
+        DocumentSourceLockContention::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        51010);
+}
+
+TEST_F(DocumentSourceLockContentionTest, CanParseAndSerializeSuccessfully) {
+    const auto specObj = fromjson("{$lockContention: {}}");
+    auto stage =
+        DocumentSourceLockContention::createFromBson(specObj.firstElement(), getExpCtx());
+    std::vector<Value> serialized;
+    stage->serializeToArray(serialized);
+    ASSERT_EQ(1u, serialized.size());
+    ASSERT_BSONOBJ_EQ(specObj, serialized[0].getDocument().toBson());
+}
+
+TEST_F(DocumentSourceLockContentionTest, ReturnsOneDocumentPerSample) {
+    auto& profiler = LockContentionProfiler::get();
+    profiler.clear();
+
+    LockContentionProfiler::Sample sample;
+    sample.resId = ResourceId(RESOURCE_COLLECTION, "test.coll"_sd);
+    sample.resourceName = "test.coll";
+    sample.mode = MODE_IX;
+    sample.opType = "insert";
+    sample.holders.push_back({MODE_X, "createIndexes"});
+    sample.waitTime = Microseconds(1500);
+    sample.result = LOCK_OK;
+    profiler.record(sample);
+    profiler.record(sample);
+
+    const auto specObj = fromjson("{$lockContention: {}}");
+    auto stage =
+        DocumentSourceLockContention::createFromBson(specObj.firstElement(), getExpCtx());
+
+    int numSamples = 0;
+    for (auto next = stage->getNext(); next.isAdvanced(); next = stage->getNext()) {
+        auto doc = next.releaseDocument();
+        ASSERT_VALUE_EQ(Value("test.coll"_sd), doc.getNestedField(FieldPath("resource.ns")));
+        ASSERT_VALUE_EQ(Value("insert"_sd), doc["opType"]);
+        ASSERT_VALUE_EQ(Value("createIndexes"_sd), doc["holders"][0]["opType"]);
+        ASSERT_EQ(1500, doc["waitMicros"].coerceToLong());
+        ++numSamples;
+    }
+    ASSERT_EQ(2, numSamples);
+    profiler.clear();
+}
+
+}  // namespace
+}  // namespace mongo
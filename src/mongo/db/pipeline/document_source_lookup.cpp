@@ -66,6 +66,7 @@ std::string pipelineToString(const vector<BSONObj>& pipeline) {
 }  // namespace
 
 constexpr size_t DocumentSourceLookUp::kMaxSubPipelineDepth;
+constexpr size_t DocumentSourceLookUp::kMaxBatchKeysSizeBytes;
 
 DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
                                            std::string as,
@@ -235,6 +236,18 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
+    if (!_batchedOutputs.empty()) {
+        auto output = std::move(_batchedOutputs.front());
+        _batchedOutputs.pop_front();
+        return std::move(output);
+    }
+
+    if (_batchEndResult) {
+        auto batchEndResult = std::move(*_batchEndResult);
+        _batchEndResult = boost::none;
+        return batchEndResult;
+    }
+
     auto nextInput = pSource->getNext();
     if (!nextInput.isAdvanced()) {
         return nextInput;
@@ -246,6 +259,26 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
+    boost::optional<std::vector<Value>> results;
+    if (!wasConstructedWithPipelineSyntax()) {
+        results = probeHashTable(inputDoc);
+
+        const auto batchSize = internalDocumentSourceLookupBatchSize.load();
+        if (!results && batchSize > 1) {
+            return lookUpBatch(std::move(inputDoc), batchSize);
+        }
+    }
+
+    if (!results) {
+        results = lookUpInForeignCollection(inputDoc);
+    }
+
+    MutableDocument output(std::move(inputDoc));
+    output.setNestedField(_as, Value(std::move(*results)));
+    return output.freeze();
+}
+
+std::vector<Value> DocumentSourceLookUp::lookUpInForeignCollection(const Document& inputDoc) {
     if (!wasConstructedWithPipelineSyntax()) {
         auto matchStage =
             makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
@@ -267,14 +300,153 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
                 objsize <= BSONObjMaxInternalSize);
         results.emplace_back(std::move(*result));
     }
-    for (auto&& source : pipeline->getSources()) {
+    recordUsedDisk(*pipeline);
+    return results;
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::lookUpBatch(Document firstInput,
+                                                                size_t batchSize) {
+    invariant(!wasConstructedWithPipelineSyntax());
+    invariant(_batchedOutputs.empty() && !_batchEndResult);
+
+    // Gather the batch of local documents and the values each of them joins on. The batch is also
+    // ended early if the combined values would make the foreign query too large.
+    std::vector<Document> inputs;
+    std::vector<std::vector<Value>> inputKeys;
+    std::vector<Value> allKeys;
+    size_t keysSizeBytes = 0;
+    auto addInput = [&](Document input) {
+        inputKeys.push_back(getLocalFieldValues(input, *_localField));
+        for (auto&& key : inputKeys.back()) {
+            keysSizeBytes += key.getApproximateSize();
+            allKeys.push_back(key);
+        }
+        inputs.push_back(std::move(input));
+    };
+
+    addInput(std::move(firstInput));
+    while (inputs.size() < batchSize && keysSizeBytes < kMaxBatchKeysSizeBytes) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            // Hold back the pause or EOF until the batch it ended has been returned.
+            _batchEndResult = std::move(nextInput);
+            break;
+        }
+        addInput(nextInput.releaseDocument());
+    }
+
+    // Query the foreign collection once for all of the values, then hand each local document the
+    // foreign documents matching its own values.
+    LookupHashTable matches(_fromExpCtx->getValueComparator(),
+                            *_foreignField,
+                            internalDocumentSourceLookupCacheSizeBytes.load());
+    {
+        _resolvedPipeline.back() =
+            makeMatchStageFromValues(allKeys, _foreignField->fullPath(), BSONObj());
+        auto pipeline = buildPipeline(inputs.front());
+        while (auto result = pipeline->getNext()) {
+            matches.add(std::move(*result));
+            if (matches.isAbandoned()) {
+                break;
+            }
+        }
+        recordUsedDisk(*pipeline);
+    }
+    if (matches.isBuilding()) {
+        matches.freeze();
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        std::vector<Value> results;
+        if (matches.isServing()) {
+            results = matches.probe(inputKeys[i]);
+            assertResultsFitInDocument(results);
+        } else {
+            // The foreign documents matching the batch did not fit in memory, so look up each local
+            // document on its own.
+            results = lookUpInForeignCollection(inputs[i]);
+        }
+
+        MutableDocument output(std::move(inputs[i]));
+        output.setNestedField(_as, Value(std::move(results)));
+        _batchedOutputs.push_back(output.freeze());
+    }
+
+    auto output = std::move(_batchedOutputs.front());
+    _batchedOutputs.pop_front();
+    return std::move(output);
+}
+
+void DocumentSourceLookUp::recordUsedDisk(const Pipeline& pipeline) {
+    for (auto&& source : pipeline.getSources()) {
         if (source->usedDisk())
             _usedDisk = true;
     }
+}
 
-    MutableDocument output(std::move(inputDoc));
-    output.setNestedField(_as, Value(std::move(results)));
-    return output.freeze();
+boost::optional<std::vector<Value>> DocumentSourceLookUp::probeHashTable(
+    const Document& inputDoc) {
+    invariant(!wasConstructedWithPipelineSyntax());
+
+    if (!_hashTable) {
+        if (internalDocumentSourceLookupHashJoinMaxMemoryBytes.load() <= 0) {
+            return boost::none;
+        }
+        buildHashTable();
+    }
+
+    if (!_hashTable->isServing()) {
+        return boost::none;
+    }
+
+    // Probe with the same values that makeMatchStageFromInput() would query for.
+    auto keys = getLocalFieldValues(inputDoc, *_localField);
+    if (std::any_of(keys.begin(), keys.end(), [](const Value& key) {
+            return key.getType() == BSONType::Undefined;
+        })) {
+        // The query would be rejected, so let it report the error.
+        return boost::none;
+    }
+
+    auto results = _hashTable->probe(keys);
+    assertResultsFitInDocument(results);
+    return results;
+}
+
+void DocumentSourceLookUp::assertResultsFitInDocument(const std::vector<Value>& results) {
+    int objsize = 0;
+    for (auto&& result : results) {
+        objsize += result.getDocument().getApproximateSize();
+        uassert(51024,
+                str::stream() << "Total size of documents in " << _fromNs.coll()
+                              << " matching pipeline "
+                              << getUserPipelineDefinition()
+                              << " exceeds maximum document size",
+                objsize <= BSONObjMaxInternalSize);
+    }
+}
+
+void DocumentSourceLookUp::buildHashTable() {
+    invariant(!_hashTable);
+    _hashTable.emplace(_fromExpCtx->getValueComparator(),
+                       *_foreignField,
+                       internalDocumentSourceLookupHashJoinMaxMemoryBytes.load());
+
+    // Read the whole foreign collection by running the pipeline with an empty $match in place of
+    // the per-document one.
+    _resolvedPipeline.back() = BSON("$match" << BSONObj());
+    auto pipeline = buildPipeline(Document());
+    while (auto result = pipeline->getNext()) {
+        _hashTable->add(std::move(*result));
+        if (_hashTable->isAbandoned()) {
+            break;
+        }
+    }
+    recordUsedDisk(*pipeline);
+
+    if (_hashTable->isBuilding()) {
+        _hashTable->freeze();
+    }
 }
 
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
@@ -470,25 +642,41 @@ void DocumentSourceLookUp::doDispose() {
     }
 }
 
+std::vector<Value> DocumentSourceLookUp::getLocalFieldValues(const Document& input,
+                                                             const FieldPath& localFieldPath) {
+    // If 'localFieldPath' references a field with an array in its path, we may need to join on
+    // multiple values, so we add each element.
+    std::vector<Value> values;
+    document_path_support::visitAllValuesAtPath(
+        input, localFieldPath, [&](const Value& nextValue) { values.push_back(nextValue); });
+
+    if (values.empty()) {
+        // Missing values are treated as null.
+        values.emplace_back(BSONNULL);
+    }
+    return values;
+}
+
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
                                                       const FieldPath& localFieldPath,
                                                       const std::string& foreignFieldName,
                                                       const BSONObj& additionalFilter) {
-    // Add the 'localFieldPath' of 'input' into 'localFieldList'. If 'localFieldPath' references a
-    // field with an array in its path, we may need to join on multiple values, so we add each
-    // element to 'localFieldList'.
+    return makeMatchStageFromValues(
+        getLocalFieldValues(input, localFieldPath), foreignFieldName, additionalFilter);
+}
+
+BSONObj DocumentSourceLookUp::makeMatchStageFromValues(const std::vector<Value>& values,
+                                                       const std::string& foreignFieldName,
+                                                       const BSONObj& additionalFilter) {
+    invariant(!values.empty());
+
     BSONArrayBuilder arrBuilder;
     bool containsRegex = false;
-    document_path_support::visitAllValuesAtPath(input, localFieldPath, [&](const Value& nextValue) {
-        arrBuilder << nextValue;
-        if (!containsRegex && nextValue.getType() == BSONType::RegEx) {
+    for (auto&& value : values) {
+        arrBuilder << value;
+        if (!containsRegex && value.getType() == BSONType::RegEx) {
             containsRegex = true;
         }
-    });
-
-    if (arrBuilder.arrSize() == 0) {
-        // Missing values are treated as null.
-        arrBuilder << BSONNULL;
     }
 
     const auto localFieldListSize = arrBuilder.arrSize();
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -36,6 +37,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
 
@@ -49,6 +51,10 @@ class DocumentSourceLookUp final : public DocumentSource, public NeedsMergerDocu
 public:
     static constexpr size_t kMaxSubPipelineDepth = 20;
 
+    // A batch of local documents is ended early once the values they join on reach this size, so
+    // that the foreign query for the batch stays well within the maximum BSON size.
+    static constexpr size_t kMaxBatchKeysSizeBytes = BSONObjMaxUserSize / 2;
+
     class LiteParsed final : public LiteParsedDocumentSource {
     public:
         static std::unique_ptr<LiteParsed> parse(const AggregationRequest& request,
@@ -153,6 +159,14 @@ public:
                                            const std::string& foreignFieldName,
                                            const BSONObj& additionalFilter);
 
+    /**
+     * Builds the $match used to query the foreign collection for documents whose
+     * 'foreignFieldName' matches any of 'values', which must not be empty.
+     */
+    static BSONObj makeMatchStageFromValues(const std::vector<Value>& values,
+                                            const std::string& foreignFieldName,
+                                            const BSONObj& additionalFilter);
+
     /**
      * Helper to absorb an $unwind stage. Only used for testing this special behavior.
      */
@@ -238,6 +252,51 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns the values of 'localFieldPath' in 'input' to join on, or a single null if it is
+     * missing.
+     */
+    static std::vector<Value> getLocalFieldValues(const Document& input,
+                                                  const FieldPath& localFieldPath);
+
+    /**
+     * Runs the $lookup pipeline for 'inputDoc' against the foreign collection and returns its
+     * results.
+     */
+    std::vector<Value> lookUpInForeignCollection(const Document& inputDoc);
+
+    /**
+     * Reads up to 'batchSize' local documents, starting with 'firstInput', and answers all of
+     * their lookups with a single query against the foreign collection. Returns the first output
+     * document and queues the rest in '_batchedOutputs'. May only be called for a $lookup with
+     * localField/foreignField syntax.
+     */
+    GetNextResult lookUpBatch(Document firstInput, size_t batchSize);
+
+    /**
+     * Throws if 'results' are too large to be stored in the 'as' field of a single document.
+     */
+    void assertResultsFitInDocument(const std::vector<Value>& results);
+
+    /**
+     * Sets '_usedDisk' if any stage of 'pipeline' used disk.
+     */
+    void recordUsedDisk(const Pipeline& pipeline);
+
+    /**
+     * Returns the documents of the foreign collection matching 'inputDoc', found by probing
+     * '_hashTable', which is built on the first call. Returns boost::none if the hash join is
+     * disabled or the table was abandoned, in which case the caller should query the foreign
+     * collection instead. May only be called for a $lookup with localField/foreignField syntax.
+     */
+    boost::optional<std::vector<Value>> probeHashTable(const Document& inputDoc);
+
+    /**
+     * Reads every document of the foreign collection into '_hashTable', abandoning it if it grows
+     * beyond 'internalDocumentSourceLookupHashJoinMaxMemoryBytes'.
+     */
+    void buildHashTable();
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -301,6 +360,15 @@ private:
     // from a cursor source.
     boost::optional<SequentialDocumentCache> _cache;
 
+    // For localField/foreignField syntax, holds the foreign collection keyed on 'foreignField' once
+    // the first input document has been seen, if the hash join is enabled.
+    boost::optional<LookupHashTable> _hashTable;
+
+    // For localField/foreignField syntax with batching enabled, holds the output documents of the
+    // current batch which have not yet been returned, followed by the pause or EOF which ended it.
+    std::deque<Document> _batchedOutputs;
+    boost::optional<GetNextResult> _batchEndResult;
+
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
     // namespace.
     boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
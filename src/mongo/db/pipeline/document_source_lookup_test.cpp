@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -632,6 +633,106 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
     lookup->dispose();
 }
 
+/**
+ * Runs a localField/foreignField $lookup from 'localDocs' into 'foreignDocs' and returns its output
+ * up to EOF, including any pauses.
+ */
+vector<DocumentSource::GetNextResult> runLocalForeignFieldLookup(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    const deque<DocumentSource::GetNextResult>& localDocs,
+    const deque<DocumentSource::GetNextResult>& foreignDocs) {
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(foreignDocs);
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignKey"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto mockLocalSource = DocumentSourceMock::create(localDocs);
+    parsed->setSource(mockLocalSource.get());
+
+    vector<DocumentSource::GetNextResult> results;
+    for (auto next = parsed->getNext(); !next.isEOF(); next = parsed->getNext()) {
+        results.push_back(std::move(next));
+    }
+    parsed->dispose();
+    return results;
+}
+
+void assertSameLookupResults(const vector<DocumentSource::GetNextResult>& results,
+                             const vector<DocumentSource::GetNextResult>& expected) {
+    ASSERT_EQ(results.size(), expected.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        ASSERT_EQ(results[i].isPaused(), expected[i].isPaused());
+        if (expected[i].isAdvanced()) {
+            ASSERT_DOCUMENT_EQ(results[i].getDocument(), expected[i].getDocument());
+        }
+    }
+}
+
+const deque<DocumentSource::GetNextResult> kLocalDocsForJoin{
+    Document{{"_id", 0}, {"foreignKey", 0}},
+    Document{{"_id", 1}, {"foreignKey", vector<Value>{Value(1), Value(2)}}},
+    DocumentSource::GetNextResult::makePauseExecution(),
+    Document{{"_id", 2}},
+    Document{{"_id", 3}, {"foreignKey", 4}},
+    Document{{"_id", 4}, {"foreignKey", 1}}};
+
+const deque<DocumentSource::GetNextResult> kForeignDocsForJoin{
+    Document{{"_id", 0}, {"key", 0}},
+    Document{{"_id", 1}, {"key", 1.0}},
+    Document{{"_id", 2}, {"key", vector<Value>{Value(2), Value(3)}}},
+    Document{{"_id", 3}},
+    Document{{"_id", 4}, {"key", BSONNULL}}};
+
+TEST_F(DocumentSourceLookUpTest, PerDocumentQueriesFindEqualValues) {
+    auto results = runLocalForeignFieldLookup(getExpCtx(), kLocalDocsForJoin, kForeignDocsForJoin);
+    ASSERT_EQ(results.size(), 6UL);
+    ASSERT_EQ(results[0].getDocument()["foreignDocs"].getArrayLength(), 1UL);
+    ASSERT_EQ(results[1].getDocument()["foreignDocs"].getArrayLength(), 2UL);
+    ASSERT_TRUE(results[2].isPaused());
+    ASSERT_EQ(results[3].getDocument()["foreignDocs"].getArrayLength(), 2UL);
+    ASSERT_EQ(results[4].getDocument()["foreignDocs"].getArrayLength(), 0UL);
+    ASSERT_EQ(results[5].getDocument()["foreignDocs"].getArrayLength(), 1UL);
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinProducesSameResultsAsPerDocumentQueries) {
+    auto expected = runLocalForeignFieldLookup(getExpCtx(), kLocalDocsForJoin, kForeignDocsForJoin);
+
+    long long oldMaxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    ON_BLOCK_EXIT([oldMaxMemoryBytes] {
+        internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(oldMaxMemoryBytes);
+    });
+
+    // With enough memory the foreign documents are served from the hash table, and with too little
+    // the table is abandoned. Either way the results must not change.
+    for (long long maxMemoryBytes : {100LL * 1024 * 1024, 1LL}) {
+        internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(maxMemoryBytes);
+        assertSameLookupResults(
+            runLocalForeignFieldLookup(getExpCtx(), kLocalDocsForJoin, kForeignDocsForJoin),
+            expected);
+    }
+}
+
+TEST_F(DocumentSourceLookUpTest, BatchedQueriesProduceSameResultsAsPerDocumentQueries) {
+    auto expected = runLocalForeignFieldLookup(getExpCtx(), kLocalDocsForJoin, kForeignDocsForJoin);
+
+    int oldBatchSize = internalDocumentSourceLookupBatchSize.load();
+    ON_BLOCK_EXIT([oldBatchSize] { internalDocumentSourceLookupBatchSize.store(oldBatchSize); });
+
+    // Batches end at the pause, at EOF or when full, and must return the pause in its place.
+    for (int batchSize : {2, 3, 1000}) {
+        internalDocumentSourceLookupBatchSize.store(batchSize);
+        assertSameLookupResults(
+            runLocalForeignFieldLookup(getExpCtx(), kLocalDocsForJoin, kForeignDocsForJoin),
+            expected);
+    }
+}
+
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -30,6 +30,10 @@
 
 #include "mongo/db/pipeline/document_source_out_replace_coll.h"
 
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+
 namespace mongo {
 
 static AtomicUInt32 aggOutCounter;
@@ -74,26 +78,90 @@ void DocumentSourceOutReplaceColl::initializeWriteNs() {
                 conn->runCommand(outputNs.db().toString(), cmd.done(), info));
     }
 
+    _useWriterThread = internalDocumentSourceOutUseWriterThread.load();
+
     if (_originalIndexes.empty()) {
         return;
     }
 
-    // Copy the indexes of the output collection to the temp collection.
-    std::vector<BSONObj> tempNsIndexes;
+    // Copy the _id index of the output collection to the temp collection now, and keep the others
+    // for finalize().
+    std::vector<BSONObj> tempNsIdIndex;
     for (const auto& indexSpec : _originalIndexes) {
         // Replace the spec's 'ns' field value, which is the original collection, with the temp
         // collection.
-        tempNsIndexes.push_back(indexSpec.addField(BSON("ns" << _tempNs.ns()).firstElement()));
+        auto tempNsIndexSpec = indexSpec.addField(BSON("ns" << _tempNs.ns()).firstElement());
+        if (indexSpec["name"].str() == "_id_") {
+            tempNsIdIndex.push_back(std::move(tempNsIndexSpec));
+        } else {
+            _deferredIndexes.push_back(std::move(tempNsIndexSpec));
+        }
+    }
+    if (tempNsIdIndex.empty()) {
+        return;
     }
     try {
-        conn->createIndexes(_tempNs.ns(), tempNsIndexes);
+        conn->createIndexes(_tempNs.ns(), tempNsIdIndex);
     } catch (DBException& ex) {
         ex.addContext("Copying indexes for $out failed");
         throw;
     }
 };
 
+void DocumentSourceOutReplaceColl::spill(BatchedObjects&& batch) {
+    uassertStatusOK(joinWriter());
+
+    if (_useWriterThread) {
+        auto serviceContext = pExpCtx->opCtx->getServiceContext();
+        const auto deadline = pExpCtx->opCtx->getDeadline();
+        auto writerExpCtx = pExpCtx->copyWith(_tempNs);
+        _writerBatch = std::move(batch.objects);
+        try {
+            _writer = stdx::thread([this, serviceContext, deadline, writerExpCtx] {
+                Client::initThread("aggOutWriter", serviceContext, nullptr);
+                auto writerOpCtx = cc().makeOperationContext();
+                if (deadline != Date_t::max()) {
+                    writerOpCtx->setDeadlineByDate(deadline, ErrorCodes::MaxTimeMSExpired);
+                }
+                writerExpCtx->opCtx = writerOpCtx.get();
+                try {
+                    writerExpCtx->mongoProcessInterface->insert(
+                        writerExpCtx, _tempNs, std::move(_writerBatch));
+                } catch (const DBException& ex) {
+                    _writerStatus = ex.toStatus();
+                }
+                writerExpCtx->opCtx = nullptr;
+            });
+        } catch (const std::exception&) {
+            // Write the batch on this thread if the writer could not be started.
+            pExpCtx->mongoProcessInterface->insert(pExpCtx, _tempNs, std::move(_writerBatch));
+        }
+        return;
+    }
+
+    DocumentSourceOut::spill(std::move(batch));
+}
+
+Status DocumentSourceOutReplaceColl::joinWriter() {
+    if (_writer.joinable()) {
+        _writer.join();
+    }
+    return std::exchange(_writerStatus, Status::OK());
+}
+
 void DocumentSourceOutReplaceColl::finalize() {
+    uassertStatusOK(joinWriter());
+
+    if (!_deferredIndexes.empty()) {
+        try {
+            pExpCtx->mongoProcessInterface->directClient()->createIndexes(_tempNs.ns(),
+                                                                          _deferredIndexes);
+        } catch (DBException& ex) {
+            ex.addContext("Copying indexes for $out failed");
+            throw;
+        }
+    }
+
     const auto& outputNs = getOutputNs();
     auto renameCommandObj =
         BSON("renameCollection" << _tempNs.ns() << "to" << outputNs.ns() << "dropTarget" << true);
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/pipeline/document_source_out.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/destructor_guard.h"
 
 namespace mongo {
@@ -42,6 +43,8 @@ public:
     using DocumentSourceOut::DocumentSourceOut;
 
     ~DocumentSourceOutReplaceColl() {
+        // The writer thread may still be inserting into the temp collection.
+        joinWriter().ignore();
         DESTRUCTOR_GUARD(
             // Make sure we drop the temp collection if anything goes wrong. Errors are ignored
             // here because nothing can be done about them. Additionally, if this fails and the
@@ -52,14 +55,22 @@ public:
     }
 
     /**
-     * Sets up a temp collection which contains the same indexes and options as the output
-     * collection. All writes will be directed to the temp collection.
+     * Sets up a temp collection which contains the same options and _id index as the output
+     * collection. All writes will be directed to the temp collection. The other indexes of the
+     * output collection are built once all documents have been inserted, see finalize().
      */
     void initializeWriteNs() final;
 
     /**
-     * Renames the temp collection to the output collection with the 'dropTarget' option set to
-     * true.
+     * Inserts the documents in 'batch' into the temp collection. If the
+     * 'internalDocumentSourceOutUseWriterThread' parameter is set, the insert happens on a writer
+     * thread, and this returns once the previous batch has been written.
+     */
+    void spill(BatchedObjects&& batch) final;
+
+    /**
+     * Builds the indexes of the output collection on the temp collection, then renames the temp
+     * collection to the output collection with the 'dropTarget' option set to true.
      */
     void finalize() final;
 
@@ -68,6 +79,11 @@ public:
     };
 
 private:
+    /**
+     * Waits for the writer thread, if any, to finish inserting its batch, and returns the outcome.
+     */
+    Status joinWriter();
+
     // Holds on to the original collection options and index specs so we can check they didn't
     // change during computation.
     BSONObj _originalOutOptions;
@@ -75,6 +91,18 @@ private:
 
     // The temporary namespace for the $out writes.
     NamespaceString _tempNs;
+
+    // The specs of the indexes other than _id to build on the temp collection once it has been
+    // filled. Building them over the full collection sorts the keys in bulk, rather than inserting
+    // them one document at a time.
+    std::vector<BSONObj> _deferredIndexes;
+
+    // Set if batches are inserted on '_writer'. At most one batch, '_writerBatch', is in flight at
+    // any time, and '_writerStatus' holds the outcome of its insert once '_writer' has been joined.
+    bool _useWriterThread = false;
+    std::vector<BSONObj> _writerBatch;
+    stdx::thread _writer;
+    Status _writerStatus = Status::OK();
 };
 
 }  // namespace mongo
@@ -0,0 +1,188 @@
+/**
+ *    Copyright (C) 2018 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_parallel_exchange.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+boost::intrusive_ptr<DocumentSourceParallelExchange> DocumentSourceParallelExchange::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Exchange> exchange,
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> consumers) {
+    return new DocumentSourceParallelExchange(expCtx, std::move(exchange), std::move(consumers));
+}
+
+DocumentSourceParallelExchange::DocumentSourceParallelExchange(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Exchange> exchange,
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> consumers)
+    : DocumentSource(expCtx), _exchange(std::move(exchange)), _consumers(std::move(consumers)) {
+    invariant(_consumers.size() == _exchange->getConsumers());
+}
+
+const char* DocumentSourceParallelExchange::getSourceName() const {
+    return "$_internalParallelExchange";
+}
+
+Value DocumentSourceParallelExchange::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(DOC(getSourceName() << DOC("consumers" << static_cast<int>(_consumers.size())
+                                                        << "consumerPipeline"
+                                                        << _consumers.front()->serialize())));
+}
+
+DocumentSource::GetNextResult DocumentSourceParallelExchange::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_consumersDone) {
+        runConsumers();
+    }
+
+    if (_resultsIt == _results.end()) {
+        return GetNextResult::makeEOF();
+    }
+    return std::move(*_resultsIt++);
+}
+
+void DocumentSourceParallelExchange::runConsumers() {
+    invariant(!_consumersDone);
+    _consumersDone = true;
+
+    auto opCtx = pExpCtx->opCtx;
+    auto serviceContext = opCtx->getServiceContext();
+    const auto deadline = opCtx->getDeadline();
+
+    std::vector<Status> statuses(_consumers.size(), Status::OK());
+    std::vector<std::vector<Document>> results(_consumers.size());
+    std::vector<stdx::thread> threads;
+    size_t numStarted = 1;
+    for (; numStarted < _consumers.size(); ++numStarted) {
+        const size_t consumerId = numStarted;
+        try {
+            threads.emplace_back([&, consumerId] {
+                const std::string threadName = str::stream() << "parallelAggregation-"
+                                                              << consumerId;
+                Client::initThread(threadName, serviceContext, nullptr);
+                auto consumerOpCtx = cc().makeOperationContext();
+                if (deadline != Date_t::max()) {
+                    consumerOpCtx->setDeadlineByDate(deadline, ErrorCodes::MaxTimeMSExpired);
+                }
+                statuses[consumerId] =
+                    runConsumer(consumerOpCtx.get(), consumerId, &results[consumerId]);
+            });
+        } catch (const std::exception& ex) {
+            statuses[consumerId] = Status(ErrorCodes::InternalError,
+                                          str::stream() << "Failed to start a parallel aggregation "
+                                                           "consumer thread: "
+                                                        << ex.what());
+            _exchange->abort(statuses[consumerId]);
+            break;
+        }
+    }
+
+    // The first consumer runs on this thread, which keeps the aggregation interruptible: if this
+    // operation is killed, the first consumer fails the Exchange and with it the others.
+    statuses[0] = runConsumer(opCtx, 0, &results[0]);
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    // Consumers which never started must still release their share of the Exchange.
+    for (size_t consumerId = numStarted; consumerId < _consumers.size(); ++consumerId) {
+        std::vector<Document> ignored;
+        runConsumer(opCtx, consumerId, &ignored).ignore();
+    }
+
+    // The pipeline read by the Exchange shares this stage's ExpressionContext, which was attached
+    // to the operation of whichever consumer loaded the Exchange buffers last.
+    pExpCtx->opCtx = opCtx;
+    pExpCtx->mongoProcessInterface->setOperationContext(opCtx);
+
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+
+    for (size_t consumerId = 0; consumerId < _consumers.size(); ++consumerId) {
+        _usedDisk = _usedDisk || _consumers[consumerId]->usedDisk();
+        std::move(results[consumerId].begin(),
+                  results[consumerId].end(),
+                  std::back_inserter(_results));
+    }
+    _resultsIt = _results.begin();
+}
+
+Status DocumentSourceParallelExchange::runConsumer(OperationContext* opCtx,
+                                                   size_t consumerId,
+                                                   std::vector<Document>* results) {
+    auto& consumer = _consumers[consumerId];
+    consumer->reattachToOperationContext(opCtx);
+
+    Status status = Status::OK();
+    try {
+        while (auto next = consumer->getNext()) {
+            results->push_back(std::move(*next));
+        }
+    } catch (const DBException& ex) {
+        LOG(3) << "Parallel aggregation consumer " << consumerId << " failed: " << ex;
+        status = ex.toStatus();
+        _exchange->abort(status);
+    }
+
+    consumer->dispose(opCtx);
+    consumer.get_deleter().dismissDisposal();
+    consumer->detachFromOperationContext();
+    return status;
+}
+
+void DocumentSourceParallelExchange::doDispose() {
+    if (_consumersDone) {
+        // Each consumer disposed of itself when it finished.
+        _results.clear();
+        _resultsIt = _results.end();
+        return;
+    }
+
+    _consumersDone = true;
+    for (auto&& consumer : _consumers) {
+        consumer->dispose(pExpCtx->opCtx);
+        consumer.get_deleter().dismissDisposal();
+    }
+    _resultsIt = _results.end();
+}
+
+}  // namespace mongo
@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2018 MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/pipeline.h"
+
+namespace mongo {
+
+/**
+ * Runs the consumer pipelines of an Exchange in parallel, the first on the calling thread and each
+ * of the others on a thread of its own, and returns the results of all of them once they have run
+ * to completion. This lets a single aggregation on a mongod use more than one core for the stages
+ * preceding a $group, see PipelineD::addParallelExchange().
+ */
+class DocumentSourceParallelExchange final : public DocumentSource {
+public:
+    static boost::intrusive_ptr<DocumentSourceParallelExchange> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        boost::intrusive_ptr<Exchange> exchange,
+        std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> consumers);
+
+    GetNextResult getNext() final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kBlocking,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kNone,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    const char* getSourceName() const final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * DocumentSourceParallelExchange does not have a direct source (its consumers read through the
+     * shared Exchange pipeline).
+     */
+    void setSource(DocumentSource* source) final {
+        invariant(!source);
+    }
+
+    bool usedDisk() final {
+        return _usedDisk;
+    }
+
+    size_t getConsumers() const {
+        return _consumers.size();
+    }
+
+protected:
+    void doDispose() final;
+
+private:
+    DocumentSourceParallelExchange(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        boost::intrusive_ptr<Exchange> exchange,
+        std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> consumers);
+
+    /**
+     * Runs every consumer pipeline to completion and gathers their results into '_results'. Throws
+     * the error of the first consumer that failed, if any.
+     */
+    void runConsumers();
+
+    /**
+     * Runs the consumer pipeline 'consumerId' on 'opCtx', appending its results to 'results', and
+     * disposes of it. If the consumer fails, fails the whole Exchange and returns the error.
+     */
+    Status runConsumer(OperationContext* opCtx, size_t consumerId, std::vector<Document>* results);
+
+    boost::intrusive_ptr<Exchange> _exchange;
+
+    // One pipeline per consumer of '_exchange', each beginning with a DocumentSourceExchange and
+    // each with an ExpressionContext of its own, since they run on different threads.
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> _consumers;
+
+    bool _consumersDone = false;
+    bool _usedDisk = false;
+
+    std::vector<Document> _results;
+    std::vector<Document>::iterator _resultsIt;
+};
+
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/collation/caching_collator.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 
@@ -285,6 +286,7 @@ intrusive_ptr<DocumentSourceSort> DocumentSourceSort::create(
 
     uassert(15976, "$sort stage must have at least one sort key", !pSort->_sortPattern.empty());
 
+    pSort->_collator = CachingCollator::make(pExpCtx->getCollator());
     pSort->_sortKeyGen = SortKeyGenerator{
         // The SortKeyGenerator expects the expressions to be serialized in order to detect a sort
         // by a metadata field.
@@ -310,6 +312,7 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
     if (pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
         opts.extSortAllowed = true;
         opts.tempDir = pExpCtx->tempDir;
+        opts.backgroundSpills = true;
     }
 
     return opts;
@@ -355,9 +358,9 @@ bool DocumentSourceSort::usedDisk() {
     return _usedDisk;
 }
 
-Value DocumentSourceSort::getCollationComparisonKey(const Value& val) const {
-    const auto collator = pExpCtx->getCollator();
-
+// static
+Value DocumentSourceSort::getCollationComparisonKey(const CollatorInterface* collator,
+                                                    const Value& val) {
     // If the collation is the simple collation, the value itself is the comparison key.
     if (!collator) {
         return val;
@@ -400,7 +403,7 @@ StatusWith<Value> DocumentSourceSort::extractKeyPart(const Document& doc,
         plainKey = patternPart.expression->evaluate(doc);
     }
 
-    return getCollationComparisonKey(plainKey);
+    return getCollationComparisonKey(_collator.get(), plainKey);
 }
 
 StatusWith<Value> DocumentSourceSort::extractKeyFast(const Document& doc) const {
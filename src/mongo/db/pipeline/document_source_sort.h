@@ -86,6 +86,13 @@ public:
     bool canRunInParallelBeforeOut(
         const std::set<std::string>& nameOfShardKeyFieldsUponEntryToStage) const final;
 
+    /**
+     * Returns the comparison key used to sort 'val' with 'collator', which may be null for the
+     * simple collation. Note that these comparison keys should always be sorted with the simple
+     * (i.e. binary) collation.
+     */
+    static Value getCollationComparisonKey(const CollatorInterface* collator, const Value& val);
+
     /**
      * Write out a Document whose contents are the sort key pattern.
      */
@@ -225,13 +232,6 @@ private:
      */
     BSONObj extractKeyWithArray(const Document& doc) const;
 
-    /**
-     * Returns the comparison key used to sort 'val' with the collation of the ExpressionContext.
-     * Note that these comparison keys should always be sorted with the simple (i.e. binary)
-     * collation.
-     */
-    Value getCollationComparisonKey(const Value& val) const;
-
     int compare(const Value& lhs, const Value& rhs) const;
 
     /**
@@ -250,6 +250,10 @@ private:
 
     boost::optional<SortKeyGenerator> _sortKeyGen;
 
+    // The collation of the sort keys of the fast path, which remembers the keys of recently seen
+    // strings, or null for the simple collation.
+    std::unique_ptr<CollatorInterface> _collator;
+
     SortPattern _sortPattern;
 
     // The set of paths on which we're sorting.
@@ -32,6 +32,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
@@ -104,7 +105,7 @@ void DocumentSourceUnwind::Unwinder::resetDocument(const Document& document) {
 
 DocumentSource::GetNextResult DocumentSourceUnwind::Unwinder::getNext() {
     // WARNING: Any functional changes to this method must also be implemented in the unwinding
-    // implementation of the $lookup stage.
+    // implementations of the $lookup and $group stages.
     if (!_haveNext) {
         return GetNextResult::makeEOF();
     }
@@ -247,6 +248,21 @@ Value DocumentSourceUnwind::serialize(boost::optional<ExplainOptions::Verbosity>
                                 << (_indexPath ? Value((*_indexPath).fullPath()) : Value()))));
 }
 
+Pipeline::SourceContainer::iterator DocumentSourceUnwind::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextGroup = dynamic_cast<DocumentSourceGroup*>((*std::next(itr)).get());
+    if (nextGroup && nextGroup->canAbsorbUnwind(*this)) {
+        nextGroup->setUnwindSource(this);
+
+        // Continue optimizing from the $group.
+        return container->erase(itr);
+    }
+
+    return std::next(itr);
+}
+
 DepsTracker::State DocumentSourceUnwind::getDependencies(DepsTracker* deps) const {
     deps->fields.insert(_unwindPath.fullPath());
     return DepsTracker::State::SEE_NEXT;
@@ -76,6 +76,10 @@ public:
         return _unwindPath.fullPath();
     }
 
+    const FieldPath& unwindPath() const {
+        return _unwindPath;
+    }
+
     bool preserveNullAndEmptyArrays() const {
         return _preserveNullAndEmptyArrays;
     }
@@ -84,6 +88,14 @@ public:
         return _indexPath;
     }
 
+protected:
+    /**
+     * Attempts to be absorbed by a subsequent $group stage, which then unwinds each input document
+     * itself.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     DocumentSourceUnwind(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                          const FieldPath& fieldPath,
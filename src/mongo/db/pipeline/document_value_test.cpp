@@ -94,6 +94,21 @@ TEST(DocumentConstruction, FromNonEmptyBson) {
     ASSERT_EQUALS("q", getNthField(document, 1).second.getString());
 }
 
+TEST(DocumentConstruction, FromBsonWithLongFieldNames) {
+    // Enough fields to use the hash table, with names much longer than the per-field estimate.
+    BSONObjBuilder bob;
+    for (int i = 0; i < 10; ++i) {
+        bob.append(std::string(100, 'a' + i), i);
+    }
+    Document document = fromBson(bob.obj());
+    ASSERT_EQUALS(10U, document.size());
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQUALS(i, document[std::string(100, 'a' + i)].getInt());
+        ASSERT_EQUALS(std::string(100, 'a' + i), getNthField(document, i).first.toString());
+    }
+    assertRoundTrips(document);
+}
+
 TEST(DocumentConstruction, FromInitializerList) {
     auto document = Document{{"a", 1}, {"b", "q"_sd}};
     ASSERT_EQUALS(2U, document.size());
@@ -111,6 +126,59 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone);
 }
 
+TEST(DocumentConstruction, FromBsonLazilyLooksUpFieldsInAnyOrder) {
+    BSONObj bson = BSON("a" << 1 << "b"
+                            << "q"
+                            << "c"
+                            << BSON("d" << 2)
+                            << "e"
+                            << BSON_ARRAY(BSON("f" << 3)));
+    Document document = Document::fromBsonLazily(bson);
+    ASSERT_EQUALS(2, document.getNestedField(FieldPath("c.d")).getInt());
+    ASSERT_EQUALS(1, document["a"].getInt());
+    ASSERT_TRUE(document["missing"].missing());
+    ASSERT_EQUALS("q", document["b"].getString());
+    ASSERT_EQUALS(4U, document.size());
+    ASSERT_EQUALS("a", getNthField(document, 0).first.toString());
+    ASSERT_EQUALS("e", getNthField(document, 3).first.toString());
+    ASSERT_DOCUMENT_EQ(document, fromBson(bson));
+    ASSERT_BSONOBJ_EQ(bson, toBson(document));
+}
+
+TEST(DocumentConstruction, FromBsonLazilyFindsFirstOfDuplicateFields) {
+    Document document = Document::fromBsonLazily(BSON("a" << 1 << "a" << 2));
+    ASSERT_EQUALS(1, document["a"].getInt());
+    ASSERT_EQUALS(2U, document.size());
+}
+
+TEST(DocumentConstruction, FromBsonLazilyOwnsItsData) {
+    Document document;
+    {
+        BSONObj bson = BSON("a" << BSON("b" << 1));
+        // An unowned view of the BSON, which becomes invalid at the end of this scope.
+        document = Document::fromBsonLazily(BSONObj(bson.objdata()));
+    }
+    ASSERT_EQUALS(1, document.getNestedField(FieldPath("a.b")).getInt());
+}
+
+TEST(DocumentConstruction, ModifyingLazyDocumentDoesNotReuseStaleBson) {
+    Document lazy = Document::fromBsonLazily(BSON("a" << 1 << "b" << 2));
+    ASSERT_EQUALS(1, lazy["a"].getInt());
+
+    MutableDocument md(std::move(lazy));
+    md["b"] = mongo::Value(3);
+    md["c"] = mongo::Value(4);
+    Document modified = md.freeze();
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 3 << "c" << 4), toBson(modified));
+}
+
+TEST(DocumentConstruction, FromBsonLazilyParsesMetadata) {
+    Document document = Document::fromBsonLazily(BSON("a" << 1 << "$textScore" << 5.0));
+    ASSERT_TRUE(document.hasTextScore());
+    ASSERT_EQ(5.0, document.getTextScore());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1), toBson(document));
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -669,6 +669,11 @@ public:
     explicit ExpressionAdd(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionVariadic<ExpressionAdd>(expCtx) {}
 
+    /**
+     * Returns the sum of the 'n' values starting at 'operands', as $add would compute it.
+     */
+    static Value apply(const Value* operands, size_t n);
+
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
 
@@ -810,6 +815,12 @@ public:
     ExpressionCompare(const boost::intrusive_ptr<ExpressionContext>& expCtx, CmpOp cmpOp)
         : ExpressionFixedArity<ExpressionCompare, 2>(expCtx), cmpOp(cmpOp) {}
 
+    /**
+     * Returns the result of this comparison between 'lhs' and 'rhs', using the collation of the
+     * expression context.
+     */
+    Value apply(const Value& lhs, const Value& rhs) const;
+
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
 
@@ -1437,6 +1448,11 @@ public:
     explicit ExpressionMultiply(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionVariadic<ExpressionMultiply>(expCtx) {}
 
+    /**
+     * Returns the product of the 'n' values starting at 'operands', as $multiply would compute it.
+     */
+    static Value apply(const Value* operands, size_t n);
+
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
 
@@ -1788,6 +1804,11 @@ public:
     explicit ExpressionSubtract(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionFixedArity<ExpressionSubtract, 2>(expCtx) {}
 
+    /**
+     * Returns 'lhs' minus 'rhs', as $subtract would compute it.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
+
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
 };
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/compiled_expression.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+namespace {
+
+const char* const kExpressions[] = {
+    // A single field path.
+    "{'': '$c'}",
+    // A dotted field path.
+    "{'': '$sub.x'}",
+    // An arithmetic chain over several fields.
+    "{'': {$add: [{$multiply: ['$a', 2]}, {$subtract: ['$c', '$sub.x']}, 1]}}",
+    // A conjunction of comparisons.
+    "{'': {$and: [{$gt: ['$a', 10]}, {$lte: ['$c', 8]}, {$lt: ['$f', 0.5]}]}}",
+    // A conditional over a comparison.
+    "{'': {$cond: [{$eq: ['$s', 'str7']}, {$add: ['$a', '$c']}, '$sub.y']}}",
+};
+
+Document makeDoc(int i) {
+    BSONObjBuilder bob;
+    bob.append("_id", i);
+    bob.append("a", i);
+    bob.append("b", "some string");
+    bob.append("c", i % 10);
+    bob.append("d", BSON_ARRAY(1 << 2 << 3));
+    bob.append("f", (i % 100) / 100.0);
+    bob.append("s", "str" + std::to_string(i % 10));
+    bob.append("sub", BSON("x" << i % 7 << "y"
+                               << "y"));
+    bob.append("z", true);
+    return Document(bob.obj());
+}
+
+std::vector<Document> makeDocs() {
+    std::vector<Document> docs;
+    for (int i = 0; i < 1000; ++i) {
+        docs.push_back(makeDoc(i));
+    }
+    return docs;
+}
+
+boost::intrusive_ptr<Expression> parseExpression(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, int expressionIndex) {
+    return Expression::parseOperand(expCtx,
+                                    fromjson(kExpressions[expressionIndex]).firstElement(),
+                                    expCtx->variablesParseState)
+        ->optimize();
+}
+
+void BM_evaluate(benchmark::State& state) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = parseExpression(expCtx, state.range(0));
+    const auto docs = makeDocs();
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            benchmark::DoNotOptimize(expr->evaluate(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_compiledEvaluate(benchmark::State& state) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = parseExpression(expCtx, state.range(0));
+    CompiledExpression compiled(expr.get());
+    const auto docs = makeDocs();
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            benchmark::DoNotOptimize(compiled.evaluate(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+BENCHMARK(BM_evaluate)->DenseRange(0, 4);
+BENCHMARK(BM_compiledEvaluate)->DenseRange(0, 4);
+
+}  // namespace
+}  // namespace mongo
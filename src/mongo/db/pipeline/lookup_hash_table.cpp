@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) 2018 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+LookupHashTable::LookupHashTable(const ValueComparator& comparator,
+                                 const FieldPath& foreignField,
+                                 size_t maxSizeBytes)
+    : _maxSizeBytes(maxSizeBytes),
+      _foreignField(foreignField.fullPath()),
+      _nullObj(BSON("" << BSONNULL)),
+      _foreignFieldPath(_foreignField),
+      _matchesNull(_foreignField, _nullObj.firstElement()),
+      _index(comparator.makeUnorderedValueMap<DocumentIndexes>()) {}
+
+void LookupHashTable::add(Document doc) {
+    invariant(isBuilding());
+
+    // Find the values along 'foreignField' the same way a query predicate over it would. Nullish
+    // values are left to '_matchesNull'.
+    const BSONObj obj = doc.toBson();
+    std::vector<Value> keys;
+    size_t sizeBytes = doc.getApproximateSize();
+    BSONElementIterator it(&_foreignFieldPath, obj);
+    while (it.more()) {
+        const BSONElement elem = it.next().element();
+        if (elem.eoo() || elem.isNull() || elem.type() == BSONType::Undefined) {
+            continue;
+        }
+        keys.emplace_back(elem);
+        sizeBytes += keys.back().getApproximateSize() + sizeof(size_t);
+    }
+    const bool matchesNull = _matchesNull.matchesBSON(obj);
+
+    if (_sizeBytes + sizeBytes > _maxSizeBytes) {
+        abandon();
+        return;
+    }
+    _sizeBytes += sizeBytes;
+
+    const size_t docIndex = _docs.size();
+    for (auto&& key : keys) {
+        auto& indexes = _index[key];
+        // An array may hold the same value more than once.
+        if (indexes.empty() || indexes.back() != docIndex) {
+            indexes.push_back(docIndex);
+        }
+    }
+    if (matchesNull) {
+        _nullMatches.push_back(docIndex);
+    }
+    _docs.push_back(std::move(doc));
+}
+
+void LookupHashTable::freeze() {
+    invariant(isBuilding());
+
+    _status = TableStatus::kServing;
+    _docs.shrink_to_fit();
+}
+
+void LookupHashTable::abandon() {
+    _status = TableStatus::kAbandoned;
+
+    _docs.clear();
+    _docs.shrink_to_fit();
+    _index.clear();
+    _nullMatches.clear();
+    _sizeBytes = 0;
+}
+
+std::vector<Value> LookupHashTable::probe(const std::vector<Value>& keys) const {
+    invariant(isServing());
+
+    DocumentIndexes matches;
+    for (auto&& key : keys) {
+        if (key.nullish()) {
+            matches.insert(matches.end(), _nullMatches.begin(), _nullMatches.end());
+            continue;
+        }
+
+        auto it = _index.find(key);
+        if (it != _index.end()) {
+            matches.insert(matches.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // A document matching several of the keys is returned once, in insertion order.
+    if (keys.size() > 1) {
+        std::sort(matches.begin(), matches.end());
+        matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+    }
+
+    std::vector<Value> results;
+    results.reserve(matches.size());
+    for (auto docIndex : matches) {
+        results.emplace_back(_docs[docIndex]);
+    }
+    return results;
+}
+
+}  // namespace mongo
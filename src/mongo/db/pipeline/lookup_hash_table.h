@@ -0,0 +1,149 @@
+/**
+ * Copyright (C) 2018 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/path.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+/**
+ * A hash table of the documents of a $lookup's foreign collection, keyed on the values of the
+ * 'foreignField' path in each document, up to a maximum size. Probing the table with the values of
+ * a local document's 'localField' returns the same documents as querying the foreign collection
+ * with {<foreignField>: {$in: [<values>]}}, in the order in which they were added.
+ *
+ * Like SequentialDocumentCache, the table is built, then served from, and may be abandoned at any
+ * point if it becomes too large.
+ */
+class LookupHashTable {
+    MONGO_DISALLOW_COPYING(LookupHashTable);
+
+public:
+    enum class TableStatus {
+        // Documents are being added. A newly constructed table is in this state.
+        kBuilding,
+
+        // The caller has invoked freeze() to indicate that all documents have been added. The table
+        // may now be probed.
+        kServing,
+
+        // The maximum size has been exceeded, or the caller has explicitly abandoned the table.
+        kAbandoned,
+    };
+
+    /**
+     * Keys are compared with 'comparator', which must outlive the table.
+     */
+    LookupHashTable(const ValueComparator& comparator,
+                    const FieldPath& foreignField,
+                    size_t maxSizeBytes);
+
+    /**
+     * Adds a document of the foreign collection to the table. Abandons the table if this would
+     * exceed the maximum size. May only be called while in 'kBuilding' mode.
+     */
+    void add(Document doc);
+
+    /**
+     * Moves the table into 'kServing' mode. May only be called while in 'kBuilding' mode.
+     */
+    void freeze();
+
+    /**
+     * Marks the table as 'kAbandoned' and frees the memory it holds.
+     */
+    void abandon();
+
+    /**
+     * Returns each document whose 'foreignField' matches any of the values in 'keys', once and in
+     * the order in which the documents were added. An element of 'keys' which is null also matches
+     * documents where 'foreignField' is missing. May only be called while in 'kServing' mode.
+     */
+    std::vector<Value> probe(const std::vector<Value>& keys) const;
+
+    TableStatus status() const {
+        return _status;
+    }
+
+    size_t sizeBytes() const {
+        return _sizeBytes;
+    }
+
+    size_t count() const {
+        return _docs.size();
+    }
+
+    bool isBuilding() const {
+        return _status == TableStatus::kBuilding;
+    }
+
+    bool isServing() const {
+        return _status == TableStatus::kServing;
+    }
+
+    bool isAbandoned() const {
+        return _status == TableStatus::kAbandoned;
+    }
+
+private:
+    using DocumentIndexes = std::vector<size_t>;
+
+    TableStatus _status = TableStatus::kBuilding;
+    const size_t _maxSizeBytes;
+    size_t _sizeBytes = 0;
+
+    // Own the path and the null that the members below refer to.
+    const std::string _foreignField;
+    const BSONObj _nullObj;
+
+    const ElementPath _foreignFieldPath;
+
+    // Whether a document matches a null key depends on more than the values along the path, e.g.
+    // {a: [{b: 1}, {c: 1}]} matches {'a.b': null}, so it is decided with the real predicate.
+    EqualityMatchExpression _matchesNull;
+
+    std::vector<Document> _docs;
+
+    // Maps each non-null value along 'foreignField' to the positions in '_docs' of the documents
+    // containing it.
+    ValueUnorderedMap<DocumentIndexes> _index;
+
+    // Positions in '_docs' of the documents matching a null key.
+    DocumentIndexes _nullMatches;
+};
+
+}  // namespace mongo
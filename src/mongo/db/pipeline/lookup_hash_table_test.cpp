@@ -0,0 +1,161 @@
+/**
+ * Copyright (C) 2018 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kTableSizeBytes = 1024 * 1024;
+
+std::vector<Value> probe(const LookupHashTable& table, std::vector<Value> keys) {
+    return table.probe(keys);
+}
+
+TEST(LookupHashTableTest, TableIsInBuildingModeUponInstantiation) {
+    ValueComparator comparator;
+    LookupHashTable table(comparator, FieldPath("a"), kTableSizeBytes);
+    ASSERT(table.isBuilding());
+}
+
+DEATH_TEST(LookupHashTableTest, CannotProbeTableWhileBuilding, "invariant") {
+    ValueComparator comparator;
+    LookupHashTable table(comparator, FieldPath("a"), kTableSizeBytes);
+    table.add(DOC("_id" << 0 << "a" << 1));
+
+    probe(table, {Value(1)});
+}
+
+TEST(LookupHashTableTest, ProbeReturnsDocumentsWithEqualKeyInInsertionOrder) {
+    ValueComparator comparator;
+    LookupHashTable table(comparator, FieldPath("a"), kTableSizeBytes);
+    table.add(DOC("_id" << 0 << "a" << 1));
+    table.add(DOC("_id" << 1 << "a" << 2));
+    table.add(DOC("_id" << 2 << "a" << 1.0));
+    table.freeze();
+
+    ASSERT(table.isServing());
+    ASSERT_EQ(table.count(), 3ul);
+    ASSERT_VALUE_EQ(Value(probe(table, {Value(1)})),
+                    Value(std::vector<Value>{Value(DOC("_id" << 0 << "a" << 1)),
+                                             Value(DOC("_id" << 2 << "a" << 1.0))}));
+    ASSERT_VALUE_EQ(Value(probe(table, {Value(2)})),
+                    Value(std::vector<Value>{Value(DOC("_id" << 1 << "a" << 2))}));
+    ASSERT(probe(table, {Value(3)}).empty());
+}
+
+TEST(LookupHashTableTest, ProbeMatchesArrayElementsAndWholeArrays) {
+    ValueComparator comparator;
+    LookupHashTable table(comparator, FieldPath("a"), kTableSizeBytes);
+    table.add(DOC("_id" << 0 << "a" << DOC_ARRAY(1 << 2 << 1)));
+    table.add(DOC("_id" << 1 << "a" << DOC_ARRAY(2 << 3)));
+    table.freeze();
+
+    auto results = probe(table, {Value(1)});
+    ASSERT_EQ(results.size(), 1ul);
+    ASSERT_VALUE_EQ(results[0]["_id"], Value(0));
+
+    ASSERT_EQ(probe(table, {Value(2)}).size(), 2ul);
+
+    results = probe(table, {Value(DOC_ARRAY(2 << 3))});
+    ASSERT_EQ(results.size(), 1ul);
+    ASSERT_VALUE_EQ(results[0]["_id"], Value(1));
+}
+
+TEST(LookupHashTableTest, ProbeWithSeveralKeysReturnsEachDocumentOnce) {
+    ValueComparator comparator;
+    LookupHashTable table(comparator, FieldPath("a"), kTableSizeBytes);
+    table.add(DOC("_id" << 0 << "a" << DOC_ARRAY(1 << 2)));
+    table.add(DOC("_id" << 1 << "a" << 3));
+    table.add(DOC("_id" << 2 << "a" << 2));
+    table.freeze();
+
+    auto results = probe(table, {Value(3), Value(2), Value(1)});
+    ASSERT_EQ(results.size(), 3ul);
+    ASSERT_VALUE_EQ(results[0]["_id"], Value(0));
+    ASSERT_VALUE_EQ(results[1]["_id"], Value(1));
+    ASSERT_VALUE_EQ(results[2]["_id"], Value(2));
+}
+
+TEST(LookupHashTableTest, NullKeyMatchesNullAndMissing) {
+    ValueComparator comparator;
+    LookupHashTable table(comparator, FieldPath("a.b"), kTableSizeBytes);
+    table.add(DOC("_id" << 0 << "a" << DOC("b" << BSONNULL)));
+    table.add(DOC("_id" << 1 << "a" << DOC("c" << 1)));
+    table.add(DOC("_id" << 2 << "a" << DOC_ARRAY(DOC("b" << 1) << DOC("c" << 1))));
+    table.add(DOC("_id" << 3 << "a" << DOC("b" << 1)));
+    table.freeze();
+
+    auto results = probe(table, {Value(BSONNULL)});
+    ASSERT_EQ(results.size(), 3ul);
+    ASSERT_VALUE_EQ(results[0]["_id"], Value(0));
+    ASSERT_VALUE_EQ(results[1]["_id"], Value(1));
+    ASSERT_VALUE_EQ(results[2]["_id"], Value(2));
+
+    results = probe(table, {Value(1)});
+    ASSERT_EQ(results.size(), 2ul);
+    ASSERT_VALUE_EQ(results[0]["_id"], Value(2));
+    ASSERT_VALUE_EQ(results[1]["_id"], Value(3));
+}
+
+TEST(LookupHashTableTest, ProbeRespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    ValueComparator comparator(&collator);
+    LookupHashTable table(comparator, FieldPath("a"), kTableSizeBytes);
+    table.add(DOC("_id" << 0 << "a"
+                        << "foo"_sd));
+    table.add(DOC("_id" << 1 << "a" << 1));
+    table.freeze();
+
+    auto results = probe(table, {Value("bar"_sd)});
+    ASSERT_EQ(results.size(), 1ul);
+    ASSERT_VALUE_EQ(results[0]["_id"], Value(0));
+}
+
+TEST(LookupHashTableTest, TableIsAbandonedWhenMaxSizeIsExceeded) {
+    ValueComparator comparator;
+    auto doc = DOC("_id" << 0 << "a" << 1);
+    LookupHashTable table(comparator, FieldPath("a"), doc.getApproximateSize() * 2);
+    table.add(doc);
+    ASSERT(table.isBuilding());
+    table.add(doc);
+
+    ASSERT(table.isAbandoned());
+    ASSERT_EQ(table.count(), 0ul);
+    ASSERT_EQ(table.sizeBytes(), 0ul);
+}
+
+}  // namespace
+}  // namespace mongo
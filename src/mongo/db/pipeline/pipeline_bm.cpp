@@ -0,0 +1,273 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_project.h"
+#include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+namespace {
+
+// The shapes of input document the benchmarks are run over, selected by state.range(0).
+enum class Shape : int {
+    // A handful of top-level scalar fields.
+    kFlat = 0,
+    // Fifty top-level scalar fields.
+    kWide = 1,
+    // A sub-document and a ten-element array of sub-documents.
+    kNested = 2,
+};
+
+Document makeDoc(Shape shape, int i) {
+    BSONObjBuilder bob;
+    bob.append("_id", i);
+    bob.append("a", i);
+    bob.append("c", i % 10);
+    bob.append("s", "str" + std::to_string(i % 100));
+    switch (shape) {
+        case Shape::kFlat:
+            break;
+        case Shape::kWide:
+            for (int f = 0; f < 50; ++f) {
+                bob.append("f" + std::to_string(f), i * f);
+            }
+            break;
+        case Shape::kNested: {
+            bob.append("sub", BSON("x" << i % 7 << "y" << BSON("z" << i)));
+            BSONArrayBuilder arr(bob.subarrayStart("arr"));
+            for (int e = 0; e < 10; ++e) {
+                arr.append(BSON("k" << e << "v" << i * e));
+            }
+            arr.done();
+            break;
+        }
+    }
+    return Document(bob.obj());
+}
+
+std::deque<DocumentSource::GetNextResult> makeInput(Shape shape, int numDocs) {
+    std::deque<DocumentSource::GetNextResult> input;
+    for (int i = 0; i < numDocs; ++i) {
+        // Spread the sort key so that $sort does real work.
+        input.emplace_back(makeDoc(shape, (i * 7919) % numDocs));
+    }
+    return input;
+}
+
+/**
+ * Runs 'stage' over a fresh DocumentSourceMock holding 'input' on each iteration, exhausting it.
+ * Only the draining of the stage is timed; rebuilding the mock and the stage is not.
+ */
+void runStage(benchmark::State& state,
+              const std::deque<DocumentSource::GetNextResult>& input,
+              const stdx::function<boost::intrusive_ptr<DocumentSource>()>& makeStage) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto mock = DocumentSourceMock::create(input);
+        auto stage = makeStage();
+        stage->setSource(mock.get());
+        state.ResumeTiming();
+
+        for (auto next = stage->getNext(); next.isAdvanced(); next = stage->getNext()) {
+            benchmark::DoNotOptimize(next.getDocument());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+void BM_documentFromBson(benchmark::State& state) {
+    const BSONObj obj = makeDoc(static_cast<Shape>(state.range(0)), 1).toBson();
+    for (auto _ : state) {
+        Document doc(obj);
+        // Documents are lazily populated from BSON, so touch the last field to force the scan.
+        benchmark::DoNotOptimize(doc["s"]);
+    }
+}
+
+void BM_documentToBson(benchmark::State& state) {
+    const Document doc = makeDoc(static_cast<Shape>(state.range(0)), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.toBson());
+    }
+}
+
+void BM_documentSetField(benchmark::State& state) {
+    const Document doc = makeDoc(static_cast<Shape>(state.range(0)), 1);
+    for (auto _ : state) {
+        MutableDocument md(doc);
+        md.setField("a", Value(2));
+        md.setField("added", Value("new"_sd));
+        benchmark::DoNotOptimize(md.freeze());
+    }
+}
+
+void BM_valueCompare(benchmark::State& state) {
+    const Document left = makeDoc(static_cast<Shape>(state.range(0)), 1);
+    const Document right = makeDoc(static_cast<Shape>(state.range(0)), 2);
+    const Value lhs(left);
+    const Value rhs(right);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Value::compare(lhs, rhs, nullptr));
+    }
+}
+
+void BM_valueHash(benchmark::State& state) {
+    const Value val(makeDoc(static_cast<Shape>(state.range(0)), 1));
+    for (auto _ : state) {
+        size_t seed = 0;
+        val.hash_combine(seed, nullptr);
+        benchmark::DoNotOptimize(seed);
+    }
+}
+
+// One expression per family, selected by state.range(0); state.range(1) selects the shape.
+const char* const kExpressions[] = {
+    // Arithmetic.
+    "{'': {$add: [{$multiply: ['$a', 2]}, {$mod: ['$c', 3]}, 1]}}",
+    // Comparison and boolean.
+    "{'': {$and: [{$gt: ['$a', 10]}, {$lte: ['$c', 8]}, {$ne: ['$s', 'str1']}]}}",
+    // Conditional.
+    "{'': {$cond: [{$eq: ['$c', 3]}, '$a', {$ifNull: ['$missing', '$c']}]}}",
+    // String.
+    "{'': {$concat: [{$toUpper: '$s'}, '-', {$substrBytes: ['$s', 0, 3]}]}}",
+    // Object construction.
+    "{'': {x: '$a', y: {$add: ['$c', 1]}, z: '$s'}}",
+    // Array.
+    "{'': {$size: {$map: {input: {$range: [0, '$c']}, in: {$multiply: ['$$this', 2]}}}}}",
+};
+
+void BM_expressionEvaluate(benchmark::State& state) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = Expression::parseOperand(expCtx,
+                                         fromjson(kExpressions[state.range(0)]).firstElement(),
+                                         expCtx->variablesParseState)
+                    ->optimize();
+    std::vector<Document> docs;
+    for (int i = 0; i < 1000; ++i) {
+        docs.push_back(makeDoc(static_cast<Shape>(state.range(1)), i));
+    }
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            benchmark::DoNotOptimize(expr->evaluate(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void expressionArgs(benchmark::internal::Benchmark* b) {
+    for (int expr = 0; expr < static_cast<int>(std::extent<decltype(kExpressions)>::value);
+         ++expr) {
+        for (int shape = 0; shape <= 2; ++shape) {
+            b->Args({expr, shape});
+        }
+    }
+}
+
+/**
+ * Registers the stage benchmarks over each shape at a small and a large input size.
+ */
+void stageArgs(benchmark::internal::Benchmark* b) {
+    for (int shape = 0; shape <= 2; ++shape) {
+        for (int numDocs : {1000, 10000}) {
+            b->Args({shape, numDocs});
+        }
+    }
+}
+
+void BM_group(benchmark::State& state, const char* spec) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto input = makeInput(static_cast<Shape>(state.range(0)), state.range(1));
+    const BSONObj specObj = fromjson(spec);
+    runStage(state, input, [&] {
+        return DocumentSourceGroup::createFromBson(specObj.firstElement(), expCtx);
+    });
+}
+
+void BM_unwind(benchmark::State& state) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    // Only the nested shape has an array to unwind; the others exercise the missing-path case.
+    const auto input = makeInput(static_cast<Shape>(state.range(0)), state.range(1));
+    const BSONObj specObj = fromjson("{$unwind: {path: '$arr', preserveNullAndEmptyArrays: true}}");
+    runStage(state, input, [&] {
+        return DocumentSourceUnwind::createFromBson(specObj.firstElement(), expCtx);
+    });
+}
+
+void BM_project(benchmark::State& state, const char* spec) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto input = makeInput(static_cast<Shape>(state.range(0)), state.range(1));
+    const BSONObj specObj = fromjson(spec);
+    runStage(state, input, [&] {
+        return DocumentSourceProject::createFromBson(specObj.firstElement(), expCtx);
+    });
+}
+
+void BM_sort(benchmark::State& state, const char* spec) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto input = makeInput(static_cast<Shape>(state.range(0)), state.range(1));
+    const BSONObj specObj = fromjson(spec);
+    runStage(state, input, [&] {
+        return DocumentSourceSort::createFromBson(specObj.firstElement(), expCtx);
+    });
+}
+
+BENCHMARK(BM_documentFromBson)->DenseRange(0, 2);
+BENCHMARK(BM_documentToBson)->DenseRange(0, 2);
+BENCHMARK(BM_documentSetField)->DenseRange(0, 2);
+BENCHMARK(BM_valueCompare)->DenseRange(0, 2);
+BENCHMARK(BM_valueHash)->DenseRange(0, 2);
+
+BENCHMARK(BM_expressionEvaluate)->Apply(expressionArgs);
+
+BENCHMARK_CAPTURE(BM_group, lowCardinality, "{$group: {_id: '$c', n: {$sum: 1}, m: {$max: '$a'}}}")
+    ->Apply(stageArgs);
+BENCHMARK_CAPTURE(BM_group, highCardinality, "{$group: {_id: '$a', n: {$sum: 1}}}")
+    ->Apply(stageArgs);
+BENCHMARK_CAPTURE(BM_group, compoundKey, "{$group: {_id: {c: '$c', s: '$s'}, avg: {$avg: '$a'}}}")
+    ->Apply(stageArgs);
+BENCHMARK(BM_unwind)->Apply(stageArgs);
+BENCHMARK_CAPTURE(BM_project, inclusion, "{$project: {a: 1, s: 1}}")->Apply(stageArgs);
+BENCHMARK_CAPTURE(BM_project, exclusion, "{$project: {a: 0, s: 0}}")->Apply(stageArgs);
+BENCHMARK_CAPTURE(BM_project, computed, "{$project: {x: {$add: ['$a', '$c']}, s: 1}}")
+    ->Apply(stageArgs);
+BENCHMARK_CAPTURE(BM_sort, singleKey, "{$sort: {a: 1}}")->Apply(stageArgs);
+BENCHMARK_CAPTURE(BM_sort, compoundKey, "{$sort: {c: 1, s: -1, a: 1}}")->Apply(stageArgs);
+
+}  // namespace
+}  // namespace mongo
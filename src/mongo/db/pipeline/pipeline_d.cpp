@@ -37,13 +37,17 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/locker_noop.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/multi_iterator.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
@@ -52,24 +56,34 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_facet.h"
 #include "mongo/db/pipeline/document_source_geo_near.h"
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_parallel_exchange.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
+#include "mongo/db/pipeline/mongo_process_interface.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
@@ -79,8 +93,12 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 #include "mongo/s/write_ops/cluster_write.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -262,6 +280,259 @@ StringData extractGeoNearFieldFromIndexes(OperationContext* opCtx, Collection* c
     }
     MONGO_UNREACHABLE;
 }
+
+/**
+ * If the pipeline starts with a $group which only counts its input, and the record store knows
+ * exactly how many records the collection has, makes the $group count them instead of reading
+ * them. Returns true if it did, in which case the pipeline needs no cursor.
+ */
+bool countFromRecordStore(Collection* collection,
+                          const intrusive_ptr<ExpressionContext>& expCtx,
+                          Pipeline::SourceContainer& sources) {
+    auto groupStage = dynamic_cast<DocumentSourceGroup*>(sources.front().get());
+    if (!groupStage || !groupStage->onlyCountsInput()) {
+        return false;
+    }
+
+    // The record count is of the latest data, which only a local read outside of a transaction
+    // sees, and includes orphaned documents, which a shard has to filter out. Reads from a
+    // timestamp, such as those on a secondary at lastApplied, may not see the writes of a batch
+    // which is being applied even though they are already counted.
+    auto opCtx = expCtx->opCtx;
+    const auto readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    const auto readSource = opCtx->recoveryUnit()->getTimestampReadSource();
+    if (expCtx->explain || expCtx->inMultiDocumentTransaction ||
+        (readSource != RecoveryUnit::ReadSource::kUnset &&
+         readSource != RecoveryUnit::ReadSource::kNoTimestamp) ||
+        readConcernArgs.getArgsAtClusterTime() ||
+        (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern &&
+         readConcernArgs.getLevel() != repl::ReadConcernLevel::kAvailableReadConcern) ||
+        ShardingState::get(opCtx)->needCollectionMetadata(opCtx, collection->ns().ns())) {
+        return false;
+    }
+
+    const auto count = collection->getRecordStore()->exactNumRecords(opCtx);
+    if (!count) {
+        return false;
+    }
+    groupStage->setInputCount(*count);
+    return true;
+}
+
+/**
+ * Returns true if 'expr' can be evaluated by several threads at once. $expr and $where evaluate
+ * with state shared through the ExpressionContext or a JavaScript scope.
+ */
+bool canMatchConcurrently(const MatchExpression* expr) {
+    if (expr->matchType() == MatchExpression::EXPRESSION ||
+        expr->matchType() == MatchExpression::WHERE) {
+        return false;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (!canMatchConcurrently(expr->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the timestamp at which several threads can count the documents of 'collection' which
+ * 'exec' returns, or boost::none if 'exec' has to count them itself. The threads read at the
+ * all-committed timestamp of a primary, which must include the writes this client already made,
+ * and evaluate the filter of a plain collection scan.
+ */
+boost::optional<Timestamp> getParallelCountTimestamp(Collection* collection,
+                                                     const intrusive_ptr<ExpressionContext>& expCtx,
+                                                     PlanExecutor* exec) {
+    auto opCtx = expCtx->opCtx;
+    const auto readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    const auto readSource = opCtx->recoveryUnit()->getTimestampReadSource();
+    if (!collection || collection->ns().isOplog() || expCtx->explain ||
+        expCtx->inMultiDocumentTransaction ||
+        (readSource != RecoveryUnit::ReadSource::kUnset &&
+         readSource != RecoveryUnit::ReadSource::kNoTimestamp) ||
+        readConcernArgs.getArgsAtClusterTime() ||
+        (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern &&
+         readConcernArgs.getLevel() != repl::ReadConcernLevel::kAvailableReadConcern) ||
+        collection->getRecordStore()->numRecords(opCtx) <
+            internalQueryParallelCountMinRecords.load()) {
+        return boost::none;
+    }
+
+    PlanStage* root = exec->getRootStage();
+    while (root->stageType() == STAGE_PROJECTION) {
+        root = root->getChildren()[0].get();
+    }
+    auto cq = exec->getCanonicalQuery();
+    if (root->stageType() != STAGE_COLLSCAN || !cq || !canMatchConcurrently(cq->root())) {
+        return boost::none;
+    }
+
+    auto storageEngine = opCtx->getServiceContext()->getStorageEngine();
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (!storageEngine->supportsReadConcernSnapshot() ||
+        replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet ||
+        !replCoord->getMemberState().primary()) {
+        return boost::none;
+    }
+
+    const Timestamp readTimestamp = storageEngine->getAllCommittedTimestamp();
+    const auto lastOp = repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
+    const auto minSnapshot = collection->getMinimumVisibleSnapshot();
+    if (readTimestamp.isNull() || readTimestamp < lastOp.getTimestamp() ||
+        (minSnapshot && readTimestamp < *minSnapshot)) {
+        return boost::none;
+    }
+    return readTimestamp;
+}
+
+/**
+ * Returns the number of documents in the range [start, stop) of 'collection' which match 'filter'.
+ */
+long long countRangeMatches(OperationContext* opCtx,
+                            const Collection* collection,
+                            const MatchExpression* filter,
+                            const RecordId& start,
+                            const RecordId& stop,
+                            const AtomicWord<bool>& interrupted) {
+    CollectionScanParams params;
+    params.collection = collection;
+    params.start = start;
+    params.stop = stop;
+    WorkingSet ws;
+    CollectionScan scan(opCtx, params, &ws, filter);
+
+    long long count = 0;
+    for (size_t numWorks = 1;; ++numWorks) {
+        if (numWorks % 128 == 0 && interrupted.load()) {
+            uasserted(ErrorCodes::Interrupted, "Parallel count was interrupted");
+        }
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        switch (scan.work(&id)) {
+            case PlanStage::ADVANCED:
+                ++count;
+                ws.free(id);
+                break;
+            case PlanStage::IS_EOF:
+                return count;
+            case PlanStage::NEED_YIELD:
+                // The snapshot keeps the read timestamp, so the scan resumes where it was.
+                scan.saveState();
+                opCtx->recoveryUnit()->abandonSnapshot();
+                scan.restoreState();
+                break;
+            case PlanStage::FAILURE:
+            case PlanStage::DEAD:
+                uassertStatusOK(WorkingSetCommon::getMemberStatus(*ws.get(id)));
+                MONGO_UNREACHABLE;
+            case PlanStage::NEED_TIME:
+                break;
+        }
+    }
+}
+
+/**
+ * Counts the documents of the collection scan planned by 'exec' by splitting the collection into
+ * ranges with CollectionScan::sampleRangeBoundaries() and scanning each of them on a thread of its
+ * own, all reading at a common timestamp. Returns boost::none if the count can't be split, in which
+ * case 'exec' has to count the documents itself.
+ *
+ * The threads rely on the intent lock this operation holds on the collection rather than taking
+ * locks of their own, which could queue behind an exclusive lock waiting for this operation.
+ */
+boost::optional<long long> countInParallel(Collection* collection,
+                                           const intrusive_ptr<ExpressionContext>& expCtx,
+                                           PlanExecutor* exec) {
+    const auto readTimestamp = getParallelCountTimestamp(collection, expCtx, exec);
+    if (!readTimestamp) {
+        return boost::none;
+    }
+
+    auto opCtx = expCtx->opCtx;
+    auto makeRangeOpCtx = [&] {
+        auto rangeOpCtx = cc().makeOperationContext();
+        rangeOpCtx->swapLockState(stdx::make_unique<LockerNoop>());
+        rangeOpCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided,
+                                                           *readTimestamp);
+        return rangeOpCtx;
+    };
+
+    // The boundaries have to exist at the read timestamp, since each range scan seeks to its start.
+    std::vector<RecordId> boundaries;
+    {
+        auto client = opCtx->getServiceContext()->makeClient("parallelCountSampler");
+        AlternativeClientRegion acr(client);
+        auto sampleOpCtx = makeRangeOpCtx();
+        boundaries = CollectionScan::sampleRangeBoundaries(
+            sampleOpCtx.get(), collection, internalQueryParallelCountThreads.load());
+    }
+    if (boundaries.empty()) {
+        return boost::none;
+    }
+
+    const MatchExpression* filter = exec->getCanonicalQuery()->root();
+    const size_t numRanges = boundaries.size() + 1;
+    std::vector<long long> counts(numRanges, 0);
+
+    stdx::mutex mutex;
+    stdx::condition_variable rangeDone;
+    size_t numRunning = numRanges;
+    Status status = Status::OK();
+    AtomicWord<bool> interrupted{false};
+
+    auto countRange = [&](size_t i) {
+        Client::initThread("parallelCount");
+
+        Status rangeStatus = Status::OK();
+        try {
+            auto rangeOpCtx = makeRangeOpCtx();
+            counts[i] = countRangeMatches(rangeOpCtx.get(),
+                                          collection,
+                                          filter,
+                                          i == 0 ? RecordId() : boundaries[i - 1],
+                                          i == boundaries.size() ? RecordId() : boundaries[i],
+                                          interrupted);
+        } catch (const DBException& ex) {
+            rangeStatus = ex.toStatus();
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (!rangeStatus.isOK() && status.isOK()) {
+                status = rangeStatus;
+                interrupted.store(true);
+            }
+            --numRunning;
+        }
+        rangeDone.notify_all();
+    };
+
+    std::vector<stdx::thread> threads;
+    ON_BLOCK_EXIT([&] {
+        interrupted.store(true);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+    for (size_t i = 0; i < numRanges; ++i) {
+        threads.emplace_back(countRange, i);
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    opCtx->waitForConditionOrInterrupt(rangeDone, lk, [&] { return numRunning == 0; });
+    uassertStatusOK(status);
+
+    long long total = 0;
+    for (auto count : counts) {
+        total += count;
+    }
+    LOG(1) << "Counted " << total << " documents of " << collection->ns() << " in " << numRanges
+           << " ranges in parallel at " << readTimestamp->toString();
+    return total;
+}
+
 }  // namespace
 
 void PipelineD::prepareCursorSource(Collection* collection,
@@ -280,6 +551,10 @@ void PipelineD::prepareCursorSource(Collection* collection,
     // We are going to generate an input cursor, so we need to be holding the collection lock.
     dassert(expCtx->opCtx->lockState()->isCollectionLockedForMode(nss.ns(), MODE_IS));
 
+    if (collection && !sources.empty() && countFromRecordStore(collection, expCtx, sources)) {
+        return;
+    }
+
     if (!sources.empty()) {
         auto sampleStage = dynamic_cast<DocumentSourceSample*>(sources.front().get());
         // Optimize an initial $sample stage if possible.
@@ -419,6 +694,17 @@ void PipelineD::prepareGenericCursorSource(Collection* collection,
                                                 &sortObj,
                                                 &projForQuery));
 
+    // A $group which only counts its input needs no cursor if the count can be split between
+    // several threads.
+    if (internalQueryParallelCountThreads.load() >= 2 && !sources.empty()) {
+        auto countStage = dynamic_cast<DocumentSourceGroup*>(sources.front().get());
+        if (countStage && countStage->onlyCountsInput()) {
+            if (auto count = countInParallel(collection, expCtx, exec.get())) {
+                countStage->setInputCount(*count);
+                return;
+            }
+        }
+    }
 
     if (!projForQuery.isEmpty() && !sources.empty()) {
         // Check for redundant $project in query with the same specification as the inclusion
@@ -751,6 +1037,143 @@ void PipelineD::addCursorSource(Pipeline* pipeline,
     pipeline->addInitialSource(std::move(cursor));
 }
 
+namespace {
+
+/**
+ * Returns true if 'stage' transforms or filters each document on its own, so that it produces the
+ * same documents when its input is split between several copies of it.
+ */
+bool isPerDocumentStage(DocumentSource* stage) {
+    return dynamic_cast<DocumentSourceMatch*>(stage) ||
+        dynamic_cast<DocumentSourceSingleDocumentTransformation*>(stage) ||
+        dynamic_cast<DocumentSourceUnwind*>(stage);
+}
+
+/**
+ * Returns true if parts of the pipeline using 'expCtx' may run on operations other than its own.
+ * Those operations cannot share a transaction or a read concern other than the default with it,
+ * nor continue a tailable cursor.
+ */
+bool canRunOnOtherOperations(const ExpressionContext& expCtx) {
+    const auto readConcernLevel = repl::ReadConcernArgs::get(expCtx.opCtx).getLevel();
+    return !expCtx.explain && !expCtx.inMultiDocumentTransaction &&
+        expCtx.tailableMode == TailableModeEnum::kNormal &&
+        (readConcernLevel == repl::ReadConcernLevel::kLocalReadConcern ||
+         readConcernLevel == repl::ReadConcernLevel::kAvailableReadConcern);
+}
+
+}  // namespace
+
+void PipelineD::addParallelExchange(Pipeline* pipeline) {
+    const int numConsumers = internalQueryParallelAggregationConsumers.load();
+    if (numConsumers < 2) {
+        return;
+    }
+
+    auto expCtx = pipeline->getContext();
+    auto opCtx = expCtx->opCtx;
+
+    // The consumers run on operations of their own.
+    if (!canRunOnOtherOperations(*expCtx)) {
+        return;
+    }
+
+    // Look for a $cursor followed by per-document stages and a $group.
+    Pipeline::SourceContainer& sources = pipeline->_sources;
+    if (sources.empty() || !dynamic_cast<DocumentSourceCursor*>(sources.front().get())) {
+        return;
+    }
+
+    auto groupIt = std::next(sources.begin());
+    while (groupIt != sources.end() && isPerDocumentStage(groupIt->get())) {
+        ++groupIt;
+    }
+    if (groupIt == sources.end()) {
+        return;
+    }
+
+    // Since the exchange hands documents to the consumers in no particular order, the $group must
+    // give the same result however its input is split, and must not promise an order of its own.
+    auto group = dynamic_cast<DocumentSourceGroup*>(groupIt->get());
+    if (!group || group->doingMerge() || group->isSortedByGroupKey() ||
+        !group->canMergePartialGroupsInAnyOrder()) {
+        return;
+    }
+
+    // Every consumer runs its own copy of the stages from after the $cursor up to and including the
+    // $group, outputting partial groups which a merging $group combines.
+    std::vector<BSONObj> consumerStages;
+    for (auto it = std::next(sources.begin()); it != std::next(groupIt); ++it) {
+        std::vector<Value> serializedStages;
+        (*it)->serializeToArray(serializedStages);
+        for (auto&& serializedStage : serializedStages) {
+            consumerStages.push_back(serializedStage.getDocument().toBson());
+        }
+    }
+    auto mergingGroup = group->createMergingGroup();
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+    spec.setConsumers(numConsumers);
+
+    boost::intrusive_ptr<Exchange> exchange =
+        new Exchange(spec, uassertStatusOK(Pipeline::create({sources.front()}, expCtx)));
+
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> consumers;
+    for (int consumerId = 0; consumerId < numConsumers; ++consumerId) {
+        // Each consumer runs on a thread of its own, so like the consumers of an Exchange requested
+        // by mongos, it needs an ExpressionContext of its own.
+        auto consumerExpCtx = expCtx->copyWith(expCtx->ns, expCtx->uuid);
+        consumerExpCtx->mongoProcessInterface = MongoProcessInterface::create(opCtx);
+        consumerExpCtx->needsMerge = true;
+
+        auto consumer = uassertStatusOK(Pipeline::parse(consumerStages, consumerExpCtx));
+        consumer->addInitialSource(
+            new DocumentSourceExchange(consumerExpCtx, exchange, consumerId));
+        consumers.push_back(std::move(consumer));
+    }
+
+    Pipeline::SourceContainer parallelSources;
+    parallelSources.push_back(
+        DocumentSourceParallelExchange::create(expCtx, exchange, std::move(consumers)));
+    parallelSources.push_back(mergingGroup);
+    parallelSources.insert(parallelSources.end(), std::next(groupIt), sources.end());
+    sources = std::move(parallelSources);
+    pipeline->stitch();
+
+    // The Exchange detached the ExpressionContext which it shares with 'pipeline'.
+    pipeline->reattachToOperationContext(opCtx);
+
+    LOG(3) << "Running " << numConsumers << " consumers of aggregation on " << expCtx->ns.ns()
+           << " in parallel: " << Value(pipeline->serialize());
+}
+
+void PipelineD::addParallelFacets(Pipeline* pipeline) {
+    const int maxThreads = internalQueryFacetMaxParallelThreads.load();
+    auto expCtx = pipeline->getContext();
+    if (maxThreads < 2 || !canRunOnOtherOperations(*expCtx)) {
+        return;
+    }
+
+    for (auto&& source : pipeline->getSources()) {
+        auto facet = dynamic_cast<DocumentSourceFacet*>(source.get());
+        if (!facet || facet->getFacetPipelines().size() < 2) {
+            continue;
+        }
+
+        std::vector<boost::intrusive_ptr<ExpressionContext>> facetExpCtxs;
+        for (size_t facetId = 0; facetId < facet->getFacetPipelines().size(); ++facetId) {
+            auto facetExpCtx = expCtx->copyWith(expCtx->ns, expCtx->uuid);
+            facetExpCtx->mongoProcessInterface = MongoProcessInterface::create(expCtx->opCtx);
+            facetExpCtxs.push_back(std::move(facetExpCtx));
+        }
+        facet->runFacetsInParallel(std::move(facetExpCtxs), maxThreads);
+
+        LOG(3) << "Running the sub-pipelines of $facet on " << expCtx->ns.ns() << " on up to "
+               << maxThreads << " threads";
+    }
+}
+
 Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
     if (auto docSourceCursor =
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
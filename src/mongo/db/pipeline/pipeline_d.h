@@ -96,6 +96,23 @@ public:
                                            const AggregationRequest* aggRequest,
                                            Pipeline* pipeline);
 
+    /**
+     * If 'internalQueryParallelAggregationConsumers' allows it and 'pipeline' begins with a
+     * $cursor, per-document stages and a $group whose accumulators are all associative and
+     * commutative, replaces those stages with an Exchange distributing the $cursor's documents
+     * round-robin to that many consumers. Each consumer runs its own copy of the per-document
+     * stages and the $group on a thread of its own, and a merging $group combines their partial
+     * groups. Must be called after the cursor source is prepared and the pipeline optimized.
+     */
+    static void addParallelExchange(Pipeline* pipeline);
+
+    /**
+     * If 'internalQueryFacetMaxParallelThreads' allows it, makes each $facet stage of 'pipeline'
+     * run its sub-pipelines on that many threads at once, each with an ExpressionContext of its
+     * own. Must be called after the pipeline is optimized.
+     */
+    static void addParallelFacets(Pipeline* pipeline);
+
     static std::string getPlanSummaryStr(const Pipeline* pipeline);
 
     static void getPlanSummaryStats(const Pipeline* pipeline, PlanSummaryStats* statsOut);
@@ -49,13 +49,15 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
-    size_t nConsumersStillProcessingThisBatch =
-        std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-            return info.nLeftToReturn > 0;
-        });
-
-    if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
-        loadNextBatch();
+    if (!_concurrentConsumers) {
+        size_t nConsumersStillProcessingThisBatch =
+            std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+                return info.nLeftToReturn > 0;
+            });
+
+        if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
+            loadNextBatch();
+        }
     }
 
     if (_buffer.empty()) {
@@ -75,12 +77,34 @@ DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
     return _buffer[bufferIndex];
 }
 
+bool TeeBuffer::loadNextBatchForConcurrentConsumers() {
+    _concurrentConsumers = true;
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (noConsumersInUse(lk)) {
+            _buffer.clear();
+            if (_source) {
+                _source->dispose();
+            }
+            return false;
+        }
+    }
+
+    loadNextBatch();
+    return !_buffer.empty();
+}
+
 void TeeBuffer::loadNextBatch() {
     _buffer.clear();
     size_t bytesInBuffer = 0;
 
     auto input = _source->getNext();
     for (; input.isAdvanced(); input = _source->getNext()) {
+        if (_concurrentConsumers) {
+            // The consumers will read this document from several threads at once.
+            input.getDocument().loadLazyFieldsRecursively();
+        }
         bytesInBuffer += input.getDocument().getApproximateSize();
         _buffer.push_back(std::move(input));
 
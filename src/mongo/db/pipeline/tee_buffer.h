@@ -35,6 +35,8 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -63,11 +65,12 @@ public:
      * consumer will not consume all input.
      */
     void dispose(size_t consumerId) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
-        if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-                return info.stillInUse;
-            })) {
+
+        // With concurrent consumers, the source is disposed of by the thread which loads batches.
+        if (!_concurrentConsumers && noConsumersInUse(lk)) {
             _buffer.clear();
             if (_source) {
                 _source->dispose();
@@ -75,6 +78,17 @@ public:
         }
     }
 
+    /**
+     * Switches this buffer to serving consumers which run concurrently, and loads the next batch
+     * for them. From then on, getNext() never loads a batch itself: a consumer which has read the
+     * whole current batch gets kPauseExecution until the next call to this function, and EOF once
+     * the source is exhausted. Only the thread calling this function reads from the source.
+     *
+     * Must not be called while any consumer is reading. Returns false if the source is exhausted,
+     * or if no consumer is still in use, in which case the source is disposed of.
+     */
+    bool loadNextBatchForConcurrentConsumers();
+
     /**
      * Retrieves the next document meant to be consumed by the pipeline given by 'consumerId'.
      * Returns GetNextState::ResultState::kPauseExecution if this pipeline has consumed the whole
@@ -92,6 +106,12 @@ private:
      */
     void loadNextBatch();
 
+    bool noConsumersInUse(WithLock) const {
+        return std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        });
+    }
+
     DocumentSource* _source = nullptr;
 
     const size_t _bufferSizeBytes;
@@ -102,5 +122,10 @@ private:
         int nLeftToReturn = 0;
     };
     std::vector<ConsumerInfo> _consumers;
+
+    // Set by loadNextBatchForConcurrentConsumers(). Consumers which run concurrently only update
+    // their own ConsumerInfo, but dispose() also reads the others', so it holds '_mutex'.
+    bool _concurrentConsumers = false;
+    stdx::mutex _mutex;
 };
 }  // namespace mongo
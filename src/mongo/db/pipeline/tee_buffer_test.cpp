@@ -166,5 +166,55 @@ TEST(TeeBufferTest, ShouldAllowOtherConsumersToAdvanceOnceTrailingConsumerIsDisp
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
 }
+TEST(TeeBufferTest, ConcurrentConsumersOnlyReadBatchesLoadedByTheOwner) {
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"a", 1}}, Document{{"a", 2}}};
+    auto mock = DocumentSourceMock::create(inputs);
+
+    const size_t nConsumers = 2;
+    const size_t bufferBytes = 1;  // Both docs won't fit in a single batch.
+    auto teeBuffer = TeeBuffer::create(nConsumers, bufferBytes);
+    teeBuffer->setSource(mock.get());
+
+    ASSERT_TRUE(teeBuffer->loadNextBatchForConcurrentConsumers());
+    for (size_t consumerId = 0; consumerId < nConsumers; ++consumerId) {
+        auto next = teeBuffer->getNext(consumerId);
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.getDocument(), inputs.front().getDocument());
+
+        // Even the last consumer to finish the batch does not load the next one.
+        ASSERT_TRUE(teeBuffer->getNext(consumerId).isPaused());
+    }
+
+    ASSERT_TRUE(teeBuffer->loadNextBatchForConcurrentConsumers());
+    for (size_t consumerId = 0; consumerId < nConsumers; ++consumerId) {
+        auto next = teeBuffer->getNext(consumerId);
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.getDocument(), inputs.back().getDocument());
+        ASSERT_TRUE(teeBuffer->getNext(consumerId).isPaused());
+    }
+
+    ASSERT_FALSE(teeBuffer->loadNextBatchForConcurrentConsumers());
+    ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
+    ASSERT_TRUE(teeBuffer->getNext(1).isEOF());
+}
+
+TEST(TeeBufferTest, ConcurrentConsumersDoNotExhaustTheSourceAfterAllAreDisposed) {
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"a", 1}}, Document{{"a", 2}}};
+    auto mock = DocumentSourceMock::create(inputs);
+
+    const size_t bufferBytes = 1;  // Both docs won't fit in a single batch.
+    auto teeBuffer = TeeBuffer::create(2, bufferBytes);
+    teeBuffer->setSource(mock.get());
+
+    ASSERT_TRUE(teeBuffer->loadNextBatchForConcurrentConsumers());
+    teeBuffer->dispose(0);
+    ASSERT_FALSE(mock->isDisposed);
+    teeBuffer->dispose(1);
+
+    // The source is disposed of by the owner, not by the consumers.
+    ASSERT_FALSE(mock->isDisposed);
+    ASSERT_FALSE(teeBuffer->loadNextBatchForConcurrentConsumers());
+    ASSERT_TRUE(mock->isDisposed);
+}
 }  // namespace
 }  // namespace mongo
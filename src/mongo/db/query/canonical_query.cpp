@@ -39,6 +39,7 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/indexability.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -244,6 +245,8 @@ Status CanonicalQuery::init(OperationContext* opCtx,
         return Status(ErrorCodes::BadValue, "cannot use sortKey $meta projection without a sort");
     }
 
+    _compiledRoot = stdx::make_unique<CompiledMatchExpression>(_root.get());
+
     return Status::OK();
 }
 
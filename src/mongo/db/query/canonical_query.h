@@ -32,6 +32,7 @@
 #include "mongo/base/status.h"
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/collation/collator_interface.h"
@@ -109,6 +110,12 @@ public:
     MatchExpression* root() const {
         return _root.get();
     }
+    /**
+     * A compiled form of root() for matching documents. Built once the tree is normalized.
+     */
+    const CompiledMatchExpression& getCompiledRoot() const {
+        return *_compiledRoot;
+    }
     BSONObj getQueryObj() const {
         return _qr->getFilter();
     }
@@ -185,6 +192,8 @@ private:
     // _root points into _qr->getFilter()
     std::unique_ptr<MatchExpression> _root;
 
+    std::unique_ptr<CompiledMatchExpression> _compiledRoot;
+
     std::unique_ptr<ParsedProjection> _proj;
 
     std::unique_ptr<CollatorInterface> _collator;
@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collation/caching_collator.h"
+
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+constexpr size_t CachingCollator::kDefaultCapacity;
+constexpr size_t CachingCollator::kMaxCachedStringSize;
+
+std::unique_ptr<CollatorInterface> CachingCollator::make(const CollatorInterface* collator,
+                                                         size_t capacity) {
+    if (!collator) {
+        return nullptr;
+    }
+    return stdx::make_unique<CachingCollator>(collator->clone(), capacity);
+}
+
+CachingCollator::CachingCollator(std::unique_ptr<CollatorInterface> collator, size_t capacity)
+    : CollatorInterface(collator->getSpec()),
+      _collator(std::move(collator)),
+      _capacity(capacity),
+      _keys(capacity) {}
+
+std::unique_ptr<CollatorInterface> CachingCollator::clone() const {
+    return make(_collator.get(), _capacity);
+}
+
+int CachingCollator::compare(StringData left, StringData right) const {
+    return _collator->compare(left, right);
+}
+
+CollatorInterface::ComparisonKey CachingCollator::getComparisonKey(StringData stringData) const {
+    if (stringData.size() > kMaxCachedStringSize) {
+        return _collator->getComparisonKey(stringData);
+    }
+
+    const std::string str = stringData.toString();
+    auto it = _keys.find(str);
+    if (it != _keys.end()) {
+        return makeComparisonKey(it->second);
+    }
+
+    auto key = _collator->getComparisonKey(stringData);
+    _keys.add(str, key.getKeyData().toString());
+    return key;
+}
+
+}  // namespace mongo
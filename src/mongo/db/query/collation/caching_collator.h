@@ -0,0 +1,75 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/util/lru_cache.h"
+
+namespace mongo {
+
+/**
+ * A collator which remembers the comparison keys of the strings it was most recently asked for,
+ * and otherwise behaves as the collator it wraps. Computing a comparison key is expensive, and
+ * sorts often see the same short strings, such as the names of countries, many times over.
+ *
+ * Only strings of up to kMaxCachedStringSize bytes are remembered. A CachingCollator is not
+ * thread-safe, so each sort has its own.
+ */
+class CachingCollator final : public CollatorInterface {
+public:
+    static constexpr size_t kDefaultCapacity = 128;
+    static constexpr size_t kMaxCachedStringSize = 64;
+
+    /**
+     * Returns a CachingCollator which wraps a clone of 'collator', or nullptr if 'collator' is null
+     * and so is the simple collation.
+     */
+    static std::unique_ptr<CollatorInterface> make(const CollatorInterface* collator,
+                                                   size_t capacity = kDefaultCapacity);
+
+    CachingCollator(std::unique_ptr<CollatorInterface> collator, size_t capacity);
+
+    std::unique_ptr<CollatorInterface> clone() const final;
+
+    int compare(StringData left, StringData right) const final;
+
+    ComparisonKey getComparisonKey(StringData stringData) const final;
+
+private:
+    const std::unique_ptr<CollatorInterface> _collator;
+    const size_t _capacity;
+
+    // The comparison keys of the strings most recently asked for, by string.
+    mutable LRUCache<std::string, std::string> _keys;
+};
+
+}  // namespace mongo
@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collation/caching_collator.h"
+
+#include <string>
+
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Reverses strings like the kReverseString mock, and counts the comparison keys it computes.
+ */
+class CountingCollator final : public CollatorInterface {
+public:
+    explicit CountingCollator(int* numKeys)
+        : CollatorInterface(_mock.getSpec()), _numKeys(numKeys) {}
+
+    std::unique_ptr<CollatorInterface> clone() const final {
+        return stdx::make_unique<CountingCollator>(_numKeys);
+    }
+
+    int compare(StringData left, StringData right) const final {
+        return _mock.compare(left, right);
+    }
+
+    ComparisonKey getComparisonKey(StringData stringData) const final {
+        ++*_numKeys;
+        return _mock.getComparisonKey(stringData);
+    }
+
+private:
+    static const CollatorInterfaceMock _mock;
+    int* const _numKeys;
+};
+
+const CollatorInterfaceMock CountingCollator::_mock(
+    CollatorInterfaceMock::MockType::kReverseString);
+
+TEST(CachingCollatorTest, SimpleCollationIsNotWrapped) {
+    ASSERT_FALSE(CachingCollator::make(nullptr));
+}
+
+TEST(CachingCollatorTest, HasTheSpecAndKeysOfTheWrappedCollator) {
+    CollatorInterfaceMock mock(CollatorInterfaceMock::MockType::kReverseString);
+    auto caching = CachingCollator::make(&mock);
+    ASSERT_TRUE(*caching == mock);
+    ASSERT_EQ(caching->getComparisonKey("abc").getKeyData(), "cba");
+    ASSERT_EQ(caching->getComparisonKey("abc").getKeyData(), "cba");
+    ASSERT_LT(caching->compare("ba", "ab"), 0);
+    ASSERT_TRUE(*caching->clone() == mock);
+}
+
+TEST(CachingCollatorTest, ComputesTheKeyOfARepeatedStringOnce) {
+    int numKeys = 0;
+    CountingCollator counting(&numKeys);
+    auto caching = CachingCollator::make(&counting, 2);
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(caching->getComparisonKey("France").getKeyData(), "ecnarF");
+        ASSERT_EQ(caching->getComparisonKey("Spain").getKeyData(), "niapS");
+    }
+    ASSERT_EQ(numKeys, 2);
+
+    // The least recently used string is forgotten when the cache is full.
+    caching->getComparisonKey("Chile");
+    caching->getComparisonKey("Spain");
+    ASSERT_EQ(numKeys, 3);
+    caching->getComparisonKey("France");
+    ASSERT_EQ(numKeys, 4);
+}
+
+TEST(CachingCollatorTest, DoesNotRememberLongStrings) {
+    int numKeys = 0;
+    CountingCollator counting(&numKeys);
+    auto caching = CachingCollator::make(&counting);
+
+    const std::string longString(CachingCollator::kMaxCachedStringSize + 1, 'x');
+    caching->getComparisonKey(longString);
+    caching->getComparisonKey(longString);
+    ASSERT_EQ(numKeys, 2);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -94,6 +94,34 @@ void flattenExecTree(const PlanStage* root, vector<const PlanStage*>* flattened)
     }
 }
 
+/**
+ * Adds the time spent in 'root' and in each stage beneath it, less the time spent in their
+ * children, to 'times' under the stage's type name.
+ */
+void addExclusiveExecutionTimes(const PlanStage* root, std::map<std::string, long long>* times) {
+    const auto& children = root->getChildren();
+    std::vector<const PlanStage*> executed;
+    if (root->stageType() == STAGE_MULTI_PLAN) {
+        auto mps = static_cast<const MultiPlanStage*>(root);
+        executed.push_back(children[mps->bestPlanIdx()].get());
+    } else {
+        for (auto&& child : children) {
+            executed.push_back(child.get());
+        }
+    }
+
+    long long childrenNanos = 0;
+    for (auto child : executed) {
+        childrenNanos += child->getCommonStats()->executionTimeNanos;
+        addExclusiveExecutionTimes(child, times);
+    }
+
+    // The times are sampled independently per stage, so a child's estimate can exceed its
+    // parent's.
+    const CommonStats* common = root->getCommonStats();
+    (*times)[common->stageTypeStr] += std::max(0LL, common->executionTimeNanos - childrenNanos);
+}
+
 /**
  * Traverse the stage tree, depth first and return the first stage of a given type.
  */
@@ -155,6 +183,9 @@ size_t getKeysExamined(StageType type, const SpecificStats* specific) {
     } else if (STAGE_DISTINCT_SCAN == type) {
         const DistinctScanStats* spec = static_cast<const DistinctScanStats*>(specific);
         return spec->keysExamined;
+    } else if (STAGE_COLUMN_SCAN == type) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        return spec->keysExamined;
     }
 
     return 0;
@@ -323,6 +354,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
         bob->appendNumber("nReturned", stats.common.advanced);
         bob->appendNumber("executionTimeMillisEstimate", stats.common.executionTimeMillis);
+        bob->appendNumber("executionTimeNanosEstimate", stats.common.executionTimeNanos);
         bob->appendNumber("works", stats.common.works);
         bob->appendNumber("advanced", stats.common.advanced);
         bob->appendNumber("needTime", stats.common.needTime);
@@ -339,6 +371,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendBool("usedDisk", spec->usedDisk);
 
             for (size_t i = 0; i < spec->mapAfterChild.size(); ++i) {
                 bob->appendNumber(string(stream() << "mapAfterChild_" << i),
@@ -361,6 +394,17 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
+            if (spec->usesZoneMap) {
+                bob->appendNumber("zoneMapSkips", spec->zoneMapSkips);
+            }
+        }
+    } else if (STAGE_COLUMN_SCAN == stats.stageType) {
+        ColumnScanStats* spec = static_cast<ColumnScanStats*>(stats.specific.get());
+        bob->append("indexName", spec->indexName);
+        bob->append("keyPattern", spec->keyPattern);
+        bob->append("fields", spec->fields);
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("keysExamined", spec->keysExamined);
         }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
@@ -532,6 +576,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendBool("usedDisk", spec->usedDisk);
         }
 
         if (spec->limit > 0) {
@@ -909,6 +954,24 @@ std::string Explain::getPlanSummary(const PlanStage* root) {
     return sb.str();
 }
 
+// static
+void Explain::getStageExecutionTimes(const PlanExecutor& exec,
+                                     std::map<std::string, long long>* timesOut) {
+    invariant(timesOut);
+
+    PlanStage* root = exec.getRootStage();
+
+    if (root->stageType() == STAGE_PIPELINE_PROXY) {
+        PlanSummaryStats stats;
+        static_cast<PipelineProxyStage*>(root)->getPlanSummaryStats(&stats);
+        *timesOut = std::move(stats.stageExecutionTimeNanos);
+        return;
+    }
+
+    timesOut->clear();
+    addExclusiveExecutionTimes(root, timesOut);
+}
+
 // static
 void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsOut) {
     invariant(NULL != statsOut);
@@ -926,6 +989,8 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
     const CommonStats* common = root->getCommonStats();
     statsOut->nReturned = common->advanced;
     statsOut->executionTimeMillis = common->executionTimeMillis;
+    statsOut->stageExecutionTimeNanos.clear();
+    addExclusiveExecutionTimes(root, &statsOut->stageExecutionTimeNanos);
 
     // The other fields are aggregations over the stages in the plan tree. We flatten
     // the tree into a list and then compute these aggregations.
@@ -959,7 +1024,10 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             const IDHackStage* idHackStage = static_cast<const IDHackStage*>(stages[i]);
             const IDHackStats* idHackStats =
                 static_cast<const IDHackStats*>(idHackStage->getSpecificStats());
-            statsOut->indexesUsed.insert(idHackStats->indexName);
+            // Collections clustered on _id are read without an index.
+            if (!idHackStats->indexName.empty()) {
+                statsOut->indexesUsed.insert(idHackStats->indexName);
+            }
         } else if (STAGE_DISTINCT_SCAN == stages[i]->stageType()) {
             const DistinctScan* distinctScan = static_cast<const DistinctScan*>(stages[i]);
             const DistinctScanStats* distinctScanStats =
@@ -156,6 +156,17 @@ public:
      */
     static void getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsOut);
 
+    /**
+     * Fills out 'timesOut' with the estimated nanoseconds spent in each type of stage in the
+     * execution tree contained in 'exec', not counting the time spent in the stage's children.
+     * Stages of the same type are summed. Of the plans raced by a MultiPlanStage, only the winner
+     * is broken down; the time spent on the losing candidates is charged to the MultiPlanStage.
+     *
+     * Cheap enough to call while the plan is still executing, e.g. when it yields.
+     */
+    static void getStageExecutionTimes(const PlanExecutor& exec,
+                                       std::map<std::string, long long>* timesOut);
+
     /**
      * If exec's root stage is a MultiPlanStage, returns the stats for the trial period of of the
      * winning plan. Otherwise, returns nullptr.
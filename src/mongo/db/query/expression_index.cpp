@@ -29,6 +29,7 @@
 #include "mongo/db/query/expression_index.h"
 
 #include <iostream>
+#include <limits>
 #include <unordered_set>
 
 #include "mongo/db/geo/geoconstants.h"
@@ -37,6 +38,8 @@
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -108,10 +111,12 @@ void ExpressionMapping::cover2d(const R2Region& region,
     GeoHashsToIntervalsWithParents(unorderedCovering, oilOut);
 }
 
-std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
-    auto minLevel = internalQueryS2GeoCoarsestLevel.load();
-    auto maxLevel = internalQueryS2GeoFinestLevel.load();
+namespace {
 
+std::vector<S2CellId> get2dsphereCoveringWithLevels(const S2Region& region,
+                                                    int minLevel,
+                                                    int maxLevel,
+                                                    int maxCells) {
     uassert(28739, "Geo coarsest level must be in range [0,30]", 0 <= minLevel && minLevel <= 30);
     uassert(28740, "Geo finest level must be in range [0,30]", 0 <= maxLevel && maxLevel <= 30);
     uassert(28741, "Geo coarsest level must be less than or equal to finest", minLevel <= maxLevel);
@@ -119,13 +124,91 @@ std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& reg
     S2RegionCoverer coverer;
     coverer.set_min_level(minLevel);
     coverer.set_max_level(maxLevel);
-    coverer.set_max_cells(internalQueryS2GeoMaxCells.load());
+    coverer.set_max_cells(maxCells);
 
     std::vector<S2CellId> cover;
     coverer.GetCovering(region, &cover);
     return cover;
 }
 
+/**
+ * Coverings of 2dsphere query regions, keyed by the region's key followed by the coverer settings
+ * that produced them. The cache is only ever trimmed on insertion, so that changes to
+ * internalQueryS2GeoCoveringCacheSize take effect without reallocating it.
+ */
+class S2CoveringCache {
+public:
+    boost::optional<std::vector<S2CellId>> get(const std::string& key) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _cache.find(key);
+        if (it == _cache.end()) {
+            return boost::none;
+        }
+        return it->second;
+    }
+
+    void add(const std::string& key, const std::vector<S2CellId>& cover, size_t maxSize) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _cache.add(key, cover);
+        while (_cache.size() > maxSize) {
+            _cache.erase(std::prev(_cache.end()));
+        }
+    }
+
+    size_t clear() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const size_t size = _cache.size();
+        while (_cache.size() > 0) {
+            _cache.erase(_cache.begin());
+        }
+        return size;
+    }
+
+private:
+    stdx::mutex _mutex;
+    LRUCache<std::string, std::vector<S2CellId>> _cache{std::numeric_limits<size_t>::max()};
+};
+
+S2CoveringCache s2CoveringCache;
+
+}  // namespace
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+    return get2dsphereCoveringWithLevels(region,
+                                         internalQueryS2GeoCoarsestLevel.load(),
+                                         internalQueryS2GeoFinestLevel.load(),
+                                         internalQueryS2GeoMaxCells.load());
+}
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCoveringCached(const S2Region& region,
+                                                                   StringData regionKey) {
+    const int minLevel = internalQueryS2GeoCoarsestLevel.load();
+    const int maxLevel = internalQueryS2GeoFinestLevel.load();
+    const int maxCells = internalQueryS2GeoMaxCells.load();
+    const int cacheSize = internalQueryS2GeoCoveringCacheSize.load();
+    if (cacheSize <= 0) {
+        return get2dsphereCoveringWithLevels(region, minLevel, maxLevel, maxCells);
+    }
+
+    // The coverer settings can be changed at runtime, so they are part of the key.
+    StringBuilder keyBuilder;
+    keyBuilder << minLevel << ',' << maxLevel << ',' << maxCells << ':' << regionKey;
+    const std::string key = keyBuilder.str();
+
+    if (auto cover = s2CoveringCache.get(key)) {
+        return std::move(*cover);
+    }
+
+    std::vector<S2CellId> cover =
+        get2dsphereCoveringWithLevels(region, minLevel, maxLevel, maxCells);
+    s2CoveringCache.add(key, cover, static_cast<size_t>(cacheSize));
+    return cover;
+}
+
+size_t ExpressionMapping::clear2dsphereCoveringCache() {
+    return s2CoveringCache.clear();
+}
+
 void ExpressionMapping::cover2dsphere(const S2Region& region,
                                       const S2IndexingParams& indexingParams,
                                       OrderedIntervalList* oilOut) {
@@ -133,6 +216,14 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+void ExpressionMapping::cover2dsphere(const S2Region& region,
+                                      StringData regionKey,
+                                      const S2IndexingParams& indexingParams,
+                                      OrderedIntervalList* oilOut) {
+    std::vector<S2CellId> cover = get2dsphereCoveringCached(region, regionKey);
+    S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
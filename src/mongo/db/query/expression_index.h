@@ -64,6 +64,21 @@ public:
 
     static std::vector<S2CellId> get2dsphereCovering(const S2Region& region);
 
+    /**
+     * Returns the same covering as get2dsphereCovering(region), but remembers it in a bounded,
+     * process-wide LRU cache so that repeated queries over the same region do not have to run the
+     * region coverer again. 'regionKey' must uniquely identify 'region', for example the BSON that
+     * 'region' was parsed from.
+     */
+    static std::vector<S2CellId> get2dsphereCoveringCached(const S2Region& region,
+                                                           StringData regionKey);
+
+    /**
+     * Removes every covering from the cache used by get2dsphereCoveringCached(), and returns how
+     * many there were. For testing only.
+     */
+    static size_t clear2dsphereCoveringCache();
+
     static void S2CellIdsToIntervals(const std::vector<S2CellId>& intervalSet,
                                      const S2IndexVersion indexVersion,
                                      OrderedIntervalList* oilOut);
@@ -77,6 +92,14 @@ public:
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    /**
+     * Like cover2dsphere() above, but computes the covering with get2dsphereCoveringCached().
+     */
+    static void cover2dsphere(const S2Region& region,
+                              StringData regionKey,
+                              const S2IndexingParams& indexParams,
+                              OrderedIntervalList* oilOut);
 };
 
 }  // namespace mongo
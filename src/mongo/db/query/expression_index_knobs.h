@@ -59,4 +59,8 @@ extern AtomicInt32 internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern AtomicInt32 internalQueryS2GeoMaxCells;
 
+// How many 2dsphere coverings of query regions and geoNear annuli do we remember? Zero disables the
+// cache.
+extern AtomicInt32 internalQueryS2GeoCoveringCacheSize;
+
 }  // namespace mongo
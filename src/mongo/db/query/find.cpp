@@ -160,6 +160,21 @@ void endQueryOp(OperationContext* opCtx,
 
 namespace {
 
+// Owned result documents of at least this many bytes are sent straight from their own buffers
+// rather than being copied into the reply. Smaller ones are cheaper to copy than to gather.
+const int kMinReplySliceBytes = 4 * 1024;
+
+/**
+ * Adds 'obj' to the documents of an OP_REPLY.
+ */
+void appendToReply(const BSONObj& obj, MessageSliceBuilder* bb) {
+    if (obj.isOwned() && obj.objsize() >= kMinReplySliceBytes) {
+        bb->appendSlice(obj.sharedBuffer(), obj.objdata(), obj.objsize());
+    } else {
+        bb->appendBuf(obj.objdata(), obj.objsize());
+    }
+}
+
 /**
  * Uses 'cursor' to fill out 'bb' with the batch of result documents to
  * be returned by this getMore.
@@ -173,7 +188,7 @@ namespace {
  */
 void generateBatch(int ntoreturn,
                    ClientCursor* cursor,
-                   BufBuilder* bb,
+                   MessageSliceBuilder* bb,
                    std::uint64_t* numResults,
                    PlanExecutor::ExecState* state) {
     PlanExecutor* exec = cursor->getExecutor();
@@ -188,7 +203,7 @@ void generateBatch(int ntoreturn,
         }
 
         // Add result to output buffer.
-        bb->appendBuf((void*)obj.objdata(), obj.objsize());
+        appendToReply(obj, bb);
 
         // Count the result.
         (*numResults)++;
@@ -318,7 +333,7 @@ Message getMore(OperationContext* opCtx,
     const int InitialBufSize =
         512 + sizeof(QueryResult::Value) + FindCommon::kMaxBytesToReturnToClientAtOnce;
 
-    BufBuilder bb(InitialBufSize);
+    MessageSliceBuilder bb(InitialBufSize);
     bb.skip(sizeof(QueryResult::Value));
 
     if (!ccPin.isOK()) {
@@ -456,6 +471,9 @@ Message getMore(OperationContext* opCtx,
         Explain::getSummaryStats(*exec, &postExecutionStats);
         postExecutionStats.totalKeysExamined -= preExecutionStats.totalKeysExamined;
         postExecutionStats.totalDocsExamined -= preExecutionStats.totalDocsExamined;
+        for (auto&& stageTime : preExecutionStats.stageExecutionTimeNanos) {
+            postExecutionStats.stageExecutionTimeNanos[stageTime.first] -= stageTime.second;
+        }
         curOp.debug().setPlanSummaryMetrics(postExecutionStats);
 
         // We do not report 'execStats' for aggregation or other globally managed cursors, both in
@@ -505,7 +523,7 @@ Message getMore(OperationContext* opCtx,
         }
     }
 
-    QueryResult::View qr = bb.buf();
+    QueryResult::View qr = bb.headBuf();
     qr.msgdata().setLen(bb.len());
     qr.msgdata().setOperation(opReply);
     qr.setResultFlags(resultFlags);
@@ -513,7 +531,7 @@ Message getMore(OperationContext* opCtx,
     qr.setStartingFrom(startingResult);
     qr.setNReturned(numResults);
     LOG(5) << "getMore returned " << numResults << " results\n";
-    return Message(bb.release());
+    return bb.release();
 }
 
 std::string runQuery(OperationContext* opCtx,
@@ -608,7 +626,7 @@ std::string runQuery(OperationContext* opCtx,
     // bb is used to hold query results
     // this buffer should contain either requested documents per query or
     // explain information, but not both
-    BufBuilder bb(FindCommon::kInitReplyBufferSize);
+    MessageSliceBuilder bb(FindCommon::kInitReplyBufferSize);
     bb.skip(sizeof(QueryResult::Value));
 
     // How many results have we obtained from the executor?
@@ -631,7 +649,7 @@ std::string runQuery(OperationContext* opCtx,
         }
 
         // Add result to output buffer.
-        bb.appendBuf((void*)obj.objdata(), obj.objsize());
+        appendToReply(obj, &bb);
 
         // Count the result.
         ++numResults;
@@ -704,7 +722,7 @@ std::string runQuery(OperationContext* opCtx,
     }
 
     // Fill out the output buffer's header.
-    QueryResult::View queryResultView = bb.buf();
+    QueryResult::View queryResultView = bb.headBuf();
     queryResultView.setCursorId(ccId);
     queryResultView.setResultFlagsToOk();
     queryResultView.msgdata().setLen(bb.len());
@@ -713,7 +731,8 @@ std::string runQuery(OperationContext* opCtx,
     queryResultView.setNReturned(numResults);
 
     // Add the results from the query into the output buffer.
-    result.setData(bb.release());
+    verify(result.empty());
+    result = bb.release();
 
     // curOp.debug().exhaust is set above.
     return curOp.debug().exhaust ? nss.ns() : "";
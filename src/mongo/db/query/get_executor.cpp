@@ -159,7 +159,14 @@ void fillOutPlannerParams(OperationContext* opCtx,
     while (ii.more()) {
         const IndexDescriptor* desc = ii.next();
         IndexCatalogEntry* ice = ii.catalogEntry(desc);
+        if (desc->getIndexType() == IndexType::INDEX_COLUMNSTORE) {
+            plannerParams->columnStoreIndices.push_back(
+                indexEntryFromIndexCatalogEntry(opCtx, *ice));
+            continue;
+        }
         plannerParams->indices.push_back(indexEntryFromIndexCatalogEntry(opCtx, *ice));
+        plannerParams->indices.back().histogram =
+            collection->infoCache()->getIndexHistogram(desc->indexName());
     }
 
     // If query supports index filters, filter params.indices by indices in query settings.
@@ -174,6 +181,7 @@ void fillOutPlannerParams(OperationContext* opCtx,
         if (boost::optional<AllowedIndicesFilter> allowedIndicesFilter =
                 querySettings->getAllowedIndicesFilter(planCacheKey)) {
             filterAllowedIndexEntries(*allowedIndicesFilter, &plannerParams->indices);
+            filterAllowedIndexEntries(*allowedIndicesFilter, &plannerParams->columnStoreIndices);
             plannerParams->indexFiltersApplied = true;
         }
     }
@@ -218,6 +226,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
             opCtx, collection, canonicalQuery->getQueryRequest().isTailable())) {
         plannerParams->options |= QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE;
     }
+
+    if (collection->getRecordStore()->isClusteredOnId()) {
+        plannerParams->options |= QueryPlannerParams::IS_CLUSTERED_ON_ID;
+    }
 }
 
 bool shouldWaitForOplogVisibility(OperationContext* opCtx,
@@ -307,8 +319,9 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
 
     const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
 
-    // If we have an _id index we can use an idhack plan.
-    if (descriptor && IDHackStage::supportsQuery(collection, *canonicalQuery)) {
+    // If we have an _id index, or the records are keyed by _id, we can use an idhack plan.
+    if ((descriptor || collection->getRecordStore()->isClusteredOnId()) &&
+        IDHackStage::supportsQuery(collection, *canonicalQuery)) {
         LOG(2) << "Using idhack: " << redact(canonicalQuery->toStringShort());
 
         root = make_unique<IDHackStage>(opCtx, collection, canonicalQuery.get(), ws, descriptor);
@@ -783,6 +796,7 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
     deleteStageParams.sort = request->getSort();
     deleteStageParams.opDebug = opDebug;
     deleteStageParams.stmtId = request->getStmtId();
+    deleteStageParams.maxBatchSize = internalDeleteMaxBatchSize.load();
 
     unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
     const PlanExecutor::YieldPolicy policy = parsedDelete->yieldPolicy();
@@ -818,8 +832,9 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
         const bool hasCollectionDefaultCollation = request->getCollation().isEmpty() ||
             CollatorInterface::collatorsMatch(collator.get(), collection->getDefaultCollator());
 
-        if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
-            request->getProj().isEmpty() && hasCollectionDefaultCollation) {
+        if ((descriptor || collection->getRecordStore()->isClusteredOnId()) &&
+            CanonicalQuery::isSimpleIdQuery(unparsedQuery) && request->getProj().isEmpty() &&
+            hasCollectionDefaultCollation) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
             PlanStage* idHackStage = new IDHackStage(
@@ -956,8 +971,9 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
         const bool hasCollectionDefaultCollation = CollatorInterface::collatorsMatch(
             parsedUpdate->getCollator(), collection->getDefaultCollator());
 
-        if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
-            request->getProj().isEmpty() && hasCollectionDefaultCollation) {
+        if ((descriptor || collection->getRecordStore()->isClusteredOnId()) &&
+            CanonicalQuery::isSimpleIdQuery(unparsedQuery) && request->getProj().isEmpty() &&
+            hasCollectionDefaultCollation) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
             // Working set 'ws' is discarded. InternalPlanner::updateWithIdHack() makes its own
@@ -1338,6 +1354,11 @@ bool turnIxscanIntoDistinctIxscan(QuerySolution* soln,
     }
 
     if (indexScanNode->index.type == IndexType::INDEX_WILDCARD) {
+        // A scan over a compound $** index visits each path's values once per combination of the
+        // regular fields' values, so we do not attempt to convert it into a DISTINCT_SCAN.
+        if (indexScanNode->index.keyPattern.nFields() > 2) {
+            return false;
+        }
         // If the query is on a field other than the distinct key, we may have generated a $** plan
         // which does not actually contain the distinct key field.
         if (field != std::next(indexScanNode->index.keyPattern.begin())->fieldName()) {
@@ -1467,7 +1488,10 @@ QueryPlannerParams fillOutPlannerParamsForDistinct(OperationContext* opCtx,
     while (ii.more()) {
         const IndexDescriptor* desc = ii.next();
         IndexCatalogEntry* ice = ii.catalogEntry(desc);
-        if (desc->keyPattern().hasField(parsedDistinct.getKey())) {
+        if (desc->getIndexType() == IndexType::INDEX_COLUMNSTORE) {
+            // The keys of a columnstore index are not ordered by the values of its fields.
+            continue;
+        } else if (desc->keyPattern().hasField(parsedDistinct.getKey())) {
             plannerParams.indices.push_back(indexEntryFromIndexCatalogEntry(opCtx, *ice));
         } else if (desc->getIndexType() == IndexType::INDEX_WILDCARD && !query.isEmpty()) {
             // Check whether the $** projection captures the field over which we are distinct-ing.
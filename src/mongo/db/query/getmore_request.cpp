@@ -50,6 +50,12 @@ const char kBatchSizeField[] = "batchSize";
 const char kAwaitDataTimeoutField[] = "maxTimeMS";
 const char kTermField[] = "term";
 const char kLastKnownCommittedOpTimeField[] = "lastKnownCommittedOpTime";
+const char kSortKeyBoundField[] = "$_internalSortKeyBound";
+
+const char kSortKeyField[] = "$sortKey";
+const char kBoundSortKeyField[] = "sortKey";
+const char kBoundSortPatternField[] = "sortPattern";
+const char kBoundCompareWholeSortKeyField[] = "compareWholeSortKey";
 
 }  // namespace
 
@@ -87,6 +93,14 @@ Status GetMoreRequest::isValid() const {
                                     << *batchSize);
     }
 
+    if (sortKeyBound &&
+        ((*sortKeyBound)[kBoundSortKeyField].type() != BSONType::Object ||
+         (*sortKeyBound)[kBoundSortPatternField].type() != BSONType::Object ||
+         (*sortKeyBound)[kBoundCompareWholeSortKeyField].type() != BSONType::Bool)) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Invalid sort key bound for getMore: " << *sortKeyBound);
+    }
+
     return Status::OK();
 }
 
@@ -102,6 +116,7 @@ StatusWith<GetMoreRequest> GetMoreRequest::parseFromBSON(const std::string& dbna
     boost::optional<Milliseconds> awaitDataTimeout;
     boost::optional<long long> term;
     boost::optional<repl::OpTime> lastKnownCommittedOpTime;
+    boost::optional<BSONObj> sortKeyBound;
 
     for (BSONElement el : cmdObj) {
         const auto fieldName = el.fieldNameStringData();
@@ -151,6 +166,14 @@ StatusWith<GetMoreRequest> GetMoreRequest::parseFromBSON(const std::string& dbna
                 return status;
             }
             lastKnownCommittedOpTime = ot;
+        } else if (fieldName == kSortKeyBoundField) {
+            if (el.type() != BSONType::Object) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << "Field '" << kSortKeyBoundField
+                                      << "' must be an object in: "
+                                      << cmdObj};
+            }
+            sortKeyBound = el.Obj().getOwned();
         } else if (!isGenericArgument(fieldName)) {
             return {ErrorCodes::FailedToParse,
                     str::stream() << "Failed to parse: " << cmdObj << ". "
@@ -172,6 +195,7 @@ StatusWith<GetMoreRequest> GetMoreRequest::parseFromBSON(const std::string& dbna
 
     GetMoreRequest request(
         std::move(*nss), *cursorid, batchSize, awaitDataTimeout, term, lastKnownCommittedOpTime);
+    request.sortKeyBound = std::move(sortKeyBound);
     Status validStatus = request.isValid();
     if (!validStatus.isOK()) {
         return validStatus;
@@ -202,7 +226,44 @@ BSONObj GetMoreRequest::toBSON() const {
         lastKnownCommittedOpTime->append(&builder, kLastKnownCommittedOpTimeField);
     }
 
+    if (sortKeyBound) {
+        builder.append(kSortKeyBoundField, *sortKeyBound);
+    }
+
     return builder.obj();
 }
 
+// static
+BSONObj GetMoreRequest::makeSortKeyBound(const BSONObj& sortKey,
+                                         const BSONObj& sortPattern,
+                                         bool compareWholeSortKey) {
+    return BSON(kBoundSortKeyField << sortKey << kBoundSortPatternField << sortPattern
+                                   << kBoundCompareWholeSortKeyField
+                                   << compareWholeSortKey);
+}
+
+bool GetMoreRequest::sortsAfterBound(const BSONObj& result) const {
+    invariant(sortKeyBound);
+    auto key = result[kSortKeyField];
+    if (!key) {
+        return false;
+    }
+
+    BSONObj sortKey;
+    if ((*sortKeyBound)[kBoundCompareWholeSortKeyField].boolean()) {
+        sortKey = key.wrap();
+    } else if (key.type() == BSONType::Object) {
+        sortKey = key.Obj();
+    } else {
+        return false;
+    }
+
+    // As in the merger, the sort keys hold ICU comparison keys rather than strings, so they are
+    // compared without a collator.
+    const bool considerFieldName = false;
+    return sortKey.woCompare((*sortKeyBound)[kBoundSortKeyField].Obj(),
+                             (*sortKeyBound)[kBoundSortPatternField].Obj(),
+                             considerFieldName) > 0;
+}
+
 }  // namespace mongo
@@ -85,6 +85,27 @@ struct GetMoreRequest {
     // Only internal queries from replication will have a last known committed optime.
     const boost::optional<repl::OpTime> lastKnownCommittedOpTime;
 
+    // Only set by a mongos which merges the sorted results of several shards and needs no more
+    // than a limited number of them. Once the mongos has received that many results, those which
+    // sort after the last of them can't be returned, so the shard ends the cursor at the first
+    // such result rather than sending it. Created by makeSortKeyBound().
+    boost::optional<BSONObj> sortKeyBound;
+
+    /**
+     * Returns a 'sortKeyBound' for results whose sort keys, compared according to 'sortPattern',
+     * sort after 'sortKey'. The sort keys are extracted from the $sortKey field of the results the
+     * same way as 'sortKey' was: as the object in that field, or wrapped in an object with
+     * 'compareWholeSortKey'.
+     */
+    static BSONObj makeSortKeyBound(const BSONObj& sortKey,
+                                    const BSONObj& sortPattern,
+                                    bool compareWholeSortKey);
+
+    /**
+     * Returns whether 'result' sorts after 'sortKeyBound', which must be set.
+     */
+    bool sortsAfterBound(const BSONObj& result) const;
+
 private:
     /**
      * Returns a non-OK status if there are semantic errors in the parsed request
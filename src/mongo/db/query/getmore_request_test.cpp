@@ -280,4 +280,51 @@ TEST(GetMoreRequestTest, toBSONHasMaxTimeMS) {
     ASSERT_BSONOBJ_EQ(requestObj, expectedRequest);
 }
 
+TEST(GetMoreRequestTest, SortKeyBoundRoundTrips) {
+    GetMoreRequest request(NamespaceString("testdb.testcoll"),
+                           123,
+                           boost::none,
+                           boost::none,
+                           boost::none,
+                           boost::none);
+    request.sortKeyBound = GetMoreRequest::makeSortKeyBound(
+        BSON("" << 5 << "" << 2), BSON("a" << 1 << "b" << -1), false);
+
+    auto result = GetMoreRequest::parseFromBSON("testdb", request.toBSON());
+    ASSERT_OK(result.getStatus());
+    ASSERT(result.getValue().sortKeyBound);
+    ASSERT_BSONOBJ_EQ(*result.getValue().sortKeyBound, *request.sortKeyBound);
+}
+
+TEST(GetMoreRequestTest, parseFromBSONInvalidSortKeyBound) {
+    auto result = GetMoreRequest::parseFromBSON("db",
+                                                BSON("getMore" << CursorId(123) << "collection"
+                                                               << "coll"
+                                                               << "$_internalSortKeyBound"
+                                                               << BSON("sortKey" << 1)));
+    ASSERT_EQUALS(ErrorCodes::BadValue, result.getStatus().code());
+}
+
+TEST(GetMoreRequestTest, SortsAfterBoundComparesSortKeysWithThePattern) {
+    GetMoreRequest request(NamespaceString("testdb.testcoll"),
+                           123,
+                           boost::none,
+                           boost::none,
+                           boost::none,
+                           boost::none);
+    request.sortKeyBound = GetMoreRequest::makeSortKeyBound(
+        BSON("" << 5 << "" << 2), BSON("a" << 1 << "b" << -1), false);
+
+    ASSERT_FALSE(request.sortsAfterBound(BSON("$sortKey" << BSON("" << 4 << "" << 0))));
+    ASSERT_FALSE(request.sortsAfterBound(BSON("$sortKey" << BSON("" << 5 << "" << 3))));
+    ASSERT_FALSE(request.sortsAfterBound(BSON("$sortKey" << BSON("" << 5 << "" << 2))));
+    ASSERT_TRUE(request.sortsAfterBound(BSON("$sortKey" << BSON("" << 5 << "" << 1))));
+    ASSERT_TRUE(request.sortsAfterBound(BSON("$sortKey" << BSON("" << 6 << "" << 9))));
+
+    request.sortKeyBound =
+        GetMoreRequest::makeSortKeyBound(BSON("$sortKey" << 5), BSON("$sortKey" << 1), true);
+    ASSERT_FALSE(request.sortsAfterBound(BSON("$sortKey" << 5)));
+    ASSERT_TRUE(request.sortsAfterBound(BSON("$sortKey" << 5.5)));
+}
+
 }  // namespace
@@ -30,8 +30,11 @@
 
 #include "mongo/db/query/index_bounds_builder.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <limits>
+#include <set>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/geo/geoconstants.h"
@@ -136,22 +139,17 @@ void makeNullEqualityBounds(const IndexEntry& index,
     // Just to be sure, make sure the bounds are in the right order if the hash values are opposite.
     IndexBoundsBuilder::unionize(oil);
 }
-}  // namespace
-
-string IndexBoundsBuilder::simpleRegex(const char* regex,
-                                       const char* flags,
-                                       const IndexEntry& index,
-                                       BoundsTightness* tightnessOut) {
-    if (index.collator) {
-        // Bounds building for simple regular expressions assumes that the index is in ASCII order,
-        // which is not necessarily true for an index with a collator.  Therefore, a regex can never
-        // use tight bounds if the index has a non-null collator. In this case, the regex must be
-        // applied to the fetched document rather than the index key, so the tightness is
-        // INEXACT_FETCH.
-        *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
-        return "";
-    }
 
+/**
+ * Returns the literal characters which every string matching 'regex' must start with, as
+ * described by IndexBoundsBuilder::simpleRegex(). A case-insensitive regex is only accepted if
+ * 'caseInsensitiveOK' is true, in which case matching strings start with the returned characters
+ * up to case.
+ */
+string regexLiteralPrefix(const char* regex,
+                          const char* flags,
+                          bool caseInsensitiveOK,
+                          IndexBoundsBuilder::BoundsTightness* tightnessOut) {
     *tightnessOut = IndexBoundsBuilder::INEXACT_COVERED;
 
     bool multilineOK;
@@ -187,6 +185,12 @@ string IndexBoundsBuilder::simpleRegex(const char* regex,
                 // Extended free-spacing mode.
                 extended = true;
                 break;
+            case 'i':
+                // Case-insensitive mode.
+                if (caseInsensitiveOK)
+                    continue;
+                else
+                    return "";
             default:
                 // Cannot use the index.
                 return "";
@@ -250,6 +254,78 @@ string IndexBoundsBuilder::simpleRegex(const char* regex,
     return r;
 }
 
+/**
+ * Returns whether the ICU collation keys for strings which start with a sequence of ASCII letters
+ * always start with the primary weights of those letters. This holds for the root collation, but
+ * not for locales with contractions of ASCII letters, such as "ch" in Slovak or "aa" in Danish, or
+ * with contractions of an ASCII letter and a combining mark, such as "n" and a tilde in Spanish.
+ */
+bool collatorKeepsASCIILetterPrefixes(const CollatorInterface& collator) {
+    static const std::set<std::string> kLanguages = {"de", "en", "fr", "it", "nl", "pt"};
+    const std::string& localeID = collator.getSpec().localeID;
+    if (localeID.find('@') != std::string::npos) {
+        return false;
+    }
+    return kLanguages.count(localeID.substr(0, localeID.find('_'))) > 0;
+}
+
+/**
+ * Returns the bounds on the collation keys of the strings which can match 'rme' in an index with
+ * the given collator, or boost::none if they can't be narrowed from all strings.
+ *
+ * A rooted regex whose literal prefix starts with ASCII letters only matches strings whose
+ * primary weights begin with those of the letters, whatever their case and the strength of the
+ * collation. The keys of such strings begin with the bytes of the prefix's key up to its first
+ * level separator, except for its last byte, which may end a run of compressed primary weights.
+ */
+boost::optional<Interval> collatedRegexStringBounds(const RegexMatchExpression& rme,
+                                                    const CollatorInterface& collator) {
+    IndexBoundsBuilder::BoundsTightness unused;
+    std::string prefix =
+        regexLiteralPrefix(rme.getString().c_str(), rme.getFlags().c_str(), true, &unused);
+    prefix.erase(std::find_if(prefix.begin(),
+                              prefix.end(),
+                              [](char c) { return !std::isalpha(static_cast<unsigned char>(c)); }),
+                 prefix.end());
+    if (prefix.empty() || !collatorKeepsASCIILetterPrefixes(collator)) {
+        return boost::none;
+    }
+
+    const StringData key = collator.getComparisonKey(prefix).getKeyData();
+    std::string start = key.substr(0, key.find('\x01')).toString();
+    if (!start.empty()) {
+        start.pop_back();
+    }
+
+    std::string end = start;
+    while (!end.empty() && static_cast<unsigned char>(end.back()) == 0xff) {
+        end.pop_back();
+    }
+    if (end.empty()) {
+        return boost::none;
+    }
+    end.back()++;
+    return IndexBoundsBuilder::makeRangeInterval(start, end, BoundInclusion::kIncludeStartKeyOnly);
+}
+}  // namespace
+
+string IndexBoundsBuilder::simpleRegex(const char* regex,
+                                       const char* flags,
+                                       const IndexEntry& index,
+                                       BoundsTightness* tightnessOut) {
+    if (index.collator) {
+        // Bounds building for simple regular expressions assumes that the index is in ASCII order,
+        // which is not necessarily true for an index with a collator.  Therefore, a regex can never
+        // use tight bounds if the index has a non-null collator. In this case, the regex must be
+        // applied to the fetched document rather than the index key, so the tightness is
+        // INEXACT_FETCH.
+        *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
+        return "";
+    }
+
+    return regexLiteralPrefix(regex, flags, false, tightnessOut);
+}
+
 
 // static
 void IndexBoundsBuilder::allValuesForField(const BSONElement& elt, OrderedIntervalList* out) {
@@ -343,8 +419,12 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
 
     // Under certain circumstances, queries on a $** index require that the bounds' tightness be
     // adjusted regardless of the predicate. Having filled out the initial bounds, we apply any
-    // necessary changes to the tightness here.
-    if (index.type == IndexType::INDEX_WILDCARD) {
+    // necessary changes to the tightness here. The regular fields of a compound $** index need no
+    // such adjustment.
+    if (index.type == IndexType::INDEX_WILDCARD &&
+        (elt.eoo() ||
+         elt.fieldNameStringData() ==
+             wcp::getWildcardKeyPatternElement(index).fieldNameStringData())) {
         *tightnessOut = wcp::translateWildcardIndexBoundsAndTightness(index, *tightnessOut, oilOut);
     }
 }
@@ -708,7 +788,11 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
             const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            // The original geo specification identifies the region, so that repeated queries over
+            // the same geometry can reuse its covering.
+            const BSONObj& rawObj = gme->getRawObj();
+            ExpressionMapping::cover2dsphere(
+                region, StringData(rawObj.objdata(), rawObj.objsize()), indexParams, oilOut);
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
@@ -909,8 +993,15 @@ void IndexBoundsBuilder::translateRegex(const RegexMatchExpression* rme,
     const string start =
         simpleRegex(rme->getString().c_str(), rme->getFlags().c_str(), index, tightnessOut);
 
+    boost::optional<Interval> collatedBounds;
+    if (index.collator) {
+        collatedBounds = collatedRegexStringBounds(*rme, *index.collator);
+    }
+
     // Note that 'tightnessOut' is set by simpleRegex above.
-    if (!start.empty()) {
+    if (collatedBounds) {
+        oilOut->intervals.push_back(*collatedBounds);
+    } else if (!start.empty()) {
         string end = start;
         end[end.size() - 1]++;
         oilOut->intervals.push_back(
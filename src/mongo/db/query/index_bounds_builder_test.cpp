@@ -38,7 +38,11 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/expression_index.h"
+#include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/unittest/unittest.h"
+#include "third_party/s2/s2cap.h"
+#include "third_party/s2/s2cellid.h"
+#include "third_party/s2/s2latlng.h"
 
 using namespace mongo;
 
@@ -2994,4 +2998,72 @@ TEST(IndexBoundsBuilderTest, IntersectizeBasic) {
     ASSERT_TRUE(oil2 == expectedIntersection);
 }
 
+S2Cap makeTestCap(double lng, double lat, double radians) {
+    return S2Cap::FromAxisAngle(S2LatLng::FromDegrees(lat, lng).ToPoint(),
+                                S1Angle::Radians(radians));
+}
+
+TEST(IndexBoundsBuilderTest, Cached2dsphereCoveringMatchesUncachedCovering) {
+    ExpressionMapping::clear2dsphereCoveringCache();
+    const S2Cap cap = makeTestCap(-73.97, 40.77, 0.001);
+
+    const std::vector<S2CellId> expected = ExpressionMapping::get2dsphereCovering(cap);
+    ASSERT_TRUE(ExpressionMapping::get2dsphereCoveringCached(cap, "cap") == expected);
+    ASSERT_TRUE(ExpressionMapping::get2dsphereCoveringCached(cap, "cap") == expected);
+    ASSERT_EQ(ExpressionMapping::clear2dsphereCoveringCache(), 1U);
+}
+
+TEST(IndexBoundsBuilderTest, Cached2dsphereCoveringDependsOnCovererSettings) {
+    ExpressionMapping::clear2dsphereCoveringCache();
+    const S2Cap cap = makeTestCap(-73.97, 40.77, 0.001);
+    const int finestLevel = internalQueryS2GeoFinestLevel.load();
+
+    ExpressionMapping::get2dsphereCoveringCached(cap, "cap");
+    internalQueryS2GeoFinestLevel.store(10);
+    const std::vector<S2CellId> coarse = ExpressionMapping::get2dsphereCoveringCached(cap, "cap");
+    internalQueryS2GeoFinestLevel.store(finestLevel);
+
+    for (auto&& cellId : coarse) {
+        ASSERT_LTE(cellId.level(), 10);
+    }
+    ASSERT_EQ(ExpressionMapping::clear2dsphereCoveringCache(), 2U);
+}
+
+TEST(IndexBoundsBuilderTest, Cached2dsphereCoveringsAreBoundedByCacheSize) {
+    ExpressionMapping::clear2dsphereCoveringCache();
+    const int cacheSize = internalQueryS2GeoCoveringCacheSize.load();
+
+    internalQueryS2GeoCoveringCacheSize.store(2);
+    ExpressionMapping::get2dsphereCoveringCached(makeTestCap(0, 0, 0.001), "a");
+    ExpressionMapping::get2dsphereCoveringCached(makeTestCap(1, 1, 0.001), "b");
+    ExpressionMapping::get2dsphereCoveringCached(makeTestCap(2, 2, 0.001), "c");
+    ASSERT_EQ(ExpressionMapping::clear2dsphereCoveringCache(), 2U);
+
+    internalQueryS2GeoCoveringCacheSize.store(0);
+    ExpressionMapping::get2dsphereCoveringCached(makeTestCap(0, 0, 0.001), "a");
+    ASSERT_EQ(ExpressionMapping::clear2dsphereCoveringCache(), 0U);
+
+    internalQueryS2GeoCoveringCacheSize.store(cacheSize);
+}
+
+TEST(IndexBoundsBuilderTest, TranslateGeoWithin2dsphereReusesCachedCovering) {
+    ExpressionMapping::clear2dsphereCoveringCache();
+    IndexEntry testIndex = IndexEntry(BSON("a"
+                                           << "2dsphere"));
+    BSONObj obj = fromjson(
+        "{a: {$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 1], [1, 1], [1, 0], [0, 0]]]}}}}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = testIndex.keyPattern.firstElement();
+
+    OrderedIntervalList first;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &first, &tightness);
+    OrderedIntervalList second;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &second, &tightness);
+
+    ASSERT_TRUE(first == second);
+    ASSERT_EQ(ExpressionMapping::clear2dsphereCoveringCache(), 1U);
+}
+
 }  // namespace
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <string>
 
@@ -40,6 +41,7 @@
 namespace mongo {
 
 class CollatorInterface;
+class IndexHistogram;
 class MatchExpression;
 
 /**
@@ -217,6 +219,15 @@ struct IndexEntry {
     // Null if this index orders strings according to the simple binary compare. If non-null,
     // represents the collator used to generate index keys for indexed strings.
     const CollatorInterface* collator = nullptr;
+
+    // For an expanded $** index, the position in 'keyPattern' of the query path which stands in for
+    // the wildcard component. This is only non-zero for a compound $** index whose wildcard
+    // component is preceded by regular fields.
+    size_t wildcardFieldPos = 0;
+
+    // The histogram of the leading field of the index gathered by the analyze command, or null if
+    // the index has not been analyzed. The planner uses it to estimate how many keys a scan reads.
+    std::shared_ptr<const IndexHistogram> histogram;
 };
 
 std::ostream& operator<<(std::ostream& stream, const IndexEntry::Identifier& ident);
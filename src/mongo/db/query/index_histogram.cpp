@@ -0,0 +1,188 @@
+/**
+ * Copyright (C) 2018 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_histogram.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+namespace {
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+bool intervalContains(const Interval& interval, const BSONElement& value) {
+    const int startCmp = compareValues(interval.start, value);
+    const int endCmp = compareValues(value, interval.end);
+    return (startCmp < 0 || (startCmp == 0 && interval.startInclusive)) &&
+        (endCmp < 0 || (endCmp == 0 && interval.endInclusive));
+}
+
+}  // namespace
+
+// static
+IndexHistogram IndexHistogram::make(std::vector<BSONObj> sample,
+                                    size_t numBuckets,
+                                    size_t numSampledRecords) {
+    invariant(numBuckets > 0);
+
+    IndexHistogram histogram;
+    histogram._sampleSize = sample.size();
+    histogram._numSampledRecords = numSampledRecords;
+    if (sample.empty()) {
+        return histogram;
+    }
+
+    std::sort(sample.begin(), sample.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return compareValues(lhs.firstElement(), rhs.firstElement()) < 0;
+    });
+
+    const size_t depth = (sample.size() + numBuckets - 1) / numBuckets;
+    Bucket current;
+    size_t ix = 0;
+    while (ix < sample.size()) {
+        // Consume the run of values equal to sample[ix].
+        size_t runEnd = ix + 1;
+        while (runEnd < sample.size() &&
+               compareValues(sample[ix].firstElement(), sample[runEnd].firstElement()) == 0) {
+            ++runEnd;
+        }
+
+        current.count += runEnd - ix;
+        current.upperBoundCount = runEnd - ix;
+        current.numDistinct += 1;
+        current.upperBound = sample[ix];
+
+        if (current.count >= depth || runEnd == sample.size()) {
+            current.upperBound = current.upperBound.getOwned();
+            histogram._buckets.push_back(std::move(current));
+            current = Bucket();
+        }
+        ix = runEnd;
+    }
+
+    histogram._minValue = sample.front().getOwned();
+    return histogram;
+}
+
+double IndexHistogram::estimateSelectivity(const OrderedIntervalList& oil) const {
+    if (_sampleSize == 0) {
+        // Without any data, assume the bounds cover everything.
+        return 1.0;
+    }
+
+    double count = 0;
+    for (auto&& interval : oil.intervals) {
+        if (interval.getDirection() == Interval::Direction::kDirectionDescending) {
+            count += estimateCount(interval.reverseClone());
+        } else {
+            count += estimateCount(interval);
+        }
+    }
+
+    return std::min(1.0, count / _sampleSize);
+}
+
+double IndexHistogram::estimateCount(const Interval& interval) const {
+    double count = 0;
+    for (size_t ix = 0; ix < _buckets.size(); ++ix) {
+        const Bucket& bucket = _buckets[ix];
+        const BSONElement upper = bucket.upperBound.firstElement();
+
+        if (intervalContains(interval, upper)) {
+            count += bucket.upperBoundCount;
+        }
+
+        const size_t interiorCount = bucket.count - bucket.upperBoundCount;
+        if (interiorCount == 0) {
+            continue;
+        }
+
+        // The interior of the first bucket is [minValue, upper). The interior of every other
+        // bucket is (previous upper bound, upper).
+        const bool lowerInclusive = (ix == 0);
+        const BSONElement lower =
+            lowerInclusive ? _minValue.firstElement() : _buckets[ix - 1].upperBound.firstElement();
+
+        const int endVsLower = compareValues(interval.end, lower);
+        const bool endsAfterLower =
+            endVsLower > 0 || (endVsLower == 0 && lowerInclusive && interval.endInclusive);
+        if (compareValues(interval.start, upper) >= 0 || !endsAfterLower) {
+            continue;
+        }
+
+        const int startVsLower = compareValues(interval.start, lower);
+        const bool coversLower = startVsLower < 0 ||
+            (startVsLower == 0 && (interval.startInclusive || !lowerInclusive));
+        const bool coversUpper = compareValues(interval.end, upper) >= 0;
+
+        if (coversLower && coversUpper) {
+            count += interiorCount;
+        } else if (interval.isPoint()) {
+            // Assume the interior values of the bucket are equally frequent.
+            const size_t numInteriorValues = std::max(size_t(1), bucket.numDistinct - 1);
+            count += static_cast<double>(interiorCount) / numInteriorValues;
+        } else {
+            // Nothing is known about where the interval falls inside the bucket.
+            count += interiorCount / 2.0;
+        }
+    }
+
+    return count;
+}
+
+size_t IndexHistogram::numDistinct() const {
+    size_t numDistinct = 0;
+    for (auto&& bucket : _buckets) {
+        numDistinct += bucket.numDistinct;
+    }
+    return numDistinct;
+}
+
+BSONObj IndexHistogram::toBSON() const {
+    BSONObjBuilder bob;
+    bob.appendNumber("sampleSize", static_cast<long long>(_sampleSize));
+    bob.append("keysPerRecord", keysPerRecord());
+    BSONArrayBuilder bucketsBuilder(bob.subarrayStart("buckets"));
+    for (auto&& bucket : _buckets) {
+        BSONObjBuilder bucketBuilder(bucketsBuilder.subobjStart());
+        bucketBuilder.appendAs(bucket.upperBound.firstElement(), "upperBound");
+        bucketBuilder.appendNumber("count", static_cast<long long>(bucket.count));
+        bucketBuilder.appendNumber("upperBoundCount",
+                                   static_cast<long long>(bucket.upperBoundCount));
+        bucketBuilder.appendNumber("numDistinct", static_cast<long long>(bucket.numDistinct));
+    }
+    bucketsBuilder.doneFast();
+    return bob.obj();
+}
+
+}  // namespace mongo
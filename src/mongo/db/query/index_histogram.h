@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) 2018 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+
+namespace mongo {
+
+/**
+ * An equi-depth histogram over the values of the leading field of an index, built from a sample
+ * of that field's index keys. It estimates what fraction of the index a set of bounds covers,
+ * which lets the planner reason about cardinality without relying only on the trial period. The
+ * analyze command builds them, and QueryPlanner::plan() uses them to order and prune candidates.
+ *
+ * Values must be in index key form (for example, collation keys for strings when the index has a
+ * collator) so that they can be compared directly against the intervals of an
+ * OrderedIntervalList.
+ */
+class IndexHistogram {
+public:
+    /**
+     * Builds a histogram with at most 'numBuckets' buckets from 'sample', where each element of
+     * 'sample' holds one sampled value as its first field. Every bucket ends at a distinct value,
+     * so heavily repeated values get a bucket of their own.
+     *
+     * 'numSampledRecords' is the number of documents whose keys make up 'sample', which differs
+     * from its size for multikey, sparse and partial indexes. If it is 0, each document is assumed
+     * to have one key.
+     */
+    static IndexHistogram make(std::vector<BSONObj> sample,
+                               size_t numBuckets,
+                               size_t numSampledRecords = 0);
+
+    /**
+     * Returns the estimated fraction of keys, between 0 and 1, which fall within 'oil'.
+     * Intervals may be in either direction.
+     */
+    double estimateSelectivity(const OrderedIntervalList& oil) const;
+
+    size_t numBuckets() const {
+        return _buckets.size();
+    }
+
+    size_t sampleSize() const {
+        return _sampleSize;
+    }
+
+    /**
+     * Returns the estimated number of keys the index holds per document of the collection, so that
+     * the selectivities of different indexes can be compared in documents.
+     */
+    double keysPerRecord() const {
+        return _numSampledRecords == 0 ? 1.0
+                                       : static_cast<double>(_sampleSize) / _numSampledRecords;
+    }
+
+    /**
+     * Returns the estimated number of distinct values across the whole sample.
+     */
+    size_t numDistinct() const;
+
+    BSONObj toBSON() const;
+
+private:
+    /**
+     * A bucket covers the values greater than the previous bucket's upper bound, up to and
+     * including its own.
+     */
+    struct Bucket {
+        // Single-field object holding the largest value in the bucket.
+        BSONObj upperBound;
+
+        // Number of sampled values in the bucket, including those equal to 'upperBound'.
+        size_t count = 0;
+
+        // Number of sampled values equal to 'upperBound'.
+        size_t upperBoundCount = 0;
+
+        // Number of distinct sampled values in the bucket, including 'upperBound'.
+        size_t numDistinct = 0;
+    };
+
+    IndexHistogram() = default;
+
+    // Estimates the number of sampled values within an ascending 'interval'.
+    double estimateCount(const Interval& interval) const;
+
+    std::vector<Bucket> _buckets;
+    size_t _sampleSize = 0;
+    size_t _numSampledRecords = 0;
+
+    // Single-field object holding the smallest sampled value.
+    BSONObj _minValue;
+};
+
+}  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ * Copyright (C) 2018 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects
+ * for all of the code used other than as permitted herein. If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so. If you do not
+ * wish to do so, delete this exception statement from your version. If you
+ * delete this exception statement from all source files in the program,
+ * then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_histogram.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+OrderedIntervalList makeOil(const BSONObj& bounds, bool startInclusive, bool endInclusive) {
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(Interval(bounds, startInclusive, endInclusive));
+    return oil;
+}
+
+OrderedIntervalList makePointOil(int value) {
+    return makeOil(BSON("" << value << "" << value), true, true);
+}
+
+// Sample of 100 values in [0, 100), each appearing once.
+std::vector<BSONObj> uniformSample() {
+    std::vector<BSONObj> sample;
+    for (int i = 99; i >= 0; --i) {
+        sample.push_back(BSON("" << i));
+    }
+    return sample;
+}
+
+TEST(IndexHistogramTest, EmptySampleAssumesEverythingMatches) {
+    auto histogram = IndexHistogram::make({}, 10);
+    ASSERT_EQ(histogram.numBuckets(), 0U);
+    ASSERT_EQ(histogram.sampleSize(), 0U);
+    ASSERT_EQ(histogram.estimateSelectivity(makePointOil(1)), 1.0);
+}
+
+TEST(IndexHistogramTest, BuildsEquiDepthBuckets) {
+    auto histogram = IndexHistogram::make(uniformSample(), 10);
+    ASSERT_EQ(histogram.numBuckets(), 10U);
+    ASSERT_EQ(histogram.sampleSize(), 100U);
+    ASSERT_EQ(histogram.numDistinct(), 100U);
+
+    BSONObj expectedFirstBucket =
+        BSON("upperBound" << 9 << "count" << 10 << "upperBoundCount" << 1 << "numDistinct" << 10);
+    ASSERT_BSONOBJ_EQ(histogram.toBSON()["buckets"].Array()[0].Obj(), expectedFirstBucket);
+}
+
+TEST(IndexHistogramTest, MinToMaxCoversWholeSample) {
+    auto histogram = IndexHistogram::make(uniformSample(), 10);
+    BSONObjBuilder bob;
+    bob.appendMinKey("");
+    bob.appendMaxKey("");
+    ASSERT_EQ(histogram.estimateSelectivity(makeOil(bob.obj(), true, true)), 1.0);
+}
+
+TEST(IndexHistogramTest, RangeAlignedWithBucketsIsExact) {
+    auto histogram = IndexHistogram::make(uniformSample(), 10);
+    // (9, 29] covers the second and third buckets exactly.
+    ASSERT_APPROX_EQUAL(
+        histogram.estimateSelectivity(makeOil(BSON("" << 9 << "" << 29), false, true)), 0.2, 1e-9);
+}
+
+TEST(IndexHistogramTest, DescendingIntervalMatchesAscending) {
+    auto histogram = IndexHistogram::make(uniformSample(), 10);
+    auto ascending = histogram.estimateSelectivity(makeOil(BSON("" << 9 << "" << 29), false, true));
+    auto descending =
+        histogram.estimateSelectivity(makeOil(BSON("" << 29 << "" << 9), true, false));
+    ASSERT_EQ(ascending, descending);
+}
+
+TEST(IndexHistogramTest, RangeOutsideSampleIsEmpty) {
+    auto histogram = IndexHistogram::make(uniformSample(), 10);
+    ASSERT_EQ(histogram.estimateSelectivity(makeOil(BSON("" << 100 << "" << 200), true, true)),
+              0.0);
+    ASSERT_EQ(histogram.estimateSelectivity(makeOil(BSON("" << -10 << "" << 0), true, false)),
+              0.0);
+}
+
+TEST(IndexHistogramTest, SkewedValueGetsItsOwnBucket) {
+    // 90% of the sample is the value 0, the rest is spread over [1, 10].
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 90; ++i) {
+        sample.push_back(BSON("" << 0));
+    }
+    for (int i = 1; i <= 10; ++i) {
+        sample.push_back(BSON("" << i));
+    }
+
+    auto histogram = IndexHistogram::make(std::move(sample), 10);
+    ASSERT_EQ(histogram.numDistinct(), 11U);
+    ASSERT_APPROX_EQUAL(histogram.estimateSelectivity(makePointOil(0)), 0.9, 1e-9);
+    ASSERT_LT(histogram.estimateSelectivity(makePointOil(5)), 0.1);
+}
+
+TEST(IndexHistogramTest, PointInsideBucketAssumesUniformValues) {
+    auto histogram = IndexHistogram::make(uniformSample(), 10);
+    // 15 lies in the interior of the bucket (9, 19], which holds nine interior values.
+    ASSERT_APPROX_EQUAL(histogram.estimateSelectivity(makePointOil(15)), 0.01, 1e-9);
+}
+
+TEST(IndexHistogramTest, MultipleIntervalsAreSummed) {
+    auto histogram = IndexHistogram::make(uniformSample(), 10);
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(Interval(BSON("" << 3 << "" << 3), true, true));
+    oil.intervals.push_back(Interval(BSON("" << 9 << "" << 19), false, true));
+    ASSERT_APPROX_EQUAL(histogram.estimateSelectivity(oil), 0.11, 1e-9);
+}
+
+TEST(IndexHistogramTest, KeysPerRecordComparesIndexesOfDifferentSizes) {
+    ASSERT_EQ(IndexHistogram::make(uniformSample(), 10).keysPerRecord(), 1.0);
+
+    // A multikey index holding 100 keys for 25 documents.
+    ASSERT_EQ(IndexHistogram::make(uniformSample(), 10, 25).keysPerRecord(), 4.0);
+
+    // A sparse index holding 100 keys for 400 documents.
+    auto sparse = IndexHistogram::make(uniformSample(), 10, 400);
+    ASSERT_EQ(sparse.keysPerRecord(), 0.25);
+    ASSERT_EQ(sparse.toBSON()["keysPerRecord"].numberDouble(), 0.25);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -115,7 +115,7 @@ public:
         Direction direction = FORWARD);
 
     /**
-     * Returns an IDHACK => UPDATE plan.
+     * Returns an IDHACK => UPDATE plan. 'descriptor' is null for collections clustered on _id.
      */
     static std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> updateWithIdHack(
         OperationContext* opCtx,
@@ -437,8 +437,7 @@ bool PlanCache::shouldCacheQuery(const CanonicalQuery& query) {
 //
 
 CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& entry)
-    : plannerData(entry.plannerData.size()),
-      key(key),
+    : key(key),
       query(entry.query.getOwned()),
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
@@ -446,10 +445,12 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
       decisionWorks(entry.works) {
     // CachedSolution should not having any references into
     // cache entry. All relevant data should be cloned/copied.
-    for (size_t i = 0; i < entry.plannerData.size(); ++i) {
-        verify(entry.plannerData[i]);
-        plannerData[i] = entry.plannerData[i]->clone();
-    }
+    //
+    // Only the winning plan is needed to rebuild a solution from the cache, so the runner-up
+    // plans are not cloned. This keeps cache hits cheap for shapes with many candidate plans.
+    invariant(!entry.plannerData.empty());
+    verify(entry.plannerData[0]);
+    plannerData.push_back(entry.plannerData[0]->clone());
 }
 
 CachedSolution::~CachedSolution() {
@@ -612,6 +613,14 @@ std::string SolutionCacheData::toString() const {
                                  << "tree=" << this->tree->toString() << ")";
         case COLLSCAN_SOLN:
             return "(collection scan)";
+        case SKIP_IXSCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip index scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
+        case COLUMN_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(columnstore index scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
         case USE_INDEX_TAGS_SOLN:
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
@@ -626,11 +635,53 @@ std::string SolutionCacheData::toString() const {
 
 PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+namespace {
+
+// Every live plan cache, so that the caches of idle collections can be found and cleared.
+stdx::mutex allPlanCachesMutex;
+std::list<PlanCache*> allPlanCaches;
+
+AtomicInt64 idleClockTicks;
+
+}  // namespace
+
+PlanCache::PlanCache(size_t size) : PlanCache(size, std::string()) {}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : PlanCache(internalQueryCacheSize.load(), ns) {}
 
-PlanCache::~PlanCache() {}
+PlanCache::PlanCache(size_t size, const std::string& ns)
+    : _cache(size), _lastUsedTick(idleClockTicks.load()), _ns(ns) {
+    stdx::lock_guard<stdx::mutex> lk(allPlanCachesMutex);
+    _registration = allPlanCaches.insert(allPlanCaches.end(), this);
+}
+
+PlanCache::~PlanCache() {
+    stdx::lock_guard<stdx::mutex> lk(allPlanCachesMutex);
+    allPlanCaches.erase(_registration);
+}
+
+size_t PlanCache::clearIdleCaches(long long idleTicks) {
+    const long long now = idleClockTicks.addAndFetch(1);
+    if (idleTicks <= 0) {
+        return 0;
+    }
+
+    size_t numCleared = 0;
+    stdx::lock_guard<stdx::mutex> lk(allPlanCachesMutex);
+    for (auto planCache : allPlanCaches) {
+        stdx::lock_guard<stdx::mutex> cacheLock(planCache->_cacheMutex);
+        if (planCache->_cache.size() == 0 || now - planCache->_lastUsedTick < idleTicks) {
+            continue;
+        }
+
+        LOG(1) << planCache->_ns << ": clearing " << planCache->_cache.size()
+               << " plan cache entries after " << (now - planCache->_lastUsedTick)
+               << " idle ticks";
+        numCleared += planCache->_cache.size();
+        planCache->_cache.clear();
+    }
+    return numCleared;
+}
 
 std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(const PlanCacheKey& key) const {
 
@@ -881,6 +932,7 @@ Status PlanCache::set(const CanonicalQuery& query,
     const auto key = computeKey(query);
     const size_t newWorks = why->stats[0]->common.works;
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    _lastUsedTick = idleClockTicks.load();
     bool isNewEntryActive = false;
     uint32_t queryHash;
     if (internalQueryCacheDisableInactiveEntries.load()) {
@@ -967,6 +1019,7 @@ PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
 
 PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    _lastUsedTick = idleClockTicks.load();
     PlanCacheEntry* entry = nullptr;
     Status cacheStatus = _cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
@@ -984,6 +1037,7 @@ Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
     PlanCacheKey ck = computeKey(cq);
 
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    _lastUsedTick = idleClockTicks.load();
     PlanCacheEntry* entry;
     Status cacheStatus = _cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <list>
 #include <set>
 
 #include "mongo/db/exec/plan_stats.h"
@@ -158,6 +159,14 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // The cached plan scans the index in 'tree' while skipping
+        // over values of its leading field.
+        SKIP_IXSCAN_SOLN,
+
+        // The cached plan scans the columnstore index in 'tree'
+        // in place of the collection.
+        COLUMN_SCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -185,7 +194,8 @@ public:
     CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& entry);
     ~CachedSolution();
 
-    // Owned here.
+    // Owned here. Holds only the winning plan's data, which is all that is needed to rebuild the
+    // solution.
     std::vector<SolutionCacheData*> plannerData;
 
     // Key used to provide feedback on the entry.
@@ -466,7 +476,19 @@ public:
         const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
         const std::function<bool(const BSONObj&)>& filterFunc) const;
 
+    /**
+     * Advances the clock against which the idleness of plan caches is measured by one tick, then
+     * removes all entries from every plan cache which has not been read or written during the last
+     * 'idleTicks' ticks. Does not clear index information. A non-positive 'idleTicks' only
+     * advances the clock.
+     *
+     * Returns the number of entries removed.
+     */
+    static size_t clearIdleCaches(long long idleTicks);
+
 private:
+    PlanCache(size_t size, const std::string& ns);
+
     struct NewEntryState {
         bool shouldBeCreated = false;
         bool shouldBeActive = false;
@@ -484,9 +506,15 @@ private:
 
     LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
 
-    // Protects _cache.
+    // Protects _cache and _lastUsedTick.
     mutable stdx::mutex _cacheMutex;
 
+    // The tick of the idle clock at which _cache was last read or written.
+    mutable long long _lastUsedTick;
+
+    // The position of this cache in the list of all plan caches.
+    std::list<PlanCache*>::iterator _registration;
+
     // Full namespace of collection.
     std::string _ns;
 
@@ -121,6 +121,14 @@ void PlanCacheIndexabilityState::processWildcardIndex(const IndexEntry& ie) {
         ie.identifier.catalogName,
         ie.filterExpr,
         ie.collator);
+
+    // The regular fields of a compound $** index are discriminated in the same way as the fields of
+    // a sparse index. The entry for the wildcard component is never consulted, since no query path
+    // can contain "$**".
+    if (ie.keyPattern.nFields() > 1) {
+        processSparseIndex(ie.identifier.catalogName, ie.keyPattern);
+        processIndexCollation(ie.identifier.catalogName, ie.keyPattern, ie.collator);
+    }
 }
 
 void PlanCacheIndexabilityState::processIndexCollation(const std::string& indexName,
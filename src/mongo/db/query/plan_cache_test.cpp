@@ -482,6 +482,30 @@ TEST(PlanCacheTest, InactiveEntriesDisabled) {
 }
 
 
+TEST(PlanCacheTest, ClearIdleCachesRemovesOnlyEntriesOfIdleCaches) {
+    PlanCache idleCache;
+    PlanCache usedCache;
+    QueryTestServiceContext serviceContext;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    addCacheEntryForShape(*cq, &idleCache);
+    addCacheEntryForShape(*cq, &usedCache);
+
+    // Without an idle period the clock only advances.
+    ASSERT_EQ(PlanCache::clearIdleCaches(0), 0U);
+    ASSERT_EQ(PlanCache::clearIdleCaches(3), 0U);
+    ASSERT_EQ(idleCache.size(), 1U);
+
+    // Reading from a cache keeps it from being idle.
+    ASSERT_EQ(usedCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+    PlanCache::clearIdleCaches(3);
+    ASSERT_EQ(idleCache.size(), 0U);
+    ASSERT_EQ(usedCache.size(), 1U);
+
+    // A cleared cache can be filled again.
+    addCacheEntryForShape(*cq, &idleCache);
+    ASSERT_EQ(idleCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+}
+
 TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     // Use a tiny cache size.
     const size_t kCacheSize = 2;
@@ -580,6 +604,25 @@ TEST(PlanCacheTest, AddActiveCacheEntry) {
     ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kNotPresent);
 }
 
+TEST(PlanCacheTest, CachedSolutionOnlyHoldsWinningPlan) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get(), qs.get()};
+
+    QueryTestServiceContext serviceContext;
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(2U), Date_t{}));
+
+    // The entry remembers every candidate, but a lookup only needs the winner.
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->plannerData.size(), 2U);
+
+    auto result = planCache.get(*cq);
+    ASSERT_EQ(result.state, PlanCache::CacheEntryState::kPresentInactive);
+    ASSERT(result.cachedSolution);
+    ASSERT_EQ(result.cachedSolution->plannerData.size(), 1U);
+}
+
 TEST(PlanCacheTest, WorksValueIncreases) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -1542,6 +1585,25 @@ TEST_F(CachePlanSelectionTest,
 }
 
 
+TEST_F(CachePlanSelectionTest, CachedPlanForSkipScanOverLeadingIndexField) {
+    bool oldEnableIndexSkipScan = internalQueryPlannerEnableIndexSkipScan.load();
+    ON_BLOCK_EXIT([oldEnableIndexSkipScan] {
+        internalQueryPlannerEnableIndexSkipScan.store(oldEnableIndexSkipScan);
+    });
+    internalQueryPlannerEnableIndexSkipScan.store(true);
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+
+    addIndex(BSON("a" << 1 << "b" << 1), "a_1_b_1");
+
+    BSONObj query = fromjson("{b: {$in: [1, 3]}}");
+    runQuery(query);
+
+    assertPlanCacheRecoversSolution(
+        query,
+        "{fetch: {filter: {b: {$in: [1, 3]}}, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[1,1,true,true],[3,3,true,true]]}}}}}");
+}
+
 TEST_F(CachePlanSelectionTest, CachedPlanForIntersectionOfMultikeyIndexesWhenUsingElemMatch) {
     params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::INDEX_INTERSECTION;
 
@@ -50,6 +50,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -347,6 +348,12 @@ void PlanExecutor::saveState() {
     // boundaries.
     WorkingSetCommon::prepareForSnapshotChange(_workingSet.get());
 
+    // Unowned BSON is not allowed to survive a yield. Only the last buffered result can still
+    // point into storage engine memory, but making an owned object owned is a no-op.
+    for (size_t i = _batchedResultsPos; i < _batchedResults.size(); ++i) {
+        _workingSet->get(_batchedResults[i])->makeObjOwnedIfNeeded();
+    }
+
     if (!isMarkedAsKilled()) {
         _root->saveState();
     }
@@ -543,7 +550,7 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         }
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        PlanStage::StageState code = workRoot(&id);
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
@@ -631,9 +638,30 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     }
 }
 
+PlanStage::StageState PlanExecutor::workRoot(WorkingSetID* out) {
+    if (_batchedResultsPos == _batchedResults.size()) {
+        _batchedResults.clear();
+        _batchedResultsPos = 0;
+
+        const int batchSize = internalQueryExecWorkBatchSize.load();
+        if (batchSize <= 1) {
+            return _root->work(out);
+        }
+
+        PlanStage::StageState code = _root->workBatch(batchSize, &_batchedResults, out);
+        if (PlanStage::ADVANCED != code) {
+            return code;
+        }
+    }
+
+    *out = _batchedResults[_batchedResultsPos++];
+    return PlanStage::ADVANCED;
+}
+
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() ||
+        (_stash.empty() && _batchedResultsPos == _batchedResults.size() && _root->isEOF());
 }
 
 void PlanExecutor::markAsKilled(Status killStatus) {
@@ -33,6 +33,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/util/partitioned.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/storage/snapshot.h"
 #include "mongo/stdx/unordered_set.h"
@@ -45,7 +46,6 @@ struct CappedInsertNotifierData;
 class Collection;
 class CursorManager;
 class PlanExecutor;
-class PlanStage;
 class PlanYieldPolicy;
 class RecordId;
 struct PlanStageStats;
@@ -498,6 +498,13 @@ private:
 
     ExecState getNextImpl(Snapshotted<BSONObj>* objOut, RecordId* dlOut);
 
+    /**
+     * Returns the next result buffered from a previous call to PlanStage::workBatch() if there is
+     * one. Otherwise works the root stage, in batches of 'internalQueryExecWorkBatchSize' if that
+     * is enabled, and returns its state as PlanStage::work() would.
+     */
+    PlanStage::StageState workRoot(WorkingSetID* out);
+
     /**
      * New PlanExecutor instances are created with the static make() methods above.
      */
@@ -572,6 +579,11 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // Results produced by a batched call to work the root stage which have not been returned yet,
+    // starting at '_batchedResultsPos'.
+    std::vector<WorkingSetID> _batchedResults;
+    size_t _batchedResultsPos = 0;
+
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
     // Set if this PlanExecutor is registered with the CursorManager.
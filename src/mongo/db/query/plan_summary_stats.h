@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <map>
+#include <set>
 #include <string>
 
 namespace mongo {
@@ -48,6 +50,9 @@ struct PlanSummaryStats {
     // The number of milliseconds spent inside the root stage's work() method.
     long long executionTimeMillis = 0;
 
+    // Estimated nanoseconds spent in each type of stage, excluding time spent in its children.
+    std::map<std::string, long long> stageExecutionTimeNanos;
+
     // Did this plan use an in-memory sort stage?
     bool hasSortStage = false;
 
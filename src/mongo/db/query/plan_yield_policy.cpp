@@ -30,13 +30,16 @@
 
 #include "mongo/db/query/plan_yield_policy.h"
 
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/explain.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_yield.h"
 #include "mongo/db/service_context.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
@@ -54,6 +57,8 @@ PlanYieldPolicy::PlanYieldPolicy(PlanExecutor* exec, PlanExecutor::YieldPolicy p
       _elapsedTracker(exec->getOpCtx()->getServiceContext()->getFastClockSource(),
                       internalQueryExecYieldIterations.load(),
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _clock(exec->getOpCtx()->getServiceContext()->getFastClockSource()),
+      _lastYieldTime(_clock->now()),
       _planYielding(exec) {}
 
 
@@ -63,6 +68,8 @@ PlanYieldPolicy::PlanYieldPolicy(PlanExecutor::YieldPolicy policy, ClockSource*
       _elapsedTracker(cs,
                       internalQueryExecYieldIterations.load(),
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _clock(cs),
+      _lastYieldTime(_clock->now()),
       _planYielding(nullptr) {}
 
 bool PlanYieldPolicy::shouldYieldOrInterrupt() {
@@ -78,11 +85,28 @@ bool PlanYieldPolicy::shouldYield() {
     invariant(!_planYielding->getOpCtx()->lockState()->inAWriteUnitOfWork());
     if (_forceYield)
         return true;
-    return _elapsedTracker.intervalHasElapsed();
+    if (!_elapsedTracker.intervalHasElapsed())
+        return false;
+    return _policy != PlanExecutor::YIELD_AUTO || yieldIsWanted();
+}
+
+bool PlanYieldPolicy::yieldIsWanted() {
+    const auto uncontendedPeriod = Milliseconds(internalQueryExecUncontendedYieldPeriodMS.load());
+    if (_clock->now() - _lastYieldTime >= uncontendedPeriod)
+        return true;
+
+    OperationContext* opCtx = _planYielding->getOpCtx();
+    if (opCtx->lockState()->hasConflictingWaiters())
+        return true;
+
+    // A plan which doesn't yield must still notice that it was killed or timed out. yield()
+    // checks for interrupt first thing.
+    return !opCtx->checkForInterruptNoAssert().isOK();
 }
 
 void PlanYieldPolicy::resetTimer() {
     _elapsedTracker.resetLastTime();
+    _lastYieldTime = _clock->now();
 }
 
 Status PlanYieldPolicy::yieldOrInterrupt(stdx::function<void()> whileYieldingFn) {
@@ -133,6 +157,15 @@ Status PlanYieldPolicy::yield(stdx::function<void()> whileYieldingFn) {
                 if (!interruptStatus.isOK()) {
                     return interruptStatus;
                 }
+
+                // Long-running plans yield periodically, which makes this a cheap point at which
+                // to let currentOp see where the plan has spent its time so far.
+                if (attempt == 1) {
+                    std::map<std::string, long long> stageTimes;
+                    Explain::getStageExecutionTimes(*_planYielding, &stageTimes);
+                    stdx::lock_guard<Client> lk(*opCtx->getClient());
+                    CurOp::get(opCtx)->setPlanStageTimes_inlock(stageTimes);
+                }
             }
 
             try {
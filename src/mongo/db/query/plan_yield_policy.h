@@ -54,6 +54,11 @@ public:
      * Periodically returns true to indicate that it is time to check for interrupt (in the case of
      * YIELD_AUTO and INTERRUPT_ONLY) or release locks or storage engine state (in the case of
      * auto-yielding plans).
+     *
+     * YIELD_AUTO plans only yield as often as internalQueryExecYieldIterations and
+     * internalQueryExecYieldPeriodMS allow when another operation waits for a lock or a ticket they
+     * hold, such as a write or a catalog change queued behind a read, or when they are
+     * interrupted. Otherwise they only yield every internalQueryExecUncontendedYieldPeriodMS.
      */
     virtual bool shouldYieldOrInterrupt();
 
@@ -139,6 +144,9 @@ private:
     bool _forceYield;
     ElapsedTracker _elapsedTracker;
 
+    ClockSource* const _clock;
+    Date_t _lastYieldTime;
+
     // The plan executor which this yield policy is responsible for yielding. Must
     // not outlive the plan executor.
     PlanExecutor* const _planYielding;
@@ -146,6 +154,9 @@ private:
     // Returns true to indicate it's time to release locks or storage engine state.
     bool shouldYield();
 
+    // Returns true if a YIELD_AUTO plan has a reason to yield now rather than keep running.
+    bool yieldIsWanted();
+
     // Releases locks or storage engine state.
     Status yield(stdx::function<void()> whileYieldingFn);
 };
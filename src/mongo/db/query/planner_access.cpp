@@ -33,6 +33,8 @@
 #include "mongo/db/query/planner_access.h"
 
 #include <algorithm>
+#include <climits>
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -49,6 +51,7 @@
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
@@ -136,6 +139,63 @@ std::vector<bool> canProvideSortWithMergeSort(
     return shouldReverseScan;
 }
 
+/**
+ * Returns true if the solution tree rooted at 'node' contains a scan over a compound $** index
+ * which does not constrain the path of the index's wildcard component.
+ */
+bool containsWildcardScanWithoutPathBounds(const QuerySolutionNode* node) {
+    if (STAGE_IXSCAN == node->getType() &&
+        wcp::isWildcardScanWithoutPathBounds(static_cast<const IndexScanNode*>(node))) {
+        return true;
+    }
+    return std::any_of(node->children.begin(), node->children.end(), [](const auto* child) {
+        return containsWildcardScanWithoutPathBounds(child);
+    });
+}
+
+/**
+ * If 'expr' compares _id to a number, intersects the inclusive range ['*minKey', '*maxKey'] with
+ * the integral _id values that can match 'expr' and returns true. Otherwise returns false.
+ */
+bool narrowClusteredIdRange(const MatchExpression* expr, long long* minKey, long long* maxKey) {
+    if (!ComparisonMatchExpression::isComparisonMatchExpression(expr) || expr->path() != "_id") {
+        return false;
+    }
+
+    const BSONElement& rhs = static_cast<const ComparisonMatchExpressionBase*>(expr)->getData();
+    if (!rhs.isNumber()) {
+        return false;
+    }
+    const bool isNaN = rhs.type() == NumberDecimal ? rhs.numberDecimal().isNaN()
+                                                   : std::isnan(rhs.numberDouble());
+    if (isNaN) {
+        return false;
+    }
+
+    const long long floorKey = clusteredid::floorOf(rhs);
+    const long long ceilKey = clusteredid::ceilOf(rhs);
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+            *minKey = std::max(*minKey, ceilKey);
+            *maxKey = std::min(*maxKey, floorKey);
+            return true;
+        case MatchExpression::GT:
+            *minKey = std::max(*minKey, floorKey == LLONG_MAX ? floorKey : floorKey + 1);
+            return true;
+        case MatchExpression::GTE:
+            *minKey = std::max(*minKey, ceilKey);
+            return true;
+        case MatchExpression::LT:
+            *maxKey = std::min(*maxKey, ceilKey == LLONG_MIN ? ceilKey : ceilKey - 1);
+            return true;
+        case MatchExpression::LTE:
+            *maxKey = std::min(*maxKey, floorKey);
+            return true;
+        default:
+            return false;
+    }
+}
+
 }  // namespace
 
 namespace mongo {
@@ -175,9 +235,49 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
         }
     }
 
+    // The records of a collection clustered on _id are stored in _id order, and only the range of
+    // records which can match the predicates on _id needs to be scanned.
+    if (params.options & QueryPlannerParams::IS_CLUSTERED_ON_ID) {
+        csn->_sort.insert(BSON("_id" << csn->direction));
+        getClusteredIdRange(query.root(), &csn->minRecord, &csn->maxRecord);
+    }
+
     return std::move(csn);
 }
 
+// static
+bool QueryPlannerAccess::getClusteredIdRange(const MatchExpression* root,
+                                             RecordId* minRecord,
+                                             RecordId* maxRecord) {
+    const long long maxNormalKey = RecordId::kMinReservedRepr - 1;
+    long long minKey = 1;
+    long long maxKey = maxNormalKey;
+    bool bounded = false;
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            bounded = narrowClusteredIdRange(root->getChild(i), &minKey, &maxKey) || bounded;
+        }
+    } else {
+        bounded = narrowClusteredIdRange(root, &minKey, &maxKey);
+    }
+
+    if (!bounded) {
+        return false;
+    }
+
+    // Keep both ends of the range normal RecordIds, so that neither is mistaken for an unbounded
+    // end.
+    minKey = std::max(minKey, 1LL);
+    maxKey = std::min(maxKey, maxNormalKey);
+    if (minKey > maxKey) {
+        minKey = 2;
+        maxKey = 1;
+    }
+    *minRecord = RecordId(minKey);
+    *maxRecord = RecordId(maxKey);
+    return true;
+}
+
 std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeLeafNode(
     const CanonicalQuery& query,
     const IndexEntry& index,
@@ -1167,7 +1267,14 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::buildIndexedDataAccess(
     const vector<IndexEntry>& indices,
     const QueryPlannerParams& params) {
     MatchExpression* unownedRoot = root.get();
-    return _buildIndexedDataAccess(query, unownedRoot, std::move(root), indices, params);
+    auto soln = _buildIndexedDataAccess(query, unownedRoot, std::move(root), indices, params);
+
+    // Scans over a compound $** index which are bounded only by its regular fields would miss
+    // documents which are absent from the index, so we reject any solution which contains one.
+    if (soln && containsWildcardScanWithoutPathBounds(soln.get())) {
+        return nullptr;
+    }
+    return soln;
 }
 
 std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::_buildIndexedDataAccess(
@@ -1291,6 +1398,81 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanWholeIndex(
     return solnRoot;
 }
 
+// static
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanIndexSkippingLeadingField(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    if (index.keyPattern.nFields() < 2) {
+        return nullptr;
+    }
+
+    BSONObjIterator kpIt(index.keyPattern);
+    kpIt.next();
+    const BSONElement secondElt = kpIt.next();
+
+    // Only plain comparisons are used to build bounds. Anything else is left to the filter.
+    auto isSkipScanPredicate = [&](const MatchExpression* node) {
+        switch (node->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+            case MatchExpression::MATCH_IN:
+                return node->path() == secondElt.fieldNameStringData();
+            default:
+                return false;
+        }
+    };
+
+    std::vector<const MatchExpression*> preds;
+    const MatchExpression* root = query.root();
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            if (isSkipScanPredicate(root->getChild(i))) {
+                preds.push_back(root->getChild(i));
+            }
+        }
+    } else if (isSkipScanPredicate(root)) {
+        preds.push_back(root);
+    }
+
+    if (preds.empty()) {
+        return nullptr;
+    }
+
+    // Bounds over a multikey field cannot be intersected, so use just one predicate for them.
+    if (index.multikey) {
+        preds.resize(1);
+    }
+
+    auto isn = make_unique<IndexScanNode>(index);
+    isn->addKeyMetadata = query.getQueryRequest().returnKey();
+    isn->queryCollator = query.getCollator();
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(preds[0], secondElt, index, &isn->bounds.fields[1], &tightness);
+    for (size_t i = 1; i < preds.size(); ++i) {
+        IndexBoundsBuilder::translateAndIntersect(
+            preds[i], secondElt, index, &isn->bounds.fields[1], &tightness);
+    }
+
+    size_t pos = 0;
+    for (auto&& kpElt : index.keyPattern) {
+        if (1 != pos) {
+            IndexBoundsBuilder::allValuesForField(kpElt, &isn->bounds.fields[pos]);
+        }
+        ++pos;
+    }
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds are only used to skip over index keys, and the fetch applies the whole filter.
+    unique_ptr<FetchNode> fetch = make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return std::move(fetch);
+}
+
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
                                                  MatchExpression::MatchType type) {
@@ -101,6 +101,17 @@ public:
                                                                  bool tailable,
                                                                  const QueryPlannerParams& params);
 
+    /**
+     * For a collection clustered on _id, computes the inclusive range ['*minRecord', '*maxRecord']
+     * of RecordIds which can hold documents matching 'root', from the comparisons of _id to
+     * numbers at the top level of 'root'. The range is empty if '*minRecord' is greater than
+     * '*maxRecord'. Returns false, leaving the arguments unchanged, if there are no such
+     * comparisons.
+     */
+    static bool getClusteredIdRange(const MatchExpression* root,
+                                    RecordId* minRecord,
+                                    RecordId* maxRecord);
+
     /**
      * Return a plan that uses the provided index as a proxy for a collection scan.
      */
@@ -109,6 +120,16 @@ public:
                                                              const QueryPlannerParams& params,
                                                              int direction = 1);
 
+    /**
+     * Return a plan that scans the provided compound index using bounds built from the query's
+     * top-level predicates over the index's second field, and all values for every other field.
+     * The index scan stage seeks from one value of the leading field to the next whenever it
+     * passes the bounds on the second field, so this skips over the parts of the index that cannot
+     * match. Returns null if there are no such predicates.
+     */
+    static std::unique_ptr<QuerySolutionNode> scanIndexSkippingLeadingField(
+        const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -609,6 +609,16 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // If we sort the output of a TEXT stage by text score alone and keep only the first
+    // 'sort->limit' results, the TEXT stage only needs to produce its highest scoring documents,
+    // which allows it to stop scanning the text index early. No stage may sit in between which
+    // could filter out some of those documents.
+    QuerySolutionNode* sortInput = keyGenNode->children[0];
+    if (sort->limit > 0 && STAGE_TEXT == sortInput->getType() && sortObj.nFields() == 1 &&
+        QueryRequest::isTextScoreMeta(sortObj.firstElement())) {
+        static_cast<TextNode*>(sortInput)->topK = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
@@ -755,9 +765,11 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
             }
         }
         // If we don't have a covered project, and we're not allowed to put an uncovered one in,
-        // bail out.
+        // bail out. A scan of a columnstore index reads only the fields the query needs, so it is
+        // as good as covered.
         if (solnRoot->fetched() &&
-            (params.options & QueryPlannerParams::NO_UNCOVERED_PROJECTIONS)) {
+            (params.options & QueryPlannerParams::NO_UNCOVERED_PROJECTIONS) &&
+            !hasNode(solnRoot.get(), STAGE_COLUMN_SCAN)) {
             return nullptr;
         }
 
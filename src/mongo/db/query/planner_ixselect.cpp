@@ -449,7 +449,8 @@ bool QueryPlannerIXSelect::_compatible(const BSONElement& keyPatternElt,
             }
         }
 
-        if (index.type == IndexType::INDEX_WILDCARD && !nodeIsSupportedByWildcardIndex(node)) {
+        if (index.type == IndexType::INDEX_WILDCARD && keyPatternIdx == index.wildcardFieldPos &&
+            !nodeIsSupportedByWildcardIndex(node)) {
             return false;
         }
 
@@ -893,6 +894,67 @@ void QueryPlannerIXSelect::stripInvalidAssignmentsToPartialIndices(
 //
 // Wildcard index invalid assignments.
 //
+
+/**
+ * Traverse the subtree rooted at 'node' to remove RelevantTag assignments to the expanded compound
+ * $** index 'idx' from predicates which are not AND-related to an assigned predicate on
+ * 'wildcardPath', the query path standing in for the index's wildcard component.
+ */
+static void stripInvalidAssignmentsToCompoundWildcardIndex(MatchExpression* node,
+                                                           size_t idx,
+                                                           StringData wildcardPath) {
+    if (Indexability::isBoundsGenerating(node)) {
+        // A predicate on its own can only use the index if it is on the wildcard path. The tag of a
+        // bounds-generating NOT is cloned onto its child, so both must be stripped.
+        auto* tag = static_cast<RelevantTag*>(node->getTag());
+        if (tag && tag->path != wildcardPath) {
+            removeIndexRelevantTag(node, idx);
+            if (MatchExpression::NOT == node->matchType()) {
+                removeIndexRelevantTag(node->getChild(0), idx);
+            }
+        }
+        return;
+    }
+
+    const MatchExpression::MatchType nodeType = node->matchType();
+
+    // Don't bother peeking inside of other negations.
+    if (MatchExpression::NOT == nodeType || MatchExpression::NOR == nodeType) {
+        return;
+    }
+
+    if (MatchExpression::AND != nodeType) {
+        // It's an OR or some kind of array operator.
+        for (size_t i = 0; i < node->numChildren(); ++i) {
+            stripInvalidAssignmentsToCompoundWildcardIndex(node->getChild(i), idx, wildcardPath);
+        }
+        return;
+    }
+
+    std::vector<MatchExpression*> andRelated;
+    std::vector<MatchExpression*> other;
+    partitionAndRelatedPreds(node, &andRelated, &other);
+
+    for (auto child : other) {
+        stripInvalidAssignmentsToCompoundWildcardIndex(child, idx, wildcardPath);
+    }
+
+    // The predicates on the regular fields may only use the index alongside a predicate on the
+    // wildcard path, since documents without any indexed wildcard paths are absent from the index.
+    const bool hasWildcardPathPred =
+        std::any_of(andRelated.begin(), andRelated.end(), [&](MatchExpression* child) {
+            auto* tag = static_cast<RelevantTag*>(child->getTag());
+            return tag && tag->path == wildcardPath &&
+                (std::count(tag->first.begin(), tag->first.end(), idx) ||
+                 std::count(tag->notFirst.begin(), tag->notFirst.end(), idx));
+        });
+    if (!hasWildcardPathPred) {
+        for (auto child : andRelated) {
+            stripInvalidAssignmentsToCompoundWildcardIndex(child, idx, wildcardPath);
+        }
+    }
+}
+
 void QueryPlannerIXSelect::stripInvalidAssignmentsToWildcardIndexes(
     MatchExpression* root, const vector<IndexEntry>& indices) {
     for (size_t idx = 0; idx < indices.size(); ++idx) {
@@ -915,6 +977,15 @@ void QueryPlannerIXSelect::stripInvalidAssignmentsToWildcardIndexes(
         if (auto* textNode = findTextNode(root)) {
             removeIndexRelevantTag(textNode, idx);
         }
+
+        // A compound $** index only contains documents with at least one indexed wildcard path,
+        // so it cannot be used for predicates on its regular fields alone.
+        if (indices[idx].keyPattern.nFields() > 1) {
+            stripInvalidAssignmentsToCompoundWildcardIndex(
+                root,
+                idx,
+                wcp::getWildcardKeyPatternElement(indices[idx]).fieldNameStringData());
+        }
     }
 }
 
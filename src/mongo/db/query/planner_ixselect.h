@@ -244,6 +244,10 @@ private:
      * Specifically, if the query has a TEXT node with both 'text' and 'wildcard' indexes present,
      * then the 'wildcard' index will mark itself as relevant to the '_fts' path reported by the
      * TEXT node. We therefore remove any such misassigned 'wildcard' tags here.
+     *
+     * Additionally, a compound 'wildcard' index only contains documents which have at least one
+     * path indexed by its wildcard component. Assignments of predicates on its regular fields are
+     * therefore removed unless they are AND-related to a predicate on the expanded query path.
      */
     static void stripInvalidAssignmentsToWildcardIndexes(MatchExpression* root,
                                                          const std::vector<IndexEntry>& indices);
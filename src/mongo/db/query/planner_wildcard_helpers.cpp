@@ -294,9 +294,11 @@ void expandWildcardIndexEntry(const IndexEntry& wildcardIndex,
                               std::vector<IndexEntry>* out) {
     invariant(out);
     invariant(wildcardIndex.type == INDEX_WILDCARD);
-    // Should only have one field of the form {"path.$**" : 1}.
-    invariant(wildcardIndex.keyPattern.nFields() == 1);
-    invariant(wildcardIndex.keyPattern.firstElement().fieldNameStringData().endsWith("$**"));
+    // Should have exactly one field of the form {"path.$**" : 1}, which may be compounded with
+    // regular fields.
+    const auto wildcardFieldPos =
+        WildcardKeyGenerator::getWildcardFieldPos(wildcardIndex.keyPattern);
+    const auto numFields = static_cast<size_t>(wildcardIndex.keyPattern.nFields());
 
     // $** indexes do not keep the multikey metadata inside the index catalog entry, as the amount
     // of metadata is not bounded. We do not expect IndexEntry objects for $** indexes to have a
@@ -337,10 +339,24 @@ void expandWildcardIndexEntry(const IndexEntry& wildcardIndex,
         invariant(multikeyPaths.size() == 1u);
         const bool isMultikey = !multikeyPaths[0].empty();
 
-        IndexEntry entry(BSON(fieldName << wildcardIndex.keyPattern.firstElement()),
+        // The query path takes the place of the wildcard component in the expanded key pattern.
+        // The regular fields of a compound $** index can never be multikey, since arrays are not
+        // permitted in them.
+        BSONObjBuilder keyPatternBob;
+        for (auto&& keyPatternElem : wildcardIndex.keyPattern) {
+            if (WildcardKeyGenerator::isWildcardFieldName(keyPatternElem.fieldNameStringData())) {
+                keyPatternBob.appendAs(keyPatternElem, fieldName);
+            } else {
+                keyPatternBob.append(keyPatternElem);
+            }
+        }
+        MultikeyPaths expandedMultikeyPaths(numFields);
+        expandedMultikeyPaths[wildcardFieldPos] = std::move(multikeyPaths[0]);
+
+        IndexEntry entry(keyPatternBob.obj(),
                          IndexType::INDEX_WILDCARD,
                          isMultikey,
-                         std::move(multikeyPaths),
+                         std::move(expandedMultikeyPaths),
                          // Expanded index entries always use the fixed-size multikey paths
                          // representation, so we purposefully discard 'multikeyPathSet'.
                          {},
@@ -351,6 +367,8 @@ void expandWildcardIndexEntry(const IndexEntry& wildcardIndex,
                          wildcardIndex.infoObj,
                          wildcardIndex.collator);
 
+        entry.wildcardFieldPos = wildcardFieldPos;
+
         invariant("$_path"_sd != fieldName);
         out->push_back(std::move(entry));
     }
@@ -361,11 +379,11 @@ BoundsTightness translateWildcardIndexBoundsAndTightness(const IndexEntry& index
                                                          OrderedIntervalList* oil) {
     // This method should only ever be called for a $** IndexEntry. We expect to be called during
     // planning, *before* finishWildcardIndexScanNode has been invoked. The IndexEntry should thus
-    // only have a single keyPattern field and multikeyPath entry, but this is sufficient to
-    // determine whether it will be necessary to adjust the tightness.
+    // have a single keyPattern field and multikeyPath entry for the query path, alongside those of
+    // any regular fields, but this is sufficient to determine whether it will be necessary to
+    // adjust the tightness.
     invariant(index.type == IndexType::INDEX_WILDCARD);
-    invariant(index.keyPattern.nFields() == 1);
-    invariant(index.multikeyPaths.size() == 1);
+    invariant(index.multikeyPaths.size() == static_cast<size_t>(index.keyPattern.nFields()));
     invariant(oil);
 
     // If our bounds include any objects -- anything in the range ({}, []) -- then we will need to
@@ -382,8 +400,9 @@ BoundsTightness translateWildcardIndexBoundsAndTightness(const IndexEntry& index
     }
 
     // If the query passes through any array indices, we must always fetch and filter the documents.
-    const auto arrayIndicesTraversedByQuery = findArrayIndexPathComponents(
-        index.multikeyPaths.front(), FieldRef{index.keyPattern.firstElementFieldName()});
+    const auto arrayIndicesTraversedByQuery =
+        findArrayIndexPathComponents(index.multikeyPaths[index.wildcardFieldPos],
+                                     FieldRef{getWildcardKeyPatternElement(index).fieldName()});
 
     // If the list of array indices we traversed is non-empty, set the tightness to INEXACT_FETCH.
     return (arrayIndicesTraversedByQuery.empty() ? tightnessIn : BoundsTightness::INEXACT_FETCH);
@@ -392,29 +411,54 @@ BoundsTightness translateWildcardIndexBoundsAndTightness(const IndexEntry& index
 void finalizeWildcardIndexScanConfiguration(IndexEntry* index, IndexBounds* bounds) {
     // We should only ever reach this point when processing a $** index. Sanity check the arguments.
     invariant(index && index->type == IndexType::INDEX_WILDCARD);
-    invariant(index->keyPattern.nFields() == 1);
-    invariant(index->multikeyPaths.size() == 1);
-    invariant(bounds && bounds->fields.size() == 1);
-    invariant(bounds->fields.front().name == index->keyPattern.firstElementFieldName());
+    const auto numFields = static_cast<size_t>(index->keyPattern.nFields());
+    const auto wildcardFieldPos = index->wildcardFieldPos;
+    invariant(wildcardFieldPos < numFields);
+    invariant(index->multikeyPaths.size() == numFields);
+    invariant(bounds && bounds->fields.size() == numFields);
+
+    // Create a FieldRef to perform any necessary manipulations on the query path string. The bounds
+    // on the query path are only left unassigned if this is a compound $** index and the query was
+    // planned using predicates on its regular fields alone.
+    FieldRef queryPath{getWildcardKeyPatternElement(*index).fieldNameStringData()};
+    const bool hasQueryPathBounds = !bounds->fields[wildcardFieldPos].name.empty();
+    invariant(hasQueryPathBounds || numFields > 1);
+    invariant(!hasQueryPathBounds ||
+              bounds->fields[wildcardFieldPos].name == queryPath.dottedField());
 
     // For $** indexes, the IndexEntry key pattern is {'path.to.field': ±1} but the actual keys in
     // the index are of the form {'$_path': ±1, 'path.to.field': ±1}, where the value of the first
     // field in each key is 'path.to.field'. We push a new entry into the bounds vector for the
-    // leading '$_path' bound here. We also push corresponding fields into the IndexScanNode's
-    // keyPattern and its multikeyPaths vector.
-    index->multikeyPaths.insert(index->multikeyPaths.begin(), std::set<std::size_t>{});
-    bounds->fields.insert(bounds->fields.begin(), {"$_path"});
-    index->keyPattern =
-        BSON("$_path" << index->keyPattern.firstElement() << index->keyPattern.firstElement());
+    // '$_path' bound here, immediately preceding the query path; for a compound $** index, this
+    // may follow one or more regular fields. We also push corresponding fields into the
+    // IndexScanNode's keyPattern and its multikeyPaths vector.
+    index->multikeyPaths.insert(index->multikeyPaths.begin() + wildcardFieldPos,
+                                std::set<std::size_t>{});
+    bounds->fields.insert(bounds->fields.begin() + wildcardFieldPos, {"$_path"});
+    BSONObjBuilder keyPatternBob;
+    size_t keyPatternPos = 0;
+    for (auto&& keyPatternElem : index->keyPattern) {
+        if (keyPatternPos++ == wildcardFieldPos) {
+            keyPatternBob.appendAs(keyPatternElem, "$_path");
+        }
+        keyPatternBob.append(keyPatternElem);
+    }
+    index->keyPattern = keyPatternBob.obj();
+
+    // Without bounds on the query path, the scan must cover every path in the index. Such a scan
+    // is never used to answer a query; see isWildcardScanWithoutPathBounds().
+    if (!hasQueryPathBounds) {
+        bounds->fields[wildcardFieldPos].intervals.push_back(IndexBoundsBuilder::allValues());
+        return;
+    }
 
-    // Create a FieldRef to perform any necessary manipulations on the query path string.
-    FieldRef queryPath{std::next(index->keyPattern.begin())->fieldNameStringData()};
-    auto& multikeyPaths = index->multikeyPaths.back();
+    auto& multikeyPaths = index->multikeyPaths[wildcardFieldPos + 1];
 
     // If the bounds overlap the object type bracket, then we must retrieve all documents which
     // include the given path. We must therefore add bounds that encompass all its subpaths,
     // specifically the interval ["path.","path/") on "$_path".
-    const bool requiresSubpathBounds = boundsOverlapObjectTypeBracket(bounds->fields.back());
+    const bool requiresSubpathBounds =
+        boundsOverlapObjectTypeBracket(bounds->fields[wildcardFieldPos + 1]);
 
     // Helper function to check whether the final path component in 'queryPath' is an array index.
     const auto lastFieldIsArrayIndex = [&multikeyPaths](const auto& queryPath) {
@@ -441,7 +485,7 @@ void finalizeWildcardIndexScanConfiguration(IndexEntry* index, IndexBounds* boun
     // Add a $_path point-interval for each path that needs to be traversed in the index. If subpath
     // bounds are required, then we must add a further range interval on ["path.","path/").
     static const char subPathStart = '.', subPathEnd = static_cast<char>('.' + 1);
-    auto& pathIntervals = bounds->fields.front().intervals;
+    auto& pathIntervals = bounds->fields[wildcardFieldPos].intervals;
     for (const auto& fieldPath : paths) {
         auto path = fieldPath.dottedField().toString();
         pathIntervals.push_back(IndexBoundsBuilder::makePointInterval(path));
@@ -461,15 +505,37 @@ bool isWildcardObjectSubpathScan(const IndexScanNode* node) {
     }
 
     // We expect consistent arguments, representing a $** index which has already been finalized.
-    invariant(node->index.keyPattern.nFields() == 2);
-    invariant(node->index.multikeyPaths.size() == 2);
-    invariant(node->bounds.fields.size() == 2);
-    invariant(node->bounds.fields.front().name == node->index.keyPattern.firstElementFieldName());
-    invariant(node->bounds.fields.back().name ==
-              std::next(node->index.keyPattern.begin())->fieldName());
+    const auto wildcardFieldPos = node->index.wildcardFieldPos;
+    const auto numFields = static_cast<size_t>(node->index.keyPattern.nFields());
+    invariant(wildcardFieldPos + 1 < numFields);
+    invariant(node->index.multikeyPaths.size() == numFields);
+    invariant(node->bounds.fields.size() == numFields);
+    invariant(node->bounds.fields[wildcardFieldPos].name == "$_path");
 
     // Check the bounds on the query field for any intersections with the object type bracket.
-    return boundsOverlapObjectTypeBracket(node->bounds.fields.back());
+    return boundsOverlapObjectTypeBracket(node->bounds.fields[wildcardFieldPos + 1]);
+}
+
+bool isWildcardScanWithoutPathBounds(const IndexScanNode* node) {
+    if (!node || node->index.type != IndexType::INDEX_WILDCARD) {
+        return false;
+    }
+
+    // A finalized $** scan always has point or subpath intervals on '$_path', unless the query
+    // path was left without bounds.
+    const auto& pathBounds = node->bounds.fields[node->index.wildcardFieldPos];
+    invariant(pathBounds.name == "$_path");
+    return pathBounds.intervals.size() == 1u && pathBounds.intervals.front().isMinToMax();
+}
+
+BSONElement getWildcardKeyPatternElement(const IndexEntry& index) {
+    BSONObjIterator it(index.keyPattern);
+    for (size_t i = 0; i < index.wildcardFieldPos; ++i) {
+        invariant(it.more());
+        it.next();
+    }
+    invariant(it.more());
+    return it.next();
 }
 
 }  // namespace wildcard_planning
@@ -68,9 +68,11 @@ BoundsTightness translateWildcardIndexBoundsAndTightness(const IndexEntry& index
 
 /**
  * During planning, the expanded $** IndexEntry's keyPattern and bounds are in the single-field
- * format {'path': 1}. Once planning is complete, it is necessary to call this method in order to
- * prepare the IndexEntry and bounds for execution. This function performs the following actions:
- * - Converts the keyPattern to the {$_path: 1, "path": 1} format expected by the $** index.
+ * format {'path': 1}, or {a: 1, 'path': 1, b: 1} for a compound $** index with regular fields 'a'
+ * and 'b'. Once planning is complete, it is necessary to call this method in order to prepare the
+ * IndexEntry and bounds for execution. This function performs the following actions:
+ * - Converts the keyPattern to the {$_path: 1, "path": 1} format expected by the $** index, with
+ *   '$_path' inserted at the IndexEntry's 'wildcardFieldPos'.
  * - Adds a new entry '$_path' to the bounds vector, and computes the necessary intervals on it.
  * - Adds a new, empty entry to 'multikeyPaths' for '$_path'.
  */
@@ -83,6 +85,20 @@ void finalizeWildcardIndexScanConfiguration(IndexEntry* index, IndexBounds* boun
  */
 bool isWildcardObjectSubpathScan(const IndexScanNode* node);
 
+/**
+ * Returns true if the given IndexScanNode is a scan over a compound $** index whose bounds do not
+ * constrain the path of its wildcard component. A document is only present in a $** index if the
+ * wildcard component indexes at least one of its paths, so such a scan may miss documents which
+ * match the predicates on the regular fields, and must not be used to answer the query.
+ */
+bool isWildcardScanWithoutPathBounds(const IndexScanNode* node);
+
+/**
+ * Returns the element of an expanded $** IndexEntry's key pattern which stands in for the index's
+ * wildcard component. For a compound $** index, all of the other elements are regular fields.
+ */
+BSONElement getWildcardKeyPatternElement(const IndexEntry& index);
+
 /**
  * Return true if the intervals on the 'value' field will include subobjects, and
  * thus require the bounds on $_path to include ["path.", "path/").
@@ -0,0 +1,346 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/projection_exec.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.query_bm");
+
+//
+// Planning.
+//
+
+/**
+ * A conjunction of 'numPredicates' range predicates over the fields f0, f1, ...
+ */
+BSONObj makeFilter(int numPredicates) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numPredicates; ++i) {
+        bob.append("f" + std::to_string(i), BSON("$gt" << i));
+    }
+    return bob.obj();
+}
+
+/**
+ * Single-field indexes over the fields f0, f1, ... Only the indexes over the first
+ * 'numPredicates' fields are relevant to the filter; the rest must still be considered and
+ * rejected by the planner.
+ */
+QueryPlannerParams makePlannerParams(int numIndexes) {
+    QueryPlannerParams params;
+    params.options = QueryPlannerParams::INCLUDE_COLLSCAN;
+    for (int i = 0; i < numIndexes; ++i) {
+        const std::string field = "f" + std::to_string(i);
+        params.indices.push_back(IndexEntry(BSON(field << 1),
+                                            false,  // multikey
+                                            false,  // sparse
+                                            false,  // unique
+                                            IndexEntry::Identifier{field + "_1"},
+                                            nullptr,  // filterExpr
+                                            BSONObj()));
+    }
+    return params;
+}
+
+std::unique_ptr<CanonicalQuery> canonicalize(OperationContext* opCtx, const BSONObj& filter) {
+    auto qr = stdx::make_unique<QueryRequest>(kNss);
+    qr->setFilter(filter);
+    qr->setSort(BSON("f0" << 1));
+    return uassertStatusOK(CanonicalQuery::canonicalize(opCtx, std::move(qr)));
+}
+
+/**
+ * Registers the planning benchmarks over (number of indexes, number of predicates) pairs.
+ */
+void planningArgs(benchmark::internal::Benchmark* b) {
+    for (int numIndexes : {1, 4, 16, 64}) {
+        for (int numPredicates : {1, 4, 8}) {
+            b->Args({numIndexes, numPredicates});
+        }
+    }
+}
+
+void BM_canonicalize(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const BSONObj filter = makeFilter(state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(canonicalize(opCtx.get(), filter));
+    }
+}
+
+void BM_plan(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto params = makePlannerParams(state.range(0));
+    const auto cq = canonicalize(opCtx.get(), makeFilter(state.range(1)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(uassertStatusOK(QueryPlanner::plan(*cq, params)));
+    }
+}
+
+void BM_planCacheGet(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto params = makePlannerParams(state.range(0));
+    const auto cq = canonicalize(opCtx.get(), makeFilter(state.range(1)));
+
+    PlanCache planCache;
+    planCache.notifyOfIndexEntries(params.indices);
+    auto solutions = uassertStatusOK(QueryPlanner::plan(*cq, params));
+    std::vector<QuerySolution*> rawSolutions;
+    auto decision = stdx::make_unique<PlanRankingDecision>();
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        rawSolutions.push_back(solutions[i].get());
+        CommonStats common("COLLSCAN");
+        auto stats = stdx::make_unique<PlanStageStats>(common, STAGE_COLLSCAN);
+        stats->specific.reset(new CollectionScanStats());
+        decision->stats.push_back(std::move(stats));
+        decision->scores.push_back(0U);
+        decision->candidateOrder.push_back(i);
+    }
+    uassertStatusOK(planCache.set(*cq, rawSolutions, std::move(decision), Date_t{}));
+
+    for (auto _ : state) {
+        auto result = planCache.get(*cq);
+        invariant(result.cachedSolution);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK(BM_canonicalize)->Apply(planningArgs);
+BENCHMARK(BM_plan)->Apply(planningArgs);
+BENCHMARK(BM_planCacheGet)->Apply(planningArgs);
+
+//
+// Projection.
+//
+
+/**
+ * A document with an _id and the fields f0, f1, ... of which there are 'numFields', each holding
+ * a small subdocument.
+ */
+BSONObj makeWideDocument(int numFields) {
+    BSONObjBuilder bob;
+    bob.append("_id", 0);
+    for (int i = 0; i < numFields; ++i) {
+        bob.append("f" + std::to_string(i), BSON("x" << i << "y" << i));
+    }
+    return bob.obj();
+}
+
+/**
+ * Applies 'spec' to a document with state.range(0) fields on each iteration.
+ */
+void BM_projection(benchmark::State& state, BSONObj spec) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const BSONObj doc = makeWideDocument(state.range(0));
+    ProjectionExec projExec(opCtx.get(), spec, nullptr, nullptr);
+
+    WorkingSet ws;
+    WorkingSetMember* member = ws.get(ws.allocate());
+    for (auto _ : state) {
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), doc);
+        member->transitionToOwnedObj();
+        invariant(projExec.transform(member).isOK());
+        benchmark::DoNotOptimize(member->obj.value());
+    }
+}
+
+BENCHMARK_CAPTURE(BM_projection, inclusion, BSON("f1" << 1 << "f7" << 1))->Arg(10)->Arg(100);
+BENCHMARK_CAPTURE(BM_projection, exclusion, BSON("f1" << 0 << "f7" << 0))->Arg(10)->Arg(100);
+BENCHMARK_CAPTURE(BM_projection, dotted, BSON("f1.x" << 1 << "f7.y" << 1))->Arg(10)->Arg(100);
+
+//
+// Execution stages over the ephemeralForTest storage engine.
+//
+
+/**
+ * Sets up a mongod storage engine and a collection of 'numDocs' documents of the form
+ * {_id: i, a: i, b: i % 100, s: <string>} with an index on {a: 1}.
+ */
+class StageBenchmarkFixture : public ServiceContextMongoDTest {
+public:
+    explicit StageBenchmarkFixture(int numDocs) {
+        auto service = getServiceContext();
+        auto replCoord = stdx::make_unique<repl::ReplicationCoordinatorMock>(service);
+        uassertStatusOK(replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+        _opCtx = makeOperationContext();
+
+        CollectionOptions options;
+        options.uuid = UUID::gen();
+        const BSONObj idIndexSpec = BSON("ns" << kNss.ns() << "name"
+                                              << "_id_"
+                                              << "key"
+                                              << BSON("_id" << 1)
+                                              << "unique"
+                                              << true
+                                              << "v"
+                                              << 2);
+        const BSONObj aIndexSpec = BSON("ns" << kNss.ns() << "name"
+                                             << "a_1"
+                                             << "key"
+                                             << BSON("a" << 1)
+                                             << "v"
+                                             << 2);
+        repl::StorageInterfaceImpl storage;
+        auto loader = uassertStatusOK(
+            storage.createCollectionForBulkLoading(kNss, options, idIndexSpec, {aIndexSpec}));
+        std::vector<BSONObj> docs;
+        for (int i = 0; i < numDocs; ++i) {
+            docs.push_back(BSON("_id" << i << "a" << i << "b" << i % 100 << "s"
+                                      << "some string value"));
+        }
+        uassertStatusOK(loader->insertDocuments(docs.begin(), docs.end()));
+        uassertStatusOK(loader->commit());
+    }
+
+    OperationContext* getOperationContext() const {
+        return _opCtx.get();
+    }
+
+private:
+    void _doTest() override {}
+
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+/**
+ * Works 'root' to EOF on each iteration of 'state', as built by 'makeRoot' over a fresh working
+ * set, and reports per-document throughput over 'numDocs' input documents.
+ */
+void runStage(benchmark::State& state,
+              int numDocs,
+              const stdx::function<std::unique_ptr<PlanStage>(WorkingSet*)>& makeRoot) {
+    for (auto _ : state) {
+        WorkingSet ws;
+        auto root = makeRoot(&ws);
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState stageState = PlanStage::NEED_TIME;
+        while (stageState != PlanStage::IS_EOF) {
+            stageState = root->work(&id);
+            invariant(stageState != PlanStage::FAILURE && stageState != PlanStage::DEAD);
+            if (stageState == PlanStage::ADVANCED) {
+                benchmark::DoNotOptimize(ws.get(id));
+                ws.free(id);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numDocs);
+}
+
+std::unique_ptr<MatchExpression> parseFilter(OperationContext* opCtx, const BSONObj& filter) {
+    boost::intrusive_ptr<ExpressionContext> expCtx(new ExpressionContext(opCtx, nullptr));
+    return uassertStatusOK(MatchExpressionParser::parse(filter, expCtx));
+}
+
+std::unique_ptr<PlanStage> makeIndexScan(OperationContext* opCtx,
+                                         const Collection* collection,
+                                         WorkingSet* ws) {
+    auto descriptor = collection->getIndexCatalog()->findIndexByName(opCtx, "a_1");
+    invariant(descriptor);
+    IndexScanParams params(opCtx, *descriptor);
+    params.bounds.isSimpleRange = true;
+    params.bounds.startKey = BSON("" << MINKEY);
+    params.bounds.endKey = BSON("" << MAXKEY);
+    params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+    return stdx::make_unique<IndexScan>(opCtx, std::move(params), ws, nullptr);
+}
+
+// The 'b < 50' filter passes half of the documents.
+const BSONObj kHalfFilter = BSON("b" << BSON("$lt" << 50));
+
+void BM_collectionScan(benchmark::State& state, bool withFilter) {
+    StageBenchmarkFixture fixture(state.range(0));
+    auto opCtx = fixture.getOperationContext();
+    AutoGetCollectionForRead autoColl(opCtx, kNss);
+    auto filter = withFilter ? parseFilter(opCtx, kHalfFilter) : nullptr;
+    CollectionScanParams params;
+    params.collection = autoColl.getCollection();
+    runStage(state, state.range(0), [&](WorkingSet* ws) {
+        return stdx::make_unique<CollectionScan>(opCtx, params, ws, filter.get());
+    });
+}
+
+void BM_indexScan(benchmark::State& state) {
+    StageBenchmarkFixture fixture(state.range(0));
+    auto opCtx = fixture.getOperationContext();
+    AutoGetCollectionForRead autoColl(opCtx, kNss);
+    runStage(state, state.range(0), [&](WorkingSet* ws) {
+        return makeIndexScan(opCtx, autoColl.getCollection(), ws);
+    });
+}
+
+void BM_indexScanFetch(benchmark::State& state, bool withFilter) {
+    StageBenchmarkFixture fixture(state.range(0));
+    auto opCtx = fixture.getOperationContext();
+    AutoGetCollectionForRead autoColl(opCtx, kNss);
+    auto filter = withFilter ? parseFilter(opCtx, kHalfFilter) : nullptr;
+    runStage(state, state.range(0), [&](WorkingSet* ws) {
+        return stdx::make_unique<FetchStage>(
+            opCtx,
+            ws,
+            makeIndexScan(opCtx, autoColl.getCollection(), ws).release(),
+            filter.get(),
+            autoColl.getCollection());
+    });
+}
+
+BENCHMARK_CAPTURE(BM_collectionScan, noFilter, false)->Arg(1000)->Arg(10000);
+BENCHMARK_CAPTURE(BM_collectionScan, filter, true)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_indexScan)->Arg(1000)->Arg(10000);
+BENCHMARK_CAPTURE(BM_indexScanFetch, noFilter, false)->Arg(1000)->Arg(10000);
+BENCHMARK_CAPTURE(BM_indexScanFetch, filter, true)->Arg(1000)->Arg(10000);
+
+}  // namespace
+}  // namespace mongo
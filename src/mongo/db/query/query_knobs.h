@@ -48,6 +48,10 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// When greater than 1, each candidate plan is given up to this many units of work at a time via
+// PlanStage::workBatch() during plan evaluation, rather than one work() call per round.
+extern AtomicInt32 internalQueryPlanEvaluationWorkBatchSize;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -57,6 +61,15 @@ extern AtomicBool internalQueryPlannerEnableIndexIntersection;
 // Do we use hash-based intersection for rooted $and queries?
 extern AtomicBool internalQueryPlannerEnableHashIntersection;
 
+// Do we consider scanning a compound index whose leading field the query does not constrain,
+// seeking past each leading value using the bounds on the second field?
+extern AtomicBool internalQueryPlannerEnableIndexSkipScan;
+
+// Candidate plans are ordered by how many keys the histograms gathered by the analyze command
+// estimate their index scans read. Those estimated to read more than this many times as many keys
+// as the best candidate are not evaluated at all. A value of 0 only orders the candidates.
+extern AtomicDouble internalQueryPlannerHistogramPruneFactor;
+
 //
 // plan cache
 //
@@ -82,6 +95,10 @@ extern AtomicBool internalQueryCacheDisableInactiveEntries;
 // Whether or not planCacheListPlans uses the new output format.
 extern AtomicBool internalQueryCacheListPlansNewOutput;
 
+// How many seconds a collection's plan cache may go unused before its entries are removed, freeing
+// their memory. Zero disables the removal of idle entries.
+extern AtomicInt32 internalQueryCacheClearIdleAfterSecs;
+
 //
 // Planning and enumeration.
 //
@@ -114,27 +131,95 @@ extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
 extern AtomicInt32 internalQueryExecMaxBlockingSortBytes;
 
-// Yield after this many "should yield?" checks.
+// When greater than 1, PlanExecutor works its plan with PlanStage::workBatch(), asking for up to
+// this many units of work per call.
+extern AtomicInt32 internalQueryExecWorkBatchSize;
+
+// Consider yielding after this many "should yield?" checks.
 extern AtomicInt32 internalQueryExecYieldIterations;
 
-// Yield if it's been at least this many milliseconds since we last yielded.
+// Consider yielding if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// When considering a yield, a YIELD_AUTO plan which no other operation is waiting on only yields if
+// it's been at least this many milliseconds since it last yielded. 0 makes it always yield.
+extern AtomicInt32 internalQueryExecUncontendedYieldPeriodMS;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
 // The number of bytes to buffer at once during a $facet stage.
 extern AtomicInt32 internalQueryFacetBufferSizeBytes;
 
+// When at least 2, the sub-pipelines of a top-level $facet on a mongod run on up to this many
+// threads at once, see PipelineD::addParallelFacets().
+extern AtomicInt32 internalQueryFacetMaxParallelThreads;
+
 extern AtomicInt64 internalDocumentSourceSortMaxBlockingSortBytes;
 
 extern AtomicInt64 internalDocumentSourceGroupMaxMemoryBytes;
 
+// The most memory that the blocking stages of all queries together may buffer before they spill to
+// disk early and new ones wait for memory, see QueryMemoryTracker. 0 means there is no limit.
+extern AtomicInt64 internalQueryExecMaxGlobalMemoryBytes;
+
+// Past this, an operation stops waiting for memory and runs anyway, since memory may be held by
+// idle cursors for much longer.
+extern AtomicInt32 internalQueryExecMemoryAdmissionMaxWaitMS;
+
+// When a $group is split between the shards and a merger, have the shards return their partial
+// groups sorted by group key so that the merger can combine them as a stream instead of building a
+// hash table of every group.
+extern AtomicBool internalDocumentSourceGroupMergeSortedPartialGroups;
+
 extern AtomicInt32 internalInsertMaxBatchSize;
 
+// The maximum number of documents a multi delete removes in each storage transaction. Index keys
+// for the whole batch are removed together, one index at a time in key order.
+extern AtomicInt32 internalDeleteMaxBatchSize;
+
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
+// When true, documents that DocumentSourceCursor passes on whole are converted from BSON lazily,
+// one field at a time as the pipeline reads them.
+extern AtomicBool internalDocumentSourceCursorLateMaterialization;
+
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// When positive, a $lookup using localField/foreignField syntax reads the foreign collection once
+// into a hash table of at most this many bytes and probes it for each input document, instead of
+// querying the foreign collection per input document. If the table would exceed the limit, $lookup
+// falls back to the per-document queries.
+extern AtomicInt64 internalDocumentSourceLookupHashJoinMaxMemoryBytes;
+
+// The number of input documents for which a $lookup using localField/foreignField syntax queries
+// the foreign collection at once, with a single $in over all of their values. A value of 1 queries
+// once per input document.
+extern AtomicInt32 internalDocumentSourceLookupBatchSize;
+
+// The maximum number of bytes a $graphLookup may use for the documents and values of a single
+// search. If 'allowDiskUse' is set, the documents visited so far are spilled to disk instead of
+// failing the query once this is exceeded.
+extern AtomicInt64 internalDocumentSourceGraphLookupMaxMemoryBytes;
+
+// The size of the cache of converted oplog entries shared by the change streams on a node. Change
+// streams reading the same oplog entries convert each of them once rather than once per stream.
+// A value of 0 disables the cache.
+extern AtomicInt64 internalChangeStreamOplogEntryCacheSizeBytes;
+
+// If true, a $out with mode "replaceCollection" inserts each batch into its temporary collection
+// on a writer thread, while the pipeline produces the next batch.
+extern AtomicBool internalDocumentSourceOutUseWriterThread;
+
+// When at least 2, an aggregation on a mongod which begins with per-document stages and a $group
+// splits the work of those stages between this many threads, see PipelineD::addParallelExchange().
+extern AtomicInt32 internalQueryParallelAggregationConsumers;
+
+// When at least 2, an aggregation on a replica set primary which only counts the documents of a
+// collection scan splits the scan into this many ranges and counts them on threads of their own,
+// provided the collection has at least internalQueryParallelCountMinRecords records.
+extern AtomicInt32 internalQueryParallelCountThreads;
+extern AtomicInt64 internalQueryParallelCountMinRecords;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
 }  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_memory_tracker.h"
+
+#include <cstdlib>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryMemoryTracker = OperationContext::declareDecoration<QueryMemoryTracker>();
+
+Counter64 globalBytesCounter;
+Counter64 admissionWaits;
+Counter64 admissionTimeouts;
+
+ServerStatusMetricField<Counter64> displayGlobalBytes("query.memory.currentBytes",
+                                                      &globalBytesCounter);
+ServerStatusMetricField<Counter64> displayAdmissionWaits("query.memory.admissionWaits",
+                                                         &admissionWaits);
+ServerStatusMetricField<Counter64> displayAdmissionTimeouts("query.memory.admissionTimeouts",
+                                                            &admissionTimeouts);
+
+/**
+ * The operations waiting in waitForAdmission(). Releasing memory only takes the mutex to wake them
+ * when there are any.
+ */
+struct AdmissionQueue {
+    stdx::mutex mutex;
+    stdx::condition_variable memoryReleased;
+    AtomicWord<int> waiters{0};
+};
+
+AdmissionQueue admissionQueue;
+
+void addGlobalBytes(long long bytes) {
+    if (bytes >= 0) {
+        globalBytesCounter.increment(bytes);
+        return;
+    }
+
+    globalBytesCounter.decrement(-bytes);
+    if (admissionQueue.waiters.load() > 0 && !QueryMemoryTracker::globalBudgetExceeded()) {
+        stdx::lock_guard<stdx::mutex> lk(admissionQueue.mutex);
+        admissionQueue.memoryReleased.notify_all();
+    }
+}
+
+}  // namespace
+
+QueryMemoryTracker* QueryMemoryTracker::get(OperationContext* opCtx) {
+    return &getQueryMemoryTracker(opCtx);
+}
+
+long long QueryMemoryTracker::globalBytes() {
+    return globalBytesCounter.get();
+}
+
+bool QueryMemoryTracker::globalBudgetExceeded() {
+    const long long budget = internalQueryExecMaxGlobalMemoryBytes.load();
+    return budget > 0 && globalBytes() > budget;
+}
+
+void QueryMemoryTracker::waitForAdmission(OperationContext* opCtx) {
+    if (currentBytes() > 0 || !globalBudgetExceeded() || opCtx->lockState()->isLocked()) {
+        return;
+    }
+
+    admissionWaits.increment();
+    LOG(1) << "Waiting for queries to release memory; " << globalBytes()
+           << " bytes are in use and the limit is " << internalQueryExecMaxGlobalMemoryBytes.load();
+
+    stdx::unique_lock<stdx::mutex> lk(admissionQueue.mutex);
+    admissionQueue.waiters.fetchAndAdd(1);
+    ON_BLOCK_EXIT([] { admissionQueue.waiters.fetchAndSubtract(1); });
+
+    const auto deadline =
+        Date_t::now() + Milliseconds(internalQueryExecMemoryAdmissionMaxWaitMS.load());
+    if (!opCtx->waitForConditionOrInterruptUntil(
+            admissionQueue.memoryReleased, lk, deadline, [] { return !globalBudgetExceeded(); })) {
+        admissionTimeouts.increment();
+    }
+}
+
+void QueryMemoryTracker::_add(long long bytes) {
+    const long long current = _bytes.addAndFetch(bytes);
+    if (current > _peakBytes.load()) {
+        // Only the thread running the operation charges it, so there is no race to update the
+        // peak.
+        _peakBytes.store(current);
+    }
+}
+
+QueryMemoryTracker::Charge::Charge(OperationContext* opCtx)
+    : _tracker(opCtx ? QueryMemoryTracker::get(opCtx) : nullptr) {}
+
+QueryMemoryTracker::Charge::~Charge() {
+    set(0);
+}
+
+bool QueryMemoryTracker::Charge::set(size_t bytes) {
+    _bytes = bytes;
+    const long long delta = static_cast<long long>(bytes) - _chargedBytes;
+    if (bytes == 0 ? delta != 0 : std::abs(delta) >= kGranularityBytes) {
+        _chargedBytes += delta;
+        if (_tracker) {
+            _tracker->_add(delta);
+        }
+        addGlobalBytes(delta);
+    }
+    return !globalBudgetExceeded();
+}
+
+void QueryMemoryTracker::Charge::detachFromOperationContext() {
+    if (_tracker) {
+        _tracker->_add(-_chargedBytes);
+        _tracker = nullptr;
+    }
+}
+
+void QueryMemoryTracker::Charge::reattachToOperationContext(OperationContext* opCtx) {
+    detachFromOperationContext();
+    _tracker = QueryMemoryTracker::get(opCtx);
+    _tracker->_add(_chargedBytes);
+}
+
+}  // namespace mongo
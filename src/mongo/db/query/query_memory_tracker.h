@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Accounts for the memory which blocking query stages, such as SortStage and $group, buffer. Each
+ * stage still enforces its own limit, but that bounds neither the memory of an operation running
+ * many such stages nor the memory of many operations running at once.
+ *
+ * Stages charge their buffered bytes through a QueryMemoryTracker::Charge, which adds them to the
+ * tracker of the operation running the stage, reported by $currentOp, and to a server-wide total.
+ * When the total exceeds internalQueryExecMaxGlobalMemoryBytes, stages which can spill to disk do
+ * so early, and stages which are about to start buffering, and hold no locks, wait in
+ * waitForAdmission() for other operations to release memory.
+ */
+class QueryMemoryTracker {
+    MONGO_DISALLOW_COPYING(QueryMemoryTracker);
+
+public:
+    class Charge;
+
+    // The least a stage should buffer before it spills to disk to stay within the global budget,
+    // so as not to write many tiny files.
+    static constexpr size_t kMinEarlySpillBytes = 1024 * 1024;
+
+    QueryMemoryTracker() = default;
+
+    static QueryMemoryTracker* get(OperationContext* opCtx);
+
+    /**
+     * Returns the bytes charged by all operations.
+     */
+    static long long globalBytes();
+
+    /**
+     * Returns whether the bytes charged by all operations exceed
+     * internalQueryExecMaxGlobalMemoryBytes.
+     */
+    static bool globalBudgetExceeded();
+
+    /**
+     * Returns the bytes charged by the stages of this operation, and the most they ever added up
+     * to. Safe to call from other threads.
+     */
+    long long currentBytes() const {
+        return _bytes.load();
+    }
+
+    long long peakBytes() const {
+        return _peakBytes.load();
+    }
+
+    /**
+     * Waits while the global budget is exceeded, for up to
+     * internalQueryExecMemoryAdmissionMaxWaitMS, unless this operation already holds memory, which
+     * it could otherwise wait on itself, or holds locks, which other operations could need to
+     * release their memory. Throws if the operation is interrupted.
+     */
+    void waitForAdmission(OperationContext* opCtx);
+
+private:
+    void _add(long long bytes);
+
+    AtomicWord<long long> _bytes{0};
+    AtomicWord<long long> _peakBytes{0};
+};
+
+/**
+ * The bytes buffered by one stage. The charge follows the stage from operation to operation, as
+ * a cursor does across getMores, through detachFromOperationContext() and
+ * reattachToOperationContext(). Releases the bytes on destruction.
+ *
+ * To keep stages which update their usage for every document off the shared counters, changes
+ * are only published once they add up to kGranularityBytes.
+ */
+class QueryMemoryTracker::Charge {
+    MONGO_DISALLOW_COPYING(Charge);
+
+public:
+    static constexpr long long kGranularityBytes = 64 * 1024;
+
+    explicit Charge(OperationContext* opCtx);
+    ~Charge();
+
+    /**
+     * Sets the bytes the stage buffers. Returns false if the global budget is exceeded, in which
+     * case the stage should spill to disk if it can.
+     */
+    bool set(size_t bytes);
+
+    size_t get() const {
+        return _bytes;
+    }
+
+    void detachFromOperationContext();
+    void reattachToOperationContext(OperationContext* opCtx);
+
+private:
+    QueryMemoryTracker* _tracker;
+    size_t _bytes = 0;
+
+    // The bytes added to '_tracker' and to the global total.
+    long long _chargedBytes = 0;
+};
+
+}  // namespace mongo
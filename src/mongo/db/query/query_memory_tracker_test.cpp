@@ -0,0 +1,191 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_memory_tracker.h"
+
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const long long kGranularity = QueryMemoryTracker::Charge::kGranularityBytes;
+
+class QueryMemoryTrackerTest : public unittest::Test {
+public:
+    QueryMemoryTrackerTest()
+        : _originalBudget(internalQueryExecMaxGlobalMemoryBytes.load()),
+          _originalMaxWait(internalQueryExecMemoryAdmissionMaxWaitMS.load()),
+          _startingGlobalBytes(QueryMemoryTracker::globalBytes()) {}
+
+    ~QueryMemoryTrackerTest() {
+        internalQueryExecMaxGlobalMemoryBytes.store(_originalBudget);
+        internalQueryExecMemoryAdmissionMaxWaitMS.store(_originalMaxWait);
+    }
+
+    // The bytes charged by the charges of this test.
+    long long globalBytes() const {
+        return QueryMemoryTracker::globalBytes() - _startingGlobalBytes;
+    }
+
+    void setBudget(long long bytes) {
+        internalQueryExecMaxGlobalMemoryBytes.store(_startingGlobalBytes + bytes);
+    }
+
+protected:
+    QueryTestServiceContext _serviceContext;
+    QueryTestServiceContext _otherServiceContext;
+
+private:
+    const long long _originalBudget;
+    const int _originalMaxWait;
+    const long long _startingGlobalBytes;
+};
+
+TEST_F(QueryMemoryTrackerTest, ChargeIsAddedToOperationAndGlobalBytes) {
+    auto opCtx = _serviceContext.makeOperationContext();
+    auto tracker = QueryMemoryTracker::get(opCtx.get());
+    {
+        QueryMemoryTracker::Charge first(opCtx.get());
+        QueryMemoryTracker::Charge second(opCtx.get());
+        first.set(2 * kGranularity);
+        second.set(3 * kGranularity);
+        ASSERT_EQ(5 * kGranularity, tracker->currentBytes());
+        ASSERT_EQ(5 * kGranularity, globalBytes());
+
+        first.set(0);
+        ASSERT_EQ(3 * kGranularity, tracker->currentBytes());
+        ASSERT_EQ(3 * kGranularity, globalBytes());
+    }
+    ASSERT_EQ(0, tracker->currentBytes());
+    ASSERT_EQ(5 * kGranularity, tracker->peakBytes());
+    ASSERT_EQ(0, globalBytes());
+}
+
+TEST_F(QueryMemoryTrackerTest, SmallChangesArePublishedOnceTheyAddUp) {
+    auto opCtx = _serviceContext.makeOperationContext();
+    auto tracker = QueryMemoryTracker::get(opCtx.get());
+
+    QueryMemoryTracker::Charge charge(opCtx.get());
+    charge.set(kGranularity - 1);
+    ASSERT_EQ(kGranularity - 1, static_cast<long long>(charge.get()));
+    ASSERT_EQ(0, tracker->currentBytes());
+
+    charge.set(kGranularity + 10);
+    ASSERT_EQ(kGranularity + 10, tracker->currentBytes());
+
+    charge.set(kGranularity + 20);
+    ASSERT_EQ(kGranularity + 10, tracker->currentBytes());
+
+    // Releasing everything is always published.
+    charge.set(0);
+    ASSERT_EQ(0, tracker->currentBytes());
+    ASSERT_EQ(0, globalBytes());
+}
+
+TEST_F(QueryMemoryTrackerTest, ChargeMovesBetweenOperations) {
+    auto opCtx = _serviceContext.makeOperationContext();
+    auto otherOpCtx = _otherServiceContext.makeOperationContext();
+
+    QueryMemoryTracker::Charge charge(opCtx.get());
+    charge.set(kGranularity);
+
+    charge.detachFromOperationContext();
+    ASSERT_EQ(0, QueryMemoryTracker::get(opCtx.get())->currentBytes());
+    ASSERT_EQ(kGranularity, globalBytes());
+
+    charge.reattachToOperationContext(otherOpCtx.get());
+    ASSERT_EQ(kGranularity, QueryMemoryTracker::get(otherOpCtx.get())->currentBytes());
+
+    charge.set(0);
+    ASSERT_EQ(0, QueryMemoryTracker::get(otherOpCtx.get())->currentBytes());
+    ASSERT_EQ(0, globalBytes());
+}
+
+TEST_F(QueryMemoryTrackerTest, SetReportsWhetherTheGlobalBudgetIsExceeded) {
+    setBudget(2 * kGranularity);
+    auto opCtx = _serviceContext.makeOperationContext();
+    auto otherOpCtx = _otherServiceContext.makeOperationContext();
+
+    QueryMemoryTracker::Charge charge(opCtx.get());
+    QueryMemoryTracker::Charge otherCharge(otherOpCtx.get());
+    ASSERT_TRUE(charge.set(kGranularity));
+    ASSERT_TRUE(otherCharge.set(kGranularity));
+    ASSERT_FALSE(otherCharge.set(2 * kGranularity));
+    ASSERT_FALSE(charge.set(kGranularity));
+    ASSERT_TRUE(otherCharge.set(0));
+}
+
+TEST_F(QueryMemoryTrackerTest, WaitForAdmissionTimesOutWhileOverBudget) {
+    setBudget(kGranularity);
+    internalQueryExecMemoryAdmissionMaxWaitMS.store(10);
+    auto opCtx = _serviceContext.makeOperationContext();
+    auto otherOpCtx = _otherServiceContext.makeOperationContext();
+
+    QueryMemoryTracker::Charge otherCharge(otherOpCtx.get());
+    otherCharge.set(2 * kGranularity);
+    ASSERT_TRUE(QueryMemoryTracker::globalBudgetExceeded());
+
+    // Runs anyway once the wait is over.
+    QueryMemoryTracker::get(opCtx.get())->waitForAdmission(opCtx.get());
+}
+
+TEST_F(QueryMemoryTrackerTest, WaitForAdmissionReturnsOnceMemoryIsReleased) {
+    setBudget(kGranularity);
+    internalQueryExecMemoryAdmissionMaxWaitMS.store(60 * 1000);
+    auto opCtx = _serviceContext.makeOperationContext();
+    auto otherOpCtx = _otherServiceContext.makeOperationContext();
+
+    QueryMemoryTracker::Charge otherCharge(otherOpCtx.get());
+    otherCharge.set(2 * kGranularity);
+
+    stdx::thread releaser([&] {
+        sleepmillis(50);
+        otherCharge.set(0);
+    });
+    QueryMemoryTracker::get(opCtx.get())->waitForAdmission(opCtx.get());
+    ASSERT_FALSE(QueryMemoryTracker::globalBudgetExceeded());
+    releaser.join();
+}
+
+TEST_F(QueryMemoryTrackerTest, OperationHoldingMemoryIsAdmittedRightAway) {
+    setBudget(kGranularity);
+    internalQueryExecMemoryAdmissionMaxWaitMS.store(60 * 1000);
+    auto opCtx = _serviceContext.makeOperationContext();
+
+    QueryMemoryTracker::Charge charge(opCtx.get());
+    charge.set(2 * kGranularity);
+    QueryMemoryTracker::get(opCtx.get())->waitForAdmission(opCtx.get());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,11 +32,14 @@
 
 #include "mongo/db/query/query_planner.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
+#include <numeric>
 #include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/wildcard_key_generator.h"
 #include "mongo/db/index_names.h"
@@ -46,11 +49,13 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/index_histogram.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_enumerator.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/util/log.h"
@@ -134,6 +139,9 @@ string optionString(size_t options) {
             case QueryPlannerParams::STRICT_DISTINCT_ONLY:
                 ss << "STRICT_DISTINCT_ONLY ";
                 break;
+            case QueryPlannerParams::IS_CLUSTERED_ON_ID:
+                ss << "IS_CLUSTERED_ON_ID ";
+                break;
             case QueryPlannerParams::DEFAULT:
                 MONGO_UNREACHABLE;
                 break;
@@ -279,6 +287,120 @@ std::unique_ptr<QuerySolution> buildCollscanSoln(const CanonicalQuery& query,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+/**
+ * Returns true if 'path' lies within _id or within one of the columns of the columnstore index
+ * 'index'.
+ */
+bool columnsHoldPath(const IndexEntry& index, StringData path) {
+    const StringData topLevelField = path.substr(0, path.find('.'));
+    return topLevelField == "_id" || index.keyPattern.hasField(topLevelField);
+}
+
+/**
+ * Appends the paths read by 'node' to 'paths'. Returns false if 'node' may read fields other than
+ * the ones named by its paths, as $expr and $where do.
+ */
+bool getFilterPaths(const MatchExpression* node, std::vector<StringData>* paths) {
+    if (node->getCategory() == MatchExpression::MatchCategory::kLogical) {
+        for (size_t i = 0; i < node->numChildren(); ++i) {
+            if (!getFilterPaths(node->getChild(i), paths)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (node->matchType() == MatchExpression::ALWAYS_FALSE ||
+        node->matchType() == MatchExpression::ALWAYS_TRUE) {
+        return true;
+    }
+
+    if (node->path().empty() || node->matchType() == MatchExpression::TEXT ||
+        node->matchType() == MatchExpression::GEO_NEAR) {
+        return false;
+    }
+    paths->push_back(node->path());
+    return true;
+}
+
+/**
+ * Appends the paths included by the projection 'projSpec' to 'paths'. Returns false unless
+ * 'projSpec' is an inclusion projection without any operators, which reads no other paths.
+ */
+bool getInclusionProjectionPaths(const BSONObj& projSpec, std::vector<StringData>* paths) {
+    bool includesAnyField = false;
+    for (auto&& elem : projSpec) {
+        const StringData field = elem.fieldNameStringData();
+        if (elem.type() == BSONType::Object || elem.type() == BSONType::Array ||
+            field.find('$') != std::string::npos) {
+            return false;
+        }
+        if (field == "_id") {
+            includesAnyField = includesAnyField || elem.trueValue();
+            continue;
+        }
+        if (!elem.trueValue()) {
+            return false;
+        }
+        paths->push_back(field);
+        includesAnyField = true;
+    }
+    return includesAnyField;
+}
+
+/**
+ * Returns a solution which scans the columnstore index 'index' in place of the collection, or
+ * nullptr if the query may read a field which is not a column of the index. Only queries whose
+ * projection names the fields they return can be answered this way.
+ */
+std::unique_ptr<QuerySolution> buildColumnScanSoln(const CanonicalQuery& query,
+                                                   const QueryPlannerParams& params,
+                                                   const IndexEntry& index) {
+    if (!query.getProj() || !query.getQueryRequest().getMin().isEmpty() ||
+        !query.getQueryRequest().getMax().isEmpty()) {
+        return nullptr;
+    }
+
+    std::vector<StringData> paths;
+    if (!getInclusionProjectionPaths(query.getQueryRequest().getProj(), &paths) ||
+        !getFilterPaths(query.root(), &paths)) {
+        return nullptr;
+    }
+    for (auto&& sortElem : query.getQueryRequest().getSort()) {
+        if (sortElem.type() == BSONType::Object) {
+            // A $meta sort.
+            return nullptr;
+        }
+        paths.push_back(sortElem.fieldNameStringData());
+    }
+    if (params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
+        for (auto&& shardKeyElem : params.shardKey) {
+            paths.push_back(shardKeyElem.fieldNameStringData());
+        }
+    }
+
+    for (auto&& path : paths) {
+        if (!columnsHoldPath(index, path)) {
+            return nullptr;
+        }
+    }
+
+    // Read only the columns which hold one of the paths.
+    std::vector<std::string> fields;
+    for (auto&& column : index.keyPattern) {
+        const StringData field = column.fieldNameStringData();
+        if (std::any_of(paths.begin(), paths.end(), [&](StringData path) {
+                return path.substr(0, path.find('.')) == field;
+            })) {
+            fields.push_back(field.toString());
+        }
+    }
+
+    auto columnScan = stdx::make_unique<ColumnScanNode>(index, std::move(fields));
+    columnScan->filter = query.root()->shallowClone();
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(columnScan));
+}
+
 std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
                                                 const CanonicalQuery& query,
                                                 const QueryPlannerParams& params,
@@ -288,6 +410,44 @@ std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+std::unique_ptr<QuerySolution> buildSkipIXSoln(const IndexEntry& index,
+                                               const CanonicalQuery& query,
+                                               const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::scanIndexSkippingLeadingField(index, query, params));
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
+/**
+ * Returns true if 'index' could answer 'query' by skipping over the values of its leading field,
+ * which the query does not constrain, while using the bounds on its second field.
+ */
+bool canSkipLeadingField(const IndexEntry& index,
+                         const CanonicalQuery& query,
+                         const stdx::unordered_set<string>& fields) {
+    // Sparse indexes would miss documents which have none of the indexed fields.
+    if (index.type != INDEX_BTREE || index.sparse || index.keyPattern.nFields() < 2) {
+        return false;
+    }
+
+    if (!CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return false;
+    }
+
+    if (index.filterExpr && !expression::isSubsetOf(query.root(), index.filterExpr)) {
+        return false;
+    }
+
+    BSONObjIterator kpIt(index.keyPattern);
+    const BSONElement leadingElt = kpIt.next();
+    const BSONElement secondElt = kpIt.next();
+    return fields.end() == fields.find(leadingElt.fieldName()) &&
+        fields.end() != fields.find(secondElt.fieldName());
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp, SimpleBSONElementComparator::kInstance);
 }
@@ -457,6 +617,21 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
         } else {
             return {std::move(soln)};
         }
+    } else if (SolutionCacheData::SKIP_IXSCAN_SOLN == winnerCacheData.solnType) {
+        auto soln = buildSkipIXSoln(*winnerCacheData.tree->entry, query, params);
+        if (!soln) {
+            return Status(ErrorCodes::BadValue,
+                          "plan cache error: soln that skips over the leading index field");
+        } else {
+            return {std::move(soln)};
+        }
+    } else if (SolutionCacheData::COLUMN_SCAN_SOLN == winnerCacheData.solnType) {
+        auto soln = buildColumnScanSoln(query, params, *winnerCacheData.tree->entry);
+        if (!soln) {
+            return Status(ErrorCodes::BadValue, "plan cache error: columnstore index scan soln");
+        } else {
+            return {std::move(soln)};
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -480,15 +655,23 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
            << redact(clone->toString()) << "Cache data:" << endl
            << redact(winnerCacheData.toString());
 
-    stdx::unordered_set<string> fields;
-    QueryPlannerIXSelect::getFields(query.root(), &fields);
-    std::vector<IndexEntry> expandedIndexes =
-        QueryPlannerIXSelect::expandIndexes(fields, params.indices);
+    // Only wildcard indexes need expanding against the query's fields. This is on the hot path for
+    // every plan cache hit, so avoid copying the index list when there is nothing to expand.
+    const std::vector<IndexEntry>* indexes = &params.indices;
+    std::vector<IndexEntry> expandedIndexes;
+    if (std::any_of(params.indices.begin(), params.indices.end(), [](const IndexEntry& entry) {
+            return entry.type == IndexType::INDEX_WILDCARD;
+        })) {
+        stdx::unordered_set<string> fields;
+        QueryPlannerIXSelect::getFields(query.root(), &fields);
+        expandedIndexes = QueryPlannerIXSelect::expandIndexes(fields, params.indices);
+        indexes = &expandedIndexes;
+    }
 
     // Map from index name to index number.
     map<IndexEntry::Identifier, size_t> indexMap;
-    for (size_t i = 0; i < expandedIndexes.size(); ++i) {
-        const IndexEntry& ie = expandedIndexes[i];
+    for (size_t i = 0; i < indexes->size(); ++i) {
+        const IndexEntry& ie = (*indexes)[i];
         const auto insertionRes = indexMap.insert(std::make_pair(ie.identifier, i));
         // Be sure the key was not already in the map.
         invariant(insertionRes.second);
@@ -507,7 +690,7 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
 
     // Use the cached index assignments to build solnRoot.
     std::unique_ptr<QuerySolutionNode> solnRoot(QueryPlannerAccess::buildIndexedDataAccess(
-        query, std::move(clone), expandedIndexes, params));
+        query, std::move(clone), *indexes, params));
 
     if (!solnRoot) {
         return Status(ErrorCodes::BadValue,
@@ -526,6 +709,102 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
     return {std::move(soln)};
 }
 
+/**
+ * Returns the estimated number of index keys, per document of the collection, which 'node' reads,
+ * or boost::none if it reads an index which has not been analyzed, or reads data in some other way.
+ */
+static boost::optional<double> estimateKeysPerRecord(const QuerySolutionNode* node) {
+    switch (node->getType()) {
+        case STAGE_IXSCAN: {
+            const auto ixn = static_cast<const IndexScanNode*>(node);
+            const auto& histogram = ixn->index.histogram;
+            if (!histogram || ixn->index.type != INDEX_BTREE || ixn->bounds.isSimpleRange ||
+                ixn->bounds.fields.empty()) {
+                return boost::none;
+            }
+            return histogram->estimateSelectivity(ixn->bounds.fields[0]) *
+                histogram->keysPerRecord();
+        }
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED:
+        case STAGE_OR:
+        case STAGE_SORT_MERGE: {
+            // Every child is read in full.
+            double total = 0;
+            for (auto&& child : node->children) {
+                auto estimate = estimateKeysPerRecord(child);
+                if (!estimate) {
+                    return boost::none;
+                }
+                total += *estimate;
+            }
+            return total;
+        }
+        default:
+            if (node->children.size() != 1) {
+                return boost::none;
+            }
+            return estimateKeysPerRecord(node->children[0]);
+    }
+}
+
+/**
+ * Orders 'solutions' by the number of index keys their scans are estimated to read, keeping those
+ * without an estimate last and in their original order. Since the plan ranker prefers the earlier
+ * of two candidates with equal scores, this decides between candidates which the trial period
+ * cannot tell apart, such as those which find no results in it.
+ *
+ * Unless the query has a limit, under which a scan providing the sort may stop early, candidates
+ * estimated to read more than internalQueryPlannerHistogramPruneFactor times as many keys as the
+ * first are removed, so that they are never evaluated.
+ */
+static void orderByEstimatedKeys(const CanonicalQuery& query,
+                                 std::vector<std::unique_ptr<QuerySolution>>* solutions) {
+    if (solutions->size() < 2) {
+        return;
+    }
+
+    std::vector<boost::optional<double>> estimates;
+    for (auto&& soln : *solutions) {
+        estimates.push_back(estimateKeysPerRecord(soln->root.get()));
+    }
+    if (std::none_of(estimates.begin(), estimates.end(), [](const boost::optional<double>& e) {
+            return static_cast<bool>(e);
+        })) {
+        return;
+    }
+
+    std::vector<size_t> order(solutions->size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        if (!estimates[lhs] || !estimates[rhs]) {
+            return estimates[lhs] && !estimates[rhs];
+        }
+        return *estimates[lhs] < *estimates[rhs];
+    });
+
+    // A histogram built from a sample cannot tell apart estimates much smaller than this, so a
+    // candidate is never pruned for reading more keys than one estimated to read almost none.
+    const double kMinEstimateForPruning = 0.001;
+    const auto& qr = query.getQueryRequest();
+    const double pruneFactor =
+        (qr.getLimit() || qr.getNToReturn()) ? 0 : internalQueryPlannerHistogramPruneFactor.load();
+    const double bestEstimate = std::max(*estimates[order[0]], kMinEstimateForPruning);
+
+    std::vector<std::unique_ptr<QuerySolution>> ordered;
+    for (auto i : order) {
+        LOG(5) << "Planner: candidate " << i << " is estimated to read "
+               << (estimates[i] ? std::to_string(*estimates[i]) : "unknown")
+               << " index keys per document";
+        if (pruneFactor > 0 && estimates[i] && *estimates[i] > pruneFactor * bestEstimate) {
+            LOG(5) << "Planner: pruning candidate:" << endl << redact((*solutions)[i]->toString());
+            continue;
+        }
+        ordered.push_back(std::move((*solutions)[i]));
+    }
+    *solutions = std::move(ordered);
+}
+
 // static
 StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
     const CanonicalQuery& query, const QueryPlannerParams& params) {
@@ -590,6 +869,22 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         hintedIndex = query.getQueryRequest().getHint();
     }
 
+    // A hinted columnstore index is scanned in place of the collection, which is only possible if
+    // its columns hold every field the query reads.
+    if (!hintedIndex.isEmpty()) {
+        auto hintedColumnStores =
+            QueryPlannerIXSelect::findIndexesByHint(hintedIndex, params.columnStoreIndices);
+        if (!hintedColumnStores.empty()) {
+            auto soln = buildColumnScanSoln(query, params, hintedColumnStores.front());
+            if (!soln) {
+                return Status(ErrorCodes::BadValue,
+                              "hinted columnstore index does not hold every field the query reads");
+            }
+            out.push_back(std::move(soln));
+            return {std::move(out)};
+        }
+    }
+
     // Either the list of indices passed in by the caller, or the list of indices filtered according
     // to the hint. This list is later expanded in order to allow the planner to handle wildcard
     // indexes.
@@ -869,6 +1164,39 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         return {std::move(out)};
     }
 
+    // A compound index whose leading field the query does not constrain may still be useful if
+    // the query has predicates over the index's second field. The index scan can skip from one
+    // leading value to the next, which pays off when the leading field has few distinct values.
+    // Whether it does is left to plan ranking.
+    size_t numSkipScanSolns = 0;
+    if (internalQueryPlannerEnableIndexSkipScan.load() &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        for (auto&& index : fullIndexList) {
+            if (out.size() >= params.maxIndexedSolutions) {
+                break;
+            }
+            if (!canSkipLeadingField(index, query, fields)) {
+                continue;
+            }
+
+            auto soln = buildSkipIXSoln(index, query, params);
+            if (soln) {
+                LOG(5) << "Planner: outputting soln that skips over the leading field of index "
+                       << index.identifier;
+                PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+                indexTree->setIndexEntry(index);
+                SolutionCacheData* scd = new SolutionCacheData();
+                scd->tree.reset(indexTree);
+                scd->solnType = SolutionCacheData::SKIP_IXSCAN_SOLN;
+
+                soln->cacheData.reset(scd);
+                out.push_back(std::move(soln));
+                ++numSkipScanSolns;
+            }
+        }
+    }
+
     // If a sort order is requested, there may be an index that provides it, even if that
     // index is not over any predicates in the query.
     //
@@ -1004,9 +1332,24 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
     bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
-    bool collscanNeeded = (0 == out.size() && canTableScan);
+    // Skip scans only pay off for some data distributions, so a collscan competes with them.
+    bool collscanNeeded = (numSkipScanSolns == out.size() && canTableScan);
+
+    // On a collection clustered on _id, a collscan plays the part of a scan over the _id index. It
+    // competes with the indexed plans when it provides the requested sort, or only reads a range
+    // of records. Like a bounded scan of the _id index, it is not considered a table scan.
+    bool clusteredIdScanUseful = false;
+    if (params.options & QueryPlannerParams::IS_CLUSTERED_ON_ID) {
+        const BSONObj& sortObj = query.getQueryRequest().getSort();
+        const bool sortsOnId =
+            SimpleBSONObjComparator::kInstance.evaluate(sortObj == BSON("_id" << 1)) ||
+            SimpleBSONObjComparator::kInstance.evaluate(sortObj == BSON("_id" << -1));
+        RecordId minRecord, maxRecord;
+        clusteredIdScanUseful = (sortsOnId && canTableScan) ||
+            QueryPlannerAccess::getClusteredIdRange(query.root(), &minRecord, &maxRecord);
+    }
 
-    if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
+    if (possibleToCollscan && (collscanRequested || collscanNeeded || clusteredIdScanUseful)) {
         auto collscan = buildCollscanSoln(query, isTailable, params);
         if (collscan) {
             LOG(5) << "Planner: outputting a collscan:" << endl << redact(collscan->toString());
@@ -1017,6 +1360,29 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         }
     }
 
+    // A columnstore index whose columns hold every field the query reads can be scanned in place
+    // of the collection, reading only those fields. Like a collscan, it visits every document, so
+    // it competes with the other plans and is subject to NO_TABLE_SCAN.
+    if (possibleToCollscan && canTableScan) {
+        for (auto&& index : params.columnStoreIndices) {
+            auto soln = buildColumnScanSoln(query, params, index);
+            if (soln) {
+                LOG(5) << "Planner: outputting soln that scans columnstore index "
+                       << index.identifier;
+                PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+                indexTree->setIndexEntry(index);
+                SolutionCacheData* scd = new SolutionCacheData();
+                scd->tree.reset(indexTree);
+                scd->solnType = SolutionCacheData::COLUMN_SCAN_SOLN;
+
+                soln->cacheData.reset(scd);
+                out.push_back(std::move(soln));
+                break;
+            }
+        }
+    }
+
+    orderByEstimatedKeys(query, &out);
     return {std::move(out)};
 }
 
@@ -31,6 +31,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/query/query_planner_common.h"
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
@@ -60,6 +62,17 @@ void QueryPlannerCommon::reverseScans(QuerySolutionNode* node) {
                   str::stream() << "Invalid bounds: " << redact(dn->bounds.toString()));
 
         dn->computeProperties();
+    } else if (STAGE_COLLSCAN == type) {
+        // Only collscans over collections clustered on _id provide a sort, which is on _id and
+        // follows the scan direction. The range of records to scan is unaffected.
+        CollectionScanNode* csn = static_cast<CollectionScanNode*>(node);
+        csn->direction *= -1;
+
+        BSONObjSet reversedSorts = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        for (auto&& sort : csn->_sort) {
+            reversedSorts.insert(reverseSortObj(sort));
+        }
+        csn->_sort = std::move(reversedSorts);
     } else if (STAGE_SORT_MERGE == type) {
         // reverse direction of comparison for merge
         MergeSortNode* msn = static_cast<MergeSortNode*>(node);
@@ -96,6 +96,10 @@ struct QueryPlannerParams {
         // return exactly one document per value of the distinct field. See the comments above the
         // declaration of getExecutorDistinct() for more detail.
         STRICT_DISTINCT_ONLY = 1 << 11,
+
+        // Set this if the records of the collection are keyed by _id, so that collection scans are
+        // in _id order and can be restricted to a range of _id values.
+        IS_CLUSTERED_ON_ID = 1 << 12,
     };
 
     // See Options enum above.
@@ -104,6 +108,10 @@ struct QueryPlannerParams {
     // What indices are available for planning?
     std::vector<IndexEntry> indices;
 
+    // The columnstore indexes of the collection. They are kept apart from 'indices' as they cannot
+    // answer predicates, and are only used to scan for the fields a query reads.
+    std::vector<IndexEntry> columnStoreIndices;
+
     // What's our shard key?  If INCLUDE_SHARD_FILTER is set we will create a shard filtering
     // stage.  If we know the shard key, we can perform covering analysis instead of always
     // forcing a fetch.
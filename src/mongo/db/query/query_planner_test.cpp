@@ -36,8 +36,11 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_always_boolean.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/index_histogram.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
+#include "mongo/db/query/query_planner_test_lib.h"
 
 namespace {
 
@@ -134,6 +137,26 @@ TEST_F(QueryPlannerTest, ExprEqCanUseHashedIndexWithRegex) {
         "{a: 'hashed'}}}}}");
 }
 
+TEST_F(QueryPlannerTest, CompoundHashedIndexCanAnswerPointOnHashedFieldAndRange) {
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a"
+                  << "hashed"
+                  << "b"
+                  << 1));
+    runQuery(fromjson("{a: 5, b: {$gt: 1, $lte: 3}}"));
+    ASSERT_EQUALS(getNumSolutions(), 1U);
+    assertSolutionExists(
+        "{fetch: {filter: {a: 5}, node: {ixscan: {filter: null, pattern: {a: 'hashed', b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CompoundHashedIndexCannotUseRangeOnHashedField) {
+    addIndex(BSON("a" << 1 << "b"
+                      << "hashed"));
+    runQuery(fromjson("{b: {$gt: 1}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
 //
 // indexFilterApplied
 // Check that index filter flag is passed from planner params
@@ -3732,6 +3755,52 @@ TEST_F(QueryPlannerTest, IntersectDisableAndHash) {
     internalQueryPlannerEnableHashIntersection.store(oldEnableHashIntersection);
 }
 
+//
+// Skip scans over a compound index without a predicate on the leading field.
+//
+
+TEST_F(QueryPlannerTest, SkipScanUsesBoundsOnSecondIndexField) {
+    bool oldEnableIndexSkipScan = internalQueryPlannerEnableIndexSkipScan.load();
+    internalQueryPlannerEnableIndexSkipScan.store(true);
+
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: {$gte: 5, $lt: 10}, c: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gte: 5, $lt: 10}, c: 1}, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,10,true,false]]}}}}}");
+
+    internalQueryPlannerEnableIndexSkipScan.store(oldEnableIndexSkipScan);
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWhenDisabled) {
+    bool oldEnableIndexSkipScan = internalQueryPlannerEnableIndexSkipScan.load();
+    internalQueryPlannerEnableIndexSkipScan.store(false);
+
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+
+    internalQueryPlannerEnableIndexSkipScan.store(oldEnableIndexSkipScan);
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedForSparseIndex) {
+    bool oldEnableIndexSkipScan = internalQueryPlannerEnableIndexSkipScan.load();
+    internalQueryPlannerEnableIndexSkipScan.store(true);
+
+    addIndex(BSON("a" << 1 << "b" << 1), false /* multikey */, true /* sparse */);
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+
+    internalQueryPlannerEnableIndexSkipScan.store(oldEnableIndexSkipScan);
+}
+
 //
 // Index intersection cases for SERVER-12825: make sure that
 // we don't generate an ixisect plan if a compound index is
@@ -5688,4 +5757,183 @@ TEST_F(QueryPlannerTest, EmptyQueryWithProjectionUsesCollscanIfIndexCollationDif
         "{proj: {spec: {_id: 0, a: 1}, node: "
         "{cscan: {dir: 1}}}}");
 }
+
+//
+// Collections clustered on _id
+//
+
+TEST_F(QueryPlannerTest, ClusteredIdRangeCollscanCompetesWithIndexedPlans) {
+    params.options = QueryPlannerParams::IS_CLUSTERED_ON_ID;
+    addIndex(BSON("a" << 1));
+    runQuery(fromjson("{_id: {$gt: 4.5, $lte: 10}, a: 1}"));
+    assertNumSolutions(2);
+    assertSolutionExists("{fetch: {node: {ixscan: {pattern: {a: 1}}}}}");
+    assertSolutionExists("{cscan: {dir: 1, minRecord: 5, maxRecord: 10}}");
+}
+
+TEST_F(QueryPlannerTest, ClusteredIdRangeIsEmptyForContradictoryPredicates) {
+    params.options = QueryPlannerParams::IS_CLUSTERED_ON_ID;
+    runQuery(fromjson("{_id: {$gt: 7, $lt: 8}}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1, minRecord: 2, maxRecord: 1}}");
+}
+
+TEST_F(QueryPlannerTest, ClusteredIdRangeIgnoresNonNumericPredicates) {
+    params.options = QueryPlannerParams::IS_CLUSTERED_ON_ID;
+    runQuery(fromjson("{_id: {$gte: 'a'}, b: {$lt: 3}}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1, minRecord: 0, maxRecord: 0}}");
+}
+
+TEST_F(QueryPlannerTest, ClusteredIdCollscanProvidesSortOnId) {
+    params.options = QueryPlannerParams::IS_CLUSTERED_ON_ID;
+    addIndex(BSON("a" << 1));
+    runQuerySortProj(fromjson("{a: {$gt: 1}, _id: {$lt: 100}}"), fromjson("{_id: -1}"), BSONObj());
+    assertNumSolutions(2);
+    assertSolutionExists(
+        "{sort: {pattern: {_id: -1}, limit: 0, node: {sortKeyGen: {node: "
+        "{fetch: {node: {ixscan: {pattern: {a: 1}}}}}}}}}");
+    assertSolutionExists("{cscan: {dir: -1, minRecord: 1, maxRecord: 99}}");
+}
+
+TEST_F(QueryPlannerTest, CollscanDoesNotProvideSortOnIdUnlessClustered) {
+    runQuerySortProj(BSONObj(), fromjson("{_id: 1}"), BSONObj());
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{sort: {pattern: {_id: 1}, limit: 0, node: {sortKeyGen: {node: {cscan: {dir: 1}}}}}}");
+}
+
+//
+// Columnstore indexes
+//
+
+TEST_F(QueryPlannerTest, ColumnScanCompetesWithCollscanWhenColumnsHoldAllReadFields) {
+    params.columnStoreIndices.push_back(
+        IndexEntry(fromjson("{a: 'columnstore', b: 'columnstore', c: 'columnstore'}"), "cs"));
+    runQuerySortProj(fromjson("{c: {$gt: 1}}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+    assertNumSolutions(2);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: "
+        "{columnScan: {name: 'cs', fields: ['a', 'c'], filter: {c: {$gt: 1}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanProvidesFieldsForBlockingSort) {
+    params.columnStoreIndices.push_back(
+        IndexEntry(fromjson("{a: 'columnstore', b: 'columnstore'}"), "cs"));
+    runQuerySortProj(BSONObj(), fromjson("{b: -1}"), fromjson("{a: 1}"));
+    assertNumSolutions(2);
+    assertSolutionExists(
+        "{proj: {spec: {a: 1}, node: {sort: {pattern: {b: -1}, limit: 0, node: {sortKeyGen: "
+        "{node: {columnScan: {name: 'cs', fields: ['a', 'b']}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanNotUsedWhenQueryReadsOtherFields) {
+    params.columnStoreIndices.push_back(
+        IndexEntry(fromjson("{a: 'columnstore', b: 'columnstore'}"), "cs"));
+
+    // A projection on another field.
+    runQuerySortProj(fromjson("{a: 1}"), BSONObj(), fromjson("{_id: 0, d: 1}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{proj: {spec: {_id: 0, d: 1}, node: {cscan: {dir: 1}}}}");
+
+    // A predicate on another field.
+    runQuerySortProj(fromjson("{d: 1}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1}}}}");
+
+    // Without a projection, or with an exclusion projection, the whole document is returned.
+    runQuery(fromjson("{a: 1}"));
+    assertHasOnlyCollscan();
+    runQuerySortProj(fromjson("{a: 1}"), BSONObj(), fromjson("{b: 0}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{proj: {spec: {b: 0}, node: {cscan: {dir: 1}}}}");
+}
+
+TEST_F(QueryPlannerTest, ColumnScanReadsWholeValuesOfDottedPaths) {
+    params.columnStoreIndices.push_back(
+        IndexEntry(fromjson("{a: 'columnstore', b: 'columnstore'}"), "cs"));
+    runQuerySortProj(fromjson("{'a.x': 1}"), BSONObj(), fromjson("{_id: 0, 'b.y': 1}"));
+    assertNumSolutions(2);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, 'b.y': 1}, node: {columnScan: {name: 'cs', fields: ['a', 'b']}}}}");
+}
+
+TEST_F(QueryPlannerTest, HintedColumnStoreIndexMustHoldAllReadFields) {
+    params.columnStoreIndices.push_back(
+        IndexEntry(fromjson("{a: 'columnstore', b: 'columnstore'}"), "cs"));
+    runQuerySortProjSkipNToReturnHint(
+        fromjson("{a: 1}"), BSONObj(), fromjson("{b: 1}"), 0, 0, fromjson("{$hint: 'cs'}"));
+    assertNumSolutions(1);
+    assertSolutionExists("{proj: {spec: {b: 1}, node: {columnScan: {name: 'cs'}}}}");
+
+    runInvalidQueryHint(fromjson("{a: 1}"), fromjson("{$hint: 'cs'}"));
+}
+
+//
+// Ordering and pruning candidates with the histograms gathered by the analyze command.
+//
+
+// Returns an index on 'field' whose histogram holds 1000 sampled values, which are all 5 if
+// 'skewed', and 0 to 999 otherwise.
+IndexEntry makeAnalyzedIndex(const std::string& field, bool skewed) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 1000; ++i) {
+        sample.push_back(BSON("" << (skewed ? 5 : i)));
+    }
+    IndexEntry entry(BSON(field << 1), field + "_1");
+    entry.histogram = std::make_shared<IndexHistogram>(IndexHistogram::make(sample, 100));
+    return entry;
+}
+
+TEST_F(QueryPlannerTest, HistogramsPruneCandidatesEstimatedToReadFarMoreKeys) {
+    addIndex(makeAnalyzedIndex("a", true));
+    addIndex(makeAnalyzedIndex("b", false));
+    runQuery(fromjson("{a: 5, b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{fetch: {filter: {a: 5}, node: {ixscan: {pattern: {b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, HistogramsOnlyOrderCandidatesOfQueryWithLimit) {
+    addIndex(makeAnalyzedIndex("a", true));
+    addIndex(makeAnalyzedIndex("b", false));
+    runQuerySortProjSkipNToReturn(fromjson("{a: 5, b: 5}"), BSONObj(), BSONObj(), 0, 10);
+
+    assertNumSolutions(3U);
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {a: 5}, node: {ixscan: {pattern: {b: 1}}}}}", solns[0]->root.get()));
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {b: 5}, node: {ixscan: {pattern: {a: 1}}}}}", solns[1]->root.get()));
+    assertSolutionExists(
+        "{fetch: {filter: {a: 5, b: 5}, node: {andSorted: {nodes: ["
+        "{ixscan: {pattern: {a: 1}}}, {ixscan: {pattern: {b: 1}}}]}}}}");
+}
+
+TEST_F(QueryPlannerTest, HistogramsOnlyOrderCandidatesWhenPruningIsDisabled) {
+    const double oldPruneFactor = internalQueryPlannerHistogramPruneFactor.load();
+    internalQueryPlannerHistogramPruneFactor.store(0);
+
+    addIndex(makeAnalyzedIndex("a", true));
+    addIndex(makeAnalyzedIndex("b", false));
+    runQuery(fromjson("{a: 5, b: 5}"));
+
+    assertNumSolutions(3U);
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {a: 5}, node: {ixscan: {pattern: {b: 1}}}}}", solns[0]->root.get()));
+
+    internalQueryPlannerHistogramPruneFactor.store(oldPruneFactor);
+}
+
+TEST_F(QueryPlannerTest, CandidatesWithoutEstimatesAreNeitherPrunedNorPreferred) {
+    addIndex(makeAnalyzedIndex("a", false));
+    addIndex(BSON("b" << 1), "b_1");
+    runQuery(fromjson("{a: {$gte: 0}, b: 5}"));
+
+    assertNumSolutions(2U);
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {b: 5}, node: {ixscan: {pattern: {a: 1}}}}}", solns[0]->root.get()));
+    assertSolutionExists("{fetch: {filter: {a: {$gte: 0}}, node: {ixscan: {pattern: {b: 1}}}}}");
+}
+
 }  // namespace
@@ -265,7 +265,8 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             return false;
         }
         BSONObj csObj = el.Obj();
-        invariant(bsonObjFieldsAreInSet(csObj, {"dir", "filter", "collation"}));
+        invariant(bsonObjFieldsAreInSet(
+            csObj, {"dir", "filter", "collation", "minRecord", "maxRecord"}));
 
         BSONElement dir = csObj["dir"];
         if (dir.eoo() || !dir.isNumber()) {
@@ -275,6 +276,15 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             return false;
         }
 
+        BSONElement minRecord = csObj["minRecord"];
+        if (minRecord && minRecord.numberLong() != csn->minRecord.repr()) {
+            return false;
+        }
+        BSONElement maxRecord = csObj["maxRecord"];
+        if (maxRecord && maxRecord.numberLong() != csn->maxRecord.repr()) {
+            return false;
+        }
+
         BSONElement filter = csObj["filter"];
         if (filter.eoo()) {
             return true;
@@ -293,6 +303,43 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
         }
 
         return filterMatches(filter.Obj(), collation, trueSoln);
+    } else if (STAGE_COLUMN_SCAN == trueSoln->getType()) {
+        const ColumnScanNode* csn = static_cast<const ColumnScanNode*>(trueSoln);
+        BSONElement el = testSoln["columnScan"];
+        if (el.eoo() || !el.isABSONObj()) {
+            return false;
+        }
+        BSONObj csObj = el.Obj();
+        invariant(bsonObjFieldsAreInSet(csObj, {"name", "fields", "filter"}));
+
+        BSONElement name = csObj["name"];
+        if (name && name.str() != csn->index.identifier.catalogName) {
+            return false;
+        }
+
+        BSONElement fields = csObj["fields"];
+        if (fields) {
+            if (fields.type() != BSONType::Array) {
+                return false;
+            }
+            std::vector<std::string> expectedFields;
+            for (auto&& field : fields.Obj()) {
+                expectedFields.push_back(field.str());
+            }
+            if (expectedFields != csn->fields) {
+                return false;
+            }
+        }
+
+        BSONElement filter = csObj["filter"];
+        if (filter.eoo()) {
+            return true;
+        } else if (filter.isNull()) {
+            return NULL == csn->filter;
+        } else if (!filter.isABSONObj()) {
+            return false;
+        }
+        return filterMatches(filter.Obj(), BSONObj(), trueSoln);
     } else if (STAGE_IXSCAN == trueSoln->getType()) {
         const IndexScanNode* ixn = static_cast<const IndexScanNode*>(trueSoln);
         BSONElement el = testSoln["ixscan"];
@@ -412,6 +459,7 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
                                          "caseSensitive",
                                          "diacriticSensitive",
                                          "prefix",
+                                         "topK",
                                          "collation",
                                          "filter"}));
 
@@ -454,6 +502,14 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             }
         }
 
+        BSONElement topKElt = textObj["topK"];
+        if (!topKElt.eoo()) {
+            if (!topKElt.isNumber() ||
+                static_cast<size_t>(topKElt.numberLong()) != node->topK) {
+                return false;
+            }
+        }
+
         BSONObj collation;
         if (BSONElement collationElt = textObj["collation"]) {
             if (!collationElt.isABSONObj()) {
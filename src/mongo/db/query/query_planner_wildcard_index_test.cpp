@@ -1817,4 +1817,102 @@ TEST_F(QueryPlannerWildcardTest, ContainedOrPushdownWorksWithWildcardIndex) {
         "{$_path: [['a','a',true,true]], a:[[1,1,true,true]]}}}}}");
 }
 
+//
+// Compound $** index tests.
+//
+
+TEST_F(QueryPlannerWildcardTest, CompoundWildcardIndexWithRegularPrefixUsesBoundsOnAllFields) {
+    addWildcardIndex(BSON("tenantId" << 1 << "attrs.$**" << 1));
+
+    runQuery(fromjson("{tenantId: 'x', 'attrs.a': {$gt: 5}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {tenantId: 1, $_path: 1, 'attrs.a': 1},"
+        "bounds: {tenantId: [['x','x',true,true]], $_path: [['attrs.a','attrs.a',true,true]],"
+        "'attrs.a': [[5,Infinity,false,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerWildcardTest, CompoundWildcardIndexWithRegularSuffixUsesBoundsOnAllFields) {
+    addWildcardIndex(BSON("attrs.$**" << 1 << "ts" << 1), {"attrs.b"});
+
+    runQuery(fromjson("{'attrs.b': 3, ts: {$lt: 10}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {$_path: 1, 'attrs.b': 1, ts: 1},"
+        "bounds: {$_path: [['attrs.b','attrs.b',true,true]], 'attrs.b': [[3,3,true,true]],"
+        "ts: [[-Infinity,10,true,false]]}}}}}");
+}
+
+TEST_F(QueryPlannerWildcardTest, CompoundWildcardIndexFillsInUnconstrainedRegularFields) {
+    addWildcardIndex(BSON("attrs.$**" << 1 << "ts" << 1));
+
+    runQuery(fromjson("{'attrs.a': 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {$_path: 1, 'attrs.a': 1, ts: 1},"
+        "bounds: {$_path: [['attrs.a','attrs.a',true,true]], 'attrs.a': [[1,1,true,true]],"
+        "ts: [['MinKey','MaxKey',true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerWildcardTest, CompoundWildcardIndexNotUsedWithoutPredicateOnWildcardPath) {
+    addWildcardIndex(BSON("tenantId" << 1 << "attrs.$**" << 1));
+
+    runQuery(fromjson("{tenantId: 'x'}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+
+    runQuery(fromjson("{tenantId: 'x', 'attrs.a': {$exists: false}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+
+    runQuery(fromjson("{tenantId: {$ne: null}, 'attrs.a': {$exists: false}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerWildcardTest, CompoundWildcardIndexAllowsObjectEqualityOnRegularField) {
+    addWildcardIndex(BSON("tenantId" << 1 << "attrs.$**" << 1));
+
+    runQuery(fromjson("{tenantId: {org: 1}, 'attrs.a': 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {tenantId: 1, $_path: 1, 'attrs.a': 1},"
+        "bounds: {tenantId: [[{org: 1},{org: 1},true,true]],"
+        "$_path: [['attrs.a','attrs.a',true,true]], 'attrs.a': [[1,1,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerWildcardTest, CompoundWildcardIndexCanProvideSortOnWildcardPath) {
+    addWildcardIndex(BSON("tenantId" << 1 << "attrs.$**" << 1));
+
+    runQuerySortProj(
+        fromjson("{tenantId: 'x', 'attrs.a': {$gte: 3}}"), BSON("attrs.a" << 1), BSONObj());
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {node: {ixscan: {pattern: {tenantId: 1, $_path: 1, 'attrs.a': 1},"
+        "bounds: {tenantId: [['x','x',true,true]], $_path: [['attrs.a','attrs.a',true,true]],"
+        "'attrs.a': [[3,Infinity,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerWildcardTest, ExpandingCompoundWildcardIndexRecordsWildcardFieldPosition) {
+    addWildcardIndex(BSON("a" << 1 << "b.$**" << 1 << "c" << 1), {"b.d"});
+
+    std::vector<IndexEntry> expandedIndexes;
+    wcp::expandWildcardIndexEntry(params.indices.back(), {"a", "b.d", "c"}, &expandedIndexes);
+
+    ASSERT_EQ(expandedIndexes.size(), 1U);
+    const auto& entry = expandedIndexes.front();
+    ASSERT_BSONOBJ_EQ(entry.keyPattern, fromjson("{a: 1, 'b.d': 1, c: 1}"));
+    ASSERT_EQ(entry.wildcardFieldPos, 1U);
+    ASSERT_TRUE(entry.multikey);
+    ASSERT_EQ(entry.multikeyPaths.size(), 3U);
+    ASSERT_TRUE(entry.multikeyPaths[0].empty());
+    ASSERT_TRUE(entry.multikeyPaths[1] == std::set<std::size_t>{1U});
+    ASSERT_TRUE(entry.multikeyPaths[2].empty());
+}
+
 }  // namespace mongo
@@ -368,6 +368,14 @@ public:
         _allowPartialResults = allowPartialResults;
     }
 
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
     boost::optional<long long> getReplicationTerm() const {
         return _replicationTerm;
     }
@@ -501,6 +509,10 @@ private:
     bool _exhaust = false;
     bool _allowPartialResults = false;
 
+    // If true, blocking stages such as an unindexed sort may use temporary files rather than
+    // failing when they exceed their memory limit.
+    bool _allowDiskUse = false;
+
     boost::optional<long long> _replicationTerm;
 };
 
@@ -26,6 +26,7 @@
  *    it in the license file.
  */
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/db/query/query_solution.h"
@@ -33,6 +34,7 @@
 #include "mongo/bson/bsontypes.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/field_ref.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/collation/collation_index_key.h"
@@ -202,6 +204,10 @@ void TextNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "diacriticSensitive= " << ftsQuery->getDiacriticSensitive() << '\n';
     addIndent(ss, indent + 1);
     *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+    if (topK > 0) {
+        addIndent(ss, indent + 1);
+        *ss << "topK = " << topK << '\n';
+    }
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->toString();
@@ -216,6 +222,7 @@ QuerySolutionNode* TextNode::clone() const {
     copy->_sort = this->_sort;
     copy->ftsQuery = this->ftsQuery->clone();
     copy->indexPrefix = this->indexPrefix;
+    copy->topK = this->topK;
 
     return copy;
 }
@@ -236,6 +243,12 @@ void CollectionScanNode::appendToString(mongoutils::str::stream* ss, int indent)
         addIndent(ss, indent + 1);
         *ss << "filter = " << filter->toString();
     }
+    if (!minRecord.isNull()) {
+        addIndent(ss, indent + 1);
+        *ss << "minRecord = " << minRecord << '\n';
+        addIndent(ss, indent + 1);
+        *ss << "maxRecord = " << maxRecord << '\n';
+    }
     addCommon(ss, indent);
 }
 
@@ -249,6 +262,50 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->direction = this->direction;
     copy->shouldTrackLatestOplogTimestamp = this->shouldTrackLatestOplogTimestamp;
     copy->shouldWaitForOplogVisibility = this->shouldWaitForOplogVisibility;
+    copy->minRecord = this->minRecord;
+    copy->maxRecord = this->maxRecord;
+
+    return copy;
+}
+
+//
+// ColumnScanNode
+//
+
+ColumnScanNode::ColumnScanNode(IndexEntry index, std::vector<std::string> fields)
+    : _sort(SimpleBSONObjComparator::kInstance.makeBSONObjSet()),
+      index(std::move(index)),
+      fields(std::move(fields)) {}
+
+void ColumnScanNode::appendToString(mongoutils::str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "COLUMN_SCAN\n";
+    addIndent(ss, indent + 1);
+    *ss << "indexName = " << index.identifier.catalogName << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "fields = [";
+    for (size_t i = 0; i < fields.size(); ++i) {
+        *ss << (i == 0 ? "" : ", ") << fields[i];
+    }
+    *ss << "]\n";
+    if (NULL != filter) {
+        addIndent(ss, indent + 1);
+        *ss << "filter = " << filter->toString();
+    }
+    addCommon(ss, indent);
+}
+
+bool ColumnScanNode::hasField(const std::string& field) const {
+    const StringData topLevelField = FieldRef(field).getPart(0);
+    return topLevelField == "_id" ||
+        std::find(fields.begin(), fields.end(), topLevelField) != fields.end();
+}
+
+QuerySolutionNode* ColumnScanNode::clone() const {
+    ColumnScanNode* copy = new ColumnScanNode(index, fields);
+    cloneBaseData(copy);
+
+    copy->_sort = this->_sort;
 
     return copy;
 }
@@ -568,9 +625,11 @@ bool IndexScanNode::hasField(const string& field) const {
 
     size_t keyPatternFieldIndex = 0;
     for (auto&& elt : index.keyPattern) {
-        // For $** indexes, the keyPattern is prefixed by a virtual field, '$_path'. We therefore
-        // skip the first keyPattern field when deciding whether we can provide the requested field.
-        if (index.type == IndexType::INDEX_WILDCARD && !keyPatternFieldIndex) {
+        // For $** indexes, the query path in the keyPattern is preceded by a virtual field,
+        // '$_path'. We therefore skip this field when deciding whether we can provide the requested
+        // field.
+        if (index.type == IndexType::INDEX_WILDCARD &&
+            keyPatternFieldIndex == index.wildcardFieldPos) {
             invariant(elt.fieldNameStringData() == "$_path"_sd);
             ++keyPatternFieldIndex;
             continue;
@@ -37,6 +37,7 @@
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/stage_types.h"
+#include "mongo/db/record_id.h"
 
 namespace mongo {
 
@@ -277,6 +278,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If nonzero, the results are sorted by text score alone and then limited to 'topK' documents,
+    // so only the 'topK' highest scoring documents need to be returned.
+    size_t topK = 0;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -321,6 +326,47 @@ struct CollectionScanNode : public QuerySolutionNode {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // For collections clustered on _id, the inclusive range of RecordIds which can hold matching
+    // documents. See QueryPlannerAccess::getClusteredIdRange(). Null if the range is unbounded.
+    RecordId minRecord;
+    RecordId maxRecord;
+};
+
+/**
+ * Scans the columns of a columnstore index and reassembles the documents of the collection from
+ * them. The documents hold _id followed by 'fields', so the scan can only answer queries that read
+ * no other fields.
+ */
+struct ColumnScanNode : public QuerySolutionNode {
+    ColumnScanNode(IndexEntry index, std::vector<std::string> fields);
+    virtual ~ColumnScanNode() {}
+
+    virtual StageType getType() const {
+        return STAGE_COLUMN_SCAN;
+    }
+
+    virtual void appendToString(mongoutils::str::stream* ss, int indent) const;
+
+    bool fetched() const {
+        return true;
+    }
+    bool hasField(const std::string& field) const;
+    bool sortedByDiskLoc() const {
+        return false;
+    }
+    const BSONObjSet& getSort() const {
+        return _sort;
+    }
+
+    QuerySolutionNode* clone() const;
+
+    BSONObjSet _sort;
+
+    IndexEntry index;
+
+    // The top-level fields to read, in the order of the columns of 'index'.
+    std::vector<std::string> fields;
 };
 
 struct AndHashNode : public QuerySolutionNode {
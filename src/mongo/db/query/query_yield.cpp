@@ -65,8 +65,10 @@ void QueryYield::yieldAllLocks(OperationContext* opCtx,
     // locks). If we are yielding, we are at a safe place to do so.
     opCtx->recoveryUnit()->abandonSnapshot();
 
-    // Track the number of yields in CurOp.
+    // Track the number of yields in CurOp, and publish the storage engine work done so far so that
+    // currentOp can report it.
     CurOp::get(opCtx)->yielded();
+    CurOp::get(opCtx)->updateStorageStats(opCtx);
 
     MONGO_FAIL_POINT_BLOCK(setYieldAllLocksHang, config) {
         StringData ns{config.getData().getStringField("namespace")};
@@ -39,6 +39,7 @@
 #include "mongo/db/exec/and_hash.h"
 #include "mongo/db/exec/and_sorted.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/column_scan.h"
 #include "mongo/db/exec/count_scan.h"
 #include "mongo/db/exec/distinct_scan.h"
 #include "mongo/db/exec/ensure_sorted.h"
@@ -57,6 +58,7 @@
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -81,6 +83,14 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.direction = (csn->direction == 1) ? CollectionScanParams::FORWARD
                                                      : CollectionScanParams::BACKWARD;
             params.shouldWaitForOplogVisibility = csn->shouldWaitForOplogVisibility;
+            if (!csn->minRecord.isNull()) {
+                // The range is bounded by normal RecordIds. Stepping below a minimum of 1 gives
+                // RecordId(), which correctly leaves the scan unbounded as no record precedes it.
+                const bool forward = params.direction == CollectionScanParams::FORWARD;
+                params.scanFrom = forward ? csn->minRecord : csn->maxRecord;
+                params.stop = forward ? RecordId(csn->maxRecord.repr() + 1)
+                                      : RecordId(csn->minRecord.repr() - 1);
+            }
             return new CollectionScan(opCtx, params, ws, csn->filter.get());
         }
         case STAGE_IXSCAN: {
@@ -107,6 +117,19 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.addKeyMetadata = ixn->addKeyMetadata;
             return new IndexScan(opCtx, std::move(params), ws, ixn->filter.get());
         }
+        case STAGE_COLUMN_SCAN: {
+            const ColumnScanNode* csn = static_cast<const ColumnScanNode*>(root);
+
+            if (nullptr == collection) {
+                warning() << "Can't scan columnstore index of null namespace";
+                return nullptr;
+            }
+
+            auto descriptor = collection->getIndexCatalog()->findIndexByName(
+                opCtx, csn->index.identifier.catalogName);
+            invariant(descriptor);
+            return new ColumnScan(opCtx, descriptor, csn->fields, ws, csn->filter.get());
+        }
         case STAGE_FETCH: {
             const FetchNode* fn = static_cast<const FetchNode*>(root);
             PlanStage* childStage = buildStages(opCtx, collection, cq, qsol, fn->children[0], ws);
@@ -125,6 +148,8 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.collection = collection;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            params.allowDiskUse = cq.getQueryRequest().allowDiskUse();
+            params.tempDir = storageGlobalParams.dbpath + "/_tmp";
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -182,6 +207,10 @@ PlanStage* buildStages(OperationContext* opCtx,
         case STAGE_AND_HASH: {
             const AndHashNode* ahn = static_cast<const AndHashNode*>(root);
             auto ret = make_unique<AndHashStage>(opCtx, ws, collection);
+            // Spilling changes the order of the results, which only matters if there is a sort.
+            if (cq.getQueryRequest().allowDiskUse() && cq.getQueryRequest().getSort().isEmpty()) {
+                ret->enableSpilling(storageGlobalParams.dbpath + "/_tmp");
+            }
             for (size_t i = 0; i < ahn->children.size(); ++i) {
                 PlanStage* childStage =
                     buildStages(opCtx, collection, cq, qsol, ahn->children[i], ws);
@@ -289,6 +318,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             // fail in this case (this improvement is being tracked by SERVER-21510).
             params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
             params.wantTextScore = (cq.getProj() && cq.getProj()->wantTextScore());
+            params.topK = node->topK;
             return new TextStage(opCtx, params, ws, node->filter.get());
         }
         case STAGE_SHARDING_FILTER: {
@@ -517,7 +517,8 @@ void checkForIdIndexesAndDropPendingCollections(OperationContext* opCtx, Databas
         if (!coll)
             continue;
 
-        if (coll->getIndexCatalog()->findIdIndex(opCtx))
+        if (coll->getIndexCatalog()->findIdIndex(opCtx) ||
+            coll->getRecordStore()->isClusteredOnId())
             continue;
 
         log() << "WARNING: the collection '" << collectionName << "' lacks a unique index on _id."
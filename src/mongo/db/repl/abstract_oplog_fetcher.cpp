@@ -317,9 +317,20 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
     getMoreBob->appendElements(batchResult.getValue());
 }
 
+Status AbstractOplogFetcher::_waitForBatchProcessing() {
+    return Status::OK();
+}
+
 void AbstractOplogFetcher::_finishCallback(Status status) {
     invariant(isActive());
 
+    // A batch that was still being processed must be done before we report our shutdown. An error
+    // from processing it takes precedence over a successful shutdown.
+    auto batchStatus = _waitForBatchProcessing();
+    if (status.isOK()) {
+        status = batchStatus;
+    }
+
     _onShutdownCallbackFn(status);
 
     decltype(_onShutdownCallbackFn) onShutdownCallbackFn;
@@ -182,6 +182,15 @@ private:
      */
     virtual StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) = 0;
 
+    /**
+     * Function called by the abstract oplog fetcher before it shuts down, to wait for the subclass
+     * to finish processing any batch it is still working on in the background.
+     *
+     * Returns the error, if any, from processing that batch. The default implementation does
+     * nothing.
+     */
+    virtual Status _waitForBatchProcessing();
+
     /**
      * This function creates a Fetcher with the given `find` command and metadata.
      */
@@ -543,6 +543,12 @@ Status applyOps(OperationContext* opCtx,
 
 // static
 MultiApplier::Operations ApplyOps::extractOperations(const OplogEntry& applyOpsOplogEntry) {
+    return extractOperations(applyOpsOplogEntry, applyOpsOplogEntry.toBSON());
+}
+
+// static
+MultiApplier::Operations ApplyOps::extractOperations(const OplogEntry& applyOpsOplogEntry,
+                                                     const BSONObj& topLevelDoc) {
     uassert(ErrorCodes::TypeMismatch,
             str::stream() << "ApplyOps::extractOperations(): not a command: "
                           << redact(applyOpsOplogEntry.toBSON()),
@@ -562,7 +568,6 @@ MultiApplier::Operations ApplyOps::extractOperations(const OplogEntry& applyOpsO
 
     MultiApplier::Operations operations;
 
-    auto topLevelDoc = applyOpsOplogEntry.toBSON();
     for (const auto& elem : operationDocs) {
         auto operationDoc = elem.Obj();
         BSONObjBuilder builder(operationDoc);
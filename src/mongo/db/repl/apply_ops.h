@@ -50,6 +50,15 @@ public:
      * Throws UserException on error.
      */
     static MultiApplier::Operations extractOperations(const OplogEntry& applyOpsOplogEntry);
+
+    /**
+     * Same as above, but completes each operation with the top-level fields, including the
+     * timestamp, of 'topLevelDoc' instead of those of the applyOps entry. Used for the entries of a
+     * transaction written as a chain of applyOps entries, all of whose operations are applied at
+     * the timestamp of the final entry.
+     */
+    static MultiApplier::Operations extractOperations(const OplogEntry& applyOpsOplogEntry,
+                                                      const BSONObj& topLevelDoc);
 };
 
 /**
@@ -38,7 +38,9 @@
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/dbclient_connection.h"
 #include "mongo/client/remote_command_retry_scheduler.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/client.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/repl/oplogreader.h"
@@ -46,6 +48,7 @@
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/fail_point_service.h"
@@ -73,6 +76,20 @@ MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListIndexesAttempts, int, 3);
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionFindAttempts, int, 3);
 // Whether to use the "exhaust cursor" feature when retrieving collection data.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(collectionClonerUsesExhaust, bool, true);
+// The number of _id ranges a large collection is split into, each cloned over its own cursor.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncCollectionClonerRanges, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "initialSyncCollectionClonerRanges must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+// The number of documents a collection needs to have to be cloned in _id ranges.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncCollectionClonerRangeMinDocuments, long long, 1000000);
+
+// The number of _id values sampled for each range a collection is split into.
+const int kSamplesPerRange = 20;
 }  // namespace
 
 // Failpoint which causes initial sync to hang before establishing its cursor to clone the
@@ -264,6 +281,9 @@ void CollectionCloner::_cancelRemainingWork_inlock() {
     if (_queryState == QueryState::kRunning) {
         _queryState = QueryState::kCanceling;
         _clientConnection->shutdownAndDisallowReconnect();
+        for (auto&& rangeConnection : _rangeClientConnections) {
+            rangeConnection->shutdownAndDisallowReconnect();
+        }
     } else {
         _queryState = QueryState::kFinished;
     }
@@ -305,6 +325,28 @@ std::vector<BSONObj> CollectionCloner::getDocumentsToInsert_forTest() {
     return _documentsToInsert;
 }
 
+// static
+std::vector<BSONObj> CollectionCloner::makeRangeBoundaries(std::vector<BSONObj> sampledIds,
+                                                           int numRanges) {
+    if (sampledIds.empty()) {
+        return {};
+    }
+
+    std::sort(sampledIds.begin(),
+              sampledIds.end(),
+              SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    std::vector<BSONObj> boundaries;
+    for (int i = 1; i < numRanges; ++i) {
+        const auto& boundary = sampledIds[sampledIds.size() * i / numRanges];
+        if (boundaries.empty() ||
+            SimpleBSONObjComparator::kInstance.evaluate(boundaries.back() != boundary)) {
+            boundaries.push_back(boundary);
+        }
+    }
+    return boundaries;
+}
+
 void CollectionCloner::_countCallback(
     const executor::TaskExecutor::RemoteCommandCallbackArgs& args) {
 
@@ -490,6 +532,7 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
                     _queryState = QueryState::kFinished;
                     _clientConnection.reset();
+                    _rangeClientConnections.clear();
                 }
                 _condition.notify_all();
             });
@@ -533,16 +576,11 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
     }
 
     _clientConnection = _createClientFn();
-    Status clientConnectionStatus = _clientConnection->connect(_source, StringData());
+    Status clientConnectionStatus = _connectAndAuthenticate(_clientConnection.get());
     if (!clientConnectionStatus.isOK()) {
         _finishCallback(clientConnectionStatus);
         return;
     }
-    if (!replAuthenticate(_clientConnection.get())) {
-        _finishCallback({ErrorCodes::AuthenticationFailed,
-                         str::stream() << "Failed to authenticate to " << _source});
-        return;
-    }
 
     // This completion guard invokes _finishCallback on destruction.
     auto cancelRemainingWorkInLock = [this]() { _cancelRemainingWork_inlock(); };
@@ -550,20 +588,11 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
     auto onCompletionGuard =
         std::make_shared<OnCompletionGuard>(cancelRemainingWorkInLock, finishCallbackFn);
 
-    try {
-        _clientConnection->query(
-            [this, onCompletionGuard](DBClientCursorBatchIterator& iter) {
-                _handleNextBatch(onCompletionGuard, iter);
-            },
-            NamespaceStringOrUUID(_sourceNss.db().toString(), *_options.uuid),
-            Query(),
-            nullptr /* fieldsToReturn */,
-            QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
-                (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
-            _collectionClonerBatchSize);
-    } catch (const DBException& e) {
-        auto queryStatus = e.toStatus().withContext(str::stream() << "Error querying collection '"
-                                                                  << _sourceNss.ns());
+    auto boundaries = _getRangeBoundaries(_clientConnection.get());
+    auto queryStatus = boundaries.empty()
+        ? _queryRange(_clientConnection.get(), BSONObj(), BSONObj(), onCompletionGuard)
+        : _queryRanges(boundaries, onCompletionGuard);
+    if (!queryStatus.isOK()) {
         stdx::unique_lock<stdx::mutex> lock(_mutex);
         if (queryStatus.code() == ErrorCodes::OperationFailed ||
             queryStatus.code() == ErrorCodes::CursorNotFound) {
@@ -584,19 +613,185 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
     onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, Status::OK());
 }
 
+Status CollectionCloner::_connectAndAuthenticate(DBClientConnection* conn) {
+    Status connectStatus = conn->connect(_source, StringData());
+    if (!connectStatus.isOK()) {
+        return connectStatus;
+    }
+    if (!replAuthenticate(conn)) {
+        return {ErrorCodes::AuthenticationFailed,
+                str::stream() << "Failed to authenticate to " << _source};
+    }
+    return Status::OK();
+}
+
+std::vector<BSONObj> CollectionCloner::_getRangeBoundaries(DBClientConnection* conn) {
+    const int numRanges = initialSyncCollectionClonerRanges.load();
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (numRanges < 2 ||
+            _stats.documentToCopy <
+                static_cast<size_t>(initialSyncCollectionClonerRangeMinDocuments.load())) {
+            return {};
+        }
+    }
+
+    // Capped collections must be cloned in their natural order. Without the simple collation, the
+    // order of the _id index is not the order of our comparisons of the sampled _id values.
+    if (_options.capped || _options.autoIndexId == CollectionOptions::NO ||
+        !_options.collation.isEmpty()) {
+        return {};
+    }
+
+    const int sampleSize = numRanges * kSamplesPerRange;
+    BSONObj cmd = BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                                   << BSON_ARRAY(BSON("$sample" << BSON("size" << sampleSize))
+                                                 << BSON("$project" << BSON("_id" << 1)))
+                                   << "cursor"
+                                   << BSON("batchSize" << sampleSize));
+    std::vector<BSONObj> sampledIds;
+    try {
+        BSONObj result;
+        conn->runCommand(_sourceNss.db().toString(), cmd, result, QueryOption_SlaveOk);
+        auto response = CursorResponse::parseFromBSON(result);
+        if (!response.isOK()) {
+            log() << "CollectionCloner ns:" << _destNss
+                  << " could not sample _id values, cloning with a single cursor: "
+                  << redact(response.getStatus());
+            return {};
+        }
+        if (response.getValue().getCursorId()) {
+            conn->killCursor(response.getValue().getNSS(), response.getValue().getCursorId());
+        }
+        for (auto&& doc : response.getValue().getBatch()) {
+            sampledIds.push_back(doc.getOwned());
+        }
+    } catch (const DBException& e) {
+        log() << "CollectionCloner ns:" << _destNss
+              << " could not sample _id values, cloning with a single cursor: "
+              << redact(e.toStatus());
+        return {};
+    }
+
+    if (sampledIds.size() < static_cast<size_t>(sampleSize / 2)) {
+        return {};
+    }
+    return makeRangeBoundaries(std::move(sampledIds), numRanges);
+}
+
+Status CollectionCloner::_queryRange(DBClientConnection* conn,
+                                     const BSONObj& min,
+                                     const BSONObj& max,
+                                     std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    Query query;
+    if (!min.isEmpty() || !max.isEmpty()) {
+        query.hint(BSON("_id" << 1));
+        if (!min.isEmpty()) {
+            query.minKey(min);
+        }
+        if (!max.isEmpty()) {
+            query.maxKey(max);
+        }
+    }
+
+    try {
+        conn->query(
+            [this, onCompletionGuard](DBClientCursorBatchIterator& iter) {
+                _handleNextBatch(onCompletionGuard, iter);
+            },
+            NamespaceStringOrUUID(_sourceNss.db().toString(), *_options.uuid),
+            query,
+            nullptr /* fieldsToReturn */,
+            QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
+                (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
+            _collectionClonerBatchSize);
+    } catch (const DBException& e) {
+        return e.toStatus().withContext(str::stream() << "Error querying collection '"
+                                                      << _sourceNss.ns());
+    }
+    return Status::OK();
+}
+
+Status CollectionCloner::_queryRanges(const std::vector<BSONObj>& boundaries,
+                                      std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    const size_t numRanges = boundaries.size() + 1;
+    log() << "CollectionCloner ns:" << _destNss << " cloning " << numRanges
+          << " _id ranges concurrently";
+
+    // The first range is cloned over the connection the _id values were sampled with.
+    std::vector<DBClientConnection*> connections{_clientConnection.get()};
+    for (size_t i = 1; i < numRanges; ++i) {
+        auto connection = _createClientFn();
+        auto status = _connectAndAuthenticate(connection.get());
+        if (!status.isOK()) {
+            return status;
+        }
+
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (_queryState == QueryState::kCanceling) {
+            return {ErrorCodes::CallbackCanceled, "Collection cloning cancelled."};
+        }
+        connections.push_back(connection.get());
+        _rangeClientConnections.push_back(std::move(connection));
+        _cloningRanges = true;
+    }
+
+    // The first error ends the queries for all other ranges, and is the one we report.
+    Status firstError = Status::OK();
+    auto queryRange = [&](size_t i) {
+        auto status = _queryRange(connections[i],
+                                  i == 0 ? BSONObj() : boundaries[i - 1],
+                                  i == boundaries.size() ? BSONObj() : boundaries[i],
+                                  onCompletionGuard);
+        if (status.isOK()) {
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (firstError.isOK()) {
+            firstError = status;
+            for (auto connection : connections) {
+                connection->shutdownAndDisallowReconnect();
+            }
+        }
+    };
+
+    std::vector<stdx::thread> threads;
+    for (size_t i = 1; i < numRanges; ++i) {
+        threads.emplace_back([&, i] {
+            Client::initThread(std::string(str::stream() << "CollectionClonerRange-" << i));
+            queryRange(i);
+        });
+    }
+    queryRange(0);
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    return firstError;
+}
+
 void CollectionCloner::_handleNextBatch(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
                                         DBClientCursorBatchIterator& iter) {
-    _stats.receivedBatches++;
+    bool scheduleInsert = true;
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stats.receivedBatches++;
         uassert(ErrorCodes::CallbackCanceled,
                 "Collection cloning cancelled.",
                 _queryState != QueryState::kCanceling);
+
+        // With several ranges, documents may already be waiting for an insertion that has been
+        // scheduled but not yet run, and this batch can be inserted along with them.
+        scheduleInsert = !_cloningRanges || _documentsToInsert.empty();
         while (iter.moreInCurrentBatch()) {
             BSONObj o = iter.nextSafe();
             _documentsToInsert.emplace_back(std::move(o));
         }
     }
+    if (!scheduleInsert) {
+        return;
+    }
 
     // Schedule the next document batch insertion.
     auto&& scheduleResult = _scheduleDbWorkFn([=](const executor::TaskExecutor::CallbackArgs& cbd) {
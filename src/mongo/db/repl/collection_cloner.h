@@ -176,6 +176,14 @@ public:
      */
     std::vector<BSONObj> getDocumentsToInsert_forTest();
 
+    /**
+     * Returns the boundaries which split the sampled {_id: <value>} documents in 'sampledIds' into
+     * 'numRanges' ranges of about the same size. The boundaries are sorted and distinct, so there
+     * are fewer than 'numRanges' - 1 of them if there are few distinct samples.
+     */
+    static std::vector<BSONObj> makeRangeBoundaries(std::vector<BSONObj> sampledIds,
+                                                    int numRanges);
+
 private:
     bool _isActive_inlock() const;
 
@@ -217,6 +225,35 @@ private:
      */
     void _runQuery(const executor::TaskExecutor::CallbackArgs& callbackData);
 
+    /**
+     * Connects 'conn' to the sync source and authenticates.
+     */
+    Status _connectAndAuthenticate(DBClientConnection* conn);
+
+    /**
+     * Samples the _id values of the collection over 'conn' to split it into ranges which can be
+     * cloned concurrently. Returns no boundaries if the collection is to be cloned with a single
+     * query.
+     */
+    std::vector<BSONObj> _getRangeBoundaries(DBClientConnection* conn);
+
+    /**
+     * Queries the documents with an _id in the range ['min', 'max') over 'conn', passing each
+     * batch to _handleNextBatch. An empty bound leaves that end of the range open. Returns when
+     * the query is finished or failed.
+     */
+    Status _queryRange(DBClientConnection* conn,
+                       const BSONObj& min,
+                       const BSONObj& max,
+                       std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Queries the ranges between 'boundaries' concurrently, each over its own connection.
+     * Returns the first error any of the queries failed with.
+     */
+    Status _queryRanges(const std::vector<BSONObj>& boundaries,
+                        std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
     /**
      * Put all results from a query batch into a buffer to be inserted, and schedule
      * it to be inserted.
@@ -297,6 +334,11 @@ private:
     // (M) Client connection used for query.
     std::unique_ptr<DBClientConnection> _clientConnection;
 
+    // (M) Client connections used for the queries of all but the first range, when the collection
+    // is cloned in several _id ranges.
+    std::vector<std::unique_ptr<DBClientConnection>> _rangeClientConnections;
+    bool _cloningRanges = false;
+
     // State transitions:
     // PreStart --> Running --> ShuttingDown --> Complete
     // It is possible to skip intermediate states. For example,
@@ -1431,4 +1431,33 @@ TEST_F(CollectionClonerRenamedBeforeStartTest,
     ASSERT_FALSE(collectionCloner->isActive());
 }
 
+TEST(CollectionClonerRangeBoundariesTest, BoundariesSplitSortedSamplesEvenly) {
+    std::vector<BSONObj> sampledIds;
+    for (int i = 11; i >= 0; --i) {
+        sampledIds.push_back(BSON("_id" << i));
+    }
+
+    auto boundaries = CollectionCloner::makeRangeBoundaries(sampledIds, 4);
+    ASSERT_EQUALS(3U, boundaries.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3), boundaries[0]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 6), boundaries[1]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 9), boundaries[2]);
+}
+
+TEST(CollectionClonerRangeBoundariesTest, BoundariesAreDistinct) {
+    std::vector<BSONObj> sampledIds;
+    for (int i = 0; i < 10; ++i) {
+        sampledIds.push_back(BSON("_id" << (i < 8 ? 1 : 2)));
+    }
+
+    auto boundaries = CollectionCloner::makeRangeBoundaries(sampledIds, 5);
+    ASSERT_EQUALS(2U, boundaries.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), boundaries[0]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), boundaries[1]);
+}
+
+TEST(CollectionClonerRangeBoundariesTest, NoBoundariesWithoutSamples) {
+    ASSERT_TRUE(CollectionCloner::makeRangeBoundaries({}, 4).empty());
+}
+
 }  // namespace
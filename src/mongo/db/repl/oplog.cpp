@@ -94,6 +94,7 @@
 #include "mongo/util/file.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/shared_buffer_pool.h"
 #include "mongo/util/startup_test.h"
 
 namespace mongo {
@@ -107,6 +108,11 @@ using std::vector;
 using IndexVersion = IndexDescriptor::IndexVersion;
 
 namespace repl {
+
+// Whether secondaries build the indexes which the primary built in the foreground in the
+// background instead, so that a long index build does not hold up oplog application.
+MONGO_EXPORT_SERVER_PARAMETER(replBuildForegroundIndexesInBackground, bool, false);
+
 namespace {
 
 MONGO_FAIL_POINT_DEFINE(sleepBetweenInsertOpTimeGenerationAndLogOp);
@@ -127,7 +133,10 @@ struct LocalOplogInfo {
     Collection* oplog = nullptr;
 
     // Synchronizes the section where a new Timestamp is generated and when it is registered in the
-    // storage engine.
+    // storage engine. The logical clock reserves timestamps without a lock, but the reservation and
+    // the registration must still happen together: otherwise a later timestamp could be registered
+    // and committed first, and the storage engine would make the oplog visible past the hole left
+    // by the earlier one.
     stdx::mutex newOpMutex;
 
     // Used to generate "h" fields in pv0. Synchronized by newOpMutex.
@@ -158,18 +167,26 @@ void _getNextOpTimes(OperationContext* opCtx,
 
     // Allow the storage engine to start the transaction outside the critical section.
     opCtx->recoveryUnit()->preallocateSnapshot();
-    stdx::lock_guard<stdx::mutex> lk(oplogInfo.newOpMutex);
 
-    auto ts = LogicalClock::get(opCtx)->reserveTicks(count).asTimestamp();
-    const bool orderedCommit = false;
+    Timestamp ts;
+    {
+        stdx::lock_guard<stdx::mutex> lk(oplogInfo.newOpMutex);
+
+        ts = LogicalClock::get(opCtx)->reserveTicks(count).asTimestamp();
+        const bool orderedCommit = false;
+
+        if (persist) {
+            fassert(28560,
+                    oplog->getRecordStore()->oplogDiskLocRegister(opCtx, ts, orderedCommit));
+        }
 
-    if (persist) {
-        fassert(28560, oplog->getRecordStore()->oplogDiskLocRegister(opCtx, ts, orderedCommit));
+        for (std::size_t i = 0; i < count; i++) {
+            slotsOut[i].hash = oplogInfo.hashGenerator.nextInt64();
+        }
     }
 
     for (std::size_t i = 0; i < count; i++) {
         slotsOut[i].opTime = {Timestamp(ts.asULL() + i), term};
-        slotsOut[i].hash = oplogInfo.hashGenerator.nextInt64();
     }
 }
 
@@ -184,6 +201,14 @@ public:
     OplogDocWriter(BSONObj frame, BSONObj oField)
         : _frame(std::move(frame)), _oField(std::move(oField)) {}
 
+    OplogDocWriter(OplogDocWriter&&) = default;
+
+    ~OplogDocWriter() {
+        // The frame is built in a pooled buffer by _logOpWriter(). Once the entry has been copied
+        // into the oplog nobody else refers to it, so it can be reused for the next entry.
+        SharedBufferPool::recycle(_frame.releaseSharedBuffer());
+    }
+
     void writeDocument(char* start) const {
         char* buf = start;
 
@@ -241,7 +266,10 @@ void createIndexForApplyOps(OperationContext* opCtx,
 
     bool relaxIndexConstraints =
         ReplicationCoordinator::get(opCtx)->shouldRelaxIndexConstraints(opCtx, indexNss);
-    if (indexSpec["background"].trueValue()) {
+    const bool buildInBackground = indexSpec["background"].trueValue() ||
+        (mode == OplogApplication::Mode::kSecondary &&
+         replBuildForegroundIndexesInBackground.load());
+    if (buildInBackground) {
         if (mode == OplogApplication::Mode::kRecovering) {
             LOG(3) << "apply op: building background index " << indexSpec
                    << " in the foreground because the node is in recovery";
@@ -314,6 +342,11 @@ void appendSessionInfo(OperationContext* opCtx,
         oplogLink.postImageOpTime.append(builder,
                                          OplogEntryBase::kPostImageOpTimeFieldName.toString());
     }
+
+    if (oplogLink.needsRetryImage) {
+        builder->append(OplogEntryBase::kNeedsRetryImageFieldName,
+                        RetryImage_serializer(*oplogLink.needsRetryImage));
+    }
 }
 
 OplogDocWriter _logOpWriter(OperationContext* opCtx,
@@ -330,7 +363,7 @@ OplogDocWriter _logOpWriter(OperationContext* opCtx,
                             StmtId statementId,
                             const OplogLink& oplogLink,
                             bool prepare) {
-    BSONObjBuilder b(256);
+    BSONObjBuilder b(SharedBufferPool::acquire(256));
 
     b.append("ts", optime.getTimestamp());
     if (optime.getTerm() != -1)
@@ -592,6 +625,35 @@ std::vector<OpTime> logInsertOps(OperationContext* opCtx,
     return opTimes;
 }
 
+void writeRetryImageEntry(OperationContext* opCtx, const ImageEntry& imageEntry) {
+    UnreplicatedWritesBlock unreplicatedWritesBlock(opCtx);
+    AutoGetCollection autoColl(opCtx, NamespaceString::kConfigImagesNamespace, MODE_IX);
+    auto collection = autoColl.getCollection();
+    if (!collection) {
+        return;
+    }
+
+    // Writers applying a batch of the oplog may reach the writes of a session out of order, so
+    // only the image of the latest write of each session is kept.
+    const auto idQuery = BSON("_id" << imageEntry.getSessionId().toBSON());
+    const auto recordId = Helpers::findById(opCtx, collection, idQuery);
+    if (!recordId.isNull()) {
+        const auto existing = collection->docFor(opCtx, recordId).value();
+        if (existing[ImageEntry::kTimestampFieldName].timestamp() > imageEntry.getTimestamp()) {
+            return;
+        }
+    }
+
+    UpdateRequest request(NamespaceString::kConfigImagesNamespace);
+    request.setQuery(idQuery);
+    request.setUpdates(imageEntry.toBSON());
+    request.setUpsert();
+    UpdateLifecycleImpl updateLifecycle(NamespaceString::kConfigImagesNamespace);
+    request.setLifecycle(&updateLifecycle);
+
+    update(opCtx, autoColl.getDb(), request);
+}
+
 namespace {
 long long getNewOplogSizeBytes(OperationContext* opCtx, const ReplSettings& replSettings) {
     if (replSettings.getOplogSizeBytes() != 0) {
@@ -1032,6 +1094,51 @@ std::map<std::string, ApplyOpMetadata> opsMap = {
      }}},
 };
 
+/**
+ * Returns which image of the document a retry of the findAndModify in 'op' returns, if the
+ * primary stored that image in the image collection rather than in the oplog.
+ */
+boost::optional<RetryImageEnum> getRetryImageKind(const BSONObj& op,
+                                                  OplogApplication::Mode mode) {
+    const auto elem = op[OplogEntryBase::kNeedsRetryImageFieldName];
+    if (elem.eoo() || mode == OplogApplication::Mode::kApplyOpsCmd) {
+        return boost::none;
+    }
+    return RetryImage_parse(IDLParserErrorContext("needsRetryImage"), elem.valueStringData());
+}
+
+/**
+ * Writes the current version of the document with _id 'idQuery' to the image collection, as the
+ * image of the findAndModify in 'op'. A pre-image must therefore be written before 'op' is applied
+ * and a post-image after. Initial sync may apply 'op' to a later version of the document than the
+ * primary did, so the images it writes are marked as invalidated.
+ */
+void writeRetryImageForOp(OperationContext* opCtx,
+                          Collection* collection,
+                          const BSONObj& op,
+                          const BSONObj& idQuery,
+                          RetryImageEnum imageKind,
+                          OplogApplication::Mode mode) {
+    if (!collection) {
+        return;
+    }
+
+    const auto recordId = Helpers::findById(opCtx, collection, idQuery);
+    if (recordId.isNull()) {
+        return;
+    }
+
+    const auto sessionInfo =
+        OperationSessionInfo::parse(IDLParserErrorContext("retry image"), op);
+    ImageEntry imageEntry(*sessionInfo.getSessionId(),
+                          *sessionInfo.getTxnNumber(),
+                          op[OplogEntryBase::kTimestampFieldName].timestamp(),
+                          imageKind,
+                          collection->docFor(opCtx, recordId).value().getOwned());
+    imageEntry.setInvalidated(mode == OplogApplication::Mode::kInitialSync);
+    writeRetryImageEntry(opCtx, imageEntry);
+}
+
 }  // namespace
 
 constexpr StringData OplogApplication::kInitialSyncOplogApplicationMode;
@@ -1423,6 +1530,8 @@ Status applyOperation_inlock(OperationContext* opCtx,
             timestamp = fieldTs.timestamp();
         }
 
+        const auto retryImageKind = getRetryImageKind(op, mode);
+
         const StringData ns = fieldNs.valuestrsafe();
         auto status = writeConflictRetry(opCtx, "applyOps_update", ns, [&] {
             WriteUnitOfWork wuow(opCtx);
@@ -1430,6 +1539,11 @@ Status applyOperation_inlock(OperationContext* opCtx,
                 uassertStatusOK(opCtx->recoveryUnit()->setTimestamp(timestamp));
             }
 
+            if (retryImageKind == RetryImageEnum::kPreImage) {
+                writeRetryImageForOp(
+                    opCtx, collection, op, updateCriteria, *retryImageKind, mode);
+            }
+
             UpdateResult ur = update(opCtx, db, request);
             if (ur.numMatched == 0 && ur.upserted.isEmpty()) {
                 if (ur.modifiers) {
@@ -1470,6 +1584,11 @@ Status applyOperation_inlock(OperationContext* opCtx,
                 }
             }
 
+            if (retryImageKind == RetryImageEnum::kPostImage) {
+                writeRetryImageForOp(
+                    opCtx, collection, op, updateCriteria, *retryImageKind, mode);
+            }
+
             wuow.commit();
             return Status::OK();
         });
@@ -1498,6 +1617,8 @@ Status applyOperation_inlock(OperationContext* opCtx,
             timestamp = fieldTs.timestamp();
         }
 
+        const auto retryImageKind = getRetryImageKind(op, mode);
+
         const StringData ns = fieldNs.valuestrsafe();
         writeConflictRetry(opCtx, "applyOps_delete", ns, [&] {
             WriteUnitOfWork wuow(opCtx);
@@ -1505,6 +1626,11 @@ Status applyOperation_inlock(OperationContext* opCtx,
                 uassertStatusOK(opCtx->recoveryUnit()->setTimestamp(timestamp));
             }
 
+            if (retryImageKind) {
+                writeRetryImageForOp(
+                    opCtx, collection, op, deleteCriteria, *retryImageKind, mode);
+            }
+
             if (opType[1] == 0) {
                 const auto justOne = true;
                 deleteObjects(opCtx, collection, requestNss, deleteCriteria, justOne);
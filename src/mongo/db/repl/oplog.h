@@ -37,6 +37,7 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/logical_session_id.h"
+#include "mongo/db/repl/image_collection_entry_gen.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -82,6 +83,9 @@ struct OplogLink {
     OpTime prevOpTime;
     OpTime preImageOpTime;
     OpTime postImageOpTime;
+
+    // Set instead of the image optimes when the image is written to the image collection.
+    boost::optional<RetryImageEnum> needsRetryImage;
 };
 
 /**
@@ -147,6 +151,13 @@ OpTime logOp(OperationContext* opCtx,
              bool prepare,
              const OplogSlot& oplogSlot);
 
+/**
+ * Writes 'imageEntry' to the image collection, in place of the image already stored there for the
+ * same session unless that one is of a later write. The write is never replicated, since each
+ * node derives the image itself. Does nothing if the image collection does not exist.
+ */
+void writeRetryImageEntry(OperationContext* opCtx, const ImageEntry& imageEntry);
+
 // Flush out the cached pointer to the oplog.
 // Used by the closeDatabase command to ensure we don't cache closed things.
 void oplogCheckCloseDatabase(OperationContext* opCtx, Database* db);
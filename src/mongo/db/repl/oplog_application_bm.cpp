@@ -0,0 +1,306 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/repl/idempotency_test_fixture.h"
+#include "mongo/db/repl/oplog_applier.h"
+#include "mongo/db/repl/sync_tail.h"
+#include "mongo/db/repl/sync_tail_test_fixture.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+// The number of operations applied by each iteration of a benchmark.
+const int kBatchSize = 1000;
+
+// CRUD operations are spread over this many collections.
+const int kNumCollections = 4;
+
+// The shapes of oplog batch the benchmarks apply, selected by state.range(0).
+enum class Workload : int {
+    kInsert = 0,
+    kUpdateSet = 1,
+    kUpdateInc = 2,
+    // Rotates between $set, $inc, $unset and a capped $push.
+    kUpdateMixed = 3,
+    kDelete = 4,
+    // Alternating create and drop commands, each in a batch of its own as the batcher would do.
+    kCommand = 5,
+    // applyOps entries of ten inserts each, as written by a committed transaction.
+    kApplyOps = 6,
+};
+
+NamespaceString collectionNss(int i) {
+    return NamespaceString("bm", "coll" + std::to_string(i % kNumCollections));
+}
+
+BSONObj makeDoc(int id) {
+    return BSON("_id" << id << "x" << id << "s"
+                      << "some string value"
+                      << "arr"
+                      << BSON_ARRAY(1 << 2 << 3));
+}
+
+/**
+ * Sets up a mongod with an oplog and a SyncTail that applies batches with 'numWriters' writer
+ * threads, and accumulates how long each phase of the timed batches took.
+ */
+class OplogApplicationBenchmarkFixture : public SyncTailTest {
+public:
+    explicit OplogApplicationBenchmarkFixture(int numWriters) {
+        setUp();
+        for (int i = 0; i < kNumCollections; ++i) {
+            uassertStatusOK(getStorageInterface()->createCollection(
+                _opCtx.get(), collectionNss(i), CollectionOptions()));
+        }
+        _writerPool = OplogApplier::makeWriterPool(numWriters);
+        _syncTail = stdx::make_unique<SyncTail>(nullptr,
+                                                getConsistencyMarkers(),
+                                                getStorageInterface(),
+                                                multiSyncApply,
+                                                _writerPool.get());
+    }
+
+    ~OplogApplicationBenchmarkFixture() {
+        _syncTail.reset();
+        _writerPool.reset();
+        tearDown();
+    }
+
+    OpTime nextOpTime() {
+        return SyncTailTest::nextOpTime();
+    }
+
+    /**
+     * Applies 'ops' as one batch without attributing its time to any phase.
+     */
+    void apply(MultiApplier::Operations ops) {
+        uassertStatusOK(_syncTail->multiApply(_opCtx.get(), std::move(ops)));
+    }
+
+    /**
+     * Applies 'ops' as one batch, waits for it to become durable as the steady state applier
+     * does, and attributes the time spent to each phase.
+     */
+    void applyTimed(MultiApplier::Operations ops) {
+        const auto before = _syncTail->getPhaseTimes();
+        apply(std::move(ops));
+        const auto after = _syncTail->getPhaseTimes();
+
+        Timer journalTimer;
+        _opCtx->recoveryUnit()->waitUntilDurable();
+        _journal += Microseconds(journalTimer.micros());
+
+        _writeOplog += after.writeOplog - before.writeOplog;
+        _fillWriterVectors += after.fillWriterVectors - before.fillWriterVectors;
+        _applyOps += after.applyOps - before.applyOps;
+    }
+
+    /**
+     * Reports the average time per batch of each phase as counters on 'state'.
+     */
+    void reportPhases(benchmark::State& state, int batchesPerIteration) const {
+        const double numBatches = static_cast<double>(state.iterations()) * batchesPerIteration;
+        state.counters["writeOplogMicros"] = durationCount<Microseconds>(_writeOplog) / numBatches;
+        state.counters["fillWriterVectorsMicros"] =
+            durationCount<Microseconds>(_fillWriterVectors) / numBatches;
+        state.counters["applyOpsMicros"] = durationCount<Microseconds>(_applyOps) / numBatches;
+        state.counters["journalMicros"] = durationCount<Microseconds>(_journal) / numBatches;
+    }
+
+private:
+    void _doTest() override {}
+
+    std::unique_ptr<ThreadPool> _writerPool;
+    std::unique_ptr<SyncTail> _syncTail;
+
+    Microseconds _writeOplog{0};
+    Microseconds _fillWriterVectors{0};
+    Microseconds _applyOps{0};
+    Microseconds _journal{0};
+};
+
+MultiApplier::Operations makeInserts(OplogApplicationBenchmarkFixture* fixture, int firstId) {
+    MultiApplier::Operations ops;
+    for (int i = 0; i < kBatchSize; ++i) {
+        const int id = firstId + i;
+        ops.push_back(
+            makeInsertDocumentOplogEntry(fixture->nextOpTime(), collectionNss(id), makeDoc(id)));
+    }
+    return ops;
+}
+
+BSONObj makeUpdateModifier(Workload workload, int iteration, int i) {
+    const int modifier = workload == Workload::kUpdateSet
+        ? 0
+        : workload == Workload::kUpdateInc ? 1 : i % 4;
+    switch (modifier) {
+        case 0:
+            return BSON("$set" << BSON("x" << iteration));
+        case 1:
+            return BSON("$inc" << BSON("x" << 1));
+        case 2:
+            return BSON("$unset" << BSON("s" << true));
+        default:
+            return BSON("$push" << BSON("arr" << BSON("$each" << BSON_ARRAY(iteration) << "$slice"
+                                                               << -8)));
+    }
+}
+
+MultiApplier::Operations makeUpdates(OplogApplicationBenchmarkFixture* fixture,
+                                     Workload workload,
+                                     int iteration) {
+    MultiApplier::Operations ops;
+    for (int id = 0; id < kBatchSize; ++id) {
+        ops.push_back(makeUpdateDocumentOplogEntry(fixture->nextOpTime(),
+                                                   collectionNss(id),
+                                                   BSON("_id" << id),
+                                                   makeUpdateModifier(workload, iteration, id)));
+    }
+    return ops;
+}
+
+MultiApplier::Operations makeDeletes(OplogApplicationBenchmarkFixture* fixture, int firstId) {
+    MultiApplier::Operations ops;
+    for (int i = 0; i < kBatchSize; ++i) {
+        const int id = firstId + i;
+        ops.push_back(makeDeleteDocumentOplogEntry(
+            fixture->nextOpTime(), collectionNss(id), BSON("_id" << id)));
+    }
+    return ops;
+}
+
+MultiApplier::Operations makeApplyOps(OplogApplicationBenchmarkFixture* fixture, int firstId) {
+    const int kOpsPerApplyOps = 10;
+    MultiApplier::Operations ops;
+    for (int i = 0; i < kBatchSize; i += kOpsPerApplyOps) {
+        BSONArrayBuilder innerOps;
+        for (int j = 0; j < kOpsPerApplyOps; ++j) {
+            const int id = firstId + i + j;
+            innerOps.append(BSON("op"
+                                 << "i"
+                                 << "ns"
+                                 << collectionNss(id).ns()
+                                 << "o"
+                                 << makeDoc(id)));
+        }
+        ops.push_back(makeCommandOplogEntry(fixture->nextOpTime(),
+                                            NamespaceString(NamespaceString::kAdminDb, "$cmd"),
+                                            BSON("applyOps" << innerOps.arr())));
+    }
+    return ops;
+}
+
+/**
+ * Registers each workload with 1, 4 and 16 writer threads.
+ */
+void oplogApplicationArgs(benchmark::internal::Benchmark* b) {
+    for (int workload = 0; workload <= static_cast<int>(Workload::kApplyOps); ++workload) {
+        for (int numWriters : {1, 4, 16}) {
+            b->Args({workload, numWriters});
+        }
+    }
+}
+
+void BM_multiApply(benchmark::State& state) {
+    const auto workload = static_cast<Workload>(state.range(0));
+    OplogApplicationBenchmarkFixture fixture(state.range(1));
+
+    // Updates apply to a fixed set of documents, which must exist beforehand.
+    if (workload == Workload::kUpdateSet || workload == Workload::kUpdateInc ||
+        workload == Workload::kUpdateMixed) {
+        fixture.apply(makeInserts(&fixture, 0));
+    }
+
+    int iteration = 0;
+    int nextId = 0;
+    int batchesPerIteration = 1;
+    for (auto _ : state) {
+        state.PauseTiming();
+        switch (workload) {
+            case Workload::kInsert: {
+                auto ops = makeInserts(&fixture, nextId);
+                state.ResumeTiming();
+                fixture.applyTimed(std::move(ops));
+                break;
+            }
+            case Workload::kUpdateSet:
+            case Workload::kUpdateInc:
+            case Workload::kUpdateMixed: {
+                auto ops = makeUpdates(&fixture, workload, iteration);
+                state.ResumeTiming();
+                fixture.applyTimed(std::move(ops));
+                break;
+            }
+            case Workload::kDelete: {
+                fixture.apply(makeInserts(&fixture, nextId));
+                auto ops = makeDeletes(&fixture, nextId);
+                state.ResumeTiming();
+                fixture.applyTimed(std::move(ops));
+                break;
+            }
+            case Workload::kCommand: {
+                std::vector<MultiApplier::Operations> batches;
+                for (int i = 0; i < kBatchSize; ++i) {
+                    const NamespaceString nss("bm", "cmd" + std::to_string(i / 2));
+                    const auto command =
+                        i % 2 == 0 ? BSON("create" << nss.coll()) : BSON("drop" << nss.coll());
+                    batches.push_back({makeCommandOplogEntry(fixture.nextOpTime(), nss, command)});
+                }
+                batchesPerIteration = kBatchSize;
+                state.ResumeTiming();
+                for (auto&& batch : batches) {
+                    fixture.applyTimed(std::move(batch));
+                }
+                break;
+            }
+            case Workload::kApplyOps: {
+                auto ops = makeApplyOps(&fixture, nextId);
+                state.ResumeTiming();
+                fixture.applyTimed(std::move(ops));
+                break;
+            }
+        }
+        ++iteration;
+        nextId += kBatchSize;
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+    fixture.reportPhases(state, batchesPerIteration);
+}
+
+BENCHMARK(BM_multiApply)->Apply(oplogApplicationArgs)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -55,6 +55,12 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replWriterThreadCount, int, 16)
         return Status::OK();
     });
 
+/**
+ * If set, the writer pool gives each writer thread its own task queue and lets idle writers steal
+ * from busy ones, instead of sharing a single queue.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replWriterUseWorkStealingPool, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(replBatchLimitOperations, int, 5 * 1000)
     ->withValidator([](const int& newVal) {
         if (newVal < 1 || newVal > (1000 * 1000)) {
@@ -80,6 +86,7 @@ std::unique_ptr<ThreadPool> OplogApplier::makeWriterPool(int threadCount) {
     options.threadNamePrefix = "repl writer worker ";
     options.poolName = "repl writer worker Pool";
     options.maxThreads = options.minThreads = static_cast<size_t>(threadCount);
+    options.useWorkStealing = replWriterUseWorkStealingPool;
     options.onCreateThread = [](const std::string&) {
         // Only do this once per thread
         if (!Client::getCurrent()) {
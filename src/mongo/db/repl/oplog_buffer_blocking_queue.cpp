@@ -30,6 +30,8 @@
 
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 
+#include <iterator>
+
 namespace mongo {
 namespace repl {
 
@@ -38,6 +40,9 @@ namespace {
 // Limit buffer to 256MB
 const size_t kOplogBufferSize = 256 * 1024 * 1024;
 
+// Number of slots the ring starts out with. Must be a power of two.
+const size_t kInitialCapacity = 1024;
+
 size_t getDocumentSize(const BSONObj& o) {
     // SERVER-9808 Avoid Fortify complaint about implicit signed->unsigned conversion
     return static_cast<size_t>(o.objsize());
@@ -47,7 +52,7 @@ size_t getDocumentSize(const BSONObj& o) {
 
 OplogBufferBlockingQueue::OplogBufferBlockingQueue() : OplogBufferBlockingQueue(nullptr) {}
 OplogBufferBlockingQueue::OplogBufferBlockingQueue(Counters* counters)
-    : _counters(counters), _queue(kOplogBufferSize, &getDocumentSize) {}
+    : _counters(counters), _slots(kInitialCapacity) {}
 
 void OplogBufferBlockingQueue::startup(OperationContext*) {
     // Update server status metric to reflect the current oplog buffer's max size.
@@ -61,14 +66,23 @@ void OplogBufferBlockingQueue::shutdown(OperationContext* opCtx) {
 }
 
 void OplogBufferBlockingQueue::pushEvenIfFull(OperationContext*, const Value& value) {
-    _queue.pushEvenIfFull(value);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_producerMutex);
+        _pushAll_inlock(&value, &value + 1);
+    }
+    _notifyDataWaiters();
     if (_counters) {
         _counters->increment(value);
     }
 }
 
 void OplogBufferBlockingQueue::push(OperationContext*, const Value& value) {
-    _queue.push(value);
+    _waitForSpace(getDocumentSize(value));
+    {
+        stdx::lock_guard<stdx::mutex> lk(_producerMutex);
+        _pushAll_inlock(&value, &value + 1);
+    }
+    _notifyDataWaiters();
     if (_counters) {
         _counters->increment(value);
     }
@@ -77,7 +91,11 @@ void OplogBufferBlockingQueue::push(OperationContext*, const Value& value) {
 void OplogBufferBlockingQueue::pushAllNonBlocking(OperationContext*,
                                                   Batch::const_iterator begin,
                                                   Batch::const_iterator end) {
-    _queue.pushAllNonBlocking(begin, end);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_producerMutex);
+        _pushAll_inlock(begin, end);
+    }
+    _notifyDataWaiters();
     if (_counters) {
         for (auto i = begin; i != end; ++i) {
             _counters->increment(*i);
@@ -86,11 +104,11 @@ void OplogBufferBlockingQueue::pushAllNonBlocking(OperationContext*,
 }
 
 void OplogBufferBlockingQueue::waitForSpace(OperationContext*, std::size_t size) {
-    _queue.waitForSpace(size);
+    _waitForSpace(size);
 }
 
 bool OplogBufferBlockingQueue::isEmpty() const {
-    return _queue.empty();
+    return _head.load() == _tail.load();
 }
 
 std::size_t OplogBufferBlockingQueue::getMaxSize() const {
@@ -98,24 +116,50 @@ std::size_t OplogBufferBlockingQueue::getMaxSize() const {
 }
 
 std::size_t OplogBufferBlockingQueue::getSize() const {
-    return _queue.size();
+    return _size.load();
 }
 
 std::size_t OplogBufferBlockingQueue::getCount() const {
-    return _queue.count();
+    // Load '_head' first so that a concurrent pop cannot make it pass the '_tail' we read.
+    const auto head = _head.load();
+    return _tail.load() - head;
 }
 
 void OplogBufferBlockingQueue::clear(OperationContext*) {
-    _queue.clear();
+    {
+        stdx::lock_guard<stdx::mutex> producerLock(_producerMutex);
+        stdx::lock_guard<stdx::mutex> consumerLock(_consumerMutex);
+        const auto mask = _slots.size() - 1;
+        const auto tail = _tail.load();
+        for (auto i = _head.load(); i != tail; ++i) {
+            _slots[i & mask] = BSONObj();
+        }
+        _head.store(tail);
+        _size.store(0);
+    }
+    {
+        stdx::lock_guard<stdx::mutex> lk(_waitMutex);
+        ++_clearCount;
+        _noLongerEmpty.notify_all();
+        _noLongerFull.notify_all();
+    }
     if (_counters) {
         _counters->clear();
     }
 }
 
 bool OplogBufferBlockingQueue::tryPop(OperationContext*, Value* value) {
-    if (!_queue.tryPop(*value)) {
-        return false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+        const auto head = _head.load();
+        if (head == _tail.load()) {
+            return false;
+        }
+        *value = std::move(_slots[head & (_slots.size() - 1)]);
+        _head.store(head + 1);
+        _size.fetchAndSubtract(getDocumentSize(*value));
     }
+    _notifySpaceWaiters();
     if (_counters) {
         _counters->decrement(*value);
     }
@@ -123,17 +167,105 @@ bool OplogBufferBlockingQueue::tryPop(OperationContext*, Value* value) {
 }
 
 bool OplogBufferBlockingQueue::waitForData(Seconds waitDuration) {
-    Value ignored;
-    return _queue.blockingPeek(ignored, static_cast<int>(durationCount<Seconds>(waitDuration)));
+    stdx::unique_lock<stdx::mutex> lk(_waitMutex);
+    const auto clearCount = _clearCount;
+    _dataWaiters.fetchAndAdd(1);
+    _noLongerEmpty.wait_for(lk, waitDuration.toSystemDuration(), [&] {
+        return !isEmpty() || _clearCount != clearCount;
+    });
+    _dataWaiters.fetchAndSubtract(1);
+    return _clearCount == clearCount && !isEmpty();
 }
 
 bool OplogBufferBlockingQueue::peek(OperationContext*, Value* value) {
-    return _queue.peek(*value);
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    const auto head = _head.load();
+    if (head == _tail.load()) {
+        return false;
+    }
+    *value = _slots[head & (_slots.size() - 1)];
+    return true;
 }
 
 boost::optional<OplogBuffer::Value> OplogBufferBlockingQueue::lastObjectPushed(
     OperationContext*) const {
-    return _queue.lastObjectPushed();
+    stdx::lock_guard<stdx::mutex> producerLock(_producerMutex);
+    stdx::lock_guard<stdx::mutex> consumerLock(_consumerMutex);
+    const auto tail = _tail.load();
+    if (_head.load() == tail) {
+        return boost::none;
+    }
+    return _slots[(tail - 1) & (_slots.size() - 1)];
+}
+
+template <typename Iterator>
+void OplogBufferBlockingQueue::_pushAll_inlock(Iterator begin, Iterator end) {
+    const auto count = static_cast<std::size_t>(std::distance(begin, end));
+    if (count == 0) {
+        return;
+    }
+
+    // Only the producer advances '_tail'. A stale '_head' can only overestimate how many
+    // operations are buffered, so at worst the ring grows a little early.
+    auto tail = _tail.load();
+    if (tail - _head.load() + count > _slots.size()) {
+        _grow_inlock(tail - _head.load() + count);
+    }
+
+    const auto mask = _slots.size() - 1;
+    std::size_t bytes = 0;
+    for (auto i = begin; i != end; ++i, ++tail) {
+        _slots[tail & mask] = *i;
+        bytes += getDocumentSize(*i);
+    }
+
+    // Account for the new operations before publishing them so that a concurrent pop can never
+    // make '_size' wrap around.
+    _size.fetchAndAdd(bytes);
+    _tail.store(tail);
+}
+
+void OplogBufferBlockingQueue::_grow_inlock(std::size_t minCapacity) {
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    auto newCapacity = _slots.size();
+    while (newCapacity < minCapacity) {
+        newCapacity *= 2;
+    }
+    if (newCapacity == _slots.size()) {
+        return;
+    }
+
+    std::vector<BSONObj> newSlots(newCapacity);
+    const auto oldMask = _slots.size() - 1;
+    const auto newMask = newCapacity - 1;
+    const auto tail = _tail.load();
+    for (auto i = _head.load(); i != tail; ++i) {
+        newSlots[i & newMask] = std::move(_slots[i & oldMask]);
+    }
+    _slots.swap(newSlots);
+}
+
+void OplogBufferBlockingQueue::_waitForSpace(std::size_t size) {
+    stdx::unique_lock<stdx::mutex> lk(_waitMutex);
+    _spaceWaiters.fetchAndAdd(1);
+    _noLongerFull.wait(lk, [&] { return _size.load() + size <= kOplogBufferSize; });
+    _spaceWaiters.fetchAndSubtract(1);
+}
+
+void OplogBufferBlockingQueue::_notifyDataWaiters() {
+    // A waiter registers itself before checking for data under '_waitMutex', so if it is not
+    // visible here it is guaranteed to see the operations that were just published.
+    if (_dataWaiters.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_waitMutex);
+        _noLongerEmpty.notify_all();
+    }
+}
+
+void OplogBufferBlockingQueue::_notifySpaceWaiters() {
+    if (_spaceWaiters.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_waitMutex);
+        _noLongerFull.notify_all();
+    }
 }
 
 }  // namespace repl
@@ -28,14 +28,25 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/repl/oplog_buffer.h"
-#include "mongo/util/queue.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 namespace repl {
 
 /**
- * Oplog buffer backed by in memory blocking queue of BSONObj.
+ * Oplog buffer backed by an in memory ring of BSONObj.
+ *
+ * The buffer has a single producer (the oplog fetcher) and a single consumer (the applier). The
+ * producer and consumer sides are guarded by separate mutexes and hand operations over through
+ * the atomic '_head' and '_tail' positions, so pushing a batch never contends with popping. Only
+ * growing the ring, clear() and lastObjectPushed() take both mutexes (producer mutex first).
+ * Threads blocked waiting for space or data sleep on '_waitMutex', which the other side only
+ * acquires when a waiter has registered itself.
  */
 class OplogBufferBlockingQueue final : public OplogBuffer {
 public:
@@ -61,8 +72,59 @@ public:
     boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
 
 private:
+    /**
+     * Appends the operations in [begin, end) to the ring and publishes them to the consumer with
+     * a single update of '_tail'. Caller must hold '_producerMutex'.
+     */
+    template <typename Iterator>
+    void _pushAll_inlock(Iterator begin, Iterator end);
+
+    /**
+     * Reallocates the ring so that it can hold at least 'minCapacity' operations.
+     * Caller must hold '_producerMutex'.
+     */
+    void _grow_inlock(std::size_t minCapacity);
+
+    /**
+     * Blocks until the buffered operations plus 'size' bytes fit in the buffer.
+     */
+    void _waitForSpace(std::size_t size);
+
+    /**
+     * Wakes threads waiting in waitForData() or _waitForSpace(), but only if there are any.
+     */
+    void _notifyDataWaiters();
+    void _notifySpaceWaiters();
+
     Counters* const _counters;
-    BlockingQueue<BSONObj> _queue;
+
+    // Serializes producers. Guards writes to '_slots' at positions at or after '_tail'.
+    mutable stdx::mutex _producerMutex;
+
+    // Serializes consumers. Guards reads of '_slots' at positions before '_tail'.
+    mutable stdx::mutex _consumerMutex;
+
+    // Ring storage. The size is always a power of two. Only replaced while holding both mutexes.
+    std::vector<BSONObj> _slots;
+
+    // Positions of the first buffered and one past the last buffered operation. Both only ever
+    // increase and are reduced modulo the ring size when indexing into '_slots'.
+    AtomicUInt64 _head;
+    AtomicUInt64 _tail;
+
+    // Total size in bytes of the buffered operations.
+    AtomicUInt64 _size;
+
+    // Number of threads blocked in waitForData() and _waitForSpace().
+    AtomicUInt32 _dataWaiters;
+    AtomicUInt32 _spaceWaiters;
+
+    stdx::mutex _waitMutex;
+    stdx::condition_variable _noLongerEmpty;
+    stdx::condition_variable _noLongerFull;
+
+    // Incremented by clear() so that waitForData() returns early. Guarded by '_waitMutex'.
+    std::uint64_t _clearCount = 0;
 };
 
 }  // namespace repl
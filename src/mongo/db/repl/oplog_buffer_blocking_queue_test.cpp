@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+BSONObj makeOp(int i) {
+    return BSON("ts" << Timestamp(Seconds(i), 0) << "h" << 1LL << "op"
+                     << "n"
+                     << "ns"
+                     << "test.t"
+                     << "o"
+                     << BSON("i" << i));
+}
+
+TEST(OplogBufferBlockingQueueTest, PushAndPopPreserveOrderAcrossRingGrowth) {
+    OplogBufferBlockingQueue buffer;
+    const int numOps = 5000;
+    OplogBuffer::Batch batch;
+    for (int i = 0; i < numOps; ++i) {
+        batch.push_back(makeOp(i));
+    }
+
+    // Interleave pops with pushes so the ring wraps around before it has to grow.
+    buffer.pushAllNonBlocking(nullptr, batch.begin(), batch.begin() + 700);
+    OplogBuffer::Value value;
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_TRUE(buffer.tryPop(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(batch[i], value);
+    }
+    buffer.pushAllNonBlocking(nullptr, batch.begin() + 700, batch.end());
+    ASSERT_EQUALS(std::size_t(numOps - 500), buffer.getCount());
+    ASSERT_BSONOBJ_EQ(batch.back(), *buffer.lastObjectPushed(nullptr));
+
+    ASSERT_TRUE(buffer.peek(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(batch[500], value);
+    for (int i = 500; i < numOps; ++i) {
+        ASSERT_TRUE(buffer.tryPop(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(batch[i], value);
+    }
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_EQUALS(0U, buffer.getSize());
+    ASSERT_FALSE(buffer.tryPop(nullptr, &value));
+    ASSERT_FALSE(buffer.lastObjectPushed(nullptr));
+}
+
+TEST(OplogBufferBlockingQueueTest, SizeTracksBytesOfBufferedOperations) {
+    OplogBufferBlockingQueue buffer;
+    auto op1 = makeOp(1);
+    auto op2 = makeOp(2);
+    buffer.push(nullptr, op1);
+    buffer.pushEvenIfFull(nullptr, op2);
+    ASSERT_EQUALS(std::size_t(op1.objsize() + op2.objsize()), buffer.getSize());
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.tryPop(nullptr, &value));
+    ASSERT_EQUALS(std::size_t(op2.objsize()), buffer.getSize());
+
+    buffer.clear(nullptr);
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_EQUALS(0U, buffer.getSize());
+    ASSERT_EQUALS(0U, buffer.getCount());
+}
+
+TEST(OplogBufferBlockingQueueTest, WaitForDataReturnsWhenProducerPushes) {
+    OplogBufferBlockingQueue buffer;
+    ASSERT_FALSE(buffer.waitForData(Seconds(0)));
+
+    auto op = makeOp(1);
+    stdx::thread producer([&] { buffer.push(nullptr, op); });
+    ASSERT_TRUE(buffer.waitForData(Seconds(60)));
+    producer.join();
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.tryPop(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(op, value);
+}
+
+TEST(OplogBufferBlockingQueueTest, ConcurrentProducerAndConsumerSeeEveryOperationInOrder) {
+    OplogBufferBlockingQueue buffer;
+    const int numBatches = 200;
+    const int batchSize = 50;
+
+    stdx::thread producer([&] {
+        for (int b = 0; b < numBatches; ++b) {
+            OplogBuffer::Batch batch;
+            for (int i = 0; i < batchSize; ++i) {
+                batch.push_back(makeOp(b * batchSize + i));
+            }
+            buffer.pushAllNonBlocking(nullptr, batch.begin(), batch.end());
+        }
+    });
+
+    OplogBuffer::Value value;
+    for (int i = 0; i < numBatches * batchSize; ++i) {
+        while (!buffer.tryPop(nullptr, &value)) {
+            buffer.waitForData(Seconds(1));
+        }
+        ASSERT_EQUALS(i, value["o"]["i"].numberInt());
+    }
+    producer.join();
+    ASSERT_TRUE(buffer.isEmpty());
+}
+
+}  // namespace
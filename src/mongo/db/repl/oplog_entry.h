@@ -63,6 +63,10 @@ public:
     // Current oplog version, should be the value of the v field in all oplog entries.
     static const int kOplogVersion;
 
+    // Field of an 'applyOps' command object which marks it as one of the entries leading up to the
+    // final entry of a transaction written as a chain of 'applyOps' oplog entries.
+    static constexpr StringData kPartialTxnFieldName = "partialTxn"_sd;
+
     // Helpers to generate ReplOperation.
     static ReplOperation makeInsertOperation(const NamespaceString& nss,
                                              boost::optional<UUID> uuid,
@@ -121,6 +125,12 @@ public:
      */
     bool shouldPrepare() const;
 
+    /**
+     * Returns if this is an 'applyOps' entry holding part of the operations of a transaction whose
+     * operations are applied, as a whole, when its final 'applyOps' entry is applied.
+     */
+    bool isPartialTransaction() const;
+
     /**
      * Returns the _id of the document being modified. Must be called on CRUD ops.
      */
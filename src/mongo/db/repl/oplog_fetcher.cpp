@@ -36,6 +36,7 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
 #include "mongo/util/assert_util.h"
@@ -50,6 +51,8 @@ Seconds OplogFetcher::kDefaultProtocolZeroAwaitDataTimeout(2);
 
 MONGO_FAIL_POINT_DEFINE(stopReplProducer);
 
+MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherPipelineBatches, bool, false);
+
 namespace {
 
 // The number and time spent reading batches off the network
@@ -498,8 +501,20 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
 
+    // Batches must be enqueued in order, so wait for the previous batch if it is still pending.
+    auto status = _waitForBatchProcessing();
+    if (!status.isOK()) {
+        return status;
+    }
+
     // TODO: back pressure handling will be added in SERVER-23499.
-    auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
+    // Enqueueing may block until the oplog buffer has space for the batch. Unless this is the last
+    // batch, the getMore for the next batch can be in flight in the meantime.
+    if (oplogFetcherPipelineBatches.load() && queryResponse.cursorId) {
+        status = _scheduleEnqueueDocuments(queryResponse, firstDocToApply, info);
+    } else {
+        status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
+    }
     if (!status.isOK()) {
         return status;
     }
@@ -532,5 +547,52 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
                                     _getGetMoreMaxTime(),
                                     _batchSize);
 }
+
+Status OplogFetcher::_waitForBatchProcessing() {
+    stdx::unique_lock<stdx::mutex> lock(_enqueueMutex);
+    _enqueueCondition.wait(lock, [this] { return !_enqueueInProgress; });
+    auto status = _enqueueStatus;
+    _enqueueStatus = Status::OK();
+    return status;
+}
+
+Status OplogFetcher::_scheduleEnqueueDocuments(const Fetcher::QueryResponse& queryResponse,
+                                               Fetcher::Documents::const_iterator begin,
+                                               const DocumentsInfo& info) {
+    // The documents point into the response, which the task holds on to until it is done with
+    // them.
+    auto response = queryResponse.otherFields.metadata;
+    auto documents = std::make_shared<Fetcher::Documents>(begin, queryResponse.documents.cend());
+
+    {
+        stdx::lock_guard<stdx::mutex> lock(_enqueueMutex);
+        invariant(!_enqueueInProgress);
+        _enqueueInProgress = true;
+    }
+
+    auto scheduleResult = _getExecutor()->scheduleWork(
+        [this, response, documents, info](const executor::TaskExecutor::CallbackArgs& args) {
+            auto status = args.status;
+            if (status.isOK()) {
+                try {
+                    status = _enqueueDocumentsFn(documents->cbegin(), documents->cend(), info);
+                } catch (...) {
+                    status = exceptionToStatus();
+                }
+            }
+
+            stdx::lock_guard<stdx::mutex> lock(_enqueueMutex);
+            _enqueueInProgress = false;
+            _enqueueStatus = status;
+            _enqueueCondition.notify_all();
+        });
+    if (!scheduleResult.isOK()) {
+        stdx::lock_guard<stdx::mutex> lock(_enqueueMutex);
+        _enqueueInProgress = false;
+        return scheduleResult.getStatus();
+    }
+
+    return Status::OK();
+}
 }  // namespace repl
 }  // namespace mongo
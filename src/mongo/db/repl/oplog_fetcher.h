@@ -38,7 +38,10 @@
 #include "mongo/db/repl/abstract_oplog_fetcher.h"
 #include "mongo/db/repl/data_replicator_external_state.h"
 #include "mongo/db/repl/repl_set_config.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/fail_point_service.h"
 
 namespace mongo {
@@ -46,6 +49,10 @@ namespace repl {
 
 MONGO_FAIL_POINT_DECLARE(stopReplProducer);
 
+// When true, the oplog fetcher sends the getMore for the next batch while the current batch is
+// still being added to the oplog buffer.
+extern AtomicBool oplogFetcherPipelineBatches;
+
 /**
  * The oplog fetcher, once started, reads operations from a remote oplog using a tailable cursor.
  *
@@ -158,6 +165,17 @@ private:
      */
     StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) override;
 
+    Status _waitForBatchProcessing() override;
+
+    /**
+     * Schedules a task to pass the documents of 'queryResponse' starting at 'begin' to
+     * '_enqueueDocumentsFn', so that the next batch can be fetched while they wait for space in
+     * the oplog buffer.
+     */
+    Status _scheduleEnqueueDocuments(const Fetcher::QueryResponse& queryResponse,
+                                     Fetcher::Documents::const_iterator begin,
+                                     const DocumentsInfo& info);
+
     // The metadata object sent with the Fetcher queries.
     const BSONObj _metadataObject;
 
@@ -174,6 +192,13 @@ private:
     const EnqueueDocumentsFn _enqueueDocumentsFn;
     const Milliseconds _awaitDataTimeout;
     const int _batchSize;
+
+    // Protects the members below, which track the batch being enqueued by the task scheduled in
+    // _scheduleEnqueueDocuments().
+    stdx::mutex _enqueueMutex;
+    stdx::condition_variable _enqueueCondition;
+    bool _enqueueInProgress = false;
+    Status _enqueueStatus = Status::OK();
 };
 
 }  // namespace repl
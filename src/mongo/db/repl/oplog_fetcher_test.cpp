@@ -770,6 +770,55 @@ TEST_F(
                       request.cmdObj["lastKnownCommittedOpTime"].Obj())));
 }
 
+TEST_F(OplogFetcherTest, PipelinedBatchesAreEnqueuedInOrder) {
+    oplogFetcherPipelineBatches.store(true);
+    ON_BLOCK_EXIT([] { oplogFetcherPipelineBatches.store(false); });
+
+    testTwoBatchHandling();
+}
+
+TEST_F(OplogFetcherTest, PipelinedEnqueueErrorStopsTheOplogFetcherOnTheNextBatch) {
+    oplogFetcherPipelineBatches.store(true);
+    ON_BLOCK_EXIT([] { oplogFetcherPipelineBatches.store(false); });
+
+    enqueueDocumentsFn = [](Fetcher::Documents::const_iterator,
+                            Fetcher::Documents::const_iterator,
+                            const OplogFetcher::DocumentsInfo&) -> Status {
+        return Status(ErrorCodes::InternalError, "my custom error");
+    };
+
+    ShutdownState shutdownState;
+    OplogFetcher oplogFetcher(&getExecutor(),
+                              lastFetched,
+                              source,
+                              nss,
+                              _createConfig(),
+                              0,
+                              rbid,
+                              true,
+                              dataReplicatorExternalState.get(),
+                              enqueueDocumentsFn,
+                              stdx::ref(shutdownState),
+                              defaultBatchSize);
+    ASSERT_OK(oplogFetcher.startup());
+
+    auto firstEntry = makeNoopOplogEntry(lastFetched);
+    auto secondEntry = makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.opTime.getTerm()}, 200);
+    auto metadataObj = makeOplogQueryMetadataObject(remoteNewerOpTime, rbid, 2, 2);
+
+    // The getMore is sent even though the first batch could not be enqueued.
+    processNetworkResponse(
+        {concatenate(makeCursorResponse(22LL, {firstEntry, secondEntry}), metadataObj),
+         Milliseconds(0)},
+        true);
+
+    auto thirdEntry = makeNoopOplogEntry({{Seconds(789), 0}, lastFetched.opTime.getTerm()}, 300);
+    processNetworkResponse(makeCursorResponse(0, {thirdEntry}, false));
+
+    oplogFetcher.join();
+    ASSERT_EQ(shutdownState.getStatus(), Status(ErrorCodes::InternalError, "my custom error"));
+}
+
 TEST_F(OplogFetcherTest, ValidateDocumentsReturnsNoSuchKeyIfTimestampIsNotFoundInAnyDocument) {
     auto firstEntry = makeNoopOplogEntry(Seconds(123), 100);
     auto secondEntry = BSON("o" << BSON("msg"
@@ -146,6 +146,9 @@ MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherInitialSyncMaxFetcherRestarts, int, 10
         return Status::OK();
     });
 
+// Set this to back the replication task executors' thread pools with a WorkStealingThreadPool.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replExecutorUseWorkStealingPool, bool, false);
+
 // The count of items in the buffer
 OplogBuffer::Counters bufferGauge;
 ServerStatusMetricField<Counter64> displayBufferCount("repl.buffer.count", &bufferGauge.count);
@@ -169,6 +172,7 @@ public:
 auto makeThreadPool(const std::string& poolName) {
     ThreadPool::Options threadPoolOptions;
     threadPoolOptions.poolName = poolName;
+    threadPoolOptions.useWorkStealing = replExecutorUseWorkStealingPool;
     threadPoolOptions.onCreateThread = [](const std::string& threadName) {
         Client::initThread(threadName.c_str());
         AuthorizationSession::get(cc())->grantInternalAuthorization();
@@ -66,6 +66,7 @@
 #include "mongo/db/repl/rslog.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/topology_coordinator.h"
+#include "mongo/db/repl/topology_version_notifier.h"
 #include "mongo/db/repl/update_position_args.h"
 #include "mongo/db/repl/vote_requester.h"
 #include "mongo/db/server_options.h"
@@ -257,42 +258,51 @@ private:
     Waiter* _waiter;
 };
 
+ReplicationCoordinatorImpl::WaiterList::WaiterQueueKey
+ReplicationCoordinatorImpl::WaiterList::_makeKey(WaiterType waiter) {
+    const auto writeConcern = waiter->writeConcern;
+    if (!writeConcern) {
+        return WaiterQueueKey{false, std::string(), 0, 0};
+    }
+    return WaiterQueueKey{true,
+                          writeConcern->wMode,
+                          writeConcern->wNumNodes,
+                          static_cast<int>(writeConcern->syncMode)};
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
-    _list.push_back(waiter);
+    _queues[_makeKey(waiter)].emplace(waiter->opTime, waiter);
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalIf_inlock(
     stdx::function<bool(WaiterType)> func) {
-    for (auto it = _list.begin(); it != _list.end();) {
-        if (!func(*it)) {
-            // This element doesn't match, so we advance the iterator to the next one.
-            ++it;
-            continue;
-        }
+    for (auto queueIt = _queues.begin(); queueIt != _queues.end();) {
+        auto& queue = queueIt->second;
+        // The queue is ordered by opTime, so stop at the first waiter that isn't satisfied.
+        for (auto it = queue.begin(); it != queue.end() && func(it->second);) {
+            WaiterType waiter = it->second;
+            if (!waiter->runs_once()) {
+                waiter->notify_inlock();
+                // Keep the waiter on the list and let the guard remove it instead.
+                ++it;
+                continue;
+            }
 
-        if (!(*it)->runs_once()) {
-            (*it)->notify_inlock();
-            // Keep the waiter on the list and let the guard remove it instead. Advance the
-            // iterator since we are skipping the removal.
-            ++it;
-            continue;
+            // Remove the waiter from the list if it was only meant to be notified once.
+            const OpTime opTime = waiter->opTime;
+            queue.erase(it);
+            // It's important to call notify() after the waiter has been removed from the list
+            // since notify() might remove the waiter itself. It may also add or remove other
+            // waiters, so look up where to resume rather than keeping an iterator across it.
+            waiter->notify_inlock();
+            it = queue.lower_bound(opTime);
         }
 
-        // Remove the waiter from the list if it was only meant to be notified once.
-        WaiterType waiter = std::move(*it);
-
-        if (it == std::prev(_list.end())) {
-            // Iterator will be invalid after erasing the last element, so set it to the
-            // next one (i.e. end()).
-            it = _list.erase(it);
+        if (queue.empty()) {
+            queueIt = _queues.erase(queueIt);
         } else {
-            // Iterator is still valid after pop_back().
-            std::swap(*it, _list.back());
-            _list.pop_back();
+            ++queueIt;
         }
-        // It's important to call notify() after the waiter has been removed from the list
-        // since notify() might remove the waiter itself.
-        waiter->notify_inlock();
     }
 }
 
@@ -302,13 +312,20 @@ void ReplicationCoordinatorImpl::WaiterList::signalAll_inlock() {
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
-    auto it = std::find(_list.begin(), _list.end(), waiter);
-    if (it == _list.end()) {
+    // Empty queues are left in place so that removal never invalidates the map while
+    // signalIf_inlock() is iterating over it. They are erased by the next signalIf_inlock().
+    auto queueIt = _queues.find(_makeKey(waiter));
+    if (queueIt == _queues.end()) {
         return false;
     }
-    std::swap(*it, _list.back());
-    _list.pop_back();
-    return true;
+    auto range = queueIt->second.equal_range(waiter->opTime);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == waiter) {
+            queueIt->second.erase(it);
+            return true;
+        }
+    }
+    return false;
 }
 
 namespace {
@@ -364,6 +381,10 @@ ReplicationCoordinatorImpl::ReplicationCoordinatorImpl(
 
     _termShadow.store(OpTime::kUninitializedTerm);
 
+    if (_settings.isPrefetchIndexModeSet()) {
+        _indexPrefetchConfig = _settings.getPrefetchIndexMode();
+    }
+
     invariant(_service);
 
     if (!isReplEnabled()) {
@@ -2485,6 +2506,7 @@ ReplicationCoordinatorImpl::_updateMemberStateFromTopologyCoordinator_inlock(
             // We must be holding the global X lock to change _canAcceptNonLocalWrites.
             invariant(opCtx);
             invariant(opCtx->lockState()->isW());
+            TopologyVersionNotifier::get(_service)->onTopologyChange();
         }
         _canAcceptNonLocalWrites = canAcceptWrites;
     }
@@ -2595,6 +2617,7 @@ ReplicationCoordinatorImpl::_updateMemberStateFromTopologyCoordinator_inlock(
     }
 
     _memberState = newState;
+    TopologyVersionNotifier::get(_service)->onTopologyChange();
 
     _cancelAndRescheduleElectionTimeout_inlock();
 
@@ -2796,6 +2819,7 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(OperationContext* opCtx,
     const ReplSetConfig oldConfig = _rsConfig;
     _rsConfig = newConfig;
     _protVersion.store(_rsConfig.getProtocolVersion());
+    TopologyVersionNotifier::get(_service)->onTopologyChange();
 
     // Warn if running --nojournal and writeConcernMajorityJournalDefault = false
     StorageEngine* storageEngine = opCtx->getServiceContext()->getStorageEngine();
@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -498,13 +501,23 @@ private:
         void add_inlock(WaiterType waiter);
         // Returns whether waiter is found and removed.
         bool remove_inlock(WaiterType waiter);
-        // Signals all waiters that satisfy the condition.
+        // Signals all waiters that satisfy the condition. The condition must be monotonic in the
+        // waiter's opTime among waiters with the same write concern: once it is false for a
+        // waiter it must be false for all such waiters with later opTimes. This lets an opTime
+        // advance visit only the waiters it satisfies plus one per write concern.
         void signalIf_inlock(stdx::function<bool(WaiterType)> fun);
         // Signals all waiters from the list.
         void signalAll_inlock();
 
     private:
-        std::vector<WaiterType> _list;
+        // Waiters without a write concern, or with the same 'w', 'wNumNodes' and sync mode.
+        using WaiterQueueKey = std::tuple<bool, std::string, int, int>;
+        // Waiters with the same key, ordered by the opTime they are waiting for.
+        using WaiterQueue = std::multimap<OpTime, WaiterType>;
+
+        static WaiterQueueKey _makeKey(WaiterType waiter);
+
+        std::map<WaiterQueueKey, WaiterQueue> _queues;
     };
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
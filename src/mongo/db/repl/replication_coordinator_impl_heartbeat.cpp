@@ -48,6 +48,7 @@
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/repl/replication_state_transition_lock_guard.h"
 #include "mongo/db/repl/topology_coordinator.h"
+#include "mongo/db/repl/topology_version_notifier.h"
 #include "mongo/db/repl/vote_requester.h"
 #include "mongo/db/service_context.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -208,8 +209,13 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
         hbStatusResponse = StatusWith<ReplSetHeartbeatResponse>(responseStatus);
     }
 
+    const int oldPrimaryIndex = _topCoord->getCurrentPrimaryIndex();
     HeartbeatResponseAction action = _topCoord->processHeartbeatResponse(
         now, networkTime, target, hbStatusResponse, lastOpCommitted);
+    if (_topCoord->getCurrentPrimaryIndex() != oldPrimaryIndex) {
+        // The primary reported by isMaster has changed.
+        TopologyVersionNotifier::get(_service)->onTopologyChange();
+    }
 
     if (action.getAction() == HeartbeatResponseAction::NoAction && hbStatusResponse.isOK() &&
         hbStatusResponse.getValue().hasState() &&
@@ -254,6 +254,11 @@ public:
      */
     void setGetConfigReturnValue(ReplSetConfig returnValue);
 
+    /**
+     * Sets the return value for calls to getLastCommittedOpTime.
+     */
+    void setLastCommittedOpTime(const OpTime& opTime);
+
     /**
      * Sets the function to generate the return value for calls to awaitReplication().
      * 'opTime' is the optime passed to awaitReplication().
@@ -284,6 +289,7 @@ private:
     MemberState _memberState;
     OpTime _myLastDurableOpTime;
     OpTime _myLastAppliedOpTime;
+    OpTime _lastCommittedOpTime;
     ReplSetConfig _getConfigReturnValue;
     AwaitReplicationReturnValueFunction _awaitReplicationReturnValueFunction = [](const OpTime&) {
         return StatusAndDuration(Status::OK(), Milliseconds(0));
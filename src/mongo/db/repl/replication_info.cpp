@@ -52,6 +52,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/repl/topology_version_notifier.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/wire_version.h"
@@ -335,6 +336,35 @@ public:
                 });
         }
 
+        // An awaitable isMaster names the topology version the client last saw, and is answered
+        // once the topology has moved on from it or 'maxAwaitTimeMS' has passed.
+        auto topologyVersionNotifier = TopologyVersionNotifier::get(opCtx->getServiceContext());
+        auto topologyVersionElement = cmdObj["topologyVersion"];
+        auto maxAwaitTimeElement = cmdObj["maxAwaitTimeMS"];
+        uassert(ErrorCodes::BadValue,
+                "'topologyVersion' and 'maxAwaitTimeMS' must be specified together",
+                !topologyVersionElement == !maxAwaitTimeElement);
+        if (topologyVersionElement) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "'topologyVersion' must be of type Object, but was of type "
+                                  << typeName(topologyVersionElement.type()),
+                    topologyVersionElement.type() == BSONType::Object);
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "'maxAwaitTimeMS' must be a number, but was of type "
+                                  << typeName(maxAwaitTimeElement.type()),
+                    maxAwaitTimeElement.isNumber());
+            uassert(ErrorCodes::BadValue,
+                    "'maxAwaitTimeMS' must not be negative",
+                    maxAwaitTimeElement.numberLong() >= 0);
+            topologyVersionNotifier->waitForTopologyChange(
+                opCtx,
+                topologyVersionElement.Obj(),
+                Date_t::now() + Milliseconds(maxAwaitTimeElement.numberLong()));
+        }
+
+        // Read the version before the topology it describes, so that a change which races with
+        // building this reply is seen by the client's next awaitable isMaster.
+        result.append("topologyVersion", topologyVersionNotifier->getTopologyVersion());
         appendReplicationInfo(opCtx, result, 0);
 
         if (serverGlobalParams.clusterRole == ClusterRole::ConfigServer) {
@@ -28,15 +28,18 @@
 
 #pragma once
 
+#include <tuple>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
 
-class NamespaceString;
 class OperationContext;
 
 namespace repl {
@@ -88,6 +91,24 @@ public:
                                                               UUID uuid,
                                                               const BSONObj& filter) const = 0;
 
+    /**
+     * Fetches the documents with the _id values in 'ids' from the sync source using the UUID.
+     * Returns one document per _id, in the same order, which is empty if the sync source has no
+     * such document, and the namespace matching the UUID on the sync source. The default
+     * implementation fetches the documents one at a time with findOneByUUID().
+     */
+    virtual std::pair<std::vector<BSONObj>, NamespaceString> findByIdsByUUID(
+        const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+        std::vector<BSONObj> docs;
+        NamespaceString nss;
+        for (auto&& id : ids) {
+            BSONObj doc;
+            std::tie(doc, nss) = findOneByUUID(db, uuid, id.wrap());
+            docs.push_back(doc);
+        }
+        return {std::move(docs), nss};
+    }
+
     /**
      * Clones a single collection from the sync source.
      */
@@ -30,6 +30,8 @@
 
 #include "mongo/db/repl/rollback_source_impl.h"
 
+#include "mongo/bson/bsonelement_comparator.h"
+#include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/cloner.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
@@ -79,6 +81,40 @@ std::pair<BSONObj, NamespaceString> RollbackSourceImpl::findOneByUUID(const std:
     return _getConnection()->findOneByUUID(db, uuid, filter);
 }
 
+std::pair<std::vector<BSONObj>, NamespaceString> RollbackSourceImpl::findByIdsByUUID(
+    const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+    BSONArrayBuilder idsBuilder;
+    for (auto&& id : ids) {
+        idsBuilder.append(id);
+    }
+
+    // Note that the query() function of DBClient is passed SlaveOK, as findOneByUUID() does.
+    auto cursor = _getConnection()->query(NamespaceStringOrUUID(db, uuid),
+                                          QUERY("_id" << BSON("$in" << idsBuilder.arr())),
+                                          0,
+                                          0,
+                                          nullptr,
+                                          QueryOption_SlaveOk);
+    uassert(ErrorCodes::HostUnreachable,
+            str::stream() << "Could not query " << _source << " for the documents to refetch",
+            cursor);
+
+    const BSONElementComparator eltCmp(BSONElementComparator::FieldNamesMode::kIgnore, nullptr);
+    auto found = eltCmp.makeBSONEltIndexedMap<BSONObj>();
+    while (cursor->more()) {
+        BSONObj doc = cursor->nextSafe().getOwned();
+        found[doc["_id"]] = doc;
+    }
+
+    std::vector<BSONObj> docs;
+    docs.reserve(ids.size());
+    for (auto&& id : ids) {
+        auto it = found.find(id);
+        docs.push_back(it == found.end() ? BSONObj() : it->second);
+    }
+    return {std::move(docs), cursor->getNamespaceString()};
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* opCtx,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
@@ -580,6 +580,11 @@ Status rollback_internal::updateFixUpInfoFromLocalOplogEntry(FixUpInfo& fixUpInf
 
 namespace {
 
+// Limits on the number of documents and the total size of their _ids refetched from the sync
+// source in a single query.
+const size_t kRefetchBatchMaxDocs = 1000;
+const int kRefetchBatchMaxBytes = 1024 * 1024;
+
 /**
  * This must be called before making any changes to our local data and after fetching any
  * information from the upstream node. If any information is fetched from the upstream node after we
@@ -982,22 +987,36 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
 
     log() << "Starting refetching documents";
 
-    for (auto&& doc : fixUpInfo.docsToRefetch) {
-        invariant(!doc._id.eoo());  // This is checked when we insert to the set.
-
-        UUID uuid = doc.uuid;
+    // The documents are refetched in batches of the same collection, which are contiguous in the
+    // set, so that a large rollback does not take one round trip to the sync source per document.
+    for (auto batchBegin = fixUpInfo.docsToRefetch.begin();
+         batchBegin != fixUpInfo.docsToRefetch.end();) {
+        UUID uuid = batchBegin->uuid;
         NamespaceString nss = catalog.lookupNSSByUUID(uuid);
 
+        std::vector<const DocID*> batch;
+        std::vector<BSONElement> ids;
+        int idsBytes = 0;
+        auto batchEnd = batchBegin;
+        for (; batchEnd != fixUpInfo.docsToRefetch.end() && batchEnd->uuid == uuid &&
+             batch.size() < kRefetchBatchMaxDocs && idsBytes < kRefetchBatchMaxBytes;
+             ++batchEnd) {
+            invariant(!batchEnd->_id.eoo());  // This is checked when we insert to the set.
+            batch.push_back(&*batchEnd);
+            ids.push_back(batchEnd->_id);
+            idsBytes += batchEnd->_id.size();
+        }
+        batchBegin = batchEnd;
+
         try {
-            LOG(2) << "Refetching document, collection: " << nss << ", UUID: " << uuid << ", "
-                   << redact(doc._id);
-            // TODO : Slow. Lots of round trips.
-            numFetched++;
+            LOG(2) << "Refetching " << batch.size() << " documents, collection: " << nss
+                   << ", UUID: " << uuid << ", starting at " << redact(ids.front());
+            numFetched += batch.size();
 
-            BSONObj good;
+            std::vector<BSONObj> goodDocs;
             NamespaceString resNss;
-            std::tie(good, resNss) =
-                rollbackSource.findOneByUUID(nss.db().toString(), uuid, doc._id.wrap());
+            std::tie(goodDocs, resNss) =
+                rollbackSource.findByIdsByUUID(nss.db().toString(), uuid, ids);
 
             // To prevent inconsistencies in the transactions collection, rollback fails if the UUID
             // of the collection is different on the sync source than on the node rolling back,
@@ -1014,17 +1033,21 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
                        "resync is required.");
             }
 
-            totalSize += good.objsize();
+            invariant(goodDocs.size() == batch.size());
+            for (size_t i = 0; i < batch.size(); ++i) {
+                const BSONObj& good = goodDocs[i];
+                totalSize += good.objsize();
 
-            // Checks that the total amount of data that needs to be refetched is at most
-            // 300 MB. We do not roll back more than 300 MB of documents in order to
-            // prevent out of memory errors from too much data being stored. See SERVER-23392.
-            if (totalSize >= 300 * 1024 * 1024) {
-                throw RSFatalException("replSet too much data to roll back.");
-            }
+                // Checks that the total amount of data that needs to be refetched is at most
+                // 300 MB. We do not roll back more than 300 MB of documents in order to
+                // prevent out of memory errors from too much data being stored. See SERVER-23392.
+                if (totalSize >= 300 * 1024 * 1024) {
+                    throw RSFatalException("replSet too much data to roll back.");
+                }
 
-            // Note good might be empty, indicating we should delete it.
-            goodVersions[uuid].insert(std::pair<DocID, BSONObj>(doc, good));
+                // Note good might be empty, indicating we should delete it.
+                goodVersions[uuid].insert(std::pair<DocID, BSONObj>(*batch[i], good));
+            }
 
         } catch (const DBException& ex) {
             // If the collection turned into a view, we might get an error trying to
@@ -1037,9 +1060,9 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
                 ex.code() == ErrorCodes::NamespaceNotFound)
                 continue;
 
-            log() << "Rollback couldn't re-fetch from uuid: " << uuid << " _id: " << redact(doc._id)
-                  << ' ' << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": "
-                  << redact(ex);
+            log() << "Rollback couldn't re-fetch from uuid: " << uuid << " _ids starting at "
+                  << redact(ids.front()) << ' ' << numFetched << '/'
+                  << fixUpInfo.docsToRefetch.size() << ": " << redact(ex);
             throw;
         }
     }
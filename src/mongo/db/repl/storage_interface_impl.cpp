@@ -897,9 +897,9 @@ Status StorageInterfaceImpl::upsertById(OperationContext* opCtx,
         }
 
         // We're using the ID hack to perform the update so we have to disallow collections
-        // without an _id index.
+        // without an _id index, unless their records are keyed by _id.
         auto descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
-        if (!descriptor) {
+        if (!descriptor && !collection->getRecordStore()->isClusteredOnId()) {
             return Status(ErrorCodes::IndexNotFound,
                           "Unable to update document in a collection without an _id index.");
         }
@@ -34,6 +34,8 @@
 
 #include "third_party/murmurhash3/MurmurHash3.h"
 #include <boost/functional/hash.hpp>
+#include <iterator>
+#include <map>
 #include <memory>
 
 #include "mongo/base/counter.h"
@@ -53,6 +55,8 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/namespace_string.h"
@@ -68,11 +72,13 @@
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/session_update_tracker.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session.h"
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/db/transaction_history_iterator.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/exit.h"
@@ -81,9 +87,17 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
+
+MONGO_EXPORT_SERVER_PARAMETER(replBatchCollectionCommands, bool, false);
+
+// Whether the batcher reads the documents and index entries of each batch of CRUD ops before
+// handing it to oplog application. The indexes read are chosen by secondaryIndexPrefetch.
+MONGO_EXPORT_SERVER_PARAMETER(replPrefetchOplogBatches, bool, false);
+
 namespace {
 
 MONGO_FAIL_POINT_DEFINE(pauseBatchApplicationBeforeCompletion);
@@ -100,6 +114,10 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 // Number and time of each ApplyOps worker pool round
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
+// Number of oplog entries whose target pages were prefetched
+Counter64 prefetchedOpsStats;
+ServerStatusMetricField<Counter64> displayPrefetchedOps("repl.apply.prefetchedOps",
+                                                        &prefetchedOpsStats);
 
 class ApplyBatchFinalizer {
 public:
@@ -226,6 +244,37 @@ NamespaceStringOrUUID getNsOrUUID(const NamespaceString& nss, const BSONObj& op)
     return nss;
 }
 
+/**
+ * Returns the collection a command applies to if it only affects that one collection, so that it
+ * may be applied in the same batch as ops on other collections. Returns boost::none for all other
+ * commands, which must be applied in a batch of their own.
+ */
+boost::optional<NamespaceString> getBatchableCommandCollection(const OplogEntry& entry) {
+    switch (entry.getCommandType()) {
+        case OplogEntry::CommandType::kCreate:
+        case OplogEntry::CommandType::kDrop:
+        case OplogEntry::CommandType::kCollMod:
+        case OplogEntry::CommandType::kCreateIndexes:
+        case OplogEntry::CommandType::kDropIndexes:
+            break;
+        default:
+            return boost::none;
+    }
+
+    // Views change the view catalog of the whole database as soon as they are applied.
+    const BSONObj& command = entry.getObject();
+    if (command.hasField("viewOn") || command.hasField("pipeline") ||
+        command.firstElement().type() != String) {
+        return boost::none;
+    }
+
+    NamespaceString nss(entry.getNss().db(), command.firstElement().valueStringData());
+    if (!nss.isValid() || nss.isSystem() || nss.isOnInternalDb()) {
+        return boost::none;
+    }
+    return nss;
+}
+
 }  // namespace
 
 // static
@@ -372,6 +421,11 @@ void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
                 &workerMultikeyPathInfo = workerMultikeyPathInfo->at(i)
             ] {
                 auto opCtx = cc().makeOperationContext();
+                // Oplog application must not queue behind user operations for storage engine
+                // tickets, which may be few when they are tuned down under load.
+                if (Locker::isGlobalThrottlingAdaptive()) {
+                    opCtx->lockState()->setShouldAcquireTicket(false);
+                }
                 status = func(opCtx.get(), &writer, st, &workerMultikeyPathInfo);
             }));
         }
@@ -394,6 +448,9 @@ void scheduleWritesToOplog(OperationContext* opCtx,
             UnreplicatedWritesBlock uwb(opCtx.get());
             ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
                 opCtx->lockState());
+            if (Locker::isGlobalThrottlingAdaptive()) {
+                opCtx->lockState()->setShouldAcquireTicket(false);
+            }
 
             std::vector<InsertStatement> docs;
             docs.reserve(end - begin);
@@ -484,6 +541,42 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * Returns the operations of a transaction written as a chain of applyOps entries, given its final
+ * entry. The earlier entries are looked up in 'partialTxnEntries', which holds those of the current
+ * batch, and are otherwise read from the oplog. All the operations take the top-level fields,
+ * including the timestamp, of the final entry so that the transaction is applied atomically.
+ */
+MultiApplier::Operations extractChainedTransactionOperations(
+    OperationContext* opCtx,
+    const OplogEntry& finalEntry,
+    const std::map<OpTime, const OplogEntry*>& partialTxnEntries) {
+    std::vector<OplogEntry> chain{finalEntry};
+    auto prevOpTime = *finalEntry.getPrevWriteOpTimeInTransaction();
+    while (!prevOpTime.isNull()) {
+        auto it = partialTxnEntries.find(prevOpTime);
+        if (it != partialTxnEntries.end()) {
+            chain.push_back(*it->second);
+        } else {
+            chain.push_back(TransactionHistoryIterator(prevOpTime).next(opCtx));
+        }
+
+        uassert(ErrorCodes::IncompleteTransactionHistory,
+                str::stream() << "Expected a partial transaction applyOps oplog entry, found "
+                              << redact(chain.back().toBSON()),
+                chain.back().isPartialTransaction());
+        prevOpTime = chain.back().getPrevWriteOpTimeInTransaction().value_or(OpTime());
+    }
+
+    MultiApplier::Operations operations;
+    const auto topLevelDoc = finalEntry.toBSON();
+    for (auto entry = chain.rbegin(); entry != chain.rend(); ++entry) {
+        auto entryOperations = ApplyOps::extractOperations(*entry, topLevelDoc);
+        std::move(entryOperations.begin(), entryOperations.end(), std::back_inserter(operations));
+    }
+    return operations;
+}
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
@@ -491,12 +584,15 @@ private:
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
+ * commandCollections - Collections which a command in the batch applies to. All ops on them go to
+ *      the same writer as the command, in order.
  */
 void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
                        std::vector<MultiApplier::OperationPtrs>* writerVectors,
                        std::vector<MultiApplier::Operations>* derivedOps,
-                       SessionUpdateTracker* sessionUpdateTracker) {
+                       SessionUpdateTracker* sessionUpdateTracker,
+                       const StringMap<bool>& commandCollections) {
     const auto serviceContext = opCtx->getServiceContext();
     const auto storageEngine = serviceContext->getStorageEngine();
 
@@ -505,7 +601,17 @@ void fillWriterVectors(OperationContext* opCtx,
 
     CachedCollectionProperties collPropertiesCache;
 
+    // Partial transaction entries of this batch, which may not be in the oplog yet.
+    std::map<OpTime, const OplogEntry*> partialTxnEntries;
+
     for (auto&& op : *ops) {
+        // The operations of a partial transaction entry are applied with the final entry of its
+        // transaction, which also updates the transactions table.
+        if (op.isPartialTransaction()) {
+            partialTxnEntries.emplace(op.getOpTime(), &op);
+            continue;
+        }
+
         StringMapTraits::HashedKey hashedNs(op.getNss().ns());
         uint32_t hash = hashedNs.hash();
 
@@ -514,13 +620,30 @@ void fillWriterVectors(OperationContext* opCtx,
         if (sessionUpdateTracker) {
             if (auto newOplogWrites = sessionUpdateTracker->updateOrFlush(op)) {
                 derivedOps->emplace_back(std::move(*newOplogWrites));
-                fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                fillWriterVectors(opCtx,
+                                  &derivedOps->back(),
+                                  writerVectors,
+                                  derivedOps,
+                                  nullptr,
+                                  commandCollections);
             }
         }
 
+        if (auto commandNss = getBatchableCommandCollection(op)) {
+            // Hash the command like the ops on its collection, so that they all stay in order.
+            hash = StringMapTraits::HashedKey(commandNss->ns()).hash();
+        }
+
         if (op.isCrudOpType()) {
             auto collProperties = collPropertiesCache.getCollectionProperties(opCtx, hashedNs);
 
+            // The properties of a collection with a command in the batch are those from before the
+            // command, and may change in the middle of the batch. Treat it like a capped
+            // collection, so that its ops are neither spread over writers nor grouped.
+            if (commandCollections.find(hashedNs) != commandCollections.end()) {
+                collProperties.isCapped = true;
+            }
+
             // For doc locking engines, include the _id of the document in the hash so we get
             // parallelism even if all writes are to a single collection.
             //
@@ -545,10 +668,23 @@ void fillWriterVectors(OperationContext* opCtx,
         // function.
         if (op.getCommandType() == OplogEntry::CommandType::kApplyOps && !op.shouldPrepare()) {
             try {
-                derivedOps->emplace_back(ApplyOps::extractOperations(op));
+                // The final entry of a transaction written as a chain of entries links to the
+                // earlier ones, whose operations are applied along with its own.
+                if (op.getPrevWriteOpTimeInTransaction() &&
+                    !op.getPrevWriteOpTimeInTransaction()->isNull()) {
+                    derivedOps->emplace_back(
+                        extractChainedTransactionOperations(opCtx, op, partialTxnEntries));
+                } else {
+                    derivedOps->emplace_back(ApplyOps::extractOperations(op));
+                }
 
                 // Nested entries cannot have different session updates.
-                fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                fillWriterVectors(opCtx,
+                                  &derivedOps->back(),
+                                  writerVectors,
+                                  derivedOps,
+                                  nullptr,
+                                  commandCollections);
             } catch (...) {
                 fassertFailedWithStatusNoTrace(
                     50711,
@@ -571,13 +707,22 @@ void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
                        std::vector<MultiApplier::OperationPtrs>* writerVectors,
                        std::vector<MultiApplier::Operations>* derivedOps) {
+    StringMap<bool> commandCollections;
+    for (auto&& op : *ops) {
+        if (auto commandNss = getBatchableCommandCollection(op)) {
+            commandCollections[commandNss->ns()] = true;
+        }
+    }
+
     SessionUpdateTracker sessionUpdateTracker;
-    fillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    fillWriterVectors(
+        opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker, commandCollections);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        fillWriterVectors(
+            opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr, commandCollections);
     }
 }
 
@@ -632,6 +777,71 @@ void tryToGoLiveAsASecondary(OperationContext* opCtx,
 }
 }
 
+namespace {
+/**
+ * Reads the pages that applying the CRUD ops of 'ops' will need, so that the writer threads find
+ * them in cache instead of each blocking on its own random reads:
+ * - the _id index entry of every document inserted, updated or deleted,
+ * - the documents updated or deleted,
+ * - with PREFETCH_ALL, the entries of the unique indexes that the inserted, updated or deleted
+ *   documents have keys in, which are read to enforce uniqueness or remove the old keys.
+ *
+ * This only reads, using the caller's own recovery unit, and does not conflict with the batch
+ * application in progress. Ops whose collection or document can't be read are skipped, since
+ * their application will report any real problem.
+ */
+void prefetchBatch(OperationContext* opCtx,
+                   const std::vector<OplogEntry>& ops,
+                   ReplSettings::IndexPrefetchConfig config) {
+    ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(opCtx->lockState());
+
+    for (const auto& op : ops) {
+        if (!op.isCrudOpType() || op.isPartialTransaction()) {
+            continue;
+        }
+
+        try {
+            const NamespaceStringOrUUID nsOrUUID = op.getUuid()
+                ? NamespaceStringOrUUID(op.getNss().db().toString(), *op.getUuid())
+                : NamespaceStringOrUUID(op.getNss());
+            AutoGetCollection autoColl(opCtx, nsOrUUID, MODE_IS);
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                continue;
+            }
+
+            const RecordId rid =
+                Helpers::findById(opCtx, collection, op.getIdElement().wrap("_id"));
+            BSONObj doc;
+            if (op.getOpType() == OpTypeEnum::kInsert) {
+                doc = op.getObject();
+            } else {
+                Snapshotted<BSONObj> found;
+                if (rid.isNull() || !collection->findDoc(opCtx, rid, &found)) {
+                    continue;
+                }
+                doc = found.value();
+            }
+
+            if (config == ReplSettings::IndexPrefetchConfig::PREFETCH_ALL) {
+                IndexCatalog* indexCatalog = collection->getIndexCatalog();
+                IndexCatalog::IndexIterator it = indexCatalog->getIndexIterator(opCtx, false);
+                while (it.more()) {
+                    IndexDescriptor* desc = it.next();
+                    if (desc->unique() && !desc->isIdIndex()) {
+                        indexCatalog->getIndex(desc)->touch(opCtx, doc).ignore();
+                    }
+                }
+            }
+            prefetchedOpsStats.increment();
+        } catch (const DBException& ex) {
+            LOG(2) << "failed to prefetch for oplog entry " << redact(op.toBSON()) << ": "
+                   << redact(ex.toStatus());
+        }
+    }
+}
+}  // namespace
+
 class SyncTail::OpQueueBatcher {
     MONGO_DISALLOW_COPYING(OpQueueBatcher);
 
@@ -704,6 +914,17 @@ private:
                 continue;  // Don't emit empty batches.
             }
 
+            // The previous batch is usually still being applied, so read what this one will
+            // need in the meantime.
+            if (!ops.empty() && replPrefetchOplogBatches.load()) {
+                auto opCtx = cc().makeOperationContext();
+                const auto config =
+                    ReplicationCoordinator::get(opCtx.get())->getIndexPrefetchConfig();
+                if (config != ReplSettings::IndexPrefetchConfig::PREFETCH_NONE) {
+                    prefetchBatch(opCtx.get(), ops.getBatch(), config);
+                }
+            }
+
             stdx::unique_lock<stdx::mutex> lk(_mutex);
             // Block until the previous batch has been taken.
             _cv.wait(lk, [&] { return _ops.empty(); });
@@ -935,8 +1156,11 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
     // Oplog entries on 'system.views' should also be processed one at a time. View catalog
     // immediately reflects changes for each oplog entry so we can see inconsistent view catalog if
     // multiple oplog entries on 'system.views' are being applied out of the original order.
+    // With replBatchCollectionCommands, commands which only affect one collection are batched too,
+    // as fillWriterVectors() keeps them in order with the ops on their collection.
     if ((entry.isCommand() &&
-         (entry.getCommandType() != OplogEntry::CommandType::kApplyOps || entry.shouldPrepare())) ||
+         (entry.getCommandType() != OplogEntry::CommandType::kApplyOps || entry.shouldPrepare()) &&
+         !(replBatchCollectionCommands.load() && getBatchableCommandCollection(entry))) ||
         entry.getNss().isSystemDotViews()) {
         if (ops->getCount() == 1) {
             // apply commands one-at-a-time
@@ -980,6 +1204,11 @@ bool SyncTail::inShutdown() const {
     return _inShutdown;
 }
 
+SyncTail::PhaseTimes SyncTail::getPhaseTimes() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _phaseTimes;
+}
+
 BSONObj SyncTail::getMissingDoc(OperationContext* opCtx, const OplogEntry& oplogEntry) {
     OplogReader missingObjReader;  // why are we using OplogReader to run a non-oplog query?
 
@@ -1283,11 +1512,14 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
             }
         });
 
+        Timer phaseTimer;
+
         // Write batch of ops into oplog.
         if (!_options.skipWritesToOplog) {
             _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, ops.front().getTimestamp());
             scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
         }
+        const auto fillStartMicros = phaseTimer.micros();
 
         // Holds 'pseudo operations' generated by secondaries to aid in replication.
         // Keep in scope until all operations in 'ops' and 'derivedOps' have been applied.
@@ -1300,9 +1532,11 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
 
         std::vector<MultiApplier::OperationPtrs> writerVectors(_writerPool->getStats().numThreads);
         fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        const auto fillEndMicros = phaseTimer.micros();
 
         // Wait for writes to finish before applying ops.
         _writerPool->waitForIdle();
+        const auto applyStartMicros = phaseTimer.micros();
 
         // Reset consistency markers in case the node fails while applying ops.
         if (!_options.skipWritesToOplog) {
@@ -1315,6 +1549,14 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
             applyOps(writerVectors, _writerPool, _applyFunc, this, &statusVector, &multikeyVector);
             _writerPool->waitForIdle();
 
+            {
+                stdx::lock_guard<stdx::mutex> lock(_mutex);
+                _phaseTimes.writeOplog +=
+                    Microseconds(fillStartMicros + (applyStartMicros - fillEndMicros));
+                _phaseTimes.fillWriterVectors += Microseconds(fillEndMicros - fillStartMicros);
+                _phaseTimes.applyOps += Microseconds(phaseTimer.micros() - applyStartMicros);
+            }
+
             // If any of the statuses is not ok, return error.
             for (auto it = statusVector.cbegin(); it != statusVector.cend(); ++it) {
                 const auto& status = *it;
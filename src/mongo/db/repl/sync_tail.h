@@ -40,9 +40,11 @@
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/replication_consistency_markers.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -62,6 +64,10 @@ class OpTime;
  * When used for steady state replication, runs a thread that reads batches of operations from
  * an oplog buffer (through the BackgroundSync interface) and applies the batch of operations.
  */
+// When true, commands which only affect a single collection, like create or createIndexes, are
+// applied in the same batch as other ops rather than in a batch of their own.
+extern AtomicBool replBatchCollectionCommands;
+
 class SyncTail {
 public:
     using MultiSyncApplyFunc =
@@ -235,6 +241,20 @@ public:
      */
     StatusWith<OpTime> multiApply(OperationContext* opCtx, MultiApplier::Operations ops);
 
+    /**
+     * Cumulative wall-clock time that multiApply() has spent in each of its phases.
+     *
+     * 'writeOplog' only counts the time the batch was held up by its oplog writes, which otherwise
+     * overlap with filling the writer vectors.
+     */
+    struct PhaseTimes {
+        Microseconds writeOplog{0};
+        Microseconds fillWriterVectors{0};
+        Microseconds applyOps{0};
+    };
+
+    PhaseTimes getPhaseTimes() const;
+
 private:
     /**
      * Pops the operation at the front of the OplogBuffer.
@@ -267,6 +287,9 @@ private:
 
     // Set to true if shutdown() has been called.
     bool _inShutdown = false;
+
+    // Time spent in each phase of multiApply().
+    PhaseTimes _phaseTimes;
 };
 
 // This free function is used by the thread pool workers to write ops to the db.
@@ -523,6 +523,57 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_EQUALS(op2, lastEntry);
 }
 
+TEST_F(SyncTailTest, MultiApplyAssignsCollectionCommandToWriterThreadOfItsCollection) {
+    NamespaceString nss1("test.t0");
+    NamespaceString nss2("test.t1");
+    auto writerPool = OplogApplier::makeWriterPool(4);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn =
+        [&mutex, &operationsApplied](OperationContext* opCtx,
+                                     MultiApplier::OperationPtrs* operationsForWriterThreadToApply,
+                                     SyncTail* st,
+                                     WorkerMultikeyPathInfo*) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    auto op1 = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss1);
+    auto op2 = makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss1, BSON("x" << 1));
+    auto op3 = makeInsertDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, nss2, BSON("x" << 2));
+    auto op4 = makeInsertDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL}, nss1, BSON("x" << 3));
+
+    SyncTail syncTail(nullptr,
+                      getConsistencyMarkers(),
+                      getStorageInterface(),
+                      applyOperationFn,
+                      writerPool.get());
+    auto lastOpTime = unittest::assertGet(syncTail.multiApply(_opCtx.get(), {op1, op2, op3, op4}));
+    ASSERT_EQUALS(op4.getOpTime(), lastOpTime);
+
+    // The create and the inserts into its collection are applied by one writer thread, in order.
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    bool sawCollection = false;
+    for (auto&& operationsAppliedByThread : operationsApplied) {
+        if (operationsAppliedByThread.front().getNss() == nss2) {
+            continue;
+        }
+        ASSERT_FALSE(sawCollection);
+        sawCollection = true;
+        ASSERT_EQUALS(3U, operationsAppliedByThread.size());
+        ASSERT_EQUALS(op1, operationsAppliedByThread[0]);
+        ASSERT_EQUALS(op2, operationsAppliedByThread[1]);
+        ASSERT_EQUALS(op4, operationsAppliedByThread[2]);
+        ASSERT_TRUE(operationsAppliedByThread[1].isForCappedCollection);
+    }
+    ASSERT_TRUE(sawCollection);
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     auto op = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
@@ -1600,6 +1651,49 @@ public:
                                 boost::none);   // post-image optime
     }
 
+    /**
+     * Creates an 'applyOps' entry of a transaction written as a chain of entries, which inserts a
+     * document for each of 'ids'.
+     */
+    repl::OplogEntry makeChainedApplyOpsOplogEntry(repl::OpTime opTime,
+                                                   const std::vector<int>& ids,
+                                                   const OperationSessionInfo& sessionInfo,
+                                                   Date_t wallClockTime,
+                                                   repl::OpTime prevOpTime,
+                                                   bool partialTxn) {
+        BSONArrayBuilder opsArray;
+        for (auto id : ids) {
+            opsArray.append(BSON("op"
+                                 << "i"
+                                 << "ns"
+                                 << nss().ns()
+                                 << "o"
+                                 << BSON("_id" << id)));
+        }
+        BSONObjBuilder applyOpsBuilder;
+        applyOpsBuilder.append("applyOps", opsArray.arr());
+        if (partialTxn) {
+            applyOpsBuilder.append(repl::OplogEntry::kPartialTxnFieldName, true);
+        }
+
+        return repl::OplogEntry(opTime,                            // optime
+                                0,                                 // hash
+                                repl::OpTypeEnum::kCommand,        // opType
+                                NamespaceString("admin", "$cmd"),  // namespace
+                                boost::none,                       // uuid
+                                boost::none,                       // fromMigrate
+                                repl::OplogEntry::kOplogVersion,   // version
+                                applyOpsBuilder.obj(),             // o
+                                boost::none,                       // o2
+                                sessionInfo,                       // sessionInfo
+                                boost::none,                       // upsert
+                                wallClockTime,                     // wall clock time
+                                0,                                 // statement id
+                                prevOpTime,    // optime of previous write within same transaction
+                                boost::none,   // pre-image optime
+                                boost::none);  // post-image optime
+    }
+
     void checkTxnTable(const OperationSessionInfo& sessionInfo,
                        const repl::OpTime& expectedOpTime,
                        Date_t expectedWallClock) {
@@ -1653,6 +1747,43 @@ TEST_F(SyncTailTxnTableTest, SimpleWriteWithTxn) {
     checkTxnTable(sessionInfo, {Timestamp(1, 0), 1}, date);
 }
 
+TEST_F(SyncTailTxnTableTest, ChainedTransactionIsAppliedWithItsFinalEntry) {
+    const auto sessionId = makeLogicalSessionIdForTest();
+    OperationSessionInfo sessionInfo;
+    sessionInfo.setSessionId(sessionId);
+    sessionInfo.setTxnNumber(3);
+    const auto date = Date_t::now();
+
+    const repl::OpTime firstOpTime(Timestamp(1, 0), 1);
+    const repl::OpTime secondOpTime(Timestamp(2, 0), 1);
+    const repl::OpTime finalOpTime(Timestamp(3, 0), 1);
+    auto firstOp =
+        makeChainedApplyOpsOplogEntry(firstOpTime, {1, 2}, sessionInfo, date, {}, true);
+    auto secondOp =
+        makeChainedApplyOpsOplogEntry(secondOpTime, {3}, sessionInfo, date, firstOpTime, true);
+    auto finalOp =
+        makeChainedApplyOpsOplogEntry(finalOpTime, {4}, sessionInfo, date, secondOpTime, false);
+
+    auto writerPool = OplogApplier::makeWriterPool();
+    SyncTail syncTail(
+        nullptr, getConsistencyMarkers(), getStorageInterface(), multiSyncApply, writerPool.get());
+
+    // The partial entries neither apply their operations nor update the transactions table.
+    ASSERT_OK(syncTail.multiApply(_opCtx.get(), {firstOp}));
+    DBDirectClient client(_opCtx.get());
+    ASSERT_EQ(0U, client.count(nss().ns()));
+    ASSERT(client
+               .findOne(NamespaceString::kSessionTransactionsTableNamespace.ns(),
+                        BSON(SessionTxnRecord::kSessionIdFieldName << sessionId.toBSON()))
+               .isEmpty());
+
+    // The final entry applies the operations of the whole chain, whether the earlier entries are
+    // in its batch or were applied in an earlier one.
+    ASSERT_OK(syncTail.multiApply(_opCtx.get(), {secondOp, finalOp}));
+    ASSERT_EQ(4U, client.count(nss().ns()));
+    checkTxnTable(sessionInfo, finalOpTime, date);
+}
+
 TEST_F(SyncTailTxnTableTest, WriteWithTxnMixedWithDirectWriteToTxnTable) {
     const auto sessionId = makeLogicalSessionIdForTest();
     OperationSessionInfo sessionInfo;
@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/topology_version_notifier.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const auto getTopologyVersionNotifier =
+    ServiceContext::declareDecoration<TopologyVersionNotifier>();
+
+}  // namespace
+
+constexpr StringData TopologyVersionNotifier::kProcessIdFieldName;
+constexpr StringData TopologyVersionNotifier::kCounterFieldName;
+
+TopologyVersionNotifier* TopologyVersionNotifier::get(ServiceContext* service) {
+    return &getTopologyVersionNotifier(service);
+}
+
+BSONObj TopologyVersionNotifier::getTopologyVersion() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return BSON(kProcessIdFieldName << _processId << kCounterFieldName << _counter);
+}
+
+void TopologyVersionNotifier::onTopologyChange() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_counter;
+    _topologyChanged.notify_all();
+}
+
+void TopologyVersionNotifier::waitForTopologyChange(OperationContext* opCtx,
+                                                    const BSONObj& topologyVersion,
+                                                    Date_t deadline) const {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    opCtx->waitForConditionOrInterruptUntil(
+        _topologyChanged, lk, deadline, [&] { return !_isCurrent_inlock(topologyVersion); });
+}
+
+bool TopologyVersionNotifier::_isCurrent_inlock(const BSONObj& topologyVersion) const {
+    auto processId = topologyVersion[kProcessIdFieldName];
+    auto counter = topologyVersion[kCounterFieldName];
+    return processId.type() == BSONType::jstOID && processId.OID() == _processId &&
+        counter.isNumber() && counter.numberLong() == _counter;
+}
+
+}  // namespace repl
+}  // namespace mongo
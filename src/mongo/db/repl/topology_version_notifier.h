@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/oid.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+namespace repl {
+
+/**
+ * Tracks the version of this node's view of the replica set topology, which isMaster reports as
+ * 'topologyVersion'. The version changes whenever the member state, the ability to accept writes or
+ * the replica set config changes, so that a client which sends the version it last saw in an
+ * awaitable isMaster is answered as soon as there is something new to see.
+ *
+ * A version is the document {processId: <OID>, counter: <long>}. The process id is generated at
+ * startup, so versions reported by a process before it restarted never match later ones.
+ */
+class TopologyVersionNotifier {
+    TopologyVersionNotifier(const TopologyVersionNotifier&) = delete;
+    TopologyVersionNotifier& operator=(const TopologyVersionNotifier&) = delete;
+
+public:
+    static constexpr StringData kProcessIdFieldName = "processId"_sd;
+    static constexpr StringData kCounterFieldName = "counter"_sd;
+
+    TopologyVersionNotifier() = default;
+
+    static TopologyVersionNotifier* get(ServiceContext* service);
+
+    /**
+     * Returns the current topology version.
+     */
+    BSONObj getTopologyVersion() const;
+
+    /**
+     * Moves to a new topology version and wakes every waiter.
+     */
+    void onTopologyChange();
+
+    /**
+     * Blocks until the current topology version differs from 'topologyVersion' or until
+     * 'deadline'. Returns immediately if 'topologyVersion' was not reported by this process. Throws
+     * if 'opCtx' is interrupted.
+     */
+    void waitForTopologyChange(OperationContext* opCtx,
+                               const BSONObj& topologyVersion,
+                               Date_t deadline) const;
+
+private:
+    bool _isCurrent_inlock(const BSONObj& topologyVersion) const;
+
+    const OID _processId = OID::gen();
+
+    mutable stdx::mutex _mutex;
+    mutable stdx::condition_variable _topologyChanged;
+    long long _counter = 0;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/topology_version_notifier.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+class TopologyVersionNotifierTest : public ServiceContextTest {
+protected:
+    TopologyVersionNotifier* notifier() {
+        return TopologyVersionNotifier::get(getServiceContext());
+    }
+};
+
+TEST_F(TopologyVersionNotifierTest, CounterAdvancesOnTopologyChange) {
+    auto before = notifier()->getTopologyVersion();
+    notifier()->onTopologyChange();
+    auto after = notifier()->getTopologyVersion();
+
+    ASSERT_EQ(before["processId"].OID(), after["processId"].OID());
+    ASSERT_EQ(before["counter"].numberLong() + 1, after["counter"].numberLong());
+}
+
+TEST_F(TopologyVersionNotifierTest, WaitForStaleVersionReturnsImmediately) {
+    auto opCtx = makeOperationContext();
+    auto stale = notifier()->getTopologyVersion();
+    notifier()->onTopologyChange();
+
+    // The deadline is far away, so the test hangs if the wait does not return at once.
+    notifier()->waitForTopologyChange(opCtx.get(), stale, Date_t::max());
+}
+
+TEST_F(TopologyVersionNotifierTest, WaitForVersionOfAnotherProcessReturnsImmediately) {
+    auto opCtx = makeOperationContext();
+    auto current = notifier()->getTopologyVersion();
+    auto otherProcess = BSON("processId" << OID::gen() << "counter" << current["counter"]);
+    notifier()->waitForTopologyChange(opCtx.get(), otherProcess, Date_t::max());
+    notifier()->waitForTopologyChange(opCtx.get(), BSONObj(), Date_t::max());
+}
+
+TEST_F(TopologyVersionNotifierTest, WaitForCurrentVersionTimesOut) {
+    auto opCtx = makeOperationContext();
+    auto current = notifier()->getTopologyVersion();
+    notifier()->waitForTopologyChange(opCtx.get(), current, Date_t::now() + Milliseconds(10));
+    ASSERT_BSONOBJ_EQ(current, notifier()->getTopologyVersion());
+}
+
+TEST_F(TopologyVersionNotifierTest, TopologyChangeWakesWaiter) {
+    auto opCtx = makeOperationContext();
+    auto current = notifier()->getTopologyVersion();
+
+    stdx::thread changer([&] {
+        sleepmillis(10);
+        notifier()->onTopologyChange();
+    });
+    notifier()->waitForTopologyChange(opCtx.get(), current, Date_t::max());
+    changer.join();
+
+    ASSERT_BSONOBJ_NE(current, notifier()->getTopologyVersion());
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
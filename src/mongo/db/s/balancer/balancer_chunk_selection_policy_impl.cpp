@@ -37,10 +37,12 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/s/catalog_cache.h"
+#include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -171,14 +173,136 @@ private:
     BSONObjIndexedMap<BalancerChunkSelectionPolicy::SplitInfo> _chunkSplitPoints;
 };
 
+/**
+ * Returns the parts of the shard statistics which the policy's decisions depend on. The data sizes
+ * only matter through whether a shard is at its maximum size.
+ */
+BSONObj getShardsFingerprint(const ShardStatisticsVector& shardStats) {
+    BSONArrayBuilder shardsBuilder;
+    for (const auto& stat : shardStats) {
+        BSONObjBuilder shardBuilder(shardsBuilder.subobjStart());
+        shardBuilder.append("id", stat.shardId.toString());
+        shardBuilder.append("draining", stat.isDraining);
+        shardBuilder.append("sizeMaxed", stat.isSizeMaxed());
+        BSONArrayBuilder tagsBuilder(shardBuilder.subarrayStart("tags"));
+        tagsBuilder.append(stat.shardTags);
+    }
+    return BSON("shards" << shardsBuilder.arr());
+}
+
 }  // namespace
 
+void BalancerChunkSelectionPolicyImpl::QuiescentCollections::startRound(
+    const ShardStatisticsVector& shardStats, const CollectionStateMap& states) {
+    auto shards = getShardsFingerprint(shardStats);
+    if (!shards.binaryEqual(_shards)) {
+        _collections.clear();
+        _shards = std::move(shards);
+        return;
+    }
+
+    std::vector<std::string> gone;
+    for (const auto& entry : _collections) {
+        if (!states.count(entry.first)) {
+            gone.push_back(entry.first);
+        }
+    }
+
+    for (const auto& ns : gone) {
+        _collections.erase(ns);
+    }
+}
+
+bool BalancerChunkSelectionPolicyImpl::QuiescentCollections::isQuiescent(
+    StringData ns, const CollectionState& state) const {
+    auto it = _collections.find(ns);
+    return it != _collections.end() && it->second.version.binaryEqual(state.version) &&
+        it->second.zones.binaryEqual(state.zones);
+}
+
+void BalancerChunkSelectionPolicyImpl::QuiescentCollections::record(StringData ns,
+                                                                    const CollectionState& state,
+                                                                    bool quiescent) {
+    if (quiescent) {
+        _collections[ns] = state;
+    } else {
+        _collections.erase(ns);
+    }
+}
+
 BalancerChunkSelectionPolicyImpl::BalancerChunkSelectionPolicyImpl(ClusterStatistics* clusterStats,
                                                                    BalancerRandomSource& random)
     : _clusterStats(clusterStats), _random(random) {}
 
 BalancerChunkSelectionPolicyImpl::~BalancerChunkSelectionPolicyImpl() = default;
 
+StatusWith<BalancerChunkSelectionPolicyImpl::CollectionStateMap>
+BalancerChunkSelectionPolicyImpl::_getCollectionStates(OperationContext* opCtx) {
+    const auto configShard = Grid::get(opCtx)->shardRegistry()->getConfigShard();
+
+    // The latest chunk version of every collection, which the {ns: 1, lastmod: 1} index of
+    // config.chunks yields without scanning the chunks themselves
+    BSONArrayBuilder pipelineBuilder;
+    pipelineBuilder.append(
+        BSON("$sort" << BSON(ChunkType::ns() << -1 << ChunkType::lastmod() << -1)));
+    pipelineBuilder.append(BSON(
+        "$group" << BSON("_id"
+                         << ("$" + ChunkType::ns())
+                         << ChunkType::lastmod()
+                         << BSON("$first" << ("$" + ChunkType::lastmod()))
+                         << ChunkType::epoch()
+                         << BSON("$first" << ("$" + ChunkType::epoch())))));
+
+    auto swVersions = configShard->runExhaustiveCursorCommand(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        ChunkType::ConfigNS.db().toString(),
+        BSON("aggregate" << ChunkType::ConfigNS.coll() << "pipeline" << pipelineBuilder.arr()
+                         << "cursor"
+                         << BSONObj()
+                         << repl::ReadConcernArgs::kReadConcernFieldName
+                         << BSON(repl::ReadConcernArgs::kLevelFieldName << "majority")),
+        Milliseconds(-1));
+    if (!swVersions.isOK()) {
+        return swVersions.getStatus();
+    }
+
+    CollectionStateMap states;
+    for (const auto& doc : swVersions.getValue().docs) {
+        states[doc["_id"].str()].version = doc.getOwned();
+    }
+
+    auto swTags = configShard->exhaustiveFindOnConfig(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        repl::ReadConcernLevel::kMajorityReadConcern,
+        TagsType::ConfigNS,
+        BSONObj(),
+        BSON(TagsType::ns() << 1 << TagsType::min() << 1),
+        boost::none);
+    if (!swTags.isOK()) {
+        return swTags.getStatus();
+    }
+
+    // The tags are sorted by namespace, so each collection's zones are one contiguous run
+    const auto& tagDocs = swTags.getValue().docs;
+    for (auto it = tagDocs.begin(); it != tagDocs.end();) {
+        const std::string ns = (*it)[TagsType::ns()].str();
+
+        BSONArrayBuilder zonesBuilder;
+        for (; it != tagDocs.end() && (*it)[TagsType::ns()].str() == ns; ++it) {
+            zonesBuilder.append(*it);
+        }
+
+        auto stateIt = states.find(ns);
+        if (stateIt != states.end()) {
+            stateIt->second.zones = BSON("zones" << zonesBuilder.arr());
+        }
+    }
+
+    return states;
+}
+
 StatusWith<SplitInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToSplit(
     OperationContext* opCtx) {
     auto shardStatsStatus = _clusterStats->getStats(opCtx);
@@ -199,7 +323,16 @@ StatusWith<SplitInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToSpli
         return SplitInfoVector{};
     }
 
+    auto swStates = _getCollectionStates(opCtx);
+    if (swStates.isOK()) {
+        _collectionsNotToSplit.startRound(shardStats, swStates.getValue());
+    } else {
+        warning() << "Unable to determine which collections changed since the previous round; "
+                  << "checking all of them for splits" << causedBy(swStates.getStatus());
+    }
+
     SplitInfoVector splitCandidates;
+    size_t numSkipped = 0;
 
     std::shuffle(collections.begin(), collections.end(), _random);
 
@@ -210,6 +343,19 @@ StatusWith<SplitInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToSpli
 
         const NamespaceString nss(coll.getNs());
 
+        boost::optional<CollectionState> state;
+        if (swStates.isOK()) {
+            auto stateIt = swStates.getValue().find(nss.ns());
+            if (stateIt != swStates.getValue().end()) {
+                state = stateIt->second;
+            }
+        }
+
+        if (state && _collectionsNotToSplit.isQuiescent(nss.ns(), *state)) {
+            numSkipped++;
+            continue;
+        }
+
         auto candidatesStatus = _getSplitCandidatesForCollection(opCtx, nss, shardStats);
         if (candidatesStatus == ErrorCodes::NamespaceNotFound) {
             // Namespace got dropped before we managed to get to it, so just skip it
@@ -217,14 +363,24 @@ StatusWith<SplitInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToSpli
         } else if (!candidatesStatus.isOK()) {
             warning() << "Unable to enforce tag range policy for collection " << nss.ns()
                       << causedBy(candidatesStatus.getStatus());
+            if (state) {
+                _collectionsNotToSplit.record(nss.ns(), *state, false);
+            }
             continue;
         }
 
+        if (state) {
+            _collectionsNotToSplit.record(nss.ns(), *state, candidatesStatus.getValue().empty());
+        }
+
         splitCandidates.insert(splitCandidates.end(),
                                std::make_move_iterator(candidatesStatus.getValue().begin()),
                                std::make_move_iterator(candidatesStatus.getValue().end()));
     }
 
+    LOG(1) << "Skipped checking " << numSkipped
+           << " collections for splits because they did not change since the previous round";
+
     return splitCandidates;
 }
 
@@ -253,8 +409,24 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
         return MigrateInfoVector{};
     }
 
+    // Balancing by load depends on the operation counters, which change from one round to the
+    // next even if the collection metadata does not, so no collection can be skipped then
+    const bool canSkipCollections = balancerLoadImbalanceRatio.load() == 0;
+
+    auto swStates = canSkipCollections
+        ? _getCollectionStates(opCtx)
+        : StatusWith<CollectionStateMap>(ErrorCodes::IllegalOperation,
+                                         "balancing by load is enabled");
+    if (swStates.isOK()) {
+        _collectionsNotToMove.startRound(shardStats, swStates.getValue());
+    } else if (canSkipCollections) {
+        warning() << "Unable to determine which collections changed since the previous round; "
+                  << "checking all of them for migrations" << causedBy(swStates.getStatus());
+    }
+
     MigrateInfoVector candidateChunks;
     std::set<ShardId> usedShards;
+    size_t numSkipped = 0;
 
     std::shuffle(collections.begin(), collections.end(), _random);
 
@@ -270,6 +442,23 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
             continue;
         }
 
+        boost::optional<CollectionState> state;
+        if (swStates.isOK()) {
+            auto stateIt = swStates.getValue().find(nss.ns());
+            if (stateIt != swStates.getValue().end()) {
+                state = stateIt->second;
+            }
+        }
+
+        if (state && _collectionsNotToMove.isQuiescent(nss.ns(), *state)) {
+            numSkipped++;
+            continue;
+        }
+
+        // A collection is only known to be balanced if none of the shards was already taken by
+        // an earlier collection's migrations when it was evaluated
+        const bool allShardsAvailable = usedShards.empty();
+
         auto candidatesStatus =
             _getMigrateCandidatesForCollection(opCtx, nss, shardStats, &usedShards);
         if (candidatesStatus == ErrorCodes::NamespaceNotFound) {
@@ -278,14 +467,25 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
         } else if (!candidatesStatus.isOK()) {
             warning() << "Unable to balance collection " << nss.ns()
                       << causedBy(candidatesStatus.getStatus());
+            if (state) {
+                _collectionsNotToMove.record(nss.ns(), *state, false);
+            }
             continue;
         }
 
+        if (state) {
+            _collectionsNotToMove.record(
+                nss.ns(), *state, allShardsAvailable && candidatesStatus.getValue().empty());
+        }
+
         candidateChunks.insert(candidateChunks.end(),
                                std::make_move_iterator(candidatesStatus.getValue().begin()),
                                std::make_move_iterator(candidatesStatus.getValue().end()));
     }
 
+    LOG(1) << "Skipped checking " << numSkipped
+           << " collections for migrations because they did not change since the previous round";
+
     return candidateChunks;
 }
 
@@ -30,6 +30,7 @@
 
 #include "mongo/db/s/balancer/balancer_chunk_selection_policy.h"
 #include "mongo/db/s/balancer/balancer_random.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -52,6 +53,51 @@ public:
                             const ShardId& newShardId) override;
 
 private:
+    /**
+     * The state of a sharded collection's metadata, as far as the policy is concerned: the latest
+     * version of its chunks and its zone ranges.
+     */
+    struct CollectionState {
+        BSONObj version;
+        BSONObj zones;
+    };
+
+    using CollectionStateMap = StringMap<CollectionState>;
+
+    /**
+     * Remembers the collections for which the policy last found nothing to do, along with the
+     * state of each collection and of the shards at the time. As long as none of these change, the
+     * policy would reach the same conclusion again, so the collection can be skipped.
+     */
+    class QuiescentCollections {
+    public:
+        /**
+         * Forgets all collections if the parts of 'shardStats' that the policy depends on changed
+         * since the previous round, and those which no longer exist according to 'states'.
+         */
+        void startRound(const ShardStatisticsVector& shardStats, const CollectionStateMap& states);
+
+        /**
+         * Returns true if 'ns' needed no work when it was last in 'state'.
+         */
+        bool isQuiescent(StringData ns, const CollectionState& state) const;
+
+        /**
+         * Records whether 'ns', which is in 'state', needed any work.
+         */
+        void record(StringData ns, const CollectionState& state, bool quiescent);
+
+    private:
+        BSONObj _shards;
+        CollectionStateMap _collections;
+    };
+
+    /**
+     * Returns the state of every sharded collection which has chunks. Reads config.chunks and
+     * config.tags with one request each, rather than one per collection.
+     */
+    StatusWith<CollectionStateMap> _getCollectionStates(OperationContext* opCtx);
+
     /**
      * Synchronous method, which iterates the collection's chunks and uses the tags information to
      * figure out whether some of them validate the tag range boundaries and need to be split.
@@ -77,6 +123,11 @@ private:
 
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Collections which needed no splits and no migrations respectively, as of their last recorded
+    // state. Only used by the balancer thread, through selectChunksToSplit and selectChunksToMove.
+    QuiescentCollections _collectionsNotToSplit;
+    QuiescentCollections _collectionsNotToMove;
 };
 
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -39,6 +40,15 @@
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadImbalanceRatio, double, 0.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal != 0.0 && newVal < 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "balancerLoadImbalanceRatio must be 0 (disabled) or at least 1.0");
+        }
+        return Status::OK();
+    });
+
 using std::map;
 using std::numeric_limits;
 using std::set;
@@ -51,6 +61,16 @@ namespace {
 // optimal average across all shards for a zone for a rebalancing migration to be initiated.
 const size_t kDefaultImbalanceThreshold = 1;
 
+// When load-based balancing is enabled, the number of chunks above the optimal per-shard count a
+// shard is allowed to receive because of its low load. The count-based imbalance threshold is
+// raised by the same amount, so that those chunks are not immediately moved back.
+const size_t kLoadBasedChunkCountSlack = 2;
+
+// The minimum number of operations a shard must have served since the previous balancer round in
+// order to be considered for load-based balancing, so that idle clusters do not move chunks
+// around because of noise.
+const uint64_t kMinOpsForLoadBasedBalancing = 1000;
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -425,6 +445,18 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                                   &migrations,
                                   usedShards))
             ;
+
+        // 4) move load off the busiest shard of the zone, if enabled
+        const double loadImbalanceRatio = balancerLoadImbalanceRatio.load();
+        if (loadImbalanceRatio > 0) {
+            _singleZoneLoadBalance(shardStats,
+                                   distribution,
+                                   tag,
+                                   idealNumberOfChunksPerShardForTag,
+                                   loadImbalanceRatio,
+                                   &migrations,
+                                   usedShards);
+        }
     }
 
     return migrations;
@@ -476,16 +508,18 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
         return false;
 
     const size_t imbalance = max - idealNumberOfChunksPerShardForTag;
+    const size_t imbalanceThreshold = kDefaultImbalanceThreshold +
+        (balancerLoadImbalanceRatio.load() > 0 ? kLoadBasedChunkCountSlack : 0);
 
     LOG(1) << "collection : " << distribution.nss().ns();
     LOG(1) << "zone       : " << tag;
     LOG(1) << "donor      : " << from << " chunks on " << max;
     LOG(1) << "receiver   : " << to << " chunks on " << min;
     LOG(1) << "ideal      : " << idealNumberOfChunksPerShardForTag;
-    LOG(1) << "threshold  : " << kDefaultImbalanceThreshold;
+    LOG(1) << "threshold  : " << imbalanceThreshold;
 
     // Check whether it is necessary to balance within this zone
-    if (imbalance < kDefaultImbalanceThreshold)
+    if (imbalance < imbalanceThreshold)
         return false;
 
     const vector<ChunkType>& chunks = distribution.getChunks(from);
@@ -516,6 +550,70 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            const string& tag,
+                                            size_t idealNumberOfChunksPerShardForTag,
+                                            double loadImbalanceRatio,
+                                            vector<MigrateInfo>* migrations,
+                                            set<ShardId>* usedShards) {
+    const ClusterStatistics::ShardStatistics* busiest = nullptr;
+    const ClusterStatistics::ShardStatistics* leastBusy = nullptr;
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        if (!tag.empty() && !stat.shardTags.count(tag))
+            continue;
+
+        if (!stat.isDraining && (!busiest || stat.opsLoad() > busiest->opsLoad())) {
+            busiest = &stat;
+        }
+
+        if (isShardSuitableReceiver(stat, tag).isOK() &&
+            (!leastBusy || stat.opsLoad() < leastBusy->opsLoad())) {
+            leastBusy = &stat;
+        }
+    }
+
+    if (!busiest || !leastBusy || busiest == leastBusy)
+        return false;
+
+    if (busiest->opsLoad() < kMinOpsForLoadBasedBalancing ||
+        busiest->opsLoad() <= loadImbalanceRatio * leastBusy->opsLoad())
+        return false;
+
+    // Do not leave the donor without chunks or push the receiver far enough above the optimal
+    // chunk count that the count-based balancing would start moving chunks off it
+    if (distribution.numberOfChunksInShardWithTag(busiest->shardId, tag) <= 1)
+        return false;
+
+    if (distribution.numberOfChunksInShardWithTag(leastBusy->shardId, tag) + 1 >
+        idealNumberOfChunksPerShardForTag + kLoadBasedChunkCountSlack)
+        return false;
+
+    for (const auto& chunk : distribution.getChunks(busiest->shardId)) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo())
+            continue;
+
+        LOG(1) << "collection : " << distribution.nss().ns();
+        LOG(1) << "zone       : " << tag;
+        LOG(1) << "donor      : " << busiest->shardId << " ops " << busiest->opsLoad();
+        LOG(1) << "receiver   : " << leastBusy->shardId << " ops " << leastBusy->opsLoad();
+
+        migrations->emplace_back(leastBusy->shardId, chunk);
+        invariant(usedShards->insert(chunk.getShard()).second);
+        invariant(usedShards->insert(leastBusy->shardId).second);
+        return true;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
@@ -36,11 +36,17 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/platform/atomic_proxy.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_id.h"
 
 namespace mongo {
 
+// When non-zero, enables load-based balancing: a chunk is moved off the shard which served the
+// most reads and writes since the previous balancer round if it served more than this many times
+// the operations of the least loaded eligible shard. Zero disables load-based balancing.
+extern AtomicDouble balancerLoadImbalanceRatio;
+
 struct ZoneRange {
     ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone);
 
@@ -179,7 +185,9 @@ public:
      *
      * The balancing logic calculates the optimum number of chunks per shard for each zone and if
      * any of the shards have chunks, which are sufficiently higher than this number, suggests
-     * moving chunks to shards, which are under this number.
+     * moving chunks to shards, which are under this number. If load-based balancing is enabled,
+     * it additionally suggests moving chunks from the busiest shard of a zone to its least busy
+     * shard, so long as that keeps the chunk counts within a small slack of the optimum.
      *
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
@@ -234,6 +242,24 @@ private:
                                    size_t idealNumberOfChunksPerShardForTag,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * Selects one chunk for the specified zone to be moved from the shard which served the most
+     * operations since the previous round to the one which served the fewest, if their loads
+     * differ by more than 'loadImbalanceRatio' and the receiver would not end up with enough
+     * chunks above 'idealNumberOfChunksPerShardForTag' for the count-based balancing to move them
+     * back. Takes into account and updates the shards, which have already been used for
+     * migrations.
+     *
+     * Returns true if a migration was suggested, false otherwise.
+     */
+    static bool _singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                       const DistributionStatus& distribution,
+                                       const std::string& tag,
+                                       size_t idealNumberOfChunksPerShardForTag,
+                                       double loadImbalanceRatio,
+                                       std::vector<MigrateInfo>* migrations,
+                                       std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -110,6 +111,16 @@ std::pair<ShardStatisticsVector, ShardToChunksMap> generateCluster(
     return std::make_pair(std::move(shardStats), std::move(chunkMap));
 }
 
+/**
+ * Returns a copy of 'stat' which reports having served the specified number of reads and writes
+ * since the previous balancer round.
+ */
+ShardStatistics withLoad(ShardStatistics stat, uint64_t readOps, uint64_t writeOps) {
+    stat.readOps = readOps;
+    stat.writeOps = writeOps;
+    return stat;
+}
+
 std::vector<MigrateInfo> balanceChunks(const ShardStatisticsVector& shardStats,
                                        const DistributionStatus& distribution,
                                        bool shouldAggressivelyBalance) {
@@ -608,6 +619,91 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+TEST(BalancerPolicy, LoadBasedBalancingIsDisabledByDefault) {
+    auto cluster = generateCluster(
+        {{withLoad(ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion),
+                   50000,
+                   50000),
+          2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 2}});
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT(migrations.empty());
+}
+
+TEST(BalancerPolicy, LoadBasedBalancingMovesChunkOffBusiestShard) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+    balancerLoadImbalanceRatio.store(2.0);
+
+    auto cluster = generateCluster(
+        {{withLoad(ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion),
+                   1000,
+                   1000),
+          2},
+         {withLoad(ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion),
+                   20000,
+                   30000),
+          2},
+         {withLoad(ShardStatistics(kShardId2, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion),
+                   100,
+                   100),
+          2}});
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId1, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId1][0].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId1][0].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, LoadBasedBalancingIgnoresLoadBelowRatio) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+    balancerLoadImbalanceRatio.store(2.0);
+
+    auto cluster = generateCluster(
+        {{withLoad(ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion),
+                   15000,
+                   0),
+          2},
+         {withLoad(ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion),
+                   10000,
+                   0),
+          2}});
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT(migrations.empty());
+}
+
+TEST(BalancerPolicy, LoadBasedBalancingDoesNotOverloadReceiverWithChunks) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+    balancerLoadImbalanceRatio.store(2.0);
+
+    // The ideal number of chunks per shard is 4 and the idle shard already holds 2 more than that,
+    // which is within the slack tolerated for load-based balancing, so the count-based balancing
+    // does not move any chunks either.
+    auto cluster = generateCluster(
+        {{withLoad(ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion),
+                   50000,
+                   50000),
+          2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 6},
+         {withLoad(ShardStatistics(kShardId2, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion),
+                   50000,
+                   50000),
+          4}});
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT(migrations.empty());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
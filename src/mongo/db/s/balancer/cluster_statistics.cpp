@@ -72,6 +72,10 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    builder.append("readOps", static_cast<long long>(readOps));
+    builder.append("writeOps", static_cast<long long>(writeOps));
+    builder.append("networkBytesIn", static_cast<long long>(networkBytesIn));
+    builder.append("networkBytesOut", static_cast<long long>(networkBytesOut));
     return builder.obj();
 }
 
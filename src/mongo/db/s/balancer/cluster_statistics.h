@@ -70,6 +70,14 @@ public:
          */
         bool isSizeMaxed() const;
 
+        /**
+         * Returns the number of read and write operations the shard served since the previous
+         * statistics snapshot.
+         */
+        uint64_t opsLoad() const {
+            return readOps + writeOps;
+        }
+
         /**
          * Returns BSON representation of this shard's statistics, for reporting purposes.
          */
@@ -92,6 +100,14 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Activity on this shard's primary since the previous statistics snapshot. Reads are
+        // queries and getMores, writes are inserts, updates and deletes. All of these are zero if
+        // there is no previous snapshot to compare against or the primary could not be reached.
+        uint64_t readOps{0};
+        uint64_t writeOps{0};
+        uint64_t networkBytesIn{0};
+        uint64_t networkBytesOut{0};
     };
 
     virtual ~ClusterStatistics();
@@ -33,6 +33,7 @@
 #include "mongo/db/s/balancer/cluster_statistics_impl.h"
 
 #include <algorithm>
+#include <boost/optional.hpp>
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
@@ -48,16 +49,16 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
+const char kNetworkField[] = "network";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard's primary.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns the serverStatus response or an error. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -78,15 +79,16 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
-
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
-    if (!status.isOK()) {
-        return status;
-    }
+    return std::move(commandResponse.getValue().response);
+}
 
-    return version;
+/**
+ * Returns the value of the numeric field 'fieldName' from 'obj', or zero if it is missing or is
+ * not a non-negative number.
+ */
+uint64_t extractCounter(const BSONObj& obj, StringData fieldName) {
+    const auto value = obj[fieldName].safeNumberLong();
+    return value > 0 ? static_cast<uint64_t>(value) : 0;
 }
 
 }  // namespace
@@ -133,15 +135,36 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        boost::optional<ActivitySample> activity;
+
+        auto serverStatusStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatusStatus.isOK()) {
+            const auto& serverStatus = serverStatusStatus.getValue();
+
+            Status status = bsonExtractStringField(serverStatus, kVersionField, &mongoDVersion);
+            if (!status.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(status);
+            }
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
+            const auto opCounters = serverStatus[kOpCountersField];
+            const auto network = serverStatus[kNetworkField];
+            if (opCounters.type() == Object && network.type() == Object) {
+                activity.emplace();
+                activity->readOps = extractCounter(opCounters.Obj(), "query") +
+                    extractCounter(opCounters.Obj(), "getmore");
+                activity->writeOps = extractCounter(opCounters.Obj(), "insert") +
+                    extractCounter(opCounters.Obj(), "update") +
+                    extractCounter(opCounters.Obj(), "delete");
+                activity->networkBytesIn = extractCounter(network.Obj(), "bytesIn");
+                activity->networkBytesOut = extractCounter(network.Obj(), "bytesOut");
+            }
         } else {
-            // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
+            // Since the mongod version and activity are only used for reporting and load-based
+            // balancing, there is no need to fail the entire round if they cannot be retrieved,
+            // so just leave them empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(serverStatusStatus.getStatus());
         }
 
         std::set<std::string> shardTags;
@@ -156,9 +179,38 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+
+        if (activity) {
+            _updateActivity(shard.getName(), *activity, &stats.back());
+        }
     }
 
     return stats;
 }
 
+void ClusterStatisticsImpl::_updateActivity(const ShardId& shardId,
+                                            const ActivitySample& sample,
+                                            ShardStatistics* stats) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _lastActivitySamples.find(shardId);
+    if (it == _lastActivitySamples.end()) {
+        _lastActivitySamples.emplace(shardId, sample);
+        return;
+    }
+
+    // A counter which went backwards means the primary was restarted or has changed, in which
+    // case the new sample only serves as the baseline for the next one
+    const auto delta = [](uint64_t current, uint64_t previous) -> uint64_t {
+        return current >= previous ? current - previous : 0;
+    };
+
+    auto& previous = it->second;
+    stats->readOps = delta(sample.readOps, previous.readOps);
+    stats->writeOps = delta(sample.writeOps, previous.writeOps);
+    stats->networkBytesIn = delta(sample.networkBytesIn, previous.networkBytesIn);
+    stats->networkBytesOut = delta(sample.networkBytesOut, previous.networkBytesOut);
+    previous = sample;
+}
+
 }  // namespace mongo
@@ -28,8 +28,11 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -37,6 +40,9 @@ namespace mongo {
  * Default implementation for the cluster statistics gathering utility. Uses a blocking method to
  * fetch the statistics and does not perform any caching. If any of the shards fails to report
  * statistics fails the entire refresh.
+ *
+ * The per-shard operation and network counters are reported as the difference from the values
+ * sampled by the previous call to getStats, so only the last sample of each shard is retained.
  */
 class ClusterStatisticsImpl final : public ClusterStatistics {
 public:
@@ -46,8 +52,33 @@ public:
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
 
 private:
+    /**
+     * Cumulative activity counters reported by a shard primary's serverStatus.
+     */
+    struct ActivitySample {
+        uint64_t readOps{0};
+        uint64_t writeOps{0};
+        uint64_t networkBytesIn{0};
+        uint64_t networkBytesOut{0};
+    };
+
+    /**
+     * Records 'sample' as the latest one for the specified shard and fills in the activity fields
+     * of 'stats' with the difference from the previously recorded sample.
+     */
+    void _updateActivity(const ShardId& shardId,
+                         const ActivitySample& sample,
+                         ShardStatistics* stats);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Protects '_lastActivitySamples', since statistics may be requested concurrently by the
+    // balancer thread and by user-initiated chunk moves.
+    stdx::mutex _mutex;
+
+    // The last activity sample taken from each shard
+    std::map<ShardId, ActivitySample> _lastActivitySamples;
 };
 
 }  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/index_legacy.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -151,6 +152,10 @@ public:
         BSONObj missingFieldObj = IndexLegacy::getMissingField(collection, idx->infoObj());
         BSONElement missingField = missingFieldObj.firstElement();
 
+        // Only the hashed field of an index represents a missing field by a hash value, any other
+        // fields represent it as null.
+        const BSONObj nullObj = BSON("" << BSONNULL);
+
         // for now, the only check is that all shard keys are filled
         // a 'missingField' valued index key is ok if the field is present in the document,
         // TODO if $exist for nulls were picking the index, it could be used instead efficiently
@@ -162,6 +167,7 @@ public:
         while (PlanExecutor::ADVANCED == (state = exec->getNext(&currKey, &loc))) {
             // check that current key contains non missing elements for all fields in keyPattern
             BSONObjIterator i(currKey);
+            BSONObjIterator j(keyPattern);
             for (int k = 0; k < keyPatternLength; k++) {
                 if (!i.more()) {
                     errmsg = str::stream() << "index key " << currKey << " too short for pattern "
@@ -169,22 +175,22 @@ public:
                     return false;
                 }
                 BSONElement currKeyElt = i.next();
+                BSONElement patternElt = j.next();
+
+                const BSONElement fieldMissingElt = ShardKeyPattern::isHashedPatternEl(patternElt)
+                    ? missingField
+                    : nullObj.firstElement();
 
                 const StringData::ComparatorInterface* stringComparator = nullptr;
                 BSONElementComparator eltCmp(BSONElementComparator::FieldNamesMode::kIgnore,
                                              stringComparator);
-                if (!currKeyElt.eoo() && eltCmp.evaluate(currKeyElt != missingField))
+                if (!currKeyElt.eoo() && eltCmp.evaluate(currKeyElt != fieldMissingElt))
                     continue;
 
                 // This is a fetch, but it's OK.  The underlying code won't throw a page fault
                 // exception.
                 BSONObj obj = collection->docFor(opCtx, loc).value();
-                BSONObjIterator j(keyPattern);
-                BSONElement real;
-                for (int x = 0; x <= k; x++)
-                    real = j.next();
-
-                real = dps::extractElementAtPath(obj, real.fieldName());
+                BSONElement real = dps::extractElementAtPath(obj, patternElt.fieldName());
 
                 if (real.type())
                     continue;
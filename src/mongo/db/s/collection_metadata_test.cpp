@@ -191,6 +191,24 @@ TEST_F(SingleChunkFixture, KeyBelongsToMe) {
     ASSERT(!makeCollectionMetadata()->keyBelongsToMe(BSONObj()));
 }
 
+TEST_F(SingleChunkFixture, KeyBelongsToMeReturnsChunkRange) {
+    auto metadata(makeCollectionMetadata());
+    boost::optional<ChunkRange> chunkRange;
+
+    ASSERT(metadata->keyBelongsToMe(BSON("a" << 15), &chunkRange));
+    ASSERT(chunkRange);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 10), chunkRange->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 20), chunkRange->getMax());
+
+    ASSERT(!metadata->keyBelongsToMe(BSON("a" << 25), &chunkRange));
+    ASSERT(chunkRange);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 20), chunkRange->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << MAXKEY), chunkRange->getMax());
+
+    ASSERT(!metadata->keyBelongsToMe(BSONObj(), &chunkRange));
+    ASSERT(!chunkRange);
+}
+
 TEST_F(SingleChunkFixture, GetNextChunk) {
     ChunkType nextChunk;
     ASSERT(
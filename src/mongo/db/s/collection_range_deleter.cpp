@@ -48,6 +48,7 @@
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/sharding_statistics.h"
@@ -58,6 +59,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -69,6 +71,31 @@ MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 20)
         return Status::OK();
     });
 
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterBatchSize must not be negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxReplicationLagSecs, int, 10)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "rangeDeleterMaxReplicationLagSecs must not be negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxBatchTimeMS, int, 100)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterMaxBatchTimeMS must not be negative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 using Deletion = CollectionRangeDeleter::Deletion;
@@ -78,6 +105,34 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 WriteConcernOptions::kWriteConcernTimeoutSharding);
 
+// The most documents deleted in a single storage transaction. Grouping deletions saves a commit
+// per document, while keeping a write conflict from having to redo much work.
+const int kMaxDeletesPerWriteUnitOfWork = 16;
+
+// The longest the range deleter backs off between batches because of replication lag or slow
+// batches, on top of rangeDeleterBatchDelayMS.
+const Milliseconds kMaxRangeDeleterBackoff = Seconds(10);
+
+/**
+ * Returns how far the majority commit point trails this node's last applied operation, or zero if
+ * that is not known.
+ */
+Seconds getMajorityReplicationLag(OperationContext* opCtx) {
+    auto const replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+        return Seconds(0);
+    }
+
+    const auto lastCommitted = replCoord->getLastCommittedOpTime();
+    const auto lastApplied = replCoord->getMyLastAppliedOpTime();
+    if (lastCommitted.isNull() || lastApplied <= lastCommitted) {
+        return Seconds(0);
+    }
+
+    return Seconds(static_cast<long long>(lastApplied.getTimestamp().getSecs()) -
+                   lastCommitted.getTimestamp().getSecs());
+}
+
 boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& deletions,
                                                  ChunkRange const& range) {
     // Start search with newest entries by using reverse iterators
@@ -108,6 +163,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     CollectionRangeDeleter* forTestOnly) {
 
     StatusWith<int> wrote = 0;
+    Milliseconds batchDelay(rangeDeleterBatchDelayMS.load());
 
     auto range = boost::optional<ChunkRange>(boost::none);
     auto notification = DeleteNotification();
@@ -218,13 +274,19 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
             }
         }
 
+        Timer batchTimer;
         try {
-            wrote = self->_doDeletion(
-                opCtx, collection, metadata->getKeyPattern(), *range, maxToDelete);
+            wrote = self->_doDeletion(opCtx,
+                                      collection,
+                                      metadata->getKeyPattern(),
+                                      *range,
+                                      self->_nextBatchSize(maxToDelete));
         } catch (const DBException& e) {
             wrote = e.toStatus();
             warning() << e.what();
         }
+
+        batchDelay = self->_throttleAfterBatch(opCtx, Milliseconds(batchTimer.millis()));
     }  // drop autoColl
 
     if (!wrote.isOK() || wrote.getValue() == 0) {
@@ -289,7 +351,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
                    << redact(self->_orphans.front().range.toString()) << " next.";
         }
 
-        return Date_t::now() + stdx::chrono::milliseconds{rangeDeleterBatchDelayMS.load()};
+        return Date_t::now() + batchDelay;
     }
 
     invariant(range);
@@ -297,7 +359,38 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     invariant(wrote.getValue() > 0);
 
     notification.abandon();
-    return Date_t::now() + stdx::chrono::milliseconds{rangeDeleterBatchDelayMS.load()};
+    return Date_t::now() + batchDelay;
+}
+
+int CollectionRangeDeleter::_nextBatchSize(int maxToDelete) const {
+    return std::max(1, static_cast<int>(maxToDelete * _batchSizeFraction));
+}
+
+Milliseconds CollectionRangeDeleter::_throttleAfterBatch(OperationContext* opCtx,
+                                                         Milliseconds batchTime) {
+    const Milliseconds baseDelay(rangeDeleterBatchDelayMS.load());
+
+    const auto maxLag = rangeDeleterMaxReplicationLagSecs.load();
+    const auto maxBatchTime = rangeDeleterMaxBatchTimeMS.load();
+    const auto lag = maxLag > 0 ? getMajorityReplicationLag(opCtx) : Seconds(0);
+
+    const bool lagging = maxLag > 0 && lag > Seconds(maxLag);
+    const bool slow = maxBatchTime > 0 && batchTime > Milliseconds(maxBatchTime);
+
+    if (!lagging && !slow) {
+        _batchSizeFraction = std::min(1.0, _batchSizeFraction * 2);
+        _backoff = Milliseconds(0);
+        return baseDelay;
+    }
+
+    _batchSizeFraction = std::max(_batchSizeFraction / 2, 1e-6);
+    _backoff = std::min(std::max(_backoff * 2, std::max(baseDelay, batchTime)),
+                        kMaxRangeDeleterBackoff);
+
+    LOG(1) << "Throttling range deletions after a batch which took " << batchTime
+           << " with a replication lag of " << lag << "; next batch in " << baseDelay + _backoff;
+
+    return baseDelay + _backoff;
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
@@ -355,31 +448,52 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
 
     int numDeleted = 0;
-    do {
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
+    bool done = false;
+    while (!done && numDeleted < maxToDelete) {
+        // Gather a group of documents to remove in a single storage transaction
+        std::vector<std::pair<RecordId, BSONObj>> toDelete;
+        while (numDeleted + static_cast<int>(toDelete.size()) < maxToDelete &&
+               toDelete.size() < static_cast<size_t>(kMaxDeletesPerWriteUnitOfWork)) {
+            RecordId rloc;
+            BSONObj obj;
+            PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+            if (state == PlanExecutor::IS_EOF) {
+                done = true;
+                break;
+            }
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                warning() << PlanExecutor::statestr(state)
+                          << " - cursor error while trying to delete " << redact(min) << " to "
+                          << redact(max) << " in " << nss << ": "
+                          << redact(WorkingSetCommon::toStatusString(obj))
+                          << ", stats: " << Explain::getWinningPlanStats(exec.get());
+                done = true;
+                break;
+            }
+            invariant(PlanExecutor::ADVANCED == state);
+
+            // The document is only needed if it has to be saved before being removed
+            toDelete.emplace_back(rloc, saver ? obj.getOwned() : BSONObj());
         }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning() << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                      << redact(min) << " to " << redact(max) << " in " << nss << ": "
-                      << redact(WorkingSetCommon::toStatusString(obj))
-                      << ", stats: " << Explain::getWinningPlanStats(exec.get());
+
+        if (toDelete.empty()) {
             break;
         }
-        invariant(PlanExecutor::ADVANCED == state);
 
         exec->saveState();
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
             WriteUnitOfWork wuow(opCtx);
-            if (saver) {
-                uassertStatusOK(saver->goingToDelete(obj));
+            for (const auto& entry : toDelete) {
+                if (saver) {
+                    uassertStatusOK(saver->goingToDelete(entry.second));
+                }
+                collection->deleteDocument(opCtx, kUninitializedStmtId, entry.first, nullptr, true);
             }
-            collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
             wuow.commit();
         });
+        numDeleted += toDelete.size();
+        ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(toDelete.size());
+
         auto restoreStateStatus = exec->restoreState();
         if (!restoreStateStatus.isOK()) {
             warning() << "error restoring cursor state while trying to delete " << redact(min)
@@ -388,9 +502,7 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
                       << redact(restoreStateStatus);
             break;
         }
-        ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(1);
-
-    } while (++numDeleted < maxToDelete);
+    }
 
     return numDeleted;
 }
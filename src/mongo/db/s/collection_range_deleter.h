@@ -46,6 +46,19 @@ class OperationContext;
 // next batch of deletions.
 extern AtomicInt32 rangeDeleterBatchDelayMS;
 
+// The maximum number of documents the range deleter removes in one batch. Zero means to use
+// internalQueryExecYieldIterations.
+extern AtomicInt32 rangeDeleterBatchSize;
+
+// If the majority commit point falls further than this many seconds behind the last applied
+// operation, the range deleter shrinks its batches and backs off. Zero disables the check.
+extern AtomicInt32 rangeDeleterMaxReplicationLagSecs;
+
+// If deleting a batch holds the collection lock for longer than this many milliseconds, which
+// happens when the deletions compete with foreground operations, the range deleter shrinks its
+// batches and backs off. Zero disables the check.
+extern AtomicInt32 rangeDeleterMaxBatchTimeMS;
+
 class CollectionRangeDeleter {
     MONGO_DISALLOW_COPYING(CollectionRangeDeleter);
 
@@ -161,6 +174,9 @@ public:
      * watchers of ranges as they are done being deleted. It performs its own collection locking, so
      * it must be called without locks.
      *
+     * While the previous batches ran into replication lag or took too long, fewer than
+     * maxToDelete documents are deleted and the returned time is pushed further out.
+     *
      * If it should be scheduled to run again because there might be more documents to delete,
      * returns the time to begin, or boost::none otherwise.
      *
@@ -193,12 +209,30 @@ private:
      */
     void _pop(Status status);
 
+    /**
+     * Returns how many documents the next batch should delete, given the caller's maximum.
+     */
+    int _nextBatchSize(int maxToDelete) const;
+
+    /**
+     * Adjusts the batch size and backoff after a batch which took 'batchTime' to delete, and
+     * returns how long to wait before deleting the next batch.
+     */
+    Milliseconds _throttleAfterBatch(OperationContext* opCtx, Milliseconds batchTime);
+
     /**
      * Ranges scheduled for deletion.  The front of the list will be in active process of deletion.
      * As each range is completed, its notification is signaled before it is popped.
      */
     std::list<Deletion> _orphans;
     std::list<Deletion> _delayedOrphans;
+
+    // Adaptive throttling state, only accessed by the range deleter task. Batches delete this
+    // fraction of the documents the caller allows, and '_backoff' is added to the delay between
+    // batches. Pressure halves the fraction and doubles the backoff; batches without pressure
+    // grow the fraction back and clear the backoff.
+    double _batchSizeFraction{1.0};
+    Milliseconds _backoff{0};
 };
 
 }  // namespace mongo
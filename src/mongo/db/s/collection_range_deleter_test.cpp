@@ -45,6 +45,7 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -231,6 +232,52 @@ TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCalls) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kShardKey << "startRangeDeletion")));
 }
 
+// Tests that the range deleter shrinks its batches and backs off while replication is lagging, and
+// recovers once the lag is no longer a concern.
+TEST_F(CollectionRangeDeleterTest, CleanupNextRangeThrottlesOnReplicationLag) {
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    for (int i = 0; i < 10; ++i) {
+        dbclient.insert(kNss.toString(), BSON(kShardKey << i));
+    }
+    ASSERT_EQUALS(10ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+
+    std::list<Deletion> ranges;
+    auto deletion = Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 10)), Date_t{}};
+    ranges.emplace_back(std::move(deletion));
+    auto when = rangeDeleter.add(std::move(ranges));
+    ASSERT(when && *when == Date_t{});
+
+    const auto originalMaxLag = rangeDeleterMaxReplicationLagSecs.load();
+    ON_BLOCK_EXIT([&] { rangeDeleterMaxReplicationLagSecs.store(originalMaxLag); });
+    rangeDeleterMaxReplicationLagSecs.store(10);
+
+    // The majority commit point trails the last applied operation by a minute
+    replicationCoordinator()->setMyLastAppliedOpTime(repl::OpTime(Timestamp(1000, 1), 1));
+    replicationCoordinator()->setLastCommittedOpTime(repl::OpTime(Timestamp(940, 1), 1));
+
+    // The first batch is full sized, but pushes the next one out by more than the usual delay
+    const auto beforeFirstBatch = Date_t::now();
+    auto nextBatchTime = next(rangeDeleter, 4);
+    ASSERT(nextBatchTime);
+    ASSERT_GTE(*nextBatchTime,
+               beforeFirstBatch + Milliseconds(2 * rangeDeleterBatchDelayMS.load()));
+    ASSERT_EQUALS(6ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+
+    // While the lag persists, each batch is half the size of the previous one
+    ASSERT_TRUE(next(rangeDeleter, 4));
+    ASSERT_EQUALS(4ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+
+    // Without the lag check, the batch size grows back
+    rangeDeleterMaxReplicationLagSecs.store(0);
+    ASSERT_TRUE(next(rangeDeleter, 4));
+    ASSERT_EQUALS(3ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+    ASSERT_TRUE(next(rangeDeleter, 4));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+    ASSERT_TRUE(next(rangeDeleter, 4));
+    ASSERT_EQUALS(0ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+}
+
 // Tests the case that there are two ranges to clean, each containing multiple documents.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     CollectionRangeDeleter rangeDeleter;
@@ -452,8 +452,9 @@ void migrateAndFurtherSplitInitialChunks(OperationContext* opCtx,
                                          const std::vector<BSONObj>& finalSplitPoints) {
     auto catalogCache = Grid::get(opCtx)->catalogCache();
 
-    if (!shardKeyPattern.isHashedPattern()) {
-        // Only initially move chunks when using a hashed shard key.
+    if (!shardKeyPattern.hasHashedPrefix()) {
+        // Only initially move chunks when the shard key starts with a hashed field, since only
+        // then were the initial chunks spread across the range of hash values.
         return;
     }
 
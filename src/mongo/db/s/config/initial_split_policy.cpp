@@ -113,10 +113,12 @@ void InitialSplitPolicy::calculateHashedSplitPointsForEmptyCollection(
     int numInitialChunks,
     std::vector<BSONObj>* initialSplitPoints,
     std::vector<BSONObj>* finalSplitPoints) {
-    if (!shardKeyPattern.isHashedPattern() || !isEmpty) {
+    if (!shardKeyPattern.hasHashedPrefix() || !isEmpty) {
         uassert(ErrorCodes::InvalidOptions,
-                str::stream() << "numInitialChunks is not supported when the collection is not "
-                              << (!shardKeyPattern.isHashedPattern() ? "hashed" : "empty"),
+                str::stream() << "numInitialChunks is not supported when "
+                              << (!shardKeyPattern.hasHashedPrefix()
+                                      ? "the shard key does not start with a hashed field"
+                                      : "the collection is not empty"),
                 !numInitialChunks);
         return;
     }
@@ -142,16 +144,28 @@ void InitialSplitPolicy::calculateHashedSplitPointsForEmptyCollection(
 
     const auto proposedKey(shardKeyPattern.getKeyPattern().toBSON());
 
+    // Any fields after the hashed prefix are compounded with MinKey, so that each split point is
+    // the lowest shard key with that hash value.
+    auto makeSplitPoint = [&proposedKey](long long hashValue) {
+        BSONObjBuilder splitPoint;
+        BSONObjIterator patternIt(proposedKey);
+        splitPoint.append(patternIt.next().fieldName(), hashValue);
+        while (patternIt.more()) {
+            splitPoint.appendMinKey(patternIt.next().fieldName());
+        }
+        return splitPoint.obj();
+    };
+
     if (numInitialChunks % 2 == 0) {
-        finalSplitPoints->push_back(BSON(proposedKey.firstElementFieldName() << current));
+        finalSplitPoints->push_back(makeSplitPoint(current));
         current += intervalSize;
     } else {
         current += intervalSize / 2;
     }
 
     for (int i = 0; i < (numInitialChunks - 1) / 2; i++) {
-        finalSplitPoints->push_back(BSON(proposedKey.firstElementFieldName() << current));
-        finalSplitPoints->push_back(BSON(proposedKey.firstElementFieldName() << -current));
+        finalSplitPoints->push_back(makeSplitPoint(current));
+        finalSplitPoints->push_back(makeSplitPoint(-current));
         current += intervalSize;
     }
 
@@ -135,6 +135,40 @@ TEST(CalculateHashedSplitPointsTest, NonEmptyCollectionHashedWithInitialSplitsFa
                        ErrorCodes::InvalidOptions);
 }
 
+TEST(CalculateHashedSplitPointsTest, EmptyCollectionCompoundHashedPrefix) {
+    std::vector<BSONObj> initialSplitPoints;
+    std::vector<BSONObj> finalSplitPoints;
+    InitialSplitPolicy::calculateHashedSplitPointsForEmptyCollection(
+        ShardKeyPattern(BSON("x"
+                             << "hashed"
+                             << "y"
+                             << 1)),
+        true,
+        2,
+        2,
+        &initialSplitPoints,
+        &finalSplitPoints);
+
+    const std::vector<BSONObj> expectedSplitPoints = {BSON("x" << 0 << "y" << MINKEY)};
+    assertBSONObjVectorsAreEqual(expectedSplitPoints, initialSplitPoints);
+    assertBSONObjVectorsAreEqual(expectedSplitPoints, finalSplitPoints);
+}
+
+TEST(CalculateHashedSplitPointsTest, CompoundHashedSuffixWithInitialSplitsFails) {
+    std::vector<BSONObj> initialSplitPoints;
+    std::vector<BSONObj> finalSplitPoints;
+    ASSERT_THROWS_CODE(InitialSplitPolicy::calculateHashedSplitPointsForEmptyCollection(
+                           ShardKeyPattern(BSON("x" << 1 << "y"
+                                                    << "hashed")),
+                           true,
+                           2,
+                           2,
+                           &initialSplitPoints,
+                           &finalSplitPoints),
+                       AssertionException,
+                       ErrorCodes::InvalidOptions);
+}
+
 TEST(CalculateHashedSplitPointsTest, NotHashedWithInitialSplitsFails) {
     std::vector<BSONObj> expectedSplitPoints;
     ASSERT_THROWS_CODE(checkCalculatedHashedSplitPoints(
@@ -444,15 +444,34 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                                                         BSONArrayBuilder* arrBuilder) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(_args.getNss().ns(), MODE_IS));
 
+    const int yieldIterations = internalQueryExecYieldIterations.load();
     ElapsedTracker tracker(opCtx->getServiceContext()->getFastClockSource(),
-                           internalQueryExecYieldIterations.load(),
+                           yieldIterations,
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    // Claim the record ids this call is expected to get through before reading any documents, so
+    // that '_mutex' is not held while reading them. This lets concurrent _migrateClone requests
+    // from the recipient build their batches in parallel and keeps the op observers, which also
+    // take '_mutex', from waiting on document reads.
+    std::vector<RecordId> claimedLocs;
+    {
+        stdx::lock_guard<stdx::mutex> sl(_mutex);
+
+        const uint64_t bytesAvailable = std::max(BSONObjMaxUserSize - arrBuilder->len(), 0);
+        const uint64_t avgObjSize = std::max<uint64_t>(_averageObjectSizeForCloneLocs, 1);
+        const std::size_t numToClaim = std::max<std::size_t>(
+            1, std::min<uint64_t>(std::max(yieldIterations, 1), bytesAvailable / avgObjSize));
+
+        auto it = _cloneLocs.begin();
+        while (it != _cloneLocs.end() && claimedLocs.size() < numToClaim) {
+            claimedLocs.push_back(*it++);
+        }
+        _cloneLocs.erase(_cloneLocs.begin(), it);
+    }
 
-    std::set<RecordId>::iterator it;
+    auto it = claimedLocs.begin();
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
+    for (; it != claimedLocs.end(); ++it) {
         // We must always make progress in this method by at least one document because empty return
         // indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
@@ -473,7 +492,12 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
         }
     }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+    // Return the record ids which did not make it into this batch. The request which claimed them
+    // made progress, so the recipient will ask again before it considers the clone finished.
+    if (it != claimedLocs.end()) {
+        stdx::lock_guard<stdx::mutex> sl(_mutex);
+        _cloneLocs.insert(it, claimedLocs.end());
+    }
 
     return Status::OK();
 }
@@ -32,6 +32,7 @@
 
 #include "mongo/db/s/migration_destination_manager.h"
 
+#include <algorithm>
 #include <list>
 #include <vector>
 
@@ -53,6 +54,7 @@
 #include "mongo/db/s/move_timing_helper.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/s/start_chunk_clone_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -67,6 +69,25 @@
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(migrationCloneBatchesInFlight, int, 2)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "migrationCloneBatchesInFlight must be between 1 and 16");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(migrationCloneInsertionThreads, int, 2)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "migrationCloneInsertionThreads must be between 1 and 16");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 const auto getMigrationDestinationManager =
@@ -377,46 +398,157 @@ void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
     stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
+    const int numFetchers = migrationCloneBatchesInFlight.load();
+    const int numInserters = migrationCloneInsertionThreads.load();
+
+    // Each inserter stops when it pops an empty batch. Only the main thread pushes those, once all
+    // the fetchers have seen the end of the clone data. The queue supports a single producer, so
+    // pushes from the main thread and the additional fetcher threads are serialized.
+    ProducerConsumerQueue<BSONObj> batches(numInserters);
+    stdx::mutex pushMutex;
+    auto pushBatch = [&](BSONObj batch, OperationContext* pushOpCtx) {
+        stdx::lock_guard<stdx::mutex> lk(pushMutex);
+        batches.push(std::move(batch), pushOpCtx);
+    };
+
+    std::vector<stdx::thread> inserterThreads;
+    auto inserterThreadsJoinGuard = MakeGuard([&] {
+        batches.closeProducerEnd();
+        for (auto& inserterThread : inserterThreads) {
+            inserterThread.join();
+        }
+    });
+    for (int i = 0; i < numInserters; ++i) {
+        inserterThreads.emplace_back([&] {
+            Client::initThreadIfNotAlready("chunkInserter");
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            try {
+                while (true) {
+                    auto nextBatch = batches.pop(inserterOpCtx.get());
+                    auto arr = nextBatch["objects"].Obj();
+                    if (arr.isEmpty()) {
+                        return;
+                    }
+                    insertBatchFn(inserterOpCtx.get(), arr);
+                }
+            } catch (...) {
+                {
+                    stdx::lock_guard<Client> lk(*opCtx->getClient());
+                    opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
+                }
+                batches.closeConsumerEnd();
+                log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+            }
+        });
+    }
+
+    // The additional fetchers issue their own _migrateClone requests, so that several batches are
+    // on the wire at the same time. An error from one of them is recorded and interrupts the main
+    // thread, which rethrows it once everything has been shut down.
+    stdx::mutex fetcherMutex;
+    std::vector<OperationContext*> fetcherOpCtxs;
+    Status fetchError = Status::OK();
+    bool fetchersDone = false;
+
+    std::vector<stdx::thread> fetcherThreads;
+    auto fetcherThreadsJoinGuard = MakeGuard([&] {
+        {
+            stdx::lock_guard<stdx::mutex> lk(fetcherMutex);
+            fetchersDone = true;
+            for (auto fetcherOpCtx : fetcherOpCtxs) {
+                stdx::lock_guard<Client> clientLock(*fetcherOpCtx->getClient());
+                fetcherOpCtx->getServiceContext()->killOperation(fetcherOpCtx,
+                                                                 ErrorCodes::Interrupted);
+            }
+        }
+        batches.closeConsumerEnd();
+        for (auto& fetcherThread : fetcherThreads) {
+            fetcherThread.join();
+        }
+    });
+    for (int i = 1; i < numFetchers; ++i) {
+        fetcherThreads.emplace_back([&] {
+            Client::initThreadIfNotAlready("chunkFetcher");
+            auto fetcherOpCtx = Client::getCurrent()->makeOperationContext();
+            {
+                stdx::lock_guard<stdx::mutex> lk(fetcherMutex);
+                if (fetchersDone) {
+                    return;
+                }
+                fetcherOpCtxs.push_back(fetcherOpCtx.get());
+            }
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<stdx::mutex> lk(fetcherMutex);
+                fetcherOpCtxs.erase(
+                    std::find(fetcherOpCtxs.begin(), fetcherOpCtxs.end(), fetcherOpCtx.get()));
+            });
 
-    ProducerConsumerQueue<BSONObj> batches(1);
-    stdx::thread inserterThread{[&] {
-        Client::initThreadIfNotAlready("chunkInserter");
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
-        try {
             while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
+                BSONObj res;
+                try {
+                    res = fetchBatchFn(fetcherOpCtx.get());
+                    if (res["objects"].Obj().isEmpty()) {
+                        return;
+                    }
+                } catch (const DBException& ex) {
+                    stdx::lock_guard<stdx::mutex> lk(fetcherMutex);
+                    if (!fetchersDone && fetchError.isOK()) {
+                        fetchError = ex.toStatus();
+                        stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+                        opCtx->getServiceContext()->killOperation(opCtx, fetchError.code());
+                    }
+                    return;
+                }
+
+                try {
+                    pushBatch(res.getOwned(), fetcherOpCtx.get());
+                } catch (const DBException&) {
+                    // The queue is only closed or this fetcher interrupted once the clone has
+                    // failed, and the main thread reports that failure
                     return;
                 }
-                insertBatchFn(inserterOpCtx.get(), arr);
             }
-        } catch (...) {
-            stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
-            log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
-        }
-    }};
-    auto inserterThreadJoinGuard = MakeGuard([&] {
-        batches.closeProducerEnd();
-        inserterThread.join();
-    });
+        });
+    }
 
-    while (true) {
-        opCtx->checkForInterrupt();
+    try {
+        while (true) {
+            opCtx->checkForInterrupt();
 
-        auto res = fetchBatchFn(opCtx);
+            auto res = fetchBatchFn(opCtx);
 
+            opCtx->checkForInterrupt();
+            auto arr = res["objects"].Obj();
+            if (arr.isEmpty()) {
+                break;
+            }
+            pushBatch(res.getOwned(), opCtx);
+        }
+
+        // Wait for the remaining in-flight batches before telling the inserters to stop
+        fetcherThreadsJoinGuard.Dismiss();
+        for (auto& fetcherThread : fetcherThreads) {
+            fetcherThread.join();
+        }
         opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
-        auto arr = res["objects"].Obj();
-        if (arr.isEmpty()) {
-            inserterThreadJoinGuard.Dismiss();
+
+        for (int i = 0; i < numInserters; ++i) {
+            pushBatch(BSON("objects" << BSONObj()), opCtx);
+        }
+        inserterThreadsJoinGuard.Dismiss();
+        for (auto& inserterThread : inserterThreads) {
             inserterThread.join();
-            opCtx->checkForInterrupt();
-            break;
         }
+        opCtx->checkForInterrupt();
+    } catch (const DBException&) {
+        // Report the original error from a failed fetcher or inserter rather than the queue
+        // closure or interruption it has caused on this thread
+        {
+            stdx::lock_guard<stdx::mutex> lk(fetcherMutex);
+            uassertStatusOK(fetchError);
+        }
+        opCtx->checkForInterrupt();
+        throw;
     }
 }
 
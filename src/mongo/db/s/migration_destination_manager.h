@@ -41,6 +41,7 @@
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/db/s/session_catalog_migration_destination.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/shard_id.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -50,6 +51,13 @@
 
 namespace mongo {
 
+// The number of _migrateClone requests a recipient keeps outstanding to the donor during the
+// initial clone of a chunk migration.
+extern AtomicInt32 migrationCloneBatchesInFlight;
+
+// The number of threads on which a recipient inserts the cloned batches of a chunk migration.
+extern AtomicInt32 migrationCloneInsertionThreads;
+
 class OperationContext;
 class StartChunkCloneRequest;
 class Status;
@@ -108,7 +116,11 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard. Up to 'migrationCloneBatchesInFlight' calls to
+     * 'fetchBatchFn' run concurrently, each on its own thread and OperationContext except for the
+     * first, which uses 'opCtx'. The fetched batches are inserted by as many as
+     * 'migrationCloneInsertionThreads' threads calling 'insertBatchFn' in parallel, so batches may
+     * be inserted in any order. Cloning ends once every fetcher has received an empty batch.
      */
     static void cloneDocumentsFromDonor(
         OperationContext* opCtx,
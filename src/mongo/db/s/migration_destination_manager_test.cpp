@@ -29,8 +29,11 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/s/migration_destination_manager.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -67,15 +70,14 @@ protected:
 
 // Tests that documents will ferry from the fetch logic to the insert logic successfully.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
-    bool ranOnce = false;
+    AtomicBool ranOnce(false);
 
     auto fetchBatchFn = [&](OperationContext* opCtx) {
         BSONObjBuilder fetchBatchResultBuilder;
 
-        if (ranOnce) {
+        if (ranOnce.swap(true)) {
             fetchBatchResultBuilder.append("objects", BSONObj());
         } else {
-            ranOnce = true;
             fetchBatchResultBuilder.append("objects", createDocumentsToCloneArray());
         }
 
@@ -107,16 +109,15 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
-    bool ranOnce = false;
+    AtomicBool ranOnce(false);
 
     auto fetchBatchFn = [&](OperationContext* opCtx) {
         BSONObjBuilder fetchBatchResultBuilder;
 
-        if (ranOnce) {
+        if (ranOnce.swap(true)) {
             uasserted(ErrorCodes::NetworkTimeout, "network error");
         }
 
-        ranOnce = true;
         fetchBatchResultBuilder.append("objects", createDocumentsToCloneArray());
 
         return fetchBatchResultBuilder.obj();
@@ -156,5 +157,56 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsCatchesInsertErrors) {
     ASSERT_EQ(operationContext()->getKillStatus(), ErrorCodes::FailedToParse);
 }
 
+// Tests that all the documents are cloned when several batches are fetched and inserted
+// concurrently.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsWithConcurrentFetchesAndInserts) {
+    const auto originalBatchesInFlight = migrationCloneBatchesInFlight.load();
+    const auto originalInsertionThreads = migrationCloneInsertionThreads.load();
+    ON_BLOCK_EXIT([&] {
+        migrationCloneBatchesInFlight.store(originalBatchesInFlight);
+        migrationCloneInsertionThreads.store(originalInsertionThreads);
+    });
+    migrationCloneBatchesInFlight.store(4);
+    migrationCloneInsertionThreads.store(3);
+
+    const int kNumBatches = 50;
+    const int kDocsPerBatch = 10;
+    AtomicInt32 nextBatch(0);
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        const int batch = nextBatch.fetchAndAdd(1);
+
+        BSONArrayBuilder arrayBuilder;
+        if (batch < kNumBatches) {
+            for (int i = 0; i < kDocsPerBatch; ++i) {
+                arrayBuilder.append(createDocument(batch * kDocsPerBatch + i));
+            }
+        }
+
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    stdx::mutex resultMutex;
+    std::vector<int> resultIds;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<stdx::mutex> lk(resultMutex);
+        for (auto&& docToClone : docs) {
+            resultIds.push_back(docToClone.Obj()["_id"].numberInt());
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn);
+
+    std::sort(resultIds.begin(), resultIds.end());
+    ASSERT_EQ(static_cast<size_t>(kNumBatches * kDocsPerBatch), resultIds.size());
+    for (int i = 0; i < kNumBatches * kDocsPerBatch; ++i) {
+        ASSERT_EQ(i, resultIds[i]);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
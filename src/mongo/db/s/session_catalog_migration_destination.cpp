@@ -57,6 +57,9 @@ const WriteConcernOptions kMajorityWC(WriteConcernOptions::kMajority,
                                       WriteConcernOptions::SyncMode::UNSET,
                                       Milliseconds(0));
 
+// Bounds the number of session oplog entries written in one storage transaction.
+const size_t kMaxSessionOplogsPerWrite = 100;
+
 struct ProcessOplogResult {
     bool isPrePostImage = false;
     repl::OpTime oplogTime;
@@ -197,14 +200,29 @@ BSONObj getNextSessionOplogBatch(OperationContext* opCtx,
 }
 
 /**
- * Insert a new oplog entry by converting the oplogBSON into type 'n' oplog with the session
- * information. The new oplogEntry will also link to prePostImageTs if not null.
+ * A session oplog entry which has been checked against its session and is ready to be written.
  */
-ProcessOplogResult processSessionOplog(OperationContext* opCtx,
-                                       const BSONObj& oplogBSON,
-                                       const ProcessOplogResult& lastResult) {
+struct PreparedSessionOplog {
+    ScopedSession scopedSession;
+    TransactionParticipant* txnParticipant;
+    BSONObj oplogBSON;
+    repl::OplogEntry oplogEntry;
+    BSONObj object;
+    BSONObj object2;
+    repl::OplogLink oplogLink;
+    ProcessOplogResult result;
+};
+
+/**
+ * Prepares to convert the oplogBSON into type 'n' oplog with the session information, linking to
+ * the pre/post image in lastResult if it is one. Returns boost::none if the session already has
+ * the statement, in which case it must not be migrated.
+ */
+boost::optional<PreparedSessionOplog> prepareSessionOplog(OperationContext* opCtx,
+                                                          const BSONObj& oplogBSON,
+                                                          const repl::OplogEntry& oplogEntry,
+                                                          const ProcessOplogResult& lastResult) {
     ProcessOplogResult result;
-    auto oplogEntry = parseOplog(oplogBSON);
 
     BSONObj object2;
     if (oplogEntry.getOpType() == repl::OpTypeEnum::kNoop) {
@@ -253,7 +271,7 @@ ProcessOplogResult processSessionOplog(OperationContext* opCtx,
 
     if (!txnParticipant->onMigrateBeginOnPrimary(opCtx, result.txnNum, stmtId)) {
         // Don't continue migrating the transaction history
-        return lastResult;
+        return boost::none;
     }
 
     BSONObj object(result.isPrePostImage
@@ -262,6 +280,28 @@ ProcessOplogResult processSessionOplog(OperationContext* opCtx,
     auto oplogLink = extractPrePostImageTs(lastResult, oplogEntry);
     oplogLink.prevOpTime = txnParticipant->getLastWriteOpTime(result.txnNum);
 
+    return PreparedSessionOplog{std::move(scopedSession),
+                                txnParticipant,
+                                oplogBSON,
+                                oplogEntry,
+                                std::move(object),
+                                std::move(object2),
+                                std::move(oplogLink),
+                                std::move(result)};
+}
+
+/**
+ * Inserts the prepared oplog entries in a single unit of work and empties 'pending'. The entries
+ * must belong to distinct sessions, since each links to the last write of its session, and a
+ * pre/post image may only be the last entry, since the entry following it links to its optime.
+ * Returns the result of the last entry.
+ */
+ProcessOplogResult writeSessionOplogs(OperationContext* opCtx,
+                                      std::vector<PreparedSessionOplog>* pending) {
+    invariant(!pending->empty());
+    auto batch = std::move(*pending);
+    pending->clear();
+
     writeConflictRetry(
         opCtx,
         "SessionOplogMigration",
@@ -276,39 +316,50 @@ ProcessOplogResult processSessionOplog(OperationContext* opCtx,
                 opCtx, NamespaceString::kSessionTransactionsTableNamespace.db(), MODE_IX);
             WriteUnitOfWork wunit(opCtx);
 
-            result.oplogTime = repl::logOp(opCtx,
-                                           "n",
-                                           oplogEntry.getNss(),
-                                           oplogEntry.getUuid(),
-                                           object,
-                                           &object2,
-                                           true,
-                                           *oplogEntry.getWallClockTime(),
-                                           sessionInfo,
-                                           stmtId,
-                                           oplogLink,
-                                           false /* prepare */,
-                                           OplogSlot());
-
-            auto oplogOpTime = result.oplogTime;
-            uassert(40633,
-                    str::stream() << "Failed to create new oplog entry for oplog with opTime: "
-                                  << oplogEntry.getOpTime().toString()
-                                  << ": "
-                                  << redact(oplogBSON),
-                    !oplogOpTime.isNull());
-
-            // Do not call onWriteOpCompletedOnPrimary if we inserted a pre/post image, because the
-            // next oplog will contain the real operation
-            if (!result.isPrePostImage) {
-                txnParticipant->onMigrateCompletedOnPrimary(
-                    opCtx, result.txnNum, {stmtId}, oplogOpTime, *oplogEntry.getWallClockTime());
+            for (auto& prepared : batch) {
+                const auto& oplogEntry = prepared.oplogEntry;
+                const auto& sessionInfo = oplogEntry.getOperationSessionInfo();
+                const auto stmtId = *oplogEntry.getStatementId();
+                auto& result = prepared.result;
+
+                result.oplogTime = repl::logOp(opCtx,
+                                               "n",
+                                               oplogEntry.getNss(),
+                                               oplogEntry.getUuid(),
+                                               prepared.object,
+                                               &prepared.object2,
+                                               true,
+                                               *oplogEntry.getWallClockTime(),
+                                               sessionInfo,
+                                               stmtId,
+                                               prepared.oplogLink,
+                                               false /* prepare */,
+                                               OplogSlot());
+
+                auto oplogOpTime = result.oplogTime;
+                uassert(40633,
+                        str::stream() << "Failed to create new oplog entry for oplog with opTime: "
+                                      << oplogEntry.getOpTime().toString()
+                                      << ": "
+                                      << redact(prepared.oplogBSON),
+                        !oplogOpTime.isNull());
+
+                // Do not call onWriteOpCompletedOnPrimary if we inserted a pre/post image, because
+                // the next oplog will contain the real operation
+                if (!result.isPrePostImage) {
+                    prepared.txnParticipant->onMigrateCompletedOnPrimary(
+                        opCtx,
+                        result.txnNum,
+                        {stmtId},
+                        oplogOpTime,
+                        *oplogEntry.getWallClockTime());
+                }
             }
 
             wunit.commit();
         });
 
-    return result;
+    return batch.back().result;
 }
 
 }  // namespace
@@ -431,8 +482,50 @@ void SessionCatalogMigrationDestination::_retrieveSessionStateFromSource(Service
                 lastOpTimeWaited = lastResult.oplogTime;
             }
 
-            while (oplogIter.more()) {
-                lastResult = processSessionOplog(opCtx, oplogIter.next().Obj(), lastResult);
+            // Entries of distinct sessions are written together, up to kMaxSessionOplogsPerWrite
+            // at a time. An entry whose session already has one pending, or which follows a
+            // pre/post image, links to the optime of that write, so it must be done first.
+            std::vector<PreparedSessionOplog> pending;
+            LogicalSessionIdSet pendingSessions;
+            auto writePending = [&] {
+                if (!pending.empty()) {
+                    lastResult = writeSessionOplogs(opCtx, &pending);
+                    pendingSessions.clear();
+                }
+            };
+
+            try {
+                ProcessOplogResult lastPrepared = lastResult;
+                while (oplogIter.more()) {
+                    const auto oplogBSON = oplogIter.next().Obj();
+                    const auto oplogEntry = parseOplog(oplogBSON);
+                    const auto& sessionId = *oplogEntry.getOperationSessionInfo().getSessionId();
+
+                    if (pending.size() >= kMaxSessionOplogsPerWrite ||
+                        pendingSessions.count(sessionId)) {
+                        writePending();
+                        lastPrepared = lastResult;
+                    }
+
+                    auto prepared = prepareSessionOplog(opCtx, oplogBSON, oplogEntry, lastPrepared);
+                    if (!prepared) {
+                        continue;
+                    }
+
+                    lastPrepared = prepared->result;
+                    pendingSessions.insert(lastPrepared.sessionId);
+                    pending.push_back(std::move(*prepared));
+
+                    if (lastPrepared.isPrePostImage) {
+                        writePending();
+                        lastPrepared = lastResult;
+                    }
+                }
+                writePending();
+            } catch (const DBException&) {
+                // Keep the entries which were accepted before the failure.
+                writePending();
+                throw;
             }
         } catch (const DBException& excep) {
             if (excep.code() == ErrorCodes::ConflictingOperationInProgress ||
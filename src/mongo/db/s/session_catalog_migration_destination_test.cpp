@@ -573,6 +573,144 @@ TEST_F(SessionCatalogMigrationDestinationTest, OplogEntriesWithDifferentSession)
     }
 }
 
+TEST_F(SessionCatalogMigrationDestinationTest, InterleavedSessionsInOneBatch) {
+    const auto sessionId1 = makeLogicalSessionIdForTest();
+    const auto sessionId2 = makeLogicalSessionIdForTest();
+
+    SessionCatalogMigrationDestination sessionMigration(kFromShard, migrationId());
+    sessionMigration.start(getServiceContext());
+
+    OperationSessionInfo sessionInfo1;
+    sessionInfo1.setSessionId(sessionId1);
+    sessionInfo1.setTxnNumber(2);
+
+    OperationSessionInfo sessionInfo2;
+    sessionInfo2.setSessionId(sessionId2);
+    sessionInfo2.setTxnNumber(42);
+
+    auto oplog1 = makeOplogEntry(OpTime(Timestamp(100, 2), 1),  // optime
+                                 OpTypeEnum::kInsert,           // op type
+                                 BSON("x" << 100),              // o
+                                 boost::none,                   // o2
+                                 sessionInfo1,                  // session info
+                                 Date_t::now(),                 // wall clock time
+                                 23);                           // statement id
+
+    auto oplog2 = makeOplogEntry(OpTime(Timestamp(90, 2), 1),  // optime
+                                 OpTypeEnum::kInsert,          // op type
+                                 BSON("x" << 90),              // o
+                                 boost::none,                  // o2
+                                 sessionInfo2,                 // session info
+                                 Date_t::now(),                // wall clock time
+                                 45);                          // statement id
+
+    auto oplog3 = makeOplogEntry(OpTime(Timestamp(80, 2), 1),  // optime
+                                 OpTypeEnum::kInsert,          // op type
+                                 BSON("x" << 80),              // o
+                                 boost::none,                  // o2
+                                 sessionInfo1,                 // session info
+                                 Date_t::now(),                // wall clock time
+                                 24);                          // statement id
+
+    auto oplog4 = makeOplogEntry(OpTime(Timestamp(70, 2), 1),  // optime
+                                 OpTypeEnum::kInsert,          // op type
+                                 BSON("x" << 70),              // o
+                                 boost::none,                  // o2
+                                 sessionInfo2,                 // session info
+                                 Date_t::now(),                // wall clock time
+                                 46);                          // statement id
+
+    returnOplog({oplog1, oplog2, oplog3, oplog4});
+
+    finishSessionExpectSuccess(&sessionMigration);
+
+    ASSERT_TRUE(SessionCatalogMigrationDestination::State::Done == sessionMigration.getState());
+
+    auto opCtx = operationContext();
+
+    {
+        auto session = getSessionWithTxn(opCtx, sessionId1, 2);
+        const auto txnParticipant =
+            TransactionParticipant::getFromNonCheckedOutSession(session.get());
+
+        TransactionHistoryIterator historyIter(txnParticipant->getLastWriteOpTime(2));
+        ASSERT_TRUE(historyIter.hasNext());
+        checkOplogWithNestedOplog(oplog3, historyIter.next(opCtx));
+
+        ASSERT_TRUE(historyIter.hasNext());
+        checkOplogWithNestedOplog(oplog1, historyIter.next(opCtx));
+
+        ASSERT_FALSE(historyIter.hasNext());
+
+        checkStatementExecuted(opCtx, session.get(), 2, 23, oplog1);
+        checkStatementExecuted(opCtx, session.get(), 2, 24, oplog3);
+    }
+
+    {
+        auto session = getSessionWithTxn(opCtx, sessionId2, 42);
+        const auto txnParticipant =
+            TransactionParticipant::getFromNonCheckedOutSession(session.get());
+
+        TransactionHistoryIterator historyIter(txnParticipant->getLastWriteOpTime(42));
+        ASSERT_TRUE(historyIter.hasNext());
+        checkOplogWithNestedOplog(oplog4, historyIter.next(opCtx));
+
+        ASSERT_TRUE(historyIter.hasNext());
+        checkOplogWithNestedOplog(oplog2, historyIter.next(opCtx));
+
+        ASSERT_FALSE(historyIter.hasNext());
+
+        checkStatementExecuted(opCtx, session.get(), 42, 45, oplog2);
+        checkStatementExecuted(opCtx, session.get(), 42, 46, oplog4);
+    }
+}
+
+TEST_F(SessionCatalogMigrationDestinationTest, ManySessionsInOneBatch) {
+    // More sessions than are written in one unit of work.
+    const int kNumSessions = 250;
+
+    SessionCatalogMigrationDestination sessionMigration(kFromShard, migrationId());
+    sessionMigration.start(getServiceContext());
+
+    std::vector<LogicalSessionId> sessionIds;
+    std::vector<OplogEntry> oplogs;
+    for (int i = 0; i < kNumSessions; i++) {
+        sessionIds.push_back(makeLogicalSessionIdForTest());
+
+        OperationSessionInfo sessionInfo;
+        sessionInfo.setSessionId(sessionIds.back());
+        sessionInfo.setTxnNumber(i + 1);
+
+        oplogs.push_back(makeOplogEntry(OpTime(Timestamp(100, i + 1), 1),  // optime
+                                        OpTypeEnum::kInsert,               // op type
+                                        BSON("x" << i),                    // o
+                                        boost::none,                       // o2
+                                        sessionInfo,                       // session info
+                                        Date_t::now(),                     // wall clock time
+                                        i));                               // statement id
+    }
+
+    returnOplog(oplogs);
+
+    finishSessionExpectSuccess(&sessionMigration);
+
+    ASSERT_TRUE(SessionCatalogMigrationDestination::State::Done == sessionMigration.getState());
+
+    auto opCtx = operationContext();
+    for (int i = 0; i < kNumSessions; i++) {
+        auto session = getSessionWithTxn(opCtx, sessionIds[i], i + 1);
+        const auto txnParticipant =
+            TransactionParticipant::getFromNonCheckedOutSession(session.get());
+
+        TransactionHistoryIterator historyIter(txnParticipant->getLastWriteOpTime(i + 1));
+        ASSERT_TRUE(historyIter.hasNext());
+        checkOplogWithNestedOplog(oplogs[i], historyIter.next(opCtx));
+        ASSERT_FALSE(historyIter.hasNext());
+
+        checkStatementExecuted(opCtx, session.get(), i + 1, i, oplogs[i]);
+    }
+}
+
 TEST_F(SessionCatalogMigrationDestinationTest, ShouldNotNestAlreadyNestedOplog) {
     const auto sessionId = makeLogicalSessionIdForTest();
 
@@ -35,6 +35,7 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/op_observer.h"
+#include "mongo/db/repl/image_collection_entry_gen.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/session.h"
@@ -52,12 +53,77 @@ namespace {
 
 PseudoRandom hashGenerator(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64());
 
+/**
+ * Returns the image of the findAndModify in 'oplog', which is stored in the image collection, as a
+ * no-op entry like the one which would otherwise hold it in the oplog, and rewrites 'oplog' to link
+ * to it. The destination shard stores the image in its oplog. Returns boost::none, leaving 'oplog'
+ * without any link to an image, if a later findAndModify of the session has replaced the image.
+ */
+boost::optional<repl::OplogEntry> forgeRetryImageOplog(OperationContext* opCtx,
+                                                       repl::OplogEntry* oplog) {
+    const auto imageKind = *oplog->getNeedsRetryImage();
+
+    DBDirectClient client(opCtx);
+    auto imageDoc = client.findOne(NamespaceString::kConfigImagesNamespace.ns(),
+                                   BSON("_id" << oplog->getSessionId()->toBSON()));
+
+    boost::optional<repl::ImageEntry> imageEntry;
+    if (!imageDoc.isEmpty()) {
+        imageEntry = repl::ImageEntry::parse(IDLParserErrorContext("image entry"), imageDoc);
+        if (imageEntry->getTxnNumber() != *oplog->getTxnNumber() ||
+            imageEntry->getTimestamp() != oplog->getTimestamp() || imageEntry->getInvalidated()) {
+            imageEntry.reset();
+        }
+    }
+
+    BSONObjBuilder rewritten;
+    for (const auto& elem : oplog->toBSON()) {
+        if (elem.fieldNameStringData() != repl::OplogEntryBase::kNeedsRetryImageFieldName) {
+            rewritten.append(elem);
+        }
+    }
+
+    if (imageEntry) {
+        oplog->getOpTime().append(&rewritten,
+                                  imageKind == repl::RetryImageEnum::kPreImage
+                                      ? repl::OplogEntryBase::kPreImageOpTimeFieldName.toString()
+                                      : repl::OplogEntryBase::kPostImageOpTimeFieldName.toString());
+    }
+
+    *oplog = uassertStatusOK(repl::OplogEntry::parse(rewritten.obj()));
+
+    if (!imageEntry) {
+        return boost::none;
+    }
+
+    return repl::OplogEntry(oplog->getOpTime(),                // optime
+                            oplog->getHash(),                  // hash
+                            repl::OpTypeEnum::kNoop,           // op type
+                            oplog->getNss(),                   // namespace
+                            oplog->getUuid(),                  // uuid
+                            boost::none,                       // fromMigrate
+                            repl::OplogEntry::kOplogVersion,   // version
+                            imageEntry->getImage(),            // o
+                            boost::none,                       // o2
+                            oplog->getOperationSessionInfo(),  // session info
+                            boost::none,                       // upsert
+                            oplog->getWallClockTime(),         // wall clock time
+                            oplog->getStatementId(),           // statement id
+                            boost::none,   // optime of previous write within same transaction
+                            boost::none,   // pre-image optime
+                            boost::none);  // post-image optime
+}
+
 boost::optional<repl::OplogEntry> fetchPrePostImageOplog(OperationContext* opCtx,
-                                                         const repl::OplogEntry& oplog) {
-    auto opTimeToFetch = oplog.getPreImageOpTime();
+                                                         repl::OplogEntry* oplog) {
+    if (oplog->getNeedsRetryImage()) {
+        return forgeRetryImageOplog(opCtx, oplog);
+    }
+
+    auto opTimeToFetch = oplog->getPreImageOpTime();
 
     if (!opTimeToFetch) {
-        opTimeToFetch = oplog.getPostImageOpTime();
+        opTimeToFetch = oplog->getPostImageOpTime();
     }
 
     if (!opTimeToFetch) {
@@ -131,8 +197,10 @@ SessionCatalogMigrationSource::SessionCatalogMigrationSource(OperationContext* o
     auto cursor = client.query(NamespaceString::kSessionTransactionsTableNamespace, query);
 
     while (cursor->more()) {
-        auto nextSession = SessionTxnRecord::parse(
-            IDLParserErrorContext("Session migration cloning"), cursor->next());
+        auto nextSession = TransactionParticipant::catchUpSessionRecord(
+            opCtx,
+            SessionTxnRecord::parse(IDLParserErrorContext("Session migration cloning"),
+                                    cursor->next()));
         if (!nextSession.getLastWriteOpTime().isNull()) {
             _sessionOplogIterators.push_back(
                 stdx::make_unique<SessionOplogIterator>(std::move(nextSession), _rollbackIdAtInit));
@@ -202,7 +270,7 @@ bool SessionCatalogMigrationSource::_handleWriteHistory(WithLock, OperationConte
                 return false;
             }
 
-            auto doc = fetchPrePostImageOplog(opCtx, nextOplog);
+            auto doc = fetchPrePostImageOplog(opCtx, &nextOplog);
             if (doc) {
                 _lastFetchedOplogBuffer.push_back(nextOplog);
                 _lastFetchedOplog = *doc;
@@ -254,7 +322,7 @@ bool SessionCatalogMigrationSource::_fetchNextOplogFromSessionCatalog(OperationC
 
 bool SessionCatalogMigrationSource::_hasNewWrites() {
     stdx::lock_guard<stdx::mutex> lk(_newOplogMutex);
-    return _lastFetchedNewWriteOplog || !_newWriteOpTimeList.empty();
+    return _lastFetchedNewWriteOplog || _newWriteOplogAfterImage || !_newWriteOpTimeList.empty();
 }
 
 bool SessionCatalogMigrationSource::_fetchNextNewWriteOplog(OperationContext* opCtx) {
@@ -263,6 +331,12 @@ bool SessionCatalogMigrationSource::_fetchNextNewWriteOplog(OperationContext* op
     {
         stdx::lock_guard<stdx::mutex> lk(_newOplogMutex);
 
+        if (_newWriteOplogAfterImage) {
+            _lastFetchedNewWriteOplog = std::move(_newWriteOplogAfterImage);
+            _newWriteOplogAfterImage.reset();
+            return true;
+        }
+
         if (_newWriteOpTimeList.empty()) {
             _lastFetchedNewWriteOplog.reset();
             return false;
@@ -282,9 +356,23 @@ bool SessionCatalogMigrationSource::_fetchNextNewWriteOplog(OperationContext* op
                           << nextOpTimeToFetch.toBSON(),
             !newWriteOplog.isEmpty());
 
+    auto newWrite = uassertStatusOK(repl::OplogEntry::parse(newWriteOplog));
+
+    // The image of a findAndModify stored in the image collection is sent ahead of the write, as
+    // if it were stored in the oplog.
+    boost::optional<repl::OplogEntry> image;
+    if (newWrite.getNeedsRetryImage()) {
+        image = forgeRetryImageOplog(opCtx, &newWrite);
+    }
+
     {
         stdx::lock_guard<stdx::mutex> lk(_newOplogMutex);
-        _lastFetchedNewWriteOplog = uassertStatusOK(repl::OplogEntry::parse(newWriteOplog));
+        if (image) {
+            _lastFetchedNewWriteOplog = std::move(image);
+            _newWriteOplogAfterImage = std::move(newWrite);
+        } else {
+            _lastFetchedNewWriteOplog = std::move(newWrite);
+        }
         _newWriteOpTimeList.pop_front();
     }
 
@@ -210,7 +210,7 @@ private:
     // Used to store the last fetched oplog. This enables calling get multiple times.
     boost::optional<repl::OplogEntry> _lastFetchedOplog;
 
-    // Protects _newWriteTsList, _lastFetchedNewWriteOplog
+    // Protects _newWriteTsList, _lastFetchedNewWriteOplog, _newWriteOplogAfterImage
     stdx::mutex _newOplogMutex;
 
     // Stores oplog opTime of new writes that are coming in.
@@ -218,6 +218,10 @@ private:
 
     // Used to store the last fetched oplog from _newWriteTsList.
     boost::optional<repl::OplogEntry> _lastFetchedNewWriteOplog;
+
+    // Holds a new findAndModify write while the image it stores in the image collection is the
+    // last fetched oplog, so that the write is returned next.
+    boost::optional<repl::OplogEntry> _newWriteOplogAfterImage;
 };
 
 }  // namespace mongo
@@ -50,6 +50,7 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/request_types/split_chunk_request_type.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -147,14 +148,16 @@ StatusWith<boost::optional<ChunkRange>> splitChunk(OperationContext* opCtx,
                           << chunkRange.toString());
     }
 
-    // If the shard key is hashed, then we must make sure that the split points are of type
-    // NumberLong.
-    if (KeyPattern::isHashedKeyPattern(keyPatternObj)) {
+    // If the shard key is hashed, then we must make sure that the values of the hashed field in the
+    // split points are of type NumberLong.
+    const ShardKeyPattern splitKeyPattern(keyPatternObj);
+    if (splitKeyPattern.isHashedPattern()) {
         for (BSONObj splitKey : splitKeys) {
             BSONObjIterator it(splitKey);
             while (it.more()) {
                 BSONElement splitKeyElement = it.next();
-                if (splitKeyElement.type() != NumberLong) {
+                if (splitKeyElement.fieldNameStringData() == splitKeyPattern.getHashedField() &&
+                    splitKeyElement.type() != NumberLong) {
                     return {ErrorCodes::CannotSplit,
                             str::stream() << "splitChunk cannot split chunk "
                                           << chunkRange.toString()
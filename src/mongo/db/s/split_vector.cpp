@@ -34,26 +34,192 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorSampleSize, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 100000) {
+            return Status(ErrorCodes::BadValue,
+                          "splitVectorSampleSize must be between 0 and 100000");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorMinRecordsForSampling, long long, 100000)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "splitVectorMinRecordsForSampling must not be negative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 const int kMaxObjectPerChunk{250000};
 
+// Number of random records drawn to estimate which fraction of the collection falls in the chunk,
+// before deciding whether sampling is cheaper than scanning the chunk's index range.
+const long long kPilotSampleSize{100};
+
+// Approximate cost of fetching a document through the random cursor, relative to advancing the
+// index scan by one key.
+const long long kRandomFetchCost{10};
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
+/**
+ * Estimates the split points of the chunk [minKey, maxKey) from a uniform random sample of the
+ * collection's documents instead of a full scan of the chunk's index range. Split points are
+ * picked at every 'keyCount'-th position of the sorted sample, scaled by the estimated number of
+ * documents in the chunk. By the Dvoretzky-Kiefer-Wolfowitz inequality, with 's' sampled keys the
+ * rank of every split point is within 1.36 / sqrt(s) of the chunk size of its exact position with
+ * 95% confidence, so the default sample of 1000 keys keeps the error under 5%.
+ *
+ * Returns boost::none if the storage engine does not support random cursors, sampling is disabled,
+ * or the cost model estimates that scanning the chunk is cheaper, in which case the caller should
+ * fall back to the index scan.
+ */
+boost::optional<std::vector<BSONObj>> sampleSplitPoints(OperationContext* opCtx,
+                                                        Collection* collection,
+                                                        IndexDescriptor* idx,
+                                                        const BSONObj& keyPattern,
+                                                        const BSONObj& minKey,
+                                                        const BSONObj& maxKey,
+                                                        long long recCount,
+                                                        long long keyCount,
+                                                        boost::optional<long long> maxSplitPoints) {
+    const long long sampleSize = splitVectorSampleSize.load();
+    if (sampleSize == 0 || recCount < splitVectorMinRecordsForSampling.load()) {
+        return boost::none;
+    }
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return boost::none;
+    }
+
+    const IndexAccessMethod* const iam = collection->getIndexCatalog()->getIndex(idx);
+    const Ordering ordering = Ordering::make(idx->keyPattern());
+
+    std::vector<BSONObj> sampledKeys;
+    long long attempts = 0;
+
+    // Draws random documents until either 'targetHits' of them fall in the chunk or 'maxAttempts'
+    // documents have been looked at.
+    auto sampleUntil = [&](long long targetHits, long long maxAttempts) {
+        while (static_cast<long long>(sampledKeys.size()) < targetHits && attempts < maxAttempts) {
+            if (attempts % 128 == 0) {
+                opCtx->checkForInterrupt();
+            }
+
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            attempts++;
+
+            BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+            iam->getKeys(record->data.toBson(),
+                         IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered,
+                         &keys,
+                         nullptr,
+                         nullptr);
+            if (keys.empty()) {
+                continue;
+            }
+
+            // The shard key fields are never multikey, so any of the keys has the same prefix
+            const BSONObj& key = *keys.begin();
+            if (key.woCompare(minKey, ordering, 0) < 0 || key.woCompare(maxKey, ordering, 0) >= 0) {
+                continue;
+            }
+
+            sampledKeys.push_back(dotted_path_support::extractElementsBasedOnTemplate(
+                prettyKey(idx->keyPattern(), key), keyPattern));
+        }
+    };
+
+    // Use a small pilot sample to estimate the size of the chunk and skip sampling if the chunk is
+    // small, or if it is such a small fraction of the collection that most of the random fetches
+    // would miss it.
+    sampleUntil(kPilotSampleSize, kPilotSampleSize);
+    if (sampledKeys.empty()) {
+        return boost::none;
+    }
+
+    const double pilotFraction = static_cast<double>(sampledKeys.size()) / attempts;
+    const double estimatedChunkRecords = pilotFraction * recCount;
+    const double expectedAttempts = sampleSize / pilotFraction;
+    if (estimatedChunkRecords < splitVectorMinRecordsForSampling.load() ||
+        expectedAttempts * kRandomFetchCost > estimatedChunkRecords) {
+        return boost::none;
+    }
+
+    sampleUntil(sampleSize, static_cast<long long>(2 * expectedAttempts) + kPilotSampleSize);
+    if (static_cast<long long>(sampledKeys.size()) < sampleSize) {
+        return boost::none;
+    }
+
+    std::sort(sampledKeys.begin(),
+              sampledKeys.end(),
+              SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    // Each sampled key stands for 'recCount / attempts' documents of the chunk
+    const double samplesPerSplit = static_cast<double>(keyCount) * attempts / recCount;
+
+    std::vector<BSONObj> splitKeys;
+    auto tooFrequentKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    const BSONObj& lowestKey = sampledKeys.front();
+
+    for (double pos = samplesPerSplit; pos < sampledKeys.size(); pos += samplesPerSplit) {
+        const BSONObj& currKey = sampledKeys[static_cast<size_t>(pos)];
+
+        // The same key cannot be used twice and may not be the lower bound of the chunk
+        const BSONObj& prevKey = splitKeys.empty() ? lowestKey : splitKeys.back();
+        if (currKey.woCompare(prevKey) == 0) {
+            tooFrequentKeys.insert(currKey);
+            continue;
+        }
+
+        splitKeys.push_back(currKey.getOwned());
+        LOG(4) << "picked a sampled split key: " << redact(currKey);
+
+        if (maxSplitPoints && maxSplitPoints.get() &&
+            static_cast<long long>(splitKeys.size()) >= maxSplitPoints.get()) {
+            break;
+        }
+    }
+
+    for (const auto& key : tooFrequentKeys) {
+        warning() << "possible low cardinality key detected in " << collection->ns()
+                  << " - key is " << key;
+    }
+
+    log() << "estimated " << splitKeys.size() << " split points for chunk " << collection->ns()
+          << " " << redact(minKey) << " -->> " << redact(maxKey) << " from " << sampledKeys.size()
+          << " sampled keys out of " << attempts << " random documents";
+
+    return splitKeys;
+}
+
 }  // namespace
 
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
@@ -150,6 +316,23 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
             keyCount = maxChunkObjects.get();
         }
 
+        // Large chunks can have their split points estimated from a random sample, unless the
+        // split needs to be at the exact halfway point of the chunk.
+        if (!force) {
+            auto sampledSplitKeys = sampleSplitPoints(opCtx,
+                                                      collection,
+                                                      idx,
+                                                      keyPattern,
+                                                      minKey,
+                                                      maxKey,
+                                                      recCount,
+                                                      keyCount,
+                                                      maxSplitPoints);
+            if (sampledSplitKeys) {
+                return std::move(*sampledSplitKeys);
+            }
+        }
+
         //
         // Traverse the index and add the keyCount-th key to the result vector. If that key
         // appeared in the vector before, we omit it. The invariant here is that all the
@@ -31,6 +31,8 @@
 #include <boost/optional.hpp>
 #include <vector>
 
+#include "mongo/platform/atomic_word.h"
+
 namespace mongo {
 
 class BSONObj;
@@ -39,6 +41,14 @@ class OperationContext;
 template <typename T>
 class StatusWith;
 
+// Number of in-range keys to sample when estimating the split points of a large chunk. Zero
+// disables sampling.
+extern AtomicInt32 splitVectorSampleSize;
+
+// Minimum number of documents, both in the collection and estimated in the chunk, for the split
+// points to be sampled instead of scanned.
+extern AtomicInt64 splitVectorMinRecordsForSampling;
+
 /**
  * Given a chunk, determines whether it can be split and returns the split points if so. This
  * function is functionally equivalent to the splitVector command.
@@ -54,6 +64,9 @@ class StatusWith;
  * be specified.
  * If force is set, split at the halfway point of the chunk. This also effectively
  * makes maxChunkSize equal the size of the chunk.
+ * For chunks with many documents, the split points are estimated from a random sample of the
+ * collection instead of a scan of the chunk's index range, if the storage engine supports random
+ * cursors and the estimated cost of sampling is lower.
  */
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              const NamespaceString& nss,
@@ -34,6 +34,7 @@
 #include "mongo/db/s/split_vector.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -300,5 +301,33 @@ TEST_F(SplitVectorTest, NoMaxChunkSize) {
     ASSERT_EQUALS(status.code(), ErrorCodes::InvalidOptions);
 }
 
+TEST_F(SplitVectorTest, SamplingFallsBackToScanWithoutRandomCursor) {
+    // The test storage engine does not provide random cursors, so even with sampling enabled for
+    // any chunk size, the split points must come from the exact index scan.
+    const auto originalMinRecords = splitVectorMinRecordsForSampling.load();
+    ON_BLOCK_EXIT([&] { splitVectorMinRecordsForSampling.store(originalMinRecords); });
+    splitVectorMinRecordsForSampling.store(0);
+
+    std::vector<BSONObj> splitKeys = unittest::assertGet(splitVector(operationContext(),
+                                                                     kNss,
+                                                                     BSON(kPattern << 1),
+                                                                     BSON(kPattern << 0),
+                                                                     BSON(kPattern << 100),
+                                                                     false,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     getDocSizeBytes() * 40LL));
+    std::vector<BSONObj> expected = {
+        BSON(kPattern << 20), BSON(kPattern << 41), BSON(kPattern << 62), BSON(kPattern << 83)};
+    ASSERT_EQ(splitKeys.size(), expected.size());
+
+    for (auto splitKeysIt = splitKeys.begin(), expectedIt = expected.begin();
+         splitKeysIt != splitKeys.end() && expectedIt != expected.end();
+         ++splitKeysIt, ++expectedIt) {
+        ASSERT_BSONOBJ_EQ(*splitKeysIt, *expectedIt);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
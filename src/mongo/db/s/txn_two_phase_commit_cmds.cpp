@@ -371,8 +371,8 @@ public:
 
             // Convert the participant list array into a set, and assert that all participants in
             // the list are unique.
-            // TODO (PM-564): Propagate the 'readOnly' flag down into the TransactionCoordinator.
             std::set<ShardId> participantList;
+            std::set<ShardId> readOnlyParticipants;
             StringBuilder ss;
             ss << "[";
             for (const auto& participant : cmd.getParticipants()) {
@@ -382,6 +382,9 @@ public:
                         std::find(participantList.begin(), participantList.end(), shardId) ==
                             participantList.end());
                 participantList.insert(shardId);
+                if (participant.getReadOnly().value_or(false)) {
+                    readOnlyParticipants.insert(shardId);
+                }
                 ss << shardId << " ";
             }
             ss << "]";
@@ -393,13 +396,17 @@ public:
                 opCtx,
                 opCtx->getLogicalSessionId().get(),
                 opCtx->getTxnNumber().get(),
-                participantList);
+                participantList,
+                readOnlyParticipants);
 
             // If the commit decision is already available before we prepare locally, it means the
-            // transaction has completed and we should skip preparing locally.
+            // transaction has completed and we should skip preparing locally. A read-only local
+            // participant is committed by the coordinator without being prepared.
             //
             // TODO (SERVER-37440): Reconsider when coordinateCommit is made idempotent.
-            if (!commitDecisionFuture.isReady()) {
+            const bool localParticipantIsReadOnly =
+                readOnlyParticipants.count(ShardingState::get(opCtx)->shardId());
+            if (!commitDecisionFuture.isReady() && !localParticipantIsReadOnly) {
                 // Execute the 'prepare' logic on the local participant (the router does not send a
                 // separate 'prepare' message to the coordinator shard).
                 _callPrepareOnLocalParticipant(opCtx);
@@ -86,6 +86,7 @@
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -576,6 +577,7 @@ void execCommandDatabase(OperationContext* opCtx,
     BSONObjBuilder extraFieldsBuilder;
     auto startOperationTime = getClientOperationTime(opCtx);
     auto invocation = command->parse(opCtx, request);
+    SamplingProfilerTagScope cpuProfilerTag(command->getName(), invocation->ns().ns());
     boost::optional<OperationSessionInfoFromClient> sessionOptions = boost::none;
 
     try {
@@ -1178,7 +1180,7 @@ DbResponse receivedGetMore(OperationContext* opCtx,
     }
 
     curop.debug().responseLength = dbresponse.response.header().dataLen();
-    auto queryResult = QueryResult::ConstView(dbresponse.response.buf());
+    auto queryResult = QueryResult::ConstView(dbresponse.response.headBuf());
     curop.debug().nreturned = queryResult.getNReturned();
 
     if (exhaust) {
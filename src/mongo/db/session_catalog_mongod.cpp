@@ -40,9 +40,9 @@
 
 namespace mongo {
 
-void MongoDSessionCatalog::onStepUp(OperationContext* opCtx) {
-    SessionCatalog::get(opCtx)->invalidateSessions(opCtx, boost::none);
+namespace {
 
+void createCollectionIfMissing(OperationContext* opCtx, const NamespaceString& nss) {
     const size_t initialExtentSize = 0;
     const bool capped = false;
     const bool maxSize = 0;
@@ -51,11 +51,7 @@ void MongoDSessionCatalog::onStepUp(OperationContext* opCtx) {
 
     DBDirectClient client(opCtx);
 
-    if (client.createCollection(NamespaceString::kSessionTransactionsTableNamespace.ns(),
-                                initialExtentSize,
-                                capped,
-                                maxSize,
-                                &result)) {
+    if (client.createCollection(nss.ns(), initialExtentSize, capped, maxSize, &result)) {
         return;
     }
 
@@ -66,10 +62,17 @@ void MongoDSessionCatalog::onStepUp(OperationContext* opCtx) {
     }
 
     uassertStatusOKWithContext(status,
-                               str::stream()
-                                   << "Failed to create the "
-                                   << NamespaceString::kSessionTransactionsTableNamespace.ns()
-                                   << " collection");
+                               str::stream() << "Failed to create the " << nss.ns()
+                                             << " collection");
+}
+
+}  // namespace
+
+void MongoDSessionCatalog::onStepUp(OperationContext* opCtx) {
+    SessionCatalog::get(opCtx)->invalidateSessions(opCtx, boost::none);
+
+    createCollectionIfMissing(opCtx, NamespaceString::kSessionTransactionsTableNamespace);
+    createCollectionIfMissing(opCtx, NamespaceString::kConfigImagesNamespace);
 }
 
 boost::optional<UUID> MongoDSessionCatalog::getTransactionTableUUID(OperationContext* opCtx) {
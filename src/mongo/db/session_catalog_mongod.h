@@ -35,9 +35,9 @@ namespace mongo {
 class MongoDSessionCatalog {
 public:
     /**
-     * Invoked when the node enters the primary state. Ensures that the transactions collection is
-     * created. Throws on severe exceptions due to which it is not safe to continue the step-up
-     * process.
+     * Invoked when the node enters the primary state. Ensures that the transactions collection and
+     * the image collection are created. Throws on severe exceptions due to which it is not safe to
+     * continue the step-up process.
      */
     static void onStepUp(OperationContext* opCtx);
 
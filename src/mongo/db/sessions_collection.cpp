@@ -50,13 +50,17 @@ constexpr StringData SessionsCollection::kSessionsTTLIndex;
 
 namespace {
 
-// This batch size is chosen to ensure that we don't form requests larger than the 16mb limit.
-// Especially for refreshes, the updates we send include the full user name (user@db), and user
-// names can be quite large (we enforce a max 10k limit for usernames used with sessions).
-//
-// At 1000 elements, a 16mb payload gives us a budget of 16000 bytes per user, which we should
-// comfortably be able to stay under, even with 10k user names.
-constexpr size_t kMaxBatchSize = 1000;
+// Refreshes and removals are sent as unordered write batches which are as large as a write command
+// allows, so that refreshing many sessions takes few round trips, and a sharded sessions
+// collection receives large batches for each shard. A batch is sent once it reaches the maximum
+// number of writes, or comes within kMaxBatchBytesHeadroom of the 16mb limit. Especially for
+// refreshes, the updates we send include the full user name (user@db), and user names can be quite
+// large (we enforce a max 10k limit for usernames used with sessions), so the headroom leaves room
+// for one more entry.
+constexpr int kMaxBatchBytesHeadroom = 64 * 1024;
+
+// Lookups are sent as a query on a list of session ids, in batches of this size.
+constexpr size_t kMaxFetchBatchSize = 1000;
 
 // Used to refresh or remove items from the session collection with write
 // concern majority
@@ -94,8 +98,16 @@ BSONObj updateQuery(const LogicalSessionRecord& record) {
     return updateBuilder.obj();
 }
 
-template <typename TFactory, typename AddLineFn, typename SendFn, typename Container>
-Status runBulkGeneric(TFactory makeT, AddLineFn addLine, SendFn sendBatch, const Container& items) {
+template <typename TFactory,
+          typename AddLineFn,
+          typename SendFn,
+          typename BatchIsFullFn,
+          typename Container>
+Status runBulkGeneric(TFactory makeT,
+                      AddLineFn addLine,
+                      SendFn sendBatch,
+                      BatchIsFullFn batchIsFull,
+                      const Container& items) {
     using T = decltype(makeT());
 
     size_t i = 0;
@@ -113,7 +125,7 @@ Status runBulkGeneric(TFactory makeT, AddLineFn addLine, SendFn sendBatch, const
     for (const auto& item : items) {
         addLine(*thing, item);
 
-        if (++i >= kMaxBatchSize) {
+        if (batchIsFull(++i)) {
             auto res = sendLocalBatch();
             if (!res.isOK()) {
                 return res;
@@ -155,7 +167,12 @@ Status runBulkCmd(StringData label,
         return sendBatch(batchBuilder->done());
     };
 
-    return runBulkGeneric(makeBatch, addLine, sendLocalBatch, items);
+    auto batchIsFull = [&](size_t batchSize) {
+        return batchSize >= write_ops::kMaxWriteBatchSize ||
+            buf.len() >= BSONObjMaxUserSize - kMaxBatchBytesHeadroom;
+    };
+
+    return runBulkGeneric(makeBatch, addLine, sendLocalBatch, batchIsFull, items);
 }
 
 }  // namespace
@@ -289,7 +306,9 @@ StatusWith<LogicalSessionIdSet> SessionsCollection::doFetch(const NamespaceStrin
         return wrappedSend(request.toBSON());
     };
 
-    auto status = runBulkGeneric(makeT, add, sendLocal, sessions);
+    auto batchIsFull = [](size_t batchSize) { return batchSize >= kMaxFetchBatchSize; };
+
+    auto status = runBulkGeneric(makeT, add, sendLocal, batchIsFull, sessions);
 
     if (!status.isOK()) {
         return status;
@@ -59,6 +59,11 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/future.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/destructor_guard.h"
@@ -102,6 +107,29 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
+/**
+ * Appends 'value' to 'buf' using 7 bits per byte, with the high bit set on all bytes but the last.
+ * Used for the lengths of prefix compressed keys, which are usually small.
+ */
+inline void appendVarUInt(BufBuilder& buf, uint32_t value) {
+    while (value >= 0x80) {
+        buf.appendChar(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buf.appendChar(static_cast<char>(value));
+}
+
+inline uint32_t readVarUInt(BufReader& reader) {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        const uint8_t byte = reader.read<uint8_t>();
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    msgasserted(51300, "invalid length in sorter file");
+}
+
 /** Ensures a named file is deleted when this object goes out of scope */
 class FileDeleter {
 public:
@@ -114,6 +142,67 @@ private:
     const std::string _fileName;
 };
 
+/** A block of a sorter file, after decryption and decompression. An empty block marks EOF. */
+struct FileBlock {
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+};
+
+/**
+ * Reads the upcoming blocks of sorter files on a background thread, so that merging several files
+ * does not wait on each of their reads in turn. Shared by the FileIterators of a MergeIterator.
+ */
+class ReadAheadThread {
+    MONGO_DISALLOW_COPYING(ReadAheadThread);
+
+public:
+    ReadAheadThread() : _thread([this] { _run(); }) {}
+
+    ~ReadAheadThread() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _shutdown = true;
+        }
+        _workAvailable.notify_one();
+        _thread.join();
+    }
+
+    /** Runs 'read' on the background thread. Tasks run in the order they are scheduled. */
+    stdx::future<FileBlock> schedule(stdx::function<FileBlock()> read) {
+        stdx::packaged_task<FileBlock()> task(std::move(read));
+        auto result = task.get_future();
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _tasks.push_back(std::move(task));
+        }
+        _workAvailable.notify_one();
+        return result;
+    }
+
+private:
+    void _run() {
+        while (true) {
+            stdx::packaged_task<FileBlock()> task;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _workAvailable.wait(lk, [this] { return _shutdown || !_tasks.empty(); });
+                if (_tasks.empty()) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    std::deque<stdx::packaged_task<FileBlock()>> _tasks;
+    bool _shutdown = false;
+    stdx::thread _thread;  // Must be constructed last.
+};
+
 /** Returns results from sorted in-memory storage */
 template <typename Key, typename Value>
 class InMemIterator : public SortIteratorInterface<Key, Value> {
@@ -154,8 +243,10 @@ public:
 
     FileIterator(const std::string& fileName,
                  const Settings& settings,
-                 std::shared_ptr<FileDeleter> fileDeleter)
+                 std::shared_ptr<FileDeleter> fileDeleter,
+                 bool prefixCompressedKeys)
         : _settings(settings),
+          _prefixCompressedKeys(prefixCompressedKeys),
           _done(false),
           _fileName(fileName),
           _fileDeleter(fileDeleter),
@@ -170,6 +261,23 @@ public:
                 boost::filesystem::file_size(_fileName) != 0);
     }
 
+    ~FileIterator() {
+        // A block being read ahead refers to this iterator.
+        if (_nextBlock.valid()) {
+            _nextBlock.wait();
+        }
+    }
+
+    /**
+     * Reads the block after the current one on 'readAhead' while the current one is consumed. Has
+     * no effect once the file has started to be read.
+     */
+    void setReadAhead(std::shared_ptr<ReadAheadThread> readAhead) {
+        if (_reader || _done)
+            return;
+        _readAhead = std::move(readAhead);
+    }
+
     bool more() {
         if (!_done)
             fillIfNeeded();  // may change _done
@@ -181,12 +289,30 @@ public:
         fillIfNeeded();
 
         // Note: key must be read before value so can't pass directly to Data constructor
-        auto first = Key::deserializeForSorter(*_reader, _settings.first);
+        auto first = _prefixCompressedKeys ? nextPrefixCompressedKey()
+                                           : Key::deserializeForSorter(*_reader, _settings.first);
         auto second = Value::deserializeForSorter(*_reader, _settings.second);
         return Data(std::move(first), std::move(second));
     }
 
 private:
+    /**
+     * Rebuilds the next key from the prefix it shares with the previous one and the rest of its
+     * bytes, see SortedFileWriter::addAlreadySorted(). The key may point into '_lastKey', which is
+     * fine since unowned data is only valid until the next call to next().
+     */
+    Key nextPrefixCompressedKey() {
+        const uint32_t sharedBytes = readVarUInt(*_reader);
+        const uint32_t suffixBytes = readVarUInt(*_reader);
+        massert(51301, "invalid key prefix in sorter file", sharedBytes <= _lastKey.size());
+
+        _lastKey.resize(sharedBytes);
+        _lastKey.append(static_cast<const char*>(_reader->skip(suffixBytes)), suffixBytes);
+
+        BufReader keyReader(_lastKey.data(), _lastKey.size());
+        return Key::deserializeForSorter(keyReader, _settings.first);
+    }
+
     void fillIfNeeded() {
         verify(!_done);
 
@@ -195,25 +321,51 @@ private:
     }
 
     void fill() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
-        if (_done)
+        FileBlock block;
+        if (_readAhead) {
+            if (!_nextBlock.valid()) {
+                _nextBlock = _readAhead->schedule([this] { return readBlock(); });
+            }
+            block = _nextBlock.get();
+            if (block.data) {
+                _nextBlock = _readAhead->schedule([this] { return readBlock(); });
+            }
+        } else {
+            block = readBlock();
+        }
+
+        if (!block.data) {
+            _done = true;
             return;
+        }
+
+        // hold on to the block and throw out the previous one
+        _buffer = std::move(block.data);
+        _reader.reset(new BufReader(_buffer.get(), block.size));
+    }
+
+    /**
+     * Reads, decrypts and decompresses the next block of the file. Only touches '_file', so that
+     * it can run on the read ahead thread.
+     */
+    FileBlock readBlock() {
+        int32_t rawSize;
+        if (!read(&rawSize, sizeof(rawSize)))
+            return FileBlock();
 
         // negative size means compressed
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
 
-        _buffer.reset(new char[blockSize]);
-        read(_buffer.get(), blockSize);
-        massert(16816, "file too short?", !_done);
+        std::unique_ptr<char[]> buffer(new char[blockSize]);
+        massert(16816, "file too short?", read(buffer.get(), blockSize));
 
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
             size_t outLen;
             Status status =
-                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(_buffer.get()),
+                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(buffer.get()),
                                                   blockSize,
                                                   reinterpret_cast<uint8_t*>(out.get()),
                                                   blockSize,
@@ -222,38 +374,37 @@ private:
                     str::stream() << "Failed to unprotect data: " << status.toString(),
                     status.isOK());
             blockSize = outLen;
-            _buffer.swap(out);
+            buffer.swap(out);
         }
 
+        FileBlock block;
         if (!compressed) {
-            _reader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
+            block.data = std::move(buffer);
+            block.size = blockSize;
+            return block;
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+        dassert(snappy::IsValidCompressedBuffer(buffer.get(), blockSize));
 
         size_t uncompressedSize;
         massert(17061,
                 "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
+                snappy::GetUncompressedLength(buffer.get(), blockSize, &uncompressedSize));
 
-        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
+        block.data.reset(new char[uncompressedSize]);
         massert(17062,
                 "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
-
-        // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
-        _reader.reset(new BufReader(_buffer.get(), uncompressedSize));
+                snappy::RawUncompress(buffer.get(), blockSize, block.data.get()));
+        block.size = uncompressedSize;
+        return block;
     }
 
-    // sets _done to true on EOF - asserts on any other error
-    void read(void* out, size_t size) {
+    // returns false on EOF - asserts on any other error
+    bool read(void* out, size_t size) {
         _file.read(reinterpret_cast<char*>(out), size);
         if (!_file.good()) {
             if (_file.eof()) {
-                _done = true;
-                return;
+                return false;
             }
 
             msgasserted(16817,
@@ -261,15 +412,23 @@ private:
                                       << myErrnoWithDescription());
         }
         verify(_file.gcount() == static_cast<std::streamsize>(size));
+        return true;
     }
 
     const Settings _settings;
+    const bool _prefixCompressedKeys;
     bool _done;
     std::unique_ptr<char[]> _buffer;
     std::unique_ptr<BufReader> _reader;
+    std::string _lastKey;  // Only used if '_prefixCompressedKeys' is set.
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
     std::ifstream _file;
+
+    // Set when the blocks of the file are read ahead. '_nextBlock' is the block after the current
+    // one, and is the only outstanding read of '_file'.
+    std::shared_ptr<ReadAheadThread> _readAhead;
+    stdx::future<FileBlock> _nextBlock;
 };
 
 /** Merge-sorts results from 0 or more FileIterators */
@@ -287,6 +446,17 @@ public:
           _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
           _first(true),
           _greater(comp) {
+        // The spill files are read ahead on one thread for the whole merge.
+        std::shared_ptr<ReadAheadThread> readAhead;
+        for (const auto& iter : iters) {
+            if (auto file = dynamic_cast<FileIterator<Key, Value>*>(iter.get())) {
+                if (!readAhead) {
+                    readAhead = std::make_shared<ReadAheadThread>();
+                }
+                file->setReadAhead(readAhead);
+            }
+        }
+
         for (size_t i = 0; i < iters.size(); i++) {
             if (iters[i]->more()) {
                 _heap.push_back(std::make_shared<Stream>(i, iters[i]->next(), iters[i]));
@@ -408,33 +578,46 @@ public:
     NoLimitSorter(const SortOptions& opts,
                   const Comparator& comp,
                   const Settings& settings = Settings())
-        : _comp(comp), _settings(settings), _opts(opts), _memUsed(0) {
+        : _comp(comp),
+          _settings(settings),
+          _opts(opts),
+          _maxRunBytes(_opts.backgroundSpills ? _opts.maxMemoryUsageBytes / 2
+                                              : _opts.maxMemoryUsageBytes),
+          _memUsed(0) {
         verify(_opts.limit == 0);
     }
 
+    ~NoLimitSorter() {
+        // A run being spilled in the background refers to this sorter.
+        if (_backgroundSpill.valid()) {
+            _backgroundSpill.wait();
+        }
+    }
+
     void add(const Key& key, const Value& val) {
         _data.push_back(std::make_pair(key, val));
 
         _memUsed += key.memUsageForSorter();
         _memUsed += val.memUsageForSorter();
 
-        if (_memUsed > _opts.maxMemoryUsageBytes)
+        if (_memUsed > _maxRunBytes)
             spill();
     }
 
     Iterator* done() {
-        if (_iters.empty()) {
-            sort();
+        if (_iters.empty() && !_backgroundSpill.valid()) {
+            sort(_data);
             return new InMemIterator<Key, Value>(_data);
         }
 
         spill();
+        waitForBackgroundSpill();
         return Iterator::merge(_iters, _opts, _comp);
     }
 
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     int numFiles() const {
-        return _iters.size();
+        return _iters.size() + (_backgroundSpill.valid() ? 1 : 0);
     }
     size_t memUsed() const {
         return _memUsed;
@@ -453,9 +636,9 @@ private:
         const Comparator& _comp;
     };
 
-    void sort() {
+    void sort(std::deque<Data>& data) const {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        std::stable_sort(data.begin(), data.end(), less);
 
         // Does 2x more compares than stable_sort
         // TODO test on windows
@@ -480,24 +663,51 @@ private:
                           << " Pass allowDiskUse:true to opt in.");
         }
 
-        sort();
+        _memUsed = 0;
+
+        if (!_opts.backgroundSpills) {
+            _iters.push_back(sortAndWrite(_data));
+            return;
+        }
+
+        // Keep at most one run in flight, so that the memory used stays within the limit.
+        waitForBackgroundSpill();
+        _backgroundSpill = stdx::async(stdx::launch::async,
+                                       [ this, run = std::move(_data) ]() mutable {
+                                           return sortAndWrite(run);
+                                       });
+        _data.clear();
+    }
+
+    /**
+     * Sorts 'data' and writes it to a new file, emptying it. Only reads the sorter's immutable
+     * state, so that it can run on a background thread.
+     */
+    std::shared_ptr<Iterator> sortAndWrite(std::deque<Data>& data) const {
+        sort(data);
 
         SortedFileWriter<Key, Value> writer(_opts, _settings);
-        for (; !_data.empty(); _data.pop_front()) {
-            writer.addAlreadySorted(_data.front().first, _data.front().second);
+        for (; !data.empty(); data.pop_front()) {
+            writer.addAlreadySorted(data.front().first, data.front().second);
         }
 
-        _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+        return std::shared_ptr<Iterator>(writer.done());
+    }
 
-        _memUsed = 0;
+    void waitForBackgroundSpill() {
+        if (_backgroundSpill.valid()) {
+            _iters.push_back(_backgroundSpill.get());
+        }
     }
 
     const Comparator _comp;
     const Settings _settings;
-    SortOptions _opts;
+    const SortOptions _opts;
+    const size_t _maxRunBytes;  // half the memory limit when runs are spilled in the background
     size_t _memUsed;
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+    stdx::future<std::shared_ptr<Iterator>> _backgroundSpill;  // the run being spilled, if any
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -808,7 +1018,7 @@ inline unsigned nextFileNumber() {
 
 template <typename Key, typename Value>
 SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _prefixCompressKeys(opts.prefixCompressKeys) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -841,7 +1051,24 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Se
 
 template <typename Key, typename Value>
 void SortedFileWriter<Key, Value>::addAlreadySorted(const Key& key, const Value& val) {
-    key.serializeForSorter(_buffer);
+    if (_prefixCompressKeys) {
+        // Sorted keys often share a long prefix with the previous one, so only write out the
+        // length of that prefix followed by the remaining bytes.
+        _keyBuffer.reset();
+        key.serializeForSorter(_keyBuffer);
+        const char* const keyData = _keyBuffer.buf();
+        const size_t keySize = _keyBuffer.len();
+        const size_t maxSharedBytes = std::min(keySize, _lastKey.size());
+        const size_t sharedBytes =
+            std::mismatch(keyData, keyData + maxSharedBytes, _lastKey.data()).first - keyData;
+
+        sorter::appendVarUInt(_buffer, sharedBytes);
+        sorter::appendVarUInt(_buffer, keySize - sharedBytes);
+        _buffer.appendBuf(keyData + sharedBytes, keySize - sharedBytes);
+        _lastKey.assign(keyData, keySize);
+    } else {
+        key.serializeForSorter(_buffer);
+    }
     val.serializeForSorter(_buffer);
 
     if (_buffer.len() > 64 * 1024)
@@ -905,7 +1132,8 @@ template <typename Key, typename Value>
 SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     spill();
     _file.close();
-    return new sorter::FileIterator<Key, Value>(_fileName, _settings, _fileDeleter);
+    return new sorter::FileIterator<Key, Value>(
+        _fileName, _settings, _fileDeleter, _prefixCompressKeys);
 }
 
 //
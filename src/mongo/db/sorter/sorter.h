@@ -98,8 +98,18 @@ struct SortOptions {
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
-
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    bool prefixCompressKeys;     /// If true, spill files only hold the bytes of each serialized
+                                 /// key which differ from the previous key.
+    bool backgroundSpills;       /// If true, each run is sorted and written to disk on another
+                                 /// thread while the next one is added. Runs are then limited to
+                                 /// half of maxMemoryUsageBytes. Only used when there is no limit.
+
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          prefixCompressKeys(false),
+          backgroundSpills(false) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -122,6 +132,16 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& PrefixCompressKeys(bool newPrefixCompressKeys = true) {
+        prefixCompressKeys = newPrefixCompressKeys;
+        return *this;
+    }
+
+    SortOptions& BackgroundSpills(bool newBackgroundSpills = true) {
+        backgroundSpills = newBackgroundSpills;
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -204,10 +224,16 @@ private:
     void spill();
 
     const Settings _settings;
+    const bool _prefixCompressKeys;
     std::string _fileName;
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
     BufBuilder _buffer;
+
+    // Used when '_prefixCompressKeys' is set. Each key is serialized to '_keyBuffer' first, and
+    // only its bytes after the prefix it shares with '_lastKey' are added to '_buffer'.
+    BufBuilder _keyBuffer;
+    std::string _lastKey;
 };
 }
 
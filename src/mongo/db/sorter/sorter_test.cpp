@@ -263,6 +263,26 @@ public:
             ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
                                         make_shared<IntIterator>(0, 10 * 1000 * 1000));
         }
+        {  // small, prefix compressed
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(SortOptions(opts).PrefixCompressKeys());
+            sorter.addAlreadySorted(0, 0);
+            sorter.addAlreadySorted(1, -1);
+            sorter.addAlreadySorted(1, -1);
+            sorter.addAlreadySorted(2, -2);
+            sorter.addAlreadySorted(258, -258);
+            const int expected[] = {0, 1, 1, 2, 258};
+            ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                        makeInMemIterator(expected));
+        }
+        {  // big, prefix compressed
+            const int numKeys = 1000 * 1000;
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(SortOptions(opts).PrefixCompressKeys());
+            for (int i = 0; i < numKeys; i++)
+                sorter.addAlreadySorted(i, -i);
+
+            ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                        make_shared<IntIterator>(0, numKeys));
+        }
 
         ASSERT(boost::filesystem::is_empty(tempDir.path()));
     }
@@ -510,6 +530,13 @@ public:
     PseudoRandom _random;
 };
 
+// Runs are sorted and spilled on another thread, and the files are read ahead during the merge.
+class LotsOfDataBackgroundSpills : public LotsOfDataLittleMemory</*random=*/true> {
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return LotsOfDataLittleMemory::adjustSortOptions(opts).BackgroundSpills();
+    }
+};
+
 
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
@@ -549,6 +576,7 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataBackgroundSpills>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
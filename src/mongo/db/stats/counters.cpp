@@ -45,37 +45,37 @@ OpCounters::OpCounters() {}
 
 void OpCounters::gotInserts(int n) {
     RARELY _checkWrap();
-    _insert.fetchAndAdd(n);
+    _insert.increment(n);
 }
 
 void OpCounters::gotInsert() {
     RARELY _checkWrap();
-    _insert.fetchAndAdd(1);
+    _insert.increment(1);
 }
 
 void OpCounters::gotQuery() {
     RARELY _checkWrap();
-    _query.fetchAndAdd(1);
+    _query.increment(1);
 }
 
 void OpCounters::gotUpdate() {
     RARELY _checkWrap();
-    _update.fetchAndAdd(1);
+    _update.increment(1);
 }
 
 void OpCounters::gotDelete() {
     RARELY _checkWrap();
-    _delete.fetchAndAdd(1);
+    _delete.increment(1);
 }
 
 void OpCounters::gotGetMore() {
     RARELY _checkWrap();
-    _getmore.fetchAndAdd(1);
+    _getmore.increment(1);
 }
 
 void OpCounters::gotCommand() {
     RARELY _checkWrap();
-    _command.fetchAndAdd(1);
+    _command.increment(1);
 }
 
 void OpCounters::gotOp(int op, bool isCommand) {
@@ -107,99 +107,69 @@ void OpCounters::gotOp(int op, bool isCommand) {
 }
 
 void OpCounters::_checkWrap() {
-    const unsigned MAX = 1 << 30;
+    const long long MAX = 1 << 30;
 
-    bool wrap = _insert.loadRelaxed() > MAX || _query.loadRelaxed() > MAX ||
-        _update.loadRelaxed() > MAX || _delete.loadRelaxed() > MAX ||
-        _getmore.loadRelaxed() > MAX || _command.loadRelaxed() > MAX;
+    bool wrap = _insert.get() > MAX || _query.get() > MAX || _update.get() > MAX ||
+        _delete.get() > MAX || _getmore.get() > MAX || _command.get() > MAX;
 
     if (wrap) {
-        _insert.store(0);
-        _query.store(0);
-        _update.store(0);
-        _delete.store(0);
-        _getmore.store(0);
-        _command.store(0);
+        _insert.reset();
+        _query.reset();
+        _update.reset();
+        _delete.reset();
+        _getmore.reset();
+        _command.reset();
     }
 }
 
 BSONObj OpCounters::getObj() const {
     BSONObjBuilder b;
-    b.append("insert", _insert.loadRelaxed());
-    b.append("query", _query.loadRelaxed());
-    b.append("update", _update.loadRelaxed());
-    b.append("delete", _delete.loadRelaxed());
-    b.append("getmore", _getmore.loadRelaxed());
-    b.append("command", _command.loadRelaxed());
+    b.append("insert", _insert.get());
+    b.append("query", _query.get());
+    b.append("update", _update.get());
+    b.append("delete", _delete.get());
+    b.append("getmore", _getmore.get());
+    b.append("command", _command.get());
     return b.obj();
 }
 
-void NetworkCounter::hitPhysicalIn(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
-
-    // don't care about the race as its just a counter
-    const bool overflow = _physicalBytesIn.loadRelaxed() > MAX;
-
-    if (overflow) {
-        _physicalBytesIn.store(bytes);
-    } else {
-        _physicalBytesIn.fetchAndAdd(bytes);
+void NetworkCounter::_hit(ShardedCounter64& counter, long long n) {
+    // Only this thread's shard is checked, so the hot path never reads the other threads' cache
+    // lines. Don't care about the race as its just a counter.
+    if (counter.increment(n) > kMaxShardValue) {
+        counter.reset();
+        counter.increment(n);
     }
 }
 
-void NetworkCounter::hitPhysicalOut(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
-
-    // don't care about the race as its just a counter
-    const bool overflow = _physicalBytesOut.loadRelaxed() > MAX;
+void NetworkCounter::hitPhysicalIn(long long bytes) {
+    _hit(_physicalBytesIn, bytes);
+}
 
-    if (overflow) {
-        _physicalBytesOut.store(bytes);
-    } else {
-        _physicalBytesOut.fetchAndAdd(bytes);
-    }
+void NetworkCounter::hitPhysicalOut(long long bytes) {
+    _hit(_physicalBytesOut, bytes);
 }
 
 void NetworkCounter::hitLogicalIn(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
-
-    // don't care about the race as its just a counter
-    const bool overflow = _together.logicalBytesIn.loadRelaxed() > MAX;
-
-    if (overflow) {
-        _together.logicalBytesIn.store(bytes);
-        // The requests field only gets incremented here (and not in hitPhysical) because the
-        // hitLogical and hitPhysical are each called for each operation. Incrementing it in both
-        // functions would double-count the number of operations.
-        _together.requests.store(1);
-    } else {
-        _together.logicalBytesIn.fetchAndAdd(bytes);
-        _together.requests.fetchAndAdd(1);
-    }
+    _hit(_logicalBytesIn, bytes);
+    // The requests field only gets incremented here (and not in hitPhysical) because the
+    // hitLogical and hitPhysical are each called for each operation. Incrementing it in both
+    // functions would double-count the number of operations.
+    _hit(_requests, 1);
 }
 
 void NetworkCounter::hitLogicalOut(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
-
-    // don't care about the race as its just a counter
-    const bool overflow = _logicalBytesOut.loadRelaxed() > MAX;
-
-    if (overflow) {
-        _logicalBytesOut.store(bytes);
-    } else {
-        _logicalBytesOut.fetchAndAdd(bytes);
-    }
+    _hit(_logicalBytesOut, bytes);
 }
 
 void NetworkCounter::append(BSONObjBuilder& b) {
-    b.append("bytesIn", static_cast<long long>(_together.logicalBytesIn.loadRelaxed()));
-    b.append("bytesOut", static_cast<long long>(_logicalBytesOut.loadRelaxed()));
-    b.append("physicalBytesIn", static_cast<long long>(_physicalBytesIn.loadRelaxed()));
-    b.append("physicalBytesOut", static_cast<long long>(_physicalBytesOut.loadRelaxed()));
-    b.append("numRequests", static_cast<long long>(_together.requests.loadRelaxed()));
+    b.append("bytesIn", _logicalBytesIn.get());
+    b.append("bytesOut", _logicalBytesOut.get());
+    b.append("physicalBytesIn", _physicalBytesIn.get());
+    b.append("physicalBytesOut", _physicalBytesOut.get());
+    b.append("numRequests", _requests.get());
 }
 
-
 OpCounters globalOpCounters;
 OpCounters replOpCounters;
 NetworkCounter networkCounter;
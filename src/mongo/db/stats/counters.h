@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/base/counter.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/basic.h"
@@ -41,7 +42,9 @@ namespace mongo {
 
 /**
  * for storing operation counters
- * note: not thread safe.  ok with that for speed
+ *
+ * Every operation bumps one of these, so each counter is sharded across threads (see
+ * ShardedCounter64) and only summed when read.
  */
 class OpCounters {
 public:
@@ -59,34 +62,34 @@ public:
     BSONObj getObj() const;
 
     // thse are used by snmp, and other things, do not remove
-    const AtomicUInt32* getInsert() const {
-        return &_insert;
+    long long getInsert() const {
+        return _insert.get();
     }
-    const AtomicUInt32* getQuery() const {
-        return &_query;
+    long long getQuery() const {
+        return _query.get();
     }
-    const AtomicUInt32* getUpdate() const {
-        return &_update;
+    long long getUpdate() const {
+        return _update.get();
     }
-    const AtomicUInt32* getDelete() const {
-        return &_delete;
+    long long getDelete() const {
+        return _delete.get();
     }
-    const AtomicUInt32* getGetMore() const {
-        return &_getmore;
+    long long getGetMore() const {
+        return _getmore.get();
     }
-    const AtomicUInt32* getCommand() const {
-        return &_command;
+    long long getCommand() const {
+        return _command.get();
     }
 
 private:
     void _checkWrap();
 
-    CacheAligned<AtomicUInt32> _insert;
-    CacheAligned<AtomicUInt32> _query;
-    CacheAligned<AtomicUInt32> _update;
-    CacheAligned<AtomicUInt32> _delete;
-    CacheAligned<AtomicUInt32> _getmore;
-    CacheAligned<AtomicUInt32> _command;
+    ShardedCounter64 _insert;
+    ShardedCounter64 _query;
+    ShardedCounter64 _update;
+    ShardedCounter64 _delete;
+    ShardedCounter64 _getmore;
+    ShardedCounter64 _command;
 };
 
 extern OpCounters globalOpCounters;
@@ -106,20 +109,17 @@ public:
     void append(BSONObjBuilder& b);
 
 private:
-    CacheAligned<AtomicInt64> _physicalBytesIn{0};
-    CacheAligned<AtomicInt64> _physicalBytesOut{0};
-
-    // These two counters are always incremented at the same time, so
-    // we place them on the same cache line.
-    struct Together {
-        AtomicInt64 logicalBytesIn{0};
-        AtomicInt64 requests{0};
-    };
-    CacheAligned<Together> _together{};
-    static_assert(sizeof(decltype(_together)) <= stdx::hardware_constructive_interference_size,
-                  "cache line spill");
-
-    CacheAligned<AtomicInt64> _logicalBytesOut{0};
+    // Every counter is bumped for every request, so they are sharded across threads. Each one
+    // resets itself once the calling thread's shard passes kMaxShardValue.
+    static constexpr long long kMaxShardValue = (1LL << 60) / ShardedCounter64::kNumShards;
+
+    static void _hit(ShardedCounter64& counter, long long n);
+
+    ShardedCounter64 _physicalBytesIn;
+    ShardedCounter64 _physicalBytesOut;
+    ShardedCounter64 _logicalBytesIn;
+    ShardedCounter64 _logicalBytesOut;
+    ShardedCounter64 _requests;
 };
 
 extern NetworkCounter networkCounter;
@@ -31,6 +31,7 @@
 #include "mongo/db/stats/operation_latency_histogram.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/namespace_string.h"
@@ -98,19 +99,34 @@ void OperationLatencyHistogram::_append(const HistogramData& data,
 
     BSONObjBuilder histogramBuilder(builder->subobjStart(key));
     if (includeHistograms) {
+        // Every high resolution bucket lies within a single one of the coarse buckets, because
+        // the coarse bucket boundaries are all powers of two or halfway between two of them.
+        std::array<uint64_t, kMaxBuckets> buckets{};
+        for (int i = 0; i < kHighResBuckets; i++) {
+            buckets[_getBucket(_getHighResBucketLowerBound(i))] += data.buckets[i];
+        }
+
         BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
         for (int i = 0; i < kMaxBuckets; i++) {
-            if (data.buckets[i] == 0)
+            if (buckets[i] == 0)
                 continue;
             BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
             entryBuilder.append("micros", static_cast<long long>(kLowerBounds[i]));
-            entryBuilder.append("count", static_cast<long long>(data.buckets[i]));
+            entryBuilder.append("count", static_cast<long long>(buckets[i]));
             entryBuilder.doneFast();
         }
         arrayBuilder.doneFast();
     }
     histogramBuilder.append("latency", static_cast<long long>(data.sum));
     histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
+
+    BSONObjBuilder percentilesBuilder(histogramBuilder.subobjStart("percentiles"));
+    percentilesBuilder.append("p50", static_cast<long long>(_getPercentile(data, 0.5)));
+    percentilesBuilder.append("p90", static_cast<long long>(_getPercentile(data, 0.9)));
+    percentilesBuilder.append("p99", static_cast<long long>(_getPercentile(data, 0.99)));
+    percentilesBuilder.append("p999", static_cast<long long>(_getPercentile(data, 0.999)));
+    percentilesBuilder.doneFast();
+
     histogramBuilder.doneFast();
 }
 
@@ -148,14 +164,91 @@ int OperationLatencyHistogram::_getBucket(uint64_t value) {
     }
 }
 
+int OperationLatencyHistogram::_getHighResBucket(uint64_t value) {
+    if (value < kSubBuckets) {
+        return value;
+    }
+
+    int log2 = 63 - countLeadingZeros64(value);
+    if (log2 > kMaxHighResBucketExponent) {
+        return kHighResBuckets - 1;
+    }
+
+    // The kSubBucketBits bits below the leading one pick the bucket within the power of two.
+    int subBucket = (value >> (log2 - kSubBucketBits)) & (kSubBuckets - 1);
+    return kSubBuckets + (log2 - kSubBucketBits) * kSubBuckets + subBucket;
+}
+
+uint64_t OperationLatencyHistogram::_getHighResBucketLowerBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+
+    int log2 = (bucket - kSubBuckets) / kSubBuckets + kSubBucketBits;
+    uint64_t subBucket = (bucket - kSubBuckets) % kSubBuckets;
+    return (kSubBuckets + subBucket) << (log2 - kSubBucketBits);
+}
+
+uint64_t OperationLatencyHistogram::_getPercentile(const HistogramData& data, double percentile) {
+    if (data.entryCount == 0) {
+        return 0;
+    }
+
+    const uint64_t rank = std::max<uint64_t>(1, std::ceil(percentile * data.entryCount));
+    uint64_t seen = 0;
+    for (int i = 0; i < kHighResBuckets - 1; i++) {
+        seen += data.buckets[i];
+        if (seen >= rank) {
+            return _getHighResBucketLowerBound(i + 1) - 1;
+        }
+    }
+    // The last bucket has no upper bound.
+    return _getHighResBucketLowerBound(kHighResBuckets - 1);
+}
+
+const OperationLatencyHistogram::HistogramData& OperationLatencyHistogram::_getData(
+    Command::ReadWriteType type) const {
+    switch (type) {
+        case Command::ReadWriteType::kRead:
+            return _reads;
+        case Command::ReadWriteType::kWrite:
+            return _writes;
+        case Command::ReadWriteType::kCommand:
+            return _commands;
+        case Command::ReadWriteType::kTransaction:
+            return _transactions;
+    }
+    MONGO_UNREACHABLE;
+}
+
+uint64_t OperationLatencyHistogram::getPercentile(double percentile,
+                                                  Command::ReadWriteType type) const {
+    return _getPercentile(_getData(type), percentile);
+}
+
 void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, HistogramData* data) {
     data->buckets[bucket]++;
     data->entryCount++;
     data->sum += latency;
 }
 
+void OperationLatencyHistogram::_mergeData(const HistogramData& from, HistogramData* into) {
+    for (int i = 0; i < kHighResBuckets; i++) {
+        into->buckets[i] += from.buckets[i];
+    }
+    into->entryCount += from.entryCount;
+    into->sum += from.sum;
+}
+
+void OperationLatencyHistogram::merge(const OperationLatencyHistogram& other) {
+    _mergeData(other._reads, &_reads);
+    _mergeData(other._writes, &_writes);
+    _mergeData(other._commands, &_commands);
+    _mergeData(other._transactions, &_transactions);
+}
+
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
-    int bucket = _getBucket(latency);
+    int bucket = _getHighResBucket(latency);
     switch (type) {
         case Command::ReadWriteType::kRead:
             _incrementData(latency, bucket, &_reads);
@@ -39,6 +39,11 @@ class BSONObjBuilder;
  * Stores statistics for latencies of read, write, command, and multi-document transaction
  * operations.
  *
+ * Latencies are counted in log-linear buckets in the style of an HDR histogram: every power of two
+ * is split into kSubBuckets equal-width buckets, so any latency is known to within 12.5% and the
+ * p50/p90/p99/p999 latencies can be reported. The coarser kMaxBuckets histogram reported when
+ * histograms are requested is derived from these buckets.
+ *
  * Note: This class is not thread-safe.
  */
 class OperationLatencyHistogram {
@@ -48,26 +53,53 @@ public:
     // Inclusive lower bounds of the histogram buckets.
     static const std::array<uint64_t, kMaxBuckets> kLowerBounds;
 
+    // The number of equal-width buckets each power of two is split into.
+    static const int kSubBucketBits = 3;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+
+    // Latencies below kSubBuckets get a bucket each, then every power of two up to 2^40 gets
+    // kSubBuckets buckets. Latencies of 2^41 and above are counted in the last bucket.
+    static const int kMaxHighResBucketExponent = 40;
+    static const int kHighResBuckets =
+        kSubBuckets + (kMaxHighResBucketExponent - kSubBucketBits + 1) * kSubBuckets;
+
     /**
      * Increments the bucket of the histogram based on the operation type.
      */
     void increment(uint64_t latency, Command::ReadWriteType type);
 
     /**
-     * Appends the four histograms with latency totals and operation counts.
+     * Adds the operations counted in 'other' to this histogram.
+     */
+    void merge(const OperationLatencyHistogram& other);
+
+    /**
+     * Appends the four histograms with latency totals, operation counts and percentiles.
      */
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
+    /**
+     * Returns the highest latency that is counted in the same bucket as the latency below which
+     * 'percentile' of the operations of 'type' fell, or 0 if there were no such operations.
+     */
+    uint64_t getPercentile(double percentile, Command::ReadWriteType type) const;
+
 private:
     struct HistogramData {
-        std::array<uint64_t, kMaxBuckets> buckets{};
+        std::array<uint64_t, kHighResBuckets> buckets{};
         uint64_t entryCount = 0;
         uint64_t sum = 0;
     };
 
     static int _getBucket(uint64_t latency);
 
-    static uint64_t _getBucketMicros(int bucket);
+    static int _getHighResBucket(uint64_t latency);
+
+    static uint64_t _getHighResBucketLowerBound(int bucket);
+
+    static uint64_t _getPercentile(const HistogramData& data, double percentile);
+
+    const HistogramData& _getData(Command::ReadWriteType type) const;
 
     void _append(const HistogramData& data,
                  const char* key,
@@ -76,6 +108,8 @@ private:
 
     void _incrementData(uint64_t latency, int bucket, HistogramData* data);
 
+    static void _mergeData(const HistogramData& from, HistogramData* into);
+
     HistogramData _reads, _writes, _commands, _transactions;
 };
 }  // namespace mongo
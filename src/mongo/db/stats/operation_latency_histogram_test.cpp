@@ -91,4 +91,74 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, MergeAddsEveryHistogram) {
+    OperationLatencyHistogram first;
+    OperationLatencyHistogram second;
+    first.increment(10, Command::ReadWriteType::kRead);
+    second.increment(1000, Command::ReadWriteType::kRead);
+    second.increment(20, Command::ReadWriteType::kTransaction);
+
+    first.merge(second);
+    BSONObjBuilder outBuilder;
+    first.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 2);
+    ASSERT_EQUALS(out["reads"]["latency"].Long(), 1010);
+    ASSERT_EQUALS(out["reads"]["histogram"].Array().size(), 2U);
+    ASSERT_EQUALS(out["transactions"]["ops"].Long(), 1);
+    ASSERT_EQUALS(out["writes"]["ops"].Long(), 0);
+    ASSERT_GTE(first.getPercentile(1, Command::ReadWriteType::kRead), 1000U);
+}
+
+TEST(OperationLatencyHistogram, PercentilesOfEmptyHistogramAreZero) {
+    OperationLatencyHistogram hist;
+    ASSERT_EQUALS(hist.getPercentile(0.99, Command::ReadWriteType::kRead), 0U);
+
+    BSONObjBuilder outBuilder;
+    hist.append(false, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["percentiles"]["p50"].Long(), 0);
+    ASSERT_EQUALS(out["reads"]["percentiles"]["p999"].Long(), 0);
+}
+
+TEST(OperationLatencyHistogram, SmallLatenciesHaveExactPercentiles) {
+    OperationLatencyHistogram hist;
+    for (uint64_t latency = 0; latency < 8; latency++) {
+        hist.increment(latency, Command::ReadWriteType::kRead);
+    }
+    ASSERT_EQUALS(hist.getPercentile(0.5, Command::ReadWriteType::kRead), 3U);
+    ASSERT_EQUALS(hist.getPercentile(1, Command::ReadWriteType::kRead), 7U);
+}
+
+TEST(OperationLatencyHistogram, PercentilesAreWithinAnEighthOfTheLatency) {
+    OperationLatencyHistogram hist;
+    for (int i = 0; i < 990; i++) {
+        hist.increment(1000, Command::ReadWriteType::kWrite);
+    }
+    for (int i = 0; i < 9; i++) {
+        hist.increment(50000, Command::ReadWriteType::kWrite);
+    }
+    hist.increment(3000000, Command::ReadWriteType::kWrite);
+
+    auto checkWithinAnEighth = [&](double percentile, uint64_t latency) {
+        uint64_t reported = hist.getPercentile(percentile, Command::ReadWriteType::kWrite);
+        ASSERT_GTE(reported, latency);
+        ASSERT_LTE(reported, latency + latency / 8);
+    };
+    checkWithinAnEighth(0.5, 1000);
+    checkWithinAnEighth(0.99, 1000);
+    checkWithinAnEighth(0.995, 50000);
+    checkWithinAnEighth(0.999, 50000);
+    checkWithinAnEighth(1, 3000000);
+
+    // The other histograms are unaffected.
+    ASSERT_EQUALS(hist.getPercentile(0.5, Command::ReadWriteType::kRead), 0U);
+
+    BSONObjBuilder outBuilder;
+    hist.append(false, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(static_cast<uint64_t>(out["writes"]["percentiles"]["p99"].Long()),
+                  hist.getPercentile(0.99, Command::ReadWriteType::kWrite));
+}
 }  // namespace mongo
@@ -0,0 +1,212 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// The maximum number of query shapes whose statistics are kept. Zero turns the store off.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(queryStatsMaxShapes, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "queryStatsMaxShapes must be non-negative");
+        }
+        return Status::OK();
+    });
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+}  // namespace
+
+constexpr size_t QueryStatsStore::kNumPartitions;
+constexpr size_t QueryStatsStore::kNumLatencyBuckets;
+
+// static
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+QueryStatsStore::QueryStatsStore() : QueryStatsStore(queryStatsMaxShapes) {}
+
+QueryStatsStore::QueryStatsStore(size_t maxShapes) : _maxShapes(maxShapes) {
+    const size_t shapesPerPartition = (maxShapes + kNumPartitions - 1) / kNumPartitions;
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>(shapesPerPartition));
+    }
+}
+
+// static
+size_t QueryStatsStore::_latencyBucket(long long micros) {
+    size_t bucket = 0;
+    while (micros > 0 && bucket < kNumLatencyBuckets - 1) {
+        micros >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void QueryStatsStore::record(StringData ns, uint32_t queryHash, const Execution& execution) {
+    if (_maxShapes == 0) {
+        return;
+    }
+
+    const auto now = Date_t::now();
+    const std::string key = str::stream() << unsignedIntToFixedLengthHex(queryHash) << ns;
+    auto& partition = *_partitions[queryHash % kNumPartitions];
+
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+
+    QueryShapeStats* stats;
+    if (!partition.shapes.get(key, &stats).isOK()) {
+        stats = new QueryShapeStats();
+        stats->ns = ns.toString();
+        stats->queryHash = queryHash;
+        stats->firstSeen = now;
+        if (partition.shapes.add(key, stats)) {
+            _numEvicted.fetchAndAdd(1);
+        }
+    }
+
+    stats->lastSeen = now;
+    stats->execCount++;
+    stats->totalLatencyMicros += execution.latencyMicros;
+    stats->maxLatencyMicros = std::max(stats->maxLatencyMicros, execution.latencyMicros);
+    stats->latencyHistogram[_latencyBucket(execution.latencyMicros)]++;
+    stats->keysExamined += execution.keysExamined;
+    stats->docsExamined += execution.docsExamined;
+    stats->nreturned += execution.nreturned;
+    stats->bytesReturned += execution.bytesReturned;
+
+    _numRecorded.fetchAndAdd(1);
+}
+
+std::vector<QueryStatsStore::QueryShapeStats> QueryStatsStore::_copyShapes() const {
+    std::vector<QueryShapeStats> shapes;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+        for (auto it = partition->shapes.begin(); it != partition->shapes.end(); ++it) {
+            shapes.push_back(*it->second);
+        }
+    }
+    return shapes;
+}
+
+std::vector<BSONObj> QueryStatsStore::getStats() const {
+    std::vector<BSONObj> results;
+    for (const auto& stats : _copyShapes()) {
+        results.push_back(stats.toBSON(true));
+    }
+    return results;
+}
+
+void QueryStatsStore::appendSummary(size_t topN, BSONObjBuilder* builder) const {
+    auto shapes = _copyShapes();
+
+    builder->append("numShapes", static_cast<long long>(shapes.size()));
+    builder->append("numRecorded", _numRecorded.load());
+    builder->append("numEvicted", _numEvicted.load());
+
+    const auto byTotalLatency = [](const QueryShapeStats& a, const QueryShapeStats& b) {
+        return a.totalLatencyMicros > b.totalLatencyMicros;
+    };
+    topN = std::min(topN, shapes.size());
+    std::partial_sort(shapes.begin(), shapes.begin() + topN, shapes.end(), byTotalLatency);
+
+    // Only numbers go into FTDC, so that the set of top shapes changing does not change the
+    // schema of the sample.
+    BSONArrayBuilder top(builder->subarrayStart("topByLatency"));
+    for (size_t i = 0; i < topN; ++i) {
+        top.append(shapes[i].toBSON(false));
+    }
+}
+
+void QueryStatsStore::clear() {
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+        partition->shapes.clear();
+    }
+}
+
+long long QueryStatsStore::QueryShapeStats::latencyPercentile(double percentile) const {
+    if (execCount == 0) {
+        return 0;
+    }
+
+    const long long rank = std::max(1LL, static_cast<long long>(std::ceil(percentile * execCount)));
+    long long seen = 0;
+    for (size_t bucket = 0; bucket < kNumLatencyBuckets; ++bucket) {
+        seen += latencyHistogram[bucket];
+        if (seen >= rank) {
+            // Nothing in the bucket took longer than the slowest execution.
+            const long long upperBound = bucket == 0 ? 0 : (1LL << bucket) - 1;
+            return std::min(upperBound, maxLatencyMicros);
+        }
+    }
+    return maxLatencyMicros;
+}
+
+BSONObj QueryStatsStore::QueryShapeStats::toBSON(bool includeIdentity) const {
+    BSONObjBuilder builder;
+    if (includeIdentity) {
+        builder.append("ns", ns);
+        builder.append("queryHash", unsignedIntToFixedLengthHex(queryHash));
+        builder.append("firstSeen", firstSeen);
+        builder.append("lastSeen", lastSeen);
+    }
+    builder.append("execCount", execCount);
+    {
+        BSONObjBuilder latency(builder.subobjStart("latencyMicros"));
+        latency.append("total", totalLatencyMicros);
+        latency.append("max", maxLatencyMicros);
+        latency.append("p50", latencyPercentile(0.5));
+        latency.append("p95", latencyPercentile(0.95));
+        latency.append("p99", latencyPercentile(0.99));
+    }
+    builder.append("keysExamined", keysExamined);
+    builder.append("docsExamined", docsExamined);
+    builder.append("nreturned", nreturned);
+    builder.append("bytesReturned", bytesReturned);
+    return builder.obj();
+}
+
+}  // namespace mongo
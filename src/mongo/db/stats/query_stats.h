@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * An in-memory, bounded store of execution statistics aggregated per query shape.
+ *
+ * A shape is identified by its namespace and the plan cache's queryHash, so the statistics here
+ * can be joined with $planCacheStats and with the queryHash printed in slow query log lines. Each
+ * operation that was planned through the plan cache key encoding reports its latency and work at
+ * the end of the operation, and the store keeps at most 'queryStatsMaxShapes' shapes, evicting
+ * the least recently executed ones.
+ *
+ * The store is split into partitions by queryHash, each with its own mutex, so that operations on
+ * different shapes rarely contend.
+ */
+class QueryStatsStore {
+    MONGO_DISALLOW_COPYING(QueryStatsStore);
+
+public:
+    static QueryStatsStore& get(ServiceContext* service);
+
+    /**
+     * The work done by a single execution of a query shape.
+     */
+    struct Execution {
+        long long latencyMicros = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+    };
+
+    /**
+     * Constructs a store holding up to the number of shapes in the 'queryStatsMaxShapes' startup
+     * parameter.
+     */
+    QueryStatsStore();
+
+    explicit QueryStatsStore(size_t maxShapes);
+
+    /**
+     * Adds 'execution' to the entry for the shape ('ns', 'queryHash'), creating it if needed.
+     * Called by recordCurOpMetrics() at the end of every operation that has a queryHash.
+     */
+    void record(StringData ns, uint32_t queryHash, const Execution& execution);
+
+    /**
+     * Returns one document per query shape currently in the store. See QueryShapeStats::toBSON()
+     * for the format.
+     */
+    std::vector<BSONObj> getStats() const;
+
+    /**
+     * Appends a summary of the store suitable for FTDC: the number of shapes, the number of
+     * executions recorded and shapes evicted, and the numeric statistics of the 'topN' shapes
+     * with the highest total latency.
+     */
+    void appendSummary(size_t topN, BSONObjBuilder* builder) const;
+
+    /**
+     * Removes every shape from the store.
+     */
+    void clear();
+
+private:
+    static constexpr size_t kNumPartitions = 16;
+
+    // Bucket 0 counts executions faster than 1 microsecond, bucket i > 0 counts executions taking
+    // [2^(i-1), 2^i) microseconds, and the last bucket also counts everything slower.
+    static constexpr size_t kNumLatencyBuckets = 32;
+
+    struct QueryShapeStats {
+        /**
+         * Returns the latency in microseconds below which 'percentile' of the executions fell,
+         * rounded up to the upper bound of the histogram bucket it lands in.
+         */
+        long long latencyPercentile(double percentile) const;
+
+        /**
+         * Produces
+         *   {ns, queryHash, firstSeen, lastSeen, execCount,
+         *    latencyMicros: {total, max, p50, p95, p99},
+         *    keysExamined, docsExamined, nreturned, bytesReturned}
+         * If 'includeIdentity' is false, ns, queryHash, firstSeen and lastSeen are left out.
+         */
+        BSONObj toBSON(bool includeIdentity) const;
+
+        std::string ns;
+        uint32_t queryHash = 0;
+        Date_t firstSeen;
+        Date_t lastSeen;
+
+        long long execCount = 0;
+        long long totalLatencyMicros = 0;
+        long long maxLatencyMicros = 0;
+        std::array<long long, kNumLatencyBuckets> latencyHistogram{};
+
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+    };
+
+    struct Partition {
+        explicit Partition(size_t maxShapes) : shapes(maxShapes) {}
+
+        // Guards 'shapes' and the QueryShapeStats it owns.
+        mutable stdx::mutex mutex;
+
+        // Keyed by the fixed-length hex queryHash followed by the namespace.
+        LRUKeyValue<std::string, QueryShapeStats> shapes;
+    };
+
+    static size_t _latencyBucket(long long micros);
+
+    std::vector<QueryShapeStats> _copyShapes() const;
+
+    const size_t _maxShapes;
+    std::vector<std::unique_ptr<Partition>> _partitions;
+
+    AtomicInt64 _numRecorded;
+    AtomicInt64 _numEvicted;
+};
+
+}  // namespace mongo
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+QueryStatsStore::Execution makeExecution(long long latencyMicros) {
+    QueryStatsStore::Execution execution;
+    execution.latencyMicros = latencyMicros;
+    execution.keysExamined = 2;
+    execution.docsExamined = 3;
+    execution.nreturned = 1;
+    execution.bytesReturned = 100;
+    return execution;
+}
+
+TEST(QueryStatsStoreTest, AggregatesExecutionsOfTheSameShape) {
+    QueryStatsStore store(100);
+    store.record("test.coll", 0x1234, makeExecution(10));
+    store.record("test.coll", 0x1234, makeExecution(30));
+
+    auto stats = store.getStats();
+    ASSERT_EQ(1U, stats.size());
+    ASSERT_EQ("test.coll", stats[0]["ns"].str());
+    ASSERT_EQ("00001234", stats[0]["queryHash"].str());
+    ASSERT_EQ(2, stats[0]["execCount"].numberLong());
+    ASSERT_EQ(40, stats[0]["latencyMicros"]["total"].numberLong());
+    ASSERT_EQ(30, stats[0]["latencyMicros"]["max"].numberLong());
+    ASSERT_EQ(4, stats[0]["keysExamined"].numberLong());
+    ASSERT_EQ(6, stats[0]["docsExamined"].numberLong());
+    ASSERT_EQ(2, stats[0]["nreturned"].numberLong());
+    ASSERT_EQ(200, stats[0]["bytesReturned"].numberLong());
+    ASSERT_LTE(stats[0]["firstSeen"].Date(), stats[0]["lastSeen"].Date());
+}
+
+TEST(QueryStatsStoreTest, SameQueryHashOnDifferentNamespacesIsADifferentShape) {
+    QueryStatsStore store(100);
+    store.record("test.a", 0x1234, makeExecution(10));
+    store.record("test.b", 0x1234, makeExecution(10));
+    store.record("test.b", 0x5678, makeExecution(10));
+
+    ASSERT_EQ(3U, store.getStats().size());
+}
+
+TEST(QueryStatsStoreTest, PercentilesAreUpperBoundsOfLatencyBuckets) {
+    QueryStatsStore store(100);
+    for (int i = 0; i < 90; ++i) {
+        store.record("test.coll", 1, makeExecution(5));
+    }
+    for (int i = 0; i < 10; ++i) {
+        store.record("test.coll", 1, makeExecution(1000));
+    }
+
+    auto stats = store.getStats();
+    auto latency = stats[0]["latencyMicros"].Obj();
+    // 5 falls in the [4, 8) bucket.
+    ASSERT_EQ(7, latency["p50"].numberLong());
+    // 1000 falls in the [512, 1024) bucket, but nothing took longer than 1000.
+    ASSERT_EQ(1000, latency["p95"].numberLong());
+    ASSERT_EQ(1000, latency["p99"].numberLong());
+}
+
+TEST(QueryStatsStoreTest, EvictsLeastRecentlyExecutedShape) {
+    // With 16 partitions, each partition holds a single shape.
+    QueryStatsStore store(16);
+    store.record("test.coll", 0, makeExecution(10));
+    store.record("test.coll", 1, makeExecution(10));
+    // Lands in the same partition as queryHash 0.
+    store.record("test.coll", 16, makeExecution(10));
+
+    auto stats = store.getStats();
+    ASSERT_EQ(2U, stats.size());
+    for (const auto& shape : stats) {
+        ASSERT_NE("00000000", shape["queryHash"].str());
+    }
+
+    BSONObjBuilder summary;
+    store.appendSummary(0, &summary);
+    ASSERT_EQ(1, summary.obj()["numEvicted"].numberLong());
+}
+
+TEST(QueryStatsStoreTest, ZeroMaxShapesKeepsNothing) {
+    QueryStatsStore store(0);
+    store.record("test.coll", 1, makeExecution(10));
+    ASSERT_EQ(0U, store.getStats().size());
+}
+
+TEST(QueryStatsStoreTest, SummaryHoldsOnlyNumbersOfTheSlowestShapes) {
+    QueryStatsStore store(100);
+    store.record("test.coll", 1, makeExecution(10));
+    store.record("test.coll", 2, makeExecution(300));
+    store.record("test.coll", 3, makeExecution(20));
+
+    BSONObjBuilder builder;
+    store.appendSummary(2, &builder);
+    auto summary = builder.obj();
+
+    ASSERT_EQ(3, summary["numShapes"].numberLong());
+    ASSERT_EQ(3, summary["numRecorded"].numberLong());
+    ASSERT_EQ(0, summary["numEvicted"].numberLong());
+
+    auto top = summary["topByLatency"].Array();
+    ASSERT_EQ(2U, top.size());
+    ASSERT_EQ(300, top[0]["latencyMicros"]["total"].numberLong());
+    ASSERT_EQ(20, top[1]["latencyMicros"]["total"].numberLong());
+    ASSERT_FALSE(top[0].Obj().hasField("ns"));
+    ASSERT_FALSE(top[0].Obj().hasField("queryHash"));
+}
+
+TEST(QueryStatsStoreTest, ClearRemovesEveryShape) {
+    QueryStatsStore store(100);
+    store.record("test.coll", 1, makeExecution(10));
+    store.record("test.coll", 2, makeExecution(10));
+    store.clear();
+    ASSERT_EQ(0U, store.getStats().size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,8 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -72,6 +74,26 @@ Top& Top::get(ServiceContext* service) {
     return getTop(service);
 }
 
+Top::Top() {
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>());
+    }
+    for (size_t i = 0; i < kNumGlobalHistogramShards; ++i) {
+        _globalHistogramShards.push_back(stdx::make_unique<GlobalHistogramShard>());
+    }
+}
+
+Top::Partition& Top::_getPartition(const UsageMap::HashedKey& hashedNs) const {
+    // The low bits of the hash pick the slot within the usage map, so use the high bits here.
+    return *_partitions[(hashedNs.hash() >> 28) % kNumPartitions];
+}
+
+Top::GlobalHistogramShard& Top::_getGlobalHistogramShard() const {
+    static AtomicWord<unsigned> nextShard;
+    thread_local const size_t myShard = nextShard.fetchAndAdd(1) % kNumGlobalHistogramShards;
+    return *_globalHistogramShards[myShard];
+}
+
 void Top::record(OperationContext* opCtx,
                  StringData ns,
                  LogicalOp logicalOp,
@@ -83,15 +105,16 @@ void Top::record(OperationContext* opCtx,
         return;
 
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    auto& partition = _getPartition(hashedNs);
+    stdx::lock_guard<SimpleMutex> lk(partition.lock);
 
     if ((command || logicalOp == LogicalOp::opQuery) &&
-        _collDropNs.find(ns.toString()) != _collDropNs.end()) {
-        _collDropNs.erase(ns.toString());
+        partition.collDropNs.find(ns.toString()) != partition.collDropNs.end()) {
+        partition.collDropNs.erase(ns.toString());
         return;
     }
 
-    CollectionData& coll = _usage[hashedNs];
+    CollectionData& coll = partition.usage[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
 
@@ -141,24 +164,32 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
+    auto hashedNs = UsageMap::HashedKey(ns);
+    auto& partition = _getPartition(hashedNs);
+    stdx::lock_guard<SimpleMutex> lk(partition.lock);
+    partition.usage.erase(hashedNs);
 
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
-        _collDropNs.insert(ns.toString());
+        partition.collDropNs.insert(ns.toString());
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out.clear();
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition->lock);
+        for (const auto& entry : partition->usage) {
+            out[entry.first] = entry.second;
+        }
+    }
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    UsageMap usage;
+    cloneMap(usage);
+    _appendToUsageMap(b, usage);
 }
 
 void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
@@ -201,9 +232,13 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    auto& partition = _getPartition(hashedNs);
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    {
+        stdx::lock_guard<SimpleMutex> lk(partition.lock);
+        partition.usage[hashedNs].opLatencyHistogram.append(includeHistograms,
+                                                            &latencyStatsBuilder);
+    }
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -211,18 +246,24 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    auto& shard = _getGlobalHistogramShard();
+    stdx::lock_guard<SimpleMutex> guard(shard.lock);
+    _incrementHistogram(opCtx, latency, &shard.histogram, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram globalHistogram;
+    for (const auto& shard : _globalHistogramShards) {
+        stdx::lock_guard<SimpleMutex> guard(shard->lock);
+        globalHistogram.merge(shard->histogram);
+    }
+    globalHistogram.append(includeHistograms, builder);
 }
 
 void Top::incrementGlobalTransactionLatencyStats(uint64_t latency) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.increment(latency, Command::ReadWriteType::kTransaction);
+    auto& shard = _getGlobalHistogramShard();
+    stdx::lock_guard<SimpleMutex> guard(shard.lock);
+    shard.histogram.increment(latency, Command::ReadWriteType::kTransaction);
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
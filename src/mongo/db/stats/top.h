@@ -30,6 +30,10 @@
 #pragma once
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
@@ -43,12 +47,17 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * Every operation records into Top when it finishes, so the usage map is split into partitions by
+ * the hash of the namespace, each with its own lock, and the global latency histogram is split
+ * into per-thread shards that are merged when read. Operations on different namespaces, and the
+ * global histogram updates of different threads, therefore rarely wait on each other.
  */
 class Top {
 public:
     static Top& get(ServiceContext* service);
 
-    Top() = default;
+    Top();
 
     struct UsageData {
         UsageData() : time(0), count(0) {}
@@ -129,6 +138,24 @@ public:
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
 private:
+    static constexpr size_t kNumPartitions = 16;
+    static constexpr size_t kNumGlobalHistogramShards = 16;
+
+    struct Partition {
+        SimpleMutex lock;
+        UsageMap usage;
+        std::set<std::string> collDropNs;
+    };
+
+    struct GlobalHistogramShard {
+        SimpleMutex lock;
+        OperationLatencyHistogram histogram;
+    };
+
+    Partition& _getPartition(const UsageMap::HashedKey& hashedNs) const;
+
+    GlobalHistogramShard& _getGlobalHistogramShard() const;
+
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
@@ -145,10 +172,10 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
-    std::set<std::string> _collDropNs;
+    // The partitions and shards are allocated separately so that their locks don't share cache
+    // lines.
+    std::vector<std::unique_ptr<Partition>> _partitions;
+    std::vector<std::unique_ptr<GlobalHistogramShard>> _globalHistogramShards;
 };
 
 }  // namespace mongo
@@ -39,4 +39,23 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+TEST(TopTest, CloneMapIncludesNamespacesFromEveryPartition) {
+    Top top;
+    for (int i = 0; i < 100; ++i) {
+        BSONObjBuilder builder;
+        top.appendLatencyStats("test.coll" + std::to_string(i), false, &builder);
+    }
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(100U, usage.size());
+
+    top.collectionDropped("test.coll0");
+    top.collectionDropped("test.coll50");
+    top.cloneMap(usage);
+    ASSERT_EQ(98U, usage.size());
+    ASSERT_EQ(0U, usage.count("test.coll0"));
+    ASSERT_EQ(1U, usage.count("test.coll1"));
+}
+
 }  // namespace
@@ -57,6 +57,7 @@ Status KVEngine::createRecordStore(OperationContext* opCtx,
                                    StringData ns,
                                    StringData ident,
                                    const CollectionOptions& options) {
+    stdx::lock_guard<stdx::mutex> lk(_identsLock);
     _idents[ident.toString()] = true;
     return Status::OK();
 }
@@ -66,12 +67,27 @@ std::unique_ptr<::mongo::RecordStore> KVEngine::getRecordStore(OperationContext*
                                                                StringData ident,
                                                                const CollectionOptions& options) {
     // TODO: deal with options.
-    _idents[ident.toString()] = true;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_identsLock);
+        _idents[ident.toString()] = true;
+    }
     return std::make_unique<RecordStore>(ns, ident);
 }
 
-void KVEngine::setMaster_inlock(std::unique_ptr<StringStore> newMaster) {
-    _master.reset(newMaster.release());
+bool KVEngine::trySwapMaster(const std::shared_ptr<StringStore>& expected,
+                             std::unique_ptr<StringStore>& newMaster) {
+    // Take ownership of the new branch outside of the lock, so that the old master is never
+    // destroyed while holding it.
+    std::shared_ptr<StringStore> oldMaster;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_masterLock);
+        if (_master != expected) {
+            return false;
+        }
+        oldMaster = std::move(_master);
+        _master = std::move(newMaster);
+    }
+    return true;
 }
 
 std::shared_ptr<StringStore> KVEngine::getMaster() const {
@@ -79,14 +95,11 @@ std::shared_ptr<StringStore> KVEngine::getMaster() const {
     return _master;
 }
 
-std::shared_ptr<StringStore> KVEngine::getMaster_inlock() const {
-    return _master;
-}
-
 
 Status KVEngine::createSortedDataInterface(OperationContext* opCtx,
                                            StringData ident,
                                            const IndexDescriptor* desc) {
+    stdx::lock_guard<stdx::mutex> lk(_identsLock);
     _idents[ident.toString()] = false;
     return Status::OK();  // I don't think we actually need to do anything here
 }
@@ -94,25 +107,36 @@ Status KVEngine::createSortedDataInterface(OperationContext* opCtx,
 mongo::SortedDataInterface* KVEngine::getSortedDataInterface(OperationContext* opCtx,
                                                              StringData ident,
                                                              const IndexDescriptor* desc) {
-    _idents[ident.toString()] = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_identsLock);
+        _idents[ident.toString()] = false;
+    }
     return new SortedDataInterface(Ordering::make(desc->keyPattern()), desc->unique(), ident);
 }
 
 Status KVEngine::dropIdent(OperationContext* opCtx, StringData ident) {
+    boost::optional<bool> isRecordStore;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_identsLock);
+        auto it = _idents.find(ident.toString());
+        if (it != _idents.end()) {
+            isRecordStore = it->second;
+            _idents.erase(it);
+        }
+    }
+
     Status dropStatus = Status::OK();
-    if (_idents.count(ident.toString()) > 0) {
+    if (isRecordStore) {
         // Check if the ident is a RecordStore or a SortedDataInterface then call the corresponding
         // truncate. A true value in the map means it is a RecordStore, false a SortedDataInterface.
-        if (_idents[ident.toString()] == true) {  // ident is RecordStore.
-            CollectionOptions s;
-            auto rs = getRecordStore(opCtx, ""_sd, ident, s);
+        if (*isRecordStore) {  // ident is RecordStore.
+            auto rs = std::make_unique<RecordStore>(""_sd, ident);
             dropStatus = rs->truncate(opCtx);
         } else {  // ident is SortedDataInterface.
             auto sdi =
                 std::make_unique<SortedDataInterface>(Ordering::make(BSONObj()), true, ident);
             dropStatus = sdi->truncate(opCtx);
         }
-        _idents.erase(ident.toString());
     }
     return dropStatus;
 }
@@ -45,8 +45,10 @@ class JournalListener;
  */
 class KVEngine : public ::mongo::KVEngine {
     std::shared_ptr<StringStore> _master = std::make_shared<StringStore>();
+    mutable stdx::mutex _masterLock;  // Protects '_master'. Only held to read or swap the pointer.
+
     std::map<std::string, bool> _idents;  // TODO : replace with a query to _master.
-    mutable stdx::mutex _masterLock;
+    mutable stdx::mutex _identsLock;      // Protects '_idents'.
 
 public:
     KVEngine() : ::mongo::KVEngine() {}
@@ -114,10 +116,12 @@ public:
     }
 
     virtual bool hasIdent(OperationContext* opCtx, StringData ident) const {
-        return true;
+        stdx::lock_guard<stdx::mutex> lk(_identsLock);
+        return _idents.count(ident.toString()) > 0;
     }
 
     std::vector<std::string> getAllIdents(OperationContext* opCtx) const {
+        stdx::lock_guard<stdx::mutex> lk(_identsLock);
         std::vector<std::string> idents;
         for (const auto& i : _idents) {
             idents.push_back(i.first);
@@ -136,19 +140,19 @@ public:
     // Biggie Specific
 
     /**
-     * Used to replace the master branch of the store with an updated copy.
-     * Appropriate lock must be taken externally.
+     * Replaces the master branch of the store with 'newMaster' if the master is still 'expected',
+     * the branch that 'newMaster' was forked from or last merged with. Returns false and leaves
+     * 'newMaster' untouched if another commit replaced the master first, in which case the caller
+     * must merge with the new master and try again.
      */
-    void setMaster_inlock(std::unique_ptr<StringStore> newMaster);
+    bool trySwapMaster(const std::shared_ptr<StringStore>& expected,
+                       std::unique_ptr<StringStore>& newMaster);
 
-    std::shared_ptr<StringStore> getMaster() const;
-    std::shared_ptr<StringStore> getMaster_inlock() const;
     /**
-     * Get the lock around the master branch.
+     * Returns a snapshot of the master branch. The snapshot is immutable, so readers never block
+     * commits and vice versa.
      */
-    stdx::mutex& getMasterLock() {
-        return _masterLock;
-    }
+    std::shared_ptr<StringStore> getMaster() const;
 
 private:
     std::shared_ptr<void> _catalogInfo;
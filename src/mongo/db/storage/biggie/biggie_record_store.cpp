@@ -227,6 +227,10 @@ std::unique_ptr<SeekableRecordCursor> RecordStore::getCursor(OperationContext* o
     return std::make_unique<ReverseCursor>(opCtx, *this);
 }
 
+std::unique_ptr<RecordCursor> RecordStore::getRandomCursor(OperationContext* opCtx) const {
+    return std::make_unique<RandomCursor>(opCtx, *this);
+}
+
 Status RecordStore::truncate(OperationContext* opCtx) {
     StringStore* str = getRecoveryUnitBranch_forking(opCtx);
     StringStore::const_iterator end = str->upper_bound(_postfix);
@@ -433,5 +437,48 @@ void RecordStore::ReverseCursor::reattachToOperationContext(OperationContext* op
 bool RecordStore::ReverseCursor::inPrefix(const std::string& key_string) {
     return (key_string > _prefix) && (key_string < _postfix);
 }
+
+RecordStore::RandomCursor::RandomCursor(OperationContext* opCtx, const RecordStore& rs)
+    : opCtx(opCtx),
+      _random(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {
+    _ident = rs._ident;
+    _prefix = rs._prefix;
+    _postfix = rs._postfix;
+}
+
+boost::optional<Record> RecordStore::RandomCursor::next() {
+    StringStore* workingCopy = getRecoveryUnitBranch_forking(opCtx);
+    auto first = workingCopy->lower_bound(_prefix);
+    auto end = workingCopy->upper_bound(_postfix);
+    if (first == end) {
+        return boost::none;
+    }
+
+    // Records which follow a gap left by deletes are returned more often than others, which is
+    // acceptable for a random cursor.
+    const int64_t firstId = extractRecordId(first->first);
+    const int64_t lastId = extractRecordId(StringStore::const_reverse_iterator(end)->first);
+    auto it = workingCopy->lower_bound(
+        createKey(_ident, firstId + _random.nextInt64(lastId - firstId + 1)));
+    invariant(it != end);
+    return Record{RecordId(extractRecordId(it->first)),
+                  RecordData(it->second.c_str(), it->second.length())};
+}
+
+void RecordStore::RandomCursor::save() {}
+
+bool RecordStore::RandomCursor::restore() {
+    return true;
+}
+
+void RecordStore::RandomCursor::detachFromOperationContext() {
+    invariant(opCtx != nullptr);
+    opCtx = nullptr;
+}
+
+void RecordStore::RandomCursor::reattachToOperationContext(OperationContext* opCtx) {
+    invariant(opCtx != nullptr);
+    this->opCtx = opCtx;
+}
 }  // namespace biggie
 }  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -107,6 +108,8 @@ public:
     std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* opCtx,
                                                     bool forward) const final;
 
+    std::unique_ptr<RecordCursor> getRandomCursor(OperationContext* opCtx) const final;
+
     virtual Status truncate(OperationContext* opCtx);
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
@@ -184,6 +187,25 @@ private:
     private:
         bool inPrefix(const std::string& key_string);
     };
+    /*
+     * Returns the first record at or after a RecordId drawn uniformly between the first and last
+     * RecordIds in the store.
+     */
+    class RandomCursor final : public RecordCursor {
+        OperationContext* opCtx;
+        StringData _ident;
+        std::string _prefix;
+        std::string _postfix;
+        PseudoRandom _random;
+
+    public:
+        RandomCursor(OperationContext* opCtx, const RecordStore& rs);
+        boost::optional<Record> next() final;
+        void save() final;
+        bool restore() final;
+        void detachFromOperationContext() final;
+        void reattachToOperationContext(OperationContext* opCtx) final;
+    };
 };
 }  // namespace biggie
 }  // namespace mongo
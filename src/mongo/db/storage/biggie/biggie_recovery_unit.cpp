@@ -47,16 +47,21 @@ void RecoveryUnit::beginUnitOfWork(OperationContext* opCtx) {}
 
 void RecoveryUnit::commitUnitOfWork() {
     if (_dirty && _workingCopy) {
+        // Commits are optimistic: the working copy is merged with the current master without
+        // holding any lock, and is only installed if no other commit got there in the meantime.
         while (true) {
             std::shared_ptr<StringStore> master = _KVEngine->getMaster();
-            try {
-                _workingCopy->merge3(*_mergeBase, *master);
-            } catch (const merge_conflict_exception&) {
-                throw WriteConflictException();
+            if (master != _mergeBase) {
+                try {
+                    _workingCopy->merge3(*_mergeBase, *master);
+                } catch (const merge_conflict_exception&) {
+                    throw WriteConflictException();
+                }
+                // The working copy now contains everything in 'master', so if we lose the race
+                // to install it, only the changes committed after 'master' need to be merged.
+                _mergeBase = std::move(master);
             }
-            stdx::lock_guard<stdx::mutex> lkOnMaster(_KVEngine->getMasterLock());
-            if (_KVEngine->getMaster_inlock() == master) {
-                _KVEngine->setMaster_inlock(std::move(_workingCopy));
+            if (_KVEngine->trySwapMaster(_mergeBase, _workingCopy)) {
                 _mergeBase.reset();
                 break;
             }
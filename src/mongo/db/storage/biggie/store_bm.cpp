@@ -0,0 +1,180 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/db/storage/biggie/biggie_recovery_unit.h"
+#include "mongo/db/storage/biggie/store.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace biggie {
+namespace {
+
+const int kMaxThreads = 16;
+
+std::string makeKey(StringData prefix, int i) {
+    // Pad the number so that neighbouring keys share a prefix, as record ids and index keys do.
+    return str::stream() << prefix << std::string(10 - std::to_string(i).size(), '0') << i;
+}
+
+StringStore makeStore(int numKeys) {
+    StringStore store;
+    for (int i = 0; i < numKeys; i++) {
+        store.insert(StringStore::value_type{makeKey("key", i), "value"});
+    }
+    return store;
+}
+
+void BM_StoreInsert(benchmark::State& state) {
+    const int numKeys = state.range(0);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(makeStore(numKeys));
+    }
+    state.SetItemsProcessed(state.iterations() * numKeys);
+}
+
+void BM_StoreFind(benchmark::State& state) {
+    const int numKeys = state.range(0);
+    const StringStore store = makeStore(numKeys);
+    std::vector<std::string> keys;
+    for (int i = 0; i < numKeys; i++) {
+        keys.push_back(makeKey("key", i));
+    }
+
+    size_t i = 0;
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(store.find(keys[i++ % keys.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_StoreIterate(benchmark::State& state) {
+    const StringStore store = makeStore(state.range(0));
+    for (auto keepRunning : state) {
+        for (auto&& entry : store) {
+            benchmark::DoNotOptimize(entry);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * Measures a snapshot copy followed by a single write, which only copies the nodes on the path to
+ * the changed key.
+ */
+void BM_StoreCopyOnWrite(benchmark::State& state) {
+    const StringStore master = makeStore(state.range(0));
+    int i = 0;
+    for (auto keepRunning : state) {
+        StringStore workingCopy(master);
+        workingCopy.update(StringStore::value_type{makeKey("key", i++ % state.range(0)), "new"});
+        benchmark::DoNotOptimize(workingCopy);
+    }
+}
+
+/**
+ * Measures merging a branch with a master that has committed a write to an unrelated key since
+ * the branch was forked.
+ */
+void BM_StoreMerge3(benchmark::State& state) {
+    const int numKeys = state.range(0);
+    const StringStore base = makeStore(numKeys);
+    StringStore other(base);
+    other.update(StringStore::value_type{makeKey("key", 0), "other"});
+
+    int i = 0;
+    for (auto keepRunning : state) {
+        state.PauseTiming();
+        StringStore current(base);
+        current.update(StringStore::value_type{makeKey("key", 1 + i++ % (numKeys - 1)), "new"});
+        state.ResumeTiming();
+
+        current.merge3(base, other);
+    }
+}
+
+/**
+ * Each thread commits single inserts into its own part of the key space through a RecoveryUnit,
+ * so that commits race with each other but only conflict when they touch the same subtree.
+ */
+void BM_ConcurrentCommits(benchmark::State& state) {
+    static std::unique_ptr<KVEngine> engine;
+    if (state.thread_index == 0) {
+        engine = stdx::make_unique<KVEngine>();
+
+        // Create each thread's subtree up front, as concurrent inserts of new branches conflict.
+        RecoveryUnit ru(engine.get());
+        ru.forkIfNeeded();
+        for (int thread = 0; thread < kMaxThreads; thread++) {
+            const std::string prefix(1, static_cast<char>('a' + thread));
+            ru.getWorkingCopy()->insert(StringStore::value_type{makeKey(prefix, 0), "value"});
+        }
+        ru.makeDirty();
+        ru.commitUnitOfWork();
+    }
+
+    const std::string prefix(1, static_cast<char>('a' + state.thread_index));
+    int i = 1;
+    int64_t conflicts = 0;
+    for (auto keepRunning : state) {
+        RecoveryUnit ru(engine.get());
+        ru.forkIfNeeded();
+        ru.getWorkingCopy()->insert(StringStore::value_type{makeKey(prefix, i++), "value"});
+        ru.makeDirty();
+        try {
+            ru.commitUnitOfWork();
+        } catch (const WriteConflictException&) {
+            ru.abortUnitOfWork();
+            conflicts++;
+        }
+    }
+    state.counters["conflicts"] = conflicts;
+
+    if (state.thread_index == 0) {
+        engine.reset();
+    }
+}
+
+BENCHMARK(BM_StoreInsert)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_StoreFind)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_StoreIterate)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_StoreCopyOnWrite)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_StoreMerge3)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_ConcurrentCommits)->ThreadRange(1, kMaxThreads);
+
+}  // namespace
+}  // namespace biggie
+}  // namespace mongo
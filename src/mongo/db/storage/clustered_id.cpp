@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/clustered_id.h"
+
+#include <cmath>
+#include <limits>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/decimal128.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace clusteredid {
+
+namespace {
+
+// 2^63 as a double. Every double at least this large is out of the range of long long.
+const double kTwoToThe63 = 9223372036854775808.0;
+
+long long roundDouble(double value, bool roundUp) {
+    invariant(!std::isnan(value));
+    const double rounded = roundUp ? std::ceil(value) : std::floor(value);
+    if (rounded >= kTwoToThe63) {
+        return std::numeric_limits<long long>::max();
+    }
+    if (rounded < -kTwoToThe63) {
+        return std::numeric_limits<long long>::min();
+    }
+    return static_cast<long long>(rounded);
+}
+
+long long roundDecimal(const Decimal128& value, bool roundUp) {
+    invariant(!value.isNaN());
+    std::uint32_t signalingFlags = Decimal128::SignalingFlag::kNoFlag;
+    const long long rounded = value.toLong(
+        &signalingFlags,
+        roundUp ? Decimal128::kRoundTowardPositive : Decimal128::kRoundTowardNegative);
+    if (Decimal128::hasFlag(signalingFlags, Decimal128::SignalingFlag::kInvalid)) {
+        return value.isNegative() ? std::numeric_limits<long long>::min()
+                                  : std::numeric_limits<long long>::max();
+    }
+    return rounded;
+}
+
+long long roundNumber(const BSONElement& elem, bool roundUp) {
+    switch (elem.type()) {
+        case NumberInt:
+        case NumberLong:
+            return elem.safeNumberLong();
+        case NumberDouble:
+            return roundDouble(elem.numberDouble(), roundUp);
+        case NumberDecimal:
+            return roundDecimal(elem.numberDecimal(), roundUp);
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+StatusWith<RecordId> keyForId(const BSONElement& id) {
+    if (!id.isNumber()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "_id in a collection clustered on _id must be a number, not "
+                              << typeName(id.type())};
+    }
+
+    bool isIntegral = true;
+    if (id.type() == NumberDouble) {
+        isIntegral = std::trunc(id.numberDouble()) == id.numberDouble();
+    } else if (id.type() == NumberDecimal) {
+        std::uint32_t signalingFlags = Decimal128::SignalingFlag::kNoFlag;
+        id.numberDecimal().toLongExact(&signalingFlags);
+        isIntegral = !Decimal128::hasFlag(signalingFlags, Decimal128::SignalingFlag::kInexact) &&
+            !Decimal128::hasFlag(signalingFlags, Decimal128::SignalingFlag::kInvalid);
+    }
+
+    const RecordId key(isIntegral ? floorOf(id) : 0);
+    if (!isIntegral || !key.isNormal()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "_id in a collection clustered on _id must be an integer between "
+                              << 1 << " and " << RecordId::kMinReservedRepr - 1 << ", not "
+                              << id.toString(false)};
+    }
+    return key;
+}
+
+StatusWith<RecordId> extractKey(const char* data, int len) {
+    const BSONObj obj(data);
+    invariant(obj.objsize() == len);
+
+    const BSONElement id = obj["_id"];
+    if (id.eoo()) {
+        return {ErrorCodes::BadValue, "Documents in a collection clustered on _id need an _id"};
+    }
+    return keyForId(id);
+}
+
+long long floorOf(const BSONElement& elem) {
+    return roundNumber(elem, false);
+}
+
+long long ceilOf(const BSONElement& elem) {
+    return roundNumber(elem, true);
+}
+
+}  // namespace clusteredid
+}  // namespace mongo
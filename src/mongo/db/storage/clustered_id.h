@@ -0,0 +1,66 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+
+namespace mongo {
+class BSONElement;
+class RecordId;
+
+/**
+ * Helpers for collections created with the 'clusteredOnId' option, whose records are keyed by their
+ * _id rather than by a RecordId chosen by the record store. Since a RecordId is a 64-bit integer,
+ * only documents whose _id is a positive integer in the range of normal RecordIds can be stored in
+ * such a collection, and the RecordId of a document is its _id.
+ */
+namespace clusteredid {
+
+/**
+ * Returns the RecordId of the document with the given '_id', or an error if '_id' is not a number
+ * with an integral value in the range of normal RecordIds. Numerically equal _id values of
+ * different types have the same RecordId.
+ */
+StatusWith<RecordId> keyForId(const BSONElement& id);
+
+/**
+ * 'data' and 'len' must be the arguments from RecordStore::insert() on a collection clustered on
+ * _id.
+ */
+StatusWith<RecordId> extractKey(const char* data, int len);
+
+/**
+ * Returns the greatest integer not greater than, or the least integer not less than, the number
+ * 'elem', saturated to the range of long long. 'elem' must be a number other than NaN.
+ */
+long long floorOf(const BSONElement& elem);
+long long ceilOf(const BSONElement& elem);
+
+}  // namespace clusteredid
+}  // namespace mongo
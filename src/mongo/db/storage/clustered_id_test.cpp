@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/clustered_id.h"
+
+#include <limits>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/decimal128.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(ClusteredIdTest, KeyForIntegralIds) {
+    ASSERT_EQ(RecordId(5), clusteredid::keyForId(BSON("_id" << 5).firstElement()).getValue());
+    ASSERT_EQ(RecordId(5), clusteredid::keyForId(BSON("_id" << 5LL).firstElement()).getValue());
+    ASSERT_EQ(RecordId(5), clusteredid::keyForId(BSON("_id" << 5.0).firstElement()).getValue());
+    ASSERT_EQ(RecordId(5),
+              clusteredid::keyForId(BSON("_id" << Decimal128("5.00")).firstElement()).getValue());
+
+    const long long maxId = RecordId::kMinReservedRepr - 1;
+    ASSERT_EQ(RecordId(maxId),
+              clusteredid::keyForId(BSON("_id" << maxId).firstElement()).getValue());
+}
+
+TEST(ClusteredIdTest, KeyForInvalidIds) {
+    ASSERT_NOT_OK(clusteredid::keyForId(BSON("_id" << 0).firstElement()).getStatus());
+    ASSERT_NOT_OK(clusteredid::keyForId(BSON("_id" << -1).firstElement()).getStatus());
+    ASSERT_NOT_OK(clusteredid::keyForId(BSON("_id" << 1.5).firstElement()).getStatus());
+    ASSERT_NOT_OK(
+        clusteredid::keyForId(BSON("_id" << Decimal128("1.5")).firstElement()).getStatus());
+    ASSERT_NOT_OK(clusteredid::keyForId(BSON("_id" << std::numeric_limits<double>::quiet_NaN())
+                                            .firstElement())
+                      .getStatus());
+    ASSERT_NOT_OK(clusteredid::keyForId(BSON("_id" << std::numeric_limits<double>::infinity())
+                                            .firstElement())
+                      .getStatus());
+    const long long firstReservedId = RecordId::kMinReservedRepr;
+    ASSERT_NOT_OK(clusteredid::keyForId(BSON("_id" << firstReservedId).firstElement()).getStatus());
+    ASSERT_NOT_OK(clusteredid::keyForId(BSON("_id"
+                                             << "1")
+                                            .firstElement())
+                      .getStatus());
+    ASSERT_NOT_OK(clusteredid::keyForId(BSON("_id" << OID::gen()).firstElement()).getStatus());
+}
+
+TEST(ClusteredIdTest, ExtractKey) {
+    BSONObj doc = BSON("a" << 1 << "_id" << 7);
+    ASSERT_EQ(RecordId(7), clusteredid::extractKey(doc.objdata(), doc.objsize()).getValue());
+
+    doc = BSON("a" << 1);
+    ASSERT_NOT_OK(clusteredid::extractKey(doc.objdata(), doc.objsize()).getStatus());
+}
+
+TEST(ClusteredIdTest, Rounding) {
+    ASSERT_EQ(3, clusteredid::floorOf(BSON("" << 3.5).firstElement()));
+    ASSERT_EQ(4, clusteredid::ceilOf(BSON("" << 3.5).firstElement()));
+    ASSERT_EQ(-4, clusteredid::floorOf(BSON("" << -3.5).firstElement()));
+    ASSERT_EQ(3, clusteredid::ceilOf(BSON("" << 3).firstElement()));
+    ASSERT_EQ(2, clusteredid::floorOf(BSON("" << Decimal128("2.9")).firstElement()));
+    ASSERT_EQ(3, clusteredid::ceilOf(BSON("" << Decimal128("2.1")).firstElement()));
+
+    ASSERT_EQ(std::numeric_limits<long long>::max(),
+              clusteredid::floorOf(BSON("" << 1e300).firstElement()));
+    ASSERT_EQ(
+        std::numeric_limits<long long>::min(),
+        clusteredid::ceilOf(BSON("" << -std::numeric_limits<double>::infinity()).firstElement()));
+    ASSERT_EQ(std::numeric_limits<long long>::max(),
+              clusteredid::floorOf(BSON("" << Decimal128("1E+30")).firstElement()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -261,6 +262,40 @@ private:
     const bool _isCapped;
 };
 
+/**
+ * Returns the first record at or after a RecordId drawn uniformly between the first and last
+ * RecordIds in the store. Records which follow a gap left by deletes are returned more often than
+ * others, which is acceptable for a random cursor.
+ */
+class EphemeralForTestRecordStore::RandomCursor final : public RecordCursor {
+public:
+    RandomCursor(OperationContext* opCtx, const EphemeralForTestRecordStore& rs)
+        : _records(rs._data->records),
+          _random(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {}
+
+    boost::optional<Record> next() final {
+        if (_records.empty())
+            return {};
+
+        const int64_t first = _records.begin()->first.repr();
+        const int64_t last = _records.rbegin()->first.repr();
+        auto it = _records.lower_bound(RecordId(first + _random.nextInt64(last - first + 1)));
+        invariant(it != _records.end());
+        return {{it->first, it->second.toRecordData()}};
+    }
+
+    void save() final {}
+    bool restore() final {
+        return true;
+    }
+    void detachFromOperationContext() final {}
+    void reattachToOperationContext(OperationContext* opCtx) final {}
+
+private:
+    const EphemeralForTestRecordStore::Records& _records;
+    PseudoRandom _random;
+};
+
 
 //
 // RecordStore
@@ -507,27 +542,30 @@ StatusWith<RecordData> EphemeralForTestRecordStore::updateWithDamages(
     stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
 
     EphemeralForTestRecord* oldRecord = recordFor(loc);
-    const int len = oldRecord->size;
-
-    EphemeralForTestRecord newRecord(len);
-    memcpy(newRecord.data.get(), oldRecord->data.get(), len);
-
-    opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *oldRecord));
-    *oldRecord = newRecord;
-
-    cappedDeleteAsNeeded_inlock(opCtx);
 
-    char* root = newRecord.data.get();
+    // Damages which grow or shrink the record are applied in order to a copy of it.
+    std::string data(oldRecord->data.get(), oldRecord->size);
     mutablebson::DamageVector::const_iterator where = damages.begin();
     const mutablebson::DamageVector::const_iterator end = damages.end();
     for (; where != end; ++where) {
-        const char* sourcePtr = damageSource + where->sourceOffset;
-        char* targetPtr = root + where->targetOffset;
-        std::memcpy(targetPtr, sourcePtr, where->size);
+        data.replace(where->targetOffset,
+                     where->getTargetSize(),
+                     damageSource + where->sourceOffset,
+                     where->size);
     }
 
+    const int len = data.size();
+    invariant(!_isCapped || len == oldRecord->size);
+
+    EphemeralForTestRecord newRecord(len);
+    memcpy(newRecord.data.get(), data.data(), len);
+
+    opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *oldRecord));
+    _data->dataSize += len - oldRecord->size;
     *oldRecord = newRecord;
 
+    cappedDeleteAsNeeded_inlock(opCtx);
+
     return newRecord.toRecordData();
 }
 
@@ -538,6 +576,11 @@ std::unique_ptr<SeekableRecordCursor> EphemeralForTestRecordStore::getCursor(
     return stdx::make_unique<ReverseCursor>(opCtx, *this);
 }
 
+std::unique_ptr<RecordCursor> EphemeralForTestRecordStore::getRandomCursor(
+    OperationContext* opCtx) const {
+    return stdx::make_unique<RandomCursor>(opCtx, *this);
+}
+
 Status EphemeralForTestRecordStore::truncate(OperationContext* opCtx) {
     // Unlike other changes, TruncateChange mutates _data on construction to perform the
     // truncate
@@ -93,6 +93,8 @@ public:
     std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* opCtx,
                                                     bool forward) const final;
 
+    std::unique_ptr<RecordCursor> getRandomCursor(OperationContext* opCtx) const final;
+
     virtual Status truncate(OperationContext* opCtx);
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
@@ -170,6 +172,7 @@ private:
 
     class Cursor;
     class ReverseCursor;
+    class RandomCursor;
 
     StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len) const;
 
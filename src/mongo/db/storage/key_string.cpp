@@ -230,10 +230,24 @@ const uint8_t kGreater = 254;
 
 // some utility functions
 namespace {
+/**
+ * Copies 'bytes' bytes from 'src' to 'dst', inverting every bit. 'dst' may be equal to 'src', but
+ * the ranges may otherwise not overlap.
+ */
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+
+    // Flip a word at a time, which the compiler can also turn into vector instructions. Going
+    // through memcpy avoids unaligned loads and stores.
+    for (; end - input >= static_cast<ptrdiff_t>(sizeof(uint64_t));
+         input += sizeof(uint64_t), output += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, input, sizeof(word));
+        word = ~word;
+        memcpy(output, &word, sizeof(word));
+    }
     while (input != end) {
         *output++ = ~(*input++);
     }
@@ -285,10 +299,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     uassert(50817, "Failed to find '0xFF' in inverted string.", end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -315,10 +327,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
-
+    memcpy_flipBits(&out[0], out.data(), out.size());
     return out;
 }
 }  // namespace
@@ -2061,6 +2070,44 @@ BSONObj KeyString::toBsonSafe(const char* buffer,
     return builder.obj();
 }
 
+BSONObj KeyString::toBsonWithFieldNames(const char* buffer,
+                                        size_t len,
+                                        Ordering ord,
+                                        const TypeBits& typeBits,
+                                        const std::vector<std::string>& fieldNames) {
+    BSONObjBuilder builder;
+    // Fields left out are decoded here, since decoding them consumes their type bits.
+    boost::optional<BSONObjBuilder> skipped;
+    BufReader reader(buffer, len);
+    TypeBits::Reader typeBitsReader(typeBits);
+    for (size_t i = 0; i < fieldNames.size() && reader.remaining(); i++) {
+        const bool invert = (ord.get(i) == -1);
+        uint8_t ctype = readType<uint8_t>(&reader, invert);
+        if (ctype == kLess || ctype == kGreater) {
+            ctype = readType<uint8_t>(&reader, invert);
+        }
+
+        if (ctype == kEnd)
+            break;
+
+        if (fieldNames[i].empty()) {
+            if (!skipped) {
+                skipped.emplace();
+            }
+            toBsonValue(
+                ctype, &reader, &typeBitsReader, invert, typeBits.version, &(*skipped << ""));
+        } else {
+            toBsonValue(ctype,
+                        &reader,
+                        &typeBitsReader,
+                        invert,
+                        typeBits.version,
+                        &(builder << fieldNames[i]));
+        }
+    }
+    return builder.obj();
+}
+
 BSONObj KeyString::toBson(const char* buffer,
                           size_t len,
                           Ordering ord,
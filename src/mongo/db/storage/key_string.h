@@ -31,6 +31,8 @@
 #pragma once
 
 #include <limits>
+#include <string>
+#include <vector>
 
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/bsonmisc.h"
@@ -342,6 +344,17 @@ public:
                           const TypeBits& types) noexcept;
     static BSONObj toBsonSafe(const char* buffer, size_t len, Ordering ord, const TypeBits& types);
 
+    /**
+     * Like toBson(), but names the i-th field of the key 'fieldNames[i]', leaves out the fields
+     * whose name is empty, and stops decoding after the last field in 'fieldNames'. This builds
+     * the simple inclusion projection of a key without an intermediate BSONObj.
+     */
+    static BSONObj toBsonWithFieldNames(const char* buffer,
+                                        size_t len,
+                                        Ordering ord,
+                                        const TypeBits& types,
+                                        const std::vector<std::string>& fieldNames);
+
     /**
      * Decodes a RecordId from the end of a buffer.
      */
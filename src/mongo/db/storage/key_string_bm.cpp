@@ -36,6 +36,7 @@
 
 #include "mongo/db/storage/key_string.h"
 #include "mongo/platform/decimal128.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/log.h"
 
@@ -46,6 +47,7 @@ std::mt19937_64 seedGen(1234);
 const int kSampleSize = 500;
 const int kStrLenMultiplier = 100;
 const int kArrLenMultiplier = 40;
+const int kLongStrLen = 4096;
 
 const Ordering ALL_ASCENDING = Ordering::make(BSONObj());
 
@@ -65,6 +67,8 @@ enum BsonValueType {
     STRING,
     ARRAY,
     DECIMAL,
+    COMPOUND,
+    LONG_STRING,
 };
 
 BSONObj generateBson(BsonValueType bsonValueType) {
@@ -92,6 +96,20 @@ BSONObj generateBson(BsonValueType bsonValueType) {
                                          Decimal128::kRoundTo34Digits,
                                          Decimal128::kRoundTiesToAway)
                                   .quantize(Decimal128("0.01", Decimal128::kRoundTiesToAway)));
+        case COMPOUND:
+            return BSON("" << static_cast<int>(expReal(gen)) << ""
+                           << std::string(expDist(gen) * kStrLenMultiplier, 'x')
+                           << ""
+                           << expReal(gen));
+        case LONG_STRING: {
+            // Long strings with the occasional NUL byte, which KeyString has to escape.
+            std::string str(kLongStrLen, 'x');
+            std::uniform_int_distribution<size_t> position(0, kLongStrLen - 1);
+            for (int i = 0; i < 4; i++) {
+                str[position(gen)] = '\0';
+            }
+            return BSON("" << str);
+        }
     }
     MONGO_UNREACHABLE;
 }
@@ -114,7 +132,7 @@ static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType
 
         result.typebits[i] = SharedBuffer::allocate(ks.getTypeBits().getSize());
         memcpy(result.typebits[i].get(), ks.getTypeBits().getBuffer(), ks.getTypeBits().getSize());
-        result.typebitsLens[i] = ks.getSize();
+        result.typebitsLens[i] = ks.getTypeBits().getSize();
     }
     return result;
 }
@@ -152,6 +170,26 @@ void BM_KeyStringToBSON(benchmark::State& state,
     state.SetItemsProcessed(state.iterations() * kSampleSize);
 }
 
+void BM_KeyStringCompare(benchmark::State& state,
+                         const KeyString::Version version,
+                         BsonValueType bsonType) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+    std::vector<std::unique_ptr<KeyString>> keyStrings;
+    for (size_t i = 0; i < kSampleSize; i++) {
+        keyStrings.push_back(stdx::make_unique<KeyString>(version));
+        keyStrings.back()->resetFromBuffer(bsonsAndKeyStrings.keystrings[i].get(),
+                                           bsonsAndKeyStrings.keystringLens[i]);
+    }
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (size_t i = 1; i < kSampleSize; i++) {
+            benchmark::DoNotOptimize(keyStrings[i - 1]->compare(*keyStrings[i]));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bsonsAndKeyStrings.keystringSize);
+    state.SetItemsProcessed(state.iterations() * (kSampleSize - 1));
+}
+
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Int, KeyString::Version::V1, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Double, KeyString::Version::V0, DOUBLE);
@@ -161,6 +199,8 @@ BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Compound, KeyString::Version::V1, COMPOUND);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_LongString, KeyString::Version::V1, LONG_STRING);
 
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Int, KeyString::Version::V1, INT);
@@ -171,5 +211,12 @@ BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Compound, KeyString::Version::V1, COMPOUND);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_LongString, KeyString::Version::V1, LONG_STRING);
+
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_Int, KeyString::Version::V1, INT);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_Compound, KeyString::Version::V1, COMPOUND);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_LongString, KeyString::Version::V1, LONG_STRING);
 }  // namespace
 }  // namespace mongo
@@ -314,6 +314,20 @@ TEST_F(KeyStringTest, AllTypesSimple) {
     ROUNDTRIP(version, BSON("" << 1235123123123LL));
 }
 
+TEST_F(KeyStringTest, StringsOfAllLengthsWithNuls) {
+    // Descending strings are inverted a word at a time, so cover lengths around the word size,
+    // with NUL bytes both inside and outside of the whole words.
+    for (size_t len = 0; len <= 40; len++) {
+        std::string str(len, 'x');
+        ROUNDTRIP(version, BSON("" << str));
+        for (size_t nulPos = 0; nulPos < len; nulPos += 3) {
+            str[nulPos] = '\0';
+            ROUNDTRIP(version, BSON("" << str));
+            ROUNDTRIP(version, BSON("" << BSONSymbol(str)));
+        }
+    }
+}
+
 TEST_F(KeyStringTest, Array1) {
     BSONObj emptyArray = BSON("" << BSONArray());
 
@@ -366,6 +380,29 @@ TEST_F(KeyStringTest, Compound1) {
     ROUNDTRIP(version, BSON("" << BSON("" << 5) << "" << 1));
 }
 
+TEST_F(KeyStringTest, ToBsonWithFieldNames) {
+    BSONObj key = BSON("" << 5.0 << ""
+                          << "x"
+                          << ""
+                          << 3LL
+                          << ""
+                          << 7);
+    KeyString ks(version, key, ONE_DESCENDING);
+
+    // The skipped leading double must still consume its type bits.
+    BSONObj projected = KeyString::toBsonWithFieldNames(
+        ks.getBuffer(), ks.getSize(), ONE_DESCENDING, ks.getTypeBits(), {"", "b", "c"});
+    ASSERT(projected.binaryEqual(BSON("b"
+                                      << "x"
+                                      << "c"
+                                      << 3LL)))
+        << projected;
+
+    projected = KeyString::toBsonWithFieldNames(
+        ks.getBuffer(), ks.getSize(), ONE_DESCENDING, ks.getTypeBits(), {"a", "", "", "d"});
+    ASSERT(projected.binaryEqual(BSON("a" << 5.0 << "d" << 7))) << projected;
+}
+
 TEST_F(KeyStringTest, Undef1) {
     ROUNDTRIP(version, BSON("" << BSONUndefined));
 }
@@ -207,6 +207,11 @@ Status KVDatabaseCatalogEntryBase::createCollection(OperationContext* opCtx,
         return Status(ErrorCodes::NamespaceExists, "collection already exists");
     }
 
+    if (options.clusteredOnId && !_engine->getEngine()->supportsClusteredIdCollections()) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "the storage engine doesn't support collections clustered on _id");
+    }
+
     KVPrefix prefix = KVPrefix::getNextPrefix(NamespaceString(ns));
 
     // need to create it
@@ -244,8 +249,6 @@ Status KVDatabaseCatalogEntryBase::createCollection(OperationContext* opCtx,
 void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
                                                 const std::string& ns,
                                                 bool forRepair) {
-    invariant(!_collections.count(ns));
-
     const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
 
     std::unique_ptr<RecordStore> rs;
@@ -259,6 +262,15 @@ void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
         invariant(rs);
     }
 
+    initCollection(ns, std::move(rs));
+}
+
+void KVDatabaseCatalogEntryBase::initCollection(const std::string& ns,
+                                                std::unique_ptr<RecordStore> rs) {
+    invariant(!_collections.count(ns));
+
+    const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
+
     // No change registration since this is only for committed collections
     _collections[ns] = new KVCollectionCatalogEntry(
         _engine->getEngine(), _engine->getCatalog(), ns, ident, std::move(rs));
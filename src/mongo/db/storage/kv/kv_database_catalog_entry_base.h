@@ -82,6 +82,12 @@ public:
 
     void initCollection(OperationContext* opCtx, const std::string& ns, bool forRepair);
 
+    /**
+     * Adds the entry for the committed collection 'ns' around the already opened 'rs', which is
+     * null when the collection has yet to be repaired.
+     */
+    void initCollection(const std::string& ns, std::unique_ptr<RecordStore> rs);
+
     void initCollectionBeforeRepair(OperationContext* opCtx, const std::string& ns);
     void reinitCollectionAfterRepair(OperationContext* opCtx, const std::string& ns);
 
@@ -254,6 +254,14 @@ public:
         return true;
     }
 
+    /**
+     * Returns true if record stores created with the 'clusteredOnId' collection option key their
+     * records by _id. See RecordStore::isClusteredOnId().
+     */
+    virtual bool supportsClusteredIdCollections() const {
+        return false;
+    }
+
     /**
      * Returns true if storage engine supports --directoryperdb.
      * See:
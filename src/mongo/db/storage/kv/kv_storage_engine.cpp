@@ -37,12 +37,14 @@
 #include "mongo/db/catalog/catalog_control.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/unclean_shutdown.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
@@ -55,6 +57,16 @@ using std::vector;
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
 const auto kCatalogLogLevel = logger::LogSeverity::Debug(2);
+
+// The number of threads which open the record stores of the catalog's collections at startup. With
+// a single thread, the collections are opened one after another on the thread loading the catalog.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(catalogLoadThreadCount, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 256) {
+            return Status(ErrorCodes::BadValue, "catalogLoadThreadCount must be between 1 and 256");
+        }
+        return Status::OK();
+    });
 }
 
 class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
@@ -196,10 +208,9 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
         }
     }
 
-    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    std::vector<std::string> collectionsToInit;
     for (const auto& coll : collectionsKnownToCatalog) {
         NamespaceString nss(coll);
-        std::string dbName = nss.db().toString();
 
         if (loadingFromUncleanShutdownOrRepair) {
             // If we are loading the catalog after an unclean shutdown or during repair, it's
@@ -232,14 +243,25 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
             }
         }
 
+        collectionsToInit.push_back(coll);
+    }
+
+    std::vector<OpenedCollection> openedCollections = _openCollections(opCtx, collectionsToInit);
+
+    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    for (size_t i = 0; i < collectionsToInit.size(); ++i) {
+        const auto& coll = collectionsToInit[i];
+        NamespaceString nss(coll);
+        std::string dbName = nss.db().toString();
+
         // No rollback since this is only for committed dbs.
         KVDatabaseCatalogEntryBase*& db = _dbs[dbName];
         if (!db) {
             db = _databaseCatalogEntryFactory(dbName, this).release();
         }
 
-        db->initCollection(opCtx, coll, _options.forRepair);
-        auto maxPrefixForCollection = _catalog->getMetaData(opCtx, coll).getMaxPrefix();
+        db->initCollection(coll, std::move(openedCollections[i].rs));
+        auto maxPrefixForCollection = openedCollections[i].md.getMaxPrefix();
         maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
 
         if (nss.isOrphanCollection()) {
@@ -255,6 +277,70 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
     startingAfterUncleanShutdown(getGlobalServiceContext()) = false;
 }
 
+std::vector<KVStorageEngine::OpenedCollection> KVStorageEngine::_openCollections(
+    OperationContext* opCtx, const std::vector<std::string>& collections) {
+    std::vector<OpenedCollection> opened(collections.size());
+
+    auto openCollection = [this](OperationContext* opCtx, const std::string& ns) {
+        OpenedCollection result;
+        result.md = _catalog->getMetaData(opCtx, ns);
+        if (!_options.forRepair) {
+            // Repair must not open a record store before it has been repaired, so it is left
+            // null there. Using it by mistake will then blow up.
+            result.rs = _engine->getGroupedRecordStore(
+                opCtx, ns, _catalog->getCollectionIdent(ns), result.md.options, result.md.prefix);
+            invariant(result.rs);
+        }
+        return result;
+    };
+
+    // Opening a record store reads the storage engine's metadata for its table and positions a
+    // cursor on it, so with many collections this dominates the time to load the catalog. Engines
+    // with document level locking allow these reads from concurrent sessions.
+    const size_t numThreads = std::min(static_cast<size_t>(catalogLoadThreadCount),
+                                       collections.size());
+    if (numThreads <= 1 || _options.forRepair || !_supportsDocLocking) {
+        for (size_t i = 0; i < collections.size(); ++i) {
+            opened[i] = openCollection(opCtx, collections[i]);
+        }
+        return opened;
+    }
+
+    ThreadPool::Options options;
+    options.poolName = "catalogLoadPool";
+    options.threadNamePrefix = "catalogLoad-";
+    options.maxThreads = options.minThreads = numThreads;
+    ThreadPool pool(options);
+    pool.startup();
+
+    std::vector<std::exception_ptr> errors(collections.size());
+    for (size_t i = 0; i < collections.size(); ++i) {
+        // The oplog registers itself with the engine's oplog visibility machinery as it is opened,
+        // so it is kept on this thread.
+        if (NamespaceString::oplog(collections[i])) {
+            opened[i] = openCollection(opCtx, collections[i]);
+            continue;
+        }
+        fassert(51014, pool.schedule([&, i] {
+            try {
+                OperationContextNoop workerOpCtx(_engine->newRecoveryUnit());
+                opened[i] = openCollection(&workerOpCtx, collections[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }));
+    }
+    pool.shutdown();
+    pool.join();
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return opened;
+}
+
 void KVStorageEngine::closeCatalog(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isLocked());
     if (shouldLog(::mongo::logger::LogComponent::kStorageRecovery, kCatalogLogLevel)) {
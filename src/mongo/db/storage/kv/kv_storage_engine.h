@@ -30,6 +30,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
@@ -217,6 +218,23 @@ private:
 
     void _dumpCatalog(OperationContext* opCtx);
 
+    /**
+     * A collection's catalog metadata along with its record store, which is null when the catalog
+     * is loaded for repair.
+     */
+    struct OpenedCollection {
+        BSONCollectionCatalogEntry::MetaData md;
+        std::unique_ptr<RecordStore> rs;
+    };
+
+    /**
+     * Reads the metadata and opens the record store of each of 'collections', returning them in
+     * the same order. Uses up to 'catalogLoadThreadCount' threads when the engine supports
+     * document level locking.
+     */
+    std::vector<OpenedCollection> _openCollections(OperationContext* opCtx,
+                                                   const std::vector<std::string>& collections);
+
     class RemoveDBChange;
 
     stdx::function<KVDatabaseCatalogEntryFactory> _databaseCatalogEntryFactory;
@@ -324,6 +324,31 @@ StatusWith<RecordId> MobileRecordStore::insertRecord(OperationContext* opCtx,
     return StatusWith<RecordId>(recId);
 }
 
+Status MobileRecordStore::insertRecords(OperationContext* opCtx,
+                                        std::vector<Record>* records,
+                                        std::vector<Timestamp>* timestamps) {
+    // All the records are inserted in the current SQLite transaction by one statement, which is
+    // only bound anew for each record.
+    MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
+    std::string insertQuery =
+        "INSERT OR REPLACE INTO \"" + _ident + "\"(rec_id, data) VALUES(?, ?);";
+    SqliteStatement insertStmt(*session, insertQuery);
+
+    int64_t dataSize = 0;
+    for (auto& record : *records) {
+        record.id = _nextId();
+        insertStmt.bindInt(0, record.id.repr());
+        insertStmt.bindBlob(1, record.data.data(), record.data.size());
+        insertStmt.step(SQLITE_DONE);
+        insertStmt.reset();
+        dataSize += record.data.size();
+    }
+
+    _changeNumRecs(opCtx, records->size());
+    _changeDataSize(opCtx, dataSize);
+    return Status::OK();
+}
+
 Status MobileRecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
                                                      const DocWriter* const* docs,
                                                      const Timestamp* timestamps,
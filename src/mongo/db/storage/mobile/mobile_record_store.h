@@ -65,6 +65,10 @@ public:
                                       int len,
                                       Timestamp timestamp) override;
 
+    Status insertRecords(OperationContext* opCtx,
+                         std::vector<Record>* records,
+                         std::vector<Timestamp>* timestamps) override;
+
     Status insertRecordsWithDocWriter(OperationContext* opCtx,
                                       const DocWriter* const* docs,
                                       const Timestamp* timestamps,
@@ -35,8 +35,45 @@
 
 namespace mongo {
 
-MobileSession::MobileSession(sqlite3* session, MobileSessionPool* sessionPool)
-    : _session(session), _sessionPool(sessionPool) {}
+MobileStatementCache::~MobileStatementCache() {
+    close();
+}
+
+sqlite3_stmt* MobileStatementCache::take(const std::string& sqlQuery) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _statements.find(sqlQuery);
+    if (it == _statements.end()) {
+        return nullptr;
+    }
+    sqlite3_stmt* stmt = it->second;
+    _statements.erase(it);
+    return stmt;
+}
+
+void MobileStatementCache::put(const std::string& sqlQuery, sqlite3_stmt* stmt) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_closed && _statements.size() < kMaxStatements) {
+            _statements.emplace(sqlQuery, stmt);
+            return;
+        }
+    }
+    sqlite3_finalize(stmt);
+}
+
+void MobileStatementCache::close() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _closed = true;
+    for (auto&& entry : _statements) {
+        sqlite3_finalize(entry.second);
+    }
+    _statements.clear();
+}
+
+MobileSession::MobileSession(sqlite3* session,
+                             MobileSessionPool* sessionPool,
+                             std::shared_ptr<MobileStatementCache> statementCache)
+    : _session(session), _sessionPool(sessionPool), _statementCache(std::move(statementCache)) {}
 
 MobileSession::~MobileSession() {
     // Releases this session back to the session pool.
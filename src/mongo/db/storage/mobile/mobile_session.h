@@ -28,15 +28,58 @@
 
 #pragma once
 
+#include <memory>
 #include <sqlite3.h>
 #include <string>
+#include <unordered_map>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/mobile/mobile_session_pool.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 class MobileSessionPool;
 
+/**
+ * Keeps the prepared statements of one SQLite connection once they are finished with, so that
+ * later statements with the same SQL reuse them rather than compile it again.
+ */
+class MobileStatementCache final {
+    MONGO_DISALLOW_COPYING(MobileStatementCache);
+
+public:
+    static const size_t kMaxStatements = 64;
+
+    MobileStatementCache() = default;
+
+    ~MobileStatementCache();
+
+    /**
+     * Returns a cached statement for "sqlQuery", which the caller then owns, or nullptr if there
+     * is none.
+     */
+    sqlite3_stmt* take(const std::string& sqlQuery);
+
+    /**
+     * Keeps "stmt", which must have been reset, for reuse by statements for "sqlQuery". The
+     * statement is finalized instead if the cache is full or closed.
+     */
+    void put(const std::string& sqlQuery, sqlite3_stmt* stmt);
+
+    /**
+     * Finalizes every cached statement, and every statement put afterwards. Must be called before
+     * the connection is closed.
+     */
+    void close();
+
+private:
+    // Statements may be returned by threads which no longer have the connection checked out, so
+    // the cache has its own mutex.
+    stdx::mutex _mutex;
+    bool _closed = false;
+    std::unordered_multimap<std::string, sqlite3_stmt*> _statements;
+};
+
 /**
  * This class manages a SQLite database connection object.
  */
@@ -44,7 +87,9 @@ class MobileSession final {
     MONGO_DISALLOW_COPYING(MobileSession);
 
 public:
-    MobileSession(sqlite3* session, MobileSessionPool* sessionPool);
+    MobileSession(sqlite3* session,
+                  MobileSessionPool* sessionPool,
+                  std::shared_ptr<MobileStatementCache> statementCache = nullptr);
 
     ~MobileSession();
 
@@ -53,8 +98,17 @@ public:
      */
     sqlite3* getSession() const;
 
+    /**
+     * Returns the cache of prepared statements of the connection, or nullptr if its statements
+     * are not cached.
+     */
+    const std::shared_ptr<MobileStatementCache>& getStatementCache() const {
+        return _statementCache;
+    }
+
 private:
     sqlite3* _session;
     MobileSessionPool* _sessionPool;
+    std::shared_ptr<MobileStatementCache> _statementCache;
 };
 }  // namespace mongo
@@ -38,14 +38,39 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/mobile/mobile_session.h"
 #include "mongo/db/storage/mobile/mobile_session_pool.h"
 #include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
 #include "mongo/db/storage/mobile/mobile_util.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
+namespace {
+
+// The page cache of each SQLite connection, in kibibytes. SQLite defaults to about 2MB for every
+// connection, which adds up quickly on the small devices the mobile engine runs on.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(mobileSessionCacheSizeKB, int, 512)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 64) {
+            return Status(ErrorCodes::BadValue, "mobileSessionCacheSizeKB must be >= 64");
+        }
+        return Status::OK();
+    });
+
+// The number of released sessions kept open for reuse. Sessions released beyond these are closed,
+// giving their page cache back, and are opened again when they are next needed.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(mobileMaxIdleSessions, int, 4)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue, "mobileMaxIdleSessions must be >= 1");
+        }
+        return Status::OK();
+    });
+
+}  // namespace
 
 MobileDelayedOpQueue::MobileDelayedOpQueue() : _isEmpty(true) {}
 
@@ -111,7 +136,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
     // Checks if there is an open session available.
     if (!_sessions.empty()) {
         sqlite3* session = _popSession_inlock();
-        return stdx::make_unique<MobileSession>(session, this);
+        return stdx::make_unique<MobileSession>(session, this, _statementCaches[session]);
     }
 
     // Checks if a new session can be opened.
@@ -120,7 +145,18 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         int status = sqlite3_open(_path.c_str(), &session);
         checkStatus(status, SQLITE_OK, "sqlite3_open");
         _curPoolSize++;
-        return stdx::make_unique<MobileSession>(session, this);
+
+        // A negative cache_size is in kibibytes rather than pages.
+        char* errMsg = NULL;
+        const std::string cacheSizeQuery = str::stream() << "PRAGMA cache_size = -"
+                                                         << mobileSessionCacheSizeKB << ";";
+        status = sqlite3_exec(session, cacheSizeQuery.c_str(), NULL, NULL, &errMsg);
+        checkStatus(status, SQLITE_OK, "sqlite3_exec", errMsg);
+        sqlite3_free(errMsg);
+
+        auto& statementCache = _statementCaches[session];
+        statementCache = std::make_shared<MobileStatementCache>();
+        return stdx::make_unique<MobileSession>(session, this, statementCache);
     }
 
     // There are no open sessions available and the maxPoolSize has been reached.
@@ -129,7 +165,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         _releasedSessionNotifier, lk, [&] { return !_sessions.empty(); });
 
     sqlite3* session = _popSession_inlock();
-    return stdx::make_unique<MobileSession>(session, this);
+    return stdx::make_unique<MobileSession>(session, this, _statementCaches[session]);
 }
 
 void MobileSessionPool::releaseSession(MobileSession* session) {
@@ -137,9 +173,28 @@ void MobileSessionPool::releaseSession(MobileSession* session) {
     if (!failedDropsQueue.isEmpty())
         failedDropsQueue.execAndDequeueOp(session);
 
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    _sessions.push_back(session->getSession());
-    _releasedSessionNotifier.notify_one();
+    sqlite3* sessionToClose = nullptr;
+    std::shared_ptr<MobileStatementCache> statementCacheToClose;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_shuttingDown && _sessions.size() >= static_cast<size_t>(mobileMaxIdleSessions)) {
+            // Enough sessions are idle already, so close this one rather than keep its memory.
+            // Waiters for a session still find one in _sessions.
+            sessionToClose = session->getSession();
+            auto it = _statementCaches.find(sessionToClose);
+            statementCacheToClose = std::move(it->second);
+            _statementCaches.erase(it);
+            _curPoolSize--;
+        } else {
+            _sessions.push_back(session->getSession());
+        }
+        _releasedSessionNotifier.notify_one();
+    }
+    if (sessionToClose) {
+        statementCacheToClose->close();
+        // Statements which are still being finalized keep the connection open until they are.
+        sqlite3_close_v2(sessionToClose);
+    }
 }
 
 void MobileSessionPool::shutDown() {
@@ -172,6 +227,10 @@ void MobileSessionPool::shutDown() {
         sqlite3_close(session);
     }
 
+    for (auto&& entry : _statementCaches) {
+        entry.second->close();
+    }
+    _statementCaches.clear();
     for (auto&& session : _sessions) {
         sqlite3_close(session);
     }
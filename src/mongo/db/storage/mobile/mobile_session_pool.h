@@ -28,9 +28,11 @@
 
 #pragma once
 
+#include <memory>
 #include <queue>
 #include <sqlite3.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -40,6 +42,7 @@
 
 namespace mongo {
 class MobileSession;
+class MobileStatementCache;
 
 /**
  * This class manages a queue of operations delayed for some reason
@@ -111,5 +114,8 @@ private:
 
     using SessionPool = std::vector<sqlite3*>;
     SessionPool _sessions;
+
+    // The prepared statement cache of every open session, whether or not it is in _sessions.
+    std::unordered_map<sqlite3*, std::shared_ptr<MobileStatementCache>> _statementCaches;
 };
 }  // namespace mongo
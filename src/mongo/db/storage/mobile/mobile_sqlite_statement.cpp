@@ -58,6 +58,18 @@ void SqliteStatement::finalize() {
     if (!_stmt) {
         return;
     }
+    auto statementCache = std::move(_statementCache);
+    if (statementCache && _exceptionStatus == SQLITE_OK) {
+        // Like finalizing the statement, resetting it releases the locks it holds.
+        int status = sqlite3_reset(_stmt);
+        if (status == SQLITE_OK) {
+            SQLITE_STMT_TRACE() << "Caching: " << _sqlQuery;
+            sqlite3_clear_bindings(_stmt);
+            statementCache->put(_sqlQuery, _stmt);
+            _stmt = NULL;
+            return;
+        }
+    }
     SQLITE_STMT_TRACE() << "Finalize: " << _sqlQuery;
 
     int status = sqlite3_finalize(_stmt);
@@ -66,6 +78,15 @@ void SqliteStatement::finalize() {
 }
 
 void SqliteStatement::prepare(const MobileSession& session) {
+    _statementCache = session.getStatementCache();
+    if (_statementCache) {
+        _stmt = _statementCache->take(_sqlQuery);
+        if (_stmt) {
+            SQLITE_STMT_TRACE() << "Reusing cached statement: " << _sqlQuery;
+            return;
+        }
+    }
+
     SQLITE_STMT_TRACE() << "Preparing: " << _sqlQuery;
 
     int status = sqlite3_prepare_v2(
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <sqlite3.h>
 #include <string>
 
@@ -117,12 +118,14 @@ public:
     static void execQuery(MobileSession* session, const std::string& query);
 
     /**
-     * Finalizes a prepared statement.
+     * Finalizes a prepared statement. If the session it was prepared with caches statements, the
+     * statement is reset and kept in that cache instead.
      */
     void finalize();
 
     /**
-     * Prepare a statement with the given mobile session.
+     * Prepare a statement with the given mobile session, reusing a statement from the session's
+     * cache when there is one for the same SQL.
      */
     void prepare(const MobileSession& session);
 
@@ -133,6 +136,10 @@ private:
     sqlite3_stmt* _stmt;
     std::string _sqlQuery;
 
+    // The cache of the connection the statement was prepared on, which finalize() returns the
+    // statement to. Null if that connection does not cache statements.
+    std::shared_ptr<MobileStatementCache> _statementCache;
+
     // If the most recent call to sqlite3_step on this statement returned an error, the error is
     // returned again when the statement is finalized. This is used to verify that the last error
     // code returned matches the finalize error code, if there is any.
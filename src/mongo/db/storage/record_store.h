@@ -262,6 +262,15 @@ public:
      */
     virtual long long numRecords(OperationContext* opCtx) const = 0;
 
+    /**
+     * Returns the number of records which a new snapshot would see, if the record store knows it
+     * exactly, or boost::none. Unlike numRecords(), which counts the records of writes that have
+     * not committed yet, this is only answered when no such write is in progress.
+     */
+    virtual boost::optional<long long> exactNumRecords(OperationContext* opCtx) const {
+        return boost::none;
+    }
+
     virtual bool isCapped() const = 0;
 
     virtual void setCappedCallback(CappedCallback*) {
@@ -496,6 +505,15 @@ public:
         return false;
     }
 
+    /**
+     * Returns true if the records of this RecordStore are keyed by the integral _id of their
+     * documents (see clustered_id.h) rather than by RecordIds chosen by the RecordStore. Inserting
+     * a document whose key is already present fails with DuplicateKey.
+     */
+    virtual bool isClusteredOnId() const {
+        return false;
+    }
+
     /**
      * @return OK if the validate run successfully
      *         OK will be returned even if corruption is found
@@ -533,6 +551,9 @@ public:
      * Return the RecordId of an oplog entry as close to startingPosition as possible without
      * being higher. If there are no entries <= startingPosition, return RecordId().
      *
+     * Record stores that are clustered on _id support this for any collection, so that scans over
+     * a range of _id values can be positioned without the start key having to exist.
+     *
      * If you don't implement the oplogStartHack, just use the default implementation which
      * returns boost::none.
      */
@@ -236,6 +236,74 @@ TEST(RecordStoreTestHarness, UpdateWithOverlappingDamageEventsReversed) {
     }
 }
 
+// Insert a record and try to perform an update on it with DamageEvents which grow and shrink the
+// record. Each DamageEvent's targetOffset is relative to the record as changed by the previous
+// ones.
+TEST(RecordStoreTestHarness, UpdateWithResizingDamageEvents) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    if (!rs->updateWithDamagesSupported())
+        return;
+
+    string data = "00010111";
+    RecordId loc;
+    const RecordData rec(data.c_str(), data.size() + 1);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), rec.data(), rec.size(), Timestamp());
+            ASSERT_OK(res.getStatus());
+            loc = res.getValue();
+            uow.commit();
+        }
+    }
+
+    string damageSource = "abcdef";
+    string modifiedData = "0abcd11ef";
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            mutablebson::DamageVector dv(3);
+            // Grow: replace "00" with "abcd".
+            dv[0].sourceOffset = 0;
+            dv[0].targetOffset = 1;
+            dv[0].size = 4;
+            dv[0].targetSize = 2;
+            // Shrink: remove "011".
+            dv[1].sourceOffset = 4;
+            dv[1].targetOffset = 6;
+            dv[1].size = 0;
+            dv[1].targetSize = 3;
+            // Insert "ef" before the terminating null.
+            dv[2].sourceOffset = 4;
+            dv[2].targetOffset = 7;
+            dv[2].size = 2;
+            dv[2].targetSize = 0;
+
+            WriteUnitOfWork uow(opCtx.get());
+            auto newRecStatus =
+                rs->updateWithDamages(opCtx.get(), loc, rec, damageSource.c_str(), dv);
+            ASSERT_OK(newRecStatus.getStatus());
+            ASSERT_EQUALS(modifiedData, newRecStatus.getValue().data());
+            ASSERT_EQUALS(static_cast<int>(modifiedData.size() + 1),
+                          newRecStatus.getValue().size());
+            uow.commit();
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            RecordData record = rs->dataFor(opCtx.get(), loc);
+            ASSERT_EQUALS(modifiedData, record.data());
+            ASSERT_EQUALS(static_cast<int>(modifiedData.size() + 1), record.size());
+        }
+    }
+}
+
 // Insert a record and try to call updateWithDamages() with an empty DamageVector.
 TEST(RecordStoreTestHarness, UpdateWithNoDamages) {
     const auto harnessHelper(newRecordStoreHarnessHelper());
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <stdlib.h>
 #include <string>
 
@@ -38,6 +39,7 @@
 #include "mongo/db/repl/read_concern_level.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/storage/snapshot.h"
+#include "mongo/db/storage/storage_stats.h"
 
 namespace mongo {
 
@@ -172,6 +174,15 @@ public:
         return boost::none;
     }
 
+    /**
+     * Returns a timestamp such that the currently open snapshot sees every oplog entry with an
+     * earlier or equal timestamp, or boost::none if no such bound is known. A forward scan of the
+     * oplog which reaches the end in this snapshot has therefore seen all entries up to it.
+     */
+    virtual boost::optional<Timestamp> getOplogVisibilityTs() const {
+        return boost::none;
+    }
+
     /**
      * Gets the local SnapshotId.
      *
@@ -305,6 +316,15 @@ public:
         return false;
     };
 
+    /**
+     * Returns a snapshot of the storage engine work performed on behalf of the calling thread so
+     * far. Callers take two snapshots and use StorageStats::since() to attribute work to a single
+     * operation. Returns nullptr if the storage engine does not collect such statistics.
+     */
+    virtual std::shared_ptr<StorageStats> getOperationStatistics() const {
+        return nullptr;
+    }
+
     /**
      * A Change is an action that is registerChange()'d while a WriteUnitOfWork exists. The
      * change is either rollback()'d or commit()'d when the WriteUnitOfWork goes out of scope.
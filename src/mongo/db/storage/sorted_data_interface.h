@@ -41,6 +41,7 @@ namespace mongo {
 
 class BSONObjBuilder;
 class BucketDeletionNotification;
+struct CompactOptions;
 class SortedDataBuilderInterface;
 struct ValidateResults;
 
@@ -127,7 +128,7 @@ public:
      * Attempt to reduce the storage space used by this index via compaction. Only called if the
      * indexed record store supports compaction-in-place.
      */
-    virtual Status compact(OperationContext* opCtx) {
+    virtual Status compact(OperationContext* opCtx, const CompactOptions* options) {
         return Status::OK();
     }
 
@@ -254,6 +255,20 @@ public:
          */
         virtual void setEndPosition(const BSONObj& key, bool inclusive) = 0;
 
+        /**
+         * Asks the cursor to return each key as an object whose i-th field is named
+         * 'fieldNames[i]', without the fields whose name is empty or which are past the end of
+         * 'fieldNames', rather than with empty field names. This lets a covered projection take
+         * keys as they are decoded. Such keys are only returned by next() and seek(), and can't
+         * be compared to keys with the original fields.
+         *
+         * Returns false if the cursor can't do this, in which case its keys are unchanged. Must
+         * be called before seeking.
+         */
+        virtual bool setKeyFieldNames(std::vector<std::string> fieldNames) {
+            return false;
+        }
+
         /**
          * Moves forward and returns the new data or boost::none if there is no more data.
          * If not positioned, returns boost::none.
@@ -0,0 +1,59 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * Manages statistics from the storage engine, allowing addition and subtraction of statistics
+ * across two points in time so that the work done by a single operation can be reported.
+ */
+class StorageStats {
+public:
+    virtual ~StorageStats() = default;
+
+    /**
+     * Returns a BSON representation of the statistics, suitable for slow query logging, the
+     * profiler and $currentOp.
+     */
+    virtual BSONObj toBSON() const = 0;
+
+    /**
+     * Returns the statistics accumulated since the 'earlier' snapshot, which must have been taken
+     * by the same storage engine. Returns nullptr if 'earlier' is of a different kind.
+     */
+    virtual std::shared_ptr<StorageStats> since(const StorageStats& earlier) const = 0;
+};
+
+}  // namespace mongo
@@ -87,6 +87,13 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
                            "[none|snappy|zlib]")
         .format("(:?none)|(:?snappy)|(:?zlib)", "(none/snappy/zlib)")
         .setDefault(moe::Value(std::string("snappy")));
+    wiredTigerOptions
+        .addOptionChaining("storage.wiredTiger.collectionConfig.oplogBlockCompressor",
+                           "wiredTigerOplogBlockCompressor",
+                           moe::String,
+                           "block compression algorithm for the oplog, defaults to the "
+                           "collection block compressor [none|snappy|zlib]")
+        .format("(:?none)|(:?snappy)|(:?zlib)", "(none/snappy/zlib)");
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.collectionConfig.configString",
                            "wiredTigerCollectionConfigString",
@@ -146,6 +153,10 @@ Status WiredTigerGlobalOptions::store(const moe::Environment& params,
         wiredTigerGlobalOptions.collectionBlockCompressor =
             params["storage.wiredTiger.collectionConfig.blockCompressor"].as<std::string>();
     }
+    if (params.count("storage.wiredTiger.collectionConfig.oplogBlockCompressor")) {
+        wiredTigerGlobalOptions.oplogBlockCompressor =
+            params["storage.wiredTiger.collectionConfig.oplogBlockCompressor"].as<std::string>();
+    }
     if (params.count("storage.wiredTiger.collectionConfig.configString")) {
         wiredTigerGlobalOptions.collectionConfig =
             params["storage.wiredTiger.collectionConfig.configString"].as<std::string>();
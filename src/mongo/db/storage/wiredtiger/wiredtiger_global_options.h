@@ -58,6 +58,8 @@ public:
     std::string engineConfig;
 
     std::string collectionBlockCompressor;
+    // Overrides 'collectionBlockCompressor' for the oplog when non-empty.
+    std::string oplogBlockCompressor;
     std::string indexBlockCompressor;
     bool useCollectionPrefixCompression;
     bool useIndexPrefixCompression;
@@ -37,6 +37,7 @@
 #include <set>
 
 #include "mongo/base/checked_cast.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
@@ -431,7 +432,7 @@ bool WiredTigerIndex::isEmpty(OperationContext* opCtx) {
     WT_CURSOR* c = curwrap.get();
     if (!c)
         return true;
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->next(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->next(c); });
     if (ret == WT_NOTFOUND)
         return true;
     invariantWTOK(ret);
@@ -499,7 +500,7 @@ bool WiredTigerIndex::isDup(OperationContext* opCtx,
     WiredTigerItem item(data.getBuffer(), data.getSize());
     setKey(c, item.Get());
 
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
     if (ret == WT_NOTFOUND) {
         return false;
     }
@@ -524,14 +525,12 @@ Status WiredTigerIndex::initAsEmpty(OperationContext* opCtx) {
     return Status::OK();
 }
 
-Status WiredTigerIndex::compact(OperationContext* opCtx) {
+Status WiredTigerIndex::compact(OperationContext* opCtx, const CompactOptions* options) {
     dassert(opCtx->lockState()->isWriteLocked());
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
-        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
-        opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, uri().c_str(), "timeout=0");
-        invariantWTOK(ret);
+        return WiredTigerUtil::compactTable(
+            opCtx, uri(), options ? options->stepTimeout : Seconds(0));
     }
     return Status::OK();
 }
@@ -830,6 +829,11 @@ public:
         _endPosition->resetToKey(stripFieldNames(key), _idx.ordering(), discriminator);
     }
 
+    bool setKeyFieldNames(std::vector<std::string> fieldNames) override {
+        _keyFieldNames = std::move(fieldNames);
+        return true;
+    }
+
     boost::optional<IndexKeyEntry> seek(const BSONObj& key,
                                         bool inclusive,
                                         RequestedInfo parts) override {
@@ -965,7 +969,13 @@ protected:
 
         BSONObj bson;
         if (TRACING_ENABLED || (parts & kWantKey)) {
-            bson = KeyString::toBson(_key.getBuffer(), _key.getSize(), _idx.ordering(), _typeBits);
+            if (_keyFieldNames.empty()) {
+                bson = KeyString::toBson(
+                    _key.getBuffer(), _key.getSize(), _idx.ordering(), _typeBits);
+            } else {
+                bson = KeyString::toBsonWithFieldNames(
+                    _key.getBuffer(), _key.getSize(), _idx.ordering(), _typeBits, _keyFieldNames);
+            }
 
             TRACE_CURSOR << " returning " << bson << ' ' << _id;
         }
@@ -998,7 +1008,7 @@ protected:
     void advanceWTCursor() {
         WT_CURSOR* c = _cursor->get();
         int ret = wiredTigerPrepareConflictRetry(
-            _opCtx, [&] { return _forward ? c->next(c) : c->prev(c); });
+            _opCtx, c, [&] { return _forward ? c->next(c) : c->prev(c); });
         if (ret == WT_NOTFOUND) {
             _cursorAtEof = true;
             return;
@@ -1020,7 +1030,8 @@ protected:
         const WiredTigerItem keyItem(query.getBuffer(), query.getSize());
         setKey(c, keyItem.Get());
 
-        int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search_near(c, &cmp); });
+        int ret =
+            wiredTigerPrepareConflictRetry(_opCtx, c, [&] { return c->search_near(c, &cmp); });
         if (ret == WT_NOTFOUND) {
             _cursorAtEof = true;
             TRACE_CURSOR << "\t not found";
@@ -1123,6 +1134,9 @@ protected:
     KVPrefix _prefix;
 
     std::unique_ptr<KeyString> _endPosition;
+
+    // When non-empty, keys are returned with these field names. See setKeyFieldNames().
+    std::vector<std::string> _keyFieldNames;
 };
 
 // The Standard Cursor doesn't need anything more than the base has.
@@ -1275,7 +1289,7 @@ bool WiredTigerIndexUnique::isDup(OperationContext* opCtx,
     // key, search a record matching the prefix key.
     int cmp;
     auto searchStatus =
-        wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search_near(c, &cmp); });
+        wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search_near(c, &cmp); });
 
     if (searchStatus == WT_NOTFOUND)
         return false;
@@ -1304,10 +1318,10 @@ bool WiredTigerIndexUnique::isDup(OperationContext* opCtx,
     int ret;
     if (cmp < 0) {
         // We got the smaller key adjacent to prefix key, check the next key too.
-        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->next(c); });
+        ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->next(c); });
     } else {
         // We got the larger key adjacent to prefix key, check the previous key too.
-        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->prev(c); });
+        ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->prev(c); });
     }
 
     if (ret == 0) {
@@ -1372,7 +1386,7 @@ StatusWith<SpecialFormatInserted> WiredTigerIndexUnique::_insertTimestampUnsafe(
     // we put them all in the "list"
     // Note that we can't omit AllZeros when there are multiple ids for a value. When we remove
     // down to a single value, it will be cleaned up.
-    ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
     invariantWTOK(ret);
 
     WT_ITEM old;
@@ -1518,7 +1532,7 @@ void WiredTigerIndexUnique::_unindexTimestampUnsafe(OperationContext* opCtx,
         if (_partial) {
             // Check that the record id matches.  We may be called to unindex records that are not
             // present in the index due to the partial filter expression.
-            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+            int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
             if (ret == WT_NOTFOUND) {
                 triggerWriteConflictAtPoint(c);
                 return;
@@ -1545,7 +1559,7 @@ void WiredTigerIndexUnique::_unindexTimestampUnsafe(OperationContext* opCtx,
 
     // dups are allowed, so we have to deal with a vector of RecordIds.
 
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
     if (ret == WT_NOTFOUND) {
         triggerWriteConflictAtPoint(c);
         return;
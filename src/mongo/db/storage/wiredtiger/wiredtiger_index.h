@@ -116,7 +116,7 @@ public:
 
     virtual Status initAsEmpty(OperationContext* opCtx);
 
-    virtual Status compact(OperationContext* opCtx);
+    virtual Status compact(OperationContext* opCtx, const CompactOptions* options);
 
     const std::string& uri() const {
         return _uri;
@@ -113,6 +113,9 @@ public:
                                    params.readOnly);
         kv->setRecordStoreExtraOptions(wiredTigerGlobalOptions.collectionConfig);
         kv->setSortedDataInterfaceExtraOptions(wiredTigerGlobalOptions.indexConfig);
+        if (lockFile && lockFile->createdByUncleanShutdown()) {
+            kv->setRecordCountsMayBeStale();
+        }
         // Intentionally leaked.
         new WiredTigerServerStatusSection(kv);
         new WiredTigerEngineRuntimeConfigParameter(kv);
@@ -77,12 +77,16 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_memory_governor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/allocator_free_memory.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/ticketholder.h"
@@ -378,6 +382,82 @@ private:
     AtomicWord<std::uint64_t> _oplogNeededForCrashRecovery;
 };
 
+class WiredTigerKVEngine::WiredTigerTicketTunerThread : public BackgroundJob {
+public:
+    explicit WiredTigerTicketTunerThread(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTTicketTuner";
+    }
+
+    virtual void run();
+
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            _shuttingDown.store(true);
+        }
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    /**
+     * Returns whether application threads had to evict pages since the last call, which means
+     * they are stalled on a full cache.
+     */
+    bool _isCacheUnderPressure();
+
+    WiredTigerSessionCache* _sessionCache;
+    long long _lastAppEvictions = -1;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+};
+
+class WiredTigerKVEngine::WiredTigerMemoryGovernorThread : public BackgroundJob {
+public:
+    WiredTigerMemoryGovernorThread(WiredTigerKVEngine* engine, size_t cacheSizeMB)
+        : BackgroundJob(false /* deleteSelf */),
+          _startupCacheSizeMB(cacheSizeMB),
+          _governor(cacheSizeMB,
+                    [engine](size_t newCacheSizeMB) {
+                        const std::string config =
+                            str::stream() << "cache_size=" << newCacheSizeMB << "M";
+                        return wtRCToStatus(engine->reconfigure(config.c_str()));
+                    },
+                    &releaseAllocatorFreeBytes) {}
+
+    virtual string name() const {
+        return "WTMemoryGovernor";
+    }
+
+    virtual void run();
+
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            _shuttingDown.store(true);
+        }
+        _condvar.notify_one();
+        wait();
+    }
+
+    void appendStats(BSONObjBuilder* builder) const {
+        _governor.appendStats(builder);
+    }
+
+private:
+    const size_t _startupCacheSizeMB;
+    WiredTigerMemoryGovernor _governor;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+};
+
 namespace {
 
 class TicketServerParameter : public ServerParameter {
@@ -425,11 +505,195 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// When enabled, the ticket tuner thread adjusts the number of read and write tickets within the
+// limits below, starting from the configured wiredTigerConcurrent*Transactions.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTickets, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsIntervalMillis, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 10 || newVal > 60 * 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerAdaptiveTicketsIntervalMillis must be between 10 and 60000");
+        }
+        return Status::OK();
+    });
+
+// TicketHolder::resize() doesn't go below 5 tickets.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsMin, int, 16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 5) {
+            return Status(ErrorCodes::BadValue, "wiredTigerAdaptiveTicketsMin must be >= 5");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsMax, int, 512)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 5) {
+            return Status(ErrorCodes::BadValue, "wiredTigerAdaptiveTicketsMax must be >= 5");
+        }
+        return Status::OK();
+    });
+
+// Tickets are added while operations wait this long for one on average.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsTargetQueueMicros, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerAdaptiveTicketsTargetQueueMicros must be >= 0");
+        }
+        return Status::OK();
+    });
+
+WiredTigerTicketTuner writeTicketTuner(&openWriteTransaction);
+WiredTigerTicketTuner readTicketTuner(&openReadTransaction);
+
+// When enabled, the memory governor thread returns free allocator memory to the operating system
+// and resizes the WiredTiger cache within the limits below, starting from the configured size.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMemoryGovernor, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMemoryGovernorIntervalMillis, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 10 || newVal > 60 * 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerMemoryGovernorIntervalMillis must be between 10 and 60000");
+        }
+        return Status::OK();
+    });
+
+// The cache shrinks while the process is resident above this share of system memory.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMemoryGovernorTargetResidentPercent, int, 80)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 100) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerMemoryGovernorTargetResidentPercent must be between 1 and "
+                          "100");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMemoryGovernorMinCacheSizeMB, int, 256)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerMemoryGovernorMinCacheSizeMB must be >= 1");
+        }
+        return Status::OK();
+    });
+
+// 0 means the cache size the engine was started with.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMemoryGovernorMaxCacheSizeMB, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerMemoryGovernorMaxCacheSizeMB must be >= 0");
+        }
+        return Status::OK();
+    });
+
+// Releasing a bounded amount per interval spreads the cost of decommitting pages out over time.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMemoryGovernorReleaseMBPerInterval, int, 64)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerMemoryGovernorReleaseMBPerInterval must be >= 0");
+        }
+        return Status::OK();
+    });
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
 }  // namespace
 
+void WiredTigerKVEngine::WiredTigerTicketTunerThread::run() {
+    Client::initThread(name().c_str());
+    ON_BLOCK_EXIT([] { Client::destroy(); });
+
+    LOG(1) << "starting " << name() << " thread";
+
+    while (!_shuttingDown.load()) {
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            _condvar.wait_for(
+                lock,
+                stdx::chrono::milliseconds(wiredTigerAdaptiveTicketsIntervalMillis.load()),
+                [&] { return _shuttingDown.load(); });
+        }
+
+        // Sample the eviction statistics even while disabled, so that enabling the tuner doesn't
+        // act on a delta from long ago.
+        const bool cacheUnderPressure = _isCacheUnderPressure();
+        const bool enabled = !_shuttingDown.load() && wiredTigerAdaptiveTickets.load();
+        Locker::setGlobalThrottlingAdaptive(enabled);
+        if (!enabled) {
+            continue;
+        }
+
+        const WiredTigerTicketTuner::Limits limits{
+            wiredTigerAdaptiveTicketsMin.load(),
+            wiredTigerAdaptiveTicketsMax.load(),
+            Microseconds(wiredTigerAdaptiveTicketsTargetQueueMicros.load())};
+        writeTicketTuner.adjust(limits, cacheUnderPressure);
+        readTicketTuner.adjust(limits, cacheUnderPressure);
+    }
+    LOG(1) << "stopping " << name() << " thread";
+}
+
+bool WiredTigerKVEngine::WiredTigerTicketTunerThread::_isCacheUnderPressure() {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    auto appEvictions = WiredTigerUtil::getStatisticsValueAs<long long>(
+        session->getSession(), "statistics:", "", WT_STAT_CONN_CACHE_EVICTION_APP);
+    if (!appEvictions.isOK()) {
+        return false;
+    }
+
+    const bool underPressure =
+        _lastAppEvictions >= 0 && appEvictions.getValue() > _lastAppEvictions;
+    _lastAppEvictions = appEvictions.getValue();
+    return underPressure;
+}
+
+void WiredTigerKVEngine::WiredTigerMemoryGovernorThread::run() {
+    Client::initThread(name().c_str());
+    ON_BLOCK_EXIT([] { Client::destroy(); });
+
+    LOG(1) << "starting " << name() << " thread";
+
+    ProcessInfo processInfo;
+    while (!_shuttingDown.load()) {
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            _condvar.wait_for(
+                lock,
+                stdx::chrono::milliseconds(wiredTigerMemoryGovernorIntervalMillis.load()),
+                [&] { return _shuttingDown.load(); });
+        }
+
+        if (_shuttingDown.load() || !wiredTigerMemoryGovernor.load()) {
+            continue;
+        }
+
+        const size_t maxCacheSizeMB = wiredTigerMemoryGovernorMaxCacheSizeMB.load();
+        const WiredTigerMemoryGovernor::Limits limits{
+            static_cast<size_t>(wiredTigerMemoryGovernorMinCacheSizeMB.load()),
+            maxCacheSizeMB ? maxCacheSizeMB : _startupCacheSizeMB,
+            wiredTigerMemoryGovernorTargetResidentPercent.load() / 100.0,
+            static_cast<size_t>(wiredTigerMemoryGovernorReleaseMBPerInterval.load()) * 1024 *
+                1024};
+        // Without operations holding tickets, decommitting pages doesn't slow anything down.
+        const WiredTigerMemoryGovernor::Sample sample{
+            static_cast<size_t>(processInfo.getResidentSize()) * 1024 * 1024,
+            static_cast<size_t>(ProcessInfo::getMemSizeMB()) * 1024 * 1024,
+            allocatorFreeBytes(),
+            openWriteTransaction.used() == 0 && openReadTransaction.used() == 0};
+        _governor.adjust(limits, sample);
+    }
+    LOG(1) << "stopping " << name() << " thread";
+}
+
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
                                        ClockSource* cs,
@@ -564,6 +828,18 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         _checkpointThread->go();
     }
 
+    if (!_readOnly) {
+        _ticketTunerThread = stdx::make_unique<WiredTigerTicketTunerThread>(_sessionCache.get());
+        _ticketTunerThread->go();
+    }
+
+    // The in-memory engine's cache holds all of its data, so it must never shrink.
+    if (!_readOnly && !_ephemeral) {
+        _memoryGovernorThread =
+            stdx::make_unique<WiredTigerMemoryGovernorThread>(this, cacheSizeMB);
+        _memoryGovernorThread->go();
+    }
+
     _sizeStorerUri = _uri("sizeStorer");
     WiredTigerSession session(_conn);
     if (!_readOnly && repair && _hasUri(session.getSession(), _sizeStorerUri)) {
@@ -601,6 +877,30 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("totalTickets", openReadTransaction.outof());
         bbb.done();
     }
+    {
+        // Together with the totalTickets sampled by FTDC, this is the history of the tuner.
+        BSONObjBuilder bbb(bb.subobjStart("adaptive"));
+        bbb.append("enabled", wiredTigerAdaptiveTickets.load());
+        {
+            BSONObjBuilder tuner(bbb.subobjStart("write"));
+            writeTicketTuner.appendStats(&tuner);
+        }
+        {
+            BSONObjBuilder tuner(bbb.subobjStart("read"));
+            readTicketTuner.appendStats(&tuner);
+        }
+        bbb.done();
+    }
+    bb.done();
+}
+
+void WiredTigerKVEngine::appendMemoryGovernorStats(BSONObjBuilder& b) const {
+    if (!_memoryGovernorThread) {
+        return;
+    }
+    BSONObjBuilder bb(b.subobjStart("memoryGovernor"));
+    bb.append("enabled", wiredTigerMemoryGovernor.load());
+    _memoryGovernorThread->appendStats(&bb);
     bb.done();
 }
 
@@ -681,6 +981,16 @@ void WiredTigerKVEngine::cleanShutdown() {
         _checkpointThread->shutdown();
         log() << "Finished shutting down checkpoint thread";
     }
+    if (_ticketTunerThread) {
+        log() << "Shutting down ticket tuner thread";
+        _ticketTunerThread->shutdown();
+        log() << "Finished shutting down ticket tuner thread";
+    }
+    if (_memoryGovernorThread) {
+        log() << "Shutting down memory governor thread";
+        _memoryGovernorThread->shutdown();
+        log() << "Finished shutting down memory governor thread";
+    }
     LOG_FOR_RECOVERY(2) << "Shutdown timestamps. StableTimestamp: " << _stableTimestamp.load()
                         << " Initial data timestamp: " << _initialDataTimestamp.load();
 
@@ -1045,6 +1355,7 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     params.cappedCallback = nullptr;
     params.sizeStorer = _sizeStorer.get();
     params.isReadOnly = _readOnly;
+    params.isClusteredOnId = options.clusteredOnId;
 
     params.cappedMaxSize = -1;
     if (options.capped) {
@@ -1582,6 +1893,7 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
 
     LOG_FOR_ROLLBACK(2) << "WiredTiger::RecoverToStableTimestamp syncing size storer to disk.";
     syncSizeInfo(true);
+    setRecordCountsMayBeStale();
 
     if (!_ephemeral) {
         LOG_FOR_ROLLBACK(2)
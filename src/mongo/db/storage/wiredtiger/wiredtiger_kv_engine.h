@@ -44,6 +44,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/elapsed_tracker.h"
@@ -82,10 +83,27 @@ public:
     void setRecordStoreExtraOptions(const std::string& options);
     void setSortedDataInterfaceExtraOptions(const std::string& options);
 
+    /**
+     * Marks the record counts saved by the size storer as possibly stale, after an unclean shutdown
+     * or a rollback to the stable timestamp. Record stores opened afterwards do not report exact
+     * record counts until they are recounted.
+     */
+    void setRecordCountsMayBeStale() {
+        _recordCountsMayBeStale.store(true);
+    }
+
+    bool recordCountsMayBeStale() const {
+        return _recordCountsMayBeStale.load();
+    }
+
     virtual bool supportsDocLocking() const override;
 
     virtual bool supportsDirectoryPerDB() const override;
 
+    virtual bool supportsClusteredIdCollections() const override {
+        return true;
+    }
+
     virtual bool isDurable() const override {
         return _durable;
     }
@@ -298,6 +316,11 @@ public:
 
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Appends what the memory governor has done so far, if it runs for this engine.
+     */
+    void appendMemoryGovernorStats(BSONObjBuilder& b) const;
+
     /**
      * These are timestamp access functions for serverStatus to be able to report the actual
      * snapshot window size.
@@ -344,6 +367,8 @@ public:
 private:
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketTunerThread;
+    class WiredTigerMemoryGovernorThread;
 
     /**
      * Opens a connection on the WiredTiger database 'path' with the configuration 'wtOpenConfig'.
@@ -413,6 +438,7 @@ private:
     std::unique_ptr<WiredTigerSizeStorer> _sizeStorer;
     std::string _sizeStorerUri;
     mutable ElapsedTracker _sizeStorerSyncTracker;
+    AtomicBool _recordCountsMayBeStale;
 
     bool _durable;
     bool _ephemeral;  // whether we are using the in-memory mode of the WT engine
@@ -428,6 +454,8 @@ private:
 
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketTunerThread> _ticketTunerThread;
+    std::unique_ptr<WiredTigerMemoryGovernorThread> _memoryGovernorThread;
 
     std::string _rsOptions;
     std::string _indexOptions;
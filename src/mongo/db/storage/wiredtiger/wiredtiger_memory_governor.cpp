@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_memory_governor.h"
+
+#include <algorithm>
+
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+constexpr double WiredTigerMemoryGovernor::kGrowHeadroomRatio;
+
+WiredTigerMemoryGovernor::WiredTigerMemoryGovernor(size_t cacheSizeMB,
+                                                   ResizeCacheFn resizeCache,
+                                                   ReleaseFn release)
+    : _resizeCache(std::move(resizeCache)),
+      _release(std::move(release)),
+      _cacheSizeMB(static_cast<long long>(cacheSizeMB)) {}
+
+size_t WiredTigerMemoryGovernor::adjust(const Limits& limits, const Sample& sample) {
+    const double residentRatio =
+        sample.systemBytes ? static_cast<double>(sample.residentBytes) / sample.systemBytes : 0;
+    const bool underPressure = residentRatio > limits.targetResidentRatio;
+
+    // Decommitting pages is expensive, so it is left for idle periods unless the memory is needed.
+    if ((sample.idle || underPressure) && sample.allocatorFreeBytes > 0 &&
+        limits.releaseBytesPerAdjustment > 0) {
+        const size_t released =
+            _release(std::min(sample.allocatorFreeBytes, limits.releaseBytesPerAdjustment));
+        if (released > 0) {
+            LOG(1) << "Released " << released << " free bytes of "
+                   << sample.allocatorFreeBytes << " to the operating system"
+                   << (underPressure ? " under memory pressure" : "");
+            _releases.fetchAndAdd(1);
+            _releasedBytes.fetchAndAdd(static_cast<long long>(released));
+            _lastActionMillis.store(Date_t::now().toMillisSinceEpoch());
+        }
+    }
+
+    const size_t current = static_cast<size_t>(_cacheSizeMB.load());
+    size_t target = current;
+    if (underPressure) {
+        target = current - std::max<size_t>(1, current / 10);
+    } else if (residentRatio < limits.targetResidentRatio - kGrowHeadroomRatio) {
+        target = current + std::max<size_t>(1, current / 10);
+    }
+    // Only move towards the limits, so that a cache size set by hand outside of them is left
+    // alone until memory use asks for a change in the other direction.
+    if (target > current) {
+        target = std::min(target, std::max(current, limits.maxCacheSizeMB));
+    } else if (target < current) {
+        target = std::max(target, std::min(current, limits.minCacheSizeMB));
+    }
+    if (target == current) {
+        return current;
+    }
+
+    Status status = _resizeCache(target);
+    if (!status.isOK()) {
+        warning() << "Failed to resize the WiredTiger cache from " << current << "MB to "
+                  << target << "MB: " << status;
+        return current;
+    }
+
+    LOG(1) << "Resized the WiredTiger cache from " << current << "MB to " << target
+           << "MB, resident memory is " << sample.residentBytes << " of " << sample.systemBytes
+           << " system bytes";
+    _cacheSizeMB.store(static_cast<long long>(target));
+    (target > current ? _cacheIncreases : _cacheDecreases).fetchAndAdd(1);
+    _lastActionMillis.store(Date_t::now().toMillisSinceEpoch());
+    return target;
+}
+
+void WiredTigerMemoryGovernor::appendStats(BSONObjBuilder* builder) const {
+    builder->append("cacheSizeMB", _cacheSizeMB.load());
+    builder->append("cacheIncreases", _cacheIncreases.load());
+    builder->append("cacheDecreases", _cacheDecreases.load());
+    builder->append("releases", _releases.load());
+    builder->append("releasedBytes", _releasedBytes.load());
+    builder->appendDate("lastAction", Date_t::fromMillisSinceEpoch(_lastActionMillis.load()));
+}
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+
+namespace mongo {
+
+/**
+ * Balances the memory of the process between the WiredTiger cache and the free memory the
+ * allocator keeps for reuse. Each call to adjust() looks at a sample of the memory use of the
+ * process. Free allocator memory is returned to the operating system a bounded amount at a time,
+ * while no operations are running so that the cost of decommitting pages doesn't land on them,
+ * or at any time while the process is resident above its target share of system memory. Above
+ * that target the cache also shrinks by a tenth, and well below it the cache grows back by a
+ * tenth.
+ *
+ * adjust() must only be called from one thread at a time, appendStats() may be called concurrently.
+ */
+class WiredTigerMemoryGovernor {
+public:
+    struct Limits {
+        size_t minCacheSizeMB;
+        size_t maxCacheSizeMB;
+        // Fraction of system memory the process should stay resident under.
+        double targetResidentRatio;
+        size_t releaseBytesPerAdjustment;
+    };
+
+    struct Sample {
+        size_t residentBytes;
+        size_t systemBytes;
+        size_t allocatorFreeBytes;
+        bool idle;
+    };
+
+    // Resizes the cache to the given size in megabytes.
+    using ResizeCacheFn = stdx::function<Status(size_t)>;
+
+    // Returns up to the given number of free bytes to the operating system, returning how many.
+    using ReleaseFn = stdx::function<size_t(size_t)>;
+
+    WiredTigerMemoryGovernor(size_t cacheSizeMB, ResizeCacheFn resizeCache, ReleaseFn release);
+
+    /**
+     * Releases free memory and resizes the cache as 'sample' asks for it, within 'limits'.
+     * Returns the cache size in megabytes afterwards.
+     */
+    size_t adjust(const Limits& limits, const Sample& sample);
+
+    /**
+     * Appends the current cache size, the number of cache resizes and releases so far, the bytes
+     * released and the time of the last action.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    // The cache grows back once the process is resident this far below its target.
+    static constexpr double kGrowHeadroomRatio = 0.1;
+
+    const ResizeCacheFn _resizeCache;
+    const ReleaseFn _release;
+
+    AtomicWord<long long> _cacheSizeMB;
+
+    AtomicInt64 _cacheIncreases;
+    AtomicInt64 _cacheDecreases;
+    AtomicInt64 _releases;
+    AtomicInt64 _releasedBytes;
+    AtomicInt64 _lastActionMillis;
+};
+
+}  // namespace mongo
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_memory_governor.h"
+
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kMB = 1024 * 1024;
+const size_t kSystemBytes = 1000 * kMB;
+const WiredTigerMemoryGovernor::Limits kLimits{100, 1000, 0.8, 64 * kMB};
+
+/**
+ * Records what the governor asks for instead of resizing a cache or releasing memory.
+ */
+class GovernorTest : public unittest::Test {
+protected:
+    std::unique_ptr<WiredTigerMemoryGovernor> makeGovernor(size_t cacheSizeMB) {
+        return stdx::make_unique<WiredTigerMemoryGovernor>(cacheSizeMB,
+                                                           [this](size_t newCacheSizeMB) {
+                                                               resizedToMB = newCacheSizeMB;
+                                                               return Status::OK();
+                                                           },
+                                                           [this](size_t bytes) {
+                                                               released += bytes;
+                                                               return bytes;
+                                                           });
+    }
+
+    static WiredTigerMemoryGovernor::Sample sample(size_t residentMB, size_t freeMB, bool idle) {
+        return {residentMB * kMB, kSystemBytes, freeMB * kMB, idle};
+    }
+
+    size_t resizedToMB = 0;
+    size_t released = 0;
+};
+
+TEST_F(GovernorTest, LeavesCacheAloneAroundTarget) {
+    auto governor = makeGovernor(500);
+    ASSERT_EQ(500U, governor->adjust(kLimits, sample(750, 0, false)));
+    ASSERT_EQ(0U, resizedToMB);
+}
+
+TEST_F(GovernorTest, ShrinksCacheAboveTarget) {
+    auto governor = makeGovernor(500);
+    ASSERT_EQ(450U, governor->adjust(kLimits, sample(900, 0, false)));
+    ASSERT_EQ(450U, resizedToMB);
+}
+
+TEST_F(GovernorTest, GrowsCacheWellBelowTarget) {
+    auto governor = makeGovernor(500);
+    ASSERT_EQ(550U, governor->adjust(kLimits, sample(500, 0, false)));
+    ASSERT_EQ(550U, resizedToMB);
+}
+
+TEST_F(GovernorTest, StaysWithinCacheLimits) {
+    auto governor = makeGovernor(105);
+    ASSERT_EQ(100U, governor->adjust(kLimits, sample(900, 0, false)));
+    ASSERT_EQ(100U, governor->adjust(kLimits, sample(900, 0, false)));
+
+    auto large = makeGovernor(950);
+    ASSERT_EQ(1000U, large->adjust(kLimits, sample(100, 0, false)));
+    ASSERT_EQ(1000U, large->adjust(kLimits, sample(100, 0, false)));
+}
+
+TEST_F(GovernorTest, LeavesCacheSetAboveTheLimitAlone) {
+    auto governor = makeGovernor(2000);
+    ASSERT_EQ(2000U, governor->adjust(kLimits, sample(100, 0, false)));
+    ASSERT_EQ(1800U, governor->adjust(kLimits, sample(900, 0, false)));
+}
+
+TEST_F(GovernorTest, ReleasesFreeMemoryOnlyWhenIdle) {
+    auto governor = makeGovernor(500);
+    governor->adjust(kLimits, sample(750, 32, false));
+    ASSERT_EQ(0U, released);
+    governor->adjust(kLimits, sample(750, 32, true));
+    ASSERT_EQ(32 * kMB, released);
+}
+
+TEST_F(GovernorTest, ReleasesFreeMemoryUnderPressureEvenWhenBusy) {
+    auto governor = makeGovernor(500);
+    governor->adjust(kLimits, sample(900, 32, false));
+    ASSERT_EQ(32 * kMB, released);
+}
+
+TEST_F(GovernorTest, ReleasesAtMostTheLimitPerAdjustment) {
+    auto governor = makeGovernor(500);
+    governor->adjust(kLimits, sample(750, 1000, true));
+    ASSERT_EQ(64 * kMB, released);
+}
+
+TEST_F(GovernorTest, KeepsCacheSizeWhenResizeFails) {
+    WiredTigerMemoryGovernor governor(500,
+                                      [](size_t) { return Status(ErrorCodes::BadValue, "no"); },
+                                      [](size_t) { return size_t(0); });
+    ASSERT_EQ(500U, governor.adjust(kLimits, sample(900, 0, false)));
+}
+
+TEST_F(GovernorTest, CountsActions) {
+    auto governor = makeGovernor(500);
+    governor->adjust(kLimits, sample(900, 16, false));
+    governor->adjust(kLimits, sample(500, 0, false));
+
+    BSONObjBuilder builder;
+    governor->appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(495, stats["cacheSizeMB"].numberLong());
+    ASSERT_EQ(1, stats["cacheIncreases"].numberLong());
+    ASSERT_EQ(1, stats["cacheDecreases"].numberLong());
+    ASSERT_EQ(1, stats["releases"].numberLong());
+    ASSERT_EQ(static_cast<long long>(16 * kMB), stats["releasedBytes"].numberLong());
+    ASSERT_GT(stats["lastAction"].Date(), Date_t());
+}
+
+}  // namespace
+}  // namespace mongo
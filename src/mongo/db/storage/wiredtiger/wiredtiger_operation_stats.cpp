@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_operation_stats.h"
+
+#include <algorithm>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+
+namespace {
+
+// getrusage() reports block input in units of 512 bytes regardless of the filesystem block size.
+const long long kRusageBlockSize = 512;
+
+long long toMicros(const struct timeval& tv) {
+    return static_cast<long long>(tv.tv_sec) * 1000 * 1000 + tv.tv_usec;
+}
+
+}  // namespace
+
+std::shared_ptr<WiredTigerOperationStats> WiredTigerOperationStats::snapshot() {
+#if defined(RUSAGE_THREAD)
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        return std::make_shared<WiredTigerOperationStats>(usage.ru_inblock * kRusageBlockSize,
+                                                          usage.ru_majflt,
+                                                          toMicros(usage.ru_utime),
+                                                          toMicros(usage.ru_stime));
+    }
+#endif
+    return std::make_shared<WiredTigerOperationStats>();
+}
+
+WiredTigerOperationStats::WiredTigerOperationStats(long long bytesRead,
+                                                   long long majorPageFaults,
+                                                   long long userCpuMicros,
+                                                   long long systemCpuMicros)
+    : _bytesRead(bytesRead),
+      _majorPageFaults(majorPageFaults),
+      _userCpuMicros(userCpuMicros),
+      _systemCpuMicros(systemCpuMicros) {}
+
+BSONObj WiredTigerOperationStats::toBSON() const {
+    BSONObjBuilder builder;
+    {
+        BSONObjBuilder data(builder.subobjStart("data"));
+        data.append("bytesRead", _bytesRead);
+        data.append("majorPageFaults", _majorPageFaults);
+    }
+    {
+        BSONObjBuilder cpu(builder.subobjStart("cpu"));
+        cpu.append("userMicros", _userCpuMicros);
+        cpu.append("systemMicros", _systemCpuMicros);
+    }
+    return builder.obj();
+}
+
+std::shared_ptr<StorageStats> WiredTigerOperationStats::since(const StorageStats& earlier) const {
+    auto other = dynamic_cast<const WiredTigerOperationStats*>(&earlier);
+    if (!other) {
+        return nullptr;
+    }
+
+    // Counters are monotonic per thread, but the snapshots may have been taken on different
+    // threads if the operation migrated between them, so never report negative work.
+    auto delta = [](long long now, long long then) { return std::max(now - then, 0LL); };
+    return std::make_shared<WiredTigerOperationStats>(
+        delta(_bytesRead, other->_bytesRead),
+        delta(_majorPageFaults, other->_majorPageFaults),
+        delta(_userCpuMicros, other->_userCpuMicros),
+        delta(_systemCpuMicros, other->_systemCpuMicros));
+}
+
+}  // namespace mongo
@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/db/storage/storage_stats.h"
+
+namespace mongo {
+
+/**
+ * Storage statistics for the work WiredTiger performed on the calling thread.
+ *
+ * The bundled WiredTiger does not maintain per-session statistics, so the counters come from the
+ * kernel's per-thread resource usage instead. Because an operation runs on a single thread while it
+ * holds its session, the difference between two snapshots taken on that thread still isolates the
+ * operation's disk reads from the time it spent on CPU. On platforms without per-thread resource
+ * usage all counters are zero.
+ */
+class WiredTigerOperationStats final : public StorageStats {
+public:
+    /**
+     * Takes a snapshot of the counters for the calling thread.
+     */
+    static std::shared_ptr<WiredTigerOperationStats> snapshot();
+
+    WiredTigerOperationStats() = default;
+    WiredTigerOperationStats(long long bytesRead,
+                             long long majorPageFaults,
+                             long long userCpuMicros,
+                             long long systemCpuMicros);
+
+    BSONObj toBSON() const final;
+
+    std::shared_ptr<StorageStats> since(const StorageStats& earlier) const final;
+
+    long long getBytesRead() const {
+        return _bytesRead;
+    }
+
+    long long getMajorPageFaults() const {
+        return _majorPageFaults;
+    }
+
+    long long getUserCpuMicros() const {
+        return _userCpuMicros;
+    }
+
+    long long getSystemCpuMicros() const {
+        return _systemCpuMicros;
+    }
+
+private:
+    // Bytes read from the filesystem, i.e. pages WiredTiger brought into its cache from disk.
+    long long _bytesRead = 0;
+    // Page faults that required I/O, e.g. when reading through the OS page cache under pressure.
+    long long _majorPageFaults = 0;
+    long long _userCpuMicros = 0;
+    long long _systemCpuMicros = 0;
+};
+
+}  // namespace mongo
@@ -86,6 +86,7 @@ void WiredTigerOplogManager::start(OperationContext* opCtx,
 
     _isRunning = true;
     _shuttingDown = false;
+    _oplogRecordStore = oplogRecordStore;
 }
 
 void WiredTigerOplogManager::halt() {
@@ -94,6 +95,7 @@ void WiredTigerOplogManager::halt() {
         invariant(_isRunning);
         _shuttingDown = true;
         _isRunning = false;
+        _oplogRecordStore = nullptr;
     }
 
     if (_oplogJournalThread.joinable()) {
@@ -131,6 +133,10 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
     invariant(_opsWaitingForVisibility > 0);
     auto exitGuard = MakeGuard([&] { _opsWaitingForVisibility--; });
 
+    // Cut short any journaling delay the oplogJournal thread is in, rather than waiting for it to
+    // poll for waiters.
+    _opsWaitingForJournalCV.notify_one();
+
     opCtx->waitForConditionOrInterrupt(_opsBecameVisibleCV, lk, [&] {
         auto newLatestVisibleTimestamp = getOplogReadTimestamp();
         if (newLatestVisibleTimestamp < currentLatestVisibleTimestamp) {
@@ -163,6 +169,23 @@ void WiredTigerOplogManager::triggerJournalFlush() {
     }
 }
 
+bool WiredTigerOplogManager::isVisibilityUpdatePending() const {
+    stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+    return _isRunning && !_shuttingDown && _opsWaitingForJournal;
+}
+
+void WiredTigerOplogManager::oplogWritesMadeDurable(uint64_t allCommitted) {
+    stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+    if (!_isRunning || _shuttingDown || allCommitted <= getOplogReadTimestamp()) {
+        return;
+    }
+
+    // Leave '_opsWaitingForJournal' set: commits after 'allCommitted' may have triggered the
+    // update, and the oplogJournal thread skips its journal flush if nothing more is visible.
+    _setOplogReadTimestamp(lk, allCommitted);
+    _oplogRecordStore->notifyCappedWaitersIfNeeded();
+}
+
 void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* sessionCache,
                                                      WiredTigerRecordStore* oplogRecordStore,
                                                      const bool updateOldestTimestamp) noexcept {
@@ -227,6 +250,14 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
         // a non-incrementing timestamp.
         if (newTimestamp <= _oplogReadTimestamp.load()) {
             LOG(2) << "no new oplog entries were made visible: " << newTimestamp;
+
+            // The read timestamp may have been published by oplogWritesMadeDurable(), which
+            // leaves moving the oldest timestamp forward to this thread. Moving it backward, like
+            // during secondary batch application, is ignored by WiredTiger.
+            if (updateOldestTimestamp) {
+                const bool force = false;
+                sessionCache->getKVEngine()->setOldestTimestamp(Timestamp(newTimestamp), force);
+            }
             continue;
         }
 
@@ -75,6 +75,17 @@ public:
     // Triggers the oplogJournal thread to update its oplog read timestamp, by flushing the journal.
     void triggerJournalFlush();
 
+    // Returns true if the oplogJournal thread has been asked to update the oplog read timestamp
+    // and has not started doing so yet.
+    bool isVisibilityUpdatePending() const;
+
+    // Called once a journal flush, or a checkpoint, which started after 'allCommitted' was
+    // fetched has completed. All of the writes before that timestamp are durable, so it can be
+    // published as the oplog read timestamp right away rather than by the next iteration of the
+    // oplogJournal thread. Does nothing unless isVisibilityUpdatePending() was true beforehand,
+    // which the caller should check before fetching 'allCommitted'.
+    void oplogWritesMadeDurable(uint64_t allCommitted);
+
     // Waits until all committed writes at this point to become visible (that is, no holes exist in
     // the oplog.)
     void waitForAllEarlierOplogWritesToBeVisible(const WiredTigerRecordStore* oplogRecordStore,
@@ -101,6 +112,9 @@ private:
     bool _isRunning = false;     // Guarded by the oplogVisibilityStateMutex.
     bool _shuttingDown = false;  // Guarded by oplogVisibilityStateMutex.
 
+    // The oplog passed to start(), set while running. Guarded by oplogVisibilityStateMutex.
+    WiredTigerRecordStore* _oplogRecordStore = nullptr;
+
     // This is the RecordId of the newest oplog document in the oplog on startup.  It is used as a
     // floor in waitForAllEarlierOplogWritesToBeVisible().
     RecordId _oplogMaxAtStartup = RecordId(0);  // Guarded by oplogVisibilityStateMutex.
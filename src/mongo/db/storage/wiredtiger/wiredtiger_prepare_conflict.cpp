@@ -33,17 +33,49 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
 // When set, simulates WT_PREPARE_CONFLICT returned from WiredTiger API calls.
 MONGO_FAIL_POINT_DEFINE(WTPrepareConflictForReads);
 
+namespace {
+Counter64 prepareConflictWaits;
+Counter64 prepareConflictWaitMicros;
+Counter64 prepareConflictSpuriousWakeups;
+
+ServerStatusMetricField<Counter64> displayPrepareConflictWaits("storage.prepareConflict.waits",
+                                                               &prepareConflictWaits);
+ServerStatusMetricField<Counter64> displayPrepareConflictWaitMicros(
+    "storage.prepareConflict.waitMicros", &prepareConflictWaitMicros);
+ServerStatusMetricField<Counter64> displayPrepareConflictSpuriousWakeups(
+    "storage.prepareConflict.spuriousWakeups", &prepareConflictSpuriousWakeups);
+}  // namespace
+
 void wiredTigerPrepareConflictLog(int attempts) {
     LOG(1) << "Caught WT_PREPARE_CONFLICT, attempt " << attempts
            << ". Waiting for unit of work to commit or abort.";
 }
 
+void wiredTigerPrepareConflictWait(OperationContext* opCtx,
+                                   WiredTigerSessionCache* sessionCache,
+                                   uint64_t tableBit,
+                                   uint64_t lastCount,
+                                   bool isRetry) {
+    prepareConflictWaits.increment();
+    if (isRetry) {
+        prepareConflictSpuriousWakeups.increment();
+    }
+
+    Timer timer;
+    ON_BLOCK_EXIT([&] { prepareConflictWaitMicros.increment(timer.micros()); });
+    sessionCache->waitUntilPreparedUnitOfWorkCommitsOrAborts(opCtx, tableBit, lastCount);
+}
+
 }  // namespace mongo
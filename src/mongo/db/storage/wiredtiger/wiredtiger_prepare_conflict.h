@@ -45,32 +45,55 @@ MONGO_FAIL_POINT_DECLARE(WTPrepareConflictForReads);
  */
 void wiredTigerPrepareConflictLog(int attempt);
 
+/**
+ * Waits on the session cache until a prepared unit of work which may have written to the table with
+ * bit 'tableBit' commits or aborts, unless one already did since its counter was 'lastCount'.
+ * Counts the wait, its duration and whether it follows an earlier wait which did not resolve the
+ * conflict ('isRetry') in the prepare conflict serverStatus metrics.
+ */
+void wiredTigerPrepareConflictWait(OperationContext* opCtx,
+                                   WiredTigerSessionCache* sessionCache,
+                                   uint64_t tableBit,
+                                   uint64_t lastCount,
+                                   bool isRetry);
+
 /**
  * Runs the argument function f as many times as needed for f to return an error other than
- * WT_PREPARE_CONFLICT. Each time f returns WT_PREPARE_CONFLICT we wait until the current unit of
- * work commits or aborts, and then try f again. Imposes no upper limit on the number of times to
- * re-try f, so any required timeout behavior must be enforced within f.
- * The function f must return a WiredTiger error code.
+ * WT_PREPARE_CONFLICT. Each time f returns WT_PREPARE_CONFLICT we wait until a prepared unit of
+ * work which may have written to the table of 'cursor' commits or aborts, and then try f again.
+ * Imposes no upper limit on the number of times to re-try f, so any required timeout behavior must
+ * be enforced within f.
+ * The function f must return a WiredTiger error code from an operation on 'cursor'.
  */
 template <typename F>
-int wiredTigerPrepareConflictRetry(OperationContext* opCtx, F&& f) {
+int wiredTigerPrepareConflictRetry(OperationContext* opCtx, WT_CURSOR* cursor, F&& f) {
     invariant(opCtx);
 
-    auto recoveryUnit = WiredTigerRecoveryUnit::get(opCtx);
-    int attempts = 0;
-    while (true) {
-        attempts++;
-        // If the failpoint is enabled, don't call the function, just simulate a conflict.
-        int ret =
-            MONGO_FAIL_POINT(WTPrepareConflictForReads) ? WT_PREPARE_CONFLICT : WT_READ_CHECK(f());
+    // If the failpoint is enabled, don't call the function, just simulate a conflict.
+    auto attempt = [&] {
+        return MONGO_FAIL_POINT(WTPrepareConflictForReads) ? WT_PREPARE_CONFLICT
+                                                           : WT_READ_CHECK(f());
+    };
+
+    int ret = attempt();
+    if (ret != WT_PREPARE_CONFLICT)
+        return ret;
 
+    auto sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    const uint64_t tableBit = WiredTigerSessionCache::prepareConflictTableBit(cursor->uri);
+    int attempts = 1;
+    while (true) {
+        // Read the counter before trying again rather than after the conflict, otherwise a
+        // prepared unit of work ending in between would leave us waiting for the next one.
+        const uint64_t lastCount = sessionCache->getPrepareCommitOrAbortCount(tableBit);
+        ret = attempt();
         if (ret != WT_PREPARE_CONFLICT)
             return ret;
 
         CurOp::get(opCtx)->debug().additiveMetrics.incrementPrepareReadConflicts(1);
         wiredTigerPrepareConflictLog(attempts);
-        // Wait on the session cache to signal that a unit of work has been committed or aborted.
-        recoveryUnit->getSessionCache()->waitUntilPreparedUnitOfWorkCommitsOrAborts(opCtx);
+        wiredTigerPrepareConflictWait(opCtx, sessionCache, tableBit, lastCount, attempts > 1);
+        attempts++;
     }
 }
 }  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -49,6 +50,8 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
+#include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
@@ -147,6 +150,7 @@ public:
 
         stdx::lock_guard<stdx::mutex> lk(_oplogStones->_mutex);
         _oplogStones->_stones.clear();
+        _oplogStones->_persistStones_inlock();
     }
 
     void rollback() final {}
@@ -229,6 +233,7 @@ WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
 void WiredTigerRecordStore::OplogStones::popOldestStone() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _stones.pop_front();
+    _persistStones_inlock();
 }
 
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRecord) {
@@ -254,6 +259,7 @@ void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRec
     LOG(2) << "create new oplogStone, current stones:" << _stones.size();
     OplogStones::Stone stone = {_currentRecords.swap(0), _currentBytes.swap(0), lastRecord};
     _stones.push_back(stone);
+    _persistStones_inlock();
 
     _pokeReclaimThreadIfNeeded();
 }
@@ -293,6 +299,7 @@ void WiredTigerRecordStore::OplogStones::updateStonesAfterCappedTruncateAfter(
     // Remove the stones corresponding to the records that were deleted.
     int64_t offset = _stones.size() - numStonesToRemove;
     _stones.erase(_stones.begin() + offset, _stones.end());
+    _persistStones_inlock();
 
     // Account for any remaining records from a partially truncated stone in the stone currently
     // being filled.
@@ -318,6 +325,11 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
     log() << "The size storer reports that the oplog contains " << numRecords
           << " records totaling to " << dataSize << " bytes";
 
+    if (_loadPersistedStones(opCtx)) {
+        return;
+    }
+    ON_BLOCK_EXIT([this] { _persistStones_inlock(); });
+
     // Only use sampling to estimate where to place the oplog stones if the number of samples drawn
     // is less than 5% of the collection.
     const uint64_t kMinSampleRatioForRandCursor = 20;
@@ -340,6 +352,75 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
     _calculateStonesBySampling(opCtx, int64_t(estRecordsPerStone), int64_t(estBytesPerStone));
 }
 
+bool WiredTigerRecordStore::OplogStones::_loadPersistedStones(OperationContext* opCtx) {
+    BSONObj persistedStones = _rs->_sizeInfo->getOplogStones();
+    if (persistedStones.isEmpty()) {
+        return false;
+    }
+
+    // The stones were saved along with the size information, which is only written back
+    // periodically. Stones for records which have since been truncated are dropped. Stones past
+    // the newest record, or which account for more records or bytes than the oplog holds, mean the
+    // saved information is stale, e.g. after an unclean shutdown.
+    RecordId earliestRecord;
+    RecordId latestRecord;
+    {
+        auto record = _rs->getCursor(opCtx, /*forward=*/true)->next();
+        if (!record) {
+            return false;
+        }
+        earliestRecord = record->id;
+    }
+    {
+        auto record = _rs->getCursor(opCtx, /*forward=*/false)->next();
+        if (!record) {
+            return false;
+        }
+        latestRecord = record->id;
+    }
+
+    std::deque<OplogStones::Stone> stones;
+    int64_t recordsInStones = 0;
+    int64_t bytesInStones = 0;
+    for (auto&& elem : persistedStones) {
+        if (elem.type() != BSONType::Object) {
+            return false;
+        }
+        BSONObj stoneObj = elem.Obj();
+        OplogStones::Stone stone = {stoneObj["records"].safeNumberLong(),
+                                    stoneObj["bytes"].safeNumberLong(),
+                                    RecordId(stoneObj["lastRecord"].safeNumberLong())};
+        if (stone.records <= 0 || stone.bytes <= 0 || !stone.lastRecord.isNormal() ||
+            (!stones.empty() && stone.lastRecord <= stones.back().lastRecord) ||
+            stone.lastRecord > latestRecord) {
+            log() << "Discarding the saved oplog truncation markers, which are not consistent "
+                     "with the oplog";
+            return false;
+        }
+        if (stone.lastRecord < earliestRecord) {
+            continue;
+        }
+        recordsInStones += stone.records;
+        bytesInStones += stone.bytes;
+        stones.push_back(stone);
+    }
+
+    const int64_t currentRecords = _rs->numRecords(opCtx) - recordsInStones;
+    const int64_t currentBytes = _rs->dataSize(opCtx) - bytesInStones;
+    if (stones.empty() || currentRecords < 0 || currentBytes < 0) {
+        log() << "Discarding the saved oplog truncation markers, which are not consistent with "
+                 "the size of the oplog";
+        return false;
+    }
+
+    log() << "Loaded " << stones.size() << " saved markers for oplog truncation, the newest at "
+          << Timestamp(stones.back().lastRecord.repr()).toStringPretty();
+    _stones = std::move(stones);
+    _currentRecords.store(currentRecords);
+    _currentBytes.store(currentBytes);
+    return true;
+}
+
 void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationContext* opCtx) {
     log() << "Scanning the oplog to determine where to place markers for truncation";
 
@@ -454,6 +535,19 @@ void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
     }
 }
 
+void WiredTigerRecordStore::OplogStones::_persistStones_inlock() {
+    BSONArrayBuilder stonesBuilder;
+    for (const auto& stone : _stones) {
+        stonesBuilder.append(BSON("records" << stone.records << "bytes" << stone.bytes
+                                            << "lastRecord"
+                                            << stone.lastRecord.repr()));
+    }
+    _rs->_sizeInfo->setOplogStones(stonesBuilder.arr());
+    if (_rs->_sizeStorer) {
+        _rs->_sizeStorer->store(_rs->_uri, _rs->_sizeInfo);
+    }
+}
+
 void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     const unsigned long long kMinStonesToKeep = 10ULL;
@@ -499,8 +593,8 @@ public:
     }
 
     boost::optional<Record> next() final {
-        int advanceRet =
-            wiredTigerPrepareConflictRetry(_opCtx, [&] { return _cursor->next(_cursor); });
+        int advanceRet = wiredTigerPrepareConflictRetry(
+            _opCtx, _cursor, [&] { return _cursor->next(_cursor); });
         if (advanceRet == WT_NOTFOUND)
             return {};
         invariantWTOK(advanceRet);
@@ -583,7 +677,13 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
         ss << "prefix_compression,";
     }
 
-    ss << "block_compressor=" << wiredTigerGlobalOptions.collectionBlockCompressor << ",";
+    // Oplog entries are written once and rarely read back outside of replication, so a
+    // denser compressor can buy a longer oplog window for the same disk footprint.
+    if (NamespaceString::oplog(ns) && !wiredTigerGlobalOptions.oplogBlockCompressor.empty()) {
+        ss << "block_compressor=" << wiredTigerGlobalOptions.oplogBlockCompressor << ",";
+    } else {
+        ss << "block_compressor=" << wiredTigerGlobalOptions.collectionBlockCompressor << ",";
+    }
 
     ss << WiredTigerCustomizationHooks::get(getGlobalServiceContext())->getTableCreateConfig(ns);
 
@@ -640,6 +740,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _isCapped(params.isCapped),
       _isEphemeral(params.isEphemeral),
       _isOplog(NamespaceString::oplog(params.ns)),
+      _isClusteredOnId(params.isClusteredOnId),
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
@@ -745,6 +846,7 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
 
     if (_sizeStorer)
         _sizeStorer->store(_uri, _sizeInfo);
+    _numRecordsIsExact.store(!_sizeStorer || (_kvEngine && !_kvEngine->recordCountsMayBeStale()));
 
     if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns())) {
         _oplogStones = std::make_shared<OplogStones>(opCtx, this);
@@ -773,6 +875,25 @@ long long WiredTigerRecordStore::numRecords(OperationContext* opCtx) const {
     return _sizeInfo->numRecords.load();
 }
 
+boost::optional<long long> WiredTigerRecordStore::exactNumRecords(OperationContext* opCtx) const {
+    if (!_numRecordsIsExact.load()) {
+        return boost::none;
+    }
+
+    // The count is only committed if no change to it was pending before or after it was read, and
+    // no change both started and finished while it was read.
+    const auto finishedBefore = _finishedNumRecordsChanges.load();
+    if (_pendingNumRecordsChanges.load() != 0) {
+        return boost::none;
+    }
+    const long long count = _sizeInfo->numRecords.load();
+    if (_pendingNumRecordsChanges.load() != 0 ||
+        _finishedNumRecordsChanges.load() != finishedBefore) {
+        return boost::none;
+    }
+    return count;
+}
+
 bool WiredTigerRecordStore::isCapped() const {
     return _isCapped;
 }
@@ -828,7 +949,7 @@ RecordData WiredTigerRecordStore::dataFor(OperationContext* opCtx, const RecordI
     WT_CURSOR* c = curwrap.get();
     invariant(c);
     setKey(c, id);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
     massert(28556, "Didn't find RecordId in WiredTigerRecordStore", ret != WT_NOTFOUND);
     invariantWTOK(ret);
     return _getData(curwrap);
@@ -843,7 +964,7 @@ bool WiredTigerRecordStore::findRecord(OperationContext* opCtx,
     WT_CURSOR* c = curwrap.get();
     invariant(c);
     setKey(c, id);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
     if (ret == WT_NOTFOUND) {
         return false;
     }
@@ -863,7 +984,7 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* opCtx, const RecordId
     cursor.assertInActiveTxn();
     WT_CURSOR* c = cursor.get();
     setKey(c, id);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
     invariantWTOK(ret);
 
     WT_ITEM old_value;
@@ -973,7 +1094,7 @@ void WiredTigerRecordStore::_positionAtFirstRecordId(OperationContext* opCtx,
         if (!forTruncate) {
             int cmp = 0;
             int ret = wiredTigerPrepareConflictRetry(
-                opCtx, [&] { return cursor->search_near(cursor, &cmp); });
+                opCtx, cursor, [&] { return cursor->search_near(cursor, &cmp); });
             invariantWTOK(ret);
 
             // This is (or was) the first recordId, so it should never be the case that we have a
@@ -982,7 +1103,8 @@ void WiredTigerRecordStore::_positionAtFirstRecordId(OperationContext* opCtx,
         }
     } else {
         invariantWTOK(WT_READ_CHECK(cursor->reset(cursor)));
-        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
+        int ret =
+            wiredTigerPrepareConflictRetry(opCtx, cursor, [&] { return cursor->next(cursor); });
         invariantWTOK(ret);
     }
 }
@@ -1022,8 +1144,8 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded_inlock(OperationContext* op
         // If we know where the first record is, go to it
         if (_cappedFirstRecord != RecordId()) {
             setKey(truncateEnd, _cappedFirstRecord);
-            ret = wiredTigerPrepareConflictRetry(opCtx,
-                                                 [&] { return truncateEnd->search(truncateEnd); });
+            ret = wiredTigerPrepareConflictRetry(
+                opCtx, truncateEnd, [&] { return truncateEnd->search(truncateEnd); });
             if (ret == 0) {
                 positioned = true;
                 savedFirstKey = _cappedFirstRecord;
@@ -1032,7 +1154,7 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded_inlock(OperationContext* op
 
         // Advance the cursor truncateEnd until we find a suitable end point for our truncate
         while ((sizeSaved < sizeOverCap || docsRemoved < docsOverCap) && (docsRemoved < 20000) &&
-               (positioned || (ret = wiredTigerPrepareConflictRetry(opCtx, [&] {
+               (positioned || (ret = wiredTigerPrepareConflictRetry(opCtx, truncateEnd, [&] {
                                    return truncateEnd->next(truncateEnd);
                                })) == 0)) {
             positioned = false;
@@ -1068,7 +1190,7 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded_inlock(OperationContext* op
             // if we scanned to the end of the collection or past our insert, go back one
             if (ret == WT_NOTFOUND || newestIdToDelete >= justInserted) {
                 ret = wiredTigerPrepareConflictRetry(
-                    opCtx, [&] { return truncateEnd->prev(truncateEnd); });
+                    opCtx, truncateEnd, [&] { return truncateEnd->prev(truncateEnd); });
             }
             invariantWTOK(ret);
 
@@ -1195,7 +1317,8 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
             WT_CURSOR* cursor = cwrap.get();
 
             // The first record in the oplog should be within the truncate range.
-            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
+            int ret =
+                wiredTigerPrepareConflictRetry(opCtx, cursor, [&] { return cursor->next(cursor); });
             invariantWTOK(ret);
             RecordId firstRecord = getKey(cursor);
             if (firstRecord < _oplogStones->firstRecord || firstRecord > stone->lastRecord) {
@@ -1255,23 +1378,39 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 
     RecordId highestId = RecordId();
     dassert(nRecords != 0);
-    for (size_t i = 0; i < nRecords; i++) {
-        auto& record = records[i];
-        if (_isOplog) {
+    if (_isOplog) {
+        for (size_t i = 0; i < nRecords; i++) {
+            auto& record = records[i];
             StatusWith<RecordId> status =
                 oploghack::extractKey(record.data.data(), record.data.size());
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
-        } else if (_isCapped) {
-            record.id = _nextId();
-        } else {
-            record.id = _nextId();
+            dassert(record.id > highestId);
+            highestId = record.id;
         }
-        dassert(record.id > highestId);
-        highestId = record.id;
+    } else if (_isClusteredOnId) {
+        for (size_t i = 0; i < nRecords; i++) {
+            auto& record = records[i];
+            StatusWith<RecordId> status =
+                clusteredid::extractKey(record.data.data(), record.data.size());
+            if (!status.isOK())
+                return status.getStatus();
+            record.id = status.getValue();
+            highestId = std::max(highestId, record.id);
+        }
+    } else {
+        // Reserve the whole batch's RecordIds at once. Besides saving an atomic operation per
+        // record, this keeps the batch contiguous when other inserters run concurrently, so all of
+        // its records are appended to the same part of the table.
+        const int64_t firstId = _reserveIds(nRecords).repr();
+        for (size_t i = 0; i < nRecords; i++) {
+            records[i].id = RecordId(firstId + i);
+        }
+        highestId = records[nRecords - 1].id;
     }
 
+    Timestamp lastTs;
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         Timestamp ts;
@@ -1287,9 +1426,23 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         } else {
             ts = timestamps[i];
         }
-        if (!ts.isNull()) {
+        // Records of a batch often share a timestamp, only update the transaction when it changes.
+        if (!ts.isNull() && ts != lastTs) {
             LOG(4) << "inserting record with timestamp " << ts;
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
+            lastTs = ts;
+        }
+        if (_isClusteredOnId) {
+            // The cursor overwrites existing records, so check for a record with the same _id
+            // first. There is no _id index to detect the duplicate instead.
+            setKey(c, record.id);
+            int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
+            if (ret == 0) {
+                const BSONObj key = BSON("" << static_cast<long long>(record.id.repr()));
+                return buildDupKeyErrorStatus(key, ns(), "_id_", BSON("_id" << 1));
+            }
+            if (ret != WT_NOTFOUND)
+                return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
         }
         setKey(c, record.id);
         WiredTigerItem value(record.data.data(), record.data.size());
@@ -1396,7 +1549,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
     WT_CURSOR* c = curwrap.get();
     invariant(c);
     setKey(c, id);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search(c); });
     invariantWTOK(ret);
 
     WT_ITEM old_value;
@@ -1441,7 +1594,7 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
         entries[i].data.data = damageSource + where->sourceOffset;
         entries[i].data.size = where->size;
         entries[i].offset = where->targetOffset;
-        entries[i].size = where->size;
+        entries[i].size = where->getTargetSize();
     }
 
     WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
@@ -1471,7 +1624,7 @@ std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
 Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
     WT_CURSOR* start = startWrap.get();
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, start, [&] { return start->next(start); });
     // Empty collections don't have anything to truncate.
     if (ret == WT_NOTFOUND) {
         return Status::OK();
@@ -1498,10 +1651,8 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx,
 
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
-        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
-        opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, getURI().c_str(), "timeout=0");
-        invariantWTOK(ret);
+        return WiredTigerUtil::compactTable(
+            opCtx, getURI(), options ? options->stepTimeout : Seconds(0));
     }
     return Status::OK();
 }
@@ -1644,7 +1795,7 @@ boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
     OperationContext* opCtx, const RecordId& startingPosition) const {
     dassert(opCtx->lockState()->isReadLocked());
 
-    if (!_isOplog)
+    if (!_isOplog && !_isClusteredOnId)
         return boost::none;
 
     if (_isOplog) {
@@ -1656,7 +1807,7 @@ boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
 
     int cmp;
     setKey(c, startingPosition);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search_near(c, &cmp); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, c, [&] { return c->search_near(c, &cmp); });
     if (ret == 0 && cmp > 0)
         ret = c->prev(c);  // landed one higher than startingPosition
     if (ret == WT_NOTFOUND)
@@ -1674,16 +1825,19 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
 
     _sizeInfo->numRecords.store(numRecords);
     _sizeInfo->dataSize.store(dataSize);
+    _numRecordsIsExact.store(true);
 
     // If we have a WiredTigerSizeStorer, but our size info is not currently cached, add it.
     if (_sizeStorer)
         _sizeStorer->store(_uri, _sizeInfo);
 }
 
-RecordId WiredTigerRecordStore::_nextId() {
+RecordId WiredTigerRecordStore::_reserveIds(size_t nRecords) {
     invariant(!_isOplog);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
+    invariant(nRecords > 0);
+    RecordId out = RecordId(_nextIdNum.fetchAndAdd(nRecords));
     invariant(out.isNormal());
+    invariant(RecordId(out.repr() + nRecords - 1).isNormal());
     return out;
 }
 
@@ -1693,14 +1847,24 @@ WiredTigerRecoveryUnit* WiredTigerRecordStore::_getRecoveryUnit(OperationContext
 
 class WiredTigerRecordStore::NumRecordsChange : public RecoveryUnit::Change {
 public:
-    NumRecordsChange(WiredTigerRecordStore* rs, int64_t diff) : _rs(rs), _diff(diff) {}
-    virtual void commit(boost::optional<Timestamp>) {}
+    NumRecordsChange(WiredTigerRecordStore* rs, int64_t diff) : _rs(rs), _diff(diff) {
+        _rs->_pendingNumRecordsChanges.fetchAndAdd(1);
+    }
+    virtual void commit(boost::optional<Timestamp>) {
+        _finish();
+    }
     virtual void rollback() {
         LOG(3) << "WiredTigerRecordStore: rolling back NumRecordsChange" << -_diff;
         _rs->_sizeInfo->numRecords.fetchAndAdd(-_diff);
+        _finish();
     }
 
 private:
+    void _finish() {
+        _rs->_finishedNumRecordsChanges.fetchAndAdd(1);
+        _rs->_pendingNumRecordsChanges.fetchAndAdd(-1);
+    }
+
     WiredTigerRecordStore* _rs;
     int64_t _diff;
 };
@@ -1879,7 +2043,7 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
         // Note that an unpositioned (or eof) WT_CURSOR returns the first/last entry in the
         // table when you call next/prev.
         int advanceRet = wiredTigerPrepareConflictRetry(
-            _opCtx, [&] { return _forward ? c->next(c) : c->prev(c); });
+            _opCtx, c, [&] { return _forward ? c->next(c) : c->prev(c); });
         if (advanceRet == WT_NOTFOUND) {
             _eof = true;
             return {};
@@ -1917,7 +2081,7 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     WT_CURSOR* c = _cursor->get();
     setKey(c, id);
     // Nothing after the next line can throw WCEs.
-    int seekRet = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search(c); });
+    int seekRet = wiredTigerPrepareConflictRetry(_opCtx, c, [&] { return c->search(c); });
     if (seekRet == WT_NOTFOUND) {
         // hasWrongPrefix check not needed for a precise 'WT_CURSOR::search'.
         _eof = true;
@@ -1974,7 +2138,7 @@ bool WiredTigerRecordStoreCursorBase::restore() {
     setKey(c, _lastReturnedId);
 
     int cmp;
-    int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search_near(c, &cmp); });
+    int ret = wiredTigerPrepareConflictRetry(_opCtx, c, [&] { return c->search_near(c, &cmp); });
     RecordId id;
     if (ret == WT_NOTFOUND) {
         _eof = true;
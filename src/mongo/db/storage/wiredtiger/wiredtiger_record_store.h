@@ -113,6 +113,8 @@ public:
         CappedCallback* cappedCallback;
         WiredTigerSizeStorer* sizeStorer;
         bool isReadOnly;
+        // If true, records are keyed by the integral _id of their documents.
+        bool isClusteredOnId = false;
     };
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
@@ -128,6 +130,8 @@ public:
 
     virtual long long numRecords(OperationContext* opCtx) const;
 
+    boost::optional<long long> exactNumRecords(OperationContext* opCtx) const override;
+
     virtual bool isCapped() const;
 
     virtual int64_t storageSize(OperationContext* opCtx,
@@ -198,6 +202,10 @@ public:
         return true;
     }
 
+    virtual bool isClusteredOnId() const override {
+        return _isClusteredOnId;
+    }
+
     virtual Status validate(OperationContext* opCtx,
                             ValidateCmdLevel level,
                             ValidateAdaptor* adaptor,
@@ -297,7 +305,10 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId();
+    /**
+     * Reserves 'nRecords' consecutive RecordIds and returns the first of them.
+     */
+    RecordId _reserveIds(size_t nRecords);
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
@@ -352,6 +363,8 @@ private:
     const bool _isEphemeral;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
+    // True if records are keyed by the integral _id of their documents.
+    const bool _isClusteredOnId;
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
@@ -372,6 +385,15 @@ private:
     std::shared_ptr<WiredTigerSizeStorer::SizeInfo> _sizeInfo;
     WiredTigerKVEngine* _kvEngine;  // not owned.
 
+    // False while the record count may differ from the records on disk, as when it was saved
+    // before an unclean shutdown, until a repair or validation recounts the records.
+    AtomicBool _numRecordsIsExact;
+
+    // The number of changes to the record count whose writes have not committed or rolled back
+    // yet, and the number which have.
+    AtomicInt64 _pendingNumRecordsChanges;
+    AtomicInt64 _finishedNumRecordsChanges;
+
     // Non-null if this record store is underlying the active oplog.
     std::shared_ptr<OplogStones> _oplogStones;
 };
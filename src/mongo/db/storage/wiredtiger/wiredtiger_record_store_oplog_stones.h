@@ -118,6 +118,13 @@ private:
     class TruncateChange;
 
     void _calculateStones(OperationContext* opCtx, size_t size);
+
+    /**
+     * Restores the stones saved in the size storer by '_persistStones_inlock()', if they are
+     * consistent with the records in the oplog. Returns false if there are none or they can't be
+     * used, in which case the stones must be calculated.
+     */
+    bool _loadPersistedStones(OperationContext* opCtx);
     void _calculateStonesByScanning(OperationContext* opCtx);
     void _calculateStonesBySampling(OperationContext* opCtx,
                                     int64_t estRecordsPerStone,
@@ -125,6 +132,12 @@ private:
 
     void _pokeReclaimThreadIfNeeded();
 
+    /**
+     * Saves the current stones with the size information of the oplog, so that they are written to
+     * the size storer table with it and don't have to be calculated again on the next startup.
+     */
+    void _persistStones_inlock();
+
     static const uint64_t kRandomSamplesPerStone = 10;
 
     WiredTigerRecordStore* _rs;
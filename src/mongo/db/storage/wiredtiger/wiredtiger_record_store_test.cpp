@@ -221,6 +221,39 @@ StatusWith<RecordId> insertBSON(ServiceContext::UniqueOperationContext& opCtx,
     return res;
 }
 
+TEST(WiredTigerRecordStoreTest, InsertRecordsReservesConsecutiveIds) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    const int nToInsert = 100;
+    std::vector<Record> records;
+    std::vector<Timestamp> timestamps(nToInsert, Timestamp());
+    for (int i = 0; i < nToInsert; i++) {
+        records.push_back({RecordId(), RecordData("a", 2)});
+    }
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecords(opCtx.get(), &records, &timestamps));
+        uow.commit();
+    }
+
+    ASSERT_EQUALS(nToInsert, rs->numRecords(opCtx.get()));
+    ASSERT_EQUALS(2 * nToInsert, rs->dataSize(opCtx.get()));
+    for (int i = 0; i < nToInsert; i++) {
+        ASSERT_EQUALS(RecordId(records[0].id.repr() + i), records[i].id);
+        ASSERT_EQUALS(string("a"), rs->dataFor(opCtx.get(), records[i].id).data());
+    }
+
+    // The next insert gets the RecordId following the batch.
+    WriteUnitOfWork uow(opCtx.get());
+    StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "b", 2, Timestamp());
+    ASSERT_OK(res.getStatus());
+    ASSERT_EQUALS(RecordId(records.back().id.repr() + 1), res.getValue());
+    uow.commit();
+}
+
 TEST(WiredTigerRecordStoreTest, CappedCursorRollover) {
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 10000, 5));
@@ -38,6 +38,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_operation_stats.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -85,16 +86,19 @@ void WiredTigerRecoveryUnit::_commit() {
 
     try {
         bool notifyDone = !_prepareTimestamp.isNull();
+        // Only wake the prepare conflict waiters on the tables this unit of work touched.
+        uint64_t tablesUsed = _session ? _session->getTablesUsed() : 0;
         if (_session && _active) {
             _txnClose(true);
         }
 
         if (MONGO_FAIL_POINT(WTAlwaysNotifyPrepareConflictWaiters)) {
             notifyDone = true;
+            tablesUsed = 0;
         }
 
         if (notifyDone) {
-            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted();
+            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted(tablesUsed);
         }
 
         for (Changes::const_iterator it = _changes.begin(), end = _changes.end(); it != end; ++it) {
@@ -111,16 +115,19 @@ void WiredTigerRecoveryUnit::_commit() {
 void WiredTigerRecoveryUnit::_abort() {
     try {
         bool notifyDone = !_prepareTimestamp.isNull();
+        // Only wake the prepare conflict waiters on the tables this unit of work touched.
+        uint64_t tablesUsed = _session ? _session->getTablesUsed() : 0;
         if (_session && _active) {
             _txnClose(false);
         }
 
         if (MONGO_FAIL_POINT(WTAlwaysNotifyPrepareConflictWaiters)) {
             notifyDone = true;
+            tablesUsed = 0;
         }
 
         if (notifyDone) {
-            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted();
+            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted(tablesUsed);
         }
 
         for (Changes::const_reverse_iterator it = _changes.rbegin(), end = _changes.rend();
@@ -292,6 +299,7 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
     _prepareTimestamp = Timestamp();
     _mySnapshotId = nextSnapshotId.fetchAndAdd(1);
     _isOplogReader = false;
+    _oplogReadTimestamp = Timestamp();
     _orderedCommit = true;  // Default value is true; we assume all writes are ordered.
 }
 
@@ -331,9 +339,31 @@ boost::optional<Timestamp> WiredTigerRecoveryUnit::getPointInTimeReadTimestamp()
     return boost::none;
 }
 
+boost::optional<Timestamp> WiredTigerRecoveryUnit::getOplogVisibilityTs() const {
+    if (!_active)
+        return boost::none;
+
+    switch (_timestampReadSource) {
+        case ReadSource::kUnset:
+        case ReadSource::kNoTimestamp:
+            // Oplog readers never see past the oplog read timestamp, which has no holes before it.
+            if (_isOplogReader && !_oplogReadTimestamp.isNull())
+                return _oplogReadTimestamp;
+            return boost::none;
+        case ReadSource::kMajorityCommitted:
+            return _majorityCommittedSnapshot;
+        case ReadSource::kAllCommittedSnapshot:
+            return _readAtTimestamp;
+        default:
+            // Other read timestamps may be ahead of writes which have not committed yet.
+            return boost::none;
+    }
+}
+
 void WiredTigerRecoveryUnit::_txnOpen() {
     invariant(!_active);
     _ensureSession();
+    _session->resetTablesUsed();
 
     // Only start a timer for transaction's lifetime if we're going to log it.
     if (shouldLog(kSlowTransactionSeverity)) {
@@ -347,9 +377,9 @@ void WiredTigerRecoveryUnit::_txnOpen() {
             WiredTigerBeginTxnBlock txnOpen(session, _ignorePrepared);
 
             if (_isOplogReader) {
-                auto status =
-                    txnOpen.setTimestamp(Timestamp(_oplogManager->getOplogReadTimestamp()),
-                                         WiredTigerBeginTxnBlock::RoundToOldest::kRound);
+                _oplogReadTimestamp = Timestamp(_oplogManager->getOplogReadTimestamp());
+                auto status = txnOpen.setTimestamp(_oplogReadTimestamp,
+                                                   WiredTigerBeginTxnBlock::RoundToOldest::kRound);
                 fassert(50771, status);
             }
             txnOpen.done();
@@ -541,6 +571,10 @@ RecoveryUnit::ReadSource WiredTigerRecoveryUnit::getTimestampReadSource() const
     return _timestampReadSource;
 }
 
+std::shared_ptr<StorageStats> WiredTigerRecoveryUnit::getOperationStatistics() const {
+    return WiredTigerOperationStats::snapshot();
+}
+
 void WiredTigerRecoveryUnit::beginIdle() {
     // Close all cursors, we don't want to keep any old cached cursors around.
     if (_session) {
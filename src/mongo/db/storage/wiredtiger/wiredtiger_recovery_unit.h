@@ -81,6 +81,8 @@ public:
 
     boost::optional<Timestamp> getPointInTimeReadTimestamp() const override;
 
+    boost::optional<Timestamp> getOplogVisibilityTs() const override;
+
     SnapshotId getSnapshotId() const override;
 
     Status setTimestamp(Timestamp timestamp) override;
@@ -116,6 +118,8 @@ public:
         return _readOnce;
     };
 
+    std::shared_ptr<StorageStats> getOperationStatistics() const override;
+
     // ---- WT STUFF
 
     WiredTigerSession* getSession();
@@ -194,6 +198,8 @@ private:
     Timestamp _readAtTimestamp;
     std::unique_ptr<Timer> _timer;
     bool _isOplogReader = false;
+    // The oplog read timestamp that the open oplog reader transaction was started at.
+    Timestamp _oplogReadTimestamp;
     typedef std::vector<std::unique_ptr<Change>> Changes;
     Changes _changes;
 };
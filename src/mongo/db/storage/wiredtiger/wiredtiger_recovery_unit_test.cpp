@@ -34,6 +34,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/recovery_unit_test_harness.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_operation_stats.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -281,6 +282,46 @@ TEST_F(WiredTigerRecoveryUnitTestFixture, WriteOnADocumentBeingPreparedTriggersW
     ru2->abortUnitOfWork();
 }
 
+TEST_F(WiredTigerRecoveryUnitTestFixture, PreparedUnitOfWorkOnlyNotifiesTablesItUsed) {
+    const char* uri = "table:prepare_transaction";
+    auto sessionCache = ru1->getSessionCache();
+    const uint64_t usedBit = WiredTigerSessionCache::prepareConflictTableBit(uri);
+
+    // Prepare a transaction which writes through a cursor from the session.
+    ru1->beginUnitOfWork(clientAndCtx1.second.get());
+    WT_CURSOR* cursor;
+    getCursor(ru1, &cursor);
+    invariantWTOK(cursor->close(cursor));
+    WiredTigerSession* session = ru1->getSession();
+    cursor = session->getCursor(uri, WiredTigerSession::genTableId(), true);
+    cursor->set_key(cursor, "key");
+    cursor->set_value(cursor, "value");
+    invariantWTOK(cursor->insert(cursor));
+    session->closeCursor(cursor);
+    ru1->setPrepareTimestamp({1, 1});
+    ru1->prepareUnitOfWork();
+    ASSERT_EQ(usedBit, session->getTablesUsed());
+
+    uint64_t unusedBit = 0;
+    for (int i = 0; !unusedBit; ++i) {
+        const auto otherUri = "table:other" + std::to_string(i);
+        const auto bit = WiredTigerSessionCache::prepareConflictTableBit(otherUri.c_str());
+        if (bit != usedBit) {
+            unusedBit = bit;
+        }
+    }
+
+    const auto usedCount = sessionCache->getPrepareCommitOrAbortCount(usedBit);
+    const auto unusedCount = sessionCache->getPrepareCommitOrAbortCount(unusedBit);
+    ru1->abortUnitOfWork();
+    ASSERT_NE(usedCount, sessionCache->getPrepareCommitOrAbortCount(usedBit));
+    ASSERT_EQ(unusedCount, sessionCache->getPrepareCommitOrAbortCount(unusedBit));
+
+    // Without a set of tables, every waiter is notified.
+    sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted(0);
+    ASSERT_NE(unusedCount, sessionCache->getPrepareCommitOrAbortCount(unusedBit));
+}
+
 TEST_F(WiredTigerRecoveryUnitTestFixture,
        ChangeIsPassedEmptyLastTimestampSetOnCommitWithNoTimestamp) {
     boost::optional<Timestamp> commitTs = boost::none;
@@ -578,5 +619,35 @@ TEST_F(WiredTigerRecoveryUnitTestFixture, ReadOnceCursorsAreNotCached) {
 
     ASSERT(ru->getReadOnce());
 }
+
+TEST_F(WiredTigerRecoveryUnitTestFixture, OperationStatisticsReportWorkSinceSnapshot) {
+    auto before = ru1->getOperationStatistics();
+    ASSERT(before);
+
+    auto after = ru1->getOperationStatistics();
+    auto delta = after->since(*before);
+    ASSERT(delta);
+
+    auto obj = delta->toBSON();
+    ASSERT_GTE(obj["data"]["bytesRead"].numberLong(), 0);
+    ASSERT_GTE(obj["data"]["majorPageFaults"].numberLong(), 0);
+    ASSERT_GTE(obj["cpu"]["userMicros"].numberLong(), 0);
+    ASSERT_GTE(obj["cpu"]["systemMicros"].numberLong(), 0);
+}
+
+TEST(WiredTigerOperationStatsTest, SinceComputesDeltaAndNeverGoesNegative) {
+    WiredTigerOperationStats earlier(4096, 2, 1000, 500);
+    WiredTigerOperationStats later(12288, 3, 1500, 400);
+
+    auto delta = later.since(earlier);
+    ASSERT(delta);
+    auto stats = dynamic_cast<WiredTigerOperationStats*>(delta.get());
+    ASSERT(stats);
+    ASSERT_EQ(8192, stats->getBytesRead());
+    ASSERT_EQ(1, stats->getMajorPageFaults());
+    ASSERT_EQ(500, stats->getUserCpuMicros());
+    ASSERT_EQ(0, stats->getSystemCpuMicros());
+}
+
 }  // namespace
 }  // namespace mongo
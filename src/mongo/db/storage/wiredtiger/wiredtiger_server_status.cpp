@@ -77,6 +77,7 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
     }
 
     WiredTigerKVEngine::appendGlobalStats(bob);
+    _engine->appendMemoryGovernorStats(bob);
 
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
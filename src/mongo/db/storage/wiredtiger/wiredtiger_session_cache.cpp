@@ -35,17 +35,22 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/base/error_codes.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/bits.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -86,6 +91,34 @@ ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
                                      "wiredTigerCursorCacheSize",
                                      &kWiredTigerCursorCacheSize);
 
+// When non-zero, the thread flushing the journal for waitUntilDurable() first waits up to this
+// long for more threads to need a flush, so that their writes are made durable by the same one.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerGroupCommitWindowMicros, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 100 * 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerGroupCommitWindowMicros must be between 0 and 100000");
+        }
+        return Status::OK();
+    });
+
+// A group commit window is closed early once this many threads are waiting for durability.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerGroupCommitMaxWaiters, int, 64)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue, "wiredTigerGroupCommitMaxWaiters must be >= 1");
+        }
+        return Status::OK();
+    });
+
+// The ratio of these is the average number of waitUntilDurable() calls served by one flush.
+Counter64 groupCommitFlushes;
+Counter64 groupCommitWaiters;
+ServerStatusMetricField<Counter64> displayGroupCommitFlushes("storage.groupCommit.flushes",
+                                                             &groupCommitFlushes);
+ServerStatusMetricField<Counter64> displayGroupCommitWaiters("storage.groupCommit.waiters",
+                                                             &groupCommitWaiters);
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, uint64_t epoch, uint64_t cursorEpoch)
     : _epoch(epoch), _cursorEpoch(cursorEpoch), _session(NULL), _cursorGen(0), _cursorsOut(0) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
@@ -139,6 +172,7 @@ WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, boo
             WT_CURSOR* c = i->_cursor;
             _cursors.erase(i);
             _cursorsOut++;
+            _tablesUsed |= WiredTigerSessionCache::prepareConflictTableBit(uri.c_str());
             return c;
         }
     }
@@ -146,6 +180,7 @@ WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, boo
     WT_CURSOR* cursor = NULL;
     _openCursor(_session, uri, allowOverwrite ? "" : "overwrite=false", &cursor);
     _cursorsOut++;
+    _tablesUsed |= WiredTigerSessionCache::prepareConflictTableBit(uri.c_str());
     return cursor;
 }
 
@@ -155,6 +190,7 @@ WT_CURSOR* WiredTigerSession::getReadOnceCursor(const std::string& uri, bool all
     WT_CURSOR* cursor = NULL;
     _openCursor(_session, uri, config, &cursor);
     _cursorsOut++;
+    _tablesUsed |= WiredTigerSessionCache::prepareConflictTableBit(uri.c_str());
     return cursor;
 }
 
@@ -224,31 +260,48 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
+namespace {
+
+// There is one partition of the session cache per core, up to this many.
+const size_t kMaxSessionCachePartitions = 64;
+
+size_t numSessionCachePartitions() {
+    return std::max<size_t>(
+        1, std::min<size_t>(ProcessInfo::getNumAvailableCores(), kMaxSessionCachePartitions));
+}
+
+}  // namespace
+
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _shuttingDown(0) {}
+    : _engine(engine), _conn(engine->getConnection()), _partitions(numSessionCachePartitions()) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _shuttingDown(0) {}
+    : _engine(NULL), _conn(conn), _partitions(numSessionCachePartitions()) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
 }
 
 void WiredTigerSessionCache::shuttingDown() {
-    uint32_t actual = _shuttingDown.load();
-    uint32_t expected;
-
-    // Try to atomically set _shuttingDown flag, but just return if another thread was first.
-    do {
-        expected = actual;
-        actual = _shuttingDown.compareAndSwap(expected, expected | kShuttingDownMask);
-        if (actual & kShuttingDownMask)
-            return;
-    } while (actual != expected);
+    // Try to atomically set the shuttingDown flag of every partition, but just return if another
+    // thread was first. The first partition decides which thread that is.
+    for (size_t i = 0; i < _partitions.size(); ++i) {
+        auto& shuttingDownFlag = _partitions[i].shuttingDown;
+        uint32_t actual = shuttingDownFlag.load();
+        uint32_t expected;
+        do {
+            expected = actual;
+            actual = shuttingDownFlag.compareAndSwap(expected, expected | kShuttingDownMask);
+            if (i == 0 && (actual & kShuttingDownMask))
+                return;
+        } while (actual != expected && !(actual & kShuttingDownMask));
+    }
 
     // Spin as long as there are threads in releaseSession
-    while (_shuttingDown.load() != kShuttingDownMask) {
-        sleepmillis(1);
+    for (auto&& partition : _partitions) {
+        while (partition.shuttingDown.load() != kShuttingDownMask) {
+            sleepmillis(1);
+        }
     }
 
     closeAll();
@@ -261,8 +314,9 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
-    const int shuttingDown = _shuttingDown.fetchAndAdd(1);
-    ON_BLOCK_EXIT([this] { _shuttingDown.fetchAndSubtract(1); });
+    auto& partition = _getPartition();
+    const int shuttingDown = partition.shuttingDown.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&partition] { partition.shuttingDown.fetchAndSubtract(1); });
 
     uassert(ErrorCodes::ShutdownInProgress,
             "Cannot wait for durability because a shutdown is in progress",
@@ -293,6 +347,16 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
+    // Register as a waiter before reading '_lastSyncTime', so that a thread which closes its group
+    // commit window because of us is guaranteed to flush our writes.
+    _durabilityWaiters.fetchAndAdd(1);
+    ON_BLOCK_EXIT([this] { _durabilityWaiters.fetchAndSubtract(1); });
+    const int groupCommitWindowMicros = wiredTigerGroupCommitWindowMicros.load();
+    if (groupCommitWindowMicros > 0) {
+        stdx::lock_guard<stdx::mutex> gclk(_groupCommitMutex);
+        _groupCommitCond.notify_all();
+    }
+
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -302,7 +366,21 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         // Someone else synced already since we read lastSyncTime, so we're done!
         return;
     }
+
+    // Give other threads a chance to join this flush. They read '_lastSyncTime' before it is
+    // bumped below, so they return as soon as they get the lock after the flush.
+    if (groupCommitWindowMicros > 0) {
+        const uint32_t maxWaiters = wiredTigerGroupCommitMaxWaiters.load();
+        stdx::unique_lock<stdx::mutex> gclk(_groupCommitMutex);
+        _groupCommitCond.wait_for(
+            gclk, Microseconds(groupCommitWindowMicros).toSystemDuration(), [&] {
+                return _durabilityWaiters.load() >= maxWaiters;
+            });
+    }
+
     _lastSyncTime.store(current + 1);
+    groupCommitFlushes.increment();
+    groupCommitWaiters.increment(_durabilityWaiters.load());
 
     // Nobody has synched yet, so we have to sync ourselves.
 
@@ -311,6 +389,14 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
     stdx::unique_lock<stdx::mutex> jlk(_journalListenerMutex);
     JournalListener::Token token = _journalListener->getToken();
 
+    // If oplog visibility is waiting to be advanced, everything committed before this flush can
+    // be made visible as soon as it's done, rather than once the oplog journal thread gets to it.
+    WiredTigerOplogManager* oplogManager = _engine ? _engine->getOplogManager() : nullptr;
+    boost::optional<uint64_t> allCommitted;
+    if (oplogManager && oplogManager->isVisibilityUpdatePending()) {
+        allCommitted = oplogManager->fetchAllCommittedValue(_conn);
+    }
+
     // Initialize on first use.
     if (!_waitUntilDurableSession) {
         invariantWTOK(
@@ -326,31 +412,60 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         LOG(4) << "created checkpoint";
     }
     _journalListener->onDurable(token);
+
+    if (allCommitted) {
+        oplogManager->oplogWritesMadeDurable(*allCommitted);
+    }
+}
+
+uint64_t WiredTigerSessionCache::prepareConflictTableBit(const char* uri) {
+    // FNV-1a, which is cheap for the short uris of WiredTiger tables.
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char* c = uri; *c; ++c) {
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ULL;
+    }
+    return 1ULL << (hash % kNumPrepareConflictTableBits);
 }
 
-void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx) {
+uint64_t WiredTigerSessionCache::getPrepareCommitOrAbortCount(uint64_t tableBit) const {
+    return _prepareCommitOrAbortCounters[countTrailingZeros64(tableBit)].load();
+}
+
+void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
+                                                                        uint64_t tableBit,
+                                                                        uint64_t lastCount) {
     invariant(opCtx);
+    const auto index = countTrailingZeros64(tableBit);
     stdx::unique_lock<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
-
-    auto lastCounter = _lastCommitOrAbortCounter;
-    opCtx->waitForConditionOrInterrupt(_prepareCommittedOrAbortedCond, lk, [&] {
-        return lastCounter != _lastCommitOrAbortCounter;
+    opCtx->waitForConditionOrInterrupt(_prepareCommittedOrAbortedConds[index], lk, [&] {
+        return lastCount != _prepareCommitOrAbortCounters[index].load();
     });
 }
 
-void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
+void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted(uint64_t tableBits) {
+    if (!tableBits) {
+        tableBits = ~0ULL;
+    }
+
     {
         stdx::unique_lock<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
-        _lastCommitOrAbortCounter++;
+        for (uint64_t bits = tableBits; bits; bits &= bits - 1) {
+            _prepareCommitOrAbortCounters[countTrailingZeros64(bits)].fetchAndAdd(1);
+        }
+    }
+    for (uint64_t bits = tableBits; bits; bits &= bits - 1) {
+        _prepareCommittedOrAbortedConds[countTrailingZeros64(bits)].notify_all();
     }
-    _prepareCommittedOrAbortedCond.notify_all();
 }
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.cacheLock);
+        for (SessionCache::iterator i = partition.sessions.begin(); i != partition.sessions.end();
+             i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -358,9 +473,12 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.cacheLock);
+        for (SessionCache::iterator i = partition.sessions.begin(); i != partition.sessions.end();
+             i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
@@ -368,10 +486,13 @@ void WiredTigerSessionCache::closeAll() {
     // Increment the epoch as we are now closing all sessions with this epoch.
     SessionCache swap;
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    // Sessions released into a partition from now on see the new epoch under its lock, and are
+    // deleted instead of cached.
+    _epoch.fetchAndAdd(1);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.cacheLock);
+        swap.insert(swap.end(), partition.sessions.begin(), partition.sessions.end());
+        partition.sessions.clear();
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -384,17 +505,29 @@ bool WiredTigerSessionCache::isEphemeral() {
 }
 
 UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
-    // We should never be able to get here after _shuttingDown is set, because no new
+    // We should never be able to get here after shuttingDown is set, because no new
     // operations should be allowed to start.
-    invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
+    auto& ownPartition = _getPartition();
+    invariant(!(ownPartition.shuttingDown.loadRelaxed() & kShuttingDownMask));
 
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+        stdx::lock_guard<stdx::mutex> lock(ownPartition.cacheLock);
+        if (!ownPartition.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = ownPartition.sessions.back();
+            ownPartition.sessions.pop_back();
+            return UniqueWiredTigerSession(cachedSession);
+        }
+    }
+
+    // Take a session released by a thread of another partition rather than opening a new one, but
+    // skip the partitions other threads are using right now.
+    for (auto&& partition : _partitions) {
+        stdx::unique_lock<stdx::mutex> lock(partition.cacheLock, stdx::try_to_lock);
+        if (lock && !partition.sessions.empty()) {
+            WiredTigerSession* cachedSession = partition.sessions.back();
+            partition.sessions.pop_back();
             return UniqueWiredTigerSession(cachedSession);
         }
     }
@@ -408,8 +541,9 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     invariant(session);
     invariant(session->cursorsOut() == 0);
 
-    const int shuttingDown = _shuttingDown.fetchAndAdd(1);
-    ON_BLOCK_EXIT([this] { _shuttingDown.fetchAndSubtract(1); });
+    auto& partition = _getPartition();
+    const int shuttingDown = partition.shuttingDown.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&partition] { partition.shuttingDown.fetchAndSubtract(1); });
 
     if (shuttingDown & kShuttingDownMask) {
         // There is a race condition with clean shutdown, where the storage engine is ripped from
@@ -453,10 +587,10 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->dropQueuedIdentsAtSessionEndAllowed(true);
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        stdx::lock_guard<stdx::mutex> lock(partition.cacheLock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -469,6 +603,13 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 }
 
 
+WiredTigerSessionCache::Partition& WiredTigerSessionCache::_getPartition() {
+    // Threads are assigned partitions round-robin, the first time they use a session cache.
+    static AtomicUInt32 nextThreadPartition;
+    static thread_local const uint32_t threadPartition = nextThreadPartition.fetchAndAdd(1);
+    return _partitions[threadPartition % _partitions.size()];
+}
+
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
     _journalListener = jl;
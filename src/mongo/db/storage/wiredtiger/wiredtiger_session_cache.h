@@ -31,9 +31,12 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <string>
+#include <vector>
 
+#include <boost/align/aligned_allocator.hpp>
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
@@ -41,6 +44,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -150,6 +154,18 @@ public:
 
     static uint64_t genTableId();
 
+    /**
+     * Returns the tables this session has opened cursors on since the last call to
+     * resetTablesUsed(), as a mask of WiredTigerSessionCache::prepareConflictTableBit() values.
+     */
+    uint64_t getTablesUsed() const {
+        return _tablesUsed;
+    }
+
+    void resetTablesUsed() {
+        _tablesUsed = 0;
+    }
+
     /**
      * For "metadata:" cursors. Guaranteed never to collide with genTableId() ids.
      */
@@ -178,6 +194,7 @@ private:
     CursorCache _cursors;            // owned
     uint64_t _cursorGen;
     int _cursorsOut;
+    uint64_t _tablesUsed = 0;
     bool _dropQueuedIdentsAtSessionEnd = true;
 };
 
@@ -244,10 +261,27 @@ public:
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
     /**
-     * Waits until a prepared unit of work has ended (either been commited or aborted). This
-     * should be used when encountering WT_PREPARE_CONFLICT errors. The caller is required to retry
-     * the conflicting WiredTiger API operation. A return from this function does not guarantee that
-     * the conflicting transaction has ended, only that one prepared unit of work in the process has
+     * Returns the bit which stands for the table 'uri' in the masks passed to
+     * notifyPreparedUnitOfWorkHasCommittedOrAborted(). Unrelated tables may share a bit.
+     */
+    static uint64_t prepareConflictTableBit(const char* uri);
+
+    /**
+     * Returns a counter which changes every time a prepared unit of work which may have written to
+     * a table with bit 'tableBit' commits or aborts. Read it before the WiredTiger API operation
+     * that may return WT_PREPARE_CONFLICT and pass it to
+     * waitUntilPreparedUnitOfWorkCommitsOrAborts(), so that a prepared unit of work which ends
+     * between the conflict and the wait is not missed.
+     */
+    uint64_t getPrepareCommitOrAbortCount(uint64_t tableBit) const;
+
+    /**
+     * Waits until a prepared unit of work which may have written to a table with bit 'tableBit'
+     * has ended (either been commited or aborted) since the counter returned by
+     * getPrepareCommitOrAbortCount() was 'lastCount'. This should be used when encountering
+     * WT_PREPARE_CONFLICT errors. The caller is required to retry the conflicting WiredTiger API
+     * operation. A return from this function does not guarantee that the conflicting transaction
+     * has ended, only that one prepared unit of work which may have touched the same table has
      * signaled that it has ended.
      * Accepts an OperationContext that will throw an AssertionException when interrupted.
      *
@@ -255,13 +289,15 @@ public:
      * units share the same session cache, and we want a recovery unit on one thread to signal all
      * recovery units waiting for prepare conflicts across all other threads.
      */
-    void waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx);
+    void waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
+                                                    uint64_t tableBit,
+                                                    uint64_t lastCount);
 
     /**
-     * Notifies waiters that the caller's perpared unit of work has ended (either committed or
-     * aborted).
+     * Notifies waiters on the tables in 'tableBits' that the caller's perpared unit of work has
+     * ended (either committed or aborted). A 'tableBits' of 0 notifies the waiters on all tables.
      */
-    void notifyPreparedUnitOfWorkHasCommittedOrAborted();
+    void notifyPreparedUnitOfWorkHasCommittedOrAborted(uint64_t tableBits);
 
     WT_CONNECTION* conn() const {
         return _conn;
@@ -289,17 +325,30 @@ private:
     WT_CONNECTION* _conn;         // not owned
     WiredTigerSnapshotManager _snapshotManager;
 
-    // Used as follows:
-    //   The low 31 bits are a count of active calls to releaseSession.
-    //   The high bit is a flag that is set if and only if we're shutting down.
-    AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
 
-    // Bumped when all open sessions need to be closed
+    /**
+     * The released sessions are cached in several partitions, so that threads getting and
+     * releasing sessions at the same time mostly lock different mutexes. Each thread releases its
+     * sessions into the partition it is assigned to, and gets sessions from that partition first.
+     */
+    struct Partition {
+        // Used as follows:
+        //   The low 31 bits are a count of active calls to releaseSession into this partition.
+        //   The high bit is a flag that is set if and only if we're shutting down.
+        AtomicUInt32 shuttingDown{0};
+
+        stdx::mutex cacheLock;
+        SessionCache sessions;
+    };
+    using CacheAlignedPartition = CacheAligned<Partition>;
+    std::vector<CacheAlignedPartition, boost::alignment::aligned_allocator<CacheAlignedPartition>>
+        _partitions;
+
+    // Bumped when all open sessions need to be closed. Sessions from an older epoch are not
+    // cached when released, so closeAll only needs each partition's lock to empty it.
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
 
     // Bumped when all open cursors need to be closed
@@ -309,10 +358,22 @@ private:
     AtomicUInt32 _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
-    // Mutex and cond var for waiting on prepare commit or abort.
+    // The number of threads waiting for their writes to become durable, which lets a group commit
+    // close its window early once enough of them have joined. '_groupCommitCond' is notified
+    // under '_groupCommitMutex' when the count goes up.
+    AtomicUInt32 _durabilityWaiters;
+    stdx::mutex _groupCommitMutex;
+    stdx::condition_variable _groupCommitCond;
+
+    // Mutex, cond vars and counters for waiting on prepare commit or abort. There is one cond var
+    // and counter per table bit, so that the end of a prepared unit of work only wakes the readers
+    // which conflicted on a table it may have written to. The counters are only incremented with
+    // the mutex held, but are read without it.
+    static constexpr size_t kNumPrepareConflictTableBits = 64;
     stdx::mutex _prepareCommittedOrAbortedMutex;
-    stdx::condition_variable _prepareCommittedOrAbortedCond;
-    std::uint64_t _lastCommitOrAbortCounter;
+    std::array<stdx::condition_variable, kNumPrepareConflictTableBits>
+        _prepareCommittedOrAbortedConds;
+    std::array<AtomicUInt64, kNumPrepareConflictTableBits> _prepareCommitOrAbortCounters;
 
     // Protects _journalListener.
     stdx::mutex _journalListenerMutex;
@@ -322,6 +383,11 @@ private:
     WT_SESSION* _waitUntilDurableSession = nullptr;  // owned, and never explicitly closed
                                                      // (uses connection close to clean up)
 
+    /**
+     * Returns the partition of the calling thread.
+     */
+    Partition& _getPartition();
+
     /**
      * Returns a session to the cache for later reuse. If closeAll was called between getting this
      * session and releasing it, the session is directly released. This method is thread safe.
@@ -33,10 +33,14 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -48,6 +52,19 @@
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
+namespace {
+
+// The number of size entries written by each transaction of a flush. The cursor is released between
+// batches, so loads of sizes which are not buffered wait for at most one batch.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerSizeStorerFlushBatchSize, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue, "wiredTigerSizeStorerFlushBatchSize must be >= 1");
+        }
+        return Status::OK();
+    });
+
+}  // namespace
 
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn,
                                            const std::string& storageUri,
@@ -76,8 +93,9 @@ void WiredTigerSizeStorer::store(StringData uri, std::shared_ptr<SizeInfo> sizeI
         return;
 
     // Ordering is important: as the entry may be flushed concurrently, set the dirty flag last.
-    stdx::lock_guard<stdx::mutex> lk(_bufferMutex);
-    auto& entry = _buffer[uri];
+    auto& partition = _partitionFor(uri);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto& entry = partition.buffer[uri];
     // During rollback it is possible to get a new SizeInfo. In that case clear the dirty flag,
     // so the SizeInfo can be destructed without triggering the dirty check invariant.
     if (entry && entry.get() != sizeInfo.get())
@@ -92,9 +110,10 @@ void WiredTigerSizeStorer::store(StringData uri, std::shared_ptr<SizeInfo> sizeI
 std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(StringData uri) const {
     {
         // Check if we can satisfy the read from the buffer.
-        stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
-        Buffer::const_iterator it = _buffer.find(uri);
-        if (it != _buffer.end())
+        auto& partition = _partitionFor(uri);
+        stdx::lock_guard<stdx::mutex> bufferLock(partition.mutex);
+        Buffer::const_iterator it = partition.buffer.find(uri);
+        if (it != partition.buffer.end())
             return it->second;
     }
 
@@ -121,46 +140,67 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
     auto result = std::make_shared<SizeInfo>();
     result->numRecords.store(data["numRecords"].safeNumberLong());
     result->dataSize.store(data["dataSize"].safeNumberLong());
+    if (data["oplogStones"].type() == BSONType::Array) {
+        result->setOplogStones(data["oplogStones"].Obj().getOwned());
+    }
     return result;
 }
 
 void WiredTigerSizeStorer::flush(bool syncToDisk) {
-    Buffer buffer;
-    {
-        stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
-        _buffer.swap(buffer);
+    std::vector<std::pair<std::string, std::shared_ptr<SizeInfo>>> entries;
+    for (auto&& partition : _partitions) {
+        Buffer buffer;
+        {
+            stdx::lock_guard<stdx::mutex> bufferLock(partition.mutex);
+            partition.buffer.swap(buffer);
+        }
+        for (auto& it : buffer)
+            entries.emplace_back(it.first, std::move(it.second));
     }
 
-    if (buffer.empty())
+    if (entries.empty())
         return;  // Nothing to do.
 
     Timer t;
-    stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
-    {
-        // On failure, place entries back into the map, unless a newer value already exists.
-        ON_BLOCK_EXIT([this, &buffer]() {
-            this->_cursor->reset(this->_cursor);
-            if (!buffer.empty()) {
-                stdx::lock_guard<stdx::mutex> bufferLock(this->_bufferMutex);
-                for (auto& it : buffer)
-                    this->_buffer.try_emplace(it.first, it.second);
-            }
-        });
+    const size_t batchSize = wiredTigerSizeStorerFlushBatchSize.load();
+    size_t numFlushed = 0;
+
+    // On failure, place the entries not yet written back into the buffer, unless a newer value
+    // already exists.
+    ON_BLOCK_EXIT([this, &entries, &numFlushed]() {
+        for (size_t i = numFlushed; i < entries.size(); ++i) {
+            auto& partition = _partitionFor(entries[i].first);
+            stdx::lock_guard<stdx::mutex> bufferLock(partition.mutex);
+            partition.buffer.try_emplace(entries[i].first, entries[i].second);
+        }
+    });
+
+    while (numFlushed < entries.size()) {
+        const size_t batchEnd = std::min(entries.size(), numFlushed + batchSize);
+
+        stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
+        ON_BLOCK_EXIT([this]() { this->_cursor->reset(this->_cursor); });
 
         WT_SESSION* session = _session.getSession();
         WiredTigerBeginTxnBlock txnOpen(session, syncToDisk ? "sync=true" : nullptr);
 
-        for (auto it = buffer.begin(); it != buffer.end(); ++it) {
+        for (size_t i = numFlushed; i < batchEnd; ++i) {
 
             // Ordering is important here: when the store method checks if the SizeInfo
             // is dirty and it returns true, the current values of numRecords and dataSize must
             // still be written back. So, the required order is to clear the dirty flag first.
-            SizeInfo& sizeInfo = *it->second;
+            SizeInfo& sizeInfo = *entries[i].second;
             sizeInfo._dirty.store(false);
-            BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
-                                             << sizeInfo.dataSize.load());
+            BSONObjBuilder dataBuilder;
+            dataBuilder.append("numRecords", sizeInfo.numRecords.load());
+            dataBuilder.append("dataSize", sizeInfo.dataSize.load());
+            BSONObj oplogStones = sizeInfo.getOplogStones();
+            if (!oplogStones.isEmpty()) {
+                dataBuilder.appendArray("oplogStones", oplogStones);
+            }
+            BSONObj data = dataBuilder.obj();
 
-            auto& uri = it->first;
+            auto& uri = entries[i].first;
             LOG(2) << "WiredTigerSizeStorer::flush " << uri << " -> " << redact(data);
             WiredTigerItem key(uri.c_str(), uri.size());
             WiredTigerItem value(data.objdata(), data.objsize());
@@ -170,10 +210,15 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
         }
         txnOpen.done();
         invariantWTOK(session->commit_transaction(session, nullptr));
-        buffer.clear();
+        numFlushed = batchEnd;
     }
 
     auto micros = t.micros();
-    LOG(2) << "WiredTigerSizeStorer flush took " << micros << " µs";
+    LOG(2) << "WiredTigerSizeStorer flush of " << entries.size() << " entries took " << micros
+           << " µs";
+}
+
+WiredTigerSizeStorer::BufferPartition& WiredTigerSizeStorer::_partitionFor(StringData uri) const {
+    return _partitions[StringMapTraits::hash(uri) % _partitions.size()];
 }
 }  // namespace mongo
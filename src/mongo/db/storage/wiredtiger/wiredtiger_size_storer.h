@@ -31,11 +31,13 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 
 #include <wiredtiger.h>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
@@ -46,13 +48,17 @@ namespace mongo {
 /**
  * The WiredTigerSizeStorer class serves as a write buffer to durably store size information for
  * MongoDB collections. The size storer uses a separate WiredTiger table as key-value store, where
- * the URI serves as key and the value is a BSON document with `numRecords` and `dataSize` fields.
+ * the URI serves as key and the value is a BSON document with `numRecords` and `dataSize` fields,
+ * and an `oplogStones` field for the oplog.
  * This buffering is neccessary to allow concurrent updates of size information without causing
  * write conflicts. The dirty size information is periodically stored written back to the table,
  * including on clean shutdown and/or catalog reload. Crashes or replica-set fail-overs may result
  * in size updates to be lost, so size information is only approximate. Reads use the buffer for
  * pending stores, or otherwise read directly from the WiredTiger table using a dedicated session
  * and cursor.
+ * The buffer is partitioned by URI so that updates to different collections rarely contend, and it
+ * is written back in bounded batches, each in its own transaction, so that reads from the table
+ * are not held up for the duration of a large flush.
  */
 class WiredTigerSizeStorer {
 public:
@@ -70,9 +76,25 @@ public:
         AtomicInt64 numRecords;
         AtomicInt64 dataSize;
 
+        /**
+         * The oplog stones of an oplog, as an array of {records, bytes, lastRecord} objects from
+         * the oldest stone to the newest. Empty for other collections.
+         */
+        BSONObj getOplogStones() const {
+            stdx::lock_guard<stdx::mutex> lk(_oplogStonesMutex);
+            return _oplogStones;
+        }
+        void setOplogStones(BSONObj oplogStones) {
+            stdx::lock_guard<stdx::mutex> lk(_oplogStonesMutex);
+            _oplogStones = std::move(oplogStones);
+        }
+
     private:
         friend WiredTigerSizeStorer;
         AtomicBool _dirty;
+
+        mutable stdx::mutex _oplogStonesMutex;  // Guards _oplogStones
+        BSONObj _oplogStones;
     };
 
     WiredTigerSizeStorer(WT_CONNECTION* conn,
@@ -89,20 +111,27 @@ public:
     std::shared_ptr<SizeInfo> load(StringData uri) const;
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table, in batches of at most
+     * wiredTigerSizeStorerFlushBatchSize entries.
      */
     void flush(bool syncToDisk);
 
 private:
+    using Buffer = StringMap<std::shared_ptr<SizeInfo>>;
+
+    struct BufferPartition {
+        stdx::mutex mutex;  // Guards buffer
+        Buffer buffer;
+    };
+
+    BufferPartition& _partitionFor(StringData uri) const;
+
     const WiredTigerSession _session;
     const bool _readOnly;
-    // Guards _cursor. Acquire *before* _bufferMutex.
+    // Guards _cursor. Never acquired while holding the mutex of a BufferPartition.
     mutable stdx::mutex _cursorMutex;
     WT_CURSOR* _cursor;  // pointer is const after constructor
 
-    using Buffer = StringMap<std::shared_ptr<SizeInfo>>;
-
-    mutable stdx::mutex _bufferMutex;  // Guards _buffer
-    Buffer _buffer;
+    mutable std::array<BufferPartition, 16> _partitions;
 };
 }
@@ -42,10 +42,12 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
@@ -209,6 +211,25 @@ TEST(WiredTigerRecordStoreTest, StorageSizeStatisticsDisabled) {
     ASSERT_THROWS(rs->storageSize(opCtx.get()), AssertionException);
 }
 
+TEST(WiredTigerRecordStoreTest, OplogBlockCompressorOnlyAppliesToTheOplog) {
+    const auto originalCompressor = wiredTigerGlobalOptions.oplogBlockCompressor;
+    ON_BLOCK_EXIT([&] { wiredTigerGlobalOptions.oplogBlockCompressor = originalCompressor; });
+    wiredTigerGlobalOptions.oplogBlockCompressor = "zlib";
+
+    CollectionOptions options;
+    auto oplogConfig = WiredTigerRecordStore::generateCreateString(
+        kWiredTigerEngineName, "local.oplog.rs", options, "", false);
+    ASSERT_OK(oplogConfig.getStatus());
+    ASSERT_STRING_CONTAINS(oplogConfig.getValue(), "block_compressor=zlib,");
+
+    auto collectionConfig = WiredTigerRecordStore::generateCreateString(
+        kWiredTigerEngineName, "a.b", options, "", false);
+    ASSERT_OK(collectionConfig.getStatus());
+    ASSERT_STRING_CONTAINS(collectionConfig.getValue(),
+                           "block_compressor=" +
+                               wiredTigerGlobalOptions.collectionBlockCompressor + ",");
+}
+
 TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -294,6 +315,76 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(nullptr);  // this has to be deleted before ss
 }
 
+TEST(WiredTigerRecordStoreTest, SizeStorerPersistsOplogStones) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    string sizeStorerUri = "table:sizeStorer";
+    string uri = "table:oplog";
+
+    BSONObj oplogStones = BSON_ARRAY(BSON("records" << 10 << "bytes" << 1000 << "lastRecord" << 5)
+                                     << BSON("records" << 12 << "bytes" << 1100 << "lastRecord"
+                                                       << 9));
+    {
+        WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri);
+        auto info = std::make_shared<WiredTigerSizeStorer::SizeInfo>();
+        info->numRecords.store(30);
+        info->dataSize.store(2800);
+        info->setOplogStones(oplogStones);
+        ss.store(uri, info);
+        ss.flush(true);
+    }
+
+    {
+        WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri);
+        auto info = ss.load(uri);
+        ASSERT_EQUALS(30, info->numRecords.load());
+        ASSERT_EQUALS(2800, info->dataSize.load());
+        ASSERT_BSONOBJ_EQ(oplogStones, info->getOplogStones());
+
+        // Once there are no stones left, they are no longer written back.
+        info->setOplogStones(BSONObj());
+        ss.store(uri, info);
+        ss.flush(true);
+    }
+
+    {
+        WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri);
+        ASSERT_BSONOBJ_EQ(BSONObj(), ss.load(uri)->getOplogStones());
+    }
+}
+
+TEST(WiredTigerRecordStoreTest, SizeStorerFlushesInBatches) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    string sizeStorerUri = "table:sizeStorer";
+
+    auto batchSizeParam =
+        ServerParameterSet::getGlobal()->getMap().find("wiredTigerSizeStorerFlushBatchSize");
+    ASSERT(batchSizeParam != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(batchSizeParam->second->setFromString("3"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(batchSizeParam->second->setFromString("1000")); });
+
+    // Ten entries take four batches, the last of which is not full.
+    const int numCollections = 10;
+    {
+        WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri);
+        for (int i = 0; i < numCollections; i++) {
+            auto info = std::make_shared<WiredTigerSizeStorer::SizeInfo>();
+            info->numRecords.store(i);
+            info->dataSize.store(i * 100);
+            ss.store(str::stream() << "table:coll" << i, info);
+        }
+        ss.flush(true);
+    }
+
+    {
+        WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri);
+        for (int i = 0; i < numCollections; i++) {
+            auto info = ss.load(str::stream() << "table:coll" << i);
+            ASSERT_EQUALS(i, info->numRecords.load());
+            ASSERT_EQUALS(i * 100, info->dataSize.load());
+        }
+    }
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+
+#include <algorithm>
+
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+WiredTigerTicketTuner::WiredTigerTicketTuner(TicketHolder* holder)
+    : _holder(holder),
+      _lastQueuedWaits(holder->queuedWaits()),
+      _lastQueuedMicros(holder->queuedMicros()) {}
+
+int WiredTigerTicketTuner::adjust(const Limits& limits, bool cacheUnderPressure) {
+    const long long queuedWaits = _holder->queuedWaits();
+    const long long queuedMicros = _holder->queuedMicros();
+    const long long newWaits = queuedWaits - _lastQueuedWaits;
+    const long long newMicros = queuedMicros - _lastQueuedMicros;
+    _lastQueuedWaits = queuedWaits;
+    _lastQueuedMicros = queuedMicros;
+
+    const int current = _holder->outof();
+    int target = current;
+    if (cacheUnderPressure) {
+        target = current - std::max(1, current / 4);
+    } else if (newWaits > 0 && newMicros / newWaits >= limits.targetQueueLatency.count()) {
+        target = current + std::max(1, current / 8);
+    }
+    // Only move towards the limits, so that a ticket count set by hand outside of them is left
+    // alone until the load asks for a change in the other direction.
+    if (target > current) {
+        target = std::min(target, std::max(current, limits.maxTickets));
+    } else if (target < current) {
+        target = std::max(target, std::min(current, limits.minTickets));
+    }
+    if (target == current) {
+        return current;
+    }
+
+    Status status = _holder->resize(target);
+    if (!status.isOK()) {
+        warning() << "Failed to resize tickets from " << current << " to " << target << ": "
+                  << status;
+        return current;
+    }
+
+    LOG(1) << "Adjusted tickets from " << current << " to " << target
+           << (cacheUnderPressure ? " under cache pressure" : "") << ", " << newWaits
+           << " queued waits took " << newMicros << " micros";
+    (target > current ? _increases : _decreases).fetchAndAdd(1);
+    _lastAdjustmentMillis.store(Date_t::now().toMillisSinceEpoch());
+    return target;
+}
+
+void WiredTigerTicketTuner::appendStats(BSONObjBuilder* builder) const {
+    builder->append("increases", _increases.load());
+    builder->append("decreases", _decreases.load());
+    builder->appendDate("lastAdjustment",
+                        Date_t::fromMillisSinceEpoch(_lastAdjustmentMillis.load()));
+}
+
+}  // namespace mongo
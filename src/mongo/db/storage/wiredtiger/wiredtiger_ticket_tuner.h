@@ -0,0 +1,81 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class TicketHolder;
+
+/**
+ * Adapts the number of tickets of a TicketHolder to the latency operations see waiting for them.
+ * Each call to adjust() looks at the waits since the previous call. The ticket count grows by an
+ * eighth when operations queued for longer than the target latency on average, as there is more
+ * work than tickets then. It shrinks by a quarter while the storage engine is under cache
+ * pressure, as more concurrent operations would only wait on eviction. Operations which must not
+ * be starved when the count is low, like replication, should not take tickets at all.
+ *
+ * adjust() must only be called from one thread at a time, appendStats() may be called concurrently.
+ */
+class WiredTigerTicketTuner {
+public:
+    struct Limits {
+        int minTickets;
+        int maxTickets;
+        Microseconds targetQueueLatency;
+    };
+
+    explicit WiredTigerTicketTuner(TicketHolder* holder);
+
+    /**
+     * Resizes the holder if its load since the last call asks for it, within 'limits'. Returns
+     * the new number of tickets. May block while shrinking until enough tickets are released.
+     */
+    int adjust(const Limits& limits, bool cacheUnderPressure);
+
+    /**
+     * Appends the number of increases and decreases so far and the time of the last one.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    TicketHolder* const _holder;
+
+    long long _lastQueuedWaits;
+    long long _lastQueuedMicros;
+
+    AtomicInt64 _increases;
+    AtomicInt64 _decreases;
+    AtomicInt64 _lastAdjustmentMillis;
+};
+
+}  // namespace mongo
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticketholder.h"
+
+namespace mongo {
+namespace {
+
+const WiredTigerTicketTuner::Limits kLimits{8, 64, Microseconds(1000)};
+
+/**
+ * Takes every ticket of 'holder' and then waits in vain for one more, which counts as a queued
+ * wait of about 'wait'.
+ */
+void queueOnExhaustedHolder(TicketHolder* holder, Milliseconds wait) {
+    const int tickets = holder->outof();
+    for (int i = 0; i < tickets; ++i) {
+        ASSERT(holder->tryAcquire());
+    }
+    ASSERT_FALSE(holder->waitForTicketUntil(Date_t::now() + wait));
+    for (int i = 0; i < tickets; ++i) {
+        holder->release();
+    }
+}
+
+TEST(WiredTigerTicketTunerTest, KeepsTicketsWithoutQueueing) {
+    TicketHolder holder(16);
+    WiredTigerTicketTuner tuner(&holder);
+    ASSERT_EQ(16, tuner.adjust(kLimits, false));
+    ASSERT_EQ(16, holder.outof());
+}
+
+TEST(WiredTigerTicketTunerTest, AddsTicketsWhenOperationsQueueTooLong) {
+    TicketHolder holder(16);
+    WiredTigerTicketTuner tuner(&holder);
+    queueOnExhaustedHolder(&holder, Milliseconds(10));
+    ASSERT_EQ(18, tuner.adjust(kLimits, false));
+    ASSERT_EQ(18, holder.outof());
+
+    // The queued wait has been accounted for.
+    ASSERT_EQ(18, tuner.adjust(kLimits, false));
+}
+
+TEST(WiredTigerTicketTunerTest, RemovesTicketsUnderCachePressure) {
+    TicketHolder holder(16);
+    WiredTigerTicketTuner tuner(&holder);
+    queueOnExhaustedHolder(&holder, Milliseconds(10));
+    ASSERT_EQ(12, tuner.adjust(kLimits, true));
+    ASSERT_EQ(12, holder.outof());
+    ASSERT_EQ(9, tuner.adjust(kLimits, true));
+    ASSERT_EQ(8, tuner.adjust(kLimits, true));
+    ASSERT_EQ(8, tuner.adjust(kLimits, true));
+}
+
+TEST(WiredTigerTicketTunerTest, LeavesTicketsSetAboveTheLimitAlone) {
+    TicketHolder holder(128);
+    WiredTigerTicketTuner tuner(&holder);
+    queueOnExhaustedHolder(&holder, Milliseconds(10));
+    ASSERT_EQ(128, tuner.adjust(kLimits, false));
+    ASSERT_EQ(96, tuner.adjust(kLimits, true));
+}
+
+TEST(WiredTigerTicketTunerTest, CountsAdjustments) {
+    TicketHolder holder(16);
+    WiredTigerTicketTuner tuner(&holder);
+    queueOnExhaustedHolder(&holder, Milliseconds(10));
+    tuner.adjust(kLimits, false);
+    tuner.adjust(kLimits, true);
+    tuner.adjust(kLimits, true);
+
+    BSONObjBuilder builder;
+    tuner.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(1, stats["increases"].numberLong());
+    ASSERT_EQ(2, stats["decreases"].numberLong());
+    ASSERT_GT(stats["lastAdjustment"].Date(), Date_t());
+}
+
+}  // namespace
+}  // namespace mongo
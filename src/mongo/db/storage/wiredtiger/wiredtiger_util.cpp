@@ -526,6 +526,24 @@ int WiredTigerUtil::verifyTable(OperationContext* opCtx,
     return (session->verify)(session, uri.c_str(), NULL);
 }
 
+Status WiredTigerUtil::compactTable(OperationContext* opCtx,
+                                    const std::string& uri,
+                                    Seconds timeout) {
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    const std::string config = str::stream() << "timeout=" << durationCount<Seconds>(timeout);
+    int ret = session->compact(session, uri.c_str(), config.c_str());
+    if (timeout > Seconds(0) && (ret == ETIMEDOUT || ret == EBUSY)) {
+        return {ErrorCodes::ExceededTimeLimit,
+                str::stream() << "compaction of " << uri << " did not finish within " << timeout
+                              << ": "
+                              << wiredtiger_strerror(ret)};
+    }
+    invariantWTOK(ret);
+    return Status::OK();
+}
+
 bool WiredTigerUtil::useTableLogging(NamespaceString ns, bool replEnabled) {
     if (!replEnabled) {
         // All tables on standalones are logged.
@@ -39,6 +39,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -265,6 +266,13 @@ public:
                            const std::string& uri,
                            std::vector<std::string>* errors = NULL);
 
+    /**
+     * Calls WT_SESSION::compact() on the table, abandoning the current snapshot first. A non-zero
+     * 'timeout' bounds the time spent; if compaction has not finished by then, or the table is
+     * busy, ExceededTimeLimit is returned and compaction may be resumed by calling this again.
+     */
+    static Status compactTable(OperationContext* opCtx, const std::string& uri, Seconds timeout);
+
     static bool useTableLogging(NamespaceString ns, bool replEnabled);
 
 private:
@@ -40,6 +40,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 
@@ -360,4 +361,42 @@ TEST(WiredTigerUtilTest, GetStatisticsValueAsUInt8) {
     ASSERT_EQUALS(static_cast<uint8_t>(100), resultInt16.getValue());
 }
 
+TEST(WiredTigerSessionCacheTest, ReusesSessionReleasedOnAnotherThread) {
+    WiredTigerUtilHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    WiredTigerSession* releasedSession = nullptr;
+    stdx::thread([&] {
+        auto session = sessionCache->getSession();
+        releasedSession = session.get();
+    }).join();
+
+    // The other thread may have released its session into another partition of the cache.
+    auto session = sessionCache->getSession();
+    ASSERT_EQUALS(releasedSession, session.get());
+}
+
+TEST(WiredTigerSessionCacheTest, CloseAllFreesSessionsOfEveryThread) {
+    WiredTigerUtilHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    auto outstandingSession = sessionCache->getSession();
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] { sessionCache->getSession(); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    sessionCache->closeAll();
+
+    // A session from before closeAll() is freed rather than cached once released, and new
+    // sessions can still be opened.
+    outstandingSession.reset();
+    auto session = sessionCache->getSession();
+    ASSERT(session->getSession());
+    ASSERT_EQUALS(0, session->cachedCursors());
+}
+
 }  // namespace mongo
@@ -41,10 +41,16 @@ using Action = TransactionCoordinator::StateMachine::Action;
 using Event = TransactionCoordinator::StateMachine::Event;
 using State = TransactionCoordinator::StateMachine::State;
 
-Action TransactionCoordinator::recvCoordinateCommit(const std::set<ShardId>& participants) {
+Action TransactionCoordinator::recvCoordinateCommit(const std::set<ShardId>& participants,
+                                                    const std::set<ShardId>& readOnlyParticipants) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
-    _participantList.recordFullList(participants);
-    return _stateMachine.onEvent(std::move(lk), Event::kRecvParticipantList);
+    _participantList.recordFullList(participants, readOnlyParticipants);
+
+    // The votes may all have arrived before the list, or there may be no votes to wait for at all
+    // when the participants other than the ones voting are read-only.
+    auto event = (_participantList.allParticipantsVotedCommit()) ? Event::kRecvFinalParticipantList
+                                                                 : Event::kRecvParticipantList;
+    return _stateMachine.onEvent(std::move(lk), event);
 }
 
 Action TransactionCoordinator::recvVoteCommit(const ShardId& shardId, Timestamp prepareTimestamp) {
@@ -81,6 +87,12 @@ Future<TransactionCoordinator::StateMachine::State> TransactionCoordinator::wait
     return _stateMachine.waitForTransitionTo({State::kCommitted, State::kAborted});
 }
 
+Future<TransactionCoordinator::StateMachine::State> TransactionCoordinator::waitForDecision() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    return _stateMachine.waitForTransitionTo(
+        {State::kWaitingForCommitAcks, State::kCommitted, State::kAborted});
+}
+
 //
 // StateMachine
 //
@@ -103,12 +115,14 @@ const std::map<State, std::map<Event, TransactionCoordinator::StateMachine::Tran
             {Event::kRecvVoteAbort,         {Action::kSendAbort, State::kAborted}},
             {Event::kRecvVoteCommit,        {}},
             {Event::kRecvParticipantList,   {State::kWaitingForVotes}},
+            {Event::kRecvFinalParticipantList, {Action::kSendCommit, State::kWaitingForCommitAcks}},
             {Event::kRecvTryAbort,          {Action::kSendAbort, State::kAborted}},
         }},
         {State::kWaitingForVotes, {
             {Event::kRecvVoteAbort,         {Action::kSendAbort, State::kAborted}},
             {Event::kRecvVoteCommit,        {}},
             {Event::kRecvParticipantList,   {}},
+            {Event::kRecvFinalParticipantList, {Action::kSendCommit, State::kWaitingForCommitAcks}},
             {Event::kRecvFinalVoteCommit,   {Action::kSendCommit, State::kWaitingForCommitAcks}},
             {Event::kRecvTryAbort,          {Action::kSendAbort, State::kAborted}},
         }},
@@ -116,11 +130,13 @@ const std::map<State, std::map<Event, TransactionCoordinator::StateMachine::Tran
             {Event::kRecvVoteAbort,         {}},
             {Event::kRecvVoteCommit,        {}},
             {Event::kRecvParticipantList,   {}},
+            {Event::kRecvFinalParticipantList, {}},
             {Event::kRecvTryAbort,          {}},
         }},
         {State::kWaitingForCommitAcks, {
             {Event::kRecvVoteCommit,        {}},
             {Event::kRecvParticipantList,   {}},
+            {Event::kRecvFinalParticipantList, {}},
             {Event::kRecvFinalVoteCommit,   {Action::kSendCommit}},
             {Event::kRecvFinalCommitAck,    {State::kCommitted}},
             {Event::kRecvTryAbort,          {}},
@@ -128,6 +144,7 @@ const std::map<State, std::map<Event, TransactionCoordinator::StateMachine::Tran
         {State::kCommitted, {
             {Event::kRecvVoteCommit,        {}},
             {Event::kRecvParticipantList,   {}},
+            {Event::kRecvFinalParticipantList, {}},
             {Event::kRecvFinalVoteCommit,   {}},
             {Event::kRecvFinalCommitAck,    {}},
             {Event::kRecvTryAbort,          {}},
@@ -217,11 +234,25 @@ Future<State> TransactionCoordinator::StateMachine::waitForTransitionTo(
 //
 
 void TransactionCoordinator::ParticipantList::recordFullList(
-    const std::set<ShardId>& participants) {
+    const std::set<ShardId>& participants, const std::set<ShardId>& readOnlyParticipants) {
+    for (auto& shardId : readOnlyParticipants) {
+        uassert(ErrorCodes::InternalError,
+                str::stream() << "Transaction commit coordinator received a participant list with "
+                                 "read-only participant "
+                              << shardId
+                              << " missing from the list",
+                participants.find(shardId) != participants.end());
+    }
+
     if (!_fullListReceived) {
         for (auto& shardId : participants) {
             _recordParticipant(shardId);
         }
+        for (auto& shardId : readOnlyParticipants) {
+            auto& participant = _participants[shardId];
+            // A participant which was prepared anyway is committed like any other.
+            participant.readOnly = (participant.vote == Participant::Vote::kUnknown);
+        }
         _fullListReceived = true;
     }
     _validate(participants);
@@ -249,6 +280,13 @@ void TransactionCoordinator::ParticipantList::recordVoteCommit(const ShardId& sh
                       << " that previously voted to abort",
         participant.vote != Participant::Vote::kAbort);
 
+    uassert(
+        ErrorCodes::InternalError,
+        str::stream() << "Transaction commit coordinator received vote 'commit' from read-only "
+                         "participant "
+                      << shardId.toString(),
+        !participant.readOnly);
+
     if (participant.vote == Participant::Vote::kUnknown) {
         participant.vote = Participant::Vote::kCommit;
         participant.prepareTimestamp = prepareTimestamp;
@@ -303,7 +341,8 @@ bool TransactionCoordinator::ParticipantList::allParticipantsVotedCommit() const
     return _fullListReceived && std::all_of(_participants.begin(),
                                             _participants.end(),
                                             [](const std::pair<ShardId, Participant>& i) {
-                                                return i.second.vote == Participant::Vote::kCommit;
+                                                return i.second.readOnly ||
+                                                    i.second.vote == Participant::Vote::kCommit;
                                             });
 }
 
@@ -319,6 +358,9 @@ Timestamp TransactionCoordinator::ParticipantList::getHighestPrepareTimestamp()
     invariant(_fullListReceived);
     Timestamp highestPrepareTimestamp = Timestamp::min();
     for (const auto& participant : _participants) {
+        if (participant.second.readOnly) {
+            continue;
+        }
         invariant(participant.second.prepareTimestamp);
         if (*participant.second.prepareTimestamp > highestPrepareTimestamp) {
             highestPrepareTimestamp = *participant.second.prepareTimestamp;
@@ -330,7 +372,7 @@ Timestamp TransactionCoordinator::ParticipantList::getHighestPrepareTimestamp()
 std::set<ShardId> TransactionCoordinator::ParticipantList::getNonAckedCommitParticipants() const {
     std::set<ShardId> nonAckedCommitParticipants;
     for (const auto& kv : _participants) {
-        if (kv.second.ack != Participant::Ack::kCommit) {
+        if (kv.second.ack != Participant::Ack::kCommit && !kv.second.readOnly) {
             invariant(kv.second.ack == Participant::Ack::kNone);
             nonAckedCommitParticipants.insert(kv.first);
         }
@@ -338,6 +380,17 @@ std::set<ShardId> TransactionCoordinator::ParticipantList::getNonAckedCommitPart
     return nonAckedCommitParticipants;
 }
 
+std::set<ShardId> TransactionCoordinator::ParticipantList::getNonAckedReadOnlyParticipants()
+    const {
+    std::set<ShardId> nonAckedReadOnlyParticipants;
+    for (const auto& kv : _participants) {
+        if (kv.second.ack != Participant::Ack::kCommit && kv.second.readOnly) {
+            nonAckedReadOnlyParticipants.insert(kv.first);
+        }
+    }
+    return nonAckedReadOnlyParticipants;
+}
+
 std::set<ShardId> TransactionCoordinator::ParticipantList::getNonVotedAbortParticipants() const {
     std::set<ShardId> nonVotedAbortParticipants;
     for (const auto& kv : _participants) {
@@ -86,6 +86,7 @@ public:
             kRecvVoteAbort,
             kRecvVoteCommit,
             kRecvParticipantList,
+            kRecvFinalParticipantList,
             kRecvFinalVoteCommit,
             kRecvFinalCommitAck,
             kRecvTryAbort,
@@ -143,11 +144,16 @@ public:
      * The coordinateCommit command contains the full participant list that this node is responsible
      * for coordinating the commit across.
      *
-     * Stores the participant list.
+     * Stores the participant list. The participants in 'readOnlyParticipants' only read data in the
+     * transaction, so they are not prepared and do not vote; they are committed without a commit
+     * timestamp once the other participants have voted to commit. If every participant has already
+     * voted, or is read-only, the coordinator decides to commit right away.
      *
-     * Throws if any participants that this node has already heard a vote from are not in the list.
+     * Throws if any participants that this node has already heard a vote from are not in the list,
+     * or if 'readOnlyParticipants' is not a subset of 'participants'.
      */
-    StateMachine::Action recvCoordinateCommit(const std::set<ShardId>& participants);
+    StateMachine::Action recvCoordinateCommit(const std::set<ShardId>& participants,
+                                              const std::set<ShardId>& readOnlyParticipants = {});
 
     /**
      * A participant sends a voteCommit command with its prepareTimestamp if it succeeded in
@@ -182,6 +188,13 @@ public:
      */
     Future<TransactionCoordinator::StateMachine::State> waitForCompletion();
 
+    /**
+     * Returns a Future which will be signaled when the TransactionCoordinator decides to commit or
+     * aborts. The resulting future will contain kWaitingForCommitAcks if the decision to commit was
+     * made but not all participants have acknowledged it yet, or the final state otherwise.
+     */
+    Future<TransactionCoordinator::StateMachine::State> waitForDecision();
+
     /**
      * Marks this participant as having completed committing the transaction.
      */
@@ -191,6 +204,10 @@ public:
         return _participantList.getNonAckedCommitParticipants();
     }
 
+    std::set<ShardId> getNonAckedReadOnlyParticipants() const {
+        return _participantList.getNonAckedReadOnlyParticipants();
+    }
+
     std::set<ShardId> getNonVotedAbortParticipants() const {
         return _participantList.getNonVotedAbortParticipants();
     }
@@ -205,7 +222,8 @@ public:
 
     class ParticipantList {
     public:
-        void recordFullList(const std::set<ShardId>& participants);
+        void recordFullList(const std::set<ShardId>& participants,
+                            const std::set<ShardId>& readOnlyParticipants = {});
         void recordVoteCommit(const ShardId& shardId, Timestamp prepareTimestamp);
         void recordVoteAbort(const ShardId& shardId);
         void recordCommitAck(const ShardId& shardId);
@@ -217,7 +235,12 @@ public:
 
         Timestamp getHighestPrepareTimestamp() const;
 
+        /**
+         * Returns the participants which have not acknowledged the commit, without the read-only
+         * participants, which are committed without a commit timestamp.
+         */
         std::set<ShardId> getNonAckedCommitParticipants() const;
+        std::set<ShardId> getNonAckedReadOnlyParticipants() const;
         std::set<ShardId> getNonVotedAbortParticipants() const;
 
         class Participant {
@@ -228,6 +251,9 @@ public:
             Vote vote{Vote::kUnknown};
             Ack ack{Ack::kNone};
             boost::optional<Timestamp> prepareTimestamp{boost::none};
+
+            // Read-only participants are not prepared and never vote.
+            bool readOnly{false};
         };
 
     private:
@@ -276,6 +302,7 @@ inline StringBuilder& operator<<(StringBuilder& sb,
         case Event::kRecvVoteAbort:         return sb << "kRecvVoteAbort";
         case Event::kRecvVoteCommit:        return sb << "kRecvVoteCommit";
         case Event::kRecvParticipantList:   return sb << "kRecvParticipantList";
+        case Event::kRecvFinalParticipantList: return sb << "kRecvFinalParticipantList";
         case Event::kRecvFinalVoteCommit:   return sb << "kRecvFinalVoteCommit";
         case Event::kRecvFinalCommitAck:    return sb << "kRecvFinalCommitAck";
         // clang-format on
@@ -141,7 +141,7 @@ namespace txn {
 void sendCommit(OperationContext* opCtx,
                 std::shared_ptr<TransactionCoordinator> coordinator,
                 const std::set<ShardId>& nonAckedParticipants,
-                Timestamp commitTimestamp) {
+                boost::optional<Timestamp> commitTimestamp) {
     invariant(coordinator);
 
     CommitTransaction commitTransaction;
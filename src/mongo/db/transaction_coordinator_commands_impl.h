@@ -37,12 +37,13 @@ namespace txn {
 
 /**
  * Asynchronously sends commit to all participants provided and calls recvCommitAck on the
- * coordinator if the commit command succeeds.
+ * coordinator if the commit command succeeds. The commit timestamp is omitted for participants
+ * which were not prepared.
  */
 void sendCommit(OperationContext* opCtx,
                 std::shared_ptr<TransactionCoordinator> coordinator,
                 const std::set<ShardId>& nonAckedParticipants,
-                Timestamp commitTimestamp);
+                boost::optional<Timestamp> commitTimestamp);
 
 /**
  * Asynchronously sends abort to all participants provided.
@@ -103,6 +103,33 @@ TEST(ParticipantList, ReceiveParticipantListMissingParticipantThatAlreadyVotedCo
                        ErrorCodes::InternalError);
 }
 
+TEST(ParticipantList, ReceiveReadOnlyParticipantNotInListThrows) {
+    ParticipantList participantList;
+    ASSERT_THROWS_CODE(
+        participantList.recordFullList({ShardId("shard0000")}, {ShardId("shard0001")}),
+        AssertionException,
+        ErrorCodes::InternalError);
+}
+
+TEST(ParticipantList, ReadOnlyParticipantVotesCommitThrows) {
+    ParticipantList participantList;
+    participantList.recordFullList({ShardId("shard0000"), ShardId("shard0001")},
+                                   {ShardId("shard0001")});
+    ASSERT_THROWS_CODE(participantList.recordVoteCommit(ShardId("shard0001"), dummyTimestamp),
+                       AssertionException,
+                       ErrorCodes::InternalError);
+}
+
+TEST(ParticipantList, ReadOnlyParticipantsCountAsVotedCommit) {
+    ParticipantList participantList;
+    participantList.recordFullList({ShardId("shard0000"), ShardId("shard0001")},
+                                   {ShardId("shard0001")});
+    ASSERT_FALSE(participantList.allParticipantsVotedCommit());
+    participantList.recordVoteCommit(ShardId("shard0000"), Timestamp(3, 1));
+    ASSERT(participantList.allParticipantsVotedCommit());
+    ASSERT_EQ(Timestamp(3, 1), participantList.getHighestPrepareTimestamp());
+}
+
 TEST(ParticipantList, ParticipantResendsVoteAbortSucceeds) {
     ParticipantList participantList;
     participantList.recordVoteAbort(ShardId("shard0001"));
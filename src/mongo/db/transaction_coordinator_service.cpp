@@ -55,6 +55,11 @@ void doCoordinatorAction(OperationContext* opCtx,
                             coordinator,
                             coordinator->getNonAckedCommitParticipants(),
                             coordinator->getCommitTimestamp());
+            // Read-only participants were never prepared, so they commit without a timestamp.
+            auto readOnlyParticipants = coordinator->getNonAckedReadOnlyParticipants();
+            if (!readOnlyParticipants.empty()) {
+                txn::sendCommit(opCtx, coordinator, readOnlyParticipants, boost::none);
+            }
             break;
         }
         case TransactionCoordinator::StateMachine::Action::kSendAbort: {
@@ -110,20 +115,23 @@ Future<TransactionCoordinatorService::CommitDecision>
 TransactionCoordinatorService::coordinateCommit(OperationContext* opCtx,
                                                 LogicalSessionId lsid,
                                                 TxnNumber txnNumber,
-                                                const std::set<ShardId>& participantList) {
+                                                const std::set<ShardId>& participantList,
+                                                const std::set<ShardId>& readOnlyParticipants) {
 
     auto coordinator = _coordinatorCatalog->get(lsid, txnNumber);
     if (!coordinator) {
         return TransactionCoordinatorService::CommitDecision::kAbort;
     }
 
-    auto actionToTake = coordinator.get()->recvCoordinateCommit(participantList);
+    auto actionToTake =
+        coordinator.get()->recvCoordinateCommit(participantList, readOnlyParticipants);
     doCoordinatorAction(opCtx, coordinator.get(), actionToTake);
 
-    return coordinator.get()->waitForCompletion().then([](auto finalState) {
-        switch (finalState) {
+    return coordinator.get()->waitForDecision().then([](auto state) {
+        switch (state) {
             case TransactionCoordinator::StateMachine::State::kAborted:
                 return TransactionCoordinatorService::CommitDecision::kAbort;
+            case TransactionCoordinator::StateMachine::State::kWaitingForCommitAcks:
             case TransactionCoordinator::StateMachine::State::kCommitted:
                 return TransactionCoordinatorService::CommitDecision::kCommit;
             default:
@@ -72,16 +72,19 @@ public:
     /**
      * Delivers coordinateCommit to the TransactionCoordinator, asynchronously sends commit or
      * abort to participants if necessary, and returns a Future that will contain the commit
-     * decision when the transaction finishes committing or aborting.
+     * decision. The participants in 'readOnlyParticipants' are not prepared, see
+     * TransactionCoordinator::recvCoordinateCommit().
      *
-     * TODO (SERVER-37364): On the commit path, this Future should instead be signaled as soon as
-     * the coordinator is finished persisting the commit decision, rather than waiting until the
-     * commit process has been completed entirely.
+     * On the commit path the Future is signaled as soon as the decision to commit is made, while
+     * commit is still being sent to the participants, since every participant is prepared at that
+     * point and nothing can make the transaction abort anymore. On the abort path it is signaled
+     * once the transaction is aborted.
      */
     Future<CommitDecision> coordinateCommit(OperationContext* opCtx,
                                             LogicalSessionId lsid,
                                             TxnNumber txnNumber,
-                                            const std::set<ShardId>& participantList);
+                                            const std::set<ShardId>& participantList,
+                                            const std::set<ShardId>& readOnlyParticipants = {});
 
     /**
      * Delivers voteCommit to the TransactionCoordinator and asynchronously sends commit or abort to
@@ -420,6 +420,48 @@ TEST_F(TransactionCoordinatorServiceTestSingleTxn, FinalVoteCommitSendsCommit) {
     assertCommitSentAndRespondWithSuccess();
 }
 
+TEST_F(TransactionCoordinatorServiceTestSingleTxn,
+       CoordinateCommitReturnsCommitDecisionBeforeCommitIsAcknowledged) {
+    auto commitDecisionFuture = coordinatorService()->coordinateCommit(
+        operationContext(), lsid(), txnNumber(), kTwoShardIdSet);
+
+    coordinatorService()->voteCommit(
+        operationContext(), lsid(), txnNumber(), kTwoShardIdList[0], kDummyTimestamp);
+    coordinatorService()->voteCommit(
+        operationContext(), lsid(), txnNumber(), kTwoShardIdList[1], kDummyTimestamp);
+
+    ASSERT_TRUE(commitDecisionFuture.isReady());
+    ASSERT_EQ(static_cast<int>(commitDecisionFuture.get()),
+              static_cast<int>(TransactionCoordinatorService::CommitDecision::kCommit));
+
+    assertCommitSentAndRespondWithSuccess();
+    assertCommitSentAndRespondWithSuccess();
+}
+
+TEST_F(TransactionCoordinatorServiceTestSingleTxn, ReadOnlyParticipantIsCommittedWithoutTimestamp) {
+    auto commitDecisionFuture = coordinatorService()->coordinateCommit(
+        operationContext(), lsid(), txnNumber(), kTwoShardIdSet, {kTwoShardIdList[1]});
+
+    coordinatorService()->voteCommit(
+        operationContext(), lsid(), txnNumber(), kTwoShardIdList[0], kDummyTimestamp);
+
+    // Commit is sent to the prepared participant with a timestamp, and to the read-only one
+    // without.
+    for (int i = 0; i < 2; ++i) {
+        onCommand([&](const executor::RemoteCommandRequest& request) {
+            ASSERT_EQ(CommitTransaction::kCommandName,
+                      request.cmdObj.firstElement().fieldNameStringData());
+            const bool isReadOnlyParticipant =
+                request.target == makeHostAndPort(kTwoShardIdList[1]);
+            ASSERT_EQ(isReadOnlyParticipant, request.cmdObj["commitTimestamp"].eoo());
+            return kOk;
+        });
+    }
+
+    ASSERT_EQ(static_cast<int>(commitDecisionFuture.get()),
+              static_cast<int>(TransactionCoordinatorService::CommitDecision::kCommit));
+}
+
 // This logic is obviously correct for a transaction which has been aborted prior to receiving
 // coordinateCommit, when the coordinator does not yet know all participants and so cannot send
 // abortTransaction to all participants. In this case, it can potentially receive voteCommit
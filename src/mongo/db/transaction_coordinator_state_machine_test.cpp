@@ -79,6 +79,13 @@ TEST(CoordinatorStateMachine, CommitSucceeds) {
         State::kCommitted);
 }
 
+TEST(CoordinatorStateMachine, FinalParticipantListCommits) {
+    expectScheduleSucceeds({Event::kRecvVoteCommit, Event::kRecvFinalParticipantList},
+                           State::kWaitingForCommitAcks);
+    expectScheduleSucceeds({Event::kRecvFinalParticipantList, Event::kRecvFinalCommitAck},
+                           State::kCommitted);
+}
+
 TEST(CoordinatorStateMachine, RecvFinalVoteCommitAndRecvVoteAbortThrows) {
     expectScheduleThrows({Event::kRecvVoteAbort, Event::kRecvFinalVoteCommit});
     expectScheduleThrows(
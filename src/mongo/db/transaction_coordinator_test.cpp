@@ -78,6 +78,42 @@ TEST(
     ASSERT_EQ(State::kCommitted, coordinator.state());
 }
 
+TEST(Coordinator, AllParticipantsVoteCommitBeforeCoordinatorReceivesParticipantListLeadsToCommit) {
+    TransactionCoordinator coordinator;
+    coordinator.recvVoteCommit(ShardId("shard0000"), dummyTimestamp);
+    coordinator.recvVoteCommit(ShardId("shard0001"), dummyTimestamp);
+    ASSERT(TransactionCoordinator::StateMachine::Action::kSendCommit ==
+           coordinator.recvCoordinateCommit({ShardId("shard0000"), ShardId("shard0001")}));
+    ASSERT_EQ(State::kWaitingForCommitAcks, coordinator.state());
+}
+
+TEST(Coordinator, ReadOnlyParticipantsDoNotVote) {
+    TransactionCoordinator coordinator;
+    coordinator.recvCoordinateCommit({ShardId("shard0000"), ShardId("shard0001")},
+                                     {ShardId("shard0001")});
+    coordinator.recvVoteCommit(ShardId("shard0000"), dummyTimestamp);
+    ASSERT_EQ(State::kWaitingForCommitAcks, coordinator.state());
+
+    ASSERT(coordinator.getNonAckedCommitParticipants() == std::set<ShardId>{ShardId("shard0000")});
+    ASSERT(coordinator.getNonAckedReadOnlyParticipants() ==
+           std::set<ShardId>{ShardId("shard0001")});
+
+    coordinator.recvCommitAck(ShardId("shard0000"));
+    coordinator.recvCommitAck(ShardId("shard0001"));
+    ASSERT_EQ(State::kCommitted, coordinator.state());
+}
+
+TEST(Coordinator, AllParticipantsReadOnlyLeadsToCommitOnParticipantList) {
+    TransactionCoordinator coordinator;
+    ASSERT(TransactionCoordinator::StateMachine::Action::kSendCommit ==
+           coordinator.recvCoordinateCommit({ShardId("shard0000"), ShardId("shard0001")},
+                                            {ShardId("shard0000"), ShardId("shard0001")}));
+    ASSERT(coordinator.getNonAckedCommitParticipants().empty());
+    coordinator.recvCommitAck(ShardId("shard0000"));
+    coordinator.recvCommitAck(ShardId("shard0001"));
+    ASSERT_EQ(State::kCommitted, coordinator.state());
+}
+
 TEST(Coordinator, NotHearingSomeParticipantsVoteOtherParticipantsVotedCommitLeadsToStillWaiting) {
     TransactionCoordinator coordinator;
     coordinator.recvCoordinateCommit({ShardId("shard0000"), ShardId("shard0001")});
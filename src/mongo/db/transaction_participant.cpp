@@ -83,8 +83,40 @@ MONGO_EXPORT_SERVER_PARAMETER(transactionLifetimeLimitSeconds, std::int32_t, 60)
         return Status::OK();
     });
 
+// Server parameter that limits the total size of the operations of a transaction. Transactions
+// which are not prepared are written to the oplog as a chain of 'applyOps' entries when they do not
+// fit in one, so the limit may be larger than the maximum BSON document size.
+MONGO_EXPORT_SERVER_PARAMETER(transactionSizeLimitBytes, long long, 64 * 1024 * 1024)
+    ->withValidator([](const long long& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "transactionSizeLimitBytes must be greater than or equal to 1");
+        }
+
+        return Status::OK();
+    });
+
+// Server parameter that limits how many consecutive retryable writes of a transaction may share
+// one update of the session's config.transactions record. The writes which skip the update are
+// found in the oplog when the record is read, so the default of 1 updates it on every write.
+MONGO_EXPORT_SERVER_PARAMETER(maxRetryableWritesPerSessionRecordUpdate, int, 1)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "maxRetryableWritesPerSessionRecordUpdate must be greater than or equal "
+                          "to 1");
+        }
+
+        return Status::OK();
+    });
+
 namespace {
 
+// How many seconds of oplog after the last write in a session's config.transactions record may
+// hold retryable writes which did not update the record. This bounds the oplog scan which catches
+// up the record when it is read.
+const unsigned kUnrecordedWritesWindowSecs = 1;
+
 // Failpoint which will pause an operation just after allocating a point-in-time storage engine
 // transaction.
 MONGO_FAIL_POINT_DEFINE(hangAfterPreallocateSnapshot);
@@ -137,8 +169,10 @@ ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
             return boost::none;
         }
 
-        return SessionTxnRecord::parse(IDLParserErrorContext("parse latest txn record for session"),
-                                       result);
+        return TransactionParticipant::catchUpSessionRecord(
+            opCtx,
+            SessionTxnRecord::parse(IDLParserErrorContext("parse latest txn record for session"),
+                                    result));
     }();
 
     if (!result.lastTxnRecord) {
@@ -149,6 +183,13 @@ ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
     while (it.hasNext()) {
         try {
             const auto entry = it.next(opCtx);
+
+            // The entries leading up to the final entry of a transaction written as a chain of
+            // applyOps entries do not complete any statement.
+            if (entry.isPartialTransaction()) {
+                continue;
+            }
+
             invariant(entry.getStatementId());
 
             if (*entry.getStatementId() == kIncompleteHistoryStmtId) {
@@ -820,16 +861,18 @@ void TransactionParticipant::addTransactionOperation(OperationContext* opCtx,
     invariant(opCtx->lockState()->inAWriteUnitOfWork());
     _transactionOperations.push_back(operation);
     _transactionOperationBytes += repl::OplogEntry::getReplOperationSize(operation);
-    // _transactionOperationBytes is based on the in-memory size of the operation.  With overhead,
-    // we expect the BSON size of the operation to be larger, so it's possible to make a transaction
-    // just a bit too large and have it fail only in the commit.  It's still useful to fail early
-    // when possible (e.g. to avoid exhausting server memory).
+    // _transactionOperationBytes is based on the in-memory size of the operation. The operations
+    // are held in memory until the transaction commits or prepares, so fail early to avoid
+    // exhausting server memory. A prepared transaction must still fit in a single oplog entry,
+    // which is checked when the entry is written.
+    const auto sizeLimit = transactionSizeLimitBytes.load();
     uassert(ErrorCodes::TransactionTooLarge,
             str::stream() << "Total size of all transaction operations must be less than "
-                          << BSONObjMaxInternalSize
-                          << ". Actual size is "
+                          << "transactionSizeLimitBytes ("
+                          << sizeLimit
+                          << "). Actual size is "
                           << _transactionOperationBytes,
-            _transactionOperationBytes <= BSONObjMaxInternalSize);
+            static_cast<long long>(_transactionOperationBytes) <= sizeLimit);
 }
 
 std::vector<repl::ReplOperation> TransactionParticipant::endTransactionAndRetrieveOperations(
@@ -1567,6 +1610,44 @@ void TransactionParticipant::refreshFromStorageIfNeeded(OperationContext* opCtx)
     }
 }
 
+SessionTxnRecord TransactionParticipant::catchUpSessionRecord(OperationContext* opCtx,
+                                                             SessionTxnRecord record) {
+    const auto unrecordedWritesBefore = record.getUnrecordedWritesBefore();
+    if (!unrecordedWritesBefore) {
+        return record;
+    }
+
+    // The writes of the transaction which did not update the record are linked to it through
+    // their previous write optimes, so only the last of them is needed.
+    DBDirectClient client(opCtx);
+    auto cursor = client.query(
+        NamespaceString::kRsOplogNamespace,
+        BSON(repl::OplogEntryBase::kTimestampFieldName
+             << BSON("$gt" << record.getLastWriteOpTime().getTimestamp() << "$lt"
+                           << *unrecordedWritesBefore)
+             << OperationSessionInfo::kSessionIdFieldName
+             << record.getSessionId().toBSON()
+             << OperationSessionInfo::kTxnNumberFieldName
+             << record.getTxnNum()
+             << repl::OplogEntryBase::kStatementIdFieldName
+             << BSON("$exists" << true)),
+        0,
+        0,
+        nullptr,
+        QueryOption_OplogReplay);
+
+    while (cursor->more()) {
+        const auto entry = uassertStatusOK(repl::OplogEntry::parse(cursor->next()));
+        record.setLastWriteOpTime(entry.getOpTime());
+        if (entry.getWallClockTime()) {
+            record.setLastWriteDate(*entry.getWallClockTime());
+        }
+    }
+
+    record.setUnrecordedWritesBefore(boost::none);
+    return record;
+}
+
 void TransactionParticipant::onWriteOpCompletedOnPrimary(
     OperationContext* opCtx,
     TxnNumber txnNumber,
@@ -1587,16 +1668,46 @@ void TransactionParticipant::onWriteOpCompletedOnPrimary(
         }
     }
 
-    const auto updateRequest =
-        _makeUpdateRequest(ul, txnNumber, lastStmtIdWriteOpTime, lastStmtIdWriteDate, txnState);
+    // A retryable write may skip updating the session record when the record already holds an
+    // earlier write of the same transaction, and the write falls within the record's bound.
+    const int maxWritesPerUpdate = maxRetryableWritesPerSessionRecordUpdate.load();
+    const bool skipSessionRecordUpdate = !txnState && _lastWrittenSessionRecord &&
+        _lastWrittenSessionRecord->getTxnNum() == txnNumber && _unrecordedWritesBefore &&
+        lastStmtIdWriteOpTime.getTimestamp() < *_unrecordedWritesBefore &&
+        _numUnrecordedWrites + 1 < maxWritesPerUpdate;
+
+    if (skipSessionRecordUpdate) {
+        ul.unlock();
+
+        _registerUpdateCacheOnCommit(
+            opCtx, txnNumber, std::move(stmtIdsWritten), lastStmtIdWriteOpTime, false, boost::none);
+        return;
+    }
+
+    boost::optional<Timestamp> unrecordedWritesBefore;
+    if (!txnState && maxWritesPerUpdate > 1) {
+        unrecordedWritesBefore = Timestamp(
+            lastStmtIdWriteOpTime.getTimestamp().getSecs() + kUnrecordedWritesWindowSecs, 0);
+    }
+
+    const auto updateRequest = _makeUpdateRequest(ul,
+                                                  txnNumber,
+                                                  lastStmtIdWriteOpTime,
+                                                  lastStmtIdWriteDate,
+                                                  txnState,
+                                                  unrecordedWritesBefore);
 
     ul.unlock();
 
     repl::UnreplicatedWritesBlock doNotReplicateWrites(opCtx);
 
     updateSessionEntry(opCtx, updateRequest);
-    _registerUpdateCacheOnCommit(
-        opCtx, txnNumber, std::move(stmtIdsWritten), lastStmtIdWriteOpTime);
+    _registerUpdateCacheOnCommit(opCtx,
+                                 txnNumber,
+                                 std::move(stmtIdsWritten),
+                                 lastStmtIdWriteOpTime,
+                                 true,
+                                 unrecordedWritesBefore);
 }
 
 bool TransactionParticipant::onMigrateBeginOnPrimary(OperationContext* opCtx,
@@ -1639,7 +1750,7 @@ void TransactionParticipant::onMigrateCompletedOnPrimary(OperationContext* opCtx
     // We do not migrate transaction oplog entries.
     auto txnState = boost::none;
     const auto updateRequest = _makeUpdateRequest(
-        ul, txnNumber, lastStmtIdWriteOpTime, oplogLastStmtIdWriteDate, txnState);
+        ul, txnNumber, lastStmtIdWriteOpTime, oplogLastStmtIdWriteDate, txnState, boost::none);
 
     ul.unlock();
 
@@ -1647,7 +1758,7 @@ void TransactionParticipant::onMigrateCompletedOnPrimary(OperationContext* opCtx
 
     updateSessionEntry(opCtx, updateRequest);
     _registerUpdateCacheOnCommit(
-        opCtx, txnNumber, std::move(stmtIdsWritten), lastStmtIdWriteOpTime);
+        opCtx, txnNumber, std::move(stmtIdsWritten), lastStmtIdWriteOpTime, true, boost::none);
 }
 
 void TransactionParticipant::invalidate() {
@@ -1662,6 +1773,8 @@ void TransactionParticipant::invalidate() {
     _numInvalidations++;
 
     _lastWrittenSessionRecord.reset();
+    _unrecordedWritesBefore = boost::none;
+    _numUnrecordedWrites = 0;
 
     _activeTxnNumber = kUninitializedTxnNumber;
     _activeTxnCommittedStatements.clear();
@@ -1762,7 +1875,8 @@ UpdateRequest TransactionParticipant::_makeUpdateRequest(
     TxnNumber newTxnNumber,
     const repl::OpTime& newLastWriteOpTime,
     Date_t newLastWriteDate,
-    boost::optional<DurableTxnStateEnum> newState) const {
+    boost::optional<DurableTxnStateEnum> newState,
+    boost::optional<Timestamp> unrecordedWritesBefore) const {
     UpdateRequest updateRequest(NamespaceString::kSessionTransactionsTableNamespace);
 
     const auto updateBSON = [&] {
@@ -1772,6 +1886,7 @@ UpdateRequest TransactionParticipant::_makeUpdateRequest(
         newTxnRecord.setLastWriteOpTime(newLastWriteOpTime);
         newTxnRecord.setLastWriteDate(newLastWriteDate);
         newTxnRecord.setState(newState);
+        newTxnRecord.setUnrecordedWritesBefore(unrecordedWritesBefore);
         return newTxnRecord.toBSON();
     }();
     updateRequest.setUpdates(updateBSON);
@@ -1785,63 +1900,79 @@ void TransactionParticipant::_registerUpdateCacheOnCommit(
     OperationContext* opCtx,
     TxnNumber newTxnNumber,
     std::vector<StmtId> stmtIdsWritten,
-    const repl::OpTime& lastStmtIdWriteOpTime) {
-    opCtx->recoveryUnit()->onCommit(
-        [ this, newTxnNumber, stmtIdsWritten = std::move(stmtIdsWritten), lastStmtIdWriteOpTime ](
-            boost::optional<Timestamp>) {
+    const repl::OpTime& lastStmtIdWriteOpTime,
+    bool sessionRecordWritten,
+    boost::optional<Timestamp> unrecordedWritesBefore) {
+    opCtx->recoveryUnit()->onCommit([
+        this,
+        newTxnNumber,
+        stmtIdsWritten = std::move(stmtIdsWritten),
+        lastStmtIdWriteOpTime,
+        sessionRecordWritten,
+        unrecordedWritesBefore
+    ](boost::optional<Timestamp>) {
+        if (sessionRecordWritten) {
             RetryableWritesStats::get(getGlobalServiceContext())
                 ->incrementTransactionsCollectionWriteCount();
+        }
 
-            stdx::lock_guard<stdx::mutex> lg(_mutex);
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+        if (!_isValid)
+            return;
 
-            if (!_isValid)
-                return;
+        if (sessionRecordWritten) {
+            _unrecordedWritesBefore = unrecordedWritesBefore;
+            _numUnrecordedWrites = 0;
+        } else {
+            _numUnrecordedWrites++;
+        }
 
-            // The cache of the last written record must always be advanced after a write so that
-            // subsequent writes have the correct point to start from.
-            if (!_lastWrittenSessionRecord) {
-                _lastWrittenSessionRecord.emplace();
+        // The cache of the last written record must always be advanced after a write so that
+        // subsequent writes have the correct point to start from.
+        if (!_lastWrittenSessionRecord) {
+            _lastWrittenSessionRecord.emplace();
 
-                _lastWrittenSessionRecord->setSessionId(_sessionId());
+            _lastWrittenSessionRecord->setSessionId(_sessionId());
+            _lastWrittenSessionRecord->setTxnNum(newTxnNumber);
+            _lastWrittenSessionRecord->setLastWriteOpTime(lastStmtIdWriteOpTime);
+        } else {
+            if (newTxnNumber > _lastWrittenSessionRecord->getTxnNum())
                 _lastWrittenSessionRecord->setTxnNum(newTxnNumber);
+
+            if (lastStmtIdWriteOpTime > _lastWrittenSessionRecord->getLastWriteOpTime())
                 _lastWrittenSessionRecord->setLastWriteOpTime(lastStmtIdWriteOpTime);
-            } else {
-                if (newTxnNumber > _lastWrittenSessionRecord->getTxnNum())
-                    _lastWrittenSessionRecord->setTxnNum(newTxnNumber);
+        }
 
-                if (lastStmtIdWriteOpTime > _lastWrittenSessionRecord->getLastWriteOpTime())
-                    _lastWrittenSessionRecord->setLastWriteOpTime(lastStmtIdWriteOpTime);
-            }
+        if (newTxnNumber > _activeTxnNumber) {
+            // This call is necessary in order to advance the txn number and reset the cached
+            // state in the case where just before the storage transaction commits, the cache
+            // entry gets invalidated and immediately refreshed while there were no writes for
+            // newTxnNumber yet. In this case _activeTxnNumber will be less than newTxnNumber
+            // and we will fail to update the cache even though the write was successful.
+            _beginOrContinueRetryableWrite(lg, newTxnNumber);
+        }
 
-            if (newTxnNumber > _activeTxnNumber) {
-                // This call is necessary in order to advance the txn number and reset the cached
-                // state in the case where just before the storage transaction commits, the cache
-                // entry gets invalidated and immediately refreshed while there were no writes for
-                // newTxnNumber yet. In this case _activeTxnNumber will be less than newTxnNumber
-                // and we will fail to update the cache even though the write was successful.
-                _beginOrContinueRetryableWrite(lg, newTxnNumber);
-            }
+        if (newTxnNumber == _activeTxnNumber) {
+            for (const auto stmtId : stmtIdsWritten) {
+                if (stmtId == kIncompleteHistoryStmtId) {
+                    _hasIncompleteHistory = true;
+                    continue;
+                }
 
-            if (newTxnNumber == _activeTxnNumber) {
-                for (const auto stmtId : stmtIdsWritten) {
-                    if (stmtId == kIncompleteHistoryStmtId) {
-                        _hasIncompleteHistory = true;
-                        continue;
-                    }
-
-                    const auto insertRes =
-                        _activeTxnCommittedStatements.emplace(stmtId, lastStmtIdWriteOpTime);
-                    if (!insertRes.second) {
-                        const auto& existingOpTime = insertRes.first->second;
-                        fassertOnRepeatedExecution(_sessionId(),
-                                                   newTxnNumber,
-                                                   stmtId,
-                                                   existingOpTime,
-                                                   lastStmtIdWriteOpTime);
-                    }
+                const auto insertRes =
+                    _activeTxnCommittedStatements.emplace(stmtId, lastStmtIdWriteOpTime);
+                if (!insertRes.second) {
+                    const auto& existingOpTime = insertRes.first->second;
+                    fassertOnRepeatedExecution(_sessionId(),
+                                               newTxnNumber,
+                                               stmtId,
+                                               existingOpTime,
+                                               lastStmtIdWriteOpTime);
                 }
             }
-        });
+        }
+    });
 
     MONGO_FAIL_POINT_BLOCK(onPrimaryTransactionalWrite, customArgs) {
         const auto& data = customArgs.getData();
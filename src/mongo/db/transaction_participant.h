@@ -55,6 +55,8 @@ namespace mongo {
 class OperationContext;
 
 extern AtomicInt32 transactionLifetimeLimitSeconds;
+extern AtomicInt64 transactionSizeLimitBytes;
+extern AtomicInt32 maxRetryableWritesPerSessionRecordUpdate;
 
 enum class SpeculativeTransactionOpTime {
     kLastApplied,
@@ -430,7 +432,10 @@ public:
      * in the write's WUOW. Updates the on-disk state of the session to match the specified
      * transaction/opTime and keeps the cached state in sync.
      *
-     * 'txnState' is 'none' for retryable writes.
+     * 'txnState' is 'none' for retryable writes. A retryable write may leave the on-disk state at
+     * an earlier write of the same transaction, as allowed by the
+     * maxRetryableWritesPerSessionRecordUpdate server parameter, in which case the on-disk state
+     * is caught up from the oplog when it is read.
      *
      * Must only be called with the session checked-out.
      *
@@ -443,6 +448,14 @@ public:
                                      Date_t lastStmtIdWriteDate,
                                      boost::optional<DurableTxnStateEnum> txnState);
 
+    /**
+     * Returns the given config.transactions record of a session with its last write advanced past
+     * the retryable writes which did not update it. Such writes are found in the oplog, between the
+     * record's last write and its 'unrecordedWritesBefore' bound.
+     */
+    static SessionTxnRecord catchUpSessionRecord(OperationContext* opCtx,
+                                                 SessionTxnRecord record);
+
     /**
      * Helper function to begin a migration on a primary node.
      *
@@ -653,12 +666,18 @@ private:
                                      TxnNumber newTxnNumber,
                                      const repl::OpTime& newLastWriteOpTime,
                                      Date_t newLastWriteDate,
-                                     boost::optional<DurableTxnStateEnum> newState) const;
+                                     boost::optional<DurableTxnStateEnum> newState,
+                                     boost::optional<Timestamp> unrecordedWritesBefore) const;
 
+    // Updates the cached state of the session when the write commits. 'sessionRecordWritten' is
+    // false for a retryable write which did not update the on-disk state, and otherwise
+    // 'unrecordedWritesBefore' is the bound which was written with it, if any.
     void _registerUpdateCacheOnCommit(OperationContext* opCtx,
                                       TxnNumber newTxnNumber,
                                       std::vector<StmtId> stmtIdsWritten,
-                                      const repl::OpTime& lastStmtIdWriteTs);
+                                      const repl::OpTime& lastStmtIdWriteTs,
+                                      bool sessionRecordWritten,
+                                      boost::optional<Timestamp> unrecordedWritesBefore);
 
     // Finishes committing the multi-document transaction after the storage-transaction has been
     // committed, the oplog entry has been inserted into the oplog, and the transactions table has
@@ -793,6 +812,12 @@ private:
     // Caches what is known to be the last written transaction record for the session
     boost::optional<SessionTxnRecord> _lastWrittenSessionRecord;
 
+    // The 'unrecordedWritesBefore' bound of the on-disk transaction record, if it was last written
+    // with one, and the number of retryable writes which have not updated that record since. They
+    // decide whether the next retryable write may skip updating the record.
+    boost::optional<Timestamp> _unrecordedWritesBefore;
+    int _numUnrecordedWrites{0};
+
     // For the active txn, tracks which statement ids have been committed and at which oplog
     // opTime. Used for fast retryability check and retrieving the previous write's data without
     // having to scan through the oplog.
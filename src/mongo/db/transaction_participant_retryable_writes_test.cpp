@@ -31,6 +31,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/logical_clock.h"
 #include "mongo/db/op_observer_noop.h"
 #include "mongo/db/op_observer_registry.h"
 #include "mongo/db/operation_context.h"
@@ -48,6 +49,7 @@
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -237,6 +239,26 @@ protected:
         ASSERT_EQ(opTime, txnParticipant->getLastWriteOpTime(txnNum));
     }
 
+    SessionTxnRecord readTxnRecord(const LogicalSessionId& lsid) {
+        DBDirectClient client(opCtx());
+        auto txnRecordObj =
+            client.findOne(NamespaceString::kSessionTransactionsTableNamespace.ns(),
+                           {BSON(SessionTxnRecord::kSessionIdFieldName << lsid.toBSON())});
+        ASSERT_FALSE(txnRecordObj.isEmpty());
+        return SessionTxnRecord::parse(IDLParserErrorContext("readTxnRecord"), txnRecordObj);
+    }
+
+    // Moves the cluster time, which the oplog timestamps are taken from, to the start of a second
+    // ahead of the wall clock, so that the next writes all get timestamps within that second.
+    void startNewOplogSecond() {
+        const auto clock = LogicalClock::get(opCtx());
+        const unsigned wallClockSecs =
+            durationCount<Seconds>(Date_t::now().toDurationSinceEpoch());
+        const auto secs =
+            std::max(wallClockSecs + 3600, clock->getClusterTime().asTimestamp().getSecs() + 1);
+        clock->setClusterTimeFromTrustedSource(LogicalTime(Timestamp(secs, 1)));
+    }
+
     OpObserverMock* _opObserver = nullptr;
 };
 
@@ -406,6 +428,78 @@ TEST_F(TransactionParticipantRetryableWritesTest, CheckStatementExecuted) {
     ASSERT(txnParticipant->checkStatementExecutedNoOplogEntryFetch(txnNum, 2000));
 }
 
+TEST_F(TransactionParticipantRetryableWritesTest, RetryableWritesShareSessionRecordUpdates) {
+    const auto originalMaxWrites = maxRetryableWritesPerSessionRecordUpdate.load();
+    maxRetryableWritesPerSessionRecordUpdate.store(3);
+    ON_BLOCK_EXIT([&] { maxRetryableWritesPerSessionRecordUpdate.store(originalMaxWrites); });
+
+    const auto sessionId = makeLogicalSessionIdForTest();
+    Session session(sessionId);
+    const auto txnParticipant = TransactionParticipant::getFromNonCheckedOutSession(&session);
+    txnParticipant->refreshFromStorageIfNeeded(opCtx());
+
+    startNewOplogSecond();
+
+    const TxnNumber txnNum = 100;
+    const auto firstOpTime = writeTxnRecord(&session, txnNum, 0, {}, boost::none);
+    const auto secondOpTime = writeTxnRecord(&session, txnNum, 1, firstOpTime, boost::none);
+    const auto thirdOpTime = writeTxnRecord(&session, txnNum, 2, secondOpTime, boost::none);
+
+    // Only the first write updated the record, which bounds the writes that did not.
+    auto txnRecord = readTxnRecord(sessionId);
+    ASSERT_EQ(firstOpTime, txnRecord.getLastWriteOpTime());
+    ASSERT_EQ(Timestamp(firstOpTime.getTimestamp().getSecs() + 1, 0),
+              *txnRecord.getUnrecordedWritesBefore());
+    ASSERT_EQ(thirdOpTime, txnParticipant->getLastWriteOpTime(txnNum));
+
+    const auto caughtUpRecord = TransactionParticipant::catchUpSessionRecord(opCtx(), txnRecord);
+    ASSERT_EQ(thirdOpTime, caughtUpRecord.getLastWriteOpTime());
+    ASSERT_FALSE(caughtUpRecord.getUnrecordedWritesBefore());
+
+    // The third write after the record was updated updates it again.
+    const auto fourthOpTime = writeTxnRecord(&session, txnNum, 3, thirdOpTime, boost::none);
+    ASSERT_EQ(fourthOpTime, readTxnRecord(sessionId).getLastWriteOpTime());
+
+    // A write after the record's bound updates it.
+    writeTxnRecord(&session, txnNum, 4, fourthOpTime, boost::none);
+    startNewOplogSecond();
+    const auto sixthOpTime = writeTxnRecord(&session, txnNum, 5, fourthOpTime, boost::none);
+    ASSERT_EQ(sixthOpTime, readTxnRecord(sessionId).getLastWriteOpTime());
+}
+
+TEST_F(TransactionParticipantRetryableWritesTest,
+       RefreshFindsRetryableWritesWhichDidNotUpdateSessionRecord) {
+    const auto originalMaxWrites = maxRetryableWritesPerSessionRecordUpdate.load();
+    maxRetryableWritesPerSessionRecordUpdate.store(10);
+    ON_BLOCK_EXIT([&] { maxRetryableWritesPerSessionRecordUpdate.store(originalMaxWrites); });
+
+    const auto sessionId = makeLogicalSessionIdForTest();
+    Session session(sessionId);
+    const auto txnParticipant = TransactionParticipant::getFromNonCheckedOutSession(&session);
+    txnParticipant->refreshFromStorageIfNeeded(opCtx());
+
+    startNewOplogSecond();
+
+    const TxnNumber txnNum = 100;
+    const auto firstOpTime = writeTxnRecord(&session, txnNum, 0, {}, boost::none);
+    const auto secondOpTime = writeTxnRecord(&session, txnNum, 1, firstOpTime, boost::none);
+    const auto thirdOpTime = writeTxnRecord(&session, txnNum, 2, secondOpTime, boost::none);
+    ASSERT_EQ(firstOpTime, readTxnRecord(sessionId).getLastWriteOpTime());
+
+    txnParticipant->invalidate();
+    txnParticipant->refreshFromStorageIfNeeded(opCtx());
+
+    ASSERT_EQ(thirdOpTime, txnParticipant->getLastWriteOpTime(txnNum));
+    ASSERT(txnParticipant->checkStatementExecuted(opCtx(), txnNum, 0));
+    ASSERT(txnParticipant->checkStatementExecuted(opCtx(), txnNum, 1));
+    ASSERT(txnParticipant->checkStatementExecuted(opCtx(), txnNum, 2));
+    ASSERT(!txnParticipant->checkStatementExecuted(opCtx(), txnNum, 3));
+
+    // The first write after a refresh updates the record.
+    const auto fourthOpTime = writeTxnRecord(&session, txnNum, 3, thirdOpTime, boost::none);
+    ASSERT_EQ(fourthOpTime, readTxnRecord(sessionId).getLastWriteOpTime());
+}
+
 TEST_F(TransactionParticipantRetryableWritesTest, CheckStatementExecutedForOldTransactionThrows) {
     const auto sessionId = makeLogicalSessionIdForTest();
     Session session(sessionId);
@@ -1228,6 +1228,10 @@ TEST_F(TxnParticipantTest, TransactionTooLargeWhileBuilding) {
 
     txnParticipant->unstashTransactionResources(opCtx(), "insert");
 
+    const auto originalSizeLimit = transactionSizeLimitBytes.load();
+    transactionSizeLimitBytes.store(16 * 1024 * 1024);
+    ON_BLOCK_EXIT([&] { transactionSizeLimitBytes.store(originalSizeLimit); });
+
     // Two 6MB operations should succeed; three 6MB operations should fail.
     constexpr size_t kBigDataSize = 6 * 1024 * 1024;
     std::unique_ptr<uint8_t[]> bigData(new uint8_t[kBigDataSize]());
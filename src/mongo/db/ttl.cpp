@@ -34,6 +34,8 @@
 
 #include "mongo/db/ttl.h"
 
+#include <algorithm>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -47,8 +49,9 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
-#include "mongo/db/exec/delete.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/logical_session_id.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/query/internal_plans.h"
@@ -59,6 +62,7 @@
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -77,6 +81,21 @@ MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60)
         return Status::OK();
     });  // used for testing
 
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 100)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0)
+            return Status(ErrorCodes::BadValue, "ttlMonitorBatchSize must be strictly positive");
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxDeletesPerSecond, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0)
+            return Status(ErrorCodes::BadValue,
+                          "ttlMonitorMaxDeletesPerSecond must not be negative");
+        return Status::OK();
+    });
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -174,6 +193,11 @@ private:
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
      * of time has passed according to its expiry specification.
+     *
+     * Expired documents are deleted in index order, in batches of at most ttlMonitorBatchSize
+     * documents. Each batch is deleted in a single storage transaction, so its oplog entries are
+     * written together, and the collection lock is released between batches. If
+     * ttlMonitorMaxDeletesPerSecond is set, the batches are paced to stay under that rate.
      */
     void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
         const NamespaceString collectionNSS(idx["ns"].String());
@@ -187,7 +211,7 @@ private:
         }
 
         const BSONObj key = idx["key"].Obj();
-        const StringData name = idx["name"].valueStringData();
+        const std::string name = idx["name"].String();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
             return;
@@ -195,31 +219,70 @@ private:
 
         LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
 
+        BSONObj resumeKey;
+        long long numDeleted = 0;
+        while (true) {
+            Timer batchTimer;
+            long long batchDeleted = 0;
+            const bool more =
+                doTTLBatchForIndex(opCtx, collectionNSS, name, &resumeKey, &batchDeleted);
+            numDeleted += batchDeleted;
+            ttlDeletedDocuments.increment(batchDeleted);
+            if (!more) {
+                break;
+            }
+
+            const int maxDeletesPerSecond = ttlMonitorMaxDeletesPerSecond.load();
+            if (maxDeletesPerSecond > 0) {
+                const Milliseconds batchBudget(batchDeleted * 1000 / maxDeletesPerSecond);
+                const Milliseconds batchTime(batchTimer.millis());
+                if (batchBudget > batchTime) {
+                    MONGO_IDLE_THREAD_BLOCK;
+                    opCtx->sleepFor(batchBudget - batchTime);
+                }
+            }
+        }
+
+        LOG(1) << "deleted: " << numDeleted;
+    }
+
+    /**
+     * Deletes the next batch of expired documents found through the TTL index 'name', starting at
+     * the index key 'resumeKey', or at the start of the index if it is empty. On return,
+     * 'resumeKey' holds the last key read and 'numDeleted' the number of documents deleted.
+     * Returns true if there may be more expired documents to delete.
+     */
+    bool doTTLBatchForIndex(OperationContext* opCtx,
+                            const NamespaceString& collectionNSS,
+                            const std::string& name,
+                            BSONObj* resumeKey,
+                            long long* numDeleted) {
         AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IX);
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return false;
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return false;
         }
 
         IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
-                   << "ttl job for: " << idx;
-            return;
+                   << "ttl job for: " << name;
+            return false;
         }
 
-        // Re-read 'idx' from the descriptor, in case the collection or index definition changed
+        // Read the spec from the descriptor, in case the collection or index definition changed
         // before we re-acquired the collection lock.
-        idx = desc->infoObj();
+        const BSONObj idx = desc->infoObj();
+        const BSONObj key = desc->keyPattern();
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -227,13 +290,13 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         const Date_t kDawnOfTime =
             Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
         const Date_t expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
-        const BSONObj startKey = BSON("" << kDawnOfTime);
+        const BSONObj startKey = resumeKey->isEmpty() ? BSON("" << kDawnOfTime) : *resumeKey;
         const BSONObj endKey = BSON("" << expirationTime);
         // The canonical check as to whether a key pattern element is "ascending" or
         // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
@@ -241,9 +304,8 @@ private:
             ? InternalPlanner::Direction::FORWARD
             : InternalPlanner::Direction::BACKWARD;
 
-        // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
-        // queries for the expired documents correctly so that we do not delete documents that are
-        // not actually expired when our snapshot changes during deletion.
+        // Each document is matched against a query for expired documents before it is deleted, so
+        // that we do not delete a document which was updated after its index key was read.
         const char* keyFieldName = key.firstElement().fieldName();
         BSONObj query =
             BSON(keyFieldName << BSON("$gte" << kDawnOfTime << "$lte" << expirationTime));
@@ -251,32 +313,59 @@ private:
         qr->setFilter(query);
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(qr));
         invariant(canonicalQuery.getStatus());
-
-        DeleteStageParams params;
-        params.isMulti = true;
-        params.canonicalQuery = canonicalQuery.getValue().get();
-
-        auto exec =
-            InternalPlanner::deleteWithIndexScan(opCtx,
-                                                 collection,
-                                                 params,
-                                                 desc,
-                                                 startKey,
-                                                 endKey,
-                                                 BoundInclusion::kIncludeBothStartAndEndKeys,
-                                                 PlanExecutor::YIELD_AUTO,
-                                                 direction);
-
-        Status result = exec->executePlan();
-        if (!result.isOK()) {
-            error() << "ttl query execution for index " << idx
-                    << " failed with status: " << redact(result);
-            return;
+        const MatchExpression* expired = canonicalQuery.getValue()->root();
+
+        // Read the next batch of expired documents in index order. A document with several
+        // expired keys may be read more than once, which only makes the batch smaller.
+        const int batchSize = ttlMonitorBatchSize.load();
+        std::vector<RecordId> toDelete;
+        bool more = false;
+        {
+            auto exec = InternalPlanner::indexScan(opCtx,
+                                                   collection,
+                                                   desc,
+                                                   startKey,
+                                                   endKey,
+                                                   BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                   PlanExecutor::NO_YIELD,
+                                                   direction);
+            BSONObj keyObj;
+            RecordId loc;
+            PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+            while (static_cast<int>(toDelete.size()) < batchSize &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&keyObj, &loc))) {
+                toDelete.push_back(loc);
+                *resumeKey = keyObj.getOwned();
+            }
+            if (static_cast<int>(toDelete.size()) < batchSize && PlanExecutor::IS_EOF != state) {
+                error() << "ttl query execution for index " << idx << " failed with state: "
+                        << PlanExecutor::statestr(state) << ": "
+                        << redact(WorkingSetCommon::toStatusString(keyObj));
+            } else {
+                more = static_cast<int>(toDelete.size()) == batchSize;
+            }
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
-        LOG(1) << "deleted: " << numDeleted;
+        std::sort(toDelete.begin(), toDelete.end());
+        toDelete.erase(std::unique(toDelete.begin(), toDelete.end()), toDelete.end());
+
+        writeConflictRetry(opCtx, "ttl delete", collectionNSS.ns(), [&] {
+            *numDeleted = 0;
+            WriteUnitOfWork wuow(opCtx);
+            for (const auto& loc : toDelete) {
+                Snapshotted<BSONObj> doc;
+                if (!collection->findDoc(opCtx, loc, &doc) || !expired->matchesBSON(doc.value())) {
+                    continue;
+                }
+                collection->deleteDocument(opCtx, kUninitializedStmtId, loc, nullptr);
+                ++*numDeleted;
+            }
+            wuow.commit();
+        });
+
+        // A full batch in which nothing could be deleted means its documents are changing under
+        // us, so leave them for the next pass rather than rescanning them.
+        return more && *numDeleted > 0;
     }
 };
 
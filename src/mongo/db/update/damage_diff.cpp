@@ -0,0 +1,191 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/damage_diff.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+namespace damagediff {
+
+namespace {
+
+using mutablebson::DamageEvent;
+using mutablebson::DamageVector;
+
+// The most damage events worth producing for one document. Past this many separate changes, the
+// bookkeeping to apply them costs more than it saves.
+const size_t kMaxDamageEvents = 64;
+
+/**
+ * Builds the damages turning one document into another, in increasing order of their offsets in
+ * the new document. Because every damage before a position has already been applied by the time a
+ * damage at that position is, target offsets are the same as the source offsets in the new
+ * document.
+ */
+class DamageBuilder {
+public:
+    DamageBuilder(const char* newBase, size_t maxDamagedBytes, DamageVector* damages)
+        : _newBase(newBase), _maxDamagedBytes(maxDamagedBytes), _damages(damages) {}
+
+    bool exceeded() const {
+        return _damagedBytes > _maxDamagedBytes || _damages->size() > kMaxDamageEvents;
+    }
+
+    size_t offsetOf(const char* newData) const {
+        return newData - _newBase;
+    }
+
+    /**
+     * Replaces 'targetSize' bytes at 'offset' with the 'size' bytes of the new document at the
+     * same offset.
+     */
+    void replace(size_t offset, size_t size, size_t targetSize) {
+        if (size == 0 && targetSize == 0) {
+            return;
+        }
+        _damagedBytes += size;
+
+        if (!_damages->empty()) {
+            DamageEvent& last = _damages->back();
+            if (last.targetOffset + last.size == offset) {
+                const size_t lastTargetSize = last.getTargetSize();
+                last.size += size;
+                setTargetSize(&last, lastTargetSize + targetSize);
+                return;
+            }
+        }
+
+        DamageEvent damage;
+        damage.sourceOffset = offset;
+        damage.targetOffset = offset;
+        damage.size = size;
+        setTargetSize(&damage, targetSize);
+        _damages->push_back(damage);
+    }
+
+private:
+    static void setTargetSize(DamageEvent* damage, size_t targetSize) {
+        if (targetSize == damage->size) {
+            damage->targetSize = boost::none;
+        } else {
+            damage->targetSize = targetSize;
+        }
+    }
+
+    const char* const _newBase;
+    const size_t _maxDamagedBytes;
+    DamageVector* const _damages;
+    size_t _damagedBytes = 0;
+};
+
+void diffObjects(const BSONObj& oldObj, const BSONObj& newObj, DamageBuilder* builder);
+
+/**
+ * Returns true if an element named 'name' appears at or after position 'start' of an object, given
+ * the last position of each name in that object.
+ */
+bool hasFieldAtOrAfter(const StringMap<size_t>& lastPositions, StringData name, size_t start) {
+    auto it = lastPositions.find(name);
+    return it != lastPositions.end() && it->second >= start;
+}
+
+void diffElements(const BSONElement& oldElt, const BSONElement& newElt, DamageBuilder* builder) {
+    if (oldElt.size() == newElt.size() &&
+        std::memcmp(oldElt.rawdata(), newElt.rawdata(), newElt.size()) == 0) {
+        return;
+    }
+
+    if (oldElt.type() != newElt.type()) {
+        builder->replace(builder->offsetOf(newElt.rawdata()), newElt.size(), oldElt.size());
+    } else if (newElt.type() == BSONType::Object || newElt.type() == BSONType::Array) {
+        diffObjects(oldElt.Obj(), newElt.Obj(), builder);
+    } else {
+        builder->replace(builder->offsetOf(newElt.value()), newElt.valuesize(), oldElt.valuesize());
+    }
+}
+
+void diffObjects(const BSONObj& oldObj, const BSONObj& newObj, DamageBuilder* builder) {
+    const size_t newOffset = builder->offsetOf(newObj.objdata());
+    if (oldObj.objsize() != newObj.objsize()) {
+        builder->replace(newOffset, sizeof(int32_t), sizeof(int32_t));
+    }
+
+    std::vector<BSONElement> oldElts;
+    StringMap<size_t> lastOldPositions;
+    for (auto&& elt : oldObj) {
+        lastOldPositions[elt.fieldNameStringData()] = oldElts.size();
+        oldElts.push_back(elt);
+    }
+    std::vector<BSONElement> newElts(newObj.begin(), newObj.end());
+
+    // Walk both objects in order, comparing same-named elements. An element of the new object
+    // whose name does not appear later in the old one was added. Otherwise the old element was
+    // removed or moved, and is deleted, since deletions do not write any data.
+    const size_t endOffset = newOffset + newObj.objsize() - 1;
+    size_t i = 0;
+    size_t j = 0;
+    while ((i < oldElts.size() || j < newElts.size()) && !builder->exceeded()) {
+        const size_t offset =
+            j < newElts.size() ? builder->offsetOf(newElts[j].rawdata()) : endOffset;
+        if (i == oldElts.size()) {
+            builder->replace(offset, newElts[j++].size(), 0);
+        } else if (j == newElts.size()) {
+            builder->replace(offset, 0, oldElts[i++].size());
+        } else if (oldElts[i].fieldNameStringData() == newElts[j].fieldNameStringData()) {
+            diffElements(oldElts[i++], newElts[j++], builder);
+        } else if (!hasFieldAtOrAfter(lastOldPositions, newElts[j].fieldNameStringData(), i)) {
+            builder->replace(offset, newElts[j++].size(), 0);
+        } else {
+            builder->replace(offset, 0, oldElts[i++].size());
+        }
+    }
+}
+
+}  // namespace
+
+bool computeDamages(const BSONObj& oldDoc,
+                    const BSONObj& newDoc,
+                    size_t maxDamagedBytes,
+                    mutablebson::DamageVector* damages) {
+    damages->clear();
+    DamageBuilder builder(newDoc.objdata(), maxDamagedBytes, damages);
+    diffObjects(oldDoc, newDoc, &builder);
+    return !builder.exceeded();
+}
+
+}  // namespace damagediff
+
+}  // namespace mongo
@@ -0,0 +1,56 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/mutable/damage_vector.h"
+
+namespace mongo {
+
+namespace damagediff {
+
+/**
+ * Computes damages which turn 'oldDoc' into 'newDoc' when applied in order, taking their source
+ * data from 'newDoc'. The damages may grow or shrink the document, and only cover the parts of it
+ * which changed: an element of 'newDoc' which is identical to the element of the same name in
+ * 'oldDoc' is left alone, and changed subdocuments and arrays are compared element by element.
+ *
+ * Returns false if the damages would write more than 'maxDamagedBytes' bytes, in which case
+ * writing all of 'newDoc' is likely to be cheaper and the contents of 'damages' are unspecified.
+ */
+bool computeDamages(const BSONObj& oldDoc,
+                    const BSONObj& newDoc,
+                    size_t maxDamagedBytes,
+                    mutablebson::DamageVector* damages);
+
+}  // namespace damagediff
+
+}  // namespace mongo
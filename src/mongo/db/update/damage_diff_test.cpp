@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/damage_diff.h"
+
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using mutablebson::DamageVector;
+
+/**
+ * Applies 'damages' to 'oldDoc' in order, the way a record store does.
+ */
+BSONObj applyDamages(const BSONObj& oldDoc, const char* source, const DamageVector& damages) {
+    std::string data(oldDoc.objdata(), oldDoc.objsize());
+    for (auto&& damage : damages) {
+        data.replace(
+            damage.targetOffset, damage.getTargetSize(), source + damage.sourceOffset, damage.size);
+    }
+    return BSONObj(data.data()).getOwned();
+}
+
+/**
+ * Computes the damages between 'oldDoc' and 'newDoc', checks that they turn one into the other,
+ * and returns the number of bytes they write.
+ */
+size_t assertDamagesApply(const BSONObj& oldDoc, const BSONObj& newDoc) {
+    DamageVector damages;
+    ASSERT_TRUE(damagediff::computeDamages(oldDoc, newDoc, newDoc.objsize(), &damages));
+
+    const BSONObj result = applyDamages(oldDoc, newDoc.objdata(), damages);
+    ASSERT_EQ(result.objsize(), newDoc.objsize());
+    ASSERT_EQ(0, std::memcmp(result.objdata(), newDoc.objdata(), newDoc.objsize()));
+
+    size_t damagedBytes = 0;
+    for (auto&& damage : damages) {
+        damagedBytes += damage.size;
+    }
+    return damagedBytes;
+}
+
+TEST(DamageDiffTest, IdenticalDocumentsHaveNoDamages) {
+    const BSONObj doc = fromjson("{_id: 1, a: {b: [1, 2, 3]}, c: 'x'}");
+    DamageVector damages;
+    ASSERT_TRUE(damagediff::computeDamages(doc, doc.copy(), doc.objsize(), &damages));
+    ASSERT_TRUE(damages.empty());
+}
+
+TEST(DamageDiffTest, SameSizeValueChangeOnlyDamagesTheValue) {
+    const BSONObj oldDoc = fromjson("{_id: 1, a: 1, b: 2}");
+    const BSONObj newDoc = fromjson("{_id: 1, a: 1, b: 3}");
+    ASSERT_EQ(assertDamagesApply(oldDoc, newDoc), sizeof(int32_t));
+}
+
+TEST(DamageDiffTest, GrowingAndShrinkingValues) {
+    const std::string padding(1000, 'p');
+    const BSONObj oldDoc = BSON("_id" << 1 << "a"
+                                      << "short"
+                                      << "pad"
+                                      << padding
+                                      << "b"
+                                      << "a much longer string");
+    const BSONObj newDoc = BSON("_id" << 1 << "a"
+                                      << "a much longer string"
+                                      << "pad"
+                                      << padding
+                                      << "b"
+                                      << "short");
+    ASSERT_LT(assertDamagesApply(oldDoc, newDoc), 100U);
+}
+
+TEST(DamageDiffTest, AddedAndRemovedFields) {
+    const std::string padding(1000, 'p');
+    const BSONObj oldDoc = BSON("_id" << 1 << "a" << 1 << "pad" << padding << "b" << 2);
+    ASSERT_LT(assertDamagesApply(oldDoc, BSON("_id" << 1 << "pad" << padding << "b" << 2)), 10U);
+    ASSERT_LT(assertDamagesApply(oldDoc, BSON("_id" << 1 << "a" << 1 << "pad" << padding)), 10U);
+    ASSERT_LT(assertDamagesApply(
+                  oldDoc, BSON("_id" << 1 << "a" << 1 << "pad" << padding << "b" << 2 << "c" << 3)),
+              20U);
+    ASSERT_LT(assertDamagesApply(oldDoc, BSON("_id" << 1 << "pad" << padding << "a" << 1)), 30U);
+}
+
+TEST(DamageDiffTest, ChangesInsideSubdocumentsAndArrays) {
+    const std::string padding(1000, 'p');
+    const BSONObj oldDoc =
+        BSON("_id" << 1 << "a" << BSON("pad" << padding << "arr" << BSON_ARRAY(1 << 2)) << "z"
+                   << padding);
+    const BSONObj pushed =
+        BSON("_id" << 1 << "a" << BSON("pad" << padding << "arr" << BSON_ARRAY(1 << 2 << 3))
+                   << "z"
+                   << padding);
+    ASSERT_LT(assertDamagesApply(oldDoc, pushed), 30U);
+
+    const BSONObj pulled =
+        BSON("_id" << 1 << "a" << BSON("pad" << padding << "arr" << BSON_ARRAY(2)) << "z"
+                   << padding);
+    ASSERT_LT(assertDamagesApply(oldDoc, pulled), 30U);
+
+    const BSONObj retyped = BSON("_id" << 1 << "a" << BSON("pad" << padding << "arr"
+                                                                 << "not an array")
+                                       << "z"
+                                       << padding);
+    ASSERT_LT(assertDamagesApply(oldDoc, retyped), 50U);
+}
+
+TEST(DamageDiffTest, FailsWhenDamagesWouldWriteTooMuch) {
+    const std::string a(20, 'a');
+    const std::string b(20, 'b');
+    const BSONObj oldDoc = BSON("_id" << 1 << "a" << a << "b" << b);
+    const BSONObj newDoc = BSON("_id" << 1 << "a" << b << "b" << a);
+    DamageVector damages;
+    ASSERT_FALSE(damagediff::computeDamages(oldDoc, newDoc, 30, &damages));
+    ASSERT_TRUE(damagediff::computeDamages(oldDoc, newDoc, 60, &damages));
+    ASSERT_EQ(damages.size(), 2U);
+}
+
+}  // namespace
+}  // namespace mongo
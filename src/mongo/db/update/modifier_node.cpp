@@ -191,6 +191,8 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
 
     if (!applyParams.indexData || !applyParams.indexData->mightBeIndexed(*applyParams.pathTaken)) {
         applyResult.indexesAffected = false;
+    } else if (applyParams.modifiedIndexedPaths) {
+        applyParams.modifiedIndexedPaths->insert(*applyParams.pathTaken);
     }
 
     if (applyParams.validateForStorage) {
@@ -285,11 +287,12 @@ UpdateNode::ApplyResult ModifierNode::applyToNonexistentElement(ApplyParams appl
         // an index {"a.b": 1}, and we set "a.1.c" and implicitly create an array element in "a",
         // then we may need to add a null key to the index, even though "a.1.c" does not appear to
         // affect the index.
-        if (!applyParams.indexData ||
-            !applyParams.indexData->mightBeIndexed(applyParams.element.getType() != BSONType::Array
-                                                       ? fullPath
-                                                       : *applyParams.pathTaken)) {
+        const FieldRef& indexedPath =
+            applyParams.element.getType() != BSONType::Array ? fullPath : *applyParams.pathTaken;
+        if (!applyParams.indexData || !applyParams.indexData->mightBeIndexed(indexedPath)) {
             applyResult.indexesAffected = false;
+        } else if (applyParams.modifiedIndexedPaths) {
+            applyParams.modifiedIndexedPaths->insert(indexedPath);
         }
 
         if (applyParams.logBuilder) {
@@ -247,6 +247,7 @@ Status UpdateDriver::update(StringData matchedField,
     // TODO: assert that update() is called at most once in a !_multi case.
 
     _affectIndices = (isDocReplacement() && (_indexedFields != NULL));
+    _modifiedIndexedPaths.clear();
 
     _logDoc.reset();
     LogBuilder logBuilder(_logDoc.root());
@@ -257,6 +258,7 @@ Status UpdateDriver::update(StringData matchedField,
     applyParams.fromOplogApplication = _fromOplogApplication;
     applyParams.validateForStorage = validateForStorage;
     applyParams.indexData = _indexedFields;
+    applyParams.modifiedIndexedPaths = &_modifiedIndexedPaths;
     if (_logOp && logOpRec) {
         applyParams.logBuilder = &logBuilder;
     }
@@ -296,6 +298,13 @@ bool UpdateDriver::modsAffectIndices() const {
     return _affectIndices;
 }
 
+const std::set<FieldRef>* UpdateDriver::getModifiedIndexedPaths() const {
+    if (isDocReplacement() || _modifiedIndexedPaths.empty()) {
+        return nullptr;
+    }
+    return &_modifiedIndexedPaths;
+}
+
 void UpdateDriver::refreshIndexKeys(const UpdateIndexData* indexedFields) {
     _indexedFields = indexedFields;
 }
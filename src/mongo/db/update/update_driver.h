@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -111,6 +112,13 @@ public:
     bool modsAffectIndices() const;
     void refreshIndexKeys(const UpdateIndexData* indexedFields);
 
+    /**
+     * Returns the paths modified by the last call to update() which might be indexed, so that
+     * only the indexes depending on one of them need new keys. Returns nullptr if every index
+     * must be considered affected, as for a replacement-style update.
+     */
+    const std::set<FieldRef>* getModifiedIndexedPaths() const;
+
     bool logOp() const;
     void setLogOp(bool logOp);
 
@@ -177,6 +185,9 @@ private:
     // at each call to update.
     bool _affectIndices = false;
 
+    // The paths modified by the last update which might be indexed.
+    std::set<FieldRef> _modifiedIndexedPaths;
+
     // Do any of the mods require positional match details when calling 'prepare'?
     bool _positional = false;
 
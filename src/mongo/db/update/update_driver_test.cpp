@@ -162,6 +162,63 @@ TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     ASSERT_TRUE(modified);
 }
 
+TEST(ModifiedIndexedPaths, OnlyPathsWhichMightBeIndexedAreReported) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateIndexData indexData;
+    indexData.addPath(FieldRef("a.b"));
+    indexData.addPath(FieldRef("c"));
+    UpdateDriver driver(expCtx);
+    driver.refreshIndexKeys(&indexData);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_DOES_NOT_THROW(
+        driver.parse(fromjson("{$set: {'a.b.0': 1, d: 1}, $inc: {'c.e': 1}}"), arrayFilters));
+
+    const FieldRefSet emptyImmutablePaths;
+    mutablebson::Document doc(fromjson("{a: {b: [0]}, c: {e: 1}, d: 0}"));
+    ASSERT_OK(driver.update(StringData(), &doc, true, emptyImmutablePaths));
+
+    ASSERT_TRUE(driver.modsAffectIndices());
+    auto modifiedPaths = driver.getModifiedIndexedPaths();
+    ASSERT(modifiedPaths);
+    ASSERT_EQ(modifiedPaths->size(), 2U);
+    ASSERT_EQ(modifiedPaths->count(FieldRef("a.b.0")), 1U);
+    ASSERT_EQ(modifiedPaths->count(FieldRef("c.e")), 1U);
+}
+
+TEST(ModifiedIndexedPaths, NoPathsReportedWhenIndexesAreNotAffected) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateIndexData indexData;
+    indexData.addPath(FieldRef("a"));
+    UpdateDriver driver(expCtx);
+    driver.refreshIndexKeys(&indexData);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_DOES_NOT_THROW(driver.parse(fromjson("{$set: {b: 1}}"), arrayFilters));
+
+    const FieldRefSet emptyImmutablePaths;
+    mutablebson::Document doc(fromjson("{a: 1}"));
+    ASSERT_OK(driver.update(StringData(), &doc, true, emptyImmutablePaths));
+
+    ASSERT_FALSE(driver.modsAffectIndices());
+    ASSERT_FALSE(driver.getModifiedIndexedPaths());
+}
+
+TEST(ModifiedIndexedPaths, ReplacementAffectsEveryIndex) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateIndexData indexData;
+    indexData.addPath(FieldRef("a"));
+    UpdateDriver driver(expCtx);
+    driver.refreshIndexKeys(&indexData);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    ASSERT_DOES_NOT_THROW(driver.parse(fromjson("{a: 2}"), arrayFilters));
+
+    const FieldRefSet emptyImmutablePaths;
+    mutablebson::Document doc(fromjson("{a: 1}"));
+    ASSERT_OK(driver.update(StringData(), &doc, true, emptyImmutablePaths));
+
+    ASSERT_TRUE(driver.modsAffectIndices());
+    ASSERT_FALSE(driver.getModifiedIndexedPaths());
+}
+
 //
 // Tests of creating a base for an upsert from a query document
 // $or, $and, $all get special handling, as does the _id field
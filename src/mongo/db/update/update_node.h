@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <set>
 
 #include "mongo/bson/bsonelement.h"
 #include "mongo/bson/mutable/element.h"
@@ -119,6 +120,9 @@ public:
         // Used to determine whether indexes are affected.
         const UpdateIndexData* indexData = nullptr;
 
+        // If provided, the path of each modification which might affect an index is added here.
+        std::set<FieldRef>* modifiedIndexedPaths = nullptr;
+
         // If provided, UpdateNode::apply will log the update here.
         LogBuilder* logBuilder = nullptr;
     };
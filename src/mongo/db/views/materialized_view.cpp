@@ -0,0 +1,531 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/views/materialized_view.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog_entry.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/ops/delete.h"
+#include "mongo/db/ops/update.h"
+#include "mongo/db/ops/update_lifecycle_impl.h"
+#include "mongo/db/ops/update_request.h"
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/parsed_aggregation_projection.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using parsed_aggregation_projection::ParsedAggregationProjection;
+
+namespace {
+
+const auto getMaterializedViewCatalog =
+    ServiceContext::declareDecoration<MaterializedViewCatalog>();
+
+// The number of source documents added to a view at a time while it is populated.
+const size_t kPopulateBatchSize = 1000;
+
+/**
+ * The stages of a materialized view, parsed for use by one operation.
+ */
+class CompiledView {
+public:
+    CompiledView(OperationContext* opCtx,
+                 const std::vector<BSONObj>& stages,
+                 const BSONObj& group)
+        : _expCtx(new ExpressionContext(opCtx, nullptr)) {
+        for (auto&& stageObj : stages) {
+            auto spec = stageObj.firstElement();
+            if (spec.fieldNameStringData() == "$match"_sd) {
+                Stage stage;
+                stage.match = uassertStatusOK(
+                    MatchExpressionParser::parse(spec.Obj(),
+                                                 _expCtx,
+                                                 ExtensionsCallbackNoop(),
+                                                 MatchExpressionParser::kBanAllSpecialFeatures));
+                _stages.push_back(std::move(stage));
+            } else {
+                Stage stage;
+                stage.project = ParsedAggregationProjection::create(
+                    _expCtx,
+                    spec.Obj(),
+                    ParsedAggregationProjection::ProjectionDefaultIdPolicy::kIncludeId,
+                    ParsedAggregationProjection::ProjectionArrayRecursionPolicy::
+                        kRecurseNestedArrays);
+                _stages.push_back(std::move(stage));
+            }
+        }
+
+        for (auto&& field : group) {
+            if (field.fieldNameStringData() == "_id"_sd) {
+                _groupId =
+                    Expression::parseOperand(_expCtx, field, _expCtx->variablesParseState);
+            } else {
+                _sumFields.push_back(field.fieldName());
+                _sumArgs.push_back(Expression::parseOperand(
+                    _expCtx, field.Obj().firstElement(), _expCtx->variablesParseState));
+            }
+        }
+    }
+
+    const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
+        return _expCtx;
+    }
+
+    /**
+     * Returns the result of the $match and $project stages for the source document 'doc', or
+     * boost::none if a $match filters it out.
+     */
+    boost::optional<Document> transform(const BSONObj& doc) const {
+        Document current(doc);
+        BSONObj currentBson = doc;
+        bool bsonIsCurrent = true;
+        for (auto&& stage : _stages) {
+            if (stage.match) {
+                if (!bsonIsCurrent) {
+                    currentBson = current.toBson();
+                    bsonIsCurrent = true;
+                }
+                if (!stage.match->matchesBSON(currentBson)) {
+                    return boost::none;
+                }
+            } else {
+                current = stage.project->applyTransformation(current);
+                bsonIsCurrent = false;
+            }
+        }
+        return current;
+    }
+
+    /**
+     * Returns the group of the transformed document 'doc'.
+     */
+    Value groupKey(const Document& doc) const {
+        Value key = _groupId->evaluate(doc);
+        uassert(51017,
+                "The _id of a group of a materialized view cannot be an array",
+                key.getType() != BSONType::Array);
+        return key.missing() ? Value(BSONNULL) : key;
+    }
+
+    /**
+     * Returns the values which the transformed document 'doc' contributes to each sum.
+     */
+    std::vector<Value> contributions(const Document& doc) const {
+        std::vector<Value> values;
+        for (auto&& arg : _sumArgs) {
+            values.push_back(arg->evaluate(doc));
+        }
+        return values;
+    }
+
+    const std::vector<std::string>& sumFields() const {
+        return _sumFields;
+    }
+
+private:
+    struct Stage {
+        std::unique_ptr<MatchExpression> match;
+        std::unique_ptr<ParsedAggregationProjection> project;
+    };
+
+    boost::intrusive_ptr<ExpressionContext> _expCtx;
+    std::vector<Stage> _stages;
+    boost::intrusive_ptr<Expression> _groupId;
+    std::vector<std::string> _sumFields;
+    std::vector<boost::intrusive_ptr<Expression>> _sumArgs;
+};
+
+/**
+ * Returns the contribution of 'value' to a sum, negated. Values which are not numbers do not
+ * contribute to a sum, and are returned unchanged.
+ */
+Value negate(const Value& value) {
+    switch (value.getType()) {
+        case NumberInt:
+            if (value.getInt() == std::numeric_limits<int>::min()) {
+                return Value(-static_cast<long long>(value.getInt()));
+            }
+            return Value(-value.getInt());
+        case NumberLong:
+            if (value.getLong() == std::numeric_limits<long long>::min()) {
+                return Value(-value.coerceToDouble());
+            }
+            return Value(-value.getLong());
+        case NumberDouble:
+            return Value(-value.getDouble());
+        case NumberDecimal:
+            return Value(value.getDecimal().negate());
+        default:
+            return value;
+    }
+}
+
+void upsert(OperationContext* opCtx,
+            Database* db,
+            const NamespaceString& nss,
+            const BSONObj& query,
+            const BSONObj& update) {
+    UpdateRequest request(nss);
+    request.setQuery(query);
+    request.setUpdates(update);
+    request.setUpsert();
+    UpdateLifecycleImpl updateLifecycle(nss);
+    request.setLifecycle(&updateLifecycle);
+    ::mongo::update(opCtx, db, request);
+}
+
+Status checkStage(const BSONElement& stageElem, bool isLast) {
+    if (stageElem.type() != BSONType::Object || stageElem.Obj().nFields() != 1) {
+        return {ErrorCodes::InvalidOptions,
+                "Each stage of a materialized view must be an object with one field"};
+    }
+
+    const auto spec = stageElem.Obj().firstElement();
+    const auto stageName = spec.fieldNameStringData();
+    if (spec.type() != BSONType::Object) {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "The specification of " << stageName << " must be an object"};
+    }
+
+    if (stageName == "$match"_sd) {
+        return Status::OK();
+    }
+
+    if (stageName == "$project"_sd) {
+        // Without a $group, the documents of the view are keyed by the _id of their source.
+        for (auto&& field : spec.Obj()) {
+            const auto fieldName = field.fieldNameStringData();
+            if (fieldName.startsWith("_id.") ||
+                (fieldName == "_id"_sd && !(field.isBoolean() || field.isNumber()))) {
+                return {ErrorCodes::InvalidOptions,
+                        "A $project stage of a materialized view cannot change the _id"};
+            }
+            if (fieldName == "_id"_sd && !field.trueValue()) {
+                return {ErrorCodes::InvalidOptions,
+                        "A $project stage of a materialized view cannot exclude the _id"};
+            }
+        }
+        return Status::OK();
+    }
+
+    if (stageName == "$group"_sd) {
+        if (!isLast) {
+            return {ErrorCodes::InvalidOptions,
+                    "$group must be the last stage of a materialized view"};
+        }
+        if (!spec.Obj().hasField("_id")) {
+            return {ErrorCodes::InvalidOptions, "$group requires an _id"};
+        }
+        bool hasCount = false;
+        for (auto&& field : spec.Obj()) {
+            if (field.fieldNameStringData() == "_id"_sd) {
+                continue;
+            }
+            if (field.type() != BSONType::Object || field.Obj().nFields() != 1 ||
+                field.Obj().firstElementFieldName() != "$sum"_sd) {
+                return {ErrorCodes::InvalidOptions,
+                        str::stream() << "The accumulators of a materialized view must be $sum, "
+                                      << "but '" << field.fieldNameStringData() << "' is not"};
+            }
+            const auto arg = field.Obj().firstElement();
+            hasCount = hasCount || (arg.isNumber() && arg.numberDouble() == 1);
+        }
+        if (!hasCount) {
+            return {ErrorCodes::InvalidOptions,
+                    "The $group of a materialized view must count its documents with {$sum: 1}"};
+        }
+        return Status::OK();
+    }
+
+    return {ErrorCodes::InvalidOptions,
+            str::stream() << stageName << " is not supported in a materialized view; only $match, "
+                          << "$project and a final $group can be maintained incrementally"};
+}
+
+}  // namespace
+
+MaterializedView::MaterializedView(NamespaceString nss, NamespaceString source, BSONObj spec)
+    : _nss(std::move(nss)), _source(std::move(source)), _spec(std::move(spec)) {}
+
+StatusWith<std::shared_ptr<const MaterializedView>> MaterializedView::parse(
+    OperationContext* opCtx, const NamespaceString& nss, const BSONObj& spec) {
+    const NamespaceString source(nss.db(), spec["on"].valueStringData());
+    if (!source.isValid() || source == nss || source.isSystem() || nss.isSystem() ||
+        nss.isOnInternalDb()) {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "Cannot maintain " << nss.ns() << " as a materialized view of "
+                              << source.ns()};
+    }
+
+    std::shared_ptr<MaterializedView> view(new MaterializedView(nss, source, spec.getOwned()));
+    const auto pipeline = view->_spec["pipeline"].Obj();
+    const int numStages = pipeline.nFields();
+    int stageIndex = 0;
+    for (auto&& stageElem : pipeline) {
+        auto status = checkStage(stageElem, ++stageIndex == numStages);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        const auto spec = stageElem.Obj().firstElement();
+        if (spec.fieldNameStringData() == "$group"_sd) {
+            view->_group = spec.Obj();
+            for (auto&& field : view->_group) {
+                const auto arg = field.isABSONObj() ? field.Obj().firstElement() : BSONElement();
+                if (field.fieldNameStringData() != "_id"_sd && arg.isNumber() &&
+                    arg.numberDouble() == 1) {
+                    view->_countField = field.fieldName();
+                    break;
+                }
+            }
+        } else {
+            view->_stages.push_back(stageElem.Obj());
+        }
+    }
+
+    // Check that the expressions of the stages parse.
+    try {
+        CompiledView(opCtx, view->_stages, view->_group);
+    } catch (const DBException& ex) {
+        return ex.toStatus().withContext("Invalid materialized view pipeline");
+    }
+
+    return {std::move(view)};
+}
+
+void MaterializedView::applyChanges(OperationContext* opCtx,
+                                    const std::vector<BSONObj>& removed,
+                                    const std::vector<BSONObj>& added) const {
+    if (removed.empty() && added.empty()) {
+        return;
+    }
+
+    Lock::CollectionLock collLock(opCtx->lockState(), _nss.ns(), MODE_IX);
+    Database* db = DatabaseHolder::getDatabaseHolder().get(opCtx, _nss.db());
+    Collection* collection = db ? db->getCollection(opCtx, _nss) : nullptr;
+    if (!collection) {
+        // The view has been dropped.
+        return;
+    }
+
+    CompiledView compiled(opCtx, _stages, _group);
+    const auto& valueComparator = compiled.getExpressionContext()->getValueComparator();
+
+    if (!isGrouped()) {
+        // Replace the view document of each added source document which passes the filters, and
+        // delete those of the removed source documents which are not replaced.
+        auto replacedIds = valueComparator.makeUnorderedValueSet();
+        for (auto&& doc : added) {
+            auto result = compiled.transform(doc);
+            if (!result) {
+                continue;
+            }
+            const auto resultBson = result->toBson();
+            const auto id = resultBson["_id"];
+            replacedIds.insert(Value(id));
+            upsert(opCtx, db, _nss, id.wrap(), resultBson);
+        }
+        for (auto&& doc : removed) {
+            const auto id = doc["_id"];
+            if (!replacedIds.count(Value(id))) {
+                deleteObjects(opCtx, collection, _nss, id.wrap(), true /* justOne */);
+            }
+        }
+        return;
+    }
+
+    // Sum the changes to each group, so that each group is written once.
+    auto groups = valueComparator
+                      .makeUnorderedValueMap<std::vector<boost::intrusive_ptr<Accumulator>>>();
+    const auto& sumFields = compiled.sumFields();
+    auto addToGroups = [&](const std::vector<BSONObj>& docs, bool isRemoval) {
+        for (auto&& doc : docs) {
+            auto result = compiled.transform(doc);
+            if (!result) {
+                continue;
+            }
+
+            auto& sums = groups[compiled.groupKey(*result)];
+            if (sums.empty()) {
+                for (size_t i = 0; i < sumFields.size(); ++i) {
+                    sums.push_back(AccumulatorSum::create(compiled.getExpressionContext()));
+                }
+            }
+
+            auto contributions = compiled.contributions(*result);
+            for (size_t i = 0; i < sums.size(); ++i) {
+                sums[i]->process(isRemoval ? negate(contributions[i]) : contributions[i], false);
+            }
+        }
+    };
+    addToGroups(removed, true);
+    addToGroups(added, false);
+
+    for (auto&& group : groups) {
+        BSONObjBuilder queryBuilder;
+        group.first.addToBsonObj(&queryBuilder, "_id");
+        const auto query = queryBuilder.obj();
+
+        BSONObjBuilder incBuilder;
+        bool countDecreased = false;
+        for (size_t i = 0; i < sumFields.size(); ++i) {
+            const auto sum = group.second[i]->getValue(false);
+            sum.addToBsonObj(&incBuilder, sumFields[i]);
+            if (sumFields[i] == _countField) {
+                countDecreased = sum.coerceToLong() < 0;
+            }
+        }
+        upsert(opCtx, db, _nss, query, BSON("$inc" << incBuilder.obj()));
+
+        // A group which no longer has any documents is removed.
+        if (countDecreased) {
+            deleteObjects(opCtx,
+                          collection,
+                          _nss,
+                          BSONObjBuilder(query).append(_countField, BSON("$lte" << 0)).obj(),
+                          true /* justOne */);
+        }
+    }
+}
+
+void MaterializedView::populate(OperationContext* opCtx) const {
+    invariant(opCtx->lockState()->isDbLockedForMode(_nss.db(), MODE_X));
+    Database* db = DatabaseHolder::getDatabaseHolder().get(opCtx, _nss.db());
+    Collection* source = db ? db->getCollection(opCtx, _source) : nullptr;
+    if (!source) {
+        return;
+    }
+
+    std::vector<BSONObj> batch;
+    auto cursor = source->getCursor(opCtx);
+    while (auto record = cursor->next()) {
+        batch.push_back(record->data.releaseToBson().getOwned());
+        if (batch.size() == kPopulateBatchSize) {
+            opCtx->checkForInterrupt();
+            applyChanges(opCtx, {}, batch);
+            batch.clear();
+        }
+    }
+    applyChanges(opCtx, {}, batch);
+}
+
+void MaterializedView::clear(OperationContext* opCtx) const {
+    invariant(opCtx->lockState()->isDbLockedForMode(_nss.db(), MODE_X));
+    Database* db = DatabaseHolder::getDatabaseHolder().get(opCtx, _nss.db());
+    if (Collection* collection = db ? db->getCollection(opCtx, _nss) : nullptr) {
+        deleteObjects(opCtx, collection, _nss, BSONObj(), false /* justOne */);
+    }
+}
+
+MaterializedViewCatalog& MaterializedViewCatalog::get(ServiceContext* service) {
+    return getMaterializedViewCatalog(service);
+}
+
+MaterializedViewCatalog::ViewList MaterializedViewCatalog::lookupBySource(
+    OperationContext* opCtx, const NamespaceString& source) {
+    std::shared_ptr<const DatabaseViews> views;
+    unsigned long long generation;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _databases.find(source.db());
+        if (it != _databases.end()) {
+            views = it->second;
+        }
+        generation = _generation;
+    }
+
+    if (!views) {
+        views = _load(opCtx, source.db());
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_generation == generation) {
+            _databases[source.db()] = views;
+        }
+    }
+
+    auto it = views->find(source.ns());
+    return it == views->end() ? ViewList() : it->second;
+}
+
+void MaterializedViewCatalog::invalidate(StringData dbName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _databases.erase(dbName);
+    ++_generation;
+}
+
+void MaterializedViewCatalog::invalidateAll() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _databases.clear();
+    ++_generation;
+}
+
+std::shared_ptr<const MaterializedViewCatalog::DatabaseViews> MaterializedViewCatalog::_load(
+    OperationContext* opCtx, StringData dbName) {
+    auto views = std::make_shared<DatabaseViews>();
+    Database* db = DatabaseHolder::getDatabaseHolder().get(opCtx, dbName);
+    if (!db) {
+        return views;
+    }
+
+    for (auto&& collection : *db) {
+        const auto options = collection->getCatalogEntry()->getCollectionOptions(opCtx);
+        if (options.materializedView.isEmpty()) {
+            continue;
+        }
+
+        auto view = MaterializedView::parse(opCtx, collection->ns(), options.materializedView);
+        if (!view.isOK()) {
+            warning() << "Not maintaining materialized view " << collection->ns()
+                      << ": " << view.getStatus();
+            continue;
+        }
+        (*views)[view.getValue()->source().ns()].push_back(std::move(view.getValue()));
+    }
+    return views;
+}
+
+}  // namespace mongo
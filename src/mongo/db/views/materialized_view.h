@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A materialized view is a collection created with the 'materializedView' option
+ * {on: <collection>, pipeline: [<stages>]}. It holds the results of the pipeline over the source
+ * collection 'on', and is maintained incrementally as the source is written, so that reading it is
+ * a plain collection read.
+ *
+ * Only pipelines which can be maintained one source document at a time are supported: any number
+ * of $match and $project stages which keep the _id of their input, optionally followed by a final
+ * $group whose accumulators are all $sum and which counts its documents with {$sum: 1}. Without a
+ * $group, the view holds one document per matching source document, with the same _id. With one,
+ * it holds one document per group, and each source change adds to or subtracts from the sums of
+ * the groups it contributes to.
+ */
+class MaterializedView {
+    MONGO_DISALLOW_COPYING(MaterializedView);
+
+public:
+    /**
+     * Parses the 'materializedView' option 'spec' of the collection 'nss'. Returns an error if the
+     * pipeline has a stage or expression which cannot be maintained incrementally.
+     */
+    static StatusWith<std::shared_ptr<const MaterializedView>> parse(OperationContext* opCtx,
+                                                                     const NamespaceString& nss,
+                                                                     const BSONObj& spec);
+
+    const NamespaceString& nss() const {
+        return _nss;
+    }
+
+    const NamespaceString& source() const {
+        return _source;
+    }
+
+    /**
+     * Returns true if the view has a $group stage, and so needs the pre-image of updated documents.
+     */
+    bool isGrouped() const {
+        return !_group.isEmpty();
+    }
+
+    /**
+     * Updates the view for the removal of the 'removed' source documents and the addition of the
+     * 'added' ones. An update is the removal of its pre-image and the addition of its post-image.
+     * The caller must hold a lock on the database, and the writes join its WriteUnitOfWork.
+     */
+    void applyChanges(OperationContext* opCtx,
+                      const std::vector<BSONObj>& removed,
+                      const std::vector<BSONObj>& added) const;
+
+    /**
+     * Adds every document of the source collection to the view, or removes every document from the
+     * view. The caller must hold the database lock in mode X.
+     */
+    void populate(OperationContext* opCtx) const;
+    void clear(OperationContext* opCtx) const;
+
+private:
+    MaterializedView(NamespaceString nss, NamespaceString source, BSONObj spec);
+
+    const NamespaceString _nss;
+    const NamespaceString _source;
+
+    // Owns the BSON which '_stages' and '_group' point into.
+    const BSONObj _spec;
+
+    // The $match and $project stages, in order.
+    std::vector<BSONObj> _stages;
+
+    // The specification of the final $group, or empty, and the field of the $group which counts
+    // the documents of each group.
+    BSONObj _group;
+    std::string _countField;
+};
+
+/**
+ * Finds the materialized views maintained from each collection. The views of a database are read
+ * from its catalog the first time one of its collections is written, and read again after a
+ * collection of the database is created, dropped or renamed.
+ */
+class MaterializedViewCatalog {
+    MONGO_DISALLOW_COPYING(MaterializedViewCatalog);
+
+public:
+    using ViewList = std::vector<std::shared_ptr<const MaterializedView>>;
+
+    static MaterializedViewCatalog& get(ServiceContext* service);
+
+    MaterializedViewCatalog() = default;
+
+    /**
+     * Returns the materialized views of the collection 'source'. The caller must hold a lock on its
+     * database.
+     */
+    ViewList lookupBySource(OperationContext* opCtx, const NamespaceString& source);
+
+    /**
+     * Forgets the views of the database 'dbName', or of every database, so that they are read from
+     * the catalog again when next needed.
+     */
+    void invalidate(StringData dbName);
+    void invalidateAll();
+
+private:
+    // The views of one database, by the full namespace of their source.
+    using DatabaseViews = StringMap<ViewList>;
+
+    std::shared_ptr<const DatabaseViews> _load(OperationContext* opCtx, StringData dbName);
+
+    stdx::mutex _mutex;
+    StringMap<std::shared_ptr<const DatabaseViews>> _databases;
+
+    // Incremented by every invalidation, so that views read before one are not remembered.
+    unsigned long long _generation = 0;
+};
+
+}  // namespace mongo
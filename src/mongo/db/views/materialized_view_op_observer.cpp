@@ -0,0 +1,232 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/views/materialized_view_op_observer.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog_entry.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/views/materialized_view.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// The document which the operation is about to delete, kept from aboutToDelete() to onDelete().
+const auto getDocumentToDelete = OperationContext::declareDecoration<boost::optional<BSONObj>>();
+
+bool isMaintained(OperationContext* opCtx, const NamespaceString& nss) {
+    return opCtx->writesAreReplicated() && !nss.isSystem() && !nss.isOnInternalDb();
+}
+
+MaterializedViewCatalog::ViewList lookupViews(OperationContext* opCtx, const NamespaceString& nss) {
+    if (!isMaintained(opCtx, nss)) {
+        return {};
+    }
+    return MaterializedViewCatalog::get(opCtx->getServiceContext()).lookupBySource(opCtx, nss);
+}
+
+/**
+ * Forgets the views of the database 'dbName' now, and again when the catalog change which the
+ * caller is making commits or rolls back.
+ */
+void invalidateViews(OperationContext* opCtx, StringData dbName) {
+    auto& catalog = MaterializedViewCatalog::get(opCtx->getServiceContext());
+    catalog.invalidate(dbName);
+    if (opCtx->lockState()->inAWriteUnitOfWork()) {
+        const std::string db = dbName.toString();
+        opCtx->recoveryUnit()->onCommit(
+            [&catalog, db](boost::optional<Timestamp>) { catalog.invalidate(db); });
+        opCtx->recoveryUnit()->onRollback([&catalog, db] { catalog.invalidate(db); });
+    }
+}
+
+}  // namespace
+
+void MaterializedViewOpObserver::onInserts(OperationContext* opCtx,
+                                           const NamespaceString& nss,
+                                           OptionalCollectionUUID uuid,
+                                           std::vector<InsertStatement>::const_iterator begin,
+                                           std::vector<InsertStatement>::const_iterator end,
+                                           bool fromMigrate) {
+    const auto views = lookupViews(opCtx, nss);
+    if (views.empty()) {
+        return;
+    }
+
+    std::vector<BSONObj> added;
+    for (auto it = begin; it != end; ++it) {
+        added.push_back(it->doc);
+    }
+    for (auto&& view : views) {
+        view->applyChanges(opCtx, {}, added);
+    }
+}
+
+void MaterializedViewOpObserver::onUpdate(OperationContext* opCtx,
+                                          const OplogUpdateEntryArgs& args) {
+    const auto views = lookupViews(opCtx, args.nss);
+    for (auto&& view : views) {
+        const auto& preImage = args.updateArgs.preImageDoc;
+        uassert(51018,
+                str::stream() << "Cannot maintain the materialized view " << view->nss().ns()
+                              << " without the pre-image of an update to " << args.nss.ns(),
+                preImage || !view->isGrouped());
+
+        // Without a $group, only the _id of the removed document is needed, and an update cannot
+        // change the _id.
+        const auto& updatedDoc = args.updateArgs.updatedDoc;
+        view->applyChanges(opCtx, {preImage ? *preImage : updatedDoc}, {updatedDoc});
+    }
+}
+
+void MaterializedViewOpObserver::aboutToDelete(OperationContext* opCtx,
+                                               const NamespaceString& nss,
+                                               const BSONObj& doc) {
+    auto& documentToDelete = getDocumentToDelete(opCtx);
+    documentToDelete = boost::none;
+    if (!lookupViews(opCtx, nss).empty()) {
+        documentToDelete = doc.getOwned();
+    }
+}
+
+void MaterializedViewOpObserver::onDelete(OperationContext* opCtx,
+                                          const NamespaceString& nss,
+                                          OptionalCollectionUUID uuid,
+                                          StmtId stmtId,
+                                          bool fromMigrate,
+                                          const boost::optional<BSONObj>& deletedDoc) {
+    auto& documentToDelete = getDocumentToDelete(opCtx);
+    if (!documentToDelete) {
+        return;
+    }
+
+    const BSONObj doc = std::move(*documentToDelete);
+    documentToDelete = boost::none;
+    for (auto&& view : lookupViews(opCtx, nss)) {
+        view->applyChanges(opCtx, {doc}, {});
+    }
+}
+
+void MaterializedViewOpObserver::onCreateCollection(OperationContext* opCtx,
+                                                    Collection* coll,
+                                                    const NamespaceString& collectionName,
+                                                    const CollectionOptions& options,
+                                                    const BSONObj& idIndex,
+                                                    const OplogSlot& createOpTime) {
+    if (options.materializedView.isEmpty()) {
+        return;
+    }
+
+    invalidateViews(opCtx, collectionName.db());
+    if (!opCtx->writesAreReplicated()) {
+        // The documents of the view are replicated by the primary which populates it.
+        return;
+    }
+
+    auto view = uassertStatusOK(
+        MaterializedView::parse(opCtx, collectionName, options.materializedView));
+
+    // Views are maintained from ordinary collections only, so that one write never cascades.
+    Database* db = DatabaseHolder::getDatabaseHolder().get(opCtx, collectionName.db());
+    Collection* source = db ? db->getCollection(opCtx, view->source()) : nullptr;
+    uassert(51015,
+            str::stream() << "Cannot maintain a materialized view of " << view->source().ns()
+                          << ", which is itself a materialized view",
+            !source ||
+                source->getCatalogEntry()->getCollectionOptions(opCtx).materializedView.isEmpty());
+    uassert(51016,
+            str::stream() << "Cannot create the materialized view " << collectionName.ns()
+                          << " because other materialized views are maintained from it",
+            MaterializedViewCatalog::get(opCtx->getServiceContext())
+                .lookupBySource(opCtx, collectionName)
+                .empty());
+
+    view->populate(opCtx);
+}
+
+void MaterializedViewOpObserver::onDropDatabase(OperationContext* opCtx,
+                                                const std::string& dbName) {
+    invalidateViews(opCtx, dbName);
+}
+
+repl::OpTime MaterializedViewOpObserver::onDropCollection(OperationContext* opCtx,
+                                                          const NamespaceString& collectionName,
+                                                          OptionalCollectionUUID uuid) {
+    // The views of a dropped collection are emptied, and filled again if a collection of the same
+    // name is created.
+    for (auto&& view : lookupViews(opCtx, collectionName)) {
+        view->clear(opCtx);
+    }
+    invalidateViews(opCtx, collectionName.db());
+    return {};
+}
+
+void MaterializedViewOpObserver::onRenameCollection(OperationContext* opCtx,
+                                                    const NamespaceString& fromCollection,
+                                                    const NamespaceString& toCollection,
+                                                    OptionalCollectionUUID uuid,
+                                                    OptionalCollectionUUID dropTargetUUID,
+                                                    bool stayTemp) {
+    postRenameCollection(opCtx, fromCollection, toCollection, uuid, dropTargetUUID, stayTemp);
+}
+
+void MaterializedViewOpObserver::postRenameCollection(OperationContext* opCtx,
+                                                      const NamespaceString& fromCollection,
+                                                      const NamespaceString& toCollection,
+                                                      OptionalCollectionUUID uuid,
+                                                      OptionalCollectionUUID dropTargetUUID,
+                                                      bool stayTemp) {
+    invalidateViews(opCtx, fromCollection.db());
+    invalidateViews(opCtx, toCollection.db());
+
+    // Views name their source, so the views of the old name lose it, and those of the new name
+    // are filled from the renamed collection.
+    for (auto&& view : lookupViews(opCtx, fromCollection)) {
+        view->clear(opCtx);
+    }
+    for (auto&& view : lookupViews(opCtx, toCollection)) {
+        view->clear(opCtx);
+        view->populate(opCtx);
+    }
+}
+
+void MaterializedViewOpObserver::onReplicationRollback(OperationContext* opCtx,
+                                                       const RollbackObserverInfo& rbInfo) {
+    MaterializedViewCatalog::get(opCtx->getServiceContext()).invalidateAll();
+}
+
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/views/materialized_view.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString viewNss("testdb.view");
+
+Status parseView(const BSONArray& pipeline) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    return MaterializedView::parse(
+               opCtx.get(), viewNss, BSON("on" << "coll" << "pipeline" << pipeline))
+        .getStatus();
+}
+
+TEST(MaterializedViewTest, ParsesMatchAndProject) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto project = BSON("b" << BSON("$add" << BSON_ARRAY("$a" << 1)));
+    auto view = MaterializedView::parse(
+        opCtx.get(),
+        viewNss,
+        BSON("on" << "coll" << "pipeline"
+                  << BSON_ARRAY(BSON("$match" << BSON("a" << 1)) << BSON("$project" << project))));
+    ASSERT_OK(view.getStatus());
+    ASSERT_EQ(view.getValue()->source(), NamespaceString("testdb.coll"));
+    ASSERT_FALSE(view.getValue()->isGrouped());
+}
+
+TEST(MaterializedViewTest, ParsesFinalGroupOfSums) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto view = MaterializedView::parse(
+        opCtx.get(),
+        viewNss,
+        BSON("on" << "coll" << "pipeline"
+                  << BSON_ARRAY(BSON("$group" << BSON("_id"
+                                                      << "$k"
+                                                      << "n"
+                                                      << BSON("$sum" << 1)
+                                                      << "total"
+                                                      << BSON("$sum"
+                                                              << "$x"))))));
+    ASSERT_OK(view.getStatus());
+    ASSERT_TRUE(view.getValue()->isGrouped());
+}
+
+TEST(MaterializedViewTest, RejectsStagesWhichCannotBeMaintained) {
+    ASSERT_EQ(parseView(BSON_ARRAY(BSON("$sort" << BSON("a" << 1)))), ErrorCodes::InvalidOptions);
+    ASSERT_EQ(parseView(BSON_ARRAY(BSON("$limit" << 1))), ErrorCodes::InvalidOptions);
+    ASSERT_EQ(parseView(BSON_ARRAY(BSON("$group" << BSON("_id"
+                                                         << "$k"
+                                                         << "n"
+                                                         << BSON("$sum" << 1)))
+                                   << BSON("$match" << BSON("n" << 1)))),
+              ErrorCodes::InvalidOptions);
+}
+
+TEST(MaterializedViewTest, RejectsProjectionsWhichChangeTheId) {
+    ASSERT_EQ(parseView(BSON_ARRAY(BSON("$project" << BSON("_id" << 0 << "a" << 1)))),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(parseView(BSON_ARRAY(BSON("$project" << BSON("_id"
+                                                           << "$a")))),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(parseView(BSON_ARRAY(BSON("$project" << BSON("_id.x" << 1)))),
+              ErrorCodes::InvalidOptions);
+}
+
+TEST(MaterializedViewTest, RejectsGroupsWithoutCountOrWithOtherAccumulators) {
+    ASSERT_EQ(parseView(BSON_ARRAY(BSON("$group" << BSON("_id"
+                                                         << "$k"
+                                                         << "total"
+                                                         << BSON("$sum"
+                                                                 << "$x"))))),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(parseView(BSON_ARRAY(BSON("$group" << BSON("_id"
+                                                         << "$k"
+                                                         << "n"
+                                                         << BSON("$sum" << 1)
+                                                         << "biggest"
+                                                         << BSON("$max"
+                                                                 << "$x"))))),
+              ErrorCodes::InvalidOptions);
+}
+
+TEST(MaterializedViewTest, RejectsViewOfItself) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    ASSERT_EQ(MaterializedView::parse(
+                  opCtx.get(), viewNss, BSON("on" << "view" << "pipeline" << BSONArray()))
+                  .getStatus(),
+              ErrorCodes::InvalidOptions);
+}
+
+}  // namespace
+}  // namespace mongo
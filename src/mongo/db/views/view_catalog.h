@@ -113,7 +113,8 @@ public:
     /**
      * Resolve the views on 'nss', transforming the pipeline appropriately. This function returns a
      * fully-resolved view definition containing the backing namespace, the resolved pipeline and
-     * the collation to use for the operation.
+     * the collation to use for the operation. Resolutions are remembered until the catalog next
+     * changes.
      */
     StatusWith<ResolvedView> resolveView(OperationContext* opCtx, const NamespaceString& nss);
 
@@ -172,6 +173,7 @@ private:
 
     stdx::mutex _mutex;  // Protects all members, except for _valid.
     ViewMap _viewMap;
+    StringMap<ResolvedView> _resolvedViews;  // Cleared whenever '_viewMap' changes.
     DurableViewCatalog* _durable;
     AtomicBool _valid;
     ViewGraph _viewGraph;
@@ -525,6 +525,50 @@ TEST_F(ViewCatalogFixture, ResolveViewCorrectPipeline) {
     }
 }
 
+TEST_F(ViewCatalogFixture, ResolveViewReflectsChangesToViewsInTheChain) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString view2("db.view2");
+    const NamespaceString viewOn("db.coll");
+    BSONArrayBuilder pipeline1;
+    BSONArrayBuilder pipeline2;
+    BSONArrayBuilder modifiedPipeline1;
+
+    pipeline1 << BSON("$match" << BSON("foo" << 1));
+    pipeline2 << BSON("$match" << BSON("foo" << 2));
+    modifiedPipeline1 << BSON("$match" << BSON("foo" << 3));
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view1, viewOn, pipeline1.arr(), emptyCollation));
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view2, view1, pipeline2.arr(), emptyCollation));
+
+    auto resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 1)),
+                      resolvedView.getValue().getPipeline()[0]);
+
+    // Resolving again gives the same result.
+    resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 1)),
+                      resolvedView.getValue().getPipeline()[0]);
+
+    ASSERT_OK(viewCatalog.modifyView(opCtx.get(), view1, viewOn, modifiedPipeline1.arr()));
+
+    resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 3)),
+                      resolvedView.getValue().getPipeline()[0]);
+
+    ASSERT_OK(viewCatalog.dropView(opCtx.get(), view1));
+
+    resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(view1, resolvedView.getValue().getNamespace());
+    ASSERT_EQ(1U, resolvedView.getValue().getPipeline().size());
+}
+
 TEST_F(ViewCatalogFixture, ResolveViewCorrectlyExtractsDefaultCollation) {
     const NamespaceString view1("db.view1");
     const NamespaceString view2("db.view2");
@@ -96,5 +96,37 @@ TEST_F(InsertTest, FixDocumentForInsertFailsOnDeeplyNestedDocuments) {
                                    makeNestedArray(BSONDepth::getMaxDepthForUserStorage() + 1)),
               ErrorCodes::Overflow);
 }
+
+TEST_F(InsertTest, FixDocumentForInsertGeneratesLeadingIdAndKeepsOtherFields) {
+    const auto doc = BSON("a" << 1 << "b" << BSON("c" << "d") << "e" << BSON_ARRAY(1 << 2));
+    auto fixed = fixDocumentForInsert(getOperationContext()->getServiceContext(), doc);
+    ASSERT_OK(fixed.getStatus());
+
+    BSONObjIterator it(fixed.getValue());
+    const auto id = it.next();
+    ASSERT_EQ("_id"_sd, id.fieldNameStringData());
+    ASSERT_EQ(jstOID, id.type());
+    ASSERT_BSONOBJ_EQ(doc, fixed.getValue().removeField("_id"));
+    ASSERT_EQ(doc.objsize() + id.size(), fixed.getValue().objsize());
+}
+
+TEST_F(InsertTest, FixDocumentForInsertMovesIdToFront) {
+    auto fixed = fixDocumentForInsert(getOperationContext()->getServiceContext(),
+                                      BSON("a" << 1 << "_id" << 2 << "b" << 3));
+    ASSERT_OK(fixed.getStatus());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2 << "a" << 1 << "b" << 3), fixed.getValue());
+
+    fixed = fixDocumentForInsert(getOperationContext()->getServiceContext(),
+                                 BSON("a" << 1 << "_id" << 2));
+    ASSERT_OK(fixed.getStatus());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2 << "a" << 1), fixed.getValue());
+}
+
+TEST_F(InsertTest, FixDocumentForInsertLeavesDocumentWithLeadingIdUnchanged) {
+    auto fixed = fixDocumentForInsert(getOperationContext()->getServiceContext(),
+                                      BSON("_id" << 1 << "a" << 1));
+    ASSERT_OK(fixed.getStatus());
+    ASSERT(fixed.getValue().isEmpty());
+}
 }  // namespace
 }  // namespace mongo
@@ -49,6 +49,7 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
@@ -583,6 +584,127 @@ public:
     }
 };
 
+/**
+ * Exceeding the memory limit while reading the first child of a hashed AND which may spill should
+ * fall back to intersecting externally.
+ */
+class QueryStageAndHashTwoLeafFirstChildLargeKeysSpills : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        std::string big(512, 'a');
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i << "big" << big));
+        }
+
+        addIndex(BSON("foo" << 1 << "big" << 1));
+        addIndex(BSON("bar" << 1));
+
+        // The stage has to hold 21 keys in its buffer for Foo <= 20.
+        WorkingSet ws;
+        auto ah = make_unique<AndHashStage>(&_opCtx, &ws, coll, 10 * big.size());
+        ah->enableSpilling(storageGlobalParams.dbpath + "/_tmp");
+
+        // Foo <= 20
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1 << "big" << 1), coll));
+        params.bounds.startKey = BSON("" << 20 << "" << big);
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar >= 10
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 10);
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // foo == bar, so our values are 10 through 20, in RecordId order. Every result carries
+        // the index keys of both children.
+        RecordId lastRecordId;
+        int count = 0;
+        while (!ah->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState status = ah->work(&id);
+            ASSERT_NOT_EQUALS(PlanStage::FAILURE, status);
+            if (PlanStage::ADVANCED != status) {
+                continue;
+            }
+
+            WorkingSetMember* member = ws.get(id);
+            ASSERT_LT(lastRecordId, member->recordId);
+            lastRecordId = member->recordId;
+            ASSERT_EQUALS(2U, member->keyData.size());
+            ++count;
+        }
+        ASSERT_EQUALS(11, count);
+
+        auto stats = static_cast<const AndHashStats*>(ah->getSpecificStats());
+        ASSERT_TRUE(stats->usedDisk);
+    }
+};
+
+/**
+ * Exceeding the memory limit while merging the middle child of a hashed AND which may spill
+ * should keep the intersection found so far and fall back to intersecting externally.
+ */
+class QueryStageAndHashThreeLeafMiddleChildLargeKeysSpills : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        std::string big(512, 'a');
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i << "baz" << i << "big" << big));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1 << "big" << 1));
+        addIndex(BSON("baz" << 1));
+
+        // Exceed the limit before the hashed AND is done reading the second child.
+        WorkingSet ws;
+        auto ah = make_unique<AndHashStage>(&_opCtx, &ws, coll, 10 * big.size());
+        ah->enableSpilling(storageGlobalParams.dbpath + "/_tmp");
+
+        // Foo <= 20
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1), coll));
+        params.bounds.startKey = BSON("" << 20);
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar >= 10
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1 << "big" << 1), coll));
+        params.bounds.startKey = BSON("" << 10 << "" << big);
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // 5 <= baz <= 15
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("baz" << 1), coll));
+        params.bounds.startKey = BSON("" << 5);
+        params.bounds.endKey = BSON("" << 15);
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // foo == bar == baz, and foo<=20, bar>=10, 5<=baz<=15, so our values are:
+        // foo == 10, 11, 12, 13, 14, 15.
+        ASSERT_EQUALS(6, countResults(ah.get()));
+
+        auto stats = static_cast<const AndHashStats*>(ah->getSpecificStats());
+        ASSERT_TRUE(stats->usedDisk);
+    }
+};
+
 // An AND with an index scan that returns nothing.
 class QueryStageAndHashWithNothing : public QueryStageAndBase {
 public:
@@ -1343,6 +1465,8 @@ public:
         add<QueryStageAndHashTwoLeafLastChildLargeKeys>();
         add<QueryStageAndHashThreeLeaf>();
         add<QueryStageAndHashThreeLeafMiddleChildLargeKeys>();
+        add<QueryStageAndHashTwoLeafFirstChildLargeKeysSpills>();
+        add<QueryStageAndHashThreeLeafMiddleChildLargeKeysSpills>();
         add<QueryStageAndHashWithNothing>();
         add<QueryStageAndHashProducesNothing>();
         add<QueryStageAndHashDeleteLookaheadDuringYield>();
@@ -390,6 +390,102 @@ public:
     }
 };
 
+//
+// Work the scan in batches and make sure we get the same objects, in order, as work() would give
+// us, with the filter applied.
+//
+
+class QueryStageCollscanWorkBatchForwardWithMatch : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+
+        // Configure the scan.
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+
+        // Make the filter.
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(BSON("foo" << BSON("$gte" << 10)), expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        unique_ptr<CollectionScan> scan(
+            new CollectionScan(&_opCtx, params, &ws, filterExpr.get()));
+
+        int count = 10;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (PlanStage::IS_EOF != state) {
+            vector<WorkingSetID> batch;
+            WorkingSetID last = WorkingSet::INVALID_ID;
+            state = scan->workBatch(7, &batch, &last);
+            ASSERT_LTE(batch.size(), 7U);
+            ASSERT_EQUALS(batch.empty(), PlanStage::ADVANCED != state);
+
+            for (auto id : batch) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT_EQUALS(count, member->obj.value()["foo"].numberInt());
+                ws.free(id);
+                ++count;
+            }
+        }
+        ASSERT_EQUALS(numObj(), count);
+
+        // Every document was tested exactly once, and every result was counted as advanced.
+        auto stats = static_cast<const CollectionScanStats*>(scan->getSpecificStats());
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), stats->docsTested);
+        ASSERT_EQUALS(static_cast<size_t>(numObj() - 10), scan->getCommonStats()->advanced);
+    }
+};
+
+//
+// Split the collection into ranges and make sure that scanning each range with 'start' and 'stop'
+// returns every document exactly once, in order.
+//
+
+class QueryStageCollscanRangePartitions : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        Collection* coll = ctx.getCollection();
+
+        vector<RecordId> expected;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &expected);
+
+        const size_t numRanges = 4;
+        vector<RecordId> boundaries =
+            CollectionScan::sampleRangeBoundaries(&_opCtx, coll, numRanges);
+        ASSERT_LT(boundaries.size(), numRanges);
+        ASSERT(std::is_sorted(boundaries.begin(), boundaries.end()));
+
+        vector<RecordId> actual;
+        for (size_t i = 0; i <= boundaries.size(); ++i) {
+            CollectionScanParams params;
+            params.collection = coll;
+            params.direction = CollectionScanParams::FORWARD;
+            params.start = i == 0 ? RecordId() : boundaries[i - 1];
+            params.stop = i == boundaries.size() ? RecordId() : boundaries[i];
+
+            WorkingSet ws;
+            unique_ptr<CollectionScan> scan(new CollectionScan(&_opCtx, params, &ws, nullptr));
+            while (!scan->isEOF()) {
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                if (PlanStage::ADVANCED == scan->work(&id)) {
+                    actual.push_back(ws.get(id)->recordId);
+                }
+            }
+        }
+
+        ASSERT(expected == actual);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -404,6 +500,8 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanDeleteUpcomingObject>();
         add<QueryStageCollscanDeleteUpcomingObjectBackward>();
+        add<QueryStageCollscanWorkBatchForwardWithMatch>();
+        add<QueryStageCollscanRangePartitions>();
     }
 };
 
@@ -34,6 +34,7 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
@@ -180,6 +182,72 @@ public:
     }
 };
 
+// Use a batched delete stage to delete the objects retrieved by a collscan, separately deleting
+// one object which the stage has buffered and one which it has yet to see. We expect the delete
+// stage to delete the other objects in batches, along with their index keys.
+class QueryStageDeleteBatched : public QueryStageDeleteBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+
+        Collection* coll = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+        deleteStageParams.maxBatchSize = 20;
+
+        WorkingSet ws;
+        DeleteStage deleteStage(&_opCtx,
+                                deleteStageParams,
+                                &ws,
+                                coll,
+                                new CollectionScan(&_opCtx, collScanParams, &ws, NULL));
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        // Nothing is deleted until the first batch is full.
+        while (stats->docsDeleted == 0) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        }
+        ASSERT_EQUALS(20U, stats->docsDeleted);
+
+        // Buffer some of the second batch.
+        for (size_t i = 0; i < 10; ++i) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        }
+        ASSERT_EQUALS(20U, stats->docsDeleted);
+
+        deleteStage.saveState();
+        remove(coll->docFor(&_opCtx, recordIds[25]).value());
+        remove(coll->docFor(&_opCtx, recordIds[45]).value());
+        deleteStage.restoreState();
+
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(numObj() - 2, stats->docsDeleted);
+        ASSERT_EQUALS(0, coll->numRecords(&_opCtx));
+
+        IndexCatalog* indexCatalog = coll->getIndexCatalog();
+        auto cursor =
+            indexCatalog->getIndex(indexCatalog->findIdIndex(&_opCtx))->newCursor(&_opCtx);
+        ASSERT_FALSE(cursor->seek(BSON("" << MINKEY), true));
+    }
+};
+
 /**
  * Test that the delete stage returns an owned copy of the original document if returnDeleted is
  * specified.
@@ -255,6 +323,7 @@ public:
         // Stage-specific tests below.
         add<QueryStageDeleteUpcomingObjectWasDeleted>();
         add<QueryStageDeleteReturnOldDoc>();
+        add<QueryStageDeleteBatched>();
     }
 };
 
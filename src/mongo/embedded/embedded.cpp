@@ -68,6 +68,7 @@
 #include "mongo/util/periodic_runner_factory.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 #include <boost/filesystem.hpp>
 
@@ -75,6 +76,29 @@
 namespace mongo {
 namespace embedded {
 namespace {
+
+/**
+ * Measures the phases of initialize(), so that a slow start on a device can be attributed to the
+ * subsystem responsible for it.
+ */
+class StartupPhaseTimer {
+public:
+    void endPhase(StringData phase) {
+        _phases.append(phase, _phaseTimer.millis());
+        _phaseTimer.reset();
+    }
+
+    BSONObj done() {
+        _phases.append("total", _totalTimer.millis());
+        return _phases.obj();
+    }
+
+private:
+    Timer _totalTimer;
+    Timer _phaseTimer;
+    BSONObjBuilder _phases;
+};
+
 void initWireSpec() {
     WireSpec& spec = WireSpec::instance();
 
@@ -179,6 +203,7 @@ void shutdown(ServiceContext* srvContext) {
 
 
 ServiceContext* initialize(const char* yaml_config) {
+    StartupPhaseTimer startupTimer;
     srand(static_cast<unsigned>(curTimeMicros64()));
 
     // yaml_config is passed to the options parser through the argc/argv interface that already
@@ -187,6 +212,7 @@ ServiceContext* initialize(const char* yaml_config) {
 
     Status status = mongo::runGlobalInitializers(yaml_config ? 1 : 0, argv, nullptr);
     uassertStatusOKWithContext(status, "Global initilization failed");
+    startupTimer.endPhase("globalInitializers");
     setGlobalServiceContext(ServiceContext::make());
 
     Client::initThread("initandlisten");
@@ -216,8 +242,10 @@ ServiceContext* initialize(const char* yaml_config) {
     }
 
     DEV log(LogComponent::kControl) << "DEBUG build (which is slower)" << endl;
+    startupTimer.endPhase("serviceContext");
 
     initializeStorageEngine(serviceContext, StorageEngineInitFlags::kAllowNoLockFile);
+    startupTimer.endPhase("storageEngine");
 
     // Warn if we detect configurations for multiple registered storage engines in the same
     // configuration file/environment.
@@ -291,6 +319,7 @@ ServiceContext* initialize(const char* yaml_config) {
     if (canCallFCVSetIfCleanStartup) {
         invariant(serverGlobalParams.featureCompatibility.isVersionInitialized());
     }
+    startupTimer.endPhase("repairAndVersionCheck");
 
     if (storageGlobalParams.upgrade) {
         log() << "finished checking dbs";
@@ -303,6 +332,7 @@ ServiceContext* initialize(const char* yaml_config) {
     if (!storageGlobalParams.readOnly) {
         restartInProgressIndexesFromLastShutdown(startupOpCtx.get());
     }
+    startupTimer.endPhase("indexBuildRestart");
 
     auto periodicRunner = std::make_unique<PeriodicRunnerEmbedded>(
         serviceContext, serviceContext->getPreciseClockSource());
@@ -312,6 +342,7 @@ ServiceContext* initialize(const char* yaml_config) {
     // Set up the logical session cache
     auto sessionCache = makeLogicalSessionCacheEmbedded();
     LogicalSessionCache::set(serviceContext, std::move(sessionCache));
+    startupTimer.endPhase("backgroundServices");
 
     // MessageServer::run will return when exit code closes its socket and we don't need the
     // operation context anymore
@@ -322,6 +353,8 @@ ServiceContext* initialize(const char* yaml_config) {
 
     serviceContext->notifyStartupComplete();
 
+    log(LogComponent::kControl) << "Startup phase timings in milliseconds: "
+                                << startupTimer.done();
     return serviceContext;
 }
 }  // namespace embedded
@@ -460,6 +460,7 @@ void client_wire_protocol_rpc(mongo_embedded_v1_client* const client,
     Message msg(std::move(sb));
 
     client->response = sep->handleRequest(opCtx.get(), msg);
+    client->response.response.flatten();
 
     MsgData::View outMessage(client->response.response.buf());
     outMessage.setId(nextMessageId());
@@ -32,6 +32,8 @@
 
 #include "mongo/executor/connection_pool.h"
 
+#include <cmath>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/remote_command_request.h"
@@ -108,6 +110,11 @@ public:
                                            Milliseconds timeout,
                                            stdx::unique_lock<stdx::mutex> lk);
 
+    /**
+     * Keeps at least 'target' connections open until hostTimeout passes, and starts opening them.
+     */
+    void warmUp(size_t target, stdx::unique_lock<stdx::mutex>& lk);
+
     /**
      * Triggers the shutdown procedure. This function marks the state as kInShutdown
      * and calls processFailure below with the status provided. This may not immediately
@@ -156,6 +163,13 @@ public:
      */
     size_t openConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns how long the connections made by this pool took to set up.
+     */
+    const ConnectionLatencyHistogram& handshakeLatency(const stdx::unique_lock<stdx::mutex>& lk) {
+        return _handshakeLatency;
+    }
+
     /**
      * Return true if the tags on the specific pool match the passed in tags
      */
@@ -190,6 +204,12 @@ private:
 
     void spawnConnections(stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * The number of connections to keep open even without requests, which is minConnections
+     * unless a warm up asked for more.
+     */
+    size_t minimumConnections();
+
     template <typename OwnershipPoolType>
     typename OwnershipPoolType::mapped_type takeFromPool(
         OwnershipPoolType& pool, typename OwnershipPoolType::key_type connPtr);
@@ -219,6 +239,11 @@ private:
 
     size_t _created;
 
+    ConnectionLatencyHistogram _handshakeLatency;
+
+    size_t _warmUpTarget;
+    Date_t _warmUpExpiration;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     /**
@@ -253,6 +278,8 @@ size_t const ConnectionPool::kDefaultMinConns = 1;
 size_t const ConnectionPool::kDefaultMaxConnecting = std::numeric_limits<size_t>::max();
 constexpr Milliseconds ConnectionPool::kDefaultRefreshRequirement;
 constexpr Milliseconds ConnectionPool::kDefaultRefreshTimeout;
+constexpr Milliseconds ConnectionPool::kDefaultDemandHalfLife;
+constexpr size_t ConnectionPool::kDefaultMaxCoalescedRequestBytes;
 
 const Status ConnectionPool::kConnectionStateUnknown =
     Status(ErrorCodes::InternalError, "Connection is in an unknown state");
@@ -369,6 +396,57 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort&
     return pool->getConnection(hostAndPort, timeout, std::move(lk));
 }
 
+void ConnectionPool::warmUpConnections(const HostAndPort& hostAndPort,
+                                       const HostAndPort& predecessor) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    auto target = updateDemand(hostAndPort, 0);
+    if (!predecessor.empty()) {
+        target = std::max(target, updateDemand(predecessor, 0));
+    }
+    target = std::min(target, _options.maxConnections);
+
+    auto iter = _pools.find(hostAndPort);
+    if (iter == _pools.end()) {
+        // Even without any history, a host we are told is about to be used is worth connecting
+        // to before the first request for it arrives.
+        std::shared_ptr<SpecificPool> pool = stdx::make_unique<SpecificPool>(this, hostAndPort);
+        iter = _pools.emplace(hostAndPort, std::move(pool)).first;
+    }
+
+    // Hold a reference, since spawning connections can drop the lock.
+    auto pool = iter->second;
+    pool->warmUp(target, lk);
+}
+
+size_t ConnectionPool::updateDemand(const HostAndPort& hostAndPort, size_t demand) {
+    const auto now = _factory->now();
+
+    auto iter = _demand.find(hostAndPort);
+    if (iter == _demand.end()) {
+        if (!demand) {
+            return 0;
+        }
+        iter = _demand.emplace(hostAndPort, HostDemand{}).first;
+    }
+
+    auto& history = iter->second;
+    if (history.lastUpdate != Date_t() && now > history.lastUpdate) {
+        const double halfLives = durationCount<Milliseconds>(now - history.lastUpdate) /
+            static_cast<double>(durationCount<Milliseconds>(_options.demandHalfLife));
+        history.peak *= std::exp2(-halfLives);
+    }
+    history.peak = std::max(history.peak, static_cast<double>(demand));
+    history.lastUpdate = now;
+
+    if (history.peak < 1) {
+        _demand.erase(iter);
+        return 0;
+    }
+
+    return static_cast<size_t>(std::ceil(history.peak));
+}
+
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
@@ -380,6 +458,7 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
                                      pool->availableConnections(lk),
                                      pool->createdConnections(lk),
                                      pool->refreshingConnections(lk)};
+        hostStats.handshakeLatency = pool->handshakeLatency(lk);
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
@@ -417,6 +496,7 @@ ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAnd
       _inFulfillRequests(false),
       _inSpawnConnections(false),
       _created(0),
+      _warmUpTarget(0),
       _state(State::kRunning) {}
 
 ConnectionPool::SpecificPool::~SpecificPool() {
@@ -470,6 +550,30 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
     return std::move(pf.future);
 }
 
+void ConnectionPool::SpecificPool::warmUp(size_t target, stdx::unique_lock<stdx::mutex>& lk) {
+    if (_state == State::kInShutdown) {
+        return;
+    }
+
+    _warmUpTarget = target;
+    _warmUpExpiration = _parent->_factory->now() + _parent->_options.hostTimeout;
+
+    LOG(1) << "Warming up connection pool for " << _hostAndPort << " to "
+           << minimumConnections() << " connections";
+
+    updateStateInLock();
+
+    spawnConnections(lk);
+}
+
+size_t ConnectionPool::SpecificPool::minimumConnections() {
+    if (_warmUpTarget && _parent->_factory->now() >= _warmUpExpiration) {
+        _warmUpTarget = 0;
+    }
+
+    return std::max(_parent->_options.minConnections, _warmUpTarget);
+}
+
 void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr,
                                                     stdx::unique_lock<stdx::mutex> lk) {
     auto needsRefreshTP = connPtr->getLastUsed() + _parent->_options.refreshRequirement;
@@ -496,7 +600,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
         // If we need to refresh this connection
 
         if (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() >=
-            _parent->_options.minConnections) {
+            minimumConnections()) {
             // If we already have minConnections, just let the connection lapse
             log() << "Ending idle connection to host " << _hostAndPort
                   << " because the pool meets constraints; " << openConnections(lk)
@@ -715,10 +819,10 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     _inSpawnConnections = true;
     auto guard = MakeGuard([&] { _inSpawnConnections = false; });
 
-    // We want minConnections <= outstanding requests <= maxConnections
+    // We want minConnections (or the warm up target) <= outstanding requests <= maxConnections
     auto target = [&] {
         return std::max(
-            _parent->_options.minConnections,
+            minimumConnections(),
             std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
     };
 
@@ -741,10 +845,11 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
         ++_created;
 
         // Run the setup callback
+        const auto setupStart = _parent->_factory->now();
         lk.unlock();
         handle->setup(
             _parent->_options.refreshTimeout,
-            guardCallback([this](
+            guardCallback([this, setupStart](
                 stdx::unique_lock<stdx::mutex> lk, ConnectionInterface* connPtr, Status status) {
                 auto conn = takeFromProcessingPool(connPtr);
 
@@ -753,6 +858,8 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
                     return;
 
                 if (status.isOK()) {
+                    _handshakeLatency.record(_parent->_factory->now() - setupStart);
+
                     // If the host and port was dropped, let the connection lapse
                     if (conn->getGeneration() == _generation) {
                         addToReady(lk, std::move(conn));
@@ -801,6 +908,10 @@ ConnectionPool::SpecificPool::OwnedConnection ConnectionPool::SpecificPool::take
 
 // Updates our state and manages the request timer
 void ConnectionPool::SpecificPool::updateStateInLock() {
+    if (_state != State::kInShutdown) {
+        _parent->updateDemand(_hostAndPort, _requests.size() + _checkedOutPool.size());
+    }
+
     if (_state == State::kInShutdown) {
         // If we're in shutdown, there is nothing to update. Our clients are all gone.
         if (_processingPool.empty() && !_activeClients) {
@@ -78,6 +78,8 @@ public:
     static const size_t kDefaultMaxConnecting;
     static constexpr Milliseconds kDefaultRefreshRequirement = Milliseconds(60000);  // 1min
     static constexpr Milliseconds kDefaultRefreshTimeout = Milliseconds(20000);      // 20secs
+    static constexpr Milliseconds kDefaultDemandHalfLife = Milliseconds(60000);      // 1min
+    static constexpr size_t kDefaultMaxCoalescedRequestBytes = 16 * 1024;
 
     static const Status kConnectionStateUnknown;
 
@@ -122,6 +124,25 @@ public:
          */
         Milliseconds hostTimeout = kDefaultHostTimeout;
 
+        /**
+         * How quickly the pool forgets the peak demand it has seen for a host. The remembered peak
+         * halves every demandHalfLife, and is what warmUpConnections() builds connections up to.
+         */
+        Milliseconds demandHalfLife = kDefaultDemandHalfLife;
+
+        /**
+         * The maximum number of small requests a NetworkInterfaceTL pipelines over a single
+         * connection to a host. Zero disables coalescing, so each request checks out a connection
+         * of its own.
+         */
+        size_t maxCoalescedRequests = 0;
+
+        /**
+         * Requests whose command and metadata together exceed this many bytes are never
+         * coalesced, so that large payloads cannot hold up the small ones pipelined behind them.
+         */
+        size_t maxCoalescedRequestBytes = kDefaultMaxCoalescedRequestBytes;
+
         /**
          * An egress tag closer manager which will provide global access to this connection pool.
          * The manager set's tags and potentially drops connections that don't match those tags.
@@ -147,6 +168,14 @@ public:
                     const stdx::function<transport::Session::TagMask(transport::Session::TagMask)>&
                         mutateFunc) override;
 
+    /**
+     * Establishes connections to 'hostAndPort' ahead of demand, up to the peak number of
+     * connections recently in use for it or for 'predecessor', whichever is larger, and keeps that
+     * many around until hostTimeout passes. 'predecessor' is the host whose load 'hostAndPort' is
+     * expected to take over, such as the previous primary of a replica set, and may be empty.
+     */
+    void warmUpConnections(const HostAndPort& hostAndPort, const HostAndPort& predecessor) override;
+
     Future<ConnectionHandle> get(const HostAndPort& hostAndPort, Milliseconds timeout);
     void get(const HostAndPort& hostAndPort, Milliseconds timeout, GetConnectionCallback cb);
 
@@ -155,8 +184,22 @@ public:
     size_t getNumConnectionsPerHost(const HostAndPort& hostAndPort) const;
 
 private:
+    /**
+     * The recent peak number of connections wanted for a host, decaying over time.
+     */
+    struct HostDemand {
+        double peak = 0;
+        Date_t lastUpdate;
+    };
+
     void returnConnection(ConnectionInterface* connection);
 
+    /**
+     * Folds the current demand for a host into its history and returns the decayed peak. Must be
+     * called with _mutex held.
+     */
+    size_t updateDemand(const HostAndPort& hostAndPort, size_t demand);
+
     std::string _name;
 
     // Options are set at startup and never changed at run time, so these are
@@ -169,6 +212,10 @@ private:
     mutable stdx::mutex _mutex;
     stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
 
+    // Outlives the specific pools, so that a host which has gone idle, or which is only about to
+    // be used, can still be warmed up from what was seen before.
+    stdx::unordered_map<HostAndPort, HostDemand> _demand;
+
     EgressTagCloserManager* _manager;
 };
 
@@ -36,6 +36,47 @@
 namespace mongo {
 namespace executor {
 
+constexpr size_t ConnectionLatencyHistogram::kNumBuckets;
+
+void ConnectionLatencyHistogram::record(Milliseconds latency) {
+    size_t bucket = 0;
+    for (auto millis = latency.count(); millis > 0 && bucket < kNumBuckets - 1; millis >>= 1) {
+        ++bucket;
+    }
+
+    ++buckets[bucket];
+    ++count;
+    total += latency;
+}
+
+ConnectionLatencyHistogram& ConnectionLatencyHistogram::operator+=(
+    const ConnectionLatencyHistogram& other) {
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    total += other.total;
+
+    return *this;
+}
+
+void ConnectionLatencyHistogram::appendToBSON(BSONObjBuilder& builder) const {
+    builder.appendNumber("count", count);
+    builder.appendNumber("totalMillis", durationCount<Milliseconds>(total));
+
+    // Only report the buckets which have something in them, each by its lower bound.
+    BSONArrayBuilder histogram(builder.subarrayStart("histogram"));
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        if (!buckets[i]) {
+            continue;
+        }
+
+        BSONObjBuilder entry(histogram.subobjStart());
+        entry.appendNumber("millis", i ? (1ll << (i - 1)) : 0ll);
+        entry.appendNumber("count", buckets[i]);
+    }
+}
+
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
                                        size_t nCreated,
@@ -49,6 +90,7 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    handshakeLatency += other.handshakeLatency;
 
     return *this;
 }
@@ -90,6 +132,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                BSONObjBuilder latencyInfo(hostInfo.subobjStart("handshakeLatency"));
+                hostStats.handshakeLatency.appendToBSON(latencyInfo);
             }
         }
     }
@@ -102,6 +146,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            BSONObjBuilder latencyInfo(hostInfo.subobjStart("handshakeLatency"));
+            hostStats.handshakeLatency.appendToBSON(latencyInfo);
         }
     }
 }
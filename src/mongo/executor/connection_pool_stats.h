@@ -28,12 +28,37 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
+
+class BSONObjBuilder;
+
 namespace executor {
 
+/**
+ * Counts how long it took to set up new connections, which covers the TCP, TLS and authentication
+ * handshakes. Bucket 0 holds setups which took less than 1ms, and bucket i > 0 those which took at
+ * least 2^(i-1)ms and less than 2^i ms. The last bucket also holds everything slower.
+ */
+struct ConnectionLatencyHistogram {
+    static constexpr size_t kNumBuckets = 16;
+
+    void record(Milliseconds latency);
+
+    ConnectionLatencyHistogram& operator+=(const ConnectionLatencyHistogram& other);
+
+    void appendToBSON(BSONObjBuilder& builder) const;
+
+    std::array<size_t, kNumBuckets> buckets{};
+    size_t count = 0u;
+    Milliseconds total{0};
+};
+
 /**
  * Holds connection information for a specific pool or remote host. These objects are maintained by
  * a parent ConnectionPoolStats object and should not need to be created directly.
@@ -49,6 +74,7 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+    ConnectionLatencyHistogram handshakeLatency;
 };
 
 /**
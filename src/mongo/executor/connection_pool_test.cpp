@@ -34,6 +34,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -1376,6 +1377,98 @@ TEST_F(ConnectionPoolTest, DropConnectionsByTagInMultipleViaManager) {
     dropConnectionsByTagTest(pool, manager);
 }
 
+/**
+ * Verify that warming up a host opens as many connections as were recently in use for the host it
+ * takes over from.
+ */
+TEST_F(ConnectionPoolTest, WarmUpOpensConnectionsForPredecessorDemand) {
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    const HostAndPort oldPrimary("localhost:30000");
+    const HostAndPort newPrimary("localhost:30001");
+
+    std::vector<ConnectionPool::ConnectionHandle> connections;
+    for (size_t i = 0; i < 3; ++i) {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get(oldPrimary,
+                 Milliseconds(5000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+                     connections.push_back(std::move(swConn.getValue()));
+                 });
+    }
+    ASSERT_EQ(3ul, connections.size());
+
+    for (auto& conn : connections) {
+        doneWith(conn);
+    }
+    connections.clear();
+
+    for (size_t i = 0; i < 3; ++i) {
+        ConnectionImpl::pushSetup(Status::OK());
+    }
+    pool.warmUpConnections(newPrimary, oldPrimary);
+
+    ASSERT_EQ(3ul, pool.getNumConnectionsPerHost(newPrimary));
+    ASSERT_EQ(0ul, ConnectionImpl::setupQueueDepth());
+}
+
+/**
+ * Verify that warming up a host nobody has used yet still opens minConnections to it.
+ */
+TEST_F(ConnectionPoolTest, WarmUpWithoutHistoryOpensMinConnections) {
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    ConnectionPool::Options options;
+    options.minConnections = 2;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    const HostAndPort host("localhost:30000");
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+    pool.warmUpConnections(host, HostAndPort());
+
+    ASSERT_EQ(2ul, pool.getNumConnectionsPerHost(host));
+}
+
+/**
+ * Verify that the time taken to set up connections is reported in the pool stats.
+ */
+TEST_F(ConnectionPoolTest, HandshakeLatencyIsReported) {
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    const HostAndPort host("localhost:30000");
+
+    bool reachedA = false;
+    pool.get(host, Milliseconds(5000), [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+        ASSERT(swConn.isOK());
+        doneWith(swConn.getValue());
+        reachedA = true;
+    });
+    ASSERT(!reachedA);
+
+    PoolImpl::setNow(now + Milliseconds(5));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(reachedA);
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+
+    const auto& latency = stats.statsByHost[host].handshakeLatency;
+    ASSERT_EQ(1ul, latency.count);
+    ASSERT_EQ(Milliseconds(5), latency.total);
+    // 5ms falls in the [4ms, 8ms) bucket.
+    ASSERT_EQ(1ul, latency.buckets[3]);
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
@@ -50,6 +50,13 @@ public:
                             const stdx::function<transport::Session::TagMask(
                                 transport::Session::TagMask)>& mutateFunc) = 0;
 
+    /**
+     * Opens connections to 'hostAndPort' ahead of use, sized after the recent use of 'hostAndPort'
+     * or 'predecessor', the host it is taking over from.
+     */
+    virtual void warmUpConnections(const HostAndPort& hostAndPort,
+                                   const HostAndPort& predecessor) = 0;
+
 protected:
     EgressTagCloser() {}
 };
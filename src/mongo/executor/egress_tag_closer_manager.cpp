@@ -74,5 +74,14 @@ void EgressTagCloserManager::mutateTags(
     }
 }
 
+void EgressTagCloserManager::warmUpConnections(const HostAndPort& hostAndPort,
+                                               const HostAndPort& predecessor) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    for (auto etc : _egressTagClosers) {
+        etc->warmUpConnections(hostAndPort, predecessor);
+    }
+}
+
 }  // namespace executor
 }  // namespace mongo
@@ -60,6 +60,8 @@ public:
         const HostAndPort& hostAndPort,
         const stdx::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc);
 
+    void warmUpConnections(const HostAndPort& hostAndPort, const HostAndPort& predecessor);
+
 private:
     stdx::mutex _mutex;
     stdx::unordered_set<EgressTagCloser*> _egressTagClosers;
@@ -30,6 +30,7 @@
 #include "mongo/unittest/unittest.h"
 
 #include "mongo/client/connection_string.h"
+#include "mongo/executor/connection_pool.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/executor/task_executor.h"
@@ -62,7 +63,8 @@ using StartCommandCB = stdx::function<void(const RemoteCommandResponse&)>;
 
 class NetworkInterfaceIntegrationFixture : public mongo::unittest::Test {
 public:
-    void startNet(std::unique_ptr<NetworkConnectionHook> connectHook = nullptr);
+    void startNet(std::unique_ptr<NetworkConnectionHook> connectHook = nullptr,
+                  ConnectionPool::Options options = ConnectionPool::Options());
     void tearDown() override;
 
     NetworkInterface& net();
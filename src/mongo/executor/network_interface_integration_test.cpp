@@ -32,11 +32,13 @@
 
 #include <algorithm>
 #include <exception>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/wire_version.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface_integration_fixture.h"
 #include "mongo/executor/test_network_connection_hook.h"
@@ -377,6 +379,37 @@ TEST_F(NetworkInterfaceTest, IsMasterRequestMissingInternalClientInfoWhenNotInte
     assertNumOps(0u, 0u, 0u, 1u);
 }
 
+class NetworkInterfaceCoalescingTest : public NetworkInterfaceIntegrationFixture {
+public:
+    void setUp() override {
+        ConnectionPool::Options options;
+        options.maxCoalescedRequests = 8;
+        startNet(nullptr, std::move(options));
+    }
+};
+
+TEST_F(NetworkInterfaceCoalescingTest, ConcurrentCommandsShareOneConnection) {
+    const int kNumCommands = 32;
+    auto target = fixture().getServers().front();
+
+    std::vector<Future<RemoteCommandResponse>> deferred;
+    for (int i = 0; i < kNumCommands; ++i) {
+        RemoteCommandRequest request(target, "admin", BSON("echo" << 1 << "i" << i), nullptr);
+        deferred.push_back(runCommand(makeCallbackHandle(), std::move(request)));
+    }
+
+    // Every pipelined reply must find its way back to the request that produced it.
+    for (int i = 0; i < kNumCommands; ++i) {
+        auto res = deferred[i].get();
+        uassertStatusOK(res.status);
+        ASSERT_EQ(res.data.getObjectField("echo").getIntField("i"), i);
+    }
+
+    ConnectionPoolStats stats;
+    net().appendConnectionStats(&stats);
+    ASSERT_EQ(1u, stats.totalCreated);
+}
+
 }  // namespace
 }  // namespace executor
 }  // namespace mongo
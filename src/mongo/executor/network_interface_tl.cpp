@@ -111,6 +111,9 @@ void NetworkInterfaceTL::_run() {
     // This returns when the reactor is stopped in shutdown()
     _reactor->run();
 
+    // Hand the shared connections back before the pool goes away.
+    _coalescedChannels.clear();
+
     // Note that the pool will shutdown again when the ConnectionPool dtor runs
     // This prevents new timers from being set, calls all cancels via the factory registry, and
     // destructs all connections for all existing pools.
@@ -209,6 +212,37 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         return Status::OK();
     }
 
+    if (_shouldCoalesce(state->request, baton)) {
+        _reactor->schedule(transport::Reactor::kPost, [this, state] {
+            if (state->deadline != RemoteCommandRequest::kNoExpirationDate) {
+                state->timer = _reactor->makeTimer();
+                state->timer->waitUntil(state->deadline).getAsync([this, state](Status status) {
+                    if (status == ErrorCodes::CallbackCanceled || state->done.swap(true)) {
+                        return;
+                    }
+
+                    if (getTestCommandsEnabled()) {
+                        stdx::lock_guard<stdx::mutex> lk(_mutex);
+                        _counters.timedOut++;
+                    }
+
+                    // The connection is shared, so it can't be canceled; the reply, if it ever
+                    // arrives, is simply dropped.
+                    LOG(2) << "Coalesced request " << state->request.id << " timed out"
+                           << ", deadline was " << state->deadline << ", op was "
+                           << redact(state->request.toString());
+                    state->promise.setError(
+                        Status(ErrorCodes::NetworkInterfaceExceededTimeLimit, "timed out"));
+                });
+            }
+
+            _startCoalescedCommand(state);
+        });
+
+        _finishCommand(state, std::move(pf.future), onFinish);
+        return Status::OK();
+    }
+
     // Interacting with the connection pool can involve more work than just getting a connection
     // out.  In particular, we can end up having to spin up new connections, and fulfilling promises
     // for other requesters.  Returning connections has the same issue.
@@ -237,29 +271,14 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
 
     auto remainingWork = [ this, state, future = std::move(pf.future), baton, onFinish ](
         StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) mutable {
-        makeReadyFutureWith([&] {
-            return _onAcquireConn(
-                state, std::move(future), std::move(*uassertStatusOK(swConn)), baton);
-        })
-            .onError([](Status error) -> StatusWith<RemoteCommandResponse> {
-                // The TransportLayer has, for historical reasons returned SocketException for
-                // network errors, but sharding assumes HostUnreachable on network errors.
-                if (error == ErrorCodes::SocketException) {
-                    error = Status(ErrorCodes::HostUnreachable, error.reason());
-                }
-                return error;
-            })
-            .getAsync([this, state, onFinish](StatusWith<RemoteCommandResponse> response) {
-                auto duration = now() - state->start;
-                if (!response.isOK()) {
-                    onFinish(RemoteCommandResponse(response.getStatus(), duration));
-                } else {
-                    const auto& rs = response.getValue();
-                    LOG(2) << "Request " << state->request.id << " finished with response: "
-                           << redact(rs.isOK() ? rs.data.toString() : rs.status.toString());
-                    onFinish(rs);
-                }
-            });
+        _finishCommand(state,
+                       makeReadyFutureWith([&] {
+                           return _onAcquireConn(state,
+                                                 std::move(future),
+                                                 std::move(*uassertStatusOK(swConn)),
+                                                 baton);
+                       }),
+                       onFinish);
     };
 
     if (baton) {
@@ -285,6 +304,31 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
     return Status::OK();
 }
 
+void NetworkInterfaceTL::_finishCommand(std::shared_ptr<CommandState> state,
+                                        Future<RemoteCommandResponse> future,
+                                        const RemoteCommandCompletionFn& onFinish) {
+    std::move(future)
+        .onError([](Status error) -> StatusWith<RemoteCommandResponse> {
+            // The TransportLayer has, for historical reasons returned SocketException for
+            // network errors, but sharding assumes HostUnreachable on network errors.
+            if (error == ErrorCodes::SocketException) {
+                error = Status(ErrorCodes::HostUnreachable, error.reason());
+            }
+            return error;
+        })
+        .getAsync([this, state, onFinish](StatusWith<RemoteCommandResponse> response) {
+            auto duration = now() - state->start;
+            if (!response.isOK()) {
+                onFinish(RemoteCommandResponse(response.getStatus(), duration));
+            } else {
+                const auto& rs = response.getValue();
+                LOG(2) << "Request " << state->request.id << " finished with response: "
+                       << redact(rs.isOK() ? rs.data.toString() : rs.status.toString());
+                onFinish(rs);
+            }
+        });
+}
+
 // This is only called from within a then() callback on a future, so throwing is equivalent to
 // returning a ready Future with a not-OK status.
 Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
@@ -392,6 +436,164 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
     return future;
 }
 
+bool NetworkInterfaceTL::_shouldCoalesce(const RemoteCommandRequest& request,
+                                         const transport::BatonHandle& baton) const {
+    // Replies on a shared connection are read on the reactor thread, so requests that want to
+    // complete on a baton keep a connection of their own.
+    if (baton || _connPoolOpts.maxCoalescedRequests == 0) {
+        return false;
+    }
+
+    auto size = static_cast<size_t>(request.cmdObj.objsize() + request.metadata.objsize());
+    return size <= _connPoolOpts.maxCoalescedRequestBytes;
+}
+
+void NetworkInterfaceTL::_startCoalescedCommand(std::shared_ptr<CommandState> state) {
+    if (state->done.load()) {
+        // Canceled or timed out before it got here.
+        _eraseInUseConn(state->cbHandle);
+        return;
+    }
+
+    const auto target = state->request.target;
+    auto& slot = _coalescedChannels[target];
+    const bool isNew = !slot;
+    if (isNew) {
+        slot = std::make_shared<CoalescedChannel>();
+    }
+
+    auto channel = slot;
+    auto timeout = state->request.timeout;
+    channel->waiting.push_back(std::move(state));
+
+    if (isNew) {
+        _connectCoalescedChannel(target, std::move(channel), timeout);
+    } else {
+        _drainCoalescedChannel(target, channel);
+    }
+}
+
+void NetworkInterfaceTL::_connectCoalescedChannel(const HostAndPort& target,
+                                                  std::shared_ptr<CoalescedChannel> channel,
+                                                  Milliseconds timeout) {
+    _pool->get(target, timeout)
+        .getAsync([this, target, channel](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+            if (!swConn.isOK()) {
+                LOG(2) << "Failed to get coalesced connection to " << target << " from pool: "
+                       << swConn.getStatus();
+                _forgetCoalescedChannel(target, channel);
+
+                auto waiting = std::move(channel->waiting);
+                channel->waiting.clear();
+                for (auto& state : waiting) {
+                    _eraseInUseConn(state->cbHandle);
+                    if (state->done.swap(true)) {
+                        continue;
+                    }
+                    if (state->timer) {
+                        state->timer->cancel();
+                    }
+                    state->promise.setError(swConn.getStatus());
+                }
+                return;
+            }
+
+            auto conn = std::move(swConn.getValue());
+            auto deleter = conn.get_deleter();
+            channel->conn =
+                CommandState::ConnHandle(conn.release(), CommandState::Deleter{deleter, _reactor});
+            _drainCoalescedChannel(target, channel);
+        });
+}
+
+void NetworkInterfaceTL::_sendCoalescedCommand(std::shared_ptr<CoalescedChannel> channel,
+                                               std::shared_ptr<CommandState> state) {
+    if (state->done.load()) {
+        _eraseInUseConn(state->cbHandle);
+        return;
+    }
+
+    auto tlconn = checked_cast<connection_pool_tl::TLConnection*>(channel->conn.get());
+    ++channel->inFlight;
+
+    tlconn->client()
+        ->runPipelinedCommandRequest(state->request)
+        .then([this, target = tlconn->getHostAndPort()](RemoteCommandResponse response) {
+            if (_metadataHook && response.status.isOK()) {
+                response.status =
+                    _metadataHook->readReplyMetadata(nullptr, target.toString(), response.data);
+            }
+
+            return RemoteCommandResponse(std::move(response));
+        })
+        .getAsync([this, channel, state](StatusWith<RemoteCommandResponse> swr) {
+            _eraseInUseConn(state->cbHandle);
+            --channel->inFlight;
+
+            auto status = swr.isOK() ? swr.getValue().status : swr.getStatus();
+            if (!status.isOK() && !channel->failed) {
+                channel->failed = true;
+                channel->conn->indicateFailure(status);
+            }
+
+            if (!state->done.swap(true)) {
+                if (getTestCommandsEnabled()) {
+                    stdx::lock_guard<stdx::mutex> lk(_mutex);
+                    if (status.isOK()) {
+                        _counters.succeeded++;
+                    } else {
+                        _counters.failed++;
+                    }
+                }
+
+                if (state->timer) {
+                    state->timer->cancel();
+                }
+
+                state->promise.setFromStatusWith(std::move(swr));
+            }
+
+            _drainCoalescedChannel(state->request.target, channel);
+        });
+}
+
+void NetworkInterfaceTL::_drainCoalescedChannel(const HostAndPort& target,
+                                                const std::shared_ptr<CoalescedChannel>& channel) {
+    while (!channel->failed && channel->conn && !channel->waiting.empty() &&
+           channel->inFlight < _connPoolOpts.maxCoalescedRequests) {
+        auto state = std::move(channel->waiting.front());
+        channel->waiting.pop_front();
+        _sendCoalescedCommand(channel, std::move(state));
+    }
+
+    if (channel->failed) {
+        // Requests that never made it onto the broken connection start over on a new one.
+        _forgetCoalescedChannel(target, channel);
+        auto waiting = std::move(channel->waiting);
+        channel->waiting.clear();
+        for (auto& state : waiting) {
+            _startCoalescedCommand(std::move(state));
+        }
+    }
+
+    if (channel->inFlight == 0 && channel->waiting.empty() && channel->conn) {
+        if (!channel->failed) {
+            channel->conn->indicateUsed();
+            channel->conn->indicateSuccess();
+        }
+        channel->conn.reset();
+        _forgetCoalescedChannel(target, channel);
+    }
+}
+
+void NetworkInterfaceTL::_forgetCoalescedChannel(const HostAndPort& target,
+                                                 const std::shared_ptr<CoalescedChannel>& channel) {
+    auto it = _coalescedChannels.find(target);
+    if (it != _coalescedChannels.end() && it->second == channel) {
+        _coalescedChannels.erase(it);
+    }
+}
+
 void NetworkInterfaceTL::_eraseInUseConn(const TaskExecutor::CallbackHandle& cbHandle) {
     stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
     _inProgress.erase(cbHandle);
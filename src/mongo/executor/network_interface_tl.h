@@ -110,13 +110,43 @@ private:
         Promise<RemoteCommandResponse> promise;
     };
 
+    /**
+     * A connection shared by the coalesced requests to one host. Requests are pipelined over it
+     * up to ConnectionPool::Options::maxCoalescedRequests at a time; the rest wait in line. The
+     * connection goes back to the pool once nothing is in flight or waiting.
+     */
+    struct CoalescedChannel {
+        // Empty until the connection has been checked out of the pool.
+        CommandState::ConnHandle conn;
+        std::deque<std::shared_ptr<CommandState>> waiting;
+        size_t inFlight = 0;
+        bool failed = false;
+    };
+
     void _run();
     void _eraseInUseConn(const TaskExecutor::CallbackHandle& handle);
+    void _finishCommand(std::shared_ptr<CommandState> state,
+                        Future<RemoteCommandResponse> future,
+                        const RemoteCommandCompletionFn& onFinish);
     Future<RemoteCommandResponse> _onAcquireConn(std::shared_ptr<CommandState> state,
                                                  Future<RemoteCommandResponse> future,
                                                  CommandState::ConnHandle conn,
                                                  const transport::BatonHandle& baton);
 
+    // The coalescing functions below must only run on the reactor thread.
+    bool _shouldCoalesce(const RemoteCommandRequest& request,
+                         const transport::BatonHandle& baton) const;
+    void _startCoalescedCommand(std::shared_ptr<CommandState> state);
+    void _connectCoalescedChannel(const HostAndPort& target,
+                                  std::shared_ptr<CoalescedChannel> channel,
+                                  Milliseconds timeout);
+    void _sendCoalescedCommand(std::shared_ptr<CoalescedChannel> channel,
+                               std::shared_ptr<CommandState> state);
+    void _drainCoalescedChannel(const HostAndPort& target,
+                                const std::shared_ptr<CoalescedChannel>& channel);
+    void _forgetCoalescedChannel(const HostAndPort& target,
+                                 const std::shared_ptr<CoalescedChannel>& channel);
+
     std::string _instanceName;
     ServiceContext* _svcCtx;
     transport::TransportLayer* _tl;
@@ -138,6 +168,9 @@ private:
     stdx::unordered_map<TaskExecutor::CallbackHandle, std::shared_ptr<CommandState>> _inProgress;
     stdx::unordered_set<std::shared_ptr<transport::ReactorTimer>> _inProgressAlarms;
 
+    // Only accessed on the reactor thread.
+    stdx::unordered_map<HostAndPort, std::shared_ptr<CoalescedChannel>> _coalescedChannels;
+
     stdx::condition_variable _workReadyCond;
     bool _isExecutorRunnable = false;
 };
@@ -86,15 +86,17 @@ public:
         MONGO_UNREACHABLE;
     }
 
-    // All fields except for "canceled" are guarded by the owning task executor's _mutex. The
-    // "canceled" field may be observed without holding _mutex, but may only be set while holding
-    // _mutex.
+    // All fields except for "canceled" are guarded by the owning task executor's _mutex or, for
+    // remote commands, by the mutex of "networkQueue". The "canceled" field may be observed
+    // without holding either, but may only be set while holding one of them. The
+    // "isNetworkOperation" and "networkQueue" fields do not change once the callback is enqueued.
 
     CallbackFn callback;
     AtomicUInt32 canceled{0U};
     WorkQueue::iterator iter;
     Date_t readyDate;
     bool isNetworkOperation = false;
+    NetworkQueue* networkQueue = nullptr;
     AtomicWord<bool> isFinished{false};
     boost::optional<stdx::condition_variable> finishedCondition;
     transport::BatonHandle baton;
@@ -152,13 +154,32 @@ void ThreadPoolTaskExecutor::startup() {
 void ThreadPoolTaskExecutor::shutdown() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     if (_inShutdown_inlock()) {
-        invariant(_networkInProgressQueue.empty());
+        for (auto&& networkQueue : _networkQueues) {
+            stdx::lock_guard<stdx::mutex> networkLk(networkQueue.mutex);
+            invariant(networkQueue.inProgress.empty());
+        }
         invariant(_sleepersQueue.empty());
         return;
     }
     _setState_inlock(joinRequired);
+    _networkQueuesClosed.store(true);
+
+    // Remote commands which have not completed are canceled and scheduled into the pool, where
+    // they stay in the "completed" queue of their NetworkQueue until they run.
+    std::vector<std::shared_ptr<CallbackState>> canceledNetworkOps;
+    for (auto&& networkQueue : _networkQueues) {
+        stdx::lock_guard<stdx::mutex> networkLk(networkQueue.mutex);
+        for (auto&& cbState : networkQueue.completed) {
+            cbState->canceled.store(1);
+        }
+        for (auto&& cbState : networkQueue.inProgress) {
+            cbState->canceled.store(1);
+            canceledNetworkOps.push_back(cbState);
+        }
+        networkQueue.completed.splice(networkQueue.completed.end(), networkQueue.inProgress);
+    }
+
     WorkQueue pending;
-    pending.splice(pending.end(), _networkInProgressQueue);
     pending.splice(pending.end(), _sleepersQueue);
     for (auto&& eventState : _unsignaledEvents) {
         pending.splice(pending.end(), eventState->waiters);
@@ -170,6 +191,7 @@ void ThreadPoolTaskExecutor::shutdown() {
         cbState->canceled.store(1);
     }
     scheduleIntoPool_inlock(&pending, std::move(lk));
+    _scheduleIntoPool(canceledNetworkOps);
     _pool->shutdown();
 }
 
@@ -223,7 +245,16 @@ stdx::unique_lock<stdx::mutex> ThreadPoolTaskExecutor::_join(stdx::unique_lock<s
         runCallback(std::move(cbState));
         lk.lock();
     }
-    invariant(_networkInProgressQueue.empty());
+    for (auto&& networkQueue : _networkQueues) {
+        stdx::unique_lock<stdx::mutex> networkLk(networkQueue.mutex);
+        while (!networkQueue.completed.empty()) {
+            auto cbState = networkQueue.completed.front();
+            networkLk.unlock();
+            runCallback(std::move(cbState));
+            networkLk.lock();
+        }
+        invariant(networkQueue.inProgress.empty());
+    }
     invariant(_sleepersQueue.empty());
     invariant(_unsignaledEvents.empty());
     _setState_inlock(shutdownComplete);
@@ -233,15 +264,23 @@ stdx::unique_lock<stdx::mutex> ThreadPoolTaskExecutor::_join(stdx::unique_lock<s
 void ThreadPoolTaskExecutor::appendDiagnosticBSON(BSONObjBuilder* b) const {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
+    size_t poolInProgressCount = _poolInProgressQueue.size();
+    size_t networkInProgressCount = 0;
+    for (auto&& networkQueue : _networkQueues) {
+        stdx::lock_guard<stdx::mutex> networkLk(networkQueue.mutex);
+        poolInProgressCount += networkQueue.completed.size();
+        networkInProgressCount += networkQueue.inProgress.size();
+    }
+
     // ThreadPool details
     // TODO: fill in
     BSONObjBuilder poolCounters(b->subobjStart("pool"));
-    poolCounters.appendIntOrLL("inProgressCount", _poolInProgressQueue.size());
+    poolCounters.appendIntOrLL("inProgressCount", poolInProgressCount);
     poolCounters.done();
 
     // Queues
     BSONObjBuilder queues(b->subobjStart("queues"));
-    queues.appendIntOrLL("networkInProgress", _networkInProgressQueue.size());
+    queues.appendIntOrLL("networkInProgress", networkInProgressCount);
     queues.appendIntOrLL("sleepers", _sleepersQueue.size());
     queues.done();
 
@@ -412,37 +451,50 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleRemoteC
         },
         baton);
     wq.front()->isNetworkOperation = true;
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    auto swCbHandle = enqueueCallbackState_inlock(&_networkInProgressQueue, &wq);
-    if (!swCbHandle.isOK())
-        return swCbHandle;
-    const auto cbState = _networkInProgressQueue.back();
+    const auto networkQueue = _nextNetworkQueue();
+    wq.front()->networkQueue = networkQueue;
+
+    // Only the mutex of the chosen NetworkQueue is taken, so concurrent remote commands do not
+    // contend on _mutex.
+    stdx::unique_lock<stdx::mutex> lk(networkQueue->mutex);
+    if (_networkQueuesClosed.load()) {
+        return {ErrorCodes::ShutdownInProgress, "Shutdown in progress"};
+    }
+    networkQueue->inProgress.splice(networkQueue->inProgress.end(), wq, wq.begin());
+    const auto cbState = networkQueue->inProgress.back();
+    CallbackHandle cbHandle;
+    setCallbackForHandle(&cbHandle, cbState);
     LOG(3) << "Scheduling remote command request: " << redact(scheduledRequest.toString());
     lk.unlock();
 
     auto commandStatus = _net->startCommand(
-        swCbHandle.getValue(),
+        cbHandle,
         scheduledRequest,
         [this, scheduledRequest, cbState, cb](const ResponseStatus& response) {
             using std::swap;
             CallbackFn newCb = [cb, scheduledRequest, response](const CallbackArgs& cbData) {
                 remoteCommandFinished(cbData, cb, scheduledRequest, response);
             };
-            stdx::unique_lock<stdx::mutex> lk(_mutex);
-            if (_inShutdown_inlock()) {
+            auto networkQueue = cbState->networkQueue;
+            stdx::unique_lock<stdx::mutex> lk(networkQueue->mutex);
+            // Once the queues are closed, shutdown() schedules every remote command itself.
+            if (_networkQueuesClosed.load()) {
                 return;
             }
             LOG(3) << "Received remote response: "
                    << redact(response.isOK() ? response.toString() : response.status.toString());
             swap(cbState->callback, newCb);
-            scheduleIntoPool_inlock(&_networkInProgressQueue, cbState->iter, std::move(lk));
+            networkQueue->completed.splice(
+                networkQueue->completed.end(), networkQueue->inProgress, cbState->iter);
+            lk.unlock();
+            _scheduleIntoPool({cbState});
         },
         baton);
 
     if (!commandStatus.isOK())
         return commandStatus;
 
-    return swCbHandle;
+    return cbHandle;
 }
 
 void ThreadPoolTaskExecutor::cancel(const CallbackHandle& cbHandle) {
@@ -479,7 +531,8 @@ void ThreadPoolTaskExecutor::wait(const CallbackHandle& cbHandle, Interruptible*
     if (cbState->isFinished.load()) {
         return;
     }
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::unique_lock<stdx::mutex> lk(cbState->networkQueue ? cbState->networkQueue->mutex
+                                                            : _mutex);
     if (!cbState->finishedCondition) {
         cbState->finishedCondition.emplace();
     }
@@ -551,7 +604,11 @@ void ThreadPoolTaskExecutor::scheduleIntoPool_inlock(WorkQueue* fromQueue,
     _poolInProgressQueue.splice(_poolInProgressQueue.end(), *fromQueue, begin, end);
 
     lk.unlock();
+    _scheduleIntoPool(todo);
+}
 
+void ThreadPoolTaskExecutor::_scheduleIntoPool(
+    const std::vector<std::shared_ptr<CallbackState>>& todo) {
     if (MONGO_FAIL_POINT(scheduleIntoPoolSpinsUntilThreadPoolShutsDown)) {
         scheduleIntoPoolSpinsUntilThreadPoolShutsDown.setMode(FailPoint::off);
         while (_pool->schedule([] {}) != ErrorCodes::ShutdownInProgress) {
@@ -592,13 +649,22 @@ void ThreadPoolTaskExecutor::runCallback(std::shared_ptr<CallbackState> cbStateA
         callback(std::move(args));
     }
     cbStateArg->isFinished.store(true);
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    _poolInProgressQueue.erase(cbStateArg->iter);
+    const auto networkQueue = cbStateArg->networkQueue;
+    stdx::lock_guard<stdx::mutex> lk(networkQueue ? networkQueue->mutex : _mutex);
+    if (networkQueue) {
+        networkQueue->completed.erase(cbStateArg->iter);
+    } else {
+        _poolInProgressQueue.erase(cbStateArg->iter);
+    }
     if (cbStateArg->finishedCondition) {
         cbStateArg->finishedCondition->notify_all();
     }
 }
 
+ThreadPoolTaskExecutor::NetworkQueue* ThreadPoolTaskExecutor::_nextNetworkQueue() {
+    return &_networkQueues[_networkQueueCounter.fetchAndAdd(1) % _networkQueues.size()];
+}
+
 bool ThreadPoolTaskExecutor::_inShutdown_inlock() const {
     return _state >= joinRequired;
 }
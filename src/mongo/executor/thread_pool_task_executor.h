@@ -28,10 +28,13 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/list.h"
 #include "mongo/stdx/mutex.h"
@@ -120,6 +123,22 @@ private:
      */
     enum State { preStart, running, joinRequired, joining, shutdownComplete };
 
+    /**
+     * Tracks remote commands from when they are started until their callbacks finish. Remote
+     * commands are spread over several of these, each with its own mutex, so that starting and
+     * completing many remote commands at once does not serialize on _mutex.
+     */
+    struct NetworkQueue {
+        mutable stdx::mutex mutex;
+
+        // Items currently scheduled into the network interface.
+        WorkQueue inProgress;
+
+        // Items whose responses have arrived, which are scheduled into the thread pool but not yet
+        // completed.
+        WorkQueue completed;
+    };
+
     /**
      * Returns an EventList containing one unsignaled EventState. This is a helper function for
      * performing allocations outside of _mutex, and should only be called by makeSingletonWork and
@@ -170,6 +189,17 @@ private:
                                  const WorkQueue::iterator& end,
                                  stdx::unique_lock<stdx::mutex> lk);
 
+    /**
+     * Schedules the callbacks in "todo" into the thread pool, or onto their batons. Must be called
+     * without holding _mutex or the mutex of any NetworkQueue.
+     */
+    void _scheduleIntoPool(const std::vector<std::shared_ptr<CallbackState>>& todo);
+
+    /**
+     * Returns the NetworkQueue which should track the next remote command.
+     */
+    NetworkQueue* _nextNetworkQueue();
+
     /**
      * Executes the callback specified by "cbState".
      */
@@ -185,15 +215,20 @@ private:
     // The thread pool that executes scheduled work items.
     std::unique_ptr<ThreadPoolInterface> _pool;
 
-    // Mutex guarding all remaining fields.
+    // Queues of remote commands, each guarded by its own mutex. Once _networkQueuesClosed is set,
+    // which happens in shutdown(), no more remote commands are added to them.
+    std::array<NetworkQueue, 16> _networkQueues;
+    AtomicUInt64 _networkQueueCounter;
+    AtomicWord<bool> _networkQueuesClosed{false};
+
+    // Mutex guarding all remaining fields. When both are held, _mutex is acquired before the mutex
+    // of a NetworkQueue.
     mutable stdx::mutex _mutex;
 
-    // Queue containing all items currently scheduled into the thread pool but not yet completed.
+    // Queue containing all items other than remote commands currently scheduled into the thread
+    // pool but not yet completed.
     WorkQueue _poolInProgressQueue;
 
-    // Queue containing all items currently scheduled into the network interface.
-    WorkQueue _networkInProgressQueue;
-
     // Queue containing all items waiting for a particular point in time to execute.
     WorkQueue _sleepersQueue;
 
@@ -159,6 +159,48 @@ TEST_F(ThreadPoolExecutorTest, ShutdownAndScheduleRaceDoesNotCrash) {
     ASSERT_EQUALS(ErrorCodes::CallbackCanceled, status2);
 }
 
+TEST_F(ThreadPoolExecutorTest, ManyRemoteCommandsCompleteOrAreCanceledAtShutdown) {
+    // Remote commands are spread over several network queues, so schedule enough of them to use
+    // each queue more than once.
+    const size_t numCommands = 40;
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    const RemoteCommandRequest request(
+        HostAndPort("localhost", 27017), "mydb", BSON("whatsUp" << 1), nullptr);
+    std::vector<Status> statuses(numCommands, getDetectableErrorStatus());
+    std::vector<TaskExecutor::CallbackHandle> cbHandles;
+    for (size_t i = 0; i < numCommands; ++i) {
+        cbHandles.push_back(unittest::assertGet(executor.scheduleRemoteCommand(
+            request, [&statuses, i](const TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+                statuses[i] = cbData.response.status;
+            })));
+    }
+
+    // Respond to all but the last command, and leave that one outstanding.
+    net->enterNetwork();
+    for (size_t i = 0; i + 1 < numCommands; ++i) {
+        ASSERT(net->hasReadyRequests());
+        net->scheduleSuccessfulResponse(BSON("ok" << 1));
+    }
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+    for (size_t i = 0; i + 1 < numCommands; ++i) {
+        executor.wait(cbHandles[i]);
+        ASSERT_OK(statuses[i]);
+    }
+
+    executor.shutdown();
+    ASSERT_EQUALS(ErrorCodes::ShutdownInProgress,
+                  executor
+                      .scheduleRemoteCommand(request,
+                                             [](const TaskExecutor::RemoteCommandCallbackArgs&) {})
+                      .getStatus());
+    joinExecutorThread();
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, statuses.back());
+}
+
 }  // namespace
 }  // namespace executor
 }  // namespace mongo
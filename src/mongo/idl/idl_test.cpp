@@ -609,6 +609,55 @@ TEST(IDLCompareTests, TestSomeFields) {
     }
 }
 
+/// Struct string view tests
+TEST(IDLViewTests, TestViewStrings) {
+    IDLParserErrorContext ctxt("root");
+
+    auto testDoc = BSON("field1"
+                        << "abc"
+                        << "field2"
+                        << "def"
+                        << "field3"
+                        << BSON_ARRAY("x"
+                                      << "y")
+                        << "field4"
+                        << BSON("a" << 1));
+    auto testStruct = ViewStrings::parse(ctxt, testDoc);
+
+    // The parsed strings and object point into the parsed document.
+    StringData field1 = testStruct.getField1();
+    ASSERT_EQUALS(field1, "abc");
+    ASSERT(field1.rawData() == testDoc["field1"].valuestr());
+    ASSERT_EQUALS(testStruct.getField2().get(), "def");
+    ASSERT(testStruct.getField2()->rawData() == testDoc["field2"].valuestr());
+    ASSERT_EQUALS(testStruct.getField3().size(), 2UL);
+    ASSERT_EQUALS(testStruct.getField3()[1], "y");
+    ASSERT(testStruct.getField4().objdata() == testDoc["field4"].Obj().objdata());
+
+    // Positive: Test we can roundtrip from the just parsed document
+    {
+        BSONObjBuilder builder;
+        testStruct.serialize(&builder);
+        auto loopbackDoc = builder.obj();
+
+        ASSERT_BSONOBJ_EQ(testDoc, loopbackDoc);
+    }
+
+    // Positive: Test we can serialize from nothing the same document
+    {
+        BSONObjBuilder builder;
+        ViewStrings one_new;
+        one_new.setField1("abc");
+        one_new.setField2(StringData("def"));
+        one_new.setField3({"x", "y"});
+        one_new.setField4(BSON("a" << 1));
+        one_new.serialize(&builder);
+
+        auto serializedDoc = builder.obj();
+        ASSERT_BSONOBJ_EQ(testDoc, serializedDoc);
+    }
+}
+
 /// Field tests
 // Positive: check ignored field is ignored
 TEST(IDLFieldTests, TestStrictStructIgnoredField) {
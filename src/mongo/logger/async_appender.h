@@ -0,0 +1,338 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/encoder.h"
+#include "mongo/logger/log_component.h"
+#include "mongo/logger/log_severity.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+
+/**
+ * Appender that moves the writing of log messages off the calling thread.
+ *
+ * append() encodes the event on the caller's thread and places the text in a bounded ring
+ * buffer, claiming a slot with a single compare-and-swap. A dedicated flusher thread drains the
+ * buffer and hands the text to "sink" in batches, so callers never wait for the sink's I/O or
+ * lock. If the buffer is full the message is dropped and counted; the flusher writes a line
+ * reporting the number of dropped messages the next time it has room.
+ *
+ * Messages of severity Error and above, and every message while write-through is on, are not
+ * returned from until the flusher has written them, so that nothing explaining a crash or an
+ * exit is left in the buffer.
+ *
+ * The sink receives already-encoded text, possibly several lines at a time, so it should be
+ * an appender using MessageEventUnadornedEncoder. "encoder" is called concurrently from every
+ * logging thread, which is safe for the stateless encoders in this directory.
+ */
+template <typename Event>
+class AsyncAppender : public Appender<Event> {
+    MONGO_DISALLOW_COPYING(AsyncAppender);
+
+public:
+    typedef Encoder<Event> EventEncoder;
+    typedef Appender<MessageEventEphemeral> Sink;
+
+    // Upper bound on the text handed to the sink in one batch.
+    static constexpr size_t kMaxBatchBytes = 1024 * 1024;
+
+    /**
+     * Constructs an appender that buffers up to "capacity" messages, rounded up to a power of two,
+     * and starts its flusher thread.
+     */
+    AsyncAppender(std::unique_ptr<EventEncoder> encoder,
+                  std::unique_ptr<Sink> sink,
+                  size_t capacity)
+        : _encoder(std::move(encoder)),
+          _sink(std::move(sink)),
+          _capacity(_roundUpToPowerOfTwo(capacity)),
+          _slots(new Slot[_capacity]) {
+        for (size_t i = 0; i < _capacity; ++i) {
+            _slots[i].sequence.store(i);
+        }
+        _flusher = stdx::thread([this] { _flusherBody(); });
+    }
+
+    /**
+     * Writes every buffered message, then stops the flusher thread.
+     */
+    ~AsyncAppender() override {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _inShutdown = true;
+            _workAvailable.notify_one();
+        }
+        _flusher.join();
+    }
+
+    Status append(const Event& event) override {
+        std::ostringstream os;
+        _encoder->encode(event, os);
+
+        uint64_t position = _enqueuePosition.load();
+        Slot* slot;
+        while (true) {
+            slot = &_slots[position & (_capacity - 1)];
+            const auto sequence = slot->sequence.load();
+            if (sequence == position) {
+                const auto observed = _enqueuePosition.compareAndSwap(position, position + 1);
+                if (observed == position) {
+                    break;
+                }
+                position = observed;
+            } else if (sequence < position) {
+                // The flusher has not yet consumed the message a full lap behind this one.
+                _numDropped.fetchAndAdd(1);
+                return Status::OK();
+            } else {
+                position = _enqueuePosition.load();
+            }
+        }
+
+        slot->date = event.getDate();
+        slot->severity = event.getSeverity().toInt();
+        slot->component = event.getComponent();
+        slot->text = os.str();
+        slot->sequence.store(position + 1);
+
+        // Pairs with the store to _flusherSleeping in _waitForWork(): either the flusher sees this
+        // slot published, or this thread sees the flusher asleep and wakes it.
+        if (_flusherSleeping.load()) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _workAvailable.notify_one();
+        }
+
+        if (event.getSeverity() >= LogSeverity::Error() || _writeThrough.load()) {
+            return _waitUntilWritten(position + 1);
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Blocks until every message appended before this call has been handed to the sink.
+     */
+    void flush() {
+        _waitUntilWritten(_enqueuePosition.load()).ignore();
+    }
+
+    /**
+     * When on, append() waits for each message to be written, as if the appender were
+     * synchronous. Intended for the final stretch of process shutdown.
+     */
+    void setWriteThrough(bool writeThrough) {
+        _writeThrough.store(writeThrough);
+        if (writeThrough) {
+            flush();
+        }
+    }
+
+    /**
+     * Returns the number of messages dropped because the buffer was full.
+     */
+    uint64_t getNumDropped() const {
+        return _numDropped.load();
+    }
+
+private:
+    /**
+     * One message in the ring buffer. "sequence" equals the slot's next enqueue position while it
+     * is free, and that position plus one once the message in it is ready to be written.
+     */
+    struct Slot {
+        AtomicUInt64 sequence;
+        Date_t date;
+        int severity;
+        LogComponent component{LogComponent::kDefault};
+        std::string text;
+    };
+
+    static size_t _roundUpToPowerOfTwo(size_t n) {
+        size_t result = 2;
+        while (result < n) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void _flusherBody() {
+        setThreadName("logFlusher");
+        std::string batch;
+        uint64_t reportedDrops = 0;
+        while (true) {
+            const auto dropped = _numDropped.load();
+            if (dropped != reportedDrops) {
+                _writeDropReport(dropped - reportedDrops);
+                reportedDrops = dropped;
+            }
+
+            // Gather every ready message, up to the batch limit, and hand them over at once.
+            Date_t lastDate;
+            LogSeverity maxSeverity = LogSeverity::Debug(5);
+            LogComponent component = LogComponent::kDefault;
+            while (batch.size() < kMaxBatchBytes) {
+                Slot& slot = _slots[_dequeuePosition & (_capacity - 1)];
+                if (slot.sequence.load() != _dequeuePosition + 1) {
+                    break;
+                }
+                batch += slot.text;
+                std::string().swap(slot.text);
+                lastDate = slot.date;
+                maxSeverity = std::max(maxSeverity, LogSeverity::cast(slot.severity));
+                component = slot.component;
+                slot.sequence.store(_dequeuePosition + _capacity);
+                ++_dequeuePosition;
+            }
+
+            if (!batch.empty()) {
+                const auto status = _sink->append(
+                    MessageEventEphemeral(lastDate, maxSeverity, component, StringData(), batch));
+                batch.clear();
+                _markWritten(status);
+                continue;
+            }
+
+            if (!_waitForWork()) {
+                return;
+            }
+        }
+    }
+
+    void _writeDropReport(uint64_t numDropped) {
+        const std::string message = "Dropped " + std::to_string(numDropped) +
+            " log messages because the asynchronous log buffer was full";
+        std::ostringstream os;
+        _encoder->encode(Event(Date_t::now(),
+                               LogSeverity::Warning(),
+                               LogComponent::kDefault,
+                               StringData(),
+                               message),
+                         os);
+        _sink->append(MessageEventEphemeral(
+                          Date_t::now(), LogSeverity::Warning(), StringData(), os.str()))
+            .ignore();
+    }
+
+    /**
+     * Publishes the flusher's progress after a batch and wakes any callers waiting on it.
+     */
+    void _markWritten(const Status& status) {
+        _writtenPosition.store(_dequeuePosition);
+        // Pairs with the increment of _numWaiters in _waitUntilWritten().
+        if (_numWaiters.load() > 0 || !status.isOK() || _sinkFailed) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _lastSinkStatus = status;
+            _sinkFailed = !status.isOK();
+            _written.notify_all();
+        }
+    }
+
+    /**
+     * Sleeps until a message may be ready or the appender is being destroyed. Returns false once
+     * the appender is shutting down and the buffer is empty.
+     */
+    bool _waitForWork() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _flusherSleeping.store(true);
+        const auto isReady = [this] {
+            return _slots[_dequeuePosition & (_capacity - 1)].sequence.load() ==
+                _dequeuePosition + 1;
+        };
+        while (!isReady()) {
+            if (_inShutdown) {
+                _flusherSleeping.store(false);
+                return false;
+            }
+            _workAvailable.wait(lk);
+        }
+        _flusherSleeping.store(false);
+        return true;
+    }
+
+    Status _waitUntilWritten(uint64_t position) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _numWaiters.fetchAndAdd(1);
+        _written.wait(lk, [&] { return _writtenPosition.load() >= position; });
+        _numWaiters.subtractAndFetch(1);
+        return _lastSinkStatus;
+    }
+
+    const std::unique_ptr<EventEncoder> _encoder;
+    const std::unique_ptr<Sink> _sink;
+    const size_t _capacity;
+    const std::unique_ptr<Slot[]> _slots;
+
+    // Next position a producer will claim. Positions grow forever; a position's slot is
+    // position & (_capacity - 1).
+    AtomicUInt64 _enqueuePosition{0};
+
+    // Next position the flusher will read. Only touched by the flusher thread.
+    uint64_t _dequeuePosition = 0;
+
+    // Whether the last batch failed, so that the next one clears _lastSinkStatus. Only touched by
+    // the flusher thread.
+    bool _sinkFailed = false;
+
+    // Every message before this position has been handed to the sink.
+    AtomicUInt64 _writtenPosition{0};
+
+    AtomicUInt64 _numDropped{0};
+    AtomicBool _flusherSleeping{false};
+    AtomicBool _writeThrough{false};
+    AtomicInt32 _numWaiters{0};
+
+    // Guards the members below, and is the mutex for the condition variables.
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _written;
+    bool _inShutdown = false;
+    Status _lastSinkStatus = Status::OK();
+
+    stdx::thread _flusher;
+};
+
+}  // namespace logger
+}  // namespace mongo
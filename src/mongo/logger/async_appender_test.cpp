@@ -0,0 +1,206 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/logger/async_appender.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/logger/message_event_utf8_encoder.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace logger {
+namespace {
+
+using AsyncMessageAppender = AsyncAppender<MessageEventEphemeral>;
+
+/**
+ * Sink that records the text of every append() and can be held closed to simulate a slow disk.
+ */
+class RecordingSink : public Appender<MessageEventEphemeral> {
+public:
+    struct State {
+        stdx::mutex mutex;
+        stdx::condition_variable cv;
+        std::string text;
+        size_t numAppends = 0;
+        bool blocked = false;
+        bool sinkEntered = false;
+    };
+
+    explicit RecordingSink(State* state) : _state(state) {}
+
+    Status append(const MessageEventEphemeral& event) override {
+        stdx::unique_lock<stdx::mutex> lk(_state->mutex);
+        _state->sinkEntered = true;
+        _state->cv.notify_all();
+        _state->cv.wait(lk, [&] { return !_state->blocked; });
+        _encoder.encode(event, _os);
+        _state->text += _os.str();
+        _os.str("");
+        ++_state->numAppends;
+        _state->cv.notify_all();
+        return Status::OK();
+    }
+
+private:
+    State* const _state;
+    std::ostringstream _os;
+    MessageEventUnadornedEncoder _encoder;
+};
+
+std::unique_ptr<AsyncMessageAppender> makeAppender(RecordingSink::State* state, size_t capacity) {
+    return stdx::make_unique<AsyncMessageAppender>(
+        stdx::make_unique<MessageEventUnadornedEncoder>(),
+        stdx::make_unique<RecordingSink>(state),
+        capacity);
+}
+
+MessageEventEphemeral makeEvent(StringData message, LogSeverity severity = LogSeverity::Log()) {
+    return MessageEventEphemeral(Date_t::now(), severity, "test", message);
+}
+
+TEST(AsyncAppenderTest, FlushWritesMessagesInOrder) {
+    RecordingSink::State state;
+    auto appender = makeAppender(&state, 2048);
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        const std::string message = "message " + std::to_string(i);
+        ASSERT_OK(appender->append(makeEvent(message)));
+        expected += message + "\n";
+    }
+    appender->flush();
+
+    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+    ASSERT_EQ(expected, state.text);
+}
+
+TEST(AsyncAppenderTest, DestructorWritesBufferedMessages) {
+    RecordingSink::State state;
+    {
+        auto appender = makeAppender(&state, 64);
+        {
+            stdx::lock_guard<stdx::mutex> lk(state.mutex);
+            state.blocked = true;
+        }
+        ASSERT_OK(appender->append(makeEvent("first")));
+        ASSERT_OK(appender->append(makeEvent("second")));
+        {
+            stdx::lock_guard<stdx::mutex> lk(state.mutex);
+            state.blocked = false;
+            state.cv.notify_all();
+        }
+    }
+    ASSERT_EQ("first\nsecond\n", state.text);
+}
+
+TEST(AsyncAppenderTest, ErrorsAreWrittenBeforeAppendReturns) {
+    RecordingSink::State state;
+    auto appender = makeAppender(&state, 64);
+    ASSERT_OK(appender->append(makeEvent("info")));
+    ASSERT_OK(appender->append(makeEvent("error", LogSeverity::Error())));
+
+    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+    ASSERT_EQ("info\nerror\n", state.text);
+}
+
+TEST(AsyncAppenderTest, WriteThroughWritesEveryMessageBeforeAppendReturns) {
+    RecordingSink::State state;
+    auto appender = makeAppender(&state, 64);
+    appender->setWriteThrough(true);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_OK(appender->append(makeEvent("line")));
+        stdx::lock_guard<stdx::mutex> lk(state.mutex);
+        ASSERT_EQ(static_cast<size_t>(5 * (i + 1)), state.text.size());
+    }
+}
+
+TEST(AsyncAppenderTest, FullBufferDropsAndReportsMessages) {
+    RecordingSink::State state;
+    auto appender = makeAppender(&state, 4);
+
+    // Hold the sink closed while the flusher is stuck writing the first message, so that the
+    // buffer fills up behind it.
+    stdx::unique_lock<stdx::mutex> lk(state.mutex);
+    state.blocked = true;
+    lk.unlock();
+    ASSERT_OK(appender->append(makeEvent("stuck")));
+    lk.lock();
+    state.cv.wait(lk, [&] { return state.sinkEntered; });
+    lk.unlock();
+
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_OK(appender->append(makeEvent("queued")));
+    }
+    ASSERT_EQ(16U, appender->getNumDropped());
+
+    lk.lock();
+    state.blocked = false;
+    state.cv.notify_all();
+    lk.unlock();
+    appender->flush();
+    appender.reset();
+
+    ASSERT_STRING_CONTAINS(state.text, "stuck\n");
+    ASSERT_STRING_CONTAINS(state.text, "log messages because the asynchronous log buffer was full");
+}
+
+TEST(AsyncAppenderTest, ConcurrentProducersLoseNothingWithRoom) {
+    RecordingSink::State state;
+    auto appender = makeAppender(&state, 1 << 14);
+    const int kThreads = 4;
+    const int kMessagesPerThread = 2000;
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kMessagesPerThread; ++i) {
+                ASSERT_OK(appender->append(makeEvent("x")));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    appender->flush();
+
+    ASSERT_EQ(0U, appender->getNumDropped());
+    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+    ASSERT_EQ(static_cast<size_t>(2 * kThreads * kMessagesPerThread), state.text.size());
+}
+
+}  // namespace
+}  // namespace logger
+}  // namespace mongo
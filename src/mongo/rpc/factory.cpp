@@ -40,9 +40,17 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 namespace rpc {
+namespace {
+
+// Replies start out in a pooled buffer of at least this size; the service state machine hands the
+// buffer back to the pool once the reply has been sent.
+const size_t kInitialReplyBufferSize = 512;
+
+}  // namespace
 
 Message messageFromOpMsgRequest(Protocol proto, const OpMsgRequest& request) {
     switch (proto) {
@@ -83,7 +91,8 @@ OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage) {
 std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol) {
     switch (protocol) {
         case Protocol::kOpMsg:
-            return stdx::make_unique<OpMsgReplyBuilder>();
+            return stdx::make_unique<OpMsgReplyBuilder>(
+                SharedBufferPool::acquire(kInitialReplyBufferSize));
         case Protocol::kOpQuery:
             return stdx::make_unique<LegacyReplyBuilder>();
     }
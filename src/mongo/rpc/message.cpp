@@ -42,4 +42,58 @@ int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
 
+void Message::flatten() {
+    if (!isScatterGather()) {
+        return;
+    }
+
+    const int totalSize = size();
+    auto flat = SharedBuffer::allocate(totalSize);
+    char* out = flat.get();
+    memcpy(out, _buf.get(), _headSize);
+    out += _headSize;
+    for (const auto& slice : _slices) {
+        memcpy(out, slice.data, slice.size);
+        out += slice.size;
+    }
+    invariant(out == flat.get() + totalSize);
+
+    _buf = std::move(flat);
+    _headSize = 0;
+    _slices.clear();
+}
+
+MessageSliceBuilder::MessageSliceBuilder(int initialSize) : _head(initialSize) {}
+
+void MessageSliceBuilder::appendSlice(ConstSharedBuffer owner, const char* data, size_t size) {
+    _sealChunk();
+    _slices.push_back({std::move(owner), data, size});
+    _tailLen += size;
+}
+
+void MessageSliceBuilder::_sealChunk() {
+    if (!_chunk) {
+        return;
+    }
+
+    const auto chunkLen = _chunk->len();
+    if (chunkLen > 0) {
+        ConstSharedBuffer chunk = _chunk->release();
+        const char* data = chunk.get();
+        _slices.push_back({std::move(chunk), data, static_cast<size_t>(chunkLen)});
+        _tailLen += chunkLen;
+    }
+    _chunk.reset();
+}
+
+Message MessageSliceBuilder::release() {
+    _sealChunk();
+
+    const int headSize = _head.len();
+    if (_slices.empty()) {
+        return Message(_head.release());
+    }
+    return Message(_head.release(), headSize, std::move(_slices));
+}
+
 }  // namespace mongo
@@ -29,12 +29,17 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -389,11 +394,28 @@ inline int ConstView::dataLen() const {
 
 }  // namespace MsgData
 
+/**
+ * A piece of a message's contents which is sent straight from a buffer shared with someone else,
+ * such as a document in a query's result set, rather than being copied into the message.
+ */
+struct MessageSlice {
+    ConstSharedBuffer owner;
+    const char* data;
+    size_t size;
+};
+
 class Message {
 public:
     Message() = default;
     explicit Message(SharedBuffer data) : _buf(std::move(data)) {}
 
+    /**
+     * Makes a scatter-gather message, whose first 'headSize' bytes are in 'head' and the rest in
+     * 'slices'. The length in the header covers the slices.
+     */
+    Message(SharedBuffer head, int headSize, std::vector<MessageSlice> slices)
+        : _buf(std::move(head)), _headSize(headSize), _slices(std::move(slices)) {}
+
     MsgData::View header() const {
         verify(!empty());
         return _buf.get();
@@ -423,8 +445,42 @@ public:
         return size() - sizeof(MSGHEADER::Value);
     }
 
+    /**
+     * Scatter-gather messages only keep their header, and whatever precedes the first slice, in
+     * their own buffer. buf() and sharedBuffer() may not be used on them until they are flattened.
+     */
+    bool isScatterGather() const {
+        return !_slices.empty();
+    }
+
+    /**
+     * The number of bytes in this message's own buffer, which is all of them unless this is a
+     * scatter-gather message.
+     */
+    int headSize() const {
+        return isScatterGather() ? _headSize : size();
+    }
+
+    /**
+     * The start of this message's own buffer, which holds headSize() bytes.
+     */
+    const char* headBuf() const {
+        return _buf.get();
+    }
+
+    const std::vector<MessageSlice>& slices() const {
+        return _slices;
+    }
+
+    /**
+     * Copies the slices of a scatter-gather message into a buffer of its own.
+     */
+    void flatten();
+
     void reset() {
         _buf = {};
+        _headSize = 0;
+        _slices.clear();
     }
 
     // use to set first buffer if empty
@@ -447,23 +503,93 @@ public:
     }
 
     char* buf() {
+        invariant(!isScatterGather());
         return _buf.get();
     }
 
     const char* buf() const {
+        invariant(!isScatterGather());
         return _buf.get();
     }
 
     SharedBuffer sharedBuffer() {
+        invariant(!isScatterGather());
         return _buf;
     }
 
     ConstSharedBuffer sharedBuffer() const {
+        invariant(!isScatterGather());
         return _buf;
     }
 
 private:
     SharedBuffer _buf;
+
+    // Only used by scatter-gather messages.
+    int _headSize = 0;
+    std::vector<MessageSlice> _slices;
+};
+
+/**
+ * Builds a message which may be scatter-gather. Bytes appended with appendBuf() are copied into
+ * the message, while slices are only referenced. len() counts both.
+ *
+ * Only the bytes before the first slice can be written in place through headBuf(), which is
+ * where the message header and any fixed-size fields that follow it belong.
+ */
+class MessageSliceBuilder {
+public:
+    explicit MessageSliceBuilder(int initialSize = 512);
+
+    char* skip(int n) {
+        invariant(_slices.empty());
+        return _head.skip(n);
+    }
+
+    void appendBuf(const void* src, size_t len) {
+        _current().appendBuf(src, len);
+    }
+
+    /**
+     * Sends 'size' bytes from 'data' without copying them, keeping 'owner' alive until the
+     * message is destroyed.
+     */
+    void appendSlice(ConstSharedBuffer owner, const char* data, size_t size);
+
+    int len() const {
+        return _head.len() + _tailLen + (_chunk ? _chunk->len() : 0);
+    }
+
+    char* headBuf() {
+        return _head.buf();
+    }
+
+    /**
+     * Returns the message. The caller must have filled in its header, including its full length.
+     */
+    Message release();
+
+private:
+    BufBuilder& _current() {
+        if (_slices.empty()) {
+            return _head;
+        }
+        if (!_chunk) {
+            _chunk = stdx::make_unique<BufBuilder>();
+        }
+        return *_chunk;
+    }
+
+    void _sealChunk();
+
+    BufBuilder _head;
+
+    // Bytes which are copied after a slice are gathered in a chunk, which becomes a slice of its
+    // own once the next slice is appended.
+    std::unique_ptr<BufBuilder> _chunk;
+
+    std::vector<MessageSlice> _slices;
+    int _tailLen = 0;
 };
 
 /**
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/rpc/message.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+SharedBuffer makeBuffer(const std::string& contents) {
+    auto buf = SharedBuffer::allocate(contents.size());
+    memcpy(buf.get(), contents.data(), contents.size());
+    return buf;
+}
+
+TEST(MessageSliceBuilder, NoSlicesBuildsContiguousMessage) {
+    MessageSliceBuilder builder;
+    builder.skip(sizeof(MSGHEADER::Value));
+    builder.appendBuf("abc", 3);
+    const int len = builder.len();
+
+    auto msg = builder.release();
+    MsgData::View(const_cast<char*>(msg.headBuf())).setLen(len);
+
+    ASSERT_FALSE(msg.isScatterGather());
+    ASSERT_EQ(msg.size(), len);
+    ASSERT_EQ(msg.headSize(), len);
+    ASSERT_EQ(std::string(msg.singleData().data(), 3), "abc");
+}
+
+TEST(MessageSliceBuilder, SlicesAreReferencedAndFlattenCopiesThem) {
+    auto first = makeBuffer("slice-one");
+    auto second = makeBuffer("slice-two");
+
+    MessageSliceBuilder builder;
+    builder.skip(sizeof(MSGHEADER::Value));
+    builder.appendBuf("head", 4);
+    builder.appendSlice(first, first.get(), 9);
+    builder.appendBuf("mid", 3);
+    builder.appendSlice(second, second.get(), 9);
+    builder.appendBuf("tail", 4);
+    const int len = builder.len();
+    ASSERT_EQ(len, static_cast<int>(sizeof(MSGHEADER::Value)) + 4 + 9 + 3 + 9 + 4);
+
+    auto msg = builder.release();
+    MsgData::View(const_cast<char*>(msg.headBuf())).setLen(len);
+
+    ASSERT_TRUE(msg.isScatterGather());
+    ASSERT_EQ(msg.size(), len);
+    ASSERT_EQ(msg.headSize(), static_cast<int>(sizeof(MSGHEADER::Value)) + 4);
+
+    // The slices point at the original buffers, with the copied bytes between them gathered into
+    // slices of their own.
+    ASSERT_EQ(msg.slices().size(), 4U);
+    ASSERT_EQ(msg.slices()[0].data, first.get());
+    ASSERT_EQ(msg.slices()[2].data, second.get());
+
+    msg.flatten();
+    ASSERT_FALSE(msg.isScatterGather());
+    ASSERT_EQ(msg.size(), len);
+    ASSERT_EQ(std::string(msg.singleData().data(), msg.dataSize()),
+              "headslice-onemidslice-twotail");
+}
+
+}  // namespace
+}  // namespace mongo
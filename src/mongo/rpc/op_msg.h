@@ -166,6 +166,15 @@ public:
         skipHeaderAndFlags();
     }
 
+    /**
+     * Builds the message in 'buf', which must not be shared, rather than in a newly allocated
+     * buffer.
+     */
+    explicit OpMsgBuilder(SharedBuffer buf) : _buf(0) {
+        _buf.useSharedBuffer(std::move(buf));
+        skipHeaderAndFlags();
+    }
+
     /**
      * See the documentation for DocSequenceBuilder below.
      */
@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/rpc/op_msg.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns a body of roughly 'bytes' bytes, as carried by a typical command.
+ */
+BSONObj makeBody(int64_t bytes) {
+    return BSON("insert"
+                << "coll"
+                << "ordered"
+                << true
+                << "$db"
+                << "test"
+                << "payload"
+                << std::string(bytes, 'x'));
+}
+
+/**
+ * Builds a message with the given body and, if 'numDocs' is non-zero, a "documents" sequence
+ * holding that many small documents.
+ */
+Message makeMessage(const BSONObj& body, int64_t numDocs) {
+    OpMsgBuilder builder;
+    if (numDocs) {
+        auto docs = builder.beginDocSequence("documents");
+        for (int64_t i = 0; i < numDocs; ++i) {
+            docs.append(BSON("_id" << i << "x" << i));
+        }
+    }
+    builder.setBody(body);
+    return builder.finish();
+}
+
+void BM_OpMsgParse(benchmark::State& state) {
+    const auto message = makeMessage(makeBody(state.range(0)), state.range(1));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(OpMsg::parse(message));
+    }
+    state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+void BM_OpMsgBuild(benchmark::State& state) {
+    const auto body = makeBody(state.range(0));
+    int64_t bytes = 0;
+    for (auto keepRunning : state) {
+        auto message = makeMessage(body, state.range(1));
+        bytes += message.size();
+        benchmark::DoNotOptimize(message);
+    }
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_OpMsgRequestSerialize(benchmark::State& state) {
+    const auto request = OpMsgRequest::fromDBAndBody("test", makeBody(state.range(0)));
+    int64_t bytes = 0;
+    for (auto keepRunning : state) {
+        auto message = request.serialize();
+        bytes += message.size();
+        benchmark::DoNotOptimize(message);
+    }
+    state.SetBytesProcessed(bytes);
+}
+
+void opMsgArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"body", "docs"});
+    for (int64_t bodyBytes : {16, 1024, 64 * 1024}) {
+        for (int64_t numDocs : {0, 100}) {
+            b->Args({bodyBytes, numDocs});
+        }
+    }
+}
+
+#define OP_MSG_BENCHMARK(fn) BENCHMARK(fn)->Apply(opMsgArgs)
+
+OP_MSG_BENCHMARK(BM_OpMsgParse);
+OP_MSG_BENCHMARK(BM_OpMsgBuild);
+BENCHMARK(BM_OpMsgRequestSerialize)->ArgName("body")->Arg(16)->Arg(1024)->Arg(64 * 1024);
+
+}  // namespace
+}  // namespace mongo
@@ -52,6 +52,13 @@ private:
 
 class OpMsgReplyBuilder final : public rpc::ReplyBuilderInterface {
 public:
+    OpMsgReplyBuilder() = default;
+
+    /**
+     * Builds the reply in 'buf', which must not be shared.
+     */
+    explicit OpMsgReplyBuilder(SharedBuffer buf) : _builder(std::move(buf)) {}
+
     ReplyBuilderInterface& setRawCommandReply(const BSONObj& reply) override {
         _builder.beginBody().appendElements(reply);
         return *this;
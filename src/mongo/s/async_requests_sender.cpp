@@ -33,6 +33,7 @@
 #include "mongo/s/async_requests_sender.h"
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/client/replica_set_monitor.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -49,6 +50,27 @@ namespace mongo {
 
 MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderUseBaton, bool, true);
 
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderHedgeReads, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderHedgeDelayPercentile, double, 95.0)
+    ->withValidator([](const double& newVal) {
+        if (!(newVal > 0 && newVal <= 100)) {
+            return Status(ErrorCodes::BadValue,
+                          "AsyncRequestsSenderHedgeDelayPercentile must be greater than 0 and at "
+                          "most 100");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderDefaultHedgeDelayMS, int, 100)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "AsyncRequestsSenderDefaultHedgeDelayMS must not be negative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 // Maximum number of retries for network and replication notMaster errors (per host).
@@ -87,6 +109,12 @@ AsyncRequestsSender::~AsyncRequestsSender() {
     while (!done()) {
         next();
     }
+
+    // Also wait for the callbacks of the requests and timers canceled after their remote had
+    // already received a response.
+    while (_numAbandonedCallbacks > 0) {
+        _opCtx->runWithoutInterruption([&] { _makeProgress(); });
+    }
 }
 
 AsyncRequestsSender::Response AsyncRequestsSender::next() {
@@ -114,6 +142,25 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() {
     return *readyResponse;
 }
 
+void AsyncRequestsSender::addRequests(const std::vector<AsyncRequestsSender::Request>& requests) {
+    for (const auto& request : requests) {
+        _remotes.emplace_back(request.shardId, request.cmdObj);
+
+        if (_stopRetrying) {
+            // Promote to the interruption status if that is why the requests were canceled.
+            _remotes.back().swResponse = !_interruptStatus.isOK()
+                ? _interruptStatus
+                : Status(ErrorCodes::CallbackCanceled,
+                         str::stream() << "Request to remote " << request.shardId
+                                       << " was not sent because pending requests were canceled");
+        }
+    }
+
+    if (!_stopRetrying) {
+        _scheduleRequests();
+    }
+}
+
 void AsyncRequestsSender::stopRetrying() {
     _stopRetrying = true;
 }
@@ -131,6 +178,12 @@ void AsyncRequestsSender::_cancelPendingRequests() {
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
+        if (remote.hedgeTimerCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerCbHandle);
+        }
     }
 }
 
@@ -222,6 +275,8 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
 
     invariant(!remote.cbHandle.isValid());
+    invariant(!remote.hedgeCbHandle.isValid());
+    invariant(!remote.hedgeTimerCbHandle.isValid());
     invariant(!remote.swResponse);
 
     Status resolveStatus = remote.resolveShardIdToHostAndPort(this, _readPreference);
@@ -235,7 +290,7 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
     auto callbackStatus = _executor->scheduleRemoteCommand(
         request,
         [remoteIndex, this](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
-            _responseQueue.push(Job{cbData, remoteIndex});
+            _responseQueue.push(Job{remoteIndex, cbData.myHandle, cbData.response});
         },
         _baton);
     if (!callbackStatus.isOK()) {
@@ -243,6 +298,12 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    remote.sentAt = Date_t::now();
+
+    if (_isHedgeable(remote)) {
+        _scheduleHedgeTimer(remoteIndex);
+    }
+
     return Status::OK();
 }
 
@@ -255,21 +316,154 @@ void AsyncRequestsSender::_makeProgress() {
     }
 
     auto& remote = _remotes[job->remoteIndex];
+
+    // Callbacks which were canceled after the remote received its response have nothing to add.
+    if (job->cbHandle != remote.cbHandle && job->cbHandle != remote.hedgeCbHandle &&
+        job->cbHandle != remote.hedgeTimerCbHandle) {
+        invariant(_numAbandonedCallbacks > 0);
+        --_numAbandonedCallbacks;
+        return;
+    }
+
     invariant(!remote.swResponse);
 
+    if (!job->response) {
+        // The hedging delay elapsed before the remote responded, unless the timer was canceled.
+        remote.hedgeTimerCbHandle = executor::TaskExecutor::CallbackHandle();
+        if (job->timerStatus.isOK() && !_stopRetrying && remote.cbHandle.isValid()) {
+            _scheduleHedgedRequest(job->remoteIndex);
+        }
+        return;
+    }
+
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
-    // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    // this copy of the request.
+    const bool fromHedge = job->cbHandle == remote.hedgeCbHandle;
+    if (fromHedge) {
+        remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+    } else {
+        remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    // If one copy of a hedged request failed, wait for the other copy
+    const bool otherCopyOutstanding = remote.cbHandle.isValid() || remote.hedgeCbHandle.isValid();
+    if (!job->response->status.isOK() && otherCopyOutstanding) {
+        return;
+    }
+
+    // The first response wins, so stop waiting on the other copy of the request
+    _abandonCallback(&remote.cbHandle);
+    _abandonCallback(&remote.hedgeCbHandle);
+    _abandonCallback(&remote.hedgeTimerCbHandle);
+
+    if (fromHedge) {
+        remote.shardHostAndPort = std::move(remote.hedgeHostAndPort);
+    }
+    remote.hedgeHostAndPort.reset();
 
     // Store the response or error.
-    if (job->cbData.response.status.isOK()) {
-        remote.swResponse = std::move(job->cbData.response);
+    if (job->response->status.isOK()) {
+        if (_isHedgeable(remote)) {
+            if (auto rsm = remote.getReplicaSetMonitor()) {
+                rsm->noteOperationLatency(
+                    *remote.shardHostAndPort,
+                    Date_t::now() - (fromHedge ? remote.hedgeSentAt : remote.sentAt));
+            }
+        }
+
+        remote.swResponse = std::move(*job->response);
     } else {
         // TODO: call participant.markAsCommandSent on "transaction already started" errors?
-        remote.swResponse = std::move(job->cbData.response.status);
+        remote.swResponse = std::move(job->response->status);
+    }
+}
+
+bool AsyncRequestsSender::_isHedgeable(const RemoteData& remote) const {
+    if (!AsyncRequestsSenderHedgeReads.load()) {
+        return false;
+    }
+
+    switch (_readPreference.pref) {
+        case ReadPreference::SecondaryOnly:
+        case ReadPreference::SecondaryPreferred:
+        case ReadPreference::Nearest:
+            break;
+        default:
+            return false;
+    }
+
+    // Commands which establish cursors are not hedged, because the cursor opened by the copy of
+    // the request whose response is discarded would be left behind until it times out.
+    const StringData commandName = remote.cmdObj.firstElementFieldName();
+    return commandName == "count" || commandName == "distinct";
+}
+
+void AsyncRequestsSender::_scheduleHedgeTimer(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    auto rsm = remote.getReplicaSetMonitor();
+    if (!rsm) {
+        return;
+    }
+
+    const auto hedgeDelay =
+        rsm->getOperationLatencyPercentile(*remote.shardHostAndPort,
+                                           AsyncRequestsSenderHedgeDelayPercentile.load())
+            .get_value_or(Milliseconds(AsyncRequestsSenderDefaultHedgeDelayMS.load()));
+
+    auto callbackStatus = _executor->scheduleWorkAt(
+        _executor->now() + hedgeDelay,
+        [remoteIndex, this](const executor::TaskExecutor::CallbackArgs& cbArgs) {
+            _responseQueue.push(Job{remoteIndex, cbArgs.myHandle, boost::none, cbArgs.status});
+        });
+    if (callbackStatus.isOK()) {
+        remote.hedgeTimerCbHandle = callbackStatus.getValue();
     }
 }
 
+void AsyncRequestsSender::_scheduleHedgedRequest(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    auto rsm = remote.getReplicaSetMonitor();
+    if (!rsm) {
+        return;
+    }
+
+    auto hedgeHost = rsm->getMatchingHostNoRefresh(_readPreference, {*remote.shardHostAndPort});
+    if (hedgeHost.empty()) {
+        return;
+    }
+
+    executor::RemoteCommandRequest request(hedgeHost, _db, remote.cmdObj, _metadataObj, _opCtx);
+
+    auto callbackStatus = _executor->scheduleRemoteCommand(
+        request,
+        [remoteIndex, this](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+            _responseQueue.push(Job{remoteIndex, cbData.myHandle, cbData.response});
+        },
+        _baton);
+    if (!callbackStatus.isOK()) {
+        return;
+    }
+
+    LOG(1) << "Hedging request to remote " << remote.shardId << " at host "
+           << *remote.shardHostAndPort << " by also sending it to " << hedgeHost;
+
+    remote.hedgeCbHandle = callbackStatus.getValue();
+    remote.hedgeHostAndPort = std::move(hedgeHost);
+    remote.hedgeSentAt = Date_t::now();
+}
+
+void AsyncRequestsSender::_abandonCallback(executor::TaskExecutor::CallbackHandle* cbHandle) {
+    if (!cbHandle->isValid()) {
+        return;
+    }
+
+    _executor->cancel(*cbHandle);
+    *cbHandle = executor::TaskExecutor::CallbackHandle();
+    ++_numAbandonedCallbacks;
+}
+
 AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
     : shardId(shardId), cmdObj(cmdObj) {}
 
@@ -316,6 +510,20 @@ std::shared_ptr<Shard> AsyncRequestsSender::RemoteData::getShard() {
     return Grid::get(getGlobalServiceContext())->shardRegistry()->getShardNoReload(shardId);
 }
 
+std::shared_ptr<ReplicaSetMonitor> AsyncRequestsSender::RemoteData::getReplicaSetMonitor() {
+    const auto shard = getShard();
+    if (!shard) {
+        return nullptr;
+    }
+
+    const auto connStr = shard->getConnString();
+    if (connStr.type() != ConnectionString::SET) {
+        return nullptr;
+    }
+
+    return ReplicaSetMonitor::get(connStr.getSetName());
+}
+
 AsyncRequestsSender::BatonDetacher::BatonDetacher(OperationContext* opCtx)
     : _baton(AsyncRequestsSenderUseBaton.load()
                  ? (opCtx->getServiceContext()->getTransportLayer()
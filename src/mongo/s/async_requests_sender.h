@@ -46,6 +46,8 @@
 
 namespace mongo {
 
+class ReplicaSetMonitor;
+
 /**
  * The AsyncRequestsSender allows for sending requests to a set of remote shards in parallel.
  * Work on remote nodes is accomplished by scheduling remote work in a TaskExecutor's event loop.
@@ -77,6 +79,11 @@ namespace mongo {
  *     }
  * }
  *
+ * For read preferences which allow more than one member of a shard to serve a request, read
+ * commands which are not answered within a typical latency of the host they were sent to are
+ * hedged: a copy is sent to another eligible member of the shard, the first response is used and
+ * the other copy of the request is canceled.
+ *
  * Does not throw exceptions.
  */
 class AsyncRequestsSender {
@@ -151,6 +158,16 @@ public:
      */
     Response next();
 
+    /**
+     * Schedules additional requests, whose responses are returned by next() along with those of
+     * the requests the ARS was constructed with. Callers must not have more than one request
+     * outstanding to the same shard, because responses are only identified by their shard id.
+     *
+     * If the outstanding requests have already been canceled, the new requests are not sent and
+     * their responses are errors instead.
+     */
+    void addRequests(const std::vector<AsyncRequestsSender::Request>& requests);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -180,6 +197,12 @@ private:
          */
         std::shared_ptr<Shard> getShard();
 
+        /**
+         * Returns the ReplicaSetMonitor of this remote's shard, or nullptr if the shard is not a
+         * replica set.
+         */
+        std::shared_ptr<ReplicaSetMonitor> getReplicaSetMonitor();
+
         // ShardId of the shard to which the command will be sent.
         ShardId shardId;
 
@@ -200,6 +223,19 @@ private:
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // The host to which a hedged copy of the request was sent. Is unset unless the request was
+        // hedged and neither copy has responded yet.
+        boost::optional<HostAndPort> hedgeHostAndPort;
+
+        // The callback handles to the outstanding hedged copy of the request and to the timer
+        // which sends it once the hedging delay has elapsed.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+        executor::TaskExecutor::CallbackHandle hedgeTimerCbHandle;
+
+        // When the request and its hedged copy were sent, to record their latency.
+        Date_t sentAt;
+        Date_t hedgeSentAt;
+
         // Whether this remote's result has been returned.
         bool done = false;
     };
@@ -209,8 +245,17 @@ private:
      * off thread, and this wraps up the arguments for that call.
      */
     struct Job {
-        executor::TaskExecutor::RemoteCommandCallbackArgs cbData;
+        // The position of the remote in '_remotes'.
         size_t remoteIndex;
+
+        // The handle of the request or timer whose callback ran.
+        executor::TaskExecutor::CallbackHandle cbHandle;
+
+        // The response to the request. Is unset if the hedging timer of the remote fired.
+        boost::optional<executor::RemoteCommandResponse> response;
+
+        // The status the hedging timer fired with.
+        Status timerStatus = Status::OK();
     };
 
     /**
@@ -286,6 +331,31 @@ private:
      */
     void _makeProgress();
 
+    /**
+     * Returns whether the request to 'remote' may be hedged, which requires a read preference that
+     * is satisfied by more than one member and a command which leaves no state behind on the
+     * member whose response is discarded.
+     */
+    bool _isHedgeable(const RemoteData& remote) const;
+
+    /**
+     * Schedules the timer which hedges the request to the remote at 'remoteIndex' if it has not
+     * responded within the configured percentile of the recent latencies of its host.
+     */
+    void _scheduleHedgeTimer(size_t remoteIndex);
+
+    /**
+     * Sends a copy of the outstanding request to the remote at 'remoteIndex' to another member of
+     * its shard matching the read preference, if there is one.
+     */
+    void _scheduleHedgedRequest(size_t remoteIndex);
+
+    /**
+     * Cancels the request or timer behind 'cbHandle', if any, and resets the handle. Its callback
+     * will still run and is accounted for in _numAbandonedCallbacks.
+     */
+    void _abandonCallback(executor::TaskExecutor::CallbackHandle* cbHandle);
+
     OperationContext* _opCtx;
 
     executor::TaskExecutor* _executor;
@@ -323,6 +393,10 @@ private:
     // Used to determine if the ARS should attempt to retry any requests. Is set to true when
     // stopRetrying() or cancelPendingRequests() is called.
     bool _stopRetrying = false;
+
+    // Number of callbacks of canceled requests and timers which no longer belong to a remote,
+    // because the remote already has a response, but which have not run yet.
+    int _numAbandonedCallbacks = 0;
 };
 
 }  // namespace mongo
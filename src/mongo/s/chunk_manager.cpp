@@ -32,8 +32,11 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/index_bounds_builder.h"
@@ -49,6 +52,11 @@ namespace {
 // Used to generate sequence numbers to assign to each newly created RoutingTableHistory
 AtomicUInt32 nextCMSequenceNumber(0);
 
+// Segments of a ChunkMap are split in half once they grow past this many chunks. This bounds
+// both the number of chunks copied when a segment is modified and, for large collections, the
+// number of segments whose pointers are copied along with the map.
+const std::size_t kMaxChunkMapSegmentSize = 512;
+
 void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     for (auto&& element : o) {
         uassert(ErrorCodes::ConflictingOperationInProgress,
@@ -57,6 +65,31 @@ void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     }
 }
 
+/**
+ * Checks that two chunks which are adjacent in the routing table and owned by different shards
+ * neither overlap nor leave a gap between them.
+ */
+void checkAdjacentChunks(const ChunkInfo& prev, const ChunkInfo& next) {
+    if (prev.getShardIdAt(boost::none) == next.getShardIdAt(boost::none)) {
+        return;
+    }
+
+    uassert(ErrorCodes::ConflictingOperationInProgress,
+            str::stream() << "Metadata contains chunks with the same or out-of-order max value; "
+                             "expected "
+                          << prev.getMax()
+                          << " < "
+                          << next.getMax(),
+            SimpleBSONObjComparator::kInstance.evaluate(prev.getMax() < next.getMax()));
+    // Make sure there are no gaps in the ranges
+    uassert(ErrorCodes::ConflictingOperationInProgress,
+            str::stream() << "Gap or an overlap between ranges "
+                          << ChunkRange(next.getMin(), next.getMax()).toString()
+                          << " and "
+                          << prev.getMax(),
+            SimpleBSONObjComparator::kInstance.evaluate(prev.getMax() == next.getMin()));
+}
+
 std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering ordering) {
     BSONObjBuilder strippedKeyValue;
     for (const auto& elem : shardKeyValue) {
@@ -69,12 +102,239 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
 
 }  // namespace
 
+ChunkMap::const_iterator& ChunkMap::const_iterator::operator++() {
+    ++_it;
+    if (_it == (*_segments)[_segmentIdx]->chunks.end()) {
+        ++_segmentIdx;
+        _it = _segmentIdx < _segments->size() ? (*_segments)[_segmentIdx]->chunks.begin()
+                                              : ChunkInfoMap::const_iterator();
+    }
+    return *this;
+}
+
+ChunkMap::const_iterator& ChunkMap::const_iterator::operator--() {
+    if (_segmentIdx == _segments->size() || _it == (*_segments)[_segmentIdx]->chunks.begin()) {
+        --_segmentIdx;
+        _it = (*_segments)[_segmentIdx]->chunks.end();
+    }
+    --_it;
+    return *this;
+}
+
+ChunkMap::const_iterator ChunkMap::begin() const {
+    if (_segments.empty()) {
+        return end();
+    }
+    return const_iterator(&_segments, 0, _segments.front()->chunks.begin());
+}
+
+ChunkMap::const_iterator ChunkMap::end() const {
+    return const_iterator(&_segments, _segments.size(), ChunkInfoMap::const_iterator());
+}
+
+ChunkMap::const_iterator ChunkMap::upper_bound(const std::string& key) const {
+    const auto segmentIdx = _findSegment(key, false);
+    if (segmentIdx == _segments.size()) {
+        return end();
+    }
+
+    const auto& segment = *_segments[segmentIdx];
+    if (_indexed) {
+        const auto pos = std::upper_bound(segment.maxKeys.begin(), segment.maxKeys.end(), key);
+        return const_iterator(
+            &_segments, segmentIdx, segment.entries[std::distance(segment.maxKeys.begin(), pos)]);
+    }
+    return const_iterator(&_segments, segmentIdx, segment.chunks.upper_bound(key));
+}
+
+ChunkMap::const_iterator ChunkMap::lower_bound(const std::string& key) const {
+    const auto segmentIdx = _findSegment(key, true);
+    if (segmentIdx == _segments.size()) {
+        return end();
+    }
+
+    const auto& segment = *_segments[segmentIdx];
+    if (_indexed) {
+        const auto pos = std::lower_bound(segment.maxKeys.begin(), segment.maxKeys.end(), key);
+        return const_iterator(
+            &_segments, segmentIdx, segment.entries[std::distance(segment.maxKeys.begin(), pos)]);
+    }
+    return const_iterator(&_segments, segmentIdx, segment.chunks.lower_bound(key));
+}
+
+void ChunkMap::erase(const std::string& afterKey, const std::string& upToKey) {
+    auto segmentIdx = _findSegment(afterKey, false);
+    while (segmentIdx < _segments.size()) {
+        const auto& chunks = _segments[segmentIdx]->chunks;
+        if (chunks.begin()->first > upToKey) {
+            break;
+        }
+
+        // Avoid copying a shared segment unless it actually contains chunks to erase.
+        if (chunks.upper_bound(afterKey) == chunks.upper_bound(upToKey)) {
+            ++segmentIdx;
+            continue;
+        }
+
+        auto& segment = _mutableSegment(segmentIdx);
+        const auto low = segment.chunks.upper_bound(afterKey);
+        const auto high = segment.chunks.upper_bound(upToKey);
+        _size -= std::distance(low, high);
+        segment.chunks.erase(low, high);
+
+        if (segment.chunks.empty()) {
+            _segments.erase(_segments.begin() + segmentIdx);
+        } else {
+            ++segmentIdx;
+        }
+    }
+}
+
+void ChunkMap::insert(const std::string& maxKey, std::shared_ptr<ChunkInfo> chunk) {
+    _indexed = false;
+    if (_segments.empty()) {
+        auto segment = std::make_shared<Segment>();
+        segment->chunks.emplace(maxKey, std::move(chunk));
+        _segments.push_back(std::move(segment));
+        _size = 1;
+        return;
+    }
+
+    // Keys past the end of the last segment are appended to it.
+    const auto segmentIdx = std::min(_findSegment(maxKey, true), _segments.size() - 1);
+    auto& segment = _mutableSegment(segmentIdx);
+    if (!segment.chunks.emplace(maxKey, std::move(chunk)).second) {
+        return;
+    }
+    ++_size;
+
+    if (segment.chunks.size() > kMaxChunkMapSegmentSize) {
+        auto upperHalf = std::make_shared<Segment>();
+        auto middle = segment.chunks.begin();
+        std::advance(middle, segment.chunks.size() / 2);
+        upperHalf->chunks.insert(middle, segment.chunks.end());
+        segment.chunks.erase(middle, segment.chunks.end());
+        _segments.insert(_segments.begin() + segmentIdx + 1, std::move(upperHalf));
+    }
+}
+
+ShardVersionMap ChunkMap::constructShardVersionMap(const OID& epoch) {
+    ShardVersionMap shardVersions;
+
+    for (std::size_t segmentIdx = 0; segmentIdx < _segments.size(); ++segmentIdx) {
+        const auto& segment = _segments[segmentIdx];
+
+        // The boundaries between segments are checked on every call, since erasing a segment can
+        // make two unmodified segments adjacent.
+        if (segmentIdx > 0) {
+            checkAdjacentChunks(*_segments[segmentIdx - 1]->chunks.rbegin()->second,
+                                *segment->chunks.begin()->second);
+        }
+
+        if (segment->needsRefresh) {
+            // Segments which need a refresh were copied or created by this map, so they are not
+            // shared with any other map yet.
+            invariant(segment.use_count() == 1);
+            segment->shardVersions.clear();
+
+            const ChunkInfo* prev = nullptr;
+            for (const auto& entry : segment->chunks) {
+                const auto& chunk = *entry.second;
+                if (prev) {
+                    checkAdjacentChunks(*prev, chunk);
+                }
+                prev = &chunk;
+
+                auto& maxShardVersion =
+                    segment->shardVersions
+                        .emplace(chunk.getShardIdAt(boost::none), ChunkVersion(0, 0, epoch))
+                        .first->second;
+                if (chunk.getLastmod() > maxShardVersion) {
+                    maxShardVersion = chunk.getLastmod();
+                }
+            }
+
+            segment->maxKeys.clear();
+            segment->entries.clear();
+            segment->maxKeys.reserve(segment->chunks.size());
+            segment->entries.reserve(segment->chunks.size());
+            for (auto it = segment->chunks.cbegin(); it != segment->chunks.cend(); ++it) {
+                segment->maxKeys.push_back(it->first);
+                segment->entries.push_back(it);
+            }
+
+            segment->needsRefresh = false;
+        }
+
+        for (const auto& entry : segment->shardVersions) {
+            auto& maxShardVersion =
+                shardVersions.emplace(entry.first, ChunkVersion(0, 0, epoch)).first->second;
+            if (entry.second > maxShardVersion) {
+                maxShardVersion = entry.second;
+            }
+        }
+    }
+
+    if (!empty()) {
+        invariant(!shardVersions.empty());
+
+        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
+        // somewhere, which should have been caught at chunk load time
+        for (const auto& entry : shardVersions) {
+            invariant(entry.second.isSet());
+        }
+
+        checkAllElementsAreOfType(MinKey, begin()->second->getMin());
+        checkAllElementsAreOfType(MaxKey, std::prev(end())->second->getMax());
+    }
+
+    _segmentMaxKeys.clear();
+    _segmentMaxKeys.reserve(_segments.size());
+    for (const auto& segment : _segments) {
+        _segmentMaxKeys.push_back(segment->maxKeys.back());
+    }
+    _indexed = true;
+
+    return shardVersions;
+}
+
+std::size_t ChunkMap::_findSegment(const std::string& key, bool inclusive) const {
+    if (_indexed) {
+        const auto it = inclusive
+            ? std::lower_bound(_segmentMaxKeys.begin(), _segmentMaxKeys.end(), key)
+            : std::upper_bound(_segmentMaxKeys.begin(), _segmentMaxKeys.end(), key);
+        return std::distance(_segmentMaxKeys.begin(), it);
+    }
+
+    const auto it = std::partition_point(
+        _segments.begin(), _segments.end(), [&](const std::shared_ptr<Segment>& segment) {
+            const auto& lastKey = segment->chunks.rbegin()->first;
+            return inclusive ? lastKey < key : lastKey <= key;
+        });
+    return std::distance(_segments.begin(), it);
+}
+
+ChunkMap::Segment& ChunkMap::_mutableSegment(std::size_t segmentIdx) {
+    _indexed = false;
+    auto& segment = _segments[segmentIdx];
+    if (segment.use_count() > 1) {
+        // Copies the entries, but not the ChunkInfo objects they point to. The lookup arrays
+        // refer to the original entries, so they are rebuilt by the next refresh instead.
+        auto copy = std::make_shared<Segment>();
+        copy->chunks = segment->chunks;
+        segment = std::move(copy);
+    }
+    segment->needsRefresh = true;
+    return *segment;
+}
+
 RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          boost::optional<UUID> uuid,
                                          KeyPattern shardKeyPattern,
                                          std::unique_ptr<CollatorInterface> defaultCollator,
                                          bool unique,
-                                         ChunkInfoMap chunkMap,
+                                         ChunkMap chunkMap,
+                                         ShardVersionMap shardVersions,
                                          ChunkVersion collectionVersion)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
@@ -84,8 +344,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _defaultCollator(std::move(defaultCollator)),
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
-      _shardVersions(
-          _constructShardVersionMap(collectionVersion.epoch(), _chunkMap, _shardKeyOrdering)),
+      _shardVersions(std::move(shardVersions)),
       _collectionVersion(collectionVersion) {}
 
 Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
@@ -121,6 +380,24 @@ bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& sha
     return it->second->getShardIdAt(_clusterTime) == shardId;
 }
 
+bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey,
+                                     const ShardId& shardId,
+                                     boost::optional<ChunkRange>* chunkRange) const {
+    chunkRange->reset();
+
+    if (shardKey.isEmpty())
+        return false;
+
+    const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    if (it == _rt->getChunkMap().end())
+        return false;
+
+    invariant(it->second->containsKey(shardKey));
+
+    chunkRange->emplace(it->second->getMin(), it->second->getMax());
+    return it->second->getShardIdAt(_clusterTime) == shardId;
+}
+
 void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
                                        const BSONObj& query,
                                        const BSONObj& collation,
@@ -154,6 +431,19 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
         }
     }
 
+    // A query which has no predicates on the shard key fields covers the whole shard key space,
+    // whatever its constants are, so there is no need to plan it in order to derive its bounds.
+    std::set<std::string> shardKeyPaths;
+    for (const auto& keyField : _rt->getShardKeyPattern().getKeyPatternFields()) {
+        shardKeyPaths.insert(keyField->dottedField().toString());
+    }
+
+    if (expression::isIndependentOf(*cq->root(), shardKeyPaths)) {
+        const auto& keyPattern = _rt->getShardKeyPattern().getKeyPattern();
+        getShardIdsForRange(keyPattern.globalMin(), keyPattern.globalMax(), shardIds);
+        return;
+    }
+
     // Transforms query into bounds for each field in the shard key
     // for example :
     //   Key { a: 1, b: 1 },
@@ -233,7 +523,7 @@ void RoutingTableHistory::getAllShardIds(std::set<ShardId>* all) const {
                    [](const ShardVersionMap::value_type& pair) { return pair.first; });
 }
 
-std::pair<ChunkInfoMap::const_iterator, ChunkInfoMap::const_iterator>
+std::pair<ChunkMap::const_iterator, ChunkMap::const_iterator>
 RoutingTableHistory::overlappingRanges(const BSONObj& min,
                                        const BSONObj& max,
                                        bool isMaxInclusive) const {
@@ -403,90 +693,6 @@ std::string RoutingTableHistory::toString() const {
     return sb.str();
 }
 
-ShardVersionMap RoutingTableHistory::_constructShardVersionMap(const OID& epoch,
-                                                               const ChunkInfoMap& chunkMap,
-                                                               Ordering shardKeyOrdering) {
-    ShardVersionMap shardVersions;
-    ChunkInfoMap::const_iterator current = chunkMap.cbegin();
-
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
-
-    while (current != chunkMap.cend()) {
-        const auto& firstChunkInRange = current->second;
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(firstChunkInRange->getShardIdAt(boost::none));
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt = shardVersions
-                                 .emplace(firstChunkInRange->getShardIdAt(boost::none),
-                                          ChunkVersion(0, 0, epoch))
-                                 .first;
-        }
-
-        auto& maxShardVersion = shardVersionIt->second;
-
-        current = std::find_if(
-            current,
-            chunkMap.cend(),
-            [&firstChunkInRange, &maxShardVersion](const ChunkInfoMap::value_type& chunkMapEntry) {
-                const auto& currentChunk = chunkMapEntry.second;
-
-                if (currentChunk->getShardIdAt(boost::none) !=
-                    firstChunkInRange->getShardIdAt(boost::none))
-                    return true;
-
-                if (currentChunk->getLastmod() > maxShardVersion)
-                    maxShardVersion = currentChunk->getLastmod();
-
-                return false;
-            });
-
-        const auto rangeLast = std::prev(current);
-
-        const BSONObj rangeMin = firstChunkInRange->getMin();
-        const BSONObj rangeMax = rangeLast->second->getMax();
-
-        if (lastMax) {
-            uassert(ErrorCodes::ConflictingOperationInProgress,
-                    str::stream()
-                        << "Metadata contains chunks with the same or out-of-order max value; "
-                           "expected "
-                        << lastMax.get()
-                        << " < "
-                        << rangeMax,
-                    SimpleBSONObjComparator::kInstance.evaluate(lastMax.get() < rangeMax));
-            // Make sure there are no gaps in the ranges
-            uassert(ErrorCodes::ConflictingOperationInProgress,
-                    str::stream() << "Gap or an overlap between ranges "
-                                  << ChunkRange(rangeMin, rangeMax).toString()
-                                  << " and "
-                                  << lastMax.get(),
-                    SimpleBSONObjComparator::kInstance.evaluate(lastMax.get() == rangeMin));
-        }
-
-        if (!firstMin)
-            firstMin = rangeMin;
-
-        lastMax = rangeMax;
-
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
-    }
-
-    if (!chunkMap.empty()) {
-        invariant(!shardVersions.empty());
-        invariant(firstMin.is_initialized());
-        invariant(lastMax.is_initialized());
-
-        checkAllElementsAreOfType(MinKey, firstMin.get());
-        checkAllElementsAreOfType(MaxKey, lastMax.get());
-    }
-
-    return shardVersions;
-}
-
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
@@ -505,6 +711,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeNew(
                                std::move(defaultCollator),
                                std::move(unique),
                                {},
+                               {},
                                {0, 0, epoch})
         .makeUpdated(chunks);
 }
@@ -563,10 +770,10 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         }
 
         // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+        chunkMap.erase(chunkMinKeyString, chunkMaxKeyString);
 
         // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
+        chunkMap.insert(chunkMaxKeyString, std::move(newChunk));
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -580,6 +787,8 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    auto shardVersions = chunkMap.constructShardVersionMap(collectionVersion.epoch());
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
@@ -587,6 +796,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
                                 CollatorInterface::cloneCollator(getDefaultCollator()),
                                 isUnique(),
                                 std::move(chunkMap),
+                                std::move(shardVersions),
                                 collectionVersion));
 }
 
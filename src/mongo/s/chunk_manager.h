@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -55,6 +57,153 @@ using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
+/**
+ * Ordered map from the max key string of each chunk to an entry describing the chunk.
+ *
+ * The chunks are kept in a sequence of segments of bounded size, which are shared between copies
+ * of the map. Modifying a copy only copies the segments it touches, so applying an incremental
+ * refresh to a routing table with many chunks allocates in proportion to the number of changed
+ * chunks rather than to the total. Each segment caches the shard versions of its own chunks, so
+ * that the shard version map can also be rebuilt without visiting the unchanged chunks.
+ */
+class ChunkMap {
+    struct Segment {
+        ChunkInfoMap chunks;
+
+        // Max chunk version per shard among 'chunks'. Only valid if 'needsRefresh' is false.
+        ShardVersionMap shardVersions;
+
+        // The keys of 'chunks' in order, and iterators to the corresponding entries. Binary
+        // searching these touches far fewer cache lines than walking the tree. Only valid if
+        // 'needsRefresh' is false.
+        std::vector<std::string> maxKeys;
+        std::vector<ChunkInfoMap::const_iterator> entries;
+
+        // Set on segments which were modified since the last call to constructShardVersionMap.
+        bool needsRefresh = true;
+    };
+
+    using SegmentVector = std::vector<std::shared_ptr<Segment>>;
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return *_it;
+        }
+        pointer operator->() const {
+            return &*_it;
+        }
+
+        const_iterator& operator++();
+        const_iterator& operator--();
+
+        const_iterator operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+        const_iterator operator--(int) {
+            auto old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _segmentIdx == other._segmentIdx &&
+                (!_segments || _segmentIdx == _segments->size() || _it == other._it);
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkMap;
+
+        const_iterator(const SegmentVector* segments,
+                       std::size_t segmentIdx,
+                       ChunkInfoMap::const_iterator it)
+            : _segments(segments), _segmentIdx(segmentIdx), _it(it) {}
+
+        const SegmentVector* _segments = nullptr;
+
+        // Index of the segment '_it' points into, or the number of segments for end().
+        std::size_t _segmentIdx = 0;
+        ChunkInfoMap::const_iterator _it;
+    };
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    /**
+     * Same as the std::map methods of the same name.
+     */
+    const_iterator upper_bound(const std::string& key) const;
+    const_iterator lower_bound(const std::string& key) const;
+
+    std::size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Erases the chunks with a max key string greater than 'afterKey' and less than or equal to
+     * 'upToKey'.
+     */
+    void erase(const std::string& afterKey, const std::string& upToKey);
+
+    /**
+     * Inserts 'chunk' under 'maxKey', unless there is already a chunk with that key.
+     */
+    void insert(const std::string& maxKey, std::shared_ptr<ChunkInfo> chunk);
+
+    /**
+     * Returns the max chunk version per shard and checks that the chunks cover the whole key
+     * space without gaps or overlaps. Only segments modified since the previous call are visited
+     * chunk by chunk. Throws ConflictingOperationInProgress if the chunks are inconsistent.
+     *
+     * Also builds the flat lookup arrays used by upper_bound and lower_bound until the map is
+     * modified again.
+     */
+    ShardVersionMap constructShardVersionMap(const OID& epoch);
+
+private:
+    /**
+     * Returns the index of the first segment whose last key is greater than 'key' (or greater or
+     * equal if 'inclusive' is true), or the number of segments if there is none.
+     */
+    std::size_t _findSegment(const std::string& key, bool inclusive) const;
+
+    /**
+     * Returns the segment at 'segmentIdx', first copying it if it is shared with another map.
+     */
+    Segment& _mutableSegment(std::size_t segmentIdx);
+
+    SegmentVector _segments;
+    std::size_t _size = 0;
+
+    // The last key of each segment, in order. Only valid if '_indexed' is true.
+    std::vector<std::string> _segmentMaxKeys;
+    bool _indexed = false;
+};
+
 /**
  * In-memory representation of the routing table for a single sharded collection at various points
  * in time.
@@ -121,7 +270,7 @@ public:
 
     ChunkVersion getVersion(const ShardId& shardId) const;
 
-    const ChunkInfoMap& getChunkMap() const {
+    const ChunkMap& getChunkMap() const {
         return _chunkMap;
     }
 
@@ -145,24 +294,18 @@ public:
         return _uuid;
     }
 
-    std::pair<ChunkInfoMap::const_iterator, ChunkInfoMap::const_iterator> overlappingRanges(
+    std::pair<ChunkMap::const_iterator, ChunkMap::const_iterator> overlappingRanges(
         const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
 
 
 private:
-    /**
-     * Does a single pass over the chunkMap and constructs the ShardVersionMap object.
-     */
-    static ShardVersionMap _constructShardVersionMap(const OID& epoch,
-                                                     const ChunkInfoMap& chunkMap,
-                                                     Ordering shardKeyOrdering);
-
     RoutingTableHistory(NamespaceString nss,
                         boost::optional<UUID> uuid,
                         KeyPattern shardKeyPattern,
                         std::unique_ptr<CollatorInterface> defaultCollator,
                         bool unique,
-                        ChunkInfoMap chunkMap,
+                        ChunkMap chunkMap,
+                        ShardVersionMap shardVersions,
                         ChunkVersion collectionVersion);
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
@@ -190,7 +333,7 @@ private:
 
     // Map from the max for each chunk to an entry describing the chunk. The union of all chunks'
     // ranges must cover the complete space from [MinKey, MaxKey).
-    const ChunkInfoMap _chunkMap;
+    const ChunkMap _chunkMap;
 
     // Map from shard id to the maximum chunk version for that shard. If a shard contains no
     // chunks, it won't be present in this map.
@@ -211,7 +354,7 @@ public:
     class ConstChunkIterator {
     public:
         ConstChunkIterator() = default;
-        explicit ConstChunkIterator(ChunkInfoMap::const_iterator iter,
+        explicit ConstChunkIterator(ChunkMap::const_iterator iter,
                                     const boost::optional<Timestamp>& clusterTime)
             : _iter{iter} {}
 
@@ -233,7 +376,7 @@ public:
         }
 
     private:
-        ChunkInfoMap::const_iterator _iter;
+        ChunkMap::const_iterator _iter;
         const boost::optional<Timestamp> _clusterTime;
     };
 
@@ -304,6 +447,14 @@ public:
      */
     bool keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const;
 
+    /**
+     * Same as above, but also returns in "chunkRange" the bounds of the chunk which contains
+     * "shardKey", if there is one. The answer is the same for every key within these bounds.
+     */
+    bool keyBelongsToShard(const BSONObj& shardKey,
+                           const ShardId& shardId,
+                           boost::optional<ChunkRange>* chunkRange) const;
+
     /**
      * Returns true if any chunk owned by the shard with the given "shardId" overlaps "range".
      */
@@ -401,6 +401,35 @@ TEST_F(CMCollapseTreeTest, HashedRegex) {
     checkIndexBoundsWithKey("{a: 'hashed'}", "{ a: /abc/ }", expectedBounds);
 }
 
+// { a: 0, b: { $gte: 2, $lt: 5 } } -> hashed a: [hash(0), hash(0)], b: [2, 5)
+TEST_F(CMCollapseTreeTest, CompoundHashedPrefixPointAndRange) {
+    auto query(canonicalize("{a: 0, b: {$gte: 2, $lt: 5}}"));
+    BSONObj key = fromjson("{a: 'hashed', b: 1}");
+
+    IndexBounds indexBounds = ChunkManager::getIndexBoundsForQuery(key, *query.get());
+    ASSERT_EQUALS(indexBounds.size(), 2U);
+    ASSERT_EQUALS(indexBounds.fields[0].intervals.size(), 1U);
+    ASSERT(indexBounds.fields[0].intervals.front().isPoint());
+    ASSERT_EQUALS(indexBounds.fields[1].intervals.size(), 1U);
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  indexBounds.fields[1].intervals.front().compare(
+                      Interval(BSON("" << 2 << "" << 5), true, false)));
+}
+
+// { a: { $gte: 2, $lt: 5 } } -> a: [2, 5), hashed b: [MinKey, MaxKey]
+TEST_F(CMCollapseTreeTest, CompoundHashedSuffixRangeOnPrefix) {
+    IndexBounds expectedBounds;
+    expectedBounds.fields.push_back(OrderedIntervalList());
+    expectedBounds.fields.push_back(OrderedIntervalList());
+    expectedBounds.fields[0].intervals.push_back(Interval(BSON("" << 2 << "" << 5), true, false));
+    BSONObjBuilder builder;
+    builder.appendMinKey("");
+    builder.appendMaxKey("");
+    expectedBounds.fields[1].intervals.push_back(Interval(builder.obj(), true, true));
+
+    checkIndexBoundsWithKey("{a: 1, b: 'hashed'}", "{a: {$gte: 2, $lt: 5}}", expectedBounds);
+}
+
 /**
  * Tests the KeyPattern key bounds generation logic.
  */
@@ -154,6 +154,39 @@ TEST_F(ChunkManagerQueryTest, UniversalRangeMultiShard) {
                  {ShardId("0"), ShardId("1"), ShardId("2"), ShardId("3")});
 }
 
+TEST_F(ChunkManagerQueryTest, NonShardKeyPredicatesMultiShard) {
+    runQueryTest(BSON("a" << 1),
+                 nullptr,
+                 false,
+                 {BSON("a"
+                       << "x"),
+                  BSON("a"
+                       << "y"),
+                  BSON("a"
+                       << "z")},
+                 BSON("b" << 5 << "$or" << BSON_ARRAY(BSON("c" << 1) << BSON("d.a" << 2))),
+                 BSONObj(),
+                 {ShardId("0"), ShardId("1"), ShardId("2"), ShardId("3")});
+}
+
+TEST_F(ChunkManagerQueryTest, NonShardKeyPredicatesAndEqualitySingleShard) {
+    runQueryTest(BSON("a" << 1),
+                 nullptr,
+                 false,
+                 {BSON("a"
+                       << "x"),
+                  BSON("a"
+                       << "y"),
+                  BSON("a"
+                       << "z")},
+                 BSON("b" << 5 << "$or" << BSON_ARRAY(BSON("a"
+                                                            << "y")
+                                                       << BSON("a"
+                                                               << "yy"))),
+                 BSONObj(),
+                 {ShardId("2")});
+}
+
 TEST_F(ChunkManagerQueryTest, EqualityRangeSingleShard) {
     runQueryTest(BSON("a" << 1),
                  nullptr,
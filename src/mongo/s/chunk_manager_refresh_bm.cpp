@@ -120,7 +120,43 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
     }
 }
 
-BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
+BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 500000});
+
+/**
+ * Measures the cost of an incremental refresh as a function of the number of chunks it changes.
+ * The changed chunks are spread evenly over the key space and moved to another shard.
+ */
+void BM_IncrementalRefreshOfChangedChunks(benchmark::State& state) {
+    const int nShards = 2;
+    const int nChunks = state.range(0);
+    const int nChangedChunks = state.range(1);
+    auto cm = makeChunkManagerWithOptimalBalancedDistribution(nShards, nChunks);
+
+    auto postMoveVersion = cm->getChunkManager()->getVersion();
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+    std::vector<ChunkType> newChunks;
+    for (int i = 0; i < nChangedChunks; ++i) {
+        const int chunkNum = int64_t(i) * nChunks / nChangedChunks;
+        postMoveVersion.incMajor();
+        newChunks.emplace_back(collName,
+                               getRangeForChunk(chunkNum, nChunks),
+                               postMoveVersion,
+                               ShardId(str::stream() << "shard" << (i % nShards)));
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(*cm, newChunks));
+    }
+}
+
+BENCHMARK(BM_IncrementalRefreshOfChangedChunks)
+    ->Args({500000, 1})
+    ->Args({500000, 10})
+    ->Args({500000, 100})
+    ->Args({500000, 1000})
+    ->Args({500000, 10000});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
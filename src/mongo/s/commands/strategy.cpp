@@ -80,6 +80,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
@@ -350,6 +351,7 @@ void runCommand(OperationContext* opCtx,
     opCtx->checkForInterrupt();  // May trigger maxTimeAlwaysTimeOut fail point.
 
     auto invocation = command->parse(opCtx, request);
+    SamplingProfilerTagScope cpuProfilerTag(command->getName(), invocation->ns().ns());
 
     // Set the logical optype, command object and namespace as soon as we identify the command. If
     // the command does not define a fully-qualified namespace, set CurOp to the generic command
@@ -38,6 +38,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -45,6 +46,17 @@
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAsyncResultsMergerReadAheadThreshold, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryAsyncResultsMergerReadAheadThreshold must be >= 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAsyncResultsMergerSendSortKeyBound, bool, true);
+
 constexpr StringData AsyncResultsMerger::kSortKeyField;
 const BSONObj AsyncResultsMerger::kWholeSortKeySortPattern = BSON(kSortKeyField << 1);
 
@@ -90,9 +102,9 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(_remotes,
-                                    _params.getSort() ? *_params.getSort() : BSONObj(),
-                                    _params.getCompareWholeSortKey())) {
+      _mergeQueue(
+          MergingComparator(_remotes, _params.getSort() ? *_params.getSort() : BSONObj())),
+      _firstSortKeys(SortKeyComparator(_params.getSort() ? *_params.getSort() : BSONObj())) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
     }
@@ -223,10 +235,7 @@ bool AsyncResultsMerger::_readySortedTailable(WithLock) {
         return false;
     }
 
-    auto smallestRemote = _mergeQueue.top();
-    auto smallestResult = _remotes[smallestRemote].docBuffer.front();
-    auto keyWeWantToReturn =
-        extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
+    const auto& keyWeWantToReturn = _remotes[_mergeQueue.top()].frontSortKey;
     for (const auto& remote : _remotes) {
         if (!remote.promisedMinSortKey) {
             // In order to merge sorted tailable cursors, we need this value to be populated.
@@ -276,7 +285,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -296,13 +305,14 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
     if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+        _pushToMergeQueue(lk, smallestRemote);
     }
 
+    _readAheadIfNeeded(lk, smallestRemote);
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
@@ -320,6 +330,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            _readAheadIfNeeded(lk, _gettingFromRemote);
             return front;
         }
 
@@ -333,7 +344,43 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
-Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
+void AsyncResultsMerger::_pushToMergeQueue(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    invariant(remote.hasNext());
+    remote.frontSortKey =
+        extractSortKey(*remote.docBuffer.front().getResult(), _params.getCompareWholeSortKey());
+    _mergeQueue.push(remoteIndex);
+}
+
+void AsyncResultsMerger::_readAheadIfNeeded(WithLock lk, size_t remoteIndex) {
+    // Tailable cursors pass batches through to the client as they arrive, so only normal cursors
+    // fetch ahead. A getMore sent on behalf of a transaction could outlive the client operation
+    // and race with its commit, so those do not read ahead either. An empty buffer is left to
+    // nextEvent(), which schedules the getMore as usual.
+    const auto threshold = internalQueryAsyncResultsMergerReadAheadThreshold.load();
+    auto& remote = _remotes[remoteIndex];
+    if (threshold <= 0 || _tailableMode != TailableModeEnum::kNormal || _params.getTxnNumber() ||
+        !_opCtx || _lifecycleState != kAlive || !remote.status.isOK() || !remote.hasNext() ||
+        remote.exhausted() || remote.cbHandle.isValid() ||
+        remote.docBuffer.size() > static_cast<size_t>(threshold)) {
+        return;
+    }
+
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
+boost::optional<BSONObj> AsyncResultsMerger::_sortKeyBound(WithLock) const {
+    if (!_params.getSort() || !_params.getLimit() || _tailableMode != TailableModeEnum::kNormal ||
+        !internalQueryAsyncResultsMergerSendSortKeyBound.load() ||
+        _firstSortKeys.size() < static_cast<size_t>(*_params.getLimit())) {
+        return boost::none;
+    }
+
+    return GetMoreRequest::makeSortKeyBound(
+        _firstSortKeys.top(), *_params.getSort(), _params.getCompareWholeSortKey());
+}
+
+Status AsyncResultsMerger::_askForNextBatch(WithLock lk, size_t remoteIndex) {
     invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
     auto& remote = _remotes[remoteIndex];
 
@@ -348,13 +395,14 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
         adjustedBatchSize = *_params.getBatchSize() - remote.fetchedCount;
     }
 
-    BSONObj cmdObj = GetMoreRequest(remote.cursorNss,
-                                    remote.cursorId,
-                                    adjustedBatchSize,
-                                    _awaitDataTimeout,
-                                    boost::none,
-                                    boost::none)
-                         .toBSON();
+    GetMoreRequest getMoreRequest(remote.cursorNss,
+                                  remote.cursorId,
+                                  adjustedBatchSize,
+                                  _awaitDataTimeout,
+                                  boost::none,
+                                  boost::none);
+    getMoreRequest.sortKeyBound = _sortKeyBound(lk);
+    BSONObj cmdObj = getMoreRequest.toBSON();
 
     if (_params.getSessionId()) {
         BSONObjBuilder newCmdBob(std::move(cmdObj));
@@ -570,9 +618,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
     if (_params.getAllowPartialResults()) {
         remote.status = Status::OK();
 
-        // Clear the results buffer and cursor id.
-        std::queue<ClusterQueryResult> emptyBuffer;
-        std::swap(remote.docBuffer, emptyBuffer);
+        // Clear the cursor id. Any results buffered before a read-ahead request failed are still
+        // returned; the remote is exhausted once they have been consumed.
         remote.cursorId = 0;
     }
 }
@@ -623,6 +670,8 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            size_t remoteIndex,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
+    // A remote with buffered results is already on the merge queue if this batch was read ahead.
+    const bool wasEmpty = !remote.hasNext();
     updateRemoteMetadata(&remote, response);
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
@@ -643,6 +692,10 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                          << obj);
                 return false;
             }
+
+            if (_params.getLimit() && *_params.getLimit() > 0) {
+                _recordSortKey(lk, obj);
+            }
         }
 
         ClusterQueryResult result(obj);
@@ -652,12 +705,24 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+    if (_params.getSort() && wasEmpty && remote.hasNext()) {
+        _pushToMergeQueue(lk, remoteIndex);
     }
     return true;
 }
 
+void AsyncResultsMerger::_recordSortKey(WithLock, const BSONObj& obj) {
+    const auto limit = static_cast<size_t>(*_params.getLimit());
+    auto sortKey = extractSortKey(obj, _params.getCompareWholeSortKey());
+    if (_firstSortKeys.size() == limit) {
+        if (compareSortKeys(sortKey, _firstSortKeys.top(), *_params.getSort()) >= 0) {
+            return;
+        }
+        _firstSortKeys.pop();
+    }
+    _firstSortKeys.push(sortKey.getOwned());
+}
+
 void AsyncResultsMerger::_signalCurrentEventIfReady(WithLock lk) {
     if (_ready(lk) && _currentEvent.isValid()) {
         // To prevent ourselves from signalling the event twice, we set '_currentEvent' as
@@ -764,13 +829,13 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 // AsyncResultsMerger::MergingComparator
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
+bool AsyncResultsMerger::SortKeyComparator::operator()(const BSONObj& lhs,
+                                                       const BSONObj& rhs) const {
+    return compareSortKeys(lhs, rhs, _sort) < 0;
+}
 
-    return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
-                           extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    return compareSortKeys(_remotes[lhs].frontSortKey, _remotes[rhs].frontSortKey, _sort) > 0;
 }
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
 #include "mongo/stdx/mutex.h"
@@ -48,6 +49,16 @@ namespace mongo {
 
 class CursorResponse;
 
+// When greater than zero, a normal (non-tailable) AsyncResultsMerger issues the next getMore to a
+// remote as soon as the number of results buffered for it drops to this many, rather than waiting
+// for the buffer to run dry. Zero disables read-ahead.
+extern AtomicInt32 internalQueryAsyncResultsMergerReadAheadThreshold;
+
+// When true, an AsyncResultsMerger which only needs a limited number of sorted results tells the
+// remotes in its getMores which results sort too late to be needed. Shards of earlier versions
+// reject the field, so this is turned off while they remain in the cluster.
+extern AtomicBool internalQueryAsyncResultsMergerSendSortKeyBound;
+
 /**
  * Given a set of cursorIds across one or more shards, the AsyncResultsMerger calls getMore on the
  * cursors to present a single sorted or unsorted stream of documents.
@@ -283,6 +294,10 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // Used when merging in sorted order. Holds the sort key of the front of 'docBuffer' while
+        // this remote is on the merge queue, so that heap comparisons need not re-extract it.
+        BSONObj frontSortKey;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -297,26 +312,50 @@ private:
 
     class MergingComparator {
     public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes,
-                          const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+        MergingComparator(const std::vector<RemoteCursorData>& remotes, const BSONObj& sort)
+            : _remotes(remotes), _sort(sort) {}
 
+        /**
+         * Compares the cached sort keys of the first buffered results of two remotes.
+         */
         bool operator()(const size_t& lhs, const size_t& rhs);
 
     private:
         const std::vector<RemoteCursorData>& _remotes;
 
+        // When $sortKey is a scalar value rather than an object, the cached sort key has the form
+        // {$sortKey: <value>} and this pattern is verified to be {$sortKey: 1}.
         const BSONObj _sort;
+    };
 
-        // When '_compareWholeSortKey' is true, $sortKey is a scalar value, rather than an object.
-        // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
-        // be {$sortKey: 1}.
-        const bool _compareWholeSortKey;
+    class SortKeyComparator {
+    public:
+        explicit SortKeyComparator(const BSONObj& sort) : _sort(sort) {}
+
+        /**
+         * Returns whether the sort key 'lhs' sorts before 'rhs'.
+         */
+        bool operator()(const BSONObj& lhs, const BSONObj& rhs) const;
+
+    private:
+        const BSONObj _sort;
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
 
+    /**
+     * Returns the bound to send with a getMore when merging in sorted order with a limit, once
+     * 'limit' results have been received: no result which sorts after the last of them will be
+     * returned.
+     */
+    boost::optional<BSONObj> _sortKeyBound(WithLock) const;
+
+    /**
+     * Adds the sort key of 'obj', a result received while merging in sorted order with a limit, to
+     * the sort keys of the first results.
+     */
+    void _recordSortKey(WithLock, const BSONObj& obj);
+
     /**
      * Parses the find or getMore command response object to a CursorResponse.
      *
@@ -356,6 +395,18 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
+    /**
+     * Caches the sort key of the first buffered result of the remote at 'remoteIndex' and adds the
+     * remote to the merge queue. The remote must have at least one buffered result.
+     */
+    void _pushToMergeQueue(WithLock, size_t remoteIndex);
+
+    /**
+     * Schedules the next getMore for the remote at 'remoteIndex' ahead of its buffer running out,
+     * if read-ahead is enabled and the number of buffered results has dropped to the threshold.
+     */
+    void _readAheadIfNeeded(WithLock, size_t remoteIndex);
+
     using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
     using CbResponse = executor::TaskExecutor::ResponseStatus;
 
@@ -434,6 +485,10 @@ private:
     // next document to return, according to the sort order. Used only if there is a sort.
     std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
 
+    // The sort keys of the first results received from all remotes, up to the limit, with the one
+    // which sorts last on top. Used only if there is a sort and a limit.
+    std::priority_queue<BSONObj, std::vector<BSONObj>, SortKeyComparator> _firstSortKeys;
+
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
@@ -44,6 +44,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_out.h"
+#include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/mongos_process_interface.h"
@@ -287,12 +288,70 @@ BSONObj createCommandForMergingShard(const AggregationRequest& request,
     return appendAllowImplicitCreate(aggCmd, true);
 }
 
+/**
+ * If the shards part of 'splitPipeline' begins with $sample, returns the command to send to each
+ * shard targeted by 'shardQuery', with the sample size apportioned by the number of records on
+ * that shard. Returns an empty map if the pipeline does not begin with $sample or if the shards
+ * could not be counted, in which case every shard is sent 'cmdObj' and samples the whole size.
+ */
+std::map<ShardId, BSONObj> apportionSampleAcrossShards(
+    OperationContext* opCtx,
+    const NamespaceString& nss,
+    const CachedCollectionRoutingInfo& routingInfo,
+    const SplitPipeline& splitPipeline,
+    const BSONObj& cmdObj,
+    const BSONObj& shardQuery,
+    const BSONObj& collation) {
+    const auto& shardSources = splitPipeline.shardsPipeline->getSources();
+    if (shardSources.empty()) {
+        return {};
+    }
+    auto sampleStage = dynamic_cast<DocumentSourceSample*>(shardSources.front().get());
+    if (!sampleStage) {
+        return {};
+    }
+
+    auto responses =
+        scatterGatherVersionedTargetByRoutingTable(opCtx,
+                                                   nss.db(),
+                                                   nss,
+                                                   routingInfo,
+                                                   BSON("count" << nss.coll()),
+                                                   ReadPreferenceSetting::get(opCtx),
+                                                   Shard::RetryPolicy::kIdempotent,
+                                                   shardQuery,
+                                                   collation);
+    std::map<ShardId, long long> numRecordsPerShard;
+    for (auto&& response : responses) {
+        if (!response.swResponse.isOK() ||
+            !getStatusFromCommandResult(response.swResponse.getValue().data).isOK()) {
+            return {};
+        }
+        numRecordsPerShard[response.shardId] =
+            response.swResponse.getValue().data["n"].safeNumberLong();
+    }
+
+    std::map<ShardId, BSONObj> cmdObjPerShard;
+    const auto sampleSizes = cluster_aggregation_planner::apportionSampleSize(
+        sampleStage->getSampleSize(), numRecordsPerShard);
+    for (auto&& shardAndSize : sampleSizes) {
+        MutableDocument shardCmd(Document{cmdObj});
+        auto shardPipeline = shardCmd.peek()[AggregationRequest::kPipelineName].getArray();
+        shardPipeline.front() = Value(
+            DOC(DocumentSourceSample::kStageName << DOC("size" << shardAndSize.second)));
+        shardCmd[AggregationRequest::kPipelineName] = Value(std::move(shardPipeline));
+        cmdObjPerShard[shardAndSize.first] = shardCmd.freeze().toBson();
+    }
+    return cmdObjPerShard;
+}
+
 std::vector<RemoteCursor> establishShardCursors(
     OperationContext* opCtx,
     const NamespaceString& nss,
     const LiteParsedPipeline& litePipe,
     boost::optional<CachedCollectionRoutingInfo>& routingInfo,
     const BSONObj& cmdObj,
+    const std::map<ShardId, BSONObj>& cmdObjPerShard,
     const ReadPreferenceSetting& readPref,
     const BSONObj& shardQuery,
     const BSONObj& collation) {
@@ -316,8 +375,10 @@ std::vector<RemoteCursor> establishShardCursors(
         // The collection is sharded. Use the routing table to decide which shards to target
         // based on the query and collation, and build versioned requests for them.
         for (auto& shardId : shardIds) {
-            auto versionedCmdObj =
-                appendShardVersion(cmdObj, routingInfo->cm()->getVersion(shardId));
+            auto shardCmdObj = cmdObjPerShard.find(shardId);
+            auto versionedCmdObj = appendShardVersion(
+                shardCmdObj == cmdObjPerShard.end() ? cmdObj : shardCmdObj->second,
+                routingInfo->cm()->getVersion(shardId));
             requests.emplace_back(std::move(shardId), std::move(versionedCmdObj));
         }
     } else {
@@ -489,11 +550,25 @@ DispatchShardPipelineResults dispatchShardPipeline(
                                                            aggRequest.getCollation());
         }
     } else {
+        // A $sample on a sharded collection only needs each shard's share of the sample.
+        std::map<ShardId, BSONObj> targetedCommandPerShard;
+        if (splitPipeline && !exchangeSpec && !mustRunOnAll && shardIds.size() > 1u &&
+            executionNsRoutingInfo && executionNsRoutingInfo->cm() &&
+            !TransactionRouter::get(opCtx) && internalQueryApportionSampleAcrossShards.load()) {
+            targetedCommandPerShard = apportionSampleAcrossShards(opCtx,
+                                                                  executionNss,
+                                                                  *executionNsRoutingInfo,
+                                                                  *splitPipeline,
+                                                                  targetedCommand,
+                                                                  shardQuery,
+                                                                  aggRequest.getCollation());
+        }
         cursors = establishShardCursors(opCtx,
                                         executionNss,
                                         liteParsedPipeline,
                                         executionNsRoutingInfo,
                                         targetedCommand,
+                                        targetedCommandPerShard,
                                         ReadPreferenceSetting::get(opCtx),
                                         shardQuery,
                                         aggRequest.getCollation());
@@ -30,6 +30,8 @@
 
 #include "mongo/s/query/cluster_aggregation_planner.h"
 
+#include <cmath>
+
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -41,6 +43,7 @@
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/async_results_merger.h"
 #include "mongo/s/query/cluster_query_knobs.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 #include "mongo/s/query/document_source_update_on_add_shard.h"
@@ -380,6 +383,18 @@ void addMergeCursorsSource(Pipeline* mergePipeline,
     auto* opCtx = mergePipeline->getContext()->opCtx;
     AsyncResultsMergerParams armParams;
     armParams.setSort(shardCursorsSortSpec);
+
+    // A merging pipeline which begins with a $limit reads no more than that many sorted results.
+    // The limit is not set while the sort key bound is turned off, since a merging shard of an
+    // earlier version would not accept it.
+    const auto& mergeSources = mergePipeline->getSources();
+    if (shardCursorsSortSpec && !mergeSources.empty() &&
+        internalQueryAsyncResultsMergerSendSortKeyBound.load()) {
+        if (auto limit = dynamic_cast<DocumentSourceLimit*>(mergeSources.front().get())) {
+            armParams.setLimit(limit->getLimit());
+        }
+    }
+
     armParams.setTailableMode(mergePipeline->getContext()->tailableMode);
     armParams.setNss(mergePipeline->getContext()->ns);
 
@@ -479,5 +494,34 @@ boost::optional<ShardedExchangePolicy> checkIfEligibleForExchange(OperationConte
     return walkPipelineBackwardsTrackingShardKey(opCtx, outStage, mergePipeline, *routingInfo.cm());
 }
 
+std::map<ShardId, long long> apportionSampleSize(
+    long long sampleSize, const std::map<ShardId, long long>& numRecordsPerShard) {
+    // The number of documents a uniform sample of the whole collection takes from one shard varies
+    // around that shard's proportional share. Asking each shard for four standard deviations more
+    // than its share means the merger almost never runs out of a shard's documents.
+    const double kNumStandardDeviations = 4.0;
+
+    long long totalRecords = 0;
+    for (auto&& shardAndCount : numRecordsPerShard) {
+        totalRecords += std::max(shardAndCount.second, 0LL);
+    }
+
+    std::map<ShardId, long long> sampleSizes;
+    for (auto&& shardAndCount : numRecordsPerShard) {
+        if (totalRecords <= 0) {
+            sampleSizes[shardAndCount.first] = sampleSize;
+            continue;
+        }
+        const double share =
+            static_cast<double>(std::max(shardAndCount.second, 0LL)) / totalRecords;
+        const double mean = sampleSize * share;
+        const double stdDev = std::sqrt(sampleSize * share * (1 - share));
+        const auto size =
+            static_cast<long long>(std::ceil(mean + kNumStandardDeviations * stdDev));
+        sampleSizes[shardAndCount.first] = std::min(sampleSize, std::max(size, 1LL));
+    }
+    return sampleSizes;
+}
+
 }  // namespace cluster_aggregation_planner
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/db/pipeline/exchange_spec_gen.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline.h"
@@ -108,5 +110,14 @@ struct ShardedExchangePolicy {
  */
 boost::optional<ShardedExchangePolicy> checkIfEligibleForExchange(OperationContext* opCtx,
                                                                   const Pipeline* mergePipeline);
+
+/**
+ * Given the number of records on each targeted shard, returns how many documents each shard should
+ * sample so that the merger can take a $sample of 'sampleSize' documents from their union. Each
+ * shard is asked for its proportional share plus some slack, rather than for the whole
+ * 'sampleSize', so that shards can use a random cursor for small samples of large collections.
+ */
+std::map<ShardId, long long> apportionSampleSize(
+    long long sampleSize, const std::map<ShardId, long long>& numRecordsPerShard);
 }  // namespace cluster_aggregation_planner
 }  // namespace mongo
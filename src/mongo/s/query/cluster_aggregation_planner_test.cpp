@@ -595,5 +595,42 @@ TEST_F(ClusterExchangeTest, CompoundShardKeyThreeShards) {
 
     future.timed_get(kFutureTimeout);
 }
+
+TEST(ApportionSampleSizeTest, EqualShardsEachSampleTheirShareWithSlack) {
+    auto sizes = cluster_aggregation_planner::apportionSampleSize(
+        100, {{ShardId("0"), 5000}, {ShardId("1"), 5000}});
+    ASSERT_EQ(sizes.size(), 2u);
+    // A share of 50 documents, plus four standard deviations of 5 documents.
+    ASSERT_EQ(sizes[ShardId("0")], 70);
+    ASSERT_EQ(sizes[ShardId("1")], 70);
+}
+
+TEST(ApportionSampleSizeTest, SmallShardSamplesLessThanLargeShard) {
+    auto sizes = cluster_aggregation_planner::apportionSampleSize(
+        1000, {{ShardId("0"), 1000}, {ShardId("1"), 99000}});
+    ASSERT_LT(sizes[ShardId("0")], 100);
+    ASSERT_GTE(sizes[ShardId("0")], 10);
+    ASSERT_EQ(sizes[ShardId("1")], 1000);
+}
+
+TEST(ApportionSampleSizeTest, SizesCoverTheWholeSample) {
+    std::map<ShardId, long long> numRecordsPerShard{
+        {ShardId("0"), 17}, {ShardId("1"), 2500}, {ShardId("2"), 80000}};
+    auto sizes = cluster_aggregation_planner::apportionSampleSize(300, numRecordsPerShard);
+    long long total = 0;
+    for (auto&& shardAndSize : sizes) {
+        ASSERT_GTE(shardAndSize.second, 1);
+        ASSERT_LTE(shardAndSize.second, 300);
+        total += shardAndSize.second;
+    }
+    ASSERT_GTE(total, 300);
+}
+
+TEST(ApportionSampleSizeTest, EmptyShardsSampleTheWholeSize) {
+    auto sizes = cluster_aggregation_planner::apportionSampleSize(
+        10, {{ShardId("0"), 0}, {ShardId("1"), 0}});
+    ASSERT_EQ(sizes[ShardId("0")], 10);
+    ASSERT_EQ(sizes[ShardId("1")], 10);
+}
 }  // namespace
 }  // namespace mongo
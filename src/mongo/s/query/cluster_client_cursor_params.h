@@ -83,6 +83,10 @@ struct ClusterClientCursorParams {
         armParams.setRemotes(std::move(remotes));
         armParams.setTailableMode(tailableMode);
         armParams.setBatchSize(batchSize);
+        if (limit) {
+            // The merged results are read up to the limit after the skip.
+            armParams.setLimit(*limit + skip.value_or(0));
+        }
         armParams.setNss(nsString);
         armParams.setAllowPartialResults(isAllowPartialResults);
 
@@ -37,6 +37,7 @@
 #include "mongo/db/kill_sessions.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/query/cluster_client_cursor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -66,6 +67,11 @@ class StatusWith;
  * The manager supports killing of registered cursors, either through the PinnedCursor object or
  * with the kill*() suite of methods.
  *
+ * Registered cursors are spread across a fixed number of partitions, each with its own mutex, so
+ * that operations on cursors in different partitions do not contend with each other.  The
+ * partition holding a cursor is encoded in its cursor id, so that a cursor can be found from its id
+ * by locking only one partition.
+ *
  * No public methods throw exceptions, and all public methods are thread-safe.
  */
 class ClusterCursorManager {
@@ -405,6 +411,9 @@ public:
      * Informs the manager that all mortal cursors with a 'last active' time equal to or earlier
      * than 'cutoff' should be killed.  The cursors need not necessarily be in the 'idle' state.
      *
+     * The partitions are visited one at a time, so that the periodic cleanup job only ever blocks
+     * operations on the cursors of the partition it is currently scanning.
+     *
      * May block waiting for other threads to finish, but does not block on the network.
      *
      * Returns the number of cursors that were killed due to inactivity.
@@ -416,6 +425,9 @@ public:
      * while this function is running, it may not be killed. If the caller wants to guarantee that
      * all cursors are killed, shutdown() should be used instead.
      *
+     * Like killMortalCursorsInactiveSince(), visits the partitions one at a time, and never holds
+     * more than one partition's lock.
+     *
      * May block waiting for other threads to finish, but does not block on the network.
      */
     void killAllCursors(OperationContext* opCtx);
@@ -468,13 +480,24 @@ public:
         return _cursorsTimedOut;
     }
 
+    /**
+     * The number of partitions that registered cursors are spread across.
+     */
+    static constexpr size_t kNumPartitions = 16;
+
 private:
     class CursorEntry;
     struct CursorEntryContainer;
+    struct Partition;
     using CursorEntryMap = stdx::unordered_map<CursorId, CursorEntry>;
     using NssToCursorContainerMap =
         stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>;
 
+    /**
+     * Returns the partition which holds the cursor with the given id, if it is registered.
+     */
+    Partition& _getPartition(CursorId cursorId) const;
+
     /**
      * Transfers ownership of the given pinned cursor back to the manager, and moves the cursor to
      * the 'idle' state.
@@ -492,9 +515,11 @@ private:
                        CursorState cursorState);
 
     /**
-     * Will detach a cursor, release the lock and then call kill() on it.
+     * Will detach a cursor from 'partition', release the partition's lock 'lk' and then call
+     * kill() on it.
      */
     void detachAndKillCursor(stdx::unique_lock<stdx::mutex> lk,
+                             Partition& partition,
                              OperationContext* opCtx,
                              const NamespaceString& nss,
                              CursorId cursorId);
@@ -503,9 +528,12 @@ private:
      * Returns a pointer to the CursorEntry for the given cursor.  If the given cursor is not
      * registered, returns null.
      *
-     * Not thread-safe.
+     * The caller must hold the lock of 'partition'.
      */
-    CursorEntry* _getEntry(WithLock, NamespaceString const& nss, CursorId cursorId);
+    CursorEntry* _getEntry(WithLock,
+                           Partition& partition,
+                           NamespaceString const& nss,
+                           CursorId cursorId);
 
     /**
      * De-registers the given cursor, and returns an owned pointer to the underlying
@@ -514,9 +542,10 @@ private:
      * If the given cursor is pinned, returns an error Status with code CursorInUse.  If the given
      * cursor is not registered, returns an error Status with code CursorNotFound.
      *
-     * Not thread-safe.
+     * The caller must hold the lock of 'partition'.
      */
     StatusWith<std::unique_ptr<ClusterClientCursor>> _detachCursor(WithLock,
+                                                                   Partition& partition,
                                                                    NamespaceString const& nss,
                                                                    CursorId cursorId);
 
@@ -526,12 +555,13 @@ private:
     void killOperationUsingCursor(WithLock, CursorEntry* entry);
 
     /**
-     * Kill the cursors satisfying the given predicate. Assumes that 'lk' is held upon entry.
+     * Kill the cursors satisfying the given predicate. Each partition is locked in turn while its
+     * matching cursors are detached, and the detached cursors are killed after its lock is
+     * released.
      *
      * Returns the number of cursors killed.
      */
-    std::size_t killCursorsSatisfying(stdx::unique_lock<stdx::mutex> lk,
-                                      OperationContext* opCtx,
+    std::size_t killCursorsSatisfying(OperationContext* opCtx,
                                       std::function<bool(CursorId, const CursorEntry&)> pred);
 
     /**
@@ -663,41 +693,63 @@ private:
         CursorEntryMap entryMap;
     };
 
+    /**
+     * A Partition holds the cursors whose ids carry a prefix equal to its index modulo
+     * kNumPartitions.  A namespace has one CursorEntryContainer in each partition which holds
+     * cursors on it.
+     */
+    struct Partition {
+        MONGO_DISALLOW_COPYING(Partition);
+
+        explicit Partition(int64_t seed) : pseudoRandom(seed) {}
+
+        // Synchronizes access to all the state of this partition.
+        mutable stdx::mutex mutex;
+
+        // Randomness source.  Used for cursor id generation.
+        PseudoRandom pseudoRandom;
+
+        // Map from cursor id prefix to associated namespace.  Exists only to provide namespace
+        // lookup for (deprecated) getNamespaceForCursorId() method.
+        //
+        // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the
+        // first cursor on a given namespace is registered in a partition, it is given a CursorId
+        // with a prefix that is unique to that namespace and partition, and an arbitrary suffix.
+        // Cursors subsequently registered on that namespace in the same partition will all share
+        // the same prefix.
+        //
+        // Entries are added when the first cursor on the given namespace is registered in this
+        // partition, and removed when the last such cursor is destroyed.
+        stdx::unordered_map<uint32_t, NamespaceString> cursorIdPrefixToNamespaceMap;
+
+        // Map from namespace to the CursorEntryContainer for that namespace in this partition.
+        //
+        // Entries are added and removed together with the entries of
+        // 'cursorIdPrefixToNamespaceMap'.
+        NssToCursorContainerMap namespaceToContainerMap;
+    };
+
     /**
      * Erase the container that 'it' points to and return an iterator to the next one. Assumes 'it'
-     * is an iterator in '_namespaceToContainerMap'.
+     * is an iterator in the 'namespaceToContainerMap' of 'partition', whose lock must be held.
      */
-    NssToCursorContainerMap::iterator eraseContainer(NssToCursorContainerMap::iterator it);
+    NssToCursorContainerMap::iterator eraseContainer(WithLock,
+                                                     Partition& partition,
+                                                     NssToCursorContainerMap::iterator it);
 
     // Clock source.  Used when the 'last active' time for a cursor needs to be set/updated.  May be
     // concurrently accessed by multiple threads.
     ClockSource* _clockSource;
 
-    // Synchronizes access to all private state variables below.
-    mutable stdx::mutex _mutex;
-
-    bool _inShutdown{false};
+    AtomicWord<bool> _inShutdown{false};
 
-    // Randomness source.  Used for cursor id generation.
-    PseudoRandom _pseudoRandom;
+    // Used to spread newly registered cursors across the partitions, so that the cursors of a
+    // single busy namespace do not all contend on the same lock.
+    AtomicWord<unsigned> _nextPartition{0};
 
-    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
-    // for (deprecated) getNamespaceForCursorId() method.
-    //
-    // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the first
-    // cursor on a given namespace is registered, it is given a CursorId with a prefix that is
-    // unique to that namespace, and an arbitrary suffix.  Cursors subsequently registered on that
-    // namespace will all share the same prefix.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
-
-    // Map from namespace to the CursorEntryContainer for that namespace.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    NssToCursorContainerMap _namespaceToContainerMap;
+    // Created on construction and never changed afterwards, so the vector itself may be read
+    // without holding any lock.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     size_t _cursorsTimedOut = 0;
 };
@@ -30,6 +30,7 @@
 
 #include "mongo/s/query/cluster_cursor_manager.h"
 
+#include <set>
 #include <vector>
 
 #include "mongo/db/logical_session_cache.h"
@@ -770,6 +771,34 @@ TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdMultipleCursorsSameNames
     }
 }
 
+// Test that cursors registered on a single namespace are spread across the manager's partitions,
+// and can each be found again from their id.
+TEST_F(ClusterCursorManagerTest, CursorsOnSameNamespaceAreSpreadAcrossPartitions) {
+    const size_t numCursors = ClusterCursorManager::kNumPartitions;
+    std::vector<CursorId> cursorIds(numCursors);
+    std::set<uint32_t> prefixes;
+    for (size_t i = 0; i < numCursors; ++i) {
+        cursorIds[i] =
+            assertGet(getManager()->registerCursor(_opCtx.get(),
+                                                   allocateMockCursor(),
+                                                   nss,
+                                                   ClusterCursorManager::CursorType::SingleTarget,
+                                                   ClusterCursorManager::CursorLifetime::Mortal,
+                                                   UserNameIterator()));
+        prefixes.insert(static_cast<uint64_t>(cursorIds[i]) >> 32);
+    }
+    ASSERT_EQ(numCursors, prefixes.size());
+
+    for (size_t i = 0; i < numCursors; ++i) {
+        auto pinnedCursor =
+            getManager()->checkOutCursor(nss, cursorIds[i], _opCtx.get(), successAuthChecker);
+        ASSERT_OK(pinnedCursor.getStatus());
+        pinnedCursor.getValue().returnCursor(ClusterCursorManager::CursorState::Exhausted);
+        ASSERT(isMockCursorKilled(i));
+    }
+    ASSERT_EQ(0U, getManager()->stats().cursorsSingleTarget);
+}
+
 // Test that getting the namespace for a cursor returns the correct namespace, when there are
 // multiple cursors registered on different namespaces.
 TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdMultipleCursorsDifferentNamespaces) {
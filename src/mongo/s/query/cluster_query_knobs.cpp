@@ -37,5 +37,6 @@ namespace mongo {
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryAlwaysMergeOnPrimaryShard, bool, false);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitMergingOnMongoS, bool, false);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryDisableExchange, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryApportionSampleAcrossShards, bool, true);
 
 }  // namespace mongo
@@ -48,4 +48,9 @@ extern AtomicBool internalQueryProhibitMergingOnMongoS;
 // If set to true on mongos then the cluster query planner will not produce plans with the exchange.
 // False by default, so the queries run with exchanges.
 extern AtomicBool internalQueryDisableExchange;
+
+// If set to true on mongos, an aggregation on a sharded collection which begins with $sample asks
+// each shard for a sample in proportion to the shard's share of the collection, rather than for the
+// whole sample size. True by default.
+extern AtomicBool internalQueryApportionSampleAcrossShards;
 }  // namespace mongo
@@ -317,5 +317,83 @@ TEST_F(RoutingTableHistoryTestThreeInitialChunks,
                               expectedBytesInChunksNotSplit);
 }
 
+/**
+ * Builds a routing table with 'numChunks' chunks [MinKey, 0), [0, 1), ..., [numChunks - 2, MaxKey)
+ * on the shard key {a: 1}, alternating between kThisShard and "otherShard".
+ */
+std::shared_ptr<RoutingTableHistory> makeRoutingTableWithManyChunks(const OID& epoch,
+                                                                    int numChunks) {
+    const KeyPattern shardKeyPattern(BSON("a" << 1));
+    std::vector<ChunkType> chunks;
+    for (int i = 0; i < numChunks; ++i) {
+        const auto min = i == 0 ? shardKeyPattern.globalMin() : BSON("a" << i - 1);
+        const auto max = i == numChunks - 1 ? shardKeyPattern.globalMax() : BSON("a" << i);
+        chunks.emplace_back(kNss,
+                            ChunkRange{min, max},
+                            ChunkVersion(i + 1, 0, epoch),
+                            i % 2 ? ShardId("otherShard") : kThisShard);
+    }
+    return RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), shardKeyPattern, nullptr, false, epoch, chunks);
+}
+
+void assertChunksAreContiguous(const RoutingTableHistory& rt) {
+    boost::optional<BSONObj> lastMax;
+    for (const auto& entry : rt.getChunkMap()) {
+        if (lastMax) {
+            ASSERT_BSONOBJ_EQ(*lastMax, entry.second->getMin());
+        }
+        lastMax = entry.second->getMax();
+    }
+}
+
+TEST(RoutingTableHistoryLargeTest, IncrementalUpdateLeavesThePreviousRoutingTableUnchanged) {
+    const OID epoch = OID::gen();
+    const int numChunks = 5000;
+    auto rt = makeRoutingTableWithManyChunks(epoch, numChunks);
+    ASSERT_EQ(rt->getChunkMap().size(), size_t(numChunks));
+    ASSERT_EQ(ChunkVersion(numChunks - 1, 0, epoch), rt->getVersion(kThisShard));
+    assertChunksAreContiguous(*rt);
+
+    // Merge the chunks [2000, 2001), ..., [2009, 2010) into one chunk on "otherShard".
+    auto newVersion = rt->getVersion();
+    newVersion.incMajor();
+    const ChunkType mergedChunk(
+        kNss, ChunkRange{BSON("a" << 2000), BSON("a" << 2010)}, newVersion, ShardId("otherShard"));
+    auto updatedRt = rt->makeUpdated({mergedChunk});
+
+    ASSERT_EQ(updatedRt->getChunkMap().size(), size_t(numChunks - 9));
+    ASSERT_EQ(newVersion, updatedRt->getVersion(ShardId("otherShard")));
+    ASSERT_EQ(ChunkVersion(numChunks - 1, 0, epoch), updatedRt->getVersion(kThisShard));
+    assertChunksAreContiguous(*updatedRt);
+
+    auto it = updatedRt->overlappingRanges(BSON("a" << 2005), BSON("a" << 2006), false);
+    ASSERT_EQ(1, std::distance(it.first, it.second));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 2000), it.first->second->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 2010), it.first->second->getMax());
+
+    // The routing table the update was applied to must not see any of its effects.
+    ASSERT_EQ(rt->getChunkMap().size(), size_t(numChunks));
+    ASSERT_EQ(ChunkVersion(numChunks, 0, epoch), rt->getVersion(ShardId("otherShard")));
+    assertChunksAreContiguous(*rt);
+    it = rt->overlappingRanges(BSON("a" << 2005), BSON("a" << 2006), false);
+    ASSERT_EQ(1, std::distance(it.first, it.second));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 2005), it.first->second->getMin());
+}
+
+TEST(RoutingTableHistoryLargeTest, IncrementalUpdateWithOverlapIsRejected) {
+    const OID epoch = OID::gen();
+    auto rt = makeRoutingTableWithManyChunks(epoch, 5000);
+
+    // A chunk which covers only part of [3001, 3002) without the rest of that chunk being
+    // replaced overlaps with it.
+    auto newVersion = rt->getVersion();
+    newVersion.incMajor();
+    const ChunkType chunk(
+        kNss, ChunkRange{BSON("a" << 3001), BSON("a" << 3001.5)}, newVersion, ShardId("shard3"));
+    ASSERT_THROWS_CODE(
+        rt->makeUpdated({chunk}), DBException, ErrorCodes::ConflictingOperationInProgress);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -58,10 +58,12 @@
 #include "mongo/db/logical_time_validator.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_killer.h"
 #include "mongo/db/startup_warnings_common.h"
 #include "mongo/db/wire_version.h"
+#include "mongo/executor/egress_tag_closer_manager.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/rpc/metadata/egress_metadata_hook_list.h"
@@ -106,6 +108,7 @@
 #include "mongo/util/periodic_runner_factory.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/quick_exit.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/signal_handlers.h"
 #include "mongo/util/stacktrace.h"
 #include "mongo/util/stringutils.h"
@@ -129,6 +132,19 @@ const ntservice::NtServiceDefaultStrings defaultServiceStrings = {
 
 constexpr auto kSignKeysRetryInterval = Seconds{1};
 
+// Whether to open connections to a newly found primary before requests for it arrive, sized after
+// the recent use of the primary it replaces.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(warmUpConnectionPoolsOnPrimaryChange, bool, true);
+
+void warmUpConnectionPools(const std::string& setName,
+                           const HostAndPort& newPrimary,
+                           const HostAndPort& oldPrimary) {
+    LOG(1) << "Warming up connection pools for new primary " << newPrimary << " of replica set "
+           << setName;
+    executor::EgressTagCloserManager::get(getGlobalServiceContext())
+        .warmUpConnections(newPrimary, oldPrimary);
+}
+
 boost::optional<ShardingUptimeReporter> shardingUptimeReporter;
 
 Status waitForSigningKeys(OperationContext* opCtx) {
@@ -373,6 +389,9 @@ ExitCode runMongosServer(ServiceContext* serviceContext) {
         &ShardRegistry::replicaSetChangeConfigServerUpdateHook);
     ReplicaSetMonitor::setSynchronousConfigChangeHook(
         &ShardRegistry::replicaSetChangeShardRegistryUpdateHook);
+    if (warmUpConnectionPoolsOnPrimaryChange) {
+        ReplicaSetMonitor::setPrimaryChangeHook(&warmUpConnectionPools);
+    }
 
     // Mongos connection pools already takes care of authenticating new connections so the
     // replica set connection shouldn't need to.
@@ -407,6 +426,8 @@ ExitCode runMongosServer(ServiceContext* serviceContext) {
 
     startMongoSFTDC();
 
+    SamplingProfiler::startIfEnabled();
+
     Status status = AuthorizationManager::get(serviceContext)->initialize(opCtx.get());
     if (!status.isOK()) {
         error() << "Initializing authorization data failed: " << status;
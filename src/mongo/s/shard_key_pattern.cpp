@@ -54,14 +54,14 @@ constexpr size_t kMaxFlattenedInCombinations = 4000000;
 constexpr auto kIdField = "_id"_sd;
 
 /**
- * Currently the allowable shard keys are either:
- * i) a hashed single field, e.g. { a : "hashed" }, or
- * ii) a compound list of ascending, potentially-nested field paths, e.g. { a : 1 , b.c : 1 }
+ * A shard key is a compound list of potentially-nested field paths, e.g. { a : 1 , b.c : 1 }. Each
+ * field is ascending, except that at most one of them may be hashed, e.g. { a : 1, b : "hashed" }.
  */
 std::vector<std::unique_ptr<FieldRef>> parseShardKeyPattern(const BSONObj& keyPattern) {
     uassert(ErrorCodes::BadValue, "Shard key is empty", !keyPattern.isEmpty());
 
     std::vector<std::unique_ptr<FieldRef>> parsedPaths;
+    bool hasHashedField = false;
 
     for (const auto& patternEl : keyPattern) {
         auto newFieldRef(stdx::make_unique<FieldRef>(patternEl.fieldNameStringData()));
@@ -85,12 +85,20 @@ std::vector<std::unique_ptr<FieldRef>> parseShardKeyPattern(const BSONObj& keyPa
                     !newFieldRef->getPart(i).empty());
         }
 
-        // Numeric and ascending (1.0), or "hashed" and single field
+        // Numeric and ascending (1.0), or "hashed"
         uassert(ErrorCodes::BadValue,
                 str::stream() << "Field " << patternEl.fieldNameStringData()
                               << " can only be 1 or 'hashed'",
                 (patternEl.isNumber() && patternEl.numberInt() == 1) ||
-                    (keyPattern.nFields() == 1 && ShardKeyPattern::isHashedPatternEl(patternEl)));
+                    ShardKeyPattern::isHashedPatternEl(patternEl));
+
+        if (ShardKeyPattern::isHashedPatternEl(patternEl)) {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Shard key " << keyPattern
+                                  << " may contain only one hashed field",
+                    !hasHashedField);
+            hasHashedField = true;
+        }
 
         parsedPaths.emplace_back(std::move(newFieldRef));
     }
@@ -179,7 +187,13 @@ Status ShardKeyPattern::checkShardKeyIsValidForMetadataStorage(const BSONObj& sh
 ShardKeyPattern::ShardKeyPattern(const BSONObj& keyPattern)
     : _keyPattern(keyPattern),
       _keyPatternPaths(parseShardKeyPattern(keyPattern)),
-      _hasId(keyPattern.hasField("_id"_sd)) {}
+      _hasId(keyPattern.hasField("_id"_sd)) {
+    for (const auto& patternEl : keyPattern) {
+        if (isHashedPatternEl(patternEl)) {
+            _hashedField = patternEl.fieldName();
+        }
+    }
+}
 
 ShardKeyPattern::ShardKeyPattern(const KeyPattern& keyPattern)
     : ShardKeyPattern(keyPattern.toBSON()) {}
@@ -189,9 +203,17 @@ bool ShardKeyPattern::isHashedPatternEl(const BSONElement& el) {
 }
 
 bool ShardKeyPattern::isHashedPattern() const {
+    return !_hashedField.empty();
+}
+
+bool ShardKeyPattern::hasHashedPrefix() const {
     return isHashedPatternEl(_keyPattern.toBSON().firstElement());
 }
 
+StringData ShardKeyPattern::getHashedField() const {
+    return _hashedField;
+}
+
 const KeyPattern& ShardKeyPattern::getKeyPattern() const {
     return _keyPattern;
 }
@@ -332,7 +354,7 @@ BSONObj ShardKeyPattern::extractShardKeyFromQuery(const CanonicalQuery& query) c
         if (!isValidShardKeyElementForStorage(equalEl))
             return BSONObj();
 
-        if (isHashedPattern()) {
+        if (patternPath.dottedField() == _hashedField) {
             keyBuilder.append(
                 patternPath.dottedField(),
                 BSONElementHasher::hash64(equalEl, BSONElementHasher::DEFAULT_HASH_SEED));
@@ -95,8 +95,24 @@ public:
      */
     static bool isHashedPatternEl(const BSONElement& el);
 
+    /**
+     * Returns true if one of the fields of the shard key pattern is hashed. The hashed field may
+     * be compounded with ascending fields, e.g. { a : "hashed", b : 1 } or { a : 1, b : "hashed" }.
+     */
     bool isHashedPattern() const;
 
+    /**
+     * Returns true if the first field of the shard key pattern is hashed, so that the whole range
+     * of shard keys is spread uniformly by the hash values. Only such shard keys can be presplit
+     * into chunks before the collection holds any data.
+     */
+    bool hasHashedPrefix() const;
+
+    /**
+     * Returns the path of the hashed field, or an empty string if no field is hashed.
+     */
+    StringData getHashedField() const;
+
     const KeyPattern& getKeyPattern() const;
 
     const std::vector<std::unique_ptr<FieldRef>>& getKeyPatternFields() const;
@@ -253,6 +269,9 @@ private:
     std::vector<std::unique_ptr<FieldRef>> _keyPatternPaths;
 
     bool _hasId;
+
+    // Path of the hashed field, if there is one
+    std::string _hashedField;
 };
 
 }  // namespace mongo
@@ -59,6 +59,28 @@ TEST(ShardKeyPattern, SingleFieldShardKeyPatternsValidityCheck) {
     ASSERT_THROWS(ShardKeyPattern(BSON("." << 1)), DBException);
 }
 
+TEST(ShardKeyPattern, CompoundHashedShardKeyPatternsValidityCheck) {
+    ShardKeyPattern(BSON("a"
+                         << "hashed"
+                         << "b"
+                         << 1));
+    ShardKeyPattern(BSON("a" << 1 << "b.c"
+                             << "hashed"
+                             << "d"
+                             << 1.0));
+
+    ASSERT_THROWS(ShardKeyPattern(BSON("a"
+                                       << "hashed"
+                                       << "b"
+                                       << "hashed")),
+                  DBException);
+    ASSERT_THROWS(ShardKeyPattern(BSON("a"
+                                       << "hashed"
+                                       << "b"
+                                       << -1)),
+                  DBException);
+}
+
 TEST(ShardKeyPattern, CompositeShardKeyPatternsValidityCheck) {
     ShardKeyPattern(BSON("a" << 1 << "b" << 1));
     ShardKeyPattern(BSON("a" << 1.0f << "b" << 1.0));
@@ -248,6 +270,36 @@ TEST(ShardKeyPattern, ExtractDocShardKeyHashed) {
     ASSERT_BSONOBJ_EQ(docKey(pattern, BSON("a" << BSON_ARRAY(BSON("b" << value)))), BSONObj());
 }
 
+TEST(ShardKeyPattern, ExtractDocShardKeyCompoundHashed) {
+    //
+    // Compound hashed ShardKeyPattern
+    //
+
+    const BSONObj bsonValue = BSON("" << 5);
+    const long long hashValue =
+        BSONElementHasher::hash64(bsonValue.firstElement(), BSONElementHasher::DEFAULT_HASH_SEED);
+
+    ShardKeyPattern pattern(BSON("a" << 1 << "b.c"
+                                     << "hashed"
+                                     << "d"
+                                     << 1));
+    ASSERT(pattern.isHashedPattern());
+    ASSERT(!pattern.hasHashedPrefix());
+    ASSERT_EQ(pattern.getHashedField(), "b.c");
+
+    ASSERT_BSONOBJ_EQ(docKey(pattern, fromjson("{a: 'x', b: {c: 5}, d: 10}")),
+                      BSON("a"
+                           << "x"
+                           << "b.c"
+                           << hashValue
+                           << "d"
+                           << 10));
+
+    ASSERT_BSONOBJ_EQ(docKey(pattern, fromjson("{a: 'x', b: {c: 5}}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(docKey(pattern, fromjson("{a: 'x', b: {c: [5]}, d: 10}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(docKey(pattern, fromjson("{a: [1], b: {c: 5}, d: 10}")), BSONObj());
+}
+
 static BSONObj queryKey(const ShardKeyPattern& pattern, const BSONObj& query) {
     QueryTestServiceContext serviceContext;
     auto opCtx = serviceContext.makeOperationContext();
@@ -417,6 +469,30 @@ TEST(ShardKeyPattern, ExtractQueryShardKeyHashed) {
     ASSERT_BSONOBJ_EQ(queryKey(pattern, BSON("a" << BSON_ARRAY(BSON("b" << value)))), BSONObj());
 }
 
+TEST(ShardKeyPattern, ExtractQueryShardKeyCompoundHashed) {
+    //
+    // Compound hashed ShardKeyPattern
+    //
+
+    const BSONObj bsonValue = BSON("" << 5);
+    const long long hashValue =
+        BSONElementHasher::hash64(bsonValue.firstElement(), BSONElementHasher::DEFAULT_HASH_SEED);
+
+    // Only the hashed field has the hash function applied to it.
+    ShardKeyPattern pattern(BSON("a"
+                                 << "hashed"
+                                 << "b"
+                                 << 1));
+    ASSERT(pattern.hasHashedPrefix());
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, fromjson("{a: 5, b: 5}")),
+                      BSON("a" << hashValue << "b" << 5));
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, fromjson("{b: 5, a: {$eq: 5}, c: 1}")),
+                      BSON("a" << hashValue << "b" << 5));
+
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, fromjson("{a: 5}")), BSONObj());
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, fromjson("{a: 5, b: {$gt: 5}}")), BSONObj());
+}
+
 static bool indexComp(const ShardKeyPattern& pattern, const BSONObj& indexPattern) {
     return pattern.isUniqueIndexCompatible(indexPattern);
 }
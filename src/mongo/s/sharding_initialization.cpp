@@ -32,6 +32,7 @@
 
 #include "mongo/s/sharding_initialization.h"
 
+#include <algorithm>
 #include <string>
 
 #include "mongo/base/status.h"
@@ -96,6 +97,13 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshTimeoutMS,
                                       int,
                                       ConnectionPool::kDefaultRefreshTimeout.count());
 
+// Pipelining small requests to a host over a shared connection is off unless this is set above 0.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolMaxCoalescedRequests, int, 0);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(
+    ShardingTaskExecutorPoolMaxCoalescedRequestBytes,
+    int,
+    static_cast<int>(ConnectionPool::kDefaultMaxCoalescedRequestBytes));
+
 namespace {
 
 using executor::NetworkInterface;
@@ -191,6 +199,10 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.minConnections = ShardingTaskExecutorPoolMinSize;
     connPoolOptions.refreshRequirement = Milliseconds(ShardingTaskExecutorPoolRefreshRequirementMS);
     connPoolOptions.refreshTimeout = Milliseconds(ShardingTaskExecutorPoolRefreshTimeoutMS);
+    connPoolOptions.maxCoalescedRequests =
+        std::max(ShardingTaskExecutorPoolMaxCoalescedRequests, 0);
+    connPoolOptions.maxCoalescedRequestBytes =
+        std::max(ShardingTaskExecutorPoolMaxCoalescedRequestBytes, 0);
 
     if (connPoolOptions.refreshRequirement <= connPoolOptions.refreshTimeout) {
         auto newRefreshTimeout = connPoolOptions.refreshRequirement - Milliseconds(1);
@@ -166,6 +166,15 @@ BSONObjBuilder appendFieldsForStartTransaction(BSONObj cmd,
 const StringMap<int> alwaysRetryableCmds = {
     {"aggregate", 1}, {"distinct", 1}, {"find", 1}, {"getMore", 1}, {"killCursors", 1}};
 
+/**
+ * Returns true if 'cmd' is known not to write, which is the case for the always retryable commands
+ * above and for the transaction commands.
+ */
+bool isReadOnlyCommand(const BSONObj& cmd) {
+    return isTransactionCommand(cmd) ||
+        alwaysRetryableCmds.count(cmd.firstElement().fieldNameStringData());
+}
+
 }  // unnamed namespace
 
 TransactionRouter::Participant::Participant(bool isCoordinator,
@@ -236,6 +245,12 @@ BSONObj TransactionRouter::Participant::attachTxnFieldsIfNeeded(
     return newCmd.obj();
 }
 
+void TransactionRouter::Participant::recordCommand(const BSONObj& cmd) {
+    if (!isReadOnlyCommand(cmd)) {
+        _readOnly = false;
+    }
+}
+
 bool TransactionRouter::Participant::isCoordinator() const {
     return _isCoordinator;
 }
@@ -274,10 +289,12 @@ boost::optional<ShardId> TransactionRouter::getCoordinatorId() const {
 
 BSONObj TransactionRouter::attachTxnFieldsIfNeeded(const ShardId& shardId, const BSONObj& cmdObj) {
     if (auto txnPart = getParticipant(shardId)) {
+        txnPart->recordCommand(cmdObj);
         return txnPart->attachTxnFieldsIfNeeded(cmdObj, false);
     }
 
-    auto txnPart = _createParticipant(shardId);
+    auto& txnPart = _createParticipant(shardId);
+    txnPart.recordCommand(cmdObj);
     return txnPart.attachTxnFieldsIfNeeded(cmdObj, true);
 }
 
@@ -550,6 +567,61 @@ Shard::CommandResponse TransactionRouter::_commitSingleShardTransaction(Operatio
         Shard::RetryPolicy::kIdempotent));
 }
 
+Shard::CommandResponse TransactionRouter::_commitSingleWriteShardTransaction(
+    OperationContext* opCtx) {
+    CommitTransaction commitCmd;
+    commitCmd.setDbName("admin");
+    auto commitCmdObj = commitCmd.toBSON(opCtx->getWriteConcern().toBSON());
+
+    std::vector<AsyncRequestsSender::Request> readOnlyCommitRequests;
+    boost::optional<ShardId> writeShardId;
+    for (const auto& participantEntry : _participants) {
+        if (participantEntry.second.isReadOnly()) {
+            readOnlyCommitRequests.emplace_back(ShardId(participantEntry.first), commitCmdObj);
+        } else {
+            invariant(!writeShardId);
+            writeShardId = ShardId(participantEntry.first);
+        }
+    }
+
+    // The read-only participants are committed before the participant that wrote, so that if one
+    // of them can no longer commit, e.g. because its transaction was aborted, nothing is committed.
+    boost::optional<Shard::CommandResponse> lastResponse;
+    auto responses = gatherResponses(opCtx,
+                                     NamespaceString::kAdminDb,
+                                     ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                                     Shard::RetryPolicy::kIdempotent,
+                                     readOnlyCommitRequests);
+    for (const auto& response : responses) {
+        uassertStatusOK(response.swResponse.getStatus());
+        const auto& responseObj = response.swResponse.getValue().data;
+
+        Shard::CommandResponse commandResponse(response.shardHostAndPort,
+                                               responseObj,
+                                               getStatusFromCommandResult(responseObj),
+                                               getWriteConcernStatusFromCommandResult(responseObj));
+        if (!commandResponse.commandStatus.isOK() ||
+            !commandResponse.writeConcernStatus.isOK()) {
+            return commandResponse;
+        }
+        lastResponse.emplace(std::move(commandResponse));
+    }
+
+    if (!writeShardId) {
+        invariant(lastResponse);
+        return *lastResponse;
+    }
+
+    auto shard = uassertStatusOK(Grid::get(opCtx)->shardRegistry()->getShard(opCtx, *writeShardId));
+    const auto& participant = _participants.find(writeShardId->toString())->second;
+    return uassertStatusOK(shard->runCommandWithFixedRetryAttempts(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        "admin",
+        participant.attachTxnFieldsIfNeeded(commitCmdObj, false),
+        Shard::RetryPolicy::kIdempotent));
+}
+
 Shard::CommandResponse TransactionRouter::_commitMultiShardTransaction(OperationContext* opCtx) {
     invariant(_coordinatorId);
 
@@ -568,6 +640,9 @@ Shard::CommandResponse TransactionRouter::_commitMultiShardTransaction(Operation
 
         CommitParticipant commitParticipant;
         commitParticipant.setShardId(shardId);
+        if (participantEntry.second.isReadOnly()) {
+            commitParticipant.setReadOnly(true);
+        }
         participantList.push_back(std::move(commitParticipant));
 
         if (participantEntry.second.isCoordinator()) {
@@ -576,6 +651,11 @@ Shard::CommandResponse TransactionRouter::_commitMultiShardTransaction(Operation
             continue;
         }
 
+        if (participantEntry.second.isReadOnly()) {
+            // The coordinator commits read-only participants without preparing them.
+            continue;
+        }
+
         const auto& participant = participantEntry.second;
         auto shard = uassertStatusOK(shardRegistry->getShard(opCtx, shardId));
         shard->runFireAndForgetCommand(opCtx,
@@ -609,6 +689,15 @@ Shard::CommandResponse TransactionRouter::commitTransaction(OperationContext* op
         return _commitSingleShardTransaction(opCtx);
     }
 
+    // Two phase commit is only needed when more than one participant wrote.
+    const auto numWriteShards =
+        std::count_if(_participants.begin(), _participants.end(), [](const auto& participantEntry) {
+            return !participantEntry.second.isReadOnly();
+        });
+    if (numWriteShards <= 1) {
+        return _commitSingleWriteShardTransaction(opCtx);
+    }
+
     return _commitMultiShardTransaction(opCtx);
 }
 
@@ -99,9 +99,25 @@ public:
             return _sharedOptions;
         }
 
+        /**
+         * True if every command sent to this participant so far only read data. Read-only
+         * participants are committed without being prepared.
+         */
+        bool isReadOnly() const {
+            return _readOnly;
+        }
+
+        /**
+         * Records that 'cmd' is sent to this participant, which is no longer read-only unless
+         * 'cmd' is known not to write.
+         */
+        void recordCommand(const BSONObj& cmd);
+
     private:
         const bool _isCoordinator{false};
 
+        bool _readOnly{true};
+
         // The highest statement id of the request during which this participant was created.
         const StmtId _stmtIdCreatedAt{kUninitializedStmtId};
 
@@ -216,7 +232,14 @@ private:
     Shard::CommandResponse _commitSingleShardTransaction(OperationContext* opCtx);
 
     /**
-     * Run two phase commit for transactions that touched multiple shards.
+     * Run basic commit for transactions that wrote to at most one shard: the read-only
+     * participants are committed first, in parallel, and then the participant that wrote, if any.
+     * None of them are prepared.
+     */
+    Shard::CommandResponse _commitSingleWriteShardTransaction(OperationContext* opCtx);
+
+    /**
+     * Run two phase commit for transactions that wrote to multiple shards.
      */
     Shard::CommandResponse _commitMultiShardTransaction(OperationContext* opCtx);
 
@@ -710,6 +710,96 @@ TEST_F(TransactionRouterTest, SendPrepareAndCoordinateCommitForMultipleParticipa
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(TransactionRouterTest, SendCommitToReadOnlyParticipantsBeforeSingleWriteParticipant) {
+    LogicalSessionId lsid(makeLogicalSessionIdForTest());
+    TxnNumber txnNum{3};
+
+    auto opCtx = operationContext();
+    opCtx->setLogicalSessionId(lsid);
+    opCtx->setTxnNumber(txnNum);
+
+    ScopedRouterSession scopedSession(opCtx);
+    auto txnRouter = TransactionRouter::get(opCtx);
+
+    txnRouter->beginOrContinueTxn(opCtx, txnNum, true);
+    txnRouter->setAtClusterTimeToLatestTime(operationContext());
+    txnRouter->attachTxnFieldsIfNeeded(shard1,
+                                       BSON("find"
+                                            << "test"));
+    txnRouter->attachTxnFieldsIfNeeded(shard2,
+                                       BSON("insert"
+                                            << "test"));
+
+    ASSERT_TRUE(txnRouter->getParticipant(shard1)->isReadOnly());
+    ASSERT_FALSE(txnRouter->getParticipant(shard2)->isReadOnly());
+
+    auto future = launchAsync([&] { txnRouter->commitTransaction(operationContext()); });
+
+    for (const auto& hostAndPort : {hostAndPort1, hostAndPort2}) {
+        onCommand([&](const RemoteCommandRequest& request) {
+            ASSERT_EQ(hostAndPort, request.target);
+            ASSERT_EQ("admin", request.dbname);
+
+            auto cmdName = request.cmdObj.firstElement().fieldNameStringData();
+            ASSERT_EQ(cmdName, "commitTransaction");
+
+            return BSON("ok" << 1);
+        });
+    }
+
+    future.timed_get(kFutureTimeout);
+}
+
+TEST_F(TransactionRouterTest, DoNotSendPrepareToReadOnlyParticipants) {
+    LogicalSessionId lsid(makeLogicalSessionIdForTest());
+    TxnNumber txnNum{3};
+
+    auto opCtx = operationContext();
+    opCtx->setLogicalSessionId(lsid);
+    opCtx->setTxnNumber(txnNum);
+
+    ScopedRouterSession scopedSession(opCtx);
+    auto txnRouter = TransactionRouter::get(opCtx);
+
+    txnRouter->beginOrContinueTxn(opCtx, txnNum, true);
+    txnRouter->setAtClusterTimeToLatestTime(operationContext());
+    txnRouter->attachTxnFieldsIfNeeded(shard1, {});
+    txnRouter->attachTxnFieldsIfNeeded(shard2, {});
+    txnRouter->attachTxnFieldsIfNeeded(shard3,
+                                       BSON("find"
+                                            << "test"));
+
+    auto future = launchAsync([&] { txnRouter->commitTransaction(operationContext()); });
+
+    onCommand([&](const RemoteCommandRequest& request) {
+        ASSERT_EQ(hostAndPort2, request.target);
+
+        auto cmdName = request.cmdObj.firstElement().fieldNameStringData();
+        ASSERT_EQ(cmdName, "prepareTransaction");
+
+        return BSON("ok" << 1);
+    });
+
+    onCommand([&](const RemoteCommandRequest& request) {
+        ASSERT_EQ(hostAndPort1, request.target);
+
+        auto cmdName = request.cmdObj.firstElement().fieldNameStringData();
+        ASSERT_EQ(cmdName, "coordinateCommitTransaction");
+
+        auto participantElements = request.cmdObj["participants"].Array();
+        ASSERT_EQ(3u, participantElements.size());
+        for (const auto& participantElement : participantElements) {
+            auto participant = participantElement.Obj();
+            const bool isReadOnly = participant["shardId"].str() == shard3.toString();
+            ASSERT_EQ(isReadOnly, participant["readOnly"].trueValue());
+        }
+
+        return BSON("ok" << 1);
+    });
+
+    future.timed_get(kFutureTimeout);
+}
+
 TEST_F(TransactionRouterTest, SnapshotErrorsResetAtClusterTime) {
     TxnNumber txnNum{3};
 
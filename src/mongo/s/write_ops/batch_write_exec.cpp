@@ -32,13 +32,18 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <deque>
+#include <memory>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/owned_pointer_map.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor_pool.h"
+#include "mongo/s/async_requests_sender.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
@@ -48,6 +53,9 @@
 #include "mongo/util/log.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(internalBatchWritePipelineUnordered, bool, true);
+
 namespace {
 
 const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly);
@@ -80,6 +88,237 @@ void noteStaleResponses(const std::vector<ShardError>& staleErrors, NSTargeter*
 // applies when no writes are occurring and metadata is not changing on reload.
 const int kMaxRoundsWithoutProgress(5);
 
+// Builds the command to send to the shard targeted by 'batch'.
+BSONObj buildShardRequest(OperationContext* opCtx,
+                          const BatchWriteOp& batchOp,
+                          const TargetedWriteBatch& batch) {
+    const auto shardBatchRequest(batchOp.buildBatchRequest(batch));
+
+    BSONObjBuilder requestBuilder;
+    shardBatchRequest.serialize(&requestBuilder);
+
+    {
+        OperationSessionInfo sessionInfo;
+
+        if (opCtx->getLogicalSessionId()) {
+            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+        }
+
+        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
+        sessionInfo.serialize(&requestBuilder);
+    }
+
+    return requestBuilder.obj();
+}
+
+/**
+ * Notes the response or error received for a child batch in the batch write op. Returns true if
+ * the response indicates that the targeter must be refreshed before the write ops, which it
+ * returned to the ready state, can be targeted again.
+ */
+bool processBatchResponse(OperationContext* opCtx,
+                          NSTargeter& targeter,
+                          BatchWriteOp& batchOp,
+                          const TargetedWriteBatch& batch,
+                          AsyncRequestsSender::Response& response,
+                          BatchWriteExecStats* stats) {
+    // First check if we were able to target a shard host.
+    if (!response.shardHostAndPort) {
+        invariant(!response.swResponse.isOK());
+
+        // Record a resolve failure
+        batchOp.noteBatchError(batch, errorFromStatus(response.swResponse.getStatus()));
+
+        // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel and
+        // retarget the batch
+        LOG(4) << "Unable to send write batch to " << batch.getEndpoint().shardName
+               << causedBy(response.swResponse.getStatus());
+        return false;
+    }
+
+    const auto shardHost(std::move(*response.shardHostAndPort));
+
+    // Then check if we successfully got a response.
+    Status responseStatus = response.swResponse.getStatus();
+    BatchedCommandResponse batchedCommandResponse;
+    if (responseStatus.isOK()) {
+        std::string errMsg;
+        if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data, &errMsg) ||
+            !batchedCommandResponse.isValid(&errMsg)) {
+            responseStatus = {ErrorCodes::FailedToParse, errMsg};
+        }
+    }
+
+    if (!responseStatus.isOK()) {
+        // Error occurred dispatching, note it
+        const Status status = responseStatus.withContext(
+            str::stream() << "Write results unavailable from " << shardHost);
+
+        batchOp.noteBatchError(batch, errorFromStatus(status));
+
+        LOG(4) << "Unable to receive write results from " << shardHost << causedBy(redact(status));
+        return false;
+    }
+
+    TrackedErrors trackedErrors;
+    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+    trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
+
+    LOG(4) << "Write results received from " << shardHost.toString() << ": "
+           << redact(batchedCommandResponse.toString());
+
+    // If we are in a transaction, we must fail the whole batch.
+    if (TransactionRouter::get(opCtx)) {
+        // Note: this returns a bad status if any part of the batch failed.
+        auto batchStatus = batchedCommandResponse.toStatus();
+        if (!batchStatus.isOK()) {
+            batchOp.forgetTargetedBatchesOnTransactionAbortingError();
+            uassertStatusOK(batchStatus.withContext(str::stream() << "Encountered error from "
+                                                                  << shardHost.toString()
+                                                                  << " during a transaction"));
+        }
+    }
+
+    // Dispatch was ok, note response
+    batchOp.noteBatchResponse(batch, batchedCommandResponse, &trackedErrors);
+
+    // Note if anything was stale
+    const auto& staleErrors = trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+    if (!staleErrors.empty()) {
+        noteStaleResponses(staleErrors, &targeter);
+        ++stats->numStaleBatches;
+    }
+
+    const auto& cannotImplicitlyCreateErrors =
+        trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
+    if (!cannotImplicitlyCreateErrors.empty()) {
+        // This forces the chunk manager to reload so we can attach the correct version on retry
+        // and make sure we route to the correct shard.
+        targeter.noteCouldNotTarget();
+    }
+
+    // Remember that we successfully wrote to this shard
+    // NOTE: This will record lastOps for shards where we actually didn't update or delete any
+    // documents, which preserves old behavior but is conservative
+    stats->noteWriteAt(shardHost,
+                       batchedCommandResponse.isLastOpSet() ? batchedCommandResponse.getLastOp()
+                                                            : repl::OpTime(),
+                       batchedCommandResponse.isElectionIdSet()
+                           ? batchedCommandResponse.getElectionId()
+                           : OID());
+
+    return !staleErrors.empty() || !cannotImplicitlyCreateErrors.empty();
+}
+
+/**
+ * Sends the child batches of an unordered write so that each shard gets its next child batch as
+ * soon as the response to its previous one has been received, rather than once all the shards
+ * have responded. The remaining ready write ops are targeted whenever a shard runs out of queued
+ * batches, until either all of them have been sent or a response requires the targeter to be
+ * refreshed, in which case the ops left are retargeted on the next round.
+ *
+ * Only one child batch is outstanding to a shard at a time, because responses are matched to
+ * their batches by shard id. Batches targeted at a shard which is still busy are queued.
+ *
+ * Takes ownership of the batches in 'childBatches'. Returns false if targeting the remaining
+ * write ops failed.
+ */
+bool sendChildBatchesPipelined(OperationContext* opCtx,
+                               NSTargeter& targeter,
+                               const BatchedCommandRequest& clientRequest,
+                               BatchWriteOp& batchOp,
+                               bool recordTargetErrors,
+                               std::map<ShardId, TargetedWriteBatch*>* childBatches,
+                               BatchWriteExecStats* stats) {
+    std::map<ShardId, std::deque<std::unique_ptr<TargetedWriteBatch>>> queuedBatches;
+    std::map<ShardId, std::unique_ptr<TargetedWriteBatch>> inFlightBatches;
+
+    auto queueBatches = [&](std::map<ShardId, TargetedWriteBatch*>* batches) {
+        for (const auto& batch : *batches) {
+            queuedBatches[batch.first].emplace_back(batch.second);
+        }
+        batches->clear();
+    };
+
+    queueBatches(childBatches);
+
+    AsyncRequestsSender ars(opCtx,
+                            Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                            clientRequest.getNS().db(),
+                            {},
+                            kPrimaryOnlyReadPreference,
+                            opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
+                                                  : Shard::RetryPolicy::kNoRetry);
+
+    auto sendToIdleShards = [&] {
+        std::vector<AsyncRequestsSender::Request> requests;
+
+        for (auto it = queuedBatches.begin(); it != queuedBatches.end();) {
+            const auto& targetShardId = it->first;
+            if (inFlightBatches.count(targetShardId)) {
+                ++it;
+                continue;
+            }
+
+            auto nextBatch = std::move(it->second.front());
+            it->second.pop_front();
+
+            stats->noteTargetedShard(targetShardId);
+
+            const auto request = buildShardRequest(opCtx, batchOp, *nextBatch);
+            LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
+
+            requests.emplace_back(targetShardId, request);
+            inFlightBatches.emplace(targetShardId, std::move(nextBatch));
+
+            it = it->second.empty() ? queuedBatches.erase(it) : std::next(it);
+        }
+
+        if (!requests.empty()) {
+            ars.addRequests(requests);
+        }
+    };
+
+    sendToIdleShards();
+
+    bool targetingStopped = false;
+    bool targetingFailed = false;
+
+    while (!ars.done()) {
+        // Block until a response is available.
+        auto response = ars.next();
+
+        auto it = inFlightBatches.find(response.shardId);
+        invariant(it != inFlightBatches.end());
+        const auto batch = std::move(it->second);
+        inFlightBatches.erase(it);
+
+        if (processBatchResponse(opCtx, targeter, batchOp, *batch, response, stats)) {
+            targetingStopped = true;
+        }
+
+        // Target more of the ready write ops once the shard which responded is out of work
+        if (!targetingStopped && !queuedBatches.count(response.shardId) &&
+            batchOp.numWriteOpsIn(WriteOpState_Ready) > 0) {
+            std::map<ShardId, TargetedWriteBatch*> moreBatches;
+            Status targetStatus = batchOp.targetBatch(targeter, recordTargetErrors, &moreBatches);
+            if (!targetStatus.isOK()) {
+                targeter.noteCouldNotTarget();
+                ++stats->numTargetErrors;
+                targetingStopped = true;
+                targetingFailed = true;
+            }
+
+            queueBatches(&moreBatches);
+        }
+
+        sendToIdleShards();
+    }
+
+    invariant(queuedBatches.empty());
+    return !targetingFailed;
+}
+
 }  // namespace
 
 void BatchWriteExec::executeBatch(OperationContext* opCtx,
@@ -100,6 +339,11 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
     int numCompletedOps = 0;
     int numRoundsWithoutProgress = 0;
 
+    // Unordered writes outside of transactions do not need to wait for all the shards targeted by
+    // a round before sending more batches to the shards which have already responded.
+    const bool pipelineUnordered = internalBatchWritePipelineUnordered.load() &&
+        !clientRequest.getWriteCommandBase().getOrdered() && !TransactionRouter::get(opCtx);
+
     while (!batchOp.isFinished()) {
         //
         // Get child batches to send using the targeter
@@ -144,6 +388,18 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         // Send all child batches
         //
 
+        if (pipelineUnordered && !childBatches.empty()) {
+            if (!sendChildBatchesPipelined(opCtx,
+                                           targeter,
+                                           clientRequest,
+                                           batchOp,
+                                           recordTargetErrors,
+                                           &childBatches,
+                                           stats)) {
+                refreshedTargeter = true;
+            }
+        }
+
         const size_t numToSend = childBatches.size();
         size_t numSent = 0;
 
@@ -174,25 +430,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
                 stats->noteTargetedShard(targetShardId);
 
-                const auto request = [&] {
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
-
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
-
-                    {
-                        OperationSessionInfo sessionInfo;
-
-                        if (opCtx->getLogicalSessionId()) {
-                            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
-                        }
-
-                        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
-                        sessionInfo.serialize(&requestBuilder);
-                    }
-
-                    return requestBuilder.obj();
-                }();
+                const auto request = buildShardRequest(opCtx, batchOp, *nextBatch);
 
                 LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
 
@@ -229,100 +467,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
                 TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
 
-                // First check if we were able to target a shard host.
-                if (!response.shardHostAndPort) {
-                    invariant(!response.swResponse.isOK());
-
-                    // Record a resolve failure
-                    batchOp.noteBatchError(*batch,
-                                           errorFromStatus(response.swResponse.getStatus()));
-
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel
-                    // and retarget the batch
-                    LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
-                           << causedBy(response.swResponse.getStatus());
-
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
-                    continue;
-                }
-
-                const auto shardHost(std::move(*response.shardHostAndPort));
-
-                // Then check if we successfully got a response.
-                Status responseStatus = response.swResponse.getStatus();
-                BatchedCommandResponse batchedCommandResponse;
-                if (responseStatus.isOK()) {
-                    std::string errMsg;
-                    if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
-                                                          &errMsg) ||
-                        !batchedCommandResponse.isValid(&errMsg)) {
-                        responseStatus = {ErrorCodes::FailedToParse, errMsg};
-                    }
-                }
-
-                if (responseStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
-                    trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
-
-                    LOG(4) << "Write results received from " << shardHost.toString() << ": "
-                           << redact(batchedCommandResponse.toString());
-
-                    // If we are in a transaction, we must fail the whole batch.
-                    if (TransactionRouter::get(opCtx)) {
-                        // Note: this returns a bad status if any part of the batch failed.
-                        auto batchStatus = batchedCommandResponse.toStatus();
-                        if (!batchStatus.isOK()) {
-                            batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-                            uassertStatusOK(batchStatus.withContext(
-                                str::stream() << "Encountered error from " << shardHost.toString()
-                                              << " during a transaction"));
-                        }
-                    }
-
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
-
-                    // Note if anything was stale
-                    const auto& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-                    if (!staleErrors.empty()) {
-                        noteStaleResponses(staleErrors, &targeter);
-                        ++stats->numStaleBatches;
-                    }
-
-                    const auto& cannotImplicitlyCreateErrors =
-                        trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
-                    if (!cannotImplicitlyCreateErrors.empty()) {
-                        // This forces the chunk manager to reload so we can attach the correct
-                        // version on retry and make sure we route to the correct shard.
-                        targeter.noteCouldNotTarget();
-                    }
-
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(shardHost,
-                                       batchedCommandResponse.isLastOpSet()
-                                           ? batchedCommandResponse.getLastOp()
-                                           : repl::OpTime(),
-                                       batchedCommandResponse.isElectionIdSet()
-                                           ? batchedCommandResponse.getElectionId()
-                                           : OID());
-                } else {
-                    // Error occurred dispatching, note it
-                    const Status status = responseStatus.withContext(
-                        str::stream() << "Write results unavailable from " << shardHost);
-
-                    batchOp.noteBatchError(*batch, errorFromStatus(status));
-
-                    LOG(4) << "Unable to receive write results from " << shardHost
-                           << causedBy(redact(status));
-                }
+                processBatchResponse(opCtx, targeter, batchOp, *batch, response, stats);
             }
         }
 
@@ -414,6 +414,77 @@ TEST_F(BatchWriteExecTest, TooManyStaleOp) {
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(BatchWriteExecTest, UnorderedMultiShardBatchesArePipelined) {
+    // Add a second shard, which owns the positive half of the key space
+    const HostAndPort kTestShardHost2("FakeHost2", 12345);
+    const std::string shardName2 = "FakeShard2";
+
+    std::unique_ptr<RemoteCommandTargeterMock> targeter(
+        stdx::make_unique<RemoteCommandTargeterMock>());
+    targeter->setConnectionStringReturnValue(ConnectionString(kTestShardHost2));
+    targeter->setFindHostReturnValue(kTestShardHost2);
+    targeterFactory()->addTargeterToReturn(ConnectionString(kTestShardHost2),
+                                           std::move(targeter));
+
+    ShardType shardType1;
+    shardType1.setName(shardName);
+    shardType1.setHost(kTestShardHost.toString());
+    ShardType shardType2;
+    shardType2.setName(shardName2);
+    shardType2.setHost(kTestShardHost2.toString());
+    setupShards({shardType1, shardType2});
+
+    nsTargeter.init(nss,
+                    {MockRange(ShardEndpoint(shardName, ChunkVersion::IGNORED()),
+                               BSON("x" << MINKEY),
+                               BSON("x" << 0)),
+                     MockRange(ShardEndpoint(shardName2, ChunkVersion::IGNORED()),
+                               BSON("x" << 0),
+                               BSON("x" << MAXKEY))});
+
+    // One document for the second shard, followed by more documents for the first shard than fit
+    // in a single batch
+    const std::string kDocValue(1'000'000, 'x');
+
+    std::vector<BSONObj> docsToInsert{BSON("x" << 1)};
+    for (int i = 1; i <= 20; i++) {
+        docsToInsert.push_back(BSON("x" << -i << "someLargeKeyToWasteSpace" << kDocValue));
+    }
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(operationContext(), nsTargeter, request, &response, &stats);
+
+        ASSERT(response.getOk());
+        ASSERT_EQUALS(response.getN(), static_cast<long long>(docsToInsert.size()));
+
+        // The second batch for the first shard did not wait for the second shard to respond
+        ASSERT_EQUALS(stats.numRounds, 1);
+        ASSERT_EQUALS(stats.getTargetedShards().size(), 2U);
+    });
+
+    // The first shard gets its second batch as soon as it responds to the first one, while the
+    // request to the second shard is still outstanding.
+    expectInsertsReturnSuccess(docsToInsert.begin() + 1, docsToInsert.begin() + 17);
+    expectInsertsReturnSuccess(docsToInsert.begin(), docsToInsert.begin() + 1);
+    expectInsertsReturnSuccess(docsToInsert.begin() + 17, docsToInsert.end());
+
+    future.timed_get(kFutureTimeout);
+}
+
 TEST_F(BatchWriteExecTest, RetryableWritesLargeBatch) {
     // A retryable error without a txnNumber is not retried.
 
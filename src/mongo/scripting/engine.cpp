@@ -510,6 +510,9 @@ public:
                bool readOnlyRecv) {
         return _real->invoke(func, args, recv, timeoutMs, ignoreReturn, readOnlyArgs, readOnlyRecv);
     }
+    void runBatch(const stdx::function<void(Scope&)>& work) {
+        _real->runBatch(work);
+    }
     bool exec(StringData code,
               const string& name,
               bool printResult,
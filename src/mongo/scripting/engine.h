@@ -32,6 +32,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 typedef unsigned long long ScriptingFunction;
@@ -133,6 +134,15 @@ public:
         uasserted(9004, std::string("invoke failed: ") + getError());
     }
 
+    /**
+     * Calls 'work' with the scope which runs the JavaScript, as a single request. Scopes which
+     * forward each call to another thread override this, so that all the calls made by 'work'
+     * cost one hand-off to that thread rather than one each.
+     */
+    virtual void runBatch(const stdx::function<void(Scope&)>& work) {
+        work(*this);
+    }
+
     void invokeSafe(const char* code, const BSONObj* args, const BSONObj* recv, int timeoutMs = 0) {
         if (invoke(code, args, recv, timeoutMs) == 0)
             return;
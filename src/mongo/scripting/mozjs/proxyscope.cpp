@@ -215,6 +215,10 @@ int MozJSProxyScope::invoke(ScriptingFunction func,
     return out;
 }
 
+void MozJSProxyScope::runBatch(const stdx::function<void(Scope&)>& work) {
+    run([&] { work(*_implScope); });
+}
+
 bool MozJSProxyScope::exec(StringData code,
                            const std::string& name,
                            bool printResult,
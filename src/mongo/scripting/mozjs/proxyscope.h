@@ -161,6 +161,8 @@ public:
                bool readOnlyArgs = false,
                bool readOnlyRecv = false) override;
 
+    void runBatch(const stdx::function<void(Scope&)>& work) override;
+
     bool exec(StringData code,
               const std::string& name,
               bool printResult,
@@ -32,6 +32,8 @@
 
 #include "mongo/shell/bench.h"
 
+#include <cmath>
+#include <functional>
 #include <pcrecpp.h>
 
 #include "mongo/client/dbclient_cursor.h"
@@ -39,6 +41,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/platform/bits.h"
 #include "mongo/scripting/bson_template_evaluator.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
@@ -321,8 +324,100 @@ Timestamp getAClusterTimeSecondsInThePast(DBClientBase* conn, int numSecondsInTh
     return Timestamp(latestTimestamp.getSecs() - numSecondsInThePast, latestTimestamp.getInc());
 }
 
+/**
+ * Sleeps for "micros" microseconds, or until the worker is told to stop if that is sooner.
+ */
+void sleepUnlessStopped(long long micros, const std::function<bool()>& shouldStop) {
+    const long long kMaxSliceMicros = 100 * 1000;
+    while (micros > 0 && !shouldStop()) {
+        const long long slice = std::min(micros, kMaxSliceMicros);
+        sleepmicros(slice);
+        micros -= slice;
+    }
+}
+
+void appendLatencyPercentiles(BSONObjBuilder* builder,
+                              const std::map<OpType, BenchRunLatencyHistogram>& latencies) {
+    BSONObjBuilder percentilesBuilder(builder->subobjStart("latencyPercentilesMicros"));
+    for (const auto& entry : latencies) {
+        const auto& histogram = entry.second;
+        BSONObjBuilder opBuilder(
+            percentilesBuilder.subobjStart(kOpTypeNames.find(entry.first)->second));
+        opBuilder.append("count", histogram.getCount());
+        opBuilder.append("p50", histogram.getPercentileMicros(50));
+        opBuilder.append("p99", histogram.getPercentileMicros(99));
+        opBuilder.append("p999", histogram.getPercentileMicros(99.9));
+        opBuilder.append("max", histogram.getMaxMicros());
+    }
+}
+
 }  // namespace
 
+int BenchRunLatencyHistogram::_bucketIndex(long long micros) {
+    if (micros < kSubBuckets) {
+        return std::max(micros, 0LL);
+    }
+    const int msb = 63 - countLeadingZeros64(micros);
+    const int shift = msb - kSubBucketBits;
+    const int subBucket = (micros >> shift) & (kSubBuckets - 1);
+    return kSubBuckets + shift * kSubBuckets + subBucket;
+}
+
+long long BenchRunLatencyHistogram::_bucketUpperBound(int index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    const int shift = index / kSubBuckets - 1;
+    const long long subBucket = index % kSubBuckets;
+    return ((kSubBuckets + subBucket + 1) << shift) - 1;
+}
+
+void BenchRunLatencyHistogram::record(long long micros) {
+    if (_buckets.empty()) {
+        _buckets.resize(kNumBuckets);
+    }
+    ++_buckets[_bucketIndex(micros)];
+    ++_count;
+    _maxMicros = std::max(_maxMicros, micros);
+}
+
+void BenchRunLatencyHistogram::updateFrom(const BenchRunLatencyHistogram& other) {
+    if (other._buckets.empty()) {
+        return;
+    }
+    if (_buckets.empty()) {
+        _buckets.resize(kNumBuckets);
+    }
+    for (int i = 0; i < kNumBuckets; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _maxMicros = std::max(_maxMicros, other._maxMicros);
+}
+
+long long BenchRunLatencyHistogram::getPercentileMicros(double percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+    const long long rank =
+        std::max(1LL, static_cast<long long>(std::ceil(percentile / 100 * _count)));
+    long long seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            return std::min(_bucketUpperBound(i), _maxMicros);
+        }
+    }
+    return _maxMicros;
+}
+
+void BenchRunPhaseStats::updateFrom(const BenchRunPhaseStats& other) {
+    opCount += other.opCount;
+    for (const auto& entry : other.latencies) {
+        latencies[entry.first].updateFrom(entry.second);
+    }
+}
+
 BenchRunEventCounter::BenchRunEventCounter() = default;
 
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
@@ -346,6 +441,13 @@ void BenchRunStats::updateFrom(const BenchRunStats& other) {
     for (const auto& trappedError : other.trappedErrors) {
         trappedErrors.push_back(trappedError);
     }
+
+    if (phases.size() < other.phases.size()) {
+        phases.resize(other.phases.size());
+    }
+    for (size_t i = 0; i < other.phases.size(); ++i) {
+        phases[i].updateFrom(other.phases[i]);
+    }
 }
 
 BenchRunConfig::BenchRunConfig() {
@@ -625,9 +727,45 @@ BenchRunOp opFromBson(const BSONObj& op) {
     return myOp;
 }
 
+BenchRunPhase phaseFromBson(const BSONObj& phaseObj) {
+    BenchRunPhase phase;
+    for (auto arg : phaseObj) {
+        auto name = arg.fieldNameStringData();
+        if (name == "seconds") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field 'phases." << name
+                                  << "' should be a positive number, but is "
+                                  << arg,
+                    arg.isNumber() && arg.number() > 0);
+            phase.seconds = arg.number();
+        } else if (name == "opsPerSecond") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field 'phases." << name
+                                  << "' should be a non-negative number, but is "
+                                  << arg,
+                    arg.isNumber() && arg.number() >= 0);
+            phase.opsPerSecond = arg.number();
+        } else if (name == "ops") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field 'phases." << name << "' should be an array. Type is "
+                                  << typeName(arg.type()),
+                    arg.type() == Array);
+            for (auto&& opElem : arg.Obj()) {
+                phase.ops.push_back(opFromBson(opElem.Obj()));
+            }
+        } else {
+            uasserted(ErrorCodes::BadValue,
+                      str::stream() << "benchRun phase has an unsupported field: " << name);
+        }
+    }
+    uassert(ErrorCodes::BadValue, "benchRun phases require a 'seconds' field", phase.seconds > 0);
+    return phase;
+}
+
 void BenchRunConfig::initializeFromBson(const BSONObj& args) {
     initializeToDefaults();
 
+    bool hasSeconds = false;
     for (auto arg : args) {
         auto name = arg.fieldNameStringData();
         if (name == "host") {
@@ -672,6 +810,25 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             seconds = arg.number();
+            hasSeconds = true;
+        } else if (name == "opsPerSecond") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name
+                                  << "' should be a non-negative number, but is "
+                                  << arg,
+                    arg.isNumber() && arg.number() >= 0);
+            opsPerSecond = arg.number();
+        } else if (name == "phases") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' should be an array. Type is "
+                                  << typeName(arg.type()),
+                    arg.type() == Array);
+            for (auto&& phaseElem : arg.Obj()) {
+                uassert(ErrorCodes::BadValue,
+                        str::stream() << "Elements of '" << name << "' should be objects",
+                        phaseElem.type() == Object);
+                phases.push_back(phaseFromBson(phaseElem.Obj()));
+            }
         } else if (name == "useSessions") {
             uassert(40641,
                     str::stream() << "Field '" << name << "' should be a boolean. . Type is "
@@ -739,6 +896,14 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
             uassert(34376, "benchRun passed an unsupported configuration field", false);
         }
     }
+
+    // By default, a phased activity runs through all of its phases once.
+    if (!phases.empty() && !hasSeconds) {
+        seconds = 0;
+        for (const auto& phase : phases) {
+            seconds += phase.seconds;
+        }
+    }
 }
 
 MONGO_DEFINE_SHIM(BenchRunConfig::createConnectionImpl);
@@ -880,6 +1045,11 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
 
     BenchRunOp::State opState(&_rng, &bsonTemplateEvaluator, &_statsBlackHole);
 
+    // The phase being run, when it started on 'timer', and how many operations it has started.
+    size_t phase = 0;
+    long long phaseStartMicros = 0;
+    long long phaseOpsStarted = 0;
+
     ON_BLOCK_EXIT([&] {
         // Executing the transaction with a new txnNumber would end the previous transaction
         // automatically, but we have to end the last transaction manually with an abort command.
@@ -889,14 +1059,51 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
     });
 
     while (!shouldStop()) {
-        for (const auto& op : _config->ops) {
+        const BenchRunPhase* phaseConfig =
+            _config->phases.empty() ? nullptr : &_config->phases[phase];
+        const auto& ops =
+            (phaseConfig && !phaseConfig->ops.empty()) ? phaseConfig->ops : _config->ops;
+        const double opsPerSecond =
+            (phaseConfig ? phaseConfig->opsPerSecond : _config->opsPerSecond) / _config->parallel;
+
+        for (const auto& op : ops) {
             if (shouldStop())
                 break;
 
+            // Move on to the next phase once this one has run for its duration. The last phase
+            // runs until the worker is stopped.
+            if (phaseConfig && phase + 1 < _config->phases.size()) {
+                const long long phaseMicros = phaseConfig->seconds * 1000 * 1000;
+                if (timer.micros() - phaseStartMicros >= phaseMicros) {
+                    ++phase;
+                    phaseStartMicros += phaseMicros;
+                    phaseOpsStarted = 0;
+                    break;
+                }
+            }
+
             opState.stats = shouldCollectStats() ? &_stats : &_statsBlackHole;
 
+            // With a target rate, start the operation at its scheduled time, or right away if that
+            // has passed, and measure its latency from the scheduled time.
+            long long startMicros = timer.micros();
+            if (opsPerSecond > 0) {
+                const long long scheduledMicros = phaseStartMicros +
+                    static_cast<long long>(phaseOpsStarted * 1000 * 1000 / opsPerSecond);
+                sleepUnlessStopped(scheduledMicros - startMicros, [this] { return shouldStop(); });
+                startMicros = scheduledMicros;
+            }
+            ++phaseOpsStarted;
+
             try {
                 op.executeOnce(conn, lsid, *_config, &opState);
+
+                auto& phaseStats = opState.stats->phases;
+                if (phaseStats.size() <= phase) {
+                    phaseStats.resize(phase + 1);
+                }
+                ++phaseStats[phase].opCount;
+                phaseStats[phase].latencies[op.op].record(timer.micros() - startMicros);
             } catch (const DBException& ex) {
                 if (!_config->hideErrors || op.showError) {
                     bool yesWatch =
@@ -1492,6 +1699,31 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     buf.append("queries", stats.queryCounter.getNumEvents());
     buf.append("commands", stats.commandCounter.getNumEvents());
 
+    BenchRunPhaseStats allPhases;
+    for (const auto& phaseStats : stats.phases) {
+        allPhases.updateFrom(phaseStats);
+    }
+    appendLatencyPercentiles(&buf, allPhases.latencies);
+
+    const auto& phases = runner->config().phases;
+    if (!phases.empty()) {
+        BSONArrayBuilder phasesBuilder(buf.subarrayStart("phases"));
+        double secondsLeft = runner->_microsElapsed / 1000000.0;
+        for (size_t i = 0; i < phases.size() && secondsLeft > 0; ++i) {
+            const double seconds =
+                i + 1 < phases.size() ? std::min(phases[i].seconds, secondsLeft) : secondsLeft;
+            secondsLeft -= seconds;
+
+            const BenchRunPhaseStats phaseStats =
+                i < stats.phases.size() ? stats.phases[i] : BenchRunPhaseStats();
+            BSONObjBuilder phaseBuilder(phasesBuilder.subobjStart());
+            phaseBuilder.append("opsPerSecond", phases[i].opsPerSecond);
+            phaseBuilder.append("totalOps", static_cast<long long>(phaseStats.opCount));
+            phaseBuilder.append("totalOps/s", phaseStats.opCount / seconds);
+            appendLatencyPercentiles(&phaseBuilder, phaseStats.latencies);
+        }
+    }
+
     BSONObj zoo = buf.obj();
 
     delete runner;
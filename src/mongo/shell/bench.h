@@ -29,7 +29,9 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "mongo/base/shim.h"
 #include "mongo/client/dbclient_base.h"
@@ -141,6 +143,27 @@ struct BenchRunOp {
     BSONObj myBsonOp;
 };
 
+/**
+ * One phase of a bench run activity, run for a fixed duration before moving on to the next phase.
+ */
+struct BenchRunPhase {
+    /**
+     * Duration of the phase, in seconds. The last phase runs until the activity is stopped.
+     */
+    double seconds = 0;
+
+    /**
+     * Target rate of operations for all threads together, or 0 to run each thread's operations
+     * back to back.
+     */
+    double opsPerSecond = 0;
+
+    /**
+     * Operations of the phase. If empty, the operations of the configuration are run.
+     */
+    std::vector<BenchRunOp> ops;
+};
+
 /**
  * Configuration object describing a bench run activity.
  */
@@ -200,6 +223,23 @@ public:
      */
     double seconds;
 
+    /**
+     * Target rate of operations for all threads together, or 0 to run each thread's operations
+     * back to back.
+     *
+     * With a target rate, each thread runs open-loop: it starts its operations on a fixed
+     * schedule rather than when its previous operation finishes, and their latencies are measured
+     * from the scheduled start. Time an operation spends waiting behind a slow one is therefore
+     * counted, instead of being omitted as it is when threads wait for each operation.
+     */
+    double opsPerSecond{0};
+
+    /**
+     * Phases of the activity, run in order by every thread. If empty, the whole activity is a
+     * single phase using 'opsPerSecond' and 'ops'.
+     */
+    std::vector<BenchRunPhase> phases;
+
     /**
      * Whether the individual benchRun thread connections should be creating and using sessions.
      */
@@ -299,6 +339,55 @@ private:
     long long _numEvents{0};
 };
 
+/**
+ * A histogram of latencies, from which percentiles can be reported to within about 3% of their
+ * exact values, in the style of HdrHistogram.
+ *
+ * Latencies below 32 microseconds are counted exactly. Above that, each power of two is split in
+ * 32 buckets of equal width.
+ *
+ * Not thread safe. Expected use is one instance per thread during parallel execution.
+ */
+class BenchRunLatencyHistogram {
+public:
+    /**
+     * Count one event which took "micros" microseconds.
+     */
+    void record(long long micros);
+
+    /**
+     * Conceptually the equivalent of "+=". Adds "other" into this.
+     */
+    void updateFrom(const BenchRunLatencyHistogram& other);
+
+    /**
+     * Get the latency in microseconds that "percentile" percent of the events took at most, or 0
+     * if there were no events.
+     */
+    long long getPercentileMicros(double percentile) const;
+
+    long long getCount() const {
+        return _count;
+    }
+
+    long long getMaxMicros() const {
+        return _maxMicros;
+    }
+
+private:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kNumBuckets = kSubBuckets * (64 - kSubBucketBits);
+
+    static int _bucketIndex(long long micros);
+    static long long _bucketUpperBound(int index);
+
+    // Allocated on the first event, so that histograms of unused op types stay small.
+    std::vector<long long> _buckets;
+    long long _count{0};
+    long long _maxMicros{0};
+};
+
 /**
  * RAII object for tracing an event.
  *
@@ -352,6 +441,19 @@ private:
     bool _succeeded;
 };
 
+/**
+ * Statistics of one phase of a bench run activity.
+ */
+struct BenchRunPhaseStats {
+    void updateFrom(const BenchRunPhaseStats& other);
+
+    unsigned long long opCount{0};
+
+    // Latencies of the successful operations, by op type. They include the time an operation
+    // waited past its scheduled start, if the phase has a target rate.
+    std::map<OpType, BenchRunLatencyHistogram> latencies;
+};
+
 /**
  * Statistics object representing the result of a bench run activity.
  */
@@ -372,6 +474,9 @@ struct BenchRunStats {
 
     std::map<std::string, long long> opcounters;
     std::vector<BSONObj> trappedErrors;
+
+    // One entry per phase reached, or a single entry if the activity has no phases.
+    std::vector<BenchRunPhaseStats> phases;
 };
 
 /**
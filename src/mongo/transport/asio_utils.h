@@ -31,6 +31,7 @@
 #include "mongo/base/status.h"
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
+#include "mongo/rpc/message.h"
 #include "mongo/util/errno_util.h"
 #include "mongo/util/future.h"
 #include "mongo/util/net/hostandport.h"
@@ -318,6 +319,70 @@ boost::optional<std::array<std::uint8_t, 7>> checkTLSRequest(const Buffer& buffe
 }
 #endif
 
+/**
+ * A ConstBufferSequence over the head and slices of a scatter-gather Message, so that it can be
+ * sent with a single writev()/sendmsg() rather than being copied into one buffer first. Like a
+ * single asio::const_buffer, it can be advanced past the bytes which have already been written.
+ *
+ * This does not keep the message alive.
+ */
+class MessageConstBuffers {
+public:
+    using value_type = asio::const_buffer;
+    using const_iterator = std::vector<asio::const_buffer>::const_iterator;
+
+    explicit MessageConstBuffers(const Message& message) : _remaining(message.size()) {
+        _buffers.reserve(message.slices().size() + 1);
+        _buffers.emplace_back(message.headBuf(), message.headSize());
+        for (const auto& slice : message.slices()) {
+            _buffers.emplace_back(slice.data, slice.size);
+        }
+    }
+
+    const_iterator begin() const {
+        return _buffers.begin() + _first;
+    }
+
+    const_iterator end() const {
+        return _buffers.end();
+    }
+
+    /**
+     * The number of bytes left to write.
+     */
+    size_t size() const {
+        return _remaining;
+    }
+
+    const void* data() const {
+        return (_first < _buffers.size()) ? _buffers[_first].data() : nullptr;
+    }
+
+    operator asio::const_buffer() const {
+        return (_first < _buffers.size()) ? _buffers[_first] : asio::const_buffer();
+    }
+
+    MessageConstBuffers& operator+=(size_t bytes) {
+        invariant(bytes <= _remaining);
+        _remaining -= bytes;
+        while (bytes > 0) {
+            auto& buffer = _buffers[_first];
+            if (bytes < buffer.size()) {
+                buffer += bytes;
+                break;
+            }
+            bytes -= buffer.size();
+            ++_first;
+        }
+        return *this;
+    }
+
+private:
+    std::vector<asio::const_buffer> _buffers;
+    size_t _first = 0;
+    size_t _remaining;
+};
+
 /**
  * Pass this to asio functions in place of a callback to have them return a Future<T>. This behaves
  * similarly to asio::use_future_t, however it returns a mongo::Future<T> rather than a
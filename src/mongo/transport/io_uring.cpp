@@ -0,0 +1,289 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/io_uring.h"
+
+#include <cerrno>
+#include <csignal>
+#include <algorithm>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return ::syscall(__NR_io_uring_setup, entries, params);
+}
+
+int ioUringEnter(int fd,
+                 unsigned toSubmit,
+                 unsigned minComplete,
+                 unsigned flags,
+                 const void* arg,
+                 size_t argSize) {
+    return ::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize);
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned numArgs) {
+    return ::syscall(__NR_io_uring_register, fd, opcode, arg, numArgs);
+}
+
+}  // namespace
+
+IoUring::~IoUring() {
+    if (_sq.sqes) {
+        ::munmap(_sq.sqes, _sq.sqesSize);
+    }
+    if (_cq.ring && _cq.ring != _sq.ring) {
+        ::munmap(_cq.ring, _cq.ringSize);
+    }
+    if (_sq.ring) {
+        ::munmap(_sq.ring, _sq.ringSize);
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+int IoUring::init(unsigned entries) {
+    invariant(_fd < 0);
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    _fd = ioUringSetup(entries, &params);
+    if (_fd < 0) {
+        return -errno;
+    }
+
+    // We rely on a single mapping for both rings, on waiting with a timeout without having to
+    // submit a timeout entry, and on the kernel never dropping completions.
+    constexpr unsigned kRequiredFeatures =
+        IORING_FEAT_SINGLE_MMAP | IORING_FEAT_EXT_ARG | IORING_FEAT_NODROP;
+    if ((params.features & kRequiredFeatures) != kRequiredFeatures) {
+        return -EOPNOTSUPP;
+    }
+
+    _sq.ringSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq.ringSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    _sq.ringSize = std::max(_sq.ringSize, _cq.ringSize);
+
+    void* ring = ::mmap(nullptr,
+                        _sq.ringSize,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE,
+                        _fd,
+                        IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED) {
+        return -errno;
+    }
+    _sq.ring = ring;
+    _cq.ring = ring;
+    _cq.ringSize = _sq.ringSize;
+
+    _sq.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr,
+                        _sq.sqesSize,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE,
+                        _fd,
+                        IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return -errno;
+    }
+    _sq.sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* base = static_cast<char*>(ring);
+    _sq.head = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+    _sq.tail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    _sq.ringMask = reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    _sq.ringEntries = reinterpret_cast<unsigned*>(base + params.sq_off.ring_entries);
+    _sq.array = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    _sq.localTail = *_sq.tail;
+
+    _cq.head = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    _cq.tail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    _cq.ringMask = reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    _cq.cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+
+    // Submission entries are always used in ring order, so the indirection array is the identity.
+    for (unsigned i = 0; i < params.sq_entries; ++i) {
+        _sq.array[i] = i;
+    }
+
+    return 0;
+}
+
+int IoUring::registerBuffers(const std::vector<iovec>& buffers) {
+    if (ioUringRegister(_fd, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) < 0) {
+        return -errno;
+    }
+    return 0;
+}
+
+io_uring_sqe* IoUring::_getSqe(uint8_t opcode, int fd, uint64_t userData) {
+    const unsigned head = __atomic_load_n(_sq.head, __ATOMIC_ACQUIRE);
+    if (_sq.localTail - head >= *_sq.ringEntries) {
+        return nullptr;
+    }
+
+    io_uring_sqe* sqe = &_sq.sqes[_sq.localTail & *_sq.ringMask];
+    ++_sq.localTail;
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->user_data = userData;
+    return sqe;
+}
+
+bool IoUring::prepRecv(int fd, void* buf, size_t len, uint64_t userData) {
+    auto sqe = _getSqe(IORING_OP_RECV, fd, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    return true;
+}
+
+bool IoUring::prepReadFixed(int fd, void* buf, size_t len, int bufIndex, uint64_t userData) {
+    auto sqe = _getSqe(IORING_OP_READ_FIXED, fd, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    sqe->buf_index = bufIndex;
+    return true;
+}
+
+bool IoUring::prepSend(int fd, const void* buf, size_t len, uint64_t userData) {
+    auto sqe = _getSqe(IORING_OP_SEND, fd, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    return true;
+}
+
+bool IoUring::prepAccept(int fd, uint64_t userData) {
+    auto sqe = _getSqe(IORING_OP_ACCEPT, fd, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->accept_flags = SOCK_CLOEXEC;
+    return true;
+}
+
+bool IoUring::prepRead(int fd, void* buf, size_t len, uint64_t userData) {
+    auto sqe = _getSqe(IORING_OP_READ, fd, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    return true;
+}
+
+bool IoUring::prepTimeout(const __kernel_timespec* ts, uint64_t userData) {
+    auto sqe = _getSqe(IORING_OP_TIMEOUT, -1, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->addr = reinterpret_cast<uint64_t>(ts);
+    sqe->len = 1;
+    sqe->timeout_flags = IORING_TIMEOUT_ABS | IORING_TIMEOUT_REALTIME;
+    return true;
+}
+
+bool IoUring::prepTimeoutRemove(uint64_t targetUserData, uint64_t userData) {
+    auto sqe = _getSqe(IORING_OP_TIMEOUT_REMOVE, -1, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->addr = targetUserData;
+    return true;
+}
+
+bool IoUring::prepCancel(uint64_t targetUserData, uint64_t userData) {
+    auto sqe = _getSqe(IORING_OP_ASYNC_CANCEL, -1, userData);
+    if (!sqe) {
+        return false;
+    }
+    sqe->addr = targetUserData;
+    return true;
+}
+
+unsigned IoUring::flush() {
+    __atomic_store_n(_sq.tail, _sq.localTail, __ATOMIC_RELEASE);
+    return _sq.localTail - __atomic_load_n(_sq.head, __ATOMIC_ACQUIRE);
+}
+
+int IoUring::enter(unsigned toSubmit, unsigned minComplete, Milliseconds timeout) {
+    unsigned flags = 0;
+    __kernel_timespec ts;
+    io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+
+    if (minComplete) {
+        flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        arg.sigmask_sz = _NSIG / 8;
+        if (timeout >= Milliseconds(0)) {
+            ts.tv_sec = durationCount<Seconds>(timeout);
+            ts.tv_nsec = durationCount<Nanoseconds>(timeout - Seconds(ts.tv_sec));
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+    }
+
+    for (;;) {
+        const int ret = ioUringEnter(_fd, toSubmit, minComplete, flags, &arg, sizeof(arg));
+        if (ret >= 0) {
+            return ret;
+        }
+        if (errno == EINTR) {
+            // Entries are only consumed once, so a signal can't have interrupted a submission.
+            continue;
+        }
+        return -errno;
+    }
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A thin wrapper around a Linux io_uring instance, built directly on top of the io_uring_setup,
+ * io_uring_enter and io_uring_register system calls.
+ *
+ * Prepared submissions are only handed to the kernel by flush() and enter(), so any number of
+ * them can be submitted with a single system call. Every submission
+ * carries a caller supplied 64-bit value which is returned with its completion.
+ *
+ * This class does no locking: callers must serialize preparing and flushing submissions against
+ * each other, and reaping completions against each other. Reaping may race with submitting.
+ *
+ * As with the underlying system calls, methods which can fail return a negative errno value.
+ */
+class IoUring {
+    MONGO_DISALLOW_COPYING(IoUring);
+
+public:
+    IoUring() = default;
+    ~IoUring();
+
+    /**
+     * Creates the ring with room for at least 'entries' submissions. Fails with -ENOSYS if the
+     * kernel does not support io_uring, or with -EOPNOTSUPP if it lacks the features we rely on.
+     */
+    int init(unsigned entries);
+
+    /**
+     * Registers 'buffers' with the kernel, so that they can be read into with prepReadFixed().
+     */
+    int registerBuffers(const std::vector<iovec>& buffers);
+
+    /**
+     * The prep functions fill in the next free submission entry, and return false if the
+     * submission queue is full, in which case the caller should flush() and enter() and retry.
+     */
+    bool prepRecv(int fd, void* buf, size_t len, uint64_t userData);
+    bool prepReadFixed(int fd, void* buf, size_t len, int bufIndex, uint64_t userData);
+    bool prepSend(int fd, const void* buf, size_t len, uint64_t userData);
+    bool prepAccept(int fd, uint64_t userData);
+    bool prepRead(int fd, void* buf, size_t len, uint64_t userData);
+    bool prepTimeout(const __kernel_timespec* ts, uint64_t userData);
+    bool prepTimeoutRemove(uint64_t targetUserData, uint64_t userData);
+    bool prepCancel(uint64_t targetUserData, uint64_t userData);
+
+    /**
+     * Makes every prepared entry visible to the kernel and returns how many entries the kernel has
+     * not consumed yet. Must be serialized with the prep functions.
+     */
+    unsigned flush();
+
+    /**
+     * Asks the kernel to consume up to 'toSubmit' flushed entries and, if 'minComplete' is not
+     * zero, waits until that many completions are available or 'timeout' elapses, in which case
+     * it returns -ETIME. A negative timeout waits forever. Returns the number of entries consumed.
+     *
+     * Unlike the rest of this class, this may be called concurrently with any other method.
+     */
+    int enter(unsigned toSubmit, unsigned minComplete, Milliseconds timeout);
+
+    /**
+     * Calls 'cb(userData, result)' for every available completion and returns how many there
+     * were. The completion queue is released before the callbacks run, so they may prepare and
+     * submit new entries.
+     */
+    template <typename Callback>
+    size_t reapCompletions(Callback&& cb) {
+        _completions.clear();
+        unsigned head = *_cq.head;
+        const unsigned tail = __atomic_load_n(_cq.tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = _cq.cqes[head & *_cq.ringMask];
+            _completions.push_back({cqe.user_data, cqe.res});
+        }
+        __atomic_store_n(_cq.head, head, __ATOMIC_RELEASE);
+
+        for (const auto& completion : _completions) {
+            cb(completion.userData, completion.result);
+        }
+        return _completions.size();
+    }
+
+private:
+    struct SubmissionQueue {
+        unsigned* head = nullptr;
+        unsigned* tail = nullptr;
+        unsigned* ringMask = nullptr;
+        unsigned* ringEntries = nullptr;
+        unsigned* array = nullptr;
+        io_uring_sqe* sqes = nullptr;
+        void* ring = nullptr;
+        size_t ringSize = 0;
+        size_t sqesSize = 0;
+
+        // Our copy of the tail, which is published to the kernel by flush().
+        unsigned localTail = 0;
+    };
+
+    struct CompletionQueue {
+        unsigned* head = nullptr;
+        unsigned* tail = nullptr;
+        unsigned* ringMask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+        void* ring = nullptr;
+        size_t ringSize = 0;
+    };
+
+    struct Completion {
+        uint64_t userData;
+        int result;
+    };
+
+    io_uring_sqe* _getSqe(uint8_t opcode, int fd, uint64_t userData);
+
+    int _fd = -1;
+    SubmissionQueue _sq;
+    CompletionQueue _cq;
+    std::vector<Completion> _completions;
+};
+
+}  // namespace transport
+}  // namespace mongo
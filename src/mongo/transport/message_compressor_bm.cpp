@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_manager.h"
+#include "mongo/transport/message_compressor_noop.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/transport/message_compressor_snappy.h"
+#include "mongo/transport/message_compressor_zlib.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A manager that has negotiated a single compressor, as a server would for a client that only
+ * offered that one.
+ */
+class CompressionFixture {
+public:
+    explicit CompressionFixture(std::unique_ptr<MessageCompressorBase> compressor) {
+        const auto name = compressor->getName();
+        _registry.setSupportedCompressors({name});
+        _registry.registerImplementation(std::move(compressor));
+        uassertStatusOK(_registry.finalizeSupportedCompressors());
+
+        BSONObjBuilder negotiated;
+        _manager.serverNegotiate(BSON("isMaster" << 1 << "compression" << BSON_ARRAY(name)),
+                                 &negotiated);
+    }
+
+    MessageCompressorManager& manager() {
+        return _manager;
+    }
+
+private:
+    MessageCompressorRegistry _registry;
+    MessageCompressorManager _manager{&_registry};
+};
+
+/**
+ * A reply of about 'bytes' bytes of repetitive documents, which compresses like a real batch.
+ */
+Message makeReply(int64_t bytes) {
+    BSONObjBuilder body;
+    {
+        BSONObjBuilder cursor(body.subobjStart("cursor"));
+        BSONArrayBuilder batch(cursor.subarrayStart("firstBatch"));
+        for (int i = 0; batch.len() < bytes; ++i) {
+            batch.append(BSON("_id" << i << "name"
+                                    << "document"
+                                    << "value"
+                                    << i * 7));
+        }
+    }
+    body.append("ok", 1.0);
+    return OpMsgRequest::fromDBAndBody("test", body.obj()).serialize();
+}
+
+template <typename Compressor>
+void BM_Compress(benchmark::State& state) {
+    CompressionFixture fixture(stdx::make_unique<Compressor>());
+    const auto message = makeReply(state.range(0));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(fixture.manager().compressMessage(message));
+    }
+    state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+template <typename Compressor>
+void BM_Decompress(benchmark::State& state) {
+    CompressionFixture fixture(stdx::make_unique<Compressor>());
+    const auto message = makeReply(state.range(0));
+    const auto compressed = uassertStatusOK(fixture.manager().compressMessage(message));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(fixture.manager().decompressMessage(compressed));
+    }
+    state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+#define COMPRESSION_BENCHMARK(fn, compressor) \
+    BENCHMARK_TEMPLATE(fn, compressor)        \
+        ->ArgName("bytes")                    \
+        ->Arg(1024)                           \
+        ->Arg(64 * 1024)                      \
+        ->Arg(1024 * 1024)
+
+COMPRESSION_BENCHMARK(BM_Compress, NoopMessageCompressor);
+COMPRESSION_BENCHMARK(BM_Compress, SnappyMessageCompressor);
+COMPRESSION_BENCHMARK(BM_Compress, ZlibMessageCompressor);
+COMPRESSION_BENCHMARK(BM_Decompress, NoopMessageCompressor);
+COMPRESSION_BENCHMARK(BM_Decompress, SnappyMessageCompressor);
+COMPRESSION_BENCHMARK(BM_Decompress, ZlibMessageCompressor);
+
+}  // namespace
+}  // namespace mongo
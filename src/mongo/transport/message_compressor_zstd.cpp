@@ -0,0 +1,204 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+#include <zstd.h>
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(zstdMessageCompressionLevel, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > ZSTD_maxCLevel()) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "zstdMessageCompressionLevel must be between 1 and "
+                                        << ZSTD_maxCLevel());
+        }
+        return Status::OK();
+    });
+
+// Path of a dictionary, trained with 'zstd --train' on samples of typical messages, which enables
+// the "zstd_dict" compressor.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(zstdMessageCompressionDictionaryPath, std::string, "");
+
+namespace {
+
+struct CCtxDeleter {
+    void operator()(ZSTD_CCtx* cctx) const {
+        ZSTD_freeCCtx(cctx);
+    }
+};
+
+struct DCtxDeleter {
+    void operator()(ZSTD_DCtx* dctx) const {
+        ZSTD_freeDCtx(dctx);
+    }
+};
+
+}  // namespace
+
+void ZstdMessageCompressor::CDictDeleter::operator()(ZSTD_CDict_s* cdict) const {
+    ZSTD_freeCDict(cdict);
+}
+
+void ZstdMessageCompressor::DDictDeleter::operator()(ZSTD_DDict_s* ddict) const {
+    ZSTD_freeDDict(ddict);
+}
+
+ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
+
+ZstdMessageCompressor::ZstdMessageCompressor(const std::string& dictionary, int compressionLevel)
+    : MessageCompressorBase(MessageCompressor::kZstdDict),
+      _cdict(ZSTD_createCDict(dictionary.data(), dictionary.size(), compressionLevel)),
+      _ddict(ZSTD_createDDict(dictionary.data(), dictionary.size())) {
+    invariant(_cdict && _ddict);
+}
+
+ZstdMessageCompressor::~ZstdMessageCompressor() = default;
+
+std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    std::unique_ptr<ZSTD_CCtx, CCtxDeleter> cctx(ZSTD_createCCtx());
+    if (!cctx) {
+        return Status{ErrorCodes::ExceededMemoryLimit, "Could not allocate zstd context"};
+    }
+
+    void* const dst = const_cast<char*>(output.data());
+    const size_t ret = _cdict
+        ? ZSTD_compress_usingCDict(
+              cctx.get(), dst, output.length(), input.data(), input.length(), _cdict.get())
+        : ZSTD_compressCCtx(cctx.get(),
+                            dst,
+                            output.length(),
+                            input.data(),
+                            input.length(),
+                            zstdMessageCompressionLevel.load());
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    const auto expectedLength = ZSTD_getFrameContentSize(input.data(), input.length());
+    if (expectedLength == ZSTD_CONTENTSIZE_UNKNOWN || expectedLength == ZSTD_CONTENTSIZE_ERROR ||
+        expectedLength != output.length()) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    // A frame which references a dictionary can only be decompressed with that same dictionary.
+    const auto frameDictId = ZSTD_getDictID_fromFrame(input.data(), input.length());
+    if (frameDictId != 0 && (!_ddict || frameDictId != ZSTD_getDictID_fromDDict(_ddict.get()))) {
+        return Status{ErrorCodes::BadValue,
+                      "Compressed message references a zstd dictionary which was not loaded"};
+    }
+
+    std::unique_ptr<ZSTD_DCtx, DCtxDeleter> dctx(ZSTD_createDCtx());
+    if (!dctx) {
+        return Status{ErrorCodes::ExceededMemoryLimit, "Could not allocate zstd context"};
+    }
+
+    void* const dst = const_cast<char*>(output.data());
+    const size_t ret = _ddict
+        ? ZSTD_decompress_usingDDict(
+              dctx.get(), dst, output.length(), input.data(), input.length(), _ddict.get())
+        : ZSTD_decompressDCtx(dctx.get(), dst, output.length(), input.data(), input.length());
+
+    if (ZSTD_isError(ret) || ret != output.length()) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    counterHitDecompress(input.length(), output.length());
+    return output.length();
+}
+
+
+MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    compressorRegistry.registerImplementation(stdx::make_unique<ZstdMessageCompressor>());
+
+    // Without a dictionary "zstd_dict" is left unregistered, so that requesting it fails the
+    // compressor configuration check.
+    if (zstdMessageCompressionDictionaryPath.empty()) {
+        return Status::OK();
+    }
+
+    std::ifstream dictionaryFile(zstdMessageCompressionDictionaryPath,
+                                 std::ios::in | std::ios::binary);
+    if (!dictionaryFile.is_open()) {
+        return {ErrorCodes::FileNotOpen,
+                str::stream() << "Could not open zstd message compression dictionary "
+                              << zstdMessageCompressionDictionaryPath};
+    }
+
+    const std::string dictionary((std::istreambuf_iterator<char>(dictionaryFile)),
+                                 std::istreambuf_iterator<char>());
+    if (dictionaryFile.bad()) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Could not read zstd message compression dictionary "
+                              << zstdMessageCompressionDictionaryPath};
+    }
+    if (dictionary.empty()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "zstd message compression dictionary "
+                              << zstdMessageCompressionDictionaryPath << " is empty"};
+    }
+
+    log() << "Loaded " << dictionary.size() << " byte zstd message compression dictionary from "
+          << zstdMessageCompressionDictionaryPath;
+    compressorRegistry.registerImplementation(stdx::make_unique<ZstdMessageCompressor>(
+        dictionary, zstdMessageCompressionLevel.load()));
+    return Status::OK();
+}
+}  // namespace mongo
@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/transport/message_compressor_base.h"
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace mongo {
+
+// Compression level used by the "zstd" compressor, and by the "zstd_dict" compressor when its
+// dictionary is loaded at startup.
+extern AtomicInt32 zstdMessageCompressionLevel;
+
+/**
+ * Compresses messages with zstd. When constructed with a dictionary, this registers as the
+ * "zstd_dict" compressor instead, and uses the dictionary to compress every message, which helps
+ * most on small messages whose content is similar to that of the samples the dictionary was
+ * trained on. Both ends of a connection must load the same dictionary to negotiate "zstd_dict".
+ */
+class ZstdMessageCompressor final : public MessageCompressorBase {
+public:
+    ZstdMessageCompressor();
+    ZstdMessageCompressor(const std::string& dictionary, int compressionLevel);
+    ~ZstdMessageCompressor();
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+private:
+    struct CDictDeleter {
+        void operator()(ZSTD_CDict_s* cdict) const;
+    };
+
+    struct DDictDeleter {
+        void operator()(ZSTD_DDict_s* ddict) const;
+    };
+
+    std::unique_ptr<ZSTD_CDict_s, CDictDeleter> _cdict;
+    std::unique_ptr<ZSTD_DDict_s, DDictDeleter> _ddict;
+};
+
+
+}  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/rpc/message.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_manager.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/unittest/unittest.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace mongo {
+namespace {
+
+const std::string kDictionary =
+    "{ insert: \"coll\", ordered: true, lsid: { id: UUID }, $clusterTime: { clusterTime: "
+    "Timestamp, signature: { hash: BinData, keyId: NumberLong } }, $db: \"test\" }";
+
+Message buildMessage(const std::string& data) {
+    const auto bufferSize = MsgData::MsgDataHeaderSize + data.size();
+    auto buf = SharedBuffer::allocate(bufferSize);
+    MsgData::View testView(buf.get());
+    testView.setId(123456);
+    testView.setResponseToMsgId(654321);
+    testView.setOperation(dbMsg);
+    testView.setLen(bufferSize);
+    memcpy(testView.data(), data.data(), data.size());
+    return Message{buf};
+}
+
+/**
+ * Round trips 'msg' through a MessageCompressorManager which negotiated 'compressor' and returns
+ * the length of the compressed message.
+ */
+int checkFidelity(const Message& msg, std::unique_ptr<MessageCompressorBase> compressor) {
+    MessageCompressorRegistry registry;
+    const auto originalView = msg.singleData();
+    const auto compressorName = compressor->getName();
+
+    registry.setSupportedCompressors({compressorName});
+    registry.registerImplementation(std::move(compressor));
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+
+    MessageCompressorManager mgr(&registry);
+    BSONObjBuilder negotiatorOut;
+    mgr.serverNegotiate(BSON("isMaster" << 1 << "compression" << BSON_ARRAY(compressorName)),
+                        &negotiatorOut);
+
+    auto swm = mgr.compressMessage(msg);
+    ASSERT_OK(swm.getStatus());
+    auto compressedMsg = std::move(swm.getValue());
+    ASSERT_EQ(compressedMsg.singleData().getNetworkOp(), dbCompressed);
+    const int compressedLen = compressedMsg.singleData().getLen();
+
+    swm = mgr.decompressMessage(compressedMsg);
+    ASSERT_OK(swm.getStatus());
+    const auto decompressedMsgView = swm.getValue().singleData();
+    ASSERT_EQ(decompressedMsgView.getId(), originalView.getId());
+    ASSERT_EQ(decompressedMsgView.getNetworkOp(), originalView.getNetworkOp());
+    ASSERT_EQ(decompressedMsgView.getLen(), originalView.getLen());
+    ASSERT_EQ(memcmp(decompressedMsgView.data(), originalView.data(), originalView.dataLen()), 0);
+
+    return compressedLen;
+}
+
+void checkOverflow(std::unique_ptr<MessageCompressorBase> compressor) {
+    const std::string data = kDictionary + kDictionary;
+    ConstDataRange input(data.data(), data.size());
+
+    std::array<char, 16> smallBuffer;
+    DataRange smallOutput(smallBuffer.data(), smallBuffer.size());
+
+    std::vector<char> normalBuffer(compressor->getMaxCompressedSize(data.size()));
+    auto sws = compressor->compressData(input, DataRange(normalBuffer.data(), normalBuffer.size()));
+    ASSERT_OK(sws);
+    ConstDataRange normalRange(normalBuffer.data(), sws.getValue());
+
+    ASSERT_NOT_OK(compressor->compressData(input, smallOutput));
+    ASSERT_NOT_OK(compressor->decompressData(normalRange, smallOutput));
+
+    // Decompressing a truncated frame must fail rather than read past the end of the input.
+    std::vector<char> scratch(data.size());
+    ConstDataRange truncatedRange(normalBuffer.data(), sws.getValue() / 2);
+    ASSERT_NOT_OK(
+        compressor->decompressData(truncatedRange, DataRange(scratch.data(), scratch.size())));
+}
+
+TEST(ZstdMessageCompressor, Fidelity) {
+    checkFidelity(buildMessage("Hello, world!"), stdx::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdMessageCompressor, Overflow) {
+    checkOverflow(stdx::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdMessageCompressor, DictionaryFidelity) {
+    checkFidelity(buildMessage("Hello, world!"),
+                  stdx::make_unique<ZstdMessageCompressor>(kDictionary, 3));
+}
+
+TEST(ZstdMessageCompressor, DictionaryOverflow) {
+    checkOverflow(stdx::make_unique<ZstdMessageCompressor>(kDictionary, 3));
+}
+
+TEST(ZstdMessageCompressor, DictionaryHelpsSmallMessages) {
+    const auto msg = buildMessage(kDictionary);
+    const int plainLen = checkFidelity(msg, stdx::make_unique<ZstdMessageCompressor>());
+    const int dictLen =
+        checkFidelity(msg, stdx::make_unique<ZstdMessageCompressor>(kDictionary, 3));
+    ASSERT_LT(dictLen, plainLen);
+}
+
+TEST(ZstdMessageCompressor, NamesAreDistinct) {
+    ASSERT_EQ(ZstdMessageCompressor().getName(), "zstd");
+    ASSERT_EQ(ZstdMessageCompressor(kDictionary, 3).getName(), "zstd_dict");
+}
+
+}  // namespace
+}  // namespace mongo
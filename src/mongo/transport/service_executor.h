@@ -81,6 +81,17 @@ public:
      */
     virtual Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) = 0;
 
+    /*
+     * Returns true if a task that owns its worker thread outright may run its next step directly,
+     * in place of calling schedule() with the given flags. Before returning true the executor does
+     * whatever schedule() would have done for those flags, such as yielding.
+     *
+     * Running inline saves allocating and queueing a Task for every step.
+     */
+    virtual bool mayRunInline(ScheduleFlags flags) {
+        return false;
+    }
+
     /*
      * Stops and joins the ServiceExecutor. Any outstanding tasks will not be executed, and any
      * associated callbacks waiting on I/O may get called with an error code.
@@ -0,0 +1,373 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_per_core.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// The number of event loops to run. If the value is -1 (the default), then it will be set to the
+// number of cores.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(perCoreServiceExecutorNumLoops, int, -1);
+
+// Whether each event loop's thread is bound to a single core.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(perCoreServiceExecutorPinThreads, bool, true);
+
+// Once a loop has more than this many tasks queued, the least loaded loop is asked to steal one.
+MONGO_EXPORT_SERVER_PARAMETER(perCoreServiceExecutorStealThreshold, int, 16);
+
+// Tasks scheduled with MayRecurse may be called recursively if the recursion depth is below this
+// value.
+MONGO_EXPORT_SERVER_PARAMETER(perCoreServiceExecutorRecursionLimit, int, 8);
+
+// Each loop thread runs its reactor for this long before checking whether it should exit.
+constexpr Milliseconds kLoopRunTime{1000};
+
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kTotalTimeQueuedUs = "totalTimeQueuedMicros"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
+constexpr auto kStealRequests = "stealRequests"_sd;
+constexpr auto kQueueDepth = "queueDepth"_sd;
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kLoops = "loops"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "percore"_sd;
+
+int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
+    invariant(tickSource->getTicksPerSecond() >= 1000000);
+    return tickSource->ticksTo<Microseconds>(ticks).count();
+}
+
+struct ServerParameterOptions : public ServiceExecutorPerCore::Options {
+    int stealThreshold() const final {
+        return perCoreServiceExecutorStealThreshold.load();
+    }
+
+    int recursionLimit() const final {
+        return perCoreServiceExecutorRecursionLimit.load();
+    }
+
+    bool pinThreads() const final {
+        return perCoreServiceExecutorPinThreads;
+    }
+};
+
+#ifdef __linux__
+/**
+ * Binds the calling thread to the 'index'th core this process may run on, wrapping around if
+ * there are fewer cores than that.
+ */
+void pinThreadToCore(size_t index) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        warning() << "Unable to get CPU affinity: " << errnoWithDescription();
+        return;
+    }
+
+    const auto numAllowed = static_cast<size_t>(CPU_COUNT(&allowed));
+    if (numAllowed == 0) {
+        return;
+    }
+
+    index %= numAllowed;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed) || index-- != 0) {
+            continue;
+        }
+
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+        CPU_SET(cpu, &pinned);
+        const int err = pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+        if (err != 0) {
+            warning() << "Unable to pin thread to CPU " << cpu << ": "
+                      << errnoWithDescription(err);
+        }
+        return;
+    }
+}
+#endif
+
+}  // namespace
+
+thread_local ServiceExecutorPerCore::Loop* ServiceExecutorPerCore::_localLoop = nullptr;
+
+ServiceExecutorPerCore::ServiceExecutorPerCore(ServiceContext* ctx,
+                                               std::vector<ReactorHandle> reactors)
+    : ServiceExecutorPerCore(
+          ctx, std::move(reactors), stdx::make_unique<ServerParameterOptions>()) {}
+
+ServiceExecutorPerCore::ServiceExecutorPerCore(ServiceContext* ctx,
+                                               std::vector<ReactorHandle> reactors,
+                                               std::unique_ptr<Options> config)
+    : _config(std::move(config)), _tickSource(ctx->getTickSource()) {
+    invariant(!reactors.empty());
+    for (auto& reactor : reactors) {
+        _loops.emplace_back(stdx::make_unique<Loop>(_loops.size(), std::move(reactor)));
+    }
+}
+
+ServiceExecutorPerCore::~ServiceExecutorPerCore() {
+    invariant(!_isRunning.load());
+}
+
+size_t ServiceExecutorPerCore::numLoops() {
+    const int configured = perCoreServiceExecutorNumLoops;
+    if (configured > 0) {
+        return static_cast<size_t>(configured);
+    }
+    return static_cast<size_t>(std::max(ProcessInfo::getNumAvailableCores(), 1UL));
+}
+
+Status ServiceExecutorPerCore::start() {
+    invariant(!_isRunning.load());
+    _isRunning.store(true);
+
+    for (auto& loop : _loops) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+            ++_threadsRunning;
+        }
+
+        auto status = launchServiceWorkerThread(
+            [ this, loop = loop.get() ] { _loopThreadRoutine(loop); });
+        if (!status.isOK()) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+                --_threadsRunning;
+            }
+            shutdown(kLoopRunTime).ignore();
+            return status;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status ServiceExecutorPerCore::shutdown(Milliseconds timeout) {
+    if (!_isRunning.load())
+        return Status::OK();
+
+    _isRunning.store(false);
+
+    stdx::unique_lock<stdx::mutex> lk(_threadsMutex);
+    for (auto& loop : _loops) {
+        loop->reactor->stop();
+    }
+    bool result = _deathCondition.wait_for(
+        lk, timeout.toSystemDuration(), [&] { return _threadsRunning == 0; });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "per-core executor couldn't shutdown all loop threads within time limit.");
+}
+
+Status ServiceExecutorPerCore::schedule(Task task,
+                                        ScheduleFlags flags,
+                                        ServiceExecutorTaskName taskName) {
+    if (!_isRunning.load()) {
+        return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    _totalQueued.addAndFetch(1);
+
+    // Tasks scheduled from a loop stay on that loop, and may run right away if they are allowed
+    // to recurse. Tasks scheduled from elsewhere, such as new sessions, go to a lightly loaded
+    // loop.
+    auto loop = _localLoop;
+    if (loop && (flags & kMayRecurse) && (loop->recursionDepth + 1 < _config->recursionLimit())) {
+        _runTask(loop, task);
+        return Status::OK();
+    }
+
+    if (!loop) {
+        loop = _pickLoopForNewTask();
+    }
+
+    int depth;
+    {
+        stdx::lock_guard<stdx::mutex> lk(loop->mutex);
+        loop->queue.push_back({std::move(task), _tickSource->getTicks()});
+        depth = loop->queueDepth.addAndFetch(1);
+    }
+    loop->reactor->schedule(Reactor::kPost, [this, loop] { _runQueuedTask(loop, loop); });
+
+    if (depth > _config->stealThreshold()) {
+        _maybeRequestSteal(loop, depth);
+    }
+
+    return Status::OK();
+}
+
+ServiceExecutorPerCore::Loop* ServiceExecutorPerCore::_pickLoopForNewTask() {
+    // Compare the next loop in round-robin order with the one after it, and take the less loaded
+    // of the two. This spreads new work evenly without looking at every loop.
+    const auto first = _nextLoop.fetchAndAdd(1) % _loops.size();
+    const auto second = (first + 1) % _loops.size();
+    auto a = _loops[first].get();
+    auto b = _loops[second].get();
+    return (b->queueDepth.load() < a->queueDepth.load()) ? b : a;
+}
+
+void ServiceExecutorPerCore::_maybeRequestSteal(Loop* owner, int depth) {
+    Loop* thief = nullptr;
+    int thiefDepth = depth / 2;
+    for (auto& loop : _loops) {
+        auto loopDepth = loop->queueDepth.load();
+        if (loop.get() != owner && loopDepth < thiefDepth) {
+            thief = loop.get();
+            thiefDepth = loopDepth;
+        }
+    }
+
+    if (!thief) {
+        return;
+    }
+
+    _stealRequests.addAndFetch(1);
+    thief->reactor->schedule(Reactor::kPost,
+                             [this, owner, thief] { _runQueuedTask(owner, thief); });
+}
+
+void ServiceExecutorPerCore::_runQueuedTask(Loop* owner, Loop* runner) {
+    const bool stealing = owner != runner;
+
+    QueuedTask queued;
+    {
+        stdx::lock_guard<stdx::mutex> lk(owner->mutex);
+
+        // Every queued task has a wakeup on its own loop, and may have another on the loop asked
+        // to steal it, so whichever of them comes second finds nothing to do.
+        if (owner->queue.empty()) {
+            return;
+        }
+
+        // A thief takes the newest task, leaving the owner the ones which have waited longest.
+        if (stealing) {
+            queued = std::move(owner->queue.back());
+            owner->queue.pop_back();
+        } else {
+            queued = std::move(owner->queue.front());
+            owner->queue.pop_front();
+        }
+        owner->queueDepth.subtractAndFetch(1);
+    }
+
+    _totalSpentQueued.addAndFetch(_tickSource->getTicks() - queued.scheduled);
+    if (stealing) {
+        runner->totalStolen.addAndFetch(1);
+    }
+
+    _runTask(runner, queued.task);
+}
+
+void ServiceExecutorPerCore::_runTask(Loop* loop, const Task& task) {
+    ++loop->recursionDepth;
+    const auto guard = MakeGuard([this, loop] {
+        --loop->recursionDepth;
+        loop->totalExecuted.addAndFetch(1);
+        _totalExecuted.addAndFetch(1);
+    });
+
+    task();
+}
+
+void ServiceExecutorPerCore::_loopThreadRoutine(Loop* loop) {
+    _localLoop = loop;
+    {
+        std::string threadName = str::stream() << "conn-loop-" << loop->id;
+        setThreadName(threadName);
+    }
+
+#ifdef __linux__
+    if (_config->pinThreads()) {
+        pinThreadToCore(loop->id);
+    }
+#endif
+
+    LOG(1) << "Started service executor loop " << loop->id;
+
+    const auto guard = MakeGuard([this] {
+        _localLoop = nullptr;
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        --_threadsRunning;
+        _deathCondition.notify_one();
+    });
+
+    while (_isRunning.load()) {
+        loop->reactor->runFor(kLoopRunTime);
+    }
+}
+
+void ServiceExecutorPerCore::appendStats(BSONObjBuilder* bob) const {
+    int threadsRunning;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        threadsRunning = _threadsRunning;
+    }
+
+    *bob << kExecutorLabel << kExecutorName                                             //
+         << kTotalQueued << _totalQueued.load()                                         //
+         << kTotalExecuted << _totalExecuted.load()                                     //
+         << kTotalTimeQueuedUs << ticksToMicros(_totalSpentQueued.load(), _tickSource)  //
+         << kStealRequests << _stealRequests.load()                                     //
+         << kThreadsRunning << threadsRunning;
+
+    BSONArrayBuilder loops(bob->subarrayStart(kLoops));
+    for (const auto& loop : _loops) {
+        BSONObjBuilder loopBuilder(loops.subobjStart());
+        loopBuilder << kQueueDepth << loop->queueDepth.load()      //
+                    << kTotalExecuted << loop->totalExecuted.load()  //
+                    << kTotalStolen << loop->totalStolen.load();
+    }
+    loops.doneFast();
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * This is a ServiceExecutor which runs one event loop per core. Each loop is a worker thread,
+ * optionally pinned to its core, which runs its own reactor. The transport layer spreads accepted
+ * sessions across the loops' reactors, so a session's network callbacks always run on the loop it
+ * was accepted on, and tasks scheduled from a loop stay on that loop.
+ *
+ * A loop's tasks are kept in its own queue, and the loop is woken up through its reactor for each
+ * of them. When a loop's queue grows beyond the steal threshold, the least loaded loop is asked to
+ * take a task from the back of it, which keeps one busy session from delaying every other session
+ * on its core. A stolen task runs elsewhere, but its session's next network callback still
+ * arrives on its own loop.
+ *
+ * Unlike the adaptive executor this never starts extra threads, so a task which blocks for a long
+ * time delays network callbacks for the other sessions on its loop.
+ */
+class ServiceExecutorPerCore final : public ServiceExecutor {
+public:
+    struct Options {
+        virtual ~Options() = default;
+
+        // The length of a loop's queue beyond which idle loops are asked to steal from it.
+        virtual int stealThreshold() const = 0;
+
+        // The maximum allowable depth of recursion for tasks scheduled with the MayRecurse flag
+        // before stack unwinding is forced.
+        virtual int recursionLimit() const = 0;
+
+        // Whether each loop's thread should be bound to a single core.
+        virtual bool pinThreads() const = 0;
+    };
+
+    /**
+     * Runs one loop on each of 'reactors', which must not be run by anyone else.
+     */
+    ServiceExecutorPerCore(ServiceContext* ctx, std::vector<ReactorHandle> reactors);
+    ServiceExecutorPerCore(ServiceContext* ctx,
+                           std::vector<ReactorHandle> reactors,
+                           std::unique_ptr<Options> config);
+
+    ~ServiceExecutorPerCore();
+
+    /**
+     * The number of loops to run: perCoreServiceExecutorNumLoops, or one per available core if
+     * that is not set.
+     */
+    static size_t numLoops();
+
+    Status start() final;
+    Status shutdown(Milliseconds timeout) final;
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) final;
+
+    Mode transportMode() const final {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const final;
+
+private:
+    struct QueuedTask {
+        Task task;
+        TickSource::Tick scheduled = 0;
+    };
+
+    struct Loop {
+        explicit Loop(size_t id, ReactorHandle reactor) : id(id), reactor(std::move(reactor)) {}
+
+        const size_t id;
+        const ReactorHandle reactor;
+
+        stdx::mutex mutex;
+        std::deque<QueuedTask> queue;
+        AtomicWord<int> queueDepth{0};
+
+        // Only used by the loop's own thread.
+        int recursionDepth = 0;
+
+        AtomicWord<int64_t> totalExecuted{0};
+        AtomicWord<int64_t> totalStolen{0};
+    };
+
+    void _loopThreadRoutine(Loop* loop);
+    Loop* _pickLoopForNewTask();
+    void _runTask(Loop* loop, const Task& task);
+    void _runQueuedTask(Loop* loop, Loop* owner);
+    void _maybeRequestSteal(Loop* owner, int depth);
+
+    std::unique_ptr<Options> _config;
+    std::vector<std::unique_ptr<Loop>> _loops;
+    TickSource* const _tickSource;
+
+    AtomicWord<bool> _isRunning{false};
+    AtomicWord<unsigned> _nextLoop{0};
+
+    // Loop threads signal this condition variable when they exit so we can gracefully shutdown
+    // the executor.
+    mutable stdx::mutex _threadsMutex;
+    stdx::condition_variable _deathCondition;
+    int _threadsRunning = 0;
+
+    AtomicWord<int64_t> _totalQueued{0};
+    AtomicWord<int64_t> _totalExecuted{0};
+    AtomicWord<int64_t> _stealRequests{0};
+    AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+
+    static thread_local Loop* _localLoop;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -57,6 +57,7 @@ public:
     Status start() override;
     Status shutdown(Milliseconds timeout) override;
     Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override;
+    bool mayRunInline(ScheduleFlags flags) override;
 
     Mode transportMode() const override {
         return Mode::kSynchronous;
@@ -67,6 +68,8 @@ public:
 private:
     Status _startWorker();
 
+    void _yieldBeforeSchedule(ScheduleFlags flags);
+
     static thread_local std::deque<Task> _localWorkQueue;
     static thread_local int _localRecursionDepth;
     static thread_local int64_t _localThreadIdleCounter;
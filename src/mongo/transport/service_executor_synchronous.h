@@ -51,6 +51,7 @@ public:
     Status start() override;
     Status shutdown(Milliseconds timeout) override;
     Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override;
+    bool mayRunInline(ScheduleFlags flags) override;
 
     Mode transportMode() const override {
         return Mode::kSynchronous;
@@ -59,6 +60,8 @@ public:
     void appendStats(BSONObjBuilder* bob) const override;
 
 private:
+    void _yieldBeforeSchedule(ScheduleFlags flags);
+
     static thread_local std::deque<Task> _localWorkQueue;
     static thread_local int _localRecursionDepth;
     static thread_local int64_t _localThreadIdleCounter;
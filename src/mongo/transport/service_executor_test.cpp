@@ -34,6 +34,7 @@
 
 #include "mongo/db/service_context.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_per_core.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/unittest/unittest.h"
@@ -163,6 +164,36 @@ protected:
     std::shared_ptr<asio::io_context> asioIOCtx;
 };
 
+struct PerCoreTestOptions : public ServiceExecutorPerCore::Options {
+    int stealThreshold() const final {
+        return 1;
+    }
+
+    int recursionLimit() const final {
+        return 0;
+    }
+
+    bool pinThreads() const final {
+        return false;
+    }
+};
+
+class ServiceExecutorPerCoreFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = ServiceContext::make();
+        setGlobalServiceContext(std::move(scOwned));
+
+        std::vector<ReactorHandle> reactors{std::make_shared<ASIOReactor>(),
+                                            std::make_shared<ASIOReactor>()};
+        auto configOwned = stdx::make_unique<PerCoreTestOptions>();
+        executor = stdx::make_unique<ServiceExecutorPerCore>(
+            getGlobalServiceContext(), std::move(reactors), std::move(configOwned));
+    }
+
+    std::unique_ptr<ServiceExecutorPerCore> executor;
+};
+
 class ServiceExecutorSynchronousFixture : public unittest::Test {
 protected:
     void setUp() override {
@@ -205,6 +236,61 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorPerCoreFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, IdleLoopStealsFromBlockedLoop) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int queuedTasksRun = 0;
+    bool stolenWhileBlocked = false;
+    bool done = false;
+
+    // The first task queues more tasks on its own loop and then blocks it. Once the queue is past
+    // the steal threshold the other loop must run one of them.
+    auto blockingTask = [&] {
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_OK(executor->schedule(
+                [&] {
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    ++queuedTasksRun;
+                    cond.notify_all();
+                },
+                ServiceExecutor::kEmptyFlags,
+                ServiceExecutorTaskName::kSSMProcessMessage));
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        stolenWhileBlocked = cond.wait_for(
+            lk, Seconds(10).toSystemDuration(), [&] { return queuedTasksRun > 0; });
+        done = true;
+        cond.notify_all();
+    };
+
+    ASSERT_OK(executor->schedule(std::move(blockingTask),
+                                 ServiceExecutor::kEmptyFlags,
+                                 ServiceExecutorTaskName::kSSMStartSession));
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    cond.wait(lk, [&] { return done && queuedTasksRun == 3; });
+    ASSERT_TRUE(stolenWhileBlocked);
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_GT(bob.obj()["stealRequests"].numberLong(), 0);
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
@@ -32,6 +32,7 @@
 
 #include "mongo/transport/service_state_machine.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
@@ -52,6 +53,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/quick_exit.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 namespace {
@@ -149,6 +151,33 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
     return requestMsg;
 }
 
+/**
+ * Given the 'synthetic' request of an exhaust stream that can no longer be delivered, returns a
+ * request that kills the cursor it refers to. Returns an empty message if the cursor cannot be
+ * identified.
+ */
+Message makeKillCursorsForExhaustMessage(const Message& exhaustMsg) {
+    if (exhaustMsg.operation() == dbGetMore) {
+        DbMessage d(exhaustMsg);
+        d.getns();
+        d.pullInt();  // ntoreturn
+        return makeKillCursorsMessage(d.pullInt64());
+    }
+
+    auto request = OpMsgRequest::parse(exhaustMsg);
+    if (request.getCommandName() != "getMore"_sd || !request.body.hasField("$db")) {
+        return Message();
+    }
+
+    BSONObjBuilder body;
+    body.append("killCursors", request.body["collection"].str());
+    body.append("cursors", BSON_ARRAY(request.body.firstElement().numberLong()));
+    if (auto lsid = request.body["lsid"]) {
+        body.append(lsid);
+    }
+    return OpMsgRequest::fromDBAndBody(request.getDatabase(), body.obj()).serialize();
+}
+
 }  // namespace
 
 using transport::ServiceExecutor;
@@ -329,6 +358,10 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
     _state.store(State::SinkWait);
     guard.release();
 
+    // Keep a reference to the reply's buffer so that it can be reused for a later reply once the
+    // transport layer is done with it.
+    auto replyBuffer = toSink.isScatterGather() ? SharedBuffer() : toSink.sharedBuffer();
+
     auto sinkMsgImpl = [&] {
         if (_transportMode == transport::Mode::kSynchronous) {
             // We don't consider ourselves idle while sending the reply since we are still doing
@@ -341,7 +374,10 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
         }
     };
 
-    sinkMsgImpl().getAsync([this](Status status) { _sinkCallback(std::move(status)); });
+    sinkMsgImpl().getAsync([ this, replyBuffer = std::move(replyBuffer) ](Status status) mutable {
+        SharedBufferPool::recycle(std::move(replyBuffer));
+        _sinkCallback(std::move(status));
+    });
 }
 
 void ServiceStateMachine::_sourceCallback(Status status) {
@@ -402,6 +438,12 @@ void ServiceStateMachine::_sinkCallback(Status status) {
         log() << "Error sending response to client: " << status << ". Ending connection from "
               << _session()->remote() << " (connection id: " << _session()->id() << ")";
         _state.store(State::EndSession);
+        if (_inExhaust) {
+            // Nobody is left to read the rest of the stream, so release the cursor now rather
+            // than leaving it to the cursor timeout.
+            _killExhaustCursor();
+            _inExhaust = false;
+        }
         return _runNextInGuard(std::move(guard));
     } else if (_inExhaust) {
         _state.store(State::Process);
@@ -418,6 +460,22 @@ void ServiceStateMachine::_sinkCallback(Status status) {
     }
 }
 
+void ServiceStateMachine::_killExhaustCursor() {
+    try {
+        auto killMsg = makeKillCursorsForExhaustMessage(_inMessage);
+        _inMessage.reset();
+        if (killMsg.empty()) {
+            return;
+        }
+
+        auto opCtx = Client::getCurrent()->makeOperationContext();
+        _sep->handleRequest(opCtx.get(), killMsg);
+    } catch (const DBException& ex) {
+        LOG(1) << "Failed to kill exhaust cursor for connection " << _session()->id() << ": "
+               << ex.toStatus();
+    }
+}
+
 void ServiceStateMachine::_processMessage(ThreadGuard guard) {
     invariant(!_inMessage.empty());
 
@@ -466,9 +524,13 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         networkCounter.hitLogicalOut(toSink.size());
 
         if (_compressorId) {
+            // Compression needs the whole message in one buffer.
+            toSink.flatten();
             auto swm = compressorMgr.compressMessage(toSink, &_compressorId.value());
             uassertStatusOK(swm.getStatus());
+            auto uncompressed = toSink.sharedBuffer();
             toSink = swm.getValue();
+            SharedBufferPool::recycle(std::move(uncompressed));
         }
         _sinkMessage(std::move(guard), std::move(toSink));
 
@@ -543,11 +605,23 @@ void ServiceStateMachine::_scheduleNextWithGuard(ThreadGuard guard,
                                                  transport::ServiceExecutor::ScheduleFlags flags,
                                                  transport::ServiceExecutorTaskName taskName,
                                                  Ownership ownershipModel) {
+    // A session that owns its thread needs no task for each step, so skip the allocation and
+    // the trip through the executor's queue when the executor allows it.
+    if (_owned.load() == Ownership::kStatic && _serviceExecutor->mayRunInline(flags)) {
+        _inlineStepPending = true;
+        return;
+    }
+
     auto func = [ ssm = shared_from_this(), ownershipModel ] {
         ThreadGuard guard(ssm.get());
         if (ownershipModel == Ownership::kStatic)
             guard.markStaticOwnership();
         ssm->_runNextInGuard(std::move(guard));
+
+        while (ssm->_inlineStepPending) {
+            ssm->_inlineStepPending = false;
+            ssm->_runNextInGuard(ThreadGuard(ssm.get()));
+        }
     };
     guard.release();
     Status status = _serviceExecutor->schedule(std::move(func), flags, taskName);
@@ -207,6 +207,11 @@ private:
     void _sourceCallback(Status status);
     void _sinkCallback(Status status);
 
+    /*
+     * Kills the cursor backing an exhaust stream whose response could not be sent to the client.
+     */
+    void _killExhaustCursor();
+
     /*
      * Source/Sink message from the TransportLayer. These will invalidate the ThreadGuard just
      * before waiting on the TL.
@@ -234,6 +239,10 @@ private:
     stdx::function<void()> _cleanupHook;
 
     bool _inExhaust = false;
+
+    // Set when the executor let the next step run inline on the thread this session owns; the
+    // task currently running picks it up once the stack has unwound.
+    bool _inlineStepPending = false;
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
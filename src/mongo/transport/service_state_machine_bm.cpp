@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/base/checked_cast.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/db/service_context.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/mock_session.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_state_machine.h"
+#include "mongo/transport/transport_layer_mock.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Does the per-request work every command goes through before and after running: parsing the
+ * OP_MSG and building an OP_MSG reply. The command itself does nothing.
+ */
+class BenchSEP : public ServiceEntryPoint {
+public:
+    void startSession(transport::SessionHandle session) override {}
+
+    void endAllSessions(transport::Session::TagMask tags) override {}
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        return 1;
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        auto opMsg = OpMsgRequest::parse(request);
+        benchmark::DoNotOptimize(opMsg.getCommandName());
+
+        OpMsgBuilder reply;
+        reply.setBody(BSON("ok" << 1.0));
+        return DbResponse{reply.finish()};
+    }
+};
+
+/**
+ * Sources the same request forever and throws away everything sunk.
+ */
+class BenchTL : public transport::TransportLayerMock {
+public:
+    class Session : public transport::MockSession {
+    public:
+        using MockSession::MockSession;
+
+        StatusWith<Message> sourceMessage() override {
+            return checked_cast<BenchTL*>(getTransportLayer())->request;
+        }
+
+        Status sinkMessage(Message message) override {
+            return Status::OK();
+        }
+    };
+
+    BenchTL() {
+        createSessionHook = [](TransportLayer* tl) { return stdx::make_unique<Session>(tl); };
+    }
+
+    Message request;
+};
+
+/**
+ * Drops every task; the benchmark steps the state machine itself with runNext().
+ */
+class BenchServiceExecutor : public transport::ServiceExecutor {
+public:
+    Status start() override {
+        return Status::OK();
+    }
+
+    Status shutdown(Milliseconds timeout) override {
+        return Status::OK();
+    }
+
+    Status schedule(Task task,
+                    ScheduleFlags flags,
+                    transport::ServiceExecutorTaskName taskName) override {
+        return Status::OK();
+    }
+
+    transport::Mode transportMode() const override {
+        return transport::Mode::kSynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override {}
+};
+
+/**
+ * Measures one request/response round trip through the ServiceStateMachine with a request
+ * payload of 'state.range(0)' bytes: sourcing, creating an OperationContext, dispatching to the
+ * ServiceEntryPoint and sinking the reply.
+ */
+void BM_SSMRoundTrip(benchmark::State& state) {
+    auto svcCtx = ServiceContext::make();
+    svcCtx->setServiceEntryPoint(stdx::make_unique<BenchSEP>());
+    svcCtx->setServiceExecutor(stdx::make_unique<BenchServiceExecutor>());
+
+    auto ownedTL = stdx::make_unique<BenchTL>();
+    auto tl = ownedTL.get();
+    svcCtx->setTransportLayer(std::move(ownedTL));
+    invariant(tl->start());
+
+    tl->request = OpMsgRequest::fromDBAndBody(
+                      "admin", BSON("ping" << 1 << "payload" << std::string(state.range(0), 'x')))
+                      .serialize();
+
+    auto ssm = ServiceStateMachine::create(
+        svcCtx.get(), tl->createSession(), transport::Mode::kSynchronous);
+    for (auto keepRunning : state) {
+        // Once to source the request, once to process it and sink the reply.
+        ssm->runNext();
+        ssm->runNext();
+    }
+    state.SetBytesProcessed(state.iterations() * tl->request.size());
+
+    tl->shutdown();
+}
+
+BENCHMARK(BM_SSMRoundTrip)->ArgName("payload")->Arg(16)->Arg(1024)->Arg(64 * 1024);
+
+}  // namespace
+}  // namespace mongo
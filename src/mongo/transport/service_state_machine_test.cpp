@@ -73,6 +73,7 @@ public:
     DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
         log() << "In handleRequest";
         _ranHandler = true;
+        _lastRequest = request;
         ASSERT_TRUE(haveClient());
 
         // Build out a dummy OK response, if no custom response message was set. Otherwise, use the
@@ -120,9 +121,14 @@ public:
         return ret;
     }
 
+    const Message& getLastRequest() const {
+        return _lastRequest;
+    }
+
 private:
     bool _uassertInHandler = false;
     bool _ranHandler = false;
+    Message _lastRequest;
 
     // A custom response message to return from 'handleRequest'.
     Message _responseMessage;
@@ -251,6 +257,10 @@ public:
         }
     }
 
+    bool mayRunInline(ScheduleFlags flags) override {
+        return _runInline;
+    }
+
     Mode transportMode() const override {
         return Mode::kSynchronous;
     }
@@ -261,8 +271,13 @@ public:
         _scheduleHook = std::move(hook);
     }
 
+    void setRunInline(bool runInline) {
+        _runInline = runInline;
+    }
+
 private:
     ScheduleHook _scheduleHook;
+    bool _runInline = false;
 };
 
 class SimpleEvent {
@@ -600,6 +615,38 @@ TEST_F(ServiceStateMachineFixture, TestExhaustOnlySupportedForGetMoreCommand) {
     ASSERT_EQ(1, reply.body.getIntField("ok"));
 }
 
+TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustKillsCursorOnSinkError) {
+    const long long cursorId = 42;
+    Message getMoreWithExhaust =
+        buildOpMsg(BSON("getMore" << cursorId << "collection"
+                                  << "coll"
+                                  << "$db"
+                                  << "test"));
+    OpMsg::setFlag(&getMoreWithExhaust, OpMsg::kExhaustSupported);
+
+    BSONObj getMoreResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns"
+                               << "test.coll"
+                               << "nextBatch"
+                               << BSONArray()));
+
+    // The client goes away while the first batch of the exhaust stream is being sent, so the
+    // session should end and the cursor should be killed rather than left for the cursor timeout.
+    _tl->setNextFailure(MockTL::Sink);
+    runSourceAndSinkTest(
+        _tl, _sep, getMoreWithExhaust, buildOpMsg(getMoreResBody), State::Process, State::Ended);
+
+    auto killRequest = OpMsgRequest::parse(_sep->getLastRequest());
+    ASSERT_BSONOBJ_EQ(BSON("killCursors"
+                           << "coll"
+                           << "cursors"
+                           << BSON_ARRAY(cursorId)
+                           << "$db"
+                           << "test"),
+                      killRequest.body);
+}
+
 TEST_F(ServiceStateMachineFixture, TestThrowHandling) {
     _sep->setUassertInHandler();
 
@@ -627,6 +674,31 @@ TEST_F(ServiceStateMachineFixture, TestSinkError) {
     ASSERT_TRUE(_tl->ranSink());
 }
 
+TEST_F(ServiceStateMachineFixture, StaticOwnershipRunsStepsInline) {
+    _sexec->setRunInline(true);
+    int scheduled = 0;
+    _sexec->setScheduleHook([&scheduled](ServiceExecutor::Task task) {
+        ++scheduled;
+        task();
+        return true;
+    });
+
+    // Serve three pings, then fail the next source like a client that went away.
+    int waits = 0;
+    _tl->setWaitHook([&] {
+        if (++waits == 6)
+            _tl->setNextFailure(MockTL::Source);
+    });
+
+    _ssm->start(ServiceStateMachine::Ownership::kStatic);
+
+    // Only starting the session went through the executor; every later step ran inline.
+    ASSERT_EQ(1, scheduled);
+    ASSERT_EQ(7, waits);
+    ASSERT_EQ(State::Ended, _ssm->state());
+    checkPingOk();
+}
+
 // This test checks that after the SSM has been cleaned up, the SessionHandle that it passed
 // into the Client doesn't have any dangling shared_ptr copies.
 TEST_F(ServiceStateMachineFixture, TestSessionCleanupOnDestroy) {
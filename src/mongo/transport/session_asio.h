@@ -139,7 +139,7 @@ public:
     Status sinkMessage(Message message) override {
         ensureSync();
 
-        return write(asio::buffer(message.buf(), message.size()))
+        return writeMessage(message)
             .then([this, &message] {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -151,7 +151,7 @@ public:
     Future<void> asyncSinkMessage(Message message,
                                   const transport::BatonHandle& baton = nullptr) override {
         ensureAsync();
-        return write(asio::buffer(message.buf(), message.size()), baton)
+        return writeMessage(message, baton)
             .then([this, message /*keep the buffer alive*/]() {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -221,6 +221,9 @@ protected:
 
         _sslSocket.emplace(
             std::move(_socket), *_tl->_egressSSLContext, removeFQDNRoot(target.host()));
+#if MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+        setupTLSSessionResumption(_sslSocket->native_handle(), target.toString());
+#endif
         lk.unlock();
 
         auto doHandshake = [&] {
@@ -411,6 +414,17 @@ private:
         return opportunisticRead(_socket, buffers, baton);
     }
 
+    /**
+     * Writes a message, gathering the slices of a scatter-gather message in place.
+     */
+    Future<void> writeMessage(const Message& message,
+                              const transport::BatonHandle& baton = nullptr) {
+        if (message.isScatterGather()) {
+            return write(MessageConstBuffers(message), baton);
+        }
+        return write(asio::buffer(message.buf(), message.size()), baton);
+    }
+
     template <typename ConstBufferSequence>
     Future<void> write(const ConstBufferSequence& buffers,
                        const transport::BatonHandle& baton = nullptr) {
@@ -224,8 +224,7 @@ TransportLayerASIO::Options::Options(const ServerGlobalParams* params)
 
 TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
                                        ServiceEntryPoint* sep)
-    : _ingressReactor(std::make_shared<ASIOReactor>()),
-      _egressReactor(std::make_shared<ASIOReactor>()),
+    : _egressReactor(std::make_shared<ASIOReactor>()),
       _acceptorReactor(std::make_shared<ASIOReactor>()),
 #ifdef MONGO_CONFIG_SSL
       _ingressSSLContext(nullptr),
@@ -233,6 +232,10 @@ TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
 #endif
       _sep(sep),
       _listenerOptions(opts) {
+    invariant(opts.numIngressReactors > 0);
+    for (size_t i = 0; i < opts.numIngressReactors; ++i) {
+        _ingressReactors.push_back(std::make_shared<ASIOReactor>());
+    }
 }
 
 TransportLayerASIO::~TransportLayerASIO() = default;
@@ -816,7 +819,7 @@ void TransportLayerASIO::shutdown() {
 ReactorHandle TransportLayerASIO::getReactor(WhichReactor which) {
     switch (which) {
         case TransportLayer::kIngress:
-            return _ingressReactor;
+            return _ingressReactors.front();
         case TransportLayer::kEgress:
             return _egressReactor;
         case TransportLayer::kNewReactor:
@@ -826,6 +829,10 @@ ReactorHandle TransportLayerASIO::getReactor(WhichReactor which) {
     MONGO_UNREACHABLE;
 }
 
+std::vector<ReactorHandle> TransportLayerASIO::getIngressReactors() {
+    return {_ingressReactors.begin(), _ingressReactors.end()};
+}
+
 void TransportLayerASIO::_acceptConnection(GenericAcceptor& acceptor) {
     auto acceptCb = [this, &acceptor](const std::error_code& ec, GenericSocket peerSocket) mutable {
         if (!_running.load())
@@ -849,7 +856,9 @@ void TransportLayerASIO::_acceptConnection(GenericAcceptor& acceptor) {
         _acceptConnection(acceptor);
     };
 
-    acceptor.async_accept(*_ingressReactor, std::move(acceptCb));
+    auto& reactor =
+        _ingressReactors[_nextIngressReactor.fetchAndAdd(1) % _ingressReactors.size()];
+    acceptor.async_accept(*reactor, std::move(acceptCb));
 }
 
 #ifdef MONGO_CONFIG_SSL
@@ -0,0 +1,256 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/server_options.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_layer_uring.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/net/sock.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Sends every message received on a session back to its client, either from a thread per
+ * session or by chaining async operations on the transport layer's ingress reactor.
+ */
+class EchoSEP : public ServiceEntryPoint {
+public:
+    explicit EchoSEP(bool async) : _async(async) {}
+
+    ~EchoSEP() {
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    void startSession(transport::SessionHandle session) override {
+        if (_async) {
+            _asyncEcho(std::move(session));
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _threads.emplace_back([session = std::move(session)] {
+            for (;;) {
+                auto swMessage = session->sourceMessage();
+                if (!swMessage.isOK() ||
+                    !session->sinkMessage(std::move(swMessage.getValue())).isOK()) {
+                    return;
+                }
+            }
+        });
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {}
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        return 0;
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+private:
+    void _asyncEcho(transport::SessionHandle session) {
+        session->asyncSourceMessage()
+            .then([session](Message message) {
+                return session->asyncSinkMessage(std::move(message));
+            })
+            .getAsync([ this, session ](Status status) {
+                if (status.isOK()) {
+                    _asyncEcho(std::move(session));
+                }
+            });
+    }
+
+    const bool _async;
+
+    stdx::mutex _mutex;
+    std::vector<stdx::thread> _threads;
+};
+
+enum class Transport { kASIO, kUring };
+
+/**
+ * An echo server on an ephemeral port, served by either transport layer in either mode. Async
+ * sessions are driven by a few threads running the transport layer's ingress reactor, much as
+ * the adaptive service executor would.
+ */
+class EchoServer {
+public:
+    EchoServer(Transport transport, bool async) : _sep(async) {
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+
+        if (transport == Transport::kASIO) {
+            transport::TransportLayerASIO::Options opts(&params);
+            opts.port = 0;
+            opts.transportMode =
+                async ? transport::Mode::kAsynchronous : transport::Mode::kSynchronous;
+            auto tl = stdx::make_unique<transport::TransportLayerASIO>(opts, &_sep);
+            _getPort = [tl = tl.get()] { return tl->listenerPort(); };
+            _tl = std::move(tl);
+        } else {
+            transport::TransportLayerUring::Options opts(&params);
+            opts.port = 0;
+            auto tl = stdx::make_unique<transport::TransportLayerUring>(opts, &_sep);
+            _getPort = [tl = tl.get()] { return tl->listenerPort(); };
+            _tl = std::move(tl);
+        }
+
+        _status = _tl->setup();
+        if (_status.isOK()) {
+            _status = _tl->start();
+        }
+        if (_status.isOK() && async) {
+            _reactor = _tl->getReactor(transport::TransportLayer::kIngress);
+            for (int i = 0; i < 4; ++i) {
+                _reactorThreads.emplace_back([this] { _reactor->run(); });
+            }
+        }
+    }
+
+    ~EchoServer() {
+        if (_reactor) {
+            _reactor->stop();
+            for (auto& thread : _reactorThreads) {
+                thread.join();
+            }
+        }
+        if (_status.isOK()) {
+            _tl->shutdown();
+        }
+    }
+
+    const Status& status() const {
+        return _status;
+    }
+
+    std::unique_ptr<Socket> connect() {
+        auto socket = stdx::make_unique<Socket>();
+        SockAddr sa{"localhost", _getPort(), AF_INET};
+        invariant(socket->connect(sa));
+        return socket;
+    }
+
+private:
+    EchoSEP _sep;
+    std::unique_ptr<transport::TransportLayer> _tl;
+    stdx::function<int()> _getPort;
+    Status _status = Status::OK();
+    transport::ReactorHandle _reactor;
+    std::vector<stdx::thread> _reactorThreads;
+};
+
+/**
+ * Measures round trips of messages with a payload of 'state.range(0)' bytes, each benchmark
+ * thread on its own connection to a shared echo server.
+ */
+void runEchoBenchmark(benchmark::State& state, Transport transport, bool async) {
+    static std::unique_ptr<EchoServer> server;
+    if (state.thread_index == 0) {
+        server = stdx::make_unique<EchoServer>(transport, async);
+    }
+
+    const auto message =
+        OpMsgRequest::fromDBAndBody(
+            "admin", BSON("ping" << 1 << "payload" << std::string(state.range(0), 'x')))
+            .serialize();
+    std::unique_ptr<char[]> echoed(new char[message.size()]);
+
+    // The server is only ready once every thread has entered the loop, so connect lazily.
+    std::unique_ptr<Socket> socket;
+    for (auto keepRunning : state) {
+        if (!socket) {
+            if (!server->status().isOK()) {
+                state.SkipWithError(server->status().reason().c_str());
+                break;
+            }
+            socket = server->connect();
+        }
+        socket->send(message.buf(), message.size(), "echo");
+        socket->recv(echoed.get(), message.size());
+    }
+    state.SetBytesProcessed(state.iterations() * message.size());
+
+    if (socket) {
+        socket->close();
+    }
+    if (state.thread_index == 0) {
+        server.reset();
+    }
+}
+
+void BM_EchoASIOSync(benchmark::State& state) {
+    runEchoBenchmark(state, Transport::kASIO, false);
+}
+
+void BM_EchoASIOAsync(benchmark::State& state) {
+    runEchoBenchmark(state, Transport::kASIO, true);
+}
+
+void BM_EchoUringSync(benchmark::State& state) {
+    runEchoBenchmark(state, Transport::kUring, false);
+}
+
+void BM_EchoUringAsync(benchmark::State& state) {
+    runEchoBenchmark(state, Transport::kUring, true);
+}
+
+#define ECHO_BENCHMARK(fn) \
+    BENCHMARK(fn)->ThreadRange(1, 16)->ArgName("payload")->Arg(16)->Arg(1024)->Arg(64 * 1024)
+
+ECHO_BENCHMARK(BM_EchoASIOSync);
+ECHO_BENCHMARK(BM_EchoASIOAsync);
+ECHO_BENCHMARK(BM_EchoUringSync);
+ECHO_BENCHMARK(BM_EchoUringAsync);
+
+}  // namespace
+}  // namespace mongo
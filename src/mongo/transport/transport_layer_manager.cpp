@@ -35,9 +35,13 @@
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_per_core.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
+#ifdef __linux__
+#include "mongo/transport/transport_layer_uring.h"
+#endif
 #include "mongo/util/net/ssl_types.h"
 #include "mongo/util/time_support.h"
 #include <limits>
@@ -131,9 +135,39 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     std::unique_ptr<TransportLayer> transportLayer;
     auto sep = ctx->getServiceEntryPoint();
 
+#ifdef __linux__
+    if (config->transportLayer == "uring") {
+        // The uring transport layer only accepts connections, so outgoing connections are made
+        // by an egress-only ASIO transport layer, which must come first to receive them.
+        transport::TransportLayerASIO::Options egressOpts(config);
+        egressOpts.mode = transport::TransportLayerASIO::Options::kEgress;
+
+        auto transportLayerUring = stdx::make_unique<transport::TransportLayerUring>(
+            transport::TransportLayerUring::Options(config), sep);
+
+        if (config->serviceExecutor == "adaptive") {
+            auto reactor = transportLayerUring->getReactor(TransportLayer::kIngress);
+            ctx->setServiceExecutor(
+                stdx::make_unique<ServiceExecutorAdaptive>(ctx, std::move(reactor)));
+        } else if (config->serviceExecutor == "synchronous") {
+            ctx->setServiceExecutor(stdx::make_unique<ServiceExecutorSynchronous>(ctx));
+        } else {
+            MONGO_UNREACHABLE;
+        }
+
+        std::vector<std::unique_ptr<TransportLayer>> retVector;
+        retVector.emplace_back(stdx::make_unique<transport::TransportLayerASIO>(egressOpts, sep));
+        retVector.emplace_back(std::move(transportLayerUring));
+        return stdx::make_unique<TransportLayerManager>(std::move(retVector));
+    }
+#endif
+
     transport::TransportLayerASIO::Options opts(config);
     if (config->serviceExecutor == "adaptive") {
         opts.transportMode = transport::Mode::kAsynchronous;
+    } else if (config->serviceExecutor == "percore") {
+        opts.transportMode = transport::Mode::kAsynchronous;
+        opts.numIngressReactors = ServiceExecutorPerCore::numLoops();
     } else if (config->serviceExecutor == "synchronous") {
         opts.transportMode = transport::Mode::kSynchronous;
     } else {
@@ -146,6 +180,9 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
         auto reactor = transportLayerASIO->getReactor(TransportLayer::kIngress);
         ctx->setServiceExecutor(
             stdx::make_unique<ServiceExecutorAdaptive>(ctx, std::move(reactor)));
+    } else if (config->serviceExecutor == "percore") {
+        ctx->setServiceExecutor(stdx::make_unique<ServiceExecutorPerCore>(
+            ctx, transportLayerASIO->getIngressReactors()));
     } else if (config->serviceExecutor == "synchronous") {
         ctx->setServiceExecutor(stdx::make_unique<ServiceExecutorSynchronous>(ctx));
     }
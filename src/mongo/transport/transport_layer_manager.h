@@ -90,9 +90,9 @@ public:
 
     BatonHandle makeBaton(OperationContext* opCtx) override {
         stdx::lock_guard<stdx::mutex> lk(_tlsMutex);
-        // TODO: figure out what to do about managers with more than one transport layer.
-        invariant(_tls.size() == 1);
-        return _tls[0]->makeBaton(opCtx);
+        // Batons wait on outgoing connections, which are all made by the first transport layer.
+        invariant(!_tls.empty());
+        return _tls.front()->makeBaton(opCtx);
     }
 
 private:
@@ -0,0 +1,1295 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_uring.h"
+
+#include <deque>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mongo/config.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/rpc/message.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/functional.h"
+#include "mongo/util/log.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/net/socket_utils.h"
+#include "mongo/util/net/ssl_options.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// Ids of the submissions whose completions need no handling, and of the one which waits on the
+// reactor's wakeup eventfd. Every other submission gets a unique id above these.
+constexpr uint64_t kIgnoredCompletion = 0;
+constexpr uint64_t kWakeupCompletion = 1;
+
+// Submission queue size of the reactors which are not used for sessions.
+constexpr unsigned kSmallRingEntries = 64;
+
+Status errnoToStatus(int err) {
+    switch (err) {
+        case ECANCELED:
+            return {ErrorCodes::CallbackCanceled, "Callback was canceled"};
+        case EAGAIN:
+            return {ErrorCodes::NetworkTimeout, "Socket operation timed out"};
+        case ECONNRESET:
+        case ENETRESET:
+        case EPIPE:
+            return {ErrorCodes::HostUnreachable, "Connection was closed"};
+        default:
+            return {ErrorCodes::SocketException, errnoWithDescription(err)};
+    }
+}
+
+Status connectionClosedStatus() {
+    return {ErrorCodes::HostUnreachable, "Connection was closed"};
+}
+
+Status initStatus(int ret, StringData what) {
+    if (ret == 0) {
+        return Status::OK();
+    }
+    if (ret == -ENOSYS || ret == -EOPNOTSUPP) {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "The uring transport layer is not supported by this kernel: "
+                              << what << " failed with " << errnoWithDescription(-ret)};
+    }
+    return {ErrorCodes::InternalError,
+            str::stream() << what << " failed with " << errnoWithDescription(-ret)};
+}
+
+}  // namespace
+
+/**
+ * A Reactor which runs tasks and io_uring completions.
+ *
+ * Any number of threads may run the reactor at once. At most one of them waits on the ring at a
+ * time, while the others run queued tasks and completions, or wait for more of them. Operations
+ * submitted in the meantime are only handed to the kernel when a thread next enters the ring, so
+ * a busy reactor submits and reaps many operations per system call.
+ */
+class TransportLayerUring::UringReactor final : public Reactor {
+public:
+    using Completion = unique_function<void(int)>;
+
+    UringReactor() = default;
+
+    ~UringReactor() {
+        // The kernel may still write into the buffers of outstanding operations, so cancel them
+        // and wait for their completions before releasing anything they reference.
+        if (_wakeupFd >= 0) {
+            std::vector<uint64_t> ids;
+            {
+                stdx::lock_guard<stdx::mutex> lk(_sqMutex);
+                for (const auto& op : _outstanding) {
+                    ids.push_back(op.first);
+                }
+            }
+            for (auto id : ids) {
+                cancel(id);
+            }
+
+            const auto deadline = now() + Seconds(10);
+            while (_hasOutstanding() && now() < deadline) {
+                drain();
+            }
+            if (_hasOutstanding()) {
+                warning() << "Leaking io_uring operations which did not complete at shutdown";
+                // The completions own whatever memory the operations reference.
+                new decltype(_outstanding)(std::move(_outstanding));
+                _bufferStorage.release();
+            }
+
+            ::close(_wakeupFd);
+        }
+    }
+
+    /**
+     * Creates the ring, and registers 'numBuffers' receive buffers of 'bufferSize' bytes each
+     * with it. Failing to register the buffers is not an error: sessions then receive into
+     * unregistered buffers instead.
+     */
+    Status init(unsigned entries, size_t numBuffers, size_t bufferSize) {
+        auto status = initStatus(_ring.init(entries), "io_uring_setup");
+        if (!status.isOK()) {
+            return status;
+        }
+
+        _wakeupFd = ::eventfd(0, EFD_CLOEXEC);
+        if (_wakeupFd < 0) {
+            return initStatus(-errno, "eventfd");
+        }
+        {
+            stdx::lock_guard<stdx::mutex> lk(_sqMutex);
+            _armWakeup(lk);
+        }
+
+        if (numBuffers) {
+            _bufferSize = bufferSize;
+            _bufferStorage.reset(new char[numBuffers * bufferSize]);
+
+            std::vector<iovec> buffers;
+            for (size_t i = 0; i < numBuffers; ++i) {
+                buffers.push_back({_bufferStorage.get() + i * bufferSize, bufferSize});
+            }
+
+            const int ret = _ring.registerBuffers(buffers);
+            if (ret < 0) {
+                warning() << "Failed to register " << numBuffers << " receive buffers with "
+                          << "io_uring, sessions will receive into unregistered buffers: "
+                          << errnoWithDescription(-ret);
+                _bufferStorage.reset();
+            } else {
+                for (size_t i = numBuffers; i > 0; --i) {
+                    _freeBuffers.push_back(i - 1);
+                }
+            }
+        }
+
+        return Status::OK();
+    }
+
+    void run() noexcept override {
+        _run(boost::none);
+    }
+
+    void runFor(Milliseconds time) noexcept override {
+        _run(now() + time);
+    }
+
+    void stop() override {
+        _stopped.store(true);
+        {
+            stdx::lock_guard<stdx::mutex> lk(_taskMutex);
+            _taskCv.notify_all();
+        }
+        _wakePoller();
+    }
+
+    void drain() override {
+        _stopped.store(false);
+
+        auto previousReactor = _reactorForThread;
+        _reactorForThread = this;
+        ON_BLOCK_EXIT([&] { _reactorForThread = previousReactor; });
+
+        for (;;) {
+            {
+                stdx::unique_lock<stdx::mutex> pollLk(_pollMutex, stdx::try_to_lock);
+                if (pollLk) {
+                    _poll(Milliseconds(0));
+                }
+            }
+
+            bool ranTask = false;
+            while (_runOneTask()) {
+                ranTask = true;
+            }
+            if (!ranTask) {
+                return;
+            }
+        }
+    }
+
+    void schedule(ScheduleMode mode, Task task) override {
+        if (mode == kDispatch && onReactorThread()) {
+            task();
+        } else {
+            _enqueue(std::move(task));
+        }
+    }
+
+    bool onReactorThread() const override {
+        return this == _reactorForThread;
+    }
+
+    std::unique_ptr<ReactorTimer> makeTimer() override;
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+    /**
+     * Queues the submission made by 'prep', which is called with the ring and the id to tag its
+     * entry with, and returns that id. 'onComplete' runs with the result of the operation on a
+     * thread running this reactor.
+     */
+    template <typename Prep>
+    uint64_t submit(Prep&& prep, Completion onComplete) {
+        uint64_t id;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_sqMutex);
+            id = _nextId++;
+            _outstanding.emplace(id, std::move(onComplete));
+            _prepare(lk, [&] { return prep(_ring, id); });
+        }
+        _wakePoller();
+        return id;
+    }
+
+    /**
+     * Asks the kernel to cancel the operation with the given id. This is a no-op if the operation
+     * already completed, and its completion still runs, with -ECANCELED, if it did not.
+     */
+    void cancel(uint64_t id) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_sqMutex);
+            _prepare(lk, [&] { return _ring.prepCancel(id, kIgnoredCompletion); });
+        }
+        _wakePoller();
+    }
+
+    void cancelTimeout(uint64_t id) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_sqMutex);
+            _prepare(lk, [&] { return _ring.prepTimeoutRemove(id, kIgnoredCompletion); });
+        }
+        _wakePoller();
+    }
+
+    /**
+     * Returns the index of a free registered buffer, or -1 if there is none.
+     */
+    int acquireBuffer() {
+        stdx::lock_guard<stdx::mutex> lk(_bufferMutex);
+        if (_freeBuffers.empty()) {
+            return -1;
+        }
+        const int index = _freeBuffers.back();
+        _freeBuffers.pop_back();
+        return index;
+    }
+
+    void releaseBuffer(int index) {
+        stdx::lock_guard<stdx::mutex> lk(_bufferMutex);
+        _freeBuffers.push_back(index);
+    }
+
+    char* bufferData(int index) const {
+        return _bufferStorage.get() + index * _bufferSize;
+    }
+
+private:
+    using QueuedTask = unique_function<void()>;
+
+    void _run(boost::optional<Date_t> deadline) noexcept {
+        auto previousReactor = _reactorForThread;
+        _reactorForThread = this;
+        ON_BLOCK_EXIT([&] { _reactorForThread = previousReactor; });
+
+        while (!_stopped.load()) {
+            if (deadline && now() >= *deadline) {
+                return;
+            }
+
+            if (_runOneTask()) {
+                continue;
+            }
+
+            stdx::unique_lock<stdx::mutex> pollLk(_pollMutex, stdx::try_to_lock);
+            if (pollLk) {
+                _pollerActive.store(true);
+                _poll(deadline ? std::max(Milliseconds(0), *deadline - now()) : Milliseconds(-1));
+                pollLk.unlock();
+
+                // Let an idle thread take over waiting on the ring while this one runs whatever
+                // just completed.
+                stdx::lock_guard<stdx::mutex> lk(_taskMutex);
+                _pollerActive.store(false);
+                if (_numIdleThreads) {
+                    _taskCv.notify_one();
+                }
+                continue;
+            }
+
+            stdx::unique_lock<stdx::mutex> lk(_taskMutex);
+            const auto ready = [&] {
+                return !_tasks.empty() || !_pollerActive.load() || _stopped.load();
+            };
+            ++_numIdleThreads;
+            if (deadline) {
+                _taskCv.wait_until(lk, deadline->toSystemTimePoint(), ready);
+            } else {
+                _taskCv.wait(lk, ready);
+            }
+            --_numIdleThreads;
+        }
+    }
+
+    bool _runOneTask() {
+        QueuedTask task;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_taskMutex);
+            if (_tasks.empty()) {
+                return false;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+            _numQueuedTasks.subtractAndFetch(1);
+        }
+
+        task();
+        return true;
+    }
+
+    void _enqueue(QueuedTask task) {
+        bool haveIdleThread;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_taskMutex);
+            _tasks.push_back(std::move(task));
+            _numQueuedTasks.addAndFetch(1);
+            haveIdleThread = _numIdleThreads > 0;
+            if (haveIdleThread) {
+                _taskCv.notify_one();
+            }
+        }
+
+        if (!haveIdleThread) {
+            _wakePoller();
+        }
+    }
+
+    // Must be called while holding _pollMutex.
+    void _poll(Milliseconds timeout) {
+        // Announce that we may block before looking for work, so that anyone queueing work after
+        // we looked knows to wake us up.
+        _pollerWaiting.store(true);
+        if (_numQueuedTasks.load() || _stopped.load()) {
+            timeout = Milliseconds(0);
+        }
+
+        unsigned toSubmit;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_sqMutex);
+            toSubmit = _ring.flush();
+        }
+
+        const int ret = _ring.enter(toSubmit, timeout == Milliseconds(0) ? 0 : 1, timeout);
+        _pollerWaiting.store(false);
+        if (ret < 0 && ret != -ETIME && ret != -EBUSY && ret != -EAGAIN) {
+            warning() << "Failed to enter io_uring: " << errnoWithDescription(-ret);
+        }
+
+        _reaped.clear();
+        _ring.reapCompletions([&](uint64_t id, int result) { _reaped.push_back({id, result}); });
+        if (_reaped.empty()) {
+            return;
+        }
+
+        std::vector<QueuedTask> completed;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_sqMutex);
+            for (const auto& reaped : _reaped) {
+                if (reaped.first == kIgnoredCompletion) {
+                    continue;
+                }
+                if (reaped.first == kWakeupCompletion) {
+                    _wakeupPending.store(false);
+                    _armWakeup(lk);
+                    continue;
+                }
+
+                auto it = _outstanding.find(reaped.first);
+                invariant(it != _outstanding.end());
+                completed.push_back(
+                    [ cb = std::move(it->second), result = reaped.second ]() mutable {
+                        cb(result);
+                    });
+                _outstanding.erase(it);
+            }
+        }
+
+        if (completed.empty()) {
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_taskMutex);
+        for (auto& task : completed) {
+            _tasks.push_back(std::move(task));
+        }
+        _numQueuedTasks.addAndFetch(completed.size());
+        if (completed.size() > 1) {
+            _taskCv.notify_all();
+        }
+    }
+
+    void _wakePoller() {
+        if (_pollerWaiting.load() && !_wakeupPending.swap(true)) {
+            const uint64_t one = 1;
+            if (::write(_wakeupFd, &one, sizeof(one)) < 0) {
+                warning() << "Failed to wake up io_uring reactor: " << errnoWithDescription();
+            }
+        }
+    }
+
+    template <typename Prep>
+    void _prepare(WithLock, Prep&& prep) {
+        while (!prep()) {
+            // The submission queue is full, so hand what it holds to the kernel right away.
+            _ring.enter(_ring.flush(), 0, Milliseconds(-1));
+        }
+    }
+
+    void _armWakeup(WithLock lk) {
+        _prepare(lk, [&] {
+            return _ring.prepRead(
+                _wakeupFd, &_wakeupValue, sizeof(_wakeupValue), kWakeupCompletion);
+        });
+    }
+
+    bool _hasOutstanding() {
+        stdx::lock_guard<stdx::mutex> lk(_sqMutex);
+        return !_outstanding.empty();
+    }
+
+    IoUring _ring;
+
+    int _wakeupFd = -1;
+    uint64_t _wakeupValue = 0;
+
+    // Serializes preparing submissions, and guards the completions of outstanding operations.
+    stdx::mutex _sqMutex;
+    uint64_t _nextId = kWakeupCompletion + 1;
+    stdx::unordered_map<uint64_t, Completion> _outstanding;
+
+    // Held by the thread which waits on the ring. Only that thread uses _reaped.
+    stdx::mutex _pollMutex;
+    std::vector<std::pair<uint64_t, int>> _reaped;
+    AtomicWord<bool> _pollerActive{false};
+    AtomicWord<bool> _pollerWaiting{false};
+    AtomicWord<bool> _wakeupPending{false};
+
+    stdx::mutex _taskMutex;
+    stdx::condition_variable _taskCv;
+    std::deque<QueuedTask> _tasks;
+    AtomicWord<long long> _numQueuedTasks{0};
+    int _numIdleThreads = 0;
+
+    AtomicWord<bool> _stopped{false};
+
+    stdx::mutex _bufferMutex;
+    std::unique_ptr<char[]> _bufferStorage;
+    size_t _bufferSize = 0;
+    std::vector<int> _freeBuffers;
+
+    static thread_local UringReactor* _reactorForThread;
+};
+
+thread_local TransportLayerUring::UringReactor*
+    TransportLayerUring::UringReactor::_reactorForThread = nullptr;
+
+class TransportLayerUring::UringReactorTimer final : public ReactorTimer {
+public:
+    explicit UringReactorTimer(UringReactor* reactor)
+        : _reactor(reactor), _state(std::make_shared<State>()) {}
+
+    ~UringReactorTimer() {
+        // Cancel the timeout so that the outstanding promise gets fulfilled.
+        cancel();
+    }
+
+    void cancel(const BatonHandle& baton = nullptr) override {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        if (_state->pendingId) {
+            _reactor->cancelTimeout(*_state->pendingId);
+            _state->pendingId = boost::none;
+        }
+    }
+
+    Future<void> waitUntil(Date_t expiration, const BatonHandle& baton = nullptr) override {
+        cancel();
+
+        auto pf = makePromiseFuture<void>();
+        auto ts = std::make_shared<__kernel_timespec>();
+        const auto millis = expiration.toMillisSinceEpoch();
+        ts->tv_sec = millis / 1000;
+        ts->tv_nsec = (millis % 1000) * 1000 * 1000;
+
+        // Holding the state's mutex keeps the completion from running before we record the id.
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        const auto generation = ++_state->generation;
+        _state->pendingId = _reactor->submit(
+            [ts](IoUring& ring, uint64_t id) { return ring.prepTimeout(ts.get(), id); },
+            [ ts, state = _state, generation, promise = std::move(pf.promise) ](
+                int result) mutable {
+                {
+                    stdx::lock_guard<stdx::mutex> lk(state->mutex);
+                    if (state->generation == generation) {
+                        state->pendingId = boost::none;
+                    }
+                }
+
+                if (result == -ETIME) {
+                    promise.emplaceValue();
+                } else {
+                    LOG(2) << "Timer received error: " << errnoToStatus(-result);
+                    promise.setError(errnoToStatus(-result));
+                }
+            });
+
+        return std::move(pf.future);
+    }
+
+private:
+    struct State {
+        stdx::mutex mutex;
+        uint64_t generation = 0;
+        boost::optional<uint64_t> pendingId;
+    };
+
+    UringReactor* const _reactor;
+    const std::shared_ptr<State> _state;
+};
+
+std::unique_ptr<ReactorTimer> TransportLayerUring::UringReactor::makeTimer() {
+    return stdx::make_unique<UringReactorTimer>(this);
+}
+
+class TransportLayerUring::UringSession final : public Session {
+    MONGO_DISALLOW_COPYING(UringSession);
+
+public:
+    /**
+     * Configures the accepted socket 'fd' and wraps it in a session, which then owns it. Throws
+     * a DBException, after closing 'fd', if the socket can't be configured.
+     */
+    static std::shared_ptr<UringSession> make(TransportLayerUring* tl, int fd) {
+        auto guard = MakeGuard([&] { ::close(fd); });
+
+        sockaddr_storage localAddr;
+        socklen_t localLen = sizeof(localAddr);
+        sockaddr_storage remoteAddr;
+        socklen_t remoteLen = sizeof(remoteAddr);
+        if (::getsockname(fd, reinterpret_cast<sockaddr*>(&localAddr), &localLen) != 0 ||
+            ::getpeername(fd, reinterpret_cast<sockaddr*>(&remoteAddr), &remoteLen) != 0) {
+            uasserted(ErrorCodes::SocketException, errnoWithDescription());
+        }
+
+        if (localAddr.ss_family == AF_INET || localAddr.ss_family == AF_INET6) {
+            const int on = 1;
+            if (::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)) != 0 ||
+                ::setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on)) != 0) {
+                uasserted(ErrorCodes::SocketException, errnoWithDescription());
+            }
+            setSocketKeepAliveParams(fd);
+        }
+
+        auto session = std::make_shared<UringSession>(tl,
+                                                      fd,
+                                                      HostAndPort(SockAddr(localAddr, localLen)),
+                                                      HostAndPort(SockAddr(remoteAddr, remoteLen)));
+        guard.Dismiss();
+        return session;
+    }
+
+    UringSession(TransportLayerUring* tl, int fd, HostAndPort local, HostAndPort remote)
+        : _tl(tl),
+          _reactor(tl->_ingressReactor.get()),
+          _fd(fd),
+          _local(std::move(local)),
+          _remote(std::move(remote)) {}
+
+    ~UringSession() {
+        end();
+        if (_registeredBuffer >= 0) {
+            _reactor->releaseBuffer(_registeredBuffer);
+        }
+        ::close(_fd);
+    }
+
+    TransportLayer* getTransportLayer() const override {
+        return _tl;
+    }
+
+    const HostAndPort& remote() const override {
+        return _remote;
+    }
+
+    const HostAndPort& local() const override {
+        return _local;
+    }
+
+    void end() override {
+        if (_ended.swap(true)) {
+            return;
+        }
+
+        cancelAsyncOperations();
+        if (::shutdown(_fd, SHUT_RDWR) != 0 && errno != ENOTCONN) {
+            error() << "Error shutting down socket: " << errnoWithDescription();
+        }
+    }
+
+    StatusWith<Message> sourceMessage() override {
+        _ensureSync();
+
+        for (;;) {
+            if (auto message = _takeBufferedMessage()) {
+                return std::move(*message);
+            }
+
+            const auto target = _receiveTarget();
+            const ssize_t received = ::recv(_fd, target.first, target.second, 0);
+            if (received > 0) {
+                _onReceived(received);
+            } else if (received == 0) {
+                return connectionClosedStatus();
+            } else if (errno != EINTR) {
+                return errnoToStatus(errno);
+            }
+        }
+    }
+
+    Future<Message> asyncSourceMessage(const transport::BatonHandle& baton = nullptr) override {
+        _ensureAsync();
+        return _asyncSourceMessage();
+    }
+
+    Status sinkMessage(Message message) override {
+        _ensureSync();
+        message.flatten();
+
+        const char* data = message.buf();
+        size_t remaining = message.size();
+        while (remaining) {
+            const ssize_t sent = ::send(_fd, data, remaining, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errnoToStatus(errno);
+            }
+            data += sent;
+            remaining -= sent;
+        }
+
+        networkCounter.hitPhysicalOut(message.size());
+        return Status::OK();
+    }
+
+    Future<void> asyncSinkMessage(Message message,
+                                  const transport::BatonHandle& baton = nullptr) override {
+        _ensureAsync();
+        message.flatten();
+        return _asyncSend(std::move(message), 0);
+    }
+
+    void cancelAsyncOperations(const transport::BatonHandle& baton = nullptr) override {
+        LOG(3) << "Cancelling outstanding I/O operations on connection to " << _remote;
+
+        stdx::lock_guard<stdx::mutex> lk(_opsMutex);
+        if (_receiveOpId) {
+            _reactor->cancel(*_receiveOpId);
+        }
+        if (_sendOpId) {
+            _reactor->cancel(*_sendOpId);
+        }
+    }
+
+    void setTimeout(boost::optional<Milliseconds> timeout) override {
+        invariant(!timeout || timeout->count() > 0);
+        _configuredTimeout = timeout;
+    }
+
+    bool isConnected() override {
+        if (_ended.load()) {
+            return false;
+        }
+        if (_readEnd > _readStart) {
+            return true;
+        }
+
+        pollfd pollFd = {_fd, POLLIN, 0};
+        int ret;
+        do {
+            ret = ::poll(&pollFd, 1, 0);
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret == 0) {
+            return true;
+        } else if (ret < 0) {
+            warning() << "Failed to poll socket for connectivity check: "
+                      << errnoWithDescription();
+            return false;
+        }
+
+        if (pollFd.revents & POLLIN) {
+            char testByte;
+            const int size = ::recv(_fd, &testByte, sizeof(testByte), MSG_PEEK);
+            if (size == sizeof(testByte)) {
+                return true;
+            } else if (size == -1) {
+                warning() << "Failed to check socket connectivity: " << errnoWithDescription();
+            }
+            // If size == 0 then we got disconnected and we should return false.
+        }
+
+        return false;
+    }
+
+private:
+    void _ensureSync() {
+        if (_blockingMode != Sync) {
+            invariant(_blockingMode == Unknown);
+            _allocateReceiveBuffer(false);
+            _blockingMode = Sync;
+        }
+
+        if (_socketTimeout != _configuredTimeout) {
+            // A zero value for the socket option means no timeout.
+            const auto timeout = _configuredTimeout.value_or(Milliseconds{0});
+            timeval tv;
+            tv.tv_sec = durationCount<Seconds>(timeout);
+            tv.tv_usec = durationCount<Microseconds>(timeout - Seconds(tv.tv_sec));
+            if (::setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) != 0 ||
+                ::setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) != 0) {
+                uasserted(ErrorCodes::SocketException, errnoWithDescription());
+            }
+            _socketTimeout = _configuredTimeout;
+        }
+    }
+
+    void _ensureAsync() {
+        if (_blockingMode == Async)
+            return;
+        invariant(_blockingMode == Unknown);
+
+        // Socket timeouts currently only effect synchronous calls, so make sure the caller isn't
+        // expecting a socket timeout when they do an async operation.
+        invariant(!_configuredTimeout);
+
+        _allocateReceiveBuffer(true);
+        _blockingMode = Async;
+    }
+
+    void _allocateReceiveBuffer(bool tryRegistered) {
+        _readBufferSize = _tl->_listenerOptions.receiveBufferSize;
+        if (tryRegistered) {
+            _registeredBuffer = _reactor->acquireBuffer();
+        }
+
+        if (_registeredBuffer >= 0) {
+            _readBuffer = _reactor->bufferData(_registeredBuffer);
+        } else {
+            _ownedReadBuffer.reset(new char[_readBufferSize]);
+            _readBuffer = _ownedReadBuffer.get();
+        }
+    }
+
+    /**
+     * Returns the next complete message out of what was received so far, or boost::none if more
+     * has to be received first.
+     */
+    boost::optional<StatusWith<Message>> _takeBufferedMessage() {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        if (_largeMessage) {
+            if (_largeMessageReceived < _largeMessageLen) {
+                return boost::none;
+            }
+            _largeMessageLen = 0;
+            _largeMessageReceived = 0;
+            return StatusWith<Message>(_finishMessage(std::move(_largeMessage)));
+        }
+
+        const size_t available = _readEnd - _readStart;
+        const char* data = _readBuffer + _readStart;
+        if (available >= kHeaderSize) {
+            if (StringData(data, 4) == "GET "_sd) {
+                return StatusWith<Message>(_sendHTTPResponse());
+            }
+
+            const auto msgLen = size_t(MSGHEADER::ConstView(data).getMessageLength());
+            if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+                StringBuilder sb;
+                sb << "recv(): message msgLen " << msgLen << " is invalid. "
+                   << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+                const auto str = sb.str();
+                LOG(0) << str;
+
+                return StatusWith<Message>(ErrorCodes::ProtocolError, str);
+            }
+
+            if (available >= msgLen) {
+                auto buffer = SharedBuffer::allocate(msgLen);
+                memcpy(buffer.get(), data, msgLen);
+                _consume(msgLen);
+                return StatusWith<Message>(_finishMessage(std::move(buffer)));
+            }
+
+            if (msgLen > _readBufferSize) {
+                // Receive the rest of a message which doesn't fit the receive buffer straight
+                // into the message's own buffer.
+                _largeMessage = SharedBuffer::allocate(msgLen);
+                memcpy(_largeMessage.get(), data, available);
+                _largeMessageLen = msgLen;
+                _largeMessageReceived = available;
+                _consume(available);
+                return boost::none;
+            }
+        }
+
+        // Move the start of a partially received message to the front of the buffer, so that
+        // the rest of it fits.
+        if (_readStart > 0) {
+            memmove(_readBuffer, data, available);
+            _readStart = 0;
+            _readEnd = available;
+        }
+        return boost::none;
+    }
+
+    void _consume(size_t bytes) {
+        _readStart += bytes;
+        if (_readStart == _readEnd) {
+            _readStart = 0;
+            _readEnd = 0;
+        }
+    }
+
+    Message _finishMessage(SharedBuffer buffer) {
+        networkCounter.hitPhysicalIn(MSGHEADER::ConstView(buffer.get()).getMessageLength());
+        return Message(std::move(buffer));
+    }
+
+    std::pair<char*, size_t> _receiveTarget() {
+        if (_largeMessage) {
+            return {_largeMessage.get() + _largeMessageReceived,
+                    _largeMessageLen - _largeMessageReceived};
+        }
+        return {_readBuffer + _readEnd, _readBufferSize - _readEnd};
+    }
+
+    void _onReceived(size_t bytes) {
+        if (_largeMessage) {
+            _largeMessageReceived += bytes;
+        } else {
+            _readEnd += bytes;
+        }
+    }
+
+    std::shared_ptr<UringSession> _self() {
+        return std::static_pointer_cast<UringSession>(shared_from_this());
+    }
+
+    Future<Message> _asyncSourceMessage() {
+        if (auto message = _takeBufferedMessage()) {
+            return Future<Message>::makeReady(std::move(*message));
+        }
+        return _asyncReceive().then([this] { return _asyncSourceMessage(); });
+    }
+
+    Future<void> _asyncReceive() {
+        if (_ended.load()) {
+            return Future<void>::makeReady(connectionClosedStatus());
+        }
+
+        auto pf = makePromiseFuture<void>();
+        const auto target = _receiveTarget();
+        const int bufIndex = _largeMessage ? -1 : _registeredBuffer;
+
+        // The completion holds a reference to the session, which keeps the socket and the
+        // receive buffer alive until the kernel is done with them.
+        stdx::lock_guard<stdx::mutex> lk(_opsMutex);
+        _receiveOpId = _reactor->submit(
+            [this, target, bufIndex](IoUring& ring, uint64_t id) {
+                return bufIndex >= 0
+                    ? ring.prepReadFixed(_fd, target.first, target.second, bufIndex, id)
+                    : ring.prepRecv(_fd, target.first, target.second, id);
+            },
+            [ this, self = _self(), promise = std::move(pf.promise) ](int result) mutable {
+                if (result > 0) {
+                    _onReceived(result);
+                    promise.emplaceValue();
+                } else if (result == 0) {
+                    promise.setError(connectionClosedStatus());
+                } else {
+                    promise.setError(errnoToStatus(-result));
+                }
+            });
+
+        return std::move(pf.future);
+    }
+
+    Future<void> _asyncSend(Message message, size_t offset) {
+        if (_ended.load()) {
+            return Future<void>::makeReady(connectionClosedStatus());
+        }
+
+        auto pf = makePromiseFuture<size_t>();
+        const char* data = message.buf() + offset;
+        const size_t len = message.size() - offset;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_opsMutex);
+            _sendOpId = _reactor->submit(
+                [this, data, len](IoUring& ring, uint64_t id) {
+                    return ring.prepSend(_fd, data, len, id);
+                },
+                [ self = _self(), promise = std::move(pf.promise) ](int result) mutable {
+                    if (result > 0) {
+                        promise.emplaceValue(result);
+                    } else if (result == 0) {
+                        promise.setError(connectionClosedStatus());
+                    } else {
+                        promise.setError(errnoToStatus(-result));
+                    }
+                });
+        }
+
+        // The continuation keeps the message's buffer alive until it has been sent.
+        return std::move(pf.future).then(
+            [ this, message = std::move(message), offset ](size_t sent) mutable {
+                offset += sent;
+                if (offset < message.size()) {
+                    return _asyncSend(std::move(message), offset);
+                }
+                networkCounter.hitPhysicalOut(message.size());
+                return Future<void>::makeReady();
+            });
+    }
+
+    // Called when a client sends an HTTP request over a native MongoDB port. The response is
+    // small, so it is sent without blocking and without waiting for the ring.
+    Status _sendHTTPResponse() {
+        constexpr auto userMsg =
+            "It looks like you are trying to access MongoDB over HTTP"
+            " on the native driver port.\r\n"_sd;
+
+        static const std::string httpResp = str::stream() << "HTTP/1.0 200 OK\r\n"
+                                                             "Connection: close\r\n"
+                                                             "Content-Type: text/plain\r\n"
+                                                             "Content-Length: "
+                                                          << userMsg.size() << "\r\n\r\n"
+                                                          << userMsg;
+
+        if (::send(_fd, httpResp.data(), httpResp.size(), MSG_NOSIGNAL | MSG_DONTWAIT) < 0) {
+            return Status(ErrorCodes::ProtocolError,
+                          str::stream()
+                              << "Client sent an HTTP request over a native MongoDB connection, "
+                                 "but there was an error sending a response: "
+                              << errnoWithDescription());
+        }
+        return Status(ErrorCodes::ProtocolError,
+                      "Client sent an HTTP request over a native MongoDB connection");
+    }
+
+    enum BlockingMode {
+        Unknown,
+        Sync,
+        Async,
+    };
+
+    TransportLayerUring* const _tl;
+    UringReactor* const _reactor;
+    const int _fd;
+    const HostAndPort _local;
+    const HostAndPort _remote;
+
+    AtomicWord<bool> _ended{false};
+    BlockingMode _blockingMode = Unknown;
+
+    boost::optional<Milliseconds> _configuredTimeout;
+    boost::optional<Milliseconds> _socketTimeout;
+
+    // Bytes received but not yet consumed are in [_readStart, _readEnd) of the receive buffer,
+    // which is either registered with the ring or owned by the session.
+    char* _readBuffer = nullptr;
+    size_t _readBufferSize = 0;
+    int _registeredBuffer = -1;
+    std::unique_ptr<char[]> _ownedReadBuffer;
+    size_t _readStart = 0;
+    size_t _readEnd = 0;
+
+    // A message too large for the receive buffer, which is being received into its own buffer.
+    SharedBuffer _largeMessage;
+    size_t _largeMessageLen = 0;
+    size_t _largeMessageReceived = 0;
+
+    // Ids of the last receive and send submitted, for cancelAsyncOperations().
+    stdx::mutex _opsMutex;
+    boost::optional<uint64_t> _receiveOpId;
+    boost::optional<uint64_t> _sendOpId;
+};
+
+TransportLayerUring::Options::Options(const ServerGlobalParams* params)
+    : port(params->port),
+      ipList(params->bind_ips),
+      useUnixSockets(!params->noUnixSocket),
+      enableIPv6(params->enableIPv6) {}
+
+TransportLayerUring::TransportLayerUring(const Options& opts, ServiceEntryPoint* sep)
+    : _ingressReactor(std::make_shared<UringReactor>()),
+      _acceptorReactor(std::make_shared<UringReactor>()),
+      _sep(sep),
+      _listenerOptions(opts) {}
+
+TransportLayerUring::~TransportLayerUring() {
+    for (auto& listener : _listeners) {
+        ::close(listener.second);
+    }
+}
+
+StatusWith<SessionHandle> TransportLayerUring::connect(HostAndPort peer,
+                                                       ConnectSSLMode sslMode,
+                                                       Milliseconds timeout) {
+    return Status(ErrorCodes::IllegalOperation,
+                  "The uring transport layer does not support outgoing connections");
+}
+
+Future<SessionHandle> TransportLayerUring::asyncConnect(HostAndPort peer,
+                                                        ConnectSSLMode sslMode,
+                                                        const ReactorHandle& reactor,
+                                                        Milliseconds timeout) {
+    return Future<SessionHandle>::makeReady(
+        Status(ErrorCodes::IllegalOperation,
+               "The uring transport layer does not support outgoing connections"));
+}
+
+Status TransportLayerUring::setup() {
+#ifdef MONGO_CONFIG_SSL
+    if (sslGlobalParams.sslMode.load() != SSLParams::SSLMode_disabled) {
+        return {ErrorCodes::InvalidOptions, "The uring transport layer does not support TLS"};
+    }
+#endif
+
+    auto status = _ingressReactor->init(_listenerOptions.ringEntries,
+                                        _listenerOptions.numRegisteredBuffers,
+                                        _listenerOptions.receiveBufferSize);
+    if (!status.isOK()) {
+        return status;
+    }
+    status = _acceptorReactor->init(kSmallRingEntries, 0, 0);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    std::vector<std::string> listenAddrs;
+    if (_listenerOptions.ipList.empty()) {
+        listenAddrs = {"127.0.0.1"};
+        if (_listenerOptions.enableIPv6) {
+            listenAddrs.emplace_back("::1");
+        }
+    } else {
+        listenAddrs = _listenerOptions.ipList;
+    }
+
+    if (_listenerOptions.useUnixSockets) {
+        listenAddrs.emplace_back(makeUnixSockPath(_listenerOptions.port));
+    }
+
+    _listenerPort = _listenerOptions.port;
+    for (auto& ip : listenAddrs) {
+        if (ip.empty()) {
+            warning() << "Skipping empty bind address";
+            continue;
+        }
+
+        auto addrs = SockAddr::createAll(
+            ip, _listenerPort, _listenerOptions.enableIPv6 ? AF_UNSPEC : AF_INET);
+        if (addrs.empty()) {
+            warning() << "Found no addresses for " << ip;
+            continue;
+        }
+
+        for (auto& addr : addrs) {
+            if (addr.getType() == AF_UNIX) {
+                if (::unlink(addr.getAddr().c_str()) == -1 && errno != ENOENT) {
+                    error() << "Failed to unlink socket file " << addr.getAddr() << " "
+                            << errnoWithDescription(errno);
+                    fassertFailedNoTrace(51004);
+                }
+            }
+            if (addr.getType() == AF_INET6 && !_listenerOptions.enableIPv6) {
+                error() << "Specified ipv6 bind address, but ipv6 is disabled";
+                fassertFailedNoTrace(51005);
+            }
+
+            const int fd = ::socket(addr.getType(), SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                return errnoToStatus(errno);
+            }
+            _listeners.emplace_back(addr, fd);
+
+            const int on = 1;
+            if (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0) {
+                return errnoToStatus(errno);
+            }
+            if (addr.getType() == AF_INET6 &&
+                ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on)) != 0) {
+                return errnoToStatus(errno);
+            }
+
+            if (::bind(fd, addr.raw(), addr.addressSize) != 0) {
+                return errnoToStatus(errno);
+            }
+
+            if (addr.getType() == AF_UNIX) {
+                if (::chmod(addr.getAddr().c_str(), serverGlobalParams.unixSocketPermissions) ==
+                    -1) {
+                    error() << "Failed to chmod socket file " << addr.getAddr() << " "
+                            << errnoWithDescription(errno);
+                    fassertFailedNoTrace(51006);
+                }
+            }
+
+            if (_listenerOptions.port == 0 &&
+                (addr.getType() == AF_INET || addr.getType() == AF_INET6)) {
+                if (_listenerPort != _listenerOptions.port) {
+                    return Status(ErrorCodes::BadValue,
+                                  "Port 0 (ephemeral port) is not allowed when"
+                                  " listening on multiple IP interfaces");
+                }
+
+                sockaddr_storage boundAddr;
+                socklen_t boundLen = sizeof(boundAddr);
+                if (::getsockname(fd, reinterpret_cast<sockaddr*>(&boundAddr), &boundLen) != 0) {
+                    return errnoToStatus(errno);
+                }
+                _listenerPort = SockAddr(boundAddr, boundLen).getPort();
+            }
+        }
+    }
+
+    if (_listeners.empty()) {
+        return Status(ErrorCodes::SocketException, "No available addresses/ports to bind to");
+    }
+
+    return Status::OK();
+}
+
+Status TransportLayerUring::start() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _running.store(true);
+
+    for (auto& listener : _listeners) {
+        if (::listen(listener.second, serverGlobalParams.listenBacklog) != 0) {
+            return errnoToStatus(errno);
+        }
+        _acceptConnection(listener.second);
+    }
+
+    _listenerThread = stdx::thread([this] {
+        setThreadName("listener");
+        while (_running.load()) {
+            _acceptorReactor->run();
+        }
+    });
+
+    log() << "waiting for connections on port " << _listenerPort << " using io_uring";
+    return Status::OK();
+}
+
+void TransportLayerUring::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _running.store(false);
+
+    // Shutting down the listening sockets fails their outstanding accepts, which prevents new
+    // connections from being opened.
+    for (auto& listener : _listeners) {
+        ::shutdown(listener.second, SHUT_RDWR);
+        auto& addr = listener.first;
+        if (addr.getType() == AF_UNIX && !addr.isAnonymousUNIXSocket()) {
+            auto path = addr.getAddr();
+            log() << "removing socket file: " << path;
+            if (::unlink(path.c_str()) != 0) {
+                const auto ewd = errnoWithDescription();
+                warning() << "Unable to remove UNIX socket " << path << ": " << ewd;
+            }
+        }
+    }
+
+    if (_listenerThread.joinable()) {
+        _acceptorReactor->stop();
+        _listenerThread.join();
+    }
+}
+
+ReactorHandle TransportLayerUring::getReactor(WhichReactor which) {
+    switch (which) {
+        case TransportLayer::kIngress:
+            return _ingressReactor;
+        case TransportLayer::kEgress:
+            // Outgoing connections are made by the ASIO transport layer, with its own reactor.
+            return nullptr;
+        case TransportLayer::kNewReactor: {
+            auto reactor = std::make_shared<UringReactor>();
+            uassertStatusOK(reactor->init(kSmallRingEntries, 0, 0));
+            return std::move(reactor);
+        }
+    }
+
+    MONGO_UNREACHABLE;
+}
+
+void TransportLayerUring::_acceptConnection(int listenerFd) {
+    _acceptorReactor->submit(
+        [listenerFd](IoUring& ring, uint64_t id) { return ring.prepAccept(listenerFd, id); },
+        [this, listenerFd](int result) {
+            if (!_running.load()) {
+                if (result >= 0) {
+                    ::close(result);
+                }
+                return;
+            }
+
+            if (result < 0) {
+                log() << "Error accepting new connection: " << errnoWithDescription(-result);
+            } else {
+                try {
+                    _sep->startSession(UringSession::make(this, result));
+                } catch (const DBException& e) {
+                    warning() << "Error accepting new connection " << e;
+                }
+            }
+
+            _acceptConnection(listenerFd);
+        });
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/net/sockaddr.h"
+
+namespace mongo {
+
+class ServiceEntryPoint;
+
+namespace transport {
+
+/**
+ * An ingress-only TransportLayer for Linux which performs network I/O through io_uring.
+ *
+ * Sessions which are driven asynchronously, as they are by the adaptive service executor, queue
+ * their receives and sends on a shared ring. Whichever thread runs the reactor next hands every
+ * queued operation to the kernel with one system call and collects all completed operations with
+ * the same call, so the number of system calls no longer grows with the number of messages.
+ * Receives read straight into buffers registered with the ring, and read ahead as much as the
+ * buffer holds, so a small message's header and body arrive together.
+ *
+ * Synchronous sessions use plain blocking system calls, but share the read-ahead buffering.
+ *
+ * Outgoing connections and TLS are not supported: the server pairs this with an egress-only
+ * TransportLayerASIO, and refuses to start with TLS enabled.
+ */
+class TransportLayerUring final : public TransportLayer {
+    MONGO_DISALLOW_COPYING(TransportLayerUring);
+
+public:
+    struct Options {
+        explicit Options(const ServerGlobalParams* params);
+        Options() = default;
+
+        int port = ServerGlobalParams::DefaultDBPort;  // port to bind to
+        std::vector<std::string> ipList;               // addresses to bind to
+        bool useUnixSockets = true;                    // whether to allow UNIX sockets in ipList
+        bool enableIPv6 = false;                       // whether to allow IPv6 sockets in ipList
+
+        unsigned ringEntries = 4096;           // submission queue size of the ingress ring
+        size_t numRegisteredBuffers = 1024;    // receive buffers registered with the ingress ring
+        size_t receiveBufferSize = 16 * 1024;  // size of each session's receive buffer
+    };
+
+    TransportLayerUring(const Options& opts, ServiceEntryPoint* sep);
+
+    ~TransportLayerUring();
+
+    StatusWith<SessionHandle> connect(HostAndPort peer,
+                                      ConnectSSLMode sslMode,
+                                      Milliseconds timeout) final;
+
+    Future<SessionHandle> asyncConnect(HostAndPort peer,
+                                       ConnectSSLMode sslMode,
+                                       const ReactorHandle& reactor,
+                                       Milliseconds timeout) final;
+
+    Status setup() final;
+
+    Status start() final;
+
+    void shutdown() final;
+
+    ReactorHandle getReactor(WhichReactor which) final;
+
+    int listenerPort() const {
+        return _listenerPort;
+    }
+
+private:
+    class UringReactor;
+    class UringReactorTimer;
+    class UringSession;
+
+    void _acceptConnection(int listenerFd);
+
+    stdx::mutex _mutex;
+
+    // The ingress reactor drives async sessions, and is run by the service executor. The
+    // acceptor reactor only accepts new connections, and is run by the listener thread.
+    std::shared_ptr<UringReactor> _ingressReactor;
+    std::shared_ptr<UringReactor> _acceptorReactor;
+
+    std::vector<std::pair<SockAddr, int>> _listeners;
+    stdx::thread _listenerThread;
+
+    ServiceEntryPoint* const _sep = nullptr;
+    AtomicWord<bool> _running{false};
+    Options _listenerOptions;
+    int _listenerPort = 0;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,303 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_uring.h"
+
+#include "mongo/db/server_options.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/net/sock.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Sends every message received on a session back to its client, either from a thread per
+ * session or by chaining async operations on the transport layer's ingress reactor.
+ */
+class EchoSEP : public ServiceEntryPoint {
+public:
+    explicit EchoSEP(bool async) : _async(async) {}
+
+    ~EchoSEP() {
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    void startSession(transport::SessionHandle session) override {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            ++_numOpenSessions;
+        }
+
+        if (_async) {
+            _asyncEcho(std::move(session));
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _threads.emplace_back([ this, session = std::move(session) ] {
+            for (;;) {
+                auto swMessage = session->sourceMessage();
+                if (!swMessage.isOK()) {
+                    break;
+                }
+                if (!session->sinkMessage(std::move(swMessage.getValue())).isOK()) {
+                    break;
+                }
+            }
+            _onSessionEnded();
+        });
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {
+        MONGO_UNREACHABLE;
+    }
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _numOpenSessions;
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+    void waitForSessionsToEnd() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [&] { return _numOpenSessions == 0; });
+    }
+
+private:
+    void _asyncEcho(transport::SessionHandle session) {
+        session->asyncSourceMessage()
+            .then([session](Message message) {
+                return session->asyncSinkMessage(std::move(message));
+            })
+            .getAsync([ this, session ](Status status) {
+                if (status.isOK()) {
+                    _asyncEcho(std::move(session));
+                } else {
+                    _onSessionEnded();
+                }
+            });
+    }
+
+    void _onSessionEnded() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        --_numOpenSessions;
+        _cv.notify_all();
+    }
+
+    const bool _async;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    size_t _numOpenSessions = 0;
+    std::vector<stdx::thread> _threads;
+};
+
+/**
+ * Sets up a uring transport layer on an ephemeral port, along with threads which run its ingress
+ * reactor when the sessions are async.
+ */
+class UringFixture {
+public:
+    explicit UringFixture(bool async) : _sep(async), _tl(_makeOptions(), &_sep) {}
+
+    ~UringFixture() {
+        if (_started) {
+            _sep.waitForSessionsToEnd();
+            _reactor->stop();
+            for (auto& thread : _reactorThreads) {
+                thread.join();
+            }
+            _tl.shutdown();
+        }
+    }
+
+    /**
+     * Starts the transport layer, or returns false if this kernel does not support io_uring.
+     */
+    bool start() {
+        auto status = _tl.setup();
+        if (status == ErrorCodes::InvalidOptions) {
+            log() << "Skipping test: " << status;
+            return false;
+        }
+        ASSERT_OK(status);
+        ASSERT_OK(_tl.start());
+        ASSERT_GT(_tl.listenerPort(), 0);
+
+        _reactor = _tl.getReactor(transport::TransportLayer::kIngress);
+        for (int i = 0; i < 2; ++i) {
+            _reactorThreads.emplace_back([this] { _reactor->run(); });
+        }
+        _started = true;
+        return true;
+    }
+
+    std::unique_ptr<Socket> connect() {
+        auto socket = stdx::make_unique<Socket>();
+        SockAddr sa{"localhost", _tl.listenerPort(), AF_INET};
+        ASSERT_TRUE(socket->connect(sa));
+        return socket;
+    }
+
+    transport::ReactorHandle reactor() {
+        return _reactor;
+    }
+
+private:
+    static transport::TransportLayerUring::Options _makeOptions() {
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        transport::TransportLayerUring::Options opts(&params);
+        opts.port = 0;
+        opts.ringEntries = 64;
+        opts.numRegisteredBuffers = 4;
+        return opts;
+    }
+
+    EchoSEP _sep;
+    transport::TransportLayerUring _tl;
+    transport::ReactorHandle _reactor;
+    std::vector<stdx::thread> _reactorThreads;
+    bool _started = false;
+};
+
+Message makeMessage(size_t payloadSize) {
+    return OpMsgRequest::fromDBAndBody(
+               "admin", BSON("ping" << 1 << "payload" << std::string(payloadSize, 'x')))
+        .serialize();
+}
+
+void sendMessages(Socket* socket, const std::vector<Message>& messages) {
+    std::string data;
+    for (const auto& message : messages) {
+        data.append(message.buf(), message.size());
+    }
+    socket->send(data.data(), data.size(), "sendMessages");
+}
+
+void assertEchoed(Socket* socket, const Message& message) {
+    std::unique_ptr<char[]> echoed(new char[message.size()]);
+    socket->recv(echoed.get(), message.size());
+    ASSERT_EQ(0, memcmp(echoed.get(), message.buf(), message.size()));
+}
+
+void runEchoTests(bool async) {
+    UringFixture fixture(async);
+    if (!fixture.start()) {
+        return;
+    }
+
+    auto first = fixture.connect();
+    auto second = fixture.connect();
+
+    // A single small message, on each of two sessions.
+    for (auto socket : {first.get(), second.get()}) {
+        auto message = makeMessage(10);
+        sendMessages(socket, {message});
+        assertEchoed(socket, message);
+    }
+
+    // Several messages received in a single read.
+    std::vector<Message> pipelined;
+    for (int i = 0; i < 20; ++i) {
+        pipelined.push_back(makeMessage(i * 10));
+    }
+    sendMessages(first.get(), pipelined);
+    for (const auto& message : pipelined) {
+        assertEchoed(first.get(), message);
+    }
+
+    // A message larger than the receive buffer, followed by one which arrives with its tail.
+    auto large = makeMessage(1024 * 1024);
+    auto small = makeMessage(100);
+    sendMessages(second.get(), {large, small});
+    assertEchoed(second.get(), large);
+    assertEchoed(second.get(), small);
+
+    first->close();
+    second->close();
+}
+
+TEST(TransportLayerUring, SyncEcho) {
+    runEchoTests(false);
+}
+
+TEST(TransportLayerUring, AsyncEcho) {
+    runEchoTests(true);
+}
+
+TEST(TransportLayerUring, ReactorTimer) {
+    UringFixture fixture(true);
+    if (!fixture.start()) {
+        return;
+    }
+
+    auto reactor = fixture.reactor();
+    auto timer = reactor->makeTimer();
+    const auto start = reactor->now();
+    ASSERT_OK(timer->waitUntil(start + Milliseconds(50)).getNoThrow());
+    ASSERT_GTE(reactor->now() - start, Milliseconds(40));
+
+    auto future = timer->waitUntil(reactor->now() + Hours(1));
+    timer->cancel();
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, future.getNoThrow());
+
+    auto scheduled = makePromiseFuture<void>();
+    reactor->schedule(transport::Reactor::kPost,
+                      [&] { scheduled.promise.emplaceValue(); });
+    ASSERT_OK(std::move(scheduled.future).getNoThrow());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,65 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace mongo {
+
+/**
+ * Hooks through which an allocator that keeps freed memory around for reuse reports how much it
+ * holds and returns it to the operating system. These functions *must not throw*.
+ */
+struct AllocatorFreeMemoryHooks {
+    // Returns the number of free bytes the allocator holds which could be returned.
+    size_t (*freeBytes)();
+
+    // Returns up to the given number of free bytes to the operating system and returns how many
+    // bytes were actually returned.
+    size_t (*release)(size_t bytes);
+};
+
+/**
+ * Registers the hooks of the allocator in use. This is done by TCMalloc at startup. Calling this
+ * is not thread-safe.
+ */
+void registerAllocatorFreeMemoryHooks(AllocatorFreeMemoryHooks hooks);
+
+/**
+ * Returns the number of free bytes the allocator holds, or 0 if no hooks are registered.
+ */
+size_t allocatorFreeBytes();
+
+/**
+ * Asks the allocator to return up to 'bytes' of free memory to the operating system. Returns the
+ * number of bytes returned, which is 0 if no hooks are registered.
+ */
+size_t releaseAllocatorFreeBytes(size_t bytes);
+
+}  // namespace mongo
@@ -29,11 +29,14 @@
 #include "mongo/platform/basic.h"
 
 #include <benchmark/benchmark.h>
+#include <ctime>
 
 #include "mongo/util/clock_source.h"
 #include "mongo/util/fast_clock_source_factory.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/system_clock_source.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -75,5 +78,44 @@ BENCHMARK(BM_ClockNow)
     ->Arg(1)
     ->Arg(10);
 
+/**
+ * Benchmark reads of the system tick source, which backs Timer and CurOp's operation timing. On
+ * machines with a reliable cycle counter this reads it directly, and otherwise it falls back to
+ * clock_gettime(CLOCK_MONOTONIC), which BM_ClockGettimeMonotonic measures for comparison.
+ */
+void BM_SystemTickSourceGetTicks(benchmark::State& state) {
+    auto tickSource = SystemTickSource::get();
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(tickSource->getTicks());
+    }
+}
+
+BENCHMARK(BM_SystemTickSourceGetTicks)->ThreadRange(1, ProcessInfo::getNumAvailableCores());
+
+#if !defined(_WIN32)
+void BM_ClockGettimeMonotonic(benchmark::State& state) {
+    for (auto keepRunning : state) {
+        timespec ts;
+        benchmark::DoNotOptimize(clock_gettime(CLOCK_MONOTONIC, &ts));
+        benchmark::DoNotOptimize(ts);
+    }
+}
+
+BENCHMARK(BM_ClockGettimeMonotonic)->ThreadRange(1, ProcessInfo::getNumAvailableCores());
+#endif
+
+/**
+ * Benchmark starting a Timer and reading its elapsed time, the pattern used to time a single
+ * operation or stage.
+ */
+void BM_TimerStartAndRead(benchmark::State& state) {
+    for (auto keepRunning : state) {
+        Timer timer;
+        benchmark::DoNotOptimize(timer.micros());
+    }
+}
+
+BENCHMARK(BM_TimerStartAndRead);
+
 }  // namespace
 }  // namespace mongo
@@ -135,8 +135,10 @@ void setThreadName(StringData name) {
 #elif defined(__linux__) && defined(MONGO_CONFIG_HAVE_PTHREAD_SETNAME_NP)
     // Do not set thread name on the main() thread. Setting the name on main thread breaks
     // pgrep/pkill since these programs base this name on /proc/*/status which displays the thread
-    // name, not the executable name.
-    if (getpid() != syscall(SYS_gettid)) {
+    // name, not the executable name. Threads that serve sessions rename themselves constantly, so
+    // only pay for the two syscalls of this check once per thread.
+    static thread_local const bool isMainThread = getpid() == syscall(SYS_gettid);
+    if (!isMainThread) {
         //  Maximum thread name length supported on Linux is 16 including the null terminator.
         //  Ideally we use short and descriptive thread names that fit: this helps for log
         //  readability as well. Still, as the limit is so low and a few current names exceed the
@@ -34,9 +34,11 @@
 
 #include "mongo/base/status.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -75,7 +77,11 @@ ThreadPool::Options cleanUpOptions(ThreadPool::Options&& options) {
 
 }  // namespace
 
-ThreadPool::ThreadPool(Options options) : _options(cleanUpOptions(std::move(options))) {}
+ThreadPool::ThreadPool(Options options) : _options(cleanUpOptions(std::move(options))) {
+    if (_options.useWorkStealing) {
+        _workStealingPool = stdx::make_unique<WorkStealingThreadPool>(_options);
+    }
+}
 
 ThreadPool::~ThreadPool() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
@@ -93,6 +99,9 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::startup() {
+    if (_workStealingPool) {
+        return _workStealingPool->startup();
+    }
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     if (_state != preStart) {
         severe() << "Attempting to start pool " << _options.poolName
@@ -109,6 +118,9 @@ void ThreadPool::startup() {
 }
 
 void ThreadPool::shutdown() {
+    if (_workStealingPool) {
+        return _workStealingPool->shutdown();
+    }
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _shutdown_inlock();
 }
@@ -129,6 +141,9 @@ void ThreadPool::_shutdown_inlock() {
 }
 
 void ThreadPool::join() {
+    if (_workStealingPool) {
+        return _workStealingPool->join();
+    }
     try {
         stdx::unique_lock<stdx::mutex> lk(_mutex);
         _join_inlock(&lk);
@@ -191,6 +206,9 @@ void ThreadPool::_drainPendingTasks() {
 }
 
 Status ThreadPool::schedule(Task task) {
+    if (_workStealingPool) {
+        return _workStealingPool->schedule(std::move(task));
+    }
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     switch (_state) {
         case joinRequired:
@@ -220,6 +238,9 @@ Status ThreadPool::schedule(Task task) {
 }
 
 void ThreadPool::waitForIdle() {
+    if (_workStealingPool) {
+        return _workStealingPool->waitForIdle();
+    }
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     // If there are any pending tasks, or non-idle threads, the pool is not idle.
     while (!_pendingTasks.empty() || _numIdleThreads < _threads.size()) {
@@ -228,6 +249,9 @@ void ThreadPool::waitForIdle() {
 }
 
 ThreadPool::Stats ThreadPool::getStats() const {
+    if (_workStealingPool) {
+        return _workStealingPool->getStats();
+    }
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     Stats result;
     result.options = _options;
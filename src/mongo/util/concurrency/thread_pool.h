@@ -29,6 +29,7 @@
 #pragma once
 
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -43,6 +44,7 @@
 namespace mongo {
 
 class Status;
+class WorkStealingThreadPool;
 
 /**
  * A configurable thread pool, for general use.
@@ -82,6 +84,11 @@ public:
         // a thread.
         Milliseconds maxIdleThreadAge = Seconds{30};
 
+        // If true, the pool hands its work to a WorkStealingThreadPool, which gives each thread its
+        // own task queue and runs exactly maxThreads threads for the life of the pool. Suits pools
+        // that are fed many small tasks.
+        bool useWorkStealing = false;
+
         // This function is run before each worker thread begins consuming tasks.
         using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
         OnCreateThreadFn onCreateThread = [](const std::string&) {};
@@ -239,6 +246,10 @@ private:
 
     // The last time that _pendingTasks.size() grew to be at least _threads.size().
     Date_t _lastFullUtilizationDate;
+
+    // Set when _options.useWorkStealing is true, in which case all work is forwarded to it and the
+    // members above are unused.
+    std::unique_ptr<WorkStealingThreadPool> _workStealingPool;
 };
 
 }  // namespace mongo
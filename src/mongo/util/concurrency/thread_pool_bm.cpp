@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace mongo {
+namespace {
+
+// Tasks scheduled per iteration, before waiting for the pool to go idle.
+const int kTasksPerBatch = 1000;
+
+ThreadPool::Options makeOptions(benchmark::State& state) {
+    ThreadPool::Options options;
+    options.minThreads = options.maxThreads = static_cast<size_t>(state.range(0));
+    return options;
+}
+
+/**
+ * Schedules a batch of trivial tasks from a single producer and waits for all of them to run,
+ * which is the pattern of the oplog writer pool.
+ */
+template <typename Pool>
+void runBatches(benchmark::State& state, Pool& pool) {
+    pool.startup();
+    AtomicInt64 counter{0};
+    for (auto keepRunning : state) {
+        for (int i = 0; i < kTasksPerBatch; ++i) {
+            pool.schedule([&counter] { counter.fetchAndAdd(1); }).transitional_ignore();
+        }
+        pool.waitForIdle();
+    }
+    pool.shutdown();
+    pool.join();
+    state.SetItemsProcessed(state.iterations() * kTasksPerBatch);
+}
+
+/**
+ * Each task schedules one follow-up task, so that the workers themselves are producers.
+ */
+template <typename Pool>
+void runFanOut(benchmark::State& state, Pool& pool) {
+    pool.startup();
+    AtomicInt64 counter{0};
+    for (auto keepRunning : state) {
+        for (int i = 0; i < kTasksPerBatch / 2; ++i) {
+            pool.schedule([&pool, &counter] {
+                    counter.fetchAndAdd(1);
+                    pool.schedule([&counter] { counter.fetchAndAdd(1); }).transitional_ignore();
+                })
+                .transitional_ignore();
+        }
+        pool.waitForIdle();
+    }
+    pool.shutdown();
+    pool.join();
+    state.SetItemsProcessed(state.iterations() * kTasksPerBatch);
+}
+
+void BM_ThreadPoolBatch(benchmark::State& state) {
+    ThreadPool pool(makeOptions(state));
+    runBatches(state, pool);
+}
+
+void BM_WorkStealingThreadPoolBatch(benchmark::State& state) {
+    WorkStealingThreadPool pool(makeOptions(state));
+    runBatches(state, pool);
+}
+
+void BM_ThreadPoolFanOut(benchmark::State& state) {
+    ThreadPool pool(makeOptions(state));
+    runFanOut(state, pool);
+}
+
+void BM_WorkStealingThreadPoolFanOut(benchmark::State& state) {
+    WorkStealingThreadPool pool(makeOptions(state));
+    runFanOut(state, pool);
+}
+
+BENCHMARK(BM_ThreadPoolBatch)->RangeMultiplier(2)->Range(1, 16)->ArgName("threads")->UseRealTime();
+BENCHMARK(BM_WorkStealingThreadPoolBatch)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->ArgName("threads")
+    ->UseRealTime();
+BENCHMARK(BM_ThreadPoolFanOut)->RangeMultiplier(2)->Range(1, 16)->ArgName("threads")->UseRealTime();
+BENCHMARK(BM_WorkStealingThreadPoolFanOut)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->ArgName("threads")
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
@@ -35,9 +35,16 @@
 
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+void TicketHolder::_recordQueuedWait(long long micros) {
+    _queuedWaits.fetchAndAdd(1);
+    _queuedMicros.fetchAndAdd(micros);
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -91,6 +98,22 @@ void TicketHolder::waitForTicket(OperationContext* opCtx) {
 }
 
 bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+    return _waitForTicketUntil(opCtx, until, true);
+}
+
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx, Date_t until, bool recordWait) {
+    // Don't read the clock or count a wait when a ticket is available right away.
+    if (tryAcquire())
+        return true;
+
+    Timer timer;
+    _waiters.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] {
+        _waiters.fetchAndSubtract(1);
+        if (recordWait)
+            _recordQueuedWait(timer.micros());
+    });
+
     const Milliseconds intervalMs(500);
     struct timespec ts;
 
@@ -143,8 +166,10 @@ Status TicketHolder::resize(int newSize) {
         _outof.fetchAndAdd(1);
     }
 
+    // Taking tickets out of circulation isn't an operation queueing for one, so it must not count
+    // as a queued wait. Otherwise shrinking would look like a reason to grow again.
     while (_outof.load() > newSize) {
-        waitForTicket();
+        _waitForTicketUntil(nullptr, Date_t::max(), false);
         _outof.subtractAndFetch(1);
     }
 
@@ -179,7 +204,15 @@ bool TicketHolder::tryAcquire() {
 
 void TicketHolder::waitForTicket(OperationContext* opCtx) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_tryAcquire())
+        return;
 
+    Timer timer;
+    _waiters.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] {
+        _waiters.fetchAndSubtract(1);
+        _recordQueuedWait(timer.micros());
+    });
     if (opCtx) {
         opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
     } else {
@@ -189,7 +222,15 @@ void TicketHolder::waitForTicket(OperationContext* opCtx) {
 
 bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
-
+    if (_tryAcquire())
+        return true;
+
+    Timer timer;
+    _waiters.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] {
+        _waiters.fetchAndSubtract(1);
+        _recordQueuedWait(timer.micros());
+    });
     if (opCtx) {
         return opCtx->waitForConditionOrInterruptUntil(
             _newTicket, lk, until, [this] { return _tryAcquire(); });
@@ -32,6 +32,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -79,8 +80,39 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of waits for a ticket which could not be satisfied right away, whether
+     * they got a ticket in the end or not, and the total time spent in them.
+     */
+    long long queuedWaits() const {
+        return _queuedWaits.load();
+    }
+
+    long long queuedMicros() const {
+        return _queuedMicros.load();
+    }
+
+    /**
+     * Returns the number of threads currently blocked waiting for a ticket.
+     */
+    int waiters() const {
+        return _waiters.load();
+    }
+
 private:
+    void _recordQueuedWait(long long micros);
+
+    AtomicInt64 _queuedWaits;
+    AtomicInt64 _queuedMicros;
+    AtomicInt32 _waiters;
+
 #if defined(__linux__)
+    /**
+     * Implements waitForTicketUntil(), only counting the wait in queuedWaits() and queuedMicros()
+     * if 'recordWait' is true.
+     */
+    bool _waitForTicketUntil(OperationContext* opCtx, Date_t until, bool recordWait);
+
     mutable sem_t _sem;
 
     // You can read _outof without a lock, but have to hold _resizeMutex to change.
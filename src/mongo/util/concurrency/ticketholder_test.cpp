@@ -31,8 +31,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
@@ -71,4 +73,40 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, CountsQueuedWaits) {
+    TicketHolder holder(1);
+    ASSERT_EQ(0, holder.queuedWaits());
+
+    // A ticket which is available right away doesn't count as a queued wait.
+    ASSERT(holder.waitForTicketUntil(Date_t::now() + Milliseconds(1)));
+    ASSERT_EQ(0, holder.queuedWaits());
+
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(5)));
+    ASSERT_EQ(1, holder.queuedWaits());
+    ASSERT_GTE(holder.queuedMicros(), 0);
+    holder.release();
+}
+
+#if defined(__linux__)
+// Only the semaphore implementation waits for tickets to come back when shrinking.
+TEST(TicketholderTest, ResizeDoesNotCountQueuedWaits) {
+    TicketHolder holder(2);
+    ASSERT(holder.tryAcquire());
+    ASSERT(holder.tryAcquire());
+
+    // Shrinking while every ticket is in use has to wait for one to come back.
+    stdx::thread shrinker([&] { ASSERT_OK(holder.resize(1)); });
+    while (holder.waiters() == 0) {
+        sleepmillis(1);
+    }
+    holder.release();
+    shrinker.join();
+
+    ASSERT_EQ(1, holder.outof());
+    ASSERT_EQ(0, holder.queuedWaits());
+    ASSERT_EQ(0, holder.queuedMicros());
+    holder.release();
+}
+#endif
 }  // namespace
@@ -0,0 +1,332 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/status.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed pools.
+AtomicInt32 nextUnnamedPoolId{1};
+
+// The pool and queue index of the worker running on this thread, if any. Lets tasks that schedule
+// follow-up work push it onto their own worker's queue.
+thread_local const void* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    invariant(options.maxThreads >= 1);
+    return options;
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))) {
+    _workers.reserve(_options.maxThreads);
+    for (size_t i = 0; i < _options.maxThreads; ++i) {
+        _workers.push_back(stdx::make_unique<Worker>());
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    shutdown();
+    if (_state.load() != shutdownComplete) {
+        join();
+    }
+    invariant(_numUnfinishedTasks.load() == 0);
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state.load() != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(51007);
+    }
+    _setState_inlock(running);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        _workers[i]->thread =
+            stdx::thread([this, i, threadName] { _workerThreadBody(i, threadName); });
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    switch (_state.load()) {
+        case preStart:
+        case running:
+            _setState_inlock(joinRequired);
+            _workAvailable.notify_all();
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    try {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _stateChange.wait(lk, [this] {
+            switch (_state.load()) {
+                case preStart:
+                case running:
+                    return false;
+                case joinRequired:
+                    return true;
+                case joining:
+                case shutdownComplete:
+                    severe() << "Attempted to join pool " << _options.poolName
+                             << " more than once";
+                    fassertFailed(51008);
+            }
+            MONGO_UNREACHABLE;
+        });
+        _setState_inlock(joining);
+        lk.unlock();
+
+        if (_workers.front()->thread.joinable()) {
+            for (auto& worker : _workers) {
+                worker->thread.join();
+            }
+        } else {
+            _drainPendingTasks();
+        }
+
+        lk.lock();
+        _setState_inlock(shutdownComplete);
+    } catch (...) {
+        severe() << "Exception escaped join in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_drainPendingTasks() {
+    // Tasks cannot be run inline because they can create OperationContexts and the join() caller
+    // may already have one associated with the thread.
+    stdx::thread cleanThread = stdx::thread([this] {
+        const std::string threadName = str::stream() << _options.threadNamePrefix
+                                                     << _workers.size();
+        setThreadName(threadName);
+        _options.onCreateThread(threadName);
+        Task task;
+        while (_takeTask(0, &task)) {
+            _runTask(std::move(task));
+        }
+    });
+    cleanThread.join();
+}
+
+Status WorkStealingThreadPool::schedule(Task task) {
+    // Count the task before looking at the state, so that a worker which observes the shutdown
+    // cannot also observe zero unfinished tasks and exit while this task is being queued.
+    _numUnfinishedTasks.fetchAndAdd(1);
+    switch (_state.load()) {
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            _onTaskFinished();
+            return Status(ErrorCodes::ShutdownInProgress,
+                          str::stream() << "Shutdown of thread pool " << _options.poolName
+                                        << " in progress");
+        case preStart:
+        case running:
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+
+    const size_t index = currentPool == this
+        ? currentWorkerIndex
+        : static_cast<size_t>(_nextQueue.fetchAndAdd(1) % _workers.size());
+    auto& worker = *_workers[index];
+    {
+        stdx::lock_guard<stdx::mutex> lk(worker.mutex);
+        worker.tasks.emplace_back(std::move(task));
+    }
+    _numQueuedTasks.fetchAndAdd(1);
+
+    // Pairs with the increment of _numSleepingWorkers in _waitForWork(): either that worker sees
+    // the task counted above, or this thread sees it asleep and wakes it.
+    if (_numSleepingWorkers.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+    return Status::OK();
+}
+
+void WorkStealingThreadPool::waitForIdle() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _poolIsIdle.wait(lk, [this] { return _numUnfinishedTasks.load() == 0; });
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Stats result;
+    result.options = _options;
+    result.numThreads = _numThreads;
+    result.numIdleThreads = static_cast<size_t>(std::max(0LL, _numSleepingWorkers.load()));
+    result.numPendingTasks = static_cast<size_t>(std::max(0LL, _numQueuedTasks.load()));
+    return result;
+}
+
+void WorkStealingThreadPool::_workerThreadBody(size_t workerIndex,
+                                               const std::string& threadName) {
+    setThreadName(threadName);
+    _options.onCreateThread(threadName);
+    LOG(1) << "starting thread in pool " << _options.poolName;
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+    try {
+        _consumeTasks(workerIndex);
+    } catch (...) {
+        severe() << "Exception reached top of stack in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+    currentPool = nullptr;
+    LOG(1) << "shutting down thread in pool " << _options.poolName;
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t workerIndex) {
+    Task task;
+    do {
+        while (_takeTask(workerIndex, &task)) {
+            _runTask(std::move(task));
+        }
+    } while (_waitForWork());
+}
+
+bool WorkStealingThreadPool::_takeTask(size_t workerIndex, Task* task) {
+    {
+        auto& own = *_workers[workerIndex];
+        stdx::lock_guard<stdx::mutex> lk(own.mutex);
+        if (!own.tasks.empty()) {
+            *task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            _numQueuedTasks.subtractAndFetch(1);
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        auto& victim = *_workers[(workerIndex + i) % _workers.size()];
+        stdx::lock_guard<stdx::mutex> lk(victim.mutex);
+        if (!victim.tasks.empty()) {
+            *task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            _numQueuedTasks.subtractAndFetch(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::_runTask(Task task) {
+    try {
+        LOG(3) << "Executing a task on behalf of pool " << _options.poolName;
+        task();
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+    _onTaskFinished();
+}
+
+void WorkStealingThreadPool::_onTaskFinished() {
+    if (_numUnfinishedTasks.subtractAndFetch(1) != 0) {
+        return;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _poolIsIdle.notify_all();
+    if (_isDrained()) {
+        _workAvailable.notify_all();
+    }
+}
+
+bool WorkStealingThreadPool::_waitForWork() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _numSleepingWorkers.fetchAndAdd(1);
+    ON_BLOCK_EXIT([this] { _numSleepingWorkers.subtractAndFetch(1); });
+    while (_numQueuedTasks.load() <= 0) {
+        if (_isDrained()) {
+            return false;
+        }
+        MONGO_IDLE_THREAD_BLOCK;
+        _workAvailable.wait(lk);
+    }
+    return true;
+}
+
+bool WorkStealingThreadPool::_isDrained() const {
+    const auto state = _state.load();
+    return state != preStart && state != running && _numUnfinishedTasks.load() == 0;
+}
+
+void WorkStealingThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state.load()) {
+        return;
+    }
+    _state.store(newState);
+    if (newState == running) {
+        _numThreads = _workers.size();
+    } else if (newState == shutdownComplete) {
+        _numThreads = 0;
+    }
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
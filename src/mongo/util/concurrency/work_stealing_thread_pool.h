@@ -0,0 +1,194 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+
+namespace mongo {
+
+class Status;
+
+/**
+ * A fixed-size thread pool in which every worker owns its own task queue.
+ *
+ * Tasks scheduled from outside the pool are spread round-robin across the workers' queues, and
+ * tasks scheduled by a task running on one of the pool's threads go to that thread's own queue.
+ * A worker whose queue is empty steals from the back of the other workers' queues before going
+ * to sleep. Unlike ThreadPool, scheduling a task does not take a pool-wide lock unless there is
+ * a sleeping worker to wake, which makes this pool a better fit for producers that schedule many
+ * small tasks.
+ *
+ * The pool is configured with ThreadPool::Options. It always runs exactly maxThreads threads from
+ * startup() until join(); minThreads and maxIdleThreadAge are ignored. Tasks on a single queue run
+ * in the order they were scheduled, but there is no ordering between tasks on different queues.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    MONGO_DISALLOW_COPYING(WorkStealingThreadPool);
+
+public:
+    using Options = ThreadPool::Options;
+    using Stats = ThreadPool::Stats;
+
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    Status schedule(Task task) override;
+
+    /**
+     * Blocks the caller until every task scheduled on this pool has finished running.
+     *
+     * Has the same contract as ThreadPool::waitForIdle().
+     */
+    void waitForIdle();
+
+    /**
+     * Returns statistics about the thread pool's utilization. The counts are sampled without
+     * stopping the workers, so they are only approximate while tasks are being scheduled.
+     * lastFullUtilizationDate is not tracked.
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * A worker thread and the queue of tasks it owns. The owner pops from the front of the queue
+     * and thieves take from the back.
+     */
+    struct Worker {
+        stdx::mutex mutex;
+        std::deque<Task> tasks;
+        stdx::thread thread;
+    };
+
+    /**
+     * Same lifecycle as ThreadPool::LifecycleState.
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * Thread body for worker "workerIndex".
+     */
+    void _workerThreadBody(size_t workerIndex, const std::string& threadName);
+
+    /**
+     * Run loop of worker "workerIndex", invoked by _workerThreadBody.
+     */
+    void _consumeTasks(size_t workerIndex);
+
+    /**
+     * Takes a task from worker "workerIndex"'s own queue, or failing that, steals one from
+     * another worker. Returns false if every queue was empty.
+     */
+    bool _takeTask(size_t workerIndex, Task* task);
+
+    /**
+     * Runs "task" and updates the bookkeeping for its completion.
+     */
+    void _runTask(Task task);
+
+    /**
+     * Retires one unit of _numUnfinishedTasks, waking waitForIdle() callers and, after shutdown,
+     * the sleeping workers when it reaches zero.
+     */
+    void _onTaskFinished();
+
+    /**
+     * Puts the calling worker to sleep until there is a queued task or the pool has finished
+     * all of its work after shutdown. Returns false if the worker should exit.
+     */
+    bool _waitForWork();
+
+    /**
+     * Returns true once shutdown has been requested and every scheduled task has finished.
+     */
+    bool _isDrained() const;
+
+    /**
+     * Runs the remaining tasks on a new thread as part of the join process, blocking until
+     * complete. Only used when the pool is joined without ever having been started.
+     */
+    void _drainPendingTasks();
+
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    // One entry per thread; the vector itself is never resized after construction.
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Guards _state transitions and is the mutex for the condition variables below. Not taken
+    // on the schedule and run paths unless a worker needs waking.
+    mutable stdx::mutex _mutex;
+
+    // Written under _mutex, read without it on the schedule path.
+    AtomicWord<LifecycleState> _state{preStart};
+
+    // Number of running worker threads, for getStats().
+    size_t _numThreads = 0;
+
+    // Signaled when a task is queued while workers sleep, or when shutdown needs them to exit.
+    stdx::condition_variable _workAvailable;
+
+    // Signaled when _numUnfinishedTasks drops to zero.
+    stdx::condition_variable _poolIsIdle;
+
+    // Signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+
+    // Tasks sitting in a queue, not yet taken by a worker. May briefly go negative, because a
+    // task is counted after it is pushed.
+    AtomicInt64 _numQueuedTasks{0};
+
+    // Tasks that have been accepted by schedule() but have not finished running.
+    AtomicInt64 _numUnfinishedTasks{0};
+
+    // Workers blocked in _waitForWork().
+    AtomicInt64 _numSleepingWorkers{0};
+
+    // Round-robin cursor for tasks scheduled from outside the pool.
+    AtomicUInt64 _nextQueue{0};
+};
+
+}  // namespace mongo
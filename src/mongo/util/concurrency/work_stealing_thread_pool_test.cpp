@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return stdx::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    addTestsForThreadPool("ThreadPoolUseWorkStealingCommon", []() {
+        ThreadPool::Options options;
+        options.useWorkStealing = true;
+        return stdx::make_unique<ThreadPool>(options);
+    });
+    return Status::OK();
+}
+
+WorkStealingThreadPool::Options makeOptions(size_t numThreads) {
+    WorkStealingThreadPool::Options options;
+    options.maxThreads = numThreads;
+    return options;
+}
+
+TEST(WorkStealingThreadPoolTest, StartsMaxThreads) {
+    WorkStealingThreadPool pool(makeOptions(4));
+    ASSERT_EQ(0U, pool.getStats().numThreads);
+    pool.startup();
+    ASSERT_EQ(4U, pool.getStats().numThreads);
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(0U, pool.getStats().numThreads);
+}
+
+TEST(WorkStealingThreadPoolTest, WaitForIdleRunsEveryTask) {
+    WorkStealingThreadPool pool(makeOptions(4));
+    pool.startup();
+    AtomicInt64 count{0};
+    const int64_t numTasks = 10000;
+    for (int64_t i = 0; i < numTasks; ++i) {
+        ASSERT_OK(pool.schedule([&count] { count.fetchAndAdd(1); }));
+    }
+    pool.waitForIdle();
+    ASSERT_EQ(numTasks, count.load());
+    ASSERT_EQ(0U, pool.getStats().numPendingTasks);
+}
+
+TEST(WorkStealingThreadPoolTest, WaitForIdleWaitsForTasksScheduledByTasks) {
+    WorkStealingThreadPool pool(makeOptions(3));
+    pool.startup();
+    AtomicInt64 count{0};
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_OK(pool.schedule([&pool, &count] {
+            for (int j = 0; j < 100; ++j) {
+                ASSERT_OK(pool.schedule([&count] { count.fetchAndAdd(1); }));
+            }
+        }));
+    }
+    pool.waitForIdle();
+    ASSERT_EQ(10000, count.load());
+}
+
+TEST(WorkStealingThreadPoolTest, SingleThreadRunsTasksInOrder) {
+    WorkStealingThreadPool pool(makeOptions(1));
+    std::vector<int> order;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_OK(pool.schedule([&order, i] { order.push_back(i); }));
+    }
+    pool.startup();
+    pool.waitForIdle();
+    ASSERT_EQ(100U, order.size());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(i, order[i]);
+    }
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkersStealFromBusyWorker) {
+    // Every follow-up task lands on the queue of the worker running the blocked task, so the only
+    // way for them to run before it is released is for the other workers to steal them.
+    WorkStealingThreadPool pool(makeOptions(4));
+    pool.startup();
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    bool release = false;
+    size_t numFollowUps = 0;
+    std::set<stdx::thread::id> followUpThreads;
+
+    ASSERT_OK(pool.schedule([&] {
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_OK(pool.schedule([&] {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                ++numFollowUps;
+                followUpThreads.insert(stdx::this_thread::get_id());
+                cv.notify_all();
+            }));
+        }
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return release; });
+    }));
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return numFollowUps == 100U; });
+        ASSERT_GTE(followUpThreads.size(), 1U);
+        release = true;
+        cv.notify_all();
+    }
+    pool.waitForIdle();
+}
+
+}  // namespace
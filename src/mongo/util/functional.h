@@ -28,8 +28,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <type_traits>
+#include <utility>
 
 #include "mongo/stdx/type_traits.h"
 #include "mongo/util/assert_util.h"
@@ -64,18 +66,31 @@ private:
 public:
     using result_type = RetType;
 
-    ~unique_function() noexcept = default;
     unique_function() = default;
 
     unique_function(const unique_function&) = delete;
     unique_function& operator=(const unique_function&) = delete;
 
-    unique_function(unique_function&&) noexcept = default;
-    unique_function& operator=(unique_function&&) noexcept = default;
+    ~unique_function() noexcept {
+        reset();
+    }
+
+    unique_function(unique_function&& that) noexcept {
+        takeFrom(that);
+    }
+
+    unique_function& operator=(unique_function&& that) noexcept {
+        if (this != &that) {
+            reset();
+            takeFrom(that);
+        }
+        return *this;
+    }
 
     void swap(unique_function& that) noexcept {
-        using std::swap;
-        swap(this->impl, that.impl);
+        unique_function tmp(std::move(that));
+        that = std::move(*this);
+        *this = std::move(tmp);
     }
 
     friend void swap(unique_function& a, unique_function& b) noexcept {
@@ -98,17 +113,20 @@ public:
             makeTag(),
         std::enable_if_t<std::is_move_constructible<Functor>::value, TagType> = makeTag(),
         std::enable_if_t<!std::is_same<Functor, unique_function>::value, TagType> = makeTag())
-        : impl(makeImpl(std::forward<Functor>(functor))) {}
+    {
+        OpsFor<std::decay_t<Functor>>::construct(&storage, std::forward<Functor>(functor));
+        ops = OpsFor<std::decay_t<Functor>>::get();
+    }
 
     unique_function(std::nullptr_t) noexcept {}
 
     RetType operator()(Args... args) const {
         invariant(static_cast<bool>(*this));
-        return impl->call(std::forward<Args>(args)...);
+        return ops->call(&storage, std::forward<Args>(args)...);
     }
 
     explicit operator bool() const noexcept {
-        return static_cast<bool>(this->impl);
+        return ops != nullptr;
     }
 
     // Needed to make `std::is_convertible<mongo::unique_function<...>, std::function<...>>` be
@@ -130,9 +148,20 @@ private:
         return {};
     }
 
-    struct Impl {
-        virtual ~Impl() noexcept = default;
-        virtual RetType call(Args&&... args) = 0;
+    // Functors of up to this size that can be moved without throwing are stored inline rather than
+    // on the heap, so that wrapping a typical lambda, such as a Future continuation or an executor
+    // task, does not allocate.
+    static constexpr size_t kInlineSize = 4 * sizeof(void*);
+
+    using Storage = std::aligned_storage_t<kInlineSize, alignof(void*)>;
+
+    // Type-erased operations on the functor held in a Storage, shared by every unique_function
+    // holding the same functor type.
+    struct Ops {
+        RetType (*call)(Storage* storage, Args&&... args);
+        // Move-constructs the functor held in 'from' into 'to', then destroys the original.
+        void (*relocate)(Storage* from, Storage* to);
+        void (*destroy)(Storage* storage);
     };
 
     // These overload helpers are needed to squelch problems in the `T ()` -> `void ()` case.
@@ -148,22 +177,91 @@ private:
         return f(std::forward<Args>(args)...);
     }
 
+    template <typename Functor,
+              bool storedInline = sizeof(Functor) <= kInlineSize &&
+                  alignof(Functor) <= alignof(Storage) &&
+                  std::is_nothrow_move_constructible<Functor>::value>
+    struct OpsFor {
+        static Functor* functor(Storage* storage) {
+            return reinterpret_cast<Functor*>(storage);
+        }
+
+        template <typename F>
+        static void construct(Storage* storage, F&& func) {
+            new (storage) Functor(std::forward<F>(func));
+        }
+
+        static RetType call(Storage* storage, Args&&... args) {
+            return callRegularVoid(
+                std::is_void<RetType>(), *functor(storage), std::forward<Args>(args)...);
+        }
+
+        static void relocate(Storage* from, Storage* to) {
+            new (to) Functor(std::move(*functor(from)));
+            functor(from)->~Functor();
+        }
+
+        static void destroy(Storage* storage) {
+            functor(storage)->~Functor();
+        }
+
+        static const Ops* get() {
+            static const Ops ops = {&call, &relocate, &destroy};
+            return &ops;
+        }
+    };
+
+    // Functors that are too large for the inline storage, or that may throw when moved, are
+    // allocated on the heap and the storage holds a pointer to them.
     template <typename Functor>
-    static auto makeImpl(Functor&& functor) {
-        struct SpecificImpl : Impl {
-            explicit SpecificImpl(Functor&& func) : f(std::move(func)) {}
+    struct OpsFor<Functor, false> {
+        static Functor*& functor(Storage* storage) {
+            return *reinterpret_cast<Functor**>(storage);
+        }
+
+        template <typename F>
+        static void construct(Storage* storage, F&& func) {
+            new (storage) Functor*(new Functor(std::forward<F>(func)));
+        }
+
+        static RetType call(Storage* storage, Args&&... args) {
+            return callRegularVoid(
+                std::is_void<RetType>(), *functor(storage), std::forward<Args>(args)...);
+        }
 
-            RetType call(Args&&... args) override {
-                return callRegularVoid(std::is_void<RetType>(), f, std::forward<Args>(args)...);
-            }
+        static void relocate(Storage* from, Storage* to) {
+            new (to) Functor*(functor(from));
+        }
 
-            std::decay_t<Functor> f;
-        };
+        static void destroy(Storage* storage) {
+            delete functor(storage);
+        }
 
-        return std::make_unique<SpecificImpl>(std::move(functor));
+        static const Ops* get() {
+            static const Ops ops = {&call, &relocate, &destroy};
+            return &ops;
+        }
+    };
+
+    void reset() noexcept {
+        if (ops) {
+            ops->destroy(&storage);
+            ops = nullptr;
+        }
     }
 
-    std::unique_ptr<Impl> impl;
+    void takeFrom(unique_function& that) noexcept {
+        if (that.ops) {
+            that.ops->relocate(&that.storage, &storage);
+            ops = std::exchange(that.ops, nullptr);
+        }
+    }
+
+    const Ops* ops = nullptr;
+
+    // Mutable since calling the functor through a const unique_function may modify it, as it could
+    // when the functor was always held through a pointer.
+    mutable Storage storage;
 };
 
 template <typename Signature>
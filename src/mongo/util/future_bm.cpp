@@ -93,6 +93,30 @@ void BM_futureIntDeferredThen(benchmark::State& state) {
     }
 }
 
+void BM_futureIntDeferredThenCapturing(benchmark::State& state) {
+    // Captures about as much state as a typical networking continuation does.
+    auto shared = std::make_shared<int>(1);
+    int* counter = shared.get();
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        auto pf = makePromiseFuture<int>();
+        auto fut = std::move(pf.future).then([shared, counter](int i) { return i + *counter; });
+        pf.promise.emplaceValue(1);
+        benchmark::DoNotOptimize(std::move(fut).get());
+    }
+}
+
+void BM_futureIntDeferredGetAsync(benchmark::State& state) {
+    int sum = 0;
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        auto pf = makePromiseFuture<int>();
+        std::move(pf.future).getAsync([&sum](StatusWith<int> swi) { sum += swi.getValue(); });
+        pf.promise.emplaceValue(1);
+    }
+    benchmark::DoNotOptimize(sum);
+}
+
 void BM_futureIntDeferredThenImmediate(benchmark::State& state) {
     for (auto _ : state) {
         benchmark::ClobberMemory();
@@ -205,6 +229,8 @@ BENCHMARK(BM_futureIntReadyThen);
 BENCHMARK(BM_futureIntReadyWithPromise);
 BENCHMARK(BM_futureIntReadyWithPromiseThen);
 BENCHMARK(BM_futureIntDeferredThen);
+BENCHMARK(BM_futureIntDeferredThenCapturing);
+BENCHMARK(BM_futureIntDeferredGetAsync);
 BENCHMARK(BM_futureIntDeferredThenImmediate);
 BENCHMARK(BM_futureIntDeferredThenReady);
 BENCHMARK(BM_futureIntDoubleDeferredThen);
@@ -74,6 +74,29 @@ ExportedServerParameter<bool, ServerParameterType::kStartupOnly> sslWithholdClie
     "sslWithholdClientCertificate",
     &sslGlobalParams.tlsWithholdClientCertificate);
 
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> tlsSessionResumption(
+    ServerParameterSet::getGlobal(), "tlsSessionResumption", &sslGlobalParams.tlsSessionResumption);
+
+class TLSSessionTimeoutSecsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    TLSSessionTimeoutSecsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "tlsSessionTimeoutSecs",
+              &sslGlobalParams.tlsSessionTimeoutSecs) {}
+
+    Status validate(const int& potentialNewValue) final {
+        if (potentialNewValue <= 0) {
+            return Status(ErrorCodes::BadValue, "tlsSessionTimeoutSecs must be greater than 0");
+        }
+        return Status::OK();
+    }
+} tlsSessionTimeoutSecsParameter;
+
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> tlsUseKernelOffload(
+    ServerParameterSet::getGlobal(), "tlsUseKernelOffload", &sslGlobalParams.tlsUseKernelOffload);
+
 }  // namespace
 
 class OpenSSLCipherConfigParameter
@@ -214,6 +214,15 @@ SSLManagerInterface* getSSLManager();
 
 extern bool isSSLServer;
 
+#if MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+/**
+ * Lets the outgoing connection 'conn' resume a TLS session established by an earlier connection to
+ * 'remote', and remembers the session 'conn' establishes for later connections to 'remote'. Must
+ * be called before the handshake starts. Does nothing if tlsSessionResumption is disabled.
+ */
+void setupTLSSessionResumption(SSL* conn, const std::string& remote);
+#endif
+
 /**
  * Returns true if the `nameToMatch` is a valid match against the `certHostName` requirement from an
  * x.509 certificate.  Matches a remote host name to an x.509 host name, including wildcards.
@@ -48,6 +48,8 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/debug_util.h"
@@ -190,6 +192,117 @@ inline int X509_NAME_ENTRY_set(const X509_NAME_ENTRY* ne) {
 }
 #endif
 
+// The number of sessions an incoming SSL context keeps around for clients to resume.
+const long kServerSessionCacheSize = 20 * 1024;
+
+struct SSLSessionFree {
+    void operator()(SSL_SESSION* const p) noexcept {
+        if (p) {
+            ::SSL_SESSION_free(p);
+        }
+    }
+};
+using UniqueSSLSession = std::unique_ptr<SSL_SESSION, SSLSessionFree>;
+
+/**
+ * Holds the most recent TLS session established with each remote host by outgoing connections, so
+ * that the next connection to the same host can offer to resume it instead of running a full
+ * handshake. The server only accepts a session it issued itself, so a stale or mismatched session
+ * costs nothing more than the full handshake it would have run anyway.
+ */
+class TLSClientSessionCache {
+public:
+    // Bounds the cache for processes which talk to very many hosts, like drivers' test suites.
+    static constexpr size_t kMaxSessions = 1024;
+
+    static TLSClientSessionCache& get() {
+        // Never destroyed, so that sessions are not freed after OpenSSL itself has been torn down.
+        static auto cache = new TLSClientSessionCache();
+        return *cache;
+    }
+
+    void resume(SSL* conn, const std::string& remote) {
+        // Remember where this connection goes, so that newSessionCallback() can tell whose
+        // session it receives.
+        ::SSL_set_ex_data(conn, _remoteIndex(), new std::string(remote));
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _sessions.find(remote);
+        if (it == _sessions.end()) {
+            return;
+        }
+
+        auto session = it->second.get();
+        if (!_isResumable(session)) {
+            _sessions.erase(it);
+            return;
+        }
+
+        // SSL_set_session() takes its own reference to the session.
+        ::SSL_set_session(conn, session);
+
+#ifdef TLS1_3_VERSION
+        // TLS 1.3 tickets should only be used once. The server sends fresh ones after every
+        // handshake, which replace this one through newSessionCallback().
+        if (::SSL_SESSION_get_protocol_version(session) == TLS1_3_VERSION) {
+            _sessions.erase(it);
+        }
+#endif
+    }
+
+    /**
+     * Installed with SSL_CTX_sess_set_new_cb() on outgoing contexts. Returning 1 means we keep the
+     * reference to 'session' we were given.
+     */
+    static int newSessionCallback(SSL* conn, SSL_SESSION* session) {
+        auto remote = static_cast<std::string*>(::SSL_get_ex_data(conn, _remoteIndex()));
+        if (!remote) {
+            return 0;
+        }
+
+        auto& cache = get();
+        stdx::lock_guard<stdx::mutex> lk(cache._mutex);
+        if (cache._sessions.size() >= kMaxSessions && !cache._sessions.count(*remote)) {
+            cache._sessions.erase(cache._sessions.begin());
+        }
+        cache._sessions[*remote] = UniqueSSLSession(session);
+        return 1;
+    }
+
+private:
+    static int _remoteIndex() {
+        static const int index = ::SSL_get_ex_new_index(
+            0,
+            nullptr,
+            nullptr,
+            nullptr,
+            [](void* parent, void* ptr, CRYPTO_EX_DATA* ad, int idx, long argl, void* argp) {
+                delete static_cast<std::string*>(ptr);
+            });
+        return index;
+    }
+
+    static bool _isResumable(SSL_SESSION* session) {
+        if (static_cast<long>(time(nullptr)) >=
+            ::SSL_SESSION_get_time(session) + ::SSL_SESSION_get_timeout(session)) {
+            return false;
+        }
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L && !defined(LIBRESSL_VERSION_NUMBER)
+        return ::SSL_SESSION_is_resumable(session);
+#else
+        return true;
+#endif
+    }
+
+    stdx::mutex _mutex;
+    stdx::unordered_map<std::string, UniqueSSLSession> _sessions;
+};
+
+// Kernel TLS needs OpenSSL 3.0 built with ktls support, and a Linux kernel which has it.
+#if defined(__linux__) && defined(SSL_OP_ENABLE_KTLS)
+#define MONGO_HAVE_KTLS 1
+#endif
+
 /**
  * Multithreaded Support for SSL.
  *
@@ -308,6 +421,13 @@ public:
 
     ~SSLConnectionOpenSSL();
 
+    /**
+     * Has OpenSSL read and write the socket itself rather than go through our BIO pair, which is
+     * what lets it hand the connection's encryption over to the kernel. Must be called before the
+     * handshake, and only on connections which have not been given any initial bytes.
+     */
+    void attachToSocket();
+
     std::string getSNIServerName() const final {
         const char* name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
         if (!name)
@@ -386,6 +506,7 @@ private:
     bool _allowInvalidCertificates;
     bool _allowInvalidHostnames;
     bool _suppressNoCertificateWarning;
+    bool _useKernelTLS = false;
     SSLConfiguration _sslConfiguration;
 
     /**
@@ -606,6 +727,17 @@ SSLConnectionOpenSSL::~SSLConnectionOpenSSL() {
     }
 }
 
+void SSLConnectionOpenSSL::attachToSocket() {
+    // SSL_set_fd() frees the internalBIO along with the rest of the old BIOs.
+    BIO_free(networkBIO);
+    networkBIO = nullptr;
+    internalBIO = nullptr;
+
+    if (SSL_set_fd(ssl, socket->rawFD()) != 1) {
+        throwSocketError(SocketErrorKind::CONNECT_ERROR, socket->remoteString());
+    }
+}
+
 SSLManagerOpenSSL::SSLManagerOpenSSL(const SSLParams& params, bool isServer)
     : _serverContext(nullptr, free_ssl_context),
       _clientContext(nullptr, free_ssl_context),
@@ -639,6 +771,17 @@ SSLManagerOpenSSL::SSLManagerOpenSSL(const SSLParams& params, bool isServer)
             uasserted(16941, "ssl initialization problem");
         }
     }
+
+    if (params.tlsUseKernelOffload) {
+#ifdef MONGO_HAVE_KTLS
+        // Only the synchronous client context hands sockets to OpenSSL, see connect().
+        ::SSL_CTX_set_options(_clientContext.get(), SSL_OP_ENABLE_KTLS);
+        _useKernelTLS = true;
+#else
+        warning() << "tlsUseKernelOffload is not supported by this build, ignoring it";
+#endif
+    }
+
     // SSL server specific initialization
     if (isServer) {
         if (!_initSynchronousSSLContext(&_serverContext, params, ConnectionDirection::kIncoming)) {
@@ -756,6 +899,23 @@ Status SSLManagerOpenSSL::initSSLContext(SSL_CTX* context,
                                     << getSSLErrorMessage(ERR_get_error()));
     }
 
+    // Let connections skip the full handshake by resuming an earlier session, either from the
+    // server's session cache or from a session ticket.
+    if (!params.tlsSessionResumption) {
+        ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_OFF);
+        ::SSL_CTX_set_options(context, SSL_OP_NO_TICKET);
+    } else if (direction == ConnectionDirection::kOutgoing) {
+        // Outgoing connections look their sessions up by the host they go to, which OpenSSL's
+        // own cache cannot do. See setupTLSSessionResumption().
+        ::SSL_CTX_set_session_cache_mode(context,
+                                         SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        ::SSL_CTX_sess_set_new_cb(context, &TLSClientSessionCache::newSessionCallback);
+    } else {
+        ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+        ::SSL_CTX_sess_set_cache_size(context, kServerSessionCacheSize);
+    }
+    ::SSL_CTX_set_timeout(context, params.tlsSessionTimeoutSecs);
+
     if (direction == ConnectionDirection::kOutgoing && params.tlsWithholdClientCertificate) {
         // Do not send a client certificate if they have been suppressed.
 
@@ -1187,6 +1347,11 @@ bool SSLManagerOpenSSL::_setupCRL(SSL_CTX* context, const std::string& crlFile)
 */
 void SSLManagerOpenSSL::_flushNetworkBIO(SSLConnectionOpenSSL* conn) {
     char buffer[BUFFER_SIZE];
+    // Connections attached to their socket do their own network I/O.
+    if (!conn->networkBIO) {
+        return;
+    }
+
     int wantWrite;
 
     /*
@@ -1238,6 +1403,12 @@ bool SSLManagerOpenSSL::_doneWithSSLOp(SSLConnectionOpenSSL* conn, int status) {
             return true;
         case SSL_ERROR_WANT_WRITE:
         case SSL_ERROR_WANT_READ:
+            if (!conn->networkBIO) {
+                // The socket is blocking, so OpenSSL only wants to retry when it timed out.
+                throwSocketError(sslErr == SSL_ERROR_WANT_READ ? SocketErrorKind::RECV_TIMEOUT
+                                                               : SocketErrorKind::SEND_TIMEOUT,
+                                 conn->socket->remoteString());
+            }
             _flushNetworkBIO(conn);  // not ready, flush network BIO and try again
             return false;
         default:
@@ -1254,6 +1425,12 @@ SSLConnectionInterface* SSLManagerOpenSSL::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(sslConn.get(), ret);
 
+    setupTLSSessionResumption(sslConn->ssl, socket->remoteString());
+
+    if (_useKernelTLS) {
+        sslConn->attachToSocket();
+    }
+
     do {
         ret = ::SSL_connect(sslConn->ssl);
     } while (!_doneWithSSLOp(sslConn.get(), ret));
@@ -1261,6 +1438,18 @@ SSLConnectionInterface* SSLManagerOpenSSL::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(sslConn.get(), ret);
 
+#ifdef MONGO_HAVE_KTLS
+    if (_useKernelTLS) {
+        LOG(2) << "Kernel TLS for connection to " << socket->remoteString()
+               << ": send=" << (BIO_get_ktls_send(SSL_get_wbio(sslConn->ssl)) ? "on" : "off")
+               << ", receive=" << (BIO_get_ktls_recv(SSL_get_rbio(sslConn->ssl)) ? "on" : "off");
+    }
+#endif
+
+    if (SSL_session_reused(sslConn->ssl)) {
+        LOG(3) << "Resumed TLS session with " << socket->remoteString();
+    }
+
     return sslConn.release();
 }
 
@@ -1282,6 +1471,13 @@ SSLConnectionInterface* SSLManagerOpenSSL::accept(Socket* socket,
 }
 
 
+void setupTLSSessionResumption(SSL* conn, const std::string& remote) {
+    if (!sslGlobalParams.tlsSessionResumption) {
+        return;
+    }
+    TLSClientSessionCache::get().resume(conn, remote);
+}
+
 StatusWith<TLSVersion> mapTLSVersion(SSL* conn) {
     int protocol = SSL_version(conn);
 
@@ -83,6 +83,9 @@ struct SSLParams {
     bool suppressNoTLSPeerCertificateWarning =
         false;  // --setParameter suppressNoTLSPeerCertificateWarning
     bool tlsWithholdClientCertificate = false;  // --setParameter tlsWithholdClientCertificate
+    bool tlsSessionResumption = true;           // --setParameter tlsSessionResumption
+    int tlsSessionTimeoutSecs = 300;            // --setParameter tlsSessionTimeoutSecs
+    bool tlsUseKernelOffload = false;           // --setParameter tlsUseKernelOffload
 
     SSLParams() {
         sslMode.store(SSLMode_disabled);
@@ -0,0 +1,448 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+
+#if defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+#define MONGO_HAVE_SAMPLING_PROFILER
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+//
+// Sampling CPU profiler
+//
+// A SIGPROF interval timer, which counts the CPU time of the whole process, interrupts whichever
+// thread is running when it expires. The signal handler records the backtrace of that thread and
+// the tag of its innermost SamplingProfilerTagScope into a fixed ring of sample slots, without
+// allocating or locking.
+//
+// A background thread drains the ring every kAggregateInterval and merges each sample into the
+// call tree of its command and namespace. Each node of a call tree is a frame, keyed by its
+// instruction pointer, and counts the samples taken in its subtree and in the frame itself. The
+// trees share the common prefixes of the stacks, so they stay small; their total number of nodes,
+// roots included, is bounded by kMaxCallTreeNodes. After that, samples are charged to the deepest
+// existing node, and samples of a command and namespace without a tree yet to a shared overflow
+// tree.
+//
+// Enable at startup time (only) with
+//     mongod --setParameter samplingProfilerEnabled=true
+//
+// If enabled, adds a samplingProfile section to serverStatus, and so to FTDC, of the form
+//     samplingProfile: {
+//         samplesPerSecond: ...,
+//         samples: ...,           // samples recorded by the signal handler
+//         samplesDropped: ...,    // samples dropped because the ring was full
+//         samplesTruncated: ...,  // samples charged to a shallower frame than they belong to
+//         callTreeNodes: ...,
+//         commands: {
+//             find: ...,          // samples taken while running each command
+//             ...
+//             none: ...           // samples taken outside of any command
+//         }
+//     }
+//
+// The getSamplingProfile command returns the symbolized call trees.
+//
+
+namespace mongo {
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(samplingProfilerEnabled, bool, false);
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(samplingProfilerSamplesPerSecond, int, 10)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "samplingProfilerSamplesPerSecond must be between 1 and 1000");
+        }
+        return Status::OK();
+    });
+
+namespace {
+
+// The maximum number of frames recorded for a sample, including the frames of the signal handler.
+const int kMaxFrames = 50;
+
+// Frames at the top of every backtrace which belong to the signal handler itself.
+const int kSkipFrames = 2;
+
+const size_t kNumSampleSlots = 1024;
+const size_t kMaxCallTreeNodes = 200 * 1000;
+const auto kAggregateInterval = Milliseconds(100);
+
+// The name used in the summary for samples taken outside of any command.
+const auto kUntaggedCommand = "none"_sd;
+
+// The command of the tree which takes the samples of all commands and namespaces which had no tree
+// of their own when the node limit was reached.
+const auto kOverflowCommand = "overflow"_sd;
+
+AtomicWord<bool> running{false};
+
+thread_local const SamplingProfilerTagScope* currentTag = nullptr;
+
+/**
+ * One sample, written by the signal handler and read by the aggregating thread. The state moves
+ * from kEmpty to kWriting by compare-and-swap in the signal handler, so that two handlers never
+ * write to the same slot, then to kFull once the sample is complete, and back to kEmpty once it
+ * has been aggregated.
+ */
+struct SampleSlot {
+    enum State { kEmpty, kWriting, kFull };
+
+    std::atomic<int> state{kEmpty};  // NOLINT
+    int numFrames = 0;
+    std::array<void*, kMaxFrames> frames;
+    char command[SamplingProfilerTagScope::kMaxCommandLength];
+    char ns[SamplingProfilerTagScope::kMaxNamespaceLength];
+};
+
+std::unique_ptr<SampleSlot[]> sampleSlots;
+AtomicWord<unsigned long long> nextSampleSlot{0};
+AtomicWord<long long> samplesRecorded{0};
+AtomicWord<long long> samplesDropped{0};
+
+struct CallTreeNode {
+    long long samples = 0;      // samples taken in this frame or in the frames it called
+    long long selfSamples = 0;  // samples taken in this frame itself
+    std::map<void*, std::unique_ptr<CallTreeNode>> children;
+};
+
+/**
+ * The call trees of each command and namespace, fed by the aggregating thread.
+ */
+struct CallTrees {
+    stdx::mutex mutex;
+    std::map<std::pair<std::string, std::string>, CallTreeNode> trees;
+    size_t numNodes = 0;
+    long long samplesTruncated = 0;
+
+    void add(const SampleSlot& sample) {
+        std::pair<std::string, std::string> key(sample.command, sample.ns);
+        auto it = trees.find(key);
+        if (it == trees.end() && numNodes >= kMaxCallTreeNodes) {
+            key = {kOverflowCommand.toString(), ""};
+            it = trees.find(key);
+        }
+        if (it == trees.end()) {
+            it = trees.emplace(std::move(key), CallTreeNode()).first;
+            numNodes++;
+        }
+
+        CallTreeNode* node = &it->second;
+        node->samples++;
+
+        // Walk the stack from its outermost frame in.
+        for (int i = sample.numFrames - 1; i >= kSkipFrames; --i) {
+            auto& child = node->children[sample.frames[i]];
+            if (!child) {
+                if (numNodes >= kMaxCallTreeNodes) {
+                    node->children.erase(sample.frames[i]);
+                    samplesTruncated++;
+                    break;
+                }
+                child = stdx::make_unique<CallTreeNode>();
+                numNodes++;
+            }
+            node = child.get();
+            node->samples++;
+        }
+        node->selfSamples++;
+    }
+};
+
+CallTrees callTrees;
+
+void aggregateSamples() {
+    setThreadName("SamplingProfiler");
+    while (true) {
+        sleepFor(kAggregateInterval);
+
+        stdx::lock_guard<stdx::mutex> lk(callTrees.mutex);
+        for (size_t i = 0; i < kNumSampleSlots; ++i) {
+            SampleSlot& slot = sampleSlots[i];
+            if (slot.state.load(std::memory_order_acquire) != SampleSlot::kFull) {
+                continue;
+            }
+            callTrees.add(slot);
+            slot.state.store(SampleSlot::kEmpty, std::memory_order_release);
+        }
+    }
+}
+
+#ifdef MONGO_HAVE_SAMPLING_PROFILER
+/**
+ * Returns the demangled name of the function containing 'frame', without its parameters, or the
+ * address if it has no symbol.
+ */
+std::string symbolize(void* frame) {
+    Dl_info dli;
+    if (dladdr(frame, &dli) && dli.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+        if (demangled) {
+            // strip off function parameters as they are very verbose and not useful
+            std::string name(demangled, std::min(strlen(demangled), strcspn(demangled, "(")));
+            free(demangled);
+            return name;
+        }
+        return dli.dli_sname;
+    }
+
+    std::ostringstream s;
+    s << frame;
+    return s.str();
+}
+#endif
+
+void appendCallTreeNodes(const CallTreeNode& node,
+                         long long minSamples,
+                         std::map<void*, std::string>* symbols,
+                         BSONArrayBuilder* builder) {
+#ifdef MONGO_HAVE_SAMPLING_PROFILER
+    std::vector<std::pair<void*, const CallTreeNode*>> children;
+    for (auto&& child : node.children) {
+        if (child.second->samples >= minSamples) {
+            children.emplace_back(child.first, child.second.get());
+        }
+    }
+    std::stable_sort(children.begin(), children.end(), [](const auto& a, const auto& b) {
+        return a.second->samples > b.second->samples;
+    });
+
+    for (auto&& child : children) {
+        auto& symbol = (*symbols)[child.first];
+        if (symbol.empty()) {
+            symbol = symbolize(child.first);
+        }
+
+        BSONObjBuilder childBuilder(builder->subobjStart());
+        childBuilder.append("frame", symbol);
+        childBuilder.append("samples", child.second->samples);
+        childBuilder.append("selfSamples", child.second->selfSamples);
+        if (!child.second->children.empty()) {
+            BSONArrayBuilder calls(childBuilder.subarrayStart("calls"));
+            appendCallTreeNodes(*child.second, minSamples, symbols, &calls);
+        }
+    }
+#endif
+}
+
+}  // namespace
+
+void SamplingProfiler::startIfEnabled() {
+    if (!samplingProfilerEnabled) {
+        return;
+    }
+
+#ifdef MONGO_HAVE_SAMPLING_PROFILER
+    invariant(!running.load());
+    sampleSlots.reset(new SampleSlot[kNumSampleSlots]);
+
+    // The first call to backtrace loads libgcc, which is not safe to do in a signal handler.
+    void* warmup[1];
+    backtrace(warmup, 1);
+
+    stdx::thread(aggregateSamples).detach();
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &SamplingProfiler::_handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        error() << "Failed to install the sampling profiler signal handler: "
+                << errnoWithDescription();
+        return;
+    }
+
+    running.store(true);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000 * 1000 / samplingProfilerSamplesPerSecond;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        running.store(false);
+        error() << "Failed to start the sampling profiler timer: " << errnoWithDescription();
+        return;
+    }
+
+    log() << "Sampling CPU profiler started, taking " << samplingProfilerSamplesPerSecond
+          << " samples per second of CPU time";
+#else
+    warning() << "The sampling CPU profiler is not supported on this platform";
+#endif
+}
+
+bool SamplingProfiler::isRunning() {
+    return running.load();
+}
+
+void SamplingProfiler::_handleSignal(int signal) {
+#ifdef MONGO_HAVE_SAMPLING_PROFILER
+    const int savedErrno = errno;
+
+    SampleSlot& slot = sampleSlots[nextSampleSlot.fetchAndAdd(1) % kNumSampleSlots];
+    int expected = SampleSlot::kEmpty;
+    if (!slot.state.compare_exchange_strong(expected, SampleSlot::kWriting)) {
+        samplesDropped.fetchAndAdd(1);
+        errno = savedErrno;
+        return;
+    }
+
+    slot.numFrames = backtrace(slot.frames.data(), kMaxFrames);
+    if (const SamplingProfilerTagScope* tag = currentTag) {
+        memcpy(slot.command, tag->_command, sizeof(slot.command));
+        memcpy(slot.ns, tag->_ns, sizeof(slot.ns));
+    } else {
+        slot.command[0] = '\0';
+        slot.ns[0] = '\0';
+    }
+
+    slot.state.store(SampleSlot::kFull, std::memory_order_release);
+    samplesRecorded.fetchAndAdd(1);
+    errno = savedErrno;
+#endif
+}
+
+void SamplingProfiler::appendSummary(BSONObjBuilder* builder) {
+    builder->append("samplesPerSecond", samplingProfilerSamplesPerSecond);
+    builder->append("samples", samplesRecorded.load());
+    builder->append("samplesDropped", samplesDropped.load());
+
+    stdx::lock_guard<stdx::mutex> lk(callTrees.mutex);
+    builder->append("samplesTruncated", callTrees.samplesTruncated);
+    builder->appendNumber("callTreeNodes", static_cast<long long>(callTrees.numNodes));
+
+    std::map<StringData, long long> commandSamples;
+    for (auto&& tree : callTrees.trees) {
+        const auto& command = tree.first.first;
+        commandSamples[command.empty() ? kUntaggedCommand : StringData(command)] +=
+            tree.second.samples;
+    }
+
+    BSONObjBuilder commandsBuilder(builder->subobjStart("commands"));
+    for (auto&& command : commandSamples) {
+        commandsBuilder.append(command.first, command.second);
+    }
+}
+
+void SamplingProfiler::appendCallTrees(BSONObjBuilder* builder, long long minSamples) {
+    stdx::lock_guard<stdx::mutex> lk(callTrees.mutex);
+
+    std::map<void*, std::string> symbols;
+    BSONArrayBuilder treesBuilder(builder->subarrayStart("callTrees"));
+    for (auto&& tree : callTrees.trees) {
+        if (tree.second.samples < minSamples) {
+            continue;
+        }
+
+        BSONObjBuilder treeBuilder(treesBuilder.subobjStart());
+        const auto& command = tree.first.first;
+        treeBuilder.append("command", command.empty() ? kUntaggedCommand : StringData(command));
+        treeBuilder.append("ns", tree.first.second);
+        treeBuilder.append("samples", tree.second.samples);
+        BSONArrayBuilder calls(treeBuilder.subarrayStart("calls"));
+        appendCallTreeNodes(tree.second, minSamples, &symbols, &calls);
+    }
+}
+
+SamplingProfilerTagScope::SamplingProfilerTagScope(StringData command, StringData ns) {
+    if (!running.load()) {
+        return;
+    }
+
+    _active = true;
+    command = command.substr(0, kMaxCommandLength - 1);
+    command.copyTo(_command, true);
+    ns = ns.substr(0, kMaxNamespaceLength - 1);
+    ns.copyTo(_ns, true);
+
+    // The signal handler may run at any point on this thread, so the tag must be complete before
+    // it is published.
+    _previous = currentTag;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    currentTag = this;
+}
+
+SamplingProfilerTagScope::~SamplingProfilerTagScope() {
+    if (_active) {
+        currentTag = _previous;
+    }
+}
+
+namespace {
+
+class SamplingProfilerServerStatusSection final : public ServerStatusSection {
+public:
+    SamplingProfilerServerStatusSection() : ServerStatusSection("samplingProfile") {}
+
+    bool includeByDefault() const override {
+        return SamplingProfiler::isRunning();
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        SamplingProfiler::appendSummary(&builder);
+        return builder.obj();
+    }
+} samplingProfilerServerStatusSection;
+
+}  // namespace
+}  // namespace mongo
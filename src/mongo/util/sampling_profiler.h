@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Sampling CPU profiler.
+ *
+ * When enabled at startup with --setParameter samplingProfilerEnabled=true, takes a stack sample
+ * of the thread running on the CPU samplingProfilerSamplesPerSecond times per second of process
+ * CPU time, and aggregates the samples into an in-memory call tree per command and namespace. It
+ * is cheap enough to leave running in production.
+ *
+ * Only available on Linux. It relies on the same SIGPROF timer as the gperftools profiler built
+ * with --use-cpu-profiler, so the two must not be used together.
+ */
+class SamplingProfiler {
+public:
+    /**
+     * Starts sampling if samplingProfilerEnabled is set. Must be called after the process has
+     * daemonized, since neither the sampling timer nor the aggregating thread survive a fork.
+     */
+    static void startIfEnabled();
+
+    /**
+     * Returns whether the profiler is taking samples.
+     */
+    static bool isRunning();
+
+    /**
+     * Appends the sampling statistics and the number of samples taken in each command. This is
+     * compact and numeric, so that it can be captured by FTDC.
+     */
+    static void appendSummary(BSONObjBuilder* builder);
+
+    /**
+     * Appends the call tree of each command and namespace, with symbolized frames. Subtrees with
+     * fewer than 'minSamples' samples are left out.
+     */
+    static void appendCallTrees(BSONObjBuilder* builder, long long minSamples);
+
+private:
+    /**
+     * The SIGPROF handler. Records a sample of the interrupted thread.
+     */
+    static void _handleSignal(int signal);
+};
+
+/**
+ * Tags the samples taken on this thread while in scope with a command name and a namespace. Only
+ * checks a flag when the profiler is not running. Scopes may nest; the innermost one applies.
+ */
+class SamplingProfilerTagScope {
+    MONGO_DISALLOW_COPYING(SamplingProfilerTagScope);
+
+public:
+    SamplingProfilerTagScope(StringData command, StringData ns);
+    ~SamplingProfilerTagScope();
+
+    static constexpr size_t kMaxCommandLength = 32;
+    static constexpr size_t kMaxNamespaceLength = 128;
+
+private:
+    friend class SamplingProfiler;
+
+    bool _active = false;
+    const SamplingProfilerTagScope* _previous = nullptr;
+    char _command[kMaxCommandLength];
+    char _ns[kMaxNamespaceLength];
+};
+
+}  // namespace mongo
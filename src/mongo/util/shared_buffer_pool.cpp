@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include <array>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+namespace {
+
+// One size class per power of two from kMinBufferSize to kMaxBufferSize inclusive.
+constexpr size_t kNumSizeClasses = 13;
+MONGO_STATIC_ASSERT((SharedBufferPool::kMinBufferSize << (kNumSizeClasses - 1)) ==
+                    SharedBufferPool::kMaxBufferSize);
+
+constexpr size_t kMaxBuffersPerSizeClass = 8;
+constexpr long long kMaxRetainedBytesPerThread = 1024 * 1024;
+constexpr long long kMaxRetainedBytes = 64 * 1024 * 1024;
+
+AtomicInt64 hits;
+AtomicInt64 misses;
+AtomicInt64 recycled;
+AtomicInt64 discarded;
+AtomicInt64 retainedBytes;
+
+struct ThreadBufferCache {
+    ~ThreadBufferCache() {
+        retainedBytes.subtractAndFetch(bytes);
+    }
+
+    std::array<std::vector<SharedBuffer>, kNumSizeClasses> sizeClasses;
+    long long bytes = 0;
+};
+
+thread_local ThreadBufferCache threadCache;
+
+/**
+ * Returns the smallest size class whose buffers can hold 'size' bytes.
+ */
+size_t sizeClassToFit(size_t size) {
+    size_t sizeClass = 0;
+    while ((SharedBufferPool::kMinBufferSize << sizeClass) < size) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+/**
+ * Returns the largest size class that a buffer of 'capacity' bytes can serve.
+ */
+size_t sizeClassServedBy(size_t capacity) {
+    size_t sizeClass = kNumSizeClasses - 1;
+    while ((SharedBufferPool::kMinBufferSize << sizeClass) > capacity) {
+        --sizeClass;
+    }
+    return sizeClass;
+}
+
+}  // namespace
+
+SharedBuffer SharedBufferPool::acquire(size_t minSize) {
+    if (minSize > kMaxBufferSize) {
+        misses.fetchAndAdd(1);
+        return SharedBuffer::allocate(minSize);
+    }
+
+    auto& cache = threadCache;
+    const auto wanted = sizeClassToFit(minSize);
+    for (auto sizeClass = wanted; sizeClass < kNumSizeClasses; ++sizeClass) {
+        auto& pooled = cache.sizeClasses[sizeClass];
+        if (pooled.empty()) {
+            continue;
+        }
+
+        auto buf = std::move(pooled.back());
+        pooled.pop_back();
+        cache.bytes -= buf.capacity();
+        retainedBytes.subtractAndFetch(buf.capacity());
+        hits.fetchAndAdd(1);
+        return buf;
+    }
+
+    misses.fetchAndAdd(1);
+    return SharedBuffer::allocate(kMinBufferSize << wanted);
+}
+
+void SharedBufferPool::recycle(SharedBuffer buf) {
+    if (!buf || buf.isShared()) {
+        return;
+    }
+
+    const long long capacity = buf.capacity();
+    auto& cache = threadCache;
+    if (capacity < static_cast<long long>(kMinBufferSize) ||
+        capacity > static_cast<long long>(kMaxBufferSize) ||
+        cache.bytes + capacity > kMaxRetainedBytesPerThread) {
+        discarded.fetchAndAdd(1);
+        return;
+    }
+
+    auto& pooled = cache.sizeClasses[sizeClassServedBy(capacity)];
+    if (pooled.size() >= kMaxBuffersPerSizeClass) {
+        discarded.fetchAndAdd(1);
+        return;
+    }
+
+    // Reserve the bytes before pooling the buffer, so that concurrent recycle() calls can't
+    // together go over the process-wide limit.
+    if (retainedBytes.addAndFetch(capacity) > kMaxRetainedBytes) {
+        retainedBytes.subtractAndFetch(capacity);
+        discarded.fetchAndAdd(1);
+        return;
+    }
+
+    pooled.push_back(std::move(buf));
+    cache.bytes += capacity;
+    recycled.fetchAndAdd(1);
+}
+
+void SharedBufferPool::recycle(ConstSharedBuffer buf) {
+    if (!buf || buf.isShared()) {
+        return;
+    }
+    recycle(std::move(buf).constCast());
+}
+
+SharedBufferPool::Stats SharedBufferPool::getStats() {
+    return {hits.load(), misses.load(), recycled.load(), discarded.load(), retainedBytes.load()};
+}
+
+void SharedBufferPool::appendStats(BSONObjBuilder* bob) {
+    const auto stats = getStats();
+    bob->append("hits", stats.hits);
+    bob->append("misses", stats.misses);
+    bob->append("recycled", stats.recycled);
+    bob->append("discarded", stats.discarded);
+    bob->append("retainedBytes", stats.retainedBytes);
+}
+
+}  // namespace mongo
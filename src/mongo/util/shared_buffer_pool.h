@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A per-thread cache of SharedBuffers, bucketed by power-of-two size class, which lets builders on
+ * hot paths such as command replies and oplog entries reuse the buffers of objects they recently
+ * finished with instead of going back to the allocator for every one.
+ *
+ * Buffers enter the pool through recycle(), which only keeps buffers that nobody else references,
+ * and leave it through acquire(). Each thread retains at most 1MB and the whole process at most
+ * 64MB, so that many threads can't pin a large amount of memory between them; anything beyond that
+ * is freed as usual.
+ */
+class SharedBufferPool {
+public:
+    /**
+     * Buffers outside of this range of capacities are never pooled.
+     */
+    static constexpr size_t kMinBufferSize = 256;
+    static constexpr size_t kMaxBufferSize = 1024 * 1024;
+
+    struct Stats {
+        long long hits;
+        long long misses;
+        long long recycled;
+        long long discarded;
+        long long retainedBytes;
+    };
+
+    /**
+     * Returns an unshared buffer with a capacity of at least 'minSize' bytes. The smallest pooled
+     * buffer that is large enough is reused if this thread has one, otherwise a new buffer is
+     * allocated with its size rounded up to a size class so that it can be pooled later.
+     */
+    static SharedBuffer acquire(size_t minSize);
+
+    /**
+     * Offers 'buf' to this thread's pool. Buffers that are null, still shared, outside the pooled
+     * size range, or that would put the thread or the process over its retained byte limit are
+     * released normally.
+     */
+    static void recycle(SharedBuffer buf);
+    static void recycle(ConstSharedBuffer buf);
+
+    /**
+     * Returns the counters summed over all threads.
+     */
+    static Stats getStats();
+
+    /**
+     * Appends the counters for the "bufferPool" serverStatus section.
+     */
+    static void appendStats(BSONObjBuilder* bob);
+};
+
+}  // namespace mongo
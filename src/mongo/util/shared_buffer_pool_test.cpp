@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// The pool is per-thread, so each test runs on a thread of its own to start out with an empty one.
+void runOnFreshThread(stdx::function<void()> test) {
+    stdx::thread thread(std::move(test));
+    thread.join();
+}
+
+TEST(SharedBufferPool, RecycledBufferIsReused) {
+    runOnFreshThread([] {
+        const auto before = SharedBufferPool::getStats();
+
+        auto buf = SharedBufferPool::acquire(300);
+        ASSERT_EQ(buf.capacity(), 512U);
+        const char* const data = buf.get();
+        SharedBufferPool::recycle(std::move(buf));
+
+        auto reused = SharedBufferPool::acquire(300);
+        ASSERT_TRUE(reused.get() == data);
+
+        const auto after = SharedBufferPool::getStats();
+        ASSERT_EQ(after.hits - before.hits, 1);
+        ASSERT_EQ(after.misses - before.misses, 1);
+        ASSERT_EQ(after.recycled - before.recycled, 1);
+    });
+}
+
+TEST(SharedBufferPool, LargerBufferServesSmallerRequest) {
+    runOnFreshThread([] {
+        auto buf = SharedBufferPool::acquire(4000);
+        ASSERT_EQ(buf.capacity(), 4096U);
+        const char* const data = buf.get();
+        SharedBufferPool::recycle(std::move(buf));
+
+        ASSERT_TRUE(SharedBufferPool::acquire(100).get() == data);
+    });
+}
+
+TEST(SharedBufferPool, SharedBufferIsNotPooled) {
+    runOnFreshThread([] {
+        const auto before = SharedBufferPool::getStats();
+
+        auto buf = SharedBufferPool::acquire(512);
+        ConstSharedBuffer otherOwner = buf;
+        SharedBufferPool::recycle(std::move(buf));
+        SharedBufferPool::recycle(otherOwner);
+
+        const auto after = SharedBufferPool::getStats();
+        ASSERT_EQ(after.recycled - before.recycled, 0);
+        ASSERT_TRUE(SharedBufferPool::acquire(512).get() != otherOwner.get());
+    });
+}
+
+TEST(SharedBufferPool, BuffersOutsideSizeRangeAreDiscarded) {
+    runOnFreshThread([] {
+        const auto before = SharedBufferPool::getStats();
+
+        SharedBufferPool::recycle(SharedBuffer::allocate(SharedBufferPool::kMinBufferSize - 1));
+        SharedBufferPool::recycle(SharedBuffer::allocate(SharedBufferPool::kMaxBufferSize + 1));
+
+        const auto after = SharedBufferPool::getStats();
+        ASSERT_EQ(after.recycled - before.recycled, 0);
+        ASSERT_EQ(after.discarded - before.discarded, 2);
+    });
+}
+
+TEST(SharedBufferPool, RetainedBytesAreBoundedAndReleasedAtThreadExit) {
+    const auto before = SharedBufferPool::getStats();
+
+    runOnFreshThread([before] {
+        const size_t size = SharedBufferPool::kMaxBufferSize / 4;
+        for (int i = 0; i < 5; ++i) {
+            SharedBufferPool::recycle(SharedBuffer::allocate(size));
+        }
+
+        const auto after = SharedBufferPool::getStats();
+        ASSERT_EQ(after.recycled - before.recycled, 4);
+        ASSERT_EQ(after.discarded - before.discarded, 1);
+        ASSERT_EQ(after.retainedBytes - before.retainedBytes,
+                  static_cast<long long>(SharedBufferPool::kMaxBufferSize));
+    });
+
+    ASSERT_EQ(SharedBufferPool::getStats().retainedBytes, before.retainedBytes);
+}
+
+}  // namespace
+}  // namespace mongo
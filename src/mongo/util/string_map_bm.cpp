@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Short field names like those of a typical document or projection.
+ */
+std::vector<std::string> makeFieldNames(int numFields) {
+    std::vector<std::string> names;
+    for (int i = 0; i < numFields; ++i) {
+        names.push_back("field" + std::to_string(i));
+    }
+    return names;
+}
+
+/**
+ * Names that share a prefix with the inserted ones but are never in the map.
+ */
+std::vector<std::string> makeMisses(int numFields) {
+    std::vector<std::string> names;
+    for (int i = 0; i < numFields; ++i) {
+        names.push_back("missing" + std::to_string(i));
+    }
+    return names;
+}
+
+// std::unordered_map with the same hash function as StringMap, so that only the table layouts
+// differ.
+struct StringDataHasher {
+    size_t operator()(const std::string& s) const {
+        return StringMapTraits::hash(s);
+    }
+};
+using StdStringMap = std::unordered_map<std::string, int, StringDataHasher>;
+
+void BM_StringMapInsert(benchmark::State& state) {
+    const auto names = makeFieldNames(state.range(0));
+    size_t bytes = 0;
+    for (auto keepRunning : state) {
+        StringMap<int> map;
+        for (size_t i = 0; i < names.size(); ++i) {
+            map[names[i]] = i;
+        }
+        bytes = map.allocatedBytes();
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+    state.counters["tableBytes"] = bytes;
+}
+
+void BM_StdUnorderedMapInsert(benchmark::State& state) {
+    const auto names = makeFieldNames(state.range(0));
+    size_t bytes = 0;
+    for (auto keepRunning : state) {
+        StdStringMap map;
+        for (size_t i = 0; i < names.size(); ++i) {
+            map[names[i]] = i;
+        }
+        // Each element is a separate node holding the pair, the cached hash and a next pointer.
+        bytes = map.bucket_count() * sizeof(void*) +
+            map.size() * (sizeof(StdStringMap::value_type) + sizeof(size_t) + sizeof(void*));
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+    state.counters["tableBytes"] = bytes;
+}
+
+void BM_StringMapFind(benchmark::State& state) {
+    const auto names = makeFieldNames(state.range(0));
+    const auto misses = makeMisses(state.range(0));
+    StringMap<int> map;
+    for (size_t i = 0; i < names.size(); ++i) {
+        map[names[i]] = i;
+    }
+    for (auto keepRunning : state) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            benchmark::DoNotOptimize(map.find(names[i]));
+            benchmark::DoNotOptimize(map.find(misses[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * names.size() * 2);
+}
+
+void BM_StdUnorderedMapFind(benchmark::State& state) {
+    const auto names = makeFieldNames(state.range(0));
+    const auto misses = makeMisses(state.range(0));
+    StdStringMap map;
+    for (size_t i = 0; i < names.size(); ++i) {
+        map[names[i]] = i;
+    }
+    for (auto keepRunning : state) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            benchmark::DoNotOptimize(map.find(names[i]));
+            benchmark::DoNotOptimize(map.find(misses[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * names.size() * 2);
+}
+
+/**
+ * Inserts and erases in equal measure, as a set of tracked names does over time, so that deleted
+ * slots keep having to be reused.
+ */
+void BM_StringMapChurn(benchmark::State& state) {
+    const auto names = makeFieldNames(state.range(0) * 2);
+    StringMap<int> map;
+    for (int i = 0; i < state.range(0); ++i) {
+        map[names[i]] = i;
+    }
+    size_t next = 0;
+    for (auto keepRunning : state) {
+        map.erase(names[next]);
+        map[names[(next + state.range(0)) % names.size()]] = next;
+        next = (next + 1) % names.size();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(BM_StringMapInsert)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_StdUnorderedMapInsert)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_StringMapFind)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_StdUnorderedMapFind)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_StringMapChurn)->Arg(64)->Arg(4096);
+
+}  // namespace
+}  // namespace mongo
@@ -29,6 +29,8 @@
 
 #include "mongo/unittest/unittest.h"
 
+#include <map>
+
 #include "mongo/platform/random.h"
 #include "mongo/util/log.h"
 #include "mongo/util/string_map.h"
@@ -145,6 +147,38 @@ TEST(StringMapTest, Erase1) {
     ASSERT_EQUALS(before, m.capacity());
 }
 
+TEST(StringMapTest, EraseUnderChurn) {
+    // Enough live keys that erased slots become tombstones which later inserts have to reuse or
+    // clear out by rehashing.
+    StringMap<int> m;
+    std::map<std::string, int> expected;
+    PseudoRandom rand(12345);
+    for (int i = 0; i < 100000; i++) {
+        const std::string key = "field" + std::to_string(rand.nextInt32(2000));
+        if (rand.nextInt32(2)) {
+            m[key] = i;
+            expected[key] = i;
+        } else {
+            ASSERT_EQUALS(expected.erase(key), m.erase(key));
+        }
+        ASSERT_EQUALS(expected.size(), m.size());
+    }
+
+    for (auto&& entry : expected) {
+        auto it = m.find(entry.first);
+        ASSERT(it != m.end());
+        ASSERT_EQUALS(entry.second, it->second);
+    }
+
+    size_t count = 0;
+    for (auto&& entry : m) {
+        ASSERT_EQUALS(expected[entry.first], entry.second);
+        ++count;
+    }
+    ASSERT_EQUALS(expected.size(), count);
+    ASSERT_LTE(m.size(), m.capacity() * 7 / 8);
+}
+
 TEST(StringMapTest, Erase2) {
     StringMap<int> m;
     m["eliot"] = 5;
@@ -196,6 +230,23 @@ TEST(StringMapTest, Copy1) {
     ASSERT_EQUALS(5, y["eliot"]);
 }
 
+TEST(StringMapTest, CopyAfterErase) {
+    StringMap<std::string> m;
+    for (int i = 0; i < 100; i++) {
+        m[std::to_string(i)] = "value" + std::to_string(i);
+    }
+    for (int i = 0; i < 100; i += 2) {
+        ASSERT_EQUALS(1U, m.erase(std::to_string(i)));
+    }
+
+    StringMap<std::string> y = m;
+    ASSERT_EQUALS(50U, y.size());
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQUALS(i % 2 == 0 ? 0U : 1U, y.count(std::to_string(i)));
+    }
+    ASSERT_EQUALS("value99", y["99"]);
+}
+
 TEST(StringMapTest, Assign) {
     StringMap<int> m;
     m["eliot"] = 5;
@@ -38,6 +38,17 @@
 #include <unistd.h>
 #endif
 
+#if defined(MONGO_CONFIG_HAVE_POSIX_MONOTONIC_CLOCK) && defined(__linux__) && \
+    (defined(__amd64__) || defined(__aarch64__))
+#define MONGO_SYSTEM_TICK_SOURCE_CPU_COUNTER
+#include <fstream>
+#include <string>
+#if defined(__amd64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
 #include "mongo/base/init.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
@@ -115,6 +126,104 @@ TickSource::Tick timerNowPosixMonotonicClock() {
     return result;
 }
 
+#if defined(MONGO_SYSTEM_TICK_SOURCE_CPU_COUNTER)
+
+/**
+ * Implementation for timer that reads the CPU's constant-rate counter directly: the TSC on x86-64
+ * and the generic timer's virtual count on ARMv8. Neither read is serializing, which is fine for
+ * the durations this is used to measure, and both avoid the cost of clock_gettime().
+ */
+TickSource::Tick timerNowCpuCounter() {
+#if defined(__amd64__)
+    return static_cast<TickSource::Tick>(__rdtsc());
+#else
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return static_cast<TickSource::Tick>(ticks);
+#endif
+}
+
+#if defined(__amd64__)
+
+/**
+ * Measures the TSC frequency against CLOCK_MONOTONIC over a few milliseconds. Each end point
+ * brackets a clock_gettime() call between two TSC reads and keeps the tightest of several
+ * attempts, so the estimate is good to a few parts per million.
+ */
+TickSource::Tick calibrateCpuCounter() {
+    struct Sample {
+        TickSource::Tick counter;
+        TickSource::Tick nanos;
+    };
+    const auto takeSample = [] {
+        Sample best{0, 0};
+        auto bestWidth = std::numeric_limits<TickSource::Tick>::max();
+        for (int i = 0; i < 5; ++i) {
+            const auto before = timerNowCpuCounter();
+            const auto nanos = timerNowPosixMonotonicClock();
+            const auto after = timerNowCpuCounter();
+            if (after - before < bestWidth) {
+                bestWidth = after - before;
+                best = {before + bestWidth / 2, nanos};
+            }
+        }
+        return best;
+    };
+
+    const auto start = takeSample();
+    sleepmillis(5);
+    const auto end = takeSample();
+    if (end.nanos <= start.nanos || end.counter <= start.counter) {
+        return 0;
+    }
+    return static_cast<TickSource::Tick>(static_cast<double>(end.counter - start.counter) *
+                                         kNanosPerSecond / (end.nanos - start.nanos));
+}
+
+#endif
+
+/**
+ * Returns the frequency of timerNowCpuCounter(), or 0 if the counter can't be trusted as a tick
+ * source on this machine.
+ */
+TickSource::Tick cpuCounterFrequency() {
+#if defined(__amd64__)
+    // The TSC must tick at a constant rate through frequency changes and sleep states ("invariant
+    // TSC"), which CPUID advertises in bit 8 of EDX for leaf 0x80000007.
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+        return 0;
+    }
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) {
+        return 0;
+    }
+
+    // The TSCs of all CPUs must also be in sync. The kernel checks this at boot and keeps
+    // watching it, and only uses the TSC as its own clock source while it holds.
+    std::ifstream clockSourceFile(
+        "/sys/devices/system/clocksource/clocksource0/current_clocksource");
+    std::string clockSource;
+    if (!(clockSourceFile >> clockSource) || clockSource != "tsc") {
+        return 0;
+    }
+
+    // Reject estimates outside 100MHz-20GHz, in case the calibration was badly disturbed.
+    const auto frequency = calibrateCpuCounter();
+    if (frequency < 100 * 1000 * 1000 || frequency > 20LL * 1000 * 1000 * 1000) {
+        return 0;
+    }
+    return frequency;
+#else
+    // The architecture guarantees a constant rate, system-wide counter, and the kernel enables
+    // reading it from user space.
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return static_cast<TickSource::Tick>(frequency);
+#endif
+}
+
+#endif
+
 void initTickSource() {
     // If the monotonic clock is not available at runtime (sysconf() returns 0 or -1),
     // do not override the generic implementation or modify ticksPerSecond.
@@ -131,6 +240,15 @@ void initTickSource() {
     timespec the_time;
     fassert(16162, !clock_gettime(CLOCK_MONOTONIC, &the_time));
     fassert(16163, static_cast<long long>(the_time.tv_sec) < maxSecs);
+
+#if defined(MONGO_SYSTEM_TICK_SOURCE_CPU_COUNTER)
+    // Prefer the CPU's counter where it is known to be reliable, falling back to the monotonic
+    // clock otherwise.
+    if (const auto frequency = cpuCounterFrequency()) {
+        ticksPerSecond = frequency;
+        _timerNow = &timerNowCpuCounter;
+    }
+#endif
 }
 #else
 void initTickSource() {}
@@ -42,6 +42,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/thread_idle_callback.h"
+#include "mongo/util/allocator_free_memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -98,6 +99,28 @@ MONGO_INITIALIZER(TCMallocThreadIdleListener)(InitializerContext*) {
     return Status::OK();
 }
 
+/**
+ * Free pages in the page heap which are still mapped, which is what ReleaseToSystem() gives back.
+ */
+size_t pageHeapFreeBytes() {
+    size_t freeBytes = 0;
+    MallocExtension::instance()->GetNumericProperty("tcmalloc.pageheap_free_bytes", &freeBytes);
+    return freeBytes;
+}
+
+size_t releasePageHeapFreeBytes(size_t bytes) {
+    const size_t before = pageHeapFreeBytes();
+    MallocExtension::instance()->ReleaseToSystem(bytes);
+    const size_t after = pageHeapFreeBytes();
+    return before > after ? before - after : 0;
+}
+
+MONGO_INITIALIZER(TCMallocFreeMemoryHooks)(InitializerContext*) {
+    if (!RUNNING_ON_VALGRIND)
+        registerAllocatorFreeMemoryHooks({&pageHeapFreeBytes, &releasePageHeapFreeBytes});
+    return Status::OK();
+}
+
 class TCMallocServerStatusSection : public ServerStatusSection {
 public:
     TCMallocServerStatusSection() : ServerStatusSection("tcmalloc") {}
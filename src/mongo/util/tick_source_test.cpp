@@ -28,9 +28,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/stdx/chrono.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/system_tick_source.h"
 #include "mongo/util/tick_source.h"
 #include "mongo/util/tick_source_mock.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -51,5 +54,31 @@ TEST(TickSourceTest, TicksToDurationConversion) {
     tsMicros.reset(1);
     ASSERT_EQ(tsMicros.ticksTo<Microseconds>(tsMicros.getTicks()).count(), 1);
 }
+
+TEST(SystemTickSourceTest, TicksNeverGoBackwards) {
+    auto tickSource = SystemTickSource::get();
+    auto last = tickSource->getTicks();
+    for (int i = 0; i < 1000 * 1000; ++i) {
+        const auto now = tickSource->getTicks();
+        ASSERT_GTE(now, last);
+        last = now;
+    }
+}
+
+TEST(SystemTickSourceTest, RateMatchesSteadyClock) {
+    // Whichever counter the system tick source picked, its calibrated rate must agree with the
+    // monotonic clock to well within a percent.
+    auto tickSource = SystemTickSource::get();
+    const auto startTicks = tickSource->getTicks();
+    const auto startTime = stdx::chrono::steady_clock::now();
+    sleepmillis(200);
+    const auto endTicks = tickSource->getTicks();
+    const auto endTime = stdx::chrono::steady_clock::now();
+
+    const auto tickMicros = tickSource->ticksTo<Microseconds>(endTicks - startTicks).count();
+    const auto steadyMicros =
+        stdx::chrono::duration_cast<stdx::chrono::microseconds>(endTime - startTime).count();
+    ASSERT_APPROX_EQUAL(tickMicros, steadyMicros, steadyMicros / 100);
+}
 }
 }  // namespace mongo
@@ -130,6 +130,91 @@ TEST(UniqueFunctionTest, dtor_releases_functor_object_and_does_not_call_function
     ASSERT_FALSE(runDetection1.itRan);
 }
 
+// Counts live instances so that tests can check that moves neither leak nor double-destroy the
+// functor, whether it is stored inline or on the heap.
+template <size_t padding, bool nothrowMove = true>
+struct CountedFunctor {
+    explicit CountedFunctor(int value) : value(value) {
+        ++live;
+    }
+    CountedFunctor(CountedFunctor&& other) noexcept(nothrowMove) : value(other.value) {
+        ++live;
+    }
+    CountedFunctor& operator=(CountedFunctor&&) = delete;
+    ~CountedFunctor() {
+        --live;
+    }
+
+    int operator()(int x) {
+        return value + x;
+    }
+
+    int value;
+    char pad[padding];
+    static int live;
+};
+
+template <size_t padding, bool nothrowMove>
+int CountedFunctor<padding, nothrowMove>::live = 0;
+
+template <typename Functor>
+void checkMovesAndDestroysFunctor() {
+    ASSERT_EQ(0, Functor::live);
+    {
+        mongo::unique_function<int(int)> uf = Functor(1);
+        ASSERT_EQ(1, Functor::live);
+        ASSERT_EQ(3, uf(2));
+
+        mongo::unique_function<int(int)> uf2 = std::move(uf);
+        ASSERT_FALSE(uf);
+        ASSERT_EQ(1, Functor::live);
+        ASSERT_EQ(4, uf2(3));
+
+        mongo::unique_function<int(int)> uf3 = [](int x) { return -x; };
+        uf3.swap(uf2);
+        ASSERT_EQ(1, Functor::live);
+        ASSERT_EQ(5, uf3(4));
+        ASSERT_EQ(-4, uf2(4));
+
+        uf3 = std::move(uf2);
+        ASSERT_EQ(0, Functor::live);
+        ASSERT_EQ(-5, uf3(5));
+
+        uf = Functor(6);
+        ASSERT_EQ(1, Functor::live);
+        uf = nullptr;
+        ASSERT_EQ(0, Functor::live);
+
+        uf = Functor(7);
+    }
+    ASSERT_EQ(0, Functor::live);
+}
+
+TEST(UniqueFunctionTest, small_functor_is_moved_and_destroyed_correctly) {
+    checkMovesAndDestroysFunctor<CountedFunctor<1>>();
+}
+
+TEST(UniqueFunctionTest, large_functor_is_moved_and_destroyed_correctly) {
+    checkMovesAndDestroysFunctor<CountedFunctor<256>>();
+}
+
+TEST(UniqueFunctionTest, functor_that_may_throw_on_move_is_moved_and_destroyed_correctly) {
+    checkMovesAndDestroysFunctor<CountedFunctor<1, false>>();
+}
+
+TEST(UniqueFunctionTest, const_call_can_mutate_functor) {
+    const mongo::unique_function<int()> counter = [count = 0]() mutable { return ++count; };
+    ASSERT_EQ(1, counter());
+    ASSERT_EQ(2, counter());
+}
+
+TEST(UniqueFunctionTest, construct_from_const_lvalue_copies_functor) {
+    const std::function<int()> func = [] { return 42; };
+    mongo::unique_function<int()> uf = func;
+    ASSERT_EQ(42, uf());
+    ASSERT_TRUE(static_cast<bool>(func));
+}
+
 TEST(UniqueFunctionTest, comparison_checks) {
     mongo::unique_function<void()> uf;
 
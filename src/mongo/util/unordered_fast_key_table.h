@@ -29,15 +29,90 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#endif
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+namespace unordered_fast_key_table_detail {
+
+/**
+ * Each slot of the table has a control byte. Full slots hold the low 7 bits of the hash of their
+ * key, so that a probe can rule out most non-matching slots without looking at the keys. Empty and
+ * deleted slots have the high bit set.
+ */
+using ControlByte = int8_t;
+constexpr ControlByte kEmpty = -128;
+constexpr ControlByte kDeleted = -2;
+
+/**
+ * A window of kWidth consecutive control bytes, which a probe examines at once.
+ */
+class Group {
+public:
+    static constexpr unsigned kWidth = 16;
+
+    explicit Group(const ControlByte* ctrl) {
+#if defined(_M_AMD64) || defined(__amd64__)
+        _ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+        std::memcpy(_ctrl, ctrl, kWidth);
+#endif
+    }
+
+    /**
+     * Returns a mask with bit i set if the i-th slot of the group is full and holds 'h2'.
+     */
+    uint32_t match(ControlByte h2) const {
+#if defined(_M_AMD64) || defined(__amd64__)
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl));
+#else
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < kWidth; ++i) {
+            mask |= uint32_t(_ctrl[i] == h2) << i;
+        }
+        return mask;
+#endif
+    }
+
+    uint32_t matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    uint32_t matchEmptyOrDeleted() const {
+#if defined(_M_AMD64) || defined(__amd64__)
+        // Only empty and deleted slots have their sign bit set.
+        return _mm_movemask_epi8(_ctrl);
+#else
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < kWidth; ++i) {
+            mask |= uint32_t(_ctrl[i] < 0) << i;
+        }
+        return mask;
+#endif
+    }
+
+private:
+#if defined(_M_AMD64) || defined(__amd64__)
+    __m128i _ctrl;
+#else
+    ControlByte _ctrl[kWidth];
+#endif
+};
+
+}  // namespace unordered_fast_key_table_detail
+
 /**
  * A hash map that allows a different type to be used stored (K_S) than is used for lookups (K_L).
  *
@@ -55,6 +130,12 @@ namespace mongo {
  *     const K_L& key() const;
  *     uint32_t hash() const; // Should be free to call repeatedly.
  * };
+ *
+ * The table is open-addressed with a separate array of one control byte per slot, in the style of
+ * SwissTable. Lookups probe a group of 16 control bytes at a time with SSE2 where available and
+ * only compare keys whose 7-bit hash fragment matches, which keeps the load factor at up to 7/8
+ * without long key-comparing probe chains. Inserting may move existing elements, invalidating
+ * iterators, pointers and references to them.
  */
 template <typename K_L,  // key lookup
           typename K_S,  // key storage
@@ -70,119 +151,73 @@ public:
     using HashedKey = typename Traits::HashedKey;
 
 private:
-    class Entry {
-    public:
-        Entry() = default;
-
-        Entry(const Entry& other)
-            : _used(other._used), _everUsed(other.everUsed), _curHash(other._curHash) {
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
-        }
-
-        Entry& operator=(const Entry& other) {
-            if (this == &other) {
-                return *this;
-            }
-
-            if (isUsed()) {
-                unUse();
-            }
-
-            _used = other._used;
-            _everUsed = other._everUsed;
-            _curHash = other._curHash;
-
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
+    using ControlByte = unordered_fast_key_table_detail::ControlByte;
+    using Group = unordered_fast_key_table_detail::Group;
+    static constexpr ControlByte kEmpty = unordered_fast_key_table_detail::kEmpty;
+    static constexpr ControlByte kDeleted = unordered_fast_key_table_detail::kDeleted;
 
-            return *this;
-        }
-
-        ~Entry() {
-            if (isUsed()) {
-                unUse();
-            }
-        }
-
-        template <typename... Args>
-        void emplaceData(const HashedKey& key, Args&&... args) {
-            dassert(!isUsed());
-            _used = true;
-            _everUsed = true;
-            _curHash = key.hash();
-            new (&_data) value_type(std::piecewise_construct,
-                                    std::forward_as_tuple(Traits::toStorage(key.key())),
-                                    std::forward_as_tuple(std::forward<Args>(args)...));
-        }
-
-        bool isUsed() const {
-            return _used;
-        }
-
-        bool wasEverUsed() const {
-            return _everUsed;
-        }
-
-        uint32_t getCurHash() const {
-            dassert(isUsed());
-            return _curHash;
-        }
-
-        void unUse() {
-            dassert(isUsed());
-            _used = false;
-            reinterpret_cast<value_type*>(&_data)->~value_type();
-        }
+    /**
+     * Storage for one slot. Whether it holds a value is recorded in the Area's control bytes, which
+     * is also responsible for constructing and destroying the value. The full hash is kept so that
+     * growing the table does not need to rehash the keys.
+     */
+    struct Entry {
+        uint32_t hash;
+        typename std::aligned_storage<sizeof(value_type),
+                                      std::alignment_of<value_type>::value>::type data;
 
         value_type& getData() {
-            dassert(isUsed());
-            return *reinterpret_cast<value_type*>(&_data);
+            return *reinterpret_cast<value_type*>(&data);
         }
 
         const value_type& getData() const {
-            dassert(isUsed());
-            return *reinterpret_cast<const value_type*>(&_data);
+            return *reinterpret_cast<const value_type*>(&data);
         }
-
-    private:
-        bool _used = false;
-        bool _everUsed = false;
-        uint32_t _curHash;
-        typename std::aligned_storage<sizeof(value_type),
-                                      std::alignment_of<value_type>::value>::type _data;
     };
 
     struct Area {
         Area() = default;  // TODO constexpr
 
-        Area(unsigned capacity, unsigned maxProbe)
-            : _hashMask(capacity - 1),
-              _maxProbe(maxProbe),
-              _entries(capacity ? new Entry[capacity] : nullptr) {
-            // Capacity must be a power of two or zero. See the comment on _hashMask for why.
-            dassert((capacity & (capacity - 1)) == 0);
-        }
+        explicit Area(unsigned capacity);
+
+        Area(const Area& other);
 
-        Area(const Area& other) : Area(other.capacity(), other._maxProbe) {
-            std::copy(other.begin(), other.end(), begin());
+        Area(Area&& other) {
+            swap(&other);
         }
 
-        Area& operator=(const Area& other) {
-            Area(other).swap(this);
+        Area& operator=(Area other) {
+            swap(&other);
             return *this;
         }
 
-        int find(const HashedKey& key, int* firstEmpty) const;
+        ~Area();
 
-        bool transfer(Area* newArea) const;
+        /**
+         * Returns the position of 'key', or -1 if it is not in the table.
+         */
+        int find(const HashedKey& key) const;
+
+        /**
+         * Returns the first empty or deleted position on the probe sequence of 'hash'.
+         */
+        unsigned findFirstNonFull(uint32_t hash) const;
+
+        template <typename... Args>
+        void emplace(unsigned pos, const HashedKey& key, Args&&... args);
+
+        void erase(unsigned pos);
+
+        /**
+         * Moves every element into 'newArea', which must be empty and large enough to hold them.
+         */
+        void transfer(Area* newArea);
 
         void swap(Area* other) {
             using std::swap;
             swap(_hashMask, other->_hashMask);
-            swap(_maxProbe, other->_maxProbe);
+            swap(_growthLeft, other->_growthLeft);
+            swap(_ctrl, other->_ctrl);
             swap(_entries, other->_entries);
         }
 
@@ -190,26 +225,50 @@ private:
             return _hashMask + 1;
         }
 
-        Entry* begin() {
-            return _entries.get();
+        bool isFull(unsigned pos) const {
+            return _ctrl[pos] >= 0;
         }
-        Entry* end() {
-            return _entries.get() + capacity();
+
+        value_type& getData(unsigned pos) {
+            dassert(isFull(pos));
+            return _entries[pos].getData();
+        }
+
+        const value_type& getData(unsigned pos) const {
+            dassert(isFull(pos));
+            return _entries[pos].getData();
+        }
+
+        // The top 25 bits of the hash pick where probing starts and the bottom 7 are stored in the
+        // control byte.
+        static unsigned h1(uint32_t hash) {
+            return hash >> 7;
         }
 
-        const Entry* begin() const {
-            return _entries.get();
+        static ControlByte h2(uint32_t hash) {
+            return hash & 0x7F;
         }
-        const Entry* end() const {
-            return _entries.get() + capacity();
+
+        // Tables keep at least one slot in eight empty or deleted so that every probe terminates.
+        static unsigned maxSizeForCapacity(unsigned capacity) {
+            return capacity - capacity / 8;
         }
 
+        void _setCtrl(unsigned pos, ControlByte c);
+
         // Capacity is always a power of two. This means that the operation (hash % capacity) can be
         // preformed by (hash & (capacity - 1)). Since we need the mask more than the capacity we
         // store it directly and derive the capacity from it. The default capacity is 0 so the
         // default hashMask is -1.
         unsigned _hashMask = -1;
-        unsigned _maxProbe = 0;
+
+        // The number of empty slots that can be filled before the table must grow. Reusing a
+        // deleted slot does not count against it.
+        unsigned _growthLeft = 0;
+
+        // One control byte per slot, followed by a copy of the first Group::kWidth bytes so that a
+        // group can be loaded at any position without wrapping around.
+        std::unique_ptr<ControlByte[]> _ctrl = {};
         std::unique_ptr<Entry[]> _entries = {};
     };
 
@@ -236,6 +295,16 @@ public:
         return _area.capacity();
     }
 
+    /**
+     * @return bytes allocated for the slots and their control bytes, excluding any memory owned by
+     * the keys and values themselves
+     */
+    size_t allocatedBytes() const {
+        if (!capacity())
+            return 0;
+        return capacity() * sizeof(Entry) + capacity() + Group::kWidth;
+    }
+
     V& operator[](const HashedKey& key) {
         return get(key);
     }
@@ -263,7 +332,7 @@ public:
     }
 
     template <typename AreaPtr,
-              typename reference = decltype(AreaPtr()->begin()->getData()),
+              typename reference = decltype(AreaPtr()->getData(0)),
               typename pointer = typename std::add_pointer<reference>::type>
     class iterator_impl
         : public std::
@@ -291,11 +360,11 @@ public:
             : _area(other._area), _position(other._position), _max(other._max) {}
 
         pointer operator->() const {
-            return &_area->_entries[_position].getData();
+            return &_area->getData(_position);
         }
 
         reference operator*() const {
-            return _area->_entries[_position].getData();
+            return _area->getData(_position);
         }
 
         iterator_impl& operator++() {
@@ -326,7 +395,7 @@ public:
                     _position = -1;
                     break;
                 }
-                if (_area->_entries[_position].isUsed())
+                if (_area->isFull(_position))
                     break;
                 ++_position;
             }
@@ -348,39 +417,38 @@ public:
     const_iterator find(const K_L& key) const {
         if (empty())
             return end();  // Don't waste time hashing.
-        return const_iterator(&_area, _area.find(HashedKey(key), nullptr));
+        return const_iterator(&_area, _area.find(HashedKey(key)));
     }
 
     const_iterator find(const HashedKey& key) const {
         if (empty())
             return end();
-        return const_iterator(&_area, _area.find(key, nullptr));
+        return const_iterator(&_area, _area.find(key));
     }
 
     iterator find(const K_L& key) {
         if (empty())
             return end();  // Don't waste time hashing.
-        return iterator(&_area, _area.find(HashedKey(key), nullptr));
+        return iterator(&_area, _area.find(HashedKey(key)));
     }
 
     iterator find(const HashedKey& key) {
         if (empty())
             return end();
-        return iterator(&_area, _area.find(key, nullptr));
+        return iterator(&_area, _area.find(key));
     }
 
     size_t count(const K_L& key) const {
         if (empty())
             return 0;  // Don't waste time hashing.
-        return _area.find(HashedKey(key), nullptr) != -1;
+        return _area.find(HashedKey(key)) != -1;
     }
 
     size_t count(const HashedKey& key) const {
         if (empty())
             return 0;
-        return _area.find(key, nullptr) != -1;
+        return _area.find(key) != -1;
     }
-
     const_iterator begin() const {
         return const_iterator(&_area);
     }
@@ -35,60 +35,154 @@
 namespace mongo {
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKey& key,
-                                                                  int* firstEmpty) const {
-    dassert(capacity());                        // Caller must special-case empty tables.
-    dassert(!firstEmpty || *firstEmpty == -1);  // Caller must initialize *firstEmpty.
-
-    unsigned probe = 0;
-    do {
-        unsigned pos = (key.hash() + probe) & _hashMask;
-
-        if (!_entries[pos].isUsed()) {
-            // space is empty
-            if (firstEmpty && *firstEmpty == -1)
-                *firstEmpty = pos;
-            if (!_entries[pos].wasEverUsed())
-                return -1;
-            continue;
+UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::Area(unsigned capacity)
+    : _hashMask(capacity - 1),
+      _growthLeft(maxSizeForCapacity(capacity)),
+      _ctrl(new ControlByte[capacity + Group::kWidth]),
+      _entries(new Entry[capacity]) {
+    // Capacity must be a power of two, and at least a group wide so that the copied control bytes
+    // at the end don't wrap around more than once. See the comment on _hashMask for why.
+    dassert((capacity & (capacity - 1)) == 0);
+    dassert(capacity >= Group::kWidth);
+    std::memset(_ctrl.get(), static_cast<uint8_t>(kEmpty), capacity + Group::kWidth);
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::Area(const Area& other) {
+    if (!other._ctrl)
+        return;
+
+    Area(other.capacity()).swap(this);
+    _growthLeft = other._growthLeft;
+    std::memcpy(_ctrl.get(), other._ctrl.get(), capacity() + Group::kWidth);
+    for (unsigned pos = 0; pos < capacity(); ++pos) {
+        if (isFull(pos)) {
+            _entries[pos].hash = other._entries[pos].hash;
+            new (&_entries[pos].data) value_type(other.getData(pos));
         }
+    }
+}
 
-        if (_entries[pos].getCurHash() != key.hash()) {
-            // space has something else
-            continue;
+template <typename K_L, typename K_S, typename V, typename Traits>
+UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::~Area() {
+    if (!_ctrl)
+        return;
+
+    for (unsigned pos = 0; pos < capacity(); ++pos) {
+        if (isFull(pos)) {
+            getData(pos).~value_type();
         }
+    }
+}
 
-        if (!Traits::equals(key.key(), Traits::toLookup(_entries[pos].getData().first))) {
-            // hashes match
-            // strings are not equals
-            continue;
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKey& key) const {
+    dassert(capacity());  // Caller must special-case empty tables.
+
+    const ControlByte fragment = h2(key.hash());
+    unsigned pos = h1(key.hash()) & _hashMask;
+    unsigned step = 0;
+    while (true) {
+        const Group group(&_ctrl[pos]);
+        for (uint32_t matches = group.match(fragment); matches; matches &= matches - 1) {
+            const unsigned candidate = (pos + countTrailingZeros64(matches)) & _hashMask;
+            const Entry& entry = _entries[candidate];
+            if (entry.hash == key.hash() &&
+                Traits::equals(key.key(), Traits::toLookup(entry.getData().first))) {
+                return candidate;
+            }
         }
 
-        // hashes and strings are equal
-        // yay!
-        return pos;
-    } while (++probe < _maxProbe);
-    return -1;
+        // A probe sequence never continues past a group with an empty slot, since an insert would
+        // have used that slot.
+        if (group.matchEmpty())
+            return -1;
+
+        // Triangular probing visits every group once when the capacity is a power of two.
+        step += Group::kWidth;
+        pos = (pos + step) & _hashMask;
+    }
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline unsigned UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::findFirstNonFull(
+    uint32_t hash) const {
+    unsigned pos = h1(hash) & _hashMask;
+    unsigned step = 0;
+    while (true) {
+        const uint32_t available = Group(&_ctrl[pos]).matchEmptyOrDeleted();
+        if (available)
+            return (pos + countTrailingZeros64(available)) & _hashMask;
+
+        step += Group::kWidth;
+        pos = (pos + step) & _hashMask;
+    }
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+template <typename... Args>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::emplace(unsigned pos,
+                                                                      const HashedKey& key,
+                                                                      Args&&... args) {
+    dassert(!isFull(pos));
+    if (_ctrl[pos] == kEmpty) {
+        dassert(_growthLeft > 0);
+        --_growthLeft;
+    }
+
+    _entries[pos].hash = key.hash();
+    new (&_entries[pos].data) value_type(std::piecewise_construct,
+                                         std::forward_as_tuple(Traits::toStorage(key.key())),
+                                         std::forward_as_tuple(std::forward<Args>(args)...));
+    _setCtrl(pos, h2(key.hash()));
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline bool UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) const {
-    for (auto&& entry : *this) {
-        if (!entry.isUsed())
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::erase(unsigned pos) {
+    getData(pos).~value_type();
+
+    // The slot can go back to being empty if no group-wide window containing it has ever been
+    // entirely full, since then no probe sequence can have continued past it. Otherwise it has to
+    // be marked deleted so that lookups keep probing.
+    const uint32_t emptyBefore = Group(&_ctrl[(pos - Group::kWidth) & _hashMask]).matchEmpty();
+    const uint32_t emptyAfter = Group(&_ctrl[pos]).matchEmpty();
+    const int fullBefore = emptyBefore ? countLeadingZeros64(emptyBefore) - (64 - Group::kWidth)
+                                       : Group::kWidth;
+    const int fullAfter = emptyAfter ? countTrailingZeros64(emptyAfter) : Group::kWidth;
+    if (fullBefore + fullAfter < static_cast<int>(Group::kWidth)) {
+        _setCtrl(pos, kEmpty);
+        ++_growthLeft;
+    } else {
+        _setCtrl(pos, kDeleted);
+    }
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) {
+    for (unsigned pos = 0; pos < capacity(); ++pos) {
+        if (!isFull(pos))
             continue;
 
-        int firstEmpty = -1;
-        int loc = newArea->find(
-            HashedKey(Traits::toLookup(entry.getData().first), entry.getCurHash()), &firstEmpty);
+        const uint32_t hash = _entries[pos].hash;
+        const unsigned newPos = newArea->findFirstNonFull(hash);
+        dassert(newArea->_growthLeft > 0);
+        --newArea->_growthLeft;
+        newArea->_entries[newPos].hash = hash;
+        new (&newArea->_entries[newPos].data) value_type(std::move(getData(pos)));
+        newArea->_setCtrl(newPos, h2(hash));
 
-        verify(loc == -1);
-        if (firstEmpty < 0) {
-            return false;
-        }
+        getData(pos).~value_type();
+        _setCtrl(pos, kEmpty);
+    }
+}
 
-        newArea->_entries[firstEmpty] = entry;
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::_setCtrl(unsigned pos,
+                                                                       ControlByte c) {
+    _ctrl[pos] = c;
+    if (pos < Group::kWidth) {
+        _ctrl[pos + capacity()] = c;
     }
-    return true;
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -115,13 +209,13 @@ inline size_t UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const HashedKey&
     if (_size == 0)
         return 0;  // Nothing to delete.
 
-    int pos = _area.find(key, nullptr);
+    int pos = _area.find(key);
 
     if (pos < 0)
         return 0;
 
     --_size;
-    _area._entries[pos].unUse();
+    _area.erase(pos);
     return 1;
 }
 
@@ -131,7 +225,7 @@ void UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const_iterator it) {
     dassert(it._area == &_area);
 
     --_size;
-    _area._entries[it._position].unUse();
+    _area.erase(it._position);
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -139,58 +233,44 @@ template <typename... Args>
 inline auto UnorderedFastKeyTable<K_L, K_S, V, Traits>::try_emplace(const HashedKey& key,
                                                                     Args&&... args)
     -> std::pair<iterator, bool> {
-    if (!_area._entries) {
+    if (!_area._ctrl) {
         // This is the first insert ever. Need to allocate initial space.
         dassert(_area.capacity() == 0);
         _grow();
-    }
-
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        int firstEmpty = -1;
-        int pos = _area.find(key, &firstEmpty);
+    } else if (_size) {
+        int pos = _area.find(key);
         if (pos >= 0) {
-            // This is only possible the first pass through the loop, since you're allocating space
-            // for a new element after that.
-            dassert(numGrowTries == 0);
             return {iterator(&_area, pos), false};
         }
+    }
 
-        // key not in map
-        // need to add
-        if (firstEmpty >= 0) {
-            _size++;
-            _area._entries[firstEmpty].emplaceData(key, std::forward<Args>(args)...);
-            return {iterator(&_area, firstEmpty), true};
-        }
-
-        // no space left in map
+    // key not in map
+    // need to add
+    unsigned pos = _area.findFirstNonFull(key.hash());
+    if (_area._growthLeft == 0 && _area._ctrl[pos] != kDeleted) {
         _grow();
+        pos = _area.findFirstNonFull(key.hash());
     }
-    msgasserted(16471, "UnorderedFastKeyTable couldn't add entry after growing many times");
+
+    _size++;
+    _area.emplace(pos, key, std::forward<Args>(args)...);
+    return {iterator(&_area, pos), true};
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
 inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::_grow() {
     unsigned capacity = _area.capacity();
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        if (capacity == 0) {
-            const unsigned kDefaultStartingCapacity = 16;
-            capacity = kDefaultStartingCapacity;
-        } else {
-            capacity *= 2;
-        }
-
-        const double kMaxProbeRatio = 0.05;
-        unsigned maxProbes = (capacity * kMaxProbeRatio) + 1;  // Round up
-
-        Area newArea(capacity, maxProbes);
-        bool success = _area.transfer(&newArea);
-        if (!success) {
-            continue;
-        }
-        _area.swap(&newArea);
-        return;
+    if (capacity == 0) {
+        const unsigned kDefaultStartingCapacity = 16;
+        capacity = kDefaultStartingCapacity;
+    } else if (_size >= Area::maxSizeForCapacity(capacity) / 2) {
+        capacity *= 2;
     }
-    msgasserted(16845, "UnorderedFastKeyTable::_grow couldn't add entry after growing many times");
+    // Otherwise the table ran out of empty slots because of deletions, and rehashing at the same
+    // capacity clears them out.
+
+    Area newArea(capacity);
+    _area.transfer(&newArea);
+    _area.swap(&newArea);
 }
 }